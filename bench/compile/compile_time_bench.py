@@ -0,0 +1,324 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, missing-function-docstring, import-outside-toplevel
+"""Compile-time benchmark of the phases of relax.build on a fixed corpus of models.
+
+Each model is built in its own process, so that its peak RSS is not hidden by the previous
+ones. The build is split in the same phases as relax.build:
+
+- relax: the default Relax pipeline of the target, including FuseOps, FuseTIR and the
+  scheduling of the kernels,
+- vm_codegen: the lowering of the Relax functions to VM bytecode,
+- tir: the default TIR pipeline of the target, including StorageRewrite, and the split of
+  the host and device functions,
+- codegen: the LLVM, CUDA... code generation,
+- link: the link of the executable.
+
+The passes are profiled with PassResourceInstrument, and the time spent in each pass itself,
+without its sub-passes, is reported for the slowest ones. With --baseline, the phases and
+the passes slower than in a previous result by more than --tolerance fail the run.
+
+    python bench/compile/compile_time_bench.py --target llvm --json compile.json
+    python bench/compile/compile_time_bench.py --target cuda --baseline compile.json
+"""
+import argparse
+import json
+import os
+import resource
+import subprocess
+import sys
+import time
+
+MODELS = ["resnet", "bert", "llama"]
+
+
+def _resnet(dtype):
+    """ResNet-18 on a 224x224 image. The batch norms are left out, as they are folded into the
+    convolutions for inference."""
+    from tvm.relax.frontend import nn
+    from tvm.relax.frontend.nn import op
+
+    class BasicBlock(nn.Module):
+        def __init__(self, in_channels, channels, stride):
+            self.conv1 = nn.Conv2D(in_channels, channels, 3, stride, 1, dtype=dtype)
+            self.conv2 = nn.Conv2D(channels, channels, 3, 1, 1, dtype=dtype)
+            self.downsample = None
+            if stride != 1 or in_channels != channels:
+                self.downsample = nn.Conv2D(in_channels, channels, 1, stride, dtype=dtype)
+
+        def forward(self, x):
+            y = self.conv2(op.relu(self.conv1(x)))
+            shortcut = x if self.downsample is None else self.downsample(x)
+            return op.relu(y + shortcut)
+
+    class ResNet(nn.Module):
+        def __init__(self):
+            self.stem = nn.Conv2D(3, 64, 7, 2, 3, dtype=dtype)
+            blocks = []
+            in_channels = 64
+            for channels, stride in [(64, 1), (128, 2), (256, 2), (512, 2)]:
+                blocks.append(BasicBlock(in_channels, channels, stride))
+                blocks.append(BasicBlock(channels, channels, 1))
+                in_channels = channels
+            self.blocks = nn.ModuleList(blocks)
+            self.fc = nn.Linear(512, 1000, dtype=dtype)
+
+        def forward(self, x):
+            x = op.relu(self.stem(x))
+            for block in self.blocks:
+                x = block(x)
+            x = op.sum(x, axis=[2, 3]) / float(x.shape[2] * x.shape[3])
+            return self.fc(x)
+
+    return ResNet(), {"forward": {"x": nn.spec.Tensor([1, 3, 224, 224], dtype)}}
+
+
+def _attention(q, k, v, num_heads, head_dim):
+    from tvm.relax.frontend.nn import op
+
+    b, s, _ = q.shape
+
+    def heads(x):
+        return op.permute_dims(op.reshape(x, (b, s, num_heads, head_dim)), [0, 2, 1, 3])
+
+    scores = op.matmul(heads(q), op.permute_dims(heads(k), [0, 1, 3, 2]))
+    probs = op.softmax(scores / float(head_dim) ** 0.5, axis=-1)
+    out = op.permute_dims(op.matmul(probs, heads(v)), [0, 2, 1, 3])
+    return op.reshape(out, (b, s, num_heads * head_dim))
+
+
+def _bert(dtype):
+    """The 12 encoder layers of BERT-base on 128 tokens."""
+    from tvm.relax.frontend import nn
+    from tvm.relax.frontend.nn import op
+
+    hidden, heads, intermediate = 768, 12, 3072
+
+    class EncoderLayer(nn.Module):
+        def __init__(self):
+            self.qkv = nn.Linear(hidden, 3 * hidden, dtype=dtype)
+            self.out = nn.Linear(hidden, hidden, dtype=dtype)
+            self.norm1 = nn.LayerNorm(hidden, dtype=dtype)
+            self.up = nn.Linear(hidden, intermediate, dtype=dtype)
+            self.down = nn.Linear(intermediate, hidden, dtype=dtype)
+            self.norm2 = nn.LayerNorm(hidden, dtype=dtype)
+
+        def forward(self, x):
+            q, k, v = op.split(self.qkv(x), 3, axis=-1)
+            x = self.norm1(x + self.out(_attention(q, k, v, heads, hidden // heads)))
+            return self.norm2(x + self.down(op.gelu(self.up(x))))
+
+    class Bert(nn.Module):
+        def __init__(self):
+            self.layers = nn.ModuleList([EncoderLayer() for _ in range(12)])
+
+        def forward(self, x):
+            for layer in self.layers:
+                x = layer(x)
+            return x
+
+    return Bert(), {"forward": {"x": nn.spec.Tensor([1, 128, hidden], dtype)}}
+
+
+def _llama(dtype):
+    """4 decoder layers of Llama-7B on a dynamic number of tokens. The rotary embedding and the
+    KV cache are left out, they are runtime builtins in the LLM flows."""
+    from tvm.relax.frontend import nn
+    from tvm.relax.frontend.nn import op
+
+    hidden, heads, intermediate = 4096, 32, 11008
+
+    class DecoderLayer(nn.Module):
+        def __init__(self):
+            self.input_norm = nn.RMSNorm(hidden, -1, 1e-6, bias=False, dtype=dtype)
+            self.qkv = nn.Linear(hidden, 3 * hidden, bias=False, dtype=dtype)
+            self.o_proj = nn.Linear(hidden, hidden, bias=False, dtype=dtype)
+            self.post_norm = nn.RMSNorm(hidden, -1, 1e-6, bias=False, dtype=dtype)
+            self.gate_up = nn.Linear(hidden, 2 * intermediate, bias=False, dtype=dtype)
+            self.down = nn.Linear(intermediate, hidden, bias=False, dtype=dtype)
+
+        def forward(self, x):
+            q, k, v = op.split(self.qkv(self.input_norm(x)), 3, axis=-1)
+            x = x + self.o_proj(_attention(q, k, v, heads, hidden // heads))
+            gate, up = op.split(self.gate_up(self.post_norm(x)), 2, axis=-1)
+            return x + self.down(op.silu(gate) * up)
+
+    class Llama(nn.Module):
+        def __init__(self):
+            self.layers = nn.ModuleList([DecoderLayer() for _ in range(4)])
+
+        def forward(self, x):
+            for layer in self.layers:
+                x = layer(x)
+            return x
+
+    return Llama(), {"forward": {"x": nn.spec.Tensor([1, "seq_len", hidden], dtype)}}
+
+
+def _max_rss_mb():
+    # ru_maxrss is in KB on Linux and in bytes on macOS.
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return rss / (1 << 20) if sys.platform == "darwin" else rss / 1024
+
+
+def _self_times(profiles):
+    """The time spent in each pass itself, without its sub-passes, summed by pass name."""
+    times = {}
+    stack = []  # (depth, name) of the enclosing passes
+    for p in profiles:
+        depth, name, duration = int(p["depth"]), str(p["name"]), float(p["duration_us"])
+        while stack and stack[-1][0] >= depth:
+            stack.pop()
+        if stack:
+            parent = stack[-1][1]
+            times[parent] = times.get(parent, 0.0) - duration
+        times[name] = times.get(name, 0.0) + duration
+        stack.append((depth, name))
+    return {name: us / 1e6 for name, us in times.items()}
+
+
+def _run_model(name, target, dtype, num_passes):
+    """Build a model phase by phase in this process, and return its measurements."""
+    import tvm
+    from tvm import relax
+    from tvm.ir.instrument import PassResourceInstrument
+    from tvm.relax import vm_build
+    from tvm.tir import build as tir_build
+
+    model, spec = {"resnet": _resnet, "bert": _bert, "llama": _llama}[name](dtype)
+    mod, _ = model.export_tvm(spec=spec)
+    target = tvm.target.Target(target)
+
+    phases = {}
+    peak_rss_mb = {"import": _max_rss_mb()}
+
+    def phase(phase_name, func):
+        start = time.perf_counter()
+        result = func()
+        phases[phase_name] = time.perf_counter() - start
+        peak_rss_mb[phase_name] = _max_rss_mb()
+        return result
+
+    def relax_passes():
+        with target:
+            return relax.get_default_pipeline(target)(mod)
+
+    def vm_codegen():
+        builder = relax.ExecBuilder()
+        return builder, vm_build._vmcodegen(builder, mod, "bytecode")
+
+    def link(lib):
+        return relax.VMExecutable(vm_build._ffi_api.VMLink(builder, target, lib, [], {}))
+
+    def tir_passes():
+        tir_mod = vm_build._auto_attach_system_lib_prefix(vm_build._filter_tir(mod), target)
+        return tir_build._lower(tir_mod, target, "default")
+
+    with tvm.transform.PassContext(opt_level=3, instruments=[PassResourceInstrument()]):
+        mod = phase("relax", relax_passes)
+        builder, mod = phase("vm_codegen", vm_codegen)
+        host_mod, device_mods, target_host = phase("tir", tir_passes)
+        lib = phase("codegen", lambda: tir_build.tir_to_runtime(host_mod, device_mods, target_host))
+        phase("link", lambda: link(lib))
+        passes = _self_times(PassResourceInstrument.profiles())
+
+    slowest = sorted(passes.items(), key=lambda kv: -kv[1])[:num_passes]
+    return {
+        "target": str(target),
+        "num_kernels": len(vm_build._filter_tir(mod).functions),
+        "total": sum(phases.values()),
+        "phases": phases,
+        "peak_rss_mb": peak_rss_mb,
+        "passes": dict(slowest),
+    }
+
+
+def _compare(results, baseline, tolerance, min_seconds):
+    """Return the descriptions of the regressions of the results over the baseline."""
+    regressions = []
+
+    def check(what, value, base, unit):
+        if base is not None and value > base * (1 + tolerance) and value - base > min_seconds:
+            regressions.append(f"{what}: {base:.3f}{unit} -> {value:.3f}{unit}")
+
+    for name, result in results.items():
+        base = baseline.get(name)
+        if base is None:
+            continue
+        check(f"{name} total", result["total"], base.get("total"), "s")
+        for phase_name, seconds in result["phases"].items():
+            check(f"{name} {phase_name}", seconds, base["phases"].get(phase_name), "s")
+        for pass_name, seconds in result["passes"].items():
+            check(f"{name} pass {pass_name}", seconds, base["passes"].get(pass_name), "s")
+        rss, base_rss = max(result["peak_rss_mb"].values()), max(base["peak_rss_mb"].values())
+        if rss > base_rss * (1 + tolerance):
+            regressions.append(f"{name} peak RSS: {base_rss:.0f}MB -> {rss:.0f}MB")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n", maxsplit=1)[0])
+    parser.add_argument("--models", default=",".join(MODELS), help="Comma separated models.")
+    parser.add_argument("--target", default="llvm")
+    parser.add_argument("--dtype", default="float32")
+    parser.add_argument("--passes", type=int, default=15, help="Number of passes reported.")
+    parser.add_argument("--json", help="File to write the results to.")
+    parser.add_argument("--baseline", help="Results of a previous run to compare with.")
+    parser.add_argument("--tolerance", type=float, default=0.1, help="Relative slowdown allowed.")
+    parser.add_argument(
+        "--min-seconds", type=float, default=0.05, help="Slowdowns below this are ignored."
+    )
+    parser.add_argument("--worker", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        json.dump(_run_model(args.worker, args.target, args.dtype, args.passes), sys.stdout)
+        return 0
+
+    # The builds must not be served from the compilation cache.
+    env = dict(os.environ)
+    env.pop("TVM_COMPILE_CACHE_DIR", None)
+    results = {}
+    for name in args.models.split(","):
+        if name not in MODELS:
+            parser.error(f"unknown model {name}, candidates are {MODELS}")
+        cmd = [sys.executable, os.path.abspath(__file__), "--worker", name]
+        cmd += ["--target", args.target, "--dtype", args.dtype, "--passes", str(args.passes)]
+        out = subprocess.run(cmd, env=env, check=True, stdout=subprocess.PIPE, text=True).stdout
+        results[name] = result = json.loads(out)
+        print(f"{name}: {result['total']:.2f}s, {result['num_kernels']} kernels, ", end="")
+        print(f"peak RSS {max(result['peak_rss_mb'].values()):.0f}MB")
+        for phase_name, seconds in result["phases"].items():
+            rss = result["peak_rss_mb"][phase_name]
+            print(f"  {phase_name:12s} {seconds:8.3f}s  {rss:8.0f}MB")
+        for pass_name, seconds in result["passes"].items():
+            print(f"    {pass_name:40s} {seconds:8.3f}s")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = _compare(results, json.load(f), args.tolerance, args.min_seconds)
+        for regression in regressions:
+            print(f"Regression: {regression}")
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
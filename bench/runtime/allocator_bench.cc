@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file allocator_bench.cc
+ * \brief Benchmarks of the allocators of the memory manager.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+using memory::Allocator;
+using memory::AllocatorType;
+using memory::Buffer;
+using memory::MemoryManager;
+
+void BM_PooledAllocFree(benchmark::State& state) {
+  Device dev{kDLCPU, 0};
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kPooled);
+  size_t nbytes = state.range(0);
+  // Warm up the pool, the steady state reuses the freed buffer.
+  allocator->Free(allocator->Alloc(dev, nbytes, kAllocAlignment, DataType::UInt(8)));
+  for (auto _ : state) {
+    Buffer buffer = allocator->Alloc(dev, nbytes, kAllocAlignment, DataType::UInt(8));
+    benchmark::DoNotOptimize(buffer.data);
+    allocator->Free(buffer);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PooledAllocFree)->Arg(256)->Arg(64 << 10)->Arg(16 << 20);
+
+void BM_PooledAllocFreeBatch(benchmark::State& state) {
+  Device dev{kDLCPU, 0};
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kPooled);
+  int64_t num_buffers = state.range(0);
+  std::vector<Buffer> buffers(num_buffers);
+  for (auto _ : state) {
+    // Buffers of mixed sizes, freed in allocation order like the registers of a VM function.
+    for (int64_t i = 0; i < num_buffers; ++i) {
+      buffers[i] = allocator->Alloc(dev, 1024 << (i % 8), kAllocAlignment, DataType::UInt(8));
+    }
+    for (int64_t i = 0; i < num_buffers; ++i) {
+      allocator->Free(buffers[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_buffers);
+}
+BENCHMARK(BM_PooledAllocFreeBatch)->Arg(16)->Arg(256);
+
+void BM_TensorEmptyFromPool(benchmark::State& state) {
+  Device dev{kDLCPU, 0};
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kPooled);
+  ffi::Shape shape{state.range(0)};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(allocator->Empty(shape, DataType::Float(32), dev));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TensorEmptyFromPool)->Arg(64)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
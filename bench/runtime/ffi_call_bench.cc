@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file ffi_call_bench.cc
+ * \brief Benchmarks of the cost of the ffi function calls.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/ffi/function.h>
+#include <tvm/runtime/tensor.h>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+void BM_FFICallNoArgs(benchmark::State& state) {
+  ffi::Function f = ffi::Function::FromTyped([]() {});
+  for (auto _ : state) {
+    f();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FFICallNoArgs);
+
+void BM_FFICallIntArgs(benchmark::State& state) {
+  ffi::Function f = ffi::Function::FromTyped([](int64_t a, int64_t b) { return a + b; });
+  int64_t sum = 0;
+  for (auto _ : state) {
+    sum = f(sum, 1).cast<int64_t>();
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FFICallIntArgs);
+
+void BM_FFICallTensorArg(benchmark::State& state) {
+  ffi::Function f = ffi::Function::FromTyped([](Tensor x) { return x->ndim; });
+  Tensor x = Tensor::Empty({16, 16}, DataType::Float(32), {kDLCPU, 0});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f(x).cast<int>());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FFICallTensorArg);
+
+void BM_FFICallPacked(benchmark::State& state) {
+  ffi::Function f = ffi::Function::FromPacked(
+      [](ffi::PackedArgs args, ffi::Any* rv) { *rv = static_cast<int>(args.size()); });
+  ffi::Shape shape{1, 2, 3};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f(1, 2.0, shape, "name").cast<int>());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FFICallPacked);
+
+void BM_FFIGetGlobal(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ffi::Function::GetGlobal("runtime.TVMTensorAllocWithScope"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FFIGetGlobal);
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
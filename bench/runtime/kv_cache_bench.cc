@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file kv_cache_bench.cc
+ * \brief Benchmarks of the host side of the paged KV cache, i.e. the BeginForward of a batch
+ *  with the sync of its auxiliary arrays to the device.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/ffi/container/array.h>
+#include <tvm/ffi/function.h>
+#include <tvm/runtime/tensor.h>
+
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+constexpr int64_t kNumLayers = 4;
+constexpr int64_t kNumHeads = 8;
+constexpr int64_t kHeadDim = 64;
+constexpr int64_t kPageSize = 16;
+constexpr int64_t kPrefillLength = 100;
+
+/*! \brief Create a CPU KV cache whose attention functions are no-op, they do not run here. */
+ffi::Any CreateKVCache(int64_t num_seqs) {
+  ffi::Function noop = ffi::Function::FromPacked([](ffi::PackedArgs args, ffi::Any* rv) {});
+  auto tir = [&noop]() { return ffi::Array<ffi::Any>{ffi::String("tir"), noop}; };
+  std::vector<int64_t> attn_kinds(kNumLayers, 0);
+  int64_t capacity = num_seqs * (kPrefillLength + kPageSize * 8);
+  return ffi::Function::GetGlobalRequired("vm.builtin.paged_attention_kv_cache_create")(
+      ffi::Shape{num_seqs, capacity, 2048, kPageSize, 0}, ffi::Shape{0, kNumLayers}, kNumHeads,
+      kNumHeads, kHeadDim, kHeadDim, ffi::Shape(attn_kinds), false, /*rope_mode=*/0, 1.0, 1e4,
+      nullptr, Tensor::Empty({}, DataType::Float(16), {kDLCPU, 0}), noop, nullptr, tir(), tir(),
+      tir(), tir(), tir(), tir(), tir(), ffi::Array<ffi::Any>{}, ffi::Array<ffi::Function>{noop},
+      noop, noop, noop, noop);
+}
+
+/*!
+ * \brief BeginForward of a batch of sequences after a prefill, each appending `append_length`
+ *  tokens. The appended tokens are popped out of the timing, to keep the lengths steady.
+ */
+void BM_KVCacheBeginForward(benchmark::State& state) {
+  int64_t num_seqs = state.range(0);
+  int64_t append_length = state.range(1);
+  ffi::Any kv_cache = CreateKVCache(num_seqs);
+  auto add_sequence = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_add_sequence");
+  auto begin_forward = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_begin_forward");
+  auto end_forward = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_end_forward");
+  auto popn = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_popn");
+
+  std::vector<int64_t> seq_ids(num_seqs);
+  for (int64_t i = 0; i < num_seqs; ++i) {
+    seq_ids[i] = i;
+    add_sequence(kv_cache, i);
+    // Prefill the sequences one by one, to stay within the prefill chunk size.
+    begin_forward(kv_cache, ffi::Shape{i}, ffi::Shape{kPrefillLength});
+    end_forward(kv_cache);
+  }
+  ffi::Shape seq_shape(seq_ids);
+
+  ffi::Shape append_lengths(std::vector<int64_t>(num_seqs, append_length));
+  for (auto _ : state) {
+    begin_forward(kv_cache, seq_shape, append_lengths);
+    end_forward(kv_cache);
+    state.PauseTiming();
+    for (int64_t i = 0; i < num_seqs; ++i) {
+      popn(kv_cache, i, static_cast<int>(append_length));
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_seqs);
+}
+BENCHMARK(BM_KVCacheBeginForward)
+    ->ArgNames({"seqs", "append"})
+    ->Args({1, 1})
+    ->Args({32, 1})
+    ->Args({128, 1})
+    ->Args({8, 64});
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file thread_pool_bench.cc
+ * \brief Benchmarks of the latency of the parallel launches of the thread pool.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <atomic>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+int EmptyTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) { return 0; }
+
+int BarrierTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  static_cast<std::atomic<int>*>(cdata)->fetch_add(1, std::memory_order_relaxed);
+  return TVMBackendParallelBarrier(task_id, penv);
+}
+
+void BM_ThreadPoolLaunch(benchmark::State& state) {
+  int num_task = state.range(0);
+  for (auto _ : state) {
+    TVMBackendParallelLaunch(EmptyTask, nullptr, num_task);
+  }
+  state.counters["threads"] = threading::NumThreads();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadPoolLaunch)->Arg(0)->Arg(1)->Arg(4);
+
+void BM_ThreadPoolLaunchBarrier(benchmark::State& state) {
+  std::atomic<int> count{0};
+  for (auto _ : state) {
+    TVMBackendParallelLaunch(BarrierTask, &count, 0);
+  }
+  benchmark::DoNotOptimize(count.load());
+  state.counters["threads"] = threading::NumThreads();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadPoolLaunchBarrier);
+
+void BM_ParallelFor(benchmark::State& state) {
+  int64_t n = state.range(0);
+  std::atomic<int64_t> sum{0};
+  for (auto _ : state) {
+    parallel_for_with_threading_backend(
+        [&sum](int64_t i) { sum.fetch_add(i, std::memory_order_relaxed); }, 0, n);
+  }
+  benchmark::DoNotOptimize(sum.load());
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ParallelFor)->Arg(64)->Arg(4096);
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
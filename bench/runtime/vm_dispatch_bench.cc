@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file vm_dispatch_bench.cc
+ * \brief Benchmarks of the instruction dispatch of the Relax VM.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/exec_builder.h>
+#include <tvm/runtime/vm/vm.h>
+
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+using vm::Instruction;
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("bench.vm.identity", [](ffi::Any x) { return x; });
+}
+
+/*!
+ * \brief Build a VM with a function "main" of one input, that chains the input through
+ *  `num_calls` calls of a packed function and returns it.
+ */
+ffi::Function BuildChainedCalls(int64_t num_calls) {
+  relax::ExecBuilder builder = relax::ExecBuilder::Create();
+  builder->EmitFunction("main", 1, std::nullopt);
+  for (int64_t i = 0; i < num_calls; ++i) {
+    builder->EmitCall("bench.vm.identity", {Instruction::Arg::Register(i)}, i + 1);
+  }
+  builder->EmitRet(Instruction::Arg::Register(num_calls));
+  builder->EndFunction("main");
+  ObjectPtr<vm::VirtualMachine> machine = vm::VirtualMachine::Create();
+  machine->LoadExecutable(builder->Get());
+  machine->Init({Device{kDLCPU, 0}}, {memory::AllocatorType::kPooled});
+  ffi::Module mod(machine);
+  return mod->GetFunction("main").value();
+}
+
+void BM_VMCallDispatch(benchmark::State& state) {
+  int64_t num_calls = state.range(0);
+  ffi::Function main = BuildChainedCalls(num_calls);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(main(static_cast<int64_t>(1)).cast<int64_t>());
+  }
+  state.SetItemsProcessed(state.iterations() * num_calls);
+}
+BENCHMARK(BM_VMCallDispatch)->Arg(1)->Arg(64)->Arg(1024);
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,495 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file llm_serving_bench.cc
+ * \brief End-to-end benchmark of LLM serving over the VM and the paged KV cache.
+ *
+ * The harness drives a compiled LLM executable with continuous-batching traffic: requests
+ * arrive as a Poisson process, with mixed prompt and output lengths, and a part of them share
+ * a system prompt that is reused through the prefix cache of the KV cache. Each step either
+ * prefills a chunk of the waiting prompts or decodes one token of all the running requests,
+ * with greedy sampling. It reports the percentiles of the time to first token (TTFT), of the
+ * time per output token (TPOT), of the request latency, and the throughput.
+ *
+ * The executable follows the calling convention of MLC LLM, where `params` is the array of
+ * parameters of the model and is omitted when `--params` is not given:
+ *   - `embed(token_ids: int32[n], params) -> float[n, hidden]`
+ *   - `batch_prefill(embeddings: [1, n, hidden], logit_positions: int32[b], kv_cache, params)
+ *      -> (logits: float32[1, b, vocab], kv_cache)`
+ *   - `batch_decode(embeddings: [b, 1, hidden], kv_cache, params)
+ *      -> (logits: float32[b, 1, vocab], kv_cache)`
+ *   - `<kv-cache-func>(max_batch_size, max_total_seq_len, prefill_chunk_size, page_size,
+ *      support_sliding_window) -> kv_cache`, each argument being a shape of one element.
+ */
+#include <tvm/ffi/container/array.h>
+#include <tvm/ffi/container/shape.h>
+#include <tvm/ffi/extra/module.h>
+#include <tvm/ffi/function.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/tensor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tvm;
+using namespace tvm::runtime;
+
+namespace {
+
+const char* kUsage =
+    "Usage: tvm_llm_serving_bench --model=<lib.so> [options]\n"
+    "--model               - The compiled executable of the model.\n"
+    "--params              - The tensor cache directory of the parameters, Default=\"\"\n"
+    "--device              - cpu, cuda or rocm, with an optional :<id>, Default=cuda:0\n"
+    "--kv-cache-func       - The KV cache creation function, Default=create_tir_paged_kv_cache\n"
+    "--num-requests        - The number of requests, Default=256\n"
+    "--request-rate        - The mean arrival rate in requests per second, Default=8\n"
+    "--prompt-len          - The range of prompt lengths, min:max, Default=64:1024\n"
+    "--output-len          - The range of output lengths, min:max, Default=32:256\n"
+    "--prefix-ratio        - The fraction of requests sharing a system prompt, Default=0.5\n"
+    "--prefix-len          - The length of the system prompts, Default=256\n"
+    "--num-prefixes        - The number of distinct system prompts, Default=4\n"
+    "--max-batch-size      - The maximum number of running requests, Default=64\n"
+    "--max-total-seq-len   - The token capacity of the KV cache, Default=65536\n"
+    "--prefill-chunk-size  - The maximum number of tokens of a prefill step, Default=2048\n"
+    "--page-size           - The page size of the KV cache, Default=16\n"
+    "--vocab-size          - The token ids of the prompts are below it, Default=32000\n"
+    "--seed                - The seed of the traffic, Default=0\n"
+    "--json                - A file to write the results to, in JSON, Default=\"\"\n";
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string model;
+  std::string params;
+  Device device{kDLCUDA, 0};
+  std::string kv_cache_func = "create_tir_paged_kv_cache";
+  int64_t num_requests = 256;
+  double request_rate = 8;
+  int64_t prompt_len[2] = {64, 1024};
+  int64_t output_len[2] = {32, 256};
+  double prefix_ratio = 0.5;
+  int64_t prefix_len = 256;
+  int64_t num_prefixes = 4;
+  int64_t max_batch_size = 64;
+  int64_t max_total_seq_len = 65536;
+  int64_t prefill_chunk_size = 2048;
+  int64_t page_size = 16;
+  int64_t vocab_size = 32000;
+  uint64_t seed = 0;
+  std::string json;
+};
+
+std::string GetOption(int argc, char* argv[], const std::string& name) {
+  std::string prefix = name + "=";
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0) {
+      return argv[i] + prefix.size();
+    }
+  }
+  return "";
+}
+
+void ParseRange(const std::string& value, int64_t range[2]) {
+  size_t colon = value.find(':');
+  range[0] = std::stoll(value.substr(0, colon));
+  range[1] = colon == std::string::npos ? range[0] : std::stoll(value.substr(colon + 1));
+  CHECK(0 < range[0] && range[0] <= range[1]) << "ValueError: Invalid range " << value;
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+  Options opts;
+  opts.model = GetOption(argc, argv, "--model");
+  if (opts.model.empty()) {
+    std::cerr << kUsage;
+    std::exit(1);
+  }
+  opts.params = GetOption(argc, argv, "--params");
+  std::string value;
+  if (!(value = GetOption(argc, argv, "--device")).empty()) {
+    size_t colon = value.find(':');
+    std::string kind = value.substr(0, colon);
+    opts.device.device_id = colon == std::string::npos ? 0 : std::stoi(value.substr(colon + 1));
+    if (kind == "cpu") {
+      opts.device.device_type = kDLCPU;
+    } else if (kind == "cuda") {
+      opts.device.device_type = kDLCUDA;
+    } else if (kind == "rocm") {
+      opts.device.device_type = kDLROCM;
+    } else {
+      LOG(FATAL) << "ValueError: Unknown device " << value;
+    }
+  }
+  if (!(value = GetOption(argc, argv, "--kv-cache-func")).empty()) opts.kv_cache_func = value;
+  auto get_int = [&](const char* name, int64_t* out) {
+    std::string v = GetOption(argc, argv, name);
+    if (!v.empty()) *out = std::stoll(v);
+  };
+  get_int("--num-requests", &opts.num_requests);
+  get_int("--prefix-len", &opts.prefix_len);
+  get_int("--num-prefixes", &opts.num_prefixes);
+  get_int("--max-batch-size", &opts.max_batch_size);
+  get_int("--max-total-seq-len", &opts.max_total_seq_len);
+  get_int("--prefill-chunk-size", &opts.prefill_chunk_size);
+  get_int("--page-size", &opts.page_size);
+  get_int("--vocab-size", &opts.vocab_size);
+  if (!(value = GetOption(argc, argv, "--request-rate")).empty()) {
+    opts.request_rate = std::stod(value);
+  }
+  if (!(value = GetOption(argc, argv, "--prefix-ratio")).empty()) {
+    opts.prefix_ratio = std::stod(value);
+  }
+  if (!(value = GetOption(argc, argv, "--prompt-len")).empty()) ParseRange(value, opts.prompt_len);
+  if (!(value = GetOption(argc, argv, "--output-len")).empty()) ParseRange(value, opts.output_len);
+  if (!(value = GetOption(argc, argv, "--seed")).empty()) opts.seed = std::stoull(value);
+  opts.json = GetOption(argc, argv, "--json");
+  CHECK_GT(opts.request_rate, 0) << "ValueError: The request rate must be positive";
+  CHECK_GT(opts.max_batch_size, 0) << "ValueError: The batch size must be positive";
+  CHECK_GT(opts.prefill_chunk_size, 0) << "ValueError: The prefill chunk size must be positive";
+  return opts;
+}
+
+/*! \brief A request of the traffic, with its serving state. */
+struct Request {
+  int64_t id;
+  /*! \brief The arrival time, relative to the start of the benchmark, in seconds. */
+  double arrival;
+  std::vector<int64_t> prompt;
+  int64_t max_new_tokens;
+  bool admitted = false;
+  int64_t num_prefilled = 0;
+  int64_t num_reused = 0;
+  int64_t num_generated = 0;
+  int32_t last_token = 0;
+  double first_token_time = 0;
+  double finish_time = 0;
+};
+
+std::vector<Request> GenerateTraffic(const Options& opts) {
+  std::mt19937_64 rng(opts.seed);
+  std::exponential_distribution<double> inter_arrival(opts.request_rate);
+  std::uniform_int_distribution<int64_t> prompt_len(opts.prompt_len[0], opts.prompt_len[1]);
+  std::uniform_int_distribution<int64_t> output_len(opts.output_len[0], opts.output_len[1]);
+  std::uniform_int_distribution<int64_t> token(0, opts.vocab_size - 1);
+  std::uniform_int_distribution<int64_t> prefix_id(0, std::max<int64_t>(opts.num_prefixes, 1) - 1);
+  std::bernoulli_distribution shares_prefix(opts.num_prefixes > 0 ? opts.prefix_ratio : 0);
+
+  std::vector<std::vector<int64_t>> prefixes(std::max<int64_t>(opts.num_prefixes, 0));
+  for (std::vector<int64_t>& prefix : prefixes) {
+    for (int64_t i = 0; i < opts.prefix_len; ++i) prefix.push_back(token(rng));
+  }
+  std::vector<Request> requests;
+  double arrival = 0;
+  for (int64_t i = 0; i < opts.num_requests; ++i) {
+    Request request;
+    request.id = i;
+    request.arrival = arrival;
+    if (shares_prefix(rng)) {
+      request.prompt = prefixes[prefix_id(rng)];
+    }
+    // The prompts sharing a system prompt continue with a suffix of their own.
+    int64_t len = prompt_len(rng);
+    for (int64_t j = 0; j < len; ++j) request.prompt.push_back(token(rng));
+    request.max_new_tokens = output_len(rng);
+    requests.push_back(std::move(request));
+    arrival += inter_arrival(rng);
+  }
+  return requests;
+}
+
+/*! \brief The model functions, with the parameters bound as the last argument. */
+class Model {
+ public:
+  explicit Model(const Options& opts) : device_(opts.device) {
+    ffi::Module lib = ffi::Module::LoadFromFile(opts.model);
+    vm_ = lib->GetFunction("vm_load_executable").value()().cast<ffi::Module>();
+    ffi::Module vm = vm_;
+    vm->GetFunction("vm_initialization")
+        .value()(static_cast<int>(device_.device_type), device_.device_id,
+                 static_cast<int>(memory::AllocatorType::kPooled), static_cast<int>(kDLCPU), 0,
+                 static_cast<int>(memory::AllocatorType::kPooled));
+    auto get_function = [&vm](const std::string& name) {
+      ffi::Optional<ffi::Function> func = vm->GetFunction(name);
+      CHECK(func.has_value()) << "ValueError: The model has no function " << name;
+      return func.value();
+    };
+    embed_ = get_function("embed");
+    prefill_ = get_function("batch_prefill");
+    decode_ = get_function("batch_decode");
+    if (!opts.params.empty()) {
+      ffi::Function::GetGlobalRequired("vm.builtin.tensor_cache.load")(
+          opts.params, static_cast<int>(device_.device_type), device_.device_id);
+      params_ = ffi::Function::GetGlobalRequired("vm.builtin.param_array_from_cache")("param", -1)
+                    .cast<ffi::Array<Tensor>>();
+      ffi::Function::GetGlobalRequired("vm.builtin.tensor_cache.clear")();
+    }
+    kv_cache_ = get_function(opts.kv_cache_func)(
+        ffi::Shape{opts.max_batch_size}, ffi::Shape{opts.max_total_seq_len},
+        ffi::Shape{opts.prefill_chunk_size}, ffi::Shape{opts.page_size}, ffi::Shape{0});
+  }
+
+  const ffi::Any& kv_cache() const { return kv_cache_; }
+
+  /*! \brief Prefill the tokens, and return the logits at the given positions. */
+  Tensor Prefill(const std::vector<int32_t>& tokens, const std::vector<int32_t>& logit_positions) {
+    Tensor embeddings = Embed(tokens);
+    Tensor view = embeddings.CreateView({1, embeddings->shape[0], embeddings->shape[1]},
+                                        embeddings->dtype);
+    return Call(prefill_, view, ToDevice(logit_positions), kv_cache_)
+        .cast<ffi::Array<ffi::Any>>()[0]
+        .cast<Tensor>();
+  }
+
+  /*! \brief Decode one token of each sequence, and return the logits. */
+  Tensor Decode(const std::vector<int32_t>& tokens) {
+    Tensor embeddings = Embed(tokens);
+    Tensor view = embeddings.CreateView({embeddings->shape[0], 1, embeddings->shape[1]},
+                                        embeddings->dtype);
+    return Call(decode_, view, kv_cache_).cast<ffi::Array<ffi::Any>>()[0].cast<Tensor>();
+  }
+
+ private:
+  template <typename... Args>
+  ffi::Any Call(const ffi::Function& func, Args&&... args) {
+    if (params_.defined()) {
+      return func(std::forward<Args>(args)..., params_.value());
+    }
+    return func(std::forward<Args>(args)...);
+  }
+
+  Tensor ToDevice(const std::vector<int32_t>& values) {
+    Tensor tensor =
+        Tensor::Empty({static_cast<int64_t>(values.size())}, DataType::Int(32), device_);
+    tensor.CopyFromBytes(values.data(), values.size() * sizeof(int32_t));
+    return tensor;
+  }
+
+  Tensor Embed(const std::vector<int32_t>& tokens) {
+    return Call(embed_, ToDevice(tokens)).cast<Tensor>();
+  }
+
+  Device device_;
+  ffi::Module vm_;
+  ffi::Function embed_, prefill_, decode_;
+  ffi::Optional<ffi::Array<Tensor>> params_;
+  ffi::Any kv_cache_;
+};
+
+/*! \brief Greedy sampling of each row of the logits. */
+std::vector<int32_t> Sample(const Tensor& logits) {
+  CHECK(logits.DataType() == DataType::Float(32))
+      << "ValueError: Expect float32 logits, but got " << logits.DataType();
+  int64_t vocab = logits->shape[logits->ndim - 1];
+  Tensor host = logits.CopyTo(Device{kDLCPU, 0});
+  const float* data = static_cast<const float*>(host->data);
+  int64_t num_rows = 1;
+  for (int i = 0; i + 1 < host->ndim; ++i) num_rows *= host->shape[i];
+  std::vector<int32_t> tokens(num_rows);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    const float* row = data + i * vocab;
+    tokens[i] = static_cast<int32_t>(std::max_element(row, row + vocab) - row);
+  }
+  return tokens;
+}
+
+/*! \brief Serve the requests with continuous batching, prefills first. */
+double Serve(const Options& opts, Model* model, std::vector<Request>* requests) {
+  auto f_add_sequence = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_add_sequence");
+  auto f_add_with_prefix =
+      ffi::Function::GetGlobalRequired("vm.builtin.attention_kv_cache_add_sequence_with_prefix");
+  auto f_commit_prefix =
+      ffi::Function::GetGlobalRequired("vm.builtin.attention_kv_cache_commit_sequence_prefix");
+  auto f_remove_sequence = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_remove_sequence");
+  auto f_begin_forward = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_begin_forward");
+  auto f_end_forward = ffi::Function::GetGlobalRequired("vm.builtin.kv_state_end_forward");
+  const ffi::Any& kv_cache = model->kv_cache();
+
+  Clock::time_point start = Clock::now();
+  auto now = [&start]() {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  size_t next_arrival = 0;
+  size_t num_finished = 0;
+  std::deque<Request*> waiting;
+  std::vector<Request*> running;
+  auto finish = [&](Request* request) {
+    request->finish_time = now();
+    f_remove_sequence(kv_cache, request->id);
+    ++num_finished;
+  };
+
+  while (num_finished < requests->size()) {
+    while (next_arrival < requests->size() && (*requests)[next_arrival].arrival <= now()) {
+      waiting.push_back(&(*requests)[next_arrival++]);
+    }
+    if (waiting.empty() && running.empty()) {
+      std::this_thread::sleep_for(
+          std::chrono::duration<double>((*requests)[next_arrival].arrival - now()));
+      continue;
+    }
+
+    // Prefill the waiting requests that fit in the batch, the last one possibly partially.
+    std::vector<Request*> batch;
+    std::vector<int64_t> seq_ids, lengths;
+    std::vector<int32_t> tokens, logit_positions;
+    size_t num_admitted = 0;
+    while (num_admitted < waiting.size() &&
+           static_cast<int64_t>(running.size() + batch.size()) < opts.max_batch_size &&
+           static_cast<int64_t>(tokens.size()) < opts.prefill_chunk_size) {
+      Request* request = waiting[num_admitted];
+      if (!request->admitted) {
+        request->num_reused =
+            f_add_with_prefix(kv_cache, request->id, ffi::Shape(request->prompt)).cast<int64_t>();
+        request->num_prefilled = request->num_reused;
+        request->admitted = true;
+      }
+      int64_t remaining = static_cast<int64_t>(request->prompt.size()) - request->num_prefilled;
+      int64_t length =
+          std::min(remaining, opts.prefill_chunk_size - static_cast<int64_t>(tokens.size()));
+      for (int64_t i = 0; i < length; ++i) {
+        tokens.push_back(static_cast<int32_t>(request->prompt[request->num_prefilled + i]));
+      }
+      batch.push_back(request);
+      seq_ids.push_back(request->id);
+      lengths.push_back(length);
+      logit_positions.push_back(static_cast<int32_t>(tokens.size()) - 1);
+      if (length < remaining) break;
+      ++num_admitted;
+    }
+    if (!batch.empty()) {
+      f_begin_forward(kv_cache, ffi::Shape(seq_ids), ffi::Shape(lengths));
+      std::vector<int32_t> sampled = Sample(model->Prefill(tokens, logit_positions));
+      f_end_forward(kv_cache);
+      for (size_t i = 0; i < batch.size(); ++i) {
+        Request* request = batch[i];
+        request->num_prefilled += lengths[i];
+        if (request->num_prefilled < static_cast<int64_t>(request->prompt.size())) continue;
+        request->first_token_time = now();
+        request->last_token = sampled[i];
+        request->num_generated = 1;
+        f_commit_prefix(kv_cache, request->id, ffi::Shape(request->prompt));
+        if (request->num_generated >= request->max_new_tokens) {
+          finish(request);
+        } else {
+          running.push_back(request);
+        }
+      }
+      waiting.erase(waiting.begin(), waiting.begin() + num_admitted);
+      continue;
+    }
+
+    // Decode one token of every running request.
+    seq_ids.clear();
+    tokens.clear();
+    for (Request* request : running) {
+      seq_ids.push_back(request->id);
+      tokens.push_back(request->last_token);
+    }
+    f_begin_forward(kv_cache, ffi::Shape(seq_ids),
+                    ffi::Shape(std::vector<int64_t>(running.size(), 1)));
+    std::vector<int32_t> sampled = Sample(model->Decode(tokens));
+    f_end_forward(kv_cache);
+    std::vector<Request*> still_running;
+    for (size_t i = 0; i < running.size(); ++i) {
+      Request* request = running[i];
+      request->last_token = sampled[i];
+      if (++request->num_generated >= request->max_new_tokens) {
+        finish(request);
+      } else {
+        still_running.push_back(request);
+      }
+    }
+    running = std::move(still_running);
+  }
+  return now();
+}
+
+struct Summary {
+  double mean, p50, p90, p99;
+};
+
+Summary Summarize(std::vector<double> values) {
+  if (values.empty()) return Summary{0, 0, 0, 0};
+  std::sort(values.begin(), values.end());
+  double sum = 0;
+  for (double v : values) sum += v;
+  auto percentile = [&values](double p) {
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+  };
+  return Summary{sum / values.size(), percentile(0.5), percentile(0.9), percentile(0.99)};
+}
+
+void Report(const Options& opts, const std::vector<Request>& requests, double duration) {
+  std::vector<double> ttft, tpot, latency;
+  int64_t num_prompt_tokens = 0, num_reused_tokens = 0, num_output_tokens = 0;
+  for (const Request& request : requests) {
+    ttft.push_back(request.first_token_time - request.arrival);
+    latency.push_back(request.finish_time - request.arrival);
+    if (request.num_generated > 1) {
+      tpot.push_back((request.finish_time - request.first_token_time) /
+                     (request.num_generated - 1));
+    }
+    num_prompt_tokens += request.prompt.size();
+    num_reused_tokens += request.num_reused;
+    num_output_tokens += request.num_generated;
+  }
+  std::vector<std::pair<std::string, Summary>> metrics = {
+      {"ttft_s", Summarize(ttft)}, {"tpot_s", Summarize(tpot)}, {"latency_s", Summarize(latency)}};
+
+  std::ostringstream os;
+  os << "{\n  \"num_requests\": " << requests.size() << ",\n  \"duration_s\": " << duration
+     << ",\n  \"request_throughput\": " << requests.size() / duration
+     << ",\n  \"output_token_throughput\": " << num_output_tokens / duration
+     << ",\n  \"prompt_tokens\": " << num_prompt_tokens
+     << ",\n  \"prefix_reused_tokens\": " << num_reused_tokens
+     << ",\n  \"output_tokens\": " << num_output_tokens;
+  for (const auto& kv : metrics) {
+    os << ",\n  \"" << kv.first << "\": {\"mean\": " << kv.second.mean
+       << ", \"p50\": " << kv.second.p50 << ", \"p90\": " << kv.second.p90
+       << ", \"p99\": " << kv.second.p99 << "}";
+  }
+  os << "\n}\n";
+  std::cout << os.str();
+  if (!opts.json.empty()) {
+    std::ofstream(opts.json) << os.str();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options opts = ParseOptions(argc, argv);
+  std::vector<Request> requests = GenerateTraffic(opts);
+  Model model(opts);
+  double duration = Serve(opts, &model, &requests);
+  Report(opts, requests, duration);
+  return 0;
+}
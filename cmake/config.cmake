@@ -64,6 +64,18 @@ set(USE_MSCCL OFF)
 # - OFF: disable NCCL
 set(USE_NVTX OFF)
 
+# Whether to enable GPUDirect Storage (cuFile) for the disco weight loader
+# (must have USE_CUDA enabled):
+# - ON: enable cuFile with cmake's auto search
+# - OFF: disable cuFile, shards are read through pinned host memory
+set(USE_CUFILE OFF)
+
+# Whether to build the CUPTI metric collector of the profiler, for the roofline metrics of
+# CUDA kernels (must have USE_CUDA enabled):
+# - ON: enable CUPTI with cmake's auto search
+# - OFF: disable CUPTI
+set(USE_CUPTI OFF)
+
 # Whether enable ROCM runtime
 #
 # Possible values:
@@ -359,6 +371,14 @@ set(TVM_FFI_BACKTRACE_ON_SEGFAULT ON)
 # - /path/to/folder/containing/: Path to folder containing papi.pc.
 set(USE_PAPI OFF)
 
+# Whether to build with zstd, which RPC sessions can use to compress the tensor
+# copies sent over the wire (RPCSession.enable_compression).
+# Possible values:
+# - ON: enable zstd support. Will search PKG_CONFIG_PATH for a libzstd.pc
+# - OFF: disable zstd support.
+# - /path/to/folder/containing/: Path to folder containing libzstd.pc.
+set(USE_ZSTD OFF)
+
 # Whether to use GoogleTest for C++ unit tests. When enabled, the generated
 # build file (e.g. Makefile) will have a target "cpptest".
 # Possible values:
@@ -371,6 +391,15 @@ set(USE_PAPI OFF)
 # predefined variables to specify the path to the GTest package if needed.
 set(USE_GTEST AUTO)
 
+# Whether to enable the `tvm_runtime_bench` target of C++ runtime microbenchmarks
+# Possible values:
+# - ON: enable Google Benchmark. The package `benchmark` will be required for
+#   cmake to succeed.
+# - OFF: disable Google Benchmark.
+# - AUTO: cmake will attempt to find the benchmark package, if found the target
+#   will be enabled, otherwise it will be disabled.
+set(USE_GOOGLE_BENCHMARK AUTO)
+
 # Enable using CUTLASS as a BYOC backend
 # Need to have USE_CUDA=ON
 set(USE_CUTLASS OFF)
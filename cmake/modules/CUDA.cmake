@@ -135,6 +135,25 @@ if(USE_CUDA)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_NVTX_LIBRARY})
   endif(USE_NVTX)
 
+  if(USE_CUFILE)
+    message(STATUS "Build with cuFile support")
+    if(NOT CUDA_CUFILE_LIBRARY)
+      message(FATAL_ERROR "Cannot find cuFile, USE_CUFILE=" ${USE_CUFILE})
+    endif()
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUFILE_LIBRARY})
+  endif(USE_CUFILE)
+
+  if(USE_CUPTI)
+    message(STATUS "Build with CUPTI support")
+    if(NOT CUDA_CUPTI_LIBRARY OR NOT CUDA_NVPERF_HOST_LIBRARY)
+      message(FATAL_ERROR "Cannot find CUPTI, USE_CUPTI=" ${USE_CUPTI})
+    endif()
+    include_directories(SYSTEM ${CUDA_CUPTI_INCLUDE_DIRS})
+    tvm_file_glob(GLOB CONTRIB_CUPTI_SRC_CC src/runtime/contrib/cupti/*.cc)
+    list(APPEND RUNTIME_SRCS ${CONTRIB_CUPTI_SRC_CC})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUPTI_LIBRARY} ${CUDA_NVPERF_HOST_LIBRARY})
+  endif(USE_CUPTI)
+
   # Add CUDA builtins to RelaxVM
   tvm_file_glob(GLOB VM_CUDA_BUILTIN_SRC_CC src/runtime/vm/cuda/*.cc)
   list(APPEND RUNTIME_SRCS ${VM_CUDA_BUILTIN_SRC_CC})
@@ -68,6 +68,8 @@ function(add_lib_info src_file)
     TVM_INFO_USE_CUBLAS="${USE_CUBLAS}"
     TVM_INFO_USE_CUDA="${USE_CUDA}"
     TVM_INFO_USE_NVTX="${USE_NVTX}"
+    TVM_INFO_USE_CUFILE="${USE_CUFILE}"
+    TVM_INFO_USE_CUPTI="${USE_CUPTI}"
     TVM_INFO_USE_NCCL="${USE_NCCL}"
     TVM_INFO_USE_MSCCL="${USE_MSCCL}"
     TVM_INFO_USE_CUDNN="${USE_CUDNN}"
@@ -129,6 +131,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_NVSHMEM="${USE_NVSHMEM}"
     TVM_INFO_USE_NNAPI_CODEGEN="${USE_NNAPI_CODEGEN}"
     TVM_INFO_USE_NNAPI_RUNTIME="${USE_NNAPI_RUNTIME}"
+    TVM_INFO_USE_ZSTD="${USE_ZSTD}"
     TVM_INFO_BACKTRACE_ON_SEGFAULT="${BACKTRACE_ON_SEGFAULT}"
   )
 
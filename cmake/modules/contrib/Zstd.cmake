@@ -0,0 +1,28 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+if(USE_ZSTD)
+  find_package(PkgConfig REQUIRED)
+
+  set(ENV{PKG_CONFIG_PATH} "${USE_ZSTD}:$ENV{PKG_CONFIG_PATH}")
+  pkg_check_modules(ZSTD REQUIRED IMPORTED_TARGET libzstd)
+  message(STATUS "Using zstd library ${ZSTD_LINK_LIBRARIES}")
+  target_link_libraries(tvm_runtime_objs PRIVATE PkgConfig::ZSTD)
+  target_link_libraries(tvm PRIVATE PkgConfig::ZSTD)
+  target_link_libraries(tvm_runtime PRIVATE PkgConfig::ZSTD)
+  target_sources(tvm_runtime_objs PRIVATE src/runtime/contrib/zstd/zstd.cc)
+endif()
@@ -101,6 +101,19 @@ macro(find_cuda use_cuda use_cudnn)
       )
       # search default path if cannot find cublaslt in non-default
       find_library(CUDA_CUBLASLT_LIBRARY NAMES cublaslt cublasLt)
+      find_library(CUDA_CUFILE_LIBRARY cufile
+        PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+        PATH_SUFFIXES lib lib64 targets/x86_64-linux/lib targets/x86_64-linux/lib/stubs lib64/stubs lib/x86_64-linux-gnu
+        NO_DEFAULT_PATH)
+      find_library(CUDA_CUPTI_LIBRARY cupti
+        PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+        PATH_SUFFIXES extras/CUPTI/lib64 lib64 lib targets/x86_64-linux/lib
+        NO_DEFAULT_PATH)
+      find_library(CUDA_NVPERF_HOST_LIBRARY nvperf_host
+        PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+        PATH_SUFFIXES extras/CUPTI/lib64 lib64 lib targets/x86_64-linux/lib
+        NO_DEFAULT_PATH)
+      set(CUDA_CUPTI_INCLUDE_DIRS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include)
     endif(MSVC)
 
     # find cuDNN
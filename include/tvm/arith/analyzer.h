@@ -386,6 +386,23 @@ class RewriteSimplifier {
   /*! \brief Reset the statistics counters */
   TVM_DLL void ResetStatsCounters();
 
+  /*! \brief Enable counting the attempts and the rewrites of each rewrite rule
+   *
+   * The counters are off by default, as they cost a hash table update
+   * for every rule attempted.
+   *
+   * \param enabled Whether to count.
+   */
+  TVM_DLL void SetRuleProfilingEnabled(bool enabled);
+
+  /*! \brief Return the counters of each rewrite rule
+   *
+   * \return A map from the source location of each rule attempted to
+   * the numbers of its attempts and of its rewrites.  The counters
+   * are reset along with the statistics counters.
+   */
+  TVM_DLL ffi::Map<ffi::String, ffi::Array<Integer>> GetRuleCounters() const;
+
   /*! \brief Set the maximum allowed number of rewrite steps
    *
    * By default, the simplifier may perform as many steps as are
@@ -565,6 +582,8 @@ class ConstraintContext {
   PrimExpr constraint_;
   /*! \brief function to be called in recovery */
   std::vector<std::function<void()>> recovery_functions_;
+  /*! \brief The depth of the analyzer memo inside of this scope, 0 if it was disabled */
+  size_t memo_depth_{0};
 };
 
 /*!
@@ -652,6 +671,8 @@ class TVM_DLL Analyzer {
   TransitiveComparisonAnalyzer transitive_comparisons;
   /*! \brief constructor */
   Analyzer();
+  /*! \brief destructor */
+  ~Analyzer();
   /*!
    * \brief Mark the value as non-negative value globally in analyzer.
    *
@@ -784,6 +805,69 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+
+  /*! \brief Statistics of the memoization of the analyzer. */
+  struct MemoStats {
+    /*! \brief The number of queries answered from the memo */
+    int64_t hits{0};
+    /*! \brief The number of queries computed and added to the memo */
+    int64_t misses{0};
+    /*! \brief The number of memoized results dropped due to changes of the context */
+    int64_t invalidations{0};
+  };
+
+  /*!
+   * \brief Enable or disable memoization of `Simplify` and `CanProve`.
+   *
+   * Results are memoized per expression object and constraint scope.
+   * Entering a ConstraintContext opens a new scope, and exiting it drops
+   * the results of that scope, so that the results of the enclosing scope
+   * are reused afterwards. Binding a variable drops the results that may
+   * depend on it.
+   *
+   * \param enabled Whether to enable memoization.
+   *
+   * \note While memoization is enabled, the context must be changed through
+   * `Bind`, `MarkGlobalNonNegValue` or `ConstraintContext`. Call `ClearMemo`
+   * after updating a sub-analyzer directly. The memo belongs to this analyzer,
+   * so separate analyzers can be used from separate threads.
+   */
+  void SetMemoizationEnabled(bool enabled);
+  /*! \brief Drop all the memoized results. */
+  void ClearMemo();
+  /*! \brief Get the statistics of the memoization. */
+  MemoStats GetMemoStats() const;
+  /*! \brief Reset the statistics of the memoization. */
+  void ResetMemoStats();
+
+  /*! \brief The counters of the queries made by all the analyzers of a thread. */
+  struct ThreadStats {
+    /*! \brief The number of calls of `Simplify`. */
+    int64_t simplify_calls{0};
+    /*! \brief The number of calls of `CanProve`. */
+    int64_t can_prove_calls{0};
+    /*! \brief The number of queries answered from the memo. */
+    int64_t memo_hits{0};
+    /*! \brief The number of queries computed and added to the memo. */
+    int64_t memo_misses{0};
+  };
+  /*!
+   * \brief Get the counters of the current thread, which only grow, e.g. for the pass profiler
+   * to attribute the queries to the passes.
+   */
+  TVM_DLL static ThreadStats GetThreadStats();
+
+ private:
+  friend class ConstraintContext;
+  class MemoTable;
+  /*! \brief Compute the result of `CanProve` without memoization. */
+  bool CanProveImpl(const PrimExpr& cond, ProofStrength strength);
+  /*! \brief Compute the result of `Simplify` without memoization. */
+  PrimExpr SimplifyImpl(const PrimExpr& expr, int steps);
+  /*! \brief The memo, nullptr when memoization is disabled. */
+  std::unique_ptr<MemoTable> memo_;
+  /*! \brief The statistics of the memoization. */
+  MemoStats memo_stats_;
 };
 
 }  // namespace arith
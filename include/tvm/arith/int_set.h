@@ -333,6 +333,23 @@ TVM_DLL ffi::Array<IntSet> EstimateRegionUpperBound(const ffi::Array<Range>& reg
                                                     const PrimExpr& predicate,
                                                     arith::Analyzer* analyzer);
 
+/*!
+ * \brief Analyze the region as the projection of a polyhedron, given the domain of variables and
+ * their predicate. Unlike interval arithmetic, the bounds of the variables relate to one another,
+ * e.g. the domain of a variable may depend on another one, so the result is tight on the
+ * non-rectangular regions of triangular or sliding-window accesses. The non-linear constraints
+ * are dropped and the elimination is over the rationals, so the result is an upper bound.
+ * \param region The region to be analyzed
+ * \param var_dom The ranges of the variables
+ * \param predicate The predicate for the accesses
+ * \param analyzer The analyzer used
+ * \return std::nullopt if the projection fails, or an array of arith::IntSet as the result of
+ * analysis
+ */
+TVM_DLL ffi::Optional<ffi::Array<IntSet>> EstimateRegionPolyhedralBound(
+    const ffi::Array<Range>& region, const ffi::Map<Var, Range>& var_dom, const PrimExpr& predicate,
+    arith::Analyzer* analyzer);
+
 }  // namespace arith
 }  // namespace tvm
 #endif  // TVM_ARITH_INT_SET_H_
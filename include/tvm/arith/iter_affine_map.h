@@ -54,6 +54,9 @@
 #include <tvm/ir/expr.h>
 #include <tvm/tir/var.h>
 
+#include <unordered_map>
+#include <vector>
+
 namespace tvm {
 namespace arith {
 
@@ -308,6 +311,68 @@ IterMapResult DetectIterMap(const ffi::Array<PrimExpr>& indices,
                             IterMapLevel check_level, arith::Analyzer* analyzer,
                             bool simplify_trivial_iterators = true);
 
+/*!
+ * \brief A memo of the results of DetectIterMap, and so of IterMapSimplify, keyed by the
+ *  structural hash of the indices, the input iterators, the predicate and the check level.
+ *
+ * The memo is opt-in, and only consulted within its scope, e.g. a schedule or a pass that analyzes
+ * the same index expressions repeatedly. Within the scope, the context of the analyzer that a
+ * result may depend on, e.g. the bounds of the free variables of the indices, is assumed to be
+ * the same for identical inputs.
+ *
+ * \code
+ *   {
+ *     With<IterMapCache> scope;
+ *     DetectIterMap(...);  // memoized until the scope exits
+ *   }
+ * \endcode
+ */
+class IterMapCacheNode : public Object {
+ public:
+  /*! \brief The number of lookups answered from the memo */
+  int64_t num_hits{0};
+  /*! \brief The number of lookups that ran the detection */
+  int64_t num_misses{0};
+
+  /*! \brief An entry of the memo */
+  struct Entry {
+    /*! \brief The inputs of the detection */
+    ffi::Array<ffi::Any> key;
+    /*! \brief The result of the detection */
+    IterMapResult result;
+  };
+  /*! \brief The entries, grouped by the structural hash of their inputs */
+  std::unordered_map<uint64_t, std::vector<Entry>> entries;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<IterMapCacheNode>()
+        .def_ro("num_hits", &IterMapCacheNode::num_hits)
+        .def_ro("num_misses", &IterMapCacheNode::num_misses);
+  }
+
+  static constexpr const bool _type_mutable = true;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("arith.IterMapCache", IterMapCacheNode, Object);
+};
+
+/*!
+ * \brief Managed reference to IterMapCacheNode.
+ * \sa IterMapCacheNode
+ */
+class IterMapCache : public ObjectRef {
+ public:
+  /*! \brief Create an empty memo */
+  TVM_DLL IterMapCache();
+
+  /*! \return The memo of the innermost scope on the current thread, if any */
+  TVM_DLL static ffi::Optional<IterMapCache> Current();
+
+  TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(IterMapCache, ObjectRef, IterMapCacheNode);
+
+  TVM_DLL void EnterWithScope();
+  TVM_DLL void ExitWithScope();
+};
+
 /*!
  * \brief Use IterVarMap detector to rewrite and simplify the indices
  *
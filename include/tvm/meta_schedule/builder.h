@@ -148,6 +148,17 @@ class Builder : public runtime::ObjectRef {
    * \return The Builder created.
    */
   static Builder PyBuilder(BuilderNode::FBuild f_build);
+  /*!
+   * \brief Create a builder that builds the inputs in the current process on a thread pool,
+   * which saves spawning worker processes and serializing the inputs to them.
+   * \param num_threads The number of threads to build with.
+   * \param f_build The function that builds an IRModule, a Target and the optional params into
+   * a runtime module.
+   * \param f_export The function that exports a runtime module and returns the artifact path.
+   * \return The Builder created.
+   */
+  TVM_DLL static Builder ThreadedBuilder(int num_threads, ffi::Function f_build,
+                                         ffi::Function f_export);
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NOTNULLABLE(Builder, runtime::ObjectRef, BuilderNode);
 };
 
@@ -25,6 +25,7 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/ffi/string.h>
 #include <tvm/meta_schedule/arg_info.h>
+#include <tvm/meta_schedule/feature_extractor.h>
 #include <tvm/meta_schedule/measure_candidate.h>
 #include <tvm/meta_schedule/runner.h>
 #include <tvm/runtime/object.h>
@@ -35,6 +36,7 @@
 namespace tvm {
 namespace meta_schedule {
 
+class Database;
 class TuneContext;
 
 /*! \brief Cost model. */
@@ -73,6 +75,14 @@ class CostModelNode : public runtime::Object {
   virtual std::vector<double> Predict(const TuneContext& context,
                                       const ffi::Array<MeasureCandidate>& candidates) = 0;
 
+  /*!
+   * \brief Pretrain the cost model on the valid tuning records of a database, so that it is
+   * useful from the first trial of a new tuning session.
+   * \param database The database to read the tuning records from.
+   * \param num_threads The number of threads to replay the traces of the records.
+   */
+  void Pretrain(const Database& database, int num_threads);
+
   static constexpr const bool _type_mutable = true;
   TVM_FFI_DECLARE_OBJECT_INFO("meta_schedule.CostModel", CostModelNode, Object);
 };
@@ -153,6 +163,26 @@ class CostModel : public runtime::ObjectRef {
                                        PyCostModelNode::FUpdate f_update,    //
                                        PyCostModelNode::FPredict f_predict,  //
                                        PyCostModelNode::FAsString f_as_string);
+  /*!
+   * \brief Create a gradient boosted trees cost model that trains and predicts natively.
+   * \param extractor The feature extractor.
+   * \param num_trees The number of boosting rounds in each training.
+   * \param max_depth The maximum depth of a tree.
+   * \param learning_rate The shrinkage applied to the output of each tree.
+   * \param reg_lambda The L2 regularization on the leaf outputs.
+   * \param gamma The minimum loss reduction required to split a node.
+   * \param min_child_weight The minimum sum of hessians in a child.
+   * \param max_bins The maximum number of histogram bins per feature, at most 256.
+   * \param num_warmup_samples The number of samples before the model predicts random scores.
+   * \param adaptive_training Whether to skip retraining until the data grows by a fifth.
+   * \param seed The seed of the random scores predicted during warmup, -1 for a random one.
+   * \return The cost model created.
+   */
+  TVM_DLL static CostModel GBDTModel(FeatureExtractor extractor, int num_trees, int max_depth,
+                                     double learning_rate, double reg_lambda, double gamma,
+                                     double min_child_weight, int max_bins,
+                                     int num_warmup_samples, bool adaptive_training,
+                                     int64_t seed);
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(CostModel, ObjectRef, CostModelNode);
 };
 
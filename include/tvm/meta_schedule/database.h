@@ -267,6 +267,15 @@ class DatabaseNode : public runtime::Object {
    * \param destination The destination database to be dumped to.
    */
   void DumpPruned(Database destination);
+  /*!
+   * \brief Compact the database in place. The invalid records, i.e. those without a measured run
+   * time, are dropped, the records of the same trace of a workload are deduplicated, and only the
+   * `top_k` fastest records of each workload are kept. A database backed by files rewrites them
+   * atomically, so that a periodic job can compact it while it is not being tuned into.
+   * \param top_k The number of records kept per workload.
+   * \return The number of records removed.
+   */
+  virtual int64_t Compact(int top_k);
   /*! \brief Return a reference to the owned module equality method instance. */
   const ModuleEquality& GetModuleEquality() const {
     ICHECK(mod_eq_);
@@ -491,9 +500,35 @@ class Database : public runtime::ObjectRef {
    * \param path_tuning_record The path to the database table.
    * \param allow_missing Whether to create new file when the given path is not found.
    * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   * \param max_records_per_workload The maximum number of valid and of invalid tuning records
+   * kept in memory for each workload, or -1 for no limit.
    */
   TVM_DLL static Database JSONDatabase(ffi::String path_workload, ffi::String path_tuning_record,
-                                       bool allow_missing, ffi::String mod_eq_name = "structural");
+                                       bool allow_missing, ffi::String mod_eq_name = "structural",
+                                       int max_records_per_workload = -1);
+  /*!
+   * \brief Create a database stored in a single memory-mapped binary file. Opening it only
+   * indexes the entries, workloads and tuning records are decoded on first use.
+   * \param path The path to the database file.
+   * \param allow_missing Whether to create new file when the given path is not found.
+   * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   * \return The created database.
+   */
+  TVM_DLL static Database BinaryDatabase(ffi::String path, bool allow_missing,
+                                         ffi::String mod_eq_name = "structural");
+  /*!
+   * \brief Create a database that shares its records with other tuning jobs through a server.
+   * Records are cached locally, committed to the server in batches and pulled periodically.
+   * \param host The host of the server.
+   * \param port The port of the server.
+   * \param commit_batch_size The number of buffered records that triggers a commit.
+   * \param pull_interval_sec The minimum interval between two pulls from the server, in seconds.
+   * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   * \return The created database.
+   */
+  TVM_DLL static Database RemoteDatabase(ffi::String host, int port, int commit_batch_size,
+                                         double pull_interval_sec,
+                                         ffi::String mod_eq_name = "structural");
   /*!
    * \brief A database composed of multiple databases, allowing users to guide IR rewriting using
    * combined knowledge of those databases. To each query, it returns the best record among all the
@@ -510,6 +545,24 @@ class Database : public runtime::ObjectRef {
    * \return The subsetted database.
    */
   TVM_DLL static Database OrderedUnionDatabase(ffi::Array<Database, void> databases);
+  /*!
+   * \brief A database that answers the queries of unseen workloads without measurement, by
+   * replaying the records of the nearest tuned workloads, i.e. the ones whose anchor blocks are of
+   * the same type and of the closest shape, with their tile sizes fitted to the new shape.
+   * \param database The database of the tuned workloads, which also receives all commits.
+   * \param k The number of nearest workloads whose records are tried on a query.
+   * \return The database created.
+   */
+  TVM_DLL static Database NearestNeighborDatabase(Database database, int k);
+  /*!
+   * \brief A database that answers the queries of unseen workloads without measurement, by
+   * re-applying the best records of the tuned workloads with the same anchor block as anchor
+   * traces, whatever the blocks fused around the anchor block.
+   * \param database The database of the tuned workloads, which also receives all commits.
+   * \param k The number of best records of the same anchor block tried on a query.
+   * \return The database created.
+   */
+  TVM_DLL static Database AnchorBlockDatabase(Database database, int k);
   /*!
    * \brief Create a database with customized methods on the python-side.
    * \param f_has_workload The packed function of `HasWorkload`.
@@ -104,12 +104,16 @@ class FeatureExtractor : public runtime::ObjectRef {
    * curve.
    * \param cache_line_bytes The number of bytes in a cache line.
    * \param extract_workload Whether to extract features in the workload in tuning context or not.
+   * \param cache_size The number of modules whose features are cached, 0 to disable caching.
+   * \param extract_texture Whether to extract the bytes each store reads from textures or not.
    * \return The feature extractor created.
    */
   TVM_DLL static FeatureExtractor PerStoreFeature(int buffers_per_store = 5,
                                                   int arith_intensity_curve_num_samples = 10,
                                                   int cache_line_bytes = 64,
-                                                  bool extract_workload = false);
+                                                  bool extract_workload = false,
+                                                  int cache_size = 1024,
+                                                  bool extract_texture = false);
   /*!
    * \brief Create a feature extractor with customized methods on the python-side.
    * \param f_extract_from The packed function of `ExtractFrom`.
@@ -28,6 +28,8 @@
 #include <tvm/tir/schedule/schedule.h>
 #include <tvm/tir/schedule/trace.h>
 
+#include <vector>
+
 namespace tvm {
 namespace meta_schedule {
 
@@ -61,6 +63,16 @@ class MutatorNode : public runtime::Object {
   virtual ffi::Optional<tir::Trace> Apply(
       const tir::Trace& trace, support::LinearCongruentialEngine::TRandState* rand_state) = 0;
 
+  /*!
+   * \brief Observe the scores that the cost model predicted for the population of a search.
+   * \param traces The traces of the population.
+   * \param scores The normalized predicted score of each trace.
+   * \note It is called between the rounds of mutation, never concurrently with `Apply`. The
+   * mutators that are not guided by the scores ignore it.
+   */
+  virtual void NotifyPredictedScores(const std::vector<tir::Trace>& traces,
+                                     const std::vector<double>& scores) {}
+
   /*!
    * \brief Clone the mutator.
    * \return The cloned mutator.
@@ -101,6 +113,17 @@ class Mutator : public runtime::ObjectRef {
   using FAsString = ffi::TypedFunction<ffi::String()>;
   /*! \brief Create a Mutator that mutates the decision of instruction Sample-Perfect-Tile */
   TVM_DLL static Mutator MutateTileSize();
+  /*!
+   * \brief Create a Mutator that mutates the tile sizes as MutateTileSize does, but drops the
+   * mutations exceeding the thread, shared memory, register or vector width limits of a GPU target
+   * before the postprocessors, and prefers the tile sizes of the population that the cost model
+   * scored high.
+   * \param max_candidates The number of mutations drawn at a time to choose from.
+   * \param temperature The temperature of the softmax choice over the score statistics of the
+   * mutated tile sizes. Zero takes the first mutation within the limits.
+   * \return The created mutator.
+   */
+  TVM_DLL static Mutator MutateTileSizeGuided(int max_candidates, double temperature);
   /*!
    * \brief Create a Mutator that mutates the parallel extent
    * \param max_jobs_per_core The maximum number of parallel jobs per core.
@@ -157,6 +157,12 @@ class Postproc : public runtime::ObjectRef {
    * \return The postprocessor created
    */
   TVM_DLL static Postproc VerifyVTCMLimit();
+  /*!
+   * \brief Verifies that the buffers in texture scopes can be lowered to 2d textures within the
+   * texture limits of the target.
+   * \return The postprocessor created
+   */
+  TVM_DLL static Postproc VerifyTextureStorage();
   /*!
    * \brief Creates a postprocessor that rewrites the layout of input tensor
    * \note Weight layout rewrite is supported so far, activation layout rewrite will be added.
@@ -175,6 +181,8 @@ class Postproc : public runtime::ObjectRef {
   TVM_DLL static ffi::Array<Postproc, void> DefaultCUDATensorCore();
   /*! \brief Create default postprocessors for Hexagon */
   TVM_DLL static ffi::Array<Postproc, void> DefaultHexagon();
+  /*! \brief Create default postprocessors for Adreno */
+  TVM_DLL static ffi::Array<Postproc, void> DefaultAdreno();
 
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(Postproc, ObjectRef, PostprocNode);
 };
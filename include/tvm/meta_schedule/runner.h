@@ -218,6 +218,19 @@ class Runner : public runtime::ObjectRef {
    * \return The runner created.
    */
   TVM_DLL static Runner PyRunner(FRun f_run);
+  /*!
+   * \brief Create a runner that measures a batch of built modules in the current process,
+   * allocating the arguments once per signature and interleaving the repeats of the candidates.
+   * \param f_load_module The function that loads an artifact into a runtime module.
+   * \param number The number of runs averaged in one repeat.
+   * \param repeat The number of repeats of each candidate.
+   * \param min_repeat_ms The minimum duration of a repeat in milliseconds.
+   * \param enable_cache_flush Whether to flush the L2 cache on GPUs, or the CPU cache, before
+   * each repeat.
+   * \return The runner created.
+   */
+  TVM_DLL static Runner InterleavedRunner(ffi::Function f_load_module, int number, int repeat,
+                                          int min_repeat_ms, bool enable_cache_flush);
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NOTNULLABLE(Runner, runtime::ObjectRef, RunnerNode);
 };
 
@@ -137,6 +137,15 @@ class ScheduleRule : public runtime::ObjectRef {
    */
   TVM_DLL static ScheduleRule InlineConstantScalars();
 
+  /*!
+   * \brief Inline the spatial blocks that read integer buffers, e.g. the decoding of quantized
+   * weights, into their consumers when those are all reductions that need multi-level tiling.
+   * The consumers then cache the packed weights, and decode them in registers. It should run
+   * before MultiLevelTiling.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule InlineDequantize();
+
   /*!
    * \brief Create a mega rule: multi-level tiling with data reuse
    * \param structure The tiling structure. Recommended:
@@ -249,9 +258,14 @@ class ScheduleRule : public runtime::ObjectRef {
    * \brief Create a schedule rule which applies cross-thread reduction to some reduction blocks
    * correspondingly when needed
    * \param thread_extents Candidates of thread axis extent (values are required to be positive).
+   * \param grid_reduction_min_extent The minimum reduction extent for which a two-pass grid
+   * reduction, across thread blocks through an rfactor buffer, is added as a candidate.
+   * std::nullopt disables it.
    * \return The schedule rule created
    */
-  TVM_DLL static ScheduleRule CrossThreadReduction(ffi::Array<Integer> thread_extents);
+  TVM_DLL static ScheduleRule CrossThreadReduction(
+      ffi::Array<Integer> thread_extents,
+      ffi::Optional<Integer> grid_reduction_min_extent = std::nullopt);
   /*!
    * \brief A rule that randomly select a compute-at location for a free block
    * \return The schedule rule created
@@ -274,6 +288,31 @@ class ScheduleRule : public runtime::ObjectRef {
                                                          int max_vectorize_extent,              //
                                                          ffi::Array<Integer> unroll_max_steps,  //
                                                          bool unroll_explicit);
+  /*!
+   * \brief Prefetch the tiles of the next iterations of a loop around a block on CPU. The rule
+   * forks the design space on the loop to pipeline, and samples the prefetch distance, which is
+   * annotated on the loop and lowered by the InjectSoftwarePrefetch pass.
+   * \param prefetch_distances The candidates of the number of iterations to prefetch ahead.
+   * \param max_pipeline_depth The number of loops outside of the innermost one to consider. The
+   * d-th of them is the pipelined loop of depth d.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule SoftwarePrefetch(ffi::Array<Integer> prefetch_distances,
+                                               int max_pipeline_depth);
+  /*!
+   * \brief Split the reduction of a block with a small output and a long reduction, e.g. a skinny
+   * GEMM, into partitions on GPU. Each partition writes its partial sums to a workspace through
+   * rfactor, and the original block becomes the epilogue that adds them up. The rule forks the
+   * design space with the split variant next to the unchanged one.
+   * \param split_factors The candidates of the number of partitions of the reduction.
+   * \param min_reduction_extent The smallest reduction extent to split.
+   * \param max_spatial_extent The largest number of output elements of a block to split.
+   * \param tiling The rule that tiles the partial sums, with the partitions as a spatial axis.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule SplitK(ffi::Array<Integer> split_factors,
+                                     int64_t min_reduction_extent, int64_t max_spatial_extent,
+                                     ScheduleRule tiling);
   /*!
    * \brief Auto bind loops around the block to BlockIdx and ThreadIdx
    * \param max_threadblocks The maximum number of threadblock on GPU
@@ -284,6 +323,24 @@ class ScheduleRule : public runtime::ObjectRef {
    */
   TVM_DLL static ScheduleRule AutoBind(int max_threadblocks, ffi::Array<Integer> thread_extents,
                                        int max_threads_per_block = -1);
+  /*!
+   * \brief Stage the read-only parameters of a reduction block, e.g. the input and the weight of a
+   * convolution, into 2d textures, so that they are read through the texture cache of GPUs such as
+   * Adreno. The scope is chosen among the texture layouts by the texture limits of the target, and
+   * the rule keeps the unchanged schedule next to the texture variant.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule CacheReadTexture();
+  /*!
+   * \brief Fuse a stage into the sliding window of its consumer, e.g. a convolution followed by
+   * a pooling, by computing it at the consumer's outermost loop it can roll along and converting
+   * its output into a rolling buffer, which only holds the rows of a window. The rule keeps the
+   * unchanged schedule next to the fused one, and marks the fused loop nest as not parallelizable.
+   * \param max_buffer_bytes The largest rolling buffer in bytes, e.g. the size of the L2 cache,
+   * -1 for no limit.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule RollingBuffer(int64_t max_buffer_bytes);
   /*!
    * \brief Create a schedule rule with customized methods on the python-side.
    * \param f_initialize_with_tune_context The packed function of `InitializeWithTuneContext`.
@@ -300,7 +357,7 @@ class ScheduleRule : public runtime::ObjectRef {
 
   /*! \brief Create default schedule rules for LLVM */
   TVM_DLL static ffi::Array<ScheduleRule, void> DefaultLLVM();
-  /*! \brief Create default schedule rules for x86 (AVX512 and VNNI) */
+  /*! \brief Create default schedule rules for x86 (AVX512, VNNI and AMX) */
   TVM_DLL static ffi::Array<ScheduleRule, void> DefaultX86(const ffi::String& type);
   /*! \brief Create default schedule rules for CUDA */
   TVM_DLL static ffi::Array<ScheduleRule, void> DefaultCUDA();
@@ -308,6 +365,8 @@ class ScheduleRule : public runtime::ObjectRef {
   TVM_DLL static ffi::Array<ScheduleRule, void> DefaultCUDATensorCore();
   /*! \brief Create default schedule rules for Hexagon */
   TVM_DLL static ffi::Array<ScheduleRule, void> DefaultHexagon();
+  /*! \brief Create default schedule rules for Adreno */
+  TVM_DLL static ffi::Array<ScheduleRule, void> DefaultAdreno();
   /*! \brief Create default schedule rules for ARM CPU (NEON and DOTPROD) */
   TVM_DLL static ffi::Array<ScheduleRule, void> DefaultARM(const ffi::String& type);
   /*! \brief Create default schedule rules for RISCV CPU (RVV) */
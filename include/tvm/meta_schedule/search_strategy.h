@@ -206,15 +206,21 @@ class SearchStrategy : public runtime::ObjectRef {
    * \param genetic_mutate_prob The probability of mutation.
    * \param genetic_max_fail_count The maximum number to try evolving the given trace.
    * \param eps_greedy The ratio to select samples in a greedy fashion via their predicted score.
+   * \param genetic_pipeline_prediction Whether to overlap the mutation of a generation with the
+   *  score prediction of its finished candidates.
+   * \param genetic_early_stop_patience The number of generations without improvement of the best
+   *  predicted scores before the evolution stops early, or zero to always run all iterations.
    */
-  TVM_DLL static SearchStrategy EvolutionarySearch(int population_size,         //
-                                                   double init_measured_ratio,  //
-                                                   int init_min_unmeasured,     //
-                                                   int max_fail_count,          //
-                                                   int genetic_num_iters,       //
-                                                   double genetic_mutate_prob,  //
-                                                   int genetic_max_fail_count,  //
-                                                   double eps_greedy);
+  TVM_DLL static SearchStrategy EvolutionarySearch(int population_size,               //
+                                                   double init_measured_ratio,        //
+                                                   int init_min_unmeasured,           //
+                                                   int max_fail_count,                //
+                                                   int genetic_num_iters,             //
+                                                   double genetic_mutate_prob,        //
+                                                   int genetic_max_fail_count,        //
+                                                   double eps_greedy,                 //
+                                                   bool genetic_pipeline_prediction,  //
+                                                   int genetic_early_stop_patience);
 
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(SearchStrategy, ObjectRef, SearchStrategyNode);
 };
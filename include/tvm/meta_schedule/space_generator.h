@@ -201,12 +201,15 @@ class SpaceGenerator : public runtime::ObjectRef {
    * \param sch_rules The schedule rules.
    * \param postprocs The postprocessors.
    * \param mutator_probs The probability of using certain mutator.
+   * \param max_resamples The number of times a schedule rule is re-applied to a block when the
+   * schedules it produces exceed the thread, shared memory or register limits of a GPU target.
+   * Zero disables the checks, leaving them to the postprocessors.
    * \return The design space generator created.
    */
   TVM_DLL static SpaceGenerator PostOrderApply(
       ffi::Function f_block_filter, ffi::Optional<ffi::Array<ScheduleRule>> sch_rules,
       ffi::Optional<ffi::Array<Postproc>> postprocs,
-      ffi::Optional<ffi::Map<Mutator, FloatImm>> mutator_probs);
+      ffi::Optional<ffi::Map<Mutator, FloatImm>> mutator_probs, int max_resamples = 0);
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NOTNULLABLE(SpaceGenerator, ObjectRef, SpaceGeneratorNode);
 };
 
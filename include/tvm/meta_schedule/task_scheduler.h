@@ -31,6 +31,7 @@
 #include <tvm/runtime/object.h>
 #include <tvm/support/random_engine.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -59,6 +60,13 @@ class TaskRecordNode : public runtime::Object {
   ffi::Optional<ffi::Array<BuilderResult>> builder_results = std::nullopt;
   /*! \brief Packed functions to fetch the runner results asynchronously. */
   ffi::Optional<ffi::Array<RunnerFuture>> runner_futures = std::nullopt;
+  /*!
+   * \brief Set when the candidates are built in the background: waits until they are sent to the
+   * runner, and then publishes `builder_results`.
+   */
+  std::function<void()> f_finish_submission = nullptr;
+  /*! \brief The order in which the running batch of the task was launched. */
+  int64_t launch_index = -1;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
@@ -140,6 +148,11 @@ class TaskSchedulerNode : public runtime::Object {
   ffi::Optional<CostModel> cost_model_;
   /*! \brief The number of remaining tasks to be tuned. */
   int remaining_tasks_;
+  /*!
+   * \brief The maximum number of batches being built or measured at once across tasks, with the
+   * building done in the background. 0 builds each batch synchronously before searching the next.
+   */
+  int num_inflight_batches = 0;
 
   /*! \brief The default destructor. */
   virtual ~TaskSchedulerNode() = default;
@@ -151,7 +164,8 @@ class TaskSchedulerNode : public runtime::Object {
         .def_ro("measure_callbacks_", &TaskSchedulerNode::measure_callbacks_)
         .def_ro("database_", &TaskSchedulerNode::database_)
         .def_ro("cost_model_", &TaskSchedulerNode::cost_model_)
-        .def_ro("remaining_tasks_", &TaskSchedulerNode::remaining_tasks_);
+        .def_ro("remaining_tasks_", &TaskSchedulerNode::remaining_tasks_)
+        .def_ro("num_inflight_batches", &TaskSchedulerNode::num_inflight_batches);
   }
 
   /*!
@@ -200,6 +214,10 @@ class TaskSchedulerNode : public runtime::Object {
   void TouchTask(int task_id);
   /*! \brief Print out a human-readable format of the tuning statistics. */
   void PrintTuningStatistics();
+  /*! \brief The number of tasks whose running batch is not joined yet. */
+  int NumInflightBatches() const;
+  /*! \brief The task whose running batch was launched the earliest, or -1 if there is none. */
+  int OldestInflightTask() const;
 
   static constexpr const bool _type_mutable = true;
   TVM_FFI_DECLARE_OBJECT_INFO("meta_schedule.TaskScheduler", TaskSchedulerNode, Object);
@@ -266,19 +284,39 @@ class TaskScheduler : public runtime::ObjectRef {
   /*!
    * \brief Create a task scheduler that fetches tasks in a round-robin fashion.
    * \param logger The tuning task's logging function.
+   * \param num_inflight_batches The maximum number of batches built or measured at once.
    * \return The task scheduler created.
    */
-  TVM_DLL static TaskScheduler RoundRobin(ffi::Function logger);
+  TVM_DLL static TaskScheduler RoundRobin(ffi::Function logger, int num_inflight_batches = 0);
   /*!
    * \brief Create a task scheduler that fetches tasks in a gradient based fashion.
    * \param logger The tuning task's logging function.
    * \param alpha The parameter alpha to control gradient computation.
    * \param window_size The parameter to control backward window size.
    * \param seed The random seed.
+   * \param num_inflight_batches The maximum number of batches built or measured at once.
    * \return The task scheduler created.
    */
   TVM_DLL static TaskScheduler GradientBased(ffi::Function logger, double alpha, int window_size,
-                                             support::LinearCongruentialEngine::TRandState seed);
+                                             support::LinearCongruentialEngine::TRandState seed,
+                                             int num_inflight_batches = 0);
+  /*!
+   * \brief Create a task scheduler that picks the task with the highest upper confidence bound
+   * of the reduction of the end-to-end latency, and stops the tasks not worth tuning any more.
+   * \param logger The tuning task's logging function.
+   * \param exploration The scale of the exploration bonus.
+   * \param window_size The number of recent rounds averaged into the expected reduction.
+   * \param min_gain The expected reduction, relative to the end-to-end latency, below which a
+   * task is terminated.
+   * \param min_rounds The number of rounds a task is tuned before it can be terminated.
+   * \param seed The random seed.
+   * \param num_inflight_batches The maximum number of batches built or measured at once.
+   * \return The task scheduler created.
+   */
+  TVM_DLL static TaskScheduler UCB(ffi::Function logger, double exploration, int window_size,
+                                   double min_gain, int min_rounds,
+                                   support::LinearCongruentialEngine::TRandState seed,
+                                   int num_inflight_batches = 0);
   /*!
    * \brief Create a task scheduler with customized methods on the python-side.
    * \param logger The tuning task's logging function.
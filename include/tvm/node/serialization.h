@@ -47,5 +47,28 @@ TVM_DLL std::string SaveJSON(ffi::Any node);
  */
 TVM_DLL ffi::Any LoadJSON(std::string json_str);
 
+/*!
+ * \brief Save the node as well as all the node it depends on in a compact binary format.
+ *
+ * It encodes the same graph as SaveJSON, with the strings interned, varint integers and the
+ * tensors as raw bytes, so it is smaller and loads faster.
+ *
+ * \return The binary representation of the node.
+ */
+TVM_DLL std::string SaveBinary(ffi::Any node);
+
+/*!
+ * \brief Load the node saved by SaveBinary.
+ * \param data The binary data.
+ * \return The loaded node.
+ */
+TVM_DLL ffi::Any LoadBinary(const std::string& data);
+
+/*!
+ * \brief Whether the data is in the format of SaveBinary.
+ * \param data The data to check.
+ */
+TVM_DLL bool IsBinaryGraph(const std::string& data);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
@@ -107,6 +107,32 @@ class StructuralEqual : public BaseValueEqual {
    */
   TVM_DLL bool operator()(const ffi::Any& lhs, const ffi::Any& rhs,
                           const bool map_free_params = false) const;
+  /*!
+   * \brief Check whether two values may be structurally equal, without a full traversal.
+   *
+   *  The check only rejects: false means that lhs and rhs differ, true that the full
+   *  comparison is needed. Up to max_depth, it compares the types, the POD and string
+   *  values, the lengths of the arrays and maps, and the functions of the modules by name.
+   *  When the StructuralHashCache is enabled, the functions of the modules are also
+   *  compared by their cached hash values, which only differ for functions that differ.
+   *
+   * \param lhs The left operand.
+   * \param rhs The right operand.
+   * \param max_depth The depth of nested nodes to check.
+   * \return Whether the values may be equal.
+   */
+  TVM_DLL static bool MayEqual(const ffi::Any& lhs, const ffi::Any& rhs, int max_depth = 4);
+  /*!
+   * \brief Compare objects via structural equal, rejecting them by MayEqual first.
+   * \param lhs The left operand.
+   * \param rhs The right operand.
+   * \param map_free_vars Whether or not to map free variables.
+   * \param skip_tensor_content Whether to skip the contents of tensors.
+   * \return The comparison result.
+   */
+  TVM_DLL static bool EqualWithPrecheck(const ffi::Any& lhs, const ffi::Any& rhs,
+                                        bool map_free_vars = false,
+                                        bool skip_tensor_content = false);
 };
 
 }  // namespace tvm
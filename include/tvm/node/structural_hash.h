@@ -125,5 +125,48 @@ class StructuralHash : public BaseValueHash {
   TVM_DLL uint64_t operator()(const ffi::Any& key) const;
 };
 
+/*!
+ * \brief Opt-in cache of the structural hash values of IR objects.
+ *
+ *  IR objects are immutable once shared, and the cache holds a reference to each
+ *  cached object, which stops CopyOnWrite from mutating it in place. Hashing the same
+ *  object again, e.g. a module kept in a tuning database, is then a lookup. An IRModule
+ *  is updated in place, e.g. by IRModuleNode::Add, so its entry also records its fields
+ *  and is dropped once one of them is replaced.
+ *
+ *  The cache is disabled with a capacity of zero, which is the default. The hash
+ *  values are the same as the ones of ffi::StructuralHash::Hash, as long as the
+ *  contents of the hashed tensors are not written after hashing.
+ */
+class StructuralHashCache {
+ public:
+  /*! \brief The counters of the cache lookups. */
+  struct Stats {
+    int64_t hits{0};
+    int64_t misses{0};
+  };
+
+  /*!
+   * \brief Compute the structural hash of a value, through the cache when enabled.
+   * \param object The value to be hashed.
+   * \param map_free_vars Whether to hash free variables by the order of their occurrences.
+   * \param skip_tensor_content Whether to skip the contents of tensors.
+   * \return The hash value.
+   */
+  TVM_DLL static uint64_t Hash(const ffi::Any& object, bool map_free_vars = false,
+                               bool skip_tensor_content = false);
+  /*!
+   * \brief Set the number of hash values to keep, evicting the least recently used ones.
+   * \param capacity The capacity, where zero disables and empties the cache.
+   */
+  TVM_DLL static void SetCapacity(int64_t capacity);
+  /*! \brief Get the capacity of the cache. */
+  TVM_DLL static int64_t GetCapacity();
+  /*! \brief Get the counters of the cache lookups. */
+  TVM_DLL static Stats GetStats();
+  /*! \brief Drop all the cached hash values and reset the counters. */
+  TVM_DLL static void Clear();
+};
+
 }  // namespace tvm
 #endif  // TVM_NODE_STRUCTURAL_HASH_H_
@@ -584,6 +584,24 @@ TVM_DLL bool ContainsImpureCall(
  */
 TVM_DLL bool WellFormed(ffi::Variant<IRModule, Function> obj, bool check_struct_info = true);
 
+/*!
+ * \brief Check if the IRModule is well formed, assuming that prev_mod was.
+ *
+ * Only the functions that differ from those bound to the same GlobalVar in prev_mod, by
+ * pointer equality, are checked, which makes the check cheap after a pass that only changed
+ * a few functions of a large module.
+ *
+ * \param mod The IRModule to check.
+ * \param prev_mod A well-formed IRModule, usually the input of the pass that produced mod.
+ * \param check_struct_info A boolean flag indicating if the property "every Expr
+ * must have defined structure info" will be checked.
+ * \return true if the changed functions are well formed, false if not.
+ * \note The checks across functions, such as a variable used as the parameter of two
+ *  functions, are only done among the changed functions.
+ */
+TVM_DLL bool WellFormedIncremental(const IRModule& mod, const IRModule& prev_mod,
+                                   bool check_struct_info = true);
+
 /*!
  * \brief Using the layout transforms on the outputs, suggest layout transformation on the blocks
  * and buffers for the PrimFunc.
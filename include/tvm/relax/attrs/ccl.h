@@ -48,7 +48,7 @@ struct AllReduceAttrs : public tvm::AttrsNodeReflAdapter<AllReduceAttrs> {
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("relax.attrs.AllReduceAttrs", AllReduceAttrs, BaseAttrsNode);
 };  // struct AllReduceAttrs
 
-/*! \brief Attributes used in allgather operators */
+/*! \brief Attributes used in allgather and alltoall operators */
 struct AllGatherAttrs : public tvm::AttrsNodeReflAdapter<AllGatherAttrs> {
   int num_workers;
   bool in_group;
@@ -85,6 +85,31 @@ struct ScatterCollectiveAttrs : public tvm::AttrsNodeReflAdapter<ScatterCollecti
                                     BaseAttrsNode);
 };  // struct ScatterCollectiveAttrs
 
+/*! \brief Attributes used in the ring attention operator */
+struct RingAttentionAttrs : public tvm::AttrsNodeReflAdapter<RingAttentionAttrs> {
+  int num_workers;
+  bool in_group;
+  bool causal;
+  ffi::Optional<FloatImm> scale;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<RingAttentionAttrs>()
+        .def_ro("num_workers", &RingAttentionAttrs::num_workers,
+                "The number of workers in the ring, each holding a block of the sequence.")
+        .def_ro("in_group", &RingAttentionAttrs::in_group,
+                "Whether the ring is formed by the workers of a group or by all the workers.")
+        .def_ro("causal", &RingAttentionAttrs::causal,
+                "Whether a query only attends to the keys at the same or earlier positions of "
+                "the whole sequence.")
+        .def_ro("scale", &RingAttentionAttrs::scale,
+                "The custom scale applied before the softmax. The default value is "
+                "1 / sqrt(head_dim).");
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("relax.attrs.RingAttentionAttrs", RingAttentionAttrs,
+                                    BaseAttrsNode);
+};  // struct RingAttentionAttrs
+
 }  // namespace relax
 }  // namespace tvm
 
@@ -36,13 +36,18 @@ namespace relax {
 struct AllClassNonMaximumSuppressionAttrs
     : public AttrsNodeReflAdapter<AllClassNonMaximumSuppressionAttrs> {
   ffi::String output_format;
+  bool fixed_output;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
-    refl::ObjectDef<AllClassNonMaximumSuppressionAttrs>().def_ro(
-        "output_format", &AllClassNonMaximumSuppressionAttrs::output_format,
-        "Output format, onnx or tensorflow. Returns outputs in a way that can be easily "
-        "consumed by each frontend.");
+    refl::ObjectDef<AllClassNonMaximumSuppressionAttrs>()
+        .def_ro("output_format", &AllClassNonMaximumSuppressionAttrs::output_format,
+                "Output format, onnx or tensorflow. Returns outputs in a way that can be easily "
+                "consumed by each frontend.")
+        .def_ro("fixed_output", &AllClassNonMaximumSuppressionAttrs::fixed_output,
+                "Whether the onnx indices keep their fixed, maximum shape instead of being "
+                "trimmed to the selected boxes, e.g. to be captured by CUDA graphs.",
+                refl::DefaultValue(false));
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("relax.attrs.AllClassNonMaximumSuppressionAttrs",
                                     AllClassNonMaximumSuppressionAttrs, BaseAttrsNode);
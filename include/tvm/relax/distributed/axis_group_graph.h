@@ -398,6 +398,29 @@ class AxisGroupGraph {
     }
   }
 
+  /*!
+   * \brief Get the axis group of an axis, i.e. all the axes connected to it, which a sharding spec
+   * of the axis propagates to when nothing cuts the propagation.
+   *
+   * \param axis the specified axis
+   * \return the axis group, which contains the axis itself
+   */
+  AxisGroup GetAxisGroup(Axis axis) {
+    AxisGroup axis_group;
+    std::vector<Axis> stack = {axis};
+    axis_group.insert(axis);
+    while (!stack.empty()) {
+      Axis cur = stack.back();
+      stack.pop_back();
+      for (const auto& edge : graph_[cur]) {
+        if (axis_group.insert(edge.dst).second) {
+          stack.push_back(edge.dst);
+        }
+      }
+    }
+    return axis_group;
+  }
+
  private:
   void AddEdge(Axis src, Axis dst, EdgeType type) {
     if (!graph_.count(src)) {
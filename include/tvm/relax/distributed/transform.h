@@ -26,6 +26,7 @@
 
 #include <tvm/ir/transform.h>
 #include <tvm/relax/dataflow_pattern.h>
+#include <tvm/relax/distributed/global_info.h>
 #include <tvm/relax/expr.h>
 #include <tvm/relax/transform.h>
 #include <tvm/tir/function.h>
@@ -50,6 +51,40 @@ using tvm::transform::CreateModulePass;
  */
 TVM_DLL Pass PropagateSharding();
 
+/*!
+ * \brief Choose the sharding of each function exposed with a global symbol that has no sharding
+ * annotation, annotate its parameters, and propagate the sharding to DistIR.
+ *
+ * The pass searches the axis group of the AxisGroupGraph sharded along each device mesh axis,
+ * which covers data, tensor and sequence parallelism, and picks the one of the lowest estimated
+ * compute and communication time whose memory per device fits the limit.
+ *
+ * \param device_mesh The device mesh to shard the functions over.
+ * \param memory_limit The limit of the memory of a device in bytes, or 0 for no limit.
+ * \param device_flops The FLOPs per second of a device in the cost model.
+ * \param link_bandwidth The bytes per second of the links between the devices in the cost model.
+ * \return The Pass.
+ */
+TVM_DLL Pass AutoSharding(DeviceMesh device_mesh, int64_t memory_limit = 0,
+                          double device_flops = 1e14, double link_bandwidth = 1e11);
+
+/*!
+ * \brief Partition a function into consecutive pipeline stages balanced by the estimated FLOPs
+ * and weight bytes of each stage.
+ *
+ * Stage i is added as `{func_name}_stage{i}`, taking the activations from the previous stage,
+ * or the inputs of the function for the first stage, followed by the weights it uses, and
+ * returning the tuple of the activations used by the later stages. The last stage returns the
+ * result of the function. Each stage after the first also gets `{func_name}_stage{i}_recv_buffers`
+ * allocating the buffers for the activations it receives. The original function is kept.
+ *
+ * \param func_name The name of the function to partition. Its first `num_input` parameters are
+ * the inputs of each micro-batch, and the others are the weights.
+ * \param num_stages The number of pipeline stages.
+ * \return The Pass.
+ */
+TVM_DLL Pass PartitionPipelineStages(ffi::String func_name, int num_stages);
+
 /*!
  * \brief Lower global view TensorIR into local view.
  *
@@ -70,6 +105,16 @@ TVM_DLL Pass LegalizeRedistribute();
  * \return The Pass.
  */
 TVM_DLL Pass LowerDistIR();
+
+/*!
+ * \brief Lower the grouped GEMMs over the local share of the experts of mixture-of-experts
+ * layers to expert parallelism, with an all-to-all exchanging the rows with the workers owning
+ * their experts before the GEMM, and another returning the outputs after it.
+ * \param num_workers The number of workers the experts are distributed over.
+ * \param num_experts The total number of experts.
+ * \return The Pass.
+ */
+TVM_DLL Pass LowerExpertParallel(int num_workers, int num_experts);
 }  // namespace transform
 }  // namespace distributed
 }  // namespace relax
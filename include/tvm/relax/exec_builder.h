@@ -31,6 +31,7 @@
 #include <tvm/runtime/vm/bytecode.h>
 #include <tvm/runtime/vm/executable.h>
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -108,6 +109,12 @@ class ExecBuilderNode : public Object {
    * \return The argument corresponding to the function index.
    */
   vm::Instruction::Arg GetFunction(const std::string& name);
+  /*!
+   * \brief Get the kind of a declared function.
+   * \param name The name of the function.
+   * \return The kind, std::nullopt if the function is not declared.
+   */
+  std::optional<vm::VMFuncInfo::FuncKind> GetDeclaredKind(const std::string& name) const;
   /*!
    * \brief Convert a constant value something that exec builder can understand.
    *
@@ -174,6 +181,11 @@ class ExecBuilderNode : public Object {
    * \brief Formalize the executable.
    */
   void Formalize();
+  /*!
+   * \brief Compute the liveness of the registers of the VM functions, and record the registers
+   *  to release after each instruction, i.e. the ones it uses or defines that are dead after it.
+   */
+  void BuildReleaseTables();
 
   /*! \brief The mutable internal executable. */
   ObjectPtr<vm::VMExecutable> exec_;  // mutable
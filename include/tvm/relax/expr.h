@@ -897,6 +897,13 @@ constexpr const char* kForcePure = "relax.force_pure";
  * arguments are assumed to be weights that are fixed across invocations.
  */
 constexpr const char* kNumInput = "num_input";
+
+/*!
+ * \brief How the VM runs the function when it is built with exec_mode "auto": "compiled" to TIR,
+ * or "bytecode" for the interpreter. When unset, the functions with static control flow are
+ * compiled.
+ */
+constexpr const char* kVMExecMode = "relax.vm_exec_mode";
 }  // namespace attr
 
 /*! \brief The extern function, which can represent packed function. */
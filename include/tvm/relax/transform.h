@@ -151,6 +151,18 @@ TVM_DLL Pass StaticPlanBlockMemory();
  */
 TVM_DLL Pass AttachGlobalSymbol();
 
+/*!
+ * \brief Keep a single PrimFunc of each group of structurally equal private PrimFuncs, and
+ * redirect the calls of the others to it.
+ *
+ * The PrimFuncs produced per call site by LegalizeOps and FuseTIR are often identical across the
+ * layers of a model. Merging them before codegen means each kernel is compiled once. The PrimFuncs
+ * that have a global symbol are left as is, since they may be called by their name.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass DeduplicatePrimFuncs();
+
 /*!
  * \brief Transform Relax IR to normal form: transform AST to A-normal form, and fill the
  * struct_info_ of expressions.
@@ -512,6 +524,24 @@ TVM_DLL Pass Gradient(ffi::String func_name,
                       ffi::Optional<ffi::Array<Var>> require_grads = std::nullopt,
                       int target_index = 0);
 
+/*!
+ * \brief Pick the forward activations of a function kept for its backward pass under a memory
+ * budget, and annotate the others with start_checkpoint and end_checkpoint, so that the Gradient
+ * pass recomputes them in the backward pass instead of keeping them alive.
+ *
+ * The activations are picked greedily by segments of consecutive bindings. The peak activation
+ * memory is estimated by the bytes of the kept activations plus the largest recomputed segment.
+ * Tensors of symbolic shapes are always kept and are not counted in the budget. Functions already
+ * annotated with checkpoints are left unchanged.
+ *
+ * \param func_name The name of the function to be differentiated.
+ * \param memory_budget The budget of the activations kept for the backward pass, in bytes.
+ * \return The Pass.
+ *
+ * \note The pass is to be applied right before Gradient, on a function of one dataflow block.
+ */
+TVM_DLL Pass AutoCheckpoint(ffi::String func_name, int64_t memory_budget);
+
 /*!
  * \brief Apply pattern matching to each function in the given module, and group matched
  * expressions into a new function. The end result is similar to FuseOps, but fusion is driven
@@ -658,13 +688,21 @@ TVM_DLL Pass DataflowUseInplaceCalls();
  * \param out_dtype The output data type of gemm/conv, which is the data type of the accumulator.
  * \param fp16_input_names The names of function parameters whose dtype should become fp16. The
  * function signature would change accordingly.
+ * \param fp8_dtype If defined, the fp8 dtype (float8_e4m3fn or float8_e5m2) of the inputs of the
+ * matmuls, which are then quantized with scales and dequantized after the matmul.
+ * \param fp8_scaling The granularity of the fp8 scales, "tensor" or "channel".
+ * \param fp8_amax The amax of the matmul inputs from calibration, by var name. The inputs
+ * without one use the amax of the current tensor. Only used by per-tensor scales.
  * \return The Pass.
  *
  * \note Mainly operates within dataflow blocks. ConvertToDataflow may need to be called first.
  */
 TVM_DLL Pass
 ToMixedPrecision(const DataType& out_dtype,
-                 ffi::Optional<ffi::Array<ffi::String>> fp16_input_names = std::nullopt);
+                 ffi::Optional<ffi::Array<ffi::String>> fp16_input_names = std::nullopt,
+                 ffi::Optional<DataType> fp8_dtype = std::nullopt,
+                 ffi::String fp8_scaling = "tensor",
+                 ffi::Optional<ffi::Map<ffi::String, double>> fp8_amax = std::nullopt);
 
 /*!
  * \brief Rewrite a Relax module for executing with CUDA graph. This pass identifies
@@ -673,6 +711,57 @@ ToMixedPrecision(const DataType& out_dtype,
  */
 TVM_DLL Pass RewriteCUDAGraph();
 
+/*!
+ * \brief Split each `ccl.allreduce` in dataflow blocks into `ccl.allreduce_start` and
+ * `ccl.allreduce_wait`, and sink the wait to the first use of the allreduce result. The compute
+ * in between runs while the allreduce is in flight on the communication stream.
+ * \return The Pass.
+ */
+TVM_DLL Pass ScheduleAsyncAllReduce();
+
+/*!
+ * \brief Decompose each `ccl.allreduce` of the output of a row-parallel matmul into chunks of the
+ * rows, and start the allreduce of each chunk right after its matmul. The allreduce of a chunk
+ * then runs on the communication stream while the matmul of the next chunk is computed.
+ * \param num_chunks The number of chunks the rows of the matmul are split into.
+ * \return The Pass.
+ */
+TVM_DLL Pass DecomposeCollectiveMatmul(int num_chunks = 4);
+
+/*!
+ * \brief Run each call of a dataflow block to a function of the external modules, e.g. a BYOC
+ * region produced by RunCodegen, on a side stream of its device, and wait for its result right
+ * before its first use. The independent external calls overlap with each other and with the
+ * kernels in between.
+ * \param num_streams The number of side streams the external calls in flight rotate over.
+ * \return The Pass.
+ */
+TVM_DLL Pass ScheduleAsyncExternCalls(int num_streams = 2);
+
+/*!
+ * \brief Combine independent `call_tir`s of a dataflow block into one kernel launch. Each PrimFunc
+ * must already be scheduled for CUDA or ROCm as a single kernel with a static one-dimensional grid.
+ * The combined kernel runs the i-th PrimFunc on the i-th range of `blockIdx.x`, so launching many
+ * small kernels, e.g. per-head norms, costs a single launch.
+ * \param max_num_blocks The largest grid of a kernel to combine. Larger kernels already occupy the
+ * device, and are not worth combining.
+ * \param max_group_size The maximum number of kernels combined into one launch.
+ * \return The Pass.
+ */
+TVM_DLL Pass HorizontalFuseTIR(int64_t max_num_blocks = 256, int64_t max_group_size = 16);
+
+/*!
+ * \brief Fuse sequences of `call_tir`s in dataflow blocks into one persistent CUDA kernel. This is
+ * an experimental lowering for latency-bound workloads such as batch-1 decode. Each PrimFunc must
+ * already be scheduled as a single kernel with a static one-dimensional grid. The stages of the
+ * persistent kernel run one after another on the same grid, and a stage that reads the result of
+ * an earlier one waits at a grid-wide barrier first.
+ * \param max_num_blocks The upper bound of the persistent grid. The barrier requires all blocks to
+ * be resident on the device at once, so this must not exceed the occupancy of the device.
+ * \return The Pass.
+ */
+TVM_DLL Pass FusePersistentKernel(int64_t max_num_blocks = 128);
+
 /*!
  * \brief The pass is designed for few shot tuning for static shape PrimFuncs. It examines all the
  *  blocks within the PrimFunc and conducts loop fusion, splitting, and other transformations based
@@ -692,6 +781,62 @@ TVM_DLL Pass FewShotTuning(int valid_count, bool benchmark);
  */
 TVM_DLL Pass SpecializePrimFuncBasedOnCallSite();
 
+/*!
+ * \brief Specialize the kernels of call_tir for the shape buckets of symbolic variables, and
+ *  dispatch the calls to the variant of their bucket at runtime.
+ *
+ * For each call_tir whose kernel has a bucketed variable in its buffer shapes, the kernel is
+ * copied once per bucket with the upper bound of the bucket in its "tir_var_upper_bound"
+ * attribute, and the call is rewritten into a call of "vm.builtin.shape_bucket_dispatch". The
+ * dispatcher runs the variant of the smallest bucket that holds the value of the variable, or
+ * the generic kernel beyond the last bucket.
+ *
+ * \param buckets The increasing upper bounds of the buckets of each symbolic variable, by the
+ *  name of the variable in the kernels.
+ * \param tune_online Whether the dispatcher benchmarks the variants valid for a bucket on its
+ *  first call, and runs the fastest one for the later calls of the bucket.
+ * \return The Pass.
+ */
+TVM_DLL Pass SpecializeCallTIRByShapeBucket(ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                                            bool tune_online);
+
+/*!
+ * \brief Dispatch the 2D matmuls of dynamic shapes to either their TIR kernel or a vendor
+ *  library at runtime.
+ *
+ * The matmuls are legalized to their TIR kernel, and called through
+ * "vm.builtin.gemm_library_dispatch", which runs the TIR kernel or
+ * "tvm.contrib.<library>.matmul" whichever the GEMM dispatch table records as faster for the
+ * bucket of the (M, N, K) shape. The table is measured once at deploy time, and saved next to
+ * the executable with "vm.builtin.gemm_dispatch_table.save" to be loaded by the later runs.
+ * The buckets missing from the table run the TIR kernel.
+ *
+ * \param library The library, e.g. "cublas", "hipblas" or "rocblas".
+ * \return The Pass.
+ */
+TVM_DLL Pass DispatchDynamicMatmulToLibrary(ffi::String library);
+
+/*!
+ * \brief Specialize Relax functions for the shape buckets of a symbolic variable of their
+ *  parameters, and make them dispatch to the static function of the bucket of each call.
+ *
+ * Each function is cloned once per bucket with the variable bound to the upper bound of the
+ * bucket, and once more with the variable left symbolic. The function itself becomes a
+ * dispatcher, which pads the parameters with zeros along the variable up to the smallest bucket
+ * holding its value, calls the static clone and slices the results back. The values beyond the
+ * last bucket call the symbolic clone. Only the variables that appear as the extents of tensor
+ * dimensions are bucketed, and the padding must not change the unpadded part of the results,
+ * e.g. the variable is a batch dimension. The pass runs before legalization, so that the
+ * kernels of the static clones are fused and tuned for their static shapes.
+ *
+ * \param buckets The increasing upper bounds of the buckets of each symbolic variable, by name.
+ * \param func_name The name of the only function to specialize. All Relax functions are
+ *  specialized if not given.
+ * \return The Pass.
+ */
+TVM_DLL Pass SpecializeShapeBuckets(ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                                    ffi::Optional<ffi::String> func_name = std::nullopt);
+
 }  // namespace transform
 }  // namespace relax
 }  // namespace tvm
@@ -0,0 +1,50 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \brief Roofline metrics of CUDA kernels for profiling via CUPTI.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_CUPTI_H_
+#define TVM_RUNTIME_CONTRIB_CUPTI_H_
+
+#include <tvm/ffi/container/array.h>
+#include <tvm/runtime/profiling.h>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief Construct a metric collector that collects the metrics of the CUDA kernels with the
+ * CUPTI profiling API.
+ *
+ * Each call is profiled in a session of its own that replays its kernels as many times as the
+ * metrics need. By default the DRAM bytes, the achieved occupancy and the tensor core
+ * utilization are collected, along with the peak DRAM bandwidth of the device, from which
+ * `Report` places the calls with known FLOPs on the roofline. The kernel duration is always
+ * collected, since the wall-clock duration of a call also counts the replays.
+ *
+ * \param metrics The names of the metrics to collect instead, as listed by
+ * `ncu --query-metrics`.
+ */
+TVM_DLL MetricCollector CreateCUPTIMetricCollector(ffi::Array<ffi::String> metrics);
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_CUPTI_H_
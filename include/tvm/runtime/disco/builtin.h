@@ -79,6 +79,33 @@ TVM_DLL Tensor DiscoEmptyTensor(ffi::Shape shape, DataType dtype, ffi::Optional<
  * \param recv The array receives the outcome of allreduce
  */
 TVM_DLL void AllReduce(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv);
+/*!
+ * \brief Start an allreduce on the communication stream, after the work issued so far on the
+ * compute stream. The outcome is not ready until AllReduceWait is called on `recv`.
+ * \param send The array send to perform allreduce on
+ * \param reduce_kind The kind of reduction operation (e.g. sum, avg, min, max)
+ * \param in_group Whether the allreduce operation performs globally or in group as default.
+ * \param recv The array receives the outcome of allreduce
+ */
+TVM_DLL void AllReduceStart(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv);
+/*!
+ * \brief Make the compute stream wait for the allreduce started by AllReduceStart.
+ * \param recv The array receives the outcome of allreduce
+ * \param send The array send to perform allreduce on, which must stay alive until the wait
+ * \return The array `recv`
+ */
+TVM_DLL Tensor AllReduceWait(Tensor recv, Tensor send);
+/*!
+ * \brief Perform an allreduce that exchanges block-quantized data, trading accuracy for a
+ * smaller communication volume. Only sum and avg are supported.
+ * \param send The array send to perform allreduce on
+ * \param reduce_kind The kind of reduction operation, either sum or avg
+ * \param in_group Whether the allreduce operation performs globally or in group as default.
+ * \param quantization The format of the exchanged data, "int8" or "e4m3"
+ * \param recv The array receives the outcome of allreduce
+ */
+TVM_DLL void AllReduceQuantized(Tensor send, ReduceKind reduce_kind, bool in_group,
+                                ffi::String quantization, Tensor recv);
 /*!
  * \brief Perform an allgather operation using the underlying communication library
  * \param send The array send to perform allgather on
@@ -86,6 +113,19 @@ TVM_DLL void AllReduce(Tensor send, ReduceKind reduce_kind, bool in_group, Tenso
  * \param recv The array receives the outcome of allgather
  */
 TVM_DLL void AllGather(Tensor send, bool in_group, Tensor recv);
+/*!
+ * \brief Perform an all-to-all operation using the underlying communication library. The
+ * buffers are split along their first axis, and split i of `send` goes to the worker i.
+ * \param send The buffer to be split and sent to each worker.
+ * \param send_splits The number of rows of `send` sent to each worker, or an empty shape to
+ * split `send` evenly.
+ * \param recv_splits The number of rows of `recv` received from each worker, or an empty shape
+ * to split `recv` evenly.
+ * \param in_group Whether the all-to-all operation performs globally or in group as default.
+ * \param recv The buffer receiving the splits from each worker, in the order of the workers.
+ */
+TVM_DLL void AllToAll(Tensor send, ffi::Shape send_splits, ffi::Shape recv_splits, bool in_group,
+                      Tensor recv);
 /*!
  * \brief Perform a broadcast operation from worker-0
  * \param send The buffer to be broadcasted
@@ -138,6 +178,37 @@ TVM_DLL void SendToWorker(Tensor buffer, int receiver_id);
  * \param sender_id The global sender worker id.
  */
 TVM_DLL void RecvFromWorker(Tensor buffer, int sender_id);
+/*!
+ * \brief Run the stages of a function partitioned by PartitionPipelineStages over micro-batches,
+ * where the group g of workers runs the stage g. Each stage receives its activations from the
+ * previous group and sends its outputs to the next group, so that the groups work on
+ * consecutive micro-batches at the same time.
+ * \param vm_module The RelaxVM module with the stages.
+ * \param func_name The name of the partitioned function.
+ * \param micro_batches The inputs of each micro-batch, only read by the first group.
+ * \param params The weights used by the stage of the worker.
+ * \return The results of the micro-batches on the last group, and empty on the others.
+ */
+TVM_DLL ffi::Array<ffi::Any> RunPipelineStages(ffi::Module vm_module, ffi::String func_name,
+                                               ffi::Array<ffi::Array<ffi::Any>> micro_batches,
+                                               ffi::Array<ffi::Any> params);
+/*!
+ * \brief Start sending a buffer to the next worker of the ring on the communication stream, while
+ * receiving the buffer of the previous worker, after the work issued so far on the compute stream.
+ * The received buffer is not ready until RingSendRecvWait is called on `recv`.
+ * \param send The buffer sent to the next worker of the ring.
+ * \param num_workers The number of workers of the ring.
+ * \param in_group Whether the ring is formed by the workers of a group or by all the workers.
+ * \param recv The buffer receiving from the previous worker of the ring.
+ */
+TVM_DLL void RingSendRecvStart(Tensor send, int num_workers, bool in_group, Tensor recv);
+/*!
+ * \brief Make the compute stream wait for the exchange started by RingSendRecvStart.
+ * \param recv The buffer receiving from the previous worker of the ring.
+ * \param send The buffer sent to the next worker, which must stay alive until the wait
+ * \return The array `recv`
+ */
+TVM_DLL Tensor RingSendRecvWait(Tensor recv, Tensor send);
 /*! \brief Get the local worker id */
 TVM_DLL int WorkerId();
 /*!
@@ -72,6 +72,7 @@
 #ifndef TVM_RUNTIME_DISCO_SESSION_H_
 #define TVM_RUNTIME_DISCO_SESSION_H_
 
+#include <tvm/ffi/container/array.h>
 #include <tvm/ffi/function.h>
 #include <tvm/runtime/int_tuple.h>
 #include <tvm/runtime/object.h>
@@ -97,6 +98,8 @@ enum class DiscoAction : int32_t {
   kCopyToWorker0 = 6,
   kDebugGetFromRemote = 7,
   kDebugSetRegister = 8,
+  kRecordCommandBuffer = 9,
+  kReplayCommandBuffer = 10,
 };
 
 /*! \brief Converts the enum class `DiscoAction` to string */
@@ -120,6 +123,10 @@ inline std::string DiscoAction2String(DiscoAction action) {
       return "kDebugGetFromRemote";
     case DiscoAction::kDebugSetRegister:
       return "kDebugSetRegister";
+    case DiscoAction::kRecordCommandBuffer:
+      return "kRecordCommandBuffer";
+    case DiscoAction::kReplayCommandBuffer:
+      return "kReplayCommandBuffer";
   }
   LOG(FATAL) << "ValueError: Unknown DiscoAction: " << static_cast<int>(action);
 }
@@ -251,6 +258,27 @@ class SessionObj : public Object {
    * \param worker_id The id of the worker to be set.
    */
   TVM_DLL virtual void DebugSetRegister(int64_t reg_id, ffi::AnyView value, int worker_id) = 0;
+  /*!
+   * \brief Start recording a command buffer. Until EndCommandBuffer is called, the packed
+   * function calls issued via CallPacked are recorded instead of being sent to the workers.
+   * \param num_placeholders The number of placeholder registers, whose values are provided
+   * by each replay of the command buffer.
+   * \return The placeholder registers, which can be used as arguments of the recorded calls.
+   */
+  TVM_DLL virtual ffi::Array<DRef> BeginCommandBuffer(int num_placeholders) = 0;
+  /*!
+   * \brief Finish recording a command buffer and ship it to all workers.
+   * \return The command buffer on workers. The registers used by the recorded calls stay alive
+   * until the command buffer is released.
+   */
+  TVM_DLL virtual DRef EndCommandBuffer() = 0;
+  /*!
+   * \brief Replay a command buffer on all workers with a single broadcast.
+   * \param command_buffer The command buffer returned by EndCommandBuffer.
+   * \param values The values of the placeholder registers for this replay.
+   */
+  TVM_DLL virtual void ReplayCommandBuffer(const DRef& command_buffer,
+                                           const ffi::PackedArgs& values) = 0;
 
   struct FFI;
   friend struct SessionObj::FFI;
@@ -274,8 +302,11 @@ class Session : public ObjectRef {
    * \brief Create a session backed by a thread pool of workers
    * \param num_workers The number of workers.
    * \param num_groups The number of worker groups.
+   * \param queue The queue of the messages between the threads, either "mutex" for a ring buffer
+   * guarded by a mutex, or "spin" for lock-free rings that the receivers spin on before they park.
    */
-  TVM_DLL static Session ThreadedSession(int num_workers, int num_groups);
+  TVM_DLL static Session ThreadedSession(int num_workers, int num_groups,
+                                         ffi::String queue = "mutex");
   /*!
    * \brief Create a session backed by pipe-based multiprocessing
    * \param num_workers The number of workers.
@@ -285,11 +316,14 @@ class Session : public ObjectRef {
    * When `worker-id` is 0, it shuts down the process pool; Otherwise, it retursn a tuple
    * (read_fd, writefd) used to communicate with the corresponding worker.
    * \param entrypoint The entrypoint of DiscoWorker main worker function.
+   * \param channel The channel to the workers after startup, either "pipe" to keep using the
+   * pipes of the process pool, or "shm" to use shared memory rings, which is Linux only.
    * \note Worker-0 is always co-located with the controler as a separate thread, and therefore
    * worker-0 does not exist in the process pool.
    */
   TVM_DLL static Session ProcessSession(int num_workers, int num_groups,
-                                        ffi::String process_pool_creator, ffi::String entrypoint);
+                                        ffi::String process_pool_creator, ffi::String entrypoint,
+                                        ffi::String channel);
 
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(Session, ObjectRef, SessionObj);
 };
@@ -42,6 +42,9 @@ namespace memory {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kBestFit,
+  /*! \brief Allocate and free in the order of the current stream, on the devices supporting it. */
+  kStreamOrdered,
 };
 
 struct Buffer {
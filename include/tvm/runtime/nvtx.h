@@ -21,6 +21,7 @@
 
 #include <tvm/runtime/base.h>
 
+#include <optional>
 #include <string>
 namespace tvm {
 namespace runtime {
@@ -42,6 +43,25 @@ class NVTXScopedRange {
   NVTXScopedRange& operator=(NVTXScopedRange&& other) = delete;
 };
 
+/*!
+ * \brief Whether the runtime annotates each VM call, KV cache forward and disco action with an
+ * NVTX range named after it, for the timelines of Nsight Systems.
+ *
+ * Off by default, and enabled by setting the environment variable TVM_NVTX_RANGES=1 or with
+ * `SetNVTXRangesEnabled`. Always false if TVM is not built against NVTX.
+ */
+TVM_DLL bool NVTXRangesEnabled();
+/*! \brief Enable or disable the NVTX ranges of `NVTXRangesEnabled`. */
+TVM_DLL void SetNVTXRangesEnabled(bool enabled);
+
+/*!
+ * \brief Enter an NVTX range for the rest of the scope when the NVTX ranges are enabled.
+ * The name is only evaluated when they are.
+ */
+#define TVM_NVTX_OPTIONAL_SCOPE(name)                                           \
+  std::optional<::tvm::runtime::NVTXScopedRange> _nvtx_optional_scope_;         \
+  if (::tvm::runtime::NVTXRangesEnabled()) _nvtx_optional_scope_.emplace(name);
+
 #ifdef _MSC_VER
 #define TVM_NVTX_FUNC_SCOPE() NVTXScopedRange _nvtx_func_scope_(__FUNCSIG__);
 #else
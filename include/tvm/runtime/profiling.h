@@ -314,6 +314,11 @@ class MetricCollectorNode : public Object {
    * one of DurationNode, PercentNode, CountNode, or String.
    */
   virtual ffi::Map<ffi::String, ffi::Any> Stop(ffi::ObjectRef obj) = 0;
+  /*! \brief Whether the collector can collect metrics of calls made within another call that
+   * it collects. Collectors that can't, such as those profiling a call by replaying its kernels,
+   * are not started for the overall "Total" time of the profiler.
+   */
+  virtual bool SupportsNesting() const { return true; }
 
   virtual ~MetricCollectorNode() {}
 
@@ -327,6 +332,21 @@ class MetricCollector : public ObjectRef {
   TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(MetricCollector, ObjectRef, MetricCollectorNode);
 };
 
+/*!
+ * \brief Create a collector of the CPU hardware counters, read with perf_event_open.
+ *
+ * The counters of all the threads of the process are collected for the calls on CPU.
+ *
+ * \param events The events to count: cycles, instructions, cache-references, cache-misses,
+ *        branch-misses, or raw events of the PMU written as r<hex>. cycles, instructions and
+ *        cache-misses are counted when empty.
+ * \param error Set to the reason when the counters can't be opened.
+ * \return The collector, or a null collector when the counters can't be opened, such as
+ *         when perf_event_paranoid does not allow them.
+ */
+TVM_DLL MetricCollector CreatePerfEventMetricCollector(ffi::Array<ffi::String> events,
+                                                       std::string* error = nullptr);
+
 /*! Information about a single function or operator call. */
 struct CallFrame {
   /*! Device on which the call was made */
@@ -424,6 +444,8 @@ class Profiler {
   std::stack<CallFrame> in_flight_;
   std::vector<MetricCollector> collectors_;
   std::unordered_map<ffi::String, ffi::Any> configuration_;
+  /*! \brief Whether the "Total" calls are being started. */
+  bool starting_totals_{false};
 };
 
 /* \brief A duration in time. */
@@ -583,6 +605,35 @@ ffi::Function WrapTimeEvaluator(ffi::Function f, Device dev, int number, int rep
                                 int cooldown_interval_ms, int repeats_to_cooldown,
                                 int cache_flush_bytes = 0, ffi::Function f_preproc = nullptr);
 
+/*!
+ * \brief Measure a batch of functions on the same device, e.g. in one call over RPC.
+ *
+ * The arguments are allocated once per signature, filled at random when
+ * `tvm.contrib.random.random_fill_for_measure` is available, and shared by the functions of that
+ * signature. The repeats are interleaved: each round times every function once, starting from a
+ * different one each round, so that a drift of the device biases every function alike.
+ *
+ * \param mods The modules of the functions.
+ * \param func_names The names of the functions in their modules, empty for the entry function.
+ * \param arg_dtypes The dtypes of the tensor arguments of each function.
+ * \param arg_shapes The shapes of the tensor arguments of each function.
+ * \param dev The device to run on.
+ * \param number The number of runs averaged in one repeat, increased to last `min_repeat_ms`.
+ * \param repeat The number of repeats of each function.
+ * \param min_repeat_ms The minimum duration of one repeat in milliseconds.
+ * \param cache_flush_bytes The number of bytes to flush from cache before each repeat.
+ * \param f_preproc The function to be executed on the arguments before each repeat.
+ * \return The seconds per run of each repeat of each function, as a row-major matrix of doubles
+ *         with a row per function and a column per repeat. The rows of the functions that
+ *         failed are NaN.
+ */
+TVM_DLL ffi::Bytes TimeEvaluateBatch(ffi::Array<ffi::Module> mods,
+                                     ffi::Array<ffi::String> func_names,
+                                     ffi::Array<ffi::Array<ffi::String>> arg_dtypes,
+                                     ffi::Array<ffi::Array<ffi::Shape>> arg_shapes, Device dev,
+                                     int number, int repeat, int min_repeat_ms,
+                                     int cache_flush_bytes = 0, ffi::Function f_preproc = nullptr);
+
 }  // namespace profiling
 }  // namespace runtime
 }  // namespace tvm
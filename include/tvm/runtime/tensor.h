@@ -160,6 +160,29 @@ class Tensor : public tvm::ffi::Tensor {
    */
   TVM_DLL static Tensor Empty(ffi::Shape shape, DLDataType dtype, Device dev,
                               ffi::Optional<ffi::String> mem_scope = std::nullopt);
+  /*!
+   * \brief Create a Tensor that views external memory without copying it.
+   *
+   * \param data The external buffer, on the device `dev`.
+   * \param shape The shape of the new array.
+   * \param dtype The data type of the new array.
+   * \param dev The device of the buffer.
+   * \param deleter Called with `data` when the last reference to the Tensor goes away, e.g. to
+   *     return the buffer to the pool it comes from. No-op when empty.
+   * \param strides The strides of the array in elements, compact when not defined.
+   * \param byte_offset The offset of the first element in the buffer, in bytes.
+   * \param alignment The required alignment of `data`, in bytes.
+   * \return The created Array.
+   *
+   * \note The buffer must be aligned to `alignment`, and the first element to the size of the
+   *       elements. The strides must not be negative, and the elements of non-compact arrays must
+   *       be byte-addressable. Otherwise this function raises an exception and `deleter` is not
+   *       called.
+   */
+  TVM_DLL static Tensor FromExternal(void* data, ffi::Shape shape, DLDataType dtype, Device dev,
+                                     std::function<void(void*)> deleter,
+                                     ffi::Optional<ffi::Shape> strides = std::nullopt,
+                                     int64_t byte_offset = 0, size_t alignment = kAllocAlignment);
   /*!
    * \brief Function to copy data from one array to another.
    * \param from The source array.
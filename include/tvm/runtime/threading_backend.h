@@ -92,6 +92,10 @@ class ThreadGroup {
     kSpecifyOneCorePerThread = -2,
     /*All threads will get the same core group affinity.*/
     kSpecifyThreadShareAllCore = -3,
+    /*Consecutive threads are grouped on each NUMA node, and bound to the cores of their node.*/
+    kNuma = -4,
+    /*Threads use the big and the little cores, and take the chunks of parallel loops dynamically.*/
+    kHybrid = -5,
   };
   /*!
    * \brief configure the CPU id affinity
@@ -109,6 +113,13 @@ class ThreadGroup {
   TVM_DLL int Configure(AffinityMode mode, int nthreads, bool exclude_worker0,
                         std::vector<unsigned int> cpus = {});
 
+  /*!
+   * \brief Estimate the throughput of the core of each worker, relative to the fastest core.
+   *  The estimate is the ratio of the maximum frequencies, and 1 when they are unknown.
+   * \return The relative throughput of the workers used by the last Configure.
+   */
+  TVM_DLL std::vector<double> WorkerThroughputs() const;
+
  private:
   Impl* impl_;
 };
@@ -125,6 +136,12 @@ TVM_DLL int MaxConcurrency();
  * \brief Setting the maximum number of available cores.
  */
 TVM_DLL void SetMaxConcurrency(int value);
+/*!
+ * \brief Get the CPUs of each NUMA node of the system.
+ * \return The CPU ids of each node, indexed by the node id. The nodes that are offline or have no
+ *  CPU have empty lists. When the topology is unknown, all the CPUs are in node 0.
+ */
+TVM_DLL const std::vector<std::vector<unsigned int>>& NumaNodeCpus();
 /*!
  * \brief Reset the threads in the pool. All current threads are destroyed and
  * new ones are created.
@@ -136,7 +153,7 @@ TVM_DLL void ResetThreadPool();
 /*!
  * \brief Configuring the CPU affinity mode for the working threads.
  * \param mode The preferred CPU type (1 = big, -1 = little, -2 = kSpecifyOneCorePerThread,
- *  -3 = kSpecifyThreadShareAllCore).
+ *  -3 = kSpecifyThreadShareAllCore, -4 = kNuma, -5 = kHybrid).
  * \param nthreads The number of threads to use (0 = use all).
  * \param cpus A list of CPUs is used to set the 'cpu affinity' for the worker threads.
  */
@@ -149,6 +166,62 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 TVM_DLL int32_t NumThreads();
 
+/*!
+ * \brief Whether a task of a parallel launch can itself launch parallel jobs.
+ * \return True for the work-stealing, isolated and OpenMP pools, or when there is a single
+ *  worker.
+ */
+TVM_DLL bool SupportsNestedLaunch();
+
+/*!
+ * \brief A thread pool with one worker bound to each CPU of a set, isolated from the
+ *  thread-local pools.
+ *
+ * The parallel launches of a thread run on the pool while the thread is in a Scope of it, and
+ * the thread itself is bound to the CPUs of the pool meanwhile. Several model instances of a
+ * process can then run on disjoint sets of cores, without oversubscribing the machine.
+ * The launches of different threads on the same pool are serialized.
+ */
+class TVM_DLL IsolatedThreadPool {
+ public:
+  /*!
+   * \brief Create the pool.
+   * \param cpus The CPUs of the pool, one worker is bound to each of them.
+   */
+  explicit IsolatedThreadPool(std::vector<unsigned int> cpus);
+  ~IsolatedThreadPool();
+  /*! \return The CPUs of the pool. */
+  const std::vector<unsigned int>& cpus() const;
+  /*! \return The pool the current thread is in a scope of, or nullptr. */
+  static IsolatedThreadPool* Current();
+  /*!
+   * \brief Run a parallel job on the pool, the calling thread runs the task 0.
+   *
+   * The parallel jobs launched by the tasks of the job run inline, as a single task.
+   * \param flambda The parallel function to be launched.
+   * \param cdata The closure data.
+   * \param num_task The number of tasks, 0 to use all the workers.
+   * \return 0 when no error is thrown, -1 when failure happens.
+   */
+  int Launch(FTVMParallelLambda flambda, void* cdata, int num_task);
+
+  /*! \brief RAII guard running the parallel launches of the current thread on a pool. */
+  class TVM_DLL Scope {
+   public:
+    explicit Scope(IsolatedThreadPool* pool);
+    ~Scope();
+
+   private:
+    IsolatedThreadPool* prev_;
+    bool entered_;
+    std::vector<unsigned int> prev_cpus_;
+  };
+
+ private:
+  class Impl;
+  Impl* impl_;
+};
+
 }  // namespace threading
 
 /*!
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file include/tvm/runtime/tracing.h
+ * \brief Timeline tracing of the runtime, exported as Chrome trace events.
+ */
+#ifndef TVM_RUNTIME_TRACING_H_
+#define TVM_RUNTIME_TRACING_H_
+
+#include <tvm/ffi/string.h>
+#include <tvm/runtime/base.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
+
+#include <optional>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*!
+ * \brief Start recording trace events, dropping the events of the previous trace.
+ *
+ * Each thread records into its own fixed-size buffer, which needs no lock, and the events past
+ * its capacity are dropped.
+ *
+ * \param device_timers Whether to also time the events on their devices, which places them on a
+ * timeline per device in addition to the host timeline of the thread.
+ * \param buffer_size The maximum number of events recorded per thread.
+ */
+TVM_DLL void StartTracing(bool device_timers, int64_t buffer_size);
+/*! \brief Stop recording trace events. */
+TVM_DLL void StopTracing();
+/*! \brief Whether trace events are being recorded. */
+TVM_DLL bool IsTracing();
+/*!
+ * \brief Set the process id of the events the current thread records, e.g. the disco worker id,
+ * which makes the traces of several workers mergeable into one timeline.
+ */
+TVM_DLL void SetTraceProcessId(int pid);
+/*!
+ * \brief Export the recorded events in the Chrome trace event format, which Perfetto also reads.
+ * The tracing should be stopped first, so that the device timers can be synchronized.
+ */
+TVM_DLL ffi::String ExportChromeTrace();
+
+/*!
+ * \brief Record the duration of its scope as a trace event, when tracing.
+ *
+ * \code{.cpp}
+ * {
+ *   TraceScope scope("kernel", func_name, dev);
+ *   func(args...);
+ * }
+ * \endcode
+ */
+class TraceScope {
+ public:
+  /*!
+   * \brief Begin the event.
+   * \param category The category of the event, which must outlive the trace.
+   * \param name The name of the event.
+   * \param device The device the event runs on, if it runs on one.
+   */
+  TVM_DLL TraceScope(const char* category, const ffi::String& name,
+                     std::optional<Device> device = std::nullopt);
+  /*! \brief End the event. */
+  TVM_DLL ~TraceScope();
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  /*! \brief The slot of the event in the buffer of the thread, or -1 if not recorded. */
+  int64_t index_{-1};
+};
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_TRACING_H_
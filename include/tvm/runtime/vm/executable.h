@@ -27,6 +27,7 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/object.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -79,6 +80,9 @@ struct VMFuncInfo {
   bool Load(dmlc::Stream* reader);
 };
 
+/*! \brief A file mapped into memory, defined in executable.cc. */
+class MappedFile;
+
 /*!
  * \brief The virtual machine executable emitted by the VM compiler.
  *
@@ -142,10 +146,14 @@ class VMExecutable : public ffi::ModuleObj {
   ffi::Module VMProfilerLoadExecutable() const;
   /*! \brief Check if the VMExecutable contains a specific function. */
   bool HasFunction(const ffi::String& name) const;
+  /*! \brief Get the constant pool of the VMExecutable. */
+  ffi::Array<ffi::Any> GetConstants() const;
   /*!
    * \brief Load VMExecutable from the file.
    * \param file_name The path of the file that load the executable from.
    * \return The loaded executable, in the form of a `runtime::Module`.
+   * \note The file is mapped into memory when possible, and the tensor constants then alias it
+   *       instead of being read into new tensors. The VM copies them to the device on first use.
    */
   static ffi::Module LoadFromFile(const ffi::String& file_name);
 
@@ -161,6 +169,13 @@ class VMExecutable : public ffi::ModuleObj {
   std::vector<Index> instr_offset;
   /*! \brief The byte data of instruction. */
   std::vector<ExecWord> instr_data;
+  /*!
+   * \brief The registers released after the i-th instruction are
+   *  release_regs[release_offset[i]:release_offset[i + 1]], empty if there is no release table.
+   */
+  std::vector<Index> release_offset;
+  /*! \brief The registers released after each instruction, see release_offset. */
+  std::vector<RegName> release_regs;
 
   virtual ~VMExecutable() {}
 
@@ -171,9 +186,16 @@ class VMExecutable : public ffi::ModuleObj {
   TVM_MODULE_VTABLE_ENTRY("vm_load_executable", &VMExecutable::VMLoadExecutable);
   TVM_MODULE_VTABLE_ENTRY("vm_profiler_load_executable", &VMExecutable::VMProfilerLoadExecutable);
   TVM_MODULE_VTABLE_ENTRY("has_function", &VMExecutable::HasFunction);
+  TVM_MODULE_VTABLE_ENTRY("get_constants", &VMExecutable::GetConstants);
   TVM_MODULE_VTABLE_END();
 
  private:
+  /*!
+   * \brief Load VMExecutable from a serialized stream.
+   * \param strm The input stream.
+   * \param file The mapped file that `strm` reads, if any.
+   */
+  static ffi::Module Load(dmlc::SeekStream* strm, const std::shared_ptr<MappedFile>& file);
   /*!
    * \brief Save the globals.
    * \param strm The input stream.
@@ -185,15 +207,20 @@ class VMExecutable : public ffi::ModuleObj {
    */
   void SaveMemoryScopeSection(dmlc::Stream* strm) const;
   /*!
-   * \brief Save the constant pool.
-   * \param strm The input stream.
+   * \brief Save the constant pool, with the data of the tensors at aligned offsets of the stream.
+   * \param strm The output stream.
    */
-  void SaveConstantSection(dmlc::Stream* strm) const;
+  void SaveConstantSection(dmlc::SeekStream* strm) const;
   /*!
    * \brief Save the instructions.
    * \param strm The input stream.
    */
   void SaveCodeSection(dmlc::Stream* strm) const;
+  /*!
+   * \brief Save the register release tables.
+   * \param strm The output stream.
+   */
+  void SaveReleaseSection(dmlc::Stream* strm) const;
   /*!
    * \brief Save the packed functions.
    * \param strm The input stream.
@@ -212,13 +239,21 @@ class VMExecutable : public ffi::ModuleObj {
   /*!
    * \brief Load the constant pool.
    * \param strm The input stream.
+   * \param header_magic The magic number of the file format.
+   * \param file The mapped file that `strm` reads, if any, which the tensors then alias.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(dmlc::SeekStream* strm, uint64_t header_magic,
+                           const std::shared_ptr<MappedFile>& file);
   /*!
    * \brief Load the instructions.
    * \param strm The input stream.
    */
   void LoadCodeSection(dmlc::Stream* strm);
+  /*!
+   * \brief Load the register release tables, which executables saved without them lack.
+   * \param strm The input stream.
+   */
+  void LoadReleaseSection(dmlc::Stream* strm);
   /*!
    * \brief Save the packed functions.
    * \param strm The input stream.
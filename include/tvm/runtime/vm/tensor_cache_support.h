@@ -48,6 +48,15 @@ struct TensorCacheMetadata {
        */
       TVM_DLL Tensor Load(Device device, const std::string* raw_data,
                           ffi::Optional<Tensor>* staging_buffer = nullptr) const;
+      /*!
+       * \brief Load the parameter from the raw data of its shard held in memory.
+       * \param device The device to load the parameter onto.
+       * \param raw_data The start of the raw data of the shard, e.g., a memory-mapped file.
+       * \param staging_buffer The buffer to be used to avoid extra OpenCL copies. Pass in a nullptr
+       * in other cases
+       */
+      TVM_DLL Tensor LoadFromBuffer(Device device, const char* raw_data,
+                                    ffi::Optional<Tensor>* staging_buffer = nullptr) const;
 
       /*! \brief Name of the parameter */
       std::string name;
@@ -27,6 +27,7 @@
 #define TVM_VM_ENABLE_PROFILER 1
 #endif
 
+#include <tvm/ffi/container/map.h>
 #include <tvm/ffi/extra/module.h>
 
 #include <memory>
@@ -176,6 +177,23 @@ class VirtualMachine : public ffi::ModuleObj {
    */
   virtual void SetInstrument(ffi::Function instrument) = 0;
 
+  /*!
+   * \brief Time one in every `sample_every` calls of each function into a latency histogram.
+   *
+   * Unlike an instrument, the sampling runs natively and only reads a clock on the sampled calls,
+   * so it is cheap enough to leave on in production. Setting it again clears the samples.
+   *
+   * \param sample_every The sampling period, or 0 to stop sampling.
+   */
+  virtual void SetCallSampling(int64_t sample_every) = 0;
+
+  /*!
+   * \brief Get the latency statistics of the functions sampled so far.
+   * \return The number of calls, of samples, and the mean, p50, p90, p99 and max latency in
+   * microseconds, by function name.
+   */
+  virtual ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> GetCallSamplingReport() = 0;
+
   /*!
    * \brief Get or create a VM extension. Once created, the extension will be stored in the VM
    * and held until the VM is destructed.
@@ -356,6 +356,21 @@ TVM_DLL bool VerifyWellFormed(const PrimFunc& func, bool assert_mode = true);
  */
 TVM_DLL bool VerifyWellFormed(const IRModule& mod, bool assert_mode = true);
 
+/*!
+ * \brief Verify if the TIR in the given IRModule is well-formed, assuming that prev_mod was.
+ *
+ * Only the PrimFuncs that differ from those bound to the same GlobalVar in prev_mod, by
+ * pointer equality, are verified.  The check that a TIR variable is not defined in more
+ * than one function is only done among these PrimFuncs.
+ *
+ * \param mod The IRModule to be verified.
+ * \param prev_mod A well-formed IRModule, usually the input of the pass that produced mod.
+ * \param assert_mode The indicator if it raises an error when the function is not well-formed.
+ * \return Whether the changed TIR functions are well-formed.
+ */
+TVM_DLL bool VerifyWellFormedIncremental(const IRModule& mod, const IRModule& prev_mod,
+                                         bool assert_mode = true);
+
 /*!
  * \brief Find the entry function of the given IRModule, i.e, functions marked by
  * `tir::attr::kIsEntryFunc`, whose name is `main` or being the only PrimeFunc.
@@ -674,6 +674,19 @@ TVM_DLL const Op& ptx_cp_async();
  */
 TVM_DLL const Op& ptx_cp_async_bulk();
 
+/*!
+ * \brief tvm intrinsics for ptx async copy of a tile of a tensor from global to shared memory
+ *        using cp.async.bulk.tensor, where the tile is described by a CUtensorMap.
+ *        The number of coordinates is the dimension of the tensor map, from 1 to 5.
+ *
+ * void ptx_cp_async_bulk_tensor(Var shared_ptr,
+ *                               Expr shared_offset,
+ *                               Var tensormap,
+ *                               int barrier_id,
+ *                               Expr coord_0, ..., Expr coord_{dim - 1});
+ */
+TVM_DLL const Op& ptx_cp_async_bulk_tensor();
+
 /*!
  * \brief tvm intrinsics for ptx async copy commit and wait.
  *
@@ -719,7 +732,7 @@ TVM_DLL const Op& ptx_arrive_barrier_expect_tx();
 /*!
  * \brief tvm intrinsics for ptx barrier wait using mbarrier.try_wait
  *
- * ptx_wait_barrier(int barrier_id)
+ * ptx_wait_barrier(int barrier_id, Expr phase = 0)
  *
  */
 TVM_DLL const Op& ptx_wait_barrier();
@@ -732,6 +745,48 @@ TVM_DLL const Op& ptx_wait_barrier();
  */
 TVM_DLL const Op& create_barriers();
 
+/*!
+ * \brief tvm intrinsic mapping a shared memory address of the current block to the address of
+ *  the same variable in the shared memory of another block in the thread block cluster.
+ *
+ * void* ptx_map_shared_rank(Var smem_ptr, Expr cta_rank)
+ *
+ */
+TVM_DLL const Op& ptx_map_shared_rank();
+
+/*!
+ * \brief tvm intrinsic for the shared memory matrix descriptor of a wgmma operand.
+ *
+ * uint64 ptx_wgmma_encode_smem_desc(Var smem_ptr,
+ *                                   Expr smem_offset,
+ *                                   int leading_byte_offset,
+ *                                   int stride_byte_offset,
+ *                                   int swizzle_mode);
+ */
+TVM_DLL const Op& ptx_wgmma_encode_smem_desc();
+
+/*!
+ * \brief tvm intrinsic for warpgroup level matrix multiply-accumulate using wgmma.mma_async,
+ *        with both multiplicands described by shared memory matrix descriptors.
+ *
+ * void ptx_wgmma_mma_async(StringImm shape, StringImm A_dtype, StringImm B_dtype,
+ *                          StringImm C_dtype, Expr desc_a, Expr desc_b,
+ *                          Var accumulator, Expr c_index, Expr scale_d,
+ *                          bool trans_a, bool trans_b);
+ */
+TVM_DLL const Op& ptx_wgmma_mma_async();
+
+/*!
+ * \brief tvm intrinsics for the fence, commit and wait of wgmma.mma_async operations.
+ *
+ * void ptx_wgmma_fence();
+ * void ptx_wgmma_commit_group();
+ * void ptx_wgmma_wait_group(int num);
+ */
+TVM_DLL const Op& ptx_wgmma_fence();
+TVM_DLL const Op& ptx_wgmma_commit_group();
+TVM_DLL const Op& ptx_wgmma_wait_group();
+
 /*!
  * \brief tvm intrinsic for storing the result of PTX MMA into a destination pointer.
  *        For example, if each thread in a warp of size 32 has 4 elements from the result of
@@ -29,6 +29,7 @@
 #include <tvm/tir/function.h>
 
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace tvm {
@@ -163,11 +164,15 @@ class ScheduleStateNode : public Object {
   /*! \brief Returns the BlockInfo correpsonding to the block sref */
   TVM_DLL BlockInfo GetBlockInfo(const StmtSRef& block_sref) const;
   /*!
-   * \brief Recalculate the BlockInfo recursively under stmt.
-   * If stmt is a Block itself, we will not reset its affine binding flag unless it doesn't
-   * have block vars, since the affine flag depends on the outer scope of stmt.
+   * \brief Mark the BlockInfo of the blocks under stmt as stale, to be recalculated when queried.
+   * If stmt is a Block itself, we will not reset its affine binding flag,
+   * since the affine flag depends on the outer scope of stmt.
+   * \note Only the stale BlockInfo that a query depends on is recalculated, so that a primitive
+   * on a large PrimFunc does not pay for the analysis of the blocks it never looks at again.
    */
   TVM_DLL void UpdateScopeBlockInfo(const Stmt& stmt);
+  /*! \brief Recalculate all the stale BlockInfo, before `block_info` is read directly */
+  TVM_DLL void FlushBlockInfo() const;
   /*!
    * \brief Get the BlockScope correpsonding to the sref of scope root block
    * \param scope_root The block sref to be retrieved
@@ -201,6 +206,17 @@ class ScheduleStateNode : public Object {
   bool IsStagePipeline(const StmtSRef& scope_root) const {
     return GetBlockInfo(scope_root).stage_pipeline;
   }
+
+ private:
+  /*! \brief Recalculate the stale BlockInfo that the BlockInfo of the block depends on */
+  void SettleBlockInfo(const StmtSRef& block_sref);
+  /*! \brief The blocks whose affine_binding flag is stale */
+  std::unordered_set<StmtSRef, ObjectPtrHash, ObjectPtrEqual> stale_affine_binding_;
+  /*!
+   * \brief The scope roots whose scope, stage_pipeline flag, and the region_cover flags of
+   * whose child blocks are stale
+   */
+  std::unordered_set<StmtSRef, ObjectPtrHash, ObjectPtrEqual> stale_scope_;
 };
 
 /*!
@@ -21,6 +21,8 @@
 
 #include <tvm/tir/schedule/instruction.h>
 
+#include <unordered_map>
+
 namespace tvm {
 namespace tir {
 
@@ -107,6 +109,17 @@ class TraceNode : public runtime::Object {
    */
   void ApplyToSchedule(Schedule sch, bool remove_postproc,
                        FTraceDecisionProvider decision_provider = nullptr) const;
+  /*!
+   * \brief Apply the instructions in the range [begin, end) of the trace to a TensorIR schedule
+   * \param sch The schedule to be applied onto
+   * \param begin The index of the first instruction to be applied
+   * \param end The index after the last instruction to be applied
+   * \param rv_map The mapping from the random variables of the trace to those of the schedule.
+   * It must cover the random variables defined before `begin`, and is extended with the outputs
+   * of the applied instructions.
+   */
+  void ApplyRangeToSchedule(Schedule sch, int begin, int end,
+                            std::unordered_map<const Object*, const Object*>* rv_map) const;
   /*!
    * \brief Serialize the trace as a JSON-style object
    * \param remove_postproc If postprocessing instructions are removed
@@ -1179,6 +1179,16 @@ constexpr const char* async_commit_queue_scope = "async_commit_queue_scope";
 constexpr const char* async_wait_queue_scope = "async_wait_queue_scope";
 constexpr const char* async_wait_inflight_count = "async_wait_inflight_count";
 
+/*!
+ * \brief Mark the region of a warp-specialized software pipeline, where the producer and the
+ *        consumer threads synchronize with each other through mbarriers. The value is the number
+ *        of producer threads.
+ * \note All threads of the block synchronize on the entry and the exit of the region, and no
+ *       other synchronization should be inserted into it.
+ * \sa tvm::tir::attr::software_pipeline_warp_specialize
+ */
+constexpr const char* warp_specialization_scope = "warp_specialization_scope";
+
 /*!
  * \brief Mark that the shape of TensorCore fragment
  */
@@ -1220,6 +1230,20 @@ constexpr const char* software_pipeline_order = "software_pipeline_order";
  */
 constexpr const char* software_pipeline_async_stages = "software_pipeline_async_stages";
 
+/*! \brief Mark the number of producer threads of a warp-specialized software pipeline
+ * \note The thread block is extended by the producer threads, which run the statements of stage 0
+ *       that copy the data of the pipeline, while the original threads run the other statements.
+ *       The two roles synchronize through mbarriers over `max_stage + 1` versions of the buffers
+ *       produced in stage 0. A value of 0 disables warp specialization.
+ */
+constexpr const char* software_pipeline_warp_specialize = "software_pipeline_warp_specialize";
+
+/*!
+ * \brief Mark the number of iterations ahead of the current one that a loop prefetches.
+ * \sa tvm::tir::transform::InjectSoftwarePrefetch
+ */
+constexpr const char* software_prefetch_distance = "software_prefetch_distance";
+
 /*! \brief Mark the buffers which is const access and can be transformed layout. */
 constexpr const char* layout_free_buffers = "layout_free_buffers";
 
@@ -1309,6 +1333,12 @@ constexpr const char* warp_execution = "warp_execution";
 /*! \brief Mark that a block is disallowed in auto inline. */
 constexpr const char* meta_schedule_inline_rule = "meta_schedule.inline_rule";
 
+/*!
+ * \brief Mark the outermost loop of a loop nest that fills a rolling buffer. Its iterations reuse
+ * the rows of the earlier ones, so the nest must not be parallelized.
+ */
+constexpr const char* meta_schedule_rolling_buffer = "meta_schedule.rolling_buffer";
+
 /*! \brief Mark that a block has an explicitly specified read region.
  * This is used to override the default read region inference in TIR.
  */
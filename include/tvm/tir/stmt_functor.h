@@ -561,6 +561,30 @@ bool ContainsNode(const Stmt& stmt) {
   return visitor.contains_node;
 }
 
+/*!
+ * \brief The counters of the nodes rebuilt by the default visitors of StmtMutator and ExprMutator
+ *  on the current thread, because a child came back as a different object.
+ */
+struct MutatorCopyStats {
+  /*! \brief The number of nodes rebuilt. */
+  int64_t num_copies{0};
+  /*!
+   * \brief The number of nodes rebuilt that are structurally equal to their original, since their
+   *  new children only differ by identity, counted while the check is enabled.
+   */
+  int64_t num_needless_copies{0};
+};
+
+/*! \brief Get the counters of the current thread, which only grow. */
+TVM_DLL MutatorCopyStats GetMutatorCopyStats();
+
+/*!
+ * \brief Enable or disable counting the needless copies on the current thread, which compares
+ *  each rebuilt node with its original and is meant for debugging.
+ * \return Whether the check was enabled before.
+ */
+TVM_DLL bool SetMutatorNeedlessCopyCheck(bool enabled);
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -62,6 +62,10 @@ TVM_DLL Pass CreatePrimFuncPass(std::function<PrimFunc(PrimFunc, IRModule, PassC
 /*!
  * \brief partition loops in the stmt.
  *
+ * With the "partition_vectorized_tail" option of the "tir.LoopPartition" config, the boundary
+ * checks in vectorized loops are treated as likely, and the innermost loop outside of the
+ * vectorized loop they depend on is partitioned into a main loop without the checks and a tail.
+ *
  * \return The pass.
  */
 TVM_DLL Pass LoopPartition();
@@ -144,6 +148,9 @@ TVM_DLL Pass ConvertSSA();
 /*!
  * \brief Instruments bound checkers.
  *
+ *  The accesses of a loop nest whose indices range over an interval known before it are
+ *  checked once before the loop nest, the others before each access.
+ *
  * \return The pass.
  */
 TVM_DLL Pass InstrumentBoundCheckers();
@@ -294,6 +301,12 @@ TVM_DLL Pass InferFragment();
  */
 static constexpr const char* kDisableLowerTVMBuiltin = "disable_lower_builtin";
 
+/*!
+ * \brief This annotation marks an allocation placed in static storage rather than on the stack
+ *  or in a workspace; the code using it is then not reentrant.
+ */
+static constexpr const char* kStaticStorage = "static_storage";
+
 /*!
  * \brief Lower builtin intrinsics.
  * \return The pass.
@@ -332,6 +345,11 @@ TVM_DLL Pass CombineContextCall();
 /*!
  * \brief Narrow down PrimExpr datatype in stmt to target_bits.
  *
+ * The free vars of the function are bounded by its "tir_var_upper_bound" attribute. On CUDA and
+ * ROCm, when the indices only fit into int32 for some sizes, the body is versioned into a
+ * narrowed body, guarded by the runtime check of the sizes, and the original body as a fallback.
+ * The versioning is disabled by the "tir.narrow_index_with_fallback" config.
+ *
  * \param target_bits The target bits
  *
  * \note Run this pass after storage flatten.
@@ -555,6 +573,10 @@ TVM_DLL Pass UnifyThreadBinding();
 
 /*!
  *  A pass to merge multiple TIR-level shared memory allocations into one
+ *
+ *  With the "tir.merge_smem_interval_coloring" config, the offsets of constant-size buffers are
+ *  planned by interval coloring over their lifetimes, aligned to "tir.merge_smem_alignment" bytes
+ *  (16 by default), and to "tir.merge_smem_swizzle_bytes" for the buffers of at least that size.
  */
 TVM_DLL Pass MergeSharedMemoryAllocations();
 
@@ -676,6 +698,21 @@ TVM_DLL Pass UnifiedStaticMemoryPlanner();
  */
 TVM_DLL Pass InjectSoftwarePipeline();
 
+/*!
+ * \brief Inject software prefetches into the loops annotated with `software_prefetch_distance`.
+ *
+ * For a distance `d`, every iteration `i` of the loop prefetches the regions of the global buffers
+ * that iteration `i + d` reads, one `tir.prefetch` per cache line, and a prologue before the loop
+ * prefetches the regions of the first `d` iterations. This is the CPU counterpart of the software
+ * pipeline: the prefetches of the next tiles overlap with the compute of the current one.
+ *
+ * Only the serial and unrolled loops whose iterations read regions of constant size are
+ * transformed, and the annotation is removed from every loop.
+ *
+ * \return The IR transform pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
 TVM_DLL Pass BindParams(const ffi::Array<runtime::Tensor>& constants);
 
 /*!
@@ -21,6 +21,7 @@ from .int_set import (
     IntervalSet,
     PresburgerSet,
     estimate_region_lower_bound,
+    estimate_region_polyhedral_bound,
     estimate_region_strict_bound,
     estimate_region_upper_bound,
 )
@@ -28,7 +29,7 @@ from .analyzer import ModularSet, ConstIntBound, Analyzer, ProofStrength, Extens
 from .bound import deduce_bound
 from .pattern import detect_linear_equation, detect_clip_bound, detect_common_subexpr
 from .int_solver import solve_linear_equations, solve_linear_inequalities
-from .iter_affine_map import IterMapExpr, IterMark, IterSplitExpr, IterSumExpr
+from .iter_affine_map import IterMapExpr, IterMark, IterSplitExpr, IterSumExpr, IterMapCache
 from .iter_affine_map import (
     detect_iter_map,
     iter_map_simplify,
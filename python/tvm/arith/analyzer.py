@@ -17,7 +17,7 @@
 # pylint: disable=invalid-name
 """Arithmetic data structure and utility"""
 import enum
-from typing import Union
+from typing import Dict, List, Union
 
 import tvm_ffi
 from tvm import ir, tir
@@ -117,6 +117,8 @@ class Analyzer:
         self._rewrite_simplify = _mod("rewrite_simplify")
         self._get_rewrite_simplify_stats = _mod("get_rewrite_simplify_stats")
         self._reset_rewrite_simplify_stats = _mod("reset_rewrite_simplify_stats")
+        self._set_rewrite_rule_profiling_enabled = _mod("set_rewrite_rule_profiling_enabled")
+        self._get_rewrite_rule_counters = _mod("get_rewrite_rule_counters")
         self._canonical_simplify = _mod("canonical_simplify")
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
@@ -124,6 +126,9 @@ class Analyzer:
         self._can_prove = _mod("can_prove")
         self._get_enabled_extensions = _mod("get_enabled_extensions")
         self._set_enabled_extensions = _mod("set_enabled_extensions")
+        self._set_memoization_enabled = _mod("set_memoization_enabled")
+        self._get_memo_stats = _mod("get_memo_stats")
+        self._reset_memo_stats = _mod("reset_memo_stats")
 
     def const_int_bound(self, expr: tir.PrimExpr) -> ConstIntBound:
         """Find constant integer bound for expr.
@@ -212,6 +217,25 @@ class Analyzer:
     def reset_rewrite_simplify_stats(self):
         self._reset_rewrite_simplify_stats()
 
+    def set_rewrite_rule_profiling_enabled(self, enabled: bool = True):
+        """Enable counting the attempts and the rewrites of each rewrite rule.
+
+        Parameters
+        ----------
+        enabled : bool
+            Whether to count.
+        """
+        self._set_rewrite_rule_profiling_enabled(enabled)
+
+    @property
+    def rewrite_rule_counters(self) -> Dict[str, List[int]]:
+        """The numbers of attempts and of rewrites of each rewrite rule attempted, keyed by
+        the source location of the rule. They are reset by reset_rewrite_simplify_stats."""
+        return {
+            str(key): [int(x) for x in value]
+            for key, value in self._get_rewrite_rule_counters().items()
+        }
+
     def canonical_simplify(self, expr: tir.PrimExpr) -> tir.PrimExpr:
         """Simplify expression via canonicalization.
 
@@ -364,3 +388,24 @@ class Analyzer:
         """
         flags = Extension(flags).value
         self._set_enabled_extensions(flags)
+
+    def enable_memoization(self, enabled: bool = True):
+        """Enable or disable the memoization of simplify and can_prove.
+
+        When enabled, the results of repeated queries on the same expression
+        object are reused until a binding or a constraint scope invalidates them.
+
+        Parameters
+        ----------
+        enabled: bool
+            Whether to memoize the results. Disabling drops all the memoized results.
+        """
+        self._set_memoization_enabled(enabled)
+
+    @property
+    def memo_stats(self) -> Dict[str, int]:
+        """Return the hits, misses and invalidations of the memoized results"""
+        return {key: int(value) for key, value in self._get_memo_stats().items()}
+
+    def reset_memo_stats(self):
+        self._reset_memo_stats()
@@ -160,6 +160,30 @@ def estimate_region_upper_bound(region, var_dom, predicate):
     return _ffi_api.EstimateRegionUpperBound(region, var_dom, predicate)
 
 
+def estimate_region_polyhedral_bound(region, var_dom, predicate):
+    """Analyze the region as the projection of a polyhedron, given the domain of variables and
+    their predicate. The domain of a variable may depend on the other variables, so the result
+    is tight on non-rectangular regions, e.g. triangular or sliding-window accesses.
+
+    Parameters
+    ----------
+    region : List[Range]
+        The region to be analyzed.
+
+    var_dom : Dict[Var, Range]
+        The ranges of the variables
+
+    predicate : PrimExpr
+        The predicate for the accesses
+
+    Returns
+    ----------
+    region_int_set : Optional[List[IntSet]]
+        None if the projection fails, or an array of IntSets as the result of analysis
+    """
+    return _ffi_api.EstimateRegionPolyhedralBound(region, var_dom, predicate)
+
+
 def pos_inf():
     """Returns the symbolic positive infinity
 
@@ -95,6 +95,35 @@ class IterMapResult(Object):
     """Result of iter map detection."""
 
 
+@tvm_ffi.register_object("arith.IterMapCache")
+class IterMapCache(Object):
+    """A memo of the results of iter map detection, keyed by the structural hash of the
+    indices, the input iterators, the predicate and the check level.
+
+    The memo is only consulted within its scope. Within the scope, the context a result may
+    depend on, e.g. the bounds of the free variables of the indices, is assumed to be the
+    same for identical inputs.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        with tvm.arith.IterMapCache() as cache:
+            sch.transform_layout(...)
+        print(cache.num_hits, cache.num_misses)
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(_ffi_api.IterMapCache)
+
+    def __enter__(self):
+        _ffi_api.IterMapCacheEnterScope(self)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        _ffi_api.IterMapCacheExitScope(self)
+
+
 class IterMapLevel(IntEnum):
     """Possible kinds of iter mapping check level."""
 
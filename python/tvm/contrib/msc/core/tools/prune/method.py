@@ -107,6 +107,89 @@ class PruneMethod(object):
         config["out_indices"] = rank[-left_num:].tolist()
         return config
 
+    @classmethod
+    def sparsify_axis(cls, data: np.ndarray, axis: int, sparsity: List[int]) -> np.ndarray:
+        """Keep the n largest of each group of m consecutive elements on axis
+
+        Parameters
+        ----------
+        data: np.ndarray
+            The source data.
+        axis: int
+            The axis of the groups, the reduction axis of the consumer.
+        sparsity: list<int>
+            The n and m of the n:m sparsity.
+
+        Returns
+        -------
+        data: np.ndarray
+            The sparse data, of the same shape.
+        """
+
+        n, m = sparsity
+        assert data.shape[axis] % m == 0, "Axis {} of {} is not a multiple of {}".format(
+            axis, data.shape, m
+        )
+        groups = np.moveaxis(data, axis, -1)
+        groups = groups.reshape(groups.shape[:-1] + (-1, m))
+        rank = np.argsort(np.abs(groups), axis=-1)
+        mask = np.ones(groups.shape, dtype=bool)
+        np.put_along_axis(mask, rank[..., : m - n], False, axis=-1)
+        groups = np.where(mask, groups, np.zeros_like(groups))
+        groups = groups.reshape(groups.shape[:-2] + (-1,))
+        return np.moveaxis(groups, -1, axis)
+
+    @classmethod
+    def nm_sparse(
+        cls,
+        pruner: BaseTool,
+        data: np.ndarray,
+        name: str,
+        consumer: str,
+        in_axis: int,
+        out_axis: int,
+        in_indices: List[int],
+        density: float = 0.5,
+        group: int = 4,
+    ) -> dict:
+        """Prune the data to n:m structured sparsity, 2:4 by default
+
+        Parameters
+        ----------
+        pruner: BasePruner
+            The pruner
+        data: np.ndarray
+            The source data.
+        name: str
+            The name of the weight.
+        consumer: str
+            The name of the consumer.
+        in_axis: int
+            The input axis
+        out_axis: int
+            The output axis
+        in_indices: list<int>
+            The input indices to be pruned
+        density: float
+            The density in each group
+        group: int
+            The size of the groups along the input axis
+
+        Returns
+        -------
+        plan: dict
+            The plan of the tensor.
+        """
+
+        config = {"in_indices": in_indices, "out_indices": []}
+        if density == 1:
+            return config
+        in_dim = len(in_indices) if in_indices else data.shape[in_axis]
+        if in_dim % group != 0:
+            return config
+        config["sparsity"] = [int(density * group), group]
+        return config
+
     @classmethod
     def framework(cls):
         return MSCFramework.MSC
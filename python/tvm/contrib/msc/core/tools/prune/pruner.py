@@ -374,6 +374,11 @@ class BasePruner(WeightTool):
                             data = PruneMethod.prune_axis(data, in_axis, w_config["in_indices"])
                         if w_config["out_indices"]:
                             data = PruneMethod.prune_axis(data, out_axis, w_config["out_indices"])
+                        if w_config.get("sparsity"):
+                            data = PruneMethod.sparsify_axis(data, in_axis, w_config["sparsity"])
+                            w_node.set_attr(
+                                "sparsity", ":".join([str(i) for i in w_config["sparsity"]])
+                            )
                         pruned_tensors[w_name] = _prune_by_shape(weight, data.shape)
                         pruned_weights[w_name] = tvm.runtime.tensor(data)
                         w_node.set_attr(
@@ -516,13 +521,23 @@ class BasePruner(WeightTool):
     def finalize(self) -> dict:
         """Get the plan"""
 
-        self._plan = {n: c for n, c in self._plan.items() if c["in_indices"] or c["out_indices"]}
+        self._plan = {
+            n: c
+            for n, c in self._plan.items()
+            if c["in_indices"] or c["out_indices"] or c.get("sparsity")
+        }
         return super().finalize()
 
     @property
     def pruned(self):
         return len(self._plan) > 0
 
+    @property
+    def sparse_weights(self) -> Dict[str, List[int]]:
+        """The weights pruned to n:m structured sparsity, with their n and m"""
+
+        return {n: c["sparsity"] for n, c in self._plan.items() if c.get("sparsity")}
+
     @classmethod
     def tool_type(cls):
         return ToolType.PRUNER
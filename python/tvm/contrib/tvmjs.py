@@ -19,12 +19,14 @@ import hashlib
 import json
 import math
 import os
+import queue
 import shutil
 
 # pylint: disable=unused-import
 import sys
+import threading
 from types import GeneratorType
-from typing import Any, Iterator, Mapping, Optional, Set, Tuple, Union
+from typing import Any, Iterator, Mapping, Optional, Sequence, Set, Tuple, Union
 
 import numpy as np
 
@@ -332,6 +334,38 @@ def dump_tensor_cache(
         print("Also saved a bf16 record to %s" % b16_nd_cache_json)
 
 
+def _record_to_tensor(buffer_source: bytes, rec: Mapping[str, Any], device: tvm.runtime.Device):
+    """Decode the bytes of a record of the tensor cache into a tensor on the device."""
+    shape = rec["shape"]
+    dtype = rec["dtype"]
+    encode_format = rec["format"]
+    arr = tvm.runtime.empty(shape, dtype, device=device)
+    if dtype == "float8_e4m3fn":
+        if ml_dtypes is not None:
+            dtype = ml_dtypes.float8_e4m3fn
+        else:
+            raise RuntimeError(
+                "ml_dtypes is not installed, cannot convert float8_e4m3fn array to numpy."
+            )
+    if dtype == "float8_e5m2":
+        if ml_dtypes is not None:
+            dtype = ml_dtypes.float8_e5m2
+        else:
+            raise RuntimeError(
+                "ml_dtypes is not installed, cannot convert float8_e5m2 array to numpy."
+            )
+    if encode_format == "f32-to-bf16" and dtype == "float32":
+        data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
+        arr.copyfrom(_convert_bf16_to_f32(data))
+    elif dtype == "bfloat16":
+        data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
+        arr.copyfrom(data)
+    else:
+        data = np.frombuffer(buffer_source, dtype=dtype).reshape(shape)
+        arr.copyfrom(data)
+    return arr
+
+
 def load_tensor_cache(cachepath: str, device: tvm.runtime.Device):
     """Load the tensor cache from the directory or json.
 
@@ -359,43 +393,380 @@ def load_tensor_cache(cachepath: str, device: tvm.runtime.Device):
         assert shard_rec["nbytes"] == len(raw_data)
 
         for rec in shard_rec["records"]:
-            name = rec["name"]
-            shape = rec["shape"]
-            dtype = rec["dtype"]
-            encode_format = rec["format"]
             offset = rec["byteOffset"]
             nbytes = rec["nbytes"]
-
-            arr = tvm.runtime.empty(shape, dtype, device=device)
             assert offset + nbytes <= len(raw_data)
-            buffer_source = raw_data[offset : offset + nbytes]
-            if dtype == "float8_e4m3fn":
-                if ml_dtypes is not None:
-                    dtype = ml_dtypes.float8_e4m3fn
-                else:
-                    raise RuntimeError(
-                        "ml_dtypes is not installed, cannot convert float8_e4m3fn array to numpy."
-                    )
-            if dtype == "float8_e5m2":
-                if ml_dtypes is not None:
-                    dtype = ml_dtypes.float8_e5m2
-                else:
-                    raise RuntimeError(
-                        "ml_dtypes is not installed, cannot convert float8_e5m2 array to numpy."
-                    )
-            if encode_format == "f32-to-bf16" and dtype == "float32":
-                data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
-                arr.copyfrom(_convert_bf16_to_f32(data))
-            elif dtype == "bfloat16":
-                data = np.frombuffer(buffer_source, dtype="uint16").reshape(shape)
-                arr.copyfrom(data)
-            else:
-                data = np.frombuffer(buffer_source, dtype=dtype).reshape(shape)
-                arr.copyfrom(data)
-            result_dict[name] = arr
+            arr = _record_to_tensor(raw_data[offset : offset + nbytes], rec, device)
+            result_dict[rec["name"]] = arr
     return result_dict, json_info["metadata"]
 
 
+def transform_params_hash(mod: tvm.IRModule, func_name: str = "transform_params") -> str:
+    """Compute the hash that identifies a parameter transform, e.g. the function produced by
+    LiftTransformParams, in the cache of transformed parameters.
+
+    The transformed parameters are saved next to `tensor-cache.json` by
+    `vm.builtin.tensor_cache.save_transformed` under this hash, and loaded by
+    `vm.builtin.tensor_cache.load_transformed` in the next processes instead of running the
+    transform again.
+
+    Parameters
+    ----------
+    mod: tvm.IRModule
+        The module that contains the transform.
+
+    func_name: str
+        The name of the transform function.
+
+    Returns
+    -------
+    transform_hash: str
+        The hash of the transform function and of all the functions it calls.
+    """
+    from tvm import relax  # pylint: disable=import-outside-toplevel
+
+    funcs = {}
+    worklist = [mod.get_global_var(func_name)]
+    while worklist:
+        gvar = worklist.pop()
+        if gvar.name_hint in funcs:
+            continue
+        func = mod[gvar]
+        funcs[gvar.name_hint] = func
+        if isinstance(func, relax.Function):
+            worklist.extend(relax.analysis.all_global_vars(func))
+    transform_mod = tvm.IRModule({name: funcs[name] for name in sorted(funcs)})
+    return "%016x" % (tvm.ir.structural_hash(transform_mod) & ((1 << 64) - 1))
+
+
+@tvm.register_global_func("tvmjs.stream_transform.get_item", override=True)
+def _stream_get_item(fget_item, index):
+    return fget_item(index)
+
+
+@tvm.register_global_func("tvmjs.stream_transform.set_item", override=True)
+def _stream_set_item(fset_item, index, value):
+    fset_item(index, value)
+
+
+class _HostMemoryBudget:
+    """The cap on the host bytes held at once by the workers of `stream_transform_params`."""
+
+    def __init__(self, cap_nbytes: int):
+        self.cap_nbytes = cap_nbytes
+        self.used_nbytes = 0
+        self.peak_nbytes = 0
+        self.num_active = 0
+        self.num_waiting = 0
+        self.cond = threading.Condition()
+
+    def _blocked(self, nbytes):
+        # A request larger than the cap goes through alone, instead of waiting forever. The
+        # inputs of a partition are held until it completes, so a request that all the other
+        # partitions in flight wait on also goes through, over the cap.
+        return (
+            self.used_nbytes > 0
+            and self.used_nbytes + nbytes > self.cap_nbytes
+            and self.num_waiting < self.num_active - 1
+        )
+
+    def start_partition(self):
+        with self.cond:
+            self.num_active += 1
+
+    def finish_partition(self, nbytes):
+        """Release the bytes still held by a partition, which no longer waits on the others."""
+        with self.cond:
+            self.num_active -= 1
+            self.used_nbytes -= nbytes
+            self.cond.notify_all()
+
+    def acquire(self, nbytes, flush):
+        """Wait until `nbytes` fit in the cap. `flush` releases the output bytes of the caller
+        beforehand, so that the waiting workers hold as little as they can."""
+        with self.cond:
+            blocked = self._blocked(nbytes)
+        if blocked:
+            flush()
+        with self.cond:
+            while self._blocked(nbytes):
+                # The others reconsider their requests once this one waits too.
+                self.num_waiting += 1
+                self.cond.notify_all()
+                self.cond.wait()
+                self.num_waiting -= 1
+            self.used_nbytes += nbytes
+            self.peak_nbytes = max(self.peak_nbytes, self.used_nbytes)
+
+    def release(self, nbytes):
+        with self.cond:
+            self.used_nbytes -= nbytes
+            self.cond.notify_all()
+
+
+def _split_transform_params(func, num_partitions: int):
+    """Split a transform_params function into functions that each produce a slice of its
+    outputs, along with the indices of these outputs."""
+    from tvm import relax  # pylint: disable=import-outside-toplevel
+
+    body = func.body
+    out_var = body.body
+    fields = out_var.fields if isinstance(out_var, relax.Tuple) else None
+    blocks = []
+    for block in body.blocks:
+        bindings = []
+        for binding in block.bindings:
+            if binding.var.same_as(out_var):
+                if not isinstance(binding.value, relax.Tuple):
+                    break
+                fields = binding.value.fields
+            else:
+                bindings.append(binding)
+        if bindings:
+            blocks.append(relax.BindingBlock(bindings))
+    if fields is None:
+        raise ValueError("The transform_params function must return a tuple of the parameters")
+
+    num_partitions = max(1, min(num_partitions, len(fields)))
+    partitions = []
+    for k in range(num_partitions):
+        indices = list(range(k, len(fields), num_partitions))
+        outputs = relax.Tuple([fields[i] for i in indices])
+        sinfo = relax.TupleStructInfo([fields[i].struct_info for i in indices])
+        outputs_var = relax.Var("outputs", sinfo)
+        part_body = relax.SeqExpr(
+            [*blocks, relax.BindingBlock([relax.VarBinding(outputs_var, outputs)])], outputs_var
+        )
+        part = relax.Function(func.params, part_body, sinfo, func.is_pure, func.attrs)
+        partitions.append((relax.analysis.remove_all_unused(part), indices))
+    return partitions
+
+
+def stream_transform_params(
+    mod: tvm.IRModule,
+    cache_dir: str,
+    output_dir: str,
+    target: Union[str, "tvm.target.Target"] = "llvm",
+    devices: Optional[Sequence[tvm.runtime.Device]] = None,
+    func_name: str = "transform_params",
+    input_names: Optional[Sequence[str]] = None,
+    output_names: Optional[Sequence[str]] = None,
+    num_threads_per_device: int = 1,
+    num_partitions: Optional[int] = None,
+    memory_cap_mb: int = 4096,
+    shard_cap_mb: int = 32,
+    meta_data=None,
+) -> Mapping[str, Any]:
+    """Transform the parameters of a tensor cache into a new tensor cache, streaming them
+    through the transform so that neither the inputs nor the outputs are all in memory.
+
+    The transform is split into `num_partitions` functions that each produce a slice of its
+    outputs, which are made lazy by LazyTransformParams and run by the workers of each
+    device. An input is read from its shard only when the transform requests it, and an
+    output is appended to an output shard as soon as it is produced, the shards being written
+    to disk when full. The host memory held by the inputs read by the partitions in flight and
+    by the shards not yet written is capped by `memory_cap_mb`, over all the workers. When
+    every other partition in flight waits on the cap, a partition goes over it rather than
+    deadlock.
+
+    Parameters
+    ----------
+    mod: tvm.IRModule
+        The module that contains the transform, e.g. produced by LiftTransformParams.
+
+    cache_dir: str
+        The directory of the tensor cache of the input parameters.
+
+    output_dir: str
+        The directory of the tensor cache of the transformed parameters.
+
+    target: Union[str, tvm.target.Target]
+        The target to compile the transform for.
+
+    devices: Optional[Sequence[tvm.runtime.Device]]
+        The devices of `target` to run the transform on. Defaults to the CPU.
+
+    func_name: str
+        The name of the transform function. It has no runtime input, and its parameters
+        are the parameters of the cache.
+
+    input_names: Optional[Sequence[str]]
+        The names in the cache of the parameters of the transform. Defaults to the names of
+        the function parameters, and must be given when they are passed as a tuple.
+
+    output_names: Optional[Sequence[str]]
+        The names of the transformed parameters. Defaults to `param_{i}`.
+
+    num_threads_per_device: int
+        The number of workers of each device.
+
+    num_partitions: Optional[int]
+        The number of functions the transform is split into. Defaults to the number of
+        workers. The intermediate values used by several outputs of different partitions
+        are computed by each of them.
+
+    memory_cap_mb: int
+        The maximum number of MB of host memory held by the transform at once.
+
+    shard_cap_mb: int
+        The maximum number of MB of an output shard.
+
+    meta_data: json-compatible-struct
+        Extra meta_data to be stored in the output cache json file.
+
+    Returns
+    -------
+    stats: Mapping[str, Any]
+        The "num_partitions", the "num_params" that were written, and the "peak_nbytes" of
+        host memory held at once.
+    """
+    # pylint: disable=import-outside-toplevel
+    from tvm import relax
+
+    if os.path.abspath(cache_dir) == os.path.abspath(output_dir):
+        raise ValueError("The transformed parameters must be written to another directory")
+    devices = [tvm.cpu()] if devices is None else list(devices)
+    num_workers = len(devices) * num_threads_per_device
+    if num_workers <= 0:
+        raise ValueError("stream_transform_params needs at least one worker")
+
+    func = mod[func_name]
+    if func.attrs is not None and "num_input" in func.attrs and int(func.attrs["num_input"]) != 0:
+        raise ValueError(f"{func_name} must not have runtime inputs")
+    if input_names is None:
+        if len(func.params) == 1 and isinstance(func.params[0].struct_info, relax.TupleStructInfo):
+            raise ValueError(
+                f"The parameters of {func_name} are a tuple, the input_names must be given"
+            )
+        input_names = [param.name_hint for param in func.params]
+
+    with open(os.path.join(cache_dir, "tensor-cache.json"), "r") as infile:
+        input_records = {}
+        for shard_rec in json.load(infile)["records"]:
+            for rec in shard_rec["records"]:
+                input_records[rec["name"]] = (shard_rec["dataPath"], rec)
+    for name in input_names:
+        if name not in input_records:
+            raise ValueError(f"Parameter {name} is not in the tensor cache of {cache_dir}")
+
+    partitions = _split_transform_params(
+        relax.transform.ToNonDataflow()(tvm.IRModule({func_name: func}))[func_name],
+        num_workers if num_partitions is None else num_partitions,
+    )
+    part_mod = tvm.IRModule()
+    for k, (part, _) in enumerate(partitions):
+        # Each run passes its own get_item and set_item callbacks, called through trampolines.
+        name = f"part{k}_transform_params"
+        lazy_mod = relax.transform.LazyTransformParams(
+            fget_item="tvmjs.stream_transform.get_item",
+            fset_item="tvmjs.stream_transform.set_item",
+            extra_get_item_params=[relax.Var("fget_item", relax.ObjectStructInfo())],
+            extra_set_item_params=[relax.Var("fset_item", relax.ObjectStructInfo())],
+        )(tvm.IRModule({name: part}))
+        part_mod[name] = lazy_mod[name]
+    executable = tvm.compile(part_mod, target=target)
+
+    num_outputs = sum(len(indices) for _, indices in partitions)
+    if output_names is None:
+        output_names = [f"param_{i}" for i in range(num_outputs)]
+    if len(output_names) != num_outputs:
+        raise ValueError(f"Got {len(output_names)} output names for {num_outputs} outputs")
+
+    os.makedirs(output_dir, exist_ok=True)
+    budget = _HostMemoryBudget(memory_cap_mb * (1 << 20))
+    shard_records = [None] * len(partitions)
+    errors = []
+    work = queue.Queue()
+    for k in range(len(partitions)):
+        work.put(k)
+
+    def run_partition(vm, device, k):
+        indices = partitions[k][1]
+        manager = TensorCacheShardingManager(
+            output_dir, f"params_shard_part{k}", shard_cap_mb * (1 << 20)
+        )
+        files = {}
+        # The VM may keep an input alive until the end of the partition, so the bytes of the
+        # inputs read stay reserved until then.
+        input_nbytes = 0
+
+        def flush():
+            pending = manager.pending_nbytes
+            manager.commit()
+            budget.release(pending)
+
+        def get_item(index):
+            nonlocal input_nbytes
+            data_path, rec = input_records[input_names[index]]
+            nbytes = rec["nbytes"]
+            budget.acquire(nbytes, flush)
+            input_nbytes += nbytes
+            if data_path not in files:
+                files[data_path] = open(os.path.join(cache_dir, data_path), "rb")
+            infile = files[data_path]
+            infile.seek(rec["byteOffset"])
+            return _record_to_tensor(infile.read(nbytes), rec, device)
+
+        def set_item(index, value):
+            nbytes = math.prod(value.shape) * DataType(str(value.dtype)).itemsize
+            budget.acquire(nbytes, flush)
+            pending = manager.pending_nbytes
+            data = value.numpy().tobytes()
+            manager.append_or_update(
+                data,
+                name=output_names[indices[index]],
+                shape=list(value.shape),
+                dtype=str(value.dtype),
+                encode_format="raw",
+            )
+            # Appending may have written the pending shard out.
+            budget.release(pending + nbytes - manager.pending_nbytes)
+
+        budget.start_partition()
+        try:
+            vm[f"part{k}_transform_params"](get_item, set_item)
+            flush()
+            shard_records[k] = manager.finish()
+        finally:
+            # On failure, release the pending shard so that the other workers do not wait on it.
+            budget.finish_partition(input_nbytes + manager.pending_nbytes)
+            for infile in files.values():
+                infile.close()
+
+    def worker(device):
+        try:
+            vm = relax.VirtualMachine(executable, device)
+            while not errors:
+                try:
+                    k = work.get_nowait()
+                except queue.Empty:
+                    return
+                run_partition(vm, device, k)
+        except Exception as err:  # pylint: disable=broad-except
+            errors.append(err)
+
+    threads = [
+        threading.Thread(target=worker, args=(device,))
+        for device in devices
+        for _ in range(num_threads_per_device)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    if errors:
+        raise errors[0]
+
+    records = [shard for shards in shard_records for shard in shards]
+    with open(os.path.join(output_dir, "tensor-cache.json"), "w") as outfile:
+        json.dump({"metadata": meta_data or {}, "records": records}, outfile, indent=4)
+    return {
+        "num_partitions": len(partitions),
+        "num_params": sum(len(shard["records"]) for shard in records),
+        "peak_nbytes": budget.peak_nbytes,
+    }
+
+
 def export_runtime(runtime_dir):
     """Export TVMJS runtime to the runtime_dir
 
@@ -0,0 +1,228 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A persistent, content-addressed cache of the modules built by tvm.tir.build and relax.build.
+
+The cache is keyed by the structural hash of the input module, the target, the current
+PassContext and the build options, and stores the built module as an exported library. An
+identical build, e.g. after a service restart, loads the library instead of compiling again.
+
+The cache is disabled unless a directory is set, through ``set_cache_dir`` or the
+``TVM_COMPILE_CACHE_DIR`` environment variable.
+"""
+import contextlib
+import hashlib
+import logging
+import os
+import threading
+from typing import Any, Callable, Dict, List, Optional
+
+import numpy as np
+
+import tvm
+
+logger = logging.getLogger(__name__)
+
+_cache_dir: Optional[str] = os.environ.get("TVM_COMPILE_CACHE_DIR") or None
+_stats = {"hits": 0, "misses": 0, "stores": 0}
+_state = threading.local()
+
+
+def set_cache_dir(path: Optional[str]) -> None:
+    """Set the directory of the compilation cache.
+
+    Parameters
+    ----------
+    path : Optional[str]
+        The directory, or None to disable the cache.
+    """
+    global _cache_dir  # pylint: disable=global-statement
+    _cache_dir = os.fspath(path) if path else None
+
+
+def get_cache_dir() -> Optional[str]:
+    """Get the directory of the compilation cache, or None if it is disabled."""
+    return _cache_dir
+
+
+def get_stats() -> Dict[str, int]:
+    """Get the numbers of hits, misses and stores of the compilation cache."""
+    return dict(_stats)
+
+
+def reset_stats() -> None:
+    """Reset the statistics of the compilation cache."""
+    for key in _stats:
+        _stats[key] = 0
+
+
+def _hash_pass_context(sha: "hashlib._Hash") -> None:
+    ctx = tvm.transform.PassContext.current()
+    sha.update(f"opt_level={ctx.opt_level}\n".encode())
+    sha.update(f"required={sorted(str(x) for x in ctx.required_pass)}\n".encode())
+    sha.update(f"disabled={sorted(str(x) for x in ctx.disabled_pass)}\n".encode())
+    for key in sorted(str(k) for k in ctx.config.keys()):
+        sha.update(f"config.{key}={ctx.config[key]}\n".encode())
+
+
+def _hash_params(sha: "hashlib._Hash", params: Dict[str, Any]) -> None:
+    for name in sorted(params.keys()):
+        value = params[name]
+        array = value.numpy() if hasattr(value, "numpy") else np.asarray(value)
+        sha.update(f"param.{name}:{array.dtype}:{array.shape}\n".encode())
+        sha.update(np.ascontiguousarray(array).tobytes())
+
+
+def compute_key(
+    kind: str,
+    mod: tvm.IRModule,
+    target: Optional[tvm.target.Target],
+    options: List[Any],
+    params: Optional[Dict[str, Any]] = None,
+) -> Optional[str]:
+    """Compute the cache key of a build.
+
+    Parameters
+    ----------
+    kind : str
+        The kind of the build, e.g. "tir" or "relax".
+    mod : tvm.IRModule
+        The input module.
+    target : Optional[tvm.target.Target]
+        The target of the build.
+    options : List[Any]
+        The other options of the build. Only strings, numbers, booleans and None make a key.
+    params : Optional[Dict[str, Any]]
+        The parameters bound to the module, hashed by content.
+
+    Returns
+    -------
+    key : Optional[str]
+        The key, or None if the build cannot be cached, e.g. with a custom pipeline.
+    """
+    for option in options:
+        if option is not None and not isinstance(option, (str, int, float, bool)):
+            return None
+    sha = hashlib.sha256()
+    sha.update(f"{kind}\n{tvm.__version__}\n".encode())
+    sha.update(f"mod={tvm.ir.structural_hash(mod, map_free_vars=True)}\n".encode())
+    if target is not None:
+        sha.update(f"target={target}\nhost={target.host}\n".encode())
+    sha.update(f"options={options!r}\n".encode())
+    _hash_pass_context(sha)
+    _hash_params(sha, params or {})
+    return sha.hexdigest()
+
+
+def _load(key: str, mod: tvm.IRModule) -> Optional[tvm.runtime.Module]:
+    lib_path = os.path.join(_cache_dir, key + ".so")
+    ir_path = os.path.join(_cache_dir, key + ".ir")
+    if not (os.path.exists(lib_path) and os.path.exists(ir_path)):
+        return None
+    try:
+        with open(ir_path, "rb") as file:
+            cached_mod = tvm.ir.load_binary(file.read())
+        # Guard against the collisions of the structural hash.
+        if not tvm.ir.structural_equal(cached_mod, mod, map_free_vars=True):
+            return None
+        return tvm.runtime.load_module(lib_path)
+    except Exception as err:  # pylint: disable=broad-except
+        logger.warning("Failed to load the compilation cache entry %s: %s", key, err)
+        return None
+
+
+def _store(key: str, mod: tvm.IRModule, built: Any) -> None:
+    os.makedirs(_cache_dir, exist_ok=True)
+    suffix = f".tmp.{os.getpid()}.{threading.get_ident()}"
+    lib_path = os.path.join(_cache_dir, key + ".so")
+    ir_path = os.path.join(_cache_dir, key + ".ir")
+    try:
+        built.export_library(lib_path + suffix)
+        with open(ir_path + suffix, "wb") as file:
+            file.write(tvm.ir.save_binary(mod))
+        # The library is renamed last, so that a reader never sees it without its module.
+        os.replace(ir_path + suffix, ir_path)
+        os.replace(lib_path + suffix, lib_path)
+        _stats["stores"] += 1
+    except Exception as err:  # pylint: disable=broad-except
+        # Not every module can be exported, e.g. without a host compiler.
+        logger.info("Skip storing the compilation cache entry %s: %s", key, err)
+        for path in (lib_path + suffix, ir_path + suffix):
+            if os.path.exists(path):
+                os.remove(path)
+
+
+@contextlib.contextmanager
+def _nested_build():
+    _state.depth = getattr(_state, "depth", 0) + 1
+    try:
+        yield
+    finally:
+        _state.depth -= 1
+
+
+def cached_build(
+    kind: str,
+    mod: tvm.IRModule,
+    target: Optional[tvm.target.Target],
+    options: List[Any],
+    build: Callable[[], Any],
+    wrap: Callable[[tvm.runtime.Module], Any],
+    params: Optional[Dict[str, Any]] = None,
+) -> Any:
+    """Run a build through the compilation cache.
+
+    The builds nested in another one, e.g. tvm.tir.build within relax.build, are not cached on
+    their own, since the outer build exports what they return.
+
+    Parameters
+    ----------
+    kind : str
+        The kind of the build.
+    mod : tvm.IRModule
+        The input module.
+    target : Optional[tvm.target.Target]
+        The target of the build.
+    options : List[Any]
+        The other options of the build.
+    build : Callable[[], Any]
+        The function running the build.
+    wrap : Callable[[tvm.runtime.Module], Any]
+        The function making the result of the build from the library loaded from the cache.
+    params : Optional[Dict[str, Any]]
+        The parameters bound to the module.
+
+    Returns
+    -------
+    result : Any
+        The result of the build.
+    """
+    if _cache_dir is None or getattr(_state, "depth", 0) > 0:
+        with _nested_build():
+            return build()
+    key = compute_key(kind, mod, target, options, params)
+    if key is None:
+        with _nested_build():
+            return build()
+    lib = _load(key, mod)
+    if lib is not None:
+        _stats["hits"] += 1
+        return wrap(lib)
+    _stats["misses"] += 1
+    with _nested_build():
+        built = build()
+    _store(key, mod, built)
+    return built
@@ -145,6 +145,41 @@ def save_json(node) -> str:
     return _ffi_node_api.SaveJSON(node)
 
 
+def load_binary(data: bytes) -> Object:
+    """Load tvm object from the binary data of save_binary.
+
+    Parameters
+    ----------
+    data : bytes
+        The binary data.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return _ffi_node_api.LoadBinary(data)
+
+
+def save_binary(node) -> bytes:
+    """Save tvm object in a compact binary format.
+
+    It holds the same graph as save_json, with the strings interned, varint integers and the
+    tensors as raw bytes, so that it is smaller and loads faster.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    data : bytes
+        Saved binary data.
+    """
+    return _ffi_node_api.SaveBinary(node)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
@@ -294,6 +329,33 @@ def structural_hash(node, map_free_vars=False):
     return _ffi_node_api.StructuralHash(node, map_free_vars)  # type: ignore # pylint: disable=no-member
 
 
+def set_structural_hash_cache_capacity(capacity):
+    """Set the capacity of the structural hash cache used by meta schedule.
+
+    The cache keeps the hash values of the most recently hashed objects, so that
+    hashing the same object again, e.g. a module in the tuning database, is a lookup.
+    A capacity of zero, the default, disables and empties the cache.
+
+    Parameters
+    ----------
+    capacity : int
+        The number of hash values to keep.
+    """
+    _ffi_node_api.StructuralHashCacheSetCapacity(capacity)  # type: ignore # pylint: disable=no-member
+
+
+def structural_hash_cache_stats():
+    """Return the hits and misses of the structural hash cache.
+
+    Return
+    ------
+    result : Dict[str, int]
+        The counters of the cache lookups.
+    """
+    stats = _ffi_node_api.StructuralHashCacheGetStats()  # type: ignore # pylint: disable=no-member
+    return {key: int(value) for key, value in stats.items()}
+
+
 def deprecated(
     method_name: str,
     new_method_name: str,
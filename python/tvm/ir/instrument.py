@@ -259,6 +259,66 @@ class PassTimingInstrument(tvm.runtime.Object):
         return _ffi_instrument_api.RenderTimePassProfiles()
 
 
+class PassResourceInstrument(tvm.runtime.Object):
+    """A pass instrument implemented in C++ that records, per pass, the change of the number
+    of IR nodes, the IR nodes allocated, the arithmetic analyzer queries and the nodes rebuilt
+    by the default TIR mutators, on top of the time spent in the pass.
+
+    Parameters
+    ----------
+    check_needless_copies : bool
+        Whether to also count the rebuilt nodes that are structurally equal to their original,
+        which compares each rebuilt node with its original and slows the passes down.
+    """
+
+    def __init__(self, check_needless_copies=False):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassResourceInstrument, check_needless_copies
+        )
+
+    @staticmethod
+    def profiles():
+        """Retrieve the profiles of the passes run so far in the current PassContext.
+
+        Returns
+        -------
+        profiles : List[Dict[str, Any]]
+            The profiles in pre-order. Each has the name of the pass, its path of enclosing
+            passes, its depth, its duration in microseconds, the numbers of IR nodes before
+            and after it, and its resource counters, including those of its sub-passes.
+        """
+        return [dict(p) for p in _ffi_instrument_api.GetPassResourceProfiles()]
+
+    @staticmethod
+    def render_flame_graph(metric="alloc_bytes"):
+        """Render the profiles in the folded stack format read by flamegraph.pl and speedscope.
+
+        Parameters
+        ----------
+        metric : str
+            The metric weighting the passes: "duration_us", "nodes_delta", "alloc_objects",
+            "alloc_bytes", "simplify_calls", "can_prove_calls", "analyzer_memo_hits",
+            "analyzer_memo_misses", "mutator_copies" or "needless_mutator_copies".
+
+        Returns
+        -------
+        folded : str
+            One line per pass with its own usage of the metric.
+
+        Examples
+        --------
+
+        .. code-block:: python
+
+            inst = PassResourceInstrument()
+            with tvm.transform.PassContext(instruments=[inst]):
+                mod = tvm.tir.transform.Simplify()(mod)
+                # before exiting the context, get profile results.
+                folded = inst.render_flame_graph("simplify_calls")
+        """
+        return _ffi_instrument_api.RenderPassResourceFlameGraph(metric)
+
+
 @pass_instrument
 class PassPrintingInstrument:
     """A pass instrument to print if before or
@@ -18,7 +18,7 @@
 
 from __future__ import annotations
 
-from typing import Dict, Union
+from typing import Dict, Optional, Union
 
 import tvm
 import tvm_ffi
@@ -312,3 +312,40 @@ class IRModule(Node, Scriptable):
             attr_map = attr_map._dict()
 
         return _ffi_api.Module_WithAttrs(self, attr_map)
+
+    def script_per_function(
+        self, path: Optional[str] = None, num_threads: int = 0, **kwargs
+    ) -> Optional[str]:
+        """Print the module to TVMScript one function at a time, for large modules.
+
+        Each function is printed on its own, in parallel, without building the Doc of the
+        whole module. The script is the same as that of `script`, except that the indices
+        of the omitted metadata restart in each function.
+
+        Parameters
+        ----------
+        path : Optional[str]
+            The file to write the script to. If None, the script is returned.
+
+        num_threads : int
+            The number of threads to print the functions, or 0 for all the cores.
+
+        kwargs
+            The options of `script`, except show_meta and print_line_numbers.
+
+        Returns
+        -------
+        script : Optional[str]
+            The script of the module, if path is None.
+        """
+        # pylint: disable=import-outside-toplevel
+        from tvm.runtime.script_printer import PrinterConfig
+
+        config = PrinterConfig(**kwargs)
+        if path is None:
+            func = tvm_ffi.get_global_func("script.printer.IRModuleScriptPerFunction")
+            return func(self, config, num_threads)
+        tvm_ffi.get_global_func("script.printer.IRModuleScriptToFile")(
+            self, config, path, num_threads
+        )
+        return None
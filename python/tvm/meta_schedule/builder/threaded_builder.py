@@ -0,0 +1,68 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Builder that compiles in the current process on a thread pool"""
+from typing import Optional, Union
+
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from ..logging import get_logger
+from ..utils import cpu_count, get_global_func_with_default_on_worker
+from .builder import Builder
+from .local_builder import T_BUILD, T_EXPORT, default_build, default_export
+
+logger = get_logger(__name__)  # pylint: disable=invalid-name
+
+
+@register_object("meta_schedule.ThreadedBuilder")
+class ThreadedBuilder(Builder):
+    """A builder that builds the given inputs in the current process on a thread pool.
+
+    Unlike LocalBuilder, it neither spawns worker processes nor serializes the inputs to them,
+    which dominates the build time of small kernels. The build is not isolated from the tuning
+    process, so a timeout cannot be enforced, and a crash in codegen ends the tuning.
+
+    Parameters
+    ----------
+    max_workers : Optional[int]
+        The number of threads to build with. Defaults to the number of CPUs.
+    f_build : Union[None, str, T_BUILD]
+        Name of the build function to be used.
+        Defaults to `meta_schedule.builder.default_build`.
+    f_export : Union[None, str, T_EXPORT]
+        Name of the export function to be used.
+        Defaults to `meta_schedule.builder.default_export`.
+    """
+
+    num_threads: int
+
+    def __init__(
+        self,
+        *,
+        max_workers: Optional[int] = None,
+        f_build: Union[None, str, T_BUILD] = None,
+        f_export: Union[None, str, T_EXPORT] = None,
+    ) -> None:
+        if max_workers is None:
+            max_workers = cpu_count(logical=True)
+        logger.info("ThreadedBuilder: max_workers = %d", max_workers)
+        self.__init_handle_by_constructor__(
+            _ffi_api.BuilderThreadedBuilder,  # type: ignore # pylint: disable=no-member
+            max_workers,
+            get_global_func_with_default_on_worker(f_build, default_build),
+            get_global_func_with_default_on_worker(f_export, default_export),
+        )
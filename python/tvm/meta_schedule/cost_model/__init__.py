@@ -18,5 +18,6 @@
 The tvm.meta_schedule.cost_model package.
 """
 from .cost_model import CostModel, PyCostModel
+from .gbdt_model import GBDTModel
 from .random_model import RandomModel
 from .xgb_model import XGBModel
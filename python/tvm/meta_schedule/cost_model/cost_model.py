@@ -28,17 +28,18 @@ from tvm_ffi import register_object
 from tvm.runtime import Object
 
 from .. import _ffi_api
+from ..database import Database
 from ..runner import RunnerResult
 from ..search_strategy import MeasureCandidate
 from ..tune_context import TuneContext
-from ..utils import _get_default_str
+from ..utils import _get_default_str, cpu_count
 
 
 @register_object("meta_schedule.CostModel")
 class CostModel(Object):
     """Cost model."""
 
-    CostModelType = Union["CostModel", Literal["xgb", "mlp", "random"]]
+    CostModelType = Union["CostModel", Literal["xgb", "gbdt", "mlp", "random"]]
 
     def load(self, path: str) -> None:
         """Load the cost model from given file location.
@@ -104,9 +105,30 @@ class CostModel(Object):
         )
         return results
 
+    def pretrain(
+        self,
+        database: Database,
+        num_threads: Union[int, Literal["physical", "logical"]] = "physical",
+    ) -> None:
+        """Pretrain the cost model on the valid tuning records of a database.
+
+        A pretrained model, saved and later loaded as the `cost_model` of a tuning session,
+        ranks candidates from the first trial instead of predicting random scores.
+
+        Parameters
+        ----------
+        database : Database
+            The database to read the tuning records from.
+        num_threads : Union[int, Literal["physical", "logical"]]
+            The number of threads to replay the traces of the records.
+        """
+        if not isinstance(num_threads, int):
+            num_threads = cpu_count(logical=num_threads == "logical")
+        _ffi_api.CostModelPretrain(self, database, num_threads)  # type: ignore # pylint: disable=no-member
+
     @staticmethod
     def create(
-        kind: Literal["xgb", "mlp", "random", "none"],
+        kind: Literal["xgb", "gbdt", "mlp", "random", "none"],
         *args,
         **kwargs,
     ) -> "CostModel":
@@ -114,15 +136,19 @@ class CostModel(Object):
 
         Parameters
         ----------
-        kind : Literal["xgb", "mlp", "random", "none"]
-            The kind of the cost model. Can be "xgb", "mlp", "random" or "none".
+        kind : Literal["xgb", "gbdt", "mlp", "random", "none"]
+            The kind of the cost model. Can be "xgb", "gbdt", "mlp", "random" or "none".
 
         Returns
         -------
         cost_model : CostModel
             The created cost model.
         """
-        from . import RandomModel, XGBModel  # pylint: disable=import-outside-toplevel
+        from . import (  # pylint: disable=import-outside-toplevel
+            GBDTModel,
+            RandomModel,
+            XGBModel,
+        )
 
         if kind == "xgb":
             return XGBModel(*args, **kwargs)  # type: ignore
@@ -134,6 +160,8 @@ class CostModel(Object):
             if param in kwargs:
                 kwargs.pop(param)
 
+        if kind == "gbdt":
+            return GBDTModel(*args, **kwargs)  # type: ignore
         if kind == "random":
             return RandomModel(*args, **kwargs)  # type: ignore
         if kind == "mlp":
@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Gradient boosted trees cost model implemented in C++"""
+from typing import Optional
+
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from ..feature_extractor import FeatureExtractor
+from .cost_model import CostModel
+
+
+@register_object("meta_schedule.GBDTModel")
+class GBDTModel(CostModel):
+    """Gradient boosted trees cost model that trains and predicts natively.
+
+    It optimizes the same objective as XGBModel, but neither training nor inference enters
+    Python, so the tuning threads score candidates without holding the GIL.
+
+    Parameters
+    ----------
+    extractor : FeatureExtractor.FeatureExtractorType
+        The feature extractor.
+    num_trees : int
+        The number of boosting rounds in each training.
+    max_depth : int
+        The maximum depth of a tree.
+    learning_rate : float
+        The shrinkage applied to the output of each tree.
+    reg_lambda : float
+        The L2 regularization on the leaf outputs.
+    gamma : float
+        The minimum loss reduction required to split a node.
+    min_child_weight : float
+        The minimum sum of hessians in a child.
+    max_bins : int
+        The maximum number of histogram bins per feature, at most 256.
+    num_warmup_samples : int
+        The number of samples before the model predicts random scores.
+    adaptive_training : bool
+        Whether to skip retraining until the data grows by a fifth.
+    seed : Optional[int]
+        The seed of the random scores predicted during warmup.
+    """
+
+    def __init__(
+        self,
+        *,
+        extractor: FeatureExtractor.FeatureExtractorType = "per-store-feature",
+        num_trees: int = 100,
+        max_depth: int = 8,
+        learning_rate: float = 0.2,
+        reg_lambda: float = 1.0,
+        gamma: float = 0.001,
+        min_child_weight: float = 0.0,
+        max_bins: int = 64,
+        num_warmup_samples: int = 100,
+        adaptive_training: bool = True,
+        seed: Optional[int] = None,
+    ):
+        if not isinstance(extractor, FeatureExtractor):
+            extractor = FeatureExtractor.create(extractor)
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostModelGBDTModel,  # type: ignore # pylint: disable=no-member
+            extractor,
+            num_trees,
+            max_depth,
+            learning_rate,
+            reg_lambda,
+            gamma,
+            min_child_weight,
+            max_bins,
+            num_warmup_samples,
+            adaptive_training,
+            -1 if seed is None else seed,
+        )
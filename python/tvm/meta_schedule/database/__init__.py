@@ -18,9 +18,13 @@
 The tvm.meta_schedule.database package.
 The database that stores serialized tuning records and workloads
 """
+from .anchor_block_database import AnchorBlockDatabase
+from .binary_database import BinaryDatabase
 from .database import Database, PyDatabase, TuningRecord, Workload, create
 from .json_database import JSONDatabase
 from .memory_database import MemoryDatabase
+from .nearest_neighbor_database import NearestNeighborDatabase
 from .ordered_union_database import OrderedUnionDatabase
+from .remote_database import DatabaseServer, RemoteDatabase
 from .schedule_fn_database import ScheduleFnDatabase
 from .union_database import UnionDatabase
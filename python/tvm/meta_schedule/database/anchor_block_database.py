@@ -0,0 +1,52 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A database that reuses the records of the tuned workloads with the same anchor block."""
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .database import Database
+
+
+@register_object("meta_schedule.AnchorBlockDatabase")
+class AnchorBlockDatabase(Database):
+    """A database that answers the queries of the workloads it has not seen without measurement.
+
+    A query the underlying database cannot answer is served from the tuned workloads whose anchor
+    block, e.g. the conv2d or the matmul, is structurally equal to the queried one, whatever the
+    elementwise blocks fused around it. Their `k` fastest records are re-applied as anchor traces
+    with `tvm.meta_schedule.trace_apply.schedule_using_anchor_trace`, which inlines or
+    parallelizes the blocks the trace does not schedule, and the first that applies is returned.
+    The returned record has no run time, as it is never measured.
+
+    Unlike a database created with `module_equality="anchor-block"`, the records stay keyed by
+    their full workloads, so a database tuned with the default equality can be reused as is.
+    All the other methods, including the commits, go to the underlying database.
+
+    Parameters
+    ----------
+    database : Database
+        The database of the tuned workloads.
+    k : int
+        The number of best records of the same anchor block tried on a query.
+    """
+
+    def __init__(self, database: Database, k: int = 5) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseAnchorBlockDatabase,  # type: ignore # pylint: disable=no-member
+            database,
+            k,
+        )
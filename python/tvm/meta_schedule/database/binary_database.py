@@ -0,0 +1,110 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A database stored in a single memory-mapped binary file"""
+import os.path as osp
+from typing import Optional
+
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .database import Database
+
+
+@register_object("meta_schedule.BinaryDatabase")
+class BinaryDatabase(Database):
+    """Database class backed by a single binary file.
+
+    Opening the database memory-maps the file and indexes its entries without decoding them.
+    Workloads and tuning records are decoded the first time a lookup needs them, which makes
+    opening large databases much faster than with JSONDatabase.
+
+    Parameters
+    ----------
+    path : str
+        The path to the database file.
+    module_equality : Optional[str]
+        A string to specify the module equality testing and hashing method.
+        See JSONDatabase for the supported values.
+    """
+
+    path: str
+
+    def __init__(
+        self,
+        path: Optional[str] = None,
+        *,
+        work_dir: Optional[str] = None,
+        allow_missing: bool = True,
+        module_equality: str = "structural",
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        path : Optional[str] = None
+            The path to the database file. If not specified,
+            will be generated from `work_dir` as `$work_dir/database.bin`.
+        work_dir : Optional[str] = None
+            The work directory, if specified, will be used to generate `path`.
+        allow_missing : bool
+            Whether to create new file when the given path is not found.
+        module_equality : str
+            A string to specify the module equality testing and hashing method.
+        """
+        if path is None and work_dir is not None:
+            path = osp.join(work_dir, "database.bin")
+        if path is None:
+            raise ValueError("`path` is not specified.")
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseBinaryDatabase,  # type: ignore # pylint: disable=no-member
+            path,
+            allow_missing,
+            module_equality,
+        )
+
+    @staticmethod
+    def from_json(
+        path_workload: str,
+        path_tuning_record: str,
+        path: str,
+        module_equality: str = "structural",
+    ) -> "BinaryDatabase":
+        """Convert the tables of a JSONDatabase into a binary database file.
+
+        Parameters
+        ----------
+        path_workload : str
+            The path to the workload table of the JSONDatabase.
+        path_tuning_record : str
+            The path to the tuning record table of the JSONDatabase.
+        path : str
+            The path to the binary database file to create. Existing content is overwritten.
+        module_equality : str
+            A string to specify the module equality testing and hashing method.
+
+        Returns
+        -------
+        database : BinaryDatabase
+            The converted database.
+        """
+        _ffi_api.DatabaseConvertJSONToBinary(  # type: ignore # pylint: disable=no-member
+            path_workload,
+            path_tuning_record,
+            path,
+            module_equality,
+        )
+        return BinaryDatabase(path, allow_missing=False, module_equality=module_equality)
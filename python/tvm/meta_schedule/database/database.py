@@ -325,6 +325,26 @@ class Database(Object):
             self, destination
         )
 
+    def compact(self, top_k: int) -> int:
+        """Compact the database in place.
+
+        The invalid records, i.e. those without a measured run time, are dropped, the records of
+        the same trace of a workload are deduplicated, and only the `top_k` fastest records of
+        each workload are kept. A JSONDatabase rewrites its tuning record file atomically, so
+        that a periodic job can compact it while it is not being tuned into.
+
+        Parameters
+        ----------
+        top_k : int
+            The number of records kept per workload.
+
+        Returns
+        -------
+        num_removed : int
+            The number of records removed.
+        """
+        return _ffi_api.DatabaseCompact(self, top_k)  # type: ignore # pylint: disable=no-member
+
     def query(
         self,
         mod: IRModule,
@@ -380,6 +400,7 @@ class Database(Object):
         kind: Union[
             Literal[
                 "json",
+                "binary",
                 "memory",
                 "union",
                 "ordered_union",
@@ -393,10 +414,10 @@ class Database(Object):
 
         Parameters
         ----------
-        kind : str = "json" | "memory" | "union" | "ordered_union" | Callable[[tvm.tir.Schedule],
-        bool]
+        kind : str = "json" | "binary" | "memory" | "union" | "ordered_union" |
+        Callable[[tvm.tir.Schedule], bool]
             The kind of the database to be created. The following kinds are supported:
-            "json", "memory", "union", "ordered_union", and a custom schedule function.
+            "json", "binary", "memory", "union", "ordered_union", and a custom schedule function.
 
         Returns
         -------
@@ -404,6 +425,7 @@ class Database(Object):
             The created database.
         """
         from . import (  # pylint: disable=import-outside-toplevel
+            BinaryDatabase,
             JSONDatabase,
             MemoryDatabase,
             OrderedUnionDatabase,
@@ -415,6 +437,8 @@ class Database(Object):
             return ScheduleFnDatabase(kind, *args, **kwargs)  # type: ignore
         if kind == "json":
             return JSONDatabase(*args, **kwargs)
+        if kind == "binary":
+            return BinaryDatabase(*args, **kwargs)  # type: ignore
         if kind == "memory":
             return MemoryDatabase(*args, **kwargs)  # type: ignore
         if kind == "union":
@@ -48,6 +48,7 @@ class JSONDatabase(Database):
 
     path_workload: str
     path_tuning_record: str
+    max_records_per_workload: int
 
     def __init__(
         self,
@@ -57,6 +58,7 @@ class JSONDatabase(Database):
         work_dir: Optional[str] = None,
         allow_missing: bool = True,
         module_equality: str = "structural",
+        max_records_per_workload: Optional[int] = None,
     ) -> None:
         """Constructor.
 
@@ -73,6 +75,10 @@ class JSONDatabase(Database):
             and `path_workload`.
         allow_missing : bool
             Whether to create new file when the given path is not found.
+        max_records_per_workload : Optional[int] = None
+            The maximum number of valid records, and of invalid records, kept in memory for
+            each workload. Only the fastest valid records are kept. The files on disk are not
+            truncated. If not specified, all records are kept.
         """
         if work_dir is not None:
             if path_workload is None:
@@ -89,4 +95,5 @@ class JSONDatabase(Database):
             path_tuning_record,
             allow_missing,
             module_equality,
+            -1 if max_records_per_workload is None else max_records_per_workload,
         )
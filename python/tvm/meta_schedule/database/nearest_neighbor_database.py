@@ -0,0 +1,50 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A database that transfers the schedules of the nearest tuned workloads."""
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .database import Database
+
+
+@register_object("meta_schedule.NearestNeighborDatabase")
+class NearestNeighborDatabase(Database):
+    """A database that answers the queries of the workloads it has not seen without measurement.
+
+    A query the underlying database cannot answer is served from the tuned workloads whose
+    anchor blocks have the same name, block iter types and buffer dtypes as the queried one.
+    The `k` of them closest in shape, measured by the sum of the absolute log ratios of the block
+    iter extents, are tried from the nearest, and the first record whose trace replays onto the
+    queried module is returned, with its tile sizes fitted to the new loop extents. The returned
+    record has no run time, as it is never measured.
+
+    All the other methods, including the commits, go to the underlying database.
+
+    Parameters
+    ----------
+    database : Database
+        The database of the tuned workloads.
+    k : int
+        The number of nearest workloads whose records are tried on a query.
+    """
+
+    def __init__(self, database: Database, k: int = 5) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseNearestNeighborDatabase,  # type: ignore # pylint: disable=no-member
+            database,
+            k,
+        )
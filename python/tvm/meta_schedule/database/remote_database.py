@@ -0,0 +1,112 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A database that shares TuningRecords with other tuning jobs through a server"""
+from tvm.runtime import Object
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .database import Database
+
+
+@register_object("meta_schedule.RemoteDatabase")
+class RemoteDatabase(Database):
+    """A database backed by a DatabaseServer, so that concurrent tuning jobs share their records.
+
+    Records are kept in a local cache. The committed records are sent to the server in batches,
+    and the records of other jobs are pulled at most once per `pull_interval_sec`.
+
+    Parameters
+    ----------
+    host : str
+        The host of the server.
+    port : int
+        The port of the server.
+    commit_batch_size : int
+        The number of buffered records that triggers a commit to the server.
+    pull_interval_sec : float
+        The minimum interval between two pulls from the server, in seconds.
+    module_equality : Optional[str]
+        A string to specify the module equality testing and hashing method.
+        It must match the one used by the other jobs.
+    """
+
+    host: str
+    port: int
+    commit_batch_size: int
+    pull_interval_sec: float
+    cache: Database
+
+    def __init__(
+        self,
+        host: str,
+        port: int,
+        *,
+        commit_batch_size: int = 16,
+        pull_interval_sec: float = 5.0,
+        module_equality: str = "structural",
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseRemoteDatabase,  # type: ignore # pylint: disable=no-member
+            host,
+            port,
+            commit_batch_size,
+            pull_interval_sec,
+            module_equality,
+        )
+
+    def sync(self) -> None:
+        """Commit the buffered records and pull the records of other jobs."""
+        _ffi_api.RemoteDatabaseSync(self)  # type: ignore # pylint: disable=no-member
+
+
+@register_object("meta_schedule.DatabaseServer")
+class DatabaseServer(Object):
+    """A server that shares the records of a database with the connected RemoteDatabases.
+
+    Parameters
+    ----------
+    database : Database
+        The backing database, which receives every record committed by the clients.
+    host : str
+        The host to listen on.
+    port : int
+        The first port to try.
+    port_end : int
+        The end of the port range to try.
+    """
+
+    database: Database
+    port: int
+
+    def __init__(
+        self,
+        database: Database,
+        host: str = "0.0.0.0",
+        port: int = 9190,
+        port_end: int = 9290,
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.DatabaseServerStart,  # type: ignore # pylint: disable=no-member
+            database,
+            host,
+            port,
+            port_end,
+        )
+
+    def stop(self) -> None:
+        """Stop the server and disconnect the clients."""
+        _ffi_api.DatabaseServerStop(self)  # type: ignore # pylint: disable=no-member
@@ -38,6 +38,12 @@ class PerStoreFeature(FeatureExtractor):
         The number of bytes in a cache line.
     extract_workload : bool
         Whether to extract features in the workload in tuning context or not.
+    cache_size : int
+        The number of modules whose features are cached, 0 to disable caching. Candidates are
+        scored again when the cost model is updated with their results, which hits the cache.
+    extract_texture : bool
+        Whether to extract the bytes each store reads from textures or not, for the targets
+        that read their inputs through a texture cache such as Adreno.
     """
 
     buffers_per_store: int
@@ -48,6 +54,10 @@ class PerStoreFeature(FeatureExtractor):
     """The number of bytes in a cache line."""
     extract_workload: bool
     """Whether to extract features in the workload in tuning context or not."""
+    cache_size: int
+    """The number of modules whose features are cached."""
+    extract_texture: bool
+    """Whether to extract the bytes each store reads from textures or not."""
     feature_vector_length: int
     """Length of the feature vector."""
 
@@ -57,6 +67,8 @@ class PerStoreFeature(FeatureExtractor):
         arith_intensity_curve_num_samples: int = 10,
         cache_line_bytes: int = 64,
         extract_workload: bool = False,
+        cache_size: int = 1024,
+        extract_texture: bool = False,
     ):
         self.__init_handle_by_constructor__(
             _ffi_api.FeatureExtractorPerStoreFeature,  # type: ignore # pylint: disable=no-member
@@ -64,4 +76,6 @@ class PerStoreFeature(FeatureExtractor):
             arith_intensity_curve_num_samples,
             cache_line_bytes,
             extract_workload,
+            cache_size,
+            extract_texture,
         )
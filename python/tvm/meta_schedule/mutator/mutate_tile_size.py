@@ -29,3 +29,26 @@ class MutateTileSize(Mutator):
         self.__init_handle_by_constructor__(
             _ffi_api.MutatorMutateTileSize,  # type: ignore # pylint: disable=no-member
         )
+
+
+@register_object("meta_schedule.MutateTileSizeGuided")
+class MutateTileSizeGuided(Mutator):
+    """Mutator that mutates the tile sizes as MutateTileSize does, but drops the mutations that
+    exceed the thread, shared memory, register or vector width limits of a GPU target before the
+    postprocessors, and prefers the tile sizes of the population that the cost model scored high.
+
+    Parameters
+    ----------
+    max_candidates : int
+        The number of mutations drawn at a time to choose from.
+    temperature : float
+        The temperature of the softmax choice over the score statistics of the mutated tile
+        sizes. Zero takes the first mutation within the limits.
+    """
+
+    def __init__(self, max_candidates: int = 8, temperature: float = 0.05) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.MutatorMutateTileSizeGuided,  # type: ignore # pylint: disable=no-member
+            max_candidates,
+            temperature,
+        )
@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Meta Schedule Mutator."""
-from typing import TYPE_CHECKING, Callable, Dict, Optional
+from typing import TYPE_CHECKING, Callable, Dict, List, Optional
 
 # isort: off
 from typing_extensions import Literal
@@ -63,6 +63,20 @@ class Mutator(Object):
         """
         return _ffi_api.MutatorApply(self, trace, -1)  # type: ignore # pylint: disable=no-member
 
+    def notify_predicted_scores(self, traces: List[Trace], scores: List[float]) -> None:
+        """Observe the scores that the cost model predicted for the population of a search.
+
+        Parameters
+        ----------
+        traces : List[Trace]
+            The traces of the population.
+        scores : List[float]
+            The normalized predicted score of each trace.
+        """
+        _ffi_api.MutatorNotifyPredictedScores(  # type: ignore # pylint: disable=no-member
+            self, traces, [float(score) for score in scores]
+        )
+
     def clone(self) -> "Mutator":
         """Clone the mutator.
 
@@ -80,13 +94,14 @@ class Mutator(Object):
             "cuda",
             "cuda-tensorcore",
             "hexagon",
+            "adreno",
         ],
     ) -> Dict["Mutator", float]:
         """Create a list of default mutators.
 
         Parameters
         ----------
-        kind : Literal["llvm", "cuda", "cuda-tensorcore", "hexagon"]
+        kind : Literal["llvm", "cuda", "cuda-tensorcore", "hexagon", "adreno"]
             The kind of mutators.
 
         Returns
@@ -100,6 +115,7 @@ class Mutator(Object):
             "cuda": _ffi_api.MutatorDefaultCUDA,  # type: ignore
             "cuda-tensorcore": _ffi_api.MutatorDefaultCUDATensorCore,  # type: ignore
             "hexagon": _ffi_api.MutatorDefaultHexagon,  # type: ignore
+            "adreno": _ffi_api.MutatorDefaultCUDA,  # type: ignore
             # pylint: enable=no-member
         }
         for k, v in funcs.items():
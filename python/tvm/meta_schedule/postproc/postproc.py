@@ -75,12 +75,14 @@ class Postproc(Object):
         return _ffi_api.PostprocClone(self)  # type: ignore # pylint: disable=no-member
 
     @staticmethod
-    def create(kind: Literal["llvm", "cuda", "cuda-tensorcore", "hexagon"]) -> List["Postproc"]:
+    def create(
+        kind: Literal["llvm", "cuda", "cuda-tensorcore", "hexagon", "adreno"],
+    ) -> List["Postproc"]:
         """Create a list of default postprocessors.
 
         Parameters
         ----------
-        kind : Literal["llvm", "cuda", "cuda-tensorcore", "hexagon"]
+        kind : Literal["llvm", "cuda", "cuda-tensorcore", "hexagon", "adreno"]
             The kind of the postprocessors.
 
         Returns
@@ -94,6 +96,7 @@ class Postproc(Object):
             "cuda": _ffi_api.PostprocDefaultCUDA,  # type: ignore
             "cuda-tensorcore": _ffi_api.PostprocDefaultCUDATensorCore,  # type: ignore
             "hexagon": _ffi_api.PostprocDefaultHexagon,  # type: ignore
+            "adreno": _ffi_api.PostprocDefaultAdreno,  # type: ignore
             # pylint: enable=no-member
         }
         for k, v in funcs.items():
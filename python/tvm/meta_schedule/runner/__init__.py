@@ -19,6 +19,7 @@ The tvm.meta_schedule.runner package.
 Meta Schedule runners that runs an artifact either locally or through the RPC interface
 """
 from .config import EvaluatorConfig, RPCConfig
+from .interleaved_runner import InterleavedRunner
 from .local_runner import LocalRunner, LocalRunnerFuture
 from .rpc_runner import RPCRunner
 from .runner import (
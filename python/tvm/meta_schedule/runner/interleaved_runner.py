@@ -0,0 +1,61 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Runner that measures a batch of candidates in the current process"""
+from typing import Optional
+
+from tvm_ffi import register_object
+
+from ...runtime import load_module
+from .. import _ffi_api
+from .config import EvaluatorConfig
+from .runner import Runner
+
+
+@register_object("meta_schedule.InterleavedRunner")
+class InterleavedRunner(Runner):
+    """A runner that measures a batch of built modules in the current process.
+
+    The arguments are allocated once per device and signature and shared by all the candidates
+    of the batch. Each repeat measures every candidate once before the next repeat starts, so a
+    drift of the device over the batch biases all the candidates alike. With
+    `enable_cpu_cache_flush`, the L2 cache is flushed before each repeat on CUDA devices, and the
+    CPU cache on CPUs.
+
+    Unlike LocalRunner, the measurement is not isolated from the tuning process, so a timeout
+    cannot be enforced and a crashing kernel ends the tuning.
+
+    Parameters
+    ----------
+    evaluator_config: EvaluatorConfig
+        The evaluator configuration.
+    """
+
+    number: int
+    repeat: int
+    min_repeat_ms: int
+    enable_cache_flush: bool
+
+    def __init__(self, evaluator_config: Optional[EvaluatorConfig] = None) -> None:
+        evaluator_config = EvaluatorConfig._normalized(evaluator_config)
+        self.__init_handle_by_constructor__(
+            _ffi_api.RunnerInterleavedRunner,  # type: ignore # pylint: disable=no-member
+            load_module,
+            evaluator_config.number,
+            evaluator_config.repeat,
+            evaluator_config.min_repeat_ms,
+            evaluator_config.enable_cpu_cache_flush,
+        )
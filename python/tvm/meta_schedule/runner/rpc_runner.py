@@ -16,11 +16,13 @@
 # under the License.
 """RPC Runner"""
 import concurrent.futures
+import hashlib
 import os.path as osp
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 
 from tvm.contrib.popen_pool import PopenPoolExecutor
+from tvm.error import TVMError
 from tvm.rpc import RPCSession
 from tvm.runtime import Device, Module
 
@@ -155,6 +157,8 @@ class RPCRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    session_reuse: bool
+        Whether each worker keeps its session open across the measurements.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -229,6 +233,7 @@ class RPCRunner(PyRunner):
     f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None]
     f_run_evaluator: Union[T_RUN_EVALUATOR, str, None]
     f_cleanup: Union[T_CLEANUP, str, None]
+    session_reuse: bool
 
     pool: PopenPoolExecutor
 
@@ -245,6 +250,7 @@ class RPCRunner(PyRunner):
         f_cleanup: Union[T_CLEANUP, str, None] = None,
         max_workers: Optional[int] = None,
         initializer: Optional[Callable[[], None]] = None,
+        session_reuse: bool = False,
     ) -> None:
         """Constructor
 
@@ -272,6 +278,12 @@ class RPCRunner(PyRunner):
             The maximum number of connections. Defaults to 1.
         initializer: Optional[Callable[[], None]]
             The initializer function.
+        session_reuse: bool
+            Whether each worker keeps its session open across the measurements, instead of
+            requesting a session from the tracker for each of them. The server then caches the
+            modules it loads by the hash of their artifact, so measuring an artifact again
+            skips its upload. A kept session holds its server, so use as many workers as
+            servers to measure on all of them. A session is dropped when a measurement fails.
         """
         super().__init__()
         self.rpc_config = RPCConfig._normalized(rpc_config)
@@ -283,6 +295,7 @@ class RPCRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self.session_reuse = session_reuse
         if max_workers is None:
             max_workers = 1
         logger.info("RPCRunner: max_workers = %d", max_workers)
@@ -309,6 +322,7 @@ class RPCRunner(PyRunner):
                     str(runner_input.artifact_path),
                     str(runner_input.device_type),
                     tuple(arg_info.as_json() for arg_info in runner_input.args_info),
+                    self.session_reuse,
                 ),
                 timeout_sec=self.rpc_config.session_timeout_sec,
             )
@@ -352,6 +366,7 @@ def _worker_func(
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
+    session_reuse: bool = False,
 ) -> List[float]:
     # Step 0. Get the registered functions
     f_create_session: T_CREATE_SESSION = get_global_func_with_default_on_worker(
@@ -367,6 +382,20 @@ def _worker_func(
         _f_run_evaluator, default_run_evaluator
     )
     f_cleanup: T_CLEANUP = get_global_func_with_default_on_worker(_f_cleanup, default_cleanup)
+    if session_reuse:
+        return _run_on_pooled_session(
+            f_create_session,
+            f_upload_module,
+            f_alloc_argument,
+            f_run_evaluator,
+            f_cleanup,
+            rpc_config,
+            evaluator_config,
+            alloc_repeat,
+            artifact_path,
+            device_type,
+            args_info,
+        )
     # Managed resources
     session: Optional[RPCSession] = None
     remote_path: Optional[str] = None
@@ -410,6 +439,88 @@ def _worker_func(
     return costs
 
 
+# The sessions each worker process keeps open, by the tracker and key they were requested from.
+_SESSION_POOL: Dict[Tuple[str, int, str], RPCSession] = {}
+
+
+def _run_on_pooled_session(
+    f_create_session: T_CREATE_SESSION,
+    f_upload_module: T_UPLOAD_MODULE,
+    f_alloc_argument: T_ALLOC_ARGUMENT,
+    f_run_evaluator: T_RUN_EVALUATOR,
+    f_cleanup: T_CLEANUP,
+    rpc_config: RPCConfig,
+    evaluator_config: EvaluatorConfig,
+    alloc_repeat: int,
+    artifact_path: str,
+    device_type: str,
+    args_info: T_ARG_INFO_JSON_OBJ_LIST,
+) -> List[float]:
+    """Measure the way `_worker_func` does, but on the session the worker kept from its previous
+    measurement, and keep the session for the next one."""
+    pool_key = (rpc_config.tracker_host, rpc_config.tracker_port, rpc_config.tracker_key)
+    session: Optional[RPCSession] = _SESSION_POOL.pop(pool_key, None)
+    if session is not None:
+        try:
+            cached_module = session.get_function("tvm.rpc.server.cached_module")
+        except TVMError:
+            # the server dropped the session
+            session = None
+    if session is None:
+        with Profiler.timeit("RPCRunner/create_session"):
+            if f_create_session is default_create_session:
+                session = _create_long_lived_session(rpc_config)
+            else:
+                session = f_create_session(rpc_config)
+            cached_module = session.get_function("tvm.rpc.server.cached_module")
+    _, remote_path = osp.split(artifact_path)
+    try:
+        device = session.device(device_type, 0)
+        with Profiler.timeit("RPCRunner/upload_module"):
+            with open(artifact_path, "rb") as file:
+                artifact_hash = hashlib.sha256(file.read()).hexdigest()
+            rt_mod: Optional[Module] = cached_module(artifact_hash)
+            if rt_mod is None:
+                rt_mod = f_upload_module(session, artifact_path, remote_path)
+                session.get_function("tvm.rpc.server.cache_module")(artifact_hash, rt_mod)
+                # the module is loaded, and the work directory is kept for the next uploads
+                session.remove(remote_path)
+                session.remove(remote_path + ".so")
+        with Profiler.timeit("RPCRunner/alloc_argument"):
+            repeated_args: List[T_ARGUMENT_LIST] = f_alloc_argument(
+                session,
+                device,
+                args_info,
+                alloc_repeat,
+            )
+        with Profiler.timeit("RPCRunner/run_evaluator"):
+            costs: List[float] = f_run_evaluator(
+                session,
+                rt_mod,
+                device,
+                evaluator_config,
+                repeated_args,
+            )
+    except BaseException:
+        # the session may be broken, so it is cleaned up and dropped
+        with Profiler.timeit("RPCRunner/cleanup"):
+            f_cleanup(session, remote_path)
+        raise
+    _SESSION_POOL[pool_key] = session
+    return costs
+
+
+def _create_long_lived_session(rpc_config: RPCConfig) -> RPCSession:
+    """Request a session that the server keeps until the worker closes it: the session timeout
+    bounds a measurement rather than the lifetime of a kept session."""
+    tracker = rpc_config.connect_tracker()
+    return tracker.request(
+        key=rpc_config.tracker_key,
+        priority=rpc_config.session_priority,
+        session_timeout=0,
+    )
+
+
 def default_create_session(rpc_config: RPCConfig) -> RPCSession:
     """Default function to create the session
 
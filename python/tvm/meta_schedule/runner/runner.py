@@ -167,7 +167,7 @@ class PyRunnerFuture:
 class Runner(Object):
     """The abstract runner interface"""
 
-    RunnerType = Union["Runner", Literal["local", "rpc"]]
+    RunnerType = Union["Runner", Literal["local", "rpc", "interleaved"]]
 
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
         """Run the built artifact and get runner futures.
@@ -186,12 +186,15 @@ class Runner(Object):
 
     @staticmethod
     def create(  # pylint: disable=keyword-arg-before-vararg
-        kind: Literal["local", "rpc"] = "local",
+        kind: Literal["local", "rpc", "interleaved"] = "local",
         *args,
         **kwargs,
     ) -> "Runner":
         """Create a Runner."""
-        from . import LocalRunner, RPCRunner  # pylint: disable=import-outside-toplevel
+        # pylint: disable=import-outside-toplevel
+        from . import InterleavedRunner, LocalRunner, RPCRunner
+
+        # pylint: enable=import-outside-toplevel
 
         if kind == "local":
             if "max_workers" in kwargs:
@@ -199,6 +202,8 @@ class Runner(Object):
             return LocalRunner(*args, **kwargs)  # type: ignore
         elif kind == "rpc":
             return RPCRunner(*args, **kwargs)  # type: ignore
+        elif kind == "interleaved":
+            return InterleavedRunner(*args, **kwargs)  # type: ignore
         raise ValueError(f"Unknown Runner: {kind}")
 
 
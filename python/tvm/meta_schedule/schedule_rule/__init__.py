@@ -22,7 +22,8 @@ blocks in a schedule. See also PostOrderApply.
 from .add_rfactor import AddRFactor
 from .apply_custom_rule import ApplyCustomRule
 from .auto_bind import AutoBind
-from .auto_inline import AutoInline, InlineConstantScalars
+from .cache_read_texture import CacheReadTexture
+from .auto_inline import AutoInline, InlineConstantScalars, InlineDequantize
 from .cross_thread_reduction import CrossThreadReduction
 from .multi_level_tiling import (
     MultiLevelTiling,
@@ -33,4 +34,7 @@ from .multi_level_tiling import (
 )
 from .parallel_vectorize_unroll import ParallelizeVectorizeUnroll
 from .random_compute_location import RandomComputeLocation
+from .rolling_buffer import RollingBuffer
 from .schedule_rule import PyScheduleRule, ScheduleRule
+from .software_prefetch import SoftwarePrefetch
+from .split_k import SplitK
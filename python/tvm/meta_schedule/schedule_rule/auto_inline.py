@@ -82,3 +82,22 @@ class InlineConstantScalars(ScheduleRule):
         self.__init_handle_by_constructor__(
             _ffi_api.ScheduleRuleInlineConstantScalars,  # type: ignore # pylint: disable=no-member
         )
+
+
+@register_object("meta_schedule.InlineDequantize")
+class InlineDequantize(ScheduleRule):
+    """Inline the blocks that decode quantized weights into the reductions that consume them.
+
+    A spatial block that reads an integer buffer, e.g. packed INT4/INT8 weights unpacked with
+    shifts and masks or through `take`, is inlined when all of its consumers are reductions
+    that multi-level tiling applies to, such as GEMMs. The consumer then caches the packed
+    weights instead of the decoded ones, and decodes them in registers. It should run before
+    MultiLevelTiling.
+    """
+
+    def __init__(
+        self,
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleInlineDequantize,  # type: ignore # pylint: disable=no-member
+        )
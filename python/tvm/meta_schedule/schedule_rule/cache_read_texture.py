@@ -0,0 +1,36 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A rule that stages the read-only inputs of reductions into textures"""
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.CacheReadTexture")
+class CacheReadTexture(ScheduleRule):
+    """Stage the read-only parameters of a reduction block, e.g. the input and the weight of a
+    convolution, into 2d textures, so that they are read through the texture cache of GPUs such as
+    Adreno. The texture scope is chosen by the `texture_spatial_limit` and `texture_depth_limit`
+    of the target, and the rule does nothing on targets without them. The unchanged schedule is
+    kept next to the texture variant in the design space.
+    """
+
+    def __init__(self) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleCacheReadTexture,  # type: ignore # pylint: disable=no-member
+        )
@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Rules which apply cross-thread reduction to some reduction blocks correspondingly when needed"""
-from typing import List
+from typing import List, Optional
 
 from tvm_ffi import register_object
 
@@ -32,10 +32,17 @@ class CrossThreadReduction(ScheduleRule):
     ----------
     thread_extents: List[int]
         Candidates of thread axis extent (values are required to be positive).
+    grid_reduction_min_extent: Optional[int]
+        The minimum extent of the reduction for which a two-pass grid reduction is added as a
+        candidate: chunks of the reduction are reduced by different thread blocks into an rfactor
+        buffer, which is then reduced by a second kernel. None disables it.
     """
 
-    def __init__(self, thread_extents: List[int]) -> None:
+    def __init__(
+        self, thread_extents: List[int], grid_reduction_min_extent: Optional[int] = None
+    ) -> None:
         self.__init_handle_by_constructor__(
             _ffi_api.ScheduleRuleCrossThreadReduction,  # type: ignore # pylint: disable=no-member
             thread_extents,
+            grid_reduction_min_extent,
         )
@@ -0,0 +1,42 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""A rule that fuses a stage into the sliding window of its consumer with a rolling buffer"""
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.RollingBuffer")
+class RollingBuffer(ScheduleRule):
+    """Fuse a stage into the sliding window of its consumer, e.g. a convolution followed by a
+    pooling, by computing it at the consumer's outermost loop it can roll along and converting its
+    output into a rolling buffer, which only holds the rows of a window. The intermediate feature
+    map then stays in the cache instead of going through the DRAM. The rule keeps the unchanged
+    schedule next to the fused one, and marks the fused loop nest as not parallelizable.
+
+    Parameters
+    ----------
+    max_buffer_bytes : int
+        The largest rolling buffer in bytes, e.g. the size of the L2 cache, -1 for no limit.
+    """
+
+    def __init__(self, max_buffer_bytes: int = 1048576) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleRollingBuffer,  # type: ignore # pylint: disable=no-member
+            max_buffer_bytes,
+        )
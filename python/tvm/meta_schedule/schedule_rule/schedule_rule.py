@@ -82,12 +82,14 @@ class ScheduleRule(Object):
         return _ffi_api.ScheduleRuleClone(self)  # type: ignore # pylint: disable=no-member
 
     @staticmethod
-    def create(kind: Literal["llvm", "cuda", "cuda-tensorcore", "hexagon"]) -> List["ScheduleRule"]:
+    def create(
+        kind: Literal["llvm", "cuda", "cuda-tensorcore", "hexagon", "adreno"],
+    ) -> List["ScheduleRule"]:
         """Create a list of schedule rules for the given kind.
 
         Parameters
         ----------
-        kind : Literal["llvm", "cuda", "cuda-tensorcore", "hexagon"]
+        kind : Literal["llvm", "cuda", "cuda-tensorcore", "hexagon", "adreno"]
             The kind of the schedule rules.
 
         Returns
@@ -101,6 +103,7 @@ class ScheduleRule(Object):
             "cuda": _ffi_api.ScheduleRuleDefaultCUDA,  # type: ignore
             "cuda-tensorcore": _ffi_api.ScheduleRuleDefaultCUDATensorCore,  # type: ignore
             "hexagon": _ffi_api.ScheduleRuleDefaultHexagon,  # type: ignore
+            "adreno": _ffi_api.ScheduleRuleDefaultAdreno,  # type: ignore
             # pylint: enable=no-member
         }
         for k, v in funcs.items():
@@ -0,0 +1,54 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Rule that prefetches the tiles of the next iterations of a loop on CPU"""
+from typing import List, Optional
+
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.SoftwarePrefetch")
+class SoftwarePrefetch(ScheduleRule):
+    """Rule that prefetches the tiles of the next iterations of a loop around a block on CPU.
+
+    The rule forks the design space on the loop to pipeline, and samples the prefetch distance.
+    The distance is annotated on the loop as `software_prefetch_distance`, and lowered to
+    `llvm.prefetch` by the InjectSoftwarePrefetch pass. The rule only applies to LLVM targets.
+
+    Parameters
+    ----------
+    prefetch_distances: Optional[List[int]]
+        The candidates of the number of iterations to prefetch ahead.
+    max_pipeline_depth: int
+        The number of loops outside of the innermost one to consider. The d-th of them is the
+        pipelined loop of depth d.
+    """
+
+    def __init__(
+        self,
+        prefetch_distances: Optional[List[int]] = None,
+        max_pipeline_depth: int = 2,
+    ) -> None:
+        if prefetch_distances is None:
+            prefetch_distances = [1, 2, 4]
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleSoftwarePrefetch,  # type: ignore # pylint: disable=no-member
+            prefetch_distances,
+            max_pipeline_depth,
+        )
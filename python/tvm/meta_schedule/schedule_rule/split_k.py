@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Rule that splits the reduction of skinny GEMMs across thread blocks on GPU"""
+from typing import List, Optional
+
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from .multi_level_tiling import MultiLevelTiling, ReuseType
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.SplitK")
+class SplitK(ScheduleRule):
+    """Rule that splits the reduction of a block with a small output and a long reduction on GPU.
+
+    The reduction is split into partitions with rfactor. Each partition writes its partial sums
+    to a workspace, and the original block becomes the epilogue that adds them up. The partial
+    sums are tiled by `tiling`, with the partitions as one more spatial axis, so that they are
+    spread over the thread blocks. The rule forks the design space with the split variant next
+    to the unchanged one, which the following rules schedule as usual.
+
+    Parameters
+    ----------
+    split_factors: Optional[List[int]]
+        The candidates of the number of partitions of the reduction.
+    min_reduction_extent: int
+        The smallest reduction extent to split.
+    max_spatial_extent: int
+        The largest number of output elements of a block to split.
+    tiling: Optional[ScheduleRule]
+        The rule that tiles the partial sums. Defaults to the multi-level tiling of the default
+        CUDA rules.
+    """
+
+    def __init__(
+        self,
+        split_factors: Optional[List[int]] = None,
+        min_reduction_extent: int = 1024,
+        max_spatial_extent: int = 16384,
+        tiling: Optional[ScheduleRule] = None,
+    ) -> None:
+        if split_factors is None:
+            split_factors = [2, 4, 8, 16]
+        if tiling is None:
+            tiling = MultiLevelTiling(
+                structure="SSSRRSRS",
+                tile_binds=["blockIdx.x", "vthread.x", "threadIdx.x"],
+                max_innermost_factor=64,
+                vector_load_lens=[1, 2, 3, 4, 8, 16],
+                reuse_read=ReuseType(req="must", levels=[4], scope="shared"),
+                reuse_write=ReuseType(req="must", levels=[3], scope="local"),
+            )
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleSplitK,  # type: ignore # pylint: disable=no-member
+            split_factors,
+            min_reduction_extent,
+            max_spatial_extent,
+            tiling,
+        )
@@ -45,6 +45,12 @@ class EvolutionarySearch(SearchStrategy):
         The maximum number to retry mutation.
     eps_greedy : float
         The ratio of greedy selected samples in the final picks.
+    genetic_pipeline_prediction : bool
+        Whether to predict the scores of the mutated candidates chunk by chunk while the rest
+        of the generation is still being mutated.
+    genetic_early_stop_patience : int
+        The number of generations without improvement of the best predicted scores before the
+        evolution stops early. Zero disables the early stop.
     """
 
     population_size: int
@@ -54,6 +60,8 @@ class EvolutionarySearch(SearchStrategy):
     genetic_mutate_prob: float
     genetic_max_fail_count: int
     eps_greedy: float
+    genetic_pipeline_prediction: bool
+    genetic_early_stop_patience: int
 
     def __init__(
         self,
@@ -66,6 +74,8 @@ class EvolutionarySearch(SearchStrategy):
         genetic_mutate_prob: float = 0.85,
         genetic_max_fail_count: int = 10,
         eps_greedy: float = 0.05,
+        genetic_pipeline_prediction: bool = False,
+        genetic_early_stop_patience: int = 0,
     ) -> None:
         """Constructor"""
         self.__init_handle_by_constructor__(
@@ -78,4 +88,6 @@ class EvolutionarySearch(SearchStrategy):
             genetic_mutate_prob,
             genetic_max_fail_count,
             eps_greedy,
+            genetic_pipeline_prediction,
+            genetic_early_stop_patience,
         )
@@ -40,6 +40,10 @@ class PostOrderApply(SpaceGenerator):
         for them. The function should take in a block and return True if a schedule should
         be generated or False if that block should be skipped. If no function is provided
         all blocks will have schedules generated.
+    max_resamples : int
+        The number of times a schedule rule is re-applied to a block when the schedules it
+        produces exceed the thread, shared memory or register limits of a GPU target, which prunes
+        the invalid candidates before the postprocessors. Zero disables the checks.
     """
 
     def __init__(
@@ -48,6 +52,7 @@ class PostOrderApply(SpaceGenerator):
         sch_rules: ScheduleRuleType = "from-target",
         postprocs: PostprocType = "from-target",
         mutator_probs: MutatorProbType = "from-target",
+        max_resamples: int = 0,
     ):
         """Constructor"""
         sch_rules, postprocs, mutator_probs = _normalize_rules(sch_rules, postprocs, mutator_probs)
@@ -57,4 +62,5 @@ class PostOrderApply(SpaceGenerator):
             sch_rules,
             postprocs,
             mutator_probs,
+            max_resamples,
         )
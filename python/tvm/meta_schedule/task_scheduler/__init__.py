@@ -23,3 +23,4 @@ records to the database.
 from .gradient_based import GradientBased
 from .round_robin import RoundRobin
 from .task_scheduler import PyTaskScheduler, TaskScheduler, create
+from .ucb import UCB
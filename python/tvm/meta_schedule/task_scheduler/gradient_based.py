@@ -34,6 +34,7 @@ class GradientBased(TaskScheduler):
         alpha: float = 0.2,
         window_size: int = 3,
         seed: int = -1,
+        num_inflight_batches: int = 0,
     ) -> None:
         """Constructor.
 
@@ -45,6 +46,10 @@ class GradientBased(TaskScheduler):
             The parameter to control backward window size in gradient computation.
         seed : int = -1
             The random seed.
+        num_inflight_batches : int = 0
+            The maximum number of batches being built or measured at once across tasks. When
+            positive, batches are built in the background while the next batch is searched.
+            0 builds each batch before searching the next one.
         """
         self.__init_handle_by_constructor__(
             _ffi_api.TaskSchedulerGradientBased,  # type: ignore # pylint: disable=no-member
@@ -52,4 +57,5 @@ class GradientBased(TaskScheduler):
             alpha,
             window_size,
             seed,
+            num_inflight_batches,
         )
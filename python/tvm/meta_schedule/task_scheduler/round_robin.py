@@ -28,9 +28,18 @@ logger = get_logger(__name__)  # pylint: disable=invalid-name
 class RoundRobin(TaskScheduler):
     """Round Robin Task Scheduler"""
 
-    def __init__(self) -> None:
-        """Constructor."""
+    def __init__(self, *, num_inflight_batches: int = 0) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        num_inflight_batches : int = 0
+            The maximum number of batches being built or measured at once across tasks. When
+            positive, batches are built in the background while the next batch is searched.
+            0 builds each batch before searching the next one.
+        """
         self.__init_handle_by_constructor__(
             _ffi_api.TaskSchedulerRoundRobin,  # type: ignore # pylint: disable=no-member
             get_logging_func(logger),
+            num_inflight_batches,
         )
@@ -63,7 +63,7 @@ class TaskScheduler(Object):
     cost_model_: Optional[CostModel]
     remaining_tasks_: int
 
-    TaskSchedulerType = Union["TaskScheduler", Literal["gradient", "round-robin"]]
+    TaskSchedulerType = Union["TaskScheduler", Literal["gradient", "round-robin", "ucb"]]
 
     def next_task_id(self) -> int:
         """Fetch the next task id.
@@ -169,7 +169,7 @@ class TaskScheduler(Object):
 
     @staticmethod
     def create(  # pylint: disable=keyword-arg-before-vararg
-        kind: Literal["round-robin", "gradient"] = "gradient",
+        kind: Literal["round-robin", "gradient", "ucb"] = "gradient",
         *args,
         **kwargs,
     ) -> "TaskScheduler":
@@ -177,12 +177,15 @@ class TaskScheduler(Object):
         from . import (  # pylint: disable=import-outside-toplevel
             GradientBased,
             RoundRobin,
+            UCB,
         )
 
         if kind == "round-robin":
             return RoundRobin(*args, **kwargs)  # type: ignore
         if kind == "gradient":
             return GradientBased(*args, **kwargs)
+        if kind == "ucb":
+            return UCB(*args, **kwargs)
         raise ValueError(f"Unknown TaskScheduler name: {kind}")
 
 
@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Upper Confidence Bound Task Scheduler"""
+from tvm_ffi import register_object
+
+from .. import _ffi_api
+from ..logging import get_logger, get_logging_func
+from .task_scheduler import TaskScheduler
+
+logger = get_logger(__name__)  # pylint: disable=invalid-name
+
+
+@register_object("meta_schedule.UCB")
+class UCB(TaskScheduler):
+    """Upper Confidence Bound Task Scheduler
+
+    Each round of a task is rewarded by the reduction of the end-to-end latency it brings,
+    relative to the end-to-end latency. The task with the highest upper confidence bound of the
+    reward is tuned next, where the exploration bonus is scaled by the task's share of the
+    end-to-end latency. The tasks whose bound falls below `min_gain` are terminated early.
+    """
+
+    def __init__(
+        self,
+        *,
+        exploration: float = 1.0,
+        window_size: int = 3,
+        min_gain: float = 1e-3,
+        min_rounds: int = 3,
+        seed: int = -1,
+        num_inflight_batches: int = 0,
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        exploration : float = 1.0
+            The scale of the exploration bonus.
+        window_size : int = 3
+            The number of recent rounds averaged into the expected reward.
+        min_gain : float = 1e-3
+            The expected reduction of the end-to-end latency, as a fraction of it, below which a
+            task is terminated. 0 never terminates a task early.
+        min_rounds : int = 3
+            The number of rounds a task is tuned before it can be terminated.
+        seed : int = -1
+            The random seed.
+        num_inflight_batches : int = 0
+            The maximum number of batches being built or measured at once across tasks.
+        """
+        self.__init_handle_by_constructor__(
+            _ffi_api.TaskSchedulerUCB,  # type: ignore # pylint: disable=no-member
+            get_logging_func(logger),
+            exploration,
+            window_size,
+            min_gain,
+            min_rounds,
+            seed,
+            num_inflight_batches,
+        )
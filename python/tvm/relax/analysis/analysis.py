@@ -481,7 +481,11 @@ def remove_all_unused(func: Function) -> Function:
     return _ffi_api.remove_all_unused(func)  # type: ignore
 
 
-def well_formed(obj: Union[IRModule, Function], check_struct_info: bool = True) -> bool:
+def well_formed(
+    obj: Union[IRModule, Function],
+    check_struct_info: bool = True,
+    prev_mod: Optional[IRModule] = None,
+) -> bool:
     """Check if the IRModule is well formed.
 
     Parameters
@@ -493,6 +497,11 @@ def well_formed(obj: Union[IRModule, Function], check_struct_info: bool = True)
         A boolean flag indicating if the property "every Expr must
         have defined structure info" will be checked.
 
+    prev_mod : Optional[tvm.IRModule]
+        A well-formed IRModule, such as the input of the pass that
+        produced `obj`.  When given, only the functions of `obj` that
+        are not the same objects as in `prev_mod` are checked.
+
     Returns
     -------
     ret: bool
@@ -504,6 +513,8 @@ def well_formed(obj: Union[IRModule, Function], check_struct_info: bool = True)
     where `check_struct_info` might be false, so that other well-formed requirements
     will be well tested and will not be blocked by not having structure info.
     """
+    if prev_mod is not None:
+        return _ffi_api.well_formed_incremental(obj, prev_mod, check_struct_info)  # type: ignore
     return _ffi_api.well_formed(obj, check_struct_info)  # type: ignore
 
 
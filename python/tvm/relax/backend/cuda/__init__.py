@@ -22,3 +22,4 @@ from .pipeline import (
     legalize_passes,
     library_dispatch_passes,
 )
+from .sparse_matmul import DispatchSparseMatmul
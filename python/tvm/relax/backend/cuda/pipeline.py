@@ -66,6 +66,7 @@ def finalize_passes(target: tvm.target.Target):  # pylint: disable=unused-argume
         relax.transform.LowerRuntimeBuiltin(),
         relax.transform.ComputePrimValue(),
         relax.transform.VMShapeLower(),
+        relax.transform.DeduplicatePrimFuncs(),
         relax.transform.AttachGlobalSymbol(),
     ]
 
@@ -0,0 +1,261 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument
+"""Dispatch the matmuls with 2:4 sparse weights to sparse tensor core kernels."""
+from typing import Iterable, Optional
+
+import numpy as np
+
+from tvm import relax, te, tir
+from tvm.contrib.nvcc import get_target_compute_version, parse_compute_version
+from tvm.ir import Op
+from tvm.ir.module import IRModule
+from tvm.ir.transform import PassContext, module_pass
+from tvm.relax import expr_functor
+from tvm.script import tir as T
+
+from ..utils import BackendDispatcher
+
+
+def is_2in4_sparse(weight: np.ndarray) -> bool:
+    """Whether each group of 4 consecutive elements of the rows has at most 2 non-zeros."""
+    if weight.ndim != 2 or weight.shape[1] % 4 != 0:
+        return False
+    groups = weight.reshape(weight.shape[0], -1, 4)
+    return bool(((groups != 0).sum(axis=-1) <= 2).all())
+
+
+def compress_2in4(weight: te.Tensor):
+    """Compress a 2:4 sparse weight into the operands of the sparse mma.
+
+    Parameters
+    ----------
+    weight : te.Tensor
+        The (out_features, in_features) weight, with at most 2 non-zeros in each group of 4
+        consecutive elements of a row. The extra non-zeros are dropped.
+
+    Returns
+    -------
+    values : te.Tensor
+        The (out_features, in_features / 2) kept elements. A group with fewer than 2 non-zeros
+        keeps zeros, so that each group keeps two distinct positions in increasing order.
+    metadata : te.Tensor
+        The (out_features / 2, in_features / 16) uint32 positions of the kept elements, 2 bits
+        each. Word (tile * 8 + i, kt) holds the 8 positions of row tile * 16 + i in the 16
+        elements of k-tile kt in its low half, and those of row tile * 16 + i + 8 in its high
+        half, which is the layout the m16n8k16 sparse mma reads.
+    """
+    n_out, k_in = weight.shape
+    zero = tir.const(0, weight.dtype)
+    p0, p1, p2, p3 = [tir.const(i, "int32") for i in range(4)]
+
+    def nonzero(n, g, j):
+        return weight[n, g * 4 + j] != zero
+
+    def first(n, g):
+        return tir.Select(nonzero(n, g, 0), p0, tir.Select(nonzero(n, g, 1), p1, p2))
+
+    def second(n, g):
+        i0 = first(n, g)
+        return tir.Select(
+            tir.all(i0 < 1, nonzero(n, g, 1)),
+            p1,
+            tir.Select(
+                tir.all(i0 < 2, nonzero(n, g, 2)), p2, tir.Select(nonzero(n, g, 3), p3, i0 + 1)
+            ),
+        )
+
+    def position(n, g, s):
+        return tir.Select(s == 0, first(n, g), second(n, g))
+
+    values = te.compute(
+        (n_out, k_in // 2),
+        lambda n, c: weight[n, c // 2 * 4 + position(n, c // 2, c % 2)],
+        name="sparse_values",
+    )
+    r = te.reduce_axis((0, 16), name="r")
+
+    def fmetadata(row, kt):
+        n = row // 8 * 16 + r // 8 * 8 + row % 8
+        j = r % 8
+        pos = position(n, kt * 4 + j // 2, j % 2).astype("uint32")
+        return te.sum(pos << (r * 2).astype("uint32"), axis=r)
+
+    metadata = te.compute((n_out // 2, k_in // 16), fmetadata, name="sparse_metadata")
+    return values, metadata
+
+
+def sparse_matmul_func(n_out: int, k_in: int, out_dtype: str) -> tir.PrimFunc:
+    """The kernel of y = x @ w.T with a 2:4 sparse w compressed by compress_2in4.
+
+    Each warp computes 16 output features of 8 rows of x with the m16n8k16 sparse mma, the
+    compressed weight as the sparse operand, and 4 warps of a block share the rows of x.
+    """
+    num_n_tiles = n_out // 16
+    num_k_tiles = k_in // 16
+
+    # fmt: off
+    @T.prim_func(private=True)
+    def sparse_matmul(x: T.handle, values: T.handle, metadata: T.handle, y: T.handle):
+        T.func_attr({"tir.is_scheduled": True, "tir.noalias": True})
+        m = T.int64()
+        X = T.match_buffer(x, (m, k_in), "float16")
+        V = T.match_buffer(values, (n_out, k_in // 2), "float16")
+        E = T.match_buffer(metadata, (n_out // 2, num_k_tiles), "uint32")
+        Y = T.match_buffer(y, (m, n_out), out_dtype)
+        bx = T.env_thread("blockIdx.x")
+        by = T.env_thread("blockIdx.y")
+        ty = T.env_thread("threadIdx.y")
+        tx = T.env_thread("threadIdx.x")
+        T.launch_thread(bx, (num_n_tiles + 3) // 4)
+        T.launch_thread(by, T.Cast("int32", (m + 7) // 8))
+        T.launch_thread(ty, 4)
+        T.launch_thread(tx, 32)
+        multi_a = T.decl_buffer([4], "float16", scope="local")
+        multi_b = T.decl_buffer([4], "float16", scope="local")
+        accum = T.decl_buffer([4], "float32", scope="local")
+        meta_local = T.decl_buffer([1], "uint32", scope="local")
+        if bx * 4 + ty < num_n_tiles:
+            for i in range(4):
+                accum[i] = T.float32(0)
+            for kt in range(num_k_tiles):
+                for i in range(4):
+                    multi_a[i] = V[(bx * 4 + ty) * 16 + tx // 4 + i // 2 * 8,
+                                   kt * 8 + tx % 4 * 2 + i % 2]
+                for i in range(4):
+                    multi_b[i] = T.if_then_else(
+                        T.Cast("int64", by * 8 + tx // 4) < m,
+                        X[by * 8 + tx // 4, kt * 16 + tx % 4 * 2 + i % 2 + i // 2 * 8],
+                        T.float16(0),
+                    )
+                meta_local[0] = E[(bx * 4 + ty) * 8 + tx // 4, kt]
+                T.evaluate(T.ptx_mma_sp("m16n8k16", "row", "col", "fp16", "fp16", "fp32",
+                                        multi_a.data, 0, multi_b.data, 0, accum.data, 0,
+                                        meta_local.data, 0, 0, False, dtype="float32"))
+            for i in range(4):
+                if T.Cast("int64", by * 8 + tx % 4 * 2 + i % 2) < m:
+                    Y[by * 8 + tx % 4 * 2 + i % 2,
+                      (bx * 4 + ty) * 16 + i // 2 * 8 + tx // 4] = T.Cast(out_dtype, accum[i])
+    # fmt: on
+
+    return sparse_matmul
+
+
+@expr_functor.mutator
+class SparseMatmulDispatcher(BackendDispatcher):
+    """Dispatcher of the matmuls with 2:4 sparse weights."""
+
+    def __init__(self, mod, weights: Optional[Iterable[str]]):
+        super().__init__(mod)
+        self.weights = set(weights or [])
+
+    def _is_sparse_weight(self, weight: relax.Expr) -> bool:
+        if isinstance(weight, relax.Constant):
+            return is_2in4_sparse(weight.data.numpy())
+        return isinstance(weight, relax.Var) and weight.name_hint in self.weights
+
+    def _supports_sparse_mma(self, call: relax.Call) -> bool:
+        tgt = self._get_target(call.struct_info)
+        if tgt.kind.name != "cuda":
+            return False
+        major, _ = parse_compute_version(get_target_compute_version(tgt))
+        return major >= 8
+
+    def visit_call_(self, call: relax.Call) -> relax.Expr:
+        call = super().visit_call_(call)
+        if not isinstance(call.op, Op) or call.op.name != "relax.matmul":
+            return call
+        x, weight_t = call.args
+        if isinstance(weight_t, relax.Var):
+            weight_t = self.lookup_binding(weight_t)
+        # y = x @ w.T, as linear layers are expressed
+        if (
+            not isinstance(weight_t, relax.Call)
+            or not isinstance(weight_t.op, Op)
+            or weight_t.op.name != "relax.permute_dims"
+            or weight_t.args[0].struct_info.ndim != 2
+            or (weight_t.attrs.axes is not None and list(weight_t.attrs.axes) != [1, 0])
+        ):
+            return call
+        weight = weight_t.args[0]
+        x_shape, x_dtype = self.get_shape_dtype(x)
+        w_shape, w_dtype = self.get_shape_dtype(weight)
+        out_dtype = call.struct_info.dtype
+        if (
+            x_dtype != "float16"
+            or w_dtype != "float16"
+            or out_dtype not in ("float16", "float32")
+            or not isinstance(x_shape, relax.ShapeExpr)
+            or not isinstance(w_shape, relax.ShapeExpr)
+            or len(x_shape.values) < 2
+            or not all(isinstance(dim, tir.IntImm) for dim in w_shape.values)
+            or not isinstance(x_shape.values[-1], tir.IntImm)
+        ):
+            return call
+        n_out, k_in = int(w_shape.values[0]), int(w_shape.values[1])
+        if int(x_shape.values[-1]) != k_in or n_out % 16 != 0 or k_in % 16 != 0:
+            return call
+        if not self._is_sparse_weight(weight) or not self._supports_sparse_mma(call):
+            return call
+
+        # The compression only depends on the weight, so LiftTransformParams moves it to the
+        # transform of the parameters, whose outputs are the compressed weights to save.
+        compressed = self.builder_.call_te(
+            compress_2in4, weight, primfunc_name_hint="compress_2in4"
+        )
+        values = self.builder_.emit(relax.TupleGetItem(compressed, 0))
+        metadata = self.builder_.emit(relax.TupleGetItem(compressed, 1))
+        x_2d = self.builder_.emit(relax.op.reshape(x, (-1, k_in)))
+        gvar = self.builder_.add_func(
+            sparse_matmul_func(n_out, k_in, out_dtype), "sparse_matmul_2in4"
+        )
+        out = self.builder_.emit(
+            relax.call_tir(
+                gvar,
+                [x_2d, values, metadata],
+                relax.TensorStructInfo((x_2d.struct_info.shape[0], n_out), out_dtype),
+            )
+        )
+        return relax.op.reshape(out, list(x_shape.values[:-1]) + [n_out])
+
+
+@module_pass(opt_level=0, name="DispatchSparseMatmul")
+class DispatchSparseMatmul:  # pylint: disable=too-few-public-methods
+    """Dispatch y = x @ w.T with a 2:4 sparse float16 w to a sparse tensor core kernel.
+
+    A constant weight is checked to be 2:4 sparse along its rows, while a parameter is only
+    taken as such when it is named in `weights`, e.g. from the MSC pruner's `sparse_weights`.
+    The weight is compressed to half of its elements and their 2-bit positions, and the kernel
+    multiplies with the `mma.sp` instruction of sm_80 and later GPUs, which skips the pruned
+    elements.
+
+    Parameters
+    ----------
+    weights : Optional[Iterable[str]]
+        The names of the parameters of the functions that are 2:4 sparse weights.
+    """
+
+    def __init__(self, weights: Optional[Iterable[str]] = None):
+        self.weights = weights
+
+    def transform_module(self, mod: IRModule, ctx: PassContext) -> IRModule:
+        dispatcher = SparseMatmulDispatcher(mod, self.weights)
+        for gv, func in mod.functions_items():
+            if isinstance(func, relax.Function):
+                func = dispatcher.visit_expr(func)
+                dispatcher.builder_.update_func(gv, func)
+        return dispatcher.builder_.get()
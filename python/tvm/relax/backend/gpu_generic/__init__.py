@@ -23,4 +23,8 @@ from .pipeline import (
     legalize_passes,
     library_dispatch_passes,
 )
-from .sampling import generic_get_sample_index, gpu_multinomial_from_uniform
+from .sampling import (
+    generic_get_sample_index,
+    gpu_apply_bitmask_inplace,
+    gpu_multinomial_from_uniform,
+)
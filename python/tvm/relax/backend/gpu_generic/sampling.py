@@ -342,3 +342,54 @@ def generic_get_sample_index(
                         output_index[v_ax0, 0] = v_ax1
 
     return _get_sample_index
+
+
+def gpu_apply_bitmask_inplace(logits_dtype: str = "float32", tx_len: int = 1024) -> PrimFunc:
+    """Generate GPU kernel applying the packed token bitmasks of grammar-constrained decoding.
+
+    The kernel masks the logits in place, and has the signature of
+    'vm.builtin.apply_bitmask_inplace', its host counterpart:
+    logits (batch_size, vocab_size), seq_ids (num_seqs,) in int32 giving the rows to mask, and
+    bitmask (batch_size, ceildiv(vocab_size, 32)) in int32, where the bit (v % 32) of
+    bitmask[i, v // 32] tells whether the token v is allowed in the row i. The logits of the
+    tokens not allowed become the lowest value of the logits dtype.
+
+    Parameters
+    ----------
+    logits_dtype : str
+        The logits data type
+
+    tx_len : int
+        The length of `threadIdx.x`
+
+    Returns
+    -------
+    func : PrimFunc
+        The generated function
+    """
+
+    TX = T.int64(tx_len)  # threadIdx.x
+
+    @T.prim_func
+    def apply_bitmask_inplace(var_logits: T.handle, var_seq_ids: T.handle, var_bitmask: T.handle):
+        T.func_attr({"tir.is_scheduled": True, "tir.noalias": True})
+        batch_size, vocab_size, num_seqs = T.int64(), T.int64(), T.int64()
+        logits = T.match_buffer(var_logits, (batch_size, vocab_size), logits_dtype)
+        seq_ids = T.match_buffer(var_seq_ids, (num_seqs,), "int32")
+        bitmask = T.match_buffer(var_bitmask, (batch_size, (vocab_size + 31) // 32), "int32")
+
+        for bx in T.thread_binding(T.ceildiv(num_seqs * vocab_size, TX), thread="blockIdx.x"):
+            for tx in T.thread_binding(TX, thread="threadIdx.x"):
+                with T.block("apply_bitmask"):
+                    vs = T.axis.spatial(num_seqs, (bx * TX + tx) // vocab_size)
+                    vv = T.axis.spatial(vocab_size, (bx * TX + tx) % vocab_size)
+                    T.where(bx * TX + tx < num_seqs * vocab_size)
+                    T.reads(seq_ids[vs], bitmask[seq_ids[vs], vv // 32], logits[seq_ids[vs], vv])
+                    T.writes(logits[seq_ids[vs], vv])
+                    logits[seq_ids[vs], vv] = T.if_then_else(
+                        (bitmask[seq_ids[vs], vv // 32] >> T.Cast("int32", vv % 32)) & 1 == 1,
+                        logits[seq_ids[vs], vv],
+                        T.min_value(logits_dtype),
+                    )
+
+    return apply_bitmask_inplace
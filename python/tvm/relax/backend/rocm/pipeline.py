@@ -65,6 +65,7 @@ def finalize_passes(target: tvm.target.Target):  # pylint: disable=unused-argume
         relax.transform.LowerRuntimeBuiltin(),
         relax.transform.ComputePrimValue(),
         relax.transform.VMShapeLower(),
+        relax.transform.DeduplicatePrimFuncs(),
         relax.transform.AttachGlobalSymbol(),
     ]
 
@@ -18,7 +18,10 @@
 
 from .transform import (
     PropagateSharding,
+    AutoSharding,
+    PartitionPipelineStages,
     LowerGlobalViewToLocalView,
     LegalizeRedistribute,
     LowerDistIR,
+    LowerExpertParallel,
 )
@@ -18,6 +18,7 @@
 """Relax distributed-related transformation passes."""
 
 import tvm.ir
+from ..global_info import DeviceMesh
 from . import _ffi_api
 
 
@@ -32,6 +33,80 @@ def PropagateSharding() -> tvm.ir.transform.Pass:
     return _ffi_api.PropagateSharding()  # type: ignore
 
 
+def AutoSharding(
+    device_mesh: DeviceMesh,
+    memory_limit: int = 0,
+    device_flops: float = 1e14,
+    link_bandwidth: float = 1e11,
+) -> tvm.ir.transform.Pass:
+    """Choose the sharding of the functions by a cost model, and propagate it to DistIR.
+
+    Each function exposed with a global symbol that has no sharding annotation is planned. The
+    pass searches the axis group sharded along each device mesh axis, e.g. the batch axes for
+    data parallelism, the hidden axes of the weights for tensor parallelism, or the sequence
+    axes for sequence parallelism, and picks the one of the lowest estimated time whose memory
+    per device fits the limit. The time estimates the FLOPs of each op over the shards of its
+    iteration space, plus a ring allreduce wherever the inputs of an op are sharded along a mesh
+    axis while its output is not. The parameters are annotated with the chosen sharding, which
+    :py:func:`PropagateSharding` then propagates, so the result is ready for
+    :py:func:`LowerDistIR`.
+
+    Parameters
+    ----------
+    device_mesh : DeviceMesh
+        The device mesh to shard the functions over.
+
+    memory_limit : int
+        The limit of the memory of a device in bytes, or 0 for no limit.
+
+    device_flops : float
+        The FLOPs per second of a device in the cost model.
+
+    link_bandwidth : float
+        The bytes per second of the links between the devices in the cost model.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.AutoSharding(  # type: ignore
+        device_mesh, memory_limit, device_flops, link_bandwidth
+    )
+
+
+def PartitionPipelineStages(func_name: str, num_stages: int) -> tvm.ir.transform.Pass:
+    """Partition a function into pipeline stages balanced by their estimated FLOPs and weights.
+
+    The bindings of the single dataflow block of the function are split into consecutive stages
+    minimizing the largest cost of a stage, where the cost of a binding is its share of the FLOPs
+    of the function plus its share of the bytes of the weights it uses first. Stage ``i`` is
+    added as ``{func_name}_stage{i}``, which takes the activations the previous stage passes on,
+    or the inputs of the function for the first stage, followed by the weights the stage uses. It
+    returns the tuple of the activations the later stages use, while the last stage returns the
+    result of the function. Each stage after the first also gets
+    ``{func_name}_stage{i}_recv_buffers``, allocating the buffers receiving its activations.
+
+    The stages are run over the micro-batches by ``runtime.disco.run_pipeline_stages``, with one
+    disco group per stage.
+
+    Parameters
+    ----------
+    func_name : str
+        The name of the function to partition. Its first ``num_input`` parameters are the inputs
+        of each micro-batch, and the others are the weights.
+
+    num_stages : int
+        The number of pipeline stages.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.PartitionPipelineStages(func_name, num_stages)  # type: ignore
+
+
 def LowerGlobalViewToLocalView() -> tvm.ir.transform.Pass:
     """Lower global view TIR to local view
 
@@ -65,3 +140,29 @@ def LowerDistIR() -> tvm.ir.transform.Pass:
         The registered pass
     """
     return _ffi_api.LowerDistIR()  # type: ignore
+
+
+def LowerExpertParallel(num_workers: int, num_experts: int) -> tvm.ir.transform.Pass:
+    """Lower the grouped GEMMs of mixture-of-experts layers to expert parallelism.
+
+    The pass works on the local view of each worker, and rewrites the calls to
+    "cutlass.group_gemm" whose weight holds num_experts / num_workers experts, worker r owning
+    the experts [r * E, (r + 1) * E). The rows of the input must be grouped by global expert
+    with the same capacity for every expert. An all-to-all sends the rows of each expert to its
+    owner, the local experts run on the rows received from every worker, and another all-to-all
+    returns the outputs in the original order.
+
+    Parameters
+    ----------
+    num_workers : int
+        The number of workers the experts are distributed over.
+
+    num_experts : int
+        The total number of experts.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.LowerExpertParallel(num_workers, num_experts)  # type: ignore
@@ -326,6 +326,7 @@ class FlashInferPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-me
         dtype: str,
         target: Target,
         name: str = "paged_kv_cache",
+        kv_dtype: Optional[str] = None,
     ) -> None:
         """Create a paged KV cache object with FlashInfer kernels.
 
@@ -370,8 +371,16 @@ class FlashInferPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-me
             The number of dimensions in the embedding that RoPE is applied to.
         enable_disaggregation : bool
             Whether to enable disaggregation in the KV cache.
+        kv_dtype : Optional[str]
+            The storage dtype of the KV cache pages. FlashInfer kernels only
+            support storing pages in `dtype` for now.
         """
         assert rope_mode != RopeMode.INLINE, "FlashInfer RoPE does not support inline mode."
+        if kv_dtype is not None and kv_dtype != dtype:
+            raise ValueError(
+                f"FlashInfer KV cache does not support KV dtype {kv_dtype} different from {dtype}. "
+                "Please use TIRPagedKVCache instead."
+            )
 
         attn_kind_single = attn_kind[0] if isinstance(attn_kind, List) else attn_kind
         if attn_kind_single == "mha_sliding":
@@ -514,6 +523,7 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
         dtype: str,
         target: Target,
         name: str = "paged_kv_cache",
+        kv_dtype: Optional[str] = None,
     ) -> None:
         """Create a paged KV cache object with TIR kernels.
 
@@ -560,7 +570,12 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
             Whether to enable disaggregation in the KV cache.
         target : Target
             The target to build the model to.
+        kv_dtype : Optional[str]
+            The storage dtype of the KV cache pages, e.g., "float8_e4m3fn".
+            K/V data are cast to it on append and cast back to `dtype` when
+            read by the attention kernels. Defaults to `dtype`.
         """
+        kv_dtype = kv_dtype or dtype
         attn_kind_single = attn_kind[0] if isinstance(attn_kind, List) else attn_kind
         if attn_kind_single == "mha_sliding":
             attn_kind_single = "mha"
@@ -595,8 +610,8 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
             rx.op.zeros((), dtype),
             # pylint: disable=line-too-long
             # fmt: off
-            bb.add_func(_kv_cache_transpose_append(num_key_value_heads, qk_head_dim, dtype), "kv_cache_transpose_append"),
-            bb.add_func(_kv_cache_transpose_append_mla(qk_head_dim, dtype), "kv_cache_transpose_append_mla"),
+            bb.add_func(_kv_cache_transpose_append(num_key_value_heads, qk_head_dim, dtype, kv_dtype=kv_dtype), "kv_cache_transpose_append"),
+            bb.add_func(_kv_cache_transpose_append_mla(qk_head_dim, dtype, kv_dtype=kv_dtype), "kv_cache_transpose_append_mla"),
             # fmt: on
             # pylint: enable=line-too-long
         ]
@@ -609,18 +624,18 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
             args.extend(
                 [
                     rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_ragged_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, v_head_dim, dtype, rope_scaling), "tir_attention_prefill_ragged_cpu")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling), "tir_attention_prefill_cpu")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling), "tir_attention_decode_cpu")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling), "tir_attention_prefill_cpu_sliding_window")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling), "tir_attention_decode_cpu_sliding_window")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling, kv_dtype=kv_dtype), "tir_attention_prefill_cpu")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling, kv_dtype=kv_dtype), "tir_attention_decode_cpu")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling, kv_dtype=kv_dtype), "tir_attention_prefill_cpu_sliding_window")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling, kv_dtype=kv_dtype), "tir_attention_decode_cpu_sliding_window")]),
                     rx.Tuple([rx.StringImm("tir"), bb.add_func(tree_attn_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, rope_scaling), "tir_attention_prefill_with_tree_mask_cpu")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(tree_attn_with_paged_kv_cache_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, rope_scaling), "tir_attention_prefill_with_tree_mask_with_paged_kv_cache_cpu")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(tree_attn_with_paged_kv_cache_cpu(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, rope_scaling, kv_dtype=kv_dtype), "tir_attention_prefill_with_tree_mask_with_paged_kv_cache_cpu")]),
                     rx.Tuple([]),  # f_mla_prefill
                     rx.Tuple([bb.add_func(_merge_state_inplace_cpu(dtype), "tir_attention_merge_state_cpu")]),
                     bb.add_func(llama_rope_with_position_map(rope_theta, rope_scale, qk_head_dim, num_attention_heads, num_key_value_heads, dtype, rope_scaling, rotary_dim), "tir_split_rotary"),
-                    bb.add_func(_copy_single_page_cpu(num_key_value_heads, page_size, qk_head_dim, dtype), "kv_cache_copy_single_page_cpu"),
-                    bb.add_func(_kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, qk_head_dim, dtype), "kv_cache_debug_get_kv"),
-                    bb.add_func(_compact_kv_copy_cpu(num_key_value_heads, qk_head_dim, dtype), "kv_cache_compact_kv_copy_cpu"),
+                    bb.add_func(_copy_single_page_cpu(num_key_value_heads, page_size, qk_head_dim, dtype, kv_dtype=kv_dtype), "kv_cache_copy_single_page_cpu"),
+                    bb.add_func(_kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, qk_head_dim, dtype, kv_dtype=kv_dtype), "kv_cache_debug_get_kv"),
+                    bb.add_func(_compact_kv_copy_cpu(num_key_value_heads, qk_head_dim, dtype, kv_dtype=kv_dtype), "kv_cache_compact_kv_copy_cpu"),
                 ]
             )
             # fmt: on
@@ -633,17 +648,17 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
             args.append(rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_ragged(num_key_value_heads if attn_kind_single == "mha" else num_attention_heads, num_attention_heads, ragged_qk_head_dim, ragged_v_head_dim, dtype, rope_scaling, target), "tir_attention_prefill_ragged")]))
             mha_functions = (
                 [
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling, target), "tir_attention_prefill")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling, target), "tir_attention_decode")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling, target), "tir_attention_prefill_sliding_window")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling, target), "tir_attention_decode_sliding_window")]),
-                    rx.Tuple([rx.StringImm("tir"), bb.add_func(tree_attn_with_paged_kv_cache(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, rope_scaling, target), "tir_attention_prefill_with_tree_mask_with_paged_kv_cache")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling, target, kv_dtype=kv_dtype), "tir_attention_prefill")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, False, rope_scaling, target, kv_dtype=kv_dtype), "tir_attention_decode")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling, target, kv_dtype=kv_dtype), "tir_attention_prefill_sliding_window")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, True, rope_scaling, target, kv_dtype=kv_dtype), "tir_attention_decode_sliding_window")]),
+                    rx.Tuple([rx.StringImm("tir"), bb.add_func(tree_attn_with_paged_kv_cache(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, rope_scaling, target, kv_dtype=kv_dtype), "tir_attention_prefill_with_tree_mask_with_paged_kv_cache")]),
                     rx.Tuple([rx.StringImm("tir"), bb.add_func(tree_attn(num_key_value_heads, num_attention_heads, qk_head_dim, dtype, rope_scaling, target), "tir_attention_prefill_with_tree_mask")]),
                 ]
                 if attn_kind_single == "mha"
                 else [rx.Tuple([]) for _ in range(6)]
             )
-            mla_function = rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_mla(num_attention_heads, v_head_dim, qk_head_dim - v_head_dim, dtype, False, target), "tir_attention_prefill_mla")] if attn_kind_single == "mla" else [])
+            mla_function = rx.Tuple([rx.StringImm("tir"), bb.add_func(_attention_prefill_mla(num_attention_heads, v_head_dim, qk_head_dim - v_head_dim, dtype, False, target, kv_dtype=kv_dtype), "tir_attention_prefill_mla")] if attn_kind_single == "mla" else [])
             attn_merge_functions = [
                 bb.add_func(_merge_state_inplace(num_attention_heads, v_head_dim, dtype, target, "tir_attention_merge_state"), "tir_attention_merge_state"),
             ]
@@ -655,13 +670,15 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
                 [
                     rx.Tuple(attn_merge_functions),
                     bb.add_func(llama_rope_with_position_map(rope_theta, rope_scale, qk_head_dim, num_attention_heads, num_key_value_heads, dtype, rope_scaling, rotary_dim), "tir_split_rotary"),
-                    bb.add_func(_copy_single_page(num_key_value_heads, page_size, qk_head_dim, dtype, target) if attn_kind_single == "mha" else _copy_single_page_mla(page_size, qk_head_dim, dtype, target), "kv_cache_copy_single_page"),
-                    bb.add_func(_kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, qk_head_dim, dtype), "kv_cache_debug_get_kv"),
-                    bb.add_func(_compact_kv_copy(num_key_value_heads, qk_head_dim, dtype, target), "kv_cache_compact_kv_copy"),
+                    bb.add_func(_copy_single_page(num_key_value_heads, page_size, qk_head_dim, dtype, target, kv_dtype=kv_dtype) if attn_kind_single == "mha" else _copy_single_page_mla(page_size, qk_head_dim, dtype, target, kv_dtype=kv_dtype), "kv_cache_copy_single_page"),
+                    bb.add_func(_kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, qk_head_dim, dtype, kv_dtype=kv_dtype), "kv_cache_debug_get_kv"),
+                    bb.add_func(_compact_kv_copy(num_key_value_heads, qk_head_dim, dtype, target, kv_dtype=kv_dtype), "kv_cache_compact_kv_copy"),
                 ]
             )
             # fmt: on
             # pylint: enable=line-too-long
+        if kv_dtype != dtype:
+            args.append(rx.op.zeros((), kv_dtype))
 
         super().__init__(
             _expr=rx.call_pure_packed(
@@ -677,9 +694,12 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
 # pylint: disable=too-many-locals
 
 
-def _kv_cache_transpose_append(num_key_value_heads, head_dim, dtype, page_size: int = 16):
+def _kv_cache_transpose_append(
+    num_key_value_heads, head_dim, dtype, page_size: int = 16, kv_dtype: Optional[str] = None
+):
     """Return the TIR function that appends new k/v data to PagedKVCache."""
 
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long
     # fmt: off
     @T.prim_func
@@ -694,7 +714,7 @@ def _kv_cache_transpose_append(num_key_value_heads, head_dim, dtype, page_size:
         num_pages = T.int64()
         pages_elem_offset = T.int64()
         position_map_elem_offset = T.int32()
-        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, page_size, head_dim), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, page_size, head_dim), kv_dtype, elem_offset=pages_elem_offset)
         k_data = T.match_buffer(var_k_data, (ntoken, num_key_value_heads, head_dim), dtype)
         v_data = T.match_buffer(var_v_data, (ntoken, num_key_value_heads, head_dim), dtype)
         position_map = T.match_buffer(
@@ -707,22 +727,25 @@ def _kv_cache_transpose_append(num_key_value_heads, head_dim, dtype, page_size:
                     T.reads(position_map[vgpos], k_data[vgpos, vh, vf])
                     T.writes(pages[position_map[vgpos] // page_size, 0, vh, position_map[vgpos] % page_size, vf])
                     position: T.int32 = position_map[vgpos]  # type: ignore
-                    pages[T.floordiv(position, page_size), 0, vh, T.floormod(position, page_size), vf] = k_data[vgpos, vh, vf]
+                    pages[T.floordiv(position, page_size), 0, vh, T.floormod(position, page_size), vf] = k_data[vgpos, vh, vf].astype(kv_dtype)
                 with T.block("v_transpose_append"):
                     vgpos, vh, vf = T.axis.remap("SSS", [global_pos, h, f])
                     T.reads(position_map[vgpos], v_data[vgpos, vh, vf])
                     T.writes(pages[position_map[vgpos] // page_size, 1, vh, position_map[vgpos] % page_size, vf])
                     position: T.int32 = position_map[vgpos] # type: ignore[name-defined,no-redef]
-                    pages[T.floordiv(position, page_size), 1, vh, T.floormod(position, page_size), vf] = v_data[vgpos, vh, vf]
+                    pages[T.floordiv(position, page_size), 1, vh, T.floormod(position, page_size), vf] = v_data[vgpos, vh, vf].astype(kv_dtype)
     # fmt: on
     # pylint: enable=line-too-long
 
     return tir_kv_cache_transpose_append
 
 
-def _kv_cache_transpose_append_mla(d_qk: int, dtype, page_size: int = 16):
+def _kv_cache_transpose_append_mla(
+    d_qk: int, dtype, page_size: int = 16, kv_dtype: Optional[str] = None
+):
     """Return the TIR function that appends new compressed KV data to PagedKVCache for MLA."""
 
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long
     # fmt: off
     @T.prim_func
@@ -736,7 +759,7 @@ def _kv_cache_transpose_append_mla(d_qk: int, dtype, page_size: int = 16):
         num_pages = T.int64()
         pages_elem_offset = T.int64()
         position_map_elem_offset = T.int32()
-        pages = T.match_buffer(var_pages, (num_pages, page_size, d_qk), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (num_pages, page_size, d_qk), kv_dtype, elem_offset=pages_elem_offset)
         kv_data = T.match_buffer(var_kv_data, (ntoken, d_qk), dtype)
         position_map = T.match_buffer(
             var_position_map, (ntoken,), "int32", elem_offset=position_map_elem_offset
@@ -748,16 +771,19 @@ def _kv_cache_transpose_append_mla(d_qk: int, dtype, page_size: int = 16):
                     T.reads(position_map[vgpos], kv_data[vgpos, vf])
                     T.writes(pages[position_map[vgpos] // page_size, position_map[vgpos] % page_size, vf])
                     position: T.int32 = position_map[vgpos]  # type: ignore
-                    pages[T.floordiv(position, page_size), T.floormod(position, page_size), vf] = kv_data[vgpos, vf]
+                    pages[T.floordiv(position, page_size), T.floormod(position, page_size), vf] = kv_data[vgpos, vf].astype(kv_dtype)
     # fmt: on
     # pylint: enable=line-too-long
 
     return tir_kv_cache_transpose_append_mla
 
 
-def _kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dtype):
+def _kv_cache_debug_get_kv(
+    num_hidden_layers, num_key_value_heads, head_dim, dtype, kv_dtype: Optional[str] = None
+):
     """Return the TIR function that fetches the k/v data on given positions and layer."""
 
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long
     # fmt: off
     @T.prim_func
@@ -774,7 +800,7 @@ def _kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dty
         num_pages = T.int64()
         pages_elem_offset = T.int64()
         position_map_elem_offset = T.int64()
-        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, page_size, head_dim), dtype,elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, page_size, head_dim), kv_dtype,elem_offset=pages_elem_offset)
         position_map = T.match_buffer(
             var_position_map, (seqlen,), "int32", elem_offset=position_map_elem_offset
         )
@@ -786,17 +812,18 @@ def _kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dty
                 T.reads(position_map[vp], pages[position_map[vp] // page_size, 0:2, vh, position_map[vp] % page_size, vd])
                 T.writes(k_data[layer_id, vp, vh, vd], v_data[layer_id, vp, vh, vd])
                 position: T.int32 = position_map[vp] # type: ignore[name-defined]
-                k_data[layer_id, vp, vh, vd] = pages[T.floordiv(position, page_size), 0, vh, T.floormod(position, page_size), vd]
-                v_data[layer_id, vp, vh, vd] = pages[T.floordiv(position, page_size), 1, vh, T.floormod(position, page_size), vd]
+                k_data[layer_id, vp, vh, vd] = pages[T.floordiv(position, page_size), 0, vh, T.floormod(position, page_size), vd].astype(dtype)
+                v_data[layer_id, vp, vh, vd] = pages[T.floordiv(position, page_size), 1, vh, T.floormod(position, page_size), vd].astype(dtype)
     # fmt: on
     # pylint: enable=line-too-long
 
     return tir_kv_cache_debug_get_kv
 
 
-def _kv_cache_debug_get_kv_mla(num_hidden_layers, d_qk, dtype):
+def _kv_cache_debug_get_kv_mla(num_hidden_layers, d_qk, dtype, kv_dtype: Optional[str] = None):
     """Return the TIR function that fetches the k/v data on given positions and layer."""
 
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long
     # fmt: off
     @T.prim_func
@@ -812,7 +839,7 @@ def _kv_cache_debug_get_kv_mla(num_hidden_layers, d_qk, dtype):
         num_pages = T.int64()
         pages_elem_offset = T.int64()
         position_map_elem_offset = T.int64()
-        pages = T.match_buffer(var_pages, (num_pages, page_size, d_qk), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (num_pages, page_size, d_qk), kv_dtype, elem_offset=pages_elem_offset)
         position_map = T.match_buffer(
             var_position_map, (seqlen,), "int32", elem_offset=position_map_elem_offset
         )
@@ -823,7 +850,7 @@ def _kv_cache_debug_get_kv_mla(num_hidden_layers, d_qk, dtype):
                 T.reads(position_map[vp], pages[position_map[vp] // page_size, position_map[vp] % page_size, vd])
                 T.writes(compressed_kv_with_k_pe_data[layer_id, vp, vd])
                 position: T.int32 = position_map[vp] # type: ignore[name-defined]
-                compressed_kv_with_k_pe_data[layer_id, vp, vd] = pages[T.floordiv(position, page_size), T.floormod(position, page_size), vd]
+                compressed_kv_with_k_pe_data[layer_id, vp, vd] = pages[T.floordiv(position, page_size), T.floormod(position, page_size), vd].astype(dtype)
     # fmt: on
     # pylint: enable=line-too-long
 
@@ -847,9 +874,9 @@ def _rope(
     cos = cos_freq * buffer[indices].astype("float32")
     sin = sin_freq * tir.if_then_else(
         d < rotary_dim // 2,
-        -buffer[indices[:-1] + (d + rotary_dim // 2,)],
-        buffer[indices[:-1] + (d - rotary_dim // 2,)],
-    ).astype("float32")
+        -buffer[indices[:-1] + (d + rotary_dim // 2,)].astype("float32"),
+        buffer[indices[:-1] + (d - rotary_dim // 2,)].astype("float32"),
+    )
     expr = (cos + sin).astype(qkv_dtype)
     for var, value in var_map.items():
         expr = tir.Let(var, value, expr)
@@ -900,13 +927,15 @@ def _get_seq_offset(pos, seq_id, length_info, sliding_window):
 
 
 def _attention_prefill_cpu(
-    h_kv, h_q, d, dtype, sliding_window: bool, rope_scaling: Dict[str, Any], page_size: int = 16
+    h_kv, h_q, d, dtype, sliding_window: bool, rope_scaling: Dict[str, Any], page_size: int = 16,
+    kv_dtype: Optional[str] = None
 ):
     global_symbol = "batch_prefill_paged_kv_cpu"
     if sliding_window:
         global_symbol += "_sliding_window"
 
     group_size = h_q // h_kv
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long,too-many-branches
     # fmt: off
     @T.prim_func
@@ -941,7 +970,7 @@ def _attention_prefill_cpu(
 
         q = T.match_buffer(var_q, (total_len, h_q, d), dtype)
         q_indptr = T.match_buffer(var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset)
-        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, page_size, d), dtype)
+        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, page_size, d), kv_dtype)
         page_indptr = T.match_buffer(var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_values = T.match_buffer(var_page_values, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
         k_rope_pos_offset = T.match_buffer(var_k_rope_pos_offset, (batch_size,), "int32", elem_offset=k_rope_pos_offset_elem_offset)
@@ -1012,9 +1041,9 @@ def _attention_prefill_cpu(
                                     K_local[d_idx] = T.if_then_else(
                                         rotary_mode == 1,
                                         _rope(pages, k_rope_pos_offset[b_idx] + row_idx, d, rope_theta, rope_scale, (page_no, 0, h_qo // group_size, page_offset, d_idx), dtype, rope_scaling),
-                                        pages[page_no, 0, h_qo // group_size, page_offset, d_idx]
+                                        pages[page_no, 0, h_qo // group_size, page_offset, d_idx].astype(dtype)
                                     )
-                                    V_local[d_idx] = pages[page_no, 1, h_qo // group_size, page_offset, d_idx]
+                                    V_local[d_idx] = pages[page_no, 1, h_qo // group_size, page_offset, d_idx].astype(dtype)
 
                                 # Compute S
                                 # Q[i] * K[i] * sm_scale
@@ -1207,6 +1236,7 @@ def _attention_prefill(
     rope_scaling: Dict[str, Any],
     target: Target,
     page_size: int = 16,
+    kv_dtype: Optional[str] = None,
 ):
     (
         NUM_BLKS,
@@ -1223,6 +1253,7 @@ def _attention_prefill(
     if sliding_window:
         global_symbol += "_sliding_window"
 
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long,too-many-branches
     # fmt: off
     @T.prim_func
@@ -1258,7 +1289,7 @@ def _attention_prefill(
 
         q = T.match_buffer(var_q, (total_len, h_q, d), dtype)
         q_indptr = T.match_buffer(var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset)
-        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, page_size, d), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, page_size, d), kv_dtype, elem_offset=pages_elem_offset)
         page_indptr = T.match_buffer(var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_values = T.match_buffer(var_page_values, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
         k_rope_pos_offset = T.match_buffer(var_k_rope_pos_offset, (batch_size,), "int32", elem_offset=k_rope_pos_offset_elem_offset)
@@ -1382,7 +1413,7 @@ def _attention_prefill(
                                                     K_smem[i, j] = T.if_then_else(
                                                         rotary_mode == 1,
                                                         _rope(pages, k_rope_pos_offset[b_idx] + cur_L, d, rope_theta, rope_scale, (page_no, 0, by, page_offset, j), dtype, rope_scaling),
-                                                        pages[page_no, 0, by, page_offset, j]
+                                                        pages[page_no, 0, by, page_offset, j].astype(dtype)
                                                     )
                                                 else:
                                                     K_smem[i, j] = 0.0
@@ -1397,7 +1428,7 @@ def _attention_prefill(
                                                     seq_offset: T.int32(is_size_var=True) = _get_seq_offset(cur_L, b_idx, length_info, sliding_window)  # type: ignore
                                                     page_no: T.int32(is_size_var=True) = page_values[cur_page_indptr_begin + T.floordiv(seq_offset, page_size)]  # type: ignore
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, page_size)  # type: ignore
-                                                    V_smem[i, j] = pages[page_no, 1, by, page_offset, j]
+                                                    V_smem[i, j] = pages[page_no, 1, by, page_offset, j].astype(dtype)
                                                 else:
                                                     V_smem[i, j] = 0.0
                                         T.tvm_storage_sync("shared")
@@ -1508,6 +1539,7 @@ def _attention_decode_cpu(
     sliding_window: bool,
     rope_scaling: Dict[str, Any],
     page_size: int = 16,
+    kv_dtype: Optional[str] = None,
 ):
     H_qo = num_qo_heads
     H_kv = num_kv_heads
@@ -1518,6 +1550,7 @@ def _attention_decode_cpu(
     if sliding_window:
         global_symbol += "_sliding_window"
 
+    kv_dtype = kv_dtype or qkv_dtype
     # fmt: off
     # pylint: disable=line-too-long
     @T.prim_func(check_well_formed=False)
@@ -1547,7 +1580,7 @@ def _attention_decode_cpu(
         length_info_elem_offset = T.int32(is_size_var=True)
 
         Q = T.match_buffer(Q_handle, (B, H_qo, D), qkv_dtype)
-        pages = T.match_buffer(pages_handle, (max_num_pages, 2, H_kv, page_size, D), qkv_dtype)
+        pages = T.match_buffer(pages_handle, (max_num_pages, 2, H_kv, page_size, D), kv_dtype)
         page_table_indptr = T.match_buffer(
             page_table_indptr_handle, (B + 1,), "int32", elem_offset=page_indptr_elem_offset
         )
@@ -1622,7 +1655,7 @@ def _attention_decode_cpu(
                             K_local[d] = T.if_then_else(
                                 rotary_mode == 1,
                                 _rope(pages, k_rope_pos_offset[b] + row_idx, head_dim, rope_theta, rope_scale, (page_no, 0, h_qo // group_size, page_offset, d), qkv_dtype, rope_scaling),
-                                pages[page_no, 0, h_qo // group_size, page_offset, d],
+                                pages[page_no, 0, h_qo // group_size, page_offset, d].astype(qkv_dtype),
                             )
                         S_val[0] = 0.0
                         for d in T.serial(D):
@@ -1641,7 +1674,7 @@ def _attention_decode_cpu(
 
                         m_val[0] = new_m[0]
                         for d in T.serial(D):
-                            V_local[d] = pages[page_no, 1, h_qo // group_size, page_offset, d]
+                            V_local[d] = pages[page_no, 1, h_qo // group_size, page_offset, d].astype(qkv_dtype)
 
                         factor[0] = T.exp2(S_val[0] - m_val[0])
                         for d in T.serial(D):
@@ -1665,6 +1698,7 @@ def _attention_decode(
     rope_scaling: Dict[str, Any],
     target: Target,
     page_size: int = 16,
+    kv_dtype: Optional[str] = None,
 ):
     qkv_dtype_bytes = 2
     H_qo = num_qo_heads
@@ -1699,6 +1733,7 @@ def _attention_decode(
     if sliding_window:
         global_symbol += "_sliding_window"
 
+    kv_dtype = kv_dtype or qkv_dtype
     # pylint: disable=line-too-long,too-many-branches
     # fmt: off
     @T.prim_func
@@ -1730,7 +1765,7 @@ def _attention_decode(
 
         Q = T.match_buffer(Q_handle, (B, H_qo, D), qkv_dtype)
         pages = T.match_buffer(
-            pages_handle, (max_num_pages, 2, H_kv, page_size, D), qkv_dtype, elem_offset=pages_elem_offset
+            pages_handle, (max_num_pages, 2, H_kv, page_size, D), kv_dtype, elem_offset=pages_elem_offset
         )
         page_table_indptr = T.match_buffer(page_table_indptr_handle, (B + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_table_values = T.match_buffer(page_table_values_handle, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
@@ -1819,9 +1854,9 @@ def _attention_decode(
                                                     K_smem[tile_start_s + j, tx * VEC_SIZE + vec] = T.if_then_else(
                                                         rotary_mode == 1,
                                                         _rope(pages, k_rope_pos_offset[batch_idx] + row_g, head_dim, rope_theta, rope_scale, (page_no, 0, by, page_offset, tx * VEC_SIZE + vec), qkv_dtype, rope_scaling),
-                                                        pages[page_no, 0, by, page_offset, tx * VEC_SIZE + vec]
+                                                        pages[page_no, 0, by, page_offset, tx * VEC_SIZE + vec].astype(qkv_dtype)
                                                     )
-                                                    V_smem[tile_start_s + j, tx * VEC_SIZE + vec] = pages[page_no, 1, by, page_offset, tx * VEC_SIZE + vec]
+                                                    V_smem[tile_start_s + j, tx * VEC_SIZE + vec] = pages[page_no, 1, by, page_offset, tx * VEC_SIZE + vec].astype(qkv_dtype)
                                             else:
                                                 for vec in T.vectorized(VEC_SIZE):
                                                     K_smem[tile_start_s + j, tx * VEC_SIZE + vec] = 0.0
@@ -2684,6 +2719,7 @@ def _attention_prefill_mla(
     sliding_window: bool,
     target: Target,
     page_size: int = 16,
+    kv_dtype: Optional[str] = None,
 ):
     d_qk = d_latent + d_rope
     (
@@ -2701,6 +2737,7 @@ def _attention_prefill_mla(
     if sliding_window:
         global_symbol += "_sliding_window"
 
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long,too-many-branches
     # fmt: off
     @T.prim_func
@@ -2729,7 +2766,7 @@ def _attention_prefill_mla(
 
         q = T.match_buffer(var_q, (total_len, h_q, d_qk), dtype)
         q_indptr = T.match_buffer(var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset)
-        pages = T.match_buffer(var_pages, (max_num_pages, page_size, d_qk), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (max_num_pages, page_size, d_qk), kv_dtype, elem_offset=pages_elem_offset)
         page_indptr = T.match_buffer(var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_values = T.match_buffer(var_page_values, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
         output = T.match_buffer(var_output, (total_len, h_q, d_latent), dtype)
@@ -2842,7 +2879,7 @@ def _attention_prefill_mla(
                                                 seq_offset: T.int32(is_size_var=True) = _get_seq_offset(cur_L, b_idx, length_info, sliding_window)  # type: ignore
                                                 page_no: T.int32(is_size_var=True) = page_values[cur_page_indptr_begin + T.floordiv(seq_offset, page_size)]  # type: ignore
                                                 page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, page_size)  # type: ignore
-                                                KV_smem[i, j] = pages[page_no, page_offset, j]
+                                                KV_smem[i, j] = pages[page_no, page_offset, j].astype(dtype)
                                             else:
                                                 KV_smem[i, j] = 0.0
                                     T.tvm_storage_sync("shared")
@@ -2945,9 +2982,12 @@ def _attention_prefill_mla(
     return sch.mod["main"].with_attr("tir.is_scheduled", True)
 
 
-def _copy_single_page(num_heads, page_size, head_dim, dtype, target: Target):
+def _copy_single_page(
+    num_heads, page_size, head_dim, dtype, target: Target, kv_dtype: Optional[str] = None
+):
     tx = get_max_num_threads_per_block(target)
 
+    kv_dtype = kv_dtype or dtype
     @T.prim_func
     def copy_single_page(
         var_pages: T.handle,
@@ -2961,7 +3001,7 @@ def _copy_single_page(num_heads, page_size, head_dim, dtype, target: Target):
         pages = T.match_buffer(
             var_pages,
             (num_pages, 2, num_heads, page_size, head_dim),
-            dtype,
+            kv_dtype,
             elem_offset=pages_elem_offset,
         )
 
@@ -2992,9 +3032,12 @@ def _copy_single_page(num_heads, page_size, head_dim, dtype, target: Target):
     return copy_single_page
 
 
-def _copy_single_page_mla(page_size, head_dim, dtype, target: Target):
+def _copy_single_page_mla(
+    page_size, head_dim, dtype, target: Target, kv_dtype: Optional[str] = None
+):
     tx = get_max_num_threads_per_block(target)
 
+    kv_dtype = kv_dtype or dtype
     @T.prim_func
     def copy_single_page_mla(
         var_pages: T.handle,
@@ -3006,7 +3049,7 @@ def _copy_single_page_mla(page_size, head_dim, dtype, target: Target):
         num_pages = T.int32()
         pages_elem_offset = T.int64()
         pages = T.match_buffer(
-            var_pages, (num_pages, page_size, head_dim), dtype, elem_offset=pages_elem_offset
+            var_pages, (num_pages, page_size, head_dim), kv_dtype, elem_offset=pages_elem_offset
         )
 
         for b in T.thread_binding((copy_length * head_dim + tx - 1) // tx, thread="blockIdx.x"):
@@ -3020,9 +3063,10 @@ def _copy_single_page_mla(page_size, head_dim, dtype, target: Target):
     return copy_single_page_mla
 
 
-def _copy_single_page_cpu(num_heads, page_size, head_dim, dtype):
+def _copy_single_page_cpu(num_heads, page_size, head_dim, dtype, kv_dtype: Optional[str] = None):
     tx = 1
 
+    kv_dtype = kv_dtype or dtype
     @T.prim_func
     def copy_single_page_cpu(
         var_pages: T.handle,
@@ -3032,7 +3076,7 @@ def _copy_single_page_cpu(num_heads, page_size, head_dim, dtype):
     ):
         T.func_attr({"tir.is_scheduled": True})
         num_pages = T.int32()
-        pages = T.match_buffer(var_pages, (num_pages, 2, num_heads, page_size, head_dim), dtype)
+        pages = T.match_buffer(var_pages, (num_pages, 2, num_heads, page_size, head_dim), kv_dtype)
 
         for b in T.serial((copy_length * num_heads * head_dim + tx - 1) // tx):
             for t in T.serial(tx):
@@ -3059,9 +3103,12 @@ def _copy_single_page_cpu(num_heads, page_size, head_dim, dtype):
     return copy_single_page_cpu
 
 
-def _compact_kv_copy(num_heads, head_dim, dtype, target: Target, page_size: int = 16):
+def _compact_kv_copy(
+    num_heads, head_dim, dtype, target: Target, page_size: int = 16, kv_dtype: Optional[str] = None
+):
     tx = get_max_num_threads_per_block(target)
 
+    kv_dtype = kv_dtype or dtype
     @T.prim_func
     def compact_kv_copy(
         var_pages: T.handle,
@@ -3078,7 +3125,7 @@ def _compact_kv_copy(num_heads, head_dim, dtype, target: Target, page_size: int
         pages = T.match_buffer(
             var_pages,
             (num_pages, 2, num_heads, page_size, head_dim),
-            dtype,
+            kv_dtype,
             elem_offset=pages_elem_offset,
         )
         copy_length_indptr = T.match_buffer(
@@ -3116,9 +3163,12 @@ def _compact_kv_copy(num_heads, head_dim, dtype, target: Target, page_size: int
     return compact_kv_copy
 
 
-def _compact_kv_copy_cpu(num_heads, head_dim, dtype, page_size: int = 16):
+def _compact_kv_copy_cpu(
+    num_heads, head_dim, dtype, page_size: int = 16, kv_dtype: Optional[str] = None
+):
     tx = 8
 
+    kv_dtype = kv_dtype or dtype
     @T.prim_func
     def compact_kv_copy_cpu(
         var_pages: T.handle,
@@ -3131,7 +3181,7 @@ def _compact_kv_copy_cpu(num_heads, head_dim, dtype, page_size: int = 16):
         total_copy_length = T.int32()
         copy_length_indptr_elem_offset = T.int32()
         copy_src_dst_pos_elem_offset = T.int32()
-        pages = T.match_buffer(var_pages, (num_pages, 2, num_heads, page_size, head_dim), dtype)
+        pages = T.match_buffer(var_pages, (num_pages, 2, num_heads, page_size, head_dim), kv_dtype)
         copy_length_indptr = T.match_buffer(
             var_copy_length_indptr,
             (batch_size + 1,),
@@ -19,7 +19,7 @@
 """Operators for tree attention."""
 
 import math
-from typing import Any, Dict, Tuple
+from typing import Any, Dict, Optional, Tuple
 
 from tvm import tir
 from tvm.runtime import DataType
@@ -53,9 +53,9 @@ def _rope(
     cos = cos_freq * buffer[indices].astype("float32")
     sin = sin_freq * tir.if_then_else(
         d < rotary_dim // 2,
-        -buffer[indices[:-1] + (d + rotary_dim // 2,)],
-        buffer[indices[:-1] + (d - rotary_dim // 2,)],
-    ).astype("float32")
+        -buffer[indices[:-1] + (d + rotary_dim // 2,)].astype("float32"),
+        buffer[indices[:-1] + (d - rotary_dim // 2,)].astype("float32"),
+    )
     expr = (cos + sin).astype(qkv_dtype)
     for var, value in var_map.items():
         expr = tir.Let(var, value, expr)
@@ -652,7 +652,9 @@ def tree_attn(
     return sch.mod["main"].with_attr("tir.is_scheduled", True)
 
 
-def tree_attn_with_paged_kv_cache_cpu(h_kv, h_q, d, dtype, rope_scaling: Dict[str, Any]):
+def tree_attn_with_paged_kv_cache_cpu(
+    h_kv, h_q, d, dtype, rope_scaling: Dict[str, Any], kv_dtype: Optional[str] = None
+):
     """Generate tree attention kernel for batched tree attention with paged key-value cache.
 
     Parameters
@@ -679,6 +681,7 @@ def tree_attn_with_paged_kv_cache_cpu(h_kv, h_q, d, dtype, rope_scaling: Dict[st
     global_symbol = "tree_attn_paged_kv_cpu"
     sliding_window = False
     group_size = h_q // h_kv
+    kv_dtype = kv_dtype or dtype
     # pylint: disable=line-too-long,too-many-branches
     # fmt: off
     @T.prim_func(check_well_formed=False)
@@ -716,7 +719,7 @@ def tree_attn_with_paged_kv_cache_cpu(h_kv, h_q, d, dtype, rope_scaling: Dict[st
 
         q = T.match_buffer(var_q, (total_len, h_q, d), dtype)
         q_indptr = T.match_buffer(var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset)
-        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), dtype)
+        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), kv_dtype)
         page_indptr = T.match_buffer(var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_values = T.match_buffer(var_page_values, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
         k_rope_pos_offset = T.match_buffer(var_k_rope_pos_offset, (batch_size,), "int32", elem_offset=k_rope_pos_offset_elem_offset)
@@ -801,9 +804,9 @@ def tree_attn_with_paged_kv_cache_cpu(h_kv, h_q, d, dtype, rope_scaling: Dict[st
                                     K_local[d_idx] = T.if_then_else(
                                         rotary_mode == 1,
                                         _rope(pages, k_rope_pos_offset[b_idx] + row_idx, d, rope_theta, rope_scale, (page_no, 0, h_qo // group_size, page_offset, d_idx), dtype, rope_scaling),
-                                        pages[page_no, 0, h_qo // group_size, page_offset, d_idx]
+                                        pages[page_no, 0, h_qo // group_size, page_offset, d_idx].astype(dtype)
                                     )
-                                    V_local[d_idx] = pages[page_no, 1, h_qo // group_size, page_offset, d_idx]
+                                    V_local[d_idx] = pages[page_no, 1, h_qo // group_size, page_offset, d_idx].astype(dtype)
 
                                 # Compute S
                                 S_val[0] = 0.0
@@ -847,7 +850,8 @@ def tree_attn_with_paged_kv_cache_cpu(h_kv, h_q, d, dtype, rope_scaling: Dict[st
 
 
 def tree_attn_with_paged_kv_cache(
-    h_kv, h_q, d, dtype, rope_scaling: Dict[str, Any], target: Target
+    h_kv, h_q, d, dtype, rope_scaling: Dict[str, Any], target: Target,
+    kv_dtype: Optional[str] = None
 ):
     """Generate tree attention kernel for batched tree attention with paged key-value cache.
 
@@ -908,6 +912,7 @@ def tree_attn_with_paged_kv_cache(
     global_symbol = "tree_attn_paged_kv"
     sliding_window = False  # Sliding window is not supported in this kernel.
 
+    kv_dtype = kv_dtype or dtype
     # fmt: off
     @T.prim_func
     def tree_attn_paged_kv(
@@ -947,7 +952,7 @@ def tree_attn_with_paged_kv_cache(
         q_indptr = T.match_buffer(
             var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset
         )
-        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), dtype)
+        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), kv_dtype)
         page_indptr = T.match_buffer(
             var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset
         )
@@ -1122,7 +1127,7 @@ def tree_attn_with_paged_kv_cache(
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, 16)  # type: ignore
                                                     K_smem[i, j] = pages[
                                                         page_no, 0, by, page_offset, j
-                                                    ]
+                                                    ].astype(dtype)
                                                 else:
                                                     K_smem[i, j] = 0.0
 
@@ -1139,7 +1144,7 @@ def tree_attn_with_paged_kv_cache(
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, 16)  # type: ignore
                                                     V_smem[i, j] = pages[
                                                         page_no, 1, by, page_offset, j
-                                                    ]
+                                                    ].astype(dtype)
                                                 else:
                                                     V_smem[i, j] = 0.0
                                         T.tvm_storage_sync("shared")
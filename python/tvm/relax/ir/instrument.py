@@ -36,12 +36,26 @@ class WellFormedInstrument:
         If True (default), perform a well-formed check before running
         a transform.  If False, only perform the well-formed check
         after running a transform.
+
+    incremental: bool
+
+        If True, only check the functions that are not the same objects
+        as in the last module checked, so that the checks stay cheap in
+        the pipelines of large models.  If False (default), check the
+        whole module each time.
     """
 
-    def __init__(self, check_struct_info: bool = True, validate_before_transform: bool = True):
+    def __init__(
+        self,
+        check_struct_info: bool = True,
+        validate_before_transform: bool = True,
+        incremental: bool = False,
+    ):
         self.skip_pass_name = ["Normalize", "NormalizeGlobalVar", "ResolveGlobals"]
         self.check_struct_info = check_struct_info
         self.validate_before_transform = validate_before_transform
+        self.incremental = incremental
+        self._checked_mod = None
 
     def run_before_pass(self, mod, pass_info):
         if self.validate_before_transform:
@@ -52,7 +66,10 @@ class WellFormedInstrument:
 
     def _check(self, mod, pass_name, name_prefix):
         if pass_name not in self.skip_pass_name:
-            is_well_formed = relax.analysis.well_formed(mod, self.check_struct_info)
+            prev_mod = self._checked_mod if self.incremental else None
+            is_well_formed = relax.analysis.well_formed(mod, self.check_struct_info, prev_mod)
             if not is_well_formed:
                 mod.show(name=f"{name_prefix}{pass_name}")
             assert is_well_formed
+            if self.incremental:
+                self._checked_mod = mod
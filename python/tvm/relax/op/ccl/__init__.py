@@ -15,4 +15,15 @@
 # specific language governing permissions and limitations
 # under the License.
 """CCL related operators."""
-from .ccl import allgather, allreduce, broadcast_from_worker0, scatter_from_worker0
+from .ccl import (
+    allgather,
+    allreduce,
+    allreduce_start,
+    allreduce_wait,
+    alltoall,
+    broadcast_from_worker0,
+    ring_attention,
+    ring_send_recv_start,
+    ring_send_recv_wait,
+    scatter_from_worker0,
+)
@@ -16,6 +16,11 @@
 # under the License.
 """Relax Collective Communications Library (CCL) operators"""
 
+from typing import Optional
+
+from tvm import DataType
+from tvm.tir import FloatImm
+
 from . import _ffi_api
 from ...expr import Expr
 
@@ -48,6 +53,53 @@ def allreduce(x, op_type: str = "sum", in_group: bool = True):  # pylint: disabl
     return _ffi_api.allreduce(x, op_type, in_group)  # type: ignore # pylint: disable=no-member
 
 
+def allreduce_start(x, op_type: str = "sum", in_group: bool = True):  # pylint: disable=invalid-name
+    """Start an asynchronous allreduce. The result is ready after `allreduce_wait`.
+
+    Parameters
+    ----------
+    x : relax.Expr
+      The input tensor.
+
+    op_type : str
+      The type of reduction operation to be applied to the input data.
+      Now "sum", "prod", "min", "max" and "avg" are supported.
+
+    in_group : bool
+      Whether the reduction operation performs globally or in group as default.
+
+    Returns
+    -------
+    result : relax.Expr
+      The pending result of allreduce.
+    """
+    supported_op_types = ["sum", "prod", "min", "max", "avg"]
+    assert op_type in supported_op_types, (
+        "Allreduce only supports limited reduction operations, "
+        f"including {supported_op_types}, but got {op_type}."
+    )
+    return _ffi_api.allreduce_start(x, op_type, in_group)  # type: ignore # pylint: disable=no-member
+
+
+def allreduce_wait(pending: Expr, x: Expr) -> Expr:
+    """Wait for an asynchronous allreduce started by `allreduce_start`.
+
+    Parameters
+    ----------
+    pending : relax.Expr
+      The output of `allreduce_start`.
+
+    x : relax.Expr
+      The input of `allreduce_start`, which must stay alive until the wait.
+
+    Returns
+    -------
+    result : relax.Expr
+      The result of allreduce.
+    """
+    return _ffi_api.allreduce_wait(pending, x)  # type: ignore # pylint: disable=no-member
+
+
 def allgather(x, num_workers: int, in_group: bool = True):  # pylint: disable=invalid-name
     """AllGather operator
 
@@ -70,6 +122,30 @@ def allgather(x, num_workers: int, in_group: bool = True):  # pylint: disable=in
     return _ffi_api.allgather(x, num_workers, in_group)  # type: ignore # pylint: disable=no-member
 
 
+def alltoall(x, num_workers: int, in_group: bool = True):  # pylint: disable=invalid-name
+    """AllToAll operator. The input is split evenly along axis 0, the split i is sent to the
+    worker i, and the output holds the splits received from each worker, in the order of the
+    workers.
+
+    Parameters
+    ----------
+    x : relax.Expr
+      The input tensor, whose axis 0 is divisible by num_workers.
+
+    num_workers : int
+      The number of workers to exchange data with.
+
+    in_group : bool
+      Whether the all-to-all operation performs globally or in group as default.
+
+    Returns
+    -------
+    result : relax.Expr
+      The result of alltoall, of the same shape as the input.
+    """
+    return _ffi_api.alltoall(x, num_workers, in_group)  # type: ignore # pylint: disable=no-member
+
+
 def broadcast_from_worker0(x: Expr) -> Expr:
     """Broadcast data from worker-0 to all other workers.
 
@@ -106,3 +182,99 @@ def scatter_from_worker0(x: Expr, num_workers: int, axis: int = 0) -> Expr:
       Chunked Tensor received by different workers.
     """
     return _ffi_api.scatter_from_worker0(x, num_workers, axis)
+
+
+def ring_send_recv_start(x: Expr, num_workers: int, in_group: bool = True) -> Expr:
+    """Start sending a buffer to the next worker of the ring, while receiving the buffer of the
+    previous worker. The received buffer is ready after `ring_send_recv_wait`.
+
+    Parameters
+    ----------
+    x : relax.Expr
+      The buffer sent to the next worker.
+
+    num_workers : int
+      The number of workers of the ring.
+
+    in_group : bool
+      Whether the ring is formed by the workers of a group or by all the workers.
+
+    Returns
+    -------
+    result : relax.Expr
+      The pending buffer received from the previous worker.
+    """
+    return _ffi_api.ring_send_recv_start(x, num_workers, in_group)  # type: ignore
+
+
+def ring_send_recv_wait(pending: Expr, x: Expr) -> Expr:
+    """Wait for a ring exchange started by `ring_send_recv_start`.
+
+    Parameters
+    ----------
+    pending : relax.Expr
+      The output of `ring_send_recv_start`.
+
+    x : relax.Expr
+      The input of `ring_send_recv_start`, which must stay alive until the wait.
+
+    Returns
+    -------
+    result : relax.Expr
+      The buffer received from the previous worker.
+    """
+    return _ffi_api.ring_send_recv_wait(pending, x)  # type: ignore
+
+
+def ring_attention(
+    query: Expr,
+    key: Expr,
+    value: Expr,
+    num_workers: int,
+    in_group: bool = True,
+    causal: bool = False,
+    scale: Optional[float] = None,
+) -> Expr:
+    """Attention over a sequence sharded across a ring of workers.
+
+    The worker of rank r holds block r of the sequence of the queries, keys and values. In each
+    of the `num_workers` steps, a worker attends its queries to the block of keys and values it
+    holds, merges the result by the log-sum-exp of each step, and passes the block to the next
+    worker of the ring, overlapping the exchange with the attention of the step.
+
+    Parameters
+    ----------
+    query : relax.Expr
+      The block of the queries, of layout (batch, seq_len, num_heads, head_dim).
+
+    key : relax.Expr
+      The block of the keys, of layout (batch, seq_len_kv, num_kv_heads, head_dim). The number
+      of query heads must be a multiple of the number of key heads.
+
+    value : relax.Expr
+      The block of the values, of layout (batch, seq_len_kv, num_kv_heads, head_dim_v).
+
+    num_workers : int
+      The number of workers of the ring.
+
+    in_group : bool
+      Whether the ring is formed by the workers of a group or by all the workers.
+
+    causal : bool
+      Whether a query only attends to the keys at the same or earlier positions of the whole
+      sequence.
+
+    scale : Optional[float]
+      The scale applied before the softmax. The default value is 1 / sqrt(head_dim).
+
+    Returns
+    -------
+    result : relax.Expr
+      The attention of the block of the queries, of layout (batch, seq_len, num_heads,
+      head_dim_v).
+    """
+    if scale is not None and not isinstance(scale, FloatImm):
+        scale = FloatImm(DataType("float32"), scale)
+    return _ffi_api.ring_attention(  # type: ignore
+        query, key, value, num_workers, in_group, causal, scale
+    )
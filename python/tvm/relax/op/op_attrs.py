@@ -316,7 +316,7 @@ class AllReduceAttrs(Attrs):
 
 @tvm_ffi.register_object("relax.attrs.AllGatherAttrs")
 class AllGatherAttrs(Attrs):
-    """Attributes used in allgather operator"""
+    """Attributes used in allgather and alltoall operators"""
 
 
 @tvm_ffi.register_object("relax.attrs.WrapParamAttrs")
@@ -26,6 +26,7 @@ def all_class_non_max_suppression(
     iou_threshold,
     score_threshold,
     output_format="onnx",
+    fixed_output=False,
 ):
     """Non-maximum suppression operator for object detection, corresponding to ONNX
     NonMaxSuppression and TensorFlow combined_non_max_suppression.
@@ -45,6 +46,10 @@ def all_class_non_max_suppression(
         Score threshold to filter out low score boxes early
     output_format : str, optional
         "onnx" or "tensorflow", see below.
+    fixed_output : bool, optional
+        Whether the "onnx" `indices` keep their fixed shape instead of being trimmed to the
+        `num_total_detection` valid rows, so that the outputs have static shapes, for instance
+        to be captured in CUDA graphs.
 
     Returns
     -------
@@ -55,8 +60,9 @@ def all_class_non_max_suppression(
         boxes. The three values in `indices` encode batch, class, and box indices.
         Rows of `indices` are ordered such that selected boxes from batch 0, class 0 come
         first, in descending of scores, followed by boxes from batch 0, class 1 etc.
-        The output uses dynamic_strided_slice to trim to only valid detections,
-        so the first tensor has shape (num_total_detection, 3) containing only valid rows.
+        Unless `fixed_output` is set, the output uses dynamic_strided_slice to trim to only valid
+        detections, so the first tensor has shape (num_total_detection, 3) containing only valid
+        rows.
 
         If `output_format` is "tensorflow", the output is three tensors, the first
         is `indices` of size `(batch_size, num_class * num_boxes , 2)`, the second is `scores` of
@@ -69,5 +75,11 @@ def all_class_non_max_suppression(
         the class 1 etc.
     """
     return _ffi_api.all_class_non_max_suppression(
-        boxes, scores, max_output_boxes_per_class, iou_threshold, score_threshold, output_format
+        boxes,
+        scores,
+        max_output_boxes_per_class,
+        iou_threshold,
+        score_threshold,
+        output_format,
+        fixed_output,
     )
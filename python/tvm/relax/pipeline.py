@@ -98,6 +98,7 @@ def default_build_pipeline():
                 transform.LowerRuntimeBuiltin(),
                 transform.ComputePrimValue(),
                 transform.VMShapeLower(),
+                transform.DeduplicatePrimFuncs(),
                 transform.AttachGlobalSymbol(),
             ],
         )
@@ -23,6 +23,7 @@ from .transform import (
     AnnotateTIROpPattern,
     AttachAttrLayoutFreeBuffers,
     AttachGlobalSymbol,
+    AutoCheckpoint,
     BindParams,
     BindSymbolicVars,
     BundleModelParams,
@@ -37,6 +38,7 @@ from .transform import (
     DeadCodeElimination,
     DecomposeOpsForInference,
     DecomposeOpsForTraining,
+    DeduplicatePrimFuncs,
     EliminateCommonSubexpr,
     ExpandMatmulOfSum,
     ExpandTupleArguments,
@@ -45,9 +47,11 @@ from .transform import (
     FunctionPass,
     FuseOps,
     FuseOpsByPattern,
+    FusePersistentKernel,
     FuseTIR,
     FusionPattern,
     Gradient,
+    HorizontalFuseTIR,
     InlinePrivateFunctions,
     KillAfterLastUse,
     LambdaLift,
@@ -73,6 +77,9 @@ from .transform import (
     RewriteCUDAGraph,
     RewriteDataflowReshape,
     RunCodegen,
+    ScheduleAsyncAllReduce,
+    DecomposeCollectiveMatmul,
+    ScheduleAsyncExternCalls,
     SplitCallTIRByPattern,
     SplitLayoutRewritePreproc,
     StaticPlanBlockMemory,
@@ -84,6 +91,9 @@ from .transform import (
     VMBuiltinLower,
     VMShapeLower,
     SpecializePrimFuncBasedOnCallSite,
+    SpecializeCallTIRByShapeBucket,
+    SpecializeShapeBuckets,
+    DispatchDynamicMatmulToLibrary,
     dataflowblock_pass,
     function_pass,
 )
@@ -97,6 +107,12 @@ from .lower_gpu_ipc_alloc_storage import LowerGPUIPCAllocStorage
 from .optimize_layout_transform import OptimizeLayoutTransform
 from .fold_batch_norm_to_conv2d_for_inference import FoldBatchnormToConv2D
 from .remove_redundant_reshape import RemoveRedundantReshape
+from .search_layout import (
+    DatabaseLayoutCost,
+    LayoutCostModel,
+    MeasuredLayoutCost,
+    SearchLayout,
+)
 
 # Import to register the legalization functions.
 from . import legalize_ops
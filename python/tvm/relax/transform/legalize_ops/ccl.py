@@ -16,16 +16,17 @@
 # under the License.
 # pylint: disable=invalid-name
 """Default legalization function for ccl operators."""
-from tvm import tir, arith, topi
+from tvm import te, tir, arith, topi
+from tvm.ir.transform import PassContext
 from ...block_builder import BlockBuilder
-from ...expr import Call, Expr, ShapeExpr
-from ...op import call_dps_packed
-from ...struct_info import TensorStructInfo, ShapeStructInfo
+from ...expr import Call, Expr, ShapeExpr, TupleGetItem
+from ...op import call_dps_packed, call_pure_packed
+from ...op.ccl import ring_send_recv_start, ring_send_recv_wait
+from ...struct_info import PrimStructInfo, TensorStructInfo, ShapeStructInfo
 from .common import register_legalize
 
 
-@register_legalize("relax.ccl.allreduce")
-def _allreduce(_bb: BlockBuilder, call: Call) -> Expr:
+def _reduce_kind(call: Call) -> int:
     op_type_str = call.attrs.op_type
     op_type_map = {
         "sum": 0,
@@ -39,13 +40,196 @@ def _allreduce(_bb: BlockBuilder, call: Call) -> Expr:
             f"Unsupported reduction operation: {op_type_str}. "
             f"Supported operations are {op_type_map.keys()}."
         )
+    return op_type_map[op_type_str]
+
+
+def _allreduce_quantization(call: Call):
+    """The quantization of the exchanged data that the pass config
+    `relax.ccl.allreduce_quantization` opts in, if `call` can use it."""
+    quantization = PassContext.current().config.get("relax.ccl.allreduce_quantization", None)
+    if quantization is None or call.attrs.op_type not in ("sum", "avg"):
+        return None
+    arg_sinfo = call.args[0].struct_info
+    if not isinstance(arg_sinfo, TensorStructInfo) or arg_sinfo.dtype not in (
+        "float32",
+        "float16",
+        "bfloat16",
+    ):
+        return None
+    return str(quantization)
+
+
+@register_legalize("relax.ccl.allreduce")
+def _allreduce(_bb: BlockBuilder, call: Call) -> Expr:
+    quantization = _allreduce_quantization(call)
+    if quantization is not None:
+        return call_dps_packed(
+            "runtime.disco.allreduce_quantized",
+            [call.args[0], ShapeExpr([_reduce_kind(call)]), call.attrs.in_group, quantization],
+            out_sinfo=call.args[0].struct_info,
+        )
     return call_dps_packed(
         "runtime.disco.allreduce",
-        [call.args[0], ShapeExpr([op_type_map[op_type_str]]), call.attrs.in_group],
+        [call.args[0], ShapeExpr([_reduce_kind(call)]), call.attrs.in_group],
+        out_sinfo=call.args[0].struct_info,
+    )
+
+
+@register_legalize("relax.ccl.allreduce_start")
+def _allreduce_start(_bb: BlockBuilder, call: Call) -> Expr:
+    # The matching `relax.ccl.allreduce_wait` is lowered after memory planning.
+    return call_dps_packed(
+        "runtime.disco.allreduce_start",
+        [call.args[0], ShapeExpr([_reduce_kind(call)]), call.attrs.in_group],
+        out_sinfo=call.args[0].struct_info,
+    )
+
+
+@register_legalize("relax.ccl.ring_send_recv_start")
+def _ring_send_recv_start(_bb: BlockBuilder, call: Call) -> Expr:
+    # The matching `relax.ccl.ring_send_recv_wait` is lowered after memory planning.
+    return call_dps_packed(
+        "runtime.disco.ring_send_recv_start",
+        [call.args[0], call.attrs.num_workers, call.attrs.in_group],
         out_sinfo=call.args[0].struct_info,
     )
 
 
+def _te_ring_attention_block(q, k, v, scale, causal, rank, src):
+    """The attention of the queries to a block of the keys and values, in float32, together with
+    the log-sum-exp of the scores of each query. With the causal mask, the queries of block
+    `rank` attend to the keys of block `src` at the same or earlier positions of the sequence."""
+    batch_size, seq_len, num_head, head_dim = q.shape
+    _, seq_len_kv, num_kv_head, head_dim_v = v.shape
+    group_size = num_head // num_kv_head
+    if scale is None:
+        scale = 1.0 / tir.sqrt(tir.Cast("float32", head_dim))
+    r_d = te.reduce_axis((0, head_dim), name="r_d")
+    score = te.compute(
+        (batch_size, num_head, seq_len, seq_len_kv),
+        lambda b, h, i, j: te.sum(
+            q[b, i, h, r_d].astype("float32") * k[b, j, h // group_size, r_d].astype("float32"),
+            axis=r_d,
+        )
+        * scale,
+        name="score",
+    )
+    if causal:
+        # A block with no key to attend to gets the same lowest score everywhere, so that its
+        # log-sum-exp vanishes from the merge of the steps.
+        score = te.compute(
+            score.shape,
+            lambda b, h, i, j: tir.Select(
+                rank * tir.Cast("int64", seq_len) + tir.Cast("int64", i)
+                >= src * tir.Cast("int64", seq_len_kv) + tir.Cast("int64", j),
+                score[b, h, i, j],
+                tir.min_value("float32"),
+            ),
+            name="masked_score",
+        )
+    r_j = te.reduce_axis((0, seq_len_kv), name="r_j")
+    max_score = te.compute(
+        (batch_size, num_head, seq_len),
+        lambda b, h, i: te.max(score[b, h, i, r_j], axis=r_j),
+        name="max_score",
+    )
+    exp_score = te.compute(
+        score.shape, lambda b, h, i, j: te.exp(score[b, h, i, j] - max_score[b, h, i]), name="exp"
+    )
+    r_j = te.reduce_axis((0, seq_len_kv), name="r_j")
+    sum_exp = te.compute(
+        (batch_size, num_head, seq_len),
+        lambda b, h, i: te.sum(exp_score[b, h, i, r_j], axis=r_j),
+        name="sum_exp",
+    )
+    r_j = te.reduce_axis((0, seq_len_kv), name="r_j")
+    out = te.compute(
+        (batch_size, seq_len, num_head, head_dim_v),
+        lambda b, i, h, d: te.sum(
+            exp_score[b, h, i, r_j] * v[b, r_j, h // group_size, d].astype("float32"), axis=r_j
+        )
+        / sum_exp[b, h, i],
+        name="out",
+    )
+    lse = te.compute(
+        (batch_size, num_head, seq_len),
+        lambda b, h, i: max_score[b, h, i] + te.log(sum_exp[b, h, i]),
+        name="lse",
+    )
+    return [out, lse]
+
+
+def _te_merge_attention_states(o_a, lse_a, o_b, lse_b):
+    """Merge the attention of two blocks of the keys by their log-sum-exp."""
+    lse = te.compute(
+        lse_a.shape,
+        lambda b, h, i: tir.max(lse_a[b, h, i], lse_b[b, h, i])
+        + te.log(
+            te.exp(lse_a[b, h, i] - tir.max(lse_a[b, h, i], lse_b[b, h, i]))
+            + te.exp(lse_b[b, h, i] - tir.max(lse_a[b, h, i], lse_b[b, h, i]))
+        ),
+        name="merged_lse",
+    )
+    out = te.compute(
+        o_a.shape,
+        lambda b, i, h, d: o_a[b, i, h, d] * te.exp(lse_a[b, h, i] - lse[b, h, i])
+        + o_b[b, i, h, d] * te.exp(lse_b[b, h, i] - lse[b, h, i]),
+        name="merged_out",
+    )
+    return [out, lse]
+
+
+@register_legalize("relax.ccl.ring_attention")
+def _ring_attention(bb: BlockBuilder, call: Call) -> Expr:
+    q, k, v = call.args
+    num_workers = call.attrs.num_workers
+    in_group = call.attrs.in_group
+    causal = call.attrs.causal
+    rank = None
+    if causal:
+        rank_value = bb.emit(
+            call_pure_packed("runtime.disco.worker_rank", sinfo_args=PrimStructInfo("int64"))
+        )
+        rank = tir.Var("rank", "int64")
+        bb.match_cast(rank_value, PrimStructInfo(value=rank))
+        rank = tir.floormod(rank, num_workers)
+
+    out, lse = None, None
+    for step in range(num_workers):
+        # Pass the block on before attending to it, so the exchange overlaps the attention.
+        if step + 1 < num_workers:
+            k_next = bb.emit(ring_send_recv_start(k, num_workers, in_group))
+            v_next = bb.emit(ring_send_recv_start(v, num_workers, in_group))
+        src = None if rank is None else tir.floormod(rank - step + num_workers, num_workers)
+        state = bb.emit_te(
+            _te_ring_attention_block,
+            q,
+            k,
+            v,
+            call.attrs.scale,
+            causal,
+            rank,
+            src,
+            primfunc_name_hint="ring_attention_block",
+        )
+        if out is None:
+            out, lse = bb.emit(TupleGetItem(state, 0)), bb.emit(TupleGetItem(state, 1))
+        else:
+            state = bb.emit_te(
+                _te_merge_attention_states,
+                out,
+                lse,
+                bb.emit(TupleGetItem(state, 0)),
+                bb.emit(TupleGetItem(state, 1)),
+                primfunc_name_hint="merge_attention_states",
+            )
+            out, lse = bb.emit(TupleGetItem(state, 0)), bb.emit(TupleGetItem(state, 1))
+        if step + 1 < num_workers:
+            k = bb.emit(ring_send_recv_wait(k_next, k))
+            v = bb.emit(ring_send_recv_wait(v_next, v))
+    return bb.call_te(topi.cast, out, call.struct_info.dtype, primfunc_name_hint="cast")
+
+
 @register_legalize("relax.ccl.allgather")
 def _allgather(_bb: BlockBuilder, call: Call) -> Expr:
     output_shape = []
@@ -71,6 +255,16 @@ def _allgather(_bb: BlockBuilder, call: Call) -> Expr:
     )
 
 
+@register_legalize("relax.ccl.alltoall")
+def _alltoall(_bb: BlockBuilder, call: Call) -> Expr:
+    # The empty splits exchange even splits of the input.
+    return call_dps_packed(
+        "runtime.disco.alltoall",
+        [call.args[0], ShapeExpr([]), ShapeExpr([]), call.attrs.in_group],
+        out_sinfo=call.args[0].struct_info,
+    )
+
+
 @register_legalize("relax.ccl.broadcast_from_worker0")
 def _broadcast_from_worker0(_bb: BlockBuilder, call: Call) -> Expr:
     return call_dps_packed(
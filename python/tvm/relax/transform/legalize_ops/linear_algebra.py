@@ -100,6 +100,182 @@ def _matmul(bb: BlockBuilder, call: Call) -> Expr:
     return bb.call_te(te_matmul, call.args[0], call.args[1], primfunc_name_hint="matmul")
 
 
+def _einsum_operand_shapes(fields):
+    """The static shapes of the einsum operands, or None when any of them is dynamic."""
+    shapes = []
+    for field in fields:
+        sinfo = field.struct_info
+        if not isinstance(sinfo, relax.TensorStructInfo) or sinfo.shape is None:
+            return None
+        shape = sinfo.shape.struct_info.values
+        if shape is None or any(not isinstance(dim, tir.IntImm) for dim in shape):
+            return None
+        shapes.append([int(dim) for dim in shape])
+    return shapes
+
+
+def _parse_einsum_subscripts(subscripts, shapes):
+    """Parse the subscripts for the pairwise decomposition.
+
+    Returns the indices of each operand, the output indices and the size of each index, or None
+    when the expression is out of the scope of the decomposition: an ellipsis, an index repeated
+    within an operand (a diagonal), or an index whose sizes differ (a broadcast).
+    """
+    subscripts = subscripts.replace(" ", "")
+    if "." in subscripts:
+        return None
+    if "->" in subscripts:
+        inputs, output = subscripts.split("->")
+    else:
+        inputs = subscripts
+        letters = inputs.replace(",", "")
+        output = "".join(sorted(c for c in set(letters) if letters.count(c) == 1))
+    inputs = inputs.split(",")
+    if len(inputs) != len(shapes) or len(set(output)) != len(output):
+        return None
+    sizes = {}
+    for indices, shape in zip(inputs, shapes):
+        if len(indices) != len(shape) or len(set(indices)) != len(indices):
+            return None
+        for index, dim in zip(indices, shape):
+            if sizes.setdefault(index, dim) != dim:
+                return None
+    if any(index not in sizes for index in output):
+        return None
+    return inputs, output, sizes
+
+
+def _einsum_contraction_path(inputs, output, sizes):
+    """The order of the pairwise contractions, as opt_einsum does.
+
+    The cost of contracting two tensors is the product of the sizes of all their indices. The
+    optimal order is searched over the subsets of the operands for up to 6 operands, beyond which
+    the pair of the cheapest contraction is greedily contracted first. Returns a list of pairs of
+    positions in the list of the remaining tensors, where the result of a contraction is appended
+    at the end of the list.
+    """
+
+    def volume(indices):
+        result = 1
+        for index in indices:
+            result *= sizes[index]
+        return result
+
+    def kept_indices(indices, others):
+        needed = set(output).union(*others)
+        return frozenset(index for index in indices if index in needed)
+
+    n = len(inputs)
+    if n <= 6:
+        operand_sets = [frozenset(indices) for indices in inputs]
+        full = (1 << n) - 1
+
+        def result_of(mask):
+            indices = frozenset().union(*(operand_sets[i] for i in range(n) if mask >> i & 1))
+            return kept_indices(indices, [operand_sets[i] for i in range(n) if not mask >> i & 1])
+
+        best = {1 << i: (0, None) for i in range(n)}
+        for mask in sorted(range(1, full + 1), key=lambda m: bin(m).count("1")):
+            if mask in best:
+                continue
+            best_cost, best_split = None, None
+            # each split is visited once, with the lowest operand on the left
+            low = mask & -mask
+            sub = (mask - 1) & mask
+            while sub:
+                if sub & low:
+                    rest = mask ^ sub
+                    cost = best[sub][0] + best[rest][0]
+                    cost += volume(result_of(sub) | result_of(rest))
+                    if best_cost is None or cost < best_cost:
+                        best_cost, best_split = cost, (sub, rest)
+                sub = (sub - 1) & mask
+            best[mask] = (best_cost, best_split)
+
+        # replay the splits in post order on the list of the remaining tensors
+        path = []
+        remaining = [1 << i for i in range(n)]
+
+        def contract(mask):
+            split = best[mask][1]
+            if split is None:
+                return
+            contract(split[0])
+            contract(split[1])
+            lhs, rhs = remaining.index(split[0]), remaining.index(split[1])
+            path.append((lhs, rhs))
+            remaining[:] = [m for m in remaining if m not in split] + [mask]
+
+        contract(full)
+        return path
+
+    path = []
+    remaining = [frozenset(indices) for indices in inputs]
+    while len(remaining) > 1:
+        _, lhs, rhs = min(
+            (volume(remaining[i] | remaining[j]), i, j)
+            for i in range(len(remaining))
+            for j in range(i + 1, len(remaining))
+        )
+        others = [s for k, s in enumerate(remaining) if k not in (lhs, rhs)]
+        result = kept_indices(remaining[lhs] | remaining[rhs], others)
+        path.append((lhs, rhs))
+        remaining = others + [result]
+    return path
+
+
+def _einsum_pairwise(bb, fields, inputs, output, sizes):
+    """Decompose the einsum into batched matmuls along the cheapest contraction path."""
+
+    def permute(tensor, indices, order):
+        if list(indices) == list(order):
+            return tensor
+        return bb.emit(relax.op.permute_dims(tensor, [indices.index(i) for i in order]))
+
+    def reshape(tensor, shape):
+        if [int(dim) for dim in tensor.struct_info.shape.struct_info.values] == shape:
+            return tensor
+        return bb.emit(relax.op.reshape(tensor, shape))
+
+    def volume(indices):
+        result = 1
+        for index in indices:
+            result *= sizes[index]
+        return result
+
+    def sum_out(tensor, indices, needed):
+        axes = [axis for axis, index in enumerate(indices) if index not in needed]
+        if not axes:
+            return tensor, indices
+        return bb.emit(relax.op.sum(tensor, axes)), "".join(i for i in indices if i in needed)
+
+    tensors = list(zip(fields, inputs))
+    for lhs, rhs in _einsum_contraction_path(inputs, output, sizes):
+        (a, a_indices), (b, b_indices) = tensors[lhs], tensors[rhs]
+        others = [indices for k, (_, indices) in enumerate(tensors) if k not in (lhs, rhs)]
+        kept = set(output).union(*others)
+        # the indices of a single operand that are not needed afterwards are summed first
+        a, a_indices = sum_out(a, a_indices, kept | set(b_indices))
+        b, b_indices = sum_out(b, b_indices, kept | set(a_indices))
+        batch = [i for i in a_indices if i in b_indices and i in kept]
+        reduce = [i for i in a_indices if i in b_indices and i not in kept]
+        a_free = [i for i in a_indices if i not in b_indices]
+        b_free = [i for i in b_indices if i not in a_indices]
+        a = permute(a, a_indices, batch + a_free + reduce)
+        b = permute(b, b_indices, batch + reduce + b_free)
+        a = reshape(a, [volume(batch), volume(a_free), volume(reduce)])
+        b = reshape(b, [volume(batch), volume(reduce), volume(b_free)])
+        result = bb.emit(relax.op.matmul(a, b))
+        result_indices = batch + a_free + b_free
+        result = reshape(result, [sizes[i] for i in result_indices])
+        tensors = [t for k, t in enumerate(tensors) if k not in (lhs, rhs)]
+        tensors.append((result, "".join(result_indices)))
+
+    [(result, indices)] = tensors
+    result, indices = sum_out(result, indices, set(output))
+    return permute(result, indices, output)
+
+
 @register_legalize("relax.einsum")
 def _einsum(bb: BlockBuilder, call: Call) -> Expr:
     t = call.args[0]
@@ -114,6 +290,15 @@ def _einsum(bb: BlockBuilder, call: Call) -> Expr:
     fields = (
         t.fields if isinstance(t, Tuple) else [bb.emit(TupleGetItem(t, i)) for i in range(n_field)]
     )
+    # A single compute over all the indices of 3 or more operands nests all the reductions,
+    # while a good order of pairwise contractions does far fewer FLOPs, each as a matmul that
+    # is tuned on its own.
+    if len(fields) >= 3:
+        shapes = _einsum_operand_shapes(fields)
+        parsed = shapes and _parse_einsum_subscripts(call.attrs.subscripts, shapes)
+        dtypes = {field.struct_info.dtype for field in fields}
+        if parsed and len(dtypes) == 1:
+            return _einsum_pairwise(bb, fields, *parsed)
     return bb.call_te(topi.einsum, call.attrs.subscripts, *fields)
 
 
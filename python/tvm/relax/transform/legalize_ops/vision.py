@@ -28,6 +28,8 @@ def _all_class_non_max_suppression(block_builder: BlockBuilder, call: Call) -> E
 
     This implementation uses dynamic_strided_slice to trim the NMS output to only
     contain valid detections, improving memory efficiency and ONNX compatibility.
+    With `fixed_output`, the indices keep the static shape given by the struct info
+    of the call instead, and only their first `num_total_detections` rows are valid.
 
     Returns
     -------
@@ -57,6 +59,18 @@ def _all_class_non_max_suppression(block_builder: BlockBuilder, call: Call) -> E
     else:
         max_boxes_val = int(num_boxes)
 
+    if output_format == "onnx" and call.attrs.fixed_output:
+        return block_builder.call_te(
+            topi.vision.all_class_non_max_suppression,
+            boxes,
+            scores,
+            max_boxes_val,
+            iou_threshold,
+            score_threshold,
+            output_format,
+            output_shape=list(call.struct_info.fields[0].shape.values),
+        )
+
     # Get NMS result with fixed shape from TOPI
     nms_result = block_builder.call_te(
         topi.vision.all_class_non_max_suppression,
@@ -0,0 +1,356 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument
+"""Cost-guided search of the layouts of ConvertLayout."""
+import logging
+import math
+from typing import Dict, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+import tvm
+from tvm import DataType, relax, tir
+from tvm.ir import IRModule, Op
+from tvm.ir.transform import PassContext
+from tvm.relax import Call, Constant, Function, TensorStructInfo
+from tvm.target import Target
+
+from . import function_pass
+from .transform import ConvertLayout, LegalizeOps
+
+logger = logging.getLogger(__name__)
+
+_TRANSFORM_OPS = ("relax.permute_dims", "relax.layout_transform")
+
+
+def _nbytes(sinfo) -> Optional[int]:
+    """The size of a tensor of static shape, None otherwise."""
+    if not isinstance(sinfo, TensorStructInfo) or sinfo.shape is None or not sinfo.dtype:
+        return None
+    shape = sinfo.shape
+    if not isinstance(shape, relax.ShapeExpr):
+        return None
+    size = 1
+    for dim in shape.values:
+        if not isinstance(dim, tir.IntImm):
+            return None
+        size *= dim.value
+    return size * DataType(sinfo.dtype).itemsize
+
+
+def _call_workload(call: Call) -> Optional[IRModule]:
+    """A module whose main function makes the call on fresh params, for tensor arguments only."""
+    params = []
+    for i, arg in enumerate(call.args):
+        if not isinstance(arg.struct_info, TensorStructInfo):
+            return None
+        params.append(relax.Var(f"arg{i}", arg.struct_info))
+    bb = relax.BlockBuilder()
+    with bb.function("main", params):
+        with bb.dataflow():
+            out = bb.emit(Call(call.op, params, call.attrs, call.sinfo_args))
+            gv = bb.emit_output(out)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+class LayoutCostModel:
+    """The cost, in seconds, of the layout-sensitive calls of a function after ConvertLayout.
+
+    This base model is analytic: the cost of a call is the time to move its tensors at the
+    given memory bandwidth, which doesn't depend on the layout. Searching with it only
+    minimizes the transforms. Subclasses override :py:meth:`op_cost`, and possibly
+    :py:meth:`transform_cost`, with tuning records or measurements.
+
+    Parameters
+    ----------
+    bandwidth : float
+        The memory bandwidth in bytes per second.
+    """
+
+    def __init__(self, bandwidth: float = 100e9):
+        self.bandwidth = bandwidth
+
+    def traffic_cost(self, call: Call) -> float:
+        """The time to read the arguments of a call and write its result."""
+        total = 0
+        for sinfo in [arg.struct_info for arg in call.args] + [call.struct_info]:
+            nbytes = _nbytes(sinfo)
+            total += nbytes if nbytes is not None else 0
+        return total / self.bandwidth
+
+    def op_cost(self, call: Call) -> float:
+        """The cost of a call to an op whose layout is searched, in its converted layout."""
+        return self.traffic_cost(call)
+
+    def transform_cost(self, call: Call) -> float:
+        """The cost of a permute_dims or layout_transform inserted by ConvertLayout."""
+        return self.traffic_cost(call)
+
+
+class MeasuredLayoutCost(LayoutCostModel):
+    """Measure the cost of each call, compiled alone with the default pipeline of the target.
+
+    The measured calls must have static shapes. The others fall back to the analytic model.
+
+    Parameters
+    ----------
+    target : Union[str, Target]
+        The target to compile for.
+    dev : Optional[Device]
+        The device to measure on, that of the target by default.
+    number : int
+        The number of runs of each measurement.
+    repeat : int
+        The number of measurements, whose mean is the cost.
+    """
+
+    def __init__(self, target, dev=None, number: int = 10, repeat: int = 3, **kwargs):
+        super().__init__(**kwargs)
+        self.target = Target(target) if isinstance(target, str) else target
+        self.dev = dev if dev is not None else tvm.device(self.target.kind.name, 0)
+        self.number = number
+        self.repeat = repeat
+
+    def measure(self, call: Call) -> Optional[float]:
+        """Measure a call, None if it can't be compiled alone."""
+        mod = _call_workload(call)
+        if mod is None:
+            return None
+        args = []
+        for param in mod["main"].params:
+            shape = [dim.value for dim in param.struct_info.shape.values]
+            data = np.random.uniform(size=shape).astype(param.struct_info.dtype)
+            args.append(tvm.runtime.tensor(data, self.dev))
+        ex = tvm.compile(mod, self.target, relax_pipeline=relax.get_default_pipeline(self.target))
+        vm = relax.VirtualMachine(ex, self.dev)
+        timer = vm.time_evaluator("main", self.dev, number=self.number, repeat=self.repeat)
+        return timer(*args).mean
+
+    def _measure_or_estimate(self, call: Call) -> float:
+        if any(_nbytes(arg.struct_info) is None for arg in call.args):
+            return self.traffic_cost(call)
+        cost = self.measure(call)
+        return cost if cost is not None else self.traffic_cost(call)
+
+    def op_cost(self, call: Call) -> float:
+        return self._measure_or_estimate(call)
+
+    def transform_cost(self, call: Call) -> float:
+        return self._measure_or_estimate(call)
+
+
+class DatabaseLayoutCost(LayoutCostModel):
+    """Look the cost of each call up in a meta-schedule tuning database.
+
+    A call is legalized alone, and its PrimFunc is queried as a workload of the database. The
+    calls without a record, as well as the transforms, use the fallback model.
+
+    Parameters
+    ----------
+    database : tvm.meta_schedule.Database
+        The tuning database, e.g. from tuning the candidate layouts with MetaScheduleTuneIRMod.
+    target : Union[str, Target]
+        The target of the records.
+    fallback : Optional[LayoutCostModel]
+        The model of the calls without a record, the analytic one by default.
+    """
+
+    def __init__(self, database, target, fallback: Optional[LayoutCostModel] = None):
+        super().__init__()
+        self.database = database
+        self.target = Target(target) if isinstance(target, str) else target
+        self.fallback = fallback if fallback is not None else LayoutCostModel()
+
+    def lookup(self, call: Call) -> Optional[float]:
+        """The mean run time of the record of a call, None if there is none."""
+        # pylint: disable=import-outside-toplevel
+        from tvm.meta_schedule.tune_context import _normalize_mod
+
+        mod = _call_workload(call)
+        if mod is None:
+            return None
+        prim_funcs = [
+            func for func in LegalizeOps()(mod).functions.values() if isinstance(func, tir.PrimFunc)
+        ]
+        if len(prim_funcs) != 1:
+            return None
+        record = self.database.query_tuning_record(
+            _normalize_mod(prim_funcs[0]), self.target, "main"
+        )
+        if record is None or not record.run_secs:
+            return None
+        return float(np.mean([float(secs) for secs in record.run_secs]))
+
+    def op_cost(self, call: Call) -> float:
+        cost = self.lookup(call)
+        return cost if cost is not None else self.fallback.op_cost(call)
+
+    def transform_cost(self, call: Call) -> float:
+        return self.fallback.transform_cost(call)
+
+
+@function_pass(opt_level=0, name="SearchLayout")
+class SearchLayout:
+    """Choose the layout of each layout-sensitive call by minimizing a cost model, and convert
+    the layouts accordingly with ConvertLayout.
+
+    Each call to an op of ``candidate_layouts`` either follows the layout of its input, as with
+    ConvertLayout without a desired layout, or takes one of the candidate layouts of its op. An
+    assignment of the choices is evaluated by running ConvertLayout with it and summing the cost
+    of the converted calls and of the transforms ConvertLayout inserted at the boundaries. The
+    transforms of constants, and of the weights of a function with a ``num_input`` attribute,
+    are free, since they are folded or lifted out of the function.
+
+    The search starts from the best of the uniform assignments, which take the same choice for
+    all the calls, and improves it one call at a time until no change lowers the total cost.
+
+    Parameters
+    ----------
+    candidate_layouts : Dict[str, List[List[str]]]
+        The candidate desired layouts of each op, in the format of the desired layouts of
+        ConvertLayout, e.g.
+        ``{"relax.nn.conv2d": [["NHWC", "OHWI"], ["NCHW4c", "OIHW4o"]]}``.
+    cost_model : Optional[LayoutCostModel]
+        The cost model, e.g. :py:class:`MeasuredLayoutCost` or :py:class:`DatabaseLayoutCost`.
+        It is the analytic model by default.
+    max_rounds : int
+        The maximum number of rounds of improvement over all the calls.
+    """
+
+    def __init__(
+        self,
+        candidate_layouts: Dict[str, List[List[str]]],
+        cost_model: Optional[LayoutCostModel] = None,
+        max_rounds: int = 4,
+    ):
+        self.candidate_layouts = {
+            op: [list(layouts) for layouts in candidates]
+            for op, candidates in candidate_layouts.items()
+        }
+        self.cost_model = cost_model if cost_model is not None else LayoutCostModel()
+        self.max_rounds = max_rounds
+        self._cost_cache: Dict[Tuple, float] = {}
+
+    def transform_function(self, func: Function, mod: IRModule, ctx: PassContext) -> Function:
+        """Search the layouts of a function and convert it."""
+        if func.attrs is not None and "Primitive" in func.attrs:
+            return func
+        anchors = self._collect_anchors(func)
+        if not anchors:
+            return func
+        # The choice 0 follows the input layout, the others are the candidates of the op.
+        choices = [[None] + self.candidate_layouts[anchor.op.name] for anchor in anchors]
+
+        best, best_cost = None, math.inf
+        for k in range(max(len(c) for c in choices)):
+            assignment = [min(k, len(c) - 1) for c in choices]
+            cost = self._evaluate(func, anchors, choices, assignment)
+            if cost < best_cost:
+                best, best_cost = assignment, cost
+
+        for _ in range(self.max_rounds):
+            improved = False
+            for i, choice in enumerate(choices):
+                for j in range(len(choice)):
+                    if j == best[i]:
+                        continue
+                    assignment = list(best)
+                    assignment[i] = j
+                    cost = self._evaluate(func, anchors, choices, assignment)
+                    if cost < best_cost:
+                        best, best_cost = assignment, cost
+                        improved = True
+            if not improved:
+                break
+
+        logger.info(
+            "SearchLayout: chose %s at an estimated cost of %.3es",
+            [choice[idx] for choice, idx in zip(choices, best)],
+            best_cost,
+        )
+        return self._convert(func, anchors, choices, best)
+
+    def _collect_anchors(self, func: Function) -> List[Call]:
+        anchors = []
+
+        def fvisit(expr):
+            if (
+                isinstance(expr, Call)
+                and isinstance(expr.op, Op)
+                and expr.op.name in self.candidate_layouts
+            ):
+                anchors.append(expr)
+
+        relax.analysis.post_order_visit(func, fvisit)
+        return anchors
+
+    def _convert(
+        self,
+        func: Function,
+        anchors: Sequence[Call],
+        choices: Sequence[List],
+        assignment: Sequence[int],
+    ) -> Function:
+        def layout_cb(call: Call):
+            for anchor, choice, idx in zip(anchors, choices, assignment):
+                if anchor.same_as(call) and choice[idx] is not None:
+                    return {call.op.name: choice[idx]}
+            return {}
+
+        return ConvertLayout({}, layout_cb)(IRModule({"main": func}))["main"]
+
+    def _evaluate(
+        self,
+        func: Function,
+        anchors: Sequence[Call],
+        choices: Sequence[List],
+        assignment: Sequence[int],
+    ) -> float:
+        converted = self._convert(func, anchors, choices, assignment)
+        num_input = (
+            int(converted.attrs["num_input"])
+            if converted.attrs is not None and "num_input" in converted.attrs
+            else len(converted.params)
+        )
+        weights = list(converted.params[num_input:])
+        total = 0.0
+
+        def fvisit(expr):
+            nonlocal total
+            if not isinstance(expr, Call) or not isinstance(expr.op, Op):
+                return
+            if expr.op.name in _TRANSFORM_OPS:
+                arg = expr.args[0]
+                if isinstance(arg, Constant) or any(arg.same_as(w) for w in weights):
+                    return
+                total += self._cost(expr, self.cost_model.transform_cost)
+            elif expr.op.name in self.candidate_layouts:
+                total += self._cost(expr, self.cost_model.op_cost)
+
+        relax.analysis.post_order_visit(converted.body, fvisit)
+        return total
+
+    def _cost(self, call: Call, fcost) -> float:
+        key = (
+            call.op.name,
+            tvm.ir.structural_hash(call.attrs) if call.attrs is not None else 0,
+            tuple(tvm.ir.structural_hash(arg.struct_info) for arg in call.args),
+        )
+        if key not in self._cost_cache:
+            self._cost_cache[key] = float(fcost(call))
+        return self._cost_cache[key]
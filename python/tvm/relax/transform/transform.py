@@ -225,6 +225,34 @@ def Gradient(
     return _ffi_api.Gradient(func_name, require_grads, target_index)  # type: ignore
 
 
+def AutoCheckpoint(func_name: str, memory_budget: int) -> tvm.ir.transform.Pass:
+    """Pick the forward activations kept for the backward pass under a memory budget.
+
+    The other activations are annotated with `R.grad.start_checkpoint` and
+    `R.grad.end_checkpoint`, so that the :py:func:`Gradient` pass applied afterwards recomputes
+    them in the backward pass instead of keeping them alive, trading compute for memory.
+
+    The activations are picked greedily by segments of consecutive bindings. The peak activation
+    memory is estimated by the bytes of the kept activations plus the largest recomputed segment.
+    Tensors of symbolic shapes are always kept and are not counted in the budget. A function
+    already annotated with checkpoints is left unchanged.
+
+    Parameters
+    ----------
+    func_name : str
+        The name of the function to be differentiated. It must have only one dataflow block.
+
+    memory_budget : int
+        The budget of the activations kept for the backward pass, in bytes.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.AutoCheckpoint(func_name, memory_budget)  # type: ignore
+
+
 def ToNonDataflow() -> tvm.ir.transform.Pass:
     """Transform all dataflow structure to non-dataflow version.
 
@@ -531,6 +559,16 @@ def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     signature will have upper bound 1024. And we will use 1024 as its value
     during memory planning.
 
+    By default, a storage is reused as a whole by a later tensor of no larger
+    size. With the pass config :code:`"relax.StaticPlanBlockMemory.mode"` set
+    to :code:`"offset"`, the constant-sized tensors of each binding block are
+    instead packed into a single storage per device at different byte offsets,
+    according to their lifetimes, so that several small tensors can share the
+    space of a larger one. The tensors whose sizes remain symbolic after
+    applying the upper bounds are packed too, at symbolic offsets computed at
+    runtime. A function can choose its mode with the attribute
+    :code:`"relax.memory_plan_mode"`, which overrides the pass config.
+
     Returns
     -------
     ret : tvm.ir.transform.Pass
@@ -611,7 +649,9 @@ def VMBuiltinLower() -> tvm.ir.transform.Pass:
     return _ffi_api.LowerRuntimeBuiltin()  # type: ignore
 
 
-def VMShapeLower(*, emit_err_ctx: bool = True) -> tvm.ir.transform.Pass:
+def VMShapeLower(
+    *, emit_err_ctx: bool = True, fuse_checks: bool = False
+) -> tvm.ir.transform.Pass:
     """Lower the symbolic shape and argument and match-cast structinfo matching.
 
     Parameters
@@ -619,11 +659,20 @@ def VMShapeLower(*, emit_err_ctx: bool = True) -> tvm.ir.transform.Pass:
     emit_err_ctx: Optional[bool]
         Whether emit err context string, can be turned off for testing purposes.
 
+    fuse_checks: Optional[bool]
+        Whether to check the tensor parameters of each function in a single generated
+        PrimFunc, instead of one builtin call per check, and to skip the match-cast checks
+        that the struct info of the matched values already proves. Can also be enabled
+        with the ``relax.VMShapeLower.fuse_checks`` pass config.
+
+        The PrimFunc reads the parameters as ``DLTensor`` handles, so it does not diagnose
+        a non-tensor argument passed for a tensor parameter.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
     """
-    return _ffi_api.VMShapeLower(emit_err_ctx)  # type: ignore
+    return _ffi_api.VMShapeLower(emit_err_ctx, fuse_checks)  # type: ignore
 
 
 def AttachGlobalSymbol() -> tvm.ir.transform.Pass:
@@ -636,6 +685,21 @@ def AttachGlobalSymbol() -> tvm.ir.transform.Pass:
     return _ffi_api.AttachGlobalSymbol()  # type: ignore
 
 
+def DeduplicatePrimFuncs() -> tvm.ir.transform.Pass:
+    """Keep a single PrimFunc of each group of structurally equal private PrimFuncs, and
+    redirect the calls of the others to it.
+
+    The PrimFuncs produced per call site by LegalizeOps and FuseTIR are often identical across
+    the layers of a model, so merging them before codegen compiles each kernel once. The
+    PrimFuncs that have a global symbol are left as is, since they may be called by their name.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.DeduplicatePrimFuncs()  # type: ignore
+
+
 def BindParams(
     func_name: str,
     params: Dict[Union[str, Var], Union[tvm.runtime.Tensor, np.ndarray]],
@@ -728,6 +792,10 @@ def FoldConstant() -> tvm.ir.transform.Pass:
 
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
+    The PrimFuncs a function may fold are built together into one module, and the results are
+    cached by the structural hash of the PrimFunc and the contents of its arguments, so the
+    repeated constant subgraphs are evaluated once. The cache lives as long as the pass object.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
@@ -795,6 +863,17 @@ def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
 
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
+    The fusions allowed by the op pattern rules are limited by the pass config
+    :code:`"relax.FuseOps.max_depth"`. Alternatively, the pass config :code:`"relax.FuseOps.policy"`
+    selects a policy that decides each of them:
+
+    - :code:`"cost_model"` estimates the run time of the kernels before and after fusion with a
+      roofline model of the current target, from the FLOPs of the PrimFuncs and the bytes of the
+      tensors they read and write.
+    - Any other value names a global function, called with a dict of the candidate (``src``,
+      ``sink``, ``num_nodes``, ``num_groups``, ``flops``, ``unfused_bytes``, ``fused_bytes``)
+      and returning whether to fuse. It can for instance consult a tuning database.
+
     Parameters
     ----------
     fuse_opt_level : int
@@ -1388,6 +1467,11 @@ def ConvertLayout(
     -------
     ret : tvm.transform.Pass
         The registered pass for layout conversion.
+
+    Note
+    ----
+    To choose the desired layout of each call among candidates with a cost model, use
+    :py:class:`tvm.relax.transform.SearchLayout`.
     """
     return _ffi_api.ConvertLayout(desired_layouts, layout_cb)  # type: ignore
 
@@ -1423,7 +1507,11 @@ def DeadCodeElimination(entry_functions: Optional[List[str]] = None) -> tvm.ir.t
 
 
 def ToMixedPrecision(
-    out_dtype="float32", fp16_input_names: Optional[List[str]] = None
+    out_dtype="float32",
+    fp16_input_names: Optional[List[str]] = None,
+    fp8_dtype: Optional[str] = None,
+    fp8_scaling: str = "tensor",
+    fp8_amax: Optional[Dict[str, float]] = None,
 ) -> tvm.ir.transform.Pass:
     """Automatic mixed precision pass. Currently the pass assumes the input module to be fp32
     only, and will automatically cast fp32 to fp16 for certain ops.
@@ -1437,13 +1525,28 @@ def ToMixedPrecision(
     fp16_input_names : List[str]
         The names of function parameters whose dtype should become fp16. The  function signature
         would change accordingly.
+    fp8_dtype : Optional[str]
+        If set to "float8_e4m3fn" or "float8_e5m2", the inputs of the matmuls are quantized to
+        this dtype instead of being cast to fp16, and the output of each matmul is dequantized
+        by the product of the scales of its inputs. The scale of an input is its amax divided by
+        the largest value of the fp8 dtype. With per-tensor scales and a transposed weight, the
+        result is the pattern of the scaled fp8 gemms of cuBLAS, see ``partition_for_cublas``.
+    fp8_scaling : str
+        The granularity of the fp8 scales: "tensor", or "channel" for one scale per row of the
+        lhs and per output channel of the rhs.
+    fp8_amax : Optional[Dict[str, float]]
+        The amax of the matmul inputs recorded in calibration, by var name, for delayed
+        scaling. The inputs without one, and all of them with per-channel scales, use the
+        amax of the current tensor.
 
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for mixed precision.
     """
-    return _ffi_api.ToMixedPrecision(out_dtype, fp16_input_names)  # type: ignore
+    return _ffi_api.ToMixedPrecision(  # type: ignore
+        out_dtype, fp16_input_names, fp8_dtype, fp8_scaling, fp8_amax
+    )
 
 
 def SplitCallTIRByPattern(patterns: List[PrimFunc], fcodegen: Callable) -> tvm.ir.transform.Pass:
@@ -1601,6 +1704,122 @@ def RewriteCUDAGraph() -> tvm.ir.transform.Pass:
     return _ffi_api.RewriteCUDAGraph()  # type: ignore
 
 
+def ScheduleAsyncAllReduce() -> tvm.ir.transform.Pass:
+    """Split each `ccl.allreduce` in dataflow blocks into `ccl.allreduce_start` and
+    `ccl.allreduce_wait`, and sink the wait to the first use of the allreduce result.
+
+    The allreduce runs on a dedicated communication stream, so the compute scheduled between
+    the start and the wait, e.g. the next matmul of a tensor-parallel layer, hides its latency.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for scheduling asynchronous allreduce.
+    """
+    return _ffi_api.ScheduleAsyncAllReduce()  # type: ignore
+
+
+def DecomposeCollectiveMatmul(num_chunks: int = 4) -> tvm.ir.transform.Pass:
+    """Decompose each `ccl.allreduce` of the output of a matmul, as in the row-parallel linear
+    layers of tensor parallelism, into chunks of the rows of the matmul.
+
+    The rows of the left operand are split into `num_chunks`, and the allreduce of each chunk is
+    started by `ccl.allreduce_start` right after its matmul. The communication stream reduces a
+    chunk while the compute stream runs the matmul of the next one, so only the allreduce of the
+    last chunk is exposed. The reduced chunks are concatenated back after the waits. Matmuls whose
+    rows are not static or do not split evenly are left unchanged.
+
+    Parameters
+    ----------
+    num_chunks: int
+        The number of chunks the rows of the matmul are split into.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for decomposing collective matmuls.
+    """
+    return _ffi_api.DecomposeCollectiveMatmul(num_chunks)  # type: ignore
+
+
+def ScheduleAsyncExternCalls(num_streams: int = 2) -> tvm.ir.transform.Pass:
+    """Run the calls to the functions of the external modules, e.g. the BYOC regions produced
+    by `RunCodegen`, on side streams, and wait for their results right before their first use.
+
+    Each call is started through `vm.builtin.external_call_async`, which makes a side stream wait
+    for the prior work of the current stream and runs the external function with the side stream
+    as the current stream of the device. The matching `relax.external_call_wait` makes the current
+    stream wait for the side stream, and keeps the inputs of the call alive until then for the
+    memory planning. Independent external regions thereby overlap with each other and with the
+    kernels in between.
+
+    Parameters
+    ----------
+    num_streams: int
+        The number of side streams the external calls in flight rotate over.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for scheduling asynchronous external calls.
+    """
+    return _ffi_api.ScheduleAsyncExternCalls(num_streams)  # type: ignore
+
+
+def HorizontalFuseTIR(
+    max_num_blocks: int = 256, max_group_size: int = 16
+) -> tvm.ir.transform.Pass:
+    """Combine independent `call_tir`s in dataflow blocks into a single kernel launch.
+
+    Each PrimFunc must already be scheduled for CUDA or ROCm, e.g. by dlight, as one kernel with a
+    static one-dimensional grid. Kernels with the same thread extents are combined into a new
+    PrimFunc, whose grid is the concatenation of their grids: the i-th kernel runs on the i-th
+    range of `blockIdx.x`. Many tiny kernels, such as per-head norms and gates, then pay the
+    launch latency once.
+
+    A call is combined only with calls it does not depend on. The combined call is placed before
+    the first binding that uses any of its results.
+
+    Parameters
+    ----------
+    max_num_blocks : int
+        The largest grid of a kernel to combine. Larger kernels already occupy the device.
+
+    max_group_size : int
+        The maximum number of kernels combined into one launch.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for horizontal fusion.
+    """
+    return _ffi_api.HorizontalFuseTIR(max_num_blocks, max_group_size)  # type: ignore
+
+
+def FusePersistentKernel(max_num_blocks: int = 128) -> tvm.ir.transform.Pass:
+    """Fuse sequences of `call_tir`s in dataflow blocks into one persistent CUDA kernel.
+
+    This is an experimental lowering for latency-bound workloads such as batch-1 decode, where
+    launching a kernel per op dominates the run time. Each PrimFunc must already be scheduled as
+    one kernel with a static one-dimensional grid, and the kernels of a sequence must have the
+    same thread extents. The stages of the persistent kernel run one after another on the same
+    grid, striding over their own grid when it is larger. A stage that reads the result of an
+    earlier stage waits at a grid-wide barrier first.
+
+    Parameters
+    ----------
+    max_num_blocks : int
+        The upper bound of the persistent grid. The grid-wide barrier spins until all blocks
+        arrive, so all blocks must be resident on the device at once.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for persistent kernel fusion.
+    """
+    return _ffi_api.FusePersistentKernel(max_num_blocks)  # type: ignore
+
+
 def AllocateWorkspace() -> tvm.ir.transform.Pass:
     """Allocate a workspace, represented by a tensor of size big enough for all external
     functions that require a temporary storage, and append it to the arguments of external
@@ -1629,6 +1848,97 @@ def SpecializePrimFuncBasedOnCallSite() -> tvm.ir.transform.Pass:
     return _ffi_api.SpecializePrimFuncBasedOnCallSite()  # type: ignore
 
 
+def SpecializeCallTIRByShapeBucket(
+    buckets: Dict[str, List[int]], tune_online: bool = False
+) -> tvm.ir.transform.Pass:
+    """Specialize the kernels of call_tir for the shape buckets of symbolic variables, and
+    dispatch the calls to the variant of their bucket at runtime.
+
+    For each call_tir whose kernel has a bucketed variable in its buffer shapes, the kernel is
+    copied once per bucket with the upper bound of the bucket in its "tir_var_upper_bound"
+    attribute, so that each copy can be scheduled or tuned for the shapes of its bucket. The call
+    is rewritten into a call of "vm.builtin.shape_bucket_dispatch", which runs the variant of the
+    smallest bucket that holds the value of the variable, or the generic kernel beyond the last
+    bucket.
+
+    Parameters
+    ----------
+    buckets : Dict[str, List[int]]
+        The increasing upper bounds of the buckets of each symbolic variable, by the name of the
+        variable in the kernels.
+
+    tune_online : bool
+        Whether the dispatcher benchmarks the variants valid for a bucket on its first call, and
+        runs the fastest one for the later calls of the bucket.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.SpecializeCallTIRByShapeBucket(buckets, tune_online)  # type: ignore
+
+
+def SpecializeShapeBuckets(
+    buckets: Dict[str, List[int]], func_name: Optional[str] = None
+) -> tvm.ir.transform.Pass:
+    """Specialize Relax functions for the shape buckets of a symbolic variable of their
+    parameters, and make them dispatch to the static function of the bucket of each call.
+
+    Each function is cloned once per bucket with the variable bound to the upper bound of the
+    bucket, and once more with the variable left symbolic. The function itself becomes a
+    dispatcher, which pads the parameters with zeros along the variable up to the smallest bucket
+    holding its value, calls the static clone and slices the results back. The values beyond the
+    last bucket call the symbolic clone.
+
+    Only the variables that appear as the extents of tensor dimensions are bucketed, and the
+    padding must not change the unpadded part of the results, e.g. the variable is a batch
+    dimension. The pass is meant to run before legalization, so that the kernels of the static
+    clones are fused and tuned for their static shapes.
+
+    Parameters
+    ----------
+    buckets : Dict[str, List[int]]
+        The increasing upper bounds of the buckets of each symbolic variable, by name.
+
+    func_name : Optional[str]
+        The name of the only function to specialize. All Relax functions are specialized if not
+        given.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.SpecializeShapeBuckets(buckets, func_name)  # type: ignore
+
+
+def DispatchDynamicMatmulToLibrary(library: str) -> tvm.ir.transform.Pass:
+    """Dispatch the 2D matmuls of dynamic shapes to either their TIR kernel or a vendor library
+    at runtime.
+
+    The matmuls are legalized to their TIR kernel, and called through
+    ``vm.builtin.gemm_library_dispatch``, which runs the TIR kernel or
+    ``tvm.contrib.<library>.matmul``, whichever the GEMM dispatch table records as faster for
+    the bucket of the (M, N, K) shape. The table is measured once at deploy time after
+    ``vm.builtin.gemm_dispatch_table.set_measure(True)``, and saved next to the executable with
+    ``vm.builtin.gemm_dispatch_table.save`` to be loaded by the later runs with
+    ``vm.builtin.gemm_dispatch_table.load``. The buckets missing from the table run the TIR
+    kernel.
+
+    Parameters
+    ----------
+    library : str
+        The library, e.g. "cublas", "hipblas" or "rocblas".
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.DispatchDynamicMatmulToLibrary(library)  # type: ignore
+
+
 def _wrap_class_function_pass(pass_cls, pass_info):
     """Wrap a python class as function pass."""
 
@@ -64,8 +64,10 @@ def _vmcodegen(
     mod: IRModule
         The input IRModule to be built.
 
-    exec_mode: {"bytecode", "compiled"}
-        The execution mode.
+    exec_mode: {"bytecode", "compiled", "auto"}
+        The execution mode. "auto" compiles the functions with static control flow to TIR and
+        leaves the others to the bytecode interpreter, which the "relax.vm_exec_mode" attribute
+        of a function ("compiled" or "bytecode") overrides.
 
     Return
     ------
@@ -77,6 +79,8 @@ def _vmcodegen(
         return _ffi_api.VMCodeGen(builder, mod)  # type:ignore
     if exec_mode == "compiled":
         return _ffi_api.VMTIRCodeGen(builder, mod)  # type: ignore
+    if exec_mode == "auto":
+        return _ffi_api.VMAutoCodeGen(builder, mod)  # type: ignore
     raise ValueError(f"Unknown exec_mode {exec_mode}")
 
 
@@ -207,8 +211,10 @@ def build(
     tir_pipelinie : str = "default"
         The TIR compilation pipeline to use.
 
-    exec_mode: {"bytecode", "compiled"}
-        The execution mode.
+    exec_mode: {"bytecode", "compiled", "auto"}
+        The execution mode, "auto" selects "compiled" or "bytecode" per function: by their
+        "relax.vm_exec_mode" attribute when set, otherwise "compiled" for the functions with
+        static control flow.
 
     system_lib: Optional[bool]
         Whether to build system lib that is being packed statically and
@@ -247,27 +253,41 @@ def build(
     if not params:
         params = {}
 
-    if relax_pipeline is not None:
-        if isinstance(relax_pipeline, str):
-            relax_pipeline = relax.get_pipeline(relax_pipeline)
-        if target is None:
-            mod = relax_pipeline(mod)
-        else:
-            with target:
+    def _build(mod, relax_pipeline):
+        if relax_pipeline is not None:
+            if isinstance(relax_pipeline, str):
+                relax_pipeline = relax.get_pipeline(relax_pipeline)
+            if target is None:
                 mod = relax_pipeline(mod)
-
-    ext_libs, constants = _extract_attrs(mod)
-    params.update(dict(constants))
-    builder = relax.ExecBuilder()
-    mod = _vmcodegen(builder, mod, exec_mode)
-    return _vmlink(
-        builder=builder,
-        target=target,
-        tir_mod=_filter_tir(mod),
-        tir_pipeline=tir_pipeline,
-        ext_libs=ext_libs,
+            else:
+                with target:
+                    mod = relax_pipeline(mod)
+
+        ext_libs, constants = _extract_attrs(mod)
+        params.update(dict(constants))
+        builder = relax.ExecBuilder()
+        mod = _vmcodegen(builder, mod, exec_mode)
+        return _vmlink(
+            builder=builder,
+            target=target,
+            tir_mod=_filter_tir(mod),
+            tir_pipeline=tir_pipeline,
+            ext_libs=ext_libs,
+            params=params,
+            system_lib=system_lib,
+        )
+
+    from tvm.driver import compile_cache  # pylint: disable=import-outside-toplevel
+
+    # The builds with a custom pipeline are not cached, since a pass has no stable key.
+    return compile_cache.cached_build(
+        "relax",
+        mod,
+        target,
+        [relax_pipeline, tir_pipeline, exec_mode, system_lib],
+        lambda: _build(mod, relax_pipeline),
+        VMExecutable,
         params=params,
-        system_lib=system_lib,
     )
 
 
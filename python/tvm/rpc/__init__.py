@@ -32,5 +32,5 @@ full remote code execution capabilities to anyone who can access this API.
 
 from .server import Server
 from .client import connect, connect_tracker
-from .client import RPCSession, LocalSession, PopenSession, TrackerSession
+from .client import RPCSession, RPCFuture, LocalSession, PopenSession, TrackerSession
 from .minrpc import with_minrpc
@@ -32,6 +32,38 @@ from tvm.contrib import utils
 from . import _ffi_api, base, server
 
 
+class RPCFuture(object):
+    """The pending result of a request sent by one of the async methods of RPCSession.
+
+    Do not directly create the object, call RPCSession.call_async,
+    RPCSession.copyfrom_async or RPCSession.copyto_async
+    """
+
+    def __init__(self, fwait):
+        self._fwait = fwait
+        self._done = False
+        self._result = None
+
+    def wait(self):
+        """Wait for the request and the requests sent before it.
+
+        Returns
+        -------
+        result : object
+            The return value of the call, None for a copy.
+
+        Raises
+        ------
+        TVMError
+            If the request, or an earlier request whose error is not raised yet, failed.
+        """
+        if not self._done:
+            self._result = self._fwait()
+            self._done = True
+            self._fwait = None
+        return self._result
+
+
 class RPCSession(object):
     """RPC Client session module
 
@@ -93,6 +125,114 @@ class RPCSession(object):
         dev._rpc_sess = self
         return dev
 
+    def call_async(self, func, *args):
+        """Call a remote function without waiting for its return.
+
+        The remote handles the requests in the order they are sent, so several
+        calls and copies can be in flight, e.g. to pipeline the uploads, the
+        runs of a time evaluator and the downloads.
+
+        Parameters
+        ----------
+        func : Function
+            The remote function, obtained from this session.
+
+        args : list
+            The arguments of the call.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the return value.
+        """
+        return RPCFuture(_ffi_api.CallAsync(func, *args))
+
+    def copyfrom_async(self, tensor, source):
+        """Copy a local tensor into a remote tensor without waiting for the copy.
+
+        The source is sent before the method returns, so it can be modified right away.
+
+        Parameters
+        ----------
+        tensor : Tensor
+            The remote tensor.
+
+        source : Tensor or numpy.ndarray
+            The local source, of the same shape and dtype.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the copy.
+        """
+        if not isinstance(source, tvm.runtime.Tensor):
+            source = tvm.runtime.tensor(source)
+        return RPCFuture(_ffi_api.CopyToRemoteAsync(source, tensor))
+
+    def copyto_async(self, tensor, target):
+        """Copy a remote tensor into a local CPU tensor without waiting for the copy.
+
+        Parameters
+        ----------
+        tensor : Tensor
+            The remote tensor.
+
+        target : Tensor
+            The local CPU target, of the same shape and dtype. Its content is
+            only valid after the future is waited for.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the copy.
+        """
+        return RPCFuture(_ffi_api.CopyFromRemoteAsync(tensor, target))
+
+    def enable_compression(self, codec="zstd", threshold=1 << 20, level=1):
+        """Compress the tensor copies of this session that are large enough.
+
+        Compression pays off on slow links, e.g. for weights with many zeros,
+        at the cost of the CPU time to compress and decompress the payloads.
+        Both sides must have the codec, e.g. zstd requires building TVM with
+        USE_ZSTD, else a ValueError is raised.
+
+        Parameters
+        ----------
+        codec : str, optional
+            The name of the codec, or None to disable the compression.
+
+        threshold : int, optional
+            The minimum size in bytes of a compressed copy.
+
+        level : int, optional
+            The compression level passed to the codec.
+        """
+        _ffi_api.SessEnableCompression(self._sess, codec or "", threshold, level)
+
+    def enable_windowed_copy(self, window=8, block_size=0, verify_crc=False):
+        """Keep several blocks of each tensor copy of this session in flight.
+
+        A copy is split into blocks that fit in the max packet size of the
+        remote, e.g. a microcontroller, and by default the client waits for each
+        block before sending the next one. With a window, the blocks are sent
+        back to back and only the oldest one is waited for once the window is
+        full, so the latency of the link is paid once per copy.
+
+        Parameters
+        ----------
+        window : int, optional
+            The max number of blocks in flight, 1 to wait for each block.
+
+        block_size : int, optional
+            The max size of a block in bytes, or 0 for the max packet size of the
+            remote.
+
+        verify_crc : bool, optional
+            Whether to check the CRC-32 of each copy on the remote once it is
+            done, raising an error when the copy was corrupted.
+        """
+        _ffi_api.SessEnableWindowedCopy(self._sess, window, block_size, verify_crc)
+
     def upload(self, data, target=None):
         """Upload file to remote runtime temp folder
 
@@ -21,7 +21,7 @@ with the distributed runtime.
 import logging
 import os
 import pickle
-from typing import Any, Callable, Optional, Sequence, Union
+from typing import Any, Callable, List, Optional, Sequence, Union
 
 import numpy as np
 
@@ -222,6 +222,49 @@ class Session(Object):
         """
         return _ffi_api.SessionCallPacked(self, 0, 0, func, *args)  # type: ignore # pylint: disable=no-member
 
+    def begin_command_buffer(self, num_placeholders: int = 0) -> List[DRef]:
+        """Start recording a command buffer. Until `end_command_buffer` is called, the calls
+        issued via `call_packed` are recorded instead of being sent to the workers.
+
+        Copies to or from worker-0 and syncs cannot be recorded. Global functions are still
+        fetched immediately.
+
+        Parameters
+        ----------
+        num_placeholders : int
+            The number of placeholder registers, whose values are provided by each replay.
+
+        Returns
+        -------
+        placeholders : List[DRef]
+            The placeholder registers, which can be used as arguments of the recorded calls.
+        """
+        return list(_ffi_api.SessionBeginCommandBuffer(self, num_placeholders))  # type: ignore # pylint: disable=no-member
+
+    def end_command_buffer(self) -> DRef:
+        """Finish recording a command buffer and ship it to all workers.
+
+        Returns
+        -------
+        command_buffer : DRef
+            The command buffer on workers. The return values of the recorded calls are
+            overwritten by each replay.
+        """
+        return _ffi_api.SessionEndCommandBuffer(self)  # type: ignore # pylint: disable=no-member
+
+    def replay_command_buffer(self, command_buffer: DRef, *values) -> None:
+        """Replay a command buffer on all workers with a single message.
+
+        Parameters
+        ----------
+        command_buffer : DRef
+            The command buffer returned by `end_command_buffer`.
+
+        *values : various types
+            The values of the placeholder registers, in the types supported by `call_packed`.
+        """
+        _ffi_api.SessionReplayCommandBuffer(self, command_buffer, *values)  # type: ignore # pylint: disable=no-member
+
     def _sync_worker(self, worker_id: int) -> None:
         """Synchronize the controller with a worker, and it will wait until the worker finishes
         executing all the existing instructions. This function is usually used for worker-0, because
@@ -521,6 +564,39 @@ class Session(Object):
         func = self._get_cached_method("runtime.disco.allgather")
         func(src, in_group, dst)
 
+    def alltoall(
+        self,
+        src: DRef,
+        dst: DRef,
+        send_splits: Optional[Sequence[int]] = None,
+        recv_splits: Optional[Sequence[int]] = None,
+        in_group: bool = True,
+    ) -> DRef:
+        """Perform an all-to-all operation on an array. The split i along the first axis of
+        `src` is sent to the worker i, and `dst` holds the splits received from each worker.
+
+        Parameters
+        ----------
+        src : DRef
+            The array to be split and sent.
+
+        dst : DRef
+            The array to receive the splits.
+
+        send_splits : Optional[Sequence[int]]
+            The number of rows of `src` sent to each worker, the same on all workers.
+            The rows are split evenly when it is None.
+
+        recv_splits : Optional[Sequence[int]]
+            The number of rows of `dst` received from each worker, the same on all workers.
+            The rows are split evenly when it is None.
+
+        in_group : bool
+            Whether the all-to-all operation performs globally or in group as default.
+        """
+        func = self._get_cached_method("runtime.disco.alltoall")
+        func(src, ShapeTuple(send_splits or []), ShapeTuple(recv_splits or []), in_group, dst)
+
     def _clear_ipc_memory_pool(self):
         # Clear the IPC memory allocator when the allocator exists.
         name = "runtime.disco.cuda_ipc.cuda_ipc_memory_allocator_clear"
@@ -530,26 +606,55 @@ class Session(Object):
 
 @register_object("runtime.disco.ThreadedSession")
 class ThreadedSession(Session):
-    """A Disco session backed by multi-threading."""
+    """A Disco session backed by multi-threading.
 
-    def __init__(self, num_workers: int, num_groups: int = 1) -> None:
+    Parameters
+    ----------
+    num_workers : int
+        The number of workers.
+    num_groups : int
+        The number of worker groups.
+    queue : str
+        The queue of the messages between the threads. "mutex" guards a ring buffer with a mutex
+        and wakes up the receiver for each message, while "spin" uses lock-free rings that the
+        receivers spin on before they park, which saves the wakeups on the critical path of
+        frequent broadcasts at the cost of busy worker threads.
+    """
+
+    def __init__(self, num_workers: int, num_groups: int = 1, queue: str = "mutex") -> None:
         """Create a disco session backed by multiple threads in the same process."""
         self.__init_handle_by_constructor__(
             _ffi_api.SessionThreaded,  # type: ignore # pylint: disable=no-member
             num_workers,
             num_groups,
+            queue,
         )
 
 
 @register_object("runtime.disco.ProcessSession")
 class ProcessSession(Session):
-    """A Disco session backed by pipe-based multi-processing."""
+    """A Disco session backed by pipe-based multi-processing.
+
+    Parameters
+    ----------
+    num_workers : int
+        The number of workers.
+    num_groups : int
+        The number of worker groups.
+    entrypoint : str
+        The module that runs the main function of the worker processes.
+    channel : str
+        The channel to the worker processes. "pipe" sends the commands through the pipes
+        of the processes, while "shm" sends them through shared memory rings, which avoids
+        the system calls per command and is only supported on Linux.
+    """
 
     def __init__(
         self,
         num_workers: int,
         num_groups: int = 1,
         entrypoint: str = "tvm.exec.disco_worker",
+        channel: str = "pipe",
     ) -> None:
         self.__init_handle_by_constructor__(
             _ffi_api.SessionProcess,  # type: ignore # pylint: disable=no-member
@@ -557,6 +662,7 @@ class ProcessSession(Session):
             num_groups,
             "runtime.disco.create_process_pool",
             entrypoint,
+            channel,
         )
         self._configure_structlog()
 
@@ -16,7 +16,10 @@
 # under the License.
 """Registration of profiling objects in python."""
 
-from typing import Dict, Sequence, Optional
+import json
+import math
+import struct
+from typing import Dict, Sequence, Optional, Tuple
 from ... import ffi as _ffi
 from . import _ffi_api
 from .. import Object, Device
@@ -270,6 +273,191 @@ def profile_function(mod, dev, collectors, func_name=None, warmup_iters=10):
     )
 
 
+def time_evaluate_batch(
+    mods,
+    dev: Device,
+    args_info: Sequence[Sequence[Tuple[Sequence[int], str]]],
+    func_names: Optional[Sequence[str]] = None,
+    number: int = 10,
+    repeat: int = 1,
+    min_repeat_ms: int = 0,
+    cache_flush_bytes: int = 0,
+    f_preproc: str = "",
+    session=None,
+):
+    """Measure a batch of functions on a device in one call, e.g. one round trip over RPC.
+
+    The arguments are allocated on the device once per signature and shared by the functions
+    with that signature. The repeats are interleaved: each round runs every function once,
+    starting from a different one each round, so that a drift of the device biases each
+    function alike.
+
+    Parameters
+    ----------
+    mods : Sequence[Module]
+        The modules of the functions, remote modules of `session` when it is given.
+
+    dev : Device
+        The device to run on.
+
+    args_info : Sequence[Sequence[Tuple[Sequence[int], str]]]
+        The (shape, dtype) of each tensor argument of each function.
+
+    func_names : Optional[Sequence[str]]
+        The name of each function in its module, the entry function of the module by default.
+
+    number : int
+        The number of runs averaged in one repeat.
+
+    repeat : int
+        The number of repeats of each function.
+
+    min_repeat_ms : int
+        The minimum duration of one repeat in milliseconds, to which `number` is increased.
+
+    cache_flush_bytes : int
+        The number of bytes to flush from the cache before each repeat.
+
+    f_preproc : str
+        The name of the function run on the arguments before each repeat.
+
+    session : Optional[RPCSession]
+        The session of the remote modules.
+
+    Returns
+    -------
+    results : List[Optional[BenchmarkResult]]
+        The results of each function, or None for the functions that failed.
+    """
+    # pylint: disable=import-outside-toplevel
+    from ..device import RPC_SESS_MASK
+    from ..module import BenchmarkResult
+
+    if func_names is None:
+        func_names = [""] * len(mods)
+    # the functions are passed as (module, name, signature) triples, as RPC passes no lists
+    funcs = []
+    for mod, func_name, args in zip(mods, func_names, args_info):
+        signature = ";".join(
+            f"{dtype}:" + ",".join(str(int(dim)) for dim in shape) for shape, dtype in args
+        )
+        funcs += [mod, func_name, signature]
+    if session is None:
+        f_evaluate = _ffi_api.TimeEvaluateBatch
+    else:
+        f_evaluate = session.get_function("runtime.profiling.TimeEvaluateBatch")
+    blob = f_evaluate(
+        dev.dlpack_device_type() % RPC_SESS_MASK,
+        dev.index,
+        number,
+        repeat,
+        min_repeat_ms,
+        cache_flush_bytes,
+        f_preproc,
+        *funcs,
+    )
+    secs = struct.unpack("@" + "d" * (len(mods) * repeat), blob)
+    results = []
+    for i in range(len(mods)):
+        row = secs[i * repeat : (i + 1) * repeat]
+        results.append(None if any(math.isnan(sec) for sec in row) else BenchmarkResult(row))
+    return results
+
+
+def start_tracing(device_timers: bool = True, buffer_size: int = 1 << 16):
+    """Start recording a timeline of the VM calls, the kernels they launch and the collective
+    calls of disco, dropping the events recorded before.
+
+    Parameters
+    ----------
+    device_timers : bool
+        Whether to also time the events on their devices, which adds a timeline per device.
+
+    buffer_size : int
+        The maximum number of events recorded per thread, past which the events are dropped.
+    """
+    _ffi_api.StartTracing(device_timers, buffer_size)
+
+
+def stop_tracing():
+    """Stop recording the timeline."""
+    _ffi_api.StopTracing()
+
+
+def export_chrome_trace() -> str:
+    """Export the recorded timeline in the Chrome trace event format, which chrome://tracing and
+    Perfetto open.
+
+    Returns
+    -------
+    trace : str
+        The trace in JSON.
+    """
+    return str(_ffi_api.ExportChromeTrace())
+
+
+def merge_chrome_traces(traces: Sequence[str]) -> str:
+    """Merge the traces exported by several processes, e.g. the disco workers, into one timeline.
+    Each worker records its events under its worker id as the process id.
+
+    Parameters
+    ----------
+    traces : Sequence[str]
+        The traces exported by :py:func:`export_chrome_trace`.
+
+    Returns
+    -------
+    trace : str
+        The merged trace in JSON.
+    """
+    events = []
+    dropped = 0
+    for trace in traces:
+        data = json.loads(trace)
+        events.extend(data["traceEvents"])
+        dropped += data.get("otherData", {}).get("dropped_events", 0)
+    return json.dumps(
+        {
+            "traceEvents": events,
+            "displayTimeUnit": "ns",
+            "otherData": {"dropped_events": dropped},
+        }
+    )
+
+
+def enable_nvtx_ranges(enable: bool = True):
+    """Annotate each VM call, KV cache forward and disco action with an NVTX range named after
+    it, for the timelines of Nsight Systems. Setting the environment variable TVM_NVTX_RANGES=1
+    enables them from the start of the process. No-op if TVM is not built with USE_NVTX.
+
+    The setting is per process, so each disco worker process enables its ranges from the
+    environment it inherits.
+
+    Parameters
+    ----------
+    enable : bool
+        Whether to annotate the calls.
+    """
+    _ffi_api.SetNVTXRangesEnabled(enable)
+
+
+@_ffi.register_object("runtime.profiling.PerfEventMetricCollector")
+class PerfEventMetricCollector(MetricCollector):
+    """Collects the CPU hardware counters with perf_event_open, without PAPI."""
+
+    def __init__(self, events: Optional[Sequence[str]] = None):
+        """
+        Parameters
+        ----------
+        events : Optional[Sequence[str]]
+            The events to count: "cycles", "instructions", "cache-references",
+            "cache-misses", "branch-misses", or raw events of the PMU written as "r<hex>".
+            Cycles, instructions and cache misses are counted by default.
+        """
+        events = [] if events is None else list(events)
+        self.__init_handle_by_constructor__(_ffi_api.PerfEventMetricCollector, events)
+
+
 # We only enable this class when TVM is build with PAPI support
 if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is not None:
 
@@ -292,3 +480,31 @@ if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=T
             for dev, names in metric_names.items():
                 wrapped[DeviceWrapper(dev)] = names
             self.__init_handle_by_constructor__(_ffi_api.PAPIMetricCollector, wrapped)
+
+
+# We only enable this class when TVM is build with CUPTI support
+if _ffi.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is not None:
+
+    @_ffi.register_object("runtime.profiling.CUPTIMetricCollector")
+    class CUPTIMetricCollector(MetricCollector):
+        """Collects the metrics of the CUDA kernels of each call using the CUPTI profiling API.
+
+        Each call is profiled in a kernel replay session, which replays its kernels until all
+        the counters are read, so the collector slows the profiled run down. The collector
+        skips the "Total" rows of the report, as CUPTI sessions can't nest.
+        """
+
+        def __init__(self, metric_names: Optional[Sequence[str]] = None):
+            """
+            Parameters
+            ----------
+            metric_names : Optional[Sequence[str]]
+                The CUPTI metrics to collect, averaged over the kernels of a call. By default,
+                the DRAM bytes, the achieved occupancy and the tensor core utilization, from
+                which the report derives the arithmetic intensity "FLOP/Byte" of the calls with
+                known FLOPs and their "DRAM Bandwidth (%)" of the peak. The "Kernel Duration
+                (us)" of the kernels, without their replays, is always collected, and the
+                report derives the rates from it.
+            """
+            metric_names = [] if metric_names is None else list(metric_names)
+            self.__init_handle_by_constructor__(_ffi_api.CUPTIMetricCollector, metric_names)
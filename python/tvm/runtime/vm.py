@@ -16,6 +16,7 @@
 # under the License.
 # pylint: disable=invalid-name, redefined-builtin, no-else-return, consider-using-dict-items
 """The Relax virtual machine."""
+import json
 from enum import IntEnum
 from typing import Any, Callable, Dict, List, Optional, Tuple, Union
 from numbers import Number, Integral
@@ -41,6 +42,8 @@ class VirtualMachine(object):
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BEST_FIT_ALLOCATOR = 3
+    STREAM_ORDERED_ALLOCATOR = 4
 
     def __init__(
         self,
@@ -62,7 +65,9 @@ class VirtualMachine(object):
 
         memory_cfg : Optional[Union[str, Dict[Device, str]]]
             Config the type of memory allocator. The allocator type can be ["naive",
-            "pooled"]. If memory_cfg is None, all devices will use pooled allocator
+            "pooled", "best_fit", "stream_ordered"], where "stream_ordered" allocates and frees
+            on the current stream without synchronizing the device, and is available on CUDA.
+            If memory_cfg is None, all devices will use pooled allocator
             by default. If memory_cfg is string, all devices will use the specified
             allocator type. If memory_cfg is a dict, each device uses the allocator
             type specified in the dict, or pooled allocator if not specified in the
@@ -106,9 +111,13 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
+            assert memory_cfg in ["naive", "pooled", "best_fit", "stream_ordered"]
             if memory_cfg == "naive":
                 default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            elif memory_cfg == "best_fit":
+                default_alloc_type = VirtualMachine.BEST_FIT_ALLOCATOR
+            elif memory_cfg == "stream_ordered":
+                default_alloc_type = VirtualMachine.STREAM_ORDERED_ALLOCATOR
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -365,6 +374,150 @@ class VirtualMachine(object):
         """
         self._set_instrument(instrument)
 
+    def set_parallel_dispatch(self, enable: bool = True) -> None:
+        """Run the independent kernel calls of the VM functions concurrently.
+
+        The VM finds the straight-line runs of calls whose kernels do not depend on
+        each other, e.g. the parallel branches of a multi-tower model, and runs them
+        at the same time on the runtime thread pool. The other instructions still run
+        in order. Only CPU devices are supported, and the thread pool must support
+        nested launches, e.g. with TVM_THREAD_POOL_KIND=work_stealing, since the
+        kernels may launch parallel jobs themselves.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to enable the parallel dispatch.
+        """
+        self.module["set_parallel_dispatch"](enable)
+
+    def set_thread_pool_cpus(self, cpus: List[int]) -> None:
+        """Run the parallel jobs of this VM on a thread pool bound to the given CPUs.
+
+        The pool has one worker per CPU and is isolated from the thread pools of
+        the calling threads, so several VM instances of a process can run on
+        disjoint sets of cores without oversubscribing them. The calling thread
+        is bound to the CPUs while it runs a function of the VM.
+
+        Parameters
+        ----------
+        cpus : List[int]
+            The CPU ids of the pool, or an empty list to use the thread pool of
+            the calling thread again.
+        """
+        self.module["set_thread_pool_cpus"](tvm.runtime.ShapeTuple(cpus))
+
+    def set_call_sampling(self, sample_every: int = 100) -> None:
+        """Time one in every `sample_every` calls of each function into a latency histogram.
+
+        Unlike :py:func:`set_instrument`, the sampling runs natively and only
+        reads a clock on the sampled calls, so it is cheap enough to leave on in
+        production. The first call of each function is always sampled. The calls
+        on a device other than the CPU are timed on the device without
+        synchronizing it. The calls run concurrently by the parallel dispatch are
+        not sampled. Setting the sampling again clears the samples.
+
+        Parameters
+        ----------
+        sample_every : int
+            The sampling period, or 0 to stop sampling.
+        """
+        tvm.get_global_func("vm.builtin.set_call_sampling")(self.module, sample_every)
+
+    def get_call_sampling_report(self) -> Dict[str, Dict[str, Any]]:
+        """Get the latency statistics of the functions sampled so far.
+
+        Returns
+        -------
+        report : Dict[str, Dict[str, Any]]
+            For each function sampled, the number of its calls ("calls"), of its
+            samples ("samples"), and its mean, p50, p90, p99 and max latency in
+            microseconds ("mean_us", "p50_us", "p90_us", "p99_us", "max_us").
+        """
+        report = tvm.get_global_func("vm.builtin.get_call_sampling_report")(self.module)
+        return {str(name): dict(stats.items()) for name, stats in report.items()}
+
+    def set_cuda_graph_max_num_graphs(self, max_num_graphs: int) -> None:
+        """Bound the number of CUDA graphs instantiated by the VM at the same time.
+
+        When the bound is reached, capturing a new graph evicts the least recently
+        used one, whose instantiated graph is updated in place when the topology
+        of the two graphs is compatible.
+
+        Parameters
+        ----------
+        max_num_graphs : int
+            The maximum number of instantiated graphs. Non-positive values mean no limit.
+        """
+        tvm.get_global_func("vm.builtin.cuda_graph.set_max_num_graphs")(
+            self.module, max_num_graphs
+        )
+
+    def prewarm_cuda_graph(self, shape_buckets: List[Tuple[int, ...]]) -> None:
+        """Declare the values of symbolic variables to capture CUDA graphs for ahead of time.
+
+        Every CUDA graph capture function that depends on the same number of
+        symbolic variables is captured for each declared shape bucket, either
+        immediately if the function has run before, or right after its first run.
+
+        Parameters
+        ----------
+        shape_buckets : List[Tuple[int, ...]]
+            The values of the symbolic variables of each bucket.
+        """
+        tvm.get_global_func("vm.builtin.cuda_graph.prewarm")(
+            self.module, [tvm.runtime.ShapeTuple(shape) for shape in shape_buckets]
+        )
+
+    def warmup_cuda_graph(
+        self, manifest_path: str, func_name: Optional[str] = None, *args: Any
+    ) -> int:
+        """Capture the CUDA graphs listed in a warmup manifest ahead of serving traffic.
+
+        The manifest is a JSON file of the form ``{"shape_buckets": [[1], [2], [4]]}``,
+        which can be produced by :py:func:`save_cuda_graph_warmup_manifest`. Since the
+        capture functions and their static arguments are only known after a function
+        runs once, a function and its arguments can be given to run right away, e.g., a
+        dummy request issued during readiness probing.
+
+        Parameters
+        ----------
+        manifest_path : str
+            The path of the warmup manifest.
+
+        func_name : Optional[str]
+            The name of the function to run once after declaring the shape buckets.
+
+        args : List[Any]
+            The arguments to the function.
+
+        Returns
+        -------
+        num_graphs : int
+            The number of CUDA graphs instantiated after the warmup.
+        """
+        num_graphs = tvm.get_global_func("vm.builtin.cuda_graph.warmup")(
+            self.module, manifest_path
+        )
+        if func_name is not None:
+            self[func_name](*args)
+            num_graphs = tvm.get_global_func("vm.builtin.cuda_graph.get_num_graphs")(self.module)
+        return num_graphs
+
+    def save_cuda_graph_warmup_manifest(self, manifest_path: str) -> None:
+        """Save the shape tuples of the CUDA graphs captured so far as a warmup manifest.
+
+        Parameters
+        ----------
+        manifest_path : str
+            The path to save the warmup manifest to.
+        """
+        shapes = tvm.get_global_func("vm.builtin.cuda_graph.get_captured_shapes")(self.module)
+        with open(manifest_path, "w") as manifest_file:
+            json.dump(
+                {"shape_buckets": [[int(x) for x in shape] for shape in shapes]}, manifest_file
+            )
+
     def time_evaluator(
         self,
         func_name: str,
@@ -474,9 +627,13 @@ class VirtualMachine(object):
             f_preproc=f_preproc,
         )
 
-    def profile(self, func_name: str, *args):
+    def profile(self, func_name: str, *args, flops: Optional[Dict[str, float]] = None):
         """Profile a function call.
 
+        On CPU, the hardware counters of each call (cycles, instructions and cache misses)
+        are collected when perf_event_open allows it. Set the environment variable
+        ``TVM_VM_PROFILE_HW_COUNTERS=0`` to skip them.
+
         Parameters
         ----------
         func_name : str
@@ -485,6 +642,12 @@ class VirtualMachine(object):
         args: List of Tensor or other objects supported by PackedFunc.
             The arguments to the function.
 
+        flops: Optional[Dict[str, float]]
+            The FLOPs of a call to each kernel, such as estimated by
+            :py:func:`tvm.tir.analysis.estimate_tir_flops` on its PrimFunc. The report then
+            includes the achieved GFLOP/s of the kernels, and their bytes per FLOP when the
+            cache misses are counted.
+
         Returns
         -------
         report: tvm.runtime.profiling.Report
@@ -495,6 +658,10 @@ class VirtualMachine(object):
         for arg in args:
             self._convert(arg, cargs)
 
+        if flops:
+            self.module["set_profile_flops"](
+                *[item for name, value in flops.items() for item in (name, float(value))]
+            )
         report_json = self.module["profile"](func_name, *cargs)
         return Report.from_json(report_json)
 
@@ -2032,6 +2032,11 @@ simdgroup_load = _op_wrapper(_tir_op.simdgroup_load)
 simdgroup_store = _op_wrapper(_tir_op.simdgroup_store)
 simdgroup_multiply_accumulate = _op_wrapper(_tir_op.simdgroup_multiply_accumulate)
 create_barriers = _op_wrapper(_tir_op.create_barriers)
+ptx_map_shared_rank = _op_wrapper(_tir_op.ptx_map_shared_rank)
+ptx_wgmma_encode_smem_desc = _op_wrapper(_tir_op.ptx_wgmma_encode_smem_desc)
+ptx_wgmma_fence = _op_wrapper(_tir_op.ptx_wgmma_fence)
+ptx_wgmma_commit_group = _op_wrapper(_tir_op.ptx_wgmma_commit_group)
+ptx_wgmma_wait_group = _op_wrapper(_tir_op.ptx_wgmma_wait_group)
 assume = _op_wrapper(_tir_op.assume)
 undef = _op_wrapper(_tir_op.undef)
 TVMBackendAllocWorkspace = _op_wrapper(_tir_op.TVMBackendAllocWorkspace)
@@ -2067,6 +2072,8 @@ ptx_mma_sp = _dtype_forward(_tir_op.ptx_mma_sp)
 ptx_ldmatrix = _dtype_forward(_tir_op.ptx_ldmatrix)
 ptx_cp_async = _dtype_forward(_tir_op.ptx_cp_async)
 ptx_cp_async_bulk = _dtype_forward(_tir_op.ptx_cp_async_bulk)
+ptx_cp_async_bulk_tensor = _dtype_forward(_tir_op.ptx_cp_async_bulk_tensor)
+ptx_wgmma_mma_async = _dtype_forward(_tir_op.ptx_wgmma_mma_async)
 mma_store = _dtype_forward(_tir_op.mma_store)
 mma_fill = _dtype_forward(_tir_op.mma_fill)
 vectorlow = _dtype_forward(_tir_op.vectorlow)
@@ -2312,6 +2319,7 @@ __all__ = float_types + [
     "ptx_ldmatrix",
     "ptx_cp_async",
     "ptx_cp_async_bulk",
+    "ptx_cp_async_bulk_tensor",
     "ptx_wait_group",
     "ptx_commit_group",
     "ptx_cp_async_barrier",
@@ -2324,6 +2332,12 @@ __all__ = float_types + [
     "simdgroup_store",
     "simdgroup_multiply_accumulate",
     "create_barriers",
+    "ptx_map_shared_rank",
+    "ptx_wgmma_encode_smem_desc",
+    "ptx_wgmma_mma_async",
+    "ptx_wgmma_fence",
+    "ptx_wgmma_commit_group",
+    "ptx_wgmma_wait_group",
     "mma_store",
     "mma_fill",
     "vectorlow",
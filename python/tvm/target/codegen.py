@@ -247,3 +247,45 @@ def llvm_version_major(allow_none=False):
         if allow_none:
             return None
         raise RuntimeError("LLVM version is not available, please check if you built TVM with LLVM")
+
+
+def llvm_jit_cache_set_dir(cache_dir):
+    """Set the directory of the on-disk cache of the objects compiled by the ORC JIT.
+
+    Identical LLVM modules JIT compiled with `-jit=orcjit` are loaded from the cache instead
+    of being compiled again, including across processes. The directory defaults to the
+    environment variable `TVM_LLVM_JIT_CACHE_DIR`.
+
+    Parameters
+    ----------
+    cache_dir : str
+        The cache directory. An empty string disables the cache.
+    """
+    _ffi_api.llvm_jit_cache_set_dir(cache_dir)
+
+
+def llvm_jit_cache_get_dir():
+    """Get the directory of the ORC JIT object cache.
+
+    Returns
+    -------
+    cache_dir : str
+        The cache directory, empty if the cache is disabled.
+    """
+    return _ffi_api.llvm_jit_cache_get_dir()
+
+
+def llvm_jit_cache_get_stats():
+    """Get the lookup statistics of the ORC JIT object cache.
+
+    Returns
+    -------
+    stats : dict[str, int]
+        The number of cache "hits", "misses" and "stores".
+    """
+    return {key: int(value) for key, value in _ffi_api.llvm_jit_cache_get_stats().items()}
+
+
+def llvm_jit_cache_reset_stats():
+    """Reset the lookup statistics of the ORC JIT object cache."""
+    _ffi_api.llvm_jit_cache_reset_stats()
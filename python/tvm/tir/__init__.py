@@ -69,6 +69,7 @@ from .op import (
     ptx_ldmatrix,
     ptx_cp_async,
     ptx_cp_async_bulk,
+    ptx_cp_async_bulk_tensor,
     ptx_commit_group,
     ptx_wait_group,
     ptx_cp_async_barrier,
@@ -77,6 +78,12 @@ from .op import (
     ptx_arrive_barrier_expect_tx,
     ptx_wait_barrier,
     create_barriers,
+    ptx_map_shared_rank,
+    ptx_wgmma_encode_smem_desc,
+    ptx_wgmma_mma_async,
+    ptx_wgmma_fence,
+    ptx_wgmma_commit_group,
+    ptx_wgmma_wait_group,
 )
 from .op import (
     make_filled_simdgroup_matrix,
@@ -243,7 +243,11 @@ def undefined_vars(node: Union[Stmt, PrimExpr], defs: Optional[List[Var]] = None
     return _ffi_api.UndefinedVars(node, defs)  # type: ignore # pylint: disable=no-member
 
 
-def verify_well_formed(obj: Union[PrimFunc, IRModule], assert_mode: bool = True) -> bool:
+def verify_well_formed(
+    obj: Union[PrimFunc, IRModule],
+    assert_mode: bool = True,
+    prev_mod: Optional[IRModule] = None,
+) -> bool:
     """Verify if the given TIR is well-formed. The verification includes:
         - Check if expressions not contain vars that is defined outside the block.
 
@@ -255,11 +259,20 @@ def verify_well_formed(obj: Union[PrimFunc, IRModule], assert_mode: bool = True)
     assert_mode: bool
         The indicator if it raises an error when the function is not well-formed.
 
+    prev_mod: Optional[tvm.ir.IRModule]
+        A well-formed module, such as the input of the pass that produced `obj`.  When
+        given, only the PrimFuncs of `obj` that are not the same objects as in `prev_mod`
+        are verified.
+
     Returns
     -------
     result: bool
         Whether it is a well-formed TIR function.
     """
+    if prev_mod is not None:
+        return _ffi_api.VerifyWellFormedIncremental(  # type: ignore # pylint: disable=no-member
+            obj, prev_mod, assert_mode
+        )
     return _ffi_api.VerifyWellFormed(obj, assert_mode)  # type: ignore # pylint: disable=no-member
 
 
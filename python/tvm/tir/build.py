@@ -181,6 +181,34 @@ def build(
     else:
         assert isinstance(mod, tvm.IRModule)
 
+    from tvm.driver import compile_cache  # pylint: disable=import-outside-toplevel
+
+    key_target = Target.canon_target(target) if target is not None else Target.current()
+    return compile_cache.cached_build(
+        "tir",
+        mod,
+        key_target,
+        [pipeline],
+        lambda: _build(mod, target, pipeline),
+        lambda lib: lib,
+    )
+
+
+def _build(mod: IRModule, target: Optional[Union[str, Target]], pipeline):
+    """Build an IRModule without the compilation cache."""
+    host_mod, device_mod_dict, target_host = _lower(mod, target, pipeline)
+    # Convert TIR IRModules to runtime Module by calling target.build
+    return tir_to_runtime(host_mod, device_mod_dict, target_host)
+
+
+def _lower(mod: IRModule, target: Optional[Union[str, Target]], pipeline):
+    """Apply the TIR passes of the build, up to the code generation.
+
+    Returns
+    -------
+    ret : Tuple[IRModule, Dict[Target, IRModule], Target]
+        The host module, the device modules and the host target, the inputs of tir_to_runtime.
+    """
     # Step 0: Determine the target in environment
     # It's used to bind the PrimFunc without target attr to serve as a default target
     target_to_bind = Target.current() if target is None else target
@@ -234,9 +262,7 @@ def build(
         target: tvm.tir.pipeline.finalize_device_passes()(device_mod)
         for target, device_mod in device_mod_dict.items()
     }
-
-    # Convert TIR IRModules to runtime Module by calling target.build
-    return tir_to_runtime(host_mod, device_mod_dict, target_host)
+    return host_mod, device_mod_dict, target_host
 
 
 tvm.register_global_func("tir.build", build)
@@ -1449,6 +1449,47 @@ def ptx_cp_async_bulk(
     )
 
 
+def ptx_cp_async_bulk_tensor(dtype, shared_ptr, shared_offset, tensormap, barrier_id, *coords):
+    """TVM intrinsic for ptx async copy of a tensor tile from global to shared memory using
+    cp.async.bulk.tensor
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-cp-async-bulk-tensor
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result.
+
+    shared_ptr : Var
+        The shared memory pointer variable.
+
+    shared_offset : Expr
+        The offset of shared memory pointer.
+
+    tensormap : Var
+        The CUtensorMap describing the global tensor and the tile to copy.
+
+    barrier_id : int
+        The ID of the barrier shared memory pointer.
+
+    coords : List[Expr]
+        The coordinates of the tile in the global tensor, innermost dimension first.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_cp_async_bulk_tensor",
+        shared_ptr,
+        shared_offset,
+        tensormap,
+        barrier_id,
+        *coords,
+    )
+
+
 def ptx_commit_group():
     """TVM intrinsic for ptx async copy commit
     https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-cp-async-commit-group
@@ -1554,7 +1595,7 @@ def ptx_arrive_barrier_expect_tx(barrier_id, byte_count):
     return call_intrin("", "tir.ptx_arrive_barrier_expect_tx", barrier_id, byte_count)
 
 
-def ptx_wait_barrier(barrier_id):
+def ptx_wait_barrier(barrier_id, phase=None):
     """TVM intrinsic for ptx barrier wait using mbarrier.try_wait
     https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-mbarrier-test-wait-mbarrier-try-wait
 
@@ -1563,12 +1604,38 @@ def ptx_wait_barrier(barrier_id):
     barrier_id : int
         The ID of the barrier shared memory pointer.
 
+    phase : Optional[Expr]
+        The parity of the phase of the barrier to wait for, 0 by default.
+
     Returns
     -------
     call : PrimExpr
         The call expression.
     """
-    return call_intrin("", "tir.ptx_wait_barrier", barrier_id)
+    if phase is None:
+        return call_intrin("", "tir.ptx_wait_barrier", barrier_id)
+    return call_intrin("", "tir.ptx_wait_barrier", barrier_id, phase)
+
+
+def ptx_map_shared_rank(smem_ptr, cta_rank):
+    """TVM intrinsic mapping a shared memory address to the same variable in the shared memory
+    of another block of the thread block cluster, using mapa
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-mapa
+
+    Parameters
+    ----------
+    smem_ptr : Var
+        The shared memory pointer in the current block.
+
+    cta_rank : Expr
+        The rank of the target block within the cluster.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression, the generic address of the variable in the target block.
+    """
+    return call_intrin("handle", "tir.ptx_map_shared_rank", smem_ptr, cta_rank)
 
 
 def create_barriers(barrier_count):
@@ -1587,6 +1654,165 @@ def create_barriers(barrier_count):
     return call_intrin("", "tir.create_barriers", barrier_count)
 
 
+def ptx_wgmma_encode_smem_desc(
+    smem_ptr, smem_offset, leading_byte_offset, stride_byte_offset, swizzle_mode=0
+):
+    """TVM intrinsic for the shared memory matrix descriptor of a wgmma.mma_async operand
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-shared-memory-layout-matrix-descriptor
+
+    Parameters
+    ----------
+    smem_ptr : Var
+        The shared memory pointer variable.
+
+    smem_offset : Expr
+        The offset of shared memory pointer.
+
+    leading_byte_offset : Expr
+        The byte offset between the core matrices along the leading dimension.
+
+    stride_byte_offset : Expr
+        The byte offset between the core matrices along the strided dimension.
+
+    swizzle_mode : int
+        The swizzle of the shared memory layout, 0 for none, 1 for 128B, 2 for 64B
+        and 3 for 32B.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        "uint64",
+        "tir.ptx_wgmma_encode_smem_desc",
+        smem_ptr,
+        smem_offset,
+        leading_byte_offset,
+        stride_byte_offset,
+        swizzle_mode,
+    )
+
+
+def ptx_wgmma_mma_async(
+    dtype,
+    shape,
+    A_dtype,
+    B_dtype,
+    C_dtype,
+    desc_a,
+    desc_b,
+    accumulator,
+    c_index,
+    scale_d=1,
+    trans_a=False,
+    trans_b=False,
+):
+    """TVM intrinsic for warpgroup level matrix multiply-accumulate using wgmma.mma_async,
+    with both multiplicands in shared memory
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-mma-async
+
+    Parameters
+    ----------
+    dtype : str
+        The data type of the result.
+
+    shape : str
+        The shape of the wgmma fragment, m64nNkK.
+
+    A_dtype : str
+        The data type of multiplicand A.
+
+    B_dtype : str
+        The data type of multiplicand B.
+
+    C_dtype : str
+        The data type of accumulator C.
+
+    desc_a : Expr
+        The shared memory matrix descriptor of multiplicand A.
+
+    desc_b : Expr
+        The shared memory matrix descriptor of multiplicand B.
+
+    accumulator : Var
+        The accumulator fragment C variable.
+
+    c_index : Expr
+        The index of accumulator fragment C.
+
+    scale_d : Expr
+        Whether the accumulator is added to the product, 0 to overwrite it.
+
+    trans_a : bool
+        Whether multiplicand A is transposed.
+
+    trans_b : bool
+        Whether multiplicand B is transposed.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_wgmma_mma_async",
+        shape,
+        A_dtype,
+        B_dtype,
+        C_dtype,
+        desc_a,
+        desc_b,
+        accumulator,
+        c_index,
+        scale_d,
+        trans_a,
+        trans_b,
+    )
+
+
+def ptx_wgmma_fence():
+    """TVM intrinsic for the fence before the first wgmma.mma_async on fresh registers
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-fence
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_fence")
+
+
+def ptx_wgmma_commit_group():
+    """TVM intrinsic for committing the pending wgmma.mma_async operations into a group
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-commit-group
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_commit_group")
+
+
+def ptx_wgmma_wait_group(num):
+    """TVM intrinsic for waiting for the wgmma.mma_async groups
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-wait-group
+
+    Parameters
+    ----------
+    num : int
+        The number of the most recent wgmma groups allowed to be pending.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_wait_group", num)
+
+
 def make_filled_simdgroup_matrix(
     d: Var,
     index: PrimExpr,
@@ -50,6 +50,7 @@ def default_tir_pipeline():
             tir.transform.InjectSoftwarePipeline(),
             tir.transform.TransformMmaBufferLayout(),
             tir.transform.LowerOpaqueBlock(),
+            tir.transform.InjectSoftwarePrefetch(),
             tir.transform.FlattenBuffer(),
             tir.transform.BF16ComputeLegalize(),
             tir.transform.NarrowDataType(32),
@@ -117,7 +118,13 @@ def default_tir_pipeline():
                 tir.transform.SplitHostDevice(),
                 # MergeSharedMemoryAllocations must follow SplitHostDevice.
                 tir.transform.MergeSharedMemoryAllocations(),
-                tir.transform.MakePackedAPI(),
+                # The direct-call mode lowers the host functions to plain C calls, for
+                # deployments without the packed function runtime.
+                (
+                    tir.transform.MakeUnpackedAPI()
+                    if bool(config.get("tir.direct_call", False))
+                    else tir.transform.MakePackedAPI()
+                ),
                 tir.transform.FP8StorageLegalize(),
                 tir.transform.BF16StorageLegalize(),
                 tir.transform.LowerDeviceKernelLaunch(),
@@ -98,14 +98,174 @@ def dot_product_16x4_u8i8i32_avx512(
         )
 
 
+@T.prim_func
+def dot_product_8x4_u8i8i32_desc(
+    A: T.Buffer((4,), "uint8", offset_factor=1),
+    B: T.Buffer((8, 4), "int8", offset_factor=1),
+    C: T.Buffer((8,), "int32", offset_factor=1),
+) -> None:
+    with T.block("root"):
+        T.reads(C[0:8], A[0:4], B[0:8, 0:4])
+        T.writes(C[0:8])
+        for i in T.serial(0, 8):
+            for k in T.serial(0, 4):
+                with T.block("update"):
+                    vi, vk = T.axis.remap("SR", [i, k])
+                    C[vi] = C[vi] + T.cast(A[vk], "int32") * T.cast(B[vi, vk], "int32")
+
+
+@T.prim_func
+def dot_product_8x4_u8i8i32_avxvnni(
+    A: T.Buffer((4,), "uint8", offset_factor=1),
+    B: T.Buffer((8, 4), "int8", offset_factor=1),
+    C: T.Buffer((8,), "int32", offset_factor=1),
+) -> None:
+    with T.block("root"):
+        T.reads(C[0:8], A[0:4], B[0:8, 0:4])
+        T.writes(C[0:8])
+
+        A_u8x4 = A.vload([0], "uint8x4")
+        A_i32 = T.reinterpret(A_u8x4, dtype="int32")
+
+        B_i8x32 = B.vload([0, 0], dtype="int8x32")
+        B_i32x8 = T.reinterpret(B_i8x32, dtype="int32x8")
+        C_i32x8 = C.vload([0], dtype="int32x8")
+
+        # On targets with AVX-VNNI but without AVX512-VL, LLVM selects the VEX encoding.
+        C[T.ramp(T.int32(0), 1, 8)] = T.call_llvm_pure_intrin(
+            T.llvm_lookup_intrinsic_id("llvm.x86.avx512.vpdpbusd.256"),
+            C_i32x8,
+            T.broadcast(A_i32, 8),
+            B_i32x8,
+            dtype="int32x8",
+        )
+
+
 VNNI_DOT_16x4_INTRIN = "dot_16x4_vnni"
 
 TensorIntrin.register(
     VNNI_DOT_16x4_INTRIN, dot_product_16x4_u8i8i32_desc, dot_product_16x4_u8i8i32_vnni
 )
 
+AVX_VNNI_DOT_8x4_INTRIN = "dot_8x4_avxvnni"
+
+TensorIntrin.register(
+    AVX_VNNI_DOT_8x4_INTRIN, dot_product_8x4_u8i8i32_desc, dot_product_8x4_u8i8i32_avxvnni
+)
+
 AVX512_DOT_16x4_INTRIN = "dot_16x4_avx512"
 
 TensorIntrin.register(
     AVX512_DOT_16x4_INTRIN, dot_product_16x4_u8i8i32_desc, dot_product_16x4_u8i8i32_avx512
 )
+
+
+def get_amx_dot_intrin(in_dtype, out_dtype):
+    """Generate the description and AMX implementation of a 16x16 tile product.
+
+    The intrinsic computes C[16, 16] += A[16, K] * B[K, 16], where every operand is a single
+    AMX tile of 16 rows of 64 bytes, and B is stored in the VNNI-packed layout
+    B[K // w, 16, w] with w = 4 for int8 and 2 for bfloat16. It requires the target to have
+    AMX (e.g. `-mcpu=sapphirerapids`), and the process to have requested the AMX tile data
+    permission of the OS, see `runtime.amx_init`. The code generator loads the tile
+    configuration at the entry of every function using the intrinsic.
+    """
+    if in_dtype == "uint8":
+        a_dtype, b_dtype, vnni_width, compute_intrin = "uint8", "int8", 4, "llvm.x86.tdpbusd"
+    else:
+        assert in_dtype == "bfloat16", f"Unsupported input dtype {in_dtype} for AMX"
+        a_dtype, b_dtype, vnni_width, compute_intrin = (
+            "bfloat16",
+            "bfloat16",
+            2,
+            "llvm.x86.tdpbf16ps",
+        )
+    in_bytes = 4 // vnni_width
+    M, N, K = 16, 16, 64 // in_bytes
+    K_outer = K // vnni_width
+
+    @T.prim_func
+    def amx_dot_desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+        A = T.match_buffer(a, (M, K), a_dtype, offset_factor=1)
+        B = T.match_buffer(b, (K_outer, N, vnni_width), b_dtype, offset_factor=1)
+        C = T.match_buffer(c, (M, N), out_dtype, offset_factor=1)
+        with T.block("root"):
+            T.reads(C[0:M, 0:N], A[0:M, 0:K], B[0:K_outer, 0:N, 0:vnni_width])
+            T.writes(C[0:M, 0:N])
+            for i, j, k in T.grid(M, N, K):
+                with T.block("update"):
+                    vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                    C[vi, vj] = C[vi, vj] + T.cast(A[vi, vk], out_dtype) * T.cast(
+                        B[vk // vnni_width, vj, vk % vnni_width], out_dtype
+                    )
+
+    @T.prim_func
+    def amx_dot_impl(a: T.handle, b: T.handle, c: T.handle) -> None:
+        lda = T.int32()
+        ldb = T.int32()
+        ldc = T.int32()
+        A = T.match_buffer(a, (M, K), a_dtype, offset_factor=1, strides=[lda, 1])
+        B = T.match_buffer(
+            b,
+            (K_outer, N, vnni_width),
+            b_dtype,
+            offset_factor=1,
+            strides=[ldb, vnni_width, 1],
+        )
+        C = T.match_buffer(c, (M, N), out_dtype, offset_factor=1, strides=[ldc, 1])
+        with T.block("root"):
+            T.reads(C[0:M, 0:N], A[0:M, 0:K], B[0:K_outer, 0:N, 0:vnni_width])
+            T.writes(C[0:M, 0:N])
+            # The strides of the tile loads and stores are in bytes.
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tileloadd64",
+                    T.int8(0),
+                    C.access_ptr("r"),
+                    T.Cast("int64", ldc * 4),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tileloadd64",
+                    T.int8(1),
+                    A.access_ptr("r"),
+                    T.Cast("int64", lda * in_bytes),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tileloadd64",
+                    T.int8(2),
+                    B.access_ptr("r"),
+                    T.Cast("int64", ldb * in_bytes),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin("void", compute_intrin, T.int8(0), T.int8(1), T.int8(2))
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "void",
+                    "llvm.x86.tilestored64",
+                    T.int8(0),
+                    C.access_ptr("w"),
+                    T.Cast("int64", ldc * 4),
+                )
+            )
+
+    return amx_dot_desc, amx_dot_impl
+
+
+AMX_DOT_16x16x64_U8I8I32_INTRIN = "dot_16x16x64_u8i8i32_amx"
+
+TensorIntrin.register(AMX_DOT_16x16x64_U8I8I32_INTRIN, *get_amx_dot_intrin("uint8", "int32"))
+
+AMX_DOT_16x16x32_BF16BF16F32_INTRIN = "dot_16x16x32_bf16bf16f32_amx"
+
+TensorIntrin.register(
+    AMX_DOT_16x16x32_BF16BF16F32_INTRIN, *get_amx_dot_intrin("bfloat16", "float32")
+)
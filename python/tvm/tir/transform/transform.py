@@ -341,6 +341,10 @@ def ConvertSSA():
 def InstrumentBoundCheckers():
     """Instruments bound checkers.
 
+    The accesses of a loop nest whose indices range over an interval known
+    before it are checked once before the loop nest, the others before each
+    access.
+
     Returns
     -------
     fpass : tvm.transform.Pass
@@ -598,6 +602,11 @@ def CombineContextCall():
 def NarrowDataType(target_bits: int):
     """Narrow down PrimExpr datatype in stmt to target_bits.
 
+    The free variables of the function are bounded by its "tir_var_upper_bound" attribute. On
+    CUDA and ROCm, when the indices only fit into int32 for some sizes, the body is versioned
+    into a narrowed body guarded by a runtime check of the sizes, with the original body as the
+    fallback. Set the "tir.narrow_index_with_fallback" config to False to disable it.
+
     Parameters
     ----------
     target_bits : int
@@ -856,6 +865,10 @@ def CompactBufferAllocation(is_strict: bool = True):
                 for j in range(0, 16):
                     C[i, j] = B[0, j] + 1
 
+    The accessed regions are estimated by interval arithmetic, which is loose on non-rectangular
+    regions, e.g. under a causal mask. The ``tir.CompactBufferAllocation.polyhedral_bound``
+    config also bounds them as the projection of the loop nest polyhedron, and keeps the tighter.
+
     Parameters
     ----------
     is_strict : bool
@@ -953,6 +966,13 @@ def MergeSharedMemoryAllocations():
     """This pass merges multiple TIR-level shared memory allocations
     into one allocation.
 
+    By default, the buffers reuse the storage of the buffers that are no longer live. With the
+    ``tir.merge_smem_interval_coloring`` config, the offsets of constant-size buffers are
+    instead planned by interval coloring over their lifetimes, which packs the buffers of
+    pipelined kernels tighter. The offsets are then aligned to ``tir.merge_smem_alignment``
+    bytes (16 by default), and the buffers of at least ``tir.merge_smem_swizzle_bytes`` bytes
+    are aligned to that size, so that their swizzled layouts keep their bank pattern.
+
     Returns
     -------
     fpass : tvm.transform.Pass
@@ -983,6 +1003,21 @@ def InjectSoftwarePipeline():
     return _ffi_api.InjectSoftwarePipeline()  # type: ignore
 
 
+def InjectSoftwarePrefetch():
+    """Inject software prefetches into the loops annotated with `software_prefetch_distance`.
+
+    For a distance `d`, every iteration `i` of the loop prefetches the regions of the global
+    buffers that iteration `i + d` reads, and a prologue before the loop prefetches the regions of
+    the first `d` iterations.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()  # type: ignore
+
+
 def ExtractPrimFuncConstants():
     """Collects and unificates tir non-scalar constants to module's attr 'Constants' array.
 
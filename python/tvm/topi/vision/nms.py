@@ -31,8 +31,12 @@ from .nms_util import (
     collect_selected_indices,
     collect_selected_indices_and_scores,
     run_all_class_nms,
+    run_all_class_nms_bitmask,
 )
 
+# The largest suppression bitmask, in bytes, for which the bitmask NMS is picked by default.
+_MAX_AUTO_BITMASK_BYTES = 64 * 1024 * 1024
+
 
 def get_valid_counts(
     data, score_threshold=0, id_index=0, score_index=1
@@ -320,6 +324,7 @@ def all_class_non_max_suppression(
     score_threshold,
     output_format="onnx",
     output_shape=None,
+    use_bitmask=None,
 ):
     """Non-maximum suppression operator for object detection, corresponding to ONNX
     NonMaxSuppression and TensorFlow combined_non_max_suppression.
@@ -338,6 +343,13 @@ def all_class_non_max_suppression(
         Score threshold to filter out low score boxes early
     output_format : str, optional
         "onnx" or "tensorflow", see below.
+    output_shape : tuple of int, optional
+        The shape of the "onnx" indices, which by default depends on max_output_boxes_per_class.
+    use_bitmask : bool, optional
+        Whether to compute the overlaps of all the pairs of boxes of a class at once and select
+        the boxes with bitmasks, in parallel over the batches and the classes, rather than run
+        one serial loop per class. By default, the bitmask is used when the number of boxes is
+        static and the mask takes at most 64MB.
     Returns
     -------
     out : list of tvm.te.Tensor
@@ -385,17 +397,39 @@ def all_class_non_max_suppression(
 
     valid_count = _get_valid_box_count(sorted_scores, score_threshold_tensor)
 
-    selected_indices, selected_scores, num_detections = run_all_class_nms(
-        boxes,
-        sorted_scores,
-        sorted_indices,
-        valid_count,
-        max_output_boxes_per_class,
-        iou_threshold,
-        _nms_loop,
-        return_scores=(output_format == "tensorflow"),
-        score_threshold=score_threshold_tensor,  # Passed score_threshold as tensor
-    )
+    if use_bitmask is None:
+        use_bitmask = isinstance(num_boxes, (int, tvm.tir.IntImm)) and isinstance(
+            batch, (int, tvm.tir.IntImm)
+        )
+        if use_bitmask:
+            num_words = (int(num_boxes) + 31) // 32
+            mask_bytes = int(batch) * int(num_class) * int(num_boxes) * num_words * 4
+            use_bitmask = mask_bytes <= _MAX_AUTO_BITMASK_BYTES
+
+    if use_bitmask:
+        # valid_count only counts the boxes above score_threshold, so the bitmask NMS doesn't
+        # need the threshold.
+        selected_indices, selected_scores, num_detections = run_all_class_nms_bitmask(
+            boxes,
+            sorted_scores,
+            sorted_indices,
+            valid_count,
+            max_output_boxes_per_class,
+            iou_threshold,
+            return_scores=(output_format == "tensorflow"),
+        )
+    else:
+        selected_indices, selected_scores, num_detections = run_all_class_nms(
+            boxes,
+            sorted_scores,
+            sorted_indices,
+            valid_count,
+            max_output_boxes_per_class,
+            iou_threshold,
+            _nms_loop,
+            return_scores=(output_format == "tensorflow"),
+            score_threshold=score_threshold_tensor,  # Passed score_threshold as tensor
+        )
 
     if output_format == "onnx":
         row_offsets = cumsum(num_detections, exclusive=True, dtype="int64")
@@ -16,6 +16,8 @@
 # under the License.
 # pylint: disable=invalid-name
 """Common utilities used in Non-maximum suppression operators"""
+import contextlib
+
 import tvm
 from tvm import te
 
@@ -471,3 +473,211 @@ def run_all_class_nms(
         name="all_class_nms",
         tag="all_class_nms",
     )
+
+
+@contextlib.contextmanager
+def _parallel_for(ib, extent, name):
+    """Loop over independent work items, spread over the threads of the GPU on GPU targets, and
+    over the threads of the thread pool otherwise."""
+    target = tvm.target.Target.current(allow_none=True)
+    if target is not None and "gpu" in list(target.keys):
+        nthread = int(target.max_num_threads)
+        bx = te.thread_axis("blockIdx.x")
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(bx, "thread_extent", tvm.tir.indexdiv(extent + nthread - 1, nthread))
+        ib.scope_attr(tx, "thread_extent", nthread)
+        index = bx * nthread + tx
+        with ib.if_scope(index < extent):
+            yield index
+    else:
+        with ib.for_range(0, extent, name=name, kind="parallel") as index:
+            yield index
+
+
+def _scalar_param(ib, value, dtype):
+    """The value of a scalar parameter, given as a python number or as a buffer of one element."""
+    if isinstance(value, tvm.tir.Buffer):
+        ptr = ib.buffer_ptr(value)
+        value = ptr[()] if len(value.shape) == 0 else ptr[0]
+    return tvm.tir.const(value, dtype) if isinstance(value, (int, float)) else value.astype(dtype)
+
+
+def _iou_bitmask_ir(boxes, sorted_indices, valid_count, iou_threshold, num_class, mask):
+    batch_class, num_boxes, num_words = mask.shape
+    num_anchors = boxes.shape[1]
+
+    ib = tvm.tir.ir_builder.create()
+    boxes = ib.buffer_ptr(boxes)
+    sorted_indices = ib.buffer_ptr(sorted_indices)
+    valid_count = ib.buffer_ptr(valid_count)
+    iou_threshold = _scalar_param(ib, iou_threshold, "float32")
+    mask = ib.buffer_ptr(mask)
+
+    # One work item per box sorted by score, which fills its row of the mask.
+    with _parallel_for(ib, batch_class * num_boxes, "ij") as ij:
+        i = ij // num_boxes
+        j = ij % num_boxes
+        base_bbox_idx = (i // num_class) * num_anchors * 4
+        word = ib.allocate("uint32", (1,), name="word", scope="local")
+        with ib.for_range(0, num_words, name="w") as w:
+            word[0] = tvm.tir.const(0, "uint32")
+            with ib.for_range(0, 32, name="b") as b:
+                k = w * 32 + b
+                with ib.if_scope(tvm.tir.all(j < k, k < valid_count[i])):
+                    iou = calculate_overlap(
+                        boxes,
+                        base_bbox_idx + sorted_indices[i, j] * 4,
+                        base_bbox_idx + sorted_indices[i, k] * 4,
+                    )
+                    with ib.if_scope(iou >= iou_threshold):
+                        word[0] = word[0] | (tvm.tir.const(1, "uint32") << b.astype("uint32"))
+            mask[i, j, w] = word[0]
+
+    return ib.get()
+
+
+def _bitmask_nms_ir(
+    mask,
+    sorted_scores,
+    sorted_indices,
+    valid_count,
+    iou_threshold,
+    max_output_size_per_class,
+    box_indices,
+    selected_scores,
+    num_valid_boxes,
+):
+    batch_class, _, num_words = mask.shape
+
+    ib = tvm.tir.ir_builder.create()
+    mask = ib.buffer_ptr(mask)
+    sorted_scores = ib.buffer_ptr(sorted_scores)
+    sorted_indices = ib.buffer_ptr(sorted_indices)
+    valid_count = ib.buffer_ptr(valid_count)
+    iou_threshold = _scalar_param(ib, iou_threshold, "float32")
+    max_output_size_per_class = _scalar_param(ib, max_output_size_per_class, "int32")
+    box_indices = ib.buffer_ptr(box_indices)
+    num_valid_boxes = ib.buffer_ptr(num_valid_boxes)
+    if selected_scores is not None:
+        selected_scores = ib.buffer_ptr(selected_scores)
+
+    # One work item per batch and class, which walks the boxes in the order of the scores and
+    # drops the ones overlapping a box kept before, as the serial loop does.
+    with _parallel_for(ib, batch_class, "i") as i:
+        removed = ib.allocate("uint32", (num_words,), name="removed", scope="local")
+        num_selected = ib.allocate("int32", (1,), name="num_selected", scope="local")
+        with ib.for_range(0, num_words, name="w") as w:
+            removed[w] = tvm.tir.const(0, "uint32")
+        num_selected[0] = 0
+        with ib.if_scope(iou_threshold > 0.0):
+            with ib.for_range(0, valid_count[i], name="j") as j:
+                is_removed = (removed[j // 32] >> (j % 32).astype("uint32")) & tvm.tir.const(
+                    1, "uint32"
+                )
+                with ib.if_scope(
+                    tvm.tir.all(
+                        num_selected[0] < max_output_size_per_class,
+                        is_removed == tvm.tir.const(0, "uint32"),
+                    )
+                ):
+                    box_indices[i, num_selected[0]] = sorted_indices[i, j]
+                    if selected_scores is not None:
+                        selected_scores[i, num_selected[0]] = sorted_scores[i, j]
+                    num_selected[0] += 1
+                    # The row of box j only has bits for the boxes after it.
+                    with ib.for_range(j // 32, num_words, name="w") as w:
+                        removed[w] = removed[w] | mask[i, j, w]
+        num_valid_boxes[i] = num_selected[0]
+
+    return ib.get()
+
+
+def run_all_class_nms_bitmask(
+    boxes,
+    sorted_scores,
+    sorted_indices,
+    valid_count,
+    max_output_size_per_class,
+    iou_threshold,
+    return_scores=False,
+):
+    """The core all class NMS routine, computing the overlaps of all the pairs of boxes at once
+    Parameters
+    ----------
+    boxes : tvm.te.Tensor
+        3-D tensor with shape (batch_size, num_boxes, 4)
+    sorted_scores: tvm.te.Tensor
+        2-D tensor with shape (batch_size * num_classes, num_boxes)
+        One of the outputs from argsort
+    sorted_indices: tvm.te.Tensor
+        2-D tensor with shape (batch_size * num_classes, num_boxes)
+        The other output from argsort
+    valid_count: tvm.te.Tensor
+        1-D tensor with shape (batch_size * num_classes,), representing
+        the number of boxes whose score is above score_threshold, per batch and class
+    max_output_boxes_per_class : int or tvm.te.Tensor
+        The maxinum number of output selected boxes per class
+    iou_threshold : float or tvm.te.Tensor
+        IoU test threshold
+    return_scores : bool, optional
+        Whether or not to return selected scores, needed by the tensorflow output format.
+    Returns
+    -------
+    out : a list of tvm.te.Tensor
+        The same outputs as run_all_class_nms.
+
+    The first kernel computes, for every box of every batch and class, the bitmask of the boxes
+    after it in the order of the scores that it suppresses, all the boxes in parallel. The
+    second keeps the boxes not suppressed by a box kept before, one batch and class per thread,
+    by OR-ing the bitmask rows of the kept boxes. The outputs have fixed shapes, so both kernels
+    can be captured in CUDA graphs. The mask takes batch_size * num_classes * num_boxes *
+    ceil(num_boxes / 32) words, and num_boxes must be static.
+    """
+    batch_class, num_boxes = sorted_scores.shape
+    num_class = batch_class // boxes.shape[0]
+    num_words = (int(num_boxes) + 31) // 32
+
+    params = [p for p in (iou_threshold, max_output_size_per_class) if isinstance(p, te.Tensor)]
+
+    def bind_params(ins):
+        # The scalar parameters given as tensors are the last inputs of the extern.
+        bound = dict(zip([id(p) for p in params], ins[len(ins) - len(params) :]))
+        return [bound.get(id(p), p) for p in (iou_threshold, max_output_size_per_class)]
+
+    mask = te.extern(
+        [(batch_class, num_boxes, num_words)],
+        [boxes, sorted_indices, valid_count] + params,
+        lambda ins, outs: _iou_bitmask_ir(
+            ins[0], ins[1], ins[2], bind_params(ins)[0], num_class, outs[0]
+        ),
+        dtype=["uint32"],
+        name="nms_iou_bitmask",
+        tag="nms_iou_bitmask",
+    )
+
+    out_shapes = [(batch_class, num_boxes), (batch_class,)]
+    out_dtypes = ["int32", "int32"]
+    if return_scores:
+        out_shapes.insert(1, (batch_class, num_boxes))
+        out_dtypes.insert(1, "float32")
+
+    outs = te.extern(
+        out_shapes,
+        [mask, sorted_scores, sorted_indices, valid_count] + params,
+        lambda ins, outs: _bitmask_nms_ir(
+            ins[0],
+            ins[1],
+            ins[2],
+            ins[3],
+            *bind_params(ins),
+            outs[0],
+            outs[1] if return_scores else None,
+            outs[-1],
+        ),
+        dtype=out_dtypes,
+        name="all_class_nms_bitmask",
+        tag="all_class_nms_bitmask",
+    )
+    if return_scores:
+        return outs[0], outs[1], outs[2]
+    return outs[0], None, outs[1]
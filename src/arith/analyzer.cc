@@ -25,7 +25,12 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <unordered_set>
+#include <utility>
+
+#include "../support/utils.h"
 #include "./scalable_expression.h"
 #include "const_fold.h"
 #include "product_normal_form.h"
@@ -33,6 +38,155 @@
 namespace tvm {
 namespace arith {
 
+/*!
+ * \brief Memoized results of the top-level queries of an analyzer.
+ *
+ * Results are kept in one layer per constraint scope. Only the layer of the
+ * innermost scope is looked up, as the results of an enclosing scope may be
+ * less precise than those under the current constraints.
+ *
+ * Binding a variable that no other binding or constraint refers to only
+ * affects the results of expressions that contain it, so those are dropped
+ * through an index from variables to the results using them. Any other
+ * binding drops everything.
+ */
+class Analyzer::MemoTable {
+ public:
+  /*! \brief The kind of a memoized query */
+  enum class QueryKind : int { kSimplify = 0, kCanProve = 1 };
+
+  struct Key {
+    /*! \brief The queried expression, kept alive by the entry */
+    const Object* expr;
+    QueryKind kind;
+    /*! \brief The steps of Simplify, or the strength of CanProve */
+    int arg;
+    /*! \brief The enabled extensions of the rewrite simplifier */
+    int64_t extensions;
+
+    bool operator==(const Key& other) const {
+      return expr == other.expr && kind == other.kind && arg == other.arg &&
+             extensions == other.extensions;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      uint64_t hash = std::hash<const Object*>()(key.expr);
+      hash = support::HashCombine(hash, static_cast<int>(key.kind));
+      hash = support::HashCombine(hash, key.arg);
+      hash = support::HashCombine(hash, key.extensions);
+      return hash;
+    }
+  };
+
+  MemoTable() : layers_(1) {}
+
+  /*! \brief Find the result of a query in the current scope, nullptr if missing. */
+  const PrimExpr* Find(const Key& key) const {
+    const Layer& layer = layers_.back();
+    auto it = layer.entries.find(key);
+    return it == layer.entries.end() ? nullptr : &it->second.result;
+  }
+
+  /*! \brief Add the result of a query in the current scope. */
+  void Insert(const Key& key, const PrimExpr& expr, const PrimExpr& result) {
+    Layer& layer = layers_.back();
+    if (!layer.entries.emplace(key, Entry{expr, result}).second) return;
+    std::unordered_set<const VarNode*> vars;
+    auto fvisit = [&vars](const ObjectRef& node) {
+      if (const auto* var = node.as<VarNode>()) vars.insert(var);
+    };
+    tir::PostOrderVisit(expr, fvisit);
+    tir::PostOrderVisit(result, fvisit);
+    for (const VarNode* var : vars) {
+      layer.var_users[var].push_back(key);
+    }
+  }
+
+  /*! \brief Open the scope of a constraint. */
+  void PushScope(const PrimExpr& constraint) {
+    AddReferencedVars(constraint);
+    layers_.emplace_back();
+  }
+
+  /*! \brief Close the innermost scope, returns the number of dropped results. */
+  int64_t PopScope() {
+    ICHECK_GT(layers_.size(), 1U);
+    int64_t num_dropped = layers_.back().entries.size();
+    layers_.pop_back();
+    return num_dropped;
+  }
+
+  /*! \brief The number of open scopes, including the outermost one. */
+  size_t Depth() const { return layers_.size(); }
+
+  /*!
+   * \brief Drop the results that may depend on a variable about to be bound.
+   * \param var The variable.
+   * \param values The expressions that the variable is bound to.
+   * \return The number of dropped results.
+   */
+  int64_t OnBind(const Var& var, std::initializer_list<PrimExpr> values) {
+    int64_t num_dropped = 0;
+    if (bound_vars_.count(var.get()) || referenced_vars_.count(var.get())) {
+      num_dropped = Clear();
+    } else {
+      for (Layer& layer : layers_) {
+        auto it = layer.var_users.find(var.get());
+        if (it == layer.var_users.end()) continue;
+        for (const Key& key : it->second) {
+          num_dropped += layer.entries.erase(key);
+        }
+        layer.var_users.erase(it);
+      }
+    }
+    bound_vars_.insert(var.get());
+    for (const PrimExpr& value : values) {
+      AddReferencedVars(value);
+    }
+    return num_dropped;
+  }
+
+  /*! \brief Drop all the results, returns the number of dropped results. */
+  int64_t Clear() {
+    int64_t num_dropped = 0;
+    for (Layer& layer : layers_) {
+      num_dropped += layer.entries.size();
+      layer.entries.clear();
+      layer.var_users.clear();
+    }
+    return num_dropped;
+  }
+
+ private:
+  struct Entry {
+    PrimExpr expr;
+    PrimExpr result;
+  };
+
+  struct Layer {
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::unordered_map<const VarNode*, std::vector<Key>> var_users;
+  };
+
+  void AddReferencedVars(const PrimExpr& expr) {
+    tir::PostOrderVisit(expr, [this](const ObjectRef& node) {
+      if (const auto* var = node.as<VarNode>()) referenced_vars_.insert(var);
+    });
+  }
+
+  /*! \brief The layers of results, one per constraint scope */
+  std::vector<Layer> layers_;
+  /*!
+   * \brief The variables that were bound, or that bindings and constraints refer to.
+   *
+   * These may be dangling, which only makes a later binding drop more results than needed.
+   */
+  std::unordered_set<const VarNode*> bound_vars_;
+  std::unordered_set<const VarNode*> referenced_vars_;
+};
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
@@ -40,7 +194,36 @@ Analyzer::Analyzer()
       canonical_simplify(this),
       int_set(this) {}
 
+Analyzer::~Analyzer() = default;
+
+void Analyzer::SetMemoizationEnabled(bool enabled) {
+  if (!enabled) {
+    memo_.reset();
+  } else if (memo_ == nullptr) {
+    memo_ = std::make_unique<MemoTable>();
+  }
+}
+
+void Analyzer::ClearMemo() {
+  if (memo_ != nullptr) {
+    memo_stats_.invalidations += memo_->Clear();
+  }
+}
+
+Analyzer::MemoStats Analyzer::GetMemoStats() const { return memo_stats_; }
+
+namespace {
+thread_local Analyzer::ThreadStats thread_stats;
+}  // namespace
+
+Analyzer::ThreadStats Analyzer::GetThreadStats() { return thread_stats; }
+
+void Analyzer::ResetMemoStats() { memo_stats_ = MemoStats(); }
+
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
+  if (memo_ != nullptr) {
+    memo_stats_.invalidations += memo_->OnBind(var, {expr});
+  }
   PrimExpr new_expr = expr;
   new_expr = this->canonical_simplify(new_expr);
   new_expr = this->rewrite_simplify(new_expr);
@@ -58,6 +241,9 @@ void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   if (tir::is_one(range->extent)) {
     this->Bind(var, range->min, allow_override);
   } else {
+    if (memo_ != nullptr) {
+      memo_stats_.invalidations += memo_->OnBind(var, {range->min, range->extent});
+    }
     this->const_int_bound.Bind(var, range, allow_override);
     this->int_set.Bind(var, range, allow_override);
     this->transitive_comparisons.Bind(var, range, allow_override);
@@ -67,6 +253,7 @@ void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
 }
 
 void Analyzer::MarkGlobalNonNegValue(const PrimExpr& value) {
+  ClearMemo();
   // decompose value as symbol * scale + offset
   int64_t offset = 0;
   PrimExpr symbol_scale = tir::make_const(value.dtype(), 0);
@@ -130,6 +317,10 @@ void ConstraintContext::EnterWithScope() {
   recovery_functions_.push_back(analyzer_->rewrite_simplify.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->int_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->transitive_comparisons.EnterConstraint(constraint_));
+  if (analyzer_->memo_ != nullptr) {
+    analyzer_->memo_->PushScope(constraint_);
+    memo_depth_ = analyzer_->memo_->Depth();
+  }
 }
 
 void ConstraintContext::ExitWithScope() {
@@ -140,6 +331,15 @@ void ConstraintContext::ExitWithScope() {
     }
     recovery_functions_.pop_back();
   }
+  if (analyzer_->memo_ != nullptr) {
+    // The memo may have been enabled, or re-created, inside of this scope. Its outermost layer
+    // then holds results under this constraint, so the whole memo has to be dropped.
+    if (memo_depth_ > 1 && analyzer_->memo_->Depth() == memo_depth_) {
+      analyzer_->memo_stats_.invalidations += analyzer_->memo_->PopScope();
+    } else {
+      analyzer_->ClearMemo();
+    }
+  }
 }
 
 bool Analyzer::CanProveGreaterEqual(const PrimExpr& expr, int64_t lower_bound) {
@@ -189,10 +389,33 @@ bool Analyzer::CanProveLessEqualThanSymbolicShapeValue(const PrimExpr& lhs, cons
 }
 
 bool Analyzer::CanProve(const PrimExpr& expr, ProofStrength strength) {
+  ++thread_stats.can_prove_calls;
   // Avoid potentially expensive simplification unless required.
   if (const auto* ptr = expr.as<IntImmNode>()) {
     return ptr->value != 0;
   }
+  // Proofs over vscale depend on the current target, so they are not memoized.
+  if (memo_ == nullptr || ContainsVscaleCall(expr)) {
+    return CanProveImpl(expr, strength);
+  }
+  MemoTable::Key key{expr.get(), MemoTable::QueryKind::kCanProve, static_cast<int>(strength),
+                     static_cast<int64_t>(rewrite_simplify.GetEnabledExtensions())};
+  if (const PrimExpr* result = memo_->Find(key)) {
+    ++memo_stats_.hits;
+    ++thread_stats.memo_hits;
+    return tir::is_one(*result);
+  }
+  ++memo_stats_.misses;
+  ++thread_stats.memo_misses;
+  bool proved = CanProveImpl(expr, strength);
+  // The proof may have changed the context, e.g. bound variables, before reaching here.
+  if (memo_ != nullptr) {
+    memo_->Insert(key, expr, Bool(proved));
+  }
+  return proved;
+}
+
+bool Analyzer::CanProveImpl(const PrimExpr& expr, ProofStrength strength) {
   PrimExpr simplified = Simplify(expr);
   const int64_t* as_int = tir::as_const_int(simplified);
   if (as_int && *as_int) return true;
@@ -250,6 +473,27 @@ bool Analyzer::CanProve(const PrimExpr& expr, ProofStrength strength) {
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
+  ++thread_stats.simplify_calls;
+  if (memo_ == nullptr || expr->IsInstance<IntImmNode>() || ContainsVscaleCall(expr)) {
+    return SimplifyImpl(expr, steps);
+  }
+  MemoTable::Key key{expr.get(), MemoTable::QueryKind::kSimplify, steps,
+                     static_cast<int64_t>(rewrite_simplify.GetEnabledExtensions())};
+  if (const PrimExpr* result = memo_->Find(key)) {
+    ++memo_stats_.hits;
+    ++thread_stats.memo_hits;
+    return *result;
+  }
+  ++memo_stats_.misses;
+  ++thread_stats.memo_misses;
+  PrimExpr res = SimplifyImpl(expr, steps);
+  if (memo_ != nullptr) {
+    memo_->Insert(key, expr, res);
+  }
+  return res;
+}
+
+PrimExpr Analyzer::SimplifyImpl(const PrimExpr& expr, int steps) {
   PrimExpr res = expr;
 
   // Always starts with a canonical simplification, as some structural property
@@ -289,6 +533,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
         return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
           self->const_int_bound.Update(args[0].cast<Var>(), args[1].cast<ConstIntBound>(),
                                        args[2].cast<bool>());
+          self->ClearMemo();
         });
       } else if (name == "const_int_bound_is_bound") {
         return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
@@ -316,6 +561,14 @@ TVM_FFI_STATIC_INIT_BLOCK() {
         return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
           self->rewrite_simplify.ResetStatsCounters();
         });
+      } else if (name == "set_rewrite_rule_profiling_enabled") {
+        return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
+          self->rewrite_simplify.SetRuleProfilingEnabled(args[0].cast<bool>());
+        });
+      } else if (name == "get_rewrite_rule_counters") {
+        return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
+          *ret = self->rewrite_simplify.GetRuleCounters();
+        });
       } else if (name == "canonical_simplify") {
         return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
           *ret = self->canonical_simplify(args[0].cast<PrimExpr>());
@@ -350,6 +603,21 @@ TVM_FFI_STATIC_INIT_BLOCK() {
         return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
           *ret = self->CanProveEqual(args[0].cast<PrimExpr>(), args[1].cast<PrimExpr>());
         });
+      } else if (name == "set_memoization_enabled") {
+        return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
+          self->SetMemoizationEnabled(args[0].cast<bool>());
+        });
+      } else if (name == "get_memo_stats") {
+        return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
+          Analyzer::MemoStats stats = self->GetMemoStats();
+          *ret = ffi::Map<ffi::String, int64_t>({{"hits", stats.hits},
+                                                 {"misses", stats.misses},
+                                                 {"invalidations", stats.invalidations}});
+        });
+      } else if (name == "reset_memo_stats") {
+        return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
+          self->ResetMemoStats();
+        });
       } else if (name == "get_enabled_extensions") {
         return ffi::Function([self](ffi::PackedArgs args, ffi::Any* ret) {
           *ret = static_cast<std::int64_t>(self->rewrite_simplify.GetEnabledExtensions());
@@ -22,15 +22,18 @@
  * \brief The integer set functions
  */
 #include <tvm/arith/int_set.h>
+#include <tvm/arith/int_solver.h>
 #include <tvm/arith/iter_affine_map.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/expr_functor.h>
 #include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "constraint_extract.h"
@@ -1227,6 +1230,92 @@ ffi::Array<IntSet> EstimateRegionUpperBound(const ffi::Array<Range>& region,
   return result;
 }
 
+ffi::Optional<ffi::Array<IntSet>> EstimateRegionPolyhedralBound(
+    const ffi::Array<Range>& region, const ffi::Map<Var, Range>& var_dom, const PrimExpr& predicate,
+    Analyzer* analyzer) {
+  // Fourier-Motzkin elimination is doubly exponential in the worst case.
+  constexpr size_t kMaxNumVars = 8;
+  std::vector<PrimExpr> conditions =
+      ExtractConstraints(predicate, /*keep_composite_constraints=*/false);
+  auto f_used_vars = [&var_dom](const PrimExpr& expr) {
+    std::vector<Var> vars;
+    tir::PostOrderVisit(expr, [&](const ObjectRef& obj) {
+      if (const auto* var = obj.as<VarNode>()) {
+        Var v = ffi::GetRef<Var>(var);
+        if (var_dom.count(v)) {
+          vars.push_back(v);
+        }
+      }
+    });
+    return vars;
+  };
+
+  ffi::Array<IntSet> result;
+  result.reserve(region.size());
+  for (const Range& range : region) {
+    const int64_t* extent = tir::as_const_int(range->extent);
+    if (extent == nullptr) {
+      // dynamic extent is not supported yet.
+      return std::nullopt;
+    }
+    // Step 1. Collect the variables the index depends on, through their domains and through the
+    // conditions of the predicate they appear in.
+    std::vector<Var> vars;
+    std::unordered_set<const VarNode*> visited;
+    std::vector<bool> used_condition(conditions.size(), false);
+    std::vector<Var> worklist = f_used_vars(range->min);
+    while (!worklist.empty()) {
+      Var v = worklist.back();
+      worklist.pop_back();
+      if (!visited.insert(v.get()).second) {
+        continue;
+      }
+      vars.push_back(v);
+      const Range& dom = var_dom.at(v);
+      for (const PrimExpr& expr : {dom->min, dom->extent}) {
+        std::vector<Var> deps = f_used_vars(expr);
+        worklist.insert(worklist.end(), deps.begin(), deps.end());
+      }
+      for (size_t i = 0; i < conditions.size(); ++i) {
+        if (used_condition[i]) continue;
+        std::vector<Var> deps = f_used_vars(conditions[i]);
+        if (std::any_of(deps.begin(), deps.end(), [&](const Var& d) { return d.same_as(v); })) {
+          used_condition[i] = true;
+          worklist.insert(worklist.end(), deps.begin(), deps.end());
+        }
+      }
+    }
+    if (vars.size() > kMaxNumVars) {
+      return std::nullopt;
+    }
+    // Step 2. Project the polyhedron {(vars, t) | t == min, vars in their domains, predicate}
+    // onto t. The variable t is eliminated last, so its bounds refer to none of the others.
+    ffi::Array<PrimExpr> relations;
+    for (const Var& v : vars) {
+      const Range& dom = var_dom.at(v);
+      relations.push_back(v >= dom->min);
+      relations.push_back(v < dom->min + dom->extent);
+    }
+    for (size_t i = 0; i < conditions.size(); ++i) {
+      if (used_condition[i]) {
+        relations.push_back(conditions[i]);
+      }
+    }
+    Var t("t", range->min.dtype());
+    relations.push_back(t == range->min);
+    ffi::Array<Var> variables(vars.begin(), vars.end());
+    variables.push_back(t);
+    auto solved = SolveLinearInequalities(IntConstraints(variables, {}, relations));
+    Range bound = solved.first.at(t).FindBestRange();
+    if (!bound.defined() || analyzer->CanProve(bound->extent <= 0)) {
+      return std::nullopt;
+    }
+    result.push_back(IntSet::FromMinExtent(analyzer->Simplify(bound->min),
+                                           analyzer->Simplify(bound->extent + (*extent - 1))));
+  }
+  return result;
+}
+
 TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
     .set_dispatch<IntervalSetNode>([](const ObjectRef& node, ReprPrinter* p) {
       auto* op = static_cast<const IntervalSetNode*>(node.get());
@@ -1262,6 +1351,12 @@ TVM_FFI_STATIC_INIT_BLOCK() {
              Analyzer analyzer;
              return EstimateRegionUpperBound(region, var_dom, predicate, &analyzer);
            })
+      .def("arith.EstimateRegionPolyhedralBound",
+           [](ffi::Array<Range> region, ffi::Map<Var, Range> var_dom,
+              PrimExpr predicate) -> ffi::Optional<ffi::Array<IntSet>> {
+             Analyzer analyzer;
+             return EstimateRegionPolyhedralBound(region, var_dom, predicate, &analyzer);
+           })
       .def("arith.PosInf", []() { return SymbolicLimits::pos_inf_; })
       .def("arith.NegInf", []() { return SymbolicLimits::neg_inf_; })
       .def("arith.UnionLowerBound", UnionLowerBound);
@@ -23,6 +23,8 @@
 #include <tvm/arith/analyzer.h>
 #include <tvm/arith/iter_affine_map.h>
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/expr_functor.h>
@@ -30,6 +32,7 @@
 #include <tvm/tir/stmt_functor.h>
 
 #include <utility>
+#include <vector>
 
 #include "../support/utils.h"
 #include "const_fold.h"
@@ -46,6 +49,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
   IterSplitExprNode::RegisterReflection();
   IterSumExprNode::RegisterReflection();
   IterMapResultNode::RegisterReflection();
+  IterMapCacheNode::RegisterReflection();
 }
 
 IterMark::IterMark(PrimExpr source, PrimExpr extent) {
@@ -1438,10 +1442,10 @@ bool IterRangeSanityCheck(const ffi::Map<Var, Range>& iter_ranges) {
   return true;
 }
 
-IterMapResult DetectIterMap(const ffi::Array<PrimExpr>& indices,
-                            const ffi::Map<Var, Range>& input_iters, const PrimExpr& predicate,
-                            IterMapLevel check_level, arith::Analyzer* analyzer,
-                            bool simplify_trivial_iterators) {
+static IterMapResult DetectIterMapImpl(const ffi::Array<PrimExpr>& indices,
+                                       const ffi::Map<Var, Range>& input_iters,
+                                       const PrimExpr& predicate, IterMapLevel check_level,
+                                       arith::Analyzer* analyzer, bool simplify_trivial_iterators) {
   IterMapResult result;
 
   // Overall detection algorithm is divided into two steps:
@@ -1524,6 +1528,76 @@ IterMapResult DetectIterMap(const ffi::Array<PrimExpr>& indices,
   return result;
 }
 
+/*! \brief The stack of the scopes of IterMapCache on a thread */
+static std::vector<IterMapCache>* IterMapCacheStack() {
+  static thread_local std::vector<IterMapCache> stack;
+  return &stack;
+}
+
+IterMapCache::IterMapCache() { data_ = ffi::make_object<IterMapCacheNode>(); }
+
+ffi::Optional<IterMapCache> IterMapCache::Current() {
+  std::vector<IterMapCache>* stack = IterMapCacheStack();
+  if (stack->empty()) {
+    return std::nullopt;
+  }
+  return stack->back();
+}
+
+void IterMapCache::EnterWithScope() { IterMapCacheStack()->push_back(*this); }
+
+void IterMapCache::ExitWithScope() {
+  std::vector<IterMapCache>* stack = IterMapCacheStack();
+  ICHECK(!stack->empty());
+  ICHECK(stack->back().same_as(*this));
+  stack->pop_back();
+}
+
+IterMapResult DetectIterMap(const ffi::Array<PrimExpr>& indices,
+                            const ffi::Map<Var, Range>& input_iters, const PrimExpr& predicate,
+                            IterMapLevel check_level, arith::Analyzer* analyzer,
+                            bool simplify_trivial_iterators) {
+  ffi::Optional<IterMapCache> opt_cache = IterMapCache::Current();
+  if (!opt_cache.defined()) {
+    return DetectIterMapImpl(indices, input_iters, predicate, check_level, analyzer,
+                             simplify_trivial_iterators);
+  }
+  IterMapCache cache = opt_cache.value();
+  ffi::Array<ffi::Any> key{indices, input_iters, predicate, static_cast<int>(check_level),
+                           simplify_trivial_iterators};
+  uint64_t hash = StructuralHash()(key);
+  const IterMapResultNode* cached = nullptr;
+  for (const IterMapCacheNode::Entry& entry : cache->entries[hash]) {
+    if (StructuralEqual()(entry.key, key)) {
+      cached = entry.result.get();
+      break;
+    }
+  }
+  if (cached != nullptr) {
+    ++cache->num_hits;
+  } else {
+    ++cache->num_misses;
+    IterMapResult detected = DetectIterMapImpl(indices, input_iters, predicate, check_level,
+                                               analyzer, simplify_trivial_iterators);
+    cached = detected.get();
+    cache->entries[hash].push_back({key, std::move(detected)});
+  }
+  // Return a copy, as the result is mutable
+  IterMapResult result;
+  result->indices = cached->indices;
+  result->errors = cached->errors;
+  result->padding_predicate = cached->padding_predicate;
+  return result;
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("arith.IterMapCache", []() { return IterMapCache(); })
+      .def("arith.IterMapCacheEnterScope", [](IterMapCache cache) { cache.EnterWithScope(); })
+      .def("arith.IterMapCacheExitScope", [](IterMapCache cache) { cache.ExitWithScope(); });
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef().def(
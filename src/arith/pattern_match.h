@@ -69,8 +69,11 @@
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
 
+#include <algorithm>
 #include <cmath>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "const_fold.h"
 
@@ -923,6 +926,263 @@ inline std::enable_if_t<(std::is_base_of_v<Pattern<TPattern>, TPattern> && ... &
 matches_one_of(const TPattern&... patterns) {
   return PMatchesOneOf<TPattern...>(patterns...);
 }
+
+/*!
+ * \brief The node kinds told apart by the dispatch of patterns.
+ *
+ * A pattern can only match an expression whose node kind, and for a binary expression the node
+ * kinds of whose operands, are among those its outermost patterns accept. Checking that on the
+ * signature of the expression, computed once, lets a long list of rules skip most patterns
+ * without initializing and matching them.
+ */
+enum PNodeKind : int {
+  kPAdd,
+  kPSub,
+  kPMul,
+  kPDiv,
+  kPMod,
+  kPFloorDiv,
+  kPFloorMod,
+  kPMin,
+  kPMax,
+  kPEQ,
+  kPNE,
+  kPLT,
+  kPLE,
+  kPGT,
+  kPGE,
+  kPAnd,
+  kPOr,
+  kPNot,
+  kPSelect,
+  kPCast,
+  kPRamp,
+  kPBroadcast,
+  kPCall,
+  kPIntImm,
+  kPFloatImm,
+  kPOtherKind,
+};
+
+/*! \brief A set of node kinds, as a bitmask */
+using PNodeKindMask = uint32_t;
+/*! \brief The set of all the node kinds */
+constexpr PNodeKindMask kPAnyKind = ~PNodeKindMask(0);
+
+constexpr PNodeKindMask PKindBit(PNodeKind kind) { return PNodeKindMask(1) << kind; }
+
+/*! \brief Get the node kind of an expression */
+inline PNodeKind GetPNodeKind(const Object* node) {
+  static const std::vector<int8_t> table = []() {
+    std::pair<int32_t, PNodeKind> kinds[] = {
+        {tir::AddNode::RuntimeTypeIndex(), kPAdd},
+        {tir::SubNode::RuntimeTypeIndex(), kPSub},
+        {tir::MulNode::RuntimeTypeIndex(), kPMul},
+        {tir::DivNode::RuntimeTypeIndex(), kPDiv},
+        {tir::ModNode::RuntimeTypeIndex(), kPMod},
+        {tir::FloorDivNode::RuntimeTypeIndex(), kPFloorDiv},
+        {tir::FloorModNode::RuntimeTypeIndex(), kPFloorMod},
+        {tir::MinNode::RuntimeTypeIndex(), kPMin},
+        {tir::MaxNode::RuntimeTypeIndex(), kPMax},
+        {tir::EQNode::RuntimeTypeIndex(), kPEQ},
+        {tir::NENode::RuntimeTypeIndex(), kPNE},
+        {tir::LTNode::RuntimeTypeIndex(), kPLT},
+        {tir::LENode::RuntimeTypeIndex(), kPLE},
+        {tir::GTNode::RuntimeTypeIndex(), kPGT},
+        {tir::GENode::RuntimeTypeIndex(), kPGE},
+        {tir::AndNode::RuntimeTypeIndex(), kPAnd},
+        {tir::OrNode::RuntimeTypeIndex(), kPOr},
+        {tir::NotNode::RuntimeTypeIndex(), kPNot},
+        {tir::SelectNode::RuntimeTypeIndex(), kPSelect},
+        {tir::CastNode::RuntimeTypeIndex(), kPCast},
+        {tir::RampNode::RuntimeTypeIndex(), kPRamp},
+        {tir::BroadcastNode::RuntimeTypeIndex(), kPBroadcast},
+        {tir::CallNode::RuntimeTypeIndex(), kPCall},
+        {IntImmNode::RuntimeTypeIndex(), kPIntImm},
+        {FloatImmNode::RuntimeTypeIndex(), kPFloatImm},
+    };
+    int32_t max_index = 0;
+    for (const auto& kv : kinds) {
+      max_index = std::max(max_index, kv.first);
+    }
+    std::vector<int8_t> table(max_index + 1, kPOtherKind);
+    for (const auto& kv : kinds) {
+      table[kv.first] = kv.second;
+    }
+    return table;
+  }();
+  if (node == nullptr) {
+    return kPOtherKind;
+  }
+  int32_t index = node->type_index();
+  return index < static_cast<int32_t>(table.size()) ? static_cast<PNodeKind>(table[index])
+                                                    : kPOtherKind;
+}
+
+/*! \brief The node kinds of an expression and of its operands, if it is a binary expression */
+struct PNodeSignature {
+  PNodeKindMask node{kPAnyKind};
+  PNodeKindMask a{kPAnyKind};
+  PNodeKindMask b{kPAnyKind};
+
+  PNodeSignature() = default;
+
+  explicit PNodeSignature(const ObjectRef& expr) {
+    const Object* ptr = expr.get();
+    PNodeKind kind = GetPNodeKind(ptr);
+    node = PKindBit(kind);
+    switch (kind) {
+#define TVM_PATTERN_SIGNATURE_OPERANDS(Kind, NodeName) \
+  case Kind:                                           \
+    SetOperands(static_cast<const NodeName*>(ptr));    \
+    break;
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPAdd, tir::AddNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPSub, tir::SubNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPMul, tir::MulNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPDiv, tir::DivNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPMod, tir::ModNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPFloorDiv, tir::FloorDivNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPFloorMod, tir::FloorModNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPMin, tir::MinNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPMax, tir::MaxNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPEQ, tir::EQNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPNE, tir::NENode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPLT, tir::LTNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPLE, tir::LENode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPGT, tir::GTNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPGE, tir::GENode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPAnd, tir::AndNode)
+      TVM_PATTERN_SIGNATURE_OPERANDS(kPOr, tir::OrNode)
+#undef TVM_PATTERN_SIGNATURE_OPERANDS
+      default:
+        break;
+    }
+  }
+
+ private:
+  template <typename NodeType>
+  void SetOperands(const NodeType* op) {
+    a = PKindBit(GetPNodeKind(op->a.get()));
+    b = PKindBit(GetPNodeKind(op->b.get()));
+  }
+};
+
+/*! \brief The node kind of the expressions a binary expression pattern can match */
+template <typename OpType>
+struct PBinaryOpKind {
+  static constexpr PNodeKindMask mask = kPAnyKind;
+};
+
+#define TVM_PATTERN_BINARY_OP_KIND(OpType, Kind)         \
+  template <>                                             \
+  struct PBinaryOpKind<OpType> {                          \
+    static constexpr PNodeKindMask mask = PKindBit(Kind); \
+  }
+
+TVM_PATTERN_BINARY_OP_KIND(tir::Add, kPAdd);
+TVM_PATTERN_BINARY_OP_KIND(tir::Sub, kPSub);
+TVM_PATTERN_BINARY_OP_KIND(tir::Mul, kPMul);
+TVM_PATTERN_BINARY_OP_KIND(tir::Div, kPDiv);
+TVM_PATTERN_BINARY_OP_KIND(tir::Mod, kPMod);
+TVM_PATTERN_BINARY_OP_KIND(tir::FloorDiv, kPFloorDiv);
+TVM_PATTERN_BINARY_OP_KIND(tir::FloorMod, kPFloorMod);
+TVM_PATTERN_BINARY_OP_KIND(tir::Min, kPMin);
+TVM_PATTERN_BINARY_OP_KIND(tir::Max, kPMax);
+TVM_PATTERN_BINARY_OP_KIND(tir::EQ, kPEQ);
+TVM_PATTERN_BINARY_OP_KIND(tir::NE, kPNE);
+TVM_PATTERN_BINARY_OP_KIND(tir::LT, kPLT);
+TVM_PATTERN_BINARY_OP_KIND(tir::LE, kPLE);
+TVM_PATTERN_BINARY_OP_KIND(tir::GT, kPGT);
+TVM_PATTERN_BINARY_OP_KIND(tir::GE, kPGE);
+TVM_PATTERN_BINARY_OP_KIND(tir::And, kPAnd);
+TVM_PATTERN_BINARY_OP_KIND(tir::Or, kPOr);
+#undef TVM_PATTERN_BINARY_OP_KIND
+
+/*!
+ * \brief The node kinds of the expressions a pattern can match.
+ * \note The default of all the node kinds is always safe, as the kinds are only used to skip.
+ */
+template <typename TPattern>
+struct PPatternKind {
+  static constexpr PNodeKindMask mask = kPAnyKind;
+};
+
+template <>
+struct PPatternKind<PVar<IntImm>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPIntImm);
+};
+
+template <>
+struct PPatternKind<PVar<FloatImm>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPFloatImm);
+};
+
+template <typename TA>
+struct PPatternKind<PConstWithTypeLike<TA>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPIntImm);
+};
+
+template <typename OpType, typename TA, typename TB>
+struct PPatternKind<PBinaryExpr<OpType, TA, TB>> {
+  static constexpr PNodeKindMask mask = PBinaryOpKind<OpType>::mask;
+};
+
+template <typename TA>
+struct PPatternKind<PNotExpr<TA>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPNot);
+};
+
+template <typename TCond, typename TA, typename TB>
+struct PPatternKind<PSelectExpr<TCond, TA, TB>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPSelect);
+};
+
+template <typename DType, typename TA>
+struct PPatternKind<PCastExpr<DType, TA>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPCast);
+};
+
+template <typename TBase, typename TStride, typename TLanes>
+struct PPatternKind<PRampExpr<TBase, TStride, TLanes>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPRamp);
+};
+
+template <typename TA, typename TLanes>
+struct PPatternKind<PBroadcastExpr<TA, TLanes>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPBroadcast);
+};
+
+template <typename Op, typename... TArgs>
+struct PPatternKind<PCallExpr<Op, TArgs...>> {
+  static constexpr PNodeKindMask mask = PKindBit(kPCall);
+};
+
+/*! \brief Check cheaply whether a pattern may match an expression with the given signature */
+template <typename TPattern>
+struct PDispatch {
+  static bool MayMatch(const PNodeSignature& sig) {
+    return (PPatternKind<TPattern>::mask & sig.node) != 0;
+  }
+};
+
+template <typename OpType, typename TA, typename TB>
+struct PDispatch<PBinaryExpr<OpType, TA, TB>> {
+  static bool MayMatch(const PNodeSignature& sig) {
+    if constexpr (PBinaryOpKind<OpType>::mask == kPAnyKind) {
+      return true;
+    } else {
+      return (PBinaryOpKind<OpType>::mask & sig.node) != 0 &&
+             (PPatternKind<TA>::mask & sig.a) != 0 && (PPatternKind<TB>::mask & sig.b) != 0;
+    }
+  }
+};
+
+template <typename... TPattern>
+struct PDispatch<PMatchesOneOf<TPattern...>> {
+  static bool MayMatch(const PNodeSignature& sig) {
+    return (PDispatch<TPattern>::MayMatch(sig) || ...);
+  }
+};
 }  // namespace arith
 }  // namespace tvm
 #endif  // TVM_ARITH_PATTERN_MATCH_H_
@@ -59,36 +59,47 @@ TVM_FFI_STATIC_INIT_BLOCK() { RewriteSimplifierStatsNode::RegisterReflection();
 //     TVM_TRY_REWRITE(matches_one_of(floormod(x*c1,c2), floormod(x*c1 + c3, c2)),
 //                     floormod(x*floormod(c1,c2) + floormod(c3,c2), c2))
 
+// The rules are dispatched on the node kinds of `ret` and of its operands: a rule whose source
+// pattern cannot match them is skipped before initializing and matching the pattern.
+
 // macro for doing simple rewrite
-#define TVM_TRY_REWRITE(SrcExpr, ResExpr) \
-  RecordAttemptedRewrite();               \
-  if ((SrcExpr).Match(ret)) {             \
-    RecordRewrite();                      \
-    return (ResExpr).Eval();              \
+#define TVM_TRY_REWRITE(SrcExpr, ResExpr)                        \
+  if (RuleMayMatch<std::decay_t<decltype(SrcExpr)>>(ret)) {      \
+    RecordAttemptedRewrite(__LINE__);                            \
+    if ((SrcExpr).Match(ret)) {                                  \
+      RecordRewrite(__LINE__);                                   \
+      return (ResExpr).Eval();                                   \
+    }                                                            \
   }
 
 // macro for rewrite + recursively rewrite ResExpr
-#define TVM_TRY_RECURSIVE_REWRITE(SrcExpr, ResExpr) \
-  RecordAttemptedRewrite();                         \
-  if ((SrcExpr).Match(ret)) {                       \
-    RecordRewrite();                                \
-    return RecursiveRewrite((ResExpr).Eval());      \
+#define TVM_TRY_RECURSIVE_REWRITE(SrcExpr, ResExpr)              \
+  if (RuleMayMatch<std::decay_t<decltype(SrcExpr)>>(ret)) {      \
+    RecordAttemptedRewrite(__LINE__);                            \
+    if ((SrcExpr).Match(ret)) {                                  \
+      RecordRewrite(__LINE__);                                   \
+      return RecursiveRewrite((ResExpr).Eval());                 \
+    }                                                            \
   }
 
 // macro rewrite only if CondExor is true after match.
-#define TVM_TRY_REWRITE_IF(SrcExpr, ResExpr, CondExpr)      \
-  RecordAttemptedRewrite();                                 \
-  if ((SrcExpr).Match(ret, [&]() { return (CondExpr); })) { \
-    RecordRewrite();                                        \
-    return (ResExpr).Eval();                                \
+#define TVM_TRY_REWRITE_IF(SrcExpr, ResExpr, CondExpr)           \
+  if (RuleMayMatch<std::decay_t<decltype(SrcExpr)>>(ret)) {      \
+    RecordAttemptedRewrite(__LINE__);                            \
+    if ((SrcExpr).Match(ret, [&]() { return (CondExpr); })) {    \
+      RecordRewrite(__LINE__);                                   \
+      return (ResExpr).Eval();                                   \
+    }                                                            \
   }
 
 // macro rewrite + recursive_rewrite only if CondExor is true after match.
 #define TVM_TRY_RECURSIVE_REWRITE_IF(SrcExpr, ResExpr, CondExpr) \
-  RecordAttemptedRewrite();                                      \
-  if ((SrcExpr).Match(ret, [&]() { return (CondExpr); })) {      \
-    RecordRewrite();                                             \
-    return RecursiveRewrite((ResExpr).Eval());                   \
+  if (RuleMayMatch<std::decay_t<decltype(SrcExpr)>>(ret)) {      \
+    RecordAttemptedRewrite(__LINE__);                            \
+    if ((SrcExpr).Match(ret, [&]() { return (CondExpr); })) {    \
+      RecordRewrite(__LINE__);                                   \
+      return RecursiveRewrite((ResExpr).Eval());                 \
+    }                                                            \
   }
 
 // NOTE for developers:
@@ -2419,6 +2430,14 @@ ObjectRef RewriteSimplifier::GetStatsCounters() const { return impl_->GetStatsCo
 
 void RewriteSimplifier::ResetStatsCounters() { impl_->ResetStatsCounters(); }
 
+void RewriteSimplifier::SetRuleProfilingEnabled(bool enabled) {
+  impl_->SetRuleProfilingEnabled(enabled);
+}
+
+ffi::Map<ffi::String, ffi::Array<Integer>> RewriteSimplifier::GetRuleCounters() const {
+  return impl_->GetRuleCounters();
+}
+
 void RewriteSimplifier::SetMaximumRewriteSteps(int64_t maximum) {
   impl_->SetMaximumRewriteSteps(maximum);
 }
@@ -2434,6 +2453,7 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
                 << ", constraints_entered = " << ptr->constraints_entered
                 << ", rewrites_attempted = " << ptr->rewrites_attempted
                 << ", rewrites_performed = " << ptr->rewrites_performed
+                << ", rewrites_skipped = " << ptr->rewrites_skipped
                 << ", max_recursive_depth = " << ptr->max_recursive_depth
                 << ", num_recursive_rewrites = " << ptr->num_recursive_rewrites << ")";
     });
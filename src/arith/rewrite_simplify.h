@@ -29,7 +29,9 @@
 #include <tvm/tir/op.h>
 
 #include <algorithm>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "const_fold.h"
@@ -51,6 +53,7 @@ struct RewriteSimplifierStatsNode : Object {
   int64_t constraints_entered{0};
   int64_t rewrites_attempted{0};
   int64_t rewrites_performed{0};
+  int64_t rewrites_skipped{0};
   int64_t max_recursive_depth{0};
   int64_t num_recursive_rewrites{0};
 
@@ -61,6 +64,7 @@ struct RewriteSimplifierStatsNode : Object {
         .def_ro("constraints_entered", &RewriteSimplifierStatsNode::constraints_entered)
         .def_ro("rewrites_attempted", &RewriteSimplifierStatsNode::rewrites_attempted)
         .def_ro("rewrites_performed", &RewriteSimplifierStatsNode::rewrites_performed)
+        .def_ro("rewrites_skipped", &RewriteSimplifierStatsNode::rewrites_skipped)
         .def_ro("max_recursive_depth", &RewriteSimplifierStatsNode::max_recursive_depth)
         .def_ro("num_recursive_rewrites", &RewriteSimplifierStatsNode::num_recursive_rewrites);
   }
@@ -130,7 +134,22 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
 
   RewriteSimplifierStats GetStatsCounters() const { return RewriteSimplifierStats(stats_); }
 
-  void ResetStatsCounters() { stats_ = {}; }
+  void ResetStatsCounters() {
+    stats_ = {};
+    rule_counters_.clear();
+  }
+
+  void SetRuleProfilingEnabled(bool enabled) { rule_profiling_enabled_ = enabled; }
+
+  /*! \brief The numbers of attempts and of rewrites of each rule, keyed by its source line */
+  ffi::Map<ffi::String, ffi::Array<Integer>> GetRuleCounters() const {
+    ffi::Map<ffi::String, ffi::Array<Integer>> result;
+    for (const auto& kv : rule_counters_) {
+      result.Set("rewrite_simplify.cc:" + std::to_string(kv.first),
+                 {Integer(kv.second.first), Integer(kv.second.second)});
+    }
+    return result;
+  }
 
   void SetMaximumRewriteSteps(int64_t maximum) { maximum_rewrite_steps_ = maximum; }
 
@@ -138,15 +157,50 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
   int64_t maximum_rewrite_steps_{0};
   RewriteSimplifierStatsNode stats_;
 
-  void RecordAttemptedRewrite() { stats_.rewrites_attempted++; }
-  void RecordRewrite() {
+  /*!
+   * \brief Check cheaply whether a rule may match an expression, from the node kinds of the
+   * expression and of its operands.
+   * \tparam TPattern The source pattern of the rule.
+   */
+  template <typename TPattern>
+  bool RuleMayMatch(const PrimExpr& expr) {
+    if (!expr.same_as(dispatch_expr_)) {
+      dispatch_expr_ = expr;
+      dispatch_signature_ = PNodeSignature(expr);
+    }
+    if (PDispatch<TPattern>::MayMatch(dispatch_signature_)) {
+      return true;
+    }
+    stats_.rewrites_skipped++;
+    return false;
+  }
+
+  void RecordAttemptedRewrite(int rule) {
+    stats_.rewrites_attempted++;
+    if (rule_profiling_enabled_) {
+      rule_counters_[rule].first++;
+    }
+  }
+  void RecordRewrite(int rule) {
     stats_.rewrites_performed++;
+    if (rule_profiling_enabled_) {
+      rule_counters_[rule].second++;
+    }
 
     ICHECK(maximum_rewrite_steps_ <= 0 || stats_.rewrites_performed <= maximum_rewrite_steps_)
         << "RewriteSimplifier exceeded maximum number of rewrites allowed ("
         << maximum_rewrite_steps_ << ")";
   }
 
+  /*! \brief Whether to count the attempts and the rewrites of each rule */
+  bool rule_profiling_enabled_{false};
+  /*! \brief The numbers of attempts and of rewrites of each rule, keyed by its source line */
+  std::unordered_map<int, std::pair<int64_t, int64_t>> rule_counters_;
+  /*! \brief The expression whose signature was computed last, for the dispatch of the rules */
+  PrimExpr dispatch_expr_;
+  /*! \brief The signature of dispatch_expr_ */
+  PNodeSignature dispatch_signature_;
+
   // counter to record recursive rewrite depth.
   int64_t recur_depth_{0};
   // internal variable map
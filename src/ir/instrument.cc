@@ -22,13 +22,26 @@
  * \brief Infrastructure for instrumentation.
  */
 #include <dmlc/thread_local.h>
+#include <tvm/arith/analyzer.h>
 #include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/accessor.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
 #include <tvm/node/repr_printer.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <optional>
+#include <sstream>
 #include <stack>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../support/pooled_object_allocator.h"
 
 namespace tvm {
 namespace instrument {
@@ -196,6 +209,92 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
       p->stream << node->name;
     });
 
+/*!
+ * \brief The counters of the resources used by a thread, which the resource instrument
+ *  attributes to the passes. Each counter only grows, so a pass uses the difference between
+ *  its exit and its entry.
+ */
+struct PassResources {
+  enum Metric : int {
+    kAllocObjects,
+    kAllocBytes,
+    kSimplifyCalls,
+    kCanProveCalls,
+    kAnalyzerMemoHits,
+    kAnalyzerMemoMisses,
+    kMutatorCopies,
+    kNeedlessMutatorCopies,
+    kNumMetrics,
+  };
+  static constexpr const char* kNames[kNumMetrics] = {
+      "alloc_objects",      "alloc_bytes",          "simplify_calls", "can_prove_calls",
+      "analyzer_memo_hits", "analyzer_memo_misses", "mutator_copies", "needless_mutator_copies",
+  };
+
+  std::array<int64_t, kNumMetrics> values{};
+
+  /*! \brief The counters of the current thread. */
+  static PassResources Now() {
+    PassResources res;
+    const support::NodeAllocationCounter& alloc = support::thread_node_allocation_counter;
+    arith::Analyzer::ThreadStats analyzer = arith::Analyzer::GetThreadStats();
+    tir::MutatorCopyStats copies = tir::GetMutatorCopyStats();
+    res.values = {alloc.num_objects,        alloc.num_bytes,    analyzer.simplify_calls,
+                  analyzer.can_prove_calls, analyzer.memo_hits, analyzer.memo_misses,
+                  copies.num_copies,        copies.num_needless_copies};
+    return res;
+  }
+
+  PassResources operator-(const PassResources& other) const {
+    PassResources res;
+    for (int i = 0; i < kNumMetrics; ++i) {
+      res.values[i] = values[i] - other.values[i];
+    }
+    return res;
+  }
+};
+
+/*! \brief Count the distinct IR nodes reachable from the functions of a module. */
+int64_t CountIRNodes(const IRModule& mod) {
+  std::unordered_set<const Object*> visited;
+  std::vector<const Object*> stack;
+  auto push = [&](const Any& value) {
+    if (std::optional<ObjectRef> opt = value.as<ObjectRef>()) {
+      if (opt->defined() && visited.insert(opt->get()).second) {
+        stack.push_back(opt->get());
+      }
+    }
+  };
+  for (const auto& kv : mod->functions) {
+    push(kv.second);
+  }
+  // The nodes stay alive through the module, so the traversal can hold raw pointers.
+  while (!stack.empty()) {
+    const Object* obj = stack.back();
+    stack.pop_back();
+    if (const auto* array = obj->as<ffi::ArrayObj>()) {
+      for (const Any& element : *array) {
+        push(element);
+      }
+    } else if (const auto* map = obj->as<ffi::MapObj>()) {
+      for (const auto& kv : *map) {
+        push(kv.first);
+        push(kv.second);
+      }
+    } else {
+      const TVMFFITypeInfo* tinfo = TVMFFIGetTypeInfo(obj->type_index());
+      if (tinfo->metadata != nullptr) {
+        ffi::reflection::ForEachFieldInfo(tinfo, [&](const TVMFFIFieldInfo* field_info) {
+          push(ffi::reflection::FieldGetter(field_info)(obj));
+        });
+      }
+    }
+  }
+  return static_cast<int64_t>(visited.size());
+}
+
+struct PassProfileThreadLocalEntry;
+
 /*! \brief PassProfile stores profiling information for a given pass and its sub-passes. */
 struct PassProfile {
   // TODO(@altanh): expose PassProfile through TVM Object API
@@ -213,16 +312,23 @@ struct PassProfile {
   Duration duration;
   /*! \brief PassProfiles for all sub-passes invoked during the execution of the pass. */
   std::vector<PassProfile> children;
+  /*! \brief The resource counters when the pass was entered, if tracked. */
+  PassResources start_resources;
+  /*! \brief The resources used by the pass and its sub-passes, if tracked. */
+  PassResources resources;
+  /*! \brief The number of IR nodes before and after the pass, if tracked. */
+  int64_t nodes_before{0};
+  int64_t nodes_after{0};
 
   explicit PassProfile(ffi::String name)
       : name(name), start(Clock::now()), end(Clock::now()), children() {}
 
   /*! \brief Gets the PassProfile of the currently executing pass. */
-  static PassProfile* Current();
+  static PassProfile* Current(PassProfileThreadLocalEntry* entry);
   /*! \brief Pushes a new PassProfile with the given pass name. */
-  static void EnterPass(ffi::String name);
+  static void EnterPass(PassProfileThreadLocalEntry* entry, ffi::String name);
   /*! \brief Pops the current PassProfile. */
-  static void ExitPass();
+  static void ExitPass(PassProfileThreadLocalEntry* entry);
 };
 
 struct PassProfileThreadLocalEntry {
@@ -237,22 +343,26 @@ struct PassProfileThreadLocalEntry {
 /*! \brief Thread local store to hold the pass profiling data. */
 typedef dmlc::ThreadLocalStore<PassProfileThreadLocalEntry> PassProfileThreadLocalStore;
 
-void PassProfile::EnterPass(ffi::String name) {
-  PassProfile* cur = PassProfile::Current();
+/*! \brief The profiles of the resource instrument, kept apart from those of the timing one. */
+struct PassResourceProfileThreadLocalEntry : public PassProfileThreadLocalEntry {};
+typedef dmlc::ThreadLocalStore<PassResourceProfileThreadLocalEntry>
+    PassResourceProfileThreadLocalStore;
+
+void PassProfile::EnterPass(PassProfileThreadLocalEntry* entry, ffi::String name) {
+  PassProfile* cur = PassProfile::Current(entry);
   cur->children.emplace_back(name);
-  PassProfileThreadLocalStore::Get()->profile_stack.push(&cur->children.back());
+  entry->profile_stack.push(&cur->children.back());
 }
 
-void PassProfile::ExitPass() {
-  PassProfile* cur = PassProfile::Current();
+void PassProfile::ExitPass(PassProfileThreadLocalEntry* entry) {
+  PassProfile* cur = PassProfile::Current(entry);
   ICHECK_NE(cur->name, "root") << "mismatched enter/exit for pass profiling";
   cur->end = PassProfile::Clock::now();
   cur->duration = std::chrono::duration_cast<PassProfile::Duration>(cur->end - cur->start);
-  PassProfileThreadLocalStore::Get()->profile_stack.pop();
+  entry->profile_stack.pop();
 }
 
-PassProfile* PassProfile::Current() {
-  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+PassProfile* PassProfile::Current(PassProfileThreadLocalEntry* entry) {
   if (!entry->profile_stack.empty()) {
     return entry->profile_stack.top();
   } else {
@@ -318,12 +428,12 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def("instrument.RenderTimePassProfiles", RenderPassProfiles)
       .def("instrument.MakePassTimingInstrument", []() {
         auto run_before_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
-          PassProfile::EnterPass(pass_info->name);
+          PassProfile::EnterPass(PassProfileThreadLocalStore::Get(), pass_info->name);
           return true;
         };
 
         auto run_after_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
-          PassProfile::ExitPass();
+          PassProfile::ExitPass(PassProfileThreadLocalStore::Get());
         };
 
         auto exit_pass_ctx = []() { PassProfileThreadLocalStore::Get()->root.children.clear(); };
@@ -334,5 +444,129 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       });
 }
 
+/*!
+ * \brief Get the resource profiles of the passes in pre-order, each with the path of its
+ *  enclosing passes, its duration, its IR node counts and its resource counters, which include
+ *  those of its sub-passes.
+ */
+ffi::Array<ffi::Map<ffi::String, Any>> GetPassResourceProfiles() {
+  PassProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+  CHECK(entry->profile_stack.empty()) << "cannot get the pass profiles while still in a pass!";
+  ffi::Array<ffi::Map<ffi::String, Any>> result;
+  std::function<void(const PassProfile&, const std::string&, int)> visit =
+      [&](const PassProfile& profile, const std::string& parent_path, int depth) {
+        std::string path = parent_path.empty() ? std::string(profile.name)
+                                               : parent_path + ";" + std::string(profile.name);
+        ffi::Map<ffi::String, Any> record;
+        record.Set("name", profile.name);
+        record.Set("path", path);
+        record.Set("depth", depth);
+        record.Set("duration_us", profile.duration.count());
+        record.Set("nodes_before", profile.nodes_before);
+        record.Set("nodes_after", profile.nodes_after);
+        for (int i = 0; i < PassResources::kNumMetrics; ++i) {
+          record.Set(PassResources::kNames[i], profile.resources.values[i]);
+        }
+        result.push_back(record);
+        for (const PassProfile& child : profile.children) {
+          visit(child, path, depth + 1);
+        }
+      };
+  for (const PassProfile& profile : entry->root.children) {
+    visit(profile, "", 0);
+  }
+  return result;
+}
+
+/*!
+ * \brief Render the resource profiles in the folded stack format of flamegraph.pl and speedscope,
+ *  one line per pass with the semicolon-separated path of the pass and its own usage of the
+ *  metric, excluding that of its sub-passes.
+ * \param metric "duration_us", "nodes_delta" or the name of a resource counter.
+ */
+ffi::String RenderPassResourceFlameGraph(ffi::String metric) {
+  PassProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+  CHECK(entry->profile_stack.empty()) << "cannot render the pass profiles while still in a pass!";
+  std::function<int64_t(const PassProfile&)> value_of;
+  if (metric == "duration_us") {
+    value_of = [](const PassProfile& p) { return static_cast<int64_t>(p.duration.count()); };
+  } else if (metric == "nodes_delta") {
+    value_of = [](const PassProfile& p) { return p.nodes_after - p.nodes_before; };
+  } else {
+    const char* const* it = std::find_if(
+        std::begin(PassResources::kNames), std::end(PassResources::kNames),
+        [&](const char* name) { return metric == name; });
+    CHECK(it != std::end(PassResources::kNames))
+        << "ValueError: Unknown pass profile metric " << metric;
+    int index = static_cast<int>(it - std::begin(PassResources::kNames));
+    value_of = [index](const PassProfile& p) { return p.resources.values[index]; };
+  }
+  std::ostringstream os;
+  std::function<void(const PassProfile&, const std::string&)> visit =
+      [&](const PassProfile& profile, const std::string& parent_path) {
+        std::string path = parent_path.empty() ? std::string(profile.name)
+                                               : parent_path + ";" + std::string(profile.name);
+        int64_t self_value = value_of(profile);
+        for (const PassProfile& child : profile.children) {
+          self_value -= value_of(child);
+          visit(child, path);
+        }
+        // The folded format only takes non-negative weights, e.g. a pass shrinking the IR.
+        if (self_value > 0) {
+          os << path << ' ' << self_value << '\n';
+        }
+      };
+  for (const PassProfile& profile : entry->root.children) {
+    visit(profile, "");
+  }
+  return os.str();
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("instrument.GetPassResourceProfiles", GetPassResourceProfiles)
+      .def("instrument.RenderPassResourceFlameGraph", RenderPassResourceFlameGraph)
+      .def("instrument.MakePassResourceInstrument", [](bool check_needless_copies) {
+        auto run_before_pass = [](const IRModule& mod, const transform::PassInfo& pass_info) {
+          PassProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+          // Count the nodes first, so that the traversal is not attributed to the pass.
+          int64_t nodes_before = CountIRNodes(mod);
+          PassProfile::EnterPass(entry, pass_info->name);
+          PassProfile* cur = PassProfile::Current(entry);
+          cur->nodes_before = nodes_before;
+          cur->start_resources = PassResources::Now();
+          cur->start = PassProfile::Clock::now();
+          return true;
+        };
+
+        auto run_after_pass = [](const IRModule& mod, const transform::PassInfo& pass_info) {
+          PassProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+          PassProfile* cur = PassProfile::Current(entry);
+          cur->resources = PassResources::Now() - cur->start_resources;
+          PassProfile::ExitPass(entry);
+          cur->nodes_after = CountIRNodes(mod);
+        };
+
+        // The check of needless copies is thread-local, so it is enabled on the thread that
+        // enters the pass context.
+        auto enter_pass_ctx = [check_needless_copies]() {
+          if (check_needless_copies) {
+            tir::SetMutatorNeedlessCopyCheck(true);
+          }
+        };
+
+        auto exit_pass_ctx = [check_needless_copies]() {
+          if (check_needless_copies) {
+            tir::SetMutatorNeedlessCopyCheck(false);
+          }
+          PassResourceProfileThreadLocalStore::Get()->root.children.clear();
+        };
+
+        return BasePassInstrument("PassResourceInstrument", enter_pass_ctx, exit_pass_ctx,
+                                  /* should_run */ nullptr, run_before_pass, run_after_pass);
+      });
+}
+
 }  // namespace instrument
 }  // namespace tvm
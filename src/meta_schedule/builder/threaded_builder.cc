@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/extra/module.h>
+#include <tvm/ffi/reflection/registry.h>
+
+#include <string>
+#include <vector>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief A builder that builds the inputs in the current process on a thread pool. */
+class ThreadedBuilderNode : public BuilderNode {
+ public:
+  /*! \brief The number of threads to build with. */
+  int num_threads;
+  /*! \brief The function that builds an IRModule into a runtime module. */
+  ffi::Function f_build;
+  /*! \brief The function that exports a runtime module and returns the artifact path. */
+  ffi::Function f_export;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<ThreadedBuilderNode>()
+        .def_ro("num_threads", &ThreadedBuilderNode::num_threads)
+        .def_ro("f_build", &ThreadedBuilderNode::f_build)
+        .def_ro("f_export", &ThreadedBuilderNode::f_export);
+  }
+
+  ffi::Array<BuilderResult> Build(const ffi::Array<BuilderInput>& build_inputs) final {
+    int n = build_inputs.size();
+    std::vector<ffi::Optional<ffi::String>> artifact_paths(n, std::nullopt);
+    std::vector<ffi::Optional<ffi::String>> error_msgs(n, std::nullopt);
+    auto f_worker = [&](int, int task_id) -> void {
+      const BuilderInput& input = build_inputs[task_id];
+      try {
+        ffi::Module rt_mod = f_build(input->mod, input->target, input->params).cast<ffi::Module>();
+        artifact_paths[task_id] = f_export(rt_mod).cast<ffi::String>();
+      } catch (const std::exception& e) {
+        error_msgs[task_id] = "ThreadedBuilder: An exception occurred\n" + std::string(e.what());
+      }
+    };
+    support::parallel_for_dynamic(0, n, num_threads, f_worker);
+    ffi::Array<BuilderResult> results;
+    results.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      results.push_back(BuilderResult(artifact_paths[i], error_msgs[i]));
+    }
+    return results;
+  }
+
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.ThreadedBuilder", ThreadedBuilderNode,
+                                    BuilderNode);
+};
+
+Builder Builder::ThreadedBuilder(int num_threads, ffi::Function f_build, ffi::Function f_export) {
+  CHECK_GT(num_threads, 0) << "ValueError: `num_threads` must be positive";
+  CHECK(f_build != nullptr) << "ValueError: `f_build` is not defined";
+  CHECK(f_export != nullptr) << "ValueError: `f_export` is not defined";
+  ObjectPtr<ThreadedBuilderNode> n = ffi::make_object<ThreadedBuilderNode>();
+  n->num_threads = num_threads;
+  n->f_build = std::move(f_build);
+  n->f_export = std::move(f_export);
+  return Builder(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  ThreadedBuilderNode::RegisterReflection();
+  refl::GlobalDef().def("meta_schedule.BuilderThreadedBuilder", Builder::ThreadedBuilder);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -18,6 +18,11 @@
  */
 #include <tvm/ffi/reflection/registry.h>
 
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 #include "../utils.h"
 
 namespace tvm {
@@ -48,6 +53,66 @@ std::vector<double> PyCostModelNode::Predict(const TuneContext& context,
   return result;
 }
 
+void CostModelNode::Pretrain(const Database& database, int num_threads) {
+  // Group the records by workload and target, which determine the tuning context.
+  std::vector<std::pair<Workload, Target>> keys;
+  std::vector<std::vector<TuningRecord>> groups;
+  std::unordered_map<std::string, size_t> key2group;
+  for (const TuningRecord& record : database->GetAllTuningRecords()) {
+    if (!record->target.defined() || !record->IsValid()) {
+      continue;
+    }
+    Target target = record->target.value();
+    std::ostringstream os;
+    os << record->workload.get() << " " << target->str();
+    auto [it, inserted] = key2group.emplace(os.str(), groups.size());
+    if (inserted) {
+      keys.emplace_back(record->workload, target);
+      groups.emplace_back();
+    }
+    groups[it->second].push_back(record);
+  }
+  for (size_t i = 0; i < groups.size(); ++i) {
+    const auto& [workload, target] = keys[i];
+    const std::vector<TuningRecord>& records = groups[i];
+    int n = records.size();
+    // Replay the traces, skipping the records whose traces no longer apply.
+    std::vector<ffi::Optional<tir::Schedule>> schs(n, std::nullopt);
+    support::parallel_for_dynamic(0, n, num_threads, [&](int thread_id, int task_id) {
+      tir::Schedule sch =
+          tir::Schedule::Traced(workload->mod, /*seed=*/-1, /*debug_mask=*/0,
+                                /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+      try {
+        records[task_id]->trace->ApplyToSchedule(sch, /*remove_postproc=*/false);
+      } catch (const std::exception& e) {
+        return;
+      }
+      schs[task_id] = sch;
+    });
+    ffi::Array<MeasureCandidate> candidates;
+    ffi::Array<RunnerResult> results;
+    for (int j = 0; j < n; ++j) {
+      if (!schs[j].defined()) {
+        continue;
+      }
+      ffi::Array<ArgInfo> args_info =
+          records[j]->args_info.defined()
+              ? records[j]->args_info.value()
+              : ArgInfo::FromEntryFunc(workload->mod, /*remove_preproc=*/true);
+      candidates.push_back(MeasureCandidate(schs[j].value(), args_info));
+      results.push_back(RunnerResult(records[j]->run_secs, std::nullopt));
+    }
+    if (candidates.empty()) {
+      continue;
+    }
+    TuneContext context(/*mod=*/workload->mod, /*target=*/target, /*space_generator=*/std::nullopt,
+                        /*search_strategy=*/std::nullopt, /*task_name=*/std::nullopt,
+                        /*num_threads=*/num_threads, /*rand_state=*/-1,
+                        /*logger=*/ffi::Function(nullptr));
+    this->Update(context, candidates, results);
+  }
+}
+
 CostModel CostModel::PyCostModel(PyCostModelNode::FLoad f_load,        //
                                  PyCostModelNode::FSave f_save,        //
                                  PyCostModelNode::FUpdate f_update,    //
@@ -85,6 +150,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
              std::vector<double> result = model->Predict(context, candidates);
              std::copy(result.begin(), result.end(), static_cast<double*>(p_addr));
            })
+      .def_method("meta_schedule.CostModelPretrain", &CostModelNode::Pretrain)
       .def("meta_schedule.CostModelPyCostModel", CostModel::PyCostModel);
 }
 
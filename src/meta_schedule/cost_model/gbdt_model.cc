@@ -0,0 +1,526 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief A regression tree over the per-store feature vectors. */
+struct RegressionTree {
+  /*! \brief The feature each node splits on; -1 for a leaf. */
+  std::vector<int32_t> feature;
+  /*! \brief The rows whose feature is less than the threshold go to the left child. */
+  std::vector<float> threshold;
+  /*! \brief The index of the left child; the right child follows it. */
+  std::vector<int32_t> left;
+  /*! \brief The output of a leaf. */
+  std::vector<float> value;
+
+  float Predict(const float* row) const {
+    int32_t node = 0;
+    while (feature[node] >= 0) {
+      node = row[feature[node]] < threshold[node] ? left[node] : left[node] + 1;
+    }
+    return value[node];
+  }
+};
+
+/*! \brief The measured samples of one workload. */
+struct FeatureGroup {
+  /*! \brief The per-store features of each sample, stored row by row. */
+  std::vector<std::vector<float>> features;
+  /*! \brief The number of stores, i.e. rows, of each sample. */
+  std::vector<int32_t> num_rows;
+  /*! \brief The mean running time of each sample. */
+  std::vector<double> costs;
+  /*! \brief The minimum running time in the group. */
+  double min_cost = std::numeric_limits<double>::infinity();
+};
+
+/*!
+ * \brief A gradient boosted trees cost model that trains and predicts in C++.
+ *
+ * It learns the same objective as XGBModel: the score of a candidate is the sum of the tree
+ * outputs over the feature vectors of its stores, regressed towards `min_cost / cost` of the
+ * workload with a squared error weighted by the label.
+ */
+class GBDTModelNode : public CostModelNode {
+ public:
+  /*! \brief The feature extractor. */
+  FeatureExtractor extractor{nullptr};
+  /*! \brief The number of boosting rounds in each training. */
+  int num_trees;
+  /*! \brief The maximum depth of a tree. */
+  int max_depth;
+  /*! \brief The shrinkage applied to the output of each tree. */
+  double learning_rate;
+  /*! \brief The L2 regularization on the leaf outputs. */
+  double reg_lambda;
+  /*! \brief The minimum loss reduction required to split a node. */
+  double gamma;
+  /*! \brief The minimum sum of hessians in a child. */
+  double min_child_weight;
+  /*! \brief The maximum number of histogram bins per feature. */
+  int max_bins;
+  /*! \brief The number of samples before the model predicts random scores. */
+  int num_warmup_samples;
+  /*! \brief Whether to skip retraining until the data grows by a fifth. */
+  bool adaptive_training;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<GBDTModelNode>()
+        .def_ro("extractor", &GBDTModelNode::extractor)
+        .def_ro("num_trees", &GBDTModelNode::num_trees)
+        .def_ro("max_depth", &GBDTModelNode::max_depth)
+        .def_ro("learning_rate", &GBDTModelNode::learning_rate)
+        .def_ro("reg_lambda", &GBDTModelNode::reg_lambda)
+        .def_ro("gamma", &GBDTModelNode::gamma)
+        .def_ro("min_child_weight", &GBDTModelNode::min_child_weight)
+        .def_ro("max_bins", &GBDTModelNode::max_bins)
+        .def_ro("num_warmup_samples", &GBDTModelNode::num_warmup_samples)
+        .def_ro("adaptive_training", &GBDTModelNode::adaptive_training);
+  }
+
+  void Load(const ffi::String& path) final {
+    std::ifstream ifs(path.operator std::string(), std::ios::binary);
+    CHECK(ifs) << "ValueError: Cannot open the cost model file: " << path;
+    std::string blob((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    dmlc::MemoryStringStream stream(&blob);
+    uint64_t magic = 0;
+    CHECK(stream.Read(&magic) && magic == kMagic)
+        << "ValueError: Not a GBDTModel file: " << path;
+    auto trees = std::make_shared<std::vector<RegressionTree>>();
+    std::map<std::string, FeatureGroup> data;
+    int64_t num_features = 0, data_size = 0, last_train_size = 0;
+    uint64_t num_trees = 0, num_groups = 0;
+    CHECK(stream.Read(&num_features) && stream.Read(&data_size) && stream.Read(&last_train_size) &&
+          stream.Read(&num_trees));
+    trees->resize(num_trees);
+    for (RegressionTree& tree : *trees) {
+      CHECK(stream.Read(&tree.feature) && stream.Read(&tree.threshold) && stream.Read(&tree.left) &&
+            stream.Read(&tree.value));
+    }
+    CHECK(stream.Read(&num_groups));
+    for (uint64_t i = 0; i < num_groups; ++i) {
+      std::string key;
+      CHECK(stream.Read(&key));
+      FeatureGroup& group = data[key];
+      uint64_t num_samples = 0;
+      CHECK(stream.Read(&num_samples) && stream.Read(&group.num_rows) &&
+            stream.Read(&group.costs) && stream.Read(&group.min_cost));
+      group.features.resize(num_samples);
+      for (std::vector<float>& feature : group.features) {
+        CHECK(stream.Read(&feature));
+      }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    trees_ = std::move(trees);
+    data_ = std::move(data);
+    num_features_ = num_features;
+    data_size_ = data_size;
+    last_train_size_ = last_train_size;
+  }
+
+  void Save(const ffi::String& path) final {
+    std::string blob;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      dmlc::MemoryStringStream stream(&blob);
+      stream.Write(kMagic);
+      stream.Write(num_features_);
+      stream.Write(data_size_);
+      stream.Write(last_train_size_);
+      stream.Write(static_cast<uint64_t>(trees_->size()));
+      for (const RegressionTree& tree : *trees_) {
+        stream.Write(tree.feature);
+        stream.Write(tree.threshold);
+        stream.Write(tree.left);
+        stream.Write(tree.value);
+      }
+      stream.Write(static_cast<uint64_t>(data_.size()));
+      for (const auto& [key, group] : data_) {
+        stream.Write(key);
+        stream.Write(static_cast<uint64_t>(group.features.size()));
+        stream.Write(group.num_rows);
+        stream.Write(group.costs);
+        stream.Write(group.min_cost);
+        for (const std::vector<float>& feature : group.features) {
+          stream.Write(feature);
+        }
+      }
+    }
+    std::ofstream ofs(path.operator std::string(), std::ios::binary);
+    CHECK(ofs) << "ValueError: Cannot open the cost model file: " << path;
+    ofs.write(blob.data(), blob.size());
+  }
+
+  void Update(const TuneContext& context, const ffi::Array<MeasureCandidate>& candidates,
+              const ffi::Array<RunnerResult>& results) final {
+    ICHECK_EQ(candidates.size(), results.size());
+    if (candidates.empty()) {
+      return;
+    }
+    ffi::Array<runtime::Tensor> features = extractor->ExtractFrom(context, candidates);
+    ICHECK_EQ(features.size(), candidates.size());
+    ObjectRef mod{nullptr};
+    if (context->mod.defined()) {
+      mod = context->mod.value();
+    }
+    std::string key = SHash2Hex(mod);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    FeatureGroup& group = data_[key];
+    for (int i = 0, n = candidates.size(); i < n; ++i) {
+      int64_t num_rows = 0, num_features = 0;
+      std::vector<float> feature = AsRows(features[i], &num_rows, &num_features);
+      // Samples without any store carry no information.
+      if (num_rows == 0) {
+        continue;
+      }
+      if (num_features_ == 0) {
+        num_features_ = num_features;
+      }
+      CHECK_EQ(num_features, num_features_)
+          << "ValueError: The feature extractor changed its feature vector length";
+      double cost = 1e10;
+      if (results[i]->run_secs.defined() && !results[i]->run_secs.value().empty()) {
+        cost = GetRunMsMedian(results[i]) / 1000.0;
+      }
+      group.features.push_back(std::move(feature));
+      group.num_rows.push_back(num_rows);
+      group.costs.push_back(cost);
+      group.min_cost = std::min(group.min_cost, cost);
+      ++data_size_;
+    }
+    if (adaptive_training && data_size_ - last_train_size_ < last_train_size_ / 5) {
+      // Retraining from scratch on every update is quadratic in the number of samples.
+      return;
+    }
+    last_train_size_ = data_size_;
+    Train(std::max(context->num_threads, 1));
+  }
+
+  std::vector<double> Predict(const TuneContext& context,
+                              const ffi::Array<MeasureCandidate>& candidates) final {
+    int n = candidates.size();
+    std::vector<double> result(n, 0.0);
+    // Take a snapshot of the trees, so that predictions run concurrently with each other and
+    // with retraining.
+    std::shared_ptr<const std::vector<RegressionTree>> trees;
+    int64_t num_features_expected = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      trees = trees_;
+      num_features_expected = num_features_;
+      if (data_size_ < num_warmup_samples || trees->empty()) {
+        support::LinearCongruentialEngine rand_engine(&rand_state_);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (double& score : result) {
+          score = dist(rand_engine);
+        }
+        return result;
+      }
+    }
+    ffi::Array<runtime::Tensor> features = extractor->ExtractFrom(context, candidates);
+    ICHECK_EQ(features.size(), candidates.size());
+    support::parallel_for_dynamic(
+        0, n, std::max(context->num_threads, 1), [&](int thread_id, int task_id) {
+          int64_t num_rows = 0, num_features = 0;
+          std::vector<float> feature = AsRows(features[task_id], &num_rows, &num_features);
+          if (num_rows == 0) {
+            return;
+          }
+          CHECK_EQ(num_features, num_features_expected)
+              << "ValueError: The feature extractor changed its feature vector length";
+          result[task_id] = PredictSample(*trees, feature.data(), num_rows, num_features);
+        });
+    return result;
+  }
+
+  static constexpr const uint64_t kMagic = 0x54444247534DULL;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.GBDTModel", GBDTModelNode, CostModelNode);
+
+ private:
+  friend class CostModel;
+
+  /*! \brief A node of the tree under construction with the rows that reach it. */
+  struct BuildNode {
+    int32_t id;
+    int depth;
+    std::vector<int32_t> rows;
+  };
+
+  /*! \brief Copy a feature tensor of shape [num_rows, num_features] into a row-major buffer. */
+  static std::vector<float> AsRows(const runtime::Tensor& tensor, int64_t* num_rows,
+                                   int64_t* num_features) {
+    ICHECK_EQ(tensor->ndim, 2);
+    *num_rows = tensor->shape[0];
+    *num_features = tensor->shape[1];
+    int64_t size = (*num_rows) * (*num_features);
+    if (tensor->dtype.code == kDLFloat && tensor->dtype.bits == 32) {
+      const float* data = static_cast<const float*>(tensor->data);
+      return std::vector<float>(data, data + size);
+    }
+    ICHECK(tensor->dtype.code == kDLFloat && tensor->dtype.bits == 64)
+        << "ValueError: Expect float32 or float64 features, but gets: "
+        << DLDataTypeToString(tensor->dtype);
+    const double* data = static_cast<const double*>(tensor->data);
+    return std::vector<float>(data, data + size);
+  }
+
+  /*! \brief The predicted score of a sample, i.e. the sum of the outputs of its rows. */
+  static double PredictSample(const std::vector<RegressionTree>& trees, const float* rows,
+                              int64_t num_rows, int64_t num_features) {
+    double score = 0.0;
+    for (int64_t r = 0; r < num_rows; ++r) {
+      const float* row = rows + r * num_features;
+      for (const RegressionTree& tree : trees) {
+        score += tree.Predict(row);
+      }
+    }
+    return score;
+  }
+
+  /*! \brief Retrain the trees from scratch on all the collected samples. */
+  void Train(int num_threads) {
+    // Step 1. Flatten the samples, labelling each with its speedup over the group's fastest one.
+    std::vector<const float*> rows;
+    std::vector<int32_t> sample_of_row;
+    std::vector<double> labels;
+    for (const auto& [key, group] : data_) {
+      for (size_t i = 0; i < group.features.size(); ++i) {
+        for (int32_t r = 0; r < group.num_rows[i]; ++r) {
+          rows.push_back(group.features[i].data() + r * num_features_);
+          sample_of_row.push_back(labels.size());
+        }
+        labels.push_back(group.costs[i] > 0 ? group.min_cost / group.costs[i] : 0.0);
+      }
+    }
+    int num_rows = rows.size();
+    int num_features = num_features_;
+    if (num_rows == 0) {
+      trees_ = std::make_shared<std::vector<RegressionTree>>();
+      return;
+    }
+
+    // Step 2. Quantize every feature into at most `max_bins` bins by its quantiles.
+    std::vector<std::vector<float>> cuts(num_features);
+    std::vector<uint8_t> bins(static_cast<size_t>(num_rows) * num_features);
+    int num_bins = std::min(std::max(max_bins, 2), 256);
+    support::parallel_for_dynamic(0, num_features, num_threads, [&](int thread_id, int f) {
+      std::vector<float> values(num_rows);
+      for (int r = 0; r < num_rows; ++r) {
+        values[r] = rows[r][f];
+      }
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+      std::vector<float>& cut = cuts[f];
+      int num_values = values.size();
+      for (int b = 1; b < num_bins && num_values > 1; ++b) {
+        float value = values[std::min(num_values - 1, b * num_values / num_bins)];
+        if (value > values[0] && (cut.empty() || value > cut.back())) {
+          cut.push_back(value);
+        }
+      }
+      // The bin of a value is the number of cuts not greater than it, so that the rows in bins
+      // up to `b` are exactly those less than `cut[b]`.
+      for (int r = 0; r < num_rows; ++r) {
+        bins[static_cast<size_t>(r) * num_features + f] =
+            std::upper_bound(cut.begin(), cut.end(), rows[r][f]) - cut.begin();
+      }
+    });
+
+    // Step 3. Boost the trees, each fitting the gradient of the pack-sum squared error.
+    std::vector<double> sample_preds(labels.size(), 0.0);
+    std::vector<double> grads(num_rows), hesses(num_rows);
+    std::vector<float> row_outputs(num_rows);
+    auto trees = std::make_shared<std::vector<RegressionTree>>();
+    for (int t = 0; t < num_trees; ++t) {
+      for (int r = 0; r < num_rows; ++r) {
+        double label = labels[sample_of_row[r]];
+        grads[r] = (sample_preds[sample_of_row[r]] - label) * label;
+        hesses[r] = label;
+      }
+      RegressionTree tree = BuildTree(bins, cuts, grads, hesses, num_threads, &row_outputs);
+      for (int r = 0; r < num_rows; ++r) {
+        sample_preds[sample_of_row[r]] += row_outputs[r];
+      }
+      trees->push_back(std::move(tree));
+    }
+    trees_ = std::move(trees);
+  }
+
+  /*!
+   * \brief Grow one tree depth-first with histogram based split finding.
+   * \param row_outputs The output of the tree on each row, filled by this function.
+   */
+  RegressionTree BuildTree(const std::vector<uint8_t>& bins,
+                           const std::vector<std::vector<float>>& cuts,
+                           const std::vector<double>& grads, const std::vector<double>& hesses,
+                           int num_threads, std::vector<float>* row_outputs) const {
+    int num_features = num_features_;
+    RegressionTree tree;
+    auto f_new_node = [&tree]() -> int32_t {
+      tree.feature.push_back(-1);
+      tree.threshold.push_back(0.0f);
+      tree.left.push_back(-1);
+      tree.value.push_back(0.0f);
+      return tree.feature.size() - 1;
+    };
+    std::vector<BuildNode> stack;
+    stack.push_back(BuildNode{f_new_node(), 0, {}});
+    stack.back().rows.resize(grads.size());
+    std::iota(stack.back().rows.begin(), stack.back().rows.end(), 0);
+    while (!stack.empty()) {
+      BuildNode node = std::move(stack.back());
+      stack.pop_back();
+      double sum_grad = 0.0, sum_hess = 0.0;
+      for (int32_t r : node.rows) {
+        sum_grad += grads[r];
+        sum_hess += hesses[r];
+      }
+      double parent_score = sum_grad * sum_grad / (sum_hess + reg_lambda);
+      // Find the best split of each feature in parallel.
+      std::vector<double> best_gain(num_features, 0.0);
+      std::vector<int> best_bin(num_features, -1);
+      if (node.depth < max_depth && node.rows.size() > 1) {
+        support::parallel_for_dynamic(0, num_features, num_threads, [&](int thread_id, int f) {
+          int num_cuts = cuts[f].size();
+          if (num_cuts == 0) {
+            return;
+          }
+          std::vector<double> hist_grad(num_cuts + 1, 0.0), hist_hess(num_cuts + 1, 0.0);
+          std::vector<int32_t> hist_count(num_cuts + 1, 0);
+          for (int32_t r : node.rows) {
+            int b = bins[static_cast<size_t>(r) * num_features + f];
+            hist_grad[b] += grads[r];
+            hist_hess[b] += hesses[r];
+            hist_count[b] += 1;
+          }
+          double left_grad = 0.0, left_hess = 0.0;
+          int32_t left_count = 0;
+          for (int b = 0; b < num_cuts; ++b) {
+            left_grad += hist_grad[b];
+            left_hess += hist_hess[b];
+            left_count += hist_count[b];
+            double right_grad = sum_grad - left_grad, right_hess = sum_hess - left_hess;
+            if (left_count == 0 || left_count == static_cast<int32_t>(node.rows.size()) ||
+                left_hess < min_child_weight || right_hess < min_child_weight) {
+              continue;
+            }
+            double gain = left_grad * left_grad / (left_hess + reg_lambda) +
+                          right_grad * right_grad / (right_hess + reg_lambda) - parent_score;
+            if (gain > best_gain[f]) {
+              best_gain[f] = gain;
+              best_bin[f] = b;
+            }
+          }
+        });
+      }
+      int split_feature = -1;
+      for (int f = 0; f < num_features; ++f) {
+        if (best_bin[f] >= 0 && best_gain[f] > gamma &&
+            (split_feature == -1 || best_gain[f] > best_gain[split_feature])) {
+          split_feature = f;
+        }
+      }
+      if (split_feature == -1) {
+        float value = -learning_rate * sum_grad / (sum_hess + reg_lambda);
+        tree.value[node.id] = value;
+        for (int32_t r : node.rows) {
+          (*row_outputs)[r] = value;
+        }
+        continue;
+      }
+      int split_bin = best_bin[split_feature];
+      BuildNode left{f_new_node(), node.depth + 1, {}};
+      BuildNode right{f_new_node(), node.depth + 1, {}};
+      tree.feature[node.id] = split_feature;
+      tree.threshold[node.id] = cuts[split_feature][split_bin];
+      tree.left[node.id] = left.id;
+      for (int32_t r : node.rows) {
+        if (bins[static_cast<size_t>(r) * num_features + split_feature] <= split_bin) {
+          left.rows.push_back(r);
+        } else {
+          right.rows.push_back(r);
+        }
+      }
+      stack.push_back(std::move(right));
+      stack.push_back(std::move(left));
+    }
+    return tree;
+  }
+
+  /*! \brief The guard of the trees and the data, shared by the tuning threads. */
+  std::mutex mutex_;
+  /*! \brief The boosted trees, replaced as a whole by each training. */
+  std::shared_ptr<const std::vector<RegressionTree>> trees_ =
+      std::make_shared<std::vector<RegressionTree>>();
+  /*! \brief The measured samples keyed by the structural hash of their workload. */
+  std::map<std::string, FeatureGroup> data_;
+  /*! \brief The length of the feature vectors, 0 before any sample is seen. */
+  int64_t num_features_ = 0;
+  /*! \brief The number of samples collected. */
+  int64_t data_size_ = 0;
+  /*! \brief The number of samples in the last training. */
+  int64_t last_train_size_ = 0;
+  /*! \brief The random state of the scores predicted during warmup. */
+  support::LinearCongruentialEngine::TRandState rand_state_;
+};
+
+CostModel CostModel::GBDTModel(FeatureExtractor extractor, int num_trees, int max_depth,
+                               double learning_rate, double reg_lambda, double gamma,
+                               double min_child_weight, int max_bins, int num_warmup_samples,
+                               bool adaptive_training, int64_t seed) {
+  CHECK_GT(num_trees, 0) << "ValueError: `num_trees` must be positive";
+  CHECK_GE(max_depth, 0) << "ValueError: `max_depth` must be non-negative";
+  ObjectPtr<GBDTModelNode> n = ffi::make_object<GBDTModelNode>();
+  n->extractor = std::move(extractor);
+  n->num_trees = num_trees;
+  n->max_depth = max_depth;
+  n->learning_rate = learning_rate;
+  n->reg_lambda = reg_lambda;
+  n->gamma = gamma;
+  n->min_child_weight = min_child_weight;
+  n->max_bins = max_bins;
+  n->num_warmup_samples = num_warmup_samples;
+  n->adaptive_training = adaptive_training;
+  n->rand_state_ = support::LinearCongruentialEngine::NormalizeSeed(seed);
+  return CostModel(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  GBDTModelNode::RegisterReflection();
+  refl::GlobalDef().def("meta_schedule.CostModelGBDTModel", CostModel::GBDTModel);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/tir/analysis.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../module_equality.h"
+#include "../trace_apply.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief A database that answers the queries of the workloads it has not seen with the best
+ * records of the tuned workloads that have the same anchor block, whatever the blocks fused
+ * around it, by re-applying their traces as anchor traces.
+ */
+class AnchorBlockDatabaseNode : public DatabaseNode {
+ public:
+  /*! \brief The database of the tuned workloads, which also stores all records committed. */
+  Database database{ffi::UnsafeInit()};
+  /*! \brief The number of best records of the same anchor block tried on a query. */
+  int k;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<AnchorBlockDatabaseNode>()
+        .def_ro("database", &AnchorBlockDatabaseNode::database)
+        .def_ro("k", &AnchorBlockDatabaseNode::k);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.AnchorBlockDatabase", AnchorBlockDatabaseNode,
+                                    DatabaseNode);
+
+ public:
+  bool HasWorkload(const IRModule& mod) final { return database->HasWorkload(mod); }
+
+  Workload CommitWorkload(const IRModule& mod) final { return database->CommitWorkload(mod); }
+
+  void CommitTuningRecord(const TuningRecord& record) final {
+    database->CommitTuningRecord(record);
+  }
+
+  ffi::Array<TuningRecord> GetTopK(const Workload& workload, int top_k) final {
+    return database->GetTopK(workload, top_k);
+  }
+
+  ffi::Array<TuningRecord> GetAllTuningRecords() final { return database->GetAllTuningRecords(); }
+
+  int64_t Size() final { return database->Size(); }
+
+  int64_t Compact(int top_k) final { return database->Compact(top_k); }
+
+  ffi::Optional<TuningRecord> QueryTuningRecord(const IRModule& mod, const Target& target,
+                                                const ffi::String& workload_name) final {
+    if (ffi::Optional<TuningRecord> record =
+            database->QueryTuningRecord(mod, target, workload_name)) {
+      return record;
+    }
+    if (ffi::Optional<tir::Schedule> sch = Transfer(mod, target)) {
+      return TuningRecord(sch.value()->trace().value(), Workload(mod), std::nullopt, target,
+                          std::nullopt);
+    }
+    return std::nullopt;
+  }
+
+  ffi::Optional<tir::Schedule> QuerySchedule(const IRModule& mod, const Target& target,
+                                             const ffi::String& workload_name) final {
+    if (ffi::Optional<tir::Schedule> sch = database->QuerySchedule(mod, target, workload_name)) {
+      return sch;
+    }
+    return Transfer(mod, target);
+  }
+
+ private:
+  /*! \brief Schedule the module with the best record of the same anchor block that applies. */
+  ffi::Optional<tir::Schedule> Transfer(const IRModule& mod, const Target& target) {
+    if (tir::FindAnchorBlock(mod) == nullptr) {
+      return std::nullopt;
+    }
+    // Step 1. Collect the measured records of the workloads with the same anchor block
+    std::vector<std::pair<double, TuningRecord>> candidates;
+    std::unordered_map<const WorkloadNode*, bool> is_same_anchor;
+    for (const TuningRecord& record : database->GetAllTuningRecords()) {
+      if (!record->IsValid() ||
+          (record->target.defined() && record->target.value()->kind->name != target->kind->name)) {
+        continue;
+      }
+      const WorkloadNode* workload = record->workload.get();
+      auto it = is_same_anchor.find(workload);
+      if (it == is_same_anchor.end()) {
+        bool same = tir::FindAnchorBlock(workload->mod) != nullptr &&
+                    anchor_block_eq_->Equal(mod, workload->mod);
+        it = is_same_anchor.emplace(workload, same).first;
+      }
+      if (it->second) {
+        candidates.emplace_back(SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value()),
+                                record);
+      }
+    }
+    // Step 2. Re-apply the k fastest ones as anchor traces, the fastest first
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    if (static_cast<int>(candidates.size()) > k) {
+      candidates.resize(k);
+    }
+    for (const auto& candidate : candidates) {
+      tir::Schedule sch =
+          tir::Schedule::Traced(mod, /*seed=*/-1, /*debug_mask=*/0,
+                                /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+      try {
+        ScheduleUsingAnchorTrace(sch, candidate.second->trace, target);
+      } catch (const std::exception&) {
+        continue;
+      }
+      return sch;
+    }
+    return std::nullopt;
+  }
+
+  /*! \brief The equality of the anchor blocks of two modules. */
+  std::unique_ptr<ModuleEquality> anchor_block_eq_ = ModuleEquality::Create("anchor-block");
+};
+
+Database Database::AnchorBlockDatabase(Database database, int k) {
+  CHECK_GT(k, 0) << "ValueError: `k` must be positive, but got " << k;
+  ObjectPtr<AnchorBlockDatabaseNode> n = ffi::make_object<AnchorBlockDatabaseNode>();
+  n->database = std::move(database);
+  n->k = k;
+  return Database(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.DatabaseAnchorBlockDatabase",
+                        Database::AnchorBlockDatabase);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { AnchorBlockDatabaseNode::RegisterReflection(); }
+
+}  // namespace meta_schedule
+}  // namespace tvm
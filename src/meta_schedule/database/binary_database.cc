@@ -0,0 +1,389 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file binary_database.cc
+ * \brief A database stored in a single binary file, indexed at load time and decoded lazily.
+ *
+ * The file starts with a header, followed by a sequence of entries. Each entry has a fixed
+ * size header carrying everything needed to index it, and a payload with the JSON of the
+ * workload or tuning record. Opening the database memory-maps the file and only walks the
+ * entry headers. Payloads are decoded when a lookup first touches them.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../../runtime/file_utils.h"
+#include "../module_equality.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief "TVMMSDB" followed by the format version. */
+constexpr uint64_t kBinaryDatabaseMagic = 0x0142444D534D5654;
+
+/*! \brief The kind of an entry in the binary database file. */
+enum BinaryEntryKind : uint32_t {
+  kWorkloadEntry = 1,
+  kTuningRecordEntry = 2,
+};
+
+/*! \brief The fixed size header of each entry, followed by the payload padded to 8 bytes. */
+struct BinaryEntryHeader {
+  /*! \brief The BinaryEntryKind of the entry. */
+  uint32_t kind;
+  /*! \brief The size of the payload in bytes, excluding padding. */
+  uint32_t payload_size;
+  /*! \brief The structural hash of a workload, or the workload index of a tuning record. */
+  uint64_t key;
+  /*! \brief The mean running time of a tuning record. */
+  double mean_run_secs;
+  /*! \brief Whether a tuning record has at least one valid measurement. */
+  uint32_t has_run_secs;
+  uint32_t reserved;
+};
+static_assert(sizeof(BinaryEntryHeader) == 32, "BinaryEntryHeader must be packed");
+
+inline size_t PaddedSize(size_t size) { return (size + 7) / 8 * 8; }
+
+/*! \brief Append an entry to the binary database file. */
+void BinaryFileAppendEntry(std::ofstream& os, BinaryEntryKind kind, uint64_t key,
+                           double mean_run_secs, bool has_run_secs, const std::string& payload) {
+  BinaryEntryHeader header;
+  header.kind = kind;
+  header.payload_size = static_cast<uint32_t>(payload.size());
+  header.key = key;
+  header.mean_run_secs = mean_run_secs;
+  header.has_run_secs = has_run_secs;
+  header.reserved = 0;
+  CHECK_EQ(header.payload_size, payload.size()) << "ValueError: Entry is too large";
+  static const char kPadding[8] = {0};
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.write(payload.data(), payload.size());
+  os.write(kPadding, PaddedSize(payload.size()) - payload.size());
+}
+
+/*! \brief Whether any of the measurements is not the stub for a failed run. */
+bool HasValidRunSecs(const ffi::Optional<ffi::Array<FloatImm>>& run_secs) {
+  if (!run_secs.defined()) return false;
+  for (const FloatImm& run_sec : run_secs.value()) {
+    if (run_sec.defined() && run_sec->value != SortTuningRecordByMeanRunSecs::kMaxMeanTime) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*! \brief A database backed by a single binary file with lazily decoded entries. */
+class BinaryDatabaseNode : public DatabaseNode {
+ public:
+  explicit BinaryDatabaseNode(ffi::String mod_eq_name = "structural")
+      : DatabaseNode(mod_eq_name) {}
+
+  /*! \brief The path to the database file */
+  ffi::String path;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<BinaryDatabaseNode>().def_ro("path", &BinaryDatabaseNode::path);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.BinaryDatabase", BinaryDatabaseNode,
+                                    DatabaseNode);
+
+  /*! \brief A workload, either still encoded in the mapped file or already decoded. */
+  struct WorkloadEntry {
+    const char* payload{nullptr};
+    size_t payload_size{0};
+    Workload::THashCode shash{0};
+    ffi::Optional<Workload> decoded{std::nullopt};
+  };
+
+  /*! \brief A tuning record, either still encoded in the mapped file or already decoded. */
+  struct RecordEntry {
+    const char* payload{nullptr};
+    size_t payload_size{0};
+    double mean_run_secs{SortTuningRecordByMeanRunSecs::kMaxMeanTime};
+    bool has_run_secs{false};
+    ffi::Optional<TuningRecord> decoded{std::nullopt};
+  };
+
+  /*! \brief The mapped content of the file at load time. */
+  std::unique_ptr<runtime::MappedFile> file_;
+  /*! \brief The workloads, in the order they are committed. */
+  std::vector<WorkloadEntry> workloads_;
+  /*! \brief The workload indices, keyed by structural hash. */
+  std::unordered_multimap<Workload::THashCode, int> shash2idx_;
+  /*! \brief The tuning records of each workload, sorted by mean running time. */
+  std::vector<std::vector<RecordEntry>> records_;
+  /*! \brief The number of tuning records. */
+  int64_t num_records_ = 0;
+
+ public:
+  bool HasWorkload(const IRModule& mod) final {
+    return FindWorkload(mod, GetModuleEquality().Hash(mod)) != -1;
+  }
+
+  Workload CommitWorkload(const IRModule& mod) final {
+    Workload::THashCode shash = GetModuleEquality().Hash(mod);
+    int index = FindWorkload(mod, shash);
+    if (index != -1) {
+      return GetWorkload(index);
+    }
+    Workload workload(mod, shash);
+    AppendEntry(kWorkloadEntry, shash, 0.0, false, JSONDumps(workload->AsJSON()));
+    WorkloadEntry entry;
+    entry.shash = shash;
+    entry.decoded = workload;
+    AddWorkload(std::move(entry));
+    return workload;
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) final {
+    int index = FindWorkload(record->workload->mod, record->workload->shash);
+    CHECK_NE(index, -1) << "ValueError: The workload of the tuning record is not committed";
+    RecordEntry entry;
+    entry.mean_run_secs = SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({}));
+    entry.has_run_secs = HasValidRunSecs(record->run_secs);
+    entry.decoded = record;
+    AppendEntry(kTuningRecordEntry, index, entry.mean_run_secs, entry.has_run_secs,
+                JSONDumps(record->AsJSON()));
+    AddRecord(index, std::move(entry));
+  }
+
+  ffi::Array<TuningRecord> GetTopK(const Workload& workload, int top_k) final {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    if (top_k == 0) {
+      return {};
+    }
+    int index = FindWorkload(workload->mod, workload->shash);
+    if (index == -1) {
+      return {};
+    }
+    ffi::Array<TuningRecord> results;
+    for (RecordEntry& entry : records_[index]) {
+      if (!entry.has_run_secs) {
+        continue;
+      }
+      TuningRecord record = GetRecord(index, &entry);
+      if (!record->IsValid()) {
+        continue;
+      }
+      results.push_back(record);
+      if (results.size() == static_cast<size_t>(top_k)) {
+        break;
+      }
+    }
+    return results;
+  }
+
+  ffi::Array<TuningRecord> GetAllTuningRecords() final {
+    std::vector<TuningRecord> results;
+    results.reserve(num_records_);
+    for (size_t index = 0; index < records_.size(); ++index) {
+      for (RecordEntry& entry : records_[index]) {
+        results.push_back(GetRecord(index, &entry));
+      }
+    }
+    std::stable_sort(results.begin(), results.end(), SortTuningRecordByMeanRunSecs());
+    return ffi::Array<TuningRecord>(results.begin(), results.end());
+  }
+
+  int64_t Size() final { return num_records_; }
+
+  /*! \brief Open the file and index the entries, without decoding any payload. */
+  void Load(bool allow_missing) {
+    {
+      std::ifstream is(path);
+      if (!is.good()) {
+        CHECK(allow_missing) << "ValueError: File doesn't exist: " << path;
+        std::ofstream os(path, std::ofstream::binary);
+        CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
+        os.write(reinterpret_cast<const char*>(&kBinaryDatabaseMagic), sizeof(uint64_t));
+        return;
+      }
+    }
+    file_ = std::make_unique<runtime::MappedFile>(path);
+    const char* data = file_->data();
+    size_t size = file_->size();
+    CHECK(size >= sizeof(uint64_t) &&
+          std::memcmp(data, &kBinaryDatabaseMagic, sizeof(uint64_t)) == 0)
+        << "ValueError: Not a meta schedule binary database: " << path;
+    for (size_t offset = sizeof(uint64_t); offset < size;) {
+      CHECK_LE(offset + sizeof(BinaryEntryHeader), size)
+          << "ValueError: Truncated entry header at offset " << offset << " of file " << path;
+      BinaryEntryHeader header;
+      std::memcpy(&header, data + offset, sizeof(header));
+      const char* payload = data + offset + sizeof(header);
+      offset += sizeof(header) + PaddedSize(header.payload_size);
+      CHECK_LE(offset, size) << "ValueError: Truncated entry payload in file " << path;
+      if (header.kind == kWorkloadEntry) {
+        WorkloadEntry entry;
+        entry.payload = payload;
+        entry.payload_size = header.payload_size;
+        entry.shash = header.key;
+        AddWorkload(std::move(entry));
+      } else if (header.kind == kTuningRecordEntry) {
+        CHECK_LT(header.key, workloads_.size())
+            << "ValueError: Tuning record refers to unknown workload " << header.key
+            << " in file " << path;
+        RecordEntry entry;
+        entry.payload = payload;
+        entry.payload_size = header.payload_size;
+        entry.mean_run_secs = header.mean_run_secs;
+        entry.has_run_secs = header.has_run_secs != 0;
+        AddRecord(static_cast<int>(header.key), std::move(entry));
+      } else {
+        LOG(FATAL) << "ValueError: Unknown entry kind " << header.kind << " in file " << path;
+      }
+    }
+  }
+
+ private:
+  /*! \return The index of the workload equal to `mod`, or -1 if there is none. */
+  int FindWorkload(const IRModule& mod, Workload::THashCode shash) {
+    auto range = shash2idx_.equal_range(shash);
+    for (auto it = range.first; it != range.second; ++it) {
+      Workload workload = GetWorkload(it->second);
+      if (workload->mod.same_as(mod) || GetModuleEquality().Equal(workload->mod, mod)) {
+        return it->second;
+      }
+    }
+    return -1;
+  }
+
+  Workload GetWorkload(int index) {
+    WorkloadEntry& entry = workloads_[index];
+    if (!entry.decoded.defined()) {
+      Workload workload =
+          Workload::FromJSON(JSONLoads(std::string(entry.payload, entry.payload_size))
+                                 .cast<ObjectRef>());
+      // Keep the hash the workload is indexed with, see JSONDatabase for why it may differ.
+      if (workload->shash != entry.shash) {
+        ObjectPtr<WorkloadNode> n = ffi::make_object<WorkloadNode>(*workload.get());
+        n->shash = entry.shash;
+        workload = Workload(n);
+      }
+      entry.decoded = workload;
+    }
+    return entry.decoded.value();
+  }
+
+  TuningRecord GetRecord(int workload_index, RecordEntry* entry) {
+    if (!entry->decoded.defined()) {
+      ObjectRef json_obj =
+          JSONLoads(std::string(entry->payload, entry->payload_size)).cast<ObjectRef>();
+      entry->decoded = TuningRecord::FromJSON(json_obj, GetWorkload(workload_index));
+    }
+    return entry->decoded.value();
+  }
+
+  void AddWorkload(WorkloadEntry entry) {
+    shash2idx_.emplace(entry.shash, static_cast<int>(workloads_.size()));
+    workloads_.push_back(std::move(entry));
+    records_.emplace_back();
+  }
+
+  void AddRecord(int workload_index, RecordEntry entry) {
+    std::vector<RecordEntry>& records = records_[workload_index];
+    // Keep records with equal running time in commit order, as JSONDatabase does.
+    auto it = std::upper_bound(records.begin(), records.end(), entry.mean_run_secs,
+                               [](double mean_run_secs, const RecordEntry& other) {
+                                 return mean_run_secs < other.mean_run_secs;
+                               });
+    records.insert(it, std::move(entry));
+    ++num_records_;
+  }
+
+  void AppendEntry(BinaryEntryKind kind, uint64_t key, double mean_run_secs, bool has_run_secs,
+                   const std::string& payload) {
+    std::ofstream os(path, std::ofstream::binary | std::ofstream::app);
+    CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path;
+    BinaryFileAppendEntry(os, kind, key, mean_run_secs, has_run_secs, payload);
+  }
+};
+
+Database Database::BinaryDatabase(ffi::String path, bool allow_missing, ffi::String mod_eq_name) {
+  ObjectPtr<BinaryDatabaseNode> n = ffi::make_object<BinaryDatabaseNode>(mod_eq_name);
+  n->path = path;
+  n->Load(allow_missing);
+  return Database(n);
+}
+
+/*!
+ * \brief Convert the workload and tuning record tables of a JSONDatabase into a binary database
+ * file. Tuning records are not replayed, only their JSON is parsed.
+ * \param path_workload The path to the workload table.
+ * \param path_tuning_record The path to the tuning record table.
+ * \param path The path to the binary database file to create.
+ * \param mod_eq_name A string to specify the module equality testing and hashing method.
+ */
+void ConvertJSONDatabaseToBinary(ffi::String path_workload, ffi::String path_tuning_record,
+                                 ffi::String path, ffi::String mod_eq_name) {
+  int num_threads = std::thread::hardware_concurrency();
+  std::unique_ptr<ModuleEquality> mod_eq = ModuleEquality::Create(mod_eq_name);
+  std::ofstream os(path, std::ofstream::binary | std::ofstream::trunc);
+  CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
+  os.write(reinterpret_cast<const char*>(&kBinaryDatabaseMagic), sizeof(uint64_t));
+  std::vector<Any> workload_objs = JSONFileReadLines(path_workload, num_threads, false);
+  for (const Any& json_obj : workload_objs) {
+    Workload workload = Workload::FromJSON(json_obj.cast<ObjectRef>());
+    BinaryFileAppendEntry(os, kWorkloadEntry, mod_eq->Hash(workload->mod), 0.0, false,
+                          JSONDumps(json_obj));
+  }
+  std::vector<Any> record_objs = JSONFileReadLines(path_tuning_record, num_threads, false);
+  for (const Any& json_obj : record_objs) {
+    const ffi::ArrayObj* arr = json_obj.as<ffi::ArrayObj>();
+    CHECK(arr && arr->size() == 2) << "ValueError: Unable to parse TuningRecord: " << json_obj;
+    int64_t workload_index = arr->at(0).cast<IntImm>()->value;
+    CHECK(workload_index >= 0 && static_cast<size_t>(workload_index) < workload_objs.size())
+        << "ValueError: Tuning record refers to unknown workload " << workload_index;
+    const ffi::ArrayObj* record_arr = arr->at(1).as<ffi::ArrayObj>();
+    CHECK(record_arr && record_arr->size() == 4)
+        << "ValueError: Unable to parse TuningRecord: " << json_obj;
+    ffi::Optional<ffi::Array<FloatImm>> run_secs = std::nullopt;
+    if (record_arr->at(1) != nullptr) {
+      run_secs = AsFloatArray(record_arr->at(1).cast<ObjectRef>());
+    }
+    BinaryFileAppendEntry(os, kTuningRecordEntry, workload_index,
+                          SortTuningRecordByMeanRunSecs::Mean(run_secs.value_or({})),
+                          HasValidRunSecs(run_secs), JSONDumps(arr->at(1)));
+  }
+  CHECK(os.good()) << "ValueError: Failed to write file: " << path;
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { BinaryDatabaseNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("meta_schedule.DatabaseBinaryDatabase", Database::BinaryDatabase)
+      .def("meta_schedule.DatabaseConvertJSONToBinary", ConvertJSONDatabaseToBinary);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
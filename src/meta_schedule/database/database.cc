@@ -41,10 +41,10 @@ Workload::Workload(IRModule mod, Workload::THashCode shash) {
 }
 
 ObjectRef WorkloadNode::AsJSON() const {
-  // Convert `this->mod` to JSON
-  std::string json_mod = tvm::SaveJSON(this->mod);
-  // Dump the JSON string to base64
-  std::string b64_mod = Base64Encode(json_mod);
+  // Serialize `this->mod` in the binary format, which is much smaller than its JSON
+  std::string binary_mod = tvm::SaveBinary(this->mod);
+  // Dump the binary to base64
+  std::string b64_mod = Base64Encode(binary_mod);
   // Output
   return ffi::Array<ffi::Any>{SHash2Str(this->shash), ffi::String(b64_mod)};
 }
@@ -60,8 +60,9 @@ Workload Workload::FromJSON(const ObjectRef& json_obj) {
     // Load json[1] => mod
     {
       ffi::String b64_mod = json_array->at(1).cast<ffi::String>();
-      std::string json_mod = Base64Decode(b64_mod);
-      mod = LoadJSON(json_mod).cast<IRModule>();
+      std::string data_mod = Base64Decode(b64_mod);
+      // The workloads saved before the binary format are in JSON
+      mod = (IsBinaryGraph(data_mod) ? LoadBinary(data_mod) : LoadJSON(data_mod)).cast<IRModule>();
       std::stringstream(str_shash) >> shash;
     }
   } catch (const std::runtime_error& e) {  // includes tvm::Error and dmlc::Error
@@ -87,6 +88,7 @@ TuningRecord::TuningRecord(tir::Trace trace, Workload workload,
 }
 
 bool WorkloadEqual::operator()(const Workload& a, const Workload& b) const {
+  if (a.same_as(b)) return true;
   return a->shash == b->shash && mod_eq_.Equal(a->mod, b->mod);
 }
 
@@ -241,6 +243,30 @@ void DatabaseNode::DumpPruned(Database destination) {
   }
 }
 
+int64_t DatabaseNode::Compact(int top_k) {
+  LOG(FATAL) << "NotImplementedError: " << this->GetTypeKey() << " does not support compaction";
+  throw;
+}
+
+std::vector<TuningRecord> SelectCompactedRecords(std::vector<TuningRecord> records, int top_k) {
+  CHECK_GT(top_k, 0) << "ValueError: top_k must be positive, but got " << top_k;
+  records.erase(std::remove_if(records.begin(), records.end(),
+                               [](const TuningRecord& record) { return !record->IsValid(); }),
+                records.end());
+  std::stable_sort(records.begin(), records.end(), SortTuningRecordByMeanRunSecs());
+  std::vector<TuningRecord> results;
+  std::unordered_set<std::string> traces;
+  for (const TuningRecord& record : records) {
+    if (static_cast<int>(results.size()) == top_k) {
+      break;
+    }
+    if (traces.insert(JSONDumps(record->trace->AsJSON(/*remove_postproc=*/false))).second) {
+      results.push_back(record);
+    }
+  }
+  return results;
+}
+
 std::vector<Database>* ThreadLocalDatabases() {
   static thread_local std::vector<Database> tls;
   return &tls;
@@ -320,6 +346,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def_method("meta_schedule.DatabaseQuerySchedule", &DatabaseNode::QuerySchedule)
       .def_method("meta_schedule.DatabaseQueryIRModule", &DatabaseNode::QueryIRModule)
       .def_method("meta_schedule.DatabaseDumpPruned", &DatabaseNode::DumpPruned)
+      .def_method("meta_schedule.DatabaseCompact", &DatabaseNode::Compact)
       .def("meta_schedule.DatabasePyDatabase", Database::PyDatabase);
 }
 
@@ -18,9 +18,16 @@
  */
 #include <tvm/ffi/reflection/registry.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iterator>
 #include <set>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "../module_equality.h"
 #include "../utils.h"
@@ -74,20 +81,39 @@ class JSONDatabaseNode : public DatabaseNode {
       : DatabaseNode(mod_eq_name),
         workloads2idx_(/*bucket_count*/ 0, WorkloadHash(), WorkloadEqual(GetModuleEquality())) {}
 
+  /*! \brief The tuning records of a single workload. */
+  struct WorkloadRecords {
+    /*! \brief The valid records, sorted by mean running time. */
+    std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> valid;
+    /*! \brief The records that failed to build or run, in commit order. */
+    std::deque<TuningRecord> invalid;
+  };
+
   /*! \brief The path to the workload table */
   ffi::String path_workload;
   /*! \brief The path to the tuning record table */
   ffi::String path_tuning_record;
-  /*! \brief All the workloads in the database */
+  /*!
+   * \brief The maximum number of valid and of invalid records kept in memory per workload,
+   * -1 for unlimited. The files on disk always keep every committed record.
+   */
+  int max_records_per_workload = -1;
+  /*!
+   * \brief All the workloads in the database, mapped to the index of their first line in the
+   * workload table. Records of duplicate lines of the same workload are kept under that index.
+   */
   std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
-  /*! \brief All the tuning records in the database */
-  std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> tuning_records_;
+  /*! \brief The tuning records in the database, one entry per line of the workload table */
+  std::vector<WorkloadRecords> records_by_workload_;
+  /*! \brief The number of tuning records in memory */
+  int64_t num_records_ = 0;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
     refl::ObjectDef<JSONDatabaseNode>()
         .def_ro("path_workload", &JSONDatabaseNode::path_workload)
-        .def_ro("path_tuning_record", &JSONDatabaseNode::path_tuning_record);
+        .def_ro("path_tuning_record", &JSONDatabaseNode::path_tuning_record)
+        .def_ro("max_records_per_workload", &JSONDatabaseNode::max_records_per_workload);
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.JSONDatabase", JSONDatabaseNode, DatabaseNode);
 
@@ -104,17 +130,20 @@ class JSONDatabaseNode : public DatabaseNode {
     Workload workload = it->first;
     // If `mod` is new in `workloads2idx_`, append it to the workload file
     if (inserted) {
-      it->second = static_cast<int>(this->workloads2idx_.size()) - 1;
+      // Duplicate lines leave the table longer than `workloads2idx_`, so index by line count
+      it->second = static_cast<int>(this->records_by_workload_.size());
+      this->records_by_workload_.emplace_back();
       JSONFileAppendLine(this->path_workload, JSONDumps(workload->AsJSON()));
     }
     return it->first;
   }
 
   void CommitTuningRecord(const TuningRecord& record) {
-    this->tuning_records_.insert(record);
+    int workload_index = this->workloads2idx_.at(record->workload);
+    this->InsertTuningRecord(workload_index, record);
     JSONFileAppendLine(this->path_tuning_record,
                        JSONDumps(ffi::Array<Any>{
-                           /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
+                           /*workload_index=*/Integer(workload_index),
                            /*tuning_record=*/record->AsJSON()  //
                        }));
   }
@@ -124,47 +153,114 @@ class JSONDatabaseNode : public DatabaseNode {
     if (top_k == 0) {
       return {};
     }
+    auto it = this->workloads2idx_.find(workload);
+    if (it == this->workloads2idx_.end() ||
+        static_cast<size_t>(it->second) >= this->records_by_workload_.size()) {
+      return {};
+    }
+    const auto& valid = this->records_by_workload_[it->second].valid;
     ffi::Array<TuningRecord> results;
-    results.reserve(top_k);
-    for (const TuningRecord& record : this->tuning_records_) {
-      auto run_secs = record->run_secs;
-      if (!record->IsValid()) {
-        continue;
-      }
-      if (record->workload.same_as(workload) ||
-          WorkloadEqual(GetModuleEquality())(record->workload, workload)) {
-        results.push_back(record);
-        if (results.size() == static_cast<size_t>(top_k)) {
-          break;
-        }
+    results.reserve(std::min(static_cast<size_t>(top_k), valid.size()));
+    for (const TuningRecord& record : valid) {
+      results.push_back(record);
+      if (results.size() == static_cast<size_t>(top_k)) {
+        break;
       }
     }
     return results;
   }
 
   ffi::Array<TuningRecord> GetAllTuningRecords() {
-    ffi::Array<TuningRecord> results;
-    results.reserve(Size());
-    for (const TuningRecord& record : this->tuning_records_) {
-      results.push_back(record);
+    std::vector<TuningRecord> records;
+    records.reserve(Size());
+    for (const WorkloadRecords& workload_records : this->records_by_workload_) {
+      records.insert(records.end(), workload_records.valid.begin(), workload_records.valid.end());
+      records.insert(records.end(), workload_records.invalid.begin(),
+                     workload_records.invalid.end());
     }
-    return results;
+    std::stable_sort(records.begin(), records.end(), SortTuningRecordByMeanRunSecs());
+    return ffi::Array<TuningRecord>(records.begin(), records.end());
+  }
+
+  int64_t Size() { return num_records_; }
+
+  int64_t Compact(int top_k) final {
+    int64_t num_records = num_records_;
+    num_records_ = 0;
+    for (WorkloadRecords& workload_records : this->records_by_workload_) {
+      std::vector<TuningRecord> kept = SelectCompactedRecords(
+          std::vector<TuningRecord>(workload_records.valid.begin(), workload_records.valid.end()),
+          top_k);
+      workload_records.valid.clear();
+      workload_records.valid.insert(kept.begin(), kept.end());
+      workload_records.invalid.clear();
+      num_records_ += kept.size();
+    }
+    // Stream the kept records to a temporary file, which then replaces the table at once, so that
+    // a reader never sees a partially written table
+    std::string path_tmp = std::string(this->path_tuning_record) + ".tmp";
+    {
+      std::ofstream os(path_tmp, std::ofstream::trunc);
+      CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path_tmp;
+      for (size_t i = 0; i < this->records_by_workload_.size(); ++i) {
+        for (const TuningRecord& record : this->records_by_workload_[i].valid) {
+          os << JSONDumps(ffi::Array<Any>{
+                    /*workload_index=*/Integer(i),
+                    /*tuning_record=*/record->AsJSON()  //
+                })
+             << '\n';
+        }
+      }
+      os.flush();
+      CHECK(os.good()) << "ValueError: Failed to write the file: " << path_tmp;
+    }
+    CHECK_EQ(std::rename(path_tmp.c_str(), this->path_tuning_record.c_str()), 0)
+        << "ValueError: Cannot replace " << this->path_tuning_record << ": "
+        << std::strerror(errno);
+    return num_records - num_records_;
   }
 
-  int64_t Size() { return tuning_records_.size(); }
+  /*! \brief Add a record to the in-memory index, evicting the worst one beyond the cap. */
+  void InsertTuningRecord(int workload_index, const TuningRecord& record) {
+    if (static_cast<size_t>(workload_index) >= this->records_by_workload_.size()) {
+      this->records_by_workload_.resize(workload_index + 1);
+    }
+    WorkloadRecords& workload_records = this->records_by_workload_[workload_index];
+    size_t cap = static_cast<size_t>(max_records_per_workload);
+    ++num_records_;
+    if (record->IsValid()) {
+      workload_records.valid.insert(record);
+      if (max_records_per_workload >= 0 && workload_records.valid.size() > cap) {
+        workload_records.valid.erase(std::prev(workload_records.valid.end()));
+        --num_records_;
+      }
+    } else {
+      workload_records.invalid.push_back(record);
+      if (max_records_per_workload >= 0 && workload_records.invalid.size() > cap) {
+        workload_records.invalid.pop_front();
+        --num_records_;
+      }
+    }
+  }
 };
 
 Database Database::JSONDatabase(ffi::String path_workload, ffi::String path_tuning_record,
-                                bool allow_missing, ffi::String mod_eq_name) {
+                                bool allow_missing, ffi::String mod_eq_name,
+                                int max_records_per_workload) {
+  CHECK(max_records_per_workload >= -1)
+      << "ValueError: max_records_per_workload must be -1 (unlimited) or non-negative";
   int num_threads = std::thread::hardware_concurrency();
   ObjectPtr<JSONDatabaseNode> n = ffi::make_object<JSONDatabaseNode>(mod_eq_name);
+  n->max_records_per_workload = max_records_per_workload;
   // Load `n->workloads2idx_` from `path_workload`
   std::vector<Workload> workloads;
+  std::vector<int> canonical_indices;
   {
     std::vector<Any> json_objs = JSONFileReadLines(path_workload, num_threads, allow_missing);
     int n_objs = json_objs.size();
     n->workloads2idx_.reserve(n_objs);
     workloads.reserve(n_objs);
+    canonical_indices.reserve(n_objs);
     for (int i = 0; i < n_objs; ++i) {
       Workload workload = Workload::FromJSON(json_objs[i].cast<ObjectRef>());
       auto recalc_hash = n->GetModuleEquality().Hash(workload->mod);
@@ -175,7 +271,8 @@ Database Database::JSONDatabase(ffi::String path_workload, ffi::String path_tuni
         wkl->shash = recalc_hash;
         workload = Workload(wkl);
       }
-      n->workloads2idx_.emplace(workload, i);
+      // The table may list a workload more than once, e.g. after concatenating two tables
+      canonical_indices.push_back(n->workloads2idx_.emplace(workload, i).first->second);
       workloads.push_back(workload);
     }
   }
@@ -183,6 +280,7 @@ Database Database::JSONDatabase(ffi::String path_workload, ffi::String path_tuni
   {
     std::vector<Any> json_objs = JSONFileReadLines(path_tuning_record, num_threads, allow_missing);
     std::vector<TuningRecord> records;
+    std::vector<int> workload_indices(json_objs.size(), -1);
     records.resize(json_objs.size(), TuningRecord{ffi::UnsafeInit()});
     support::parallel_for_dynamic(
         0, json_objs.size(), num_threads, [&](int thread_id, int task_id) {
@@ -194,6 +292,7 @@ Database Database::JSONDatabase(ffi::String path_workload, ffi::String path_tuni
             int64_t workload_index = arr->at(0).cast<IntImm>()->value;
             ICHECK(workload_index >= 0 && static_cast<size_t>(workload_index) < workloads.size());
             workload = workloads[workload_index];
+            workload_indices[task_id] = workload_index;
             records[task_id] = TuningRecord::FromJSON(arr->at(1).cast<ObjectRef>(), workload);
           } catch (std::runtime_error& e) {
             LOG(FATAL) << "ValueError: Unable to parse TuningRecord, on line " << (task_id + 1)
@@ -204,8 +303,9 @@ Database Database::JSONDatabase(ffi::String path_workload, ffi::String path_tuni
                        << e.what();
           }
         });
-    for (const TuningRecord& record : records) {
-      n->tuning_records_.insert(record);
+    n->records_by_workload_.resize(workloads.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+      n->InsertTuningRecord(canonical_indices[workload_indices[i]], records[i]);
     }
   }
   n->path_workload = path_workload;
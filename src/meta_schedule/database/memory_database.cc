@@ -18,6 +18,9 @@
  */
 #include <tvm/ffi/reflection/registry.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "../module_equality.h"
 #include "../utils.h"
 
@@ -90,6 +93,25 @@ class MemoryDatabaseNode : public DatabaseNode {
   ffi::Array<TuningRecord> GetAllTuningRecords() final { return records; }
 
   int64_t Size() final { return records.size(); }
+
+  int64_t Compact(int top_k) final {
+    std::unordered_map<const WorkloadNode*, std::vector<TuningRecord>> workload2records;
+    for (const TuningRecord& record : records) {
+      workload2records[record->workload.get()].push_back(record);
+    }
+    int64_t num_records = records.size();
+    ffi::Array<TuningRecord> compacted;
+    for (const Workload& workload : workloads) {
+      auto it = workload2records.find(workload.get());
+      if (it != workload2records.end()) {
+        for (const TuningRecord& record : SelectCompactedRecords(std::move(it->second), top_k)) {
+          compacted.push_back(record);
+        }
+      }
+    }
+    records = std::move(compacted);
+    return num_records - static_cast<int64_t>(records.size());
+  }
 };
 
 Database Database::MemoryDatabase(ffi::String mod_eq_name) {
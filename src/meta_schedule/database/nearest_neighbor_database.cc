@@ -0,0 +1,282 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/tir/analysis.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The type and the shape of the anchor block of a workload. */
+struct AnchorShape {
+  /*! \brief The block name, the types of the block iters and the dtypes of the buffers. */
+  std::string op_type;
+  /*! \brief The extents of the block iters. */
+  std::vector<int64_t> extents;
+
+  /*!
+   * \brief Extract the anchor shape of a module.
+   * \return Whether the module has an anchor block with static iter extents.
+   */
+  static bool FromModule(const IRModule& mod, AnchorShape* result) {
+    const tir::BlockNode* block = tir::FindAnchorBlock(mod);
+    if (block == nullptr) {
+      return false;
+    }
+    std::ostringstream os;
+    os << block->name_hint << ':';
+    for (const tir::IterVar& iter : block->iter_vars) {
+      const auto* extent = iter->dom->extent.as<IntImmNode>();
+      if (extent == nullptr) {
+        return false;
+      }
+      os << static_cast<int>(iter->iter_type);
+      result->extents.push_back(extent->value);
+    }
+    for (const auto& regions : {block->writes, block->reads}) {
+      os << ':';
+      for (const tir::BufferRegion& region : regions) {
+        os << region->buffer->dtype << ',';
+      }
+    }
+    result->op_type = os.str();
+    return true;
+  }
+
+  /*! \brief The sum of the absolute log ratios between the iter extents of two shapes. */
+  static double Distance(const AnchorShape& a, const AnchorShape& b) {
+    double result = 0.0;
+    for (size_t i = 0; i < a.extents.size(); ++i) {
+      result += std::abs(std::log(static_cast<double>(a.extents[i]) / b.extents[i]));
+    }
+    return result;
+  }
+};
+
+/*!
+ * \brief Fit a previous tiling decision to a loop of a new extent. Each inner factor becomes the
+ * largest divisor of the remaining extent no larger than it, and the outermost factor takes the
+ * rest, so the tiles stay as close to the tuned ones as the new extent allows.
+ */
+ffi::Array<Integer> FitPerfectTile(const ffi::Array<Integer>& decision, int64_t extent,
+                                   int64_t max_innermost_factor) {
+  int n = decision.size();
+  std::vector<int64_t> result(n, 1);
+  int64_t len = extent;
+  for (int i = n - 1; i > 0; --i) {
+    int64_t limit = std::min<int64_t>(decision[i]->value, len);
+    if (i == n - 1 && max_innermost_factor > 0) {
+      limit = std::min(limit, max_innermost_factor);
+    }
+    int64_t factor = std::max<int64_t>(limit, 1);
+    while (len % factor != 0) {
+      --factor;
+    }
+    result[i] = factor;
+    len /= factor;
+  }
+  result[0] = len;
+  return support::AsArray<int64_t, Integer>(result);
+}
+
+/*!
+ * \brief A database that answers the queries of the workloads it has not seen by transferring the
+ * schedules of its nearest tuned workloads, i.e. the ones whose anchor blocks are of the same type
+ * and of the closest shape, without measuring them.
+ */
+class NearestNeighborDatabaseNode : public DatabaseNode {
+ public:
+  /*! \brief The database of the tuned workloads, which also stores all records committed. */
+  Database database{ffi::UnsafeInit()};
+  /*! \brief The number of nearest workloads whose schedules are tried on a query. */
+  int k;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<NearestNeighborDatabaseNode>()
+        .def_ro("database", &NearestNeighborDatabaseNode::database)
+        .def_ro("k", &NearestNeighborDatabaseNode::k);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.NearestNeighborDatabase",
+                                    NearestNeighborDatabaseNode, DatabaseNode);
+
+ public:
+  bool HasWorkload(const IRModule& mod) final { return database->HasWorkload(mod); }
+
+  Workload CommitWorkload(const IRModule& mod) final { return database->CommitWorkload(mod); }
+
+  void CommitTuningRecord(const TuningRecord& record) final {
+    database->CommitTuningRecord(record);
+  }
+
+  ffi::Array<TuningRecord> GetTopK(const Workload& workload, int top_k) final {
+    return database->GetTopK(workload, top_k);
+  }
+
+  ffi::Array<TuningRecord> GetAllTuningRecords() final { return database->GetAllTuningRecords(); }
+
+  int64_t Size() final { return database->Size(); }
+
+  int64_t Compact(int top_k) final { return database->Compact(top_k); }
+
+  ffi::Optional<TuningRecord> QueryTuningRecord(const IRModule& mod, const Target& target,
+                                                const ffi::String& workload_name) final {
+    if (ffi::Optional<TuningRecord> record =
+            database->QueryTuningRecord(mod, target, workload_name)) {
+      return record;
+    }
+    if (ffi::Optional<tir::Schedule> sch = Transfer(mod, target)) {
+      return TuningRecord(sch.value()->trace().value(), Workload(mod), std::nullopt, target,
+                          std::nullopt);
+    }
+    return std::nullopt;
+  }
+
+  ffi::Optional<tir::Schedule> QuerySchedule(const IRModule& mod, const Target& target,
+                                             const ffi::String& workload_name) final {
+    if (ffi::Optional<tir::Schedule> sch = database->QuerySchedule(mod, target, workload_name)) {
+      return sch;
+    }
+    return Transfer(mod, target);
+  }
+
+ private:
+  /*! \brief Schedule the module with the record of the nearest workload that applies to it. */
+  ffi::Optional<tir::Schedule> Transfer(const IRModule& mod, const Target& target) {
+    AnchorShape shape;
+    if (!AnchorShape::FromModule(mod, &shape)) {
+      return std::nullopt;
+    }
+    // Step 1. Find the best record of each tuned workload of the same anchor type
+    struct Candidate {
+      TuningRecord record;
+      double distance;
+      double mean_run_secs;
+    };
+    std::unordered_map<const WorkloadNode*, Candidate> best;
+    std::unordered_map<const WorkloadNode*, bool> is_same_type;
+    for (const TuningRecord& record : database->GetAllTuningRecords()) {
+      if (!record->IsValid() ||
+          (record->target.defined() && record->target.value()->kind->name != target->kind->name)) {
+        continue;
+      }
+      const WorkloadNode* workload = record->workload.get();
+      auto type_it = is_same_type.find(workload);
+      if (type_it == is_same_type.end()) {
+        AnchorShape tuned;
+        bool same = AnchorShape::FromModule(workload->mod, &tuned) &&
+                    tuned.op_type == shape.op_type && tuned.extents.size() == shape.extents.size();
+        type_it = is_same_type.emplace(workload, same).first;
+        if (same) {
+          best.emplace(workload, Candidate{record, AnchorShape::Distance(shape, tuned),
+                                           SortTuningRecordByMeanRunSecs::kMaxMeanTime});
+        }
+      }
+      if (!type_it->second) {
+        continue;
+      }
+      Candidate& candidate = best.at(workload);
+      double mean_run_secs = SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value());
+      if (mean_run_secs < candidate.mean_run_secs) {
+        candidate.record = record;
+        candidate.mean_run_secs = mean_run_secs;
+      }
+    }
+    // Step 2. Try the records of the k nearest workloads, the nearest first
+    std::vector<Candidate> candidates;
+    candidates.reserve(best.size());
+    for (auto& kv : best) {
+      candidates.push_back(std::move(kv.second));
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+      if (a.distance != b.distance) {
+        return a.distance < b.distance;
+      }
+      return a.mean_run_secs < b.mean_run_secs;
+    });
+    if (static_cast<int>(candidates.size()) > k) {
+      candidates.resize(k);
+    }
+    for (const Candidate& candidate : candidates) {
+      if (ffi::Optional<tir::Schedule> sch = Refit(mod, candidate.record->trace)) {
+        return sch;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /*!
+   * \brief Replay a trace onto a module of a different shape, fitting its tiling decisions to the
+   * new loop extents.
+   * \return The schedule, or std::nullopt if the trace does not apply to the module.
+   */
+  static ffi::Optional<tir::Schedule> Refit(const IRModule& mod, const tir::Trace& trace) {
+    static const tir::InstructionKind& kind_sample_perfect_tile =
+        tir::InstructionKind::Get("SamplePerfectTile");
+    tir::Schedule sch =
+        tir::Schedule::Traced(mod, /*seed=*/-1, /*debug_mask=*/0,
+                              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+    auto f_decision_provider = [&](const tir::Instruction& inst, const ffi::Array<Any>& inputs,
+                                   const ffi::Array<Any>& attrs, const Any& decision) -> Any {
+      if (!inst->kind.same_as(kind_sample_perfect_tile) || decision == nullptr) {
+        return decision;
+      }
+      tir::For loop = sch->Get(inputs[0].cast<tir::LoopRV>());
+      const auto* extent = loop->extent.as<IntImmNode>();
+      if (extent == nullptr) {
+        return decision;
+      }
+      return FitPerfectTile(decision.cast<ffi::Array<Integer>>(), extent->value,
+                            attrs[1].cast<Integer>()->value);
+    };
+    try {
+      trace->ApplyToSchedule(sch, /*remove_postproc=*/false, f_decision_provider);
+    } catch (const std::exception&) {
+      return std::nullopt;
+    }
+    return sch;
+  }
+};
+
+Database Database::NearestNeighborDatabase(Database database, int k) {
+  CHECK_GT(k, 0) << "ValueError: `k` must be positive, but got " << k;
+  ObjectPtr<NearestNeighborDatabaseNode> n = ffi::make_object<NearestNeighborDatabaseNode>();
+  n->database = std::move(database);
+  n->k = k;
+  return Database(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.DatabaseNearestNeighborDatabase",
+                        Database::NearestNeighborDatabase);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { NearestNeighborDatabaseNode::RegisterReflection(); }
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,415 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file remote_database.cc
+ * \brief A database shared by tuning jobs through a record server.
+ *
+ * The server owns a backing database and an append-only log of the records committed to it.
+ * Clients keep every record in a local in-memory cache: their own commits are buffered and sent
+ * in batches, and the records committed by the other clients are pulled from the log before the
+ * cache is queried. Each message is a length-prefixed JSON array, `[method, args...]` for
+ * requests and `[status, payload]` for responses.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../support/socket.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The interval at which the server threads check whether they should stop, in ms. */
+constexpr int kServerPollIntervalMs = 100;
+
+/*! \brief Send a request or a response. */
+void SendMessage(support::TCPSocket* socket, const ffi::Array<Any>& message) {
+  socket->SendBytes(JSONDumps(message));
+}
+
+/*! \brief Receive a request or a response. */
+ffi::Array<Any> RecvMessage(support::TCPSocket* socket) {
+  return JSONLoads(socket->RecvBytes()).cast<ffi::Array<Any>>();
+}
+
+/*! \brief A server that shares the records of a database with the connected clients. */
+class DatabaseServerNode : public runtime::Object {
+ public:
+  /*! \brief The backing database. */
+  Database database{nullptr};
+  /*! \brief The port the server listens on. */
+  int port;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<DatabaseServerNode>()
+        .def_ro("database", &DatabaseServerNode::database)
+        .def_ro("port", &DatabaseServerNode::port);
+  }
+
+  ~DatabaseServerNode() { this->Stop(); }
+
+  void Start(const ffi::String& host, int port, int port_end) {
+    support::Socket::Startup();
+    listen_socket_.Create();
+    this->port = listen_socket_.TryBindHost(host, port, port_end);
+    CHECK_NE(this->port, -1) << "ValueError: Cannot bind the database server to " << host
+                             << " on ports [" << port << ", " << port_end << ")";
+    listen_socket_.Listen();
+    // Seed the log with the records the backing database already has.
+    for (const TuningRecord& record : database->GetAllTuningRecords()) {
+      log_.push_back(LogEntry{/*client_id=*/-1, WorkloadJSON(record->workload), record->AsJSON()});
+    }
+    accept_thread_ = std::thread([this]() { this->AcceptLoop(); });
+  }
+
+  void Stop() {
+    if (stopped_.exchange(true)) {
+      return;
+    }
+    if (accept_thread_.joinable()) {
+      accept_thread_.join();
+    }
+    for (std::thread& thread : client_threads_) {
+      thread.join();
+    }
+    client_threads_.clear();
+    listen_socket_.Close();
+  }
+
+  static constexpr const bool _type_mutable = true;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.DatabaseServer", DatabaseServerNode, Object);
+
+ private:
+  /*! \brief A record committed to the server, kept as JSON to be sent to the clients. */
+  struct LogEntry {
+    int64_t client_id;
+    std::string workload;
+    ObjectRef record;
+  };
+
+  std::string WorkloadJSON(const Workload& workload) {
+    auto it = workload2json_.find(workload);
+    if (it == workload2json_.end()) {
+      it = workload2json_.emplace(workload, JSONDumps(workload->AsJSON())).first;
+      json2workload_.emplace(it->second, workload);
+    }
+    return it->second;
+  }
+
+  Workload JSONWorkload(const std::string& json) {
+    auto it = json2workload_.find(json);
+    if (it == json2workload_.end()) {
+      Workload workload = Workload::FromJSON(JSONLoads(json).cast<ObjectRef>());
+      workload = database->CommitWorkload(workload->mod);
+      it = json2workload_.emplace(json, workload).first;
+      workload2json_.emplace(workload, json);
+    }
+    return it->second;
+  }
+
+  void AcceptLoop() {
+    while (!stopped_) {
+      support::PollHelper poll;
+      poll.WatchRead(listen_socket_.sockfd);
+      poll.Poll(kServerPollIntervalMs);
+      if (!poll.CheckRead(listen_socket_.sockfd)) {
+        continue;
+      }
+      support::TCPSocket socket = listen_socket_.Accept();
+      socket.SetNoDelay(true);
+      client_threads_.emplace_back([this, socket]() mutable { this->Serve(socket); });
+    }
+  }
+
+  void Serve(support::TCPSocket socket) {
+    try {
+      while (!stopped_) {
+        support::PollHelper poll;
+        poll.WatchRead(socket.sockfd);
+        poll.Poll(kServerPollIntervalMs);
+        if (!poll.CheckRead(socket.sockfd)) {
+          continue;
+        }
+        ffi::Array<Any> request = RecvMessage(&socket);
+        ffi::Array<Any> response;
+        try {
+          response = {ffi::String("ok"), Handle(request)};
+        } catch (const std::exception& e) {
+          response = {ffi::String("error"), ffi::String(e.what())};
+        }
+        SendMessage(&socket, response);
+      }
+    } catch (const std::exception& e) {
+      // The client disconnected.
+    }
+    socket.Close();
+  }
+
+  Any Handle(const ffi::Array<Any>& request) {
+    CHECK(!request.empty()) << "ValueError: Empty request";
+    std::string method = request[0].cast<ffi::String>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (method == "connect") {
+      return next_client_id_++;
+    } else if (method == "commit") {
+      // ["commit", client_id, [[workload, record], ...]]
+      int64_t client_id = request[1].cast<int64_t>();
+      for (const Any& item : request[2].cast<ffi::Array<Any>>()) {
+        ffi::Array<Any> pair = item.cast<ffi::Array<Any>>();
+        std::string workload_json = pair[0].cast<ffi::String>();
+        ObjectRef record_json = pair[1].cast<ObjectRef>();
+        Workload workload = JSONWorkload(workload_json);
+        database->CommitTuningRecord(TuningRecord::FromJSON(record_json, workload));
+        log_.push_back(LogEntry{client_id, workload_json, record_json});
+      }
+      return static_cast<int64_t>(log_.size());
+    } else if (method == "pull") {
+      // ["pull", client_id, cursor] -> [new_cursor, [[workload, record], ...]]
+      int64_t client_id = request[1].cast<int64_t>();
+      int64_t cursor = request[2].cast<int64_t>();
+      ffi::Array<Any> records;
+      for (int64_t i = cursor, n = log_.size(); i < n; ++i) {
+        if (log_[i].client_id != client_id) {
+          records.push_back(ffi::Array<Any>{ffi::String(log_[i].workload), log_[i].record});
+        }
+      }
+      return ffi::Array<Any>{static_cast<int64_t>(log_.size()), records};
+    }
+    LOG(FATAL) << "ValueError: Unknown database server method: " << method;
+    throw;
+  }
+
+  /*! \brief The guard of the backing database and the log. */
+  std::mutex mutex_;
+  /*! \brief The records committed so far, in order. */
+  std::vector<LogEntry> log_;
+  /*! \brief The JSON of the workloads sent or received. */
+  std::unordered_map<Workload, std::string, ObjectPtrHash, ObjectPtrEqual> workload2json_;
+  std::unordered_map<std::string, Workload> json2workload_;
+  /*! \brief The id of the next client that connects. */
+  int64_t next_client_id_ = 0;
+  support::TCPSocket listen_socket_;
+  std::atomic<bool> stopped_{false};
+  std::thread accept_thread_;
+  std::vector<std::thread> client_threads_;
+};
+
+/*! \brief A database that shares its records with other tuning jobs through a server. */
+class RemoteDatabaseNode : public DatabaseNode {
+ public:
+  explicit RemoteDatabaseNode(ffi::String mod_eq_name = "structural")
+      : DatabaseNode(mod_eq_name), cache(Database::MemoryDatabase(mod_eq_name)) {}
+
+  ~RemoteDatabaseNode() {
+    try {
+      std::lock_guard<std::mutex> lock(mutex_);
+      this->Flush();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to commit the buffered tuning records to the database server: "
+                   << e.what();
+    }
+    socket_.Close();
+  }
+
+  /*! \brief The host of the server. */
+  ffi::String host;
+  /*! \brief The port of the server. */
+  int port;
+  /*! \brief The number of buffered records that triggers a commit to the server. */
+  int commit_batch_size;
+  /*! \brief The minimum interval between two pulls from the server, in seconds. */
+  double pull_interval_sec;
+  /*! \brief The local cache of all the records. */
+  Database cache;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<RemoteDatabaseNode>()
+        .def_ro("host", &RemoteDatabaseNode::host)
+        .def_ro("port", &RemoteDatabaseNode::port)
+        .def_ro("commit_batch_size", &RemoteDatabaseNode::commit_batch_size)
+        .def_ro("pull_interval_sec", &RemoteDatabaseNode::pull_interval_sec)
+        .def_ro("cache", &RemoteDatabaseNode::cache);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.RemoteDatabase", RemoteDatabaseNode,
+                                    DatabaseNode);
+
+  void Connect() {
+    support::Socket::Startup();
+    socket_.Create();
+    CHECK(socket_.Connect(support::SockAddr(host.c_str(), port)))
+        << "ValueError: Cannot connect to the database server at " << host << ":" << port;
+    socket_.SetNoDelay(true);
+    client_id_ = Call({ffi::String("connect")}).cast<int64_t>();
+    this->Pull(/*force=*/true);
+  }
+
+  bool HasWorkload(const IRModule& mod) final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->Pull(/*force=*/false);
+    return cache->HasWorkload(mod);
+  }
+
+  Workload CommitWorkload(const IRModule& mod) final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Workloads are sent along with the first record committed to them.
+    return cache->CommitWorkload(mod);
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache->CommitTuningRecord(record);
+    pending_.push_back(ffi::Array<Any>{ffi::String(WorkloadJSON(record->workload)),
+                                       record->AsJSON()});
+    if (static_cast<int>(pending_.size()) >= commit_batch_size) {
+      this->Flush();
+    }
+  }
+
+  ffi::Array<TuningRecord> GetTopK(const Workload& workload, int top_k) final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->Pull(/*force=*/false);
+    return cache->GetTopK(workload, top_k);
+  }
+
+  ffi::Array<TuningRecord> GetAllTuningRecords() final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->Pull(/*force=*/true);
+    return cache->GetAllTuningRecords();
+  }
+
+  int64_t Size() final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->Pull(/*force=*/true);
+    return cache->Size();
+  }
+
+  /*! \brief Commit the buffered records and pull the records of the other clients. */
+  void Sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->Pull(/*force=*/true);
+  }
+
+ private:
+  Any Call(ffi::Array<Any> request) {
+    SendMessage(&socket_, request);
+    ffi::Array<Any> response = RecvMessage(&socket_);
+    ICHECK_EQ(response.size(), 2);
+    CHECK(response[0].cast<ffi::String>() == "ok")
+        << "RuntimeError: The database server failed: " << response[1].cast<ffi::String>();
+    return response[1];
+  }
+
+  void Flush() {
+    if (pending_.empty()) {
+      return;
+    }
+    Call({ffi::String("commit"), client_id_, pending_});
+    pending_.clear();
+  }
+
+  void Pull(bool force) {
+    this->Flush();
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - last_pull_ < std::chrono::duration<double>(pull_interval_sec)) {
+      return;
+    }
+    last_pull_ = now;
+    ffi::Array<Any> result =
+        Call({ffi::String("pull"), client_id_, cursor_}).cast<ffi::Array<Any>>();
+    cursor_ = result[0].cast<int64_t>();
+    for (const Any& item : result[1].cast<ffi::Array<Any>>()) {
+      ffi::Array<Any> pair = item.cast<ffi::Array<Any>>();
+      std::string workload_json = pair[0].cast<ffi::String>();
+      auto it = json2workload_.find(workload_json);
+      if (it == json2workload_.end()) {
+        Workload workload = Workload::FromJSON(JSONLoads(workload_json).cast<ObjectRef>());
+        workload = cache->CommitWorkload(workload->mod);
+        it = json2workload_.emplace(workload_json, workload).first;
+        workload2json_.emplace(workload, workload_json);
+      }
+      cache->CommitTuningRecord(TuningRecord::FromJSON(pair[1].cast<ObjectRef>(), it->second));
+    }
+  }
+
+  std::string WorkloadJSON(const Workload& workload) {
+    auto it = workload2json_.find(workload);
+    if (it == workload2json_.end()) {
+      it = workload2json_.emplace(workload, JSONDumps(workload->AsJSON())).first;
+      json2workload_.emplace(it->second, workload);
+    }
+    return it->second;
+  }
+
+  /*! \brief The guard of the connection and the cache, shared by the tuning threads. */
+  std::mutex mutex_;
+  support::TCPSocket socket_;
+  /*! \brief The id of this client on the server, to skip its own records when pulling. */
+  int64_t client_id_ = -1;
+  /*! \brief The position in the log of the server up to which the records are pulled. */
+  int64_t cursor_ = 0;
+  /*! \brief The records committed locally but not sent to the server yet. */
+  ffi::Array<Any> pending_;
+  std::chrono::steady_clock::time_point last_pull_;
+  /*! \brief The JSON of the workloads sent or received. */
+  std::unordered_map<Workload, std::string, ObjectPtrHash, ObjectPtrEqual> workload2json_;
+  std::unordered_map<std::string, Workload> json2workload_;
+};
+
+Database Database::RemoteDatabase(ffi::String host, int port, int commit_batch_size,
+                                  double pull_interval_sec, ffi::String mod_eq_name) {
+  CHECK_GT(commit_batch_size, 0) << "ValueError: `commit_batch_size` must be positive";
+  ObjectPtr<RemoteDatabaseNode> n = ffi::make_object<RemoteDatabaseNode>(mod_eq_name);
+  n->host = host;
+  n->port = port;
+  n->commit_batch_size = commit_batch_size;
+  n->pull_interval_sec = pull_interval_sec;
+  n->Connect();
+  return Database(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  DatabaseServerNode::RegisterReflection();
+  RemoteDatabaseNode::RegisterReflection();
+  refl::GlobalDef()
+      .def("meta_schedule.DatabaseRemoteDatabase", Database::RemoteDatabase)
+      .def_method("meta_schedule.RemoteDatabaseSync", &RemoteDatabaseNode::Sync)
+      .def("meta_schedule.DatabaseServerStart",
+           [](Database database, ffi::String host, int port, int port_end) -> ObjectRef {
+             ObjectPtr<DatabaseServerNode> n = ffi::make_object<DatabaseServerNode>();
+             n->database = database;
+             n->Start(host, port, port_end);
+             return ObjectRef(n);
+           })
+      .def_method("meta_schedule.DatabaseServerStop", &DatabaseServerNode::Stop);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -19,8 +19,11 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <cmath>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -216,31 +219,6 @@ int64_t GetVarStride(const std::vector<MultiIndex>& multi_indices, const IntVec&
   return (result == kNotFound) ? 0 : result;
 }
 
-/*!
- * \brief Converts a 2-dimensional STL vector to a TVM Tensor
- * \param src The source 2-dimensional STL vector
- * \param second_dim_size The length of the second dimension. When the first dim of src is 0,
- * second_dim_size must be specified, and in such case the shape of the result Tensor is
- * (0, second_dim_size).
- * \return The converted TVM Tensor
- */
-runtime::Tensor AsTensor(const std::vector<std::vector<double>>& src, int second_dim_size = -1) {
-  int n = src.size();
-  ICHECK(!src.empty() || second_dim_size != -1);
-  int m = src.empty() ? second_dim_size : src[0].size();
-  runtime::Tensor tgt = runtime::Tensor::Empty(
-      /*shape=*/{n, m},
-      /*dtype=*/DLDataType{kDLFloat, 64, 1},
-      /*ctx=*/DLDevice{kDLCPU, 0});
-  double* data = static_cast<double*>(tgt->data);
-  for (const std::vector<double>& row : src) {
-    for (double v : row) {
-      *data++ = v;
-    }
-  }
-  return tgt;
-}
-
 }  // namespace utils
 
 namespace transform {
@@ -1251,6 +1229,43 @@ struct Feature {
 
 }  // namespace group6
 
+namespace group7 {
+
+/*! \brief Group 7 feature, the reads through the texture cache */
+struct Feature {
+  double texture_bytes = 0.0;         // The bytes read from textures
+  double texture_unique_bytes = 0.0;  // The unique bytes read from textures
+  double texture_ratio = 0.0;         // The fraction of the bytes read that come from textures
+
+  static constexpr int64_t kCount = 3;
+
+  void Export(std::vector<double>* v) const {
+    double vs[] = {
+        slog(texture_bytes),
+        slog(texture_unique_bytes),
+        texture_ratio,
+    };
+    v->insert(v->end(), std::begin(vs), std::end(vs));
+  }
+
+  explicit Feature(const group2::Feature& group2) {
+    double read_bytes = 0.0;
+    for (const group2::Feature::SubFeature& feature : group2.sub_features) {
+      if (feature.access_type == group2::Feature::AccessType::kWrite) {
+        continue;
+      }
+      read_bytes += feature.bytes;
+      if (runtime::IsTextureStorage(ffi::GetRef<Buffer>(feature.buffer).scope())) {
+        texture_bytes += feature.bytes;
+        texture_unique_bytes += feature.unique_bytes;
+      }
+    }
+    texture_ratio = read_bytes > 0.0 ? texture_bytes / read_bytes : 0.0;
+  }
+};
+
+}  // namespace group7
+
 /*! \brief The feature extracted */
 struct Feature {
   const BufferNode* buffer = nullptr;
@@ -1367,6 +1382,8 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
   int arith_intensity_curve_num_samples;
   int cache_line_bytes;
   bool extract_workload;
+  int cache_size;
+  bool extract_texture;
   int feature_vector_length;
 
   static void RegisterReflection() {
@@ -1377,26 +1394,85 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
                 &PerStoreFeatureNode::arith_intensity_curve_num_samples)
         .def_ro("cache_line_bytes", &PerStoreFeatureNode::cache_line_bytes)
         .def_ro("extract_workload", &PerStoreFeatureNode::extract_workload)
+        .def_ro("cache_size", &PerStoreFeatureNode::cache_size)
+        .def_ro("extract_texture", &PerStoreFeatureNode::extract_texture)
         .def_ro("feature_vector_length", &PerStoreFeatureNode::feature_vector_length);
   }
 
-  void ExtractSingle(IRModule mod, bool is_gpu, std::vector<std::vector<double>>* results) {
+  /*! \brief The features of a module, one row of `row_length` per store, without group 6. */
+  struct CachedFeatures {
+    IRModule mod;
+    bool is_gpu;
+    int num_rows;
+    std::vector<double> data;
+  };
+
+  /*! \brief The length of a row of the cached features. */
+  int RowLength() const {
+    return extract_workload ? feature_vector_length - tir::group6::Feature::kCount
+                            : feature_vector_length;
+  }
+
+  std::shared_ptr<const CachedFeatures> ExtractSingle(IRModule mod, bool is_gpu) {
     static transform::Sequential passes = tir::transform::PassListForPerStoreFeature();
-    mod = passes(std::move(mod));
+    auto result = std::make_shared<CachedFeatures>();
+    result->mod = mod;
+    result->is_gpu = is_gpu;
+    mod = passes(DeepCopyIRModule(mod));
     std::vector<tir::Feature> features = tir::PerStoreFeatureCollector::Collect(
         is_gpu, this->cache_line_bytes, this->arith_intensity_curve_num_samples, mod);
-    int n_features = features.size();
-    results->resize(n_features);
-    for (int i = 0; i < n_features; ++i) {
-      const tir::Feature& feature = features[i];
-      std::vector<double>& result = (*results)[i];
-      result.reserve(feature_vector_length);
-      feature.group1->Export(&result);
-      feature.group2->Export(&result, this->buffers_per_store);
-      feature.group3->Export(&result);
-      feature.group4->Export(&result, feature.group5->outer_prod);
-      feature.group5->Export(&result);
+    result->num_rows = features.size();
+    result->data.reserve(features.size() * RowLength());
+    for (const tir::Feature& feature : features) {
+      feature.group1->Export(&result->data);
+      feature.group2->Export(&result->data, this->buffers_per_store);
+      feature.group3->Export(&result->data);
+      feature.group4->Export(&result->data, feature.group5->outer_prod);
+      feature.group5->Export(&result->data);
+      if (extract_texture) {
+        tir::group7::Feature(*feature.group2).Export(&result->data);
+      }
     }
+    ICHECK_EQ(result->data.size(), features.size() * RowLength());
+    return result;
+  }
+
+  /*!
+   * \brief Get the features of a module from the cache, or extract and cache them. Candidates
+   * are scored before they are measured, and scored again when the cost model is updated with
+   * their results, so most of them are looked up at least twice.
+   */
+  std::shared_ptr<const CachedFeatures> GetOrExtract(const IRModule& mod, bool is_gpu) {
+    if (cache_size <= 0) {
+      return ExtractSingle(mod, is_gpu);
+    }
+    size_t key = support::HashCombine(StructuralHash()(mod), is_gpu);
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      auto [begin, end] = cache_.equal_range(key);
+      for (auto it = begin; it != end; ++it) {
+        const CachedFeatures& entry = *it->second->second;
+        if (entry.is_gpu == is_gpu && StructuralEqual()(entry.mod, mod)) {
+          lru_.splice(lru_.begin(), lru_, it->second);
+          return it->second->second;
+        }
+      }
+    }
+    std::shared_ptr<const CachedFeatures> result = ExtractSingle(mod, is_gpu);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    lru_.emplace_front(key, result);
+    cache_.emplace(key, lru_.begin());
+    while (static_cast<int>(lru_.size()) > cache_size) {
+      auto [begin, end] = cache_.equal_range(lru_.back().first);
+      for (auto it = begin; it != end; ++it) {
+        if (it->second == std::prev(lru_.end())) {
+          cache_.erase(it);
+          break;
+        }
+      }
+      lru_.pop_back();
+    }
+    return result;
   }
 
   ffi::Array<runtime::Tensor> ExtractFrom(const TuneContext& tune_context,
@@ -1405,41 +1481,62 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     bool is_gpu = std::find(target_keys.begin(), target_keys.end(), "gpu") != target_keys.end();
     std::vector<runtime::Tensor> results;
     results.resize(candidates.size());
-    std::unique_ptr<tir::group6::Feature> feature_group6 = nullptr;
+    std::vector<double> feature_group6;
     if (extract_workload) {
-      feature_group6 = std::make_unique<tir::group6::Feature>(tune_context->mod.value());
+      tir::group6::Feature(tune_context->mod.value()).Export(&feature_group6);
     }
     auto f = [this, is_gpu, &feature_group6, &candidates, &results](int, int task_id) -> void {
-      const auto& candidate = candidates[task_id];
-      std::vector<std::vector<double>> features;
-      ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu, &features);
-      if (extract_workload) {
-        for (auto& feature : features) {
-          feature_group6->Export(&feature);
-        }
+      std::shared_ptr<const CachedFeatures> features =
+          GetOrExtract(candidates[task_id]->sch->mod(), is_gpu);
+      int64_t row_length = RowLength();
+      runtime::Tensor result = runtime::Tensor::Empty(
+          /*shape=*/{features->num_rows, feature_vector_length},
+          /*dtype=*/DLDataType{kDLFloat, 64, 1},
+          /*ctx=*/DLDevice{kDLCPU, 0});
+      double* data = static_cast<double*>(result->data);
+      const double* src = features->data.data();
+      for (int i = 0; i < features->num_rows; ++i) {
+        data = std::copy(src, src + row_length, data);
+        data = std::copy(feature_group6.begin(), feature_group6.end(), data);
+        src += row_length;
       }
-      results[task_id] = tir::utils::AsTensor(features, this->feature_vector_length);
+      results[task_id] = result;
     };
     support::parallel_for_dynamic(0, candidates.size(), tune_context->num_threads, f);
     return results;
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.PerStoreFeature", PerStoreFeatureNode,
                                     FeatureExtractorNode);
+
+ private:
+  using CacheEntry = std::pair<size_t, std::shared_ptr<const CachedFeatures>>;
+  /*! \brief The mutex guarding the cache. */
+  std::mutex cache_mutex_;
+  /*! \brief The cached features, from the most to the least recently used. */
+  std::list<CacheEntry> lru_;
+  /*! \brief The index of the cached features by the structural hash of the modules. */
+  std::unordered_multimap<size_t, std::list<CacheEntry>::iterator> cache_;
 };
 
 FeatureExtractor FeatureExtractor::PerStoreFeature(int buffers_per_store,
                                                    int arith_intensity_curve_num_samples,
-                                                   int cache_line_bytes, bool extract_workload) {
+                                                   int cache_line_bytes, bool extract_workload,
+                                                   int cache_size, bool extract_texture) {
   ObjectPtr<PerStoreFeatureNode> n = ffi::make_object<PerStoreFeatureNode>();
   n->buffers_per_store = buffers_per_store;
   n->arith_intensity_curve_num_samples = arith_intensity_curve_num_samples;
   n->cache_line_bytes = cache_line_bytes;
   n->extract_workload = extract_workload;
+  n->cache_size = cache_size;
+  n->extract_texture = extract_texture;
   n->feature_vector_length = tir::group1::Feature::kCount +                                  //
                              tir::group2::Feature::SubFeature::kCount * buffers_per_store +  //
                              arith_intensity_curve_num_samples +                             //
                              tir::group4::Feature::kCount +                                  //
                              tir::group5::Feature::kCount;
+  if (extract_texture) {
+    n->feature_vector_length += tir::group7::Feature::kCount;
+  }
   if (extract_workload) {
     n->feature_vector_length += tir::group6::Feature::kCount;
   }
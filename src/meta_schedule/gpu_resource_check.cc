@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "./gpu_resource_check.h"
+
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "./utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+GPUResourceLimits GPUResourceLimits::FromTarget(const Target& target) {
+  GPUResourceLimits limits;
+  if (!IsGPUTarget(target->kind->name)) {
+    return limits;
+  }
+  auto get = [&target](const char* name) -> int64_t {
+    ffi::Optional<Integer> v = target->GetAttr<Integer>(name);
+    return v.has_value() ? v.value()->value : -1;
+  };
+  limits.max_threads_per_block = get("max_threads_per_block");
+  limits.max_shared_memory_per_block = get("max_shared_memory_per_block");
+  limits.registers_per_block = get("registers_per_block");
+  return limits;
+}
+
+namespace {
+
+/*! \brief The bytes of a buffer, or -1 when its shape is not constant. */
+int64_t BufferBytes(const tir::Buffer& buffer) {
+  int64_t bytes = (buffer->dtype.bits() * buffer->dtype.lanes() + 7) / 8;
+  for (const PrimExpr& dim : buffer->shape) {
+    const auto* extent = dim.as<IntImmNode>();
+    if (extent == nullptr) return -1;
+    bytes *= extent->value;
+  }
+  return bytes;
+}
+
+/*! \brief Accumulates the resources of each kernel, i.e. each outermost thread-bound loop. */
+class GPUResourceVisitor : public tir::StmtVisitor {
+ public:
+  explicit GPUResourceVisitor(const GPUResourceLimits& limits) : limits_(limits) {}
+
+  std::string error;
+
+ private:
+  void VisitStmt_(const tir::ForNode* loop) final {
+    if (!error.empty()) return;
+    const auto* extent = loop->extent.as<IntImmNode>();
+    if (loop->kind == tir::ForKind::kVectorized && extent != nullptr) {
+      int64_t bytes = extent->value * MaxStoreBytes(loop->body);
+      if (bytes > limits_.max_vector_bytes) {
+        error = "a vectorized access of " + std::to_string(bytes) + " bytes exceeds " +
+                std::to_string(limits_.max_vector_bytes);
+        return;
+      }
+    }
+    if (loop->kind != tir::ForKind::kThreadBinding || !loop->thread_binding.defined()) {
+      tir::StmtVisitor::VisitStmt_(loop);
+      return;
+    }
+    if (in_kernel_) {
+      RecordThread(loop->thread_binding.value()->thread_tag, extent);
+      tir::StmtVisitor::VisitStmt_(loop);
+      return;
+    }
+    in_kernel_ = true;
+    thread_extents_.clear();
+    shared_bytes_ = 0;
+    local_bytes_ = 0;
+    RecordThread(loop->thread_binding.value()->thread_tag, extent);
+    tir::StmtVisitor::VisitStmt_(loop);
+    in_kernel_ = false;
+    if (error.empty()) CheckKernel();
+  }
+
+  void VisitStmt_(const tir::BlockNode* block) final {
+    for (const tir::Buffer& buffer : block->alloc_buffers) {
+      AddBuffer(buffer);
+    }
+    tir::StmtVisitor::VisitStmt_(block);
+  }
+
+  void RecordThread(const std::string& tag, const IntImmNode* extent) {
+    if (extent == nullptr) return;
+    if (tag.rfind("threadIdx.", 0) == 0 || tag.rfind("vthread", 0) == 0) {
+      int64_t& recorded = thread_extents_[tag];
+      recorded = std::max(recorded, extent->value);
+    }
+  }
+
+  void AddBuffer(const tir::Buffer& buffer) {
+    int64_t bytes = BufferBytes(buffer);
+    if (bytes < 0) return;
+    std::string scope = buffer.scope();
+    if (scope == "shared" || scope == "shared.dyn") {
+      shared_bytes_ += bytes;
+    } else if (scope == "local") {
+      local_bytes_ += bytes;
+    }
+  }
+
+  void CheckKernel() {
+    int64_t threads = 1;
+    int64_t vthreads = 1;
+    for (const auto& kv : thread_extents_) {
+      (kv.first.rfind("vthread", 0) == 0 ? vthreads : threads) *= kv.second;
+    }
+    if (limits_.max_threads_per_block > 0 && threads > limits_.max_threads_per_block) {
+      error = std::to_string(threads) + " threads exceed max_threads_per_block " +
+              std::to_string(limits_.max_threads_per_block);
+    } else if (vthreads > limits_.max_vthread) {
+      error = std::to_string(vthreads) + " virtual threads exceed " +
+              std::to_string(limits_.max_vthread);
+    } else if (limits_.max_shared_memory_per_block > 0 &&
+               shared_bytes_ > limits_.max_shared_memory_per_block) {
+      error = std::to_string(shared_bytes_) + " bytes of shared memory exceed " +
+              "max_shared_memory_per_block " + std::to_string(limits_.max_shared_memory_per_block);
+    } else if (limits_.registers_per_block > 0 &&
+               (local_bytes_ + 3) / 4 * threads * vthreads > limits_.registers_per_block) {
+      error = std::to_string((local_bytes_ + 3) / 4) + " registers per thread for " +
+              std::to_string(threads * vthreads) + " threads exceed registers_per_block " +
+              std::to_string(limits_.registers_per_block);
+    }
+  }
+
+  static int64_t MaxStoreBytes(const tir::Stmt& body) {
+    int64_t bytes = 1;
+    tir::PostOrderVisit(body, [&bytes](const ObjectRef& obj) {
+      if (const auto* store = obj.as<tir::BufferStoreNode>()) {
+        DataType dtype = store->buffer->dtype;
+        bytes = std::max<int64_t>(bytes, (dtype.bits() * dtype.lanes() + 7) / 8);
+      }
+    });
+    return bytes;
+  }
+
+  const GPUResourceLimits& limits_;
+  bool in_kernel_ = false;
+  std::unordered_map<std::string, int64_t> thread_extents_;
+  int64_t shared_bytes_ = 0;
+  int64_t local_bytes_ = 0;
+};
+
+}  // namespace
+
+std::string CheckGPUResources(const IRModule& mod, const GPUResourceLimits& limits) {
+  if (!limits.defined()) {
+    return "";
+  }
+  IRModule compacted{ffi::UnsafeInit()};
+  try {
+    compacted = tvm::transform::Sequential(ffi::Array<tvm::transform::Pass>{
+        tir::transform::LowerInitBlock(),
+        tir::transform::PlanAndUpdateBufferAllocationLocation(),
+        tir::transform::ConvertBlocksToOpaque(),
+        tir::transform::CompactBufferAllocation(),
+    })(mod);
+  } catch (const std::exception&) {
+    // Leave the schedules that do not lower to the postprocessors.
+    return "";
+  }
+  for (const auto& kv : compacted->functions) {
+    if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+      GPUResourceVisitor visitor(limits);
+      visitor(func->body);
+      if (!visitor.error.empty()) {
+        return visitor.error;
+      }
+    }
+  }
+  return "";
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_META_SCHEDULE_GPU_RESOURCE_CHECK_H_
+#define TVM_META_SCHEDULE_GPU_RESOURCE_CHECK_H_
+
+#include <tvm/ir/module.h>
+#include <tvm/target/target.h>
+
+#include <string>
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief The per-block resource limits of a GPU target that a schedule is checked against before
+ * it is postprocessed. A negative limit is not checked.
+ */
+struct GPUResourceLimits {
+  /*! \brief The maximum number of threads of a thread block. */
+  int64_t max_threads_per_block = -1;
+  /*! \brief The maximum bytes of shared memory of a thread block. */
+  int64_t max_shared_memory_per_block = -1;
+  /*! \brief The number of 32-bit registers of a thread block. */
+  int64_t registers_per_block = -1;
+  /*! \brief The maximum number of virtual threads, as VerifyGPUCode checks. */
+  int64_t max_vthread = 8;
+  /*! \brief The maximum bytes of a vectorized access, as VerifyGPUCode checks. */
+  int64_t max_vector_bytes = 16;
+
+  /*!
+   * \brief The limits of a target, all unchecked when it is not a GPU target.
+   * \param target The target.
+   * \return The limits.
+   */
+  static GPUResourceLimits FromTarget(const Target& target);
+
+  /*! \return Whether any limit is checked. */
+  bool defined() const {
+    return max_threads_per_block > 0 || max_shared_memory_per_block > 0 ||
+           registers_per_block > 0;
+  }
+};
+
+/*!
+ * \brief Check a scheduled, not postprocessed module against the resource limits of a GPU.
+ *
+ * Unlike the VerifyGPUCode postprocessor, the module is not lowered: the buffers are only
+ * compacted to find the footprints of the shared and local buffers, so that the check is cheap
+ * enough for the candidates that the postprocessors would reject anyway. The registers are
+ * estimated from the local buffers alone. The extents that are not constant are not checked.
+ *
+ * \param mod The scheduled module.
+ * \param limits The limits to check.
+ * \return An empty string when the module is within the limits, otherwise the limit it exceeds.
+ */
+std::string CheckGPUResources(const IRModule& mod, const GPUResourceLimits& limits);
+
+}  // namespace meta_schedule
+}  // namespace tvm
+
+#endif  // TVM_META_SCHEDULE_GPU_RESOURCE_CHECK_H_
@@ -24,28 +24,90 @@
 #include <tvm/node/structural_equal.h>
 #include <tvm/node/structural_hash.h>
 #include <tvm/tir/analysis.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt.h>
 
 #include <memory>
 
 namespace tvm {
 namespace meta_schedule {
 
+namespace {
+
+/*! \brief Whether two buffers may be equal, from their data types and constant shapes. */
+bool BufferMayEqual(const tir::Buffer& lhs, const tir::Buffer& rhs) {
+  if (lhs->dtype != rhs->dtype || lhs->shape.size() != rhs->shape.size()) return false;
+  for (size_t i = 0; i < lhs->shape.size(); ++i) {
+    const auto* lhs_dim = lhs->shape[i].as<IntImmNode>();
+    const auto* rhs_dim = rhs->shape[i].as<IntImmNode>();
+    if ((lhs_dim == nullptr) != (rhs_dim == nullptr)) return false;
+    if (lhs_dim != nullptr && lhs_dim->value != rhs_dim->value) return false;
+  }
+  return true;
+}
+
+/*!
+ * \brief Whether the PrimFuncs of two modules may be equal, from the buffers of their
+ *  parameters. The workloads of an operator mostly differ in their shapes, which rejects them
+ *  without traversing the bodies.
+ */
+bool PrimFuncsMayEqual(const IRModule& lhs, const IRModule& rhs) {
+  for (const auto& [gvar, base_func] : lhs->functions) {
+    const auto* lhs_func = base_func.as<tir::PrimFuncNode>();
+    if (lhs_func == nullptr || !rhs->ContainGlobalVar(gvar->name_hint)) continue;
+    const auto* rhs_func = rhs->Lookup(gvar->name_hint).as<tir::PrimFuncNode>();
+    if (rhs_func == nullptr) continue;
+    if (lhs_func->params.size() != rhs_func->params.size()) return false;
+    for (size_t i = 0; i < lhs_func->params.size(); ++i) {
+      ffi::Optional<tir::Buffer> lhs_buffer = lhs_func->buffer_map.Get(lhs_func->params[i]);
+      ffi::Optional<tir::Buffer> rhs_buffer = rhs_func->buffer_map.Get(rhs_func->params[i]);
+      if (lhs_buffer.has_value() != rhs_buffer.has_value()) return false;
+      if (lhs_buffer.has_value() && !BufferMayEqual(lhs_buffer.value(), rhs_buffer.value())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/*! \brief Whether two blocks may be equal, from the buffers they read and write. */
+bool BlockMayEqual(const tir::BlockNode* lhs, const tir::BlockNode* rhs) {
+  if (lhs->iter_vars.size() != rhs->iter_vars.size() || lhs->reads.size() != rhs->reads.size() ||
+      lhs->writes.size() != rhs->writes.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs->reads.size(); ++i) {
+    if (!BufferMayEqual(lhs->reads[i]->buffer, rhs->reads[i]->buffer)) return false;
+  }
+  for (size_t i = 0; i < lhs->writes.size(); ++i) {
+    if (!BufferMayEqual(lhs->writes[i]->buffer, rhs->writes[i]->buffer)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 class ModuleEqualityStructural : public ModuleEquality {
  public:
-  size_t Hash(IRModule mod) const { return tvm::StructuralHash()(mod); }
-  bool Equal(IRModule lhs, IRModule rhs) const { return tvm::StructuralEqual()(lhs, rhs); }
+  size_t Hash(IRModule mod) const { return StructuralHashCache::Hash(mod); }
+  bool Equal(IRModule lhs, IRModule rhs) const {
+    if (lhs.same_as(rhs)) return true;
+    return PrimFuncsMayEqual(lhs, rhs) && tvm::StructuralEqual::EqualWithPrecheck(lhs, rhs);
+  }
   ffi::String GetName() const { return "structural"; }
 };
 
 class ModuleEqualityIgnoreTensor : public ModuleEquality {
  public:
   size_t Hash(IRModule mod) const {
-    return tvm::ffi::StructuralHash::Hash(mod, /*map_free_vars=*/false,
-                                          /*skip_tensor_content=*/true);
+    return StructuralHashCache::Hash(mod, /*map_free_vars=*/false,
+                                     /*skip_tensor_content=*/true);
   }
   bool Equal(IRModule lhs, IRModule rhs) const {
-    return tvm::ffi::StructuralEqual::Equal(lhs, rhs, /*map_free_vars=*/false,
-                                            /*skip_tensor_content=*/true);
+    if (lhs.same_as(rhs)) return true;
+    return PrimFuncsMayEqual(lhs, rhs) &&
+           tvm::StructuralEqual::EqualWithPrecheck(lhs, rhs, /*map_free_vars=*/false,
+                                                   /*skip_tensor_content=*/true);
   }
   ffi::String GetName() const { return "ignore-tensor"; }
 };
@@ -56,7 +118,7 @@ class ModuleEqualityAnchorBlock : public ModuleEquality {
   size_t Hash(IRModule mod) const {
     auto anchor_block = tir::FindAnchorBlock(mod);
     if (anchor_block) {
-      return ffi::StructuralHash::Hash(ffi::GetRef<tir::Block>(anchor_block),
+      return StructuralHashCache::Hash(ffi::GetRef<tir::Block>(anchor_block),
                                        /*map_free_vars=*/false,
                                        /*skip_tensor_content=*/true);
     }
@@ -66,6 +128,7 @@ class ModuleEqualityAnchorBlock : public ModuleEquality {
     auto anchor_block_lhs = tir::FindAnchorBlock(lhs);
     auto anchor_block_rhs = tir::FindAnchorBlock(rhs);
     if (anchor_block_lhs && anchor_block_rhs) {
+      if (!BlockMayEqual(anchor_block_lhs, anchor_block_rhs)) return false;
       return tvm::ffi::StructuralEqual::Equal(ffi::GetRef<tir::Block>(anchor_block_lhs),
                                               ffi::GetRef<tir::Block>(anchor_block_rhs),
                                               /*map_free_vars=*/false,
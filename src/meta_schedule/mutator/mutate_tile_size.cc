@@ -18,9 +18,13 @@
  */
 #include <tvm/ffi/reflection/registry.h>
 
+#include <cmath>
+#include <map>
 #include <mutex>
+#include <tuple>
 #include <unordered_map>
 
+#include "../gpu_resource_check.h"
 #include "../utils.h"
 
 namespace tvm {
@@ -190,22 +194,31 @@ struct FactorMemo {
   std::mutex mutex_;
 };
 
-ffi::Optional<Trace> MutateSampleTileSize(const Trace& trace, Instruction inst,
-                                          std::vector<int64_t> tiles, TRandState* rand_state) {
-  int n_splits = tiles.size();
+/*!
+ * \brief Move a factor of one tile of a Sample-Perfect-Tile decision to another tile
+ * \param inst The Sample-Perfect-Tile instruction
+ * \param tiles The decision, updated with the move
+ * \param rand_state The random state
+ * \param src The tile the factor is moved from
+ * \param dst The tile the factor is moved to
+ * \return Whether a move is found
+ */
+bool SampleTileSizeMove(const Instruction& inst, std::vector<int64_t>* tiles,
+                        TRandState* rand_state, int* src, int* dst) {
+  int n_splits = tiles->size();
   // Step 1. Choose two loops, `x` and `y`
   int x, y;
   // select source
   while (true) {
     x = tir::SampleInt(rand_state, 0, n_splits);
-    if (tiles[x] <= 1) {
+    if ((*tiles)[x] <= 1) {
       continue;
     }
     y = tir::SampleInt(rand_state, 0, n_splits - 1);
     if (y >= x) {
       ++y;
     }
-    std::vector<int> factors = FactorMemo::Factorize(tiles[x]);
+    std::vector<int> factors = FactorMemo::Factorize((*tiles)[x]);
     // Step 2. Choose the divide factor
     int64_t divide_factor;
     if (y != n_splits - 1) {
@@ -214,24 +227,35 @@ ffi::Optional<Trace> MutateSampleTileSize(const Trace& trace, Instruction inst,
       int64_t limit = Downcast<Integer>(inst->attrs[1])->value;
       int max_factor_index = static_cast<int>(factors.size()) - 1;
       for (; max_factor_index >= 1; max_factor_index--) {
-        if (factors[max_factor_index] * tiles[y] <= limit) {
+        if (factors[max_factor_index] * (*tiles)[y] <= limit) {
           break;
         }
       }
       if (max_factor_index == 0) {
         if (n_splits <= 2) {
-          return std::nullopt;
+          return false;
         }
         // Failed on this dst_idx, try next one.
         continue;
       }
       divide_factor = factors[tir::SampleInt(rand_state, 1, max_factor_index + 1)];
     }
-    tiles[x] /= divide_factor;
-    tiles[y] *= divide_factor;
-    return trace->WithDecision(inst, support::AsArray<int64_t, IntImm>(tiles),
-                               /*remove_postproc=*/true);
+    (*tiles)[x] /= divide_factor;
+    (*tiles)[y] *= divide_factor;
+    *src = x;
+    *dst = y;
+    return true;
+  }
+}
+
+ffi::Optional<Trace> MutateSampleTileSize(const Trace& trace, Instruction inst,
+                                          std::vector<int64_t> tiles, TRandState* rand_state) {
+  int x, y;
+  if (!SampleTileSizeMove(inst, &tiles, rand_state, &x, &y)) {
+    return std::nullopt;
   }
+  return trace->WithDecision(inst, support::AsArray<int64_t, IntImm>(tiles),
+                             /*remove_postproc=*/true);
 }
 
 ffi::Optional<Trace> MutateSampleVectorize(const Trace& trace, Instruction inst,
@@ -270,13 +294,210 @@ ffi::Optional<Trace> MutateTileSizeNode::Apply(const Trace& trace, TRandState* r
   }
 }
 
+/*!
+ * \brief The position of each Sample-Perfect-Tile instruction among those of its trace, which
+ * identifies the same tiling across the traces of a design space
+ */
+std::unordered_map<const Object*, int> SamplePerfectTileOrdinals(const Trace& trace) {
+  static const InstructionKind& inst_sample_perfect_tile =
+      InstructionKind::Get("SamplePerfectTile");
+  std::unordered_map<const Object*, int> ordinals;
+  for (const Instruction& inst : trace->insts) {
+    if (inst->kind.same_as(inst_sample_perfect_tile)) {
+      int ordinal = ordinals.size();
+      ordinals.emplace(inst.get(), ordinal);
+    }
+  }
+  return ordinals;
+}
+
+/*!
+ * \brief A mutator that mutates the tile size within the resource limits of the target, guided
+ * by the scores that the cost model predicted for the population
+ */
+class MutateTileSizeGuidedNode : public MutatorNode {
+ public:
+  /*! \brief The number of mutations drawn at a time to choose from. */
+  int max_candidates;
+  /*! \brief The temperature of the softmax over the score statistics of the mutations. */
+  double temperature;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<MutateTileSizeGuidedNode>()
+        .def_ro("max_candidates", &MutateTileSizeGuidedNode::max_candidates)
+        .def_ro("temperature", &MutateTileSizeGuidedNode::temperature);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.MutateTileSizeGuided",
+                                    MutateTileSizeGuidedNode, MutatorNode);
+
+ public:
+  // Inherit from `MutatorNode`
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    this->mod_ = context->mod;
+    if (context->target.defined()) {
+      this->limits_ = GPUResourceLimits::FromTarget(context->target.value());
+    }
+  }
+  // Inherit from `MutatorNode`
+  ffi::Optional<Trace> Apply(const Trace& trace, TRandState* rand_state) final;
+  // Inherit from `MutatorNode`
+  void NotifyPredictedScores(const std::vector<Trace>& traces,
+                             const std::vector<double>& scores) final;
+  // Inherit from `MutatorNode`
+  Mutator Clone() const final {
+    ObjectPtr<MutateTileSizeGuidedNode> n = ffi::make_object<MutateTileSizeGuidedNode>(*this);
+    return Mutator(n);
+  }
+
+ private:
+  /*! \brief The ordinal, the extent, the position and the value of a tile. */
+  using TileKey = std::tuple<int, int64_t, int, int64_t>;
+
+  /*! \brief How much higher than average the population scores the given tiles. */
+  double Affinity(int ordinal, const std::vector<int64_t>& tiles, int x, int y) const {
+    double affinity = 0.0;
+    int64_t extent = Product(tiles);
+    for (int pos : {x, y}) {
+      auto it = tile_scores_.find(TileKey(ordinal, extent, pos, tiles[pos]));
+      if (it != tile_scores_.end()) {
+        affinity += it->second.first / it->second.second - mean_score_;
+      }
+    }
+    return affinity;
+  }
+
+  /*! \brief Whether the schedule of a trace is within the resource limits of the target. */
+  bool WithinLimits(const Trace& trace, TRandState* rand_state) const {
+    if (!limits_.defined() || !mod_.has_value()) {
+      return true;
+    }
+    tir::Schedule sch =
+        tir::Schedule::Traced(mod_.value(), /*rand_state=*/ForkSeed(rand_state), /*debug_mode=*/0,
+                              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+    try {
+      trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+    } catch (const std::exception&) {
+      return false;
+    }
+    return CheckGPUResources(sch->mod(), limits_).empty();
+  }
+
+  /*! \brief The module to tune. */
+  ffi::Optional<IRModule> mod_;
+  /*! \brief The resource limits of the target. */
+  GPUResourceLimits limits_;
+  /*! \brief The sum and the number of the scores of the population with each tile. */
+  std::map<TileKey, std::pair<double, int>> tile_scores_;
+  /*! \brief The mean score of the population. */
+  double mean_score_ = 0.0;
+};
+
+void MutateTileSizeGuidedNode::NotifyPredictedScores(const std::vector<Trace>& traces,
+                                                     const std::vector<double>& scores) {
+  tile_scores_.clear();
+  mean_score_ = 0.0;
+  if (traces.empty()) {
+    return;
+  }
+  for (size_t i = 0; i < traces.size(); ++i) {
+    mean_score_ += scores[i];
+    std::unordered_map<const Object*, int> ordinals = SamplePerfectTileOrdinals(traces[i]);
+    std::vector<Instruction> insts;
+    std::vector<std::vector<int64_t>> decisions;
+    FindSamplePerfectTile(traces[i], &insts, &decisions);
+    for (size_t j = 0; j < insts.size(); ++j) {
+      int64_t extent = Product(decisions[j]);
+      for (int pos = 0, n = decisions[j].size(); pos < n; ++pos) {
+        std::pair<double, int>& stat =
+            tile_scores_[TileKey(ordinals.at(insts[j].get()), extent, pos, decisions[j][pos])];
+        stat.first += scores[i];
+        stat.second += 1;
+      }
+    }
+  }
+  mean_score_ /= traces.size();
+}
+
+ffi::Optional<Trace> MutateTileSizeGuidedNode::Apply(const Trace& trace, TRandState* rand_state) {
+  std::vector<Instruction> sample_perfect_tile_insts;
+  std::vector<Instruction> sample_vectorize_insts;
+  std::vector<std::vector<int64_t>> sample_perfect_tile_tiles;
+  std::vector<int64_t> sample_vectorize_decisions;
+  FindSamplePerfectTile(trace, &sample_perfect_tile_insts, &sample_perfect_tile_tiles);
+  FindSampleVectorize(trace, &sample_vectorize_insts, &sample_vectorize_decisions);
+  int size_a = sample_perfect_tile_insts.size();
+  int size_b = sample_vectorize_insts.size();
+  if (size_a == 0 && size_b == 0) {
+    return std::nullopt;
+  }
+  std::unordered_map<const Object*, int> ordinals = SamplePerfectTileOrdinals(trace);
+  std::vector<Trace> candidates;
+  std::vector<double> affinities;
+  for (int i = 0; i < max_candidates; ++i) {
+    int n = tir::SampleInt(rand_state, 0, size_a + size_b);
+    ffi::Optional<Trace> new_trace;
+    double affinity = 0.0;
+    if (n < size_a) {
+      const Instruction& inst = sample_perfect_tile_insts[n];
+      std::vector<int64_t> tiles = sample_perfect_tile_tiles[n];
+      int x, y;
+      if (!SampleTileSizeMove(inst, &tiles, rand_state, &x, &y)) {
+        continue;
+      }
+      affinity = Affinity(ordinals.at(inst.get()), tiles, x, y);
+      new_trace = trace->WithDecision(inst, support::AsArray<int64_t, IntImm>(tiles),
+                                      /*remove_postproc=*/true);
+    } else {
+      n -= size_a;
+      new_trace = MutateSampleVectorize(trace, sample_vectorize_insts[n],
+                                        sample_vectorize_decisions[n], rand_state);
+    }
+    if (!new_trace.has_value() || !WithinLimits(new_trace.value(), rand_state)) {
+      continue;
+    }
+    candidates.push_back(new_trace.value());
+    affinities.push_back(affinity);
+    if (temperature <= 0.0 || tile_scores_.empty()) {
+      break;
+    }
+  }
+  if (candidates.empty()) {
+    return std::nullopt;
+  }
+  if (candidates.size() == 1) {
+    return candidates[0];
+  }
+  double max_affinity = *std::max_element(affinities.begin(), affinities.end());
+  std::vector<double> probs;
+  probs.reserve(affinities.size());
+  for (double affinity : affinities) {
+    probs.push_back(std::exp((affinity - max_affinity) / temperature));
+  }
+  return candidates[tir::MakeMultinomialSampler(rand_state, probs)()];
+}
+
 Mutator Mutator::MutateTileSize() { return Mutator(ffi::make_object<MutateTileSizeNode>()); }
 
-TVM_FFI_STATIC_INIT_BLOCK() { MutateTileSizeNode::RegisterReflection(); }
+Mutator Mutator::MutateTileSizeGuided(int max_candidates, double temperature) {
+  CHECK_GT(max_candidates, 0) << "ValueError: `max_candidates` must be positive";
+  CHECK_GE(temperature, 0.0) << "ValueError: `temperature` must be non-negative";
+  ObjectPtr<MutateTileSizeGuidedNode> n = ffi::make_object<MutateTileSizeGuidedNode>();
+  n->max_candidates = max_candidates;
+  n->temperature = temperature;
+  return Mutator(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  MutateTileSizeNode::RegisterReflection();
+  MutateTileSizeGuidedNode::RegisterReflection();
+}
 
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("meta_schedule.MutatorMutateTileSize", Mutator::MutateTileSize);
+  refl::GlobalDef()
+      .def("meta_schedule.MutatorMutateTileSize", Mutator::MutateTileSize)
+      .def("meta_schedule.MutatorMutateTileSizeGuided", Mutator::MutateTileSizeGuided);
 }
 
 }  // namespace meta_schedule
@@ -103,6 +103,14 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                  (seed != -1) ? seed : support::LinearCongruentialEngine::DeviceRandom();
              return self->Apply(trace, &seed_);
            })
+      .def("meta_schedule.MutatorNotifyPredictedScores",
+           [](Mutator self, ffi::Array<tir::Trace> traces, ffi::Array<FloatImm> scores) {
+             CHECK_EQ(traces.size(), scores.size())
+                 << "ValueError: Expect a score for each trace";
+             self->NotifyPredictedScores(
+                 std::vector<tir::Trace>(traces.begin(), traces.end()),
+                 support::AsVector<FloatImm, double>(scores));
+           })
       .def_method("meta_schedule.MutatorClone", &MutatorNode::Clone)
       .def("meta_schedule.MutatorPyMutator", Mutator::PyMutator)
       .def("meta_schedule.MutatorDefaultLLVM", Mutator::DefaultLLVM)
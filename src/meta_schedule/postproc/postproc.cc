@@ -104,12 +104,22 @@ ffi::Array<Postproc> Postproc::DefaultCUDATensorCore() {
 
 ffi::Array<Postproc> Postproc::DefaultHexagon() {
   return ffi::Array<Postproc>{
-      Postproc::DisallowDynamicLoop(),   Postproc::RewriteParallelVectorizeUnroll(),
-      Postproc::RewriteReductionBlock(), Postproc::RewriteLayout(),
+      Postproc::DisallowDynamicLoop(),
+      Postproc::RewriteParallelVectorizeUnroll(),
+      Postproc::RewriteReductionBlock(),
+      Postproc::RewriteLayout(),
+      // User DMA only copies contiguous regions into VTCM.
+      Postproc::DisallowAsyncStridedMemCopy(),
       Postproc::VerifyVTCMLimit(),
   };
 }
 
+ffi::Array<Postproc> Postproc::DefaultAdreno() {
+  ffi::Array<Postproc> results = Postproc::DefaultCUDA();
+  results.push_back(Postproc::VerifyTextureStorage());
+  return results;
+}
+
 TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
     .set_dispatch<PyPostprocNode>([](const ObjectRef& n, ReprPrinter* p) {
       const auto* self = n.as<PyPostprocNode>();
@@ -135,7 +145,8 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def("meta_schedule.PostprocDefaultLLVM", Postproc::DefaultLLVM)
       .def("meta_schedule.PostprocDefaultCUDA", Postproc::DefaultCUDA)
       .def("meta_schedule.PostprocDefaultCUDATensorCore", Postproc::DefaultCUDATensorCore)
-      .def("meta_schedule.PostprocDefaultHexagon", Postproc::DefaultHexagon);
+      .def("meta_schedule.PostprocDefaultHexagon", Postproc::DefaultHexagon)
+      .def("meta_schedule.PostprocDefaultAdreno", Postproc::DefaultAdreno);
 }
 
 }  // namespace meta_schedule
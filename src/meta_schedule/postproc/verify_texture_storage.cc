@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class VerifyTextureStorageNode : public PostprocNode {
+ public:
+  /*! \brief The largest width and height of a texture. */
+  int64_t spatial_limit = -1;
+  /*! \brief The largest depth of a texture array. */
+  int64_t depth_limit = -1;
+
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    Target target = context->target.value();
+    spatial_limit = target->GetAttr<Integer>("texture_spatial_limit").value_or(-1)->value;
+    depth_limit = target->GetAttr<Integer>("texture_depth_limit").value_or(-1)->value;
+  }
+
+  bool Verify(const tir::Buffer& buffer) const {
+    std::string scope = buffer.scope();
+    if (!runtime::IsTextureStorage(scope)) {
+      return true;
+    }
+    // A texture on a target without textures can't be lowered.
+    if (spatial_limit <= 0 || depth_limit <= 0) {
+      return false;
+    }
+    return FitsTextureLimits(buffer->shape, buffer->dtype, scope, spatial_limit, depth_limit);
+  }
+
+  bool Apply(const tir::Schedule& sch) final {
+    for (const auto& kv : sch->mod()->functions) {
+      const auto* func = kv.second.as<tir::PrimFuncNode>();
+      if (func == nullptr) continue;
+      for (const auto& it : func->buffer_map) {
+        if (!Verify(it.second)) {
+          return false;
+        }
+      }
+      bool fits = true;
+      tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+        if (const auto* block = obj.as<tir::BlockNode>()) {
+          for (const tir::Buffer& buffer : block->alloc_buffers) {
+            fits = fits && Verify(buffer);
+          }
+        }
+      });
+      if (!fits) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Postproc Clone() const {
+    ObjectPtr<VerifyTextureStorageNode> n = ffi::make_object<VerifyTextureStorageNode>(*this);
+    return Postproc(n);
+  }
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<VerifyTextureStorageNode>();
+  }
+
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.VerifyTextureStorage",
+                                    VerifyTextureStorageNode, PostprocNode);
+};
+
+Postproc Postproc::VerifyTextureStorage() {
+  ObjectPtr<VerifyTextureStorageNode> n = ffi::make_object<VerifyTextureStorageNode>();
+  return Postproc(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  VerifyTextureStorageNode::RegisterReflection();
+  refl::GlobalDef().def("meta_schedule.PostprocVerifyTextureStorage",
+                        Postproc::VerifyTextureStorage);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
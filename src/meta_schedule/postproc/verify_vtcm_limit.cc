@@ -34,6 +34,12 @@ class VerifyVTCMLimitNode : public PostprocNode {
     ICHECK(target->kind->name == "hexagon");
     // The value of 0 will disable VTCM verification.
     vtcm_capacity = target->GetAttr<Integer>("vtcm-capacity").value_or(0);
+    if (vtcm_capacity->value <= 0) {
+      // Fall back to the budget of the build, as the VerifyVTCMLimit pass does.
+      vtcm_capacity = transform::PassContext::Current()
+                          ->GetConfig<Integer>("tir.vtcm_capacity", Integer(0))
+                          .value();
+    }
   }
 
   bool Verify(const IRModule& mod) const {
@@ -46,8 +52,9 @@ class VerifyVTCMLimitNode : public PostprocNode {
   bool Apply(const tir::Schedule& sch) final {
     IRModule mod = sch->mod();
     IRModule lowered{nullptr};
+    // The compaction passes inject the software pipelines, so that the VTCM of a double-buffered
+    // DMA counts twice.
     auto pass_list = tir::GetVTCMCompactionPasses();
-    transform::PassContext pass_ctx = transform::PassContext::Current();
     lowered = tvm::transform::Sequential(pass_list)(std::move(mod));
     if (!Verify(lowered)) {
       return false;
@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/extra/module.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief A runner that measures a batch of built modules in the current process. The repeats
+ * of all the candidates are interleaved, so that a drift of the device, e.g. its clock going
+ * down as it heats up, biases every candidate alike instead of the last ones measured.
+ */
+class InterleavedRunnerNode : public RunnerNode {
+ public:
+  /*! \brief The function that loads an artifact into a runtime module. */
+  ffi::Function f_load_module;
+  /*! \brief The number of runs averaged in one repeat. */
+  int number;
+  /*! \brief The number of repeats of each candidate. */
+  int repeat;
+  /*! \brief The minimum duration of a repeat in milliseconds. */
+  int min_repeat_ms;
+  /*! \brief Whether to flush the cache before each repeat. */
+  bool enable_cache_flush;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<InterleavedRunnerNode>()
+        .def_ro("f_load_module", &InterleavedRunnerNode::f_load_module)
+        .def_ro("number", &InterleavedRunnerNode::number)
+        .def_ro("repeat", &InterleavedRunnerNode::repeat)
+        .def_ro("min_repeat_ms", &InterleavedRunnerNode::min_repeat_ms)
+        .def_ro("enable_cache_flush", &InterleavedRunnerNode::enable_cache_flush);
+  }
+
+  ffi::Array<RunnerFuture> Run(ffi::Array<RunnerInput> runner_inputs) final {
+    int n = runner_inputs.size();
+    std::vector<ffi::Function> timers(n, ffi::Function(nullptr));
+    std::vector<const ffi::Array<Any>*> args(n, nullptr);
+    std::vector<std::vector<double>> run_secs(n);
+    std::vector<ffi::Optional<ffi::String>> error_msgs(n, std::nullopt);
+    // The arguments are allocated once per device and signature, and shared by the candidates.
+    std::unordered_map<std::string, ffi::Array<Any>> args_by_signature;
+    for (int i = 0; i < n; ++i) {
+      const RunnerInput& input = runner_inputs[i];
+      try {
+        Device dev = GetDevice(input->device_type);
+        std::string signature = input->device_type + ":" + JSONDumps(ArgsAsJSON(input));
+        auto it = args_by_signature.find(signature);
+        if (it == args_by_signature.end()) {
+          it = args_by_signature.emplace(signature, AllocArguments(input, dev)).first;
+        }
+        args[i] = &it->second;
+        ffi::Module rt_mod = f_load_module(input->artifact_path).cast<ffi::Module>();
+        ffi::Optional<ffi::Function> f = rt_mod->GetFunction(ffi::symbol::tvm_ffi_main);
+        CHECK(f.has_value()) << "ValueError: The module has no entry function";
+        timers[i] = runtime::profiling::WrapTimeEvaluator(
+            f.value(), dev, number, /*repeat=*/1, min_repeat_ms,
+            /*limit_zero_time_iterations=*/100, /*cooldown_interval_ms=*/0,
+            /*repeats_to_cooldown=*/1, /*cache_flush_bytes=*/0, GetCacheFlush(dev));
+      } catch (const std::exception& e) {
+        error_msgs[i] = "InterleavedRunner: An exception occurred\n" + std::string(e.what());
+      }
+    }
+    // Each round measures every candidate once, starting from a different one each time.
+    for (int r = 0; r < repeat; ++r) {
+      for (int j = 0; j < n; ++j) {
+        int i = (j + r) % n;
+        if (error_msgs[i].has_value()) {
+          continue;
+        }
+        try {
+          std::vector<ffi::AnyView> views(args[i]->begin(), args[i]->end());
+          ffi::Any rv;
+          timers[i].CallPacked(views.data(), views.size(), &rv);
+          ffi::Bytes blob = rv.cast<ffi::Bytes>();
+          ICHECK_EQ(blob.size(), sizeof(double));
+          run_secs[i].push_back(*reinterpret_cast<const double*>(blob.data()));
+        } catch (const std::exception& e) {
+          error_msgs[i] = "InterleavedRunner: An exception occurred\n" + std::string(e.what());
+        }
+      }
+    }
+    ffi::Array<RunnerFuture> results;
+    results.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      ffi::Optional<ffi::Array<FloatImm>> secs = std::nullopt;
+      if (!error_msgs[i].has_value()) {
+        ffi::Array<FloatImm> measured;
+        for (double sec : run_secs[i]) {
+          measured.push_back(FloatImm(DataType::Float(32), sec));
+        }
+        secs = measured;
+      }
+      RunnerResult result(secs, error_msgs[i]);
+      results.push_back(RunnerFuture([]() -> bool { return true; },
+                                     [result]() -> RunnerResult { return result; }));
+    }
+    return results;
+  }
+
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.InterleavedRunner", InterleavedRunnerNode,
+                                    RunnerNode);
+
+ private:
+  static Device GetDevice(const ffi::String& device_type) {
+    ffi::Optional<TargetKind> kind = TargetKind::Get(device_type);
+    CHECK(kind.has_value()) << "ValueError: Unknown device type: " << device_type;
+    return Device{static_cast<DLDeviceType>(kind.value()->default_device_type), 0};
+  }
+
+  static ffi::Array<Any> ArgsAsJSON(const RunnerInput& input) {
+    ffi::Array<Any> json;
+    for (const ArgInfo& arg_info : input->args_info) {
+      json.push_back(arg_info->AsJSON());
+    }
+    return json;
+  }
+
+  static ffi::Array<Any> AllocArguments(const RunnerInput& input, Device dev) {
+    static const auto f_random_fill =
+        ffi::Function::GetGlobal("tvm.contrib.random.random_fill_for_measure");
+    ffi::Array<Any> args;
+    for (const ArgInfo& arg_info : input->args_info) {
+      const auto* info = arg_info.as<TensorInfoNode>();
+      CHECK(info != nullptr) << "NotImplementedError: Unsupported argument: " << arg_info;
+      runtime::Tensor arg = runtime::Tensor::Empty(info->shape, info->dtype, dev);
+      if (f_random_fill.has_value()) {
+        (*f_random_fill)(arg);
+      }
+      args.push_back(arg);
+    }
+    return args;
+  }
+
+  ffi::Function GetCacheFlush(Device dev) const {
+    if (!enable_cache_flush) {
+      return ffi::Function(nullptr);
+    }
+    const char* name =
+        dev.device_type == kDLCUDA ? "l2_cache_flush_cuda" : "cache_flush_cpu_non_first_arg";
+    return ffi::Function::GetGlobal(name).value_or(ffi::Function(nullptr));
+  }
+};
+
+Runner Runner::InterleavedRunner(ffi::Function f_load_module, int number, int repeat,
+                                 int min_repeat_ms, bool enable_cache_flush) {
+  CHECK(f_load_module != nullptr) << "ValueError: `f_load_module` is not defined";
+  CHECK_GT(number, 0) << "ValueError: `number` must be positive";
+  CHECK_GT(repeat, 0) << "ValueError: `repeat` must be positive";
+  ObjectPtr<InterleavedRunnerNode> n = ffi::make_object<InterleavedRunnerNode>();
+  n->f_load_module = std::move(f_load_module);
+  n->number = number;
+  n->repeat = repeat;
+  n->min_repeat_ms = min_repeat_ms;
+  n->enable_cache_flush = enable_cache_flush;
+  return Runner(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  InterleavedRunnerNode::RegisterReflection();
+  refl::GlobalDef().def("meta_schedule.RunnerInterleavedRunner", Runner::InterleavedRunner);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -248,5 +248,75 @@ TVM_FFI_STATIC_INIT_BLOCK() {
   refl::GlobalDef().def("meta_schedule.ScheduleRuleInlineConstantScalars",
                         ScheduleRule::InlineConstantScalars);
 }
+
+/*!
+ * \brief Inline the blocks that decode quantized weights into the reductions, e.g. GEMMs, that
+ * consume them.
+ */
+class InlineDequantizeNode : public ScheduleRuleNode {
+ public:
+  void InitializeWithTuneContext(const TuneContext& context) final {}
+
+  ffi::Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    // Look for a spatial block that reads an integer buffer, e.g. the packed weights unpacked
+    // with shifts and masks or through `take`, and whose consumers are all reductions that
+    // multi-level tiling applies to. Left alone, the decoded weights are materialized in global
+    // memory, or in shared memory once the consumer caches its reads. Inlined, the consumer
+    // caches the packed weights instead and decodes them in registers.
+    tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+    if (block_sref->parent == nullptr || !tir::IsSpatial(block_sref)) {
+      return {sch};
+    }
+    const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+    bool reads_integer = std::any_of(block->reads.begin(), block->reads.end(),
+                                     [](const tir::BufferRegion& region) {
+                                       DataType dtype = region->buffer->dtype;
+                                       return dtype.is_int() || dtype.is_uint();
+                                     });
+    if (block->writes.size() != 1 || !reads_integer) {
+      return {sch};
+    }
+    if (ffi::Optional<ffi::String> ann =
+            tir::GetAnn<ffi::String>(block_sref, tir::attr::meta_schedule_inline_rule)) {
+      if (ann.value() == "disable") return {sch};
+    }
+    tir::ScheduleState state = sch->state();
+    ffi::Array<tir::StmtSRef> consumers = tir::GetConsumers(state, block_sref);
+    bool feeds_reductions =
+        !consumers.empty() && std::all_of(consumers.begin(), consumers.end(),
+                                          [&](const tir::StmtSRef& consumer) {
+                                            return tir::NeedsMultiLevelTiling(state, consumer);
+                                          });
+    if (feeds_reductions && tir::CanComputeInline(state, block_sref)) {
+      sch->ComputeInline(block_rv);
+    }
+    return {sch};
+  }
+
+  ScheduleRule Clone() const final {
+    ObjectPtr<InlineDequantizeNode> n = ffi::make_object<InlineDequantizeNode>(*this);
+    return ScheduleRule(n);
+  }
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<InlineDequantizeNode>();
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.InlineDequantize", InlineDequantizeNode,
+                                    ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::InlineDequantize() {
+  ObjectPtr<InlineDequantizeNode> n = ffi::make_object<InlineDequantizeNode>();
+  return ScheduleRule(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { InlineDequantizeNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.ScheduleRuleInlineDequantize",
+                        ScheduleRule::InlineDequantize);
+}
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -0,0 +1,165 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+namespace {
+
+/*! \brief Check if a buffer is a parameter of a PrimFunc of the module that no block writes. */
+bool IsReadOnlyParam(const IRModule& mod, const tir::Buffer& buffer) {
+  for (const auto& kv : mod->functions) {
+    const auto* func = kv.second.as<tir::PrimFuncNode>();
+    if (func == nullptr) continue;
+    bool is_param = false;
+    for (const auto& it : func->buffer_map) {
+      if (it.second.same_as(buffer)) {
+        is_param = true;
+        break;
+      }
+    }
+    if (!is_param) continue;
+    bool written = false;
+    tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+      if (const auto* block = obj.as<tir::BlockNode>()) {
+        for (const tir::BufferRegion& region : block->writes) {
+          written = written || region->buffer.same_as(buffer);
+        }
+      }
+    });
+    return !written;
+  }
+  return false;
+}
+
+}  // namespace
+
+class CacheReadTextureNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    Target target = context->target.value();
+    this->spatial_limit_ = target->GetAttr<Integer>("texture_spatial_limit").value_or(-1)->value;
+    this->depth_limit_ = target->GetAttr<Integer>("texture_depth_limit").value_or(-1)->value;
+  }
+
+  // Inherited from ScheduleRuleNode
+  ffi::Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final;
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<CacheReadTextureNode> n = ffi::make_object<CacheReadTextureNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ private:
+  /*! \brief The texture scope a buffer fits in, or an empty string if none. */
+  std::string SelectScope(const tir::Buffer& buffer) const {
+    // The conventions only differ in how the outer dimensions are spread over the width, the
+    // height and the depth of the image, so the first one within the limits is taken.
+    for (const char* scope :
+         {"global.texture-weight", "global.texture-nhwc", "global.texture"}) {
+      if (FitsTextureLimits(buffer->shape, buffer->dtype, scope, spatial_limit_, depth_limit_)) {
+        return scope;
+      }
+    }
+    return "";
+  }
+
+ public:
+  /*! \brief The largest width and height of a texture, -1 if the target has no textures. */
+  int64_t spatial_limit_ = -1;
+  /*! \brief The largest depth of a texture array, -1 if the target has no textures. */
+  int64_t depth_limit_ = -1;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<CacheReadTextureNode>();
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.CacheReadTexture", CacheReadTextureNode,
+                                    ScheduleRuleNode);
+};
+
+ffi::Array<tir::Schedule> CacheReadTextureNode::Apply(const tir::Schedule& sch,
+                                                      const tir::BlockRV& block_rv) {
+  if (spatial_limit_ <= 0 || depth_limit_ <= 0) {
+    return {sch};
+  }
+  tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+  const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+  // Only the reductions, e.g. convolutions and dense layers, reread their inputs enough to gain
+  // from the texture cache.
+  bool has_reduction = std::any_of(
+      block->iter_vars.begin(), block->iter_vars.end(),
+      [](const tir::IterVar& iter) { return iter->iter_type == tir::IterVarType::kCommReduce; });
+  if (!has_reduction) {
+    return {sch};
+  }
+  std::vector<std::pair<int, std::string>> texture_reads;
+  for (int i = 0, n = block->reads.size(); i < n; ++i) {
+    const tir::Buffer& buffer = block->reads[i]->buffer;
+    if (buffer.scope() != "global" || !IsReadOnlyParam(sch->mod(), buffer)) {
+      continue;
+    }
+    std::string scope = SelectScope(buffer);
+    if (!scope.empty()) {
+      texture_reads.emplace_back(i, scope);
+    }
+  }
+  if (texture_reads.empty()) {
+    return {sch};
+  }
+  tir::Schedule texture_sch = sch->Copy();
+  texture_sch->Seed(sch->ForkSeed());
+  try {
+    for (const auto& [read_index, scope] : texture_reads) {
+      tir::BlockRV cache_rv = texture_sch->CacheRead(block_rv, read_index, scope);
+      // The copy must stay a block of its own for the codegen to write the image.
+      texture_sch->Annotate(cache_rv, tir::attr::meta_schedule_inline_rule,
+                            ffi::String("disable"));
+      // A texel is written at once, so the channels are vectorized, and RewriteUnboundBlock
+      // binds the loops outside of them to the threads.
+      ffi::Array<tir::LoopRV> loops = texture_sch->GetLoops(cache_rv);
+      texture_sch->Vectorize(loops.back());
+    }
+  } catch (const tvm::runtime::Error& e) {
+    return {sch};
+  }
+  return {texture_sch, sch};
+}
+
+ScheduleRule ScheduleRule::CacheReadTexture() {
+  ObjectPtr<CacheReadTextureNode> n = ffi::make_object<CacheReadTextureNode>();
+  return ScheduleRule(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { CacheReadTextureNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.ScheduleRuleCacheReadTexture",
+                        ScheduleRule::CacheReadTexture);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -61,6 +61,7 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
     }
 
     // Step 1. Make a copy of the original schedule. The new copy is used for scheduling.
+    ffi::Optional<tir::Schedule> grid_sch = GridReduction(sch, block_rv);
     tir::Schedule tmp_sch = sch->Copy();
     tmp_sch->Seed(sch->ForkSeed());
 
@@ -113,6 +114,9 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
         tmp_sch->Split(fused_reduce_loop, {std::nullopt, thread_extent});
     tmp_sch->Bind(split_res[1], "threadIdx.x");
 
+    if (grid_sch.defined()) {
+      return {tmp_sch, grid_sch.value(), sch};
+    }
     return {tmp_sch, sch};
   }
 
@@ -142,6 +146,62 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
     return false;
   }
 
+  /*!
+   * \brief Schedule a reduction too long for a single thread block as a two-pass grid reduction.
+   * The fused reduction loop is split into chunks, the first pass reduces each chunk in a thread
+   * block into an rfactor buffer, and the second pass reduces the partial results of each output
+   * across the threads of a thread block.
+   * \param sch The TensorIR schedule
+   * \param block_rv The reduction block
+   * \return The new schedule, or std::nullopt if the reduction is not long enough or cannot be
+   * rfactored.
+   */
+  ffi::Optional<tir::Schedule> GridReduction(const tir::Schedule& sch,
+                                             const tir::BlockRV& block_rv) {
+    if (grid_reduction_min_extent <= 0) {
+      return std::nullopt;
+    }
+    tir::Schedule grid_sch = sch->Copy();
+    grid_sch->Seed(sch->ForkSeed());
+    try {
+      size_t num_spatial_loops;
+      tir::LoopRV fused_reduce_loop;
+      ReorderAndFuseReductionLoops(grid_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+      const int64_t* extent = tir::GetLoopIntExtent(grid_sch->Get(fused_reduce_loop).get());
+      if (extent == nullptr || *extent < grid_reduction_min_extent) {
+        return std::nullopt;
+      }
+      int n_candidate = static_cast<int>(thread_extents.size());
+      ffi::Array<FloatImm> probs(n_candidate, FloatImm(DataType::Float(32), 1.0 / n_candidate));
+      tir::ExprRV num_chunks = grid_sch->SampleCategorical(thread_extents, probs);
+      tir::ExprRV thread_extent = grid_sch->SampleCategorical(thread_extents, probs);
+      ffi::Array<tir::LoopRV> split =
+          grid_sch->Split(fused_reduce_loop, {num_chunks, std::nullopt, thread_extent});
+      // Pass 1: the chunk loop becomes a spatial loop of the rfactor block, one thread block per
+      // chunk of each output.
+      tir::BlockRV rf_block = grid_sch->RFactor(split[0], num_spatial_loops);
+      ffi::Array<tir::LoopRV> rf_loops = grid_sch->GetLoops(rf_block);
+      ffi::Array<tir::LoopRV> rf_outer(rf_loops.begin(),
+                                       rf_loops.begin() + num_spatial_loops + 1);
+      grid_sch->Bind(grid_sch->Fuse(rf_outer), "blockIdx.x");
+      grid_sch->Bind(rf_loops.back(), "threadIdx.x");
+      // Pass 2: the partial results of each output are reduced by the threads of a thread block.
+      ffi::Array<tir::LoopRV> loops = grid_sch->GetLoops(block_rv);
+      tir::LoopRV block_loop{ffi::UnsafeInit()};
+      if (num_spatial_loops == 0) {
+        block_loop = grid_sch->AddUnitLoop(loops[0]);
+      } else {
+        ffi::Array<tir::LoopRV> spatial_loops(loops.begin(), loops.begin() + num_spatial_loops);
+        block_loop = grid_sch->Fuse(spatial_loops);
+      }
+      grid_sch->Bind(block_loop, "blockIdx.x");
+      grid_sch->Bind(loops.back(), "threadIdx.x");
+    } catch (const tvm::runtime::Error&) {
+      return std::nullopt;
+    }
+    return grid_sch;
+  }
+
   /*!
    * \brief Get the ExprRV which used to define the extent of a given loop.
    * \param trace The trace of the schedule, where the extent is to be found
@@ -274,24 +334,33 @@ class CrossThreadReductionNode : public ScheduleRuleNode {
   int warp_size;
   /*! \brief Candidates of thread axis extent (values are required to be positive). */
   ffi::Array<Integer> thread_extents;
+  /*!
+   * \brief The minimum extent of the fused reduction loop for which a two-pass grid reduction
+   * is added as a candidate. A non-positive value disables the grid reduction.
+   */
+  int64_t grid_reduction_min_extent{-1};
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
     refl::ObjectDef<CrossThreadReductionNode>()
         .def_ro("max_threads_per_block", &CrossThreadReductionNode::max_threads_per_block)
         .def_ro("warp_size", &CrossThreadReductionNode::warp_size)
-        .def_ro("thread_extents", &CrossThreadReductionNode::thread_extents);
+        .def_ro("thread_extents", &CrossThreadReductionNode::thread_extents)
+        .def_ro("grid_reduction_min_extent",
+                &CrossThreadReductionNode::grid_reduction_min_extent);
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.CrossThreadReduction", CrossThreadReductionNode,
                                     ScheduleRuleNode);
 };
 
-ScheduleRule ScheduleRule::CrossThreadReduction(ffi::Array<Integer> thread_extents) {
+ScheduleRule ScheduleRule::CrossThreadReduction(ffi::Array<Integer> thread_extents,
+                                                ffi::Optional<Integer> grid_reduction_min_extent) {
   for (const auto& extent : thread_extents) {
     CHECK(extent->value > 0) << "ValueError: The candidates of thread extent must be positive";
   }
   ObjectPtr<CrossThreadReductionNode> n = ffi::make_object<CrossThreadReductionNode>();
   n->thread_extents = std::move(thread_extents);
+  n->grid_reduction_min_extent = grid_reduction_min_extent.value_or(Integer(-1))->value;
   return ScheduleRule(n);
 }
 
@@ -93,12 +93,19 @@ void MultiLevelTilingNode::InitializeWithTuneContext(const TuneContext& context)
           // is theoretically feasible, but no guarantee for great performance.
           this->stages = {4, 5};
         }
+        // The mbarrier waits of warp-specialized pipelines require sm_90 or higher.
+        this->support_warp_specialization_ = std::stoi(sm) >= 90;
       } catch (const std::invalid_argument& e) {
         LOG(WARNING) << "ValueError: Unable to parse `target.arch`: " << sm
                      << ". Details: " << e.what();
       }
     }
   }
+  if (context->target.value()->kind->name == "hexagon" && reuse_read_.scope == "global.vtcm") {
+    // The tiles read into VTCM are copied by user DMA, which lower_async_dma.cc lowers the async
+    // stage into. Stage 3 places the compute one iteration behind the copies, i.e. double buffers.
+    this->stages = {3};
+  }
   logger = context->logger;
 }
 
@@ -289,10 +296,13 @@ std::vector<State> MultiLevelTilingNode::AddReadReuse(State state) const {
   if (config.req == ReuseType::kNoReuse) {
     return {std::move(state)};
   }
-  ICHECK(config.req != ReuseType::kMayReuse);
   const BlockRV& block_rv = state->block_rv;
   std::vector<State> results;
-  results.reserve(config.levels.size());
+  results.reserve(config.levels.size() + 1);
+  if (config.req == ReuseType::kMayReuse) {
+    // Keep the state reading the buffers in place, e.g. for the tiles too large to be cached.
+    results.push_back(state->Copy());
+  }
   for (int level : config.levels) {
     State new_state = state->Copy();
     Schedule& sch = new_state->sch;
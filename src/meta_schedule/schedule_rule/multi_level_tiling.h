@@ -215,6 +215,8 @@ class MultiLevelTilingNode : public ScheduleRuleNode {
   int max_threads_per_block_;
   /*! \brief All available async pipeline stages. */
   std::vector<int> stages;
+  /*! \brief Whether the target supports warp-specialized software pipelines. */
+  bool support_warp_specialization_;
   /*! \brief The logging function */
   ffi::Function logger;
   /*! \brief The function to overwrite the default condition for applying MultiLevelTiling. */
@@ -259,6 +261,7 @@ ObjectPtr<NodeType> MultiLevelTilingInitCommon(
   }
   n->thread_warp_size_ = -1;
   n->max_threads_per_block_ = -1;
+  n->support_warp_specialization_ = false;
   return n;
 }
 
@@ -711,6 +711,16 @@ std::vector<State> MultiLevelTilingTensorCoreNode::AddSoftwarePipeline(
                   ffi::Array<Integer>{0, 0, 1, 2, 2});
     sch->Annotate(state->tiles[r_indices_[0]].back(), tir::attr::software_pipeline_order,
                   ffi::Array<Integer>{0, 1, 3, 2, 4});
+    if (support_warp_specialization_) {
+      // Search over keeping the copies in the compute threads, or dedicating a producer warp or
+      // warpgroup to them, synchronized with the compute threads through mbarriers.
+      ffi::Array<Integer> num_producer_threads{0, 32, 128};
+      int n = num_producer_threads.size();
+      tir::ExprRV warp_specialize = sch->SampleCategorical(
+          num_producer_threads, ffi::Array<FloatImm>(n, FloatImm(DataType::Float(32), 1.0 / n)));
+      sch->Annotate(state->tiles[r_indices_[0]].back(),
+                    tir::attr::software_pipeline_warp_specialize, warp_specialize);
+    }
   } else {
     // Outer software pipeline: Interleave the outer loop with the (pipelined) inner loop.
     // The prefetching stage of the inner pipeline is executed by one iteration in the outer loop.
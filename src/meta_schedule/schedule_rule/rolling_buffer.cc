@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class RollingBufferNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {}
+
+  // Inherited from ScheduleRuleNode
+  ffi::Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final;
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<RollingBufferNode> n = ffi::make_object<RollingBufferNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ private:
+  /*! \brief Check if the block is a stage of a pipeline that a sliding window consumes. */
+  bool CheckConditions(const tir::Schedule& sch, const tir::BlockRV& block_rv) const {
+    tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+    const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+    // Cond 1. The block is a direct child of the root block, with a single intermediate output.
+    if (block_sref->parent == nullptr || block->writes.size() != 1) {
+      return false;
+    }
+    if (tir::GetScopeRoot(sch->state(), block_sref, /*require_stage_pipeline=*/false)->parent !=
+        nullptr) {
+      return false;
+    }
+    if (tir::HasBeenMultiLevelTiled(block_sref)) {
+      return false;
+    }
+    // Cond 2. The block has a single consumer, which reduces over a window of the output, e.g. a
+    // convolution or a pooling.
+    ffi::Array<tir::StmtSRef> consumers = tir::GetConsumers(sch->state(), block_sref);
+    if (consumers.size() != 1) {
+      return false;
+    }
+    const tir::BlockNode* consumer = TVM_SREF_TO_BLOCK(consumers[0]);
+    return std::any_of(
+        consumer->iter_vars.begin(), consumer->iter_vars.end(),
+        [](const tir::IterVar& iter) { return iter->iter_type == tir::IterVarType::kCommReduce; });
+  }
+
+  /*! \brief The number of bytes of the buffer the block writes. */
+  static int64_t WriteBufferBytes(const tir::Schedule& sch, const tir::BlockRV& block_rv) {
+    const tir::Buffer& buffer = sch->Get(block_rv)->writes[0]->buffer;
+    int64_t bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+    for (const PrimExpr& dim : buffer->shape) {
+      const auto* int_imm = dim.as<IntImmNode>();
+      if (int_imm == nullptr) {
+        return -1;
+      }
+      bytes *= int_imm->value;
+    }
+    return bytes;
+  }
+
+ public:
+  /*! \brief The largest rolling buffer in bytes, -1 for no limit. */
+  int64_t max_buffer_bytes;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<RollingBufferNode>().def_ro("max_buffer_bytes",
+                                                &RollingBufferNode::max_buffer_bytes);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.RollingBuffer", RollingBufferNode,
+                                    ScheduleRuleNode);
+};
+
+ffi::Array<tir::Schedule> RollingBufferNode::Apply(const tir::Schedule& sch,
+                                                   const tir::BlockRV& block_rv) {
+  if (!CheckConditions(sch, block_rv)) {
+    return {sch};
+  }
+  tir::BlockRV consumer_rv = sch->GetConsumers(block_rv)[0];
+  ffi::Array<tir::LoopRV> loops = sch->GetLoops(consumer_rv);
+  // Under the outermost loop that slides the window, e.g. the loop over the output rows of a
+  // convolution, the producer only keeps the rows of a window, which the next iterations reuse.
+  for (const tir::LoopRV& loop : loops) {
+    tir::Schedule rolled = sch->Copy();
+    rolled->Seed(sch->ForkSeed());
+    try {
+      rolled->ComputeAt(block_rv, loop, /*preserve_unit_loops=*/true);
+      rolled->RollingBuffer(block_rv, /*write_buffer_index=*/0);
+    } catch (const tvm::runtime::Error& e) {
+      continue;
+    }
+    int64_t bytes = WriteBufferBytes(rolled, block_rv);
+    if (bytes < 0 || (max_buffer_bytes > 0 && bytes > max_buffer_bytes)) {
+      continue;
+    }
+    rolled->Annotate(loops[0], tir::attr::meta_schedule_rolling_buffer, Integer(1));
+    return {rolled, sch};
+  }
+  return {sch};
+}
+
+ScheduleRule ScheduleRule::RollingBuffer(int64_t max_buffer_bytes) {
+  ObjectPtr<RollingBufferNode> n = ffi::make_object<RollingBufferNode>();
+  n->max_buffer_bytes = max_buffer_bytes;
+  return ScheduleRule(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { RollingBufferNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.ScheduleRuleRollingBuffer", ScheduleRule::RollingBuffer);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -89,9 +89,14 @@ ffi::Array<ScheduleRule> ScheduleRule::DefaultLLVM() {
 }
 
 ffi::Array<ScheduleRule> ScheduleRule::DefaultX86(const ffi::String& type) {
-  static const ffi::Map<ffi::String, ffi::String> intrins = {{"vnni", "dot_16x4_vnni"},
-                                                             {"avx512", "dot_16x4_avx512"}};
-  return {
+  // On AMX targets, the int8 and bf16 tile products are tried first, and the VNNI dot product
+  // covers the workloads whose shapes do not fit the tiles.
+  static const ffi::Map<ffi::String, ffi::Array<ffi::String>> intrins = {
+      {"vnni", {"dot_16x4_vnni"}},
+      {"avxvnni", {"dot_8x4_avxvnni"}},
+      {"avx512", {"dot_16x4_avx512"}},
+      {"amx", {"dot_16x16x64_u8i8i32_amx", "dot_16x16x32_bf16bf16f32_amx", "dot_16x4_vnni"}}};
+  ffi::Array<ScheduleRule> rules{
       ScheduleRule::ApplyCustomRule(),
       ScheduleRule::InlineConstantScalars(),
       ScheduleRule::AutoInline(
@@ -105,34 +110,37 @@ ffi::Array<ScheduleRule> ScheduleRule::DefaultX86(const ffi::String& type) {
       ScheduleRule::AddRFactor(
           /*max_jobs_per_core=*/16,
           /*max_innermost_factor=*/Integer(64)),
-      ScheduleRule::MultiLevelTilingWithIntrin(
-          /*intrin_name=*/intrins[type],
-          /*structure=*/"SSRSRS",
-          /*tile_binds=*/std::nullopt,
-          /*max_innermost_factor=*/Integer(64),
-          /*vector_load_lens=*/std::nullopt,
-          /*reuse_read=*/std::nullopt,
-          /*reuse_write=*/
-          ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
-                                          {"levels", ffi::Array<Integer>{1, 2}},
-                                          {"scope", ffi::String("global")}}),
-      ScheduleRule::MultiLevelTiling(
-          /*structure=*/"SSRSRS",
-          /*tile_binds=*/std::nullopt,
-          /*max_innermost_factor=*/Integer(64),
-          /*vector_load_lens=*/std::nullopt,
-          /*reuse_read=*/std::nullopt,
-          /*reuse_write=*/
-          ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
-                                          {"levels", ffi::Array<Integer>{1, 2}},
-                                          {"scope", ffi::String("global")}}),
-      ScheduleRule::ParallelizeVectorizeUnroll(
-          /*max_jobs_per_core=*/16,
-          /*max_vectorize_extent=*/64,
-          /*unroll_max_steps=*/ffi::Array<Integer>{0, 16, 64, 512},
-          /*unroll_explicit=*/true),
-      ScheduleRule::RandomComputeLocation(),
   };
+  for (const ffi::String& intrin_name : intrins.at(type)) {
+    rules.push_back(ScheduleRule::MultiLevelTilingWithIntrin(
+        /*intrin_name=*/intrin_name,
+        /*structure=*/"SSRSRS",
+        /*tile_binds=*/std::nullopt,
+        /*max_innermost_factor=*/Integer(64),
+        /*vector_load_lens=*/std::nullopt,
+        /*reuse_read=*/std::nullopt,
+        /*reuse_write=*/
+        ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
+                                        {"levels", ffi::Array<Integer>{1, 2}},
+                                        {"scope", ffi::String("global")}}));
+  }
+  rules.push_back(ScheduleRule::MultiLevelTiling(
+      /*structure=*/"SSRSRS",
+      /*tile_binds=*/std::nullopt,
+      /*max_innermost_factor=*/Integer(64),
+      /*vector_load_lens=*/std::nullopt,
+      /*reuse_read=*/std::nullopt,
+      /*reuse_write=*/
+      ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
+                                      {"levels", ffi::Array<Integer>{1, 2}},
+                                      {"scope", ffi::String("global")}}));
+  rules.push_back(ScheduleRule::ParallelizeVectorizeUnroll(
+      /*max_jobs_per_core=*/16,
+      /*max_vectorize_extent=*/64,
+      /*unroll_max_steps=*/ffi::Array<Integer>{0, 16, 64, 512},
+      /*unroll_explicit=*/true));
+  rules.push_back(ScheduleRule::RandomComputeLocation());
+  return rules;
 }
 
 ffi::Array<ScheduleRule> ScheduleRule::DefaultCUDA() {
@@ -292,7 +300,10 @@ ffi::Array<ScheduleRule> ScheduleRule::DefaultHexagon() {
           /*structure=*/"SRSRS",
           /*vector_length_in_bits=*/1024,
           /*max_innermost_factor=*/Integer(128),
-          /*reuse_read=*/std::nullopt,
+          /*reuse_read=*/
+          ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
+                                          {"levels", ffi::Array<Integer>{2}},
+                                          {"scope", ffi::String("global.vtcm")}},
           /*reuse_write=*/
           ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
                                           {"levels", ffi::Array<Integer>{1, 2}},
@@ -416,6 +427,43 @@ ffi::Array<ScheduleRule> GetARMDotprodSpecificRules() {
   };
 }
 
+ffi::Array<ScheduleRule> GetARMI8mmSpecificRules() {
+  return {
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/ffi::String("mmla_2x2x8_i8i8s32_smmla"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/std::nullopt,
+          /*max_innermost_factor=*/Integer(32),
+          /*vector_load_lens=*/std::nullopt,
+          /*reuse_read=*/std::nullopt,
+          /*reuse_write=*/
+          ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
+                                          {"levels", ffi::Array<Integer>{1, 2}},
+                                          {"scope", ffi::String("global")}}),
+      ScheduleRule::MultiLevelTilingWithIntrin(
+          /*intrin_name=*/ffi::String("mmla_2x2x8_u8u8u32_ummla"),
+          /*structure=*/"SSRSRS",
+          /*tile_binds=*/std::nullopt,
+          /*max_innermost_factor=*/Integer(32),
+          /*vector_load_lens=*/std::nullopt,
+          /*reuse_read=*/std::nullopt,
+          /*reuse_write=*/
+          ffi::Map<ffi::String, ffi::Any>{{"req", ffi::String("may")},
+                                          {"levels", ffi::Array<Integer>{1, 2}},
+                                          {"scope", ffi::String("global")}}),
+  };
+}
+
+ffi::Array<ScheduleRule> ScheduleRule::DefaultAdreno() {
+  ffi::Array<ScheduleRule> results{
+      ScheduleRule::ApplyCustomRule(),
+      ScheduleRule::CacheReadTexture(),
+  };
+  ffi::Array<ScheduleRule> append = ScheduleRule::DefaultCUDA();
+  results.insert(results.end(), append.begin() + 1, append.end());
+  return results;
+}
+
 ffi::Array<ScheduleRule> ScheduleRule::DefaultARM(const ffi::String& type) {
   return ffi::Array<ScheduleRule>::Agregate(
       ScheduleRule::ApplyCustomRule(), ScheduleRule::InlineConstantScalars(),
@@ -431,7 +479,10 @@ ffi::Array<ScheduleRule> ScheduleRule::DefaultARM(const ffi::String& type) {
           /*max_jobs_per_core=*/8,
           /*max_innermost_factor=*/Integer(32)),
       "neon" == type ? GetARMNeonSpecificRules() : ffi::Array<ScheduleRule>{},
-      "dotprod" == type ? GetARMDotprodSpecificRules() : ffi::Array<ScheduleRule>{},
+      // Targets with I8MM also have the dot product instructions, which remain the fallback.
+      "i8mm" == type ? GetARMI8mmSpecificRules() : ffi::Array<ScheduleRule>{},
+      "dotprod" == type || "i8mm" == type ? GetARMDotprodSpecificRules()
+                                          : ffi::Array<ScheduleRule>{},
       ScheduleRule::MultiLevelTiling(
           /*structure=*/"SSRSRS",
           /*tile_binds=*/std::nullopt,
@@ -476,6 +527,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def("meta_schedule.ScheduleRuleDefaultCUDA", ScheduleRule::DefaultCUDA)
       .def("meta_schedule.ScheduleRuleDefaultCUDATensorCore", ScheduleRule::DefaultCUDATensorCore)
       .def("meta_schedule.ScheduleRuleDefaultHexagon", ScheduleRule::DefaultHexagon)
+      .def("meta_schedule.ScheduleRuleDefaultAdreno", ScheduleRule::DefaultAdreno)
       .def("meta_schedule.ScheduleRuleDefaultARM", ScheduleRule::DefaultARM);
 }
 
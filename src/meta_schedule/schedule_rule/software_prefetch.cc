@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class SoftwarePrefetchNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    // The prefetches are lowered to `llvm.prefetch`.
+    this->enabled_ = context->target.value()->kind->name == "llvm";
+  }
+
+  // Inherited from ScheduleRuleNode
+  ffi::Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) {
+    tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+    if (!enabled_ || block_sref->parent == nullptr || prefetch_distances.empty()) {
+      return {sch};
+    }
+    const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+    bool reads_global = std::any_of(
+        block->reads.begin(), block->reads.end(),
+        [](const tir::BufferRegion& region) { return region->buffer.scope() == "global"; });
+    if (!reads_global) {
+      return {sch};
+    }
+
+    // The innermost loop is left for vectorization, so the pipeline depth `d` selects the `d`-th
+    // loop outside of it.
+    ffi::Array<tir::LoopRV> loops = sch->GetLoops(block_rv);
+    int num_loops = loops.size();
+    int n = prefetch_distances.size();
+    ffi::Array<FloatImm> probs(n, FloatImm(DataType::Float(32), 1.0 / n));
+    ffi::Array<tir::Schedule> results{sch};
+    for (int depth = 1; depth <= max_pipeline_depth && depth < num_loops; ++depth) {
+      const tir::LoopRV& loop_rv = loops[num_loops - 1 - depth];
+      const tir::ForNode* loop = TVM_SREF_TO_FOR(sch->GetSRef(loop_rv));
+      if (loop->kind != tir::ForKind::kSerial || is_one(loop->extent) ||
+          loop->annotations.count(tir::attr::software_prefetch_distance)) {
+        continue;
+      }
+      tir::Schedule new_sch = sch->Copy();
+      new_sch->Seed(sch->ForkSeed());
+      tir::ExprRV distance = new_sch->SampleCategorical(prefetch_distances, probs);
+      new_sch->Annotate(loop_rv, tir::attr::software_prefetch_distance, distance);
+      results.push_back(new_sch);
+    }
+    return results;
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<SoftwarePrefetchNode> n = ffi::make_object<SoftwarePrefetchNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ public:
+  /*! \brief The candidates of the number of iterations to prefetch ahead. */
+  ffi::Array<Integer> prefetch_distances;
+  /*! \brief The number of loops outside of the innermost one to consider for prefetching. */
+  int max_pipeline_depth;
+  /*! \brief Whether the target supports prefetching. */
+  bool enabled_;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<SoftwarePrefetchNode>()
+        .def_ro("prefetch_distances", &SoftwarePrefetchNode::prefetch_distances)
+        .def_ro("max_pipeline_depth", &SoftwarePrefetchNode::max_pipeline_depth);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.SoftwarePrefetch", SoftwarePrefetchNode,
+                                    ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::SoftwarePrefetch(ffi::Array<Integer> prefetch_distances,
+                                            int max_pipeline_depth) {
+  for (const Integer& distance : prefetch_distances) {
+    CHECK_GT(distance->value, 0)
+        << "ValueError: The prefetch distance should be positive, but got " << distance;
+  }
+  ObjectPtr<SoftwarePrefetchNode> n = ffi::make_object<SoftwarePrefetchNode>();
+  n->prefetch_distances = prefetch_distances;
+  n->max_pipeline_depth = max_pipeline_depth;
+  n->enabled_ = false;
+  return ScheduleRule(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { SoftwarePrefetchNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.ScheduleRuleSoftwarePrefetch",
+                        ScheduleRule::SoftwarePrefetch);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class SplitKNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    this->enabled_ = IsGPUTarget(context->target.value()->kind->name);
+    this->tiling->InitializeWithTuneContext(context);
+  }
+
+  // Inherited from ScheduleRuleNode
+  ffi::Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+    if (!enabled_ || block_sref->parent == nullptr ||
+        !tir::NeedsMultiLevelTiling(sch->state(), block_sref)) {
+      return {sch};
+    }
+    // Only reductions with a small output and a long reduction, e.g. the GEMMs of LLM decoding,
+    // leave the GPU underoccupied when tiled over the output alone.
+    const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+    int64_t spatial_extent = 1;
+    for (const tir::IterVar& iter : block->iter_vars) {
+      const int64_t* extent = as_const_int(iter->dom->extent);
+      if (extent == nullptr) {
+        return {sch};
+      }
+      if (iter->iter_type == tir::IterVarType::kDataPar) {
+        spatial_extent *= *extent;
+      }
+    }
+    if (spatial_extent > max_spatial_extent) {
+      return {sch};
+    }
+
+    tir::Schedule split_sch = sch->Copy();
+    split_sch->Seed(sch->ForkSeed());
+    tir::BlockRV block_rf;
+    try {
+      // Fuse the reduction loops and split off the K partitions, whose number is sampled among
+      // the factors that divide the reduction.
+      size_t num_spatial_loops;
+      tir::LoopRV fused_reduce_loop;
+      ReorderAndFuseReductionLoops(split_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+      const int64_t* reduction_extent =
+          tir::GetLoopIntExtent(split_sch->GetSRef(fused_reduce_loop));
+      if (reduction_extent == nullptr || *reduction_extent < min_reduction_extent) {
+        return {sch};
+      }
+      ffi::Array<Integer> candidates;
+      for (const Integer& factor : split_factors) {
+        if (factor->value < *reduction_extent && *reduction_extent % factor->value == 0) {
+          candidates.push_back(factor);
+        }
+      }
+      if (candidates.empty()) {
+        return {sch};
+      }
+      int n = candidates.size();
+      tir::ExprRV num_splits = split_sch->SampleCategorical(
+          candidates, ffi::Array<FloatImm>(n, FloatImm(DataType::Float(32), 1.0 / n)));
+      ffi::Array<tir::LoopRV> split_loops =
+          split_sch->Split(fused_reduce_loop, {num_splits, std::nullopt});
+      // The rfactor block computes the partial sums of each partition into a workspace, and the
+      // original block becomes the epilogue that adds them up.
+      block_rf = split_sch->RFactor(split_loops[0], num_spatial_loops);
+    } catch (const tvm::runtime::Error& e) {
+      return {sch};
+    }
+
+    // The rfactor block is created after the blocks to visit were collected, so it is tiled here,
+    // with the K partitions as one more spatial axis spread over the thread blocks. The epilogue
+    // is left to the following rules.
+    ffi::Array<tir::Schedule> results{sch};
+    for (const tir::Schedule& tiled : tiling->Apply(split_sch, block_rf)) {
+      results.push_back(tiled);
+    }
+    return results;
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<SplitKNode> n = ffi::make_object<SplitKNode>(*this);
+    n->tiling = tiling->Clone();
+    return ScheduleRule(n);
+  }
+
+ public:
+  /*! \brief The candidates of the number of partitions of the reduction. */
+  ffi::Array<Integer> split_factors;
+  /*! \brief The smallest reduction extent to split. */
+  int64_t min_reduction_extent;
+  /*! \brief The largest number of output elements of a block to split. */
+  int64_t max_spatial_extent;
+  /*! \brief The rule that tiles the partial sums. */
+  ScheduleRule tiling{nullptr};
+  /*! \brief Whether the target is a GPU. */
+  bool enabled_;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<SplitKNode>()
+        .def_ro("split_factors", &SplitKNode::split_factors)
+        .def_ro("min_reduction_extent", &SplitKNode::min_reduction_extent)
+        .def_ro("max_spatial_extent", &SplitKNode::max_spatial_extent)
+        .def_ro("tiling", &SplitKNode::tiling);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.SplitK", SplitKNode, ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::SplitK(ffi::Array<Integer> split_factors, int64_t min_reduction_extent,
+                                  int64_t max_spatial_extent, ScheduleRule tiling) {
+  for (const Integer& factor : split_factors) {
+    CHECK_GT(factor->value, 1) << "ValueError: The number of partitions of the reduction should "
+                                  "be greater than 1, but got "
+                               << factor;
+  }
+  ObjectPtr<SplitKNode> n = ffi::make_object<SplitKNode>();
+  n->split_factors = split_factors;
+  n->min_reduction_extent = min_reduction_extent;
+  n->max_spatial_extent = max_spatial_extent;
+  n->tiling = tiling;
+  n->enabled_ = false;
+  return ScheduleRule(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { SplitKNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.ScheduleRuleSplitK", ScheduleRule::SplitK);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
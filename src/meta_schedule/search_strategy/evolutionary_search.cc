@@ -19,6 +19,15 @@
 
 #include <tvm/ffi/reflection/registry.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "../module_equality.h"
 #include "../utils.h"
 
@@ -116,6 +125,8 @@ struct PerThreadData {
   TRandState rand_state{-1};
   std::function<int32_t()> trace_sampler = nullptr;
   std::function<ffi::Optional<Mutator>()> mutator_sampler = nullptr;
+  /*! \brief The schedules replayed from the prefixes of the mutated traces */
+  std::unique_ptr<tir::TraceReplayCache> replay_cache = std::make_unique<tir::TraceReplayCache>();
 
   /*!
    * \brief Set the value for the trace and mutator samplers per thread.
@@ -241,6 +252,86 @@ std::vector<double> PredictNormalizedScore(const std::vector<Schedule>& candidat
   return scores;
 }
 
+/*!
+ * \brief Mutate a population in the background, and predict the scores of the mutated candidates
+ * chunk by chunk on the calling thread as soon as each chunk is complete.
+ * \param population_size The size of the mutated population.
+ * \param num_threads The number of threads to mutate with.
+ * \param f_mutate The function to produce `next_population[task_id]` on the given thread.
+ * \param next_population The mutated population, filled by `f_mutate`.
+ * \param f_predict The function to predict the scores of a chunk of candidates.
+ * \return The predicted scores of the mutated population.
+ */
+std::vector<double> PipelinedMutateAndPredict(
+    int population_size, int num_threads, const std::function<void(int, int)>& f_mutate,
+    const std::vector<Schedule>& next_population,
+    const std::function<std::vector<double>(const std::vector<Schedule>&)>& f_predict) {
+  constexpr int kNumChunks = 8;
+  int chunk_size = (population_size + kNumChunks - 1) / kNumChunks;
+  int num_chunks = (population_size + chunk_size - 1) / chunk_size;
+  std::vector<std::atomic<int>> num_unfinished(num_chunks);
+  for (int i = 0; i < num_chunks; ++i) {
+    num_unfinished[i] = std::min(chunk_size, population_size - i * chunk_size);
+  }
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<int> finished_chunks;
+  bool mutation_done = false;
+  std::exception_ptr mutation_error = nullptr;
+  std::thread mutation_thread([&]() {
+    try {
+      support::parallel_for_dynamic(0, population_size, num_threads,
+                                    [&](int thread_id, int task_id) {
+                                      f_mutate(thread_id, task_id);
+                                      int chunk_id = task_id / chunk_size;
+                                      if (--num_unfinished[chunk_id] == 0) {
+                                        std::lock_guard<std::mutex> lock(mutex);
+                                        finished_chunks.push_back(chunk_id);
+                                        cv.notify_one();
+                                      }
+                                    });
+    } catch (...) {
+      mutation_error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    mutation_done = true;
+    cv.notify_one();
+  });
+  std::vector<double> scores(population_size, 0.0);
+  std::exception_ptr predict_error = nullptr;
+  for (int num_predicted = 0; num_predicted < num_chunks; ++num_predicted) {
+    int chunk_id;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return !finished_chunks.empty() || mutation_done; });
+      if (finished_chunks.empty()) {
+        break;
+      }
+      chunk_id = finished_chunks.front();
+      finished_chunks.pop_front();
+    }
+    int begin = chunk_id * chunk_size;
+    int end = std::min(begin + chunk_size, population_size);
+    try {
+      std::vector<double> chunk_scores = f_predict(
+          std::vector<Schedule>(next_population.begin() + begin, next_population.begin() + end));
+      ICHECK_EQ(chunk_scores.size(), end - begin);
+      std::copy(chunk_scores.begin(), chunk_scores.end(), scores.begin() + begin);
+    } catch (...) {
+      predict_error = std::current_exception();
+      break;
+    }
+  }
+  mutation_thread.join();
+  if (mutation_error != nullptr) {
+    std::rethrow_exception(mutation_error);
+  }
+  if (predict_error != nullptr) {
+    std::rethrow_exception(predict_error);
+  }
+  return scores;
+}
+
 /**************** Evolutionary Search ****************/
 
 /*!\brief A search strategy that generates measure candidates using evolutionary search. */
@@ -380,6 +471,17 @@ class EvolutionarySearchNode : public SearchStrategyNode {
   /*** Configuration: pick states for measurement ***/
   /*! \brief The ratio of measurements to use randomly sampled states. */
   double eps_greedy;
+  /*** Configuration: scheduling of the evolution ***/
+  /*!
+   * \brief Whether to predict the scores of a generation while it is still being mutated,
+   * instead of after the whole generation is ready.
+   */
+  bool genetic_pipeline_prediction;
+  /*!
+   * \brief The number of consecutive generations without improvement of the best predicted
+   * scores before the evolution stops early. Zero disables the early stop.
+   */
+  int genetic_early_stop_patience;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
@@ -393,7 +495,11 @@ class EvolutionarySearchNode : public SearchStrategyNode {
         .def_ro("genetic_num_iters", &EvolutionarySearchNode::genetic_num_iters)
         .def_ro("genetic_mutate_prob", &EvolutionarySearchNode::genetic_mutate_prob)
         .def_ro("genetic_max_fail_count", &EvolutionarySearchNode::genetic_max_fail_count)
-        .def_ro("eps_greedy", &EvolutionarySearchNode::eps_greedy);
+        .def_ro("eps_greedy", &EvolutionarySearchNode::eps_greedy)
+        .def_ro("genetic_pipeline_prediction",
+                &EvolutionarySearchNode::genetic_pipeline_prediction)
+        .def_ro("genetic_early_stop_patience",
+                &EvolutionarySearchNode::genetic_early_stop_patience);
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.EvolutionarySearch", EvolutionarySearchNode,
                                     SearchStrategyNode);
@@ -462,6 +568,8 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     n->genetic_mutate_prob = this->genetic_mutate_prob;
     n->genetic_max_fail_count = this->genetic_max_fail_count;
     n->eps_greedy = this->eps_greedy;
+    n->genetic_pipeline_prediction = this->genetic_pipeline_prediction;
+    n->genetic_early_stop_patience = this->genetic_early_stop_patience;
     n->ctx_ = this->ctx_;
     n->rand_state_ = this->rand_state_;
     n->state_ = nullptr;  // cleared the state
@@ -544,11 +652,16 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
     exists = this->measured_workloads_;
   }
   SizedHeap heap(num);
+  auto f_predict = [this](const std::vector<Schedule>& candidates) {
+    return PredictNormalizedScore(candidates, ffi::GetRef<TuneContext>(self->ctx_),
+                                  this->cost_model_);
+  };
+  // Predict normalized score with the cost model,
+  std::vector<double> scores = f_predict(population);
+  // The sum of the best predicted scores, which only grows as the heap is updated
+  double best_heap_score = -std::numeric_limits<double>::infinity();
+  int num_stale_iters = 0;
   for (int iter = 0;; ++iter) {
-    // Predict normalized score with the cost model,
-    std::vector<double> scores =
-        PredictNormalizedScore(population, ffi::GetRef<TuneContext>(self->ctx_), this->cost_model_);
-
     {
       auto _ = Profiler::TimedScope("EvoSearch/Evolve/Misc");
       ICHECK_EQ(scores.size(), population.size());
@@ -566,6 +679,33 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
       if (iter == self->genetic_num_iters) {
         break;
       }
+      // Discontinue once the best candidates stop improving
+      if (self->genetic_early_stop_patience > 0) {
+        double heap_score = 0.0;
+        for (const SizedHeap::Item& item : heap.heap) {
+          heap_score += item.score;
+        }
+        if (heap_score > best_heap_score) {
+          best_heap_score = heap_score;
+          num_stale_iters = 0;
+        } else if (++num_stale_iters >= self->genetic_early_stop_patience) {
+          TVM_PY_LOG(INFO, self->ctx_->logger)
+              << "Evolve stops early at iter #" << iter << ": the best " << heap.heap.size()
+              << " predicted scores did not improve in " << num_stale_iters << " iteration(s)";
+          break;
+        }
+      }
+      // Let the mutators guided by the predicted scores observe the population
+      {
+        std::vector<tir::Trace> traces;
+        traces.reserve(population.size());
+        for (const Schedule& sch : population) {
+          traces.push_back(sch->trace().value());
+        }
+        for (const auto& kv : self->mutator_probs_) {
+          kv.first->NotifyPredictedScores(traces, scores);
+        }
+      }
       // Set threaded samplers, with probability from predicated normalized throughput
       for (PerThreadData& data : this->per_thread_data_) {
         data.Set(scores, self->genetic_mutate_prob, self->mutator_probs_);
@@ -596,7 +736,8 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
             // Decision: mutate
             Mutator mutator = opt_mutator.value();
             if (ffi::Optional<tir::Trace> new_trace = mutator->Apply(trace, rand_state)) {
-              if (ffi::Optional<Schedule> sch = pp.Apply(mod, new_trace.value(), rand_state)) {
+              if (ffi::Optional<Schedule> sch = pp.Apply(mod, new_trace.value(), rand_state,
+                                                         data.replay_cache.get())) {
                 // note that sch's trace is different from new_trace
                 // because it contains post-processing information
                 result = sch.value();
@@ -613,10 +754,18 @@ std::vector<Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
           result = population.at(sampled_trace_id);
         }
       };
-      support::parallel_for_dynamic(0, self->population_size, self->ctx_->num_threads,
-                                    f_find_candidate);
+      std::vector<double> next_scores;
+      if (self->genetic_pipeline_prediction) {
+        next_scores = PipelinedMutateAndPredict(self->population_size, self->ctx_->num_threads,
+                                                f_find_candidate, next_population, f_predict);
+      } else {
+        support::parallel_for_dynamic(0, self->population_size, self->ctx_->num_threads,
+                                      f_find_candidate);
+        next_scores = f_predict(next_population);
+      }
 
       population.swap(next_population);
+      scores.swap(next_scores);
       TVM_PY_LOG(INFO, self->ctx_->logger) << "Evolve iter #" << iter << " done. Summary:\n"
                                            << pp.SummarizeFailures();
     }
@@ -749,17 +898,22 @@ size_t EvolutionarySearchNode::State::ModuleHash(const IRModule& mod) const {
   return database_->GetModuleEquality().Hash(mod);
 }
 
-SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,         //
-                                                  double init_measured_ratio,  //
-                                                  int init_min_unmeasured,     //
-                                                  int max_fail_count,          //
-                                                  int genetic_num_iters,       //
-                                                  double genetic_mutate_prob,  //
-                                                  int genetic_max_fail_count,  //
-                                                  double eps_greedy) {
+SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,               //
+                                                  double init_measured_ratio,        //
+                                                  int init_min_unmeasured,           //
+                                                  int max_fail_count,                //
+                                                  int genetic_num_iters,             //
+                                                  double genetic_mutate_prob,        //
+                                                  int genetic_max_fail_count,        //
+                                                  double eps_greedy,                 //
+                                                  bool genetic_pipeline_prediction,  //
+                                                  int genetic_early_stop_patience) {
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(init_measured_ratio, "Initial measured ratio");
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(genetic_mutate_prob, "Mutation probability");
   TVM_META_SCHEDULE_CHECK_PROB_RANGE(eps_greedy, "Greedy pick probability");
+  CHECK_GE(genetic_early_stop_patience, 0)
+      << "ValueError: `genetic_early_stop_patience` should be non-negative, but got "
+      << genetic_early_stop_patience;
   ObjectPtr<EvolutionarySearchNode> n = ffi::make_object<EvolutionarySearchNode>();
   n->population_size = population_size;
   n->num_empty_iters_before_early_stop = 5;
@@ -770,6 +924,8 @@ SearchStrategy SearchStrategy::EvolutionarySearch(int population_size,         /
   n->genetic_max_fail_count = genetic_max_fail_count;
   n->genetic_mutate_prob = genetic_mutate_prob;
   n->eps_greedy = eps_greedy;
+  n->genetic_pipeline_prediction = genetic_pipeline_prediction;
+  n->genetic_early_stop_patience = genetic_early_stop_patience;
   return SearchStrategy(n);
 }
 
@@ -18,6 +18,7 @@
  */
 #include <tvm/ffi/reflection/registry.h>
 
+#include "../gpu_resource_check.h"
 #include "../utils.h"
 
 namespace tvm {
@@ -35,15 +36,79 @@ class PostOrderApplyNode : public SpaceGeneratorNode {
   ffi::Function f_block_filter_ = nullptr;
   /*! \brief The random state. -1 means using random number. */
   TRandState rand_state_ = -1;
+  /*!
+   * \brief The number of times a schedule rule is re-applied to a block when the schedules it
+   * produces exceed the resource limits of the target. Zero disables the checks.
+   */
+  int max_resamples = 0;
+  /*! \brief The resource limits of the target. */
+  GPUResourceLimits limits_;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
-    refl::ObjectDef<PostOrderApplyNode>();
+    refl::ObjectDef<PostOrderApplyNode>().def_ro("max_resamples",
+                                                 &PostOrderApplyNode::max_resamples);
   }
 
   void InitializeWithTuneContext(const TuneContext& context) final {
     SpaceGeneratorNode::InitializeWithTuneContext(context);
     this->rand_state_ = ForkSeed(&context->rand_state);
+    if (context->target.defined()) {
+      this->limits_ = GPUResourceLimits::FromTarget(context->target.value());
+    }
+  }
+
+  /*!
+   * \brief Apply a schedule rule to a block. When some of the schedules it produces exceed the
+   * resource limits of the target, the rule is re-applied with other random decisions to replace
+   * them, so that the invalid candidates are pruned before the postprocessors.
+   * \param sch_rule The schedule rule.
+   * \param sch The schedule to apply the rule to.
+   * \param block_rv The block to apply the rule to.
+   * \return The schedules within the limits, or all of them when none is within after the retries.
+   */
+  ffi::Array<tir::Schedule> ApplyRule(const ScheduleRule& sch_rule, const tir::Schedule& sch,
+                                      const tir::BlockRV& block_rv) {
+    if (max_resamples <= 0 || !limits_.defined()) {
+      return sch_rule->Apply(sch, /*block=*/block_rv);
+    }
+    tir::Schedule original = sch->Copy();
+    ffi::Array<tir::Schedule> applied = sch_rule->Apply(sch, /*block=*/block_rv);
+    std::vector<tir::Schedule> results(applied.begin(), applied.end());
+    std::vector<bool> within(results.size());
+    int num_within = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+      within[i] = CheckGPUResources(results[i]->mod(), limits_).empty();
+      num_within += within[i];
+    }
+    for (int trial = 0; trial < max_resamples && num_within < static_cast<int>(results.size());
+         ++trial) {
+      tir::Schedule copy = original->Copy();
+      copy->Seed(ForkSeed(&this->rand_state_));
+      ffi::Array<tir::Schedule> resampled = sch_rule->Apply(copy, /*block=*/block_rv);
+      // The rule is expected to produce the same candidates, only with other decisions
+      if (resampled.size() != results.size()) {
+        break;
+      }
+      for (size_t i = 0; i < results.size(); ++i) {
+        if (!within[i] && CheckGPUResources(resampled[i]->mod(), limits_).empty()) {
+          results[i] = resampled[i];
+          within[i] = true;
+          ++num_within;
+        }
+      }
+    }
+    if (num_within == 0) {
+      // Leave the verdict to the postprocessors
+      return applied;
+    }
+    ffi::Array<tir::Schedule> pruned;
+    for (size_t i = 0; i < results.size(); ++i) {
+      if (within[i]) {
+        pruned.push_back(results[i]);
+      }
+    }
+    return pruned;
   }
 
   ffi::Array<tir::Schedule> GenerateDesignSpace(const IRModule& mod) final {
@@ -86,7 +151,7 @@ class PostOrderApplyNode : public SpaceGeneratorNode {
             continue;
           }
         }
-        ffi::Array<tir::Schedule> applied = sch_rule->Apply(sch, /*block=*/block_rv);
+        ffi::Array<tir::Schedule> applied = ApplyRule(sch_rule, sch, block_rv);
         for (const tir::Schedule& sch : applied) {
           stack.emplace_back(sch, blocks);
         }
@@ -107,12 +172,14 @@ class PostOrderApplyNode : public SpaceGeneratorNode {
 SpaceGenerator SpaceGenerator::PostOrderApply(
     ffi::Function f_block_filter, ffi::Optional<ffi::Array<ScheduleRule>> sch_rules,
     ffi::Optional<ffi::Array<Postproc>> postprocs,
-    ffi::Optional<ffi::Map<Mutator, FloatImm>> mutator_probs) {
+    ffi::Optional<ffi::Map<Mutator, FloatImm>> mutator_probs, int max_resamples) {
+  CHECK_GE(max_resamples, 0) << "ValueError: `max_resamples` must be non-negative";
   ObjectPtr<PostOrderApplyNode> n = ffi::make_object<PostOrderApplyNode>();
   n->sch_rules = std::move(sch_rules);
   n->postprocs = std::move(postprocs);
   n->mutator_probs = std::move(mutator_probs);
   n->f_block_filter_ = std::move(f_block_filter);
+  n->max_resamples = max_resamples;
   return SpaceGenerator(n);
 }
 
@@ -28,10 +28,15 @@ ffi::String GetRuleKindFromTarget(const Target& target) {
   if (target->kind->name == "llvm") {
     static auto target_has_feature_fn_ptr =
         tvm::ffi::Function::GetGlobalRequired("target.target_has_feature");
+    if (target_has_feature_fn_ptr("amx-int8", target).cast<bool>()) {
+      return "amx";
+    }
     bool have_avx512vnni = target_has_feature_fn_ptr("avx512vnni", target).cast<bool>();
     bool have_avxvnni = target_has_feature_fn_ptr("avxvnni", target).cast<bool>();
-    if (have_avx512vnni || have_avxvnni) {
+    if (have_avx512vnni) {
       return "vnni";
+    } else if (have_avxvnni) {
+      return "avxvnni";
     } else {
       bool have_avx512f = target_has_feature_fn_ptr("avx512f", target).cast<bool>();
       bool have_avx512bw = target_has_feature_fn_ptr("avx512bw", target).cast<bool>();
@@ -47,6 +52,9 @@ ffi::String GetRuleKindFromTarget(const Target& target) {
     TargetJSON target_json = target::parsers::aprofile::ParseTarget(target->Export());
     TargetFeatures afeatures = Downcast<TargetFeatures>(target_json.at("features"));
 
+    if (Downcast<Bool>(afeatures.at("has_matmul_i8"))) {
+      return "i8mm";
+    }
     if (Downcast<Bool>(afeatures.at("has_dotprod"))) {
       return "dotprod";
     }
@@ -76,6 +84,10 @@ ffi::String GetRuleKindFromTarget(const Target& target) {
     return "cuda";
   }
 
+  if (target->kind->name == "opencl" &&
+      target->GetAttr<ffi::String>("device").value_or("") == "adreno") {
+    return "adreno";
+  }
   if (IsGPUTarget(target->kind->name)) {
     return "cuda";
   }
@@ -113,10 +125,22 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultHexagon();
       default_postprocs = Postproc::DefaultHexagon();
       default_mutator_probs = Mutator::DefaultHexagon();
+    } else if (kind == "adreno") {
+      default_sch_rules = ScheduleRule::DefaultAdreno();
+      default_postprocs = Postproc::DefaultAdreno();
+      default_mutator_probs = Mutator::DefaultCUDA();
+    } else if (kind == "amx") {
+      default_sch_rules = ScheduleRule::DefaultX86("amx");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else if (kind == "vnni") {
       default_sch_rules = ScheduleRule::DefaultX86("vnni");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "avxvnni") {
+      default_sch_rules = ScheduleRule::DefaultX86("avxvnni");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else if (kind == "avx512") {
       default_sch_rules = ScheduleRule::DefaultX86("avx512");
       default_postprocs = Postproc::DefaultCPUTensorization();
@@ -136,6 +160,10 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultARM("dotprod");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "i8mm") {
+      default_sch_rules = ScheduleRule::DefaultARM("i8mm");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else {
       LOG(FATAL) << "Unsupported kind: " << kind;
       throw;
@@ -134,9 +134,12 @@ class GradientBasedNode final : public TaskSchedulerNode {
 };
 
 TaskScheduler TaskScheduler::GradientBased(ffi::Function logger, double alpha, int window_size,
-                                           support::LinearCongruentialEngine::TRandState seed) {
+                                           support::LinearCongruentialEngine::TRandState seed,
+                                           int num_inflight_batches) {
+  CHECK_GE(num_inflight_batches, 0) << "ValueError: `num_inflight_batches` must be non-negative";
   ObjectPtr<GradientBasedNode> n = ffi::make_object<GradientBasedNode>();
   n->logger = logger;
+  n->num_inflight_batches = num_inflight_batches;
   n->alpha = alpha;
   n->window_size = window_size;
   n->rand_state = support::LinearCongruentialEngine::NormalizeSeed(seed);
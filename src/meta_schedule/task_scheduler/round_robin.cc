@@ -55,9 +55,11 @@ class RoundRobinNode final : public TaskSchedulerNode {
   }
 };
 
-TaskScheduler TaskScheduler::RoundRobin(ffi::Function logger) {
+TaskScheduler TaskScheduler::RoundRobin(ffi::Function logger, int num_inflight_batches) {
+  CHECK_GE(num_inflight_batches, 0) << "ValueError: `num_inflight_batches` must be non-negative";
   ObjectPtr<RoundRobinNode> n = ffi::make_object<RoundRobinNode>();
   n->logger = logger;
+  n->num_inflight_batches = num_inflight_batches;
   n->task_id = -1;
   return TaskScheduler(n);
 }
@@ -18,6 +18,14 @@
  */
 #include <tvm/ffi/reflection/registry.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "../utils.h"
 
 namespace tvm {
@@ -46,23 +54,21 @@ TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   this->data_ = std::move(n);
 }
 
-void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
+ffi::Array<BuilderResult> SendToBuilder(const ffi::Array<MeasureCandidate>& candidates,
+                                       const Target& target, const Builder& builder) {
   auto _ = Profiler::TimedScope("SendToBuilder");
-  ffi::Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  Target target = self->ctx->target.value();
   ffi::Array<BuilderInput> inputs;
   inputs.reserve(candidates.size());
   for (const MeasureCandidate& candidate : candidates) {
     inputs.push_back(BuilderInput(candidate->sch->mod(), target));
   }
-  self->builder_results = builder->Build(inputs);
+  return builder->Build(inputs);
 }
 
-void SendToRunner(TaskRecordNode* self, const Runner& runner) {
+ffi::Array<RunnerFuture> SendToRunner(const ffi::Array<MeasureCandidate>& candidates,
+                                      const ffi::Array<BuilderResult>& builder_results,
+                                      const Target& target, const Runner& runner) {
   auto _ = Profiler::TimedScope("SendToRunner");
-  ffi::Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  ffi::Array<BuilderResult> builder_results = self->builder_results.value();
-  Target target = self->ctx->target.value();
   ICHECK_EQ(candidates.size(), builder_results.size());
   int n = candidates.size();
   int n_build_errors = 0;
@@ -81,8 +87,7 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
   }
   ffi::Array<RunnerFuture> futures = runner->Run(inputs);
   if (n_build_errors == 0) {
-    self->runner_futures = futures;
-    return;
+    return futures;
   }
   ffi::Array<RunnerFuture> results;
   results.reserve(n);
@@ -99,7 +104,105 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
       results.push_back(futures[j++]);
     }
   }
-  self->runner_futures = results;
+  return results;
+}
+
+/*!
+ * \brief A background thread that sends the batches of candidates to the builder and then to the
+ * runner, in the order they are submitted.
+ */
+class SubmissionPipeline {
+ public:
+  SubmissionPipeline() : thread_([this]() { this->Loop(); }) {}
+
+  ~SubmissionPipeline() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  std::shared_future<void> Submit(std::function<void()> job) {
+    std::packaged_task<void()> task(std::move(job));
+    std::shared_future<void> future = task.get_future().share();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return future;
+  }
+
+ private:
+  void Loop() {
+    for (;;) {
+      std::packaged_task<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::packaged_task<void()>> queue_;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+
+/*!
+ * \brief Send the candidates of a task to the builder and the runner in the background. The
+ * runner futures of the task are available right away, and become done once the candidates are
+ * submitted and their measurement finishes.
+ */
+void SubmitInBackground(TaskRecordNode* self, const Builder& builder, const Runner& runner,
+                        SubmissionPipeline* pipeline) {
+  struct State {
+    ffi::Array<BuilderResult> builder_results;
+    ffi::Array<RunnerFuture> runner_futures;
+    std::shared_future<void> submitted;
+  };
+  auto state = std::make_shared<State>();
+  ffi::Array<MeasureCandidate> candidates = self->measure_candidates.value();
+  Target target = self->ctx->target.value();
+  state->submitted = pipeline->Submit([state, candidates, target, builder, runner]() {
+    state->builder_results = SendToBuilder(candidates, target, builder);
+    state->runner_futures = SendToRunner(candidates, state->builder_results, target, runner);
+  });
+  int n = candidates.size();
+  ffi::Array<RunnerFuture> futures;
+  futures.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    futures.push_back(RunnerFuture(
+        /*f_done=*/
+        [state, i]() -> bool {
+          if (state->submitted.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+          }
+          // A failed submission is done, and rethrows its error when the result is fetched.
+          return i >= static_cast<int>(state->runner_futures.size()) ||
+                 state->runner_futures[i]->Done();
+        },
+        /*f_result=*/
+        [state, i]() -> RunnerResult {
+          state->submitted.get();
+          return state->runner_futures[i]->Result();
+        }));
+  }
+  self->runner_futures = futures;
+  self->f_finish_submission = [self, state]() {
+    state->submitted.get();
+    self->builder_results = state->builder_results;
+  };
 }
 
 void TaskCleanUp(TaskRecordNode* self, int task_id, const ffi::Array<RunnerResult>& results) {
@@ -146,6 +249,7 @@ void TaskCleanUp(TaskRecordNode* self, int task_id, const ffi::Array<RunnerResul
   self->measure_candidates = std::nullopt;
   self->builder_results = std::nullopt;
   self->runner_futures = std::nullopt;
+  self->launch_index = -1;
 }
 
 void TaskSchedulerNode::Tune(ffi::Array<TuneContext> ctxs, ffi::Array<FloatImm> task_weights,
@@ -184,6 +288,11 @@ void TaskSchedulerNode::Tune(ffi::Array<TuneContext> ctxs, ffi::Array<FloatImm>
                                             database, cost_model);
   }
 
+  std::unique_ptr<SubmissionPipeline> pipeline = nullptr;
+  if (this->num_inflight_batches > 0) {
+    pipeline = std::make_unique<SubmissionPipeline>();
+  }
+  int64_t num_launched = 0;
   int num_trials_already = 0;
   for (int task_id; num_trials_already < max_trials_global && (task_id = NextTaskId()) != -1;) {
     TVM_PY_LOG(INFO, this->logger)
@@ -199,10 +308,23 @@ void TaskSchedulerNode::Tune(ffi::Array<TuneContext> ctxs, ffi::Array<FloatImm>
             task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
       int num_candidates = candidates.value().size();
       num_trials_already += num_candidates;
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
-      SendToBuilder(task, builder);
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
-      SendToRunner(task, runner);
+      task->launch_index = num_launched++;
+      if (pipeline != nullptr) {
+        // Apply backpressure by joining the oldest batches until there is room for this one.
+        while (NumInflightBatches() >= this->num_inflight_batches) {
+          JoinRunningTask(OldestInflightTask());
+        }
+        TVM_PY_LOG(INFO, this->logger)
+            << "Sending " << num_candidates << " sample(s) to builder and runner in background";
+        SubmitInBackground(task, builder, runner, pipeline.get());
+      } else {
+        Target target = task->ctx->target.value();
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
+        task->builder_results = SendToBuilder(candidates.value(), target, builder);
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
+        task->runner_futures =
+            SendToRunner(candidates.value(), task->builder_results.value(), target, runner);
+      }
     } else {
       TerminateTask(task_id);
     }
@@ -219,9 +341,37 @@ void TaskSchedulerNode::Tune(ffi::Array<TuneContext> ctxs, ffi::Array<FloatImm>
   }
 }
 
+int TaskSchedulerNode::NumInflightBatches() const {
+  int count = 0;
+  for (const TaskRecord& task : this->tasks_) {
+    if (task->runner_futures.defined()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+int TaskSchedulerNode::OldestInflightTask() const {
+  int oldest = -1;
+  for (int i = 0, n = this->tasks_.size(); i < n; ++i) {
+    const TaskRecordNode* task = this->tasks_[i].get();
+    if (task->runner_futures.defined() &&
+        (oldest == -1 || task->launch_index < this->tasks_[oldest]->launch_index)) {
+      oldest = i;
+    }
+  }
+  return oldest;
+}
+
 ffi::Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
   TaskRecordNode* task = this->tasks_[task_id].get();
   ICHECK(task->runner_futures.defined());
+  if (task->f_finish_submission != nullptr) {
+    auto _ = Profiler::TimedScope("WaitForSubmission");
+    std::function<void()> f_finish_submission = std::move(task->f_finish_submission);
+    task->f_finish_submission = nullptr;
+    f_finish_submission();
+  }
   ffi::Array<RunnerResult> results;
   {
     auto _ = Profiler::TimedScope("JoinRunnerFutures");
@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/ffi/reflection/registry.h>
+
+#include <cmath>
+#include <limits>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief The task scheduler that treats the tasks as the arms of a bandit. The reward of a round
+ * of a task is the reduction of the end-to-end latency it brings, i.e. the improvement of its best
+ * latency times its weight, relative to the current end-to-end latency. It picks the task with
+ * the highest upper confidence bound of the reward, where the exploration bonus is scaled by the
+ * task's share of the end-to-end latency, and terminates the tasks whose bound falls below the
+ * minimum gain worth tuning for.
+ */
+class UCBNode final : public TaskSchedulerNode {
+ public:
+  /*! \brief The scale of the exploration bonus. */
+  double exploration;
+  /*! \brief The number of recent rounds averaged into the expected reward. */
+  int window_size;
+  /*! \brief The expected reduction of the end-to-end latency below which a task is terminated. */
+  double min_gain;
+  /*! \brief The number of rounds a task is tuned before it can be terminated. */
+  int min_rounds;
+  support::LinearCongruentialEngine::TRandState rand_state;
+
+  int round_robin_rounds_;
+  std::vector<std::vector<double>> best_latency_history_;
+
+  static void RegisterReflection() {
+    namespace refl = tvm::ffi::reflection;
+    refl::ObjectDef<UCBNode>()
+        .def_ro("exploration", &UCBNode::exploration)
+        .def_ro("window_size", &UCBNode::window_size)
+        .def_ro("min_gain", &UCBNode::min_gain)
+        .def_ro("min_rounds", &UCBNode::min_rounds);
+  }
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("meta_schedule.UCB", UCBNode, TaskSchedulerNode);
+
+ public:
+  void Tune(ffi::Array<TuneContext> tasks, ffi::Array<FloatImm> task_weights, int max_trials_global,
+            int max_trials_per_task, int num_trials_per_iter, Builder builder, Runner runner,
+            ffi::Array<MeasureCallback> measure_callbacks, ffi::Optional<Database> database,
+            ffi::Optional<CostModel> cost_model) final {
+    int n_tasks = tasks.size();
+    round_robin_rounds_ = 0;
+    best_latency_history_.assign(n_tasks, std::vector<double>());
+    TaskSchedulerNode::Tune(tasks, task_weights, max_trials_global, max_trials_per_task,
+                            num_trials_per_iter, builder, runner, measure_callbacks, database,
+                            cost_model);
+  }
+
+  int NextTaskId() final {
+    int n_tasks = this->tasks_.size();
+    // Step 1. Tune each task once to get its initial latency.
+    if (round_robin_rounds_ == 0) {
+      TVM_PY_LOG_CLEAR_SCREEN(this->logger);
+      this->PrintTuningStatistics();
+    }
+    if (round_robin_rounds_ < n_tasks) {
+      return round_robin_rounds_++;
+    }
+    if (round_robin_rounds_ == n_tasks) {
+      for (int i = 0; i < n_tasks; ++i) {
+        if (this->tasks_[i]->runner_futures.defined()) {
+          this->JoinRunningTask(i);
+        }
+      }
+      ++round_robin_rounds_;
+    }
+    // Step 2. Collect the tasks that are not terminated yet
+    std::vector<int> tasks_alive;
+    tasks_alive.reserve(n_tasks);
+    for (int i = 0; i < n_tasks; ++i) {
+      this->TouchTask(i);
+      if (!this->tasks_[i]->is_terminated) {
+        tasks_alive.push_back(i);
+      }
+    }
+    if (tasks_alive.empty()) {
+      return -1;
+    }
+    // Step 3. Calculate the end-to-end latency and the total number of rounds
+    double total_latency = 0.0;
+    int total_rounds = 0;
+    for (int i = 0; i < n_tasks; ++i) {
+      const std::vector<double>& history = this->best_latency_history_[i];
+      total_rounds += history.size();
+      if (!history.empty() && history.back() < 1e9) {
+        total_latency += this->tasks_[i]->task_weight * history.back();
+      }
+    }
+    // Step 4. Calculate the upper confidence bound of each task alive, and terminate the tasks
+    // not worth tuning any more
+    std::vector<int> candidates;
+    std::vector<double> scores;
+    for (int task_id : tasks_alive) {
+      double score = this->UpperConfidenceBound(task_id, total_latency, total_rounds);
+      int n_rounds = this->best_latency_history_[task_id].size();
+      if (std::isfinite(score) && n_rounds >= min_rounds && score < min_gain) {
+        if (this->tasks_[task_id]->runner_futures.defined()) {
+          this->JoinRunningTask(task_id);
+        }
+        TVM_PY_LOG(INFO, this->logger)
+            << "Task #" << task_id << " is terminated: its expected gain " << score
+            << " is below " << min_gain;
+        this->TerminateTask(task_id);
+        continue;
+      }
+      candidates.push_back(task_id);
+      scores.push_back(score);
+    }
+    if (candidates.empty()) {
+      return -1;
+    }
+    // Step 5. Select the task with the highest bound
+    auto max_score = std::max_element(scores.begin(), scores.end());
+    auto min_score = std::min_element(scores.begin(), scores.end());
+    int task_id = -1;
+    if (*max_score == *min_score) {
+      task_id = candidates[tir::SampleInt(&this->rand_state, 0, candidates.size())];
+    } else {
+      task_id = candidates[std::distance(scores.begin(), max_score)];
+    }
+    if (this->tasks_[task_id]->runner_futures.defined()) {
+      JoinRunningTask(task_id);
+    }
+    return task_id;
+  }
+
+  ffi::Array<RunnerResult> JoinRunningTask(int task_id) final {
+    ffi::Array<RunnerResult> results = TaskSchedulerNode::JoinRunningTask(task_id);
+    TaskRecordNode* task = this->tasks_[task_id].get();
+    if (task->latency_ms.size() > 0) {
+      this->best_latency_history_.at(task_id).push_back(
+          *std::min_element(task->latency_ms.begin(),  //
+                            task->latency_ms.end()));
+    }
+    return results;
+  }
+
+ private:
+  /*!
+   * \brief The upper confidence bound of the reduction of the end-to-end latency, relative to the
+   * end-to-end latency, that the next round of a task brings.
+   * \return The bound, or negative infinity if the task has no valid latency yet.
+   */
+  double UpperConfidenceBound(int task_id, double total_latency, int total_rounds) const {
+    const std::vector<double>& history = this->best_latency_history_[task_id];
+    int n = history.size();
+    if (n == 0 || history.back() >= 1e9 || total_latency <= 0.0) {
+      return -std::numeric_limits<double>::infinity();
+    }
+    double weight = this->tasks_[task_id]->task_weight;
+    double share = weight * history.back() / total_latency;
+    // Without an observed round, optimistically expect the task's whole share.
+    double mean_gain = share;
+    int begin = std::max(1, n - window_size);
+    if (begin < n) {
+      double sum = 0.0;
+      for (int i = begin; i < n; ++i) {
+        // The first valid latency, after invalid ones, is not a gain over them.
+        if (history[i - 1] < 1e9) {
+          sum += weight * (history[i - 1] - history[i]) / total_latency;
+        }
+      }
+      mean_gain = sum / (n - begin);
+    }
+    double bonus = exploration * share * std::sqrt(2.0 * std::log(std::max(total_rounds, 1)) / n);
+    return mean_gain + bonus;
+  }
+};
+
+TaskScheduler TaskScheduler::UCB(ffi::Function logger, double exploration, int window_size,
+                                 double min_gain, int min_rounds,
+                                 support::LinearCongruentialEngine::TRandState seed,
+                                 int num_inflight_batches) {
+  CHECK_GE(exploration, 0.0) << "ValueError: `exploration` must be non-negative";
+  CHECK_GT(window_size, 0) << "ValueError: `window_size` must be positive";
+  CHECK_GE(num_inflight_batches, 0) << "ValueError: `num_inflight_batches` must be non-negative";
+  ObjectPtr<UCBNode> n = ffi::make_object<UCBNode>();
+  n->logger = logger;
+  n->num_inflight_batches = num_inflight_batches;
+  n->exploration = exploration;
+  n->window_size = window_size;
+  n->min_gain = min_gain;
+  n->min_rounds = min_rounds;
+  n->rand_state = support::LinearCongruentialEngine::NormalizeSeed(seed);
+  return TaskScheduler(n);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() { UCBNode::RegisterReflection(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("meta_schedule.TaskSchedulerUCB", TaskScheduler::UCB);
+}
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -49,12 +49,14 @@
 #include <utility>
 #include <vector>
 
+#include "../runtime/texture.h"
 #include "../support/array.h"
 #include "../support/base64.h"
 #include "../support/nd_int_set.h"
 #include "../support/table_printer.h"
 #include "../support/utils.h"
 #include "../tir/schedule/primitive.h"
+#include "../tir/schedule/traced_schedule.h"
 #include "../tir/schedule/utils.h"
 
 #define TVM_PY_LOG(logging_level, logger)                                \
@@ -319,17 +321,24 @@ struct ThreadedTraceApply {
    * \param mod The IRModule to be applied
    * \param trace The trace to apply to the IRModule
    * \param rand_state The random seed
+   * \param replay_cache The cache to resume the replay from, if any
    * \return The schedule created, or std::nullopt if any postprocessor fails
    */
   ffi::Optional<tir::Schedule> Apply(const IRModule& mod, const tir::Trace& trace,
-                                     TRandState* rand_state) {
-    tir::Schedule sch =
-        tir::Schedule::Traced(mod,
-                              /*rand_state=*/ForkSeed(rand_state),
-                              /*debug_mode=*/0,
-                              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
-
-    trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+                                     TRandState* rand_state,
+                                     tir::TraceReplayCache* replay_cache = nullptr) {
+    tir::Schedule sch{nullptr};
+    if (replay_cache != nullptr) {
+      sch = replay_cache->Replay(mod, trace, /*remove_postproc=*/true,
+                                 /*seed=*/ForkSeed(rand_state),
+                                 /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+    } else {
+      sch = tir::Schedule::Traced(mod,
+                                  /*rand_state=*/ForkSeed(rand_state),
+                                  /*debug_mode=*/0,
+                                  /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+      trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+    }
     sch->EnterPostproc();
 
     for (int i = 0; i < n_; ++i) {
@@ -497,6 +506,15 @@ struct SortTuningRecordByMeanRunSecs {
   }
 };
 
+/*!
+ * \brief Select the records that a compaction keeps among those of a workload: the `top_k` fastest
+ * valid records of distinct traces, the fastest first.
+ * \param records The records of a workload.
+ * \param top_k The number of records to keep.
+ * \return The records kept.
+ */
+std::vector<TuningRecord> SelectCompactedRecords(std::vector<TuningRecord> records, int top_k);
+
 /*!
  * \brief The helper function to clone schedule rules, postprocessors, and mutators.
  * \param src The source space generator.
@@ -531,6 +549,40 @@ inline void CloneRules(const SpaceGeneratorNode* src, SpaceGeneratorNode* dst) {
   }
 }
 
+/*!
+ * \brief Check if a buffer can be stored as a 2d texture of the given scope.
+ * \param shape The shape of the buffer, whose last dimension packs the channels of a texel.
+ * \param dtype The data type of the buffer.
+ * \param scope The texture storage scope, e.g. "global.texture-weight".
+ * \param spatial_limit The largest width and height of a texture on the target.
+ * \param depth_limit The largest depth of a texture array on the target.
+ * \return Whether the buffer is static, has texels of 64 or 128 bits and fits the limits.
+ */
+inline bool FitsTextureLimits(const ffi::Array<PrimExpr>& shape, DataType dtype,
+                              const std::string& scope, int64_t spatial_limit,
+                              int64_t depth_limit) {
+  if (shape.size() < 3 || !dtype.is_float()) {
+    return false;
+  }
+  std::vector<int64_t> extents;
+  for (const PrimExpr& dim : shape) {
+    const auto* int_imm = dim.as<IntImmNode>();
+    if (int_imm == nullptr) {
+      return false;
+    }
+    extents.push_back(int_imm->value);
+  }
+  int64_t channel_bits = extents.back() * dtype.bits() * dtype.lanes();
+  if (channel_bits != 64 && channel_bits != 128) {
+    return false;
+  }
+  size_t axis = runtime::DefaultTextureLayoutSeparator(extents.size(), scope);
+  runtime::Texture2DShape<int64_t> texture =
+      runtime::ApplyTexture2DFlattening<int64_t>(extents, extents.size(), axis);
+  return texture.width <= spatial_limit && texture.height <= spatial_limit &&
+         texture.depth <= depth_limit;
+}
+
 /*! \brief Returns true if the given target is one of the supported gpu targets. */
 inline bool IsGPUTarget(const std::string& target_name) {
   static const std::unordered_set<std::string> gpu_targets{"cuda", "rocm", "vulkan", "metal",
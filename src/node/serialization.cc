@@ -16,7 +16,6 @@
  * specific language governing permissions and limitations
  * under the License.
  */
-
 /*!
  * \file node/serialization.cc
  * \brief Utilities to serialize TVM AST/IR objects.
@@ -24,8 +23,17 @@
 #include <tvm/ffi/extra/json.h>
 #include <tvm/ffi/extra/serialization.h>
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/node/serialization.h>
 #include <tvm/runtime/base.h>
 
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../support/base64.h"
+
 namespace tvm {
 
 std::string SaveJSON(Any n) {
@@ -40,8 +48,316 @@ Any LoadJSON(std::string json_str) {
   return ffi::FromJSONGraph(jgraph);
 }
 
+namespace {
+
+/*!
+ * \brief The binary encoding of the JSON graph of ToJSONGraph.
+ *
+ * The layout is the magic, then the table of the distinct strings, then the root value. Each
+ * value is a tag byte followed by its payload: integers are zigzag varints, strings are varint
+ * indices into the table, and containers are a varint size followed by their elements. The
+ * base64 strings of the graph, which hold the tensor payloads, are kept as their raw bytes.
+ */
+constexpr const char kBinaryMagic[] = "TVMBIN01";
+constexpr size_t kBinaryMagicSize = sizeof(kBinaryMagic) - 1;
+/*! \brief The strings shorter than this are not checked for a base64 payload. */
+constexpr size_t kMinBase64Size = 64;
+
+enum BinaryTag : uint8_t {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt = 3,
+  kFloat = 4,
+  kString = 5,
+  kArray = 6,
+  kObject = 7,
+  kBase64 = 8,
+};
+
+bool IsBase64Char(char c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '+' ||
+         c == '/';
+}
+
+std::string Base64EncodeRaw(const char* data, size_t size) {
+  using support::base64::EncodeTable;
+  std::string result;
+  result.reserve((size + 2) / 3 * 4);
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+  size_t i = 0;
+  for (; i + 3 <= size; i += 3) {
+    uint32_t v = (p[i] << 16) | (p[i + 1] << 8) | p[i + 2];
+    result += EncodeTable[v >> 18];
+    result += EncodeTable[(v >> 12) & 0x3F];
+    result += EncodeTable[(v >> 6) & 0x3F];
+    result += EncodeTable[v & 0x3F];
+  }
+  if (i < size) {
+    uint32_t v = p[i] << 16;
+    if (i + 1 < size) v |= p[i + 1] << 8;
+    result += EncodeTable[v >> 18];
+    result += EncodeTable[(v >> 12) & 0x3F];
+    result += i + 1 < size ? EncodeTable[(v >> 6) & 0x3F] : '=';
+    result += '=';
+  }
+  return result;
+}
+
+/*!
+ * \brief Decode a base64 string, if it is the canonical encoding of its bytes, so that encoding
+ * the bytes again gives back the same string.
+ */
+bool Base64DecodeCanonical(const std::string& str, std::string* bytes) {
+  using support::base64::DecodeTable;
+  size_t size = str.size();
+  if (size % 4 != 0) return false;
+  size_t padding = 0;
+  while (padding < 2 && padding < size && str[size - 1 - padding] == '=') ++padding;
+  for (size_t i = 0; i + padding < size; ++i) {
+    if (!IsBase64Char(str[i])) return false;
+  }
+  bytes->clear();
+  bytes->reserve(size / 4 * 3);
+  for (size_t i = 0; i < size; i += 4) {
+    uint32_t v = 0;
+    int num_chars = 0;
+    for (size_t j = 0; j < 4; ++j) {
+      v <<= 6;
+      if (str[i + j] != '=') {
+        v |= static_cast<uint32_t>(DecodeTable[static_cast<unsigned char>(str[i + j])]);
+        ++num_chars;
+      }
+    }
+    bytes->push_back(static_cast<char>(v >> 16));
+    if (num_chars > 2) bytes->push_back(static_cast<char>((v >> 8) & 0xFF));
+    if (num_chars > 3) bytes->push_back(static_cast<char>(v & 0xFF));
+  }
+  return Base64EncodeRaw(bytes->data(), bytes->size()) == str;
+}
+
+class BinaryGraphWriter {
+ public:
+  std::string Write(const ffi::json::Value& root) {
+    std::string body;
+    WriteValue(root, &body);
+    std::string result(kBinaryMagic, kBinaryMagicSize);
+    WriteVarint(strings_.size(), &result);
+    for (const std::string* str : strings_) {
+      WriteVarint(str->size(), &result);
+      result.append(*str);
+    }
+    result.append(body);
+    return result;
+  }
+
+ private:
+  static void WriteVarint(uint64_t value, std::string* out) {
+    while (value >= 0x80) {
+      out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+  }
+
+  void WriteString(const ffi::String& str, std::string* out) {
+    std::string value(str.data(), str.size());
+    if (value.size() >= kMinBase64Size && Base64DecodeCanonical(value, &scratch_)) {
+      out->push_back(kBase64);
+      WriteVarint(scratch_.size(), out);
+      out->append(scratch_);
+      return;
+    }
+    auto it = string_index_.find(value);
+    if (it == string_index_.end()) {
+      it = string_index_.emplace(std::move(value), strings_.size()).first;
+      strings_.push_back(&it->first);
+    }
+    out->push_back(kString);
+    WriteVarint(it->second, out);
+  }
+
+  void WriteValue(const ffi::json::Value& value, std::string* out) {
+    switch (value.type_index()) {
+      case ffi::TypeIndex::kTVMFFINone: {
+        out->push_back(kNull);
+        return;
+      }
+      case ffi::TypeIndex::kTVMFFIBool: {
+        out->push_back(value.cast<bool>() ? kTrue : kFalse);
+        return;
+      }
+      case ffi::TypeIndex::kTVMFFIInt: {
+        int64_t v = value.cast<int64_t>();
+        out->push_back(kInt);
+        WriteVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63), out);
+        return;
+      }
+      case ffi::TypeIndex::kTVMFFIFloat: {
+        double v = value.cast<double>();
+        char buf[sizeof(double)];
+        std::memcpy(buf, &v, sizeof(double));
+        out->push_back(kFloat);
+        out->append(buf, sizeof(double));
+        return;
+      }
+      case ffi::TypeIndex::kTVMFFISmallStr:
+      case ffi::TypeIndex::kTVMFFIStr: {
+        WriteString(value.cast<ffi::String>(), out);
+        return;
+      }
+      default:
+        break;
+    }
+    if (const auto* arr = value.as<ffi::ArrayObj>()) {
+      out->push_back(kArray);
+      WriteVarint(arr->size(), out);
+      for (const Any& elem : *arr) {
+        WriteValue(elem, out);
+      }
+    } else if (const auto* obj = value.as<ffi::MapObj>()) {
+      out->push_back(kObject);
+      WriteVarint(obj->size(), out);
+      for (const auto& kv : *obj) {
+        WriteValue(kv.first, out);
+        WriteValue(kv.second, out);
+      }
+    } else {
+      LOG(FATAL) << "TypeError: Unexpected value in the JSON graph: " << value.GetTypeKey();
+    }
+  }
+
+  /*! \brief The index of each distinct string, and the strings in the order of their indices. */
+  std::unordered_map<std::string, uint64_t> string_index_;
+  std::vector<const std::string*> strings_;
+  std::string scratch_;
+};
+
+class BinaryGraphReader {
+ public:
+  BinaryGraphReader(const char* data, size_t size) : ptr_(data), end_(data + size) {}
+
+  ffi::json::Value Read() {
+    CHECK(Remaining() >= kBinaryMagicSize && std::memcmp(ptr_, kBinaryMagic, kBinaryMagicSize) == 0)
+        << "ValueError: The data is not in the binary format of node.SaveBinary";
+    ptr_ += kBinaryMagicSize;
+    uint64_t num_strings = ReadVarint();
+    CHECK_LE(num_strings, Remaining()) << "ValueError: The binary graph is truncated";
+    strings_.reserve(num_strings);
+    for (uint64_t i = 0; i < num_strings; ++i) {
+      uint64_t size = ReadVarint();
+      strings_.push_back(ffi::String(ReadBytes(size), size));
+    }
+    ffi::json::Value root = ReadValue();
+    CHECK(ptr_ == end_) << "ValueError: Unexpected trailing data after the binary graph";
+    return root;
+  }
+
+ private:
+  size_t Remaining() const { return end_ - ptr_; }
+
+  const char* ReadBytes(uint64_t size) {
+    CHECK_LE(size, Remaining()) << "ValueError: The binary graph is truncated";
+    const char* result = ptr_;
+    ptr_ += size;
+    return result;
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = static_cast<uint8_t>(*ReadBytes(1));
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    LOG(FATAL) << "ValueError: Invalid varint in the binary graph";
+  }
+
+  ffi::json::Value ReadValue() {
+    uint8_t tag = static_cast<uint8_t>(*ReadBytes(1));
+    switch (tag) {
+      case kNull:
+        return nullptr;
+      case kFalse:
+        return false;
+      case kTrue:
+        return true;
+      case kInt: {
+        uint64_t v = ReadVarint();
+        return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+      }
+      case kFloat: {
+        double v;
+        std::memcpy(&v, ReadBytes(sizeof(double)), sizeof(double));
+        return v;
+      }
+      case kString: {
+        uint64_t index = ReadVarint();
+        CHECK_LT(index, strings_.size()) << "ValueError: Invalid string index in the binary graph";
+        return strings_[index];
+      }
+      case kBase64: {
+        uint64_t size = ReadVarint();
+        const char* bytes = ReadBytes(size);
+        return ffi::String(Base64EncodeRaw(bytes, size));
+      }
+      case kArray: {
+        uint64_t size = ReadVarint();
+        CHECK_LE(size, Remaining()) << "ValueError: The binary graph is truncated";
+        ffi::json::Array arr;
+        arr.reserve(size);
+        for (uint64_t i = 0; i < size; ++i) {
+          arr.push_back(ReadValue());
+        }
+        return arr;
+      }
+      case kObject: {
+        uint64_t size = ReadVarint();
+        CHECK_LE(size, Remaining()) << "ValueError: The binary graph is truncated";
+        ffi::json::Object obj;
+        for (uint64_t i = 0; i < size; ++i) {
+          ffi::json::Value key = ReadValue();
+          obj.Set(key, ReadValue());
+        }
+        return obj;
+      }
+      default:
+        LOG(FATAL) << "ValueError: Unknown tag " << static_cast<int>(tag) << " in the binary graph";
+    }
+  }
+
+  const char* ptr_;
+  const char* end_;
+  std::vector<ffi::String> strings_;
+};
+
+}  // namespace
+
+std::string SaveBinary(Any n) {
+  ffi::json::Object metadata{{"tvm_version", TVM_VERSION}};
+  return BinaryGraphWriter().Write(ffi::ToJSONGraph(n, metadata));
+}
+
+Any LoadBinary(const std::string& data) {
+  return ffi::FromJSONGraph(BinaryGraphReader(data.data(), data.size()).Read());
+}
+
+bool IsBinaryGraph(const std::string& data) {
+  return data.size() >= kBinaryMagicSize &&
+         std::memcmp(data.data(), kBinaryMagic, kBinaryMagicSize) == 0;
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("node.SaveJSON", SaveJSON).def("node.LoadJSON", LoadJSON);
+  refl::GlobalDef()
+      .def("node.SaveJSON", SaveJSON)
+      .def("node.LoadJSON", LoadJSON)
+      .def("node.SaveBinary",
+           [](Any n) {
+             std::string data = SaveBinary(n);
+             return ffi::Bytes(data.data(), data.size());
+           })
+      .def("node.LoadBinary",
+           [](ffi::Bytes data) { return LoadBinary(std::string(data.data(), data.size())); });
 }
 }  // namespace tvm
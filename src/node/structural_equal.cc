@@ -27,6 +27,7 @@
 #include <tvm/node/functor.h>
 #include <tvm/node/node.h>
 #include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 
 #include <optional>
 #include <unordered_map>
@@ -77,11 +78,87 @@ TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
       .def("node.StructuralEqual", NodeStructuralEqualAdapter)
-      .def("node.GetFirstStructuralMismatch", ffi::StructuralEqual::GetFirstMismatch);
+      .def("node.GetFirstStructuralMismatch", ffi::StructuralEqual::GetFirstMismatch)
+      .def("node.StructuralMayEqual", [](const Any& lhs, const Any& rhs, int max_depth) {
+        return StructuralEqual::MayEqual(lhs, rhs, max_depth);
+      });
 }
 
 bool StructuralEqual::operator()(const ffi::Any& lhs, const ffi::Any& rhs,
                                  bool map_free_params) const {
   return ffi::StructuralEqual::Equal(lhs, rhs, map_free_params);
 }
+
+namespace {
+
+/*! \brief Whether a value is cheap to compare in full, i.e. a POD value or a string. */
+bool IsLeafValue(const Any& value) {
+  int32_t type_index = value.type_index();
+  return type_index < ffi::TypeIndex::kTVMFFIStaticObjectBegin ||
+         type_index == ffi::TypeIndex::kTVMFFIStr || type_index == ffi::TypeIndex::kTVMFFIBytes;
+}
+
+/*!
+ * \brief Compare two functions of modules by their cached hash values.
+ *
+ *  The hash values skip the tensor contents and map the free variables, such as the
+ *  GlobalVars, in the order of their occurrences. Both only merge more functions into the
+ *  same hash value, so the functions that would compare equal within their modules, under
+ *  any of the flags, still have the same one.
+ *
+ *  The functions are looked up in the modules as they are now, and a function itself is only
+ *  updated through CopyOnWrite, which the reference held by the cache turns into a copy. The
+ *  cached values therefore always belong to the functions being compared.
+ */
+bool FunctionHashMayEqual(const BaseFunc& lhs, const BaseFunc& rhs) {
+  if (StructuralHashCache::GetCapacity() == 0) {
+    // Without the cache, hashing is a full traversal of its own.
+    return true;
+  }
+  return StructuralHashCache::Hash(lhs, /*map_free_vars=*/true, /*skip_tensor_content=*/true) ==
+         StructuralHashCache::Hash(rhs, /*map_free_vars=*/true, /*skip_tensor_content=*/true);
+}
+
+bool MayEqualImpl(const Any& lhs, const Any& rhs, int depth) {
+  if (IsLeafValue(lhs) || IsLeafValue(rhs)) {
+    return ffi::StructuralEqual::Equal(lhs, rhs);
+  }
+  if (lhs.type_index() != rhs.type_index()) return false;
+  const Object* lhs_obj = lhs.cast<const Object*>();
+  const Object* rhs_obj = rhs.cast<const Object*>();
+  if (lhs_obj == rhs_obj || depth <= 0) return true;
+  if (const auto* lhs_array = lhs_obj->as<ffi::ArrayObj>()) {
+    const auto* rhs_array = static_cast<const ffi::ArrayObj*>(rhs_obj);
+    if (lhs_array->size() != rhs_array->size()) return false;
+    for (size_t i = 0; i < lhs_array->size(); ++i) {
+      if (!MayEqualImpl((*lhs_array)[i], (*rhs_array)[i], depth - 1)) return false;
+    }
+  } else if (const auto* lhs_map = lhs_obj->as<ffi::MapObj>()) {
+    // The keys may be variables, which are only matched in the full comparison.
+    return lhs_map->size() == static_cast<const ffi::MapObj*>(rhs_obj)->size();
+  } else if (const auto* lhs_mod = lhs_obj->as<IRModuleNode>()) {
+    const auto* rhs_mod = static_cast<const IRModuleNode*>(rhs_obj);
+    if (lhs_mod->functions.size() != rhs_mod->functions.size()) return false;
+    // The GlobalVars of the modules are matched by name.
+    for (const auto& [gvar, lhs_func] : lhs_mod->functions) {
+      if (!rhs_mod->ContainGlobalVar(gvar->name_hint)) return false;
+      BaseFunc rhs_func = rhs_mod->Lookup(gvar->name_hint);
+      if (lhs_func->type_index() != rhs_func->type_index()) return false;
+      if (depth > 1 && !FunctionHashMayEqual(lhs_func, rhs_func)) return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool StructuralEqual::MayEqual(const ffi::Any& lhs, const ffi::Any& rhs, int max_depth) {
+  return MayEqualImpl(lhs, rhs, max_depth);
+}
+
+bool StructuralEqual::EqualWithPrecheck(const ffi::Any& lhs, const ffi::Any& rhs,
+                                        bool map_free_vars, bool skip_tensor_content) {
+  return MayEqual(lhs, rhs) &&
+         ffi::StructuralEqual::Equal(lhs, rhs, map_free_vars, skip_tensor_content);
+}
 }  // namespace tvm
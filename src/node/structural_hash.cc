@@ -26,6 +26,7 @@
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/access_path.h>
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/ir/module.h>
 #include <tvm/node/functor.h>
 #include <tvm/node/node.h>
 #include <tvm/node/structural_hash.h>
@@ -33,7 +34,10 @@
 #include <tvm/target/codegen.h>
 
 #include <algorithm>
+#include <list>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "../support/base64.h"
 #include "../support/str_escape.h"
@@ -84,6 +88,178 @@ uint64_t StructuralHash::operator()(const ffi::Any& object) const {
   return ffi::StructuralHash::Hash(object, false);
 }
 
+namespace {
+
+/*! \brief The LRU table behind StructuralHashCache. */
+class StructuralHashCacheTable {
+ public:
+  static StructuralHashCacheTable* Global() {
+    static StructuralHashCacheTable* inst = new StructuralHashCacheTable();
+    return inst;
+  }
+
+  uint64_t Hash(const ObjectRef& object, bool map_free_vars, bool skip_tensor_content) {
+    Key key{object.get(), map_free_vars, skip_tensor_content};
+    std::vector<ObjectRef> contents = SnapshotContents(object);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (capacity_ > 0) {
+        auto it = index_.find(key);
+        if (it != index_.end() && SameContents(it->second->contents, contents)) {
+          ++stats_.hits;
+          entries_.splice(entries_.begin(), entries_, it->second);
+          return it->second->hash;
+        }
+        if (it != index_.end()) {
+          // The object was mutated in place since it was hashed.
+          entries_.erase(it->second);
+          index_.erase(it);
+        }
+        ++stats_.misses;
+      }
+    }
+    // Hash out of the lock, so that other threads are not blocked on a large module.
+    uint64_t hash = ffi::StructuralHash::Hash(object, map_free_vars, skip_tensor_content);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ > 0 && !index_.count(key)) {
+      entries_.push_front(Entry{object, key, hash, std::move(contents)});
+      index_[key] = entries_.begin();
+      EvictToCapacity();
+    }
+    return hash;
+  }
+
+  void SetCapacity(int64_t capacity) {
+    CHECK_GE(capacity, 0) << "ValueError: The capacity of the structural hash cache must be "
+                             "non-negative, but got "
+                          << capacity;
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    EvictToCapacity();
+  }
+
+  int64_t GetCapacity() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  StructuralHashCache::Stats GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    entries_.clear();
+    stats_ = StructuralHashCache::Stats();
+  }
+
+ private:
+  struct Key {
+    const Object* object;
+    bool map_free_vars;
+    bool skip_tensor_content;
+
+    bool operator==(const Key& other) const {
+      return object == other.object && map_free_vars == other.map_free_vars &&
+             skip_tensor_content == other.skip_tensor_content;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return support::HashCombine(std::hash<const Object*>()(key.object),
+                                  (key.map_free_vars << 1) | key.skip_tensor_content);
+    }
+  };
+
+  struct Entry {
+    /*! \brief Keeps the object alive and shared, so that its address stays a valid key */
+    ObjectRef object;
+    Key key;
+    uint64_t hash;
+    /*! \brief The fields of the object that may be replaced in place, as they were hashed */
+    std::vector<ObjectRef> contents;
+  };
+
+  /*!
+   * \brief Get the fields of an object that its methods replace in place, rather than through
+   *  CopyOnWrite, e.g. the functions of a module on IRModuleNode::Add or Remove.
+   *
+   *  Holding these fields keeps them shared, so that the containers are copied on an update and
+   *  a mutated object is told apart from the one that was hashed.
+   */
+  static std::vector<ObjectRef> SnapshotContents(const ObjectRef& object) {
+    if (const auto* mod = object.as<IRModuleNode>()) {
+      return {mod->functions, mod->attrs, mod->global_infos};
+    }
+    return {};
+  }
+
+  static bool SameContents(const std::vector<ObjectRef>& lhs, const std::vector<ObjectRef>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                      [](const ObjectRef& a, const ObjectRef& b) { return a.same_as(b); });
+  }
+
+  void EvictToCapacity() {
+    while (static_cast<int64_t>(entries_.size()) > capacity_) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+  }
+
+  std::mutex mutex_;
+  int64_t capacity_{0};
+  /*! \brief The entries, from the most to the least recently used */
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+  StructuralHashCache::Stats stats_;
+};
+
+}  // namespace
+
+uint64_t StructuralHashCache::Hash(const ffi::Any& object, bool map_free_vars,
+                                   bool skip_tensor_content) {
+  // POD values are cheap to hash, and have no identity to key the cache on.
+  if (object.type_index() < ffi::TypeIndex::kTVMFFIStaticObjectBegin) {
+    return ffi::StructuralHash::Hash(object, map_free_vars, skip_tensor_content);
+  }
+  return StructuralHashCacheTable::Global()->Hash(object.cast<ObjectRef>(), map_free_vars,
+                                                  skip_tensor_content);
+}
+
+void StructuralHashCache::SetCapacity(int64_t capacity) {
+  StructuralHashCacheTable::Global()->SetCapacity(capacity);
+}
+
+int64_t StructuralHashCache::GetCapacity() {
+  return StructuralHashCacheTable::Global()->GetCapacity();
+}
+
+StructuralHashCache::Stats StructuralHashCache::GetStats() {
+  return StructuralHashCacheTable::Global()->GetStats();
+}
+
+void StructuralHashCache::Clear() { StructuralHashCacheTable::Global()->Clear(); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("node.StructuralHashCacheSetCapacity", StructuralHashCache::SetCapacity)
+      .def("node.StructuralHashCacheGetCapacity", StructuralHashCache::GetCapacity)
+      .def("node.StructuralHashCacheGetStats",
+           []() {
+             StructuralHashCache::Stats stats = StructuralHashCache::GetStats();
+             return ffi::Map<ffi::String, int64_t>(
+                 {{"hits", stats.hits}, {"misses", stats.misses}});
+           })
+      .def("node.StructuralHashCacheClear", StructuralHashCache::Clear)
+      .def("node.CachedStructuralHash", [](const ffi::Any& object, bool map_free_vars) {
+        return static_cast<int64_t>(StructuralHashCache::Hash(object, map_free_vars));
+      });
+}
+
 struct RefToObjectPtr : public ObjectRef {
   static ObjectPtr<Object> Get(const ObjectRef& ref) {
     return ffi::details::ObjectUnsafe::ObjectPtrFromObjectRef<Object>(ref);
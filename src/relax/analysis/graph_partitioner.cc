@@ -170,6 +170,8 @@ void GraphPartitioner::MergeFromTo(Group* child, Group* parent) {
   // update the number of nodes of the parent group
   parent->num_nodes += child->num_nodes;
   parent->args_num += child->args_num;
+  parent->flops += child->flops;
+  parent->bytes += child->bytes;
   child->parent = parent;
   // update anchor ref and pattern
   if (child->anchor_ref != nullptr) {
@@ -192,6 +194,11 @@ void GraphPartitioner::CommitFuse_(IndexedForwardGraph::Node* src, IndexedForwar
   ICHECK(gnode != nullptr);
   // merge the current group to the parent if possible.
   MergeFromTo(gnode, target);
+  if (policy_.faccept != nullptr && !output_fused_[src->index]) {
+    // The output of src is consumed inside the group from now on.
+    output_fused_[src->index] = true;
+    target->FindRoot()->bytes -= 2 * node_costs_[src->index].output_bytes;
+  }
   for (auto link = src->outputs.head; link != nullptr; link = link->next) {
     CommitFuse_(link->value.node, sink, target);
   }
@@ -285,6 +292,47 @@ size_t GraphPartitioner::CountFusedArgs(const IndexedForwardGraph& graph,
   return args_num;
 }
 
+void GraphPartitioner::EstimateFusion_(IndexedForwardGraph::Node* src,
+                                       IndexedForwardGraph::Node* sink,
+                                       std::unordered_set<Group*>* merged_groups,
+                                       double* saved_bytes) {
+  if (src == sink || visited_.count(src)) return;
+  visited_.insert(src);
+  merged_groups->insert(groups_[src->index]->FindRoot());
+  if (!output_fused_[src->index]) {
+    *saved_bytes += 2 * node_costs_[src->index].output_bytes;
+  }
+  for (auto link = src->outputs.head; link != nullptr; link = link->next) {
+    EstimateFusion_(link->value.node, sink, merged_groups, saved_bytes);
+  }
+}
+
+FusionCandidate GraphPartitioner::EstimateFusion(IndexedForwardGraph::Node* src,
+                                                 IndexedForwardGraph::Node* sink) {
+  std::unordered_set<Group*> merged_groups{groups_[sink->index]->FindRoot()};
+  double saved_bytes = 0;
+  visited_.clear();
+  EstimateFusion_(src, sink, &merged_groups, &saved_bytes);
+
+  FusionCandidate candidate;
+  candidate.src = src;
+  candidate.sink = sink;
+  candidate.num_groups = merged_groups.size();
+  for (Group* group : merged_groups) {
+    candidate.num_nodes += group->num_nodes;
+    candidate.flops += group->flops;
+    candidate.unfused_bytes += group->bytes;
+  }
+  candidate.fused_bytes = candidate.unfused_bytes - saved_bytes;
+  return candidate;
+}
+
+bool GraphPartitioner::AcceptFusion(IndexedForwardGraph::Node* src,
+                                    IndexedForwardGraph::Node* sink) {
+  if (policy_.faccept == nullptr) return true;
+  return policy_.faccept(EstimateFusion(src, sink));
+}
+
 void GraphPartitioner::InitGroups(const IndexedForwardGraph& graph) {
   auto args_counter = [](const tvm::Object* obj) {
     size_t args_num = 0;
@@ -319,6 +367,17 @@ void GraphPartitioner::InitGroups(const IndexedForwardGraph& graph) {
     group_node->args_num = args_counter(graph_node->ref);
     groups_[nid] = group_node;
   }
+  if (policy_.faccept != nullptr) {
+    node_costs_.resize(groups_.size());
+    output_fused_.assign(groups_.size(), false);
+    for (size_t nid = 0; nid < groups_.size(); ++nid) {
+      if (policy_.festimate != nullptr) {
+        node_costs_[nid] = policy_.festimate(graph.post_dfs_order[nid]);
+      }
+      groups_[nid]->flops = node_costs_[nid].flops;
+      groups_[nid]->bytes = node_costs_[nid].bytes;
+    }
+  }
 }
 
 void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
@@ -352,8 +411,10 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
     ICHECK(!graph_node->extern_ref);
     size_t dom_parent_gindex = dom_node->parent->gnode->index;
 
-    // refuse the fusion if too many ops are going to be fused together
-    if (CountFusedNodesWithNewChild(graph_node, dom_node->parent->gnode) > max_fuse_depth_)
+    // refuse the fusion if too many ops are going to be fused together, unless a fusion
+    // policy decides it
+    if (policy_.faccept == nullptr &&
+        CountFusedNodesWithNewChild(graph_node, dom_node->parent->gnode) > max_fuse_depth_)
       continue;
     // Refuse the fusion if too many arguments are going to be in the fused function
     if (max_function_args_ > 0) {
@@ -377,7 +438,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
         // dom_root_group can also be tuple, as in inception layers
         // CheckPath is needed to avoid fusing two intermediate tuples
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            AcceptFusion(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -400,7 +462,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
         ICHECK(dom_node->parent->gnode != nullptr);
         // The fuse can be executed if all the intermediate ops are still broadcast.
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kBroadcast; };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            AcceptFusion(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -420,7 +483,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
                     kind == kOutEWiseFusable);
           }
         };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            AcceptFusion(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -430,7 +494,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
       if (phase != 1) continue;
       // Check if all path are injective.
       auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
-      if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+      if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+          AcceptFusion(graph_node, dom_node->parent->gnode)) {
         CommitFuse(graph_node, dom_node->parent->gnode);
       }
     } else {
@@ -28,6 +28,7 @@
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/type.h>
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -158,6 +159,45 @@ class DominatorTree {
   Node* GetNode(support::Arena* arena, IndexedForwardGraph::Node* gnode);
 };
 
+/*! \brief The estimated cost of a node of the graph when it runs as a kernel alone. */
+struct NodeCost {
+  /*! \brief The floating point operations of the node. */
+  double flops{0};
+  /*! \brief The bytes of the tensors the node reads and writes. */
+  double bytes{0};
+  /*! \brief The bytes of the output of the node, which stays on chip once it is fused. */
+  double output_bytes{0};
+};
+
+/*! \brief A fusion that the op pattern rules allow, with the estimated cost of the result. */
+struct FusionCandidate {
+  /*! \brief The node to fuse, along with the nodes on its paths to sink. */
+  const IndexedForwardGraph::Node* src{nullptr};
+  /*! \brief The post-dominator of src, into whose group the nodes are fused. */
+  const IndexedForwardGraph::Node* sink{nullptr};
+  /*! \brief The number of nodes of the fused group. */
+  size_t num_nodes{0};
+  /*! \brief The number of groups that are merged into the fused group. */
+  size_t num_groups{0};
+  /*! \brief The estimated FLOPs of the fused group. */
+  double flops{0};
+  /*! \brief The estimated bytes the merged groups read and write when they are not fused. */
+  double unfused_bytes{0};
+  /*! \brief The estimated bytes the fused group reads and writes. */
+  double fused_bytes{0};
+};
+
+/*!
+ * \brief A policy deciding the fusions that the op pattern rules allow. When it is set, it
+ *  replaces the limit on the number of fused nodes.
+ */
+struct FusionPolicy {
+  /*! \brief Estimate the cost of a node. */
+  std::function<NodeCost(const IndexedForwardGraph::Node* node)> festimate;
+  /*! \brief Whether to commit a fusion candidate. */
+  std::function<bool(const FusionCandidate& candidate)> faccept;
+};
+
 /*!
  * \brief A partition of the graph marked by union find data structure.
  */
@@ -193,6 +233,11 @@ class GraphPartitioner {
      */
     size_t args_num{0};
 
+    /*! \brief The estimated FLOPs of the group, when a fusion policy is set. */
+    double flops{0};
+    /*! \brief The estimated bytes the group reads and writes, when a fusion policy is set. */
+    double bytes{0};
+
     /*! \brief Optional attributes to annotate the grouped function. */
     ffi::Map<ffi::String, Any> attrs;
     /*!
@@ -207,6 +252,12 @@ class GraphPartitioner {
    */
   std::vector<Group*> Partition(const IndexedForwardGraph& graph);
 
+  /*!
+   * \brief Set the policy deciding the fusions.
+   * \param policy The fusion policy.
+   */
+  void SetFusionPolicy(FusionPolicy policy) { policy_ = std::move(policy); }
+
  private:
   /*! \brief The internal arena for temporary space. */
   support::Arena* arena_;
@@ -218,6 +269,12 @@ class GraphPartitioner {
   size_t max_function_args_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
+  /*! \brief The optional fusion policy. */
+  FusionPolicy policy_;
+  /*! \brief The estimated cost of each node, when a fusion policy is set. */
+  std::vector<NodeCost> node_costs_;
+  /*! \brief Whether the output of each node is consumed inside its group only. */
+  std::vector<bool> output_fused_;
   /*! \brief internal field used for deduplication */
   std::unordered_set<IndexedForwardGraph::Node*> visited_;
   /*! \brief The map with nodes which were postponed for fusing. */
@@ -293,6 +350,14 @@ class GraphPartitioner {
   // limit will be exceeded.
   size_t CountFusedArgs(const IndexedForwardGraph& graph, IndexedForwardGraph::Node* child);
 
+  // Internal implementation of EstimateFusion
+  void EstimateFusion_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink,
+                       std::unordered_set<Group*>* merged_groups, double* saved_bytes);
+  // Estimate the fused group if src and the nodes on its paths to sink are fused into sink.
+  FusionCandidate EstimateFusion(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
+  // Whether to commit fusing src into sink, which the op pattern rules allow.
+  bool AcceptFusion(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
+
   // Initialize the groups.
   void InitGroups(const IndexedForwardGraph& graph);
 
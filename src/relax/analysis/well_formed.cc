@@ -86,12 +86,28 @@ class WellFormedChecker : public relax::ExprVisitor,
                           public relax::StructInfoVisitor,
                           public tir::ExprVisitor {
  public:
-  static bool Check(ffi::Variant<IRModule, Function> obj, bool check_struct_info) {
+  static bool Check(ffi::Variant<IRModule, Function> obj, bool check_struct_info,
+                    ffi::Optional<IRModule> prev_mod = std::nullopt) {
     WellFormedChecker well_formed_checker =
         WellFormedChecker(obj.as<IRModule>(), check_struct_info);
 
     if (const auto* mod = obj.as<IRModuleNode>()) {
+      // An unchanged function may still call one that was removed, check them all then.
+      if (prev_mod.has_value()) {
+        for (const auto& it : prev_mod.value()->functions) {
+          if (!mod->functions.count(it.first)) {
+            prev_mod = std::nullopt;
+            break;
+          }
+        }
+      }
       for (const auto& it : mod->functions) {
+        if (prev_mod.has_value()) {
+          auto prev = prev_mod.value()->functions.find(it.first);
+          if (prev != prev_mod.value()->functions.end() && (*prev).second.same_as(it.second)) {
+            continue;
+          }
+        }
         // visit relax.Function
         if (auto* n = it.second.as<FunctionNode>()) {
           Function func = ffi::GetRef<Function>(n);
@@ -650,9 +666,16 @@ bool WellFormed(ffi::Variant<IRModule, Function> obj, bool check_struct_info) {
   return WellFormedChecker::Check(obj, check_struct_info);
 }
 
+bool WellFormedIncremental(const IRModule& mod, const IRModule& prev_mod,
+                           bool check_struct_info) {
+  return WellFormedChecker::Check(mod, check_struct_info, prev_mod);
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("relax.analysis.well_formed", WellFormed);
+  refl::GlobalDef()
+      .def("relax.analysis.well_formed", WellFormed)
+      .def("relax.analysis.well_formed_incremental", WellFormedIncremental);
 }
 
 }  // namespace relax
@@ -29,7 +29,9 @@
 #include <tvm/relax/type.h>
 
 #include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../../../transform/utils.h"
@@ -128,8 +130,11 @@ class CollectFromCompositeFunctionBody : public ExprVisitor {
 class TensorRTJSONSerializer : public JSONSerializer {
  public:
   explicit TensorRTJSONSerializer(ffi::Map<Constant, ffi::String> constant_names,
-                                  ffi::Map<Var, Expr> bindings)
-      : JSONSerializer(constant_names), bindings_(bindings) {}
+                                  ffi::Map<Var, Expr> bindings,
+                                  std::vector<std::string> input_max_shapes)
+      : JSONSerializer(constant_names),
+        bindings_(bindings),
+        input_max_shapes_(std::move(input_max_shapes)) {}
 
   using JSONSerializer::VisitExpr_;
 
@@ -175,7 +180,7 @@ class TensorRTJSONSerializer : public JSONSerializer {
     return AddNode(node, ffi::GetRef<Expr>(call_node));
   }
 
-  static void SaveGlobalAttributes(std::shared_ptr<JSONGraphNode> node) {
+  void SaveGlobalAttributes(std::shared_ptr<JSONGraphNode> node) {
     auto ctx = transform::PassContext::Current();
     auto cfg = ctx->GetConfig<TensorRTCompilerConfig>("relax.ext.tensorrt.options");
     if (!cfg.defined()) {
@@ -202,13 +207,73 @@ class TensorRTJSONSerializer : public JSONSerializer {
     node->SetAttr("max_workspace_size", max_workspace_size_attr);
     node->SetAttr("use_fp16", use_fp16_attr);
     node->SetAttr("use_uint8", use_uint8_attr);
+    if (!input_max_shapes_.empty()) {
+      std::vector<dmlc::any> input_max_shapes_attr;
+      input_max_shapes_attr.emplace_back(input_max_shapes_);
+      node->SetAttr("input_max_shapes", input_max_shapes_attr);
+    }
   }
 
  private:
   /*! \brief The bindings to look up composite functions. */
   ffi::Map<Var, Expr> bindings_;
+  /*!
+   * \brief The max shapes of the input tensors as comma-separated dimensions, or empty if no
+   *  symbolic dimension of the inputs is bounded.
+   */
+  std::vector<std::string> input_max_shapes_;
 };
 
+/*!
+ * \brief Get the max shapes of the input tensors of a function, in the order of the input entries
+ *  of the JSON graph.
+ *
+ * The symbolic dimensions are bounded by the "tir_var_upper_bound" attribute of the function, and
+ * are -1 when unbounded. The runtime builds explicit-batch engines with optimization profiles up
+ * to the max shapes, so that one engine serves all the shapes within the bounds.
+ *
+ * \param func The function to be compiled via TensorRT.
+ * \return The max shapes as comma-separated dimensions, or empty if no dimension is bounded.
+ */
+std::vector<std::string> GetInputMaxShapes(const Function& func) {
+  ffi::Map<ffi::String, IntImm> upper_bounds =
+      func->GetAttr<ffi::Map<ffi::String, IntImm>>("tir_var_upper_bound")
+          .value_or(ffi::Map<ffi::String, IntImm>());
+  std::vector<std::string> max_shapes;
+  bool bounded = false;
+  auto f_add_tensor = [&](const StructInfo& sinfo) {
+    const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+    if (tensor_sinfo == nullptr || !tensor_sinfo->GetShape().defined()) {
+      return;
+    }
+    std::ostringstream os;
+    ffi::Array<PrimExpr> shape = tensor_sinfo->GetShape().value();
+    for (size_t i = 0; i < shape.size(); ++i) {
+      os << (i == 0 ? "" : ",");
+      const auto* var = shape[i].as<tir::VarNode>();
+      if (const int64_t* value = tir::as_const_int(shape[i])) {
+        os << *value;
+      } else if (var != nullptr && upper_bounds.count(var->name_hint)) {
+        os << upper_bounds.at(var->name_hint)->value;
+        bounded = true;
+      } else {
+        os << -1;
+      }
+    }
+    max_shapes.push_back(os.str());
+  };
+  for (const Var& param : func->params) {
+    if (const auto* tuple_sinfo = GetStructInfoAs<TupleStructInfoNode>(param)) {
+      for (const StructInfo& field : tuple_sinfo->fields) {
+        f_add_tensor(field);
+      }
+    } else {
+      f_add_tensor(GetStructInfo(param));
+    }
+  }
+  return bounded ? max_shapes : std::vector<std::string>();
+}
+
 void CollectFromCompositeFunctionBody::VisitExpr_(const ConstantNode* constant_node) {
   for (const auto& entry : serializer_->VisitExpr(ffi::GetRef<Constant>(constant_node))) {
     args_.emplace_back(entry);
@@ -231,7 +296,8 @@ ffi::Array<ffi::Module> TensorRTCompiler(ffi::Array<Function> functions,
   ffi::Array<ffi::Module> compiled_functions;
   for (const auto& func : functions) {
     VLOG(1) << "TensorRT partition:" << std::endl << func;
-    TensorRTJSONSerializer serializer(constant_names, AnalyzeVar2Value(func));
+    TensorRTJSONSerializer serializer(constant_names, AnalyzeVar2Value(func),
+                                      GetInputMaxShapes(func));
     serializer.serialize(func);
     std::string graph_json = serializer.GetJSON();
     VLOG(1) << "TensorRT JSON:" << std::endl << graph_json;
@@ -306,6 +306,10 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     if (!symbol.has_value()) {
       symbol = gvar->name_hint;
       kind = VMFuncInfo::FuncKind::kPackedFunc;
+      // In the "auto" exec mode, the functions compiled to TIR are declared upfront.
+      if (builder_->GetDeclaredKind(symbol.value()) == VMFuncInfo::FuncKind::kVMTIRFunc) {
+        kind = VMFuncInfo::FuncKind::kVMTIRFunc;
+      }
     }
     // declare the function to be safe.
     ICHECK(symbol.has_value());
@@ -34,6 +34,7 @@
 #include <tvm/tir/stmt.h>
 
 #include <cctype>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -59,7 +60,15 @@ class CodeGenVMTIR : public ExprFunctor<ffi::Optional<PrimExpr>(const Expr&)> {
     system_lib_prefix_ = ctx_mod_->GetAttr<ffi::String>(tvm::attr::kSystemLibPrefix);
   }
 
-  static IRModule Run(relax::ExecBuilder builder, IRModule mod) {
+  /*!
+   * \brief Compile the relax functions to TIR.
+   * \param builder The builder of the executable.
+   * \param mod The module.
+   * \param fcompile Selects the functions to compile, all of them when empty. The others stay in
+   *        the returned module.
+   */
+  static IRModule Run(relax::ExecBuilder builder, IRModule mod,
+                      std::function<bool(const Function&)> fcompile = nullptr) {
     // create a new copy
     IRModule res_mod = mod;
     res_mod.CopyOnWrite();
@@ -68,6 +77,7 @@ class CodeGenVMTIR : public ExprFunctor<ffi::Optional<PrimExpr>(const Expr&)> {
     // Remove relax function and turn into TIR func.
     for (auto& p : mod->functions) {
       if (auto* func = p.second.as<FunctionNode>()) {
+        if (fcompile != nullptr && !fcompile(ffi::GetRef<Function>(func))) continue;
         auto tir_func = codegen.Codegen(ffi::GetRef<Function>(func));
         auto gsymbol = tir_func->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol);
         res_mod->Add(GlobalVar(gsymbol.value()), tir_func);
@@ -283,7 +293,13 @@ class CodeGenVMTIR : public ExprFunctor<ffi::Optional<PrimExpr>(const Expr&)> {
   }
 
   ffi::Optional<PrimExpr> VisitExpr_(const ConstantNode* op) final {
-    return ConstListGet(builder_->ConvertConstant(op->data).value());
+    auto arg = builder_->ConvertConstant(op->data);
+    if (auto tsinfo = op->struct_info_.as<TensorStructInfoNode>()) {
+      if (tsinfo->vdevice.defined()) {
+        builder_->SaveMemoryScope(arg, tsinfo->vdevice.value()->memory_scope);
+      }
+    }
+    return ConstListGet(arg.value());
   }
 
   ffi::Optional<PrimExpr> VisitExpr_(const ShapeExprNode* op) final {
@@ -345,8 +361,12 @@ class CodeGenVMTIR : public ExprFunctor<ffi::Optional<PrimExpr>(const Expr&)> {
           *kind = VMFuncInfo::FuncKind::kPackedFunc;
           return efunc->global_symbol;
         } else if (func.as<FunctionNode>()) {
-          *kind = VMFuncInfo::FuncKind::kVMTIRFunc;
-          return gvar->name_hint;
+          ffi::String symbol =
+              func->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol).value_or(gvar->name_hint);
+          // In the "auto" exec mode, the functions left to the bytecode are declared upfront.
+          bool is_bytecode = builder_->GetDeclaredKind(symbol) == VMFuncInfo::FuncKind::kVMFunc;
+          *kind = is_bytecode ? VMFuncInfo::FuncKind::kVMFunc : VMFuncInfo::FuncKind::kVMTIRFunc;
+          return symbol;
         } else if (func.as<tir::PrimFuncNode>()) {
           *kind = VMFuncInfo::FuncKind::kPackedFunc;
           return gvar->name_hint;
@@ -444,9 +464,6 @@ class CodeGenVMTIR : public ExprFunctor<ffi::Optional<PrimExpr>(const Expr&)> {
     ffi::Array<PrimExpr> args;
     // if context is required, pass as first argument.
     args.push_back(ctx_ptr_);
-    auto* func = call_node->args[0].as<ExternFuncNode>();
-    ICHECK(func) << "CallBuiltin comes with extern func";
-
     auto tuple_arg = Downcast<Tuple>(call_node->args[1]);
 
     // Handle args of the call
@@ -454,7 +471,11 @@ class CodeGenVMTIR : public ExprFunctor<ffi::Optional<PrimExpr>(const Expr&)> {
       args.push_back(this->VisitExpr(arg).value());
     }
 
-    this->EmitCallPacked(func->global_symbol, args, dst_reg);
+    VMFuncInfo::FuncKind kind;
+    ffi::Optional<ffi::String> symbol = LookupFunction(call_node->args[0], &kind);
+    CHECK(symbol.has_value() && kind == VMFuncInfo::FuncKind::kPackedFunc)
+        << "ValueError: CallBuiltin expects a packed function, but got " << call_node->args[0];
+    this->EmitCallPacked(symbol.value(), args, dst_reg);
   }
 
   void EmitNormalCall(const Call& call_node, int64_t dst_reg) {
@@ -543,9 +564,57 @@ IRModule VMTIRCodeGen(ExecBuilder exec_builder, IRModule mod) {
   return CodeGenVMTIR::Run(exec_builder, mod);
 }
 
+// Defined in codegen_vm.cc.
+IRModule VMCodeGen(ExecBuilder exec_builder, IRModule mod);
+
+/*!
+ * \brief Check if a function is compiled to TIR in the "auto" exec mode: per its kVMExecMode
+ *  attribute when set, otherwise when its control flow is static.
+ */
+bool IsCompiledInAutoMode(const Function& func) {
+  if (auto mode = func->GetAttr<ffi::String>(attr::kVMExecMode)) {
+    CHECK(mode.value() == "compiled" || mode.value() == "bytecode")
+        << "ValueError: " << attr::kVMExecMode << " must be \"compiled\" or \"bytecode\", but got "
+        << mode.value();
+    return mode.value() == "compiled";
+  }
+  bool has_branch = false;
+  PostOrderVisit(func->body, [&has_branch](const Expr& expr) {
+    if (expr.as<IfNode>()) has_branch = true;
+  });
+  return !has_branch;
+}
+
+/*!
+ * \brief Create the Relax VM executable with a mix of functions compiled to TIR and bytecode
+ *        functions, see IsCompiledInAutoMode.
+ *
+ * \param exec_builder Builder to collect executables.
+ * \param mod Input module.
+ * \return Extra TIR module created.
+ */
+IRModule VMAutoCodeGen(ExecBuilder exec_builder, IRModule mod) {
+  // Declare every function with the kind of its codegen first, under the name the lookups of
+  // both codegens use, so that a call refers to its callee with the right kind whatever the
+  // order the functions are generated in.
+  for (const auto& [gvar, base_func] : mod->functions) {
+    if (auto func = base_func.as<Function>()) {
+      ffi::String symbol =
+          func.value()->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol).value_or(gvar->name_hint);
+      exec_builder->DeclareFunction(symbol, IsCompiledInAutoMode(func.value())
+                                                ? VMFuncInfo::FuncKind::kVMTIRFunc
+                                                : VMFuncInfo::FuncKind::kVMFunc);
+    }
+  }
+  IRModule res_mod = CodeGenVMTIR::Run(exec_builder, mod, IsCompiledInAutoMode);
+  return VMCodeGen(exec_builder, res_mod);
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("relax.VMTIRCodeGen", VMTIRCodeGen);
+  refl::GlobalDef()
+      .def("relax.VMTIRCodeGen", VMTIRCodeGen)
+      .def("relax.VMAutoCodeGen", VMAutoCodeGen);
 }
 
 }  // namespace codegen_vm
@@ -23,7 +23,10 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/relax/exec_builder.h>
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 namespace tvm {
 namespace relax {
@@ -43,6 +46,7 @@ VMExecutable* ExecBuilderNode::exec() const { return exec_.get(); }
 ObjectPtr<VMExecutable> ExecBuilderNode::Get() {
   this->Formalize();
   this->CheckExecutable();
+  this->BuildReleaseTables();
   return exec_;
 }
 
@@ -93,6 +97,13 @@ vm::Instruction::Arg ExecBuilderNode::GetFunction(const std::string& func_name)
   return vm::Instruction::Arg::FuncIdx(it->second);
 }
 
+std::optional<vm::VMFuncInfo::FuncKind> ExecBuilderNode::GetDeclaredKind(
+    const std::string& name) const {
+  auto it = exec_->func_map.find(name);
+  if (it == exec_->func_map.end()) return std::nullopt;
+  return exec_->func_table[it->second].kind;
+}
+
 void ExecBuilderNode::EmitFunction(const std::string& func_name, int64_t num_inputs,
                                    ffi::Optional<ffi::Array<ffi::String>> param_names,
                                    vm::VMFuncInfo::FuncKind kind, int64_t init_register_size) {
@@ -323,6 +334,97 @@ void ExecBuilderNode::Formalize() {
   }
 }
 
+void ExecBuilderNode::BuildReleaseTables() {
+  size_t num_instrs = exec_->instr_offset.size();
+  // uses and defs of each instruction, and the pcs it may continue at.
+  std::vector<std::vector<RegName>> uses(num_instrs), defs(num_instrs);
+  std::vector<std::vector<Index>> succs(num_instrs);
+  std::vector<bool> in_vm_func(num_instrs, false);
+  auto add_use = [&](size_t pc, RegName reg) {
+    if (reg < Instruction::kBeginSpecialReg) uses[pc].push_back(reg);
+  };
+  for (const VMFuncInfo& func : exec_->func_table) {
+    if (func.kind != VMFuncInfo::FuncKind::kVMFunc) continue;
+    for (Index pc = func.start_instr; pc < func.end_instr; ++pc) {
+      in_vm_func[pc] = true;
+      Instruction instr = exec_->GetInstruction(pc);
+      switch (instr.op) {
+        case Opcode::Call: {
+          for (Index i = 0; i < instr.num_args; ++i) {
+            if (instr.args[i].kind() == Instruction::ArgKind::kRegister) {
+              add_use(pc, instr.args[i].value());
+            }
+          }
+          if (instr.dst < Instruction::kBeginSpecialReg) defs[pc].push_back(instr.dst);
+          succs[pc].push_back(pc + 1);
+          break;
+        }
+        case Opcode::Ret: {
+          // The returned register is read by Ret, the rest of the frame is cleared on return.
+          add_use(pc, instr.result);
+          break;
+        }
+        case Opcode::Goto: {
+          succs[pc].push_back(pc + instr.pc_offset);
+          break;
+        }
+        case Opcode::If: {
+          add_use(pc, instr.cond);
+          succs[pc].push_back(pc + 1);
+          succs[pc].push_back(pc + instr.false_offset);
+          break;
+        }
+        default:
+          LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
+          break;
+      }
+      std::sort(uses[pc].begin(), uses[pc].end());
+      uses[pc].erase(std::unique(uses[pc].begin(), uses[pc].end()), uses[pc].end());
+    }
+  }
+
+  // Backward liveness over sorted register sets, until a fixed point is reached. The VM
+  // codegen only jumps forward, so a single pass is enough for it.
+  std::vector<std::vector<RegName>> live_in(num_instrs), live_out(num_instrs);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t pc = num_instrs; pc-- > 0;) {
+      if (!in_vm_func[pc]) continue;
+      std::vector<RegName> out;
+      for (Index succ : succs[pc]) {
+        if (succ < 0 || static_cast<size_t>(succ) >= num_instrs) continue;
+        std::vector<RegName> merged;
+        std::set_union(out.begin(), out.end(), live_in[succ].begin(), live_in[succ].end(),
+                       std::back_inserter(merged));
+        out = std::move(merged);
+      }
+      std::vector<RegName> in;
+      std::set_difference(out.begin(), out.end(), defs[pc].begin(), defs[pc].end(),
+                          std::back_inserter(in));
+      std::vector<RegName> with_uses;
+      std::set_union(in.begin(), in.end(), uses[pc].begin(), uses[pc].end(),
+                     std::back_inserter(with_uses));
+      if (with_uses != live_in[pc]) {
+        live_in[pc] = std::move(with_uses);
+        changed = true;
+      }
+      live_out[pc] = std::move(out);
+    }
+  }
+
+  exec_->release_offset.assign(1, 0);
+  exec_->release_regs.clear();
+  for (size_t pc = 0; pc < num_instrs; ++pc) {
+    std::vector<RegName> touched;
+    std::set_union(uses[pc].begin(), uses[pc].end(), defs[pc].begin(), defs[pc].end(),
+                   std::back_inserter(touched));
+    std::set_difference(touched.begin(), touched.end(), live_out[pc].begin(),
+                        live_out[pc].end(), std::back_inserter(exec_->release_regs));
+    exec_->release_offset.push_back(exec_->release_regs.size());
+  }
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
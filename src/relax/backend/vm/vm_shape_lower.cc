@@ -20,6 +20,7 @@
  * \file src/relax/backend/vm/vm_shape_lower.cc
  * \brief Lower the function boundary type checks and symbolic shape computations.
  */
+#include <tvm/arith/analyzer.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/backend.h>
@@ -28,10 +29,16 @@
 #include <tvm/relax/struct_info_functor.h>
 #include <tvm/runtime/vm/builtin.h>
 #include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 namespace tvm {
 namespace relax {
 
@@ -203,8 +210,8 @@ class VMShapeLowerMutator
       public StructInfoFunctor<void(const StructInfo&, Expr, bool, bool, const ffi::String&,
                                     std::vector<MatchShapeTodoItem>*)> {
  public:
-  static IRModule Lower(IRModule mod, bool emit_err_ctx) {
-    VMShapeLowerMutator mutator(mod, emit_err_ctx);
+  static IRModule Lower(IRModule mod, bool emit_err_ctx, bool fuse_checks) {
+    VMShapeLowerMutator mutator(mod, emit_err_ctx, fuse_checks);
 
     for (auto& kv : mod->functions) {
       if (auto* func = kv.second.as<FunctionNode>()) {
@@ -216,8 +223,8 @@ class VMShapeLowerMutator
   }
 
  private:
-  explicit VMShapeLowerMutator(IRModule mod, bool emit_err_ctx)
-      : ExprMutator(mod), emit_err_ctx_(emit_err_ctx) {}
+  explicit VMShapeLowerMutator(IRModule mod, bool emit_err_ctx, bool fuse_checks)
+      : ExprMutator(mod), emit_err_ctx_(emit_err_ctx), fuse_checks_(fuse_checks) {}
 
   using ExprMutator::VisitExpr_;
 
@@ -250,18 +257,20 @@ class VMShapeLowerMutator
         // and skip weights.
         num_input = static_cast<size_t>(opt_num_input.value()->value);
       }
-      for (size_t i = 0; i < func->params.size(); ++i) {
-        StructInfo sinfo = GetStructInfo(func->params[i]);
-        std::ostringstream err_ctx;
-        err_ctx << "ErrorContext(fn=" << gvar->name_hint << ", loc=param[" << i
-                << "], param=" << func->params[i]->name_hint() << ", annotation=" << sinfo << ") ";
-        this->CheckMatchCast(sinfo, func->params[i], true, i >= num_input, err_ctx.str(),
-                             &match_todos);
+      if (!fuse_checks_ || !this->EmitFusedParamCheck(gvar, func, num_input)) {
+        // The struct info of the parameters is what is checked, it can't prove the checks.
+        in_param_check_ = true;
+        for (size_t i = 0; i < func->params.size(); ++i) {
+          StructInfo sinfo = GetStructInfo(func->params[i]);
+          this->CheckMatchCast(sinfo, func->params[i], true, i >= num_input,
+                               ParamErrContext(gvar, func, i), &match_todos);
+        }
+        // insert heap generation logic.
+        match_todos = this->RunMatch(match_todos, false);
+        this->EmitOutstandingPrimExprCompute();
+        this->RunMatch(match_todos, true);
+        in_param_check_ = false;
       }
-      // insert heap generation logic.
-      match_todos = this->RunMatch(match_todos, false);
-      this->EmitOutstandingPrimExprCompute();
-      this->RunMatch(match_todos, true);
 
       BindingBlock pre_block = builder_->EndBlock();
       blocks.push_back(pre_block);
@@ -327,6 +336,14 @@ class VMShapeLowerMutator
     return emit_err_ctx_ ? StringImm(err_ctx) : StringImm("");
   }
 
+  static std::string ParamErrContext(const GlobalVar& gvar, const Function& func, size_t i) {
+    std::ostringstream err_ctx;
+    err_ctx << "ErrorContext(fn=" << gvar->name_hint << ", loc=param[" << i
+            << "], param=" << func->params[i]->name_hint()
+            << ", annotation=" << GetStructInfo(func->params[i]) << ") ";
+    return err_ctx.str();
+  }
+
   VarBinding AllocShapeHeapBinding(IntImm heap_size) {
     if (heap_size->value > 0) {
       TensorStructInfo heap_sinfo(ShapeDType(), 1);
@@ -514,7 +531,16 @@ class VMShapeLowerMutator
         args.push_back(PrimValue::Int64(item.pattern.size()));
       }
 
-      for (PrimExpr expr : item.pattern) {
+      ffi::Optional<ffi::Array<PrimExpr>> known_values =
+          fuse_checks_ && !in_param_check_ ? GetKnownValues(item.input) : std::nullopt;
+      for (size_t i = 0; i < item.pattern.size(); ++i) {
+        const PrimExpr& expr = item.pattern[i];
+        if (known_values && IsProvenEqual(known_values.value()[i], expr)) {
+          // The struct info of the input already guarantees this value.
+          args.push_back(PrimValue::Int64(static_cast<int>(MatchShapeCode::kNoOp)));
+          args.push_back(PrimValue::Int64(0));
+          continue;
+        }
         auto [code, rvalue] = MakeMatchArgs(expr, require_value_computed);
         all_nop = all_nop && code == MatchShapeCode::kNoOp;
         any_nop = any_nop || code == MatchShapeCode::kNoOp;
@@ -533,6 +559,193 @@ class VMShapeLowerMutator
     return outstanding_todos;
   }
 
+  /*! \brief Get the values that the struct info of a matched input has already checked. */
+  static ffi::Optional<ffi::Array<PrimExpr>> GetKnownValues(const Expr& input) {
+    StructInfo sinfo = GetStructInfo(input);
+    if (auto* prim = sinfo.as<PrimStructInfoNode>()) {
+      if (prim->value.defined()) return ffi::Array<PrimExpr>{prim->value.value()};
+    } else if (auto* shape = sinfo.as<ShapeStructInfoNode>()) {
+      return shape->values;
+    } else if (auto* tensor = sinfo.as<TensorStructInfoNode>()) {
+      if (auto* shape_expr = tensor->shape.as<ShapeExprNode>()) return shape_expr->values;
+    }
+    return std::nullopt;
+  }
+
+  /*!
+   * \brief Whether a known value equals the pattern, whose value is either a constant or
+   *        already computed.
+   */
+  bool IsProvenEqual(const PrimExpr& known, const PrimExpr& pattern) {
+    if (!pattern->IsInstance<IntImmNode>()) {
+      auto it = slot_map_.find(pattern);
+      if (it == slot_map_.end() || !it->second->value_computed) return false;
+    }
+    return known.dtype() == pattern.dtype() && analyzer_.CanProveEqual(known, pattern);
+  }
+
+  /*!
+   * \brief Check the parameters in a single generated PrimFunc.
+   *
+   * The PrimFunc checks the ndim, dtype and shape of the tensor parameters and populates
+   * the heap with their symbolic vars and the expressions computed from them, in place of
+   * the builtin check, match_shape and shape_func calls of each parameter.
+   *
+   * \param gvar The global var of the function.
+   * \param func The function whose parameters are checked.
+   * \param num_input The number of inputs, only the dynamic shapes of the rest are checked.
+   * \return Whether the checks were emitted. They are not when some parameters are not
+   *         tensors, the caller then falls back to the builtin checks.
+   */
+  bool EmitFusedParamCheck(const GlobalVar& gvar, const Function& func, size_t num_input) {
+    std::vector<size_t> params;
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      StructInfo sinfo = GetStructInfo(func->params[i]);
+      if (sinfo->IsInstance<ObjectStructInfoNode>()) continue;
+      auto* tensor = sinfo.as<TensorStructInfoNode>();
+      if (tensor == nullptr) return false;
+      auto* shape_expr = tensor->shape.as<ShapeExprNode>();
+      if (tensor->shape.defined() && shape_expr == nullptr) return false;
+      if (i >= num_input && shape_expr != nullptr &&
+          std::all_of(shape_expr->values.begin(), shape_expr->values.end(),
+                      [](const PrimExpr& e) { return e->IsInstance<IntImmNode>(); })) {
+        // weights with static shapes are not checked.
+        continue;
+      }
+      params.push_back(i);
+    }
+    if (params.empty()) return true;
+
+    const tir::Stmt nop = tir::Evaluate(0);
+    tir::Var heap("heap", DataType::Handle());
+    tir::Buffer heap_buffer = tir::decl_buffer({heap_size_}, ShapeDType(), "H", "global");
+    ffi::Array<tir::Var> prim_params;
+    ffi::Map<tir::Var, tir::Buffer> buffer_map;
+    ffi::Array<Expr> call_args;
+    if (heap_size_->value > 0) {
+      prim_params.push_back(heap);
+      buffer_map.Set(heap, heap_buffer);
+      call_args.push_back(shape_heap_);
+    }
+    // The statements enclosing the heap stores, in order.
+    std::vector<tir::Stmt> nest;
+    // Symbolic var => the value bound to it, and the vars in the order they are bound.
+    std::unordered_map<tir::Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> var_values;
+    std::vector<tir::Var> bound_vars;
+    // The shape values that are checked once all vars are bound.
+    std::vector<std::tuple<PrimExpr, PrimExpr, std::string>> deferred_checks;
+    auto assert_true = [&](PrimExpr cond, const std::string& msg) {
+      nest.push_back(tir::AssertStmt(cond, tir::StringImm(msg), nop));
+    };
+    auto field = [](DataType dtype, const tir::Var& handle, int kind) {
+      return tir::Call(dtype, tir::builtin::tvm_struct_get(),
+                       {handle, IntImm(DataType::Int(32), 0), IntImm(DataType::Int(32), kind)});
+    };
+
+    for (size_t i : params) {
+      const Var& param = func->params[i];
+      auto* tensor = GetStructInfoAs<TensorStructInfoNode>(param);
+      std::string err_ctx = emit_err_ctx_ ? ParamErrContext(gvar, func, i) : "";
+      tir::Var handle(param->name_hint(), DataType::Handle());
+      prim_params.push_back(handle);
+      call_args.push_back(param);
+
+      assert_true(!tir::Call(DataType::Bool(), tir::builtin::isnullptr(), {handle}),
+                  err_ctx + " expect a Tensor");
+      if (!tensor->IsUnknownNdim()) {
+        assert_true(field(DataType::Int(32), handle, tir::builtin::kArrNDim) ==
+                        IntImm(DataType::Int(32), tensor->ndim),
+                    err_ctx + " expect Tensor with ndim " + std::to_string(tensor->ndim));
+      }
+      if (!tensor->IsUnknownDtype()) {
+        std::ostringstream msg;
+        msg << err_ctx << " expect Tensor with dtype " << tensor->dtype;
+        DataType dtype = tensor->dtype;
+        assert_true(field(DataType::UInt(8), handle, tir::builtin::kArrTypeCode) ==
+                            IntImm(DataType::UInt(8), dtype.code()) &&
+                        field(DataType::UInt(8), handle, tir::builtin::kArrTypeBits) ==
+                            IntImm(DataType::UInt(8), dtype.bits()) &&
+                        field(DataType::UInt(16), handle, tir::builtin::kArrTypeLanes) ==
+                            IntImm(DataType::UInt(16), dtype.lanes()),
+                    msg.str());
+      }
+      auto* shape_expr = tensor->shape.as<ShapeExprNode>();
+      if (shape_expr == nullptr) continue;
+
+      std::string shape_name = std::string(param->name_hint()) + ".shape";
+      tir::Buffer shape =
+          tir::decl_buffer({IntImm(DataType::Int(32), tensor->ndim)}, ShapeDType(), shape_name);
+      nest.push_back(
+          tir::LetStmt(shape->data, field(DataType::Handle(), handle, tir::builtin::kArrShape),
+                       nop));
+      nest.push_back(tir::DeclBuffer(shape, nop));
+      for (int k = 0; k < tensor->ndim; ++k) {
+        PrimExpr expr = shape_expr->values[k];
+        PrimExpr value = tir::BufferLoad(shape, {IntImm(DataType::Int(32), k)});
+        std::ostringstream msg;
+        msg << err_ctx << " match_cast error, shape[" << k << "] mismatch to " << expr;
+        if (expr->IsInstance<IntImmNode>()) {
+          assert_true(value == expr, msg.str());
+          continue;
+        }
+        tir::Var loaded(shape_name + "_" + std::to_string(k), ShapeDType());
+        nest.push_back(tir::LetStmt(loaded, value, nop));
+        if (auto var = expr.as<tir::Var>()) {
+          auto it = var_values.find(var.value());
+          if (it == var_values.end()) {
+            var_values[var.value()] = loaded;
+            bound_vars.push_back(var.value());
+          } else {
+            assert_true(loaded == it->second, msg.str());
+          }
+        } else {
+          deferred_checks.emplace_back(expr, loaded, msg.str());
+        }
+      }
+    }
+
+    auto var_map = [&](const tir::Var& var) -> ffi::Optional<PrimExpr> {
+      auto it = var_values.find(var);
+      ICHECK(it != var_values.end())
+          << "PrimExpr " << var << " in function " << gvar << " has not been computed";
+      return it->second;
+    };
+    for (const auto& [expr, loaded, msg] : deferred_checks) {
+      assert_true(loaded == tir::Substitute(expr, var_map), msg);
+    }
+
+    // store the vars and the expressions computed from them to the heap.
+    ffi::Array<tir::Stmt> seq;
+    for (const tir::Var& var : bound_vars) {
+      PrimExprSlot* slot = slot_map_.at(var);
+      slot->value_computed = true;
+      ready_vars_.push_back(slot);
+      seq.push_back(
+          tir::BufferStore(heap_buffer, var_values.at(var), {IntImm(ShapeDType(), slot->index)}));
+    }
+    for (PrimExprSlot* slot : GetReadyPrimExprSlots()) {
+      slot->value_computed = true;
+      seq.push_back(tir::BufferStore(heap_buffer, tir::Substitute(slot->expr, var_map),
+                                     {IntImm(ShapeDType(), slot->index)}));
+    }
+    tir::Stmt body = seq.empty() ? nop : tir::SeqStmt::Flatten(seq);
+    for (auto it = nest.rbegin(); it != nest.rend(); ++it) {
+      if (auto* assert_stmt = it->as<tir::AssertStmtNode>()) {
+        body = tir::AssertStmt(assert_stmt->condition, assert_stmt->message, body);
+      } else if (auto* let = it->as<tir::LetStmtNode>()) {
+        body = tir::LetStmt(let->var, let->value, body);
+      } else {
+        body = tir::DeclBuffer(Downcast<tir::DeclBuffer>(*it)->buffer, body);
+      }
+    }
+
+    tir::PrimFunc check_func(prim_params, body, VoidType(), buffer_map);
+    check_func = WithAttr<tir::PrimFunc>(std::move(check_func), tvm::tir::attr::kIsHostFunc, true);
+    GlobalVar check_func_var = builder_->AddFunction(check_func, "param_check");
+    builder_->Emit(Call(check_func_var, call_args), "_");
+    return true;
+  }
+
   /*!
    * \brief Compute a list of prim expr that now be computed
    *        for given ready vars.
@@ -772,6 +985,15 @@ class VMShapeLowerMutator
   //-------------------------------------------------------
   /*! \brief whether to emit error context, can be turned off for testing purposes. */
   bool emit_err_ctx_{true};
+  /*!
+   * \brief whether to check the tensor parameters in one PrimFunc per function, and skip
+   *        the match_cast checks that the struct info of the inputs already proves.
+   */
+  bool fuse_checks_{false};
+  /*! \brief analyzer to prove the match_cast checks. */
+  arith::Analyzer analyzer_;
+  /*! \brief whether the parameters are being checked. */
+  bool in_param_check_{false};
   /*! \brief heap ptr to store the PrimExpr slots. */
   Var shape_heap_;
   /*! \brief heap size. */
@@ -808,17 +1030,22 @@ class VMShapeLowerMutator
 
 namespace transform {
 
-Pass VMShapeLower(bool emit_err_ctx) {
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMShapeLower.fuse_checks", Bool);
+
+Pass VMShapeLower(bool emit_err_ctx, bool fuse_checks) {
   auto pass_func = [=](IRModule mod, PassContext pc) {
-    return VMShapeLowerMutator::Lower(mod, emit_err_ctx);
+    bool fuse = fuse_checks ||
+                pc->GetConfig<Bool>("relax.VMShapeLower.fuse_checks", Bool(false)).value();
+    return VMShapeLowerMutator::Lower(mod, emit_err_ctx, fuse);
   };
   return CreateModulePass(pass_func, 0, "VMShapeLower", {});
 }
 
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("relax.transform.VMShapeLower",
-                        [](bool emit_err_ctx) { return VMShapeLower(emit_err_ctx); });
+  refl::GlobalDef().def("relax.transform.VMShapeLower", [](bool emit_err_ctx, bool fuse_checks) {
+    return VMShapeLower(emit_err_ctx, fuse_checks);
+  });
 }
 
 }  // namespace transform
@@ -0,0 +1,446 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform/auto_sharding.cc
+ * \brief Pass for choosing the sharding of the functions by a cost model, which annotates the
+ *  parameters and propagates the sharding to DistIR.
+ */
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/distributed/axis_group_graph.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/utils.h>
+#include <tvm/tir/op.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "../../op/distributed/distributed.h"
+#include "../../op/distributed/utils.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+namespace {
+
+/*! \brief Get the struct info of the tensor of an axis, which may be a field of a tuple. */
+const TensorStructInfoNode* GetAxisTensorStructInfo(const Axis& axis) {
+  StructInfo sinfo = GetStructInfo(ffi::GetRef<Expr>(axis.tensor));
+  if (const auto* tuple_sinfo = sinfo.as<TupleStructInfoNode>()) {
+    if (axis.tuple_index >= static_cast<int>(tuple_sinfo->fields.size())) {
+      return nullptr;
+    }
+    return tuple_sinfo->fields[axis.tuple_index].as<TensorStructInfoNode>();
+  }
+  return sinfo.as<TensorStructInfoNode>();
+}
+
+/*! \brief The static shape of a tensor, with -1 for the symbolic dims. */
+std::vector<int64_t> GetStaticShape(const TensorStructInfoNode* sinfo) {
+  std::vector<int64_t> shape;
+  if (const auto* shape_expr = sinfo->shape.as<ShapeExprNode>()) {
+    for (const PrimExpr& dim : shape_expr->values) {
+      const int64_t* dim_len = tir::as_const_int(dim);
+      shape.push_back(dim_len != nullptr ? *dim_len : -1);
+    }
+  }
+  return shape;
+}
+
+/*!
+ * \brief The cost model of the sharding of a function.
+ *
+ * Sharding an axis group along a device mesh axis shards all the tensor axes of the group, i.e.
+ * data parallelism for the group of the batch axes, tensor parallelism for the groups of the
+ * hidden axes of the weights, sequence parallelism for the group of the sequence axes. Each
+ * device mesh axis shards at most one axis group. The cost of a sharding is the estimated time
+ *
+ *   sum of (FLOPs of each op / the number of shards of its iteration space) / device_flops
+ *   + bytes of the collectives / link_bandwidth
+ *
+ * where the iteration space of an op is sharded by the mesh axes sharding any of its tensors,
+ * and an op whose inputs are sharded along a mesh axis while its output is not, e.g. a matmul
+ * sharded on its reduction axis, needs a ring allreduce of its output along the mesh axis. The
+ * memory of a device is estimated by the shards of the parameters plus the peak of the shards of
+ * the activations alive at each binding.
+ */
+class ShardingCostModel : public ExprVisitor {
+ public:
+  ShardingCostModel(const Function& func, const IRModule& mod, const DeviceMesh& device_mesh)
+      : mod_(mod), device_mesh_(device_mesh) {
+    BuildAxisGroupGraph(&axis_group_graph_, func, mod);
+    for (const Var& param : func->params) {
+      AddTensor(param, /*is_param=*/true);
+    }
+    VisitExpr(func->body);
+    if (const auto* seq = func->body.as<SeqExprNode>()) {
+      MarkUses(seq->body, num_bindings_);
+    }
+  }
+
+  /*! \brief Get the candidate axis groups of a mesh axis, which contain an axis of a parameter. */
+  std::vector<int> GetCandidateGroups(int mesh_axis) {
+    int64_t num_shards = device_mesh_->shape[mesh_axis];
+    std::vector<int> candidates;
+    for (int group_id = 0; group_id < static_cast<int>(groups_.size()); ++group_id) {
+      if (group_has_param_[group_id] && IsShardable(groups_[group_id], num_shards)) {
+        candidates.push_back(group_id);
+      }
+    }
+    return candidates;
+  }
+
+  /*!
+   * \brief Estimate the sharding of the function.
+   * \param choice The axis group sharded along each mesh axis, or -1 for none.
+   * \return The estimated time and the bytes per device.
+   */
+  std::pair<double, int64_t> Estimate(const std::vector<int>& choice, double device_flops,
+                                      double link_bandwidth) const {
+    std::vector<int64_t> tensor_shards(tensors_.size());
+    for (int i = 0; i < static_cast<int>(tensors_.size()); ++i) {
+      tensor_shards[i] = GetNumShards({i}, choice);
+    }
+    double compute_flops = 0;
+    double comm_bytes = 0;
+    for (const OpInfo& op : ops_) {
+      std::vector<int> op_tensors = op.inputs;
+      if (op.output >= 0) op_tensors.push_back(op.output);
+      compute_flops += op.flops / GetNumShards(op_tensors, choice);
+      if (op.output < 0 || tensors_[op.output].bytes < 0) continue;
+      for (int mesh_axis = 0; mesh_axis < static_cast<int>(choice.size()); ++mesh_axis) {
+        if (choice[mesh_axis] < 0 || HasGroup(op.output, choice[mesh_axis])) continue;
+        bool sharded_input = std::any_of(op.inputs.begin(), op.inputs.end(), [&](int input) {
+          return HasGroup(input, choice[mesh_axis]);
+        });
+        if (sharded_input) {
+          int64_t num_shards = device_mesh_->shape[mesh_axis];
+          double output_bytes =
+              static_cast<double>(tensors_[op.output].bytes) / tensor_shards[op.output];
+          comm_bytes += 2.0 * (num_shards - 1) / num_shards * output_bytes;
+        }
+      }
+    }
+
+    int64_t param_bytes = 0;
+    std::vector<int64_t> live_bytes(num_bindings_ + 1, 0);
+    for (int i = 0; i < static_cast<int>(tensors_.size()); ++i) {
+      const TensorInfo& tensor = tensors_[i];
+      if (tensor.bytes < 0) continue;
+      int64_t bytes = tensor.bytes / tensor_shards[i];
+      if (tensor.def_index < 0) {
+        param_bytes += bytes;
+        continue;
+      }
+      for (int j = tensor.def_index; j <= std::max(tensor.def_index, tensor.last_use); ++j) {
+        live_bytes[j] += bytes;
+      }
+    }
+    int64_t peak_bytes = *std::max_element(live_bytes.begin(), live_bytes.end());
+    return {compute_flops / device_flops + comm_bytes / link_bandwidth, param_bytes + peak_bytes};
+  }
+
+  /*! \brief Get the placement of a parameter, or nullopt if the parameter is not a tensor. */
+  ffi::Optional<Placement> GetParamPlacement(const Var& param, const std::vector<int>& choice) {
+    auto it = tensor_index_.find(param.get());
+    if (it == tensor_index_.end()) {
+      return std::nullopt;
+    }
+    const TensorInfo& tensor = tensors_[it->second];
+    std::vector<PlacementSpec> specs(choice.size(), PlacementSpec::Replica());
+    for (int mesh_axis = 0; mesh_axis < static_cast<int>(choice.size()); ++mesh_axis) {
+      for (int dim = 0; dim < static_cast<int>(tensor.dim_groups.size()); ++dim) {
+        if (choice[mesh_axis] >= 0 && tensor.dim_groups[dim] == choice[mesh_axis]) {
+          specs[mesh_axis] = PlacementSpec::Sharding(dim);
+        }
+      }
+    }
+    return Placement(ffi::Array<PlacementSpec>(specs));
+  }
+
+ private:
+  struct TensorInfo {
+    /*! \brief The axis group of each dim. */
+    std::vector<int> dim_groups;
+    /*! \brief The bytes of the tensor, or -1 if its shape is symbolic. */
+    int64_t bytes;
+    /*! \brief The index of the binding of the tensor, or -1 for a parameter. */
+    int def_index;
+    /*! \brief The index of the last binding using the tensor. */
+    int last_use;
+  };
+
+  struct OpInfo {
+    std::vector<int> inputs;
+    /*! \brief The output tensor, or -1 if the output is not a tensor. */
+    int output;
+    double flops;
+  };
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    MarkUses(binding->value, num_bindings_);
+    int output = AddTensor(binding->var, /*is_param=*/false);
+    if (const auto* call = binding->value.as<CallNode>()) {
+      OpInfo op{{}, output, EstimateCallFlops(mod_, ffi::GetRef<Call>(call))};
+      for (const Expr& arg : GetCallArgs(ffi::GetRef<Call>(call))) {
+        auto it = tensor_index_.find(arg.get());
+        if (it != tensor_index_.end()) {
+          op.inputs.push_back(it->second);
+        }
+      }
+      ops_.push_back(op);
+    }
+    ++num_bindings_;
+  }
+
+  int AddTensor(const Var& var, bool is_param) {
+    const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(var);
+    if (sinfo == nullptr || sinfo->IsUnknownNdim()) {
+      return -1;
+    }
+    TensorInfo tensor;
+    std::vector<int64_t> shape = GetStaticShape(sinfo);
+    tensor.bytes = sinfo->IsUnknownDtype() || static_cast<int>(shape.size()) != sinfo->ndim
+                       ? -1
+                       : sinfo->dtype.bytes() * sinfo->dtype.lanes();
+    for (int dim = 0; dim < sinfo->ndim; ++dim) {
+      tensor.dim_groups.push_back(GetGroupId({var.get(), dim}));
+      if (tensor.bytes >= 0) {
+        tensor.bytes = shape[dim] >= 0 ? tensor.bytes * shape[dim] : -1;
+      }
+    }
+    tensor.def_index = is_param ? -1 : num_bindings_;
+    tensor.last_use = tensor.def_index;
+    if (is_param) {
+      for (int group_id : tensor.dim_groups) {
+        group_has_param_[group_id] = true;
+      }
+    }
+    int index = static_cast<int>(tensors_.size());
+    tensors_.push_back(tensor);
+    tensor_index_[var.get()] = index;
+    return index;
+  }
+
+  void MarkUses(const Expr& expr, int binding_index) {
+    PostOrderVisit(expr, [&](const Expr& e) {
+      auto it = tensor_index_.find(e.get());
+      if (it != tensor_index_.end()) {
+        tensors_[it->second].last_use = std::max(tensors_[it->second].last_use, binding_index);
+      }
+    });
+  }
+
+  int GetGroupId(const Axis& axis) {
+    auto it = axis_group_id_.find(axis);
+    if (it != axis_group_id_.end()) {
+      return it->second;
+    }
+    int group_id = static_cast<int>(groups_.size());
+    groups_.push_back(axis_group_graph_.GetAxisGroup(axis));
+    group_has_param_.push_back(false);
+    for (const Axis& member : groups_.back()) {
+      axis_group_id_[member] = group_id;
+    }
+    return group_id;
+  }
+
+  /*!
+   * \brief Check if an axis group can be sharded into a number of shards, i.e. it has no constant,
+   * it holds at most one axis of each tensor, and its static axes are divisible by the shards.
+   */
+  bool IsShardable(const AxisGroup& group, int64_t num_shards) const {
+    if (group.size() <= 1) {
+      return false;
+    }
+    std::unordered_map<const ExprNode*, std::vector<int>> tuple_indices;
+    for (const Axis& axis : group) {
+      if (axis.dim < 0 || axis.tensor->IsInstance<ConstantNode>()) {
+        return false;
+      }
+      std::vector<int>& indices = tuple_indices[axis.tensor];
+      if (std::find(indices.begin(), indices.end(), axis.tuple_index) != indices.end()) {
+        return false;
+      }
+      indices.push_back(axis.tuple_index);
+      const TensorStructInfoNode* sinfo = GetAxisTensorStructInfo(axis);
+      if (sinfo == nullptr) {
+        return false;
+      }
+      std::vector<int64_t> shape = GetStaticShape(sinfo);
+      if (axis.dim < static_cast<int>(shape.size()) && shape[axis.dim] >= 0 &&
+          shape[axis.dim] % num_shards != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool HasGroup(int tensor, int group_id) const {
+    const std::vector<int>& dim_groups = tensors_[tensor].dim_groups;
+    return std::find(dim_groups.begin(), dim_groups.end(), group_id) != dim_groups.end();
+  }
+
+  int64_t GetNumShards(const std::vector<int>& tensors, const std::vector<int>& choice) const {
+    int64_t num_shards = 1;
+    for (int mesh_axis = 0; mesh_axis < static_cast<int>(choice.size()); ++mesh_axis) {
+      if (choice[mesh_axis] >= 0 && std::any_of(tensors.begin(), tensors.end(), [&](int tensor) {
+            return HasGroup(tensor, choice[mesh_axis]);
+          })) {
+        num_shards *= device_mesh_->shape[mesh_axis];
+      }
+    }
+    return num_shards;
+  }
+
+  IRModule mod_;
+  DeviceMesh device_mesh_;
+  AxisGroupGraph axis_group_graph_;
+  std::vector<AxisGroup> groups_;
+  std::vector<bool> group_has_param_;
+  std::unordered_map<Axis, int, AxisHash> axis_group_id_;
+  std::vector<TensorInfo> tensors_;
+  std::unordered_map<const Object*, int> tensor_index_;
+  std::vector<OpInfo> ops_;
+  int num_bindings_ = 0;
+};
+
+/*!
+ * \brief Search the axis group sharded along each mesh axis with the lowest estimated time whose
+ * memory fits the limit, or with the lowest memory if none fits.
+ */
+std::vector<int> SearchSharding(ShardingCostModel* cost_model, const DeviceMesh& device_mesh,
+                                int64_t memory_limit, double device_flops,
+                                double link_bandwidth) {
+  int num_mesh_axes = static_cast<int>(device_mesh->shape.size());
+  std::vector<std::vector<int>> candidates;
+  for (int mesh_axis = 0; mesh_axis < num_mesh_axes; ++mesh_axis) {
+    candidates.push_back(cost_model->GetCandidateGroups(mesh_axis));
+    candidates.back().insert(candidates.back().begin(), -1);
+  }
+
+  std::vector<int> choice(num_mesh_axes, -1);
+  std::vector<int> best_choice = choice;
+  double best_time = std::numeric_limits<double>::infinity();
+  int64_t best_bytes = std::numeric_limits<int64_t>::max();
+  bool best_fits = false;
+  std::function<void(int)> f_search = [&](int mesh_axis) {
+    if (mesh_axis == num_mesh_axes) {
+      auto [time, bytes] = cost_model->Estimate(choice, device_flops, link_bandwidth);
+      bool fits = memory_limit <= 0 || bytes <= memory_limit;
+      bool better;
+      if (fits) {
+        better = !best_fits || time < best_time || (time == best_time && bytes < best_bytes);
+      } else {
+        better = !best_fits && bytes < best_bytes;
+      }
+      if (better) {
+        best_choice = choice;
+        best_time = time;
+        best_bytes = bytes;
+        best_fits = fits;
+      }
+      return;
+    }
+    for (int group_id : candidates[mesh_axis]) {
+      if (group_id >= 0 && std::find(choice.begin(), choice.end(), group_id) != choice.end()) {
+        continue;
+      }
+      choice[mesh_axis] = group_id;
+      f_search(mesh_axis + 1);
+      choice[mesh_axis] = -1;
+    }
+  };
+  f_search(0);
+  if (!best_fits) {
+    LOG(WARNING) << "AutoSharding cannot fit the memory limit of " << memory_limit
+                 << " bytes per device, and picks the sharding of the least memory, "
+                 << best_bytes << " bytes";
+  }
+  return best_choice;
+}
+
+/*! \brief Annotate the sharding of each tensor parameter of a function at its beginning. */
+Function AnnotateParams(const Function& func, ShardingCostModel* cost_model,
+                        const DeviceMesh& device_mesh, const std::vector<int>& choice) {
+  ffi::Array<Binding> bindings;
+  ffi::Map<Var, Expr> var_map;
+  for (const Var& param : func->params) {
+    ffi::Optional<Placement> placement = cost_model->GetParamPlacement(param, choice);
+    if (!placement.defined()) {
+      continue;
+    }
+    Call call = Downcast<Call>(annotate_sharding(param, device_mesh, placement.value()));
+    UpdateStructInfo(call, GetStructInfo(param));
+    Var annotated(param->name_hint() + "_sharded", GetStructInfo(param));
+    bindings.push_back(VarBinding(annotated, call));
+    var_map.Set(param, annotated);
+  }
+  SeqExpr body = Downcast<SeqExpr>(Bind(func->body, var_map));
+  ffi::Array<BindingBlock> blocks = {BindingBlock(bindings)};
+  blocks.insert(blocks.end(), body->blocks.begin(), body->blocks.end());
+  Function new_func = func;
+  new_func.CopyOnWrite()->body = SeqExpr(blocks, body->body, body->span);
+  return new_func;
+}
+
+}  // namespace
+
+namespace transform {
+
+Pass AutoSharding(DeviceMesh device_mesh, int64_t memory_limit, double device_flops,
+                  double link_bandwidth) {
+  CHECK_GT(device_flops, 0) << "ValueError: The FLOPS of a device must be positive";
+  CHECK_GT(link_bandwidth, 0) << "ValueError: The bandwidth of the links must be positive";
+  auto pass_func = [=](IRModule mod, PassContext pc) {
+    IRModule annotated_mod = mod;
+    for (const auto& [gv, base_func] : mod->functions) {
+      const auto* func = base_func.as<FunctionNode>();
+      if (func == nullptr || !func->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol).has_value() ||
+          !func->body->IsInstance<SeqExprNode>() || IsDistIRFunc(ffi::GetRef<Function>(func)) ||
+          IsShardingAnnotatedFunc(ffi::GetRef<Function>(func))) {
+        continue;
+      }
+      ShardingCostModel cost_model(ffi::GetRef<Function>(func), mod, device_mesh);
+      std::vector<int> choice =
+          SearchSharding(&cost_model, device_mesh, memory_limit, device_flops, link_bandwidth);
+      annotated_mod.CopyOnWrite()->Update(
+          gv, AnnotateParams(ffi::GetRef<Function>(func), &cost_model, device_mesh, choice));
+    }
+    return PropagateSharding()(annotated_mod);
+  };
+  return CreateModulePass(pass_func, 1, "AutoSharding", {});
+}
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.distributed.transform.AutoSharding", AutoSharding);
+}
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
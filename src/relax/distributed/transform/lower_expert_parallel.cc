@@ -0,0 +1,175 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform/lower_expert_parallel.cc
+ * \brief Pass for lowering the grouped GEMMs of mixture-of-experts layers to expert parallelism.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+
+#include "../../op/ccl/ccl.h"
+#include "../../op/tensor/index.h"
+#include "../../op/tensor/manipulate.h"
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+/*!
+ * \brief Rewrite the grouped GEMMs over the local experts of a worker into expert parallelism.
+ *
+ * The rows of the input of a grouped GEMM are grouped by global expert, with the same capacity
+ * of rows for every expert, and worker r owns the experts [r * E, (r + 1) * E). An all-to-all
+ * sends the rows of each expert to its owner, the local experts run on the rows received from
+ * every worker, and another all-to-all returns the outputs to the workers the rows came from.
+ */
+class ExpertParallelLowerer : public ExprMutator {
+ public:
+  static IRModule Lower(IRModule mod, int num_workers, int num_experts) {
+    return ExpertParallelLowerer(mod, num_workers, num_experts).Lower();
+  }
+
+ private:
+  explicit ExpertParallelLowerer(IRModule mod, int num_workers, int num_experts)
+      : ExprMutator(mod), num_workers_(num_workers), num_experts_(num_experts) {}
+
+  IRModule Lower() {
+    auto mod = builder_->GetContextIRModule();
+    for (const auto& [gv, base_func] : mod->functions) {
+      const auto* func_ = base_func.as<FunctionNode>();
+      if (func_ == nullptr) {
+        continue;
+      }
+      Expr new_func_body = VisitExpr(func_->body);
+      auto new_func = ffi::make_object<FunctionNode>(*func_);
+      new_func->body = new_func_body;
+      builder_->UpdateFunction(gv, Function(new_func));
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  using ExprMutator::VisitExpr_;
+  Expr VisitExpr_(const CallNode* op) final {
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+    if (!call->op.same_as(call_dps_packed_op) || call->sinfo_args.size() != 1) {
+      return call;
+    }
+    const auto* extern_func = call->args[0].as<ExternFuncNode>();
+    const auto* args = call->args[1].as<TupleNode>();
+    // The arguments of the grouped GEMM are the input, the weight, the indptr of the groups
+    // and the workspace.
+    if (extern_func == nullptr || extern_func->global_symbol != "cutlass.group_gemm" ||
+        args == nullptr || args->fields.size() != 4) {
+      return call;
+    }
+    Expr x = args->fields[0];
+    Expr weight = args->fields[1];
+    Expr indptr = args->fields[2];
+    Expr workspace = args->fields[3];
+    const auto* x_sinfo = GetStructInfoAs<TensorStructInfoNode>(x);
+    const auto* weight_sinfo = GetStructInfoAs<TensorStructInfoNode>(weight);
+    const auto* out_sinfo = call->sinfo_args[0].as<TensorStructInfoNode>();
+    if (x_sinfo == nullptr || weight_sinfo == nullptr || out_sinfo == nullptr) {
+      return call;
+    }
+    ffi::Optional<ffi::Array<PrimExpr>> x_shape = x_sinfo->GetShape();
+    ffi::Optional<ffi::Array<PrimExpr>> weight_shape = weight_sinfo->GetShape();
+    ffi::Optional<ffi::Array<PrimExpr>> out_shape = out_sinfo->GetShape();
+    if (!x_shape.defined() || !weight_shape.defined() || !out_shape.defined() ||
+        x_shape.value().size() != 2 || weight_shape.value().size() != 3 ||
+        out_shape.value().size() != 2) {
+      return call;
+    }
+    // Only the GEMMs whose weight holds the local share of the experts are rewritten.
+    const auto* num_local_experts = weight_shape.value()[0].as<IntImmNode>();
+    if (num_local_experts == nullptr ||
+        num_local_experts->value * num_workers_ != static_cast<int64_t>(num_experts_)) {
+      return call;
+    }
+    PrimExpr num_rows = x_shape.value()[0];
+    arith::Analyzer analyzer;
+    if (!analyzer.CanProve(floormod(num_rows, num_experts_) == 0)) {
+      return call;
+    }
+    DataType dtype = num_rows.dtype();
+    PrimExpr capacity = analyzer.Simplify(floordiv(num_rows, num_experts_));
+    PrimExpr num_workers = IntImm(dtype, num_workers_);
+    PrimExpr num_groups = IntImm(dtype, num_local_experts->value);
+    PrimExpr local_rows = analyzer.Simplify(num_groups * num_workers * capacity);
+    PrimExpr k = x_shape.value()[1];
+    PrimExpr n = out_shape.value()[1];
+    ffi::Array<Integer> swap_leading_axes{1, 0, 2, 3};
+
+    // Send the rows of each expert to its owner, and group the received rows by local expert.
+    Expr recv = builder_->Emit(alltoall(x, num_workers_, /*in_group=*/true));
+    Expr grouped = builder_->Emit(reshape(recv, ffi::Array<PrimExpr>{num_workers, num_groups,
+                                                                      capacity, k}));
+    grouped = builder_->Emit(permute_dims(grouped, swap_leading_axes));
+    grouped = builder_->Emit(reshape(grouped, ffi::Array<PrimExpr>{local_rows, k}));
+    // With the same capacity for every expert, the local group i ends where the global group
+    // (i + 1) * num_workers - 1 does.
+    Expr local_indptr = builder_->Emit(strided_slice(
+        indptr, Tuple({PrimValue::Int64(0)}), Tuple({PrimValue::Int64(num_workers_ - 1)}),
+        Tuple({PrimValue::Int64(num_experts_)}), Tuple({PrimValue::Int64(num_workers_)})));
+    TensorStructInfo local_out_sinfo(ShapeExpr({local_rows, n}), out_sinfo->dtype,
+                                     out_sinfo->vdevice);
+    Expr local_out = builder_->Emit(
+        Call(call->op, {call->args[0], Tuple({grouped, weight, local_indptr, workspace})},
+             call->attrs, {local_out_sinfo}));
+    // Return the outputs to the workers the rows came from, in the original order.
+    Expr out = builder_->Emit(reshape(local_out, ffi::Array<PrimExpr>{num_groups, num_workers,
+                                                                       capacity, n}));
+    out = builder_->Emit(permute_dims(out, swap_leading_axes));
+    out = builder_->Emit(reshape(out, ffi::Array<PrimExpr>{num_rows, n}));
+    return alltoall(out, num_workers_, /*in_group=*/true);
+  }
+
+  /*! \brief The number of workers the experts are distributed over. */
+  int num_workers_;
+  /*! \brief The total number of experts. */
+  int num_experts_;
+};
+
+namespace transform {
+
+Pass LowerExpertParallel(int num_workers, int num_experts) {
+  CHECK_GT(num_workers, 0) << "ValueError: num_workers must be positive";
+  CHECK_EQ(num_experts % num_workers, 0)
+      << "ValueError: The " << num_experts << " experts cannot be distributed evenly over "
+      << num_workers << " workers";
+  auto pass_func = [=](IRModule m, PassContext pc) {
+    return ExpertParallelLowerer::Lower(m, num_workers, num_experts);
+  };
+  return CreateModulePass(pass_func, 1, "LowerExpertParallel", {});
+}
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.distributed.transform.LowerExpertParallel", LowerExpertParallel);
+}
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
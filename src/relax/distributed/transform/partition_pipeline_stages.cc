@@ -0,0 +1,347 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform/partition_pipeline_stages.cc
+ * \brief Pass for partitioning a function into pipeline stages balanced by FLOPs and memory, run
+ *  by the disco worker groups with "runtime.disco.run_pipeline_stages".
+ */
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/block_builder.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/utils.h>
+#include <tvm/tir/op.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../op/tensor/create.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+namespace {
+
+/*! \brief Get the constant number of bytes of a tensor, or 0 if its shape is symbolic. */
+int64_t GetStaticTensorBytes(const Expr& expr) {
+  const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(expr);
+  const auto* shape = sinfo != nullptr ? sinfo->shape.as<ShapeExprNode>() : nullptr;
+  if (shape == nullptr || sinfo->IsUnknownDtype()) {
+    return 0;
+  }
+  int64_t bytes = sinfo->dtype.bytes() * sinfo->dtype.lanes();
+  for (const PrimExpr& dim : shape->values) {
+    const int64_t* dim_len = tir::as_const_int(dim);
+    if (dim_len == nullptr) {
+      return 0;
+    }
+    bytes *= *dim_len;
+  }
+  return bytes;
+}
+
+/*! \brief Get the vars an expression uses, in the order of their first use. */
+std::vector<Var> GetUsedVars(const Expr& expr) {
+  std::vector<Var> vars;
+  std::unordered_set<const VarNode*> visited;
+  PostOrderVisit(expr, [&](const Expr& e) {
+    if (const auto* var = e.as<VarNode>()) {
+      if (visited.insert(var).second) {
+        vars.push_back(ffi::GetRef<Var>(var));
+      }
+    }
+  });
+  return vars;
+}
+
+/*!
+ * \brief Split the costs of a sequence of bindings into a number of consecutive non-empty
+ * stages minimizing the maximum cost of a stage.
+ * \return The index of the first binding of each stage.
+ */
+std::vector<int> PartitionLinear(const std::vector<double>& costs, int num_stages) {
+  int n = static_cast<int>(costs.size());
+  std::vector<double> prefix(n + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    prefix[i + 1] = prefix[i] + costs[i];
+  }
+  const double inf = std::numeric_limits<double>::infinity();
+  // best[k][i]: the minimum maximum cost of splitting the first i bindings into k stages.
+  std::vector<std::vector<double>> best(num_stages + 1, std::vector<double>(n + 1, inf));
+  std::vector<std::vector<int>> split(num_stages + 1, std::vector<int>(n + 1, 0));
+  best[0][0] = 0;
+  for (int k = 1; k <= num_stages; ++k) {
+    for (int i = k; i <= n - (num_stages - k); ++i) {
+      for (int j = k - 1; j < i; ++j) {
+        double cost = std::max(best[k - 1][j], prefix[i] - prefix[j]);
+        if (cost < best[k][i]) {
+          best[k][i] = cost;
+          split[k][i] = j;
+        }
+      }
+    }
+  }
+  std::vector<int> starts(num_stages);
+  for (int k = num_stages, i = n; k >= 1; --k) {
+    starts[k - 1] = split[k][i];
+    i = split[k][i];
+  }
+  return starts;
+}
+
+/*!
+ * \brief Partition a function into pipeline stages.
+ *
+ * The first num_input parameters of the function are the inputs of each micro-batch, and the
+ * others are the weights. Each binding of the dataflow block costs its share of the FLOPs of
+ * the function plus its share of the bytes of the weights it uses first, and the bindings are
+ * split into consecutive stages minimizing the maximum cost of a stage. Stage i is the function
+ * `{func_name}_stage{i}`, which takes the values the stage i - 1 passes on, or the inputs for the
+ * first stage, followed by the weights the stage uses, and returns the tuple of the values the
+ * later stages use. The last stage returns the result of the function. Each stage but the first
+ * also has `{func_name}_stage{i}_recv_buffers`, which allocates the buffers receiving the values
+ * from the previous stage.
+ */
+class PipelineStagePartitioner {
+ public:
+  PipelineStagePartitioner(IRModule mod, ffi::String func_name, int num_stages)
+      : mod_(mod), func_name_(func_name), num_stages_(num_stages) {}
+
+  IRModule Partition() {
+    const auto* func = mod_->Lookup(func_name_).as<FunctionNode>();
+    CHECK(func) << func_name_ << " is not a Relax Function";
+    const auto* seq = func->body.as<SeqExprNode>();
+    CHECK(seq && seq->blocks.size() == 1 && seq->blocks[0]->IsInstance<DataflowBlockNode>())
+        << "PartitionPipelineStages expects the body of " << func_name_
+        << " to be a single dataflow block. ConvertToDataflow may need to be called first.";
+    ffi::Array<Binding> bindings = seq->blocks[0]->bindings;
+    CHECK_GE(static_cast<int>(bindings.size()), num_stages_)
+        << "ValueError: " << func_name_ << " has " << bindings.size()
+        << " bindings, fewer than the " << num_stages_ << " stages";
+
+    int num_input =
+        func->GetAttr<Integer>(attr::kNumInput).value_or(Integer(func->params.size()))->value;
+    std::unordered_set<const VarNode*> weights;
+    for (int i = num_input; i < static_cast<int>(func->params.size()); ++i) {
+      weights.insert(func->params[i].get());
+    }
+
+    // Step 1. Split the bindings by their costs.
+    std::vector<double> flops, weight_bytes;
+    double total_flops = 0, total_weight_bytes = 0;
+    std::unordered_set<const VarNode*> used_weights;
+    for (const Binding& binding : bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      CHECK(var_binding) << "PartitionPipelineStages does not support MatchCast bindings";
+      const auto* call = var_binding->value.as<CallNode>();
+      flops.push_back(call != nullptr ? EstimateCallFlops(mod_, ffi::GetRef<Call>(call)) : 0);
+      weight_bytes.push_back(0);
+      for (const Var& var : GetUsedVars(var_binding->value)) {
+        if (weights.count(var.get()) && used_weights.insert(var.get()).second) {
+          weight_bytes.back() += GetStaticTensorBytes(var);
+        }
+      }
+      total_flops += flops.back();
+      total_weight_bytes += weight_bytes.back();
+    }
+    std::vector<double> costs;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      double cost = 0;
+      cost += total_flops > 0 ? flops[i] / total_flops : 0;
+      cost += total_weight_bytes > 0 ? weight_bytes[i] / total_weight_bytes : 0;
+      // Balance the stages by the number of bindings when nothing is estimated.
+      costs.push_back(total_flops > 0 || total_weight_bytes > 0 ? cost : 1);
+    }
+    std::vector<int> starts = PartitionLinear(costs, num_stages_);
+    starts.push_back(static_cast<int>(bindings.size()));
+
+    // Step 2. Find the stage defining and the last stage using each value.
+    std::unordered_map<const VarNode*, int> def_stage, last_use_stage;
+    for (int i = 0; i < num_input; ++i) {
+      def_stage[func->params[i].get()] = 0;
+    }
+    for (int stage = 0; stage < num_stages_; ++stage) {
+      for (int i = starts[stage]; i < starts[stage + 1]; ++i) {
+        const auto* var_binding = bindings[i].as<VarBindingNode>();
+        for (const Var& var : GetUsedVars(var_binding->value)) {
+          last_use_stage[var.get()] = stage;
+        }
+        def_stage[bindings[i]->var.get()] = stage;
+      }
+    }
+    for (const Var& var : GetUsedVars(seq->body)) {
+      last_use_stage[var.get()] = num_stages_ - 1;
+    }
+    // The values stage i passes on to the stage i + 1, in the order of their definitions.
+    std::vector<std::vector<Var>> passed(num_stages_);
+    std::vector<Var> values(func->params.begin(), func->params.begin() + num_input);
+    for (const Binding& binding : bindings) {
+      values.push_back(binding->var);
+    }
+    for (const Var& value : values) {
+      auto it = last_use_stage.find(value.get());
+      if (it == last_use_stage.end()) continue;
+      for (int stage = def_stage[value.get()]; stage < it->second; ++stage) {
+        passed[stage].push_back(value);
+      }
+    }
+
+    // Step 3. Build the functions of the stages.
+    IRModule result = mod_;
+    IRModuleNode* result_node = result.CopyOnWrite();
+    for (int stage = 0; stage < num_stages_; ++stage) {
+      std::vector<Var> inputs =
+          stage == 0 ? std::vector<Var>(func->params.begin(), func->params.begin() + num_input)
+                     : passed[stage - 1];
+      bool is_last = stage + 1 == num_stages_;
+      std::string name = std::string(func_name_) + "_stage" + std::to_string(stage);
+      Function stage_func = BuildStage(ffi::GetRef<Function>(func), inputs, weights, bindings,
+                                       starts[stage], starts[stage + 1],
+                                       is_last ? std::vector<Var>() : passed[stage],
+                                       is_last ? seq->body : Expr());
+      stage_func = WithAttr(stage_func, tvm::attr::kGlobalSymbol, ffi::String(name));
+      result_node->Add(GlobalVar(name), stage_func);
+      if (stage > 0) {
+        std::string recv_name = name + "_recv_buffers";
+        Function recv_func = BuildRecvBuffers(inputs, name);
+        recv_func = WithAttr(recv_func, tvm::attr::kGlobalSymbol, ffi::String(recv_name));
+        result_node->Add(GlobalVar(recv_name), recv_func);
+      }
+    }
+    return result;
+  }
+
+ private:
+  Function BuildStage(const Function& func, const std::vector<Var>& inputs,
+                      const std::unordered_set<const VarNode*>& weights,
+                      const ffi::Array<Binding>& bindings, int begin, int end,
+                      const std::vector<Var>& outputs, const Expr& result) {
+    ffi::Map<Var, Expr> var_map;
+    ffi::Array<Var> params;
+    for (const Var& input : inputs) {
+      Var param(input->name_hint(), GetStructInfo(input));
+      params.push_back(param);
+      var_map.Set(input, param);
+    }
+    int num_input = static_cast<int>(params.size());
+    // The weights are passed in the order of the parameters of the function.
+    std::unordered_set<const VarNode*> used;
+    for (int i = begin; i < end; ++i) {
+      for (const Var& var : GetUsedVars(Downcast<VarBinding>(bindings[i])->value)) {
+        used.insert(var.get());
+      }
+    }
+    if (result.defined()) {
+      for (const Var& var : GetUsedVars(result)) {
+        used.insert(var.get());
+      }
+    }
+    for (const Var& param : func->params) {
+      if (weights.count(param.get()) && used.count(param.get())) {
+        Var new_param(param->name_hint(), GetStructInfo(param));
+        params.push_back(new_param);
+        var_map.Set(param, new_param);
+      }
+    }
+
+    BlockBuilder builder = BlockBuilder::Create(mod_);
+    builder->BeginDataflowBlock();
+    for (int i = begin; i < end; ++i) {
+      const auto* var_binding = bindings[i].as<VarBindingNode>();
+      Expr value = Bind(var_binding->value, var_map);
+      ffi::String name = var_binding->var->name_hint();
+      Var new_var = var_binding->var->IsInstance<DataflowVarNode>()
+                        ? builder->Emit(value, name)
+                        : builder->EmitOutput(value, name);
+      var_map.Set(var_binding->var, new_var);
+    }
+    Expr output;
+    if (result.defined()) {
+      output = Bind(result, var_map);
+    } else {
+      ffi::Array<Expr> fields;
+      for (const Var& var : outputs) {
+        fields.push_back(var_map.at(var));
+      }
+      output = Tuple(fields);
+    }
+    // The result of the last stage may already be an output of the block.
+    Var output_var = output->IsInstance<VarNode>() && !output->IsInstance<DataflowVarNode>()
+                         ? Downcast<Var>(output)
+                         : builder->EmitOutput(output, "gv");
+    BindingBlock block = builder->EndBlock();
+    Function stage_func(params, builder->Normalize(SeqExpr({block}, output_var)), std::nullopt,
+                        func->is_pure);
+    return WithAttr(stage_func, attr::kNumInput, Integer(num_input));
+  }
+
+  Function BuildRecvBuffers(const std::vector<Var>& inputs, const std::string& stage_name) {
+    BlockBuilder builder = BlockBuilder::Create(mod_);
+    builder->BeginDataflowBlock();
+    ffi::Array<Expr> buffers;
+    for (const Var& input : inputs) {
+      const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(input);
+      CHECK(sinfo && sinfo->shape.as<ShapeExprNode>() && !sinfo->IsUnknownDtype() &&
+            GetStaticTensorBytes(input) > 0)
+          << "ValueError: " << stage_name << " receives " << input->name_hint()
+          << ", whose struct info " << GetStructInfo(input)
+          << " is not a tensor of static shape to send between the pipeline stages";
+      buffers.push_back(builder->Emit(zeros(sinfo->shape.value(), sinfo->dtype)));
+    }
+    Var output_var = builder->EmitOutput(Tuple(buffers), "gv");
+    BindingBlock block = builder->EndBlock();
+    return Function({}, builder->Normalize(SeqExpr({block}, output_var)), std::nullopt, true);
+  }
+
+  IRModule mod_;
+  ffi::String func_name_;
+  int num_stages_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass PartitionPipelineStages(ffi::String func_name, int num_stages) {
+  CHECK_GT(num_stages, 0) << "ValueError: The number of stages must be positive, but got "
+                          << num_stages;
+  auto pass_func = [=](IRModule mod, PassContext pc) {
+    return PipelineStagePartitioner(mod, func_name, num_stages).Partition();
+  };
+  return CreateModulePass(pass_func, 0, "PartitionPipelineStages", {});
+}
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.distributed.transform.PartitionPipelineStages",
+                        PartitionPipelineStages);
+}
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
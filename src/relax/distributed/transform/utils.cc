@@ -18,6 +18,10 @@
  */
 
 #include "utils.h"
+
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+
 namespace tvm {
 namespace relax {
 namespace distributed {
@@ -76,6 +80,45 @@ bool IsShardingAnnotatedFunc(Function func) {
   });
   return has_annotate_sharding;
 }
+
+double EstimateCallFlops(const IRModule& mod, const Call& call) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  static const Op& matmul_op = Op::Get("relax.matmul");
+  if (call->op.same_as(call_tir_op)) {
+    ffi::Optional<tir::PrimFunc> prim_func = MatchPrimFunc(mod, call->args[0]);
+    return prim_func.has_value() ? tir::EstimateTIRFlops(prim_func.value()->body) : 0;
+  }
+  auto f_num_elements = [](const TensorStructInfoNode* sinfo) -> double {
+    const auto* shape = sinfo != nullptr ? sinfo->shape.as<ShapeExprNode>() : nullptr;
+    if (shape == nullptr) {
+      return -1;
+    }
+    double num_elements = 1;
+    for (const PrimExpr& dim : shape->values) {
+      const int64_t* dim_len = tir::as_const_int(dim);
+      if (dim_len == nullptr) {
+        return -1;
+      }
+      num_elements *= *dim_len;
+    }
+    return num_elements;
+  };
+  double num_elements = f_num_elements(GetStructInfoAs<TensorStructInfoNode>(call));
+  if (num_elements < 0) {
+    return 0;
+  }
+  if (call->op.same_as(matmul_op)) {
+    const auto* lhs_sinfo = GetStructInfoAs<TensorStructInfoNode>(call->args[0]);
+    const auto* lhs_shape = lhs_sinfo != nullptr ? lhs_sinfo->shape.as<ShapeExprNode>() : nullptr;
+    if (lhs_shape != nullptr && !lhs_shape->values.empty()) {
+      if (const int64_t* k = tir::as_const_int(lhs_shape->values.back())) {
+        return 2 * num_elements * *k;
+      }
+    }
+  }
+  return num_elements;
+}
+
 }  // namespace distributed
 }  // namespace relax
 }  // namespace tvm
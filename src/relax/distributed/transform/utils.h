@@ -23,6 +23,7 @@
 #include <tvm/ir/function.h>
 #include <tvm/ir/module.h>
 #include <tvm/relax/analysis.h>
+#include <tvm/relax/distributed/axis_group_graph.h>
 #include <tvm/relax/distributed/struct_info.h>
 #include <tvm/relax/expr_functor.h>
 namespace tvm {
@@ -60,6 +61,25 @@ bool IsDistIRFunc(Function func);
  */
 bool IsShardingAnnotatedFunc(Function func);
 
+/*!
+ * \brief Estimate the FLOPs of a call, by EstimateTIRFlops for a call_tir, as 2 * M * N * K for a
+ * matmul, and as the number of output elements for the other ops
+ * \param mod The IRModule of the call, where the TIR function of a call_tir is looked up
+ * \param call The call, whose output shape is static for the estimate of a non-call_tir
+ * \return The estimated FLOPs, or 0 if the shapes are symbolic
+ */
+double EstimateCallFlops(const IRModule& mod, const Call& call);
+
+/*!
+ * \brief Build the axis group graph of a function, which PropagateSharding propagates the sharding
+ * annotations along.
+ * \param axis_group_graph The graph to add the axes and the edges of the function to
+ * \param func The function
+ * \param mod The IRModule of the function, where the TIR functions it calls are looked up
+ */
+void BuildAxisGroupGraph(AxisGroupGraph* axis_group_graph, const Function& func,
+                         const IRModule& mod);
+
 }  // namespace distributed
 }  // namespace relax
 }  // namespace tvm
@@ -34,6 +34,7 @@
 #include <tvm/relax/type.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -844,7 +845,16 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
       }
       ICHECK(op_map_infer_struct_info_.count(op))
           << " Cannot find the FInferStructInfo attribute registered to op: " << op->name;
-      return op_map_infer_struct_info_[op](call, ffi::GetRef<BlockBuilder>(this));
+      // Repeated layers of a large model call the same op on the same static shapes over and
+      // over, reuse the struct info inferred for the first of them.
+      ffi::Optional<ffi::Array<ffi::Any>> memo_key = GetStructInfoMemoKey(call);
+      if (memo_key.has_value()) {
+        auto it = struct_info_memo_.find(memo_key.value());
+        if (it != struct_info_memo_.end()) return it->second;
+      }
+      StructInfo sinfo = op_map_infer_struct_info_[op](call, ffi::GetRef<BlockBuilder>(this));
+      if (memo_key.has_value()) struct_info_memo_.emplace(memo_key.value(), sinfo);
+      return sinfo;
     } else {
       // derive using function parameters
       ICHECK(call->op->struct_info_.defined());
@@ -855,6 +865,51 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
     }
   }
 
+  /*!
+   * \brief Whether the struct info is fully static, so that the struct info inferred from it
+   *  neither refers to the argument itself nor depends on the shape vars known in the scope.
+   */
+  static bool IsStaticStructInfo(const StructInfo& sinfo) {
+    auto is_static_value = [](const PrimExpr& value) {
+      return value->IsInstance<IntImmNode>() || value->IsInstance<FloatImmNode>();
+    };
+    if (const auto* tensor = sinfo.as<TensorStructInfoNode>()) {
+      if (!tensor->shape.defined()) return true;
+      const auto* shape = tensor->shape.value().as<ShapeExprNode>();
+      return shape != nullptr && std::all_of(shape->values.begin(), shape->values.end(),
+                                             is_static_value);
+    } else if (const auto* shape = sinfo.as<ShapeStructInfoNode>()) {
+      return !shape->values.defined() ||
+             std::all_of(shape->values.value().begin(), shape->values.value().end(),
+                         is_static_value);
+    } else if (const auto* prim = sinfo.as<PrimStructInfoNode>()) {
+      return !prim->value.defined() || is_static_value(prim->value.value());
+    } else if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+      return std::all_of(tuple->fields.begin(), tuple->fields.end(), IsStaticStructInfo);
+    }
+    return false;
+  }
+
+  /*!
+   * \brief The key of the call in the struct info memo, or std::nullopt if its struct info
+   *  must be inferred from the call itself.
+   */
+  static ffi::Optional<ffi::Array<ffi::Any>> GetStructInfoMemoKey(const Call& call) {
+    ffi::Array<ffi::Any> arg_sinfo;
+    for (const Expr& arg : call->args) {
+      if (!arg->struct_info_.defined()) return std::nullopt;
+      StructInfo sinfo = Downcast<StructInfo>(arg->struct_info_);
+      if (!IsStaticStructInfo(sinfo)) return std::nullopt;
+      // A few ops look into in-line arguments such as PrimValue and ShapeExpr.
+      arg_sinfo.push_back(static_cast<int64_t>(arg->type_index()));
+      arg_sinfo.push_back(sinfo);
+    }
+    if (!std::all_of(call->sinfo_args.begin(), call->sinfo_args.end(), IsStaticStructInfo)) {
+      return std::nullopt;
+    }
+    return ffi::Array<ffi::Any>{call->op, call->attrs, call->sinfo_args, arg_sinfo};
+  }
+
   // erase to well defined within current scope.
   StructInfo EraseToWellDefinedInScope(StructInfo info) {
     if (scope_stack_.empty()) {
@@ -1035,6 +1090,13 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
 
   /*! \brief Whether the FNormalize function should be applied */
   bool apply_f_normalize_{true};
+
+  /*!
+   * \brief The struct info inferred for the calls of an op, keyed by the op, its attributes,
+   *  sinfo_args and the kind and static struct info of its arguments.
+   */
+  std::unordered_map<ffi::Array<ffi::Any>, StructInfo, StructuralHash, StructuralEqual>
+      struct_info_memo_;
 };
 
 BlockBuilder BlockBuilder::Create(ffi::Optional<IRModule> mod) {
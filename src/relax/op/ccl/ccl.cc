@@ -20,6 +20,7 @@
 #include "ccl.h"
 
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/ir/transform.h>
 
 #include <utility>
 
@@ -28,10 +29,17 @@ namespace relax {
 
 /* relax.ccl.allreduce */
 
+/*!
+ * \brief The format, "int8" or "e4m3", of the data exchanged by the sum and avg allreduces of
+ * floating-point tensors. When set, LegalizeOps lowers them to the quantized allreduce.
+ */
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.ccl.allreduce_quantization", ffi::String);
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   AllReduceAttrs::RegisterReflection();
   AllGatherAttrs::RegisterReflection();
   ScatterCollectiveAttrs::RegisterReflection();
+  RingAttentionAttrs::RegisterReflection();
 }
 
 Expr allreduce(Expr x, ffi::String op_type, bool in_group) {
@@ -61,6 +69,62 @@ TVM_REGISTER_OP("relax.ccl.allreduce")
     .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutUnaryEwise)
     .set_attr<Bool>("FPurity", Bool(true));
 
+/* relax.ccl.allreduce_start */
+
+Expr allreduce_start(Expr x, ffi::String op_type, bool in_group) {
+  ObjectPtr<AllReduceAttrs> attrs = ffi::make_object<AllReduceAttrs>();
+  attrs->op_type = std::move(op_type);
+  attrs->in_group = std::move(in_group);
+
+  static const Op& op = Op::Get("relax.ccl.allreduce_start");
+  return Call(op, {std::move(x)}, Attrs{attrs}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.ccl.allreduce_start", allreduce_start);
+}
+
+TVM_REGISTER_OP("relax.ccl.allreduce_start")
+    .set_attrs_type<AllReduceAttrs>()
+    .set_num_inputs(1)
+    .add_argument("x", "Tensor", "Input to which allreduce will be applied.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllReduce)
+    .set_attr<Bool>("FPurity", Bool(true));
+
+/* relax.ccl.allreduce_wait */
+
+Expr allreduce_wait(Expr pending, Expr x) {
+  static const Op& op = Op::Get("relax.ccl.allreduce_wait");
+  return Call(op, {std::move(pending), std::move(x)}, {}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.ccl.allreduce_wait", allreduce_wait);
+}
+
+StructInfo InferStructInfoAllReduceWait(const Call& call, const BlockBuilder& ctx) {
+  ffi::Array<TensorStructInfo> input_sinfo = GetInputTensorStructInfo(call, ctx);
+  return input_sinfo[0];
+}
+
+Expr LowerBuiltinAllReduceWait(const BlockBuilder& bb, const Call& call) {
+  static const ExternFunc builtin_allreduce_wait{"runtime.disco.allreduce_wait"};
+  return Call(builtin_allreduce_wait, call->args, Attrs(), {GetStructInfo(call)});
+}
+
+// The output aliases the pending result, so the op is kept until memory planning, and only then
+// lowered to the runtime builtin.
+TVM_REGISTER_OP("relax.ccl.allreduce_wait")
+    .set_num_inputs(2)
+    .add_argument("pending", "Tensor", "The output of the allreduce_start to wait for.")
+    .add_argument("x", "Tensor", "The input of the allreduce_start, kept alive until the wait.")
+    .set_attr<Bool>("RequiresArgumentShapes", Bool(false))
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllReduceWait)
+    .set_attr<Bool>("FPurity", Bool(true))
+    .set_attr<FLowerBuiltin>("FLowerBuiltin", LowerBuiltinAllReduceWait);
+
 /* relax.ccl.allgather */
 
 Expr allgather(Expr x, int num_workers, bool in_group) {
@@ -100,6 +164,44 @@ TVM_REGISTER_OP("relax.ccl.allgather")
     .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutUnaryEwise)
     .set_attr<Bool>("FPurity", Bool(true));
 
+/* relax.ccl.alltoall */
+
+Expr alltoall(Expr x, int num_workers, bool in_group) {
+  ObjectPtr<AllGatherAttrs> attrs = ffi::make_object<AllGatherAttrs>();
+  attrs->num_workers = std::move(num_workers);
+  attrs->in_group = std::move(in_group);
+
+  static const Op& op = Op::Get("relax.ccl.alltoall");
+  return Call(op, {std::move(x)}, Attrs{attrs}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.ccl.alltoall", alltoall);
+}
+
+StructInfo InferStructInfoAllToAll(const Call& call, const BlockBuilder& ctx) {
+  TensorStructInfo input_sinfo = GetUnaryInputTensorStructInfo(call, ctx);
+  const auto* attrs = call->attrs.as<AllGatherAttrs>();
+  auto input_shape = input_sinfo->GetShape();
+  PrimExpr num_workers(attrs->num_workers);
+  if (input_shape.defined() &&
+      ctx->GetAnalyzer()->CanProve(floormod(input_shape.value()[0], num_workers) != 0)) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "alltoall expects the size of axis 0 of input tensor to be divisible by "
+                        "the num_workers. However, the input tensor has shape "
+                     << input_shape.value() << " while num_workers is " << attrs->num_workers);
+  }
+  return input_sinfo;
+}
+
+TVM_REGISTER_OP("relax.ccl.alltoall")
+    .set_num_inputs(1)
+    .add_argument("x", "Tensor", "The buffer to be split evenly along axis 0 and exchanged.")
+    .set_attrs_type<AllGatherAttrs>()
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllToAll)
+    .set_attr<Bool>("FPurity", Bool(true));
+
 /* relax.ccl.broadcast_from_worker0 */
 Expr broadcast_from_worker0(Expr x) {
   static const Op& op = Op::Get("relax.ccl.broadcast_from_worker0");
@@ -171,5 +273,127 @@ TVM_REGISTER_OP("relax.ccl.scatter_from_worker0")
     .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoScatter)
     .set_attr<Bool>("FPurity", Bool(true));
 
+/* relax.ccl.ring_send_recv_start */
+
+Expr ring_send_recv_start(Expr x, int num_workers, bool in_group) {
+  ObjectPtr<AllGatherAttrs> attrs = ffi::make_object<AllGatherAttrs>();
+  attrs->num_workers = std::move(num_workers);
+  attrs->in_group = std::move(in_group);
+
+  static const Op& op = Op::Get("relax.ccl.ring_send_recv_start");
+  return Call(op, {std::move(x)}, Attrs{attrs}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.ccl.ring_send_recv_start", ring_send_recv_start);
+}
+
+StructInfo InferStructInfoRingSendRecv(const Call& call, const BlockBuilder& ctx) {
+  return GetUnaryInputTensorStructInfo(call, ctx);
+}
+
+TVM_REGISTER_OP("relax.ccl.ring_send_recv_start")
+    .set_attrs_type<AllGatherAttrs>()
+    .set_num_inputs(1)
+    .add_argument("x", "Tensor", "The buffer sent to the next worker of the ring.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoRingSendRecv)
+    .set_attr<Bool>("FPurity", Bool(true));
+
+/* relax.ccl.ring_send_recv_wait */
+
+Expr ring_send_recv_wait(Expr pending, Expr x) {
+  static const Op& op = Op::Get("relax.ccl.ring_send_recv_wait");
+  return Call(op, {std::move(pending), std::move(x)}, {}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.ccl.ring_send_recv_wait", ring_send_recv_wait);
+}
+
+Expr LowerBuiltinRingSendRecvWait(const BlockBuilder& bb, const Call& call) {
+  static const ExternFunc builtin_ring_send_recv_wait{"runtime.disco.ring_send_recv_wait"};
+  return Call(builtin_ring_send_recv_wait, call->args, Attrs(), {GetStructInfo(call)});
+}
+
+// Like allreduce_wait, the op is kept until memory planning, so that the buffer received into
+// and the buffer sent stay alive until the wait.
+TVM_REGISTER_OP("relax.ccl.ring_send_recv_wait")
+    .set_num_inputs(2)
+    .add_argument("pending", "Tensor", "The output of the ring_send_recv_start to wait for.")
+    .add_argument("x", "Tensor", "The input of ring_send_recv_start, kept alive until the wait.")
+    .set_attr<Bool>("RequiresArgumentShapes", Bool(false))
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllReduceWait)
+    .set_attr<Bool>("FPurity", Bool(true))
+    .set_attr<FLowerBuiltin>("FLowerBuiltin", LowerBuiltinRingSendRecvWait);
+
+/* relax.ccl.ring_attention */
+
+Expr ring_attention(Expr query, Expr key, Expr value, int num_workers, bool in_group, bool causal,
+                    ffi::Optional<FloatImm> scale) {
+  ObjectPtr<RingAttentionAttrs> attrs = ffi::make_object<RingAttentionAttrs>();
+  attrs->num_workers = num_workers;
+  attrs->in_group = in_group;
+  attrs->causal = causal;
+  attrs->scale = std::move(scale);
+
+  static const Op& op = Op::Get("relax.ccl.ring_attention");
+  return Call(op, {std::move(query), std::move(key), std::move(value)}, Attrs{attrs}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.ccl.ring_attention", ring_attention);
+}
+
+StructInfo InferStructInfoRingAttention(const Call& call, const BlockBuilder& ctx) {
+  ffi::Array<TensorStructInfo> input_sinfo = GetInputTensorStructInfo(call, ctx);
+  TensorStructInfo q_sinfo = input_sinfo[0];
+  TensorStructInfo k_sinfo = input_sinfo[1];
+  TensorStructInfo v_sinfo = input_sinfo[2];
+  for (const TensorStructInfo& sinfo : input_sinfo) {
+    if (!sinfo->IsUnknownNdim() && sinfo->ndim != 4) {
+      ctx->ReportFatal(Diagnostic::Error(call)
+                       << "ring_attention expects the query, key and value to be 4-D tensors of "
+                          "layout (batch, seq_len, num_heads, head_dim). However, got "
+                       << sinfo);
+    }
+  }
+  const auto* q_shape = q_sinfo->shape.as<ShapeExprNode>();
+  const auto* k_shape = k_sinfo->shape.as<ShapeExprNode>();
+  const auto* v_shape = v_sinfo->shape.as<ShapeExprNode>();
+  if (q_shape == nullptr || k_shape == nullptr || v_shape == nullptr) {
+    return TensorStructInfo(q_sinfo->dtype, 4, q_sinfo->vdevice);
+  }
+  arith::Analyzer* analyzer = ctx->GetAnalyzer();
+  auto f_check = [&](const PrimExpr& lhs, const PrimExpr& rhs, const char* what) {
+    if (analyzer->CanProve(lhs != rhs)) {
+      ctx->ReportFatal(Diagnostic::Error(call)
+                       << "ring_attention expects " << what << ", but got " << lhs << " and "
+                       << rhs);
+    }
+  };
+  f_check(q_shape->values[0], k_shape->values[0], "the same batch size of query and key");
+  f_check(k_shape->values[0], v_shape->values[0], "the same batch size of key and value");
+  f_check(k_shape->values[1], v_shape->values[1], "the same sequence length of key and value");
+  f_check(k_shape->values[2], v_shape->values[2], "the same number of heads of key and value");
+  f_check(q_shape->values[3], k_shape->values[3], "the same head dim of query and key");
+  f_check(floormod(q_shape->values[2], k_shape->values[2]), IntImm(DataType::Int(64), 0),
+          "the number of query heads to be a multiple of the number of key heads");
+  ffi::Array<PrimExpr> output_shape = {q_shape->values[0], q_shape->values[1], q_shape->values[2],
+                                       v_shape->values[3]};
+  return TensorStructInfo(ShapeExpr(output_shape), q_sinfo->dtype, q_sinfo->vdevice);
+}
+
+TVM_REGISTER_OP("relax.ccl.ring_attention")
+    .set_attrs_type<RingAttentionAttrs>()
+    .set_num_inputs(3)
+    .add_argument("query", "Tensor", "The block of the queries of the worker.")
+    .add_argument("key", "Tensor", "The block of the keys of the worker.")
+    .add_argument("value", "Tensor", "The block of the values of the worker.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoRingAttention)
+    .set_attr<Bool>("FPurity", Bool(true));
+
 }  // namespace relax
 }  // namespace tvm
@@ -35,15 +35,36 @@ namespace relax {
 /*! \brief AllReduce. */
 Expr allreduce(Expr data, ffi::String op_type, bool in_group);
 
+/*! \brief Start an asynchronous AllReduce, whose output is ready after allreduce_wait. */
+Expr allreduce_start(Expr data, ffi::String op_type, bool in_group);
+
+/*! \brief Wait for the asynchronous AllReduce that produces `pending` from `data`. */
+Expr allreduce_wait(Expr pending, Expr data);
+
 /*! \brief AllGather. */
 Expr allgather(Expr data, int num_workers, bool in_group);
 
+/*! \brief AllToAll, exchanging the even splits along axis 0 of data between the workers. */
+Expr alltoall(Expr data, int num_workers, bool in_group);
+
 /*! \brief Broadcast data from worker-0 to all other workers. */
 Expr broadcast_from_worker0(Expr data);
 
 /*! \brief Perform a scatter operation from worker-0, chunking the given buffer into equal parts. */
 Expr scatter_from_worker0(Expr data, int num_workers, int axis);
 
+/*! \brief Start sending data to the next worker of the ring, while receiving the output from the
+ * previous one. The output is ready after ring_send_recv_wait. */
+Expr ring_send_recv_start(Expr data, int num_workers, bool in_group);
+
+/*! \brief Wait for the ring exchange that receives `pending` while sending `data`. */
+Expr ring_send_recv_wait(Expr pending, Expr data);
+
+/*! \brief Attention over a sequence sharded across a ring of workers, which rotate the blocks of
+ * the keys and values around the ring. */
+Expr ring_attention(Expr query, Expr key, Expr value, int num_workers, bool in_group, bool causal,
+                    ffi::Optional<FloatImm> scale);
+
 }  // namespace relax
 }  // namespace tvm
 
@@ -859,6 +859,44 @@ TVM_FFI_STATIC_INIT_BLOCK() {
   refl::GlobalDef().def("relax.op.call_dps_packed", MakeCallDPSPacked);
 }
 
+// external_call_wait
+
+StructInfo InferStructInfoExternalCallWait(const Call& call, const BlockBuilder& ctx) {
+  if (call->args.size() != 3) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "external_call_wait expects the pending result, the inputs of the "
+                        "external call and the index of its stream.");
+  }
+  return GetStructInfo(call->args[0]);
+}
+
+Expr LowerBuiltinExternalCallWait(const BlockBuilder& bb, const Call& call) {
+  static const ExternFunc builtin_external_call_wait{"vm.builtin.external_call_wait"};
+  return Call(builtin_external_call_wait, call->args, Attrs(), {GetStructInfo(call)});
+}
+
+// The output aliases the pending result, so the op is kept until memory planning, and only then
+// lowered to the runtime builtin.
+TVM_REGISTER_OP("relax.external_call_wait")
+    .set_num_inputs(3)
+    .add_argument("pending", "Tensor", "The output of the external call to wait for.")
+    .add_argument("inputs", "Tuple", "The inputs of the external call, kept alive until the wait.")
+    .add_argument("stream_index", "PrimValue", "The index of the stream of the external call.")
+    .set_attr<Bool>("RequiresArgumentShapes", Bool(false))
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoExternalCallWait)
+    .set_attr<Bool>("FPurity", Bool(true))
+    .set_attr<FLowerBuiltin>("FLowerBuiltin", LowerBuiltinExternalCallWait);
+
+Expr MakeExternalCallWait(Expr pending, Tuple inputs, int64_t stream_index) {
+  static const Op& op = Op::Get("relax.external_call_wait");
+  return Call(op, {pending, inputs, PrimValue::Int64(stream_index)}, {}, {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.op.external_call_wait", MakeExternalCallWait);
+}
+
 // call_py_func
 
 StructInfo InferStructInfoCallPyFunc(const Call& call, const BlockBuilder& ctx) {
@@ -39,9 +39,10 @@ TVM_FFI_STATIC_INIT_BLOCK() { AllClassNonMaximumSuppressionAttrs::RegisterReflec
 
 Expr all_class_non_max_suppression(Expr boxes, Expr scores, Expr max_output_boxes_per_class,
                                    Expr iou_threshold, Expr score_threshold,
-                                   ffi::String output_format) {
+                                   ffi::String output_format, bool fixed_output) {
   auto attrs = tvm::ffi::make_object<AllClassNonMaximumSuppressionAttrs>();
   attrs->output_format = output_format;
+  attrs->fixed_output = fixed_output;
 
   static const Op& op = Op::Get("relax.vision.all_class_non_max_suppression");
   return Call(op,
@@ -0,0 +1,289 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/auto_checkpoint.cc
+ * \brief Pick the activations kept for the backward pass under a memory budget, and annotate the
+ *  others with start_checkpoint and end_checkpoint so that the Gradient pass recomputes them.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/tir/op.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+using VarSet = std::unordered_set<const VarNode*>;
+
+/*!
+ * \brief Get the constant number of bytes of a tensor var, computed from its shape the same way
+ * StaticPlanBlockMemory does, or -1 if the var is not a tensor of static shape.
+ */
+int64_t GetStaticTensorBytes(const Var& var) {
+  const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(var);
+  if (sinfo == nullptr || sinfo->IsUnknownDtype() || !sinfo->shape.defined()) {
+    return -1;
+  }
+  const auto* shape = sinfo->shape.as<ShapeExprNode>();
+  if (shape == nullptr) {
+    return -1;
+  }
+  int64_t bytes = sinfo->dtype.bytes() * sinfo->dtype.lanes();
+  for (const PrimExpr& dim : shape->values) {
+    const int64_t* dim_len = tir::as_const_int(dim);
+    if (dim_len == nullptr) {
+      return -1;
+    }
+    bytes *= *dim_len;
+  }
+  return bytes;
+}
+
+/*! \brief Get the vars an expression uses, in the order of their first use. */
+std::vector<Var> GetUsedVars(const Expr& expr) {
+  std::vector<Var> vars;
+  std::unordered_set<const VarNode*> visited;
+  PostOrderVisit(expr, [&](const Expr& e) {
+    if (const auto* var = e.as<VarNode>()) {
+      if (visited.insert(var).second) {
+        vars.push_back(ffi::GetRef<Var>(var));
+      }
+    }
+  });
+  return vars;
+}
+
+/*!
+ * \brief Pick the bindings of a forward block to recompute in the backward pass.
+ *
+ * A binding is kept when its var is an output of the block, when it uses no vars, or when its
+ * size is not static. The others are candidates to recompute. For a segment budget b, the greedy
+ * scheme of "Training Deep Nets with Sublinear Memory Cost" walks the candidates in order and keeps
+ * a candidate once the recomputed segment before it would grow over b. The peak activation memory
+ * of the backward pass is then estimated by the bytes kept plus the largest recomputed segment,
+ * since CheckpointGenerator recomputes the segments on demand and StaticPlanBlockMemory frees each
+ * of them after its last use.
+ *
+ * Among the segment budgets whose estimated peak fits the memory budget, the one recomputing the
+ * fewest bindings is picked. When none fits, the one with the lowest peak is picked.
+ */
+VarSet PickRecomputedVars(const DataflowBlock& block, int64_t memory_budget) {
+  struct Candidate {
+    const VarNode* var;
+    int64_t bytes;
+  };
+  std::vector<Candidate> candidates;
+  int64_t forced_bytes = 0;
+  int64_t candidate_bytes = 0;
+  for (const Binding& binding : block->bindings) {
+    const auto* var_binding = binding.as<VarBindingNode>();
+    int64_t bytes = GetStaticTensorBytes(binding->var);
+    if (!binding->var->IsInstance<DataflowVarNode>() || GetUsedVars(var_binding->value).empty() ||
+        bytes < 0) {
+      forced_bytes += std::max<int64_t>(bytes, 0);
+      continue;
+    }
+    candidates.push_back({binding->var.get(), bytes});
+    candidate_bytes += bytes;
+  }
+  if (candidates.empty() || forced_bytes + candidate_bytes <= memory_budget) {
+    return {};
+  }
+
+  int num_candidates = static_cast<int>(candidates.size());
+  std::vector<bool> best_keep;
+  int best_num_recomputed = -1;
+  int64_t best_peak = -1;
+  bool best_fits = false;
+  for (int k = 1; k <= num_candidates; ++k) {
+    int64_t segment_budget = candidate_bytes * k / num_candidates;
+    std::vector<bool> keep(num_candidates, false);
+    int64_t kept_bytes = forced_bytes;
+    int64_t segment_bytes = 0;
+    int64_t max_segment_bytes = 0;
+    int num_recomputed = 0;
+    for (int i = 0; i < num_candidates; ++i) {
+      if (segment_bytes + candidates[i].bytes > segment_budget) {
+        keep[i] = true;
+        kept_bytes += candidates[i].bytes;
+        segment_bytes = 0;
+      } else {
+        segment_bytes += candidates[i].bytes;
+        max_segment_bytes = std::max(max_segment_bytes, segment_bytes);
+        ++num_recomputed;
+      }
+    }
+    int64_t peak = kept_bytes + max_segment_bytes;
+    bool fits = peak <= memory_budget;
+    bool better;
+    if (best_num_recomputed == -1 || fits != best_fits) {
+      better = best_num_recomputed == -1 || fits;
+    } else if (fits) {
+      better = num_recomputed < best_num_recomputed ||
+               (num_recomputed == best_num_recomputed && peak < best_peak);
+    } else {
+      better = peak < best_peak;
+    }
+    if (better) {
+      best_keep = keep;
+      best_num_recomputed = num_recomputed;
+      best_peak = peak;
+      best_fits = fits;
+    }
+  }
+  if (!best_fits) {
+    LOG(WARNING) << "AutoCheckpoint cannot fit the activations in the memory budget of "
+                 << memory_budget << " bytes, and recomputes them to an estimated peak of "
+                 << best_peak << " bytes";
+  }
+
+  VarSet recomputed;
+  for (int i = 0; i < num_candidates; ++i) {
+    if (!best_keep[i]) {
+      recomputed.insert(candidates[i].var);
+    }
+  }
+  return recomputed;
+}
+
+/*!
+ * \brief Annotate a forward block so that CheckpointCollector of the Gradient pass marks exactly
+ * the vars out of the recomputed set as checkpointed.
+ *
+ * A recomputed binding reads the kept vars and the params through start_checkpoint, and a kept
+ * binding reads the recomputed vars through end_checkpoint. Each annotation is emitted once, before
+ * its first use.
+ */
+DataflowBlock AnnotateCheckpoints(const DataflowBlock& block, const VarSet& recomputed) {
+  static const Op& start_checkpoint_op = Op::Get("relax.grad.start_checkpoint");
+  static const Op& end_checkpoint_op = Op::Get("relax.grad.end_checkpoint");
+
+  ffi::Array<Binding> new_bindings;
+  std::unordered_map<const VarNode*, Var> annotated;
+  auto f_annotate = [&](const Var& var, const Op& op, const char* suffix) -> Var {
+    auto it = annotated.find(var.get());
+    if (it != annotated.end()) {
+      return it->second;
+    }
+    Call call(op, {var});
+    UpdateStructInfo(call, GetStructInfo(var));
+    DataflowVar new_var(var->name_hint() + suffix, GetStructInfo(var));
+    new_bindings.push_back(VarBinding(new_var, call));
+    annotated[var.get()] = new_var;
+    return new_var;
+  };
+
+  for (const Binding& binding : block->bindings) {
+    const auto* var_binding = binding.as<VarBindingNode>();
+    bool is_recomputed = recomputed.count(binding->var.get());
+    ffi::Map<Var, Expr> var_map;
+    for (const Var& var : GetUsedVars(var_binding->value)) {
+      // The params are never recomputed.
+      bool is_kept = !recomputed.count(var.get());
+      if (is_recomputed && is_kept) {
+        var_map.Set(var, f_annotate(var, start_checkpoint_op, "_scp"));
+      } else if (!is_recomputed && !is_kept) {
+        var_map.Set(var, f_annotate(var, end_checkpoint_op, "_ecp"));
+      }
+    }
+    if (var_map.empty()) {
+      new_bindings.push_back(binding);
+    } else {
+      new_bindings.push_back(VarBinding(binding->var, Bind(var_binding->value, var_map)));
+    }
+  }
+  return DataflowBlock(new_bindings, block->span);
+}
+
+/*! \brief Check if a block is already annotated with checkpoints, or is not supported. */
+bool IsAnnotatedOrUnsupported(const DataflowBlock& block) {
+  static const Op& start_checkpoint_op = Op::Get("relax.grad.start_checkpoint");
+  static const Op& end_checkpoint_op = Op::Get("relax.grad.end_checkpoint");
+  for (const Binding& binding : block->bindings) {
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (var_binding == nullptr) {
+      return true;
+    }
+    const auto* call = var_binding->value.as<CallNode>();
+    if (call != nullptr && (call->op.same_as(start_checkpoint_op) ||
+                            call->op.same_as(end_checkpoint_op))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+namespace transform {
+
+Pass AutoCheckpoint(ffi::String func_name, int64_t memory_budget) {
+  CHECK_GE(memory_budget, 0) << "ValueError: The memory budget must be non-negative, but got "
+                             << memory_budget;
+  auto pass_func = [=](IRModule mod, PassContext pc) {
+    auto* func = mod->Lookup(func_name).as<FunctionNode>();
+    CHECK(func) << func_name << " is not a Relax Function";
+    const auto* seq = func->body.as<SeqExprNode>();
+    if (seq == nullptr || seq->blocks.size() != 1 ||
+        !seq->blocks[0]->IsInstance<DataflowBlockNode>()) {
+      LOG(WARNING) << "AutoCheckpoint expects the body of " << func_name
+                   << " to be a single dataflow block, and leaves it unchanged";
+      return mod;
+    }
+    DataflowBlock block = Downcast<DataflowBlock>(seq->blocks[0]);
+    if (IsAnnotatedOrUnsupported(block)) {
+      return mod;
+    }
+    VarSet recomputed = PickRecomputedVars(block, memory_budget);
+    if (recomputed.empty()) {
+      return mod;
+    }
+
+    Function new_func = ffi::GetRef<Function>(func);
+    new_func.CopyOnWrite()->body =
+        SeqExpr({AnnotateCheckpoints(block, recomputed)}, seq->body, seq->span);
+    mod.CopyOnWrite()->Update(mod->GetGlobalVar(func_name), new_func);
+    return mod;
+  };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"AutoCheckpoint",
+                          /*required=*/{});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.AutoCheckpoint", AutoCheckpoint);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -23,6 +23,7 @@
  *   into in-place versions.
  */
 
+#include <tvm/arith/iter_affine_map.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/ir/transform.h>
 #include <tvm/relax/analysis.h>
@@ -42,7 +43,15 @@ namespace relax {
 // pairs of indices (the liveness interval, from the starting index to the end index).
 // A starting index of -1 means the var is defined before the block starts and an end index
 // of block->bindings.size() (one past the last index) means it is live after the block ends.
-std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock& block) {
+// Without used_after, every non-dataflow var is assumed to be used after the block. Otherwise, it
+// is the set of the vars used after the block in the function, and live_through is the set of the
+// vars defined before the block that are used after it.
+std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(
+    const DataflowBlock& block, const std::unordered_set<Var>* used_after = nullptr,
+    const std::unordered_set<Var>* live_through = nullptr) {
+  auto is_live_out = [used_after](const Var& var) {
+    return used_after ? used_after->count(var) > 0 : !var.as<DataflowVarNode>();
+  };
   std::unordered_map<Var, std::pair<int, int>> ret;
   for (int i = block->bindings.size() - 1; i >= 0; i--) {
     Binding b = block->bindings[i];
@@ -65,9 +74,8 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
 
     for (auto var : used_vars) {
       int range_end = i;
-      // if the var is not a dataflow var, then it is live
-      // after the block (we are not checking later blocks)
-      if (!var.as<DataflowVarNode>()) {
+      // if the var is used after the block, then it is live after the block
+      if (is_live_out(var)) {
         range_end = block->bindings.size();
       }
       if (!ret.count(var)) {
@@ -77,7 +85,7 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
 
     if (!ret.count(defined_var)) {
       // if it's an output, then it lives past the end of the block
-      if (!defined_var.as<DataflowVarNode>()) {
+      if (is_live_out(defined_var)) {
         ret[defined_var] = {i, block->bindings.size()};
       } else {
         // otherwise, it's live only here
@@ -91,12 +99,20 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
       ret[defined_var] = new_range;
     }
   }
+  if (live_through) {
+    for (const Var& var : *live_through) {
+      ret[var] = {-1, static_cast<int>(block->bindings.size())};
+    }
+  }
   return ret;
 }
 
 class AliasAnalyzer {
  public:
-  AliasAnalyzer() : alias_map_(), tuple_map_(), mem_idx_(0) {}
+  // With a module, the calls to its Relax functions whose results never alias their arguments are
+  // treated like op calls, i.e. as returning fresh values, instead of mystery calls.
+  explicit AliasAnalyzer(ffi::Optional<IRModule> mod = std::nullopt)
+      : alias_map_(), tuple_map_(), mem_idx_(0), mod_(mod), fresh_callees_(&own_fresh_callees_) {}
 
   // The analysis returns a map of vars to memory locations that it *could* map to
   // (any unique allocation = one memory location), plus a map of memory locations
@@ -106,6 +122,13 @@ class AliasAnalyzer {
   std::pair<std::unordered_map<Var, std::unordered_set<int>>,
             std::unordered_map<int, std::vector<std::unordered_set<int>>>>
   Analyze(const DataflowBlock& block, const ffi::Array<Var>& inputs) {
+    return Analyze(ffi::Array<BindingBlock>{block}, inputs);
+  }
+
+  // Analyze consecutive binding blocks, e.g. all the blocks of a function body.
+  std::pair<std::unordered_map<Var, std::unordered_set<int>>,
+            std::unordered_map<int, std::vector<std::unordered_set<int>>>>
+  Analyze(const ffi::Array<BindingBlock>& blocks, const ffi::Array<Var>& inputs) {
     for (auto input : inputs) {
       int curr_idx = get_fresh_idx();
       alias_map_[input] = {curr_idx};
@@ -113,17 +136,62 @@ class AliasAnalyzer {
         InsertFreshTuple(curr_idx, tup_info);
       }
     }
+    inputs_end_idx_ = mem_idx_;
 
-    for (const Binding& binding : block->bindings) {
-      Var current_var = binding->var;
-      Expr value = GetBoundValue(binding);
-      alias_map_[current_var] = GetAliasSet(value, current_var);
+    for (const BindingBlock& block : blocks) {
+      for (const Binding& binding : block->bindings) {
+        Var current_var = binding->var;
+        Expr value = GetBoundValue(binding);
+        alias_map_[current_var] = GetAliasSet(value, current_var);
+      }
     }
 
     return {alias_map_, tuple_map_};
   }
 
  private:
+  // Check whether the result of a Relax function of the module never aliases its arguments.
+  bool ReturnsFreshValue(const GlobalVar& gv) {
+    if (!mod_.defined() || !mod_.value()->functions.count(gv)) {
+      return false;
+    }
+    if (auto it = fresh_callees_->find(gv.get()); it != fresh_callees_->end()) {
+      return it->second;
+    }
+    // recursive calls are assumed to alias their arguments
+    (*fresh_callees_)[gv.get()] = false;
+    auto func = mod_.value()->functions.Get(gv).value().as<FunctionNode>();
+    const auto* seq = func ? func->body.as<SeqExprNode>() : nullptr;
+    if (seq == nullptr) {
+      return false;
+    }
+    AliasAnalyzer callee_analyzer(mod_);
+    callee_analyzer.fresh_callees_ = fresh_callees_;
+    callee_analyzer.Analyze(seq->blocks, func->params);
+    Var ret_var("ret", GetStructInfo(seq->body));
+    bool fresh = callee_analyzer.AllFresh(callee_analyzer.GetAliasSet(seq->body, ret_var));
+    (*fresh_callees_)[gv.get()] = fresh;
+    return fresh;
+  }
+
+  // Check that none of the memory locations, or of the members of the tuples among them, is
+  // unknown or an input.
+  bool AllFresh(const std::unordered_set<int>& alias_set) {
+    for (int idx : alias_set) {
+      if (idx < inputs_end_idx_) {
+        return false;
+      }
+      if (tuple_map_.count(idx)) {
+        for (const auto& member_set : tuple_map_[idx]) {
+          if (!AllFresh(member_set)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
   int get_fresh_idx() {
     int ret = mem_idx_;
     mem_idx_++;
@@ -226,6 +294,9 @@ class AliasAnalyzer {
     if (value.as<ConstantNode>() || value.as<PrimValueNode>() || value.as<FunctionNode>()) {
       // TODO(@slyubomirsky): We will probably want special handling for closures
       ret.insert(get_fresh_idx());
+    } else if (value.as<IfNode>()) {
+      // only outside of dataflow blocks: the result may be any value of the branches
+      ret.insert(-1);
     } else if (auto* target_var_node = value.as<VarNode>()) {
       auto target_var = ffi::GetRef<Var>(target_var_node);
       if (alias_map_.count(target_var)) {
@@ -287,6 +358,16 @@ class AliasAnalyzer {
           }
           ret.insert(get_fresh_idx());
         }
+      } else if (const auto* gv = call_node->op.as<GlobalVarNode>();
+                 gv && ReturnsFreshValue(ffi::GetRef<GlobalVar>(gv))) {
+        // a subroutine whose result never aliases its arguments
+        if (auto* tup_info = GetStructInfoAs<TupleStructInfoNode>(bound_var)) {
+          int tup_idx = get_fresh_idx();
+          ret.insert(tup_idx);
+          InsertFreshTuple(tup_idx, tup_info);
+          return ret;
+        }
+        ret.insert(get_fresh_idx());
       } else {
         // assume any non-op call can be extremely dangerous and do anything
         return HandleMysteryCall(call_node, bound_var);
@@ -299,6 +380,13 @@ class AliasAnalyzer {
   std::unordered_map<Var, std::unordered_set<int>> alias_map_;
   std::unordered_map<int, std::vector<std::unordered_set<int>>> tuple_map_;
   int mem_idx_;
+  // the memory locations below this index are those of the inputs
+  int inputs_end_idx_ = 0;
+  ffi::Optional<IRModule> mod_;
+  // whether the result of each analyzed subroutine is fresh, shared with the analyzers of the
+  // subroutines
+  std::unordered_map<const GlobalVarNode*, bool> own_fresh_callees_;
+  std::unordered_map<const GlobalVarNode*, bool>* fresh_callees_;
 };
 
 // given a shape, return the number of elements corresponding to it (product of elements)
@@ -516,6 +604,194 @@ static std::unordered_set<std::string> SUPPORTED_OPS = {"relax.add",      "relax
                                                         "relax.nn.silu",  "relax.nn.relu"};
 bool OpSupportsInplace(const Op& op) { return SUPPORTED_OPS.count(op->name); }
 
+// Check whether a PrimFunc computes its output elementwise from one of its inputs, so that the
+// output can be written into the input: the output is written by a single store, executed once
+// per index, and the input is only read by the value of that store, at the same indices.
+class ElementwiseInputChecker : public tir::StmtExprVisitor {
+ public:
+  static bool Check(const tir::PrimFunc& func, int input_idx, int output_idx) {
+    auto input = func->buffer_map.Get(func->params[input_idx]);
+    auto output = func->buffer_map.Get(func->params[output_idx]);
+    if (!input || !output) {
+      return false;
+    }
+    ElementwiseInputChecker checker(input.value(), output.value());
+    if (!checker.SameLayout()) {
+      return false;
+    }
+    checker(func->body);
+    return checker.elementwise_ && checker.num_stores_ == 1;
+  }
+
+ private:
+  ElementwiseInputChecker(const tir::Buffer& input, const tir::Buffer& output)
+      : input_(input), output_(output) {}
+
+  bool SameLayout() {
+    if (input_->dtype != output_->dtype || input_->shape.size() != output_->shape.size() ||
+        !input_->strides.empty() || !output_->strides.empty() ||
+        !analyzer_.CanProveEqual(input_->elem_offset, output_->elem_offset)) {
+      return false;
+    }
+    for (size_t i = 0; i < input_->shape.size(); ++i) {
+      if (!analyzer_.CanProveEqual(input_->shape[i], output_->shape[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Check a buffer other than the input and the output does not alias them.
+  void CheckBuffer(const tir::Buffer& buffer) {
+    if (!buffer.same_as(input_) && !buffer.same_as(output_) &&
+        (buffer->data.same_as(input_->data) || buffer->data.same_as(output_->data))) {
+      elementwise_ = false;
+    }
+  }
+
+  void VisitStmt_(const tir::ForNode* op) final {
+    loops_.Set(op->loop_var, Range::FromMinExtent(op->min, op->extent));
+    tir::StmtExprVisitor::VisitStmt_(op);
+    loops_.erase(op->loop_var);
+  }
+
+  void VisitStmt_(const tir::BlockRealizeNode* op) final {
+    // Express the indices in the block in terms of the loop vars.
+    auto old_bindings = iter_bindings_;
+    auto old_predicate = predicate_;
+    for (size_t i = 0; i < op->iter_values.size(); ++i) {
+      iter_bindings_.Set(op->block->iter_vars[i]->var,
+                         tir::Substitute(op->iter_values[i], iter_bindings_));
+    }
+    predicate_ = predicate_ && tir::Substitute(op->predicate, iter_bindings_);
+    for (const auto& match_buffer : op->block->match_buffers) {
+      CheckBuffer(match_buffer->buffer);
+      if (match_buffer->source->buffer.same_as(input_) ||
+          match_buffer->source->buffer.same_as(output_)) {
+        elementwise_ = false;
+      }
+    }
+    tir::StmtExprVisitor::VisitStmt_(op);
+    iter_bindings_ = old_bindings;
+    predicate_ = old_predicate;
+  }
+
+  void VisitStmt_(const tir::BufferStoreNode* op) final {
+    CheckBuffer(op->buffer);
+    if (op->buffer.same_as(input_)) {
+      elementwise_ = false;
+    } else if (op->buffer.same_as(output_)) {
+      ++num_stores_;
+      ffi::Array<PrimExpr> indices =
+          op->indices.Map([this](const PrimExpr& e) { return tir::Substitute(e, iter_bindings_); });
+      auto iter_map = arith::DetectIterMap(indices, loops_, predicate_,
+                                           arith::IterMapLevel::Bijective, &analyzer_);
+      if (iter_map->indices.empty()) {
+        elementwise_ = false;
+      }
+      store_indices_ = op->indices;
+      tir::StmtExprVisitor::VisitExpr(op->value);
+      store_indices_ = std::nullopt;
+      for (const auto& index : op->indices) {
+        VisitExpr(index);
+      }
+      return;
+    }
+    tir::StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const tir::BufferLoadNode* op) final {
+    CheckBuffer(op->buffer);
+    if (op->buffer.same_as(output_)) {
+      elementwise_ = false;
+    } else if (op->buffer.same_as(input_) &&
+               (!store_indices_ || !StructuralEqual()(op->indices, store_indices_.value()))) {
+      elementwise_ = false;
+    }
+    tir::StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const tir::DeclBufferNode* op) final {
+    CheckBuffer(op->buffer);
+    tir::StmtExprVisitor::VisitStmt_(op);
+  }
+
+  // Any other use of the data of the buffers, e.g. an address passed to an extern, and the
+  // loops and threads the indices cannot be checked against.
+  void VisitExpr_(const tir::VarNode* op) final {
+    if (op == input_->data.get() || op == output_->data.get()) {
+      elementwise_ = false;
+    }
+  }
+  void VisitStmt_(const tir::WhileNode* op) final { elementwise_ = false; }
+  void VisitStmt_(const tir::AttrStmtNode* op) final {
+    if (op->attr_key == tir::attr::thread_extent || op->attr_key == tir::attr::virtual_thread) {
+      elementwise_ = false;
+    }
+    tir::StmtExprVisitor::VisitStmt_(op);
+  }
+
+  tir::Buffer input_;
+  tir::Buffer output_;
+  ffi::Map<tir::Var, Range> loops_;
+  ffi::Map<tir::Var, PrimExpr> iter_bindings_;
+  PrimExpr predicate_ = IntImm(DataType::Bool(), 1);
+  ffi::Optional<ffi::Array<PrimExpr>> store_indices_ = std::nullopt;
+  int num_stores_ = 0;
+  bool elementwise_ = true;
+  arith::Analyzer analyzer_;
+};
+
+// Return the PrimFunc of a call_tir to a single tensor, whose arguments can be written in-place,
+// if any.
+ffi::Optional<tir::PrimFunc> InplaceCandidatePrimFunc(const CallNode* call, const IRModule& mod) {
+  static const auto& call_tir_op = Op::Get("relax.call_tir");
+  // the scalar arguments would come after the output in the parameters
+  if (!call->op.same_as(call_tir_op) || call->args.size() != 2 ||
+      !call->sinfo_args[0].as<TensorStructInfoNode>()) {
+    return std::nullopt;
+  }
+  const auto* gv = call->args[0].as<GlobalVarNode>();
+  const auto* args = call->args[1].as<TupleNode>();
+  if (gv == nullptr || args == nullptr) {
+    return std::nullopt;
+  }
+  auto func = mod->functions.Get(ffi::GetRef<GlobalVar>(gv));
+  if (!func || !func.value()->IsInstance<tir::PrimFuncNode>()) {
+    return std::nullopt;
+  }
+  auto prim_func = Downcast<tir::PrimFunc>(func.value());
+  if (prim_func->params.size() != args->fields.size() + 1) {
+    return std::nullopt;
+  }
+  return prim_func;
+}
+
+// Check that the output of a call_tir can be written into one of its arguments: the PrimFunc must
+// be elementwise on it, and on any other argument that may alias it.
+bool IsElementwiseOnAliases(const tir::PrimFunc& func, const ffi::Array<Expr>& args,
+                            int candidate,
+                            const std::unordered_map<Var, std::unordered_set<int>>& alias_sets) {
+  int output_idx = static_cast<int>(args.size());
+  auto alias_set = [&](const Expr& arg) -> std::unordered_set<int> {
+    if (auto var = arg.as<Var>(); var && alias_sets.count(var.value())) {
+      return alias_sets.at(var.value());
+    }
+    return {};
+  };
+  auto candidate_aliases = alias_set(args[candidate]);
+  for (int k = 0; k < static_cast<int>(args.size()); ++k) {
+    bool may_alias = k == candidate || args[k].same_as(args[candidate]);
+    for (int idx : alias_set(args[k])) {
+      may_alias = may_alias || candidate_aliases.count(idx);
+    }
+    if (may_alias && !ElementwiseInputChecker::Check(func, k, output_idx)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*! \brief Corresponds to a binding where at least one argument meets the conditions to be
  *  made in-place. Contains the binding index and indices of the applicable arguments
  */
@@ -561,15 +837,14 @@ class InplaceOpportunity : public ObjectRef {
 // For both lists, each element is a list of ints of the following format:
 //   The first element is the index of the *binding* in the block.
 //   All remaining elements are the indices of *eligible arguments* in that call.
+// The calls considered are those to the supported ops, and the call_tir to a PrimFunc which
+// computes its output elementwise from the arguments (see ElementwiseInputChecker).
 std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>>
-FindInplaceOpportunities(const DataflowBlock& block, const ffi::Array<Var>& inputs,
-                         const BlockBuilder& ctx) {
-  auto live_ranges = AnalyzeLiveness(block);
-  AliasAnalyzer analyzer;
-  auto alias_info = analyzer.Analyze(block, inputs);
-  auto alias_sets = alias_info.first;
-  auto tuple_map = alias_info.second;
-
+FindInplaceOpportunities(
+    const DataflowBlock& block, std::unordered_map<Var, std::pair<int, int>> live_ranges,
+    const std::unordered_map<Var, std::unordered_set<int>>& alias_sets,
+    const std::unordered_map<int, std::vector<std::unordered_set<int>>>& tuple_map,
+    const BlockBuilder& ctx) {
   std::vector<InplaceOpportunity> size_match_list;
   std::vector<InplaceOpportunity> exact_match_list;
 
@@ -617,7 +892,11 @@ FindInplaceOpportunities(const DataflowBlock& block, const ffi::Array<Var>& inpu
 
     if (auto* call_node = value.as<CallNode>()) {
       if (auto* op_node = call_node->op.as<OpNode>()) {
-        if (!OpSupportsInplace(ffi::GetRef<Op>(op_node))) {
+        ffi::Array<Expr> args = call_node->args;
+        auto prim_func = InplaceCandidatePrimFunc(call_node, ctx->GetContextIRModule());
+        if (prim_func) {
+          args = Downcast<Tuple>(call_node->args[1])->fields;
+        } else if (!OpSupportsInplace(ffi::GetRef<Op>(op_node))) {
           continue;
         }
 
@@ -631,8 +910,8 @@ FindInplaceOpportunities(const DataflowBlock& block, const ffi::Array<Var>& inpu
         }
 
         // Check that at least one argument matches size with the result
-        for (size_t j = 0; j < call_node->args.size(); j++) {
-          auto arg = call_node->args[j];
+        for (size_t j = 0; j < args.size(); j++) {
+          auto arg = args[j];
           for (auto target : target_sinfo) {
             auto [matches_size, matches_exactly] = SizeMatches(target, GetStructInfo(arg), ctx);
             if (matches_size) {
@@ -652,7 +931,10 @@ FindInplaceOpportunities(const DataflowBlock& block, const ffi::Array<Var>& inpu
         std::unordered_set<int> remove_candidates;
         for (auto candidate : candidates) {
           if (!InplaceConditionsMet(live_ranges, alias_sets, tuple_map, currently_live,
-                                    call_node->args[candidate], i)) {
+                                    args[candidate], i)) {
+            remove_candidates.insert(candidate);
+          } else if (prim_func &&
+                     !IsElementwiseOnAliases(prim_func.value(), args, candidate, alias_sets)) {
             remove_candidates.insert(candidate);
           }
         }
@@ -692,6 +974,15 @@ FindInplaceOpportunities(const DataflowBlock& block, const ffi::Array<Var>& inpu
   return {size_match_list, exact_match_list};
 }
 
+std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>>
+FindInplaceOpportunities(const DataflowBlock& block, const ffi::Array<Var>& inputs,
+                         const BlockBuilder& ctx) {
+  auto live_ranges = AnalyzeLiveness(block);
+  AliasAnalyzer analyzer(ctx->GetContextIRModule());
+  auto [alias_sets, tuple_map] = analyzer.Analyze(block, inputs);
+  return FindInplaceOpportunities(block, live_ranges, alias_sets, tuple_map, ctx);
+}
+
 // Replace buffers in a PrimFunc according to the mapping.
 tir::Stmt RemapBuffers(const tir::Stmt& stmt,
                        const ffi::Map<tir::Buffer, tir::Buffer>& buffer_map) {
@@ -800,9 +1091,69 @@ class ModuleInplaceTransformer : public ExprMutator {
 
   Expr VisitExpr_(const FunctionNode* op) override {
     auto old_func_params = func_params;
+    auto old_block_analyses = block_analyses_;
     func_params = op->params;
+    block_analyses_ = AnalyzeFunctionBlocks(ffi::GetRef<Function>(op));
     auto ret = ExprMutator::VisitExpr_(op);
     func_params = old_func_params;
+    block_analyses_ = old_block_analyses;
+    return ret;
+  }
+
+  // The liveness and alias analyses of a dataflow block, in the context of its function.
+  struct BlockAnalysis {
+    std::unordered_map<Var, std::pair<int, int>> live_ranges;
+    std::unordered_map<Var, std::unordered_set<int>> alias_sets;
+    std::unordered_map<int, std::vector<std::unordered_set<int>>> tuple_map;
+  };
+
+  // Analyze the dataflow blocks of the body of a function together, so that the outputs of a block
+  // which are not used after it can be overwritten in it, and the values computed in the previous
+  // blocks can be overwritten as well.
+  std::unordered_map<const DataflowBlockNode*, BlockAnalysis> AnalyzeFunctionBlocks(
+      const Function& func) {
+    std::unordered_map<const DataflowBlockNode*, BlockAnalysis> ret;
+    const auto* seq = func->body.as<SeqExprNode>();
+    if (seq == nullptr) {
+      return ret;
+    }
+    // The function params are not passed as inputs, as we can't make any assumptions about them.
+    AliasAnalyzer analyzer(mod_);
+    auto [alias_sets, tuple_map] = analyzer.Analyze(seq->blocks, {});
+
+    int num_blocks = seq->blocks.size();
+    std::vector<std::unordered_set<Var>> used_after(num_blocks);
+    std::unordered_set<Var> used;
+    for (const Var& var : AllVars(seq->body)) {
+      used.insert(var);
+    }
+    for (int i = num_blocks - 1; i >= 0; --i) {
+      used_after[i] = used;
+      for (const Binding& binding : seq->blocks[i]->bindings) {
+        for (const Var& var : AllVars(GetBoundValue(binding))) {
+          used.insert(var);
+        }
+      }
+    }
+
+    std::unordered_set<Var> defined_before(func->params.begin(), func->params.end());
+    for (int i = 0; i < num_blocks; ++i) {
+      const BindingBlock& block = seq->blocks[i];
+      if (const auto* dataflow_block = block.as<DataflowBlockNode>()) {
+        std::unordered_set<Var> live_through;
+        for (const Var& var : used_after[i]) {
+          if (defined_before.count(var)) {
+            live_through.insert(var);
+          }
+        }
+        ret[dataflow_block] = {AnalyzeLiveness(Downcast<DataflowBlock>(block), &used_after[i],
+                                               &live_through),
+                               alias_sets, tuple_map};
+      }
+      for (const Binding& binding : block->bindings) {
+        defined_before.insert(binding->var);
+      }
+    }
     return ret;
   }
 
@@ -815,7 +1166,15 @@ class ModuleInplaceTransformer : public ExprMutator {
     // For now, only handle exact match cases.
     // Note: Not passing any input values for now, as we can't make any assumptions
     // about them.
-    auto matches_found = FindInplaceOpportunities(block, {}, builder_);
+    std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>> matches_found;
+    if (auto it = block_analyses_.find(op); it != block_analyses_.end()) {
+      const BlockAnalysis& analysis = it->second;
+      matches_found = FindInplaceOpportunities(block, analysis.live_ranges, analysis.alias_sets,
+                                               analysis.tuple_map, builder_);
+    } else {
+      // a nested block, e.g. in a branch, is analyzed on its own
+      matches_found = FindInplaceOpportunities(block, {}, builder_);
+    }
     ffi::Map<Binding, ffi::Array<Integer>> new_idxs;
     for (auto match : matches_found.second) {
       new_idxs.Set(block->bindings[match->binding_idx.IntValue()], match->arg_idxs);
@@ -864,14 +1223,22 @@ class ModuleInplaceTransformer : public ExprMutator {
     static const auto& legalize_map = Op::GetAttrMap<FLegalize>("FLegalize");
     static const auto& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
 
+    static const auto& call_tir_op = Op::Get("relax.call_tir");
+
+    // A call_tir is rewritten directly, other ops are legalized to one first.
     auto op = Downcast<Op>(call->op);
-    auto legalized_call = Downcast<Call>(legalize_map[op](builder_, call));
+    Call legalized_call = call;
+    if (!op.same_as(call_tir_op)) {
+      legalized_call = Downcast<Call>(legalize_map[op](builder_, call));
+    }
     auto* legalized_call_cow = legalized_call.CopyOnWrite();
 
     // The legalized call should be call_tir. We will replace it with call_tir_inplace
     // and replace the called PrimFunc with an inplace version
     auto legal_op = Downcast<GlobalVar>(legalized_call->args[0]);
-    legalizers_added.push_back(legal_op);
+    if (!op.same_as(call_tir_op)) {
+      legalizers_added.push_back(legal_op);
+    }
     auto inline_legal_op_name = legal_op->name_hint + "_inplace";
 
     auto mod = builder_->GetContextIRModule();
@@ -927,6 +1294,8 @@ class ModuleInplaceTransformer : public ExprMutator {
 
     tir::PrimFunc new_primfunc(new_params, new_body, old_primfunc->ret_type, new_buffer_map,
                                old_primfunc->attrs, old_primfunc->span);
+    // the PrimFunc of a call_tir may be public, its in-place version is private
+    new_primfunc = WithoutAttr(std::move(new_primfunc), tvm::attr::kGlobalSymbol);
 
     // note: this might be a good time to get rid of the old legalized function, but we don't do it
     // now because later ops might need the same one. Instead, we will clean up at the end
@@ -953,6 +1322,8 @@ class ModuleInplaceTransformer : public ExprMutator {
   const IRModule& mod_;
   // Keep track of legalizers we add so we can clean up at the end.
   ffi::Array<GlobalVar> legalizers_added;
+  // The analyses of the top-level dataflow blocks of the current function.
+  std::unordered_map<const DataflowBlockNode*, BlockAnalysis> block_analyses_;
   // The current function's params will be treated as non-aliased
   // (we are assuming good behavior on the user's part).
   ffi::Array<Var> func_params;
@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/decompose_collective_matmul.cc
+ * \brief Decompose the allreduce of the output of a row-parallel matmul into chunks of rows, so
+ *  that the communication of each chunk overlaps the matmul of the next ones.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/ccl.h>
+#include <tvm/relax/attrs/linear_algebra.h>
+#include <tvm/relax/block_builder.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../op/ccl/ccl.h"
+#include "../op/tensor/linear_algebra.h"
+#include "../op/tensor/manipulate.h"
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*!
+ * \brief Rewrite each `y = ccl.allreduce(matmul(x, w))` of a dataflow block, whose matmul output
+ * has no other use, into
+ *
+ *   x_chunks = split(x, num_chunks, axis=-2)
+ *   y_0 = matmul(x_chunks[0], w)
+ *   y_0_pending = ccl.allreduce_start(y_0)
+ *   y_1 = matmul(x_chunks[1], w)
+ *   y_1_pending = ccl.allreduce_start(y_1)
+ *   ...
+ *   y = concat([ccl.allreduce_wait(y_0_pending, y_0), ...], axis=-2)
+ *
+ * The allreduce of each chunk runs on the communication stream while the compute stream runs
+ * the matmul of the next chunk, and only the allreduce of the last chunk is exposed.
+ */
+class CollectiveMatmulDecomposer {
+ public:
+  CollectiveMatmulDecomposer(const BlockBuilder& bb, int num_chunks)
+      : bb_(bb), num_chunks_(num_chunks) {}
+
+  DataflowBlock Decompose(const DataflowBlock& block) {
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    static const Op& allreduce_op = Op::Get("relax.ccl.allreduce");
+
+    // Step 1. Find the matmuls whose only use is an allreduce.
+    std::unordered_map<const VarNode*, Call> matmuls;
+    std::unordered_map<const VarNode*, int> num_uses;
+    for (const Binding& binding : block->bindings) {
+      Expr value = GetBoundValue(binding);
+      for (const Var& var : FreeVars(value)) {
+        ++num_uses[var.get()];
+      }
+      const auto* call = value.as<CallNode>();
+      if (binding->IsInstance<VarBindingNode>() && binding->var->IsInstance<DataflowVarNode>() &&
+          call && call->op.same_as(matmul_op) && IsDecomposable(ffi::GetRef<Call>(call))) {
+        matmuls.emplace(binding->var.get(), ffi::GetRef<Call>(call));
+      }
+    }
+    std::unordered_set<const VarNode*> decomposed;
+    for (const Binding& binding : block->bindings) {
+      const auto* call = GetBoundValue(binding).as<CallNode>();
+      if (call && call->op.same_as(allreduce_op) && call->args[0]->IsInstance<VarNode>()) {
+        const auto* arg = call->args[0].as<VarNode>();
+        if (matmuls.count(arg) && num_uses[arg] == 1) {
+          decomposed.insert(arg);
+        }
+      }
+    }
+    if (decomposed.empty()) {
+      return block;
+    }
+
+    // Step 2. Emit the chunks in place of the allreduce, and drop the matmul.
+    ffi::Array<Binding> new_bindings;
+    for (const Binding& binding : block->bindings) {
+      if (decomposed.count(binding->var.get())) {
+        continue;
+      }
+      const auto* call = GetBoundValue(binding).as<CallNode>();
+      if (call && call->op.same_as(allreduce_op) && call->args[0]->IsInstance<VarNode>() &&
+          decomposed.count(call->args[0].as<VarNode>())) {
+        const auto* attrs = call->attrs.as<AllReduceAttrs>();
+        ICHECK(attrs != nullptr);
+        EmitChunks(&new_bindings, binding->var, matmuls.at(call->args[0].as<VarNode>()), attrs);
+      } else {
+        new_bindings.push_back(binding);
+      }
+    }
+    return DataflowBlock(new_bindings, block->span);
+  }
+
+ private:
+  /*! \brief Check if the rows of the lhs of a matmul split evenly into the chunks. */
+  bool IsDecomposable(const Call& matmul_call) const {
+    const auto* x_sinfo = GetStructInfoAs<TensorStructInfoNode>(matmul_call->args[0]);
+    const auto* w_sinfo = GetStructInfoAs<TensorStructInfoNode>(matmul_call->args[1]);
+    if (x_sinfo == nullptr || w_sinfo == nullptr || x_sinfo->ndim < 2 || w_sinfo->ndim != 2) {
+      return false;
+    }
+    const auto* x_shape = x_sinfo->shape.as<ShapeExprNode>();
+    if (x_shape == nullptr) {
+      return false;
+    }
+    const auto* num_rows = x_shape->values[x_sinfo->ndim - 2].as<IntImmNode>();
+    return num_rows != nullptr && num_rows->value >= num_chunks_ &&
+           num_rows->value % num_chunks_ == 0;
+  }
+
+  DataflowVar EmitBinding(ffi::Array<Binding>* bindings, const Expr& value,
+                          const std::string& name) {
+    Expr normalized = bb_->Normalize(value);
+    DataflowVar var(name, GetStructInfo(normalized));
+    bindings->push_back(VarBinding(var, normalized));
+    return var;
+  }
+
+  void EmitChunks(ffi::Array<Binding>* bindings, const Var& output, const Call& matmul_call,
+                  const AllReduceAttrs* attrs) {
+    const auto* matmul_attrs = matmul_call->attrs.as<MatmulAttrs>();
+    ICHECK(matmul_attrs != nullptr);
+    const Expr& lhs = matmul_call->args[0];
+    const Expr& rhs = matmul_call->args[1];
+    int axis = GetStructInfoAs<TensorStructInfoNode>(lhs)->ndim - 2;
+    std::string name = output->name_hint();
+    Var chunks = EmitBinding(bindings, split(lhs, IntImm(DataType::Int(64), num_chunks_), axis),
+                             name + "_lhs_chunks");
+    std::vector<Var> partials, pendings;
+    for (int i = 0; i < num_chunks_; ++i) {
+      std::string chunk_name = name + "_" + std::to_string(i);
+      Var chunk = EmitBinding(bindings, TupleGetItem(chunks, i), chunk_name + "_lhs");
+      Var partial =
+          EmitBinding(bindings, matmul(chunk, rhs, matmul_attrs->out_dtype), chunk_name);
+      partials.push_back(partial);
+      pendings.push_back(EmitBinding(
+          bindings, allreduce_start(partial, attrs->op_type, attrs->in_group),
+          chunk_name + "_pending"));
+    }
+    ffi::Array<Expr> reduced;
+    for (int i = 0; i < num_chunks_; ++i) {
+      reduced.push_back(EmitBinding(bindings, allreduce_wait(pendings[i], partials[i]),
+                                    name + "_" + std::to_string(i) + "_reduced"));
+    }
+    Expr concatenated = bb_->Normalize(concat(Tuple(reduced), axis));
+    bindings->push_back(VarBinding(output, concatenated));
+  }
+
+  BlockBuilder bb_;
+  int num_chunks_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass DecomposeCollectiveMatmul(int num_chunks) {
+  CHECK_GE(num_chunks, 2) << "ValueError: DecomposeCollectiveMatmul needs at least 2 chunks, "
+                          << "but got " << num_chunks;
+  auto pass_func = [=](DataflowBlock block, IRModule mod, PassContext pc) {
+    return CollectiveMatmulDecomposer(BlockBuilder::Create(mod), num_chunks).Decompose(block);
+  };
+  return CreateDataflowBlockPass(pass_func, 1, "DecomposeCollectiveMatmul", {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.DecomposeCollectiveMatmul", DecomposeCollectiveMatmul);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/deduplicate_prim_funcs.cc
+ * \brief Merge the structurally equal PrimFuncs of a module.
+ *
+ * FuseTIR and LegalizeOps produce a PrimFunc per call site, so that the layers of a deep model
+ * each carry their own copy of the same kernels, which are then compiled separately. This pass
+ * keeps a single PrimFunc of each group of structurally equal private PrimFuncs, found through a
+ * structural hash index, and redirects the calls of the others to it.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/ir/module.h>
+#include <tvm/ir/replace_global_vars.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+namespace transform {
+
+Pass DeduplicatePrimFuncs() {
+  auto pass_func = [=](IRModule mod, PassContext pc) {
+    // The PrimFuncs with a global symbol are exposed, and may be called by their name.
+    std::vector<std::pair<GlobalVar, tir::PrimFunc>> prim_funcs;
+    for (const auto& [gvar, func] : mod->functions) {
+      if (auto prim_func = func.as<tir::PrimFunc>()) {
+        if (!prim_func.value()->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol).has_value()) {
+          prim_funcs.emplace_back(gvar, prim_func.value());
+        }
+      }
+    }
+    // Visit the functions by name, so that the function kept of each group is deterministic.
+    std::sort(prim_funcs.begin(), prim_funcs.end(), [](const auto& a, const auto& b) {
+      return a.first->name_hint < b.first->name_hint;
+    });
+
+    std::unordered_map<tir::PrimFunc, GlobalVar, StructuralHash, StructuralEqual> canonical;
+    ffi::Map<GlobalVar, GlobalVar> replacements;
+    for (const auto& [gvar, prim_func] : prim_funcs) {
+      auto [it, inserted] = canonical.emplace(prim_func, gvar);
+      if (!inserted) {
+        replacements.Set(gvar, it->second);
+      }
+    }
+    if (replacements.empty()) {
+      return mod;
+    }
+
+    auto* write_ptr = mod.CopyOnWrite();
+    for (const auto& kv : replacements) {
+      write_ptr->Remove(kv.first);
+    }
+    return tvm::transform::ReplaceGlobalVars(mod, replacements);
+  };
+  return CreateModulePass(pass_func, 0, "DeduplicatePrimFuncs", {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.DeduplicatePrimFuncs", DeduplicatePrimFuncs);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/dispatch_dynamic_matmul_to_library.cc
+ * \brief Dispatch the matmuls of dynamic shapes to either their TIR kernel or a vendor library
+ *  at runtime.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/attrs/linear_algebra.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+
+namespace tvm {
+namespace relax {
+
+class DynamicMatmulDispatcher : public ExprMutator {
+ public:
+  static IRModule Dispatch(IRModule mod, ffi::String library) {
+    return DynamicMatmulDispatcher(mod, library).Dispatch();
+  }
+
+ private:
+  explicit DynamicMatmulDispatcher(IRModule mod, ffi::String library)
+      : ExprMutator(mod), library_(library) {}
+
+  IRModule Dispatch() {
+    auto mod = builder_->GetContextIRModule();
+    for (const auto& [gv, base_func] : mod->functions) {
+      const auto* func_ = base_func.as<FunctionNode>();
+      if (func_ == nullptr || func_->HasNonzeroAttr(attr::kPrimitive)) {
+        continue;
+      }
+      Expr new_func_body = VisitExpr(func_->body);
+      auto new_func = ffi::make_object<FunctionNode>(*func_);
+      new_func->body = new_func_body;
+      builder_->UpdateFunction(gv, Function(new_func));
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  using ExprMutator::VisitExpr_;
+  Expr VisitExpr_(const CallNode* op) final {
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    if (!call->op.same_as(matmul_op)) {
+      return call;
+    }
+    const auto* a_sinfo = GetStructInfoAs<TensorStructInfoNode>(call->args[0]);
+    const auto* b_sinfo = GetStructInfoAs<TensorStructInfoNode>(call->args[1]);
+    const auto* out_sinfo = GetStructInfoAs<TensorStructInfoNode>(call);
+    if (a_sinfo == nullptr || b_sinfo == nullptr || out_sinfo == nullptr) {
+      return call;
+    }
+    // The libraries run the 2D GEMMs of float operands into an output of the same dtype.
+    DataType dtype = a_sinfo->dtype;
+    if (a_sinfo->ndim != 2 || b_sinfo->ndim != 2 || !dtype.is_float() ||
+        (dtype.bits() != 16 && dtype.bits() != 32) || b_sinfo->dtype != dtype ||
+        out_sinfo->dtype != dtype) {
+      return call;
+    }
+    // The static GEMMs are tuned at compile time.
+    ffi::Optional<ffi::Array<PrimExpr>> shape = out_sinfo->GetShape();
+    ffi::Optional<ffi::Array<PrimExpr>> a_shape = a_sinfo->GetShape();
+    if (!shape.defined() || !a_shape.defined()) {
+      return call;
+    }
+    bool is_dynamic = !a_shape.value()[1]->IsInstance<IntImmNode>();
+    for (const PrimExpr& dim : shape.value()) {
+      is_dynamic |= !dim->IsInstance<IntImmNode>();
+    }
+    if (!is_dynamic) {
+      return call;
+    }
+
+    static const auto& legalize_map = Op::GetAttrMap<FLegalize>("FLegalize");
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    if (!legalize_map.count(matmul_op)) {
+      return call;
+    }
+    Expr legalized = legalize_map[matmul_op](builder_, call);
+    const auto* tir_call = legalized.as<CallNode>();
+    if (tir_call == nullptr || !tir_call->op.same_as(call_tir_op) || tir_call->args.size() != 2) {
+      return call;
+    }
+    static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+    return Call(call_dps_packed_op,
+                {ExternFunc("vm.builtin.gemm_library_dispatch"),
+                 Tuple({StringImm(library_), tir_call->args[0], call->args[0], call->args[1]})},
+                Attrs(), {GetStructInfo(call)});
+  }
+
+  /*! \brief The library the GEMMs can run with, e.g. "cublas". */
+  ffi::String library_;
+};
+
+namespace transform {
+
+Pass DispatchDynamicMatmulToLibrary(ffi::String library) {
+  auto pass_func = [=](IRModule m, PassContext pc) {
+    return DynamicMatmulDispatcher::Dispatch(m, library);
+  };
+  return CreateModulePass(pass_func, 0, "DispatchDynamicMatmulToLibrary", {});
+}
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.DispatchDynamicMatmulToLibrary",
+                        DispatchDynamicMatmulToLibrary);
+}
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
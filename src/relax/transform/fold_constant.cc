@@ -28,19 +28,235 @@
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "../../support/utils.h"
+
 namespace tvm {
 namespace relax {
 
+/*!
+ * \brief Collect the PrimFuncs of the call_tir that may be folded, i.e. whose arguments are
+ * constants or the results of such calls, so that they are built together.
+ */
+class FoldableCallCollector : public ExprVisitor {
+ public:
+  static std::vector<tir::PrimFunc> Collect(const Function& func, const IRModule& mod) {
+    FoldableCallCollector collector(mod);
+    collector.VisitExpr(func);
+    return std::move(collector.funcs_);
+  }
+
+ private:
+  explicit FoldableCallCollector(const IRModule& mod) : mod_(mod) {}
+
+  void VisitBinding_(const VarBindingNode* binding, const ConstantNode* val) final {
+    constant_vars_.insert(binding->var.get());
+  }
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    ExprVisitor::VisitBinding_(binding, call);
+    if (!call->op.same_as(call_tir_op) || call->args.size() < 2) return;
+    const auto* gvar = call->args[0].as<GlobalVarNode>();
+    const auto* args = call->args[1].as<TupleNode>();
+    if (gvar == nullptr || args == nullptr) return;
+    for (const Expr& arg : args->fields) {
+      if (!arg->IsInstance<ConstantNode>() && !constant_vars_.count(arg.get())) return;
+    }
+    ffi::Optional<BaseFunc> base_func = mod_->functions.Get(ffi::GetRef<GlobalVar>(gvar));
+    if (const auto* func = base_func.as<tir::PrimFuncNode>()) {
+      constant_vars_.insert(binding->var.get());
+      if (visited_funcs_.insert(func).second) {
+        funcs_.push_back(ffi::GetRef<tir::PrimFunc>(func));
+      }
+    }
+  }
+
+  const IRModule& mod_;
+  /*! \brief The vars bound to constants, or to the results of the foldable calls. */
+  std::unordered_set<const Object*> constant_vars_;
+  std::unordered_set<const Object*> visited_funcs_;
+  std::vector<tir::PrimFunc> funcs_;
+};
+
+/*!
+ * \brief The builds and the results of the folded PrimFuncs, shared by the functions of a module
+ * and by the runs of the same FoldConstant pass.
+ */
+class ConstantFoldingCache {
+ public:
+  /*!
+   * \brief Build the PrimFuncs a function may fold and not built yet, in a single module.
+   * \note If the batch fails to build, e.g. as one of the functions only works on GPU, the
+   * functions are left to be built one by one.
+   */
+  void BuildFoldable(const Function& func, const IRModule& mod) {
+    std::vector<tir::PrimFunc> funcs;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const tir::PrimFunc& prim_func : FoldableCallCollector::Collect(func, mod)) {
+        if (!func_build_cache_.count(prim_func)) funcs.push_back(prim_func);
+      }
+    }
+    if (funcs.size() < 2) return;
+
+    IRModule batch;
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < funcs.size(); ++i) {
+      symbols.push_back("tir_function_" + std::to_string(i));
+      batch->Add(GlobalVar(symbols.back()),
+                 WithAttr(funcs[i], tvm::attr::kGlobalSymbol, ffi::String(symbols.back())));
+    }
+    try {
+      const auto pf = tvm::ffi::Function::GetGlobalRequired("tir.build");
+      ffi::Module rt_module = pf(batch, Target("llvm")).cast<ffi::Module>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < funcs.size(); ++i) {
+        func_build_cache_[funcs[i]] = rt_module->GetFunction(symbols[i]);
+      }
+    } catch (const tvm::Error& err) {
+      DLOG(WARNING) << "Batched build failure of " << funcs.size()
+                    << " functions, build them one by one. Error message: " << err.what();
+    }
+  }
+
+  /*!
+   * \brief Get a cached build version of func
+   * \return The cached func, nullopt if func cannot be built.
+   */
+  ffi::Optional<ffi::Function> GetBuild(tir::PrimFunc func) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = func_build_cache_.find(func);
+      if (it != func_build_cache_.end()) {
+        return it->second;
+      }
+    }
+    ffi::Optional<ffi::Function> build_func = std::nullopt;
+    try {
+      // Not all the primfunc can be directly built via llvm, for example, if a function is
+      // already scheduled to only work on GPU, we will need to skip this in the const folder for
+      // now
+      // TODO(Hongyi): further check and narrow the scope of foldable function
+      const auto pf = tvm::ffi::Function::GetGlobalRequired("tir.build");
+      tir::PrimFunc named = WithAttr(func, tvm::attr::kGlobalSymbol, ffi::String("tir_function"));
+      ffi::Module rt_module = pf(named, Target("llvm")).cast<ffi::Module>();
+      build_func = rt_module->GetFunction("tir_function");
+    } catch (const tvm::Error& err) {
+      // build failure may happen in which case we skip
+      DLOG(WARNING) << "Build failure for function " << func << ", Error message: " << err.what();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    func_build_cache_[func] = build_func;
+    return build_func;
+  }
+
+  /*! \brief Look up the result of a call folded before, with the same function and arguments. */
+  ffi::Optional<runtime::Tensor> LookupResult(const tir::PrimFunc& func,
+                                              const ffi::Array<runtime::Tensor>& args,
+                                              const ffi::Shape& shape, DataType dtype) {
+    std::optional<uint64_t> key = HashCall(func, args, shape, dtype);
+    if (!key.has_value()) return std::nullopt;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = results_.find(key.value());
+    if (it == results_.end()) return std::nullopt;
+    for (const FoldedCall& entry : it->second) {
+      if (entry.args.size() != args.size() || !SameTensor(entry.result, shape, dtype) ||
+          !StructuralEqual()(entry.func, func)) {
+        continue;
+      }
+      bool same_args = true;
+      for (size_t i = 0; i < args.size() && same_args; ++i) {
+        same_args = SameTensorData(entry.args[i], args[i]);
+      }
+      if (same_args) return entry.result;
+    }
+    return std::nullopt;
+  }
+
+  /*! \brief Record the result of a folded call. */
+  void AddResult(const tir::PrimFunc& func, const ffi::Array<runtime::Tensor>& args,
+                 runtime::Tensor result) {
+    std::optional<uint64_t> key = HashCall(func, args, result.Shape(), result.DataType());
+    if (!key.has_value()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    results_[key.value()].push_back(FoldedCall{func, args, std::move(result)});
+  }
+
+ private:
+  struct FoldedCall {
+    tir::PrimFunc func;
+    ffi::Array<runtime::Tensor> args;
+    runtime::Tensor result;
+  };
+
+  static bool IsHashable(const runtime::Tensor& tensor) {
+    return tensor->device.device_type == kDLCPU && tensor.IsContiguous();
+  }
+
+  static std::string_view TensorBytes(const runtime::Tensor& tensor) {
+    return std::string_view(static_cast<const char*>(tensor->data) + tensor->byte_offset,
+                            runtime::GetDataSize(*tensor.operator->()));
+  }
+
+  static bool SameTensor(const runtime::Tensor& tensor, const ffi::Shape& shape, DataType dtype) {
+    if (tensor.DataType() != dtype || tensor->ndim != static_cast<int>(shape.size())) {
+      return false;
+    }
+    return std::equal(shape.begin(), shape.end(), tensor->shape);
+  }
+
+  static bool SameTensorData(const runtime::Tensor& a, const runtime::Tensor& b) {
+    return SameTensor(a, b.Shape(), b.DataType()) && TensorBytes(a) == TensorBytes(b);
+  }
+
+  /*! \brief Hash a call by the structure of the function and the contents of the arguments. */
+  static std::optional<uint64_t> HashCall(const tir::PrimFunc& func,
+                                          const ffi::Array<runtime::Tensor>& args,
+                                          const ffi::Shape& shape, DataType dtype) {
+    uint64_t key = StructuralHash()(func);
+    for (const runtime::Tensor& arg : args) {
+      if (!IsHashable(arg)) return std::nullopt;
+      key = support::HashCombine(key, std::hash<std::string_view>()(TensorBytes(arg)));
+      for (int64_t dim : arg.Shape()) {
+        key = support::HashCombine(key, dim);
+      }
+    }
+    for (int64_t dim : shape) {
+      key = support::HashCombine(key, dim);
+    }
+    key = support::HashCombine(key, dtype.code());
+    key = support::HashCombine(key, dtype.bits());
+    return support::HashCombine(key, dtype.lanes());
+  }
+
+  std::mutex mutex_;
+  // cache for function build, via structural equality
+  std::unordered_map<tir::PrimFunc, ffi::Optional<ffi::Function>, StructuralHash, StructuralEqual>
+      func_build_cache_;
+  // cache for the folded calls, via the hash of the function and the arguments
+  std::unordered_map<uint64_t, std::vector<FoldedCall>> results_;
+};
+
 class ConstantFolder : public ExprMutator {
  public:
-  static Function Fold(Function func, IRModule ctx_module) {
-    ConstantFolder folder(std::move(ctx_module));
+  static Function Fold(Function func, IRModule ctx_module, ConstantFoldingCache* cache) {
+    ConstantFolder folder(std::move(ctx_module), cache);
     func = Downcast<Function>(RemoveAllUnused(folder(func)));
     return func;
   }
 
  private:
-  explicit ConstantFolder(IRModule ctx_module) : ExprMutator(ctx_module) {}
+  explicit ConstantFolder(IRModule ctx_module, ConstantFoldingCache* cache)
+      : ExprMutator(ctx_module), cache_(cache) {}
 
   /*!
    * \brief Pattern match the shape inside the given struct info to a
@@ -98,38 +314,6 @@ class ConstantFolder : public ExprMutator {
     return std::nullopt;
   }
 
-  /*!
-   * \brief Get a cached build version of func
-   * \return The cached func, nullopt if func cannot be built.
-   */
-  ffi::Optional<ffi::Function> GetCachedBuild(tir::PrimFunc func) {
-    // TODO(tvm-team): consider another way of bulk extract and build PrimFunc once
-    // would be helpful for future cases where PrimFunc recursively call into each other
-    Target eval_cpu_target{"llvm"};
-
-    auto it = func_build_cache_.find(func);
-    if (it != func_build_cache_.end()) {
-      return it->second;
-    }
-    ffi::Optional<ffi::Function> build_func = std::nullopt;
-
-    try {
-      // Not all the primfunc can be directly built via llvm, for example, if a function is
-      // already scheduled to only work on GPU, we will need to skip this in the const folder for
-      // now
-      // TODO(Hongyi): further check and narrow the scope of foldable function
-      const auto pf = tvm::ffi::Function::GetGlobalRequired("tir.build");
-      func = WithAttr(func, tvm::attr::kGlobalSymbol, ffi::String("tir_function"));
-      ffi::Module rt_module = pf(func, eval_cpu_target).cast<ffi::Module>();
-      build_func = rt_module->GetFunction("tir_function");
-    } catch (const tvm::Error& err) {
-      // build failure may happen in which case we skip
-      DLOG(WARNING) << "Build failure for function " << func << ", Error message: " << err.what();
-    }
-    func_build_cache_[func] = build_func;
-    return build_func;
-  }
-
   /*!
    * \brief Checks if it is useful to fold \p expr.
    * \details Folding an expr is a trade-off - we are materializing a constant in the IRModule and
@@ -148,8 +332,12 @@ class ConstantFolder : public ExprMutator {
   ffi::Optional<Expr> ConstEvaluateCallTIR(tir::PrimFunc tir_func,
                                            ffi::Array<runtime::Tensor> arr_args, ffi::Shape shape,
                                            DataType ret_type) {
+    if (ffi::Optional<runtime::Tensor> folded =
+            cache_->LookupResult(tir_func, arr_args, shape, ret_type)) {
+      return Constant(folded.value());
+    }
     // obtain function from the cache.
-    ffi::Optional<ffi::Function> func = GetCachedBuild(tir_func);
+    ffi::Optional<ffi::Function> func = cache_->GetBuild(tir_func);
     if (!func) return std::nullopt;
 
     // here the vector size has an additional + 1 because we need to put ret_tensor at the end
@@ -172,6 +360,7 @@ class ConstantFolder : public ExprMutator {
     ffi::Any ret;
     // invoke
     func.value().CallPacked(ffi::PackedArgs(packed_args.data(), packed_args.size()), &ret);
+    cache_->AddResult(tir_func, arr_args, ret_tensor);
     return Constant(ret_tensor);
   }
 
@@ -316,16 +505,17 @@ class ConstantFolder : public ExprMutator {
     return ExprMutator::VisitExpr_(op);
   }
 
-  // cache for function build, via structural equality
-  std::unordered_map<tir::PrimFunc, ffi::Optional<ffi::Function>, StructuralHash, StructuralEqual>
-      func_build_cache_;
+  /*! \brief The builds and the results shared with the other functions. */
+  ConstantFoldingCache* cache_;
 };
 
 namespace transform {
 
 Pass FoldConstant() {
+  auto cache = std::make_shared<ConstantFoldingCache>();
   auto pass_func = [=](Function f, IRModule m, PassContext pc) {
-    return ConstantFolder::Fold(f, m);
+    cache->BuildFoldable(f, m);
+    return ConstantFolder::Fold(f, m, cache.get());
   };
   return CreateFunctionPass(pass_func, 0, "FoldConstant", {});
 }
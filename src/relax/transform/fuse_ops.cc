@@ -34,11 +34,14 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/struct_info.h>
 #include <tvm/relax/transform.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/expr_functor.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <optional>
+#include <string>
 
 #include "../../support/arena.h"
 #include "../analysis/graph_partitioner.h"
@@ -98,6 +101,7 @@ using support::LinkNode;
 constexpr uint32_t kMaxFusedOps = 256;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.max_depth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.policy", ffi::String);
 
 class GraphCreator : public ExprVisitor {
  public:
@@ -1038,15 +1042,158 @@ class OperatorFusor : public ExprMutator {
   bool lift_constants_{true};
 };
 
-IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth) {
+/*!
+ * \brief Estimate the cost of the nodes of the fusion graph, from the FLOPs of the PrimFuncs they
+ *  call and the sizes of the tensors they read and write.
+ * \note The symbolic dimensions of the tensors are not counted.
+ */
+class FusionCostEstimator {
+ public:
+  explicit FusionCostEstimator(const IRModule& mod)
+      : mod_(mod), var2value_(AnalyzeVar2Value(mod)) {}
+
+  NodeCost operator()(const IndexedForwardGraph::Node* node) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const Op& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
+    NodeCost cost;
+    const auto* var = ffi::GetRef<ObjectRef>(node->ref).as<VarNode>();
+    if (var == nullptr) return cost;
+    auto it = var2value_.find(ffi::GetRef<Var>(var));
+    if (it == var2value_.end()) return cost;
+    const auto* call = (*it).second.as<CallNode>();
+    if (call == nullptr ||
+        !(call->op.same_as(call_tir_op) || call->op.same_as(call_tir_inplace_op))) {
+      return cost;
+    }
+    GlobalVar gvar = Downcast<GlobalVar>(call->args[0]);
+    auto it_flops = flops_.find(gvar.get());
+    if (it_flops == flops_.end()) {
+      auto prim_func = mod_->Lookup(gvar).as<tir::PrimFuncNode>();
+      double flops = prim_func != nullptr ? tir::EstimateTIRFlops(prim_func->body) : 0;
+      it_flops = flops_.emplace(gvar.get(), flops).first;
+    }
+    cost.flops = it_flops->second;
+    cost.output_bytes = TensorBytes(GetStructInfo(ffi::GetRef<Var>(var)));
+    cost.bytes = cost.output_bytes;
+    for (const Expr& arg : Downcast<Tuple>(call->args[1])->fields) {
+      cost.bytes += TensorBytes(GetStructInfo(arg));
+    }
+    return cost;
+  }
+
+ private:
+  static double TensorBytes(const StructInfo& sinfo) {
+    if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+      double bytes = 0;
+      for (const StructInfo& field : tuple->fields) {
+        bytes += TensorBytes(field);
+      }
+      return bytes;
+    }
+    const auto* tensor = sinfo.as<TensorStructInfoNode>();
+    if (tensor == nullptr || tensor->IsUnknownDtype() || !tensor->shape.defined()) return 0;
+    const auto* shape = tensor->shape.as<ShapeExprNode>();
+    if (shape == nullptr) return 0;
+    double bytes = tensor->dtype.bytes() * tensor->dtype.lanes();
+    for (const PrimExpr& dim : shape->values) {
+      if (const auto* int_dim = dim.as<IntImmNode>()) {
+        bytes *= int_dim->value;
+      }
+    }
+    return bytes;
+  }
+
+  IRModule mod_;
+  ffi::Map<Var, Expr> var2value_;
+  std::unordered_map<const GlobalVarNode*, double> flops_;
+};
+
+/*!
+ * \brief A roofline model of the fused kernels. The run time of a kernel is bounded by its FLOPs
+ *  or by the bytes it moves, plus the launch overhead. A fusion is committed if it does not make
+ *  the estimated total run time worse, where the kernels of more than a soft limit of nodes are
+ *  penalized for the register pressure.
+ */
+class RooflineFusionModel {
+ public:
+  RooflineFusionModel(Target target, ffi::Optional<Integer> max_fuse_depth) {
+    bool is_gpu = false;
+    if (target.defined()) {
+      std::vector<std::string> keys = target->GetKeys();
+      is_gpu = std::find(keys.begin(), keys.end(), "gpu") != keys.end();
+    }
+    peak_flops_ = is_gpu ? 2e13 : 1e12;
+    bandwidth_ = is_gpu ? 1e12 : 1e11;
+    launch_seconds_ = is_gpu ? 4e-6 : 1e-6;
+    soft_fuse_depth_ =
+        max_fuse_depth.has_value() ? max_fuse_depth.value()->value : (is_gpu ? 16 : 32);
+  }
+
+  bool operator()(const FusionCandidate& candidate) const {
+    double compute_seconds = candidate.flops / peak_flops_;
+    double unfused = std::max(compute_seconds, candidate.unfused_bytes / bandwidth_) +
+                     candidate.num_groups * launch_seconds_;
+    double excess =
+        std::max<double>(0, static_cast<double>(candidate.num_nodes) - soft_fuse_depth_);
+    double fused = std::max(compute_seconds, candidate.fused_bytes / bandwidth_) *
+                       (1 + kSpillPenalty * excess) +
+                   launch_seconds_;
+    return fused <= unfused;
+  }
+
+ private:
+  /*! \brief The slowdown of a fused kernel per node beyond the soft limit. */
+  static constexpr double kSpillPenalty = 0.1;
+  double peak_flops_;
+  double bandwidth_;
+  double launch_seconds_;
+  int64_t soft_fuse_depth_;
+};
+
+/*!
+ * \brief Create the fusion policy of the given name.
+ * \param mod The module to fuse.
+ * \param name "cost_model", or the name of a global function taking a dict of the candidate.
+ * \param max_fuse_depth The configured limit on the number of fused nodes.
+ */
+FusionPolicy CreateFusionPolicy(const IRModule& mod, const std::string& name,
+                                ffi::Optional<Integer> max_fuse_depth) {
+  FusionPolicy policy;
+  policy.festimate = FusionCostEstimator(mod);
+  if (name == "cost_model") {
+    policy.faccept = RooflineFusionModel(Target::Current(true), max_fuse_depth);
+    return policy;
+  }
+  auto fpolicy = ffi::Function::GetGlobal(name);
+  CHECK(fpolicy.has_value()) << "ValueError: relax.FuseOps.policy must be \"cost_model\" or the "
+                             << "name of a global function, but got \"" << name << "\"";
+  policy.faccept = [f = fpolicy.value()](const FusionCandidate& candidate) {
+    ffi::Map<ffi::String, ffi::Any> info{
+        {"src", ffi::GetRef<ObjectRef>(candidate.src->ref)},
+        {"sink", ffi::GetRef<ObjectRef>(candidate.sink->ref)},
+        {"num_nodes", static_cast<int64_t>(candidate.num_nodes)},
+        {"num_groups", static_cast<int64_t>(candidate.num_groups)},
+        {"flops", candidate.flops},
+        {"unfused_bytes", candidate.unfused_bytes},
+        {"fused_bytes", candidate.fused_bytes}};
+    return f(info).cast<bool>();
+  };
+  return policy;
+}
+
+IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth,
+                 std::optional<FusionPolicy> policy = std::nullopt) {
   support::Arena arena;
 
   // Step 1. Create the indexed-forward graph according to the input IRModule.
   IndexedForwardGraph graph = GraphCreator::Create(mod, &arena);
 
   // Step 2. Partition the graph by applying the fusion algorithm.
-  std::vector<GraphPartitioner::Group*> groups =
-      GraphPartitioner(&arena, opt_level, max_fuse_depth, /*max_function_args=*/0).Partition(graph);
+  GraphPartitioner partitioner(&arena, opt_level, max_fuse_depth, /*max_function_args=*/0);
+  if (policy.has_value()) {
+    partitioner.SetFusionPolicy(std::move(policy.value()));
+  }
+  std::vector<GraphPartitioner::Group*> groups = partitioner.Partition(graph);
 
   // Step 3. Transform the IRModule by fusing the operators in accordance with the graph partition
   // results.
@@ -1439,7 +1586,13 @@ Pass FuseOps(int fuse_opt_level) {
       [=](IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relax.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue());
+        auto policy_name = pc->GetConfig<ffi::String>("relax.FuseOps.policy");
+        std::optional<FusionPolicy> policy = std::nullopt;
+        if (policy_name.has_value() && !policy_name.value().empty()) {
+          policy = CreateFusionPolicy(m, policy_name.value(),
+                                      pc->GetConfig<Integer>("relax.FuseOps.max_depth"));
+        }
+        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue(), std::move(policy));
       };
   return CreateModulePass(/*pass_function=*/pass_func,  //
                           /*opt_level=*/0,              //
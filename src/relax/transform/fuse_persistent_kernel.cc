@@ -0,0 +1,409 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/fuse_persistent_kernel.cc
+ * \brief Fuse a sequence of GPU kernels of a dataflow block into one persistent kernel, whose
+ * stages are separated by grid-wide barriers.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/runtime/module.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../tir/schedule/transform.h"
+#include "kernel_launch_utils.h"
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*! \brief A kernel of the persistent kernel, and the relax variables it reads and writes. */
+struct Stage {
+  KernelInfo kernel;
+  /*! \brief The arguments of the call_tir, which are bound to the input parameters in order. */
+  ffi::Array<Expr> args;
+  /*! \brief The variable bound to the result of the call_tir. */
+  Var output;
+  /*! \brief The number of output parameters. */
+  size_t num_outputs;
+};
+
+/*!
+ * \brief Wrap the statement in thread binding loops of the given extents.
+ * \param thread_extents The extents of the thread bindings by thread tag.
+ * \param f_body The callback to build the body from the loop variables by thread tag.
+ */
+tir::Stmt MakeThreadLoops(
+    const std::map<std::string, int64_t>& thread_extents,
+    std::function<tir::Stmt(const std::map<std::string, tir::Var>&)> f_body) {
+  std::map<std::string, tir::Var> thread_vars;
+  for (const auto& [tag, extent] : thread_extents) {
+    std::string name = tag;
+    std::replace(name.begin(), name.end(), '.', '_');
+    thread_vars.emplace(tag, tir::Var(name, DataType::Int(32)));
+  }
+  tir::Stmt body = f_body(thread_vars);
+  for (auto it = thread_extents.rbegin(); it != thread_extents.rend(); ++it) {
+    body = tir::For(thread_vars.at(it->first), IntImm(DataType::Int(32), 0),
+                    IntImm(DataType::Int(32), it->second), tir::ForKind::kThreadBinding, body,
+                    tir::IterVar(NullValue<Range>(), tir::Var(""), tir::IterVarType::kThreadIndex,
+                                 it->first));
+  }
+  return body;
+}
+
+/*!
+ * \brief Build the persistent kernel of the stages.
+ *
+ * Every stage runs on the same grid of `num_blocks` blocks, striding over its own grid when the
+ * latter is larger. A stage that reads the output of a stage since the last barrier waits for all
+ * blocks at a grid-wide barrier first. The barrier is the global `tvm_storage_sync` of the CUDA
+ * codegen, which requires all blocks of the grid to be resident on the device at once.
+ *
+ * The parameters are the inputs from outside of the stages, followed by the outputs of all
+ * stages. An output that a later stage reads is passed to it through the output buffer.
+ *
+ * \param stages The stages in execution order.
+ * \param max_num_blocks The upper bound of the persistent grid.
+ * \param external_args The arguments to the persistent kernel, which are the inputs that are not
+ * produced by the stages.
+ */
+tir::PrimFunc MakePersistentKernel(const std::vector<Stage>& stages, int64_t max_num_blocks,
+                                   ffi::Array<Expr>* external_args) {
+  ffi::Array<tir::Var> inputs;
+  ffi::Array<tir::Var> outputs;
+  ffi::Map<tir::Var, tir::Buffer> buffer_map;
+  ffi::Array<tir::Buffer> alloc_buffers;
+  // The output buffer of each variable produced by a stage.
+  std::unordered_map<const VarNode*, tir::Buffer> produced;
+  std::vector<ffi::Map<tir::Buffer, tir::Buffer>> buffer_remaps(stages.size());
+  std::vector<bool> needs_barrier(stages.size(), false);
+  std::unordered_set<const VarNode*> written_since_barrier;
+
+  int64_t num_blocks = 0;
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const Stage& stage = stages[i];
+    const tir::PrimFunc& func = stage.kernel.func;
+    size_t num_inputs = func->params.size() - stage.num_outputs;
+    ICHECK_EQ(num_inputs, stage.args.size());
+    for (size_t j = 0; j < num_inputs; ++j) {
+      const tir::Var& param = func->params[j];
+      const tir::Buffer& buffer = func->buffer_map.at(param);
+      const auto* var = stage.args[j].as<VarNode>();
+      auto it = var ? produced.find(var) : produced.end();
+      if (it != produced.end()) {
+        buffer_remaps[i].Set(buffer, it->second);
+        needs_barrier[i] = needs_barrier[i] || written_since_barrier.count(var);
+      } else {
+        inputs.push_back(param);
+        buffer_map.Set(param, buffer);
+        external_args->push_back(stage.args[j]);
+      }
+    }
+    if (needs_barrier[i]) {
+      written_since_barrier.clear();
+    }
+    for (size_t j = num_inputs; j < func->params.size(); ++j) {
+      const tir::Var& param = func->params[j];
+      outputs.push_back(param);
+      buffer_map.Set(param, func->buffer_map.at(param));
+    }
+    // Only a stage with a single output can be read by the later stages, as reading one field of
+    // a tuple output takes a binding outside of the stages.
+    if (stage.num_outputs == 1) {
+      produced.emplace(stage.output.get(), func->buffer_map.at(func->params.back()));
+      written_since_barrier.insert(stage.output.get());
+    }
+    alloc_buffers.insert(alloc_buffers.end(), stage.kernel.alloc_buffers.begin(),
+                         stage.kernel.alloc_buffers.end());
+    num_blocks = std::max(num_blocks, stage.kernel.num_blocks);
+  }
+  num_blocks = std::min(num_blocks, max_num_blocks);
+  ffi::Array<tir::Var> params = inputs;
+  params.insert(params.end(), outputs.begin(), outputs.end());
+
+  const std::map<std::string, int64_t>& thread_extents = stages[0].kernel.thread_extents;
+  tir::Var block_var("blockIdx_x", DataType::Int(32));
+  PrimExpr grid_size = IntImm(DataType::Int(32), num_blocks);
+
+  ffi::Array<tir::Stmt> seq;
+  seq.push_back(MakeThreadLoops(thread_extents, [](const auto&) {
+    return tir::Evaluate(
+        tir::Call(DataType::Int(32), tir::builtin::tvm_global_barrier_kinit(), {}));
+  }));
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const KernelInfo& kernel = stages[i].kernel;
+    if (needs_barrier[i]) {
+      seq.push_back(MakeThreadLoops(thread_extents, [&](const auto& thread_vars) {
+        PrimExpr is_lead = const_true();
+        for (const auto& [tag, var] : thread_vars) {
+          is_lead = is_lead && var == 0;
+        }
+        // The barrier of the codegen lets a single thread of each block arrive, so the other
+        // threads of the block must have finished the stage before.
+        return tir::SeqStmt(
+            {tir::Evaluate(tir::Call(DataType::Int(32), tir::builtin::tvm_storage_sync(),
+                                     {tir::StringImm("shared")})),
+             tir::Evaluate(tir::Call(DataType::Int(32), tir::builtin::tvm_storage_sync(),
+                                     {tir::StringImm("global"), is_lead, grid_size}))});
+      }));
+    }
+
+    tir::Stmt body = kernel.body;
+    if (!buffer_remaps[i].empty()) {
+      body = tir::ReplaceBufferMutator(buffer_remaps[i], nullptr)(std::move(body));
+    }
+    int64_t num_trips = (kernel.num_blocks + num_blocks - 1) / num_blocks;
+    tir::Var trip_var("trip", DataType::Int(32));
+    PrimExpr block_index =
+        num_trips == 1 ? PrimExpr(block_var) : trip_var * grid_size + block_var;
+    body = tir::Substitute(body, [&](const tir::Var& var) {
+      ffi::Optional<PrimExpr> result;
+      if (var.same_as(kernel.block_var)) {
+        result = tvm::cast(var.dtype(), block_index);
+      }
+      return result;
+    });
+    if (kernel.num_blocks != num_trips * num_blocks) {
+      body = tir::IfThenElse(block_index < IntImm(DataType::Int(32), kernel.num_blocks), body);
+    }
+    if (num_trips > 1) {
+      body = tir::For(trip_var, IntImm(DataType::Int(32), 0), IntImm(DataType::Int(32), num_trips),
+                      tir::ForKind::kSerial, body);
+    }
+    seq.push_back(body);
+  }
+
+  tir::Stmt grid = tir::For(block_var, IntImm(DataType::Int(32), 0), grid_size,
+                            tir::ForKind::kThreadBinding, tir::SeqStmt(seq),
+                            tir::IterVar(NullValue<Range>(), tir::Var(""),
+                                         tir::IterVarType::kThreadIndex, "blockIdx.x"));
+  // Reset the barrier counter on the host before each launch.
+  tir::Stmt prepare = tir::Evaluate(
+      tir::Call(DataType::Int(32), tir::builtin::tvm_call_packed(),
+                {tir::StringImm(runtime::symbol::tvm_prepare_global_barrier)}));
+  tir::Block root(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{}, /*name_hint=*/"root",
+                  tir::SeqStmt({prepare, grid}), /*init=*/std::nullopt, alloc_buffers);
+  tir::Stmt func_body = tir::BlockRealize(/*iter_values=*/{}, /*predicate=*/const_true(), root);
+
+  ffi::Map<ffi::String, ffi::Any> attrs{{"tir.noalias", true}};
+  if (auto target = stages[0].kernel.func->GetAttr<Target>(tvm::attr::kTarget)) {
+    attrs.Set(tvm::attr::kTarget, target.value());
+  }
+  return tir::PrimFunc(params, func_body, VoidType(), buffer_map, DictAttrs(attrs));
+}
+
+/*! \brief Rewrite the runs of call_tir in dataflow blocks into one call_tir each. */
+class PersistentKernelFuser : public ExprMutator {
+ public:
+  static IRModule Transform(const IRModule& mod, int64_t max_num_blocks) {
+    PersistentKernelFuser mutator(mod, max_num_blocks);
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        Function new_func = Downcast<Function>(mutator(ffi::GetRef<Function>(func)));
+        if (!new_func.same_as(kv.second)) {
+          mutator.builder_->UpdateFunction(kv.first, new_func);
+        }
+      }
+    }
+    return mutator.builder_->GetContextIRModule();
+  }
+
+ private:
+  PersistentKernelFuser(const IRModule& mod, int64_t max_num_blocks)
+      : ExprMutator(mod), mod_(mod), max_num_blocks_(max_num_blocks) {}
+
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    ffi::Array<Binding> new_bindings;
+    // The current run of stages, and the bindings of their calls.
+    std::vector<Stage> run;
+    std::vector<VarBinding> run_bindings;
+    std::unordered_set<const VarNode*> run_outputs;
+    bool changed = false;
+
+    auto f_flush = [&]() {
+      changed |= EmitRun(run, run_bindings, &new_bindings);
+      run.clear();
+      run_bindings.clear();
+      run_outputs.clear();
+    };
+
+    for (const Binding& binding : block->bindings) {
+      std::optional<Stage> stage = MatchStage(binding);
+      if (stage.has_value()) {
+        if (!run.empty() && run[0].kernel.launch_key != stage->kernel.launch_key) {
+          f_flush();
+        }
+        run_outputs.insert(binding->var.get());
+        run.push_back(std::move(stage.value()));
+        run_bindings.push_back(Downcast<VarBinding>(binding));
+        continue;
+      }
+      // A binding that uses the result of a stage must come after the persistent kernel.
+      for (const Var& var : FreeVars(GetBoundValue(binding))) {
+        if (run_outputs.count(var.get())) {
+          f_flush();
+          break;
+        }
+      }
+      new_bindings.push_back(binding);
+    }
+    f_flush();
+
+    if (!changed) {
+      return ffi::GetRef<DataflowBlock>(block);
+    }
+    return DataflowBlock(new_bindings, block->span);
+  }
+
+  /*! \brief Match a binding of a call_tir to a single-kernel PrimFunc. */
+  std::optional<Stage> MatchStage(const Binding& binding) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (var_binding == nullptr) {
+      return std::nullopt;
+    }
+    const auto* call = var_binding->value.as<CallNode>();
+    if (call == nullptr || !call->op.same_as(call_tir_op) || call->args.size() != 2 ||
+        !call->args[1]->IsInstance<TupleNode>()) {
+      return std::nullopt;
+    }
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    if (gv == nullptr) {
+      return std::nullopt;
+    }
+    auto opt_func = mod_->functions.Get(ffi::GetRef<GlobalVar>(gv));
+    if (!opt_func.has_value() || !opt_func.value()->IsInstance<tir::PrimFuncNode>()) {
+      return std::nullopt;
+    }
+    // The global barrier is only implemented by the CUDA codegen.
+    std::optional<KernelInfo> kernel =
+        MatchKernel(Downcast<tir::PrimFunc>(opt_func.value()), {"cuda"},
+                    std::numeric_limits<int64_t>::max());
+    if (!kernel.has_value()) {
+      return std::nullopt;
+    }
+    const StructInfo& sinfo = call->sinfo_args[0];
+    size_t num_outputs = 1;
+    if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+      num_outputs = tuple->fields.size();
+    }
+    return Stage{std::move(kernel.value()), Downcast<Tuple>(call->args[1])->fields,
+                 var_binding->var, num_outputs};
+  }
+
+  /*!
+   * \brief Emit the bindings of a run: a single call_tir to the persistent kernel, and a binding
+   * of each original variable to its part of the result.
+   * \return Whether the run was fused.
+   */
+  bool EmitRun(const std::vector<Stage>& run, const std::vector<VarBinding>& run_bindings,
+               ffi::Array<Binding>* bindings) {
+    if (run.size() < 2) {
+      bindings->insert(bindings->end(), run_bindings.begin(), run_bindings.end());
+      return false;
+    }
+
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    ffi::Array<Expr> args;
+    tir::PrimFunc func = MakePersistentKernel(run, max_num_blocks_, &args);
+    ffi::Array<StructInfo> out_sinfo;
+    for (const VarBinding& binding : run_bindings) {
+      StructInfo sinfo = Downcast<Call>(binding->value)->sinfo_args[0];
+      if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+        out_sinfo.insert(out_sinfo.end(), tuple->fields.begin(), tuple->fields.end());
+      } else {
+        out_sinfo.push_back(sinfo);
+      }
+    }
+
+    GlobalVar gv = builder_->AddFunction(func, "persistent_kernel");
+    Expr fused_value =
+        builder_->Normalize(Call(call_tir_op, {gv, Tuple(args)}, {}, {TupleStructInfo(out_sinfo)}));
+    DataflowVar fused_var("persistent_kernel", GetStructInfo(fused_value));
+    bindings->push_back(VarBinding(fused_var, fused_value));
+
+    int index = 0;
+    for (size_t i = 0; i < run.size(); ++i) {
+      Expr value;
+      if (GetStructInfo(run_bindings[i]->var)->IsInstance<TupleStructInfoNode>()) {
+        ffi::Array<Expr> fields;
+        for (size_t j = 0; j < run[i].num_outputs; ++j) {
+          fields.push_back(TupleGetItem(fused_var, index++));
+        }
+        value = Tuple(fields);
+      } else {
+        value = TupleGetItem(fused_var, index++);
+      }
+      bindings->push_back(VarBinding(run_bindings[i]->var, builder_->Normalize(value)));
+    }
+    return true;
+  }
+
+  IRModule mod_;
+  int64_t max_num_blocks_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass FusePersistentKernel(int64_t max_num_blocks) {
+  CHECK_GT(max_num_blocks, 0) << "ValueError: max_num_blocks should be positive, but got "
+                              << max_num_blocks;
+  auto pass_func = [=](IRModule mod, PassContext pc) {
+    return PersistentKernelFuser::Transform(mod, max_num_blocks);
+  };
+  return CreateModulePass(/*pass_function=*/pass_func,           //
+                          /*opt_level=*/0,                       //
+                          /*pass_name=*/"FusePersistentKernel",  //
+                          /*required=*/{});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.FusePersistentKernel", FusePersistentKernel);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
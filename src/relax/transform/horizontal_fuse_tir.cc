@@ -0,0 +1,344 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/horizontal_fuse_tir.cc
+ * \brief Batch independent GPU kernels of a dataflow block into a single kernel launch.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "kernel_launch_utils.h"
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*!
+ * \brief Combine the kernels into one PrimFunc. The block range [offset_i, offset_i + num_blocks_i)
+ * of the combined grid runs the i-th kernel. The parameters are the inputs of all kernels followed
+ * by the outputs of all kernels, following the destination-passing convention of call_tir.
+ * \param kernels The kernels to combine.
+ * \param num_outputs The number of output parameters of each kernel.
+ */
+tir::PrimFunc CombineKernels(const std::vector<KernelInfo>& kernels,
+                             const std::vector<size_t>& num_outputs) {
+  ffi::Array<tir::Var> inputs;
+  ffi::Array<tir::Var> outputs;
+  ffi::Map<tir::Var, tir::Buffer> buffer_map;
+  ffi::Array<tir::Buffer> alloc_buffers;
+  ffi::Optional<Target> target;
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    const tir::PrimFunc& func = kernels[i].func;
+    size_t num_inputs = func->params.size() - num_outputs[i];
+    for (size_t j = 0; j < func->params.size(); ++j) {
+      const tir::Var& param = func->params[j];
+      (j < num_inputs ? inputs : outputs).push_back(param);
+      buffer_map.Set(param, func->buffer_map.at(param));
+    }
+    alloc_buffers.insert(alloc_buffers.end(), kernels[i].alloc_buffers.begin(),
+                         kernels[i].alloc_buffers.end());
+    if (!target.defined()) {
+      target = func->GetAttr<Target>(tvm::attr::kTarget);
+    }
+  }
+  ffi::Array<tir::Var> params = inputs;
+  params.insert(params.end(), outputs.begin(), outputs.end());
+
+  // Build the dispatch from the last kernel backwards, so that each branch checks its upper bound
+  // only, and the last kernel needs no check at all.
+  tir::Var block_var("blockIdx_x", DataType::Int(32));
+  std::vector<int64_t> offsets;
+  int64_t total_blocks = 0;
+  for (const KernelInfo& kernel : kernels) {
+    offsets.push_back(total_blocks);
+    total_blocks += kernel.num_blocks;
+  }
+  tir::Stmt dispatch;
+  for (int i = static_cast<int>(kernels.size()) - 1; i >= 0; --i) {
+    const KernelInfo& kernel = kernels[i];
+    PrimExpr local_block =
+        tvm::cast(kernel.block_var.dtype(), block_var - IntImm(DataType::Int(32), offsets[i]));
+    tir::Stmt body = tir::Substitute(kernel.body, [&](const tir::Var& var) {
+      ffi::Optional<PrimExpr> result;
+      if (var.same_as(kernel.block_var)) {
+        result = local_block;
+      }
+      return result;
+    });
+    if (dispatch.defined()) {
+      PrimExpr upper = IntImm(DataType::Int(32), offsets[i] + kernel.num_blocks);
+      dispatch = tir::IfThenElse(block_var < upper, body, dispatch);
+    } else {
+      dispatch = body;
+    }
+  }
+  tir::Stmt grid = tir::For(block_var, IntImm(DataType::Int(32), 0),
+                            IntImm(DataType::Int(32), total_blocks),
+                            tir::ForKind::kThreadBinding, dispatch,
+                            tir::IterVar(NullValue<Range>(), tir::Var(""),
+                                         tir::IterVarType::kThreadIndex, "blockIdx.x"));
+  tir::Block root(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{}, /*name_hint=*/"root", grid,
+                  /*init=*/std::nullopt, alloc_buffers);
+  tir::Stmt body = tir::BlockRealize(/*iter_values=*/{}, /*predicate=*/const_true(), root);
+
+  ffi::Map<ffi::String, ffi::Any> attrs{{"tir.noalias", true}};
+  if (target.defined()) {
+    attrs.Set(tvm::attr::kTarget, target.value());
+  }
+  return tir::PrimFunc(params, body, VoidType(), buffer_map, DictAttrs(attrs));
+}
+
+/*! \brief Rewrite groups of independent call_tir in dataflow blocks into one call_tir each. */
+class HorizontalFuser : public ExprMutator {
+ public:
+  static IRModule Transform(const IRModule& mod, int64_t max_num_blocks, int64_t max_group_size) {
+    HorizontalFuser mutator(mod, max_num_blocks, max_group_size);
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        Function new_func = Downcast<Function>(mutator(ffi::GetRef<Function>(func)));
+        if (!new_func.same_as(kv.second)) {
+          mutator.builder_->UpdateFunction(kv.first, new_func);
+        }
+      }
+    }
+    return mutator.builder_->GetContextIRModule();
+  }
+
+ private:
+  HorizontalFuser(const IRModule& mod, int64_t max_num_blocks, int64_t max_group_size)
+      : ExprMutator(mod),
+        mod_(mod),
+        max_num_blocks_(max_num_blocks),
+        max_group_size_(max_group_size) {}
+
+  /*! \brief A call_tir binding that can share a kernel launch with others. */
+  struct Member {
+    VarBinding binding;
+    Call call;
+    KernelInfo kernel;
+  };
+
+  /*! \brief The members collected so far for one launch configuration. */
+  struct Group {
+    std::string launch_key;
+    std::vector<Member> members;
+    /*! \brief The variables bound by the members. */
+    std::unordered_set<const VarNode*> outputs;
+  };
+
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    ffi::Array<Binding> new_bindings;
+    std::vector<Group> groups;
+    bool changed = false;
+
+    auto f_flush = [&](Group* group) {
+      changed |= EmitGroup(*group, &new_bindings);
+      group->members.clear();
+      group->outputs.clear();
+    };
+
+    for (const Binding& binding : block->bindings) {
+      Expr value = GetBoundValue(binding);
+      // A binding that uses the result of a pending member must come after the combined call.
+      std::unordered_set<const VarNode*> used_vars;
+      for (const Var& var : FreeVars(value)) {
+        used_vars.insert(var.get());
+      }
+      for (Group& group : groups) {
+        for (const VarNode* var : used_vars) {
+          if (group.outputs.count(var)) {
+            f_flush(&group);
+            break;
+          }
+        }
+      }
+
+      std::optional<Member> member = MatchMember(binding);
+      if (!member.has_value()) {
+        new_bindings.push_back(binding);
+        continue;
+      }
+      auto it = std::find_if(groups.begin(), groups.end(), [&](const Group& group) {
+        return group.launch_key == member->kernel.launch_key;
+      });
+      if (it == groups.end()) {
+        groups.push_back(Group{member->kernel.launch_key, {}, {}});
+        it = std::prev(groups.end());
+      }
+      it->outputs.insert(binding->var.get());
+      it->members.push_back(std::move(member.value()));
+      if (static_cast<int64_t>(it->members.size()) >= max_group_size_) {
+        f_flush(&*it);
+      }
+    }
+    for (Group& group : groups) {
+      f_flush(&group);
+    }
+
+    if (!changed) {
+      return ffi::GetRef<DataflowBlock>(block);
+    }
+    return DataflowBlock(new_bindings, block->span);
+  }
+
+  /*! \brief Match a binding of a call_tir to a small single-kernel PrimFunc. */
+  std::optional<Member> MatchMember(const Binding& binding) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (var_binding == nullptr) {
+      return std::nullopt;
+    }
+    const auto* call = var_binding->value.as<CallNode>();
+    // Calls that pass symbolic variables to the PrimFunc are left alone, as the combined grid
+    // must be static.
+    if (call == nullptr || !call->op.same_as(call_tir_op) || call->args.size() != 2 ||
+        !call->args[1]->IsInstance<TupleNode>()) {
+      return std::nullopt;
+    }
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    if (gv == nullptr) {
+      return std::nullopt;
+    }
+    auto opt_func = mod_->functions.Get(ffi::GetRef<GlobalVar>(gv));
+    if (!opt_func.has_value() || !opt_func.value()->IsInstance<tir::PrimFuncNode>()) {
+      return std::nullopt;
+    }
+    std::optional<KernelInfo> kernel =
+        MatchKernel(Downcast<tir::PrimFunc>(opt_func.value()), {"cuda", "rocm"}, max_num_blocks_);
+    if (!kernel.has_value()) {
+      return std::nullopt;
+    }
+    return Member{ffi::GetRef<VarBinding>(var_binding), ffi::GetRef<Call>(call),
+                  std::move(kernel.value())};
+  }
+
+  /*!
+   * \brief Emit the bindings of a group: a single call_tir to the combined PrimFunc, and a binding
+   * of each original variable to its part of the result.
+   * \return Whether the group was combined.
+   */
+  bool EmitGroup(const Group& group, ffi::Array<Binding>* bindings) {
+    if (group.members.size() < 2) {
+      for (const Member& member : group.members) {
+        bindings->push_back(member.binding);
+      }
+      return false;
+    }
+
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    std::vector<KernelInfo> kernels;
+    std::vector<size_t> num_outputs;
+    ffi::Array<Expr> args;
+    ffi::Array<StructInfo> out_sinfo;
+    for (const Member& member : group.members) {
+      kernels.push_back(member.kernel);
+      StructInfo sinfo = member.call->sinfo_args[0];
+      ffi::Array<StructInfo> fields;
+      if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+        fields = tuple->fields;
+      } else {
+        fields = {sinfo};
+      }
+      num_outputs.push_back(fields.size());
+      out_sinfo.insert(out_sinfo.end(), fields.begin(), fields.end());
+      for (const Expr& arg : Downcast<Tuple>(member.call->args[1])->fields) {
+        args.push_back(arg);
+      }
+    }
+
+    std::string name = "horizontal_fused";
+    for (const Member& member : group.members) {
+      name += "_" + Downcast<GlobalVar>(member.call->args[0])->name_hint;
+      if (name.size() > 64) {
+        break;
+      }
+    }
+    GlobalVar gv = builder_->AddFunction(CombineKernels(kernels, num_outputs), name);
+    Call fused_call(call_tir_op, {gv, Tuple(args)}, {}, {TupleStructInfo(out_sinfo)});
+    Expr fused_value = builder_->Normalize(fused_call);
+    DataflowVar fused_var(name, GetStructInfo(fused_value));
+    bindings->push_back(VarBinding(fused_var, fused_value));
+
+    int index = 0;
+    for (size_t i = 0; i < group.members.size(); ++i) {
+      const Member& member = group.members[i];
+      Expr value;
+      if (member.call->sinfo_args[0]->IsInstance<TupleStructInfoNode>()) {
+        ffi::Array<Expr> fields;
+        for (size_t j = 0; j < num_outputs[i]; ++j) {
+          fields.push_back(TupleGetItem(fused_var, index++));
+        }
+        value = Tuple(fields);
+      } else {
+        value = TupleGetItem(fused_var, index++);
+      }
+      bindings->push_back(VarBinding(member.binding->var, builder_->Normalize(value)));
+    }
+    return true;
+  }
+
+  IRModule mod_;
+  int64_t max_num_blocks_;
+  int64_t max_group_size_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass HorizontalFuseTIR(int64_t max_num_blocks, int64_t max_group_size) {
+  CHECK_GE(max_group_size, 2) << "ValueError: max_group_size should be at least 2, but got "
+                              << max_group_size;
+  auto pass_func = [=](IRModule mod, PassContext pc) {
+    return HorizontalFuser::Transform(mod, max_num_blocks, max_group_size);
+  };
+  return CreateModulePass(/*pass_function=*/pass_func,        //
+                          /*opt_level=*/0,                    //
+                          /*pass_name=*/"HorizontalFuseTIR",  //
+                          /*required=*/{});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.HorizontalFuseTIR", HorizontalFuseTIR);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file kernel_launch_utils.cc
+ * \brief Utilities for the passes that combine GPU kernels scheduled in TIR into fewer launches.
+ */
+
+#include "kernel_launch_utils.h"
+
+#include <tvm/target/target.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <sstream>
+
+#include "../../support/utils.h"
+
+namespace tvm {
+namespace relax {
+
+using support::StartsWith;
+
+std::optional<KernelInfo> MatchKernel(const tir::PrimFunc& prim_func,
+                                      const std::unordered_set<std::string>& target_kinds,
+                                      int64_t max_num_blocks) {
+  ffi::Optional<Target> target = prim_func->GetAttr<Target>(tvm::attr::kTarget);
+  if (!target.defined()) {
+    target = Target::Current(/*allow_not_defined=*/true);
+  }
+  if (!target.defined() || !target_kinds.count(target.value()->kind->name)) {
+    return std::nullopt;
+  }
+  for (const tir::Var& param : prim_func->params) {
+    auto it = prim_func->buffer_map.find(param);
+    if (it == prim_func->buffer_map.end()) {
+      return std::nullopt;
+    }
+    for (const PrimExpr& dim : (*it).second->shape) {
+      if (!dim->IsInstance<IntImmNode>()) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  KernelInfo info;
+  info.func = tir::RenewDefs(prim_func);
+  tir::Stmt body = info.func->body;
+  if (const auto* realize = body.as<tir::BlockRealizeNode>()) {
+    const tir::Block& root = realize->block;
+    if (!root->iter_vars.empty() || !root->match_buffers.empty() || root->init.defined()) {
+      return std::nullopt;
+    }
+    info.alloc_buffers = root->alloc_buffers;
+    body = root->body;
+  }
+  const auto* loop = body.as<tir::ForNode>();
+  if (loop == nullptr || loop->kind != tir::ForKind::kThreadBinding ||
+      loop->thread_binding.value()->thread_tag != "blockIdx.x" || !tir::is_zero(loop->min) ||
+      !loop->annotations.empty()) {
+    return std::nullopt;
+  }
+  const auto* extent = loop->extent.as<IntImmNode>();
+  if (extent == nullptr || extent->value > max_num_blocks) {
+    return std::nullopt;
+  }
+  info.block_var = loop->loop_var;
+  info.num_blocks = extent->value;
+  info.body = loop->body;
+
+  // The thread extents of the kernel. A kernel with more than one grid dimension or with
+  // conflicting thread extents is left alone.
+  std::map<std::string, int64_t>& thread_extents = info.thread_extents;
+  bool valid = true;
+  auto f_record = [&](const ffi::String& tag, const PrimExpr& extent) {
+    const auto* imm = extent.as<IntImmNode>();
+    if (StartsWith(tag, "blockIdx.") || StartsWith(tag, "vthread") || imm == nullptr) {
+      valid = false;
+      return;
+    }
+    auto [it, inserted] = thread_extents.emplace(tag, imm->value);
+    if (!inserted && it->second != imm->value) {
+      valid = false;
+    }
+  };
+  tir::PostOrderVisit(info.body, [&](const ObjectRef& obj) {
+    if (const auto* for_node = obj.as<tir::ForNode>()) {
+      if (for_node->kind == tir::ForKind::kThreadBinding) {
+        f_record(for_node->thread_binding.value()->thread_tag, for_node->extent);
+      }
+    } else if (const auto* attr = obj.as<tir::AttrStmtNode>()) {
+      if (attr->attr_key == tir::attr::thread_extent ||
+          attr->attr_key == tir::attr::virtual_thread) {
+        f_record(Downcast<tir::IterVar>(attr->node)->thread_tag, attr->value);
+      }
+    }
+  });
+  if (!valid) {
+    return std::nullopt;
+  }
+
+  std::ostringstream os;
+  os << target.value()->str();
+  for (const auto& [tag, value] : thread_extents) {
+    os << ";" << tag << "=" << value;
+  }
+  info.launch_key = os.str();
+  return info;
+}
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file kernel_launch_utils.h
+ * \brief Utilities for the passes that combine GPU kernels scheduled in TIR into fewer launches.
+ */
+
+#ifndef TVM_RELAX_TRANSFORM_KERNEL_LAUNCH_UTILS_H_
+#define TVM_RELAX_TRANSFORM_KERNEL_LAUNCH_UTILS_H_
+
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_set>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief The launch configuration of a PrimFunc that consists of a single GPU kernel whose grid
+ * is one-dimensional.
+ */
+struct KernelInfo {
+  /*! \brief The PrimFunc, with its definitions renewed. */
+  tir::PrimFunc func;
+  /*! \brief The loop variable bound to blockIdx.x. */
+  tir::Var block_var;
+  /*! \brief The number of thread blocks. */
+  int64_t num_blocks{0};
+  /*! \brief The body of the blockIdx.x loop. */
+  tir::Stmt body;
+  /*! \brief The buffers allocated by the root block. */
+  ffi::Array<tir::Buffer> alloc_buffers;
+  /*! \brief The extents of the thread bindings other than blockIdx.x, by thread tag. */
+  std::map<std::string, int64_t> thread_extents;
+  /*!
+   * \brief The kernels can share a launch only if their thread extents and targets agree, which
+   * this key encodes.
+   */
+  std::string launch_key;
+};
+
+/*!
+ * \brief Match a PrimFunc scheduled as a single kernel with a constant one-dimensional grid.
+ * \param func The PrimFunc, whose buffers must have static shapes.
+ * \param target_kinds The target kinds to accept. The target is the "target" attribute of the
+ * function, or the current target.
+ * \param max_num_blocks The largest grid to accept.
+ * \return The kernel info, or std::nullopt if the function does not match.
+ */
+std::optional<KernelInfo> MatchKernel(const tir::PrimFunc& func,
+                                      const std::unordered_set<std::string>& target_kinds,
+                                      int64_t max_num_blocks);
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_TRANSFORM_KERNEL_LAUNCH_UTILS_H_
@@ -32,16 +32,22 @@
  *
  * A region is a subgraph of the Relax function that are executed statically. A region is executed
  * statically if 1) it only depends on the memory allocated internally in the Relax function with
- * constant shapes, 2) it only contains kernel launches (there are no control flow).
+ * constant shapes, 2) it only contains kernel launches, and `If` whose branches only contain kernel
+ * launches and whose condition only depends on the captured symbolic variables.
  *
  * This transformation is expected to run after `StaticPlanBlockMemory`. After
  * `StaticPlanBlockMemory`, all the tensors that can be statically allocated are allocated with
  * `R.memory.alloc_storage` and `R.memory.alloc_tensor`, while other tensors will be allocated via
  * `R.builtin.alloc_tensor`.
  *
- * `CUDAGraphRewritePlanner` is executed at the level of BindingBlock. It first identify all the
- * storage objects allocated with `R.memory.alloc_storage` within the BindingBlock, and then
- * identify the static regions by propagating starting from the storage objects.
+ * `CUDAGraphRewritePlanner` is executed at the level of SeqExpr. It first identify all the
+ * storage objects allocated with `R.memory.alloc_storage` within the function, and then
+ * identify the static regions by propagating starting from the storage objects. A region spans
+ * the consecutive binding blocks of a SeqExpr, but not the boundaries of a DataflowBlock.
+ *
+ * The captured symbolic variables are the key of the graphs captured for a region. When an `If` is
+ * lifted to a region, the variables of its condition are added to the key, so that a graph is
+ * captured for each branch.
  *
  * All the calls to `R.memory.alloc_storage` within the same BindingBlock are grouped into a single
  * new function. Each of the static regions are lifted to a new function.
@@ -227,6 +233,49 @@ class OutputStorageCollector : public ExprVisitor {
   std::unordered_set<const VarNode*> output_vars_;
 };
 
+/*!
+ * \brief Check whether the branches of an `If` only contain kernel launches and operations on the
+ * static buffers, which can be lifted to a captured region together with the `If`.
+ */
+class LiftableBranchChecker : public ExprVisitor {
+ public:
+  static bool Check(const IRModule& mod, const Expr& branch) {
+    LiftableBranchChecker checker(mod);
+    checker.VisitExpr(branch);
+    return checker.liftable_;
+  }
+
+ private:
+  explicit LiftableBranchChecker(const IRModule& mod) : mod_(mod) {}
+
+  void VisitExpr_(const CallNode* call) final {
+    static const auto& mem_alloc_storage_op = Op::Get("relax.memory.alloc_storage");
+    static const auto& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+    if (const auto* gv = call->op.as<GlobalVarNode>()) {
+      // calls to other Relax functions are not allowed
+      liftable_ &= mod_->Lookup(ffi::GetRef<GlobalVar>(gv))->IsInstance<tir::PrimFuncNode>();
+    } else if (const auto* extern_func = call->op.as<ExternFuncNode>()) {
+      liftable_ &= !support::StartsWith(extern_func->global_symbol, "vm.builtin");
+    } else if (const auto* op = call->op.as<OpNode>()) {
+      liftable_ &= !support::StartsWith(op->name, "relax.builtin") &&
+                   !call->op.same_as(mem_alloc_storage_op) &&
+                   !call->op.same_as(call_builtin_with_ctx_op);
+    } else {
+      liftable_ = false;
+    }
+    ExprVisitor::VisitExpr_(call);
+  }
+
+  // The symbolic variables defined in the branches, and the conditions of the nested `If`, would
+  // not be part of the key of the captured graphs.
+  void VisitBinding_(const MatchCastNode* binding) final { liftable_ = false; }
+  void VisitExpr_(const IfNode* if_node) final { liftable_ = false; }
+  void VisitExpr_(const FunctionNode* func) final { liftable_ = false; }
+
+  IRModule mod_;
+  bool liftable_ = true;
+};
+
 /*!
  * \brief The planner for rewriting the function to enable cuda graph capturing.
  */
@@ -340,14 +389,20 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     current_function_scope_.alloc_storage_builder = nullptr;
   }
 
-  void VisitBindingBlock_(const BindingBlockNode* binding_block) final {
+  void VisitExpr_(const SeqExprNode* seq_expr) final {
     BindingBlockScope new_scope;
     std::swap(new_scope, current_block_scope_);
-    for (const auto& binding : binding_block->bindings) {
-      VisitBinding(binding);
+    for (const auto& block : seq_expr->blocks) {
+      // The launch of a region is emitted in its first block, the outputs of a region launched in
+      // a DataflowBlock would not be visible after it.
+      bool is_dataflow = block->IsInstance<DataflowBlockNode>();
+      if (is_dataflow) EndRegion();
+      VisitBindingBlock(block);
+      if (is_dataflow) EndRegion();
     }
     EndRegion();
     std::swap(new_scope, current_block_scope_);
+    VisitExpr(seq_expr->body);
   }
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
@@ -389,6 +444,7 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     }();
 
     if (is_all_static) {
+      InheritBranchKey(binding, args);
       bool is_kernel_launch = [&]() {
         static const auto& null_value_op = Op::Get("relax.null_value");
 
@@ -447,6 +503,7 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     if (IsStatic(ffi::GetRef<Var>(var))) {
       AddStaticBinding(binding, false);
       MarkAsFuncInput({var});
+      InheritBranchKey(binding, {var});
     } else {
       EndRegion();
     }
@@ -463,6 +520,7 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     if (IsStatic(tuple->fields, &args, &tir_vars)) {
       AddStaticBinding(binding, false);
       MarkAsFuncInput(args, tir_vars);
+      InheritBranchKey(binding, args);
     } else {
       EndRegion();
     }
@@ -475,12 +533,59 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     if (IsStatic(tuple_get_item->tuple)) {
       AddStaticBinding(binding, false);
       MarkAsFuncInput({tuple});
+      InheritBranchKey(binding, {tuple});
     } else {
       EndRegion();
     }
     MarkAsFuncOutput({tuple});
   }
 
+  void VisitBinding_(const VarBindingNode* binding, const IfNode* if_node) final {
+    std::vector<const VarNode*> args;
+    std::vector<const tir::VarNode*> tir_vars;
+    if (IsStaticIf(if_node, &args, &tir_vars)) {
+      if (current_block_scope_.capture_builder == nullptr) {
+        StartRegion();
+      }
+      AddStaticBinding(binding, /*is_alloc_storage=*/false);
+      MarkAsFuncInput(args, tir_vars);
+      // The buffers of the result depend on the branch taken, the graphs capturing them must be
+      // keyed by the condition as well.
+      branch_key_vars_[binding->var.get()] = tir_vars;
+    } else {
+      // The bindings after the If must not be lifted before it. The branches are planned on their
+      // own.
+      EndRegion();
+      ExprVisitor::VisitBinding_(binding, if_node);
+    }
+    MarkAsFuncOutput(args);
+  }
+
+  /*!
+   * \brief Check whether an If can be lifted to a captured region as a whole. Its condition must
+   * be a PrimValue of the captured symbolic variables, which are then part of the key of the
+   * captured graphs. Its branches must only use static variables and only contain the bindings
+   * that can be lifted.
+   */
+  bool IsStaticIf(const IfNode* if_node, std::vector<const VarNode*>* vars_collector,
+                  std::vector<const tir::VarNode*>* tir_vars_collector) {
+    If if_expr = ffi::GetRef<If>(if_node);
+    bool is_static = true;
+    // Collect all the free variables, which are outputs of the regions they are lifted to.
+    for (const Var& var : FreeVars(if_expr)) {
+      is_static &= IsStatic(var, vars_collector, tir_vars_collector);
+    }
+    const auto* cond = if_node->cond.as<PrimValueNode>();
+    if (cond == nullptr || !IsStatic(cond->value, nullptr, tir_vars_collector)) {
+      return false;
+    }
+    for (const tir::Var& var : FreeSymbolicVars(if_expr)) {
+      is_static &= IsStatic(var, nullptr, tir_vars_collector);
+    }
+    return is_static && LiftableBranchChecker::Check(mod_, if_node->true_branch) &&
+           LiftableBranchChecker::Check(mod_, if_node->false_branch);
+  }
+
   bool IsStatic(const PrimExpr& expr,
                 [[maybe_unused]] std::vector<const VarNode*>* vars_collector = nullptr,
                 std::vector<const tir::VarNode*>* tir_vars_collector = nullptr) {
@@ -512,6 +617,11 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
       if (vars_collector != nullptr) {
         vars_collector->push_back(var);
       }
+      if (auto it = branch_key_vars_.find(var);
+          it != branch_key_vars_.end() && tir_vars_collector != nullptr) {
+        tir_vars_collector->insert(tir_vars_collector->end(), it->second.begin(),
+                                   it->second.end());
+      }
       // recursively check the struct info to collect the symbolic TIR vars
       return static_vars_.count(var) && IsStatic(Downcast<StructInfo>(var->struct_info_.value()),
                                                  vars_collector, tir_vars_collector);
@@ -592,7 +702,21 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     static_vars_.emplace(binding->var.get());
   }
 
-  /*! \brief The states of the current scope (the BindingBlock) which is a FuncBuilder.
+  /*!
+   * \brief Propagate the symbolic variables of the branches that select the buffers of the
+   * arguments of a binding to the bound variable, which can alias them.
+   */
+  void InheritBranchKey(const VarBindingNode* binding, const std::vector<const VarNode*>& args) {
+    for (const VarNode* arg : args) {
+      if (auto it = branch_key_vars_.find(arg); it != branch_key_vars_.end()) {
+        std::vector<const tir::VarNode*> arg_key = it->second;
+        std::vector<const tir::VarNode*>& key = branch_key_vars_[binding->var.get()];
+        key.insert(key.end(), arg_key.begin(), arg_key.end());
+      }
+    }
+  }
+
+  /*! \brief The states of the current scope (the SeqExpr) which is a FuncBuilder.
    * The FuncBuilder are initialized with nullptr, meaning the planner is currently not doing any
    * lifting. They are initialized lazily when a binding that can be lifted is encountered.
    * They are reset to nullptr when an unsupported operation is encountered.
@@ -619,6 +743,9 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
   // Symbolic variables that are allowed to be captured. This can come from symbolic shapes of
   // weights or hints in the function annotations.
   std::unordered_set<const tir::VarNode*> capture_symbolic_vars_;
+  // The symbolic variables of the conditions of the lifted If that select the buffers of a
+  // variable. They are added to the key of the graphs which capture the variable.
+  std::unordered_map<const VarNode*, std::vector<const tir::VarNode*>> branch_key_vars_;
   // Binding to the FuncBuilder if the binding is lifted. This is used to update the inputs/outputs
   // of the lifted function when its binding is used outside.
   std::unordered_map<const VarNode*, FuncBuilder*> binding_to_region_;
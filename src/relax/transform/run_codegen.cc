@@ -173,15 +173,34 @@ class CodeGenRunner : ExprMutator {
                                         ffi::Map<ffi::String, OptionMap> target_options) {
     std::unordered_map<std::string, ffi::Array<Function>> target_functions;
 
+    // The extern functions take the upper bounds of the symbolic variables declared by the other
+    // functions, e.g. for the backends to build engines serving all the shapes within the bounds.
+    ffi::Map<ffi::String, IntImm> upper_bounds;
+    for (const auto& [gv, func] : mod->functions) {
+      if (!func->IsInstance<FunctionNode>() || func->GetAttr<ffi::String>(attr::kCodegen)) {
+        continue;
+      }
+      auto opt_bounds = func->GetAttr<ffi::Map<ffi::String, IntImm>>("tir_var_upper_bound");
+      for (const auto& [name, bound] : opt_bounds.value_or(ffi::Map<ffi::String, IntImm>())) {
+        if (!upper_bounds.count(name) || upper_bounds.at(name)->value < bound->value) {
+          upper_bounds.Set(name, bound);
+        }
+      }
+    }
+
     for (const auto& entry : mod->functions) {
       if (entry.second->IsInstance<tir::PrimFuncNode>()) {
         continue;
       }
-      PostOrderVisit(entry.second, [&target_functions](Expr e) {
+      PostOrderVisit(entry.second, [&target_functions, &upper_bounds](Expr e) {
         if (e->IsInstance<FunctionNode>()) {
           auto f = Downcast<Function>(e);
           if (auto target_opt = f->GetAttr<ffi::String>(attr::kCodegen)) {
             ffi::String target = target_opt.value();
+            if (!upper_bounds.empty() && !f->GetAttr<ffi::Map<ffi::String, IntImm>>(
+                                             "tir_var_upper_bound")) {
+              f = WithAttr(std::move(f), "tir_var_upper_bound", upper_bounds);
+            }
             target_functions[target].push_back(f);
           }
         }
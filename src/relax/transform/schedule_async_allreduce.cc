@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/schedule_async_allreduce.cc
+ * \brief Split `ccl.allreduce` into start/wait pairs that overlap with independent compute.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/block_builder.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../op/ccl/ccl.h"
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*!
+ * \brief Rewrite each `y = ccl.allreduce(x)` of a dataflow block into
+ *
+ *   y_pending = ccl.allreduce_start(x)
+ *   ...  # the bindings that do not depend on y
+ *   y = ccl.allreduce_wait(y_pending, x)
+ *
+ * where the wait is emitted right before the first binding that uses y, or at the end of the
+ * block if y is only used outside of it.
+ */
+DataflowBlock ScheduleAllReduceInBlock(const DataflowBlock& block, const BlockBuilder& bb) {
+  static const Op& allreduce_op = Op::Get("relax.ccl.allreduce");
+
+  ffi::Array<Binding> new_bindings;
+  // The waits that are not emitted yet, in the order of their allreduce.
+  std::vector<std::pair<const VarNode*, Binding>> pending_waits;
+  bool changed = false;
+
+  for (const Binding& binding : block->bindings) {
+    Expr value = GetBoundValue(binding);
+    if (!pending_waits.empty()) {
+      std::unordered_set<const VarNode*> used_vars;
+      for (const Var& var : FreeVars(value)) {
+        used_vars.insert(var.get());
+      }
+      std::vector<std::pair<const VarNode*, Binding>> remaining;
+      for (auto& [var, wait] : pending_waits) {
+        if (used_vars.count(var)) {
+          new_bindings.push_back(wait);
+        } else {
+          remaining.emplace_back(var, std::move(wait));
+        }
+      }
+      pending_waits = std::move(remaining);
+    }
+
+    const auto* call = value.as<CallNode>();
+    if (binding->IsInstance<VarBindingNode>() && call && call->op.same_as(allreduce_op)) {
+      const auto* attrs = call->attrs.as<AllReduceAttrs>();
+      ICHECK(attrs != nullptr);
+      DataflowVar pending_var(binding->var->name_hint() + "_pending",
+                              GetStructInfo(binding->var));
+      Expr start = bb->Normalize(allreduce_start(call->args[0], attrs->op_type, attrs->in_group));
+      Expr wait = bb->Normalize(allreduce_wait(pending_var, call->args[0]));
+      new_bindings.push_back(VarBinding(pending_var, start));
+      pending_waits.emplace_back(binding->var.get(), VarBinding(binding->var, wait));
+      changed = true;
+    } else {
+      new_bindings.push_back(binding);
+    }
+  }
+  for (auto& [var, wait] : pending_waits) {
+    new_bindings.push_back(wait);
+  }
+
+  if (!changed) {
+    return block;
+  }
+  return DataflowBlock(new_bindings, block->span);
+}
+
+}  // namespace
+
+namespace transform {
+
+Pass ScheduleAsyncAllReduce() {
+  auto pass_func = [=](DataflowBlock block, IRModule mod, PassContext pc) {
+    return ScheduleAllReduceInBlock(block, BlockBuilder::Create(mod));
+  };
+  return CreateDataflowBlockPass(pass_func, 1, "ScheduleAsyncAllReduce", {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.ScheduleAsyncAllReduce", ScheduleAsyncAllReduce);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/schedule_async_extern_calls.cc
+ * \brief Run the calls to the external modules on side streams, and wait for their results right
+ *  before their first use, so that independent external regions overlap.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*! \brief Check if a callee is a function of the external modules of the IRModule. */
+bool IsExternalModuleFunc(const Expr& func, const ffi::Array<ffi::Module>& ext_mods) {
+  const auto* extern_func = func.as<ExternFuncNode>();
+  if (extern_func == nullptr) {
+    return false;
+  }
+  for (const ffi::Module& ext_mod : ext_mods) {
+    if (ext_mod->ImplementsFunction(extern_func->global_symbol)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief Rewrite each `y = R.call_dps_packed(ext_func, (x, ...))` of a dataflow block, where
+ * ext_func is a function of the external modules, into
+ *
+ *   y_pending = R.call_dps_packed("vm.builtin.external_call_async", (ext_func, stream, x, ...))
+ *   ...  # the bindings that do not depend on y
+ *   y = R.external_call_wait(y_pending, (x, ...), stream)
+ *
+ * where the wait is emitted right before the first binding that uses y, or at the end of the
+ * block if y is only used outside of it. The external calls in flight at the same time run on
+ * different streams, up to the number of streams.
+ */
+DataflowBlock ScheduleExternCallsInBlock(const DataflowBlock& block,
+                                         const ffi::Array<ffi::Module>& ext_mods,
+                                         int num_streams) {
+  static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+  static const Op& external_call_wait_op = Op::Get("relax.external_call_wait");
+  static const ExternFunc external_call_async{"vm.builtin.external_call_async"};
+
+  ffi::Array<Binding> new_bindings;
+  // The waits that are not emitted yet with their stream, in the order of their external call.
+  std::vector<std::tuple<const VarNode*, Binding, int64_t>> pending_waits;
+  bool changed = false;
+
+  for (const Binding& binding : block->bindings) {
+    Expr value = GetBoundValue(binding);
+    if (!pending_waits.empty()) {
+      std::unordered_set<const VarNode*> used_vars;
+      for (const Var& var : FreeVars(value)) {
+        used_vars.insert(var.get());
+      }
+      std::vector<std::tuple<const VarNode*, Binding, int64_t>> remaining;
+      for (auto& [var, wait, stream] : pending_waits) {
+        if (used_vars.count(var)) {
+          new_bindings.push_back(wait);
+        } else {
+          remaining.emplace_back(var, std::move(wait), stream);
+        }
+      }
+      pending_waits = std::move(remaining);
+    }
+
+    const auto* call = value.as<CallNode>();
+    // Only the calls with a single tensor output are waited for, as the memory planning tracks
+    // the result of a wait as an alias of its input.
+    if (binding->IsInstance<VarBindingNode>() && call && call->op.same_as(call_dps_packed_op) &&
+        IsExternalModuleFunc(call->args[0], ext_mods) && call->args[1]->IsInstance<TupleNode>() &&
+        GetStructInfo(binding->var)->IsInstance<TensorStructInfoNode>()) {
+      Tuple args = Downcast<Tuple>(call->args[1]);
+      // Take the first stream without an external call in flight, if any.
+      std::vector<bool> busy(num_streams, false);
+      for (const auto& [var, wait, stream] : pending_waits) {
+        busy[stream] = true;
+      }
+      int64_t stream_index = static_cast<int64_t>(pending_waits.size() % num_streams);
+      for (int i = 0; i < num_streams; ++i) {
+        if (!busy[i]) {
+          stream_index = i;
+          break;
+        }
+      }
+      ffi::Array<Expr> async_args{call->args[0], PrimValue::Int64(stream_index)};
+      for (const Expr& arg : args->fields) {
+        async_args.push_back(arg);
+      }
+      StructInfo sinfo = GetStructInfo(binding->var);
+      DataflowVar pending_var(binding->var->name_hint() + "_pending", sinfo);
+      Call start(call_dps_packed_op, {external_call_async, Tuple(async_args)}, call->attrs,
+                 call->sinfo_args, call->span);
+      Call wait(external_call_wait_op, {pending_var, args, PrimValue::Int64(stream_index)}, {},
+                {}, call->span);
+      UpdateStructInfo(start, sinfo);
+      UpdateStructInfo(wait, sinfo);
+      new_bindings.push_back(VarBinding(pending_var, start));
+      pending_waits.emplace_back(binding->var.get(), VarBinding(binding->var, wait), stream_index);
+      changed = true;
+    } else {
+      new_bindings.push_back(binding);
+    }
+  }
+  for (auto& [var, wait, stream] : pending_waits) {
+    new_bindings.push_back(wait);
+  }
+
+  if (!changed) {
+    return block;
+  }
+  return DataflowBlock(new_bindings, block->span);
+}
+
+}  // namespace
+
+namespace transform {
+
+Pass ScheduleAsyncExternCalls(int num_streams) {
+  CHECK_GT(num_streams, 0) << "ValueError: The number of streams must be positive, but got "
+                           << num_streams;
+  auto pass_func = [=](DataflowBlock block, IRModule mod, PassContext pc) {
+    auto ext_mods = mod->GetAttr<ffi::Array<ffi::Module>>(tvm::attr::kExternalMods);
+    if (!ext_mods.has_value() || ext_mods.value().empty()) {
+      return block;
+    }
+    return ScheduleExternCallsInBlock(block, ext_mods.value(), num_streams);
+  };
+  return CreateDataflowBlockPass(pass_func, 0, "ScheduleAsyncExternCalls", {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.ScheduleAsyncExternCalls", ScheduleAsyncExternCalls);
+}
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
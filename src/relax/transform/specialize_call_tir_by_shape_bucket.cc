@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/specialize_call_tir_by_shape_bucket.cc
+ * \brief Specialize the kernels of call_tir for shape buckets of a symbolic variable, and
+ *  dispatch the calls to the variant of their bucket at runtime.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+
+#include <map>
+#include <utility>
+
+namespace tvm {
+namespace relax {
+
+class ShapeBucketSpecializer : public ExprMutator {
+ public:
+  static IRModule Specialize(IRModule mod, ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                             bool tune_online) {
+    return ShapeBucketSpecializer(mod, buckets, tune_online).Specialize();
+  }
+
+ private:
+  explicit ShapeBucketSpecializer(IRModule mod,
+                                  ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                                  bool tune_online)
+      : ExprMutator(mod), buckets_(buckets), tune_online_(tune_online) {}
+
+  IRModule Specialize() {
+    auto mod = builder_->GetContextIRModule();
+    for (const auto& [gv, base_func] : mod->functions) {
+      const auto* func_ = base_func.as<FunctionNode>();
+      if (func_ == nullptr || func_->HasNonzeroAttr(attr::kPrimitive)) {
+        continue;
+      }
+      Expr new_func_body = VisitExpr(func_->body);
+      auto new_func = ffi::make_object<FunctionNode>(*func_);
+      new_func->body = new_func_body;
+      builder_->UpdateFunction(gv, Function(new_func));
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  using ExprMutator::VisitExpr_;
+  Expr VisitExpr_(const CallNode* op) final {
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    // The calls with extra symbolic arguments are left generic.
+    if (!call->op.same_as(call_tir_op) || call->args.size() != 2) {
+      return call;
+    }
+    GlobalVar gv = Downcast<GlobalVar>(call->args[0]);
+    auto opt_func = builder_->GetContextIRModule()->functions.Get(gv);
+    if (!opt_func.has_value() || !opt_func.value()->IsInstance<tir::PrimFuncNode>()) {
+      return call;
+    }
+    tir::PrimFunc func = Downcast<tir::PrimFunc>(opt_func.value());
+    ffi::Array<Expr> args = Downcast<Tuple>(call->args[1])->fields;
+    ffi::Array<StructInfo> out_sinfo;
+    if (const auto* tuple_sinfo = call->sinfo_args[0].as<TupleStructInfoNode>()) {
+      out_sinfo = tuple_sinfo->fields;
+    } else {
+      out_sinfo = {call->sinfo_args[0]};
+    }
+    if (func->params.size() != args.size() + out_sinfo.size()) {
+      return call;
+    }
+
+    // Find the first bucketed variable in the buffer shapes, and its value at the call site.
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      auto opt_buffer = func->buffer_map.Get(func->params[i]);
+      StructInfo sinfo = i < args.size() ? GetStructInfo(args[i]) : out_sinfo[i - args.size()];
+      const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+      if (!opt_buffer.has_value() || tensor_sinfo == nullptr) {
+        continue;
+      }
+      ffi::Optional<ffi::Array<PrimExpr>> shape = tensor_sinfo->GetShape();
+      const tir::Buffer& buffer = opt_buffer.value();
+      if (!shape.defined() || shape.value().size() != buffer->shape.size()) {
+        continue;
+      }
+      for (size_t k = 0; k < buffer->shape.size(); ++k) {
+        const auto* var = buffer->shape[k].as<tir::VarNode>();
+        if (var == nullptr || !buckets_.count(var->name_hint)) {
+          continue;
+        }
+        ffi::Array<Integer> bounds = buckets_.at(var->name_hint);
+        ffi::Array<Expr> variants = GetVariants(gv, func, ffi::GetRef<tir::Var>(var), bounds);
+        ffi::Array<Expr> dispatch_args{PrimValue(shape.value()[k]),
+                                       ShapeExpr(bounds.Map([](Integer b) -> PrimExpr {
+                                         return IntImm(DataType::Int(64), b->value);
+                                       })),
+                                       Tuple(variants), PrimValue(Bool(tune_online_))};
+        for (const Expr& arg : args) {
+          dispatch_args.push_back(arg);
+        }
+        static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+        return Call(call_dps_packed_op,
+                    {ExternFunc("vm.builtin.shape_bucket_dispatch"), Tuple(dispatch_args)},
+                    call->attrs, call->sinfo_args);
+      }
+    }
+    return call;
+  }
+
+  /*!
+   * \brief Get the variants of a kernel for the buckets of a variable, and the generic kernel.
+   *
+   * The variant of a bucket is a copy of the kernel annotated with the upper bound of the bucket
+   * in its "tir_var_upper_bound" attribute, for the kernel to be scheduled or tuned for the
+   * shapes of the bucket.
+   */
+  ffi::Array<Expr> GetVariants(const GlobalVar& gv, const tir::PrimFunc& func, const tir::Var& var,
+                               const ffi::Array<Integer>& bounds) {
+    auto key = std::make_pair(gv.get(), std::string(var->name_hint));
+    auto it = variants_.find(key);
+    if (it != variants_.end()) {
+      return it->second;
+    }
+    ffi::Array<Expr> variants;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+      CHECK(i == 0 || bounds[i - 1]->value < bounds[i]->value)
+          << "ValueError: The bucket bounds of " << var->name_hint
+          << " must be increasing, but got " << bounds;
+      ffi::Map<ffi::String, Any> upper_bounds{{var->name_hint, bounds[i]}};
+      tir::PrimFunc variant = WithAttr(func, "tir_var_upper_bound", upper_bounds);
+      std::string name_hint = std::string(gv->name_hint) + "_" + std::string(var->name_hint) +
+                              "_le" + std::to_string(bounds[i]->value);
+      GlobalVar variant_gv = builder_->AddFunction(variant, name_hint);
+      if (func->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol).has_value()) {
+        variant = WithAttr(variant, tvm::attr::kGlobalSymbol, variant_gv->name_hint);
+        builder_->UpdateFunction(variant_gv, variant);
+      }
+      variants.push_back(variant_gv);
+    }
+    variants.push_back(gv);
+    variants_[key] = variants;
+    return variants;
+  }
+
+  /*! \brief The upper bounds of the buckets of each symbolic variable, by name. */
+  ffi::Map<ffi::String, ffi::Array<Integer>> buckets_;
+  /*! \brief Whether the dispatcher benchmarks the variants of a bucket on its first call. */
+  bool tune_online_;
+  /*! \brief The variants of the kernels already specialized, by kernel and variable. */
+  std::map<std::pair<const GlobalVarNode*, std::string>, ffi::Array<Expr>> variants_;
+};
+
+namespace transform {
+
+Pass SpecializeCallTIRByShapeBucket(ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                                    bool tune_online) {
+  auto pass_func = [=](IRModule m, PassContext pc) {
+    return ShapeBucketSpecializer::Specialize(m, buckets, tune_online);
+  };
+  return CreateModulePass(pass_func, 0, "SpecializeCallTIRByShapeBucket", {});
+}
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.SpecializeCallTIRByShapeBucket",
+                        SpecializeCallTIRByShapeBucket);
+}
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,256 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/specialize_shape_buckets.cc
+ * \brief Specialize Relax functions for shape buckets of a symbolic variable, and dispatch to
+ *  the static function of the bucket with padding.
+ */
+
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/block_builder.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/tir/analysis.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../op/tensor/create.h"
+#include "../op/tensor/index.h"
+#include "../op/tensor/manipulate.h"
+
+namespace tvm {
+namespace relax {
+
+class ShapeBucketCloner {
+ public:
+  static IRModule Specialize(IRModule mod, ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                             ffi::Optional<ffi::String> func_name) {
+    return ShapeBucketCloner(mod, buckets, func_name).Specialize();
+  }
+
+ private:
+  explicit ShapeBucketCloner(IRModule mod, ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                             ffi::Optional<ffi::String> func_name)
+      : builder_(BlockBuilder::Create(mod)), buckets_(buckets), func_name_(func_name) {}
+
+  IRModule Specialize() {
+    std::vector<std::pair<GlobalVar, Function>> funcs;
+    for (const auto& [gv, base_func] : builder_->GetContextIRModule()->functions) {
+      if (auto opt_func = base_func.as<Function>()) {
+        if (!opt_func.value()->HasNonzeroAttr(attr::kPrimitive) &&
+            (!func_name_.has_value() || gv->name_hint == func_name_.value())) {
+          funcs.emplace_back(gv, opt_func.value());
+        }
+      }
+    }
+    for (const auto& [gv, func] : funcs) {
+      ffi::Array<tir::Var> param_vars;
+      for (const Var& param : func->params) {
+        for (const tir::Var& var : DefinableTIRVarsInStructInfo(GetStructInfo(param))) {
+          param_vars.push_back(var);
+        }
+      }
+      // Bucket the first variable defined by the parameters that has buckets.
+      for (const tir::Var& var : param_vars) {
+        if (!buckets_.count(var->name_hint) || !IsPaddable(func, var)) {
+          continue;
+        }
+        builder_->UpdateFunction(gv, MakeDispatcher(gv, func, var, buckets_.at(var->name_hint)));
+        break;
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  /*!
+   * \brief Whether the parameters of a function can be padded along a variable, and its
+   *  results sliced back, i.e. the variable only appears as the extent of tensor dimensions.
+   */
+  static bool IsPaddable(const Function& func, const tir::Var& var) {
+    for (const Var& param : func->params) {
+      if (!IsPaddable(GetStructInfo(param), var)) {
+        return false;
+      }
+    }
+    return IsPaddable(func->ret_struct_info, var);
+  }
+
+  static bool IsPaddable(const StructInfo& sinfo, const tir::Var& var) {
+    auto f_uses_var = [&](const tir::VarNode* v) { return v == var.get(); };
+    if (const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>()) {
+      ffi::Optional<ffi::Array<PrimExpr>> shape = tensor_sinfo->GetShape();
+      if (!shape.defined()) {
+        return true;
+      }
+      for (const PrimExpr& dim : shape.value()) {
+        if (!dim.same_as(var) && tir::UsesVar(dim, f_uses_var)) {
+          return false;
+        }
+      }
+      return true;
+    } else if (const auto* tuple_sinfo = sinfo.as<TupleStructInfoNode>()) {
+      for (const StructInfo& field : tuple_sinfo->fields) {
+        if (!IsPaddable(field, var)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    for (const tir::Var& v : TIRVarsInStructInfo(sinfo)) {
+      if (v.same_as(var)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Add the clones of a function with the variable bound to each bucket bound and the
+   *  generic clone, and make the function dispatch to them.
+   */
+  Function MakeDispatcher(const GlobalVar& gv, const Function& func, const tir::Var& var,
+                          const ffi::Array<Integer>& bounds) {
+    std::string prefix = std::string(gv->name_hint) + "_" + std::string(var->name_hint);
+    auto f_add_clone = [&](ffi::Map<tir::Var, PrimExpr> binding, const std::string& name) {
+      Function clone = CopyWithNewVars(Downcast<Function>(Bind(func, {}, binding)));
+      clone = WithoutAttr(std::move(clone), tvm::attr::kGlobalSymbol);
+      return builder_->AddFunction(clone, name);
+    };
+
+    builder_->BeginScope(func->params);
+    // The generic clone handles the values beyond the last bucket.
+    Expr result = WrapInSeq(Call(f_add_clone({}, prefix + "_dynamic"), func->params));
+    for (int i = static_cast<int>(bounds.size()) - 1; i >= 0; --i) {
+      CHECK(i == 0 || bounds[i - 1]->value < bounds[i]->value)
+          << "ValueError: The bucket bounds of " << var->name_hint
+          << " must be increasing, but got " << bounds;
+      PrimExpr bound = IntImm(var->dtype, bounds[i]->value);
+      GlobalVar static_gv = f_add_clone({{var, bound}}, prefix + std::to_string(bounds[i]->value));
+
+      builder_->BeginBindingBlock();
+      ffi::Array<Expr> args;
+      for (const Var& param : func->params) {
+        args.push_back(Pad(param, var, bound));
+      }
+      Var out = builder_->Emit(Call(static_gv, args), "out");
+      Expr ret = Slice(out, func->ret_struct_info, var);
+      if (!ret->IsInstance<VarNode>()) {
+        ret = builder_->Emit(ret);
+      }
+      Expr branch = SeqExpr({builder_->EndBlock()}, ret);
+      result = WrapInSeq(If(PrimValue(var <= bound), branch, result));
+    }
+    builder_->EndScope();
+
+    return Function(func->params, result, func->ret_struct_info, func->is_pure, func->attrs,
+                    func->span);
+  }
+
+  /*! \brief Bind an expression to a variable in a SeqExpr of its own. */
+  Expr WrapInSeq(Expr expr) {
+    builder_->BeginBindingBlock();
+    Var var = builder_->Emit(expr);
+    return SeqExpr({builder_->EndBlock()}, var);
+  }
+
+  /*! \brief Pad the dimensions of a tensor along the variable with zeros, up to the bound. */
+  Expr Pad(Expr x, const tir::Var& var, const PrimExpr& bound) {
+    const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(x);
+    if (tensor_sinfo == nullptr || !tensor_sinfo->GetShape().defined()) {
+      return x;
+    }
+    ffi::Array<PrimExpr> shape = tensor_sinfo->GetShape().value();
+    bool padded = false;
+    for (size_t k = 0; k < shape.size(); ++k) {
+      if (!shape[k].same_as(var)) {
+        continue;
+      }
+      ffi::Array<PrimExpr> pad_shape = shape;
+      pad_shape.Set(k, bound - var);
+      Expr pad_zeros = builder_->Emit(zeros(ShapeExpr(pad_shape), tensor_sinfo->dtype));
+      x = builder_->Emit(concat(Tuple({x, pad_zeros}), static_cast<int64_t>(k)));
+      shape.Set(k, bound);
+      padded = true;
+    }
+    if (!padded) {
+      return x;
+    }
+    return builder_->EmitMatchCast(
+        x, TensorStructInfo(ShapeExpr(shape), tensor_sinfo->dtype, tensor_sinfo->vdevice));
+  }
+
+  /*! \brief Slice the results of the static clone back to the struct info of the function. */
+  Expr Slice(Expr x, const StructInfo& sinfo, const tir::Var& var) {
+    if (const auto* tuple_sinfo = sinfo.as<TupleStructInfoNode>()) {
+      ffi::Array<Expr> fields;
+      for (size_t i = 0; i < tuple_sinfo->fields.size(); ++i) {
+        Expr field = builder_->Emit(TupleGetItem(x, i));
+        fields.push_back(Slice(field, tuple_sinfo->fields[i], var));
+      }
+      return Tuple(fields);
+    }
+    const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+    if (tensor_sinfo == nullptr || !tensor_sinfo->GetShape().defined()) {
+      return x;
+    }
+    ffi::Array<PrimExpr> shape = tensor_sinfo->GetShape().value();
+    bool sliced = false;
+    for (size_t k = 0; k < shape.size(); ++k) {
+      if (!shape[k].same_as(var)) {
+        continue;
+      }
+      x = builder_->Emit(
+          strided_slice(x, Tuple({PrimValue::Int64(k)}), Tuple({PrimValue::Int64(0)}),
+                        Tuple({PrimValue(var)}), std::nullopt, /*assume_inbound=*/true));
+      sliced = true;
+    }
+    if (!sliced) {
+      return x;
+    }
+    return builder_->EmitMatchCast(x, sinfo);
+  }
+
+  BlockBuilder builder_;
+  /*! \brief The increasing upper bounds of the buckets of each symbolic variable, by name. */
+  ffi::Map<ffi::String, ffi::Array<Integer>> buckets_;
+  /*! \brief The name of the only function to specialize, if any. */
+  ffi::Optional<ffi::String> func_name_;
+};
+
+namespace transform {
+
+Pass SpecializeShapeBuckets(ffi::Map<ffi::String, ffi::Array<Integer>> buckets,
+                            ffi::Optional<ffi::String> func_name) {
+  auto pass_func = [=](IRModule m, PassContext pc) {
+    return ShapeBucketCloner::Specialize(m, buckets, func_name);
+  };
+  return CreateModulePass(pass_func, 0, "SpecializeShapeBuckets", {});
+}
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("relax.transform.SpecializeShapeBuckets", SpecializeShapeBuckets);
+}
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
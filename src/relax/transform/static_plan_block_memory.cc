@@ -64,6 +64,23 @@
  * It means the maximum value of variable that names "n" in the function
  * signature will have upper bound 1024. And we will use 1024 as its value
  * during memory planning.
+ *
+ * With the pass config "relax.StaticPlanBlockMemory.mode" set to "offset",
+ * the tokens of constant size in the global scope are not reused as a whole.
+ * Instead, the lifetime of each of them is recorded in the allocation stage,
+ * and the tensors of each binding block and device are packed into a single
+ * arena storage at different byte offsets, greedily by decreasing size, each
+ * into the smallest gap among the tensors whose lifetimes overlap with it.
+ * A tensor placed at a non-zero offset is wrapped by `memory.ensure_zero_offset`,
+ * as the PrimFuncs expect the data pointer to be the start of the tensor.
+ *
+ * The tensors whose sizes stay symbolic after applying the upper bounds are
+ * packed as well, as long as their sizes only depend on the TIR variables of
+ * the function signature. They are placed after the constant-size tensors of
+ * the arena, in slots shared by the tensors with disjoint lifetimes, so that
+ * their offsets and the arena size are symbolic expressions evaluated at
+ * runtime (see ComputePrimValue). The mode can be overridden per function
+ * with the function attribute "relax.memory_plan_mode".
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/ffi/reflection/registry.h>
@@ -71,13 +88,19 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/transform.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <tuple>
+#include <unordered_set>
 #include <vector>
 
 #include "../../runtime/texture.h"
+#include "../op/memory/view.h"
 #include "utils.h"
 
 namespace tvm {
@@ -321,12 +344,153 @@ class TokenAllocatorMixed {
   std::vector<StorageToken> full_pool_;
 };
 
+/*!
+ * \brief Check if the input op waits for the result of an asynchronous op, which it returns, while
+ * the inputs of the asynchronous op, given as its second argument, are in use until the wait.
+ */
+bool IsAsyncWaitOp(const Expr& op) {
+  static const Op& allreduce_wait_op = Op::Get("relax.ccl.allreduce_wait");
+  static const Op& ring_send_recv_wait_op = Op::Get("relax.ccl.ring_send_recv_wait");
+  static const Op& external_call_wait_op = Op::Get("relax.external_call_wait");
+  return op.same_as(allreduce_wait_op) || op.same_as(ring_send_recv_wait_op) ||
+         op.same_as(external_call_wait_op);
+}
+
 /*! \brief Check if the input op is a memory op that may return the same buffer. */
 bool IsInplaceMemoryOp(const Expr& op) {
   static const Op& reshape_op = Op::Get("relax.reshape");
   static const Op& view_op = Op::Get("relax.memory.view");
   static const Op& ensure_zero_offset_op = Op::Get("relax.memory.ensure_zero_offset");
-  return op.same_as(reshape_op) || op.same_as(view_op) || op.same_as(ensure_zero_offset_op);
+  return op.same_as(reshape_op) || op.same_as(view_op) || op.same_as(ensure_zero_offset_op) ||
+         IsAsyncWaitOp(op);
+}
+
+/*!
+ * \brief The lifetime of a tensor that is planned into an arena in the offset mode.
+ * \note The lifetime is measured in the visiting order of the bindings, both ends included.
+ */
+struct ArenaInterval {
+  /*! \brief The token of the tensor. */
+  StorageToken token;
+  /*! \brief The `builtin.alloc_tensor` of the tensor. */
+  const ExprNode* alloc_tensor;
+  /*! \brief The binding block of the allocation. */
+  const BindingBlockNode* block;
+  /*! \brief The runtime device index of the allocation. */
+  int64_t device_index;
+  /*! \brief The binding that allocates the tensor. */
+  int begin;
+  /*! \brief The binding that releases the tensor, or -1 if it is never released. */
+  int end{-1};
+  /*! \brief The planned byte offset in the arena, for the constant-size tensors. */
+  int64_t offset{0};
+};
+
+/*! \brief Round the number of bytes up to the allocation alignment. */
+PrimExpr AlignBytes(PrimExpr bytes) {
+  PrimExpr alignment = IntImm(DataType::Int(64), runtime::kAllocAlignment);
+  return floordiv(bytes + alignment - 1, alignment) * alignment;
+}
+
+/*!
+ * \brief Assign the byte offsets of the tensors of one arena.
+ * \param intervals The tensors of the arena, whose offsets are assigned.
+ * \return The number of bytes of the arena.
+ */
+int64_t PackArena(const std::vector<ArenaInterval*>& intervals) {
+  auto align = [](int64_t bytes) {
+    return (bytes + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+           runtime::kAllocAlignment;
+  };
+  std::vector<ArenaInterval*> order = intervals;
+  std::stable_sort(order.begin(), order.end(), [](ArenaInterval* a, ArenaInterval* b) {
+    return a->token->const_bytes() > b->token->const_bytes();
+  });
+  std::vector<ArenaInterval*> placed;
+  int64_t arena_bytes = 0;
+  for (ArenaInterval* interval : order) {
+    int64_t size = interval->token->const_bytes();
+    std::vector<ArenaInterval*> overlapped;
+    for (ArenaInterval* other : placed) {
+      if (other->begin <= interval->end && interval->begin <= other->end) {
+        overlapped.push_back(other);
+      }
+    }
+    std::sort(overlapped.begin(), overlapped.end(),
+              [](ArenaInterval* a, ArenaInterval* b) { return a->offset < b->offset; });
+    // Take the smallest gap that fits, or the end of the overlapped tensors.
+    int64_t candidate = 0;
+    int64_t best_offset = -1;
+    int64_t best_gap = 0;
+    for (ArenaInterval* other : overlapped) {
+      int64_t gap = other->offset - candidate;
+      if (gap >= size && (best_offset == -1 || gap < best_gap)) {
+        best_offset = candidate;
+        best_gap = gap;
+      }
+      candidate = std::max(candidate, align(other->offset + other->token->const_bytes()));
+    }
+    interval->offset = best_offset != -1 ? best_offset : candidate;
+    arena_bytes = std::max(arena_bytes, interval->offset + size);
+    placed.push_back(interval);
+  }
+  return arena_bytes;
+}
+
+/*!
+ * \brief Assign the byte offsets of the symbolic-size tensors of one arena. The tensors with
+ *  disjoint lifetimes share a slot, when the size of one provably covers the other.
+ * \param intervals The symbolic-size tensors of the arena, in the order of allocation.
+ * \param base The byte offset of the first slot.
+ * \param analyzer The arithmetic analyzer.
+ * \param offsets The byte offset of each tensor.
+ * \return The number of bytes of the arena.
+ */
+PrimExpr PackDynamicArena(const std::vector<ArenaInterval*>& intervals, PrimExpr base,
+                          arith::Analyzer* analyzer,
+                          std::unordered_map<const ArenaInterval*, PrimExpr>* offsets) {
+  struct Slot {
+    PrimExpr bytes;
+    int end;
+    std::vector<const ArenaInterval*> members;
+  };
+  std::vector<Slot> slots;
+  for (const ArenaInterval* interval : intervals) {
+    const PrimExpr& bytes = interval->token->bytes;
+    auto it = std::find_if(slots.begin(), slots.end(), [&](const Slot& slot) {
+      return slot.end < interval->begin && (analyzer->CanProve(bytes <= slot.bytes) ||
+                                            analyzer->CanProve(slot.bytes <= bytes));
+    });
+    if (it == slots.end()) {
+      slots.push_back(Slot{bytes, interval->end, {}});
+      it = slots.end() - 1;
+    } else if (!analyzer->CanProve(bytes <= it->bytes)) {
+      it->bytes = bytes;
+    }
+    it->end = interval->end;
+    it->members.push_back(interval);
+  }
+  PrimExpr offset = base;
+  PrimExpr arena_bytes = base;
+  for (const Slot& slot : slots) {
+    for (const ArenaInterval* member : slot.members) {
+      (*offsets)[member] = offset;
+    }
+    arena_bytes = analyzer->Simplify(offset + slot.bytes);
+    offset = analyzer->Simplify(offset + AlignBytes(slot.bytes));
+  }
+  return arena_bytes;
+}
+
+/*!
+ * \brief Get whether a function is planned in the offset mode.
+ * \param mode The mode of the pass config, or of the attribute of the function.
+ */
+bool IsOffsetMode(const ffi::String& mode) {
+  CHECK(mode == "token" || mode == "offset")
+      << "ValueError: The memory planning mode must be \"token\" or \"offset\", but got \""
+      << mode << "\"";
+  return mode == "offset";
 }
 
 /*! \brief The base class for the storage allocation visitor. */
@@ -552,6 +716,11 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
     } else if (IsInplaceMemoryOp(call->op)) {
       // Reuse the input's token for builtin reshape.
       SetTokens(call, GetTokens(call->args[0]));
+      if (IsAsyncWaitOp(call->op)) {
+        // The inputs of the asynchronous op are still read by its stream until the wait.
+        Tokens tokens = GetTokensWithAllocSiteCheck(call->args[1], block_stack_.back());
+        ForEachLeaf(tokens, [](StorageToken token) { token->ref_counter += 1; });
+      }
       return;
     }
 
@@ -746,8 +915,8 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
 class StorageAllocator : public StorageAllocatorBaseVisitor {
  public:
   explicit StorageAllocator(std::unordered_map<const ExprNode*, Tokens> token_map,
-                            arith::Analyzer* analyzer)
-      : allocator_(analyzer) {
+                            arith::Analyzer* analyzer, bool offset_mode)
+      : analyzer_(analyzer), default_offset_mode_(offset_mode), allocator_(analyzer) {
     this->token_map_ = std::move(token_map);
   }
 
@@ -759,7 +928,20 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
       }
       // Clear the allocator to make the planning of different functions independent.
       allocator_.Clear();
+      arena_intervals_.clear();
+      token2interval_.clear();
+      offset_mode_ = default_offset_mode_;
+      if (auto mode = func->GetAttr<ffi::String>("relax.memory_plan_mode")) {
+        offset_mode_ = IsOffsetMode(mode.value());
+      }
+      signature_vars_.clear();
+      for (const Var& param : func->params) {
+        for (const tir::Var& var : DefinableTIRVarsInStructInfo(GetStructInfo(param))) {
+          signature_vars_.insert(var.get());
+        }
+      }
       this->VisitExpr_(func);
+      this->PlanArenas();
     }
   }
 
@@ -768,6 +950,8 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
    * underlying storage token that it is using.
    */
   std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token;
+  /*! \brief The byte offset of each `builtin.alloc_tensor` in its token, if it is not zero. */
+  std::unordered_map<const ExprNode*, PrimExpr> alloc_tensor2offset;
   /*! \brief The mapping from each binding block to the storage tokens that are create inside. */
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens;
 
@@ -775,6 +959,92 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
   using ExprVisitor::VisitBinding_;
   using ExprVisitor::VisitExpr_;
 
+  void VisitBinding(const Binding& binding) final {
+    ++binding_index_;
+    StorageAllocatorBaseVisitor::VisitBinding(binding);
+  }
+
+  /*! \brief Whether the tensor of the token is planned into an arena in the offset mode. */
+  bool IsArenaCandidate(const StorageToken& prototype, const Call& alloc_tensor) const {
+    if (!offset_mode_ || prototype->storage_scope != "global") {
+      return false;
+    }
+    if (prototype->vdevice.defined() && prototype->vdevice.value()->memory_scope != "global") {
+      return false;
+    }
+    // The arena is allocated before the tensors, so its size can only use the signature vars.
+    for (const tir::Var& var : tir::UndefinedVars(prototype->bytes)) {
+      if (!signature_vars_.count(var.get())) {
+        return false;
+      }
+    }
+    const auto* device_index = Downcast<PrimValue>(alloc_tensor->args[2])->value.as<IntImmNode>();
+    return device_index != nullptr;
+  }
+
+  /*! \brief Pack the tensors of each binding block and device into one arena. */
+  void PlanArenas() {
+    std::map<std::tuple<const BindingBlockNode*, int64_t>, std::vector<ArenaInterval*>> arenas;
+    std::vector<std::tuple<const BindingBlockNode*, int64_t>> arena_order;
+    for (ArenaInterval& interval : arena_intervals_) {
+      if (interval.end == -1) interval.end = binding_index_;
+      auto key = std::make_tuple(interval.block, interval.device_index);
+      if (!arenas.count(key)) arena_order.push_back(key);
+      arenas[key].push_back(&interval);
+    }
+    for (const auto& key : arena_order) {
+      const std::vector<ArenaInterval*>& intervals = arenas[key];
+      std::vector<ArenaInterval*> const_intervals;
+      std::vector<ArenaInterval*> dynamic_intervals;
+      for (ArenaInterval* interval : intervals) {
+        if (interval->token->const_bytes() >= 0) {
+          const_intervals.push_back(interval);
+        } else {
+          dynamic_intervals.push_back(interval);
+        }
+      }
+      // The constant-size tensors come first, then the slots of the symbolic-size ones.
+      int64_t const_bytes = PackArena(const_intervals);
+      std::unordered_map<const ArenaInterval*, PrimExpr> offsets;
+      for (ArenaInterval* interval : const_intervals) {
+        offsets[interval] = IntImm(DataType::Int(64), interval->offset);
+      }
+      PrimExpr arena_bytes = IntImm(DataType::Int(64), const_bytes);
+      if (!dynamic_intervals.empty()) {
+        PrimExpr base = IntImm(DataType::Int(64), const_intervals.empty() ? 0 : const_bytes);
+        arena_bytes = PackDynamicArena(dynamic_intervals, analyzer_->Simplify(AlignBytes(base)),
+                                       analyzer_, &offsets);
+      }
+      // The arena takes the dtype of its largest constant-size tensor, or of its first tensor.
+      ArenaInterval* largest = const_intervals.empty()
+                                   ? intervals[0]
+                                   : *std::max_element(const_intervals.begin(),
+                                                       const_intervals.end(),
+                                                       [](ArenaInterval* a, ArenaInterval* b) {
+                                                         return a->token->const_bytes() <
+                                                                b->token->const_bytes();
+                                                       });
+      StorageToken arena({IntImm(DataType::Int(64), 1)}, DataType::UInt(8), "global");
+      arena->bytes = arena_bytes;
+      arena->dtype = largest->token->dtype;
+      arena->storage_id = this->n_storage_++;
+
+      std::vector<const StorageTokenNode*>& block_tokens = block2tokens[std::get<0>(key)];
+      for (ArenaInterval* interval : intervals) {
+        alloc_tensor2token[interval->alloc_tensor] = arena;
+        const PrimExpr& offset = offsets.at(interval);
+        if (!tir::is_zero(offset)) {
+          alloc_tensor2offset[interval->alloc_tensor] = offset;
+        }
+        block_tokens.erase(
+            std::remove(block_tokens.begin(), block_tokens.end(), interval->token.get()),
+            block_tokens.end());
+      }
+      block_tokens.push_back(arena.get());
+      arena_tokens_.push_back(arena);
+    }
+  }
+
   void VisitBindingBlock_(const BindingBlockNode* block) final {
     StorageAllocatorBaseVisitor::VisitBindingBlock_(block);
     // Sanity check: each token allocated inside the block should not be
@@ -796,7 +1066,20 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
         return;
       }
       ICHECK(it->second.IsLeaf());
-      StorageToken new_token = this->RequestReuseOrAlloc(it->second.LeafValue());
+      StorageToken new_token{nullptr};
+      Call alloc_tensor = ffi::GetRef<Call>(call);
+      if (IsArenaCandidate(it->second.LeafValue(), alloc_tensor)) {
+        // Every tensor gets a token of its own, which is packed into an arena afterwards.
+        new_token = allocator_.Alloc(it->second.LeafValue(), this->n_storage_++);
+        ICHECK(!block_stack_.empty());
+        ArenaInterval interval{new_token, call, block_stack_.back(),
+                               Downcast<PrimValue>(call->args[2])->value.as<IntImmNode>()->value,
+                               binding_index_};
+        token2interval_[new_token.get()] = arena_intervals_.size();
+        arena_intervals_.push_back(std::move(interval));
+      } else {
+        new_token = this->RequestReuseOrAlloc(it->second.LeafValue());
+      }
 
       // Record that this alloc_tensor is using the token.
       alloc_tensor2token.insert({call, new_token});
@@ -820,22 +1103,31 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
       } else {
         ICHECK(token_map_[call].IsNull());
       }
+      if (IsAsyncWaitOp(call->op)) {
+        ReleaseArgumentTokens(call->args[1]);
+      }
       return;
     }
 
-    // Decrease the reference counter by one for each token that the arguments use.
-    // Check if a token can be released (i.e., has no reference) after decrease.
-    // And release it if so.
     for (const Expr& arg : call->args) {
-      Tokens tokens = GetTokens(arg);
-      ForEachLeaf(tokens, [this](StorageToken token) {
-        ICHECK_GT(token->ref_counter, 0);
-        token->ref_counter -= 1;
-        this->CheckForRelease(token);
-      });
+      ReleaseArgumentTokens(arg);
     }
   }
 
+  /*!
+   * \brief Decrease the reference counter by one for each token that the argument uses.
+   * Check if a token can be released (i.e., has no reference) after decrease.
+   * And release it if so.
+   */
+  void ReleaseArgumentTokens(const Expr& arg) {
+    Tokens tokens = GetTokens(arg);
+    ForEachLeaf(tokens, [this](StorageToken token) {
+      ICHECK_GT(token->ref_counter, 0);
+      token->ref_counter -= 1;
+      this->CheckForRelease(token);
+    });
+  }
+
   /*! \brief Request a storage reuse, or allocate storage if no appropriate storage is reusable. */
   StorageToken RequestReuseOrAlloc(StorageToken prototype) {
     ffi::Optional<StorageToken> token = allocator_.RequestReuse(prototype);
@@ -856,7 +1148,13 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     ICHECK_GE(token->ref_counter, 0);
 
     if (token->ref_counter == 0) {
-      allocator_.Release(token);
+      auto it_interval = token2interval_.find(token.get());
+      if (it_interval != token2interval_.end()) {
+        // The arena tensors are not reused as a whole.
+        arena_intervals_[it_interval->second].end = binding_index_;
+      } else {
+        allocator_.Release(token);
+      }
       auto it = token2cur_tensor_.find(token.get());
       ICHECK(it != token2cur_tensor_.end());
       token2cur_tensor_.erase(it);
@@ -865,6 +1163,22 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   /*! \brief Number of allocated storages. */
   int n_storage_{0};
+  /*! \brief The arithmetic analyzer. */
+  arith::Analyzer* analyzer_;
+  /*! \brief Whether to pack the tensors into arenas at byte offsets, unless a function says. */
+  bool default_offset_mode_;
+  /*! \brief Whether to pack the tensors of the current function into arenas. */
+  bool offset_mode_{false};
+  /*! \brief The TIR vars defined by the signature of the current function. */
+  std::unordered_set<const tir::VarNode*> signature_vars_;
+  /*! \brief The index of the binding being visited. */
+  int binding_index_{-1};
+  /*! \brief The tensors of the current function that are planned into arenas. */
+  std::vector<ArenaInterval> arena_intervals_;
+  /*! \brief The index of the arena interval of each token. */
+  std::unordered_map<const StorageTokenNode*, size_t> token2interval_;
+  /*! \brief The arena tokens, kept alive for the rewriter. */
+  std::vector<StorageToken> arena_tokens_;
   /*! \brief The 1D memory allocator. */
   TokenAllocatorMixed allocator_;
   /*! \brief The mapping from each token to the tensors that are currently using it. */
@@ -881,10 +1195,12 @@ class StorageAllocationRewriter : public ExprMutator {
  public:
   explicit StorageAllocationRewriter(
       IRModule mod, std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token,
+      std::unordered_map<const ExprNode*, PrimExpr> alloc_tensor2offset,
       std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>>
           block2tokens)
       : ExprMutator(std::move(mod)),
         alloc_tensor2token_(std::move(alloc_tensor2token)),
+        alloc_tensor2offset_(std::move(alloc_tensor2offset)),
         block2tokens_(std::move(block2tokens)) {}
 
   IRModule Rewrite() {
@@ -946,11 +1262,19 @@ class StorageAllocationRewriter : public ExprMutator {
       }
 
       // And always create a `memory.alloc_tensor` for the old `builtin.alloc_tensor`.
-      PrimValue offset = PrimValue::Int64(0);
+      auto it_offset = alloc_tensor2offset_.find(call);
+      PrimValue offset = it_offset != alloc_tensor2offset_.end() ? PrimValue(it_offset->second)
+                                                                 : PrimValue::Int64(0);
       DataType dtype = sinfo->dtype;
-      return Call(mem_alloc_tensor,
-                  {storage_var, offset, sinfo->shape.value(), DataTypeImm(dtype), call->args[2]},
-                  Attrs());
+      Call alloc_tensor(mem_alloc_tensor,
+                        {storage_var, offset, sinfo->shape.value(), DataTypeImm(dtype),
+                         call->args[2]},
+                        Attrs());
+      if (it_offset == alloc_tensor2offset_.end()) {
+        return alloc_tensor;
+      }
+      // The PrimFuncs expect the tensors to start at their data pointer.
+      return ensure_zero_offset(builder_->Emit(alloc_tensor, "alloc"));
     } else if (plan_dynamic_output_ && call->op == alloc_tensor_op) {
       // Case 2. For a `alloc_tensor` that is not planned for memory reuse,
       // we would still like to allocate **static** memory for the tensor.
@@ -999,33 +1323,40 @@ class StorageAllocationRewriter : public ExprMutator {
    its corresponding underlying storage token that it is using.
    */
   std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token_;
+  /*! \brief The non-zero byte offset of each `builtin.alloc_tensor` in its storage. */
+  std::unordered_map<const ExprNode*, PrimExpr> alloc_tensor2offset_;
   /*! \brief The mapping from each binding block to the storage tokens that are create inside. */
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens_;
   /*! \brief The mapping from each token to its corresponding storage var in each function. */
   std::unordered_map<const StorageTokenNode*, Var> token2storage_var_;
 };
 
-IRModule StaticPlanBlockMemory(IRModule mod) {
+IRModule StaticPlanBlockMemory(IRModule mod, bool offset_mode) {
   arith::Analyzer ana;
 
   // Step 1. Initialize.
   std::unordered_map<const ExprNode*, Tokens> token_map =
       StorageAllocatorInit::Initialize(mod, &ana);
   // Step 2. Collect the memory allocation info.
-  StorageAllocator allocator(std::move(token_map), &ana);
+  StorageAllocator allocator(std::move(token_map), &ana, offset_mode);
   allocator.Allocate(mod);
   // Step 3. Rewrite the function.
   StorageAllocationRewriter rewriter(std::move(mod),  //
                                      std::move(allocator.alloc_tensor2token),
+                                     std::move(allocator.alloc_tensor2offset),
                                      std::move(allocator.block2tokens));
   return rewriter.Rewrite();
 }
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.StaticPlanBlockMemory.mode", ffi::String);
+
 Pass StaticPlanBlockMemory() {
   auto pass_func = [=](IRModule m, PassContext pc) {
-    return relax::StaticPlanBlockMemory(std::move(m));
+    ffi::String mode = pc->GetConfig<ffi::String>("relax.StaticPlanBlockMemory.mode")
+                           .value_or(ffi::String("token"));
+    return relax::StaticPlanBlockMemory(std::move(m), IsOffsetMode(mode));
   };
   return CreateModulePass(pass_func, /*opt_level=*/0, "StaticPlanBlockMemory", {});
 }
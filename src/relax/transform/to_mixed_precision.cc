@@ -22,17 +22,27 @@
  */
 
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/relax/attrs/manipulate.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include "../op/nn/convolution.h"
+#include "../op/tensor/binary.h"
 #include "../op/tensor/datatype.h"
 #include "../op/tensor/linear_algebra.h"
+#include "../op/tensor/manipulate.h"
+#include "../op/tensor/statistical.h"
+#include "../op/tensor/unary.h"
 #include "infer_amp_utils.h"
 #include "utils.h"
 
@@ -112,6 +122,15 @@ int GetMixedPrecisionInfo(const CallNode* call_node) {
  *
  *   When we encounter the var afterwards, we will directly replace it with the parameter. This
  *   information is tracked by the const_map_.
+ *
+ * FP8 mode:
+ *   With an fp8 dtype, the matmuls use fp8 inputs instead of fp16 ones. Each input is quantized
+ *   as x_fp8 = clip(x / scale, -fp8_max, fp8_max) with scale = amax(|x|) / fp8_max, and the
+ *   output of the matmul (accumulated in out_dtype) is dequantized by the product of the
+ *   scales. The amax is per tensor, or per channel (per row of the lhs and per output channel
+ *   of the rhs), and is either computed from the current tensor or given from calibration
+ *   (delayed scaling). The per-tensor form, with a transposed rhs, is the one of the scaled fp8
+ *   gemms of cuBLAS/CUTLASS: astype(matmul(x, permute_dims(w)) * (scale_x * scale_w)).
  */
 class DTypeDecisionCollector : public ExprVisitor {
  public:
@@ -269,13 +288,25 @@ class DTypeDecisionCollector : public ExprVisitor {
   VarDTypeMap only_fp16_map_;
 };
 
+/*! \brief The options of the FP8 mode of matmuls. */
+struct FP8Options {
+  /*! \brief The fp8 dtype of the inputs, float8_e4m3fn or float8_e5m2. */
+  DataType dtype;
+  /*! \brief Whether the scales are per channel instead of per tensor. */
+  bool per_channel = false;
+  /*! \brief The amax of the inputs from calibration, by var name. */
+  std::unordered_map<std::string, double> amax;
+};
+
 class ToMixedPrecisionRewriter : public ExprMutator {
  public:
   explicit ToMixedPrecisionRewriter(const VarDTypeMap* only_fp16_map, DataType output_dtype,
-                                    const std::unordered_set<std::string>& fp16_input_names)
+                                    const std::unordered_set<std::string>& fp16_input_names,
+                                    std::optional<FP8Options> fp8 = std::nullopt)
       : only_fp16_map_(only_fp16_map),
         output_dtype_(output_dtype),
-        fp16_input_names_(fp16_input_names) {}
+        fp16_input_names_(fp16_input_names),
+        fp8_(std::move(fp8)) {}
 
  private:
   Var GetRemapped(const Var& var) {
@@ -405,6 +436,118 @@ class ToMixedPrecisionRewriter : public ExprMutator {
     return true;
   }
 
+  // Whether a matmul is rewritten in fp8: both inputs must be floating-point matrices.
+  bool UseFP8(const Call& call) const {
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    if (!fp8_ || !call->op.same_as(matmul_op)) return false;
+    for (const Expr& arg : call->args) {
+      const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(arg);
+      if (tensor == nullptr || tensor->IsUnknownNdim() || tensor->ndim < 2 ||
+          (tensor->dtype != fp16_ && tensor->dtype != fp32_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::optional<double> CalibratedAmax(const std::vector<Expr>& exprs) const {
+    for (const Expr& expr : exprs) {
+      if (const auto* var = expr.as<VarNode>()) {
+        auto it = fp8_->amax.find(var->name_hint());
+        if (it != fp8_->amax.end()) return it->second;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /*!
+   * \brief Quantize a tensor to fp8.
+   * \param x The tensor.
+   * \param amax The amax of the tensor from calibration, if any.
+   * \param axis The reduction axis of the amax for per-channel scales, whose size is kept as 1.
+   * \return The quantized tensor and its scale in fp32, of shape (1,) for a per-tensor scale.
+   */
+  std::pair<Expr, Expr> QuantizeFP8(const Expr& x, std::optional<double> amax,
+                                    std::optional<int> axis) {
+    // the amax of an all-zero tensor must not give a zero scale
+    constexpr double kMinAmax = 1e-12;
+    DataType fp8_dtype = fp8_->dtype;
+    double fp8_max = fp8_dtype.is_float8_e5m2() ? 57344.0 : 448.0;
+    Expr x_fp32 = RewriteExpr(x, NTypeFrom(x, fp32_));
+    Expr scale;
+    if (amax && !axis) {
+      scale = MakeConstantScalar(std::max(amax.value(), kMinAmax) / fp8_max, fp32_);
+    } else {
+      ffi::Optional<ffi::Array<Integer>> axes = std::nullopt;
+      if (axis) axes = ffi::Array<Integer>{Integer(axis.value())};
+      Expr x_amax = max(abs(x_fp32), axes, /*keepdims=*/axis.has_value());
+      scale = divide(maximum(x_amax, MakeConstantScalar(kMinAmax, fp32_)),
+                     MakeConstantScalar(fp8_max, fp32_));
+    }
+    if (!axis) {
+      scale = reshape(scale, ffi::Array<PrimExpr>{IntImm(DataType::Int(64), 1)});
+    }
+    Var scale_var = builder_->Emit(scale);
+    Expr scaled = clip(divide(x_fp32, scale_var), PrimValue(FloatImm(fp32_, -fp8_max)),
+                       PrimValue(FloatImm(fp32_, fp8_max)));
+    return {builder_->Emit(astype(scaled, fp8_dtype)), scale_var};
+  }
+
+  // Rewrite matmul(x, w) to dequantize(matmul(quantize(x), quantize(w))), see the FP8 mode above.
+  Expr RewriteFP8Matmul(const Call& call, const CallNode* orig_call) {
+    static const Op& permute_dims_op = Op::Get("relax.permute_dims");
+    bool per_channel = fp8_->per_channel;
+    Expr lhs = call->args[0];
+    Expr rhs = call->args[1];
+
+    // The weight of a linear layer is transposed. Quantize it before the transpose, so that the
+    // matmul keeps a transposed rhs, as the fp8 gemms require.
+    ffi::Optional<Expr> rhs_transposed = std::nullopt;
+    if (const auto* rhs_var = rhs.as<VarNode>()) {
+      auto value = builder_->LookupBinding(ffi::GetRef<Var>(rhs_var));
+      const auto* transpose = value ? value.value().as<CallNode>() : nullptr;
+      if (transpose && transpose->op.same_as(permute_dims_op)) {
+        const auto* attrs = transpose->attrs.as<PermuteDimsAttrs>();
+        const auto* tensor = GetStructInfoAs<TensorStructInfoNode>(transpose->args[0]);
+        bool reversed = attrs && (!attrs->axes.defined() || (attrs->axes.value()[0]->value == 1 &&
+                                                             attrs->axes.value()[1]->value == 0));
+        if (tensor && tensor->ndim == 2 && reversed &&
+            (tensor->dtype == fp16_ || tensor->dtype == fp32_)) {
+          rhs_transposed = transpose->args[0];
+        }
+      }
+    }
+
+    auto [q_lhs, scale_lhs] =
+        QuantizeFP8(lhs, CalibratedAmax({orig_call->args[0]}),
+                    per_channel ? std::optional<int>(-1) : std::nullopt);
+    Expr q_rhs, scale_rhs;
+    if (rhs_transposed) {
+      auto [q_weight, scale_weight] =
+          QuantizeFP8(rhs_transposed.value(),
+                      CalibratedAmax({rhs_transposed.value(), orig_call->args[1]}),
+                      per_channel ? std::optional<int>(-1) : std::nullopt);
+      q_rhs = builder_->Emit(permute_dims(q_weight, std::nullopt));
+      // a per-channel scale of shape (N, 1), as one of the output channels (1, N)
+      scale_rhs = per_channel ? builder_->Emit(permute_dims(scale_weight, std::nullopt))
+                              : scale_weight;
+    } else {
+      std::tie(q_rhs, scale_rhs) =
+          QuantizeFP8(rhs, CalibratedAmax({orig_call->args[1]}),
+                      per_channel ? std::optional<int>(-2) : std::nullopt);
+    }
+
+    Expr out = builder_->Emit(matmul(q_lhs, q_rhs, output_dtype_));
+    if (output_dtype_ != fp32_) {
+      scale_lhs = builder_->Emit(astype(scale_lhs, output_dtype_));
+      scale_rhs = builder_->Emit(astype(scale_rhs, output_dtype_));
+    }
+    if (per_channel) {
+      return multiply(builder_->Emit(multiply(out, scale_lhs)), scale_rhs);
+    }
+    return multiply(out, builder_->Emit(multiply(scale_lhs, scale_rhs)));
+  }
+
   void CastIfFp16Only(const Var& var) {
     ICHECK(builder_->CurrentBlockIsDataFlow());
     // Get the current remapped var
@@ -476,6 +619,15 @@ class ToMixedPrecisionRewriter : public ExprMutator {
     // We first to remap the args to the current vars according to the var_remap_
     new_call.CopyOnWrite()->args = RemapArgs(new_call->args);
 
+    if (policy == kAlways && UseFP8(new_call)) {
+      Expr new_value = builder_->Normalize(RewriteFP8Matmul(new_call, call_node));
+      // Store the output as the other kAlways ops do, see below.
+      NType to = binding->var->IsInstance<DataflowVarNode>() ? NTypeFrom(new_value, fp16_)
+                                                             : NTypeFrom(binding->var);
+      ReEmitBinding(binding, builder_->Normalize(RewriteExpr(new_value, to)));
+      return;
+    }
+
     // Then we rewrite the args according to the policy
     std::optional<DataType> opt_new_dtype = std::nullopt;
 
@@ -595,27 +747,46 @@ class ToMixedPrecisionRewriter : public ExprMutator {
   DataType output_dtype_;
   ffi::Array<Var> params_;
   std::unordered_set<std::string> fp16_input_names_;
+  std::optional<FP8Options> fp8_;
 
   const Op& wrap_param_op = Op::Get("relax.wrap_param");
 };
 
 Expr ToMixedPrecision(const Function& f, const DataType& out_dtype,
-                      ffi::Optional<ffi::Array<ffi::String>> fp16_input_names) {
+                      ffi::Optional<ffi::Array<ffi::String>> fp16_input_names,
+                      std::optional<FP8Options> fp8) {
   VarDTypeMap only_fp16_map = DTypeDecisionCollector::Collect(f, out_dtype);
   std::unordered_set<std::string> fp16_input_names_set;
   if (fp16_input_names) {
     fp16_input_names_set.insert(fp16_input_names.value().begin(), fp16_input_names.value().end());
   }
-  ToMixedPrecisionRewriter mutator(&only_fp16_map, out_dtype, fp16_input_names_set);
+  ToMixedPrecisionRewriter mutator(&only_fp16_map, out_dtype, fp16_input_names_set, fp8);
   return mutator(f);
 }
 
 namespace transform {
 
 Pass ToMixedPrecision(const DataType& out_dtype,
-                      ffi::Optional<ffi::Array<ffi::String>> fp16_input_names) {
+                      ffi::Optional<ffi::Array<ffi::String>> fp16_input_names,
+                      ffi::Optional<DataType> fp8_dtype, ffi::String fp8_scaling,
+                      ffi::Optional<ffi::Map<ffi::String, double>> fp8_amax) {
+  std::optional<FP8Options> fp8 = std::nullopt;
+  if (fp8_dtype) {
+    CHECK(fp8_dtype.value().is_float8_e4m3fn() || fp8_dtype.value().is_float8_e5m2())
+        << "ValueError: The fp8 dtype of ToMixedPrecision must be float8_e4m3fn or float8_e5m2, "
+        << "but got " << fp8_dtype.value();
+    CHECK(fp8_scaling == "tensor" || fp8_scaling == "channel")
+        << "ValueError: The fp8 scaling of ToMixedPrecision must be \"tensor\" or \"channel\", "
+        << "but got " << fp8_scaling;
+    fp8 = FP8Options{fp8_dtype.value(), fp8_scaling == "channel", {}};
+    if (fp8_amax) {
+      for (const auto& [name, amax] : fp8_amax.value()) {
+        fp8->amax[name] = amax;
+      }
+    }
+  }
   auto pass_func = [=](Function f, IRModule m, PassContext pc) {
-    return Downcast<Function>(ToMixedPrecision(f, out_dtype, fp16_input_names));
+    return Downcast<Function>(ToMixedPrecision(f, out_dtype, fp16_input_names, fp8));
   };
   return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
 }
@@ -36,21 +36,64 @@
 #include <tvm/ffi/string.h>
 #include <tvm/runtime/tensor.h>
 
+#include <atomic>
 #include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
 
+namespace {
+
+/*!
+ * \brief Skip a tensor saved by Tensor::Save.
+ * \return The size of the saved tensor, in bytes.
+ */
+size_t SkipTensor(dmlc::SeekStream* strm) {
+  size_t begin = strm->Tell();
+  uint64_t header, reserved;
+  Device dev;
+  int ndim;
+  DLDataType dtype;
+  ICHECK(strm->Read(&header) && header == kTVMTensorMagic) << "Invalid DLTensor file format";
+  ICHECK(strm->Read(&reserved) && strm->Read(&dev) && strm->Read(&ndim) && strm->Read(&dtype))
+      << "Invalid DLTensor file format";
+  std::vector<int64_t> shape(ndim);
+  if (ndim != 0) {
+    ICHECK(strm->ReadArray(shape.data(), ndim)) << "Invalid DLTensor file format";
+  }
+  int64_t data_byte_size;
+  ICHECK(strm->Read(&data_byte_size)) << "Invalid DLTensor file format";
+  strm->Seek(strm->Tell() + data_byte_size);
+  return strm->Tell() - begin;
+}
+
+}  // namespace
+
 /*!
  * \brief The const-loader module is designed to manage initialization of the
  * imported submodules for the C++ runtime.
+ *
+ * When loaded from bytes, the constants are only deserialized when the first submodule that
+ * needs them is initialized, or by a background prefetch. The deserialized constants of cold
+ * submodules can be evicted, and are then deserialized again on their next use.
  */
 class ConstLoaderModuleObj : public ffi::ModuleObj {
  public:
   ConstLoaderModuleObj(
       const std::unordered_map<std::string, Tensor>& const_var_tensor,
-      const std::unordered_map<std::string, std::vector<std::string>>& const_vars_by_symbol)
-      : const_var_tensor_(const_var_tensor), const_vars_by_symbol_(const_vars_by_symbol) {
+      const std::unordered_map<std::string, std::vector<std::string>>& const_vars_by_symbol,
+      ffi::Optional<ffi::Bytes> serialized = std::nullopt,
+      const std::unordered_map<std::string, std::pair<size_t, size_t>>& serialized_range = {})
+      : const_var_tensor_(const_var_tensor),
+        const_vars_by_symbol_(const_vars_by_symbol),
+        serialized_(serialized),
+        serialized_range_(serialized_range) {
     VLOG(1) << "Creating ConstLoaderModule";
     // Only the related submodules are cached to reduce the number of runtime
     // symbol lookup for initialization. Otherwise, symbols/primitives in the
@@ -59,7 +102,7 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
       for (const auto& var : kv.second) {
         VLOG(1) << "ConstLoaderModuleNode has constant '" << var << "' for function '" << kv.first
                 << "'";
-        ICHECK_GT(const_var_tensor_.count(var), 0)
+        ICHECK(const_var_tensor_.count(var) || serialized_range_.count(var))
             << "ConstLoaderModuleNode is missing entry for constant '" << var << "' for function '"
             << kv.first << "'";
       }
@@ -67,6 +110,8 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
     }
   }
 
+  ~ConstLoaderModuleObj() { StopPrefetch(); }
+
   ffi::Optional<ffi::Function> GetFunction(const ffi::String& name) final {
     VLOG(1) << "ConstLoaderModuleNode::GetFunction(" << name << ")";
     // Initialize and memoize the module.
@@ -81,12 +126,42 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
     if (name == "get_const_var_tensor") {
       return ffi::Function([_self, this](ffi::PackedArgs args, ffi::Any* rv) {
         ffi::Map<ffi::String, ffi::Any> ret_map;
-        for (const auto& kv : const_var_tensor_) {
-          ret_map.Set(kv.first, kv.second);
+        for (const std::string& var : ListConstVars()) {
+          ret_map.Set(var, GetConstVarTensor(var));
         }
         *rv = ret_map;
       });
     }
+    if (name == "prefetch_constants") {
+      // Deserialize the constants of the given symbols, all by default, in a background thread.
+      return ffi::Function([_self, this](ffi::PackedArgs args, ffi::Any* rv) {
+        std::vector<std::string> symbols;
+        if (args.size() == 0) {
+          for (const auto& kv : const_vars_by_symbol_) symbols.push_back(kv.first);
+        } else {
+          for (const ffi::String& symbol : args[0].cast<ffi::Array<ffi::String>>()) {
+            symbols.push_back(symbol);
+          }
+        }
+        StartPrefetch(std::move(symbols));
+      });
+    }
+    if (name == "wait_prefetch") {
+      return ffi::Function([_self, this](ffi::PackedArgs args, ffi::Any* rv) { WaitPrefetch(); });
+    }
+    if (name == "num_loaded_constants") {
+      // The number of constants currently deserialized, which the prefetch and eviction change.
+      return ffi::Function([_self, this](ffi::PackedArgs args, ffi::Any* rv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        *rv = static_cast<int64_t>(const_var_tensor_.size());
+      });
+    }
+    if (name == "evict_constants") {
+      // Drop the deserialized constants of the given symbols, returning the number dropped.
+      return ffi::Function([_self, this](ffi::PackedArgs args, ffi::Any* rv) {
+        *rv = EvictConstants(args[0].cast<ffi::Array<ffi::String>>());
+      });
+    }
 
     // Run the module.
     // Normally we would only have a limited number of submodules. The runtime
@@ -113,15 +188,50 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
     ffi::Array<Tensor> ret;
     ICHECK_GT(const_vars_by_symbol_.count(symbol), 0U)
         << "No constants known for function '" << symbol << "'";
-    std::vector<std::string> vars = const_vars_by_symbol_[symbol];
+    const std::vector<std::string>& vars = const_vars_by_symbol_.at(symbol);
     for (const auto& var : vars) {
-      ICHECK_GT(const_var_tensor_.count(var), 0U)
-          << "No such constant variable '" << var << "' for function '" << symbol << "'";
-      ret.push_back(const_var_tensor_[var]);
+      ret.push_back(GetConstVarTensor(var, symbol));
     }
     return ret;
   }
 
+  /*!
+   * \brief Get a constant, deserializing it on its first use.
+   * \param var The name of the constant.
+   * \param symbol The function that needs it, for the error message.
+   */
+  Tensor GetConstVarTensor(const std::string& var, const std::string& symbol = "") {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = const_var_tensor_.find(var);
+      if (it != const_var_tensor_.end()) return it->second;
+    }
+    auto it = serialized_range_.find(var);
+    ICHECK(it != serialized_range_.end())
+        << "No such constant variable '" << var << "' for function '" << symbol << "'";
+    // Deserialize without the lock, the prefetch may then race to insert the same constant.
+    dmlc::MemoryFixedSizeStream ms(const_cast<char*>(serialized_.value().data()) + it->second.first,
+                                   it->second.second);
+    Tensor tensor;
+    tensor.Load(&ms);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return const_var_tensor_.emplace(var, tensor).first->second;
+  }
+
+  /*! \brief Drop the deserialized constants of the symbols that can be deserialized again. */
+  int64_t EvictConstants(const ffi::Array<ffi::String>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t num_evicted = 0;
+    for (const ffi::String& symbol : symbols) {
+      auto it = const_vars_by_symbol_.find(symbol);
+      if (it == const_vars_by_symbol_.end()) continue;
+      for (const std::string& var : it->second) {
+        if (serialized_range_.count(var)) num_evicted += const_var_tensor_.erase(var);
+      }
+    }
+    return num_evicted;
+  }
+
   /*!
    * \brief Initialize each imported module.
    * \param symobl The symbol used for initializing a module. It is also used
@@ -156,21 +266,26 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
     dmlc::MemoryStringStream ms(&bytes_buffer);
     dmlc::Stream* stream = &ms;
 
-    std::vector<std::string> variables;
-    std::vector<Tensor> const_var_tensor;
-    for (const auto& it : const_var_tensor_) {
-      ffi::String var_name = it.first;
-      variables.push_back(var_name);
-      const_var_tensor.push_back(it.second);
-    }
+    std::vector<std::string> variables = ListConstVars();
 
     // Save all variables in the function.
     stream->Write(variables);
-    // Save all constant data.
-    uint64_t sz = static_cast<uint64_t>(const_var_tensor.size());
+    // Save all constant data, copying the constants not deserialized yet as they are.
+    uint64_t sz = static_cast<uint64_t>(variables.size());
     stream->Write(sz);
     for (uint64_t i = 0; i < sz; i++) {
-      const_var_tensor[i].Save(stream);
+      Tensor tensor;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = const_var_tensor_.find(variables[i]);
+        if (it != const_var_tensor_.end()) tensor = it->second;
+      }
+      if (tensor.defined()) {
+        tensor.Save(stream);
+      } else {
+        const std::pair<size_t, size_t>& range = serialized_range_.at(variables[i]);
+        stream->Write(serialized_.value().data() + range.first, range.second);
+      }
     }
 
     // Save the symbol to list of required constant variables mapping
@@ -201,18 +316,12 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
     ICHECK(stream->Read(&sz, sizeof(sz))) << "Loading number of vars failed";
     ICHECK_EQ(static_cast<size_t>(sz), variables.size())
         << "The number of variables and ndarray counts must match";
-    // Load the list of ndarray.
-    std::vector<Tensor> arrays;
-    for (uint64_t i = 0; i < sz; i++) {
-      Tensor temp;
-      temp.Load(stream);
-      arrays.push_back(temp);
-    }
-
-    std::unordered_map<std::string, Tensor> const_var_tensor;
+    // Record where each ndarray is, they are only deserialized when needed.
+    std::unordered_map<std::string, std::pair<size_t, size_t>> serialized_range;
     for (uint64_t i = 0; i < sz; i++) {
-      ICHECK_EQ(const_var_tensor.count(variables[i]), 0U);
-      const_var_tensor[variables[i]] = arrays[i];
+      ICHECK_EQ(serialized_range.count(variables[i]), 0U);
+      size_t offset = ms.Tell();
+      serialized_range[variables[i]] = {offset, SkipTensor(&ms)};
     }
 
     // Load the symbol to list of required constant variables mapping
@@ -232,11 +341,49 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
       const_vars_by_symbol[symbols[i]] = const_vars[i];
     }
 
-    auto n = ffi::make_object<ConstLoaderModuleObj>(const_var_tensor, const_vars_by_symbol);
+    auto n = ffi::make_object<ConstLoaderModuleObj>(
+        std::unordered_map<std::string, Tensor>(), const_vars_by_symbol, bytes, serialized_range);
     return ffi::Module(n);
   }
 
  private:
+  /*! \return The names of all the constants. */
+  std::vector<std::string> ListConstVars() const {
+    std::vector<std::string> variables;
+    for (const auto& it : serialized_range_) {
+      variables.push_back(it.first);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& it : const_var_tensor_) {
+      if (!serialized_range_.count(it.first)) variables.push_back(it.first);
+    }
+    return variables;
+  }
+
+  void StartPrefetch(std::vector<std::string> symbols) {
+    StopPrefetch();
+    stop_prefetch_ = false;
+    prefetch_thread_ = std::thread([this, symbols = std::move(symbols)]() {
+      for (const std::string& symbol : symbols) {
+        auto it = const_vars_by_symbol_.find(symbol);
+        if (it == const_vars_by_symbol_.end()) continue;
+        for (const std::string& var : it->second) {
+          if (stop_prefetch_) return;
+          GetConstVarTensor(var, symbol);
+        }
+      }
+    });
+  }
+
+  void WaitPrefetch() {
+    if (prefetch_thread_.joinable()) prefetch_thread_.join();
+  }
+
+  void StopPrefetch() {
+    stop_prefetch_ = true;
+    WaitPrefetch();
+  }
+
   /*!
    * \brief Record if a module is initialized. It is needed by imported
    * modules using execution engine.
@@ -246,6 +393,14 @@ class ConstLoaderModuleObj : public ffi::ModuleObj {
   std::unordered_map<std::string, Tensor> const_var_tensor_;
   /*! \brief Symbol name to required constant variables mapping. */
   std::unordered_map<std::string, std::vector<std::string>> const_vars_by_symbol_;
+  /*! \brief The bytes the module is loaded from, if any. */
+  ffi::Optional<ffi::Bytes> serialized_;
+  /*! \brief Variable name to the offset and size of its serialized Tensor. */
+  std::unordered_map<std::string, std::pair<size_t, size_t>> serialized_range_;
+  /*! \brief Guards const_var_tensor_ against the prefetch thread. */
+  mutable std::mutex mutex_;
+  std::thread prefetch_thread_;
+  std::atomic<bool> stop_prefetch_{false};
 };
 
 ffi::Module ConstLoaderModuleCreate(
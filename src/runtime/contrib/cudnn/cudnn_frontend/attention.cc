@@ -24,9 +24,13 @@
 
 #include "./attention.h"
 
+#include <tvm/ffi/extra/c_env_api.h>
 #include <tvm/ffi/function.h>
+#include <tvm/runtime/data_type.h>
 #include <tvm/runtime/device_api.h>
 
+#include <sstream>
+
 #include "../../../cuda/cuda_common.h"
 #include "../cudnn_utils.h"
 
@@ -101,7 +105,12 @@ void CuDNNSDPARunnerNode::Init(int64_t batch, int64_t seq_len, int64_t num_heads
   int device_id;
   CUDA_CALL(cudaGetDevice(&device_id));
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal(DLDevice{kDLCUDA, device_id});
-  CUDNN_FRONTEND_CALL(graph_->build(entry_ptr->handle, {cudnn_frontend::HeurMode_t::A}));
+  std::ostringstream os;
+  os << "sdpa/" << layout << "/" << runtime::DLDataTypeToString(data_type) << "/" << batch << ","
+     << seq_len << "," << num_heads << "," << num_kv_heads << "," << head_size << ","
+     << head_size_v << "/" << scale;
+  op_key_ = os.str();
+  needs_tuning_ = CuDNNFrontendPlanCache::Global()->Build(&graph_, entry_ptr->handle, op_key_);
 }
 
 void CuDNNSDPARunnerNode::Run(const DLTensor* qkv, DLTensor* workspace, DLTensor* out) {
@@ -117,6 +126,14 @@ void CuDNNSDPARunnerNode::Run(const DLTensor* qkv, DLTensor* workspace, DLTensor
       {kTensorIDQ, q_ptr}, {kTensorIDK, k_ptr}, {kTensorIDV, v_ptr}, {kTensorIDOut, out_ptr}};
 
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal(qkv->device);
+  cudaStream_t stream =
+      static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, qkv->device.device_id));
+  CUDNN_CALL(cudnnSetStream(entry_ptr->handle, stream));
+  if (needs_tuning_) {
+    CuDNNFrontendPlanCache::Global()->Tune(graph_.get(), entry_ptr->handle, inputs, qkv->device,
+                                           op_key_);
+    needs_tuning_ = false;
+  }
   CUDNN_FRONTEND_CALL(graph_->execute(entry_ptr->handle, inputs, workspace->data));
 }
 
@@ -31,11 +31,7 @@
 #include <memory>
 #include <string>
 
-#define CUDNN_FRONTEND_CALL(func)                    \
-  do {                                               \
-    auto status = (func);                            \
-    CHECK(status.is_good()) << status.get_message(); \
-  } while (0)
+#include "./plan_cache.h"
 
 namespace tvm {
 namespace contrib {
@@ -64,6 +60,10 @@ class CuDNNSDPARunnerNode : public tvm::runtime::Object {
   int64_t offset_q_{0};
   int64_t offset_k_{0};
   int64_t offset_v_{0};
+  /*! \brief The key of the execution plan in the plan cache. */
+  std::string op_key_;
+  /*! \brief Whether the plans are autotuned on the first run. */
+  bool needs_tuning_{false};
 };
 
 class CuDNNSDPARunner : public tvm::runtime::ObjectRef {
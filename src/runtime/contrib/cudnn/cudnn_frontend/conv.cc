@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/cudnn/cudnn_frontend/conv.cc
+ * \brief cuDNN fused convolution, bias and activation implementation
+ */
+
+#include "./conv.h"
+
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/function.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
+
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include "../../../cuda/cuda_common.h"
+#include "../cudnn_utils.h"
+
+namespace tvm {
+namespace contrib {
+
+namespace {
+
+/*!
+ * \brief Get the dims of a 4D tensor in the (N, C, H, W) order the cuDNN graphs take, and the
+ *  strides of its layout.
+ */
+std::pair<std::vector<int64_t>, std::vector<int64_t>> GetDimsAndStrides(
+    const std::vector<int64_t>& shape, bool channels_last) {
+  CHECK_EQ(shape.size(), 4) << "Only 2D convolutions are supported";
+  if (channels_last) {
+    int64_t n = shape[0], h = shape[1], w = shape[2], c = shape[3];
+    return {{n, c, h, w}, {h * w * c, 1, w * c, c}};
+  }
+  int64_t c = shape[1], h = shape[2], w = shape[3];
+  return {shape, {c * h * w, h * w, w, 1}};
+}
+
+}  // namespace
+
+void CuDNNConvRunnerNode::Init(const std::string& layout, const std::vector<int64_t>& data_shape,
+                               const std::vector<int64_t>& kernel_shape,
+                               const std::vector<int64_t>& out_shape,
+                               const std::vector<int>& padding, const std::vector<int>& strides,
+                               const std::vector<int>& dilation, const DLDataType& data_type,
+                               bool has_bias, bool relu) {
+  CHECK(layout == "NHWC" || layout == "NCHW") << "Unsupported layout: " << layout;
+  CHECK_EQ(padding.size(), 4);
+  CHECK_EQ(strides.size(), 2);
+  CHECK_EQ(dilation.size(), 2);
+  CHECK(data_type.code == DLDataTypeCode::kDLFloat &&
+        (data_type.bits == 16 || data_type.bits == 32))
+      << "Only float16 and float32 are supported";
+  bool channels_last = layout == "NHWC";
+
+  graph_ = std::make_unique<cudnn_frontend::graph::Graph>();
+  graph_->set_io_data_type(data_type.bits == 16 ? cudnn_frontend::DataType_t::HALF
+                                                : cudnn_frontend::DataType_t::FLOAT)
+      .set_intermediate_data_type(cudnn_frontend::DataType_t::FLOAT)
+      .set_compute_data_type(cudnn_frontend::DataType_t::FLOAT);
+
+  auto [data_dims, data_strides] = GetDimsAndStrides(data_shape, channels_last);
+  auto [kernel_dims, kernel_strides] = GetDimsAndStrides(kernel_shape, channels_last);
+  auto [out_dims, out_strides] = GetDimsAndStrides(out_shape, channels_last);
+  auto x = graph_->tensor(cudnn_frontend::graph::Tensor_attributes()
+                              .set_name("data")
+                              .set_uid(kTensorIDData)
+                              .set_dim(data_dims)
+                              .set_stride(data_strides));
+  auto w = graph_->tensor(cudnn_frontend::graph::Tensor_attributes()
+                              .set_name("kernel")
+                              .set_uid(kTensorIDKernel)
+                              .set_dim(kernel_dims)
+                              .set_stride(kernel_strides));
+  auto conv_options = cudnn_frontend::graph::Conv_fprop_attributes()
+                          .set_name("conv")
+                          .set_pre_padding({padding[0], padding[1]})
+                          .set_post_padding({padding[2], padding[3]})
+                          .set_stride({strides[0], strides[1]})
+                          .set_dilation({dilation[0], dilation[1]});
+  auto y = graph_->conv_fprop(x, w, conv_options);
+  if (has_bias) {
+    int64_t channels = out_dims[1];
+    auto b = graph_->tensor(cudnn_frontend::graph::Tensor_attributes()
+                                .set_name("bias")
+                                .set_uid(kTensorIDBias)
+                                .set_dim({1, channels, 1, 1})
+                                .set_stride({channels, 1, channels, channels}));
+    y = graph_->pointwise(y, b,
+                          cudnn_frontend::graph::Pointwise_attributes().set_name("bias").set_mode(
+                              cudnn_frontend::PointwiseMode_t::ADD));
+  }
+  if (relu) {
+    y = graph_->pointwise(y,
+                          cudnn_frontend::graph::Pointwise_attributes().set_name("relu").set_mode(
+                              cudnn_frontend::PointwiseMode_t::RELU_FWD));
+  }
+  y->set_output(true).set_uid(kTensorIDOut).set_dim(out_dims).set_stride(out_strides);
+
+  std::ostringstream os;
+  os << "conv2d/" << layout << "/" << runtime::DLDataTypeToString(data_type) << "/";
+  for (const auto* shape : {&data_shape, &kernel_shape}) {
+    for (int64_t dim : *shape) {
+      os << dim << ",";
+    }
+    os << "/";
+  }
+  for (const auto* values : {&padding, &strides, &dilation}) {
+    for (int value : *values) {
+      os << value << ",";
+    }
+    os << "/";
+  }
+  os << (has_bias ? "bias" : "") << (relu ? "_relu" : "");
+  op_key_ = os.str();
+
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal(DLDevice{kDLCUDA, device_id});
+  needs_tuning_ = CuDNNFrontendPlanCache::Global()->Build(&graph_, entry_ptr->handle, op_key_);
+}
+
+void CuDNNConvRunnerNode::Run(const DLTensor* data, const DLTensor* kernel, const DLTensor* bias,
+                              DLTensor* out) {
+  auto f_ptr = [](const DLTensor* tensor) {
+    return static_cast<void*>(static_cast<uint8_t*>(tensor->data) + tensor->byte_offset);
+  };
+  std::unordered_map<int64_t, void*> variant_pack = {{kTensorIDData, f_ptr(data)},
+                                                     {kTensorIDKernel, f_ptr(kernel)},
+                                                     {kTensorIDOut, f_ptr(out)}};
+  if (bias != nullptr) {
+    variant_pack[kTensorIDBias] = f_ptr(bias);
+  }
+
+  CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal(data->device);
+  cudaStream_t stream =
+      static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, data->device.device_id));
+  CUDNN_CALL(cudnnSetStream(entry_ptr->handle, stream));
+  if (needs_tuning_) {
+    CuDNNFrontendPlanCache::Global()->Tune(graph_.get(), entry_ptr->handle, variant_pack,
+                                           data->device, op_key_);
+    needs_tuning_ = false;
+  }
+  size_t workspace_size = graph_->get_workspace_size();
+  void* workspace =
+      workspace_size > 0
+          ? runtime::DeviceAPI::Get(data->device)->AllocWorkspace(data->device, workspace_size)
+          : nullptr;
+  auto status = graph_->execute(entry_ptr->handle, variant_pack, workspace);
+  if (workspace != nullptr) {
+    runtime::DeviceAPI::Get(data->device)->FreeWorkspace(data->device, workspace);
+  }
+  CHECK(status.is_good()) << status.get_message();
+}
+
+}  // namespace contrib
+}  // namespace tvm
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/cudnn/cudnn_frontend/conv.h
+ * \brief cuDNN fused convolution, bias and activation implementation
+ */
+
+#ifndef TVM_RUNTIME_CONTRIB_CUDNN_CUDNN_FRONTEND_CONV_H_
+#define TVM_RUNTIME_CONTRIB_CUDNN_CUDNN_FRONTEND_CONV_H_
+
+#include <cudnn_frontend.h>
+#include <tvm/ffi/function.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./plan_cache.h"
+
+namespace tvm {
+namespace contrib {
+
+/*!
+ * \brief The runner of a 2D convolution, optionally followed by a bias add and a ReLU, as a single
+ *  cuDNN frontend graph, which cuDNN runs as one fused kernel where it can.
+ */
+class CuDNNConvRunnerNode : public tvm::runtime::Object {
+ public:
+  CuDNNConvRunnerNode() {}
+
+  ~CuDNNConvRunnerNode() {}
+
+  static constexpr const char* _type_key = "contrib.cudnn.ConvRunner";
+
+  /*!
+   * \brief Build the graph of the convolution.
+   * \param layout The layout of the data and the output, "NHWC" or "NCHW". The kernel is in "OHWI"
+   *  or "OIHW" respectively.
+   * \param data_shape The shape of the data, in the layout.
+   * \param kernel_shape The shape of the kernel, in the layout of the kernel.
+   * \param out_shape The shape of the output, in the layout.
+   * \param padding The padding of the top, left, bottom and right.
+   * \param strides The strides of the height and width.
+   * \param dilation The dilation of the height and width.
+   * \param data_type The dtype of the data, the kernel, the bias and the output.
+   * \param has_bias Whether the graph adds a bias, broadcast along the channels.
+   * \param relu Whether the graph applies a ReLU at the end.
+   */
+  void Init(const std::string& layout, const std::vector<int64_t>& data_shape,
+            const std::vector<int64_t>& kernel_shape, const std::vector<int64_t>& out_shape,
+            const std::vector<int>& padding, const std::vector<int>& strides,
+            const std::vector<int>& dilation, const DLDataType& data_type, bool has_bias,
+            bool relu);
+
+  void Run(const DLTensor* data, const DLTensor* kernel, const DLTensor* bias, DLTensor* out);
+
+  static constexpr int kTensorIDData = 0;
+  static constexpr int kTensorIDKernel = 1;
+  static constexpr int kTensorIDBias = 2;
+  static constexpr int kTensorIDOut = 3;
+
+ private:
+  std::unique_ptr<cudnn_frontend::graph::Graph> graph_{nullptr};
+  /*! \brief The key of the execution plan in the plan cache. */
+  std::string op_key_;
+  /*! \brief Whether the plans are autotuned on the first run. */
+  bool needs_tuning_{false};
+};
+
+class CuDNNConvRunner : public tvm::runtime::ObjectRef {
+ public:
+  static CuDNNConvRunner Create() {
+    auto n = ffi::make_object<CuDNNConvRunnerNode>();
+    return CuDNNConvRunner(n);
+  }
+
+  TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(CuDNNConvRunner, tvm::runtime::ObjectRef,
+                                             CuDNNConvRunnerNode);
+};
+
+}  // namespace contrib
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_CUDNN_CUDNN_FRONTEND_CONV_H_
@@ -0,0 +1,221 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/cudnn/cudnn_frontend/plan_cache.cc
+ * \brief The cache of the execution plans of the cuDNN frontend graphs, persisted on disk.
+ */
+
+#include "./plan_cache.h"
+
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+
+#include "../../../cuda/cuda_common.h"
+#include "../../../file_utils.h"
+
+namespace tvm {
+namespace contrib {
+
+using runtime::GetCacheDir;
+using runtime::LoadBinaryFromFile;
+using runtime::SaveBinaryToFile;
+
+CuDNNFrontendPlanCache* CuDNNFrontendPlanCache::Global() {
+  static CuDNNFrontendPlanCache* inst = new CuDNNFrontendPlanCache();
+  return inst;
+}
+
+CuDNNFrontendPlanCache::CuDNNFrontendPlanCache() {
+  const char* env_dir = std::getenv("TVM_CUDNN_FRONTEND_PLAN_CACHE_DIR");
+  if (env_dir != nullptr) {
+    dir_ = env_dir;
+  } else {
+    dir_ = GetCacheDir() + "/cudnn_frontend_plans";
+  }
+  const char* env_autotune = std::getenv("TVM_CUDNN_FRONTEND_AUTOTUNE");
+  autotune_ = env_autotune != nullptr && std::string(env_autotune) == "1";
+}
+
+std::string CuDNNFrontendPlanCache::GetKey(const std::string& op_key) {
+  // The plans are specific to the cuDNN version and the GPU architecture.
+  int device_id, major, minor;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id));
+  std::ostringstream os;
+  os << op_key << "/cudnn" << cudnnGetVersion() << "/sm_" << major << minor;
+  return os.str();
+}
+
+std::string CuDNNFrontendPlanCache::GetPath(const std::string& key) const {
+  if (dir_.empty()) {
+    return "";
+  }
+  // FNV-1a, as the file names must be stable across runs.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : key) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+  }
+  std::ostringstream os;
+  os << dir_ << "/" << std::hex << hash << ".plan";
+  return os.str();
+}
+
+bool CuDNNFrontendPlanCache::Lookup(const std::string& key, std::vector<uint8_t>* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = plans_.find(key);
+  if (it != plans_.end()) {
+    *data = it->second;
+    return true;
+  }
+  std::string path = GetPath(key);
+  if (path.empty() || !std::filesystem::exists(path)) {
+    return false;
+  }
+  // The file holds the key on its first line, which guards against hash collisions.
+  std::string content;
+  LoadBinaryFromFile(path, &content);
+  size_t pos = content.find('\n');
+  if (pos == std::string::npos || content.compare(0, pos, key) != 0) {
+    return false;
+  }
+  data->assign(content.begin() + pos + 1, content.end());
+  plans_[key] = *data;
+  return true;
+}
+
+void CuDNNFrontendPlanCache::Store(const std::string& key,
+                                   const cudnn_frontend::graph::Graph& graph) {
+  std::vector<uint8_t> data;
+  auto status = graph.serialize(data);
+  if (!status.is_good()) {
+    // Not all the engines support serialization, whose graphs are then built in each process.
+    VLOG(1) << "Cannot serialize the cuDNN frontend plan of " << key << ": "
+            << status.get_message();
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  plans_[key] = data;
+  std::string path = GetPath(key);
+  if (path.empty()) {
+    return;
+  }
+  std::string tmp_path = path + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(&graph));
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+  try {
+    // The plan stays in the table of this process, the others rebuild it when it is not on disk.
+    if (!ec) {
+      SaveBinaryToFile(tmp_path, key + "\n" + std::string(data.begin(), data.end()));
+      std::filesystem::rename(tmp_path, path, ec);
+    }
+  } catch (const std::exception& e) {
+    VLOG(1) << "Failed to cache the cuDNN frontend plan at " << path << ": " << e.what();
+  }
+}
+
+bool CuDNNFrontendPlanCache::Build(std::unique_ptr<cudnn_frontend::graph::Graph>* graph,
+                                   cudnnHandle_t handle, const std::string& op_key) {
+  std::string key = GetKey(op_key);
+  std::vector<uint8_t> data;
+  if (Lookup(key, &data)) {
+    auto restored = std::make_unique<cudnn_frontend::graph::Graph>();
+    auto status = restored->deserialize(handle, data);
+    if (status.is_good()) {
+      *graph = std::move(restored);
+      return false;
+    }
+    // A stale cache entry, e.g. of another cuDNN build, is rebuilt below.
+    VLOG(1) << "Cannot restore the cuDNN frontend plan of " << key << ": "
+            << status.get_message();
+  }
+  cudnn_frontend::graph::Graph* g = graph->get();
+  CUDNN_FRONTEND_CALL(g->validate());
+  CUDNN_FRONTEND_CALL(g->build_operation_graph(handle));
+  CUDNN_FRONTEND_CALL(g->create_execution_plans(
+      {cudnn_frontend::HeurMode_t::A, cudnn_frontend::HeurMode_t::FALLBACK}));
+  CUDNN_FRONTEND_CALL(g->check_support(handle));
+  if (autotune_) {
+    CUDNN_FRONTEND_CALL(g->build_plans(handle, cudnn_frontend::BuildPlanPolicy_t::ALL));
+    return true;
+  }
+  CUDNN_FRONTEND_CALL(
+      g->build_plans(handle, cudnn_frontend::BuildPlanPolicy_t::HEURISTICS_CHOICE));
+  Store(key, *g);
+  return false;
+}
+
+void CuDNNFrontendPlanCache::Tune(cudnn_frontend::graph::Graph* graph, cudnnHandle_t handle,
+                                  const std::unordered_map<int64_t, void*>& variant_pack,
+                                  Device dev, const std::string& op_key) {
+  size_t workspace_size = graph->get_autotune_workspace_size();
+  void* workspace = workspace_size > 0
+                        ? runtime::DeviceAPI::Get(dev)->AllocWorkspace(dev, workspace_size)
+                        : nullptr;
+  auto status = graph->autotune(handle, variant_pack, workspace);
+  if (workspace != nullptr) {
+    runtime::DeviceAPI::Get(dev)->FreeWorkspace(dev, workspace);
+  }
+  CHECK(status.is_good()) << "Failed to autotune the cuDNN frontend plan of " << op_key << ": "
+                          << status.get_message();
+  Store(GetKey(op_key), *graph);
+}
+
+void CuDNNFrontendPlanCache::set_dir(const std::string& dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  dir_ = dir;
+}
+
+std::string CuDNNFrontendPlanCache::dir() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dir_;
+}
+
+size_t CuDNNFrontendPlanCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return plans_.size();
+}
+
+void CuDNNFrontendPlanCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  plans_.clear();
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("contrib.cudnn.frontend.set_plan_cache_dir",
+           [](const std::string& dir) { CuDNNFrontendPlanCache::Global()->set_dir(dir); })
+      .def("contrib.cudnn.frontend.get_plan_cache_dir",
+           []() { return CuDNNFrontendPlanCache::Global()->dir(); })
+      .def("contrib.cudnn.frontend.set_autotune",
+           [](bool autotune) { CuDNNFrontendPlanCache::Global()->set_autotune(autotune); })
+      .def("contrib.cudnn.frontend.plan_cache_size",
+           []() { return static_cast<int64_t>(CuDNNFrontendPlanCache::Global()->size()); })
+      .def("contrib.cudnn.frontend.clear_plan_cache",
+           []() { CuDNNFrontendPlanCache::Global()->Clear(); });
+}
+
+}  // namespace contrib
+}  // namespace tvm
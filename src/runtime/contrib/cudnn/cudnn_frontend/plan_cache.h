@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/cudnn/cudnn_frontend/plan_cache.h
+ * \brief The cache of the execution plans of the cuDNN frontend graphs, persisted on disk.
+ */
+
+#ifndef TVM_RUNTIME_CONTRIB_CUDNN_CUDNN_FRONTEND_PLAN_CACHE_H_
+#define TVM_RUNTIME_CONTRIB_CUDNN_CUDNN_FRONTEND_PLAN_CACHE_H_
+
+#include <cudnn_frontend.h>
+#include <tvm/runtime/device_api.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define CUDNN_FRONTEND_CALL(func)                    \
+  do {                                               \
+    auto status = (func);                            \
+    CHECK(status.is_good()) << status.get_message(); \
+  } while (0)
+
+namespace tvm {
+namespace contrib {
+
+/*!
+ * \brief The cache of the serialized execution plans of the cuDNN frontend graphs, keyed by the
+ *  operation, the shapes and the dtypes of the graph, the cuDNN version and the GPU architecture.
+ *
+ * The plans are kept in memory, and also saved in the cache directory when one is set, either by
+ * the TVM_CUDNN_FRONTEND_PLAN_CACHE_DIR environment variable or by
+ * "contrib.cudnn.frontend.set_plan_cache_dir", so that the plans picked by autotuning survive
+ * restarts of the process.
+ */
+class CuDNNFrontendPlanCache {
+ public:
+  static CuDNNFrontendPlanCache* Global();
+
+  /*!
+   * \brief Build the execution plan of a graph, or restore it from the cache.
+   * \param graph The graph, replaced by the deserialized graph when the plan is restored.
+   * \param handle The cuDNN handle.
+   * \param op_key The key of the operation, shapes and dtypes of the graph.
+   * \return Whether the graph is to be autotuned by Tune on its first run, i.e. autotuning is on
+   *  and the plan is not restored from the cache.
+   */
+  bool Build(std::unique_ptr<cudnn_frontend::graph::Graph>* graph, cudnnHandle_t handle,
+             const std::string& op_key);
+
+  /*!
+   * \brief Autotune the plans built for a graph on the actual buffers, and cache the fastest.
+   * \param graph The graph built by Build.
+   * \param handle The cuDNN handle.
+   * \param variant_pack The buffers of the tensors of the graph, by uid.
+   * \param dev The device of the buffers.
+   * \param op_key The key the graph is built with.
+   */
+  void Tune(cudnn_frontend::graph::Graph* graph, cudnnHandle_t handle,
+            const std::unordered_map<int64_t, void*>& variant_pack, Device dev,
+            const std::string& op_key);
+
+  void set_dir(const std::string& dir);
+
+  std::string dir();
+
+  void set_autotune(bool autotune) { autotune_ = autotune; }
+
+  size_t size();
+
+  void Clear();
+
+ private:
+  CuDNNFrontendPlanCache();
+
+  /*! \brief Get the full key of an operation key on the current GPU. */
+  static std::string GetKey(const std::string& op_key);
+
+  /*! \brief Get the file of a key in the cache directory. */
+  std::string GetPath(const std::string& key) const;
+
+  bool Lookup(const std::string& key, std::vector<uint8_t>* data);
+
+  void Store(const std::string& key, const cudnn_frontend::graph::Graph& graph);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<uint8_t>> plans_;
+  /*! \brief The directory the plans are saved in, or empty to keep them in memory only. */
+  std::string dir_;
+  /*! \brief Whether to autotune the plans missing from the cache on their first run. */
+  bool autotune_{false};
+};
+
+}  // namespace contrib
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_CUDNN_CUDNN_FRONTEND_PLAN_CACHE_H_
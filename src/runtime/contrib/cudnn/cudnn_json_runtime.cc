@@ -36,6 +36,7 @@
 
 #ifdef TVM_USE_CUDNN_FRONTEND
 #include "./cudnn_frontend/attention.h"
+#include "./cudnn_frontend/conv.h"
 #endif
 #include "cudnn_utils.h"
 
@@ -60,14 +61,18 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
       if (node.GetOpType() == "kernel") {
         std::string op_name = node.GetOpName();
         if (op_name.find("conv2d") != std::string::npos) {
-          op_execs_[i] = GetConv2DExec(node);
+          op_execs_[i] = GetConv2DExec(node, EntryID(i, 0));
         } else if (op_name.find("attention") != std::string::npos) {
-          op_execs_[i] = GetAttentionExec(node);
+          op_execs_[i] = GetAttentionExec(node, EntryID(i, 0));
         } else {
           LOG(FATAL) << "Unsupported op: " << op_name;
         }
       }
     }
+    // The outputs of the kernels consumed within the graph share a device arena.
+    int device_id;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    AllocateIntermediateEntries(Device{kDLCUDA, device_id});
   }
 
   const char* kind() const override { return "cudnn_json"; }  // May be overridden
@@ -100,16 +105,17 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
     return int_vec;
   }
 
-  std::function<void()> GetConv2DExec(const JSONGraphNode& node) {
+  std::function<void()> GetConv2DExec(const JSONGraphNode& node, uint32_t output_eid) {
     int device_id;
     CUDA_CALL(cudaGetDevice(&device_id));
     auto* entry_ptr = tvm::contrib::CuDNNThreadEntry::ThreadLocal(DLDevice{kDLCUDA, device_id});
     auto op_name = node.GetOpName();
 
     std::vector<int> input_dims, kernel_dims, output_dims;
-    auto input_node = nodes_[0];
-    auto input_shapes = input_node.GetOpShape()[0];
-    auto kernel_shapes = nodes_[1].GetOpShape()[0];
+    auto input_entry = node.GetInputs()[0];
+    auto kernel_entry = node.GetInputs()[1];
+    auto input_shapes = nodes_[input_entry.id_].GetOpShape()[input_entry.index_];
+    auto kernel_shapes = nodes_[kernel_entry.id_].GetOpShape()[kernel_entry.index_];
     auto output_shapes = node.GetOpShape()[0];
     for (const auto& _i : input_shapes) {
       input_dims.emplace_back(static_cast<int>(_i));
@@ -150,6 +156,23 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
       coef = 0.1;
     }
 
+#ifdef TVM_USE_CUDNN_FRONTEND
+    // The frontend graph fuses the bias and the ReLU into the convolution, with its plan cached.
+    DLDataType out_dtype = node.GetOpDataType()[0];
+    DLDataType data_dtype = nodes_[input_entry.id_].GetOpDataType()[input_entry.index_];
+    if (groups == 1 && dims == 2 && (act == CUDNN_ACTIVATION_IDENTITY || coef == 1.0) &&
+        DataType(out_dtype) == DataType(data_dtype)) {
+      auto runner = tvm::contrib::CuDNNConvRunner::Create();
+      runner->Init(layout, input_shapes, kernel_shapes, output_shapes, padding, strides, dilation,
+                   out_dtype, has_bias, act == CUDNN_ACTIVATION_RELU);
+      return [=]() {
+        const DLTensor* bias = has_bias ? GetInput(node, 2) : nullptr;
+        runner->Run(GetInput(node, 0), GetInput(node, 1), bias,
+                    const_cast<DLTensor*>(data_entry_[output_eid]));
+      };
+    }
+#endif
+
     /*conv mode: CUDNN_CROSS_CORRELATION by default*/
     int mode = CUDNN_CROSS_CORRELATION;
 
@@ -176,7 +199,6 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
       };
 
       auto [a_ptr, b_ptr, bias_ptr] = get_inputs(node, has_bias);
-      uint32_t output_eid = EntryID(outputs_[0]);
       auto out_ptr = data_entry_[output_eid];
       if (has_bias) {
         tvm::contrib::ConvolutionBiasActivationForward(
@@ -191,7 +213,7 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
     return op_exec;
   }
 
-  std::function<void()> GetAttentionExec(const JSONGraphNode& node) {
+  std::function<void()> GetAttentionExec(const JSONGraphNode& node, uint32_t output_eid) {
 #ifdef TVM_USE_CUDNN_FRONTEND
     auto dtype = node.GetOpDataType()[0];
     int num_heads = vstr2vint(node, "num_heads")[0];
@@ -226,7 +248,7 @@ class cuDNNJSONRuntime : public JSONRuntimeBase {
     return [=]() {
       auto qkv = GetInput(node, 0);
       auto workspace = const_cast<DLTensor*>(GetInput(node, 1));
-      auto out = const_cast<DLTensor*>(data_entry_[EntryID(outputs_[0])]);
+      auto out = const_cast<DLTensor*>(data_entry_[output_eid]);
       runner->Run(qkv, workspace, out);
     };
 #else
@@ -0,0 +1,495 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cupti.cc
+ * \brief A MetricCollector of the roofline metrics of CUDA kernels, with the CUPTI profiling API.
+ */
+#include <cuda.h>
+#include <cupti_profiler_target.h>
+#include <cupti_target.h>
+#include <nvperf_cuda_host.h>
+#include <nvperf_host.h>
+#include <nvperf_target.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/contrib/cupti.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define CUPTI_CALL(func)                                                             \
+  {                                                                                  \
+    CUptiResult e = (func);                                                          \
+    if (e != CUPTI_SUCCESS) {                                                        \
+      const char* msg;                                                               \
+      cuptiGetResultString(e, &msg);                                                 \
+      LOG(FATAL) << "CUPTIError: in function " #func " failed with error: " << msg;  \
+    }                                                                                \
+  }
+
+#define NVPW_CALL(func)                                                         \
+  {                                                                             \
+    NVPA_Status e = (func);                                                     \
+    if (e != NVPA_STATUS_SUCCESS) {                                             \
+      LOG(FATAL) << "NVPWError: in function " #func " failed with error " << e; \
+    }                                                                           \
+  }
+
+/*! \brief How the values of a metric over the kernels of a call are reported. */
+enum class CUPTIMetricKind : int {
+  /*! \brief A count, summed over the kernels. */
+  kCount = 0,
+  /*! \brief A ratio, averaged over the kernels. */
+  kAverage = 1,
+  /*! \brief A duration in nanoseconds, summed over the kernels. */
+  kDuration = 2,
+};
+
+/*! \brief A metric to evaluate, and how it is reported. */
+struct CUPTIMetric {
+  /*! \brief The name of the metric for CUPTI. */
+  std::string name;
+  /*! \brief The name of the metric in the reports. */
+  std::string report_name;
+  CUPTIMetricKind kind;
+};
+
+/*! \brief The time the kernels of a call run, which excludes the replays of the session. */
+static const CUPTIMetric kernel_duration_metric = {"gpu__time_duration.sum",
+                                                   "Kernel Duration (us)",
+                                                   CUPTIMetricKind::kDuration};
+
+static const std::vector<CUPTIMetric> default_metrics = {
+    {"dram__bytes.sum", "DRAM Bytes", CUPTIMetricKind::kCount},
+    {"sm__warps_active.avg.pct_of_peak_sustained_active", "Achieved Occupancy (%)",
+     CUPTIMetricKind::kAverage},
+    {"sm__pipe_tensor_cycles_active.avg.pct_of_peak_sustained_active",
+     "Tensor Core Utilization (%)", CUPTIMetricKind::kAverage},
+    kernel_duration_metric};
+
+/*! \brief The maximum number of kernels profiled in a call. */
+static constexpr int kMaxRanges = 256;
+
+/*! \brief Object that marks the device of a call that is profiled. */
+struct CUPTISessionNode : public Object {
+  int device_id;
+
+  explicit CUPTISessionNode(int device_id) : device_id(device_id) {}
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("CUPTISessionNode", CUPTISessionNode, Object);
+};
+
+/*! \brief The profiler configuration of a device, and the images its sessions write to. */
+struct CUPTIDeviceState {
+  CUcontext ctx;
+  std::string chip_name;
+  std::vector<uint8_t> counter_availability;
+  std::vector<uint8_t> evaluator_scratch;
+  NVPW_MetricsEvaluator* evaluator{nullptr};
+  std::vector<NVPW_MetricEvalRequest> eval_requests;
+  std::vector<uint8_t> config_image;
+  std::vector<uint8_t> counter_data_prefix;
+  std::vector<uint8_t> counter_data;
+  std::vector<uint8_t> counter_data_scratch;
+  /*! \brief The peak DRAM bandwidth in GB/s. */
+  double peak_dram_bandwidth;
+  bool in_session{false};
+};
+
+/*! \brief MetricCollectorNode for the metrics of CUDA kernels, from CUPTI.
+ *
+ * Each call is profiled in its own session in kernel replay mode, so that CUPTI replays each
+ * kernel of the call until all the counters the metrics need are collected, and each kernel
+ * is a range of the session. The metrics are summed or averaged over the kernels.
+ */
+struct CUPTIMetricCollectorNode final : public MetricCollectorNode {
+  explicit CUPTIMetricCollectorNode(std::vector<CUPTIMetric> metrics)
+      : metrics(std::move(metrics)) {}
+
+  void Init(ffi::Array<DeviceWrapper> devices) final {
+    CUpti_Profiler_Initialize_Params init = {CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerInitialize(&init));
+    NVPW_InitializeHost_Params host = {NVPW_InitializeHost_Params_STRUCT_SIZE};
+    NVPW_CALL(NVPW_InitializeHost(&host));
+    for (auto wrapped_device : devices) {
+      Device dev = wrapped_device->device;
+      if (dev.device_type == kDLCUDA && !states.count(dev.device_id)) {
+        InitDevice(dev.device_id, &states[dev.device_id]);
+      }
+    }
+  }
+
+  ObjectRef Start(Device dev) final {
+    if (dev.device_type != kDLCUDA) return ObjectRef(nullptr);
+    auto it = states.find(dev.device_id);
+    // A session profiles a single call at a time.
+    if (it == states.end() || it->second.in_session) return ObjectRef(nullptr);
+    CUPTIDeviceState& state = it->second;
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaDeviceSynchronize());
+    InitCounterData(&state);
+
+    CUpti_Profiler_BeginSession_Params begin = {CUpti_Profiler_BeginSession_Params_STRUCT_SIZE};
+    begin.ctx = state.ctx;
+    begin.counterDataImageSize = state.counter_data.size();
+    begin.pCounterDataImage = state.counter_data.data();
+    begin.counterDataScratchBufferSize = state.counter_data_scratch.size();
+    begin.pCounterDataScratchBuffer = state.counter_data_scratch.data();
+    begin.range = CUPTI_AutoRange;
+    begin.replayMode = CUPTI_KernelReplay;
+    begin.maxRangesPerPass = kMaxRanges;
+    begin.maxLaunchesPerPass = kMaxRanges;
+    CUPTI_CALL(cuptiProfilerBeginSession(&begin));
+
+    CUpti_Profiler_SetConfig_Params config = {CUpti_Profiler_SetConfig_Params_STRUCT_SIZE};
+    config.ctx = state.ctx;
+    config.pConfig = state.config_image.data();
+    config.configSize = state.config_image.size();
+    config.passIndex = 0;
+    config.minNestingLevel = 1;
+    config.numNestingLevels = 1;
+    CUPTI_CALL(cuptiProfilerSetConfig(&config));
+
+    CUpti_Profiler_EnableProfiling_Params enable = {
+        CUpti_Profiler_EnableProfiling_Params_STRUCT_SIZE};
+    enable.ctx = state.ctx;
+    CUPTI_CALL(cuptiProfilerEnableProfiling(&enable));
+    state.in_session = true;
+    return ObjectRef(ffi::make_object<CUPTISessionNode>(dev.device_id));
+  }
+
+  ffi::Map<ffi::String, ffi::Any> Stop(ObjectRef obj) final {
+    int device_id = obj.as<CUPTISessionNode>()->device_id;
+    CUPTIDeviceState& state = states.at(device_id);
+    CUDA_CALL(cudaSetDevice(device_id));
+    CUDA_CALL(cudaDeviceSynchronize());
+
+    CUpti_Profiler_DisableProfiling_Params disable = {
+        CUpti_Profiler_DisableProfiling_Params_STRUCT_SIZE};
+    disable.ctx = state.ctx;
+    CUPTI_CALL(cuptiProfilerDisableProfiling(&disable));
+    CUpti_Profiler_UnsetConfig_Params unset = {CUpti_Profiler_UnsetConfig_Params_STRUCT_SIZE};
+    unset.ctx = state.ctx;
+    CUPTI_CALL(cuptiProfilerUnsetConfig(&unset));
+    CUpti_Profiler_EndSession_Params end = {CUpti_Profiler_EndSession_Params_STRUCT_SIZE};
+    end.ctx = state.ctx;
+    CUPTI_CALL(cuptiProfilerEndSession(&end));
+    state.in_session = false;
+
+    NVPW_CounterData_GetNumRanges_Params ranges = {
+        NVPW_CounterData_GetNumRanges_Params_STRUCT_SIZE};
+    ranges.pCounterDataImage = state.counter_data.data();
+    NVPW_CALL(NVPW_CounterData_GetNumRanges(&ranges));
+    ffi::Map<ffi::String, ffi::Any> reported_metrics;
+    // the call launched no kernel
+    if (ranges.numRanges == 0) return reported_metrics;
+
+    NVPW_MetricsEvaluator_SetDeviceAttributes_Params attrs = {
+        NVPW_MetricsEvaluator_SetDeviceAttributes_Params_STRUCT_SIZE};
+    attrs.pMetricsEvaluator = state.evaluator;
+    attrs.pCounterDataImage = state.counter_data.data();
+    attrs.counterDataImageSize = state.counter_data.size();
+    NVPW_CALL(NVPW_MetricsEvaluator_SetDeviceAttributes(&attrs));
+
+    std::vector<double> sums(metrics.size(), 0);
+    std::vector<double> values(metrics.size());
+    for (size_t range = 0; range < ranges.numRanges; ++range) {
+      NVPW_MetricsEvaluator_EvaluateToGpuValues_Params eval = {
+          NVPW_MetricsEvaluator_EvaluateToGpuValues_Params_STRUCT_SIZE};
+      eval.pMetricsEvaluator = state.evaluator;
+      eval.pMetricEvalRequests = state.eval_requests.data();
+      eval.numMetricEvalRequests = state.eval_requests.size();
+      eval.metricEvalRequestStructSize = NVPW_MetricEvalRequest_STRUCT_SIZE;
+      eval.metricEvalRequestStrideSize = sizeof(NVPW_MetricEvalRequest);
+      eval.pCounterDataImage = state.counter_data.data();
+      eval.counterDataImageSize = state.counter_data.size();
+      eval.rangeIndex = range;
+      eval.isolated = true;
+      eval.pMetricValues = values.data();
+      NVPW_CALL(NVPW_MetricsEvaluator_EvaluateToGpuValues(&eval));
+      for (size_t i = 0; i < metrics.size(); ++i) sums[i] += values[i];
+    }
+    for (size_t i = 0; i < metrics.size(); ++i) {
+      if (metrics[i].kind == CUPTIMetricKind::kCount) {
+        reported_metrics.Set(metrics[i].report_name,
+                             ObjectRef(ffi::make_object<CountNode>(static_cast<int64_t>(sums[i]))));
+      } else if (metrics[i].kind == CUPTIMetricKind::kDuration) {
+        reported_metrics.Set(metrics[i].report_name,
+                             ObjectRef(ffi::make_object<DurationNode>(sums[i] / 1e3)));
+      } else {
+        reported_metrics.Set(metrics[i].report_name,
+                             ObjectRef(ffi::make_object<RatioNode>(sums[i] / ranges.numRanges)));
+      }
+    }
+    reported_metrics.Set("Peak DRAM Bandwidth (GB/s)",
+                         ObjectRef(ffi::make_object<RatioNode>(state.peak_dram_bandwidth)));
+    return reported_metrics;
+  }
+
+  bool SupportsNesting() const final { return false; }
+
+  ~CUPTIMetricCollectorNode() final {
+    for (auto& kv : states) {
+      NVPW_MetricsEvaluator_Destroy_Params destroy = {
+          NVPW_MetricsEvaluator_Destroy_Params_STRUCT_SIZE};
+      destroy.pMetricsEvaluator = kv.second.evaluator;
+      NVPW_MetricsEvaluator_Destroy(&destroy);
+    }
+    if (!states.empty()) {
+      CUpti_Profiler_DeInitialize_Params deinit = {CUpti_Profiler_DeInitialize_Params_STRUCT_SIZE};
+      cuptiProfilerDeInitialize(&deinit);
+    }
+  }
+
+  /*! \brief The metrics to collect. */
+  std::vector<CUPTIMetric> metrics;
+  /*! \brief The state of each CUDA device id. */
+  std::unordered_map<int, CUPTIDeviceState> states;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("runtime.profiling.CUPTIMetricCollector",
+                                    CUPTIMetricCollectorNode, MetricCollectorNode);
+
+ private:
+  /*! \brief Create the metrics evaluator, the config image and the counter data prefix. */
+  void InitDevice(int device_id, CUPTIDeviceState* state) {
+    CUDA_CALL(cudaSetDevice(device_id));
+    // create the primary context of the device
+    CUDA_CALL(cudaFree(nullptr));
+    CUDA_DRIVER_CALL(cuCtxGetCurrent(&state->ctx));
+
+    CUpti_Device_GetChipName_Params chip = {CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+    chip.deviceIndex = device_id;
+    CUPTI_CALL(cuptiDeviceGetChipName(&chip));
+    state->chip_name = chip.pChipName;
+    const char* chip_name = state->chip_name.c_str();
+
+    CUpti_Profiler_GetCounterAvailability_Params avail = {
+        CUpti_Profiler_GetCounterAvailability_Params_STRUCT_SIZE};
+    avail.ctx = state->ctx;
+    CUPTI_CALL(cuptiProfilerGetCounterAvailability(&avail));
+    state->counter_availability.resize(avail.counterAvailabilityImageSize);
+    avail.pCounterAvailabilityImage = state->counter_availability.data();
+    CUPTI_CALL(cuptiProfilerGetCounterAvailability(&avail));
+    const uint8_t* availability = state->counter_availability.data();
+
+    NVPW_CUDA_MetricsEvaluator_CalculateScratchBufferSize_Params scratch = {
+        NVPW_CUDA_MetricsEvaluator_CalculateScratchBufferSize_Params_STRUCT_SIZE};
+    scratch.pChipName = chip_name;
+    scratch.pCounterAvailabilityImage = availability;
+    NVPW_CALL(NVPW_CUDA_MetricsEvaluator_CalculateScratchBufferSize(&scratch));
+    state->evaluator_scratch.resize(scratch.scratchBufferSize);
+    NVPW_CUDA_MetricsEvaluator_Initialize_Params evaluator = {
+        NVPW_CUDA_MetricsEvaluator_Initialize_Params_STRUCT_SIZE};
+    evaluator.pScratchBuffer = state->evaluator_scratch.data();
+    evaluator.scratchBufferSize = state->evaluator_scratch.size();
+    evaluator.pChipName = chip_name;
+    evaluator.pCounterAvailabilityImage = availability;
+    NVPW_CALL(NVPW_CUDA_MetricsEvaluator_Initialize(&evaluator));
+    state->evaluator = evaluator.pMetricsEvaluator;
+
+    // the raw counters the metrics are computed from
+    std::vector<NVPA_RawMetricRequest> raw_requests;
+    for (const CUPTIMetric& metric : metrics) {
+      NVPW_MetricEvalRequest request;
+      NVPW_MetricsEvaluator_ConvertMetricNameToMetricEvalRequest_Params convert = {
+          NVPW_MetricsEvaluator_ConvertMetricNameToMetricEvalRequest_Params_STRUCT_SIZE};
+      convert.pMetricsEvaluator = state->evaluator;
+      convert.pMetricName = metric.name.c_str();
+      convert.pMetricEvalRequest = &request;
+      convert.metricEvalRequestStructSize = NVPW_MetricEvalRequest_STRUCT_SIZE;
+      NVPA_Status status = NVPW_MetricsEvaluator_ConvertMetricNameToMetricEvalRequest(&convert);
+      CHECK_EQ(status, NVPA_STATUS_SUCCESS)
+          << "ValueError: Unknown CUPTI metric " << metric.name << " for chip " << chip_name;
+      state->eval_requests.push_back(request);
+
+      NVPW_MetricsEvaluator_GetMetricRawDependencies_Params deps = {
+          NVPW_MetricsEvaluator_GetMetricRawDependencies_Params_STRUCT_SIZE};
+      deps.pMetricsEvaluator = state->evaluator;
+      deps.pMetricEvalRequests = &request;
+      deps.numMetricEvalRequests = 1;
+      deps.metricEvalRequestStructSize = NVPW_MetricEvalRequest_STRUCT_SIZE;
+      deps.metricEvalRequestStrideSize = sizeof(NVPW_MetricEvalRequest);
+      NVPW_CALL(NVPW_MetricsEvaluator_GetMetricRawDependencies(&deps));
+      std::vector<const char*> names(deps.numRawDependencies);
+      deps.ppRawDependencies = names.data();
+      NVPW_CALL(NVPW_MetricsEvaluator_GetMetricRawDependencies(&deps));
+      for (const char* name : names) {
+        NVPA_RawMetricRequest raw = {NVPA_RAW_METRIC_REQUEST_STRUCT_SIZE};
+        raw.pMetricName = name;
+        raw.isolated = true;
+        raw.keepInstances = true;
+        raw_requests.push_back(raw);
+      }
+    }
+
+    NVPW_CUDA_RawMetricsConfig_Create_V2_Params create = {
+        NVPW_CUDA_RawMetricsConfig_Create_V2_Params_STRUCT_SIZE};
+    create.activityKind = NVPA_ACTIVITY_KIND_PROFILER;
+    create.pChipName = chip_name;
+    create.pCounterAvailabilityImage = availability;
+    NVPW_CALL(NVPW_CUDA_RawMetricsConfig_Create_V2(&create));
+    NVPA_RawMetricsConfig* config = create.pRawMetricsConfig;
+    NVPW_RawMetricsConfig_BeginPassGroup_Params begin = {
+        NVPW_RawMetricsConfig_BeginPassGroup_Params_STRUCT_SIZE};
+    begin.pRawMetricsConfig = config;
+    NVPW_CALL(NVPW_RawMetricsConfig_BeginPassGroup(&begin));
+    NVPW_RawMetricsConfig_AddMetrics_Params add = {
+        NVPW_RawMetricsConfig_AddMetrics_Params_STRUCT_SIZE};
+    add.pRawMetricsConfig = config;
+    add.pRawMetricRequests = raw_requests.data();
+    add.numMetricRequests = raw_requests.size();
+    NVPW_CALL(NVPW_RawMetricsConfig_AddMetrics(&add));
+    NVPW_RawMetricsConfig_EndPassGroup_Params end = {
+        NVPW_RawMetricsConfig_EndPassGroup_Params_STRUCT_SIZE};
+    end.pRawMetricsConfig = config;
+    NVPW_CALL(NVPW_RawMetricsConfig_EndPassGroup(&end));
+    NVPW_RawMetricsConfig_GenerateConfigImage_Params generate = {
+        NVPW_RawMetricsConfig_GenerateConfigImage_Params_STRUCT_SIZE};
+    generate.pRawMetricsConfig = config;
+    NVPW_CALL(NVPW_RawMetricsConfig_GenerateConfigImage(&generate));
+    NVPW_RawMetricsConfig_GetConfigImage_Params image = {
+        NVPW_RawMetricsConfig_GetConfigImage_Params_STRUCT_SIZE};
+    image.pRawMetricsConfig = config;
+    NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&image));
+    state->config_image.resize(image.bytesCopied);
+    image.bytesAllocated = state->config_image.size();
+    image.pBuffer = state->config_image.data();
+    NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&image));
+    NVPW_RawMetricsConfig_Destroy_Params destroy_config = {
+        NVPW_RawMetricsConfig_Destroy_Params_STRUCT_SIZE};
+    destroy_config.pRawMetricsConfig = config;
+    NVPW_CALL(NVPW_RawMetricsConfig_Destroy(&destroy_config));
+
+    NVPW_CUDA_CounterDataBuilder_Create_Params builder = {
+        NVPW_CUDA_CounterDataBuilder_Create_Params_STRUCT_SIZE};
+    builder.pChipName = chip_name;
+    builder.pCounterAvailabilityImage = availability;
+    NVPW_CALL(NVPW_CUDA_CounterDataBuilder_Create(&builder));
+    NVPW_CounterDataBuilder_AddMetrics_Params add_counters = {
+        NVPW_CounterDataBuilder_AddMetrics_Params_STRUCT_SIZE};
+    add_counters.pCounterDataBuilder = builder.pCounterDataBuilder;
+    add_counters.pRawMetricRequests = raw_requests.data();
+    add_counters.numMetricRequests = raw_requests.size();
+    NVPW_CALL(NVPW_CounterDataBuilder_AddMetrics(&add_counters));
+    NVPW_CounterDataBuilder_GetCounterDataPrefix_Params prefix = {
+        NVPW_CounterDataBuilder_GetCounterDataPrefix_Params_STRUCT_SIZE};
+    prefix.pCounterDataBuilder = builder.pCounterDataBuilder;
+    NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&prefix));
+    state->counter_data_prefix.resize(prefix.bytesCopied);
+    prefix.bytesAllocated = state->counter_data_prefix.size();
+    prefix.pBuffer = state->counter_data_prefix.data();
+    NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&prefix));
+    NVPW_CounterDataBuilder_Destroy_Params destroy_builder = {
+        NVPW_CounterDataBuilder_Destroy_Params_STRUCT_SIZE};
+    destroy_builder.pCounterDataBuilder = builder.pCounterDataBuilder;
+    NVPW_CALL(NVPW_CounterDataBuilder_Destroy(&destroy_builder));
+
+    // DDR memory transfers twice per clock.
+    int memory_clock_khz, bus_width_bits;
+    CUDA_CALL(cudaDeviceGetAttribute(&memory_clock_khz, cudaDevAttrMemoryClockRate, device_id));
+    CUDA_CALL(
+        cudaDeviceGetAttribute(&bus_width_bits, cudaDevAttrGlobalMemoryBusWidth, device_id));
+    state->peak_dram_bandwidth = 2.0 * memory_clock_khz * 1e3 * (bus_width_bits / 8.0) / 1e9;
+  }
+
+  /*! \brief Initialize the counter data image of a new session. */
+  void InitCounterData(CUPTIDeviceState* state) {
+    CUpti_Profiler_CounterDataImageOptions options = {
+        CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE};
+    options.pCounterDataPrefix = state->counter_data_prefix.data();
+    options.counterDataPrefixSize = state->counter_data_prefix.size();
+    options.maxNumRanges = kMaxRanges;
+    options.maxNumRangeTreeNodes = kMaxRanges;
+    options.maxRangeNameLength = 64;
+
+    CUpti_Profiler_CounterDataImage_CalculateSize_Params size = {
+        CUpti_Profiler_CounterDataImage_CalculateSize_Params_STRUCT_SIZE};
+    size.sizeofCounterDataImageOptions = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+    size.pOptions = &options;
+    CUPTI_CALL(cuptiProfilerCounterDataImageCalculateSize(&size));
+    state->counter_data.resize(size.counterDataImageSize);
+
+    CUpti_Profiler_CounterDataImage_Initialize_Params init = {
+        CUpti_Profiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+    init.sizeofCounterDataImageOptions = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+    init.pOptions = &options;
+    init.counterDataImageSize = state->counter_data.size();
+    init.pCounterDataImage = state->counter_data.data();
+    CUPTI_CALL(cuptiProfilerCounterDataImageInitialize(&init));
+
+    CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params scratch = {
+        CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params_STRUCT_SIZE};
+    scratch.counterDataImageSize = state->counter_data.size();
+    scratch.pCounterDataImage = state->counter_data.data();
+    CUPTI_CALL(cuptiProfilerCounterDataImageCalculateScratchBufferSize(&scratch));
+    state->counter_data_scratch.resize(scratch.counterDataScratchBufferSize);
+
+    CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params init_scratch = {
+        CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params_STRUCT_SIZE};
+    init_scratch.counterDataImageSize = state->counter_data.size();
+    init_scratch.pCounterDataImage = state->counter_data.data();
+    init_scratch.counterDataScratchBufferSize = state->counter_data_scratch.size();
+    init_scratch.pCounterDataScratchBuffer = state->counter_data_scratch.data();
+    CUPTI_CALL(cuptiProfilerCounterDataImageInitializeScratchBuffer(&init_scratch));
+  }
+};
+
+/*! \brief Wrapper for `CUPTIMetricCollectorNode`. */
+class CUPTIMetricCollector : public MetricCollector {
+ public:
+  explicit CUPTIMetricCollector(ffi::Array<ffi::String> metric_names) {
+    std::vector<CUPTIMetric> metrics;
+    for (const ffi::String& name : metric_names) {
+      // the metrics are reported by their names, and averaged over the kernels of a call.
+      if (name != kernel_duration_metric.name) {
+        metrics.push_back({name, name, CUPTIMetricKind::kAverage});
+      }
+    }
+    // The wall-clock duration of a call includes the replays of its kernels, so the kernel
+    // duration is always collected for the rates the report derives.
+    if (!metrics.empty()) {
+      metrics.push_back(kernel_duration_metric);
+    }
+    data_ = ffi::make_object<CUPTIMetricCollectorNode>(metrics.empty() ? default_metrics
+                                                                       : metrics);
+  }
+  TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(CUPTIMetricCollector, MetricCollector,
+                                             CUPTIMetricCollectorNode);
+};
+
+MetricCollector CreateCUPTIMetricCollector(ffi::Array<ffi::String> metrics) {
+  return CUPTIMetricCollector(metrics);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("runtime.profiling.CUPTIMetricCollector",
+                        [](ffi::Array<ffi::String> metrics) {
+                          return CUPTIMetricCollector(metrics);
+                        });
+}
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -21,6 +21,8 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/base.h>
 
+#include <atomic>
+
 #include "../../cuda/cuda_common.h"
 #include "./helper_cuda_kernels.h"
 
@@ -107,6 +109,19 @@ void RandomFill(DLTensor* tensor) {
     } else {
       CURandGenerator().Generate64bit(tensor->data, actual_size);
     }
+  } else if (tensor->dtype.code == DLDataTypeCode::kDLInt ||
+             tensor->dtype.code == DLDataTypeCode::kDLUInt ||
+             tensor->dtype.code == DLDataTypeCode::kDLBool) {
+    int bits = tensor->dtype.bits;
+    CHECK(bits == 4 || bits == 8 || bits == 16 || bits == 32 || bits == 64)
+        << "ValueError: Unsupported dtype: " << tensor->dtype;
+    // The successive fills take disjoint counters of the stream.
+    static std::atomic<uint64_t> next_counter{0};
+    constexpr uint64_t kPhiloxKey = 0x5443564D52414E44ULL;
+    int64_t num = bits == 4 ? (tensor_size + 1) / 2 : tensor_size;
+    uint64_t offset = next_counter.fetch_add((num + 3) / 4);
+    PhiloxFillIntegers(tensor->data, num, bits, tensor->dtype.code == DLDataTypeCode::kDLBool,
+                       kPhiloxKey, offset);
   } else {
     LOG(FATAL) << "ValueError: Unsupported dtype: " << tensor->dtype;
   }
@@ -20,10 +20,14 @@
 
 #include "./helper_cuda_kernels.h"
 
+#include "../random/philox.h"
+
 namespace tvm {
 namespace runtime {
 namespace curand {
 
+namespace philox = ::tvm::contrib::philox;
+
 __global__ void KernelFp32ToFp16(const float* src, half* dst, int num) {
   int idx = blockDim.x * blockIdx.x + threadIdx.x;
   if (idx < num) {
@@ -37,6 +41,47 @@ void ConvertFp32toFp16(const void* _src, void* _dst, int64_t num) {
   KernelFp32ToFp16<<<(num + 255) / 256, 256>>>(src, dst, num);
 }
 
+// Each thread generates the 4 items of a counter.
+template <typename T>
+__global__ void KernelPhiloxFill(T* dst, int64_t num, uint64_t key, uint64_t offset, float low,
+                                 float high) {
+  int64_t counter = static_cast<int64_t>(blockDim.x) * blockIdx.x + threadIdx.x;
+  int64_t first = counter * philox::kOutputsPerCounter;
+  if (first >= num) return;
+  uint32_t bits[philox::kOutputsPerCounter];
+  philox::Philox4x32(key, offset + counter, bits);
+  for (int j = 0; j < philox::kOutputsPerCounter && first + j < num; ++j) {
+    dst[first + j] = static_cast<T>(philox::ToUniform(bits[j], low, high));
+  }
+}
+
+template <typename T>
+void LaunchPhiloxFill(void* dst, int64_t num, uint64_t key, uint64_t offset, float low,
+                      float high) {
+  int64_t num_counters =
+      (num + philox::kOutputsPerCounter - 1) / philox::kOutputsPerCounter;
+  KernelPhiloxFill<T><<<(num_counters + 255) / 256, 256>>>(static_cast<T*>(dst), num, key, offset,
+                                                           low, high);
+}
+
+void PhiloxFillIntegers(void* dst, int64_t num, int bits, bool is_bool, uint64_t key,
+                        uint64_t offset) {
+  if (is_bool) {
+    LaunchPhiloxFill<bool>(dst, num, key, offset, 1.0f, 10.0f);
+  } else if (bits == 4) {
+    // Two packed values per byte, both non-zero.
+    LaunchPhiloxFill<uint8_t>(dst, num, key, offset, 17.0f, 30.0f);
+  } else if (bits == 8) {
+    LaunchPhiloxFill<uint8_t>(dst, num, key, offset, 1.0f, 10.0f);
+  } else if (bits == 16) {
+    LaunchPhiloxFill<uint16_t>(dst, num, key, offset, 1.0f, 10.0f);
+  } else if (bits == 32) {
+    LaunchPhiloxFill<uint32_t>(dst, num, key, offset, 1.0f, 10.0f);
+  } else if (bits == 64) {
+    LaunchPhiloxFill<uint64_t>(dst, num, key, offset, 1.0f, 10.0f);
+  }
+}
+
 }  // namespace curand
 }  // namespace runtime
 }  // namespace tvm
@@ -34,6 +34,19 @@ namespace curand {
  */
 void ConvertFp32toFp16(const void* src, void* dst, int64_t num);
 
+/*!
+ * \brief Fill an array of integers or booleans with the non-zero values of the host
+ *  RandomFillForMeasure, generated on the device from the Philox stream.
+ * \param dst The destination array.
+ * \param num The number of items, which are bytes for 4-bit types.
+ * \param bits The number of bits of the items, 4 for a byte packing two values.
+ * \param is_bool Whether the items are booleans.
+ * \param key The key of the Philox stream.
+ * \param offset The counter of the first 4 items.
+ */
+void PhiloxFillIntegers(void* dst, int64_t num, int bits, bool is_bool, uint64_t key,
+                        uint64_t offset);
+
 }  // namespace curand
 }  // namespace runtime
 }  // namespace tvm
@@ -27,7 +27,9 @@
 #include <tvm/runtime/tensor.h>
 
 #include <cstddef>
+#include <sstream>
 #include <string>
+#include <typeinfo>
 #include <vector>
 
 #include "../../../runtime/regex.h"
@@ -243,7 +245,8 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   // Build up the engine based on the input graph.
   void BuildEngine() {
-    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
+    // The primitives are shared with the other modules through the cache, and run on its engine.
+    engine_ = DNNLPrimitiveCache::Global()->engine();
     stream_ = dnnl::stream(engine_);
 
     std::set<uint32_t> io_eid_set(run_arg_eid_.begin(), run_arg_eid_.end());
@@ -292,6 +295,59 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         }
       }
     }
+    tensor_registry_.PlanMemory(net_);
+  }
+
+  /*!
+   * \brief Get the signature of the op of a node, which determines its primitive: the op name and
+   * attributes, the shapes and dtypes of the inputs and outputs, and the data of the constants set
+   * as the primitive attributes by ParseAttrs.
+   */
+  std::string GetOpSignature(const size_t& nid) {
+    const JSONGraphNode& node = nodes_[nid];
+    std::ostringstream os;
+    os << node.GetOpName() << ";";
+    for (const auto& key : node.GetAttrKeys()) {
+      os << key << "=";
+      for (const auto& value : node.GetAttr<std::vector<std::string>>(key)) os << value << ",";
+      os << ";";
+    }
+    auto f_add_shapes = [&os](const JSONGraphNode& entry_node, size_t index) {
+      for (int64_t dim : entry_node.GetOpShape()[index]) os << dim << ",";
+      os << ffi::DLDataTypeToString(entry_node.GetOpDataType()[index]) << ";";
+    };
+    for (const auto& entry : node.GetInputs()) f_add_shapes(nodes_[entry.id_], entry.index_);
+    for (size_t i = 0; i < node.GetNumOutput(); ++i) f_add_shapes(node, i);
+    // The post-op scales, sums and zero points are folded into the primitive.
+    std::vector<int> const_indices;
+    for (const char* name : {"o_scl_idx", "sum_scl_idx", "dst_zp_idx"}) {
+      const_indices.push_back(GetNodeAttr<int>(node, name, {"-1"}));
+    }
+    auto activation = GetNodeAttr<std::vector<std::string>>(node, "activation", {"none"});
+    for (size_t i = 1; i < activation.size(); ++i) {
+      const_indices.push_back(std::stoi(activation[i]));
+    }
+    for (int idx : const_indices) {
+      if (idx < 0 || idx >= static_cast<int>(node.GetInputs().size())) continue;
+      const auto& entry = node.GetInputs()[idx];
+      const DLTensor* tensor = data_entry_[node_row_ptr_[entry.id_] + entry.index_];
+      if (tensor == nullptr) continue;
+      os << "const" << idx << "="
+         << std::string(static_cast<const char*>(tensor->data) + tensor->byte_offset,
+                        GetDataSize(*tensor))
+         << ";";
+    }
+    return os.str();
+  }
+
+  /*!
+   * \brief Create the primitive of the op of a node from its descriptor, or reuse the primitive of
+   * an op of the same signature, created by this module or any other.
+   */
+  template <typename PrimT>
+  dnnl::primitive MakePrimitive(const size_t& nid, const typename PrimT::primitive_desc& pd) {
+    std::string signature = std::string(typeid(PrimT).name()) + ":" + GetOpSignature(nid);
+    return DNNLPrimitiveCache::Global()->GetOrCreate(signature, [&pd]() { return PrimT(pd); });
   }
 
   void Convolution(const size_t& nid) {
@@ -383,7 +439,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
       sum_in_tr = sum_in_tr.TreatAs(dst_layout);
     }
 
-    Submit(dnnl::convolution_forward(conv_prim_desc),
+    Submit(MakePrimitive<dnnl::convolution_forward>(nid, conv_prim_desc),
            {{DNNL_ARG_SRC, src_tr},
             {DNNL_ARG_WEIGHTS, wgh_tr},
             {DNNL_ARG_BIAS, bias_tr},
@@ -452,11 +508,12 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     auto scratchpad_tr = TensorRequisite::AsIs(deconv_prim_desc.scratchpad_desc());
 
-    Submit(dnnl::deconvolution_forward(deconv_prim_desc), {{DNNL_ARG_SRC, src_tr},
-                                                           {DNNL_ARG_WEIGHTS, wgh_tr},
-                                                           {DNNL_ARG_BIAS, bias_tr},
-                                                           {DNNL_ARG_SCRATCHPAD, scratchpad_tr},
-                                                           {DNNL_ARG_DST, dst_tr}});
+    Submit(MakePrimitive<dnnl::deconvolution_forward>(nid, deconv_prim_desc),
+           {{DNNL_ARG_SRC, src_tr},
+            {DNNL_ARG_WEIGHTS, wgh_tr},
+            {DNNL_ARG_BIAS, bias_tr},
+            {DNNL_ARG_SCRATCHPAD, scratchpad_tr},
+            {DNNL_ARG_DST, dst_tr}});
   }
 
   void Dense(const size_t& nid) {
@@ -496,7 +553,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
       sum_in_tr = GetInput(nid, node.GetInputs().size() - 1);
     }
 
-    Submit(dnnl::inner_product_forward(dense_prim_desc),
+    Submit(MakePrimitive<dnnl::inner_product_forward>(nid, dense_prim_desc),
            {{DNNL_ARG_SRC, src_tr},
             {DNNL_ARG_WEIGHTS, wgh_tr},
             {DNNL_ARG_BIAS, bias_tr},
@@ -544,11 +601,11 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     auto scratchpad_tr = TensorRequisite::AsIs(bmm_prim_desc.scratchpad_desc());
 
-    Submit(dnnl::matmul(bmm_prim_desc), {{DNNL_ARG_SRC, src_tr},
-                                         {DNNL_ARG_WEIGHTS, wgh_tr},
-                                         {DNNL_ARG_BIAS, bias_tr},
-                                         {DNNL_ARG_SCRATCHPAD, scratchpad_tr},
-                                         {DNNL_ARG_DST, dst_tr}});
+    Submit(MakePrimitive<dnnl::matmul>(nid, bmm_prim_desc), {{DNNL_ARG_SRC, src_tr},
+                                                             {DNNL_ARG_WEIGHTS, wgh_tr},
+                                                             {DNNL_ARG_BIAS, bias_tr},
+                                                             {DNNL_ARG_SCRATCHPAD, scratchpad_tr},
+                                                             {DNNL_ARG_DST, dst_tr}});
   }
 
   void BatchNorm(const size_t& nid) {
@@ -590,11 +647,12 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     register_copy(gamma_tr, scale_tr);
     register_copy(beta_tr, shift_tr);
 
-    Submit(dnnl::batch_normalization_forward(bn_prim_desc), {{DNNL_ARG_SRC, src_tr},
-                                                             {DNNL_ARG_DST, dst_tr},
-                                                             {DNNL_ARG_SCALE_SHIFT, scale_shift_tr},
-                                                             {DNNL_ARG_MEAN, mean_tr},
-                                                             {DNNL_ARG_VARIANCE, var_tr}});
+    Submit(MakePrimitive<dnnl::batch_normalization_forward>(nid, bn_prim_desc),
+           {{DNNL_ARG_SRC, src_tr},
+            {DNNL_ARG_DST, dst_tr},
+            {DNNL_ARG_SCALE_SHIFT, scale_shift_tr},
+            {DNNL_ARG_MEAN, mean_tr},
+            {DNNL_ARG_VARIANCE, var_tr}});
   }
 
   void LayerNorm(const size_t& nid) {
@@ -638,7 +696,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     register_copy(beta_tr, shift_tr);
 
     Submit(
-        dnnl::layer_normalization_forward(lnorm_prim_desc),
+        MakePrimitive<dnnl::layer_normalization_forward>(nid, lnorm_prim_desc),
         {{DNNL_ARG_SRC, src_tr}, {DNNL_ARG_DST, dst_tr}, {DNNL_ARG_SCALE_SHIFT, scale_shift_tr}});
   }
 
@@ -700,7 +758,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     auto scratchpad_tr = TensorRequisite::AsIs(pool_prim_desc.scratchpad_desc());
 
-    Submit(dnnl::pooling_v2_forward(pool_prim_desc),
+    Submit(MakePrimitive<dnnl::pooling_v2_forward>(nid, pool_prim_desc),
            {{DNNL_ARG_SRC, src_tr}, {DNNL_ARG_DST, dst_tr}, {DNNL_ARG_SCRATCHPAD, scratchpad_tr}});
   }
 
@@ -725,7 +783,8 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto elt_prim_desc = dnnl::eltwise_forward::primitive_desc(elt_desc, engine_);
     ICHECK(src_tr.desc() == elt_prim_desc.dst_desc());
 
-    Submit(dnnl::eltwise_forward(elt_prim_desc), {{DNNL_ARG_SRC, src_tr}, {DNNL_ARG_DST, dst_tr}});
+    Submit(MakePrimitive<dnnl::eltwise_forward>(nid, elt_prim_desc),
+           {{DNNL_ARG_SRC, src_tr}, {DNNL_ARG_DST, dst_tr}});
   }
 
   void Softmax(const size_t& nid) {
@@ -744,7 +803,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto softmax_prim_desc = dnnl::softmax_forward::primitive_desc(softmax_desc, engine_);
     ICHECK(dst_tr.desc() == softmax_prim_desc.dst_desc());
 
-    Submit(dnnl::softmax_forward(softmax_prim_desc),
+    Submit(MakePrimitive<dnnl::softmax_forward>(nid, softmax_prim_desc),
            {{DNNL_ARG_SRC, src_tr}, {DNNL_ARG_DST, dst_tr}});
   }
 
@@ -763,7 +822,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto binary_desc = dnnl::binary::desc(algo, lhs_tr.desc(), rhs_tr.desc(), dst_tr.desc());
     auto binary_prim_desc = dnnl::binary::primitive_desc(binary_desc, engine_);
 
-    Submit(dnnl::binary(binary_prim_desc),
+    Submit(MakePrimitive<dnnl::binary>(nid, binary_prim_desc),
            {{DNNL_ARG_SRC_0, lhs_tr}, {DNNL_ARG_SRC_1, rhs_tr}, {DNNL_ARG_DST, dst_tr}});
   }
 
@@ -933,7 +992,9 @@ TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
       .def("runtime.DNNLJSONRuntimeCreate", DNNLJSONRuntimeCreate)
-      .def("ffi.Module.load_from_bytes.dnnl_json", JSONRuntimeBase::LoadFromBytes<DNNLJSONRuntime>);
+      .def("ffi.Module.load_from_bytes.dnnl_json", JSONRuntimeBase::LoadFromBytes<DNNLJSONRuntime>)
+      .def("runtime.dnnl_primitive_cache_size",
+           []() { return static_cast<int64_t>(DNNLPrimitiveCache::Global()->size()); });
 }
 
 }  // namespace contrib
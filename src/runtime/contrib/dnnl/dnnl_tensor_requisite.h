@@ -43,6 +43,7 @@
 //  -Wzero-as-null-pointer-constant and -Wdocumentation-unknown-command
 #include <dnnl.hpp>
 
+#include "../json/json_memory_planner.h"
 #include "dnnl_utils.h"
 
 namespace tvm {
@@ -600,7 +601,43 @@ class TensorRegistry {
    */
   MemSolver MakeSolver(const DLTensorProvider& ext_provider) const {
     return MemSolverImpl(eng_, ext_provider, const_mem_collection_, ext_mem_collection_,
-                         tmp_mem_collection_, tmp_mem_mapping_);
+                         tmp_mem_collection_, tmp_mem_mapping_, tmp_mem_root_, tmp_mem_offsets_,
+                         arena_size_);
+  }
+
+  /*!
+   * \brief Plan the intermediate memories into a single arena by the liveness of their buffers in
+   * the action queue, so that the buffers not alive at the same time share memory.
+   *
+   * \param actions The action queue using all the registered TRs, in execution order.
+   */
+  void PlanMemory(const ActionQue& actions) {
+    // Resolve the temp memories reusing others to the root buffers holding their memory.
+    std::vector<size_t> root(tmp_mem_collection_.size());
+    for (size_t i = 0; i < root.size(); i++) {
+      auto found = tmp_mem_mapping_.find(i);
+      root[i] = found == tmp_mem_mapping_.end() ? i : root[found->second];
+    }
+    std::vector<size_t> sizes(root.size(), 0);
+    for (size_t i = 0; i < root.size(); i++) {
+      sizes[root[i]] = std::max(sizes[root[i]], tmp_mem_collection_[i].get_size());
+    }
+    // The first and the last actions using each root buffer. The buffers an action reads and
+    // writes are alive at the same time.
+    std::vector<std::pair<size_t, size_t>> lifetimes(root.size(), {actions.size(), 0});
+    for (size_t step = 0; step < actions.size(); step++) {
+      for (const auto& kvp : std::get<1>(actions[step])) {
+        if (kvp.second.flag_ != TMP_STORAGE) continue;
+        auto& lifetime = lifetimes[root[kvp.second.idx_]];
+        lifetime.first = std::min(lifetime.first, step);
+        lifetime.second = std::max(lifetime.second, step);
+      }
+    }
+    for (size_t i = 0; i < root.size(); i++) {
+      if (lifetimes[i].first > lifetimes[i].second) sizes[i] = 0;
+    }
+    tmp_mem_root_ = root;
+    arena_size_ = json::PlanArenaOffsets(sizes, lifetimes, &tmp_mem_offsets_);
   }
 
   void MarkInplace(const TensorRequisite& tr, const TensorRequisite& shared) {
@@ -661,7 +698,9 @@ class TensorRegistry {
                   const std::vector<dnnl::memory>& const_mems,
                   const std::vector<std::pair<uint32_t, dnnl::memory::desc>>& ext_mems,
                   const std::vector<dnnl::memory::desc>& tmp_mem_descs,
-                  const std::map<size_t, size_t>& tmp_mem_mapping)
+                  const std::map<size_t, size_t>& tmp_mem_mapping,
+                  const std::vector<size_t>& tmp_mem_root,
+                  const std::vector<size_t>& tmp_mem_offsets, size_t arena_size)
         : eng_(eng),
           ext_data_provider_(ext_data_provider),
           const_mems_(const_mems),
@@ -669,6 +708,23 @@ class TensorRegistry {
       // Construct temp memory objects on the fly. While we have no scratchpads
       // support on VM/GraphExecutor level.
       tmp_mems_.resize(tmp_mem_descs.size());
+      if (!tmp_mem_offsets.empty()) {
+        // Place the planned temp memories in a single arena.
+        if (arena_size > 0) {
+          arena_ = dnnl::memory({{static_cast<dnnl::memory::dim>(arena_size)},
+                                 dnnl::memory::data_type::u8,
+                                 dnnl::memory::format_tag::a},
+                                eng_);
+        }
+        ICHECK_EQ(tmp_mem_root.size(), tmp_mem_descs.size())
+            << "Temp memories were registered after the memory planning";
+        auto* base = static_cast<uint8_t*>(arena_ ? arena_.get_data_handle() : nullptr);
+        for (size_t i = 0; i < tmp_mem_descs.size(); i++) {
+          void* handle = base + tmp_mem_offsets[tmp_mem_root[i]];
+          tmp_mems_[i] = dnnl::memory(tmp_mem_descs[i], eng_, handle);
+        }
+        return;
+      }
       for (size_t i = 0; i < tmp_mem_descs.size(); i++) {
         auto found = tmp_mem_mapping.find(i);
 
@@ -707,6 +763,8 @@ class TensorRegistry {
     const std::vector<dnnl::memory>& const_mems_;
     const std::vector<std::pair<uint32_t, dnnl::memory::desc>>& ext_mems_;
     std::vector<dnnl::memory> tmp_mems_;
+    /*! \brief The arena of the planned temp memories, if any. */
+    dnnl::memory arena_;
   };
 
   ArgId MakeArgReq(ArgReqFlag flag, uint32_t idx) { return {flag, idx}; }
@@ -720,6 +778,14 @@ class TensorRegistry {
   /* Mapping of some temp buffer on previously registered. */
   std::map<size_t, size_t> tmp_mem_mapping_;
 
+  /* The root buffer of each temp buffer, and the arena offsets of the root buffers. Empty if the
+   *  memory is not planned. */
+  std::vector<size_t> tmp_mem_root_;
+  std::vector<size_t> tmp_mem_offsets_;
+
+  /* The byte size of the arena of the planned temp buffers. */
+  size_t arena_size_ = 0;
+
   /* Collection of external_intermediate memory objects.
    *  first  - eid of external buffer to ask
    *  second - t_desc describes how to treat external buffer */
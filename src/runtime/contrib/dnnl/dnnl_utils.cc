@@ -71,6 +71,26 @@ dnnl::memory::desc MakePlainDesc(const std::vector<int64_t>& shape, DLDataType d
   return {dnnl_shape, dnnl_dtype, dnnl_plain_strides};
 }
 
+DNNLPrimitiveCache* DNNLPrimitiveCache::Global() {
+  static DNNLPrimitiveCache* inst = new DNNLPrimitiveCache();
+  return inst;
+}
+
+dnnl::primitive DNNLPrimitiveCache::GetOrCreate(const std::string& signature,
+                                                const std::function<dnnl::primitive()>& f_create) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = primitives_.find(signature);
+  if (it == primitives_.end()) {
+    it = primitives_.emplace(signature, f_create()).first;
+  }
+  return it->second;
+}
+
+size_t DNNLPrimitiveCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return primitives_.size();
+}
+
 }  // namespace contrib
 }  // namespace runtime
 }  // namespace tvm
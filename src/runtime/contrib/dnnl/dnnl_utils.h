@@ -26,8 +26,11 @@
 #define TVM_RUNTIME_CONTRIB_DNNL_DNNL_UTILS_H_
 
 #include <cstdint>
+#include <functional>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // TODO(@apeskov): Have to mute warning from dnnl headers.
@@ -62,6 +65,41 @@ dnnl::memory::dims shape_dl2dnnl(const std::vector<int64_t>& shape);
  */
 dnnl::memory::desc MakePlainDesc(const std::vector<int64_t>& shape, DLDataType dltype);
 
+/*!
+ * \brief The process-wide cache of DNNL primitives by op signature. It is shared by all the DNNL
+ * JSON runtime modules, so that the identical layers of the graphs each JIT their primitive once.
+ *
+ * The primitives of the cache run on the engine of the cache, on which the modules must create
+ * their streams and memories.
+ */
+class DNNLPrimitiveCache {
+ public:
+  /*! \brief Get the global cache. */
+  static DNNLPrimitiveCache* Global();
+
+  /*! \brief The CPU engine of the cached primitives. */
+  const dnnl::engine& engine() const { return engine_; }
+
+  /*!
+   * \brief Get the primitive of an op signature, or create it if it is not cached.
+   * \param signature The signature of the op, which determines its primitive.
+   * \param f_create The function to create the primitive on the engine of the cache.
+   * \return The cached primitive.
+   */
+  dnnl::primitive GetOrCreate(const std::string& signature,
+                              const std::function<dnnl::primitive()>& f_create);
+
+  /*! \brief The number of cached primitives. */
+  size_t size();
+
+ private:
+  DNNLPrimitiveCache() : engine_(dnnl::engine::kind::cpu, 0) {}
+
+  dnnl::engine engine_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, dnnl::primitive> primitives_;
+};
+
 namespace utils {
 
 /*! \brief Pretty printer util for shape */
@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/json/json_memory_planner.h
+ * \brief Liveness based planning of the intermediate memories of the JSON runtimes.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_JSON_JSON_MEMORY_PLANNER_H_
+#define TVM_RUNTIME_CONTRIB_JSON_JSON_MEMORY_PLANNER_H_
+
+#include <tvm/runtime/logging.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace json {
+
+/*! \brief The alignment in bytes of the buffers planned in the arena. */
+constexpr size_t kArenaAlignment = 64;
+
+/*!
+ * \brief Plan the byte offsets of buffers in a single arena, so that the buffers whose lifetimes
+ *  overlap do not overlap in memory.
+ *
+ * The buffers are placed greedily by decreasing size, each at the lowest aligned offset that does
+ * not overlap any placed buffer alive at the same time.
+ *
+ * \param sizes The byte sizes of the buffers. The buffers of size 0 are not placed.
+ * \param lifetimes The first and the last steps using each buffer, inclusive.
+ * \param offsets The byte offsets of the buffers in the arena.
+ * \return The byte size of the arena.
+ */
+inline size_t PlanArenaOffsets(const std::vector<size_t>& sizes,
+                               const std::vector<std::pair<size_t, size_t>>& lifetimes,
+                               std::vector<size_t>* offsets) {
+  ICHECK_EQ(sizes.size(), lifetimes.size());
+  offsets->assign(sizes.size(), 0);
+  std::vector<size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  auto f_align = [](size_t value) {
+    return (value + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+  };
+  size_t arena_size = 0;
+  std::vector<size_t> placed;
+  for (size_t i : order) {
+    if (sizes[i] == 0) continue;
+    // The byte ranges of the placed buffers alive at the same time, by start offset.
+    std::vector<std::pair<size_t, size_t>> busy;
+    for (size_t j : placed) {
+      if (lifetimes[j].first <= lifetimes[i].second && lifetimes[i].first <= lifetimes[j].second) {
+        busy.emplace_back((*offsets)[j], (*offsets)[j] + sizes[j]);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+    size_t offset = 0;
+    for (const auto& [begin, end] : busy) {
+      if (offset + sizes[i] <= begin) break;
+      offset = std::max(offset, f_align(end));
+    }
+    (*offsets)[i] = offset;
+    arena_size = std::max(arena_size, offset + sizes[i]);
+    placed.push_back(i);
+  }
+  return f_align(arena_size);
+}
+
+}  // namespace json
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_JSON_JSON_MEMORY_PLANNER_H_
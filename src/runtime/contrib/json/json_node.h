@@ -31,6 +31,7 @@
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/data_type.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
@@ -281,6 +282,20 @@ class JSONGraphNode {
    */
   bool HasAttr(const std::string& key) const { return attrs_.find(key) != attrs_.end(); }
 
+  /*!
+   * \brief Get the keys of all the attributes of the node.
+   *
+   * \return The keys in sorted order.
+   */
+  std::vector<std::string> GetAttrKeys() const {
+    std::vector<std::string> keys;
+    for (const auto& kv : attrs_) {
+      keys.push_back(kv.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+  }
+
   void CaptureAttrs(const JSONGraphNode& that) {
     for (const auto& kv : that.attrs_) {
       attrs_[kv.first] = kv.second;
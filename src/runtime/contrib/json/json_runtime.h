@@ -29,6 +29,7 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/tensor.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <tuple>
@@ -37,6 +38,7 @@
 #include <utility>
 #include <vector>
 
+#include "json_memory_planner.h"
 #include "json_node.h"
 
 namespace tvm {
@@ -276,6 +278,68 @@ class JSONRuntimeBase : public ffi::ModuleObj {
     }
   }
 
+  /*!
+   * \brief Allocate the intermediate entries, i.e. the outputs of the kernel nodes which are not
+   * outputs of the graph, in a single arena on the device, and bind them to their data entries.
+   *
+   * The entries whose lifetimes, from the kernel producing them to their last consumer in the
+   * topological order of the nodes, do not overlap share memory.
+   *
+   * \param dev The device to allocate the arena on.
+   */
+  void AllocateIntermediateEntries(Device dev) {
+    std::vector<bool> is_output(NumEntries(), false);
+    for (const auto& entry : outputs_) {
+      is_output[EntryID(entry)] = true;
+    }
+    std::vector<uint32_t> eids;
+    std::vector<ffi::Shape> shapes;
+    std::vector<DLDataType> dtypes;
+    std::vector<size_t> sizes;
+    std::vector<std::pair<size_t, size_t>> lifetimes;
+    std::vector<int64_t> eid_to_index(NumEntries(), -1);
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      const auto& node = nodes_[nid];
+      if (node.GetOpType() != "kernel") continue;
+      for (const auto& entry : node.GetInputs()) {
+        int64_t index = eid_to_index[EntryID(entry)];
+        if (index >= 0) lifetimes[index].second = nid;
+      }
+      std::vector<std::vector<int64_t>> node_shapes = node.GetOpShape();
+      std::vector<DLDataType> node_dtypes = node.GetOpDataType();
+      for (uint32_t i = 0; i < node.GetNumOutput() && i < node_shapes.size(); ++i) {
+        uint32_t eid = EntryID(nid, i);
+        if (is_output[eid] || data_entry_[eid] != nullptr) continue;
+        // The entries of dynamic shapes are left to the backend.
+        size_t size = (node_dtypes[i].bits * node_dtypes[i].lanes + 7) / 8;
+        bool is_static = true;
+        for (int64_t dim : node_shapes[i]) {
+          is_static &= dim >= 0;
+          size *= static_cast<size_t>(std::max<int64_t>(dim, 0));
+        }
+        if (!is_static) continue;
+        eid_to_index[eid] = eids.size();
+        eids.push_back(eid);
+        shapes.emplace_back(node_shapes[i]);
+        dtypes.push_back(node_dtypes[i]);
+        sizes.push_back(size);
+        lifetimes.emplace_back(nid, nid);
+      }
+    }
+    if (eids.empty()) return;
+
+    std::vector<size_t> offsets;
+    size_t arena_size = PlanArenaOffsets(sizes, lifetimes, &offsets);
+    intermediate_arena_ =
+        Tensor::Empty({static_cast<int64_t>(arena_size)}, DataType::UInt(8), dev);
+    intermediate_entries_.clear();
+    for (size_t i = 0; i < eids.size(); ++i) {
+      intermediate_entries_.push_back(
+          intermediate_arena_.CreateView(shapes[i], dtypes[i], offsets[i]));
+      data_entry_[eids[i]] = intermediate_entries_.back().operator->();
+    }
+  }
+
   // Load the graph.
   void Load(dmlc::JSONReader* reader) {
     reader->BeginObject();
@@ -328,6 +392,10 @@ class JSONRuntimeBase : public ffi::ModuleObj {
   std::vector<uint32_t> input_var_eid_;
   /*! \brief input const node index. */
   std::vector<uint32_t> const_idx_;
+  /*! \brief The arena of the intermediate entries, if allocated. */
+  Tensor intermediate_arena_;
+  /*! \brief The views of the intermediate entries in the arena. */
+  std::vector<Tensor> intermediate_entries_;
   /*! \brief Indicate if the engine has been initialized. */
   bool initialized_{false};
   /*! \brief Initializer mutex*/
@@ -330,9 +330,52 @@ int _KVTransferPageToPage(DLTensor* remote_pages, DLTensor* local_pages,
   return 0;
 }
 
+int _KVTransferNotify(DLTensor* recv_counters, int64_t layer_id, DLTensor* remote_pages,
+                      int64_t local_num_kv_heads, tvm::ffi::Shape recver_pe_offsets,
+                      TVMStreamHandle transfer_stream) {
+  CHECK_EQ(recv_counters->device.device_type, kDLCUDA)
+      << "The device of recv_counters must be CUDA.";
+  CHECK(recv_counters->dtype.code == kDLUInt && recv_counters->dtype.bits == 64)
+      << "The recv_counters must be uint64.";
+  CHECK_EQ(recv_counters->ndim, 1);
+  CHECK(layer_id >= 0 && layer_id < recv_counters->shape[0]);
+  CHECK_EQ(remote_pages->ndim, 5);
+  int remote_num_kv_head = remote_pages->shape[2];
+
+  int local_tp_rank;
+  tvm::runtime::DiscoWorker* worker = tvm::runtime::ThreadLocalDiscoWorker::Get()->worker;
+  if (worker == nullptr) {
+    local_tp_rank = 0;
+  } else {
+    local_tp_rank = worker->worker_id;
+  }
+
+  uint64_t* counter = reinterpret_cast<uint64_t*>(reinterpret_cast<char*>(recv_counters->data) +
+                                                  recv_counters->byte_offset) +
+                      layer_id;
+  for (int64_t recver_pe_offset : recver_pe_offsets) {
+    // The recver PEs of this rank, as the head mapping of KVTransfer.
+    if (local_num_kv_heads <= remote_num_kv_head) {
+      int gather_factor = remote_num_kv_head / local_num_kv_heads;
+      nvshmemx_signal_op_on_stream(counter, 1, NVSHMEM_SIGNAL_ADD,
+                                   recver_pe_offset + local_tp_rank / gather_factor,
+                                   static_cast<cudaStream_t>(transfer_stream));
+    } else {
+      int scatter_factor = local_num_kv_heads / remote_num_kv_head;
+      for (int i = 0; i < scatter_factor; ++i) {
+        nvshmemx_signal_op_on_stream(counter, 1, NVSHMEM_SIGNAL_ADD,
+                                     recver_pe_offset + local_tp_rank * scatter_factor + i,
+                                     static_cast<cudaStream_t>(transfer_stream));
+      }
+    }
+  }
+  return 0;
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
       .def("nvshmem.KVTransfer", _KVTransfer)
-      .def("nvshmem.KVTransferPageToPage", _KVTransferPageToPage);
+      .def("nvshmem.KVTransferPageToPage", _KVTransferPageToPage)
+      .def("nvshmem.KVTransferNotify", _KVTransferNotify);
 }
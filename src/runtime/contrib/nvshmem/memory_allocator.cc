@@ -40,7 +40,9 @@ using tvm::runtime::memory::PooledAllocator;
  */
 class NVSHMEMAllocator final : public PooledAllocator {
  public:
-  explicit NVSHMEMAllocator() : PooledAllocator() {}
+  // NVSHMEM allocations are collective, so bypass the thread caches to keep every PE
+  // issuing the same sequence of device allocations.
+  explicit NVSHMEMAllocator() : PooledAllocator(kDefaultPageSize, /*thread_cache_capacity=*/0) {}
 
   ~NVSHMEMAllocator() { PooledAllocator::ReleaseAll(); }
 
@@ -19,7 +19,7 @@
 
 /*!
  * \file random/mt_random_engine.cc
- * \brief mt19937 random engine
+ * \brief mt19937 random engine, with Philox counter-based fills of random tensors
  */
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/device_api.h>
@@ -33,6 +33,7 @@
 #include <thread>
 
 #include "../3rdparty/compiler-rt/builtin_fp16.h"
+#include "philox.h"
 
 namespace tvm {
 namespace contrib {
@@ -58,6 +59,8 @@ class RandomEngine {
   inline void Seed(unsigned seed) {
     rnd_engine_.seed(seed);
     this->rseed_ = static_cast<unsigned>(seed);
+    this->philox_key_ = seed;
+    this->philox_offset_ = 0;
   }
 
   /*!
@@ -120,76 +123,93 @@ class RandomEngine {
 
   void RandomFill(DLTensor* data) {
     if (data->device.device_type == kDLCPU) {
-      FillData(data);
+      FillData(data, /*parallel=*/false);
     } else {
       runtime::Tensor local = runtime::Tensor::Empty(
           std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
 
       const DLTensor* tensor = local.GetDLTensorPtr();
-      FillData(const_cast<DLTensor*>(tensor));
+      FillData(const_cast<DLTensor*>(tensor), /*parallel=*/false);
       runtime::Tensor::CopyFromTo(tensor, data);
     }
   }
 
   void RandomFillForMeasure(DLTensor* data) {
     if (data->device.device_type == kDLCPU) {
-      FillDataForMeasure(data);
+      FillData(data, /*parallel=*/true);
     } else {
       runtime::Tensor local = runtime::Tensor::Empty(
           std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
       const DLTensor* tensor = local.GetDLTensorPtr();
-      FillDataForMeasure(const_cast<DLTensor*>(tensor));
+      FillData(const_cast<DLTensor*>(tensor), /*parallel=*/true);
       runtime::Tensor::CopyFromTo(tensor, data);
     }
   }
 
  private:
-  void FillDataImpl(void* data, int64_t st, int64_t ed, DLDataType dtype) {
+  /*!
+   * \brief Fill the items [st, ed) of a tensor from the Philox stream, where the item i is
+   *  generated from the counter offset + i / 4. The items are bytes for 4-bit types, which
+   *  pack two values per byte.
+   */
+  void FillDataImpl(void* data, int64_t st, int64_t ed, DLDataType dtype, uint64_t offset) const {
     // Make the value be 1.0 - 10.0, not (0.0 - 1.0) so that we could satisfy
     // quantized dtype (uint8 / int8) data non-empty requirement
-    std::uniform_real_distribution<> dist(1.0, 10.0);
     // Use float representation could make us work well on float / int type too.
     if (dtype.bits == 1) {
-      std::generate_n(static_cast<bool*>(data) + st, ed - st, [&]() { return dist(rnd_engine_); });
+      FillRange(static_cast<bool*>(data), st, ed, offset, 1.0f, 10.0f,
+                [](float v) { return v != 0.0f; });
     } else if (dtype.bits == 4) {
       // For uint4/int4 we pack two values into a single byte.
       // Thus, to ensure both values are non-zero, we use a distribution of 17 - 30.
-      std::uniform_real_distribution<> packed_dist(17.0, 30.0);
-      std::generate_n(reinterpret_cast<uint8_t*>(data) + st, ed - st,
-                      [&]() { return packed_dist(rnd_engine_); });
+      FillRange(static_cast<uint8_t*>(data), st, ed, offset, 17.0f, 30.0f,
+                [](float v) { return static_cast<uint8_t>(v); });
     } else if (dtype.bits == 8) {
-      std::generate_n(static_cast<uint8_t*>(data) + st, ed - st,
-                      [&]() { return dist(rnd_engine_); });
+      FillRange(static_cast<uint8_t*>(data), st, ed, offset, 1.0f, 10.0f,
+                [](float v) { return static_cast<uint8_t>(v); });
     } else if (dtype.bits == 16) {
-      std::generate_n(static_cast<uint16_t*>(data) + st, ed - st, [&]() {
-        return __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(
-            static_cast<float>(dist(rnd_engine_)));
+      FillRange(static_cast<uint16_t*>(data), st, ed, offset, 1.0f, 10.0f, [](float v) {
+        return __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(v);
       });
     } else if (dtype.bits == 32) {
-      std::generate_n(static_cast<float*>(data) + st, ed - st, [&]() { return dist(rnd_engine_); });
+      FillRange(static_cast<float*>(data), st, ed, offset, 1.0f, 10.0f, [](float v) { return v; });
     } else if (dtype.bits == 64) {
-      std::generate_n(static_cast<double*>(data) + st, ed - st,
-                      [&]() { return dist(rnd_engine_); });
+      FillRange(static_cast<double*>(data), st, ed, offset, 1.0f, 10.0f,
+                [](float v) { return static_cast<double>(v); });
     } else {
       LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
     }
   }
 
-  void FillData(DLTensor* tensor) {
-    int64_t size = 1;
-    for (int i = 0; i < tensor->ndim; ++i) {
-      size *= tensor->shape[i];
-    }
-    DLDataType dtype = tensor->dtype;
-    if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
-        dtype.bits == 32 || dtype.bits == 64) {
-      FillDataImpl(tensor->data, 0, size, dtype);
-    } else {
-      LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
+  template <typename T, typename FConvert>
+  void FillRange(T* out, int64_t st, int64_t ed, uint64_t offset, float low, float high,
+                 FConvert convert) const {
+    // The counters of a batch are generated as independent lanes, which the compiler can
+    // vectorize, and a batch is aligned so that the items do not depend on the range.
+    constexpr int kLanes = 8;
+    constexpr int64_t kBatch = kLanes * philox::kOutputsPerCounter;
+    for (int64_t begin = st / kBatch * kBatch; begin < ed; begin += kBatch) {
+      uint32_t bits[kLanes][philox::kOutputsPerCounter];
+      uint64_t first_counter = offset + begin / philox::kOutputsPerCounter;
+      for (int lane = 0; lane < kLanes; ++lane) {
+        philox::Philox4x32(philox_key_, first_counter + lane, bits[lane]);
+      }
+      int64_t lo = std::max(begin, st);
+      int64_t hi = std::min(begin + kBatch, ed);
+      for (int64_t i = lo; i < hi; ++i) {
+        int64_t k = i - begin;
+        out[i] = convert(philox::ToUniform(bits[k / philox::kOutputsPerCounter]
+                                               [k % philox::kOutputsPerCounter],
+                                           low, high));
+      }
     }
   }
 
-  void FillDataForMeasure(DLTensor* tensor) {
+  /*!
+   * \brief Fill a tensor with the next values of the Philox stream.
+   * \param parallel Whether to split the fill over the threads of the runtime thread pool.
+   */
+  void FillData(DLTensor* tensor, bool parallel) {
     struct ParallelTask {
       static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
         ParallelTask* task = static_cast<ParallelTask*>(cdata);
@@ -198,16 +218,19 @@ class RandomEngine {
       }
 
       void Run(int i, int num_tasks) {
-        int64_t chunk_size = size / num_tasks;
+        int64_t chunk_size = (size + num_tasks - 1) / num_tasks;
         int64_t st = i * chunk_size;
         int64_t ed = std::min(st + chunk_size, size);
-        self->FillDataImpl(data, st, ed, dtype);
+        if (st < ed) {
+          self->FillDataImpl(data, st, ed, dtype, offset);
+        }
       }
 
-      RandomEngine* self;
+      const RandomEngine* self;
       void* data;
       int64_t size;
       DLDataType dtype;
+      uint64_t offset;
     };
 
     ParallelTask task;
@@ -218,10 +241,19 @@ class RandomEngine {
     for (int i = 0; i < tensor->ndim; ++i) {
       size *= tensor->shape[i];
     }
+    if (dtype.bits == 4) {
+      size = (size + 1) / 2;
+    }
+    task.offset = philox_offset_;
+    philox_offset_ += (size + philox::kOutputsPerCounter - 1) / philox::kOutputsPerCounter;
     if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
         dtype.bits == 32 || dtype.bits == 64) {
-      int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
-      ICHECK_EQ(res, 0) << "RandomFillForMeasure: TVMBackendParallelLaunch failed";
+      if (parallel) {
+        int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
+        ICHECK_EQ(res, 0) << "RandomFillForMeasure: TVMBackendParallelLaunch failed";
+      } else {
+        FillDataImpl(task.data, 0, size, dtype, task.offset);
+      }
     } else {
       LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
     }
@@ -230,6 +262,10 @@ class RandomEngine {
  private:
   std::mt19937 rnd_engine_;
   unsigned rseed_;
+  /*! \brief The key of the Philox stream of the fills. */
+  uint64_t philox_key_;
+  /*! \brief The first counter of the next fill. */
+  uint64_t philox_offset_;
 };
 
 }  // namespace contrib
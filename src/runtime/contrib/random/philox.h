@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random/philox.h
+ * \brief Philox-4x32-10 counter-based random number generator, shared by the host and the
+ *  CUDA fills of random tensors.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+#define TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+
+#include <cstdint>
+
+#if defined(__CUDACC__)
+#define TVM_PHILOX_FUNC __host__ __device__ inline
+#else
+#define TVM_PHILOX_FUNC inline
+#endif
+
+namespace tvm {
+namespace contrib {
+namespace philox {
+
+/*! \brief The number of 32-bit outputs of a counter. */
+constexpr int kOutputsPerCounter = 4;
+
+/*!
+ * \brief Generate the 4 outputs of a counter. The outputs only depend on the key and the
+ *  counter, so that any range of a tensor can be generated independently of the others.
+ * \param key The key, i.e. the seed of the stream.
+ * \param counter The counter.
+ * \param out The 4 outputs.
+ */
+TVM_PHILOX_FUNC void Philox4x32(uint64_t key, uint64_t counter, uint32_t out[4]) {
+  constexpr uint32_t kMul0 = 0xD2511F53u;
+  constexpr uint32_t kMul1 = 0xCD9E8D57u;
+  constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+  constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+  uint32_t c0 = static_cast<uint32_t>(counter);
+  uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+  uint32_t c2 = 0;
+  uint32_t c3 = 0;
+  uint32_t k0 = static_cast<uint32_t>(key);
+  uint32_t k1 = static_cast<uint32_t>(key >> 32);
+  for (int round = 0; round < 10; ++round) {
+    uint64_t p0 = static_cast<uint64_t>(kMul0) * c0;
+    uint64_t p1 = static_cast<uint64_t>(kMul1) * c2;
+    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(p1);
+    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(p0);
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+/*! \brief Map an output to a float in [low, high), using its 24 highest bits. */
+TVM_PHILOX_FUNC float ToUniform(uint32_t bits, float low, float high) {
+  return low + (high - low) * (static_cast<float>(bits >> 8) * (1.0f / 16777216.0f));
+}
+
+}  // namespace philox
+}  // namespace contrib
+}  // namespace tvm
+
+#undef TVM_PHILOX_FUNC
+
+#endif  // TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
@@ -134,7 +134,10 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                         tvm::ffi::Function::GetGlobal("runtime.contrib.curand.RandomFill");
                     auto out = args[0].cast<DLTensor*>();
                     if (curand.has_value() && out->device.device_type == DLDeviceType::kDLCUDA) {
-                      if (out->dtype.code == DLDataTypeCode::kDLFloat) {
+                      // Generate on the device, without a host fill and a copy.
+                      DLDataTypeCode code = static_cast<DLDataTypeCode>(out->dtype.code);
+                      if (code == DLDataTypeCode::kDLFloat || code == DLDataTypeCode::kDLInt ||
+                          code == DLDataTypeCode::kDLUInt || code == DLDataTypeCode::kDLBool) {
                         (*curand)(out);
                         return;
                       }
@@ -26,8 +26,11 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
 #include "../../../../3rdparty/compiler-rt/builtin_fp16.h"
@@ -73,6 +76,192 @@ struct float16 {
   inline bool operator>=(const float16& rhs) const { return to_float() >= rhs.to_float(); }
 };
 
+// The rows with at least this many elements are radix sorted.
+constexpr int64_t kRadixSortMinSize = 256;
+// The sorts of less elements run on a single thread.
+constexpr int64_t kParallelSortMinSize = 1 << 15;
+// A row with at least this many elements is split over the threads when the rows are too few
+// to keep the threads busy.
+constexpr int64_t kParallelRowMinSize = 1 << 16;
+
+/*!
+ * \brief Map the keys of a type to unsigned integers of the same order, for radix sorting.
+ *  The floats are ordered by the sign and magnitude of their bits, with -0 mapped to +0 so
+ *  that both compare equal, and NaNs at the ends.
+ */
+template <typename DataType, typename = void>
+struct RadixKey {
+  static constexpr bool kEnabled = false;
+};
+
+template <typename DataType>
+struct RadixKey<DataType, std::enable_if_t<std::is_integral_v<DataType>>> {
+  static constexpr bool kEnabled = true;
+  using UInt = std::make_unsigned_t<DataType>;
+  static UInt Encode(DataType value) {
+    UInt bits = static_cast<UInt>(value);
+    if constexpr (std::is_signed_v<DataType>) {
+      bits ^= static_cast<UInt>(UInt(1) << (sizeof(UInt) * 8 - 1));
+    }
+    return bits;
+  }
+};
+
+template <typename UIntType>
+UIntType EncodeFloatBits(UIntType bits) {
+  constexpr UIntType kSign = static_cast<UIntType>(UIntType(1) << (sizeof(UIntType) * 8 - 1));
+  if (bits == kSign) bits = 0;
+  return (bits & kSign) ? static_cast<UIntType>(~bits) : static_cast<UIntType>(bits | kSign);
+}
+
+template <>
+struct RadixKey<float> {
+  static constexpr bool kEnabled = true;
+  using UInt = uint32_t;
+  static UInt Encode(float value) {
+    UInt bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return EncodeFloatBits(bits);
+  }
+};
+
+template <>
+struct RadixKey<double> {
+  static constexpr bool kEnabled = true;
+  using UInt = uint64_t;
+  static UInt Encode(double value) {
+    UInt bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return EncodeFloatBits(bits);
+  }
+};
+
+template <>
+struct RadixKey<float16> {
+  static constexpr bool kEnabled = true;
+  using UInt = uint16_t;
+  static UInt Encode(float16 value) { return EncodeFloatBits(value.bits); }
+};
+
+/*!
+ * \brief Stable LSD radix sort of (index, key) pairs by key, 8 bits per pass.
+ * \param data The pairs to sort.
+ * \param n The number of pairs.
+ * \param is_ascend Whether to sort in the ascending order.
+ * \param scratch The buffer alternating with `data` between passes, of at least n pairs.
+ */
+template <typename Pair>
+void RadixSort(Pair* data, int64_t n, bool is_ascend, Pair* scratch) {
+  using Key = RadixKey<typename Pair::second_type>;
+  using UInt = typename Key::UInt;
+  // The descending order is the ascending order of the complement, which keeps the sort stable.
+  const UInt flip = is_ascend ? UInt(0) : static_cast<UInt>(~UInt(0));
+  Pair* src = data;
+  Pair* dst = scratch;
+  for (size_t shift = 0; shift < sizeof(UInt) * 8; shift += 8) {
+    int64_t count[257] = {0};
+    for (int64_t i = 0; i < n; ++i) {
+      ++count[((Key::Encode(src[i].second) ^ flip) >> shift & 0xFF) + 1];
+    }
+    // All the keys have the same digit, the pass would not move anything.
+    if (std::any_of(count + 1, count + 257, [n](int64_t c) { return c == n; })) continue;
+    for (int b = 0; b < 256; ++b) {
+      count[b + 1] += count[b];
+    }
+    for (int64_t i = 0; i < n; ++i) {
+      dst[count[(Key::Encode(src[i].second) ^ flip) >> shift & 0xFF]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if (src != data) {
+    std::copy(src, src + n, data);
+  }
+}
+
+/*!
+ * \brief Sort a row of (index, key) pairs by key, stable so that the equal keys keep the order
+ *  of their index.
+ * \param sorter The pairs of the row.
+ * \param scratch A buffer for the radix sort.
+ * \param is_ascend Whether to sort in the ascending order.
+ * \param parallel Whether to split the row over the threads of the runtime thread pool. The
+ *  chunks of the row are radix sorted by the threads, then merged pairwise.
+ */
+template <typename Pair>
+void SortRow(std::vector<Pair>* sorter, std::vector<Pair>* scratch, bool is_ascend,
+             bool parallel) {
+  using DataType = typename Pair::second_type;
+  using Key = RadixKey<DataType>;
+  int64_t n = static_cast<int64_t>(sorter->size());
+  if constexpr (Key::kEnabled) {
+    if (n >= kRadixSortMinSize) {
+      scratch->resize(n);
+      Pair* data = sorter->data();
+      Pair* buffer = scratch->data();
+      if (!parallel) {
+        RadixSort(data, n, is_ascend, buffer);
+        return;
+      }
+      int64_t num_chunks = std::max(1, threading::MaxConcurrency());
+      auto chunk_begin = [&](int64_t c) { return std::min(n, c * n / num_chunks); };
+      parallel_for_with_threading_backend(
+          [&](int64_t c) {
+            int64_t begin = chunk_begin(c);
+            RadixSort(data + begin, chunk_begin(c + 1) - begin, is_ascend, buffer + begin);
+          },
+          0, num_chunks);
+      auto less = [is_ascend](const Pair& lhs, const Pair& rhs) {
+        return is_ascend ? Key::Encode(lhs.second) < Key::Encode(rhs.second)
+                         : Key::Encode(lhs.second) > Key::Encode(rhs.second);
+      };
+      // std::merge takes the left run first on equal keys, which keeps the sort stable.
+      Pair* src = data;
+      Pair* dst = buffer;
+      for (int64_t width = 1; width < num_chunks; width *= 2) {
+        int64_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+        parallel_for_with_threading_backend(
+            [&](int64_t m) {
+              int64_t lo = chunk_begin(2 * m * width);
+              int64_t mid = chunk_begin(std::min(num_chunks, (2 * m + 1) * width));
+              int64_t hi = chunk_begin(std::min(num_chunks, (2 * m + 2) * width));
+              std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, less);
+            },
+            0, num_merges);
+        std::swap(src, dst);
+      }
+      if (src != data) {
+        std::copy(src, src + n, data);
+      }
+      return;
+    }
+  }
+  if (is_ascend) {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareAscend<DataType>);
+  } else {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareDescend<DataType>);
+  }
+}
+
+/*!
+ * \brief Run f(begin, end, parallel_within_rows) on the rows of a sort. The chunks of rows run in
+ *  parallel when there are enough rows, else the rows run in order and the large ones are split
+ *  over the threads.
+ */
+template <typename F>
+void ForEachRowRange(int64_t num_rows, int64_t row_size, F f) {
+  int64_t num_threads = threading::MaxConcurrency();
+  if (num_threads <= 1 || num_rows * row_size < kParallelSortMinSize) {
+    f(0, num_rows, false);
+  } else if (num_rows < num_threads && row_size >= kParallelRowMinSize) {
+    f(0, num_rows, true);
+  } else {
+    int64_t num_chunks = std::min(num_rows, num_threads);
+    parallel_for_with_threading_backend(
+        [&](int64_t c) { f(c * num_rows / num_chunks, (c + 1) * num_rows / num_chunks, false); },
+        0, num_chunks);
+  }
+}
+
 // Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
@@ -93,7 +282,6 @@ void RegisterArgsortNMS() {
         auto dtype = input->dtype;
         auto data_ptr = static_cast<float*>(input->data);
         auto sort_num_ptr = static_cast<int32_t*>(sort_num->data);
-        std::vector<std::pair<int32_t, float>> sorter;
         int64_t axis_mul_before = 1;
         int64_t axis_mul_after = 1;
 
@@ -120,8 +308,12 @@ void RegisterArgsortNMS() {
           }
         }
 
-        for (int64_t i = 0; i < axis_mul_before; ++i) {
-          for (int64_t j = 0; j < axis_mul_after; ++j) {
+        auto sort_rows = [&](int64_t begin, int64_t end, bool parallel_within_rows) {
+          std::vector<std::pair<int32_t, float>> sorter;
+          std::vector<std::pair<int32_t, float>> scratch;
+          for (int64_t row = begin; row < end; ++row) {
+            int64_t i = row / axis_mul_after;
+            int64_t j = row % axis_mul_after;
             sorter.clear();
             int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
             int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
@@ -129,33 +321,26 @@ void RegisterArgsortNMS() {
               int64_t full_idx = base_idx + k * axis_mul_after;
               sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
             }
-            if (is_ascend) {
 #if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-              if (dtype.bits == 16) {
+            if (dtype.bits == 16) {
+              if (is_ascend) {
                 std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
               } else {
-#endif
-                std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
+                std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
               }
-#endif
             } else {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-              if (dtype.bits == 16) {
-                std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
-              } else {
 #endif
-                std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<float>);
+              SortRow(&sorter, &scratch, is_ascend, parallel_within_rows);
 #if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-              }
-#endif
             }
+#endif
             for (int32_t k = 0; k < input->shape[axis]; ++k) {
               *(static_cast<int32_t*>(output->data) + base_idx + k * axis_mul_after) =
                   k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
             }
           }
-        }
+        };
+        ForEachRowRange(axis_mul_before * axis_mul_after, input->shape[axis], sort_rows);
       });
 }
 
@@ -165,10 +350,9 @@ void sort_impl(
     std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
   auto data_ptr = static_cast<DataType*>(input->data);
   auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -177,24 +361,25 @@ void sort_impl(
     }
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  auto sort_rows = [&](int64_t begin, int64_t end, bool parallel_within_rows) {
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    std::vector<std::pair<int64_t, DataType>> scratch;
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       sorter.clear();
       int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
       for (int64_t k = 0; k < input->shape[axis]; ++k) {
         int64_t full_idx = base_idx + k * axis_mul_after;
         sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
       }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
+      SortRow(&sorter, &scratch, is_ascend, parallel_within_rows);
       for (int64_t k = 0; k < input->shape[axis]; ++k) {
         epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
       }
     }
-  }
+  };
+  ForEachRowRange(axis_mul_before * axis_mul_after, input->shape[axis], sort_rows);
 }
 
 template <typename DataType, typename OutType>
@@ -359,6 +544,9 @@ void RegisterSort() {
   });
 }
 
+// The top-k of a larger k select the k elements of a row, instead of maintaining a heap.
+constexpr int kTopkSelectMinK = 64;
+
 template <typename DataType, typename IndicesType>
 void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, int axis,
           bool is_ascend) {
@@ -368,14 +556,8 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
 
-  // Maintain a min/max containing the top-k elements
-  std::vector<std::pair<int64_t, DataType>> running_heap;
-
-  // Need +1 when inserting new element before maintaining heap invariant
-  running_heap.reserve(k + 1);
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -386,50 +568,64 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
   if (k < 1) {
     k = input->shape[axis];
   }
-
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  const int64_t axis_size = input->shape[axis];
+  // The comparisons break the ties by index, so that the heap and the selection agree.
+  auto before = [is_ascend](const std::pair<int64_t, DataType>& lhs,
+                            const std::pair<int64_t, DataType>& rhs) {
+    return is_ascend ? CompareAscend<DataType, true>(lhs, rhs)
+                     : CompareDescend<DataType, true>(lhs, rhs);
+  };
+
+  auto topk_rows = [&](int64_t begin, int64_t end, bool /*parallel_within_rows*/) {
+    // Maintain a min/max containing the top-k elements
+    std::vector<std::pair<int64_t, DataType>> running_heap;
+    // Need +1 when inserting new element before maintaining heap invariant
+    running_heap.reserve(k >= kTopkSelectMinK ? axis_size : k + 1);
+
+    for (int64_t row = begin; row < end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       running_heap.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
+      int64_t src_base_idx = i * axis_size * axis_mul_after + j;
       int64_t dst_base_idx = i * k * axis_mul_after + j;
 
-      // Start by creating min/max heap with fixed-k elements
-      int cur_axis_index = 0;
-      for (; cur_axis_index < k && cur_axis_index < input->shape[axis]; cur_axis_index++) {
-        int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        running_heap.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
-      }
-      if (!is_ascend) {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
+      if (k >= kTopkSelectMinK) {
+        // Select the k first elements of the order, then sort them.
+        for (int64_t cur_axis_index = 0; cur_axis_index < axis_size; cur_axis_index++) {
+          int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
+          running_heap.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
+        }
+        if (k < axis_size) {
+          std::nth_element(running_heap.begin(), running_heap.begin() + k, running_heap.end(),
+                           before);
+          running_heap.resize(k);
+        }
       } else {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-      }
-
-      // Iterate through all elements, adding to heap along the way
-      for (; cur_axis_index < input->shape[axis]; cur_axis_index++) {
-        int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        std::pair<int64_t, DataType> cur_val = {cur_axis_index, data_ptr[full_idx]};
-
-        // Eq. to cur_val.second > running_heap.second
-        if (!is_ascend && CompareDescend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          running_heap.pop_back();
-        } else if (is_ascend && CompareAscend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          running_heap.pop_back();
+        // Start by creating min/max heap with fixed-k elements
+        int64_t cur_axis_index = 0;
+        for (; cur_axis_index < k && cur_axis_index < axis_size; cur_axis_index++) {
+          int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
+          running_heap.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
+        }
+        std::make_heap(running_heap.begin(), running_heap.end(), before);
+
+        // Iterate through all elements, adding to heap along the way
+        for (; cur_axis_index < axis_size; cur_axis_index++) {
+          int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
+          std::pair<int64_t, DataType> cur_val = {cur_axis_index, data_ptr[full_idx]};
+
+          // Eq. to cur_val.second > running_heap.second
+          if (before(cur_val, running_heap[0])) {
+            running_heap.push_back(cur_val);
+            std::push_heap(running_heap.begin(), running_heap.end(), before);
+            std::pop_heap(running_heap.begin(), running_heap.end(), before);
+            running_heap.pop_back();
+          }
         }
       }
 
       // finally sort heap and deliver results
-      if (is_ascend) {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-      } else {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-      }
+      std::sort(running_heap.begin(), running_heap.end(), before);
 
       for (uint32_t kk = 0; kk < running_heap.size(); ++kk) {
         if (indices_ptr != nullptr) {
@@ -442,7 +638,8 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
         }
       }
     }
-  }
+  };
+  ForEachRowRange(axis_mul_before * axis_mul_after, axis_size, topk_rows);
 }
 
 // Argsort implemented C library sort.
@@ -40,14 +40,16 @@ namespace contrib {
 TensorRTBuilder::TensorRTBuilder(TensorRTLogger* logger,
                                  const std::vector<const DLTensor*>& data_entry,
                                  size_t max_workspace_size, bool use_implicit_batch, bool use_fp16,
-                                 int batch_size, nvinfer1::IInt8Calibrator* calibrator)
+                                 int batch_size, nvinfer1::IInt8Calibrator* calibrator,
+                                 const TensorRTOptimizationProfile* profile)
     : data_entry_(data_entry),
       max_workspace_size_(max_workspace_size),
       use_implicit_batch_(use_implicit_batch),
       use_fp16_(use_fp16),
       use_int8_(false),
       batch_size_(batch_size),
-      calibrator_(calibrator) {
+      calibrator_(calibrator),
+      profile_(profile) {
   // Create TRT builder and network.
   builder_ = nvinfer1::createInferBuilder(*logger);
 
@@ -183,7 +185,20 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
   }
 
   // Add profiles.
-  if (!use_implicit_batch_) {
+  if (!use_implicit_batch_ && profile_ != nullptr) {
+    ICHECK_EQ(profile_->max_shapes.size(), network_->getNbInputs());
+    auto profile = builder_->createOptimizationProfile();
+    for (int i = 0; i < network_->getNbInputs(); ++i) {
+      auto name = network_->getInput(i)->getName();
+      profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN,
+                             VectorToTrtDims(profile_->min_shapes[i]));
+      profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT,
+                             VectorToTrtDims(profile_->opt_shapes[i]));
+      profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX,
+                             VectorToTrtDims(profile_->max_shapes[i]));
+    }
+    config_->addOptimizationProfile(profile);
+  } else if (!use_implicit_batch_) {
     auto profile = builder_->createOptimizationProfile();
     for (int i = 0; i < network_->getNbInputs(); ++i) {
       auto name = network_->getInput(i)->getName();
@@ -27,6 +27,7 @@
 
 #include <tvm/runtime/tensor.h>
 
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -54,6 +55,42 @@ struct TensorRTEngineAndContext {
   std::vector<std::string> outputs;
 };
 
+/*!
+ * \brief The min, opt and max shapes of the inputs of an explicit-batch engine, in the order of the
+ * network inputs. The engine built with the profile serves all the input shapes between the min
+ * and max shapes, and is tuned for the opt shapes.
+ */
+struct TensorRTOptimizationProfile {
+  std::vector<std::vector<int64_t>> min_shapes;
+  std::vector<std::vector<int64_t>> opt_shapes;
+  std::vector<std::vector<int64_t>> max_shapes;
+
+  /*! \brief Whether the profile covers the shapes of the inputs. */
+  bool Covers(const std::vector<std::vector<int64_t>>& shapes) const {
+    if (shapes.size() != max_shapes.size()) return false;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      if (shapes[i].size() != max_shapes[i].size()) return false;
+      for (size_t j = 0; j < shapes[i].size(); ++j) {
+        if (shapes[i][j] < min_shapes[i][j] || shapes[i][j] > max_shapes[i][j]) return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief A string that identifies the profile, e.g. for the engines cached on disk. */
+  std::string Key() const {
+    std::ostringstream os;
+    for (const auto* shapes : {&min_shapes, &opt_shapes, &max_shapes}) {
+      for (const auto& shape : *shapes) {
+        for (int64_t dim : shape) os << dim << ",";
+        os << ";";
+      }
+      os << "|";
+    }
+    return os.str();
+  }
+};
+
 /*!
  * \brief Converts a JSONRuntime graph into a TensorRT engine and execution context. Inputs,
  * constants, layers, and outputs can be added to construct the TensorRT network definition.
@@ -70,10 +107,14 @@ class TensorRTBuilder {
    * \param use_implicit_batch Whether to use implicit batch mode (default)
    * \param use_fp16 Whether to automatically convert a model to fp16
    * \param batch_size If use_implicit_batch,
+   * \param calibrator The calibrator in INT8 mode, or nullptr.
+   * \param profile The optimization profile of the engine if not use_implicit_batch, or nullptr
+   * to build the engine for the current input shapes.
    */
   TensorRTBuilder(TensorRTLogger* logger, const std::vector<const DLTensor*>& data_entry,
                   size_t max_workspace_size, bool use_implicit_batch, bool use_fp16, int batch_size,
-                  nvinfer1::IInt8Calibrator* calibrator = nullptr);
+                  nvinfer1::IInt8Calibrator* calibrator = nullptr,
+                  const TensorRTOptimizationProfile* profile = nullptr);
 
   /*!
    * \brief Add TensorRT input(s) for input node in network definition.
@@ -168,6 +209,9 @@ class TensorRTBuilder {
   /*! \brief calibrator pointer to add batch data when using int8 mode */
   /*! \brief pointer will be nullptr when it is fp16 or fp32 precision */
   nvinfer1::IInt8Calibrator* calibrator_;
+
+  /*! \brief The optimization profile of the engine, or nullptr. */
+  const TensorRTOptimizationProfile* profile_;
 };
 
 }  // namespace contrib
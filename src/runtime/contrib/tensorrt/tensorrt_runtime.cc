@@ -23,12 +23,14 @@
  */
 
 #include <dmlc/parameter.h>
+#include <tvm/ffi/extra/c_env_api.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/tensor.h>
 
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -137,9 +139,29 @@ class TensorRTRuntime : public JSONRuntimeBase {
       if (nodes_[i].HasAttr("use_fp16")) {
         use_fp16_ = std::stoi(nodes_[i].GetAttr<std::vector<std::string>>("use_fp16")[0]);
       }
+      if (nodes_[i].HasAttr("input_max_shapes") && input_max_shapes_.empty()) {
+        for (const auto& str : nodes_[i].GetAttr<std::vector<std::string>>("input_max_shapes")) {
+          std::vector<int64_t> shape;
+          std::istringstream is(str);
+          std::string dim;
+          while (std::getline(is, dim, ',')) {
+            shape.push_back(std::stoll(dim));
+          }
+          input_max_shapes_.push_back(shape);
+        }
+      }
     }
   }
 
+  /*!
+   * \brief Whether to build explicit-batch engines with optimization profiles up to the max input
+   * shapes, instead of an engine per batch size. INT8 calibration runs per batch size.
+   */
+  bool UseOptimizationProfiles() const {
+    return !use_implicit_batch_ && !input_max_shapes_.empty() &&
+           !dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
+  }
+
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
   /*! \brief Destroy engines and contexts. */
   void DestroyEngines() {
@@ -152,6 +174,14 @@ class TensorRTRuntime : public JSONRuntimeBase {
       it.second.engine->destroy();
     }
     trt_engine_cache_.clear();
+    for (auto& it : profile_engine_cache_) {
+      VLOG(1) << "Destroying TensorRT context and engine for function '" << symbol_name_
+              << "' (profile " << it.first << ")";
+      it.second.context->destroy();
+      it.second.engine->destroy();
+    }
+    profile_engine_cache_.clear();
+    profiles_.clear();
   }
 
   ~TensorRTRuntime() override {
@@ -162,7 +192,8 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief Run inference using built engine. */
   void Run() override {
-    auto& engine_and_context = GetOrBuildEngine();
+    auto& engine_and_context =
+        UseOptimizationProfiles() ? GetOrBuildProfileEngine() : GetOrBuildEngine();
     int batch_size = GetBatchSize();
     if (batch_size == 0) return;
     auto engine = engine_and_context.engine;
@@ -228,23 +259,36 @@ class TensorRTRuntime : public JSONRuntimeBase {
       }
     }
 
+    // Enqueue the engine on the current stream of the device, e.g. a side stream the VM runs
+    // the independent external regions on.
+    int device_id = data_entry_[input_var_eid_[0]]->device.device_type == kDLCUDA
+                        ? data_entry_[input_var_eid_[0]]->device.device_id
+                        : 0;
+    cudaStream_t stream = static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, device_id));
 #if TRT_VERSION_GE(6, 0, 1)
     if (use_implicit_batch_) {
-      ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueue(batch_size, bindings.data(), stream, nullptr))
+          << "Running TensorRT failed.";
     } else {
-      ICHECK(context->executeV2(bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueueV2(bindings.data(), stream, nullptr)) << "Running TensorRT failed.";
     }
 #else
-    ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+    ICHECK(context->enqueue(batch_size, bindings.data(), stream, nullptr))
+        << "Running TensorRT failed.";
 #endif
 
     // Copy outputs from GPU buffers if needed.
+    bool synced = false;
     for (size_t i = 0; i < outputs_.size(); ++i) {
       uint32_t eid = EntryID(outputs_[i]);
       const std::string& name = engine_and_context.outputs[i];
       int binding_index = engine->getBindingIndex(name.c_str());
       ICHECK_NE(binding_index, -1);
       if (data_entry_[eid]->device.device_type != kDLCUDA) {
+        if (!synced) {
+          ICHECK_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+          synced = true;
+        }
         auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
         device_buffer.CopyTo(const_cast<DLTensor*>(data_entry_[eid]));
       }
@@ -322,20 +366,109 @@ class TensorRTRuntime : public JSONRuntimeBase {
     return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
   }
 
+  /*! \brief Get the shapes of the input entries, in the order of the network inputs. */
+  std::vector<std::vector<int64_t>> GetInputShapes() {
+    std::vector<std::vector<int64_t>> shapes;
+    for (size_t i = 0; i < input_nodes_.size(); ++i) {
+      auto nid = input_nodes_[i];
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (size_t j = 0; j < nodes_[nid].GetOpShape().size(); ++j) {
+        const DLTensor* tensor = data_entry_[EntryID(nid, j)];
+        shapes.emplace_back(tensor->shape, tensor->shape + tensor->ndim);
+      }
+    }
+    return shapes;
+  }
+
+  /*!
+   * \brief Get the optimization profile of an engine serving the input shapes. The symbolic
+   * dimensions bounded at compile time range from 1 to their bound, and the engine is tuned for the
+   * bound. The unbounded ones, and the ones beyond their bound, are fixed to their current value.
+   */
+  TensorRTOptimizationProfile GetOptimizationProfile(
+      const std::vector<std::vector<int64_t>>& shapes) {
+    ICHECK_EQ(shapes.size(), input_max_shapes_.size())
+        << "The max shapes of the TensorRT inputs do not match the inputs";
+    TensorRTOptimizationProfile profile;
+    size_t input_index = 0;
+    for (size_t i = 0; i < input_nodes_.size(); ++i) {
+      auto nid = input_nodes_[i];
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (const auto& node_shape : nodes_[nid].GetOpShape()) {
+        const std::vector<int64_t>& shape = shapes[input_index];
+        const std::vector<int64_t>& max_shape = input_max_shapes_[input_index];
+        ICHECK_EQ(shape.size(), max_shape.size());
+        ICHECK_EQ(shape.size(), node_shape.size());
+        std::vector<int64_t> min_dims = shape, max_dims = shape;
+        for (size_t k = 0; k < shape.size(); ++k) {
+          if (node_shape[k] != -1 || max_shape[k] == -1) continue;
+          if (shape[k] > max_shape[k]) {
+            LOG(WARNING) << "Dimension " << k << " of TensorRT input " << input_index << " is "
+                         << shape[k] << ", beyond its upper bound " << max_shape[k];
+            continue;
+          }
+          min_dims[k] = 1;
+          max_dims[k] = max_shape[k];
+        }
+        profile.min_shapes.push_back(min_dims);
+        profile.opt_shapes.push_back(max_dims);
+        profile.max_shapes.push_back(max_dims);
+        ++input_index;
+      }
+    }
+    return profile;
+  }
+
+  /*!
+   * \brief Get an engine whose optimization profile serves the current input shapes, and load it
+   * from the cache directory or build it if none exists.
+   */
+  TensorRTEngineAndContext& GetOrBuildProfileEngine() {
+    std::vector<std::vector<int64_t>> shapes = GetInputShapes();
+    for (const auto& profile : profiles_) {
+      if (profile.Covers(shapes)) {
+        return profile_engine_cache_.at(profile.Key());
+      }
+    }
+    TensorRTOptimizationProfile profile = GetOptimizationProfile(shapes);
+    std::string key = profile.Key();
+    if (!GetCachedProfileEngineFromDisk(profile)) {
+      DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_ << " with profile "
+                 << key;
+      const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
+      TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, /*use_implicit_batch=*/
+                              false, use_fp16, GetBatchSize(), /*calibrator=*/nullptr, &profile);
+      AddNetwork(&builder);
+      profile_engine_cache_[key] = builder.BuildEngine();
+      VLOG(1) << "Finished building TensorRT engine for subgraph " << symbol_name_
+              << " with profile " << key;
+      CacheProfileEngineToDisk(profile);
+    }
+    profiles_.push_back(profile);
+    return profile_engine_cache_.at(key);
+  }
+
   void BuildEngineFromJson(int batch_size) {
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
     TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
                             use_fp16, batch_size, calibrator_.get());
+    AddNetwork(&builder);
+    TensorRTEngineAndContext engine_and_context = builder.BuildEngine();
+    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
+  }
+
+  /*! \brief Add the inputs, constants, layers and outputs of the graph to the network. */
+  void AddNetwork(TensorRTBuilder* builder) {
     for (size_t i = 0; i < input_nodes_.size(); ++i) {
       auto nid = input_nodes_[i];
       const auto& node = nodes_[nid];
       std::string name = node.GetOpName();
       if (node.GetOpType() == "input") {
-        builder.AddInput(nid, EntryID(nid, 0), node);
+        builder->AddInput(nid, EntryID(nid, 0), node);
       } else {
         ICHECK_EQ(node.GetOpType(), "const");
         uint32_t eid = EntryID(nid, 0);
-        builder.AddConstant(nid, data_entry_[eid]);
+        builder->AddConstant(nid, data_entry_[eid]);
       }
     }
 
@@ -343,16 +476,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
     for (size_t nid = 0; nid < nodes_.size(); ++nid) {
       const auto& node = nodes_[nid];
       if (node.GetOpType() != "kernel") continue;
-      builder.AddLayer(nid, node);
+      builder->AddLayer(nid, node);
     }
 
     // Add outputs.
     for (size_t i = 0; i < outputs_.size(); ++i) {
-      builder.AddOutput(outputs_[i], EntryID(outputs_[i]));
+      builder->AddOutput(outputs_[i], EntryID(outputs_[i]));
     }
-
-    TensorRTEngineAndContext engine_and_context = builder.BuildEngine();
-    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
   }
 
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
@@ -361,7 +491,8 @@ class TensorRTRuntime : public JSONRuntimeBase {
    */
   bool GetCachedEnginesFromDisk() {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
-    if (cache_dir.empty()) return false;
+    // The engines with optimization profiles are loaded by profile at first inference.
+    if (cache_dir.empty() || UseOptimizationProfiles()) return false;
     std::string key = GetSubgraphKey();
     std::string path = cache_dir + "/" + key + ".plan";
     // Check if engine is in the cache.
@@ -425,6 +556,78 @@ class TensorRTRuntime : public JSONRuntimeBase {
     SaveBinaryToFile(meta_path, os.str());
   }
 
+  /*! \brief The path w/o suffix of the engine of an optimization profile in the cache directory. */
+  std::string GetProfileEnginePath(const std::string& cache_dir,
+                                   const TensorRTOptimizationProfile& profile) {
+    // FNV-1a, as the file names must be stable across runs.
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : profile.Key()) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << cache_dir << "/" << GetSubgraphKey() << "_profile_" << std::hex << hash;
+    return os.str();
+  }
+
+  /*!
+   * \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for an already built TRT
+   * engine of the optimization profile and load it into profile_engine_cache_.
+   */
+  bool GetCachedProfileEngineFromDisk(const TensorRTOptimizationProfile& profile) {
+    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (cache_dir.empty()) return false;
+    std::string path = GetProfileEnginePath(cache_dir, profile);
+    std::ifstream infile(path + ".meta", std::ios::binary);
+    if (!infile.good()) return false;
+    infile.close();
+    // Load metadata, and check the profile against hash collisions.
+    TensorRTEngineAndContext engine_and_context;
+    std::string serialized_meta, profile_key;
+    LoadBinaryFromFile(path + ".meta", &serialized_meta);
+    std::istringstream is(serialized_meta);
+    dmlc::JSONReader reader(&is);
+    dmlc::JSONObjectReadHelper helper;
+    helper.DeclareField("inputs", &engine_and_context.inputs);
+    helper.DeclareField("outputs", &engine_and_context.outputs);
+    helper.DeclareField("profile", &profile_key);
+    helper.ReadAllFields(&reader);
+    if (profile_key != profile.Key()) return false;
+    LOG(INFO) << "Loading cached TensorRT engine from " << path << ".plan";
+    std::string serialized_engine;
+    LoadBinaryFromFile(path + ".plan", &serialized_engine);
+    nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
+    engine_and_context.engine =
+        runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
+    engine_and_context.context = engine_and_context.engine->createExecutionContext();
+    profile_engine_cache_[profile.Key()] = engine_and_context;
+    return true;
+  }
+
+  /*!
+   * \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine of the optimization profile to
+   * that directory so it can be loaded later.
+   */
+  void CacheProfileEngineToDisk(const TensorRTOptimizationProfile& profile) {
+    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (cache_dir.empty()) return;
+    std::string path = GetProfileEnginePath(cache_dir, profile);
+    DLOG(INFO) << "Caching TensorRT engine to " << path << ".plan";
+    const TensorRTEngineAndContext& engine_and_context = profile_engine_cache_.at(profile.Key());
+    nvinfer1::IHostMemory* serialized_engine = engine_and_context.engine->serialize();
+    SaveBinaryToFile(path + ".plan",
+                     std::string(static_cast<const char*>(serialized_engine->data()),
+                                 serialized_engine->size()));
+    serialized_engine->destroy();
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginObject();
+    writer.WriteObjectKeyValue("inputs", engine_and_context.inputs);
+    writer.WriteObjectKeyValue("outputs", engine_and_context.outputs);
+    writer.WriteObjectKeyValue("profile", profile.Key());
+    writer.EndObject();
+    SaveBinaryToFile(path + ".meta", os.str());
+  }
+
   std::string GetSubgraphKey() {
     // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
     // instead use a hash of graph_json and all weights to allow many models in the same directory,
@@ -437,12 +640,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
     std::vector<int64_t> shape(data_entry_[entry_id]->shape,
                                data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
     if (device_buffers_.count(binding_index)) {
-      // Buffer is already initialized.
-      if (shape[0] > device_buffers_[binding_index]->shape[0]) {
+      // Buffer is already initialized. Any dimension may change with optimization profiles.
+      const DLTensor* buffer = device_buffers_[binding_index].operator->();
+      if (GetDataSize(*data_entry_[entry_id]) > GetDataSize(*buffer)) {
         // Buffer is too small. Need to allocate bigger buffer.
         device_buffers_[binding_index] =
             runtime::Tensor::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
-      } else if (shape[0] < device_buffers_[binding_index]->shape[0]) {
+      } else if (shape != std::vector<int64_t>(buffer->shape, buffer->shape + buffer->ndim)) {
         // Buffer is too large. Create view.
         return device_buffers_[binding_index].CreateView(shape, data_entry_[entry_id]->dtype);
       }
@@ -469,6 +673,12 @@ class TensorRTRuntime : public JSONRuntimeBase {
   std::unordered_map<std::pair<std::string, int>, TensorRTEngineAndContext, PairHash>
       trt_engine_cache_;
 
+  /*! \brief Map of optimization profile key to TRT engine if built already. */
+  std::unordered_map<std::string, TensorRTEngineAndContext> profile_engine_cache_;
+
+  /*! \brief The optimization profiles of the engines built, in build order. */
+  std::vector<TensorRTOptimizationProfile> profiles_;
+
   /*! \brief Calibrator for INT8 mode. */
   std::unique_ptr<TensorRTCalibrator> calibrator_;
 
@@ -517,6 +727,12 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief Use auto-conversion to fp16 */
   bool use_fp16_;
+
+  /*!
+   * \brief The max shapes of the inputs, where the symbolic dimensions are bounded at compile time
+   * or are -1 if unbounded. Empty if no dimension is bounded.
+   */
+  std::vector<std::vector<int64_t>> input_max_shapes_;
 };
 
 ffi::Module TensorRTRuntimeCreate(const ffi::String& symbol_name, const ffi::String& graph_json,
@@ -0,0 +1,355 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file sampling.cu
+ * \brief Batched top-k, top-p and min-p sampling on GPU.
+ *
+ * One thread block samples one row. The set of the tokens kept by top-k and top-p is
+ * {prob > threshold}, since both filters only keep the tokens whose probability is large
+ * enough. The threshold is found by a bisection on the bits of the non-negative float
+ * probabilities, which is a radix select of one bit per pass and needs no sort. The token is
+ * then sampled from the kept set in the index order with a block-wide prefix sum. The kernels
+ * allocate no memory and do not synchronize with the host, so that they can be captured in
+ * CUDA graphs, and only the sampled token ids are written out.
+ */
+#include <cub/block/block_reduce.cuh>
+#include <cub/block/block_scan.cuh>
+#include <dlpack/dlpack.h>
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+
+#include <cfloat>
+#include <cstdint>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+constexpr int kSamplingBlockSize = 512;
+
+/*! \brief The probability of the tokens of a row given as probabilities. */
+struct RowProb {
+  const float* row;
+  __device__ float operator()(int64_t i) const { return row[i]; }
+};
+
+/*! \brief The probability of the tokens of a row given as logits, with the softmax computed. */
+struct RowProbFromLogits {
+  const float* row;
+  float max_value;
+  float scale;
+  float inv_sum;
+  __device__ float operator()(int64_t i) const {
+    return __expf((row[i] - max_value) * scale) * inv_sum;
+  }
+};
+
+/*! \brief The mass and the number of tokens of a set, reduced together. */
+struct MassAndCount {
+  float mass;
+  int count;
+};
+
+struct MassAndCountSum {
+  __device__ MassAndCount operator()(const MassAndCount& a, const MassAndCount& b) const {
+    return {a.mass + b.mass, a.count + b.count};
+  }
+};
+
+struct MaxOp {
+  __device__ float operator()(float a, float b) const { return a > b ? a : b; }
+};
+
+struct SumOp {
+  __device__ float operator()(float a, float b) const { return a + b; }
+};
+
+using IndexAndValue = cub::KeyValuePair<int, float>;
+
+struct ArgMaxOp {
+  __device__ IndexAndValue operator()(const IndexAndValue& a, const IndexAndValue& b) const {
+    if (b.value > a.value || (b.value == a.value && b.key >= 0 && b.key < a.key)) return b;
+    return a;
+  }
+};
+
+struct MaxInt64Op {
+  __device__ int64_t operator()(int64_t a, int64_t b) const { return a > b ? a : b; }
+};
+
+union SamplingTempStorage {
+  cub::BlockReduce<float, kSamplingBlockSize>::TempStorage reduce_float;
+  cub::BlockReduce<int64_t, kSamplingBlockSize>::TempStorage reduce_int64;
+  cub::BlockReduce<MassAndCount, kSamplingBlockSize>::TempStorage reduce_mass_and_count;
+  cub::BlockReduce<IndexAndValue, kSamplingBlockSize>::TempStorage argmax;
+  cub::BlockScan<float, kSamplingBlockSize>::TempStorage scan;
+};
+
+/*! \brief Reduce a float over the block and broadcast the result to every thread. */
+template <typename Op>
+__device__ float BlockAllReduce(float value, Op op, SamplingTempStorage* temp, float* broadcast) {
+  float result = cub::BlockReduce<float, kSamplingBlockSize>(temp->reduce_float).Reduce(value, op);
+  if (threadIdx.x == 0) *broadcast = result;
+  __syncthreads();
+  result = *broadcast;
+  __syncthreads();
+  return result;
+}
+
+/*!
+ * \brief Sample one row after top-k, top-p and min-p filtering.
+ * \param prob The probability of each token of the row.
+ * \param max_prob The largest probability of the row.
+ * \return The sampled token, or -1 if the row has no token to sample from, e.g. with NaNs.
+ */
+template <typename Prob>
+__device__ int64_t SampleRow(Prob prob, float max_prob, int64_t vocab_size, int top_k,
+                             float top_p, float min_p, float uniform_sample,
+                             SamplingTempStorage* temp) {
+  __shared__ MassAndCount shared_mass_and_count;
+  __shared__ int64_t shared_sampled;
+
+  bool use_top_k = top_k > 0 && top_k < vocab_size;
+  bool use_top_p = top_p < 1.0f;
+  // Whether the tokens with a probability greater than threshold pass top-k and top-p.
+  auto keeps_greater_than = [&](float threshold) {
+    MassAndCount local{0.0f, 0};
+    for (int64_t i = threadIdx.x; i < vocab_size; i += kSamplingBlockSize) {
+      float p = prob(i);
+      if (p > threshold) {
+        local.mass += p;
+        local.count += 1;
+      }
+    }
+    MassAndCount total = cub::BlockReduce<MassAndCount, kSamplingBlockSize>(
+                             temp->reduce_mass_and_count)
+                             .Reduce(local, MassAndCountSum());
+    if (threadIdx.x == 0) shared_mass_and_count = total;
+    __syncthreads();
+    total = shared_mass_and_count;
+    __syncthreads();
+    // The token of probability p is kept when the tokens larger than it are not enough yet.
+    return (!use_top_k || total.count < top_k) && (!use_top_p || total.mass < top_p);
+  };
+
+  // Bisect on the bits of the threshold, which order as the non-negative floats do, to find
+  // the largest threshold rejecting the token at the threshold. The largest probability is
+  // always kept, so that the upper bound is valid.
+  float threshold = 0.0f;
+  if ((use_top_k || use_top_p) && !keeps_greater_than(0.0f)) {
+    uint32_t lo = __float_as_uint(0.0f);
+    uint32_t hi = __float_as_uint(max_prob);
+    while (hi - lo > 1) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (keeps_greater_than(__uint_as_float(mid))) {
+        hi = mid;
+      } else {
+        lo = mid;
+      }
+    }
+    threshold = __uint_as_float(lo);
+  }
+  float min_prob = min_p * max_prob;
+  auto is_kept = [&](float p) { return p > threshold && p >= min_prob && p > 0.0f; };
+
+  // Sample from the kept tokens in the index order. Each thread owns a contiguous chunk.
+  int64_t chunk = (vocab_size + kSamplingBlockSize - 1) / kSamplingBlockSize;
+  int64_t begin = static_cast<int64_t>(threadIdx.x) * chunk;
+  int64_t end = begin + chunk < vocab_size ? begin + chunk : vocab_size;
+  float local_mass = 0.0f;
+  int64_t local_last = -1;
+  for (int64_t i = begin; i < end; ++i) {
+    float p = prob(i);
+    if (is_kept(p)) {
+      local_mass += p;
+      local_last = i;
+    }
+  }
+  float prefix;
+  float total;
+  cub::BlockScan<float, kSamplingBlockSize>(temp->scan).ExclusiveSum(local_mass, prefix, total);
+  __syncthreads();
+  int64_t last =
+      cub::BlockReduce<int64_t, kSamplingBlockSize>(temp->reduce_int64).Reduce(local_last,
+                                                                                MaxInt64Op());
+  if (threadIdx.x == 0) shared_sampled = -1;
+  __syncthreads();
+  float target = uniform_sample * total;
+  if (local_mass > 0.0f && prefix <= target && target < prefix + local_mass) {
+    float cumsum = prefix;
+    int64_t sampled = local_last;
+    for (int64_t i = begin; i < end; ++i) {
+      float p = prob(i);
+      if (is_kept(p)) {
+        cumsum += p;
+        if (target < cumsum) {
+          sampled = i;
+          break;
+        }
+      }
+    }
+    shared_sampled = sampled;
+  }
+  __syncthreads();
+  // The target may fall past the last token due to the rounding of the prefix sum.
+  if (threadIdx.x == 0 && shared_sampled == -1) shared_sampled = last;
+  __syncthreads();
+  return shared_sampled;
+}
+
+/*!
+ * \brief The kernel sampling one row per thread block.
+ * \param temperature The temperature of each row when input holds logits, or nullptr when it
+ * holds probabilities.
+ */
+__global__ void BatchSampleKernel(const float* input, int64_t vocab_size,
+                                  const float* temperature, const int* top_k, const float* top_p,
+                                  const float* min_p, const float* uniform_sample,
+                                  int64_t* output) {
+  __shared__ SamplingTempStorage temp;
+  __shared__ float shared_float;
+  int64_t row = blockIdx.x;
+  const float* row_input = input + row * vocab_size;
+
+  if (temperature == nullptr) {
+    RowProb prob{row_input};
+    float local_max = -FLT_MAX;
+    for (int64_t i = threadIdx.x; i < vocab_size; i += kSamplingBlockSize) {
+      local_max = max(local_max, prob(i));
+    }
+    float max_prob = BlockAllReduce(local_max, MaxOp(), &temp, &shared_float);
+    int64_t sampled = SampleRow(prob, max_prob, vocab_size, top_k[row], top_p[row], min_p[row],
+                                uniform_sample[row], &temp);
+    if (threadIdx.x == 0) output[row] = sampled;
+    return;
+  }
+
+  float row_temperature = temperature[row];
+  if (row_temperature < 1e-6f) {
+    // Greedy decoding.
+    IndexAndValue local{-1, -FLT_MAX};
+    for (int64_t i = threadIdx.x; i < vocab_size; i += kSamplingBlockSize) {
+      if (row_input[i] > local.value) local = {static_cast<int>(i), row_input[i]};
+    }
+    IndexAndValue best =
+        cub::BlockReduce<IndexAndValue, kSamplingBlockSize>(temp.argmax)
+            .Reduce(local, ArgMaxOp());
+    if (threadIdx.x == 0) output[row] = best.key;
+    return;
+  }
+  float local_max = -FLT_MAX;
+  for (int64_t i = threadIdx.x; i < vocab_size; i += kSamplingBlockSize) {
+    local_max = max(local_max, row_input[i]);
+  }
+  float max_value = BlockAllReduce(local_max, MaxOp(), &temp, &shared_float);
+  float scale = 1.0f / row_temperature;
+  float local_sum = 0.0f;
+  for (int64_t i = threadIdx.x; i < vocab_size; i += kSamplingBlockSize) {
+    local_sum += __expf((row_input[i] - max_value) * scale);
+  }
+  float sum = BlockAllReduce(local_sum, SumOp(), &temp, &shared_float);
+  RowProbFromLogits prob{row_input, max_value, scale, 1.0f / sum};
+  // The largest logit has probability exp(0) / sum.
+  int64_t sampled = SampleRow(prob, prob.inv_sum, vocab_size, top_k[row], top_p[row], min_p[row],
+                              uniform_sample[row], &temp);
+  if (threadIdx.x == 0) output[row] = sampled;
+}
+
+void CheckSamplingTensor(DLTensor* tensor, int64_t batch_size, DLDataType dtype,
+                         const char* name) {
+  CHECK_EQ(tensor->device.device_type, kDLCUDA) << name << " must be on CUDA";
+  CHECK(tensor->dtype.code == dtype.code && tensor->dtype.bits == dtype.bits &&
+        tensor->dtype.lanes == 1)
+      << "Unexpected data type of " << name;
+  CHECK(tensor->strides == nullptr) << name << " must be contiguous";
+  int64_t numel = 1;
+  for (int i = 0; i < tensor->ndim; ++i) numel *= tensor->shape[i];
+  CHECK_EQ(numel, batch_size) << name << " must have one element per row";
+}
+
+/*!
+ * \brief Batched top-k, top-p and min-p sampling on GPU.
+ * \param input The probabilities or logits of shape (batch_size, vocab_size), in float32.
+ * \param temperature The temperature of each row in float32 when input holds logits, or
+ * nullptr when it holds probabilities. A temperature close to 0 means greedy decoding.
+ * \param top_k The top-k value of each row in int32. A value <= 0 disables top-k.
+ * \param top_p The top-p value of each row in float32. A value >= 1 disables top-p.
+ * \param min_p The min-p value of each row in float32. A value of 0 disables min-p.
+ * \param uniform_sample The uniform sample in [0, 1) of each row in float32.
+ * \param output The sampled token ids of shape (batch_size, 1) in int64, written on device.
+ * A row with no token to sample from, e.g. with NaNs, gets -1.
+ */
+void BatchSampleOnGPU(DLTensor* input, DLTensor* temperature, DLTensor* top_k, DLTensor* top_p,
+                      DLTensor* min_p, DLTensor* uniform_sample, DLTensor* output) {
+  CHECK_EQ(input->ndim, 2) << "The input of batched sampling must be 2-dimensional";
+  CHECK_EQ(input->device.device_type, kDLCUDA) << "The input of batched sampling must be on CUDA";
+  CHECK(input->dtype.code == kDLFloat && input->dtype.bits == 32) << "The input must be float32";
+  CHECK(input->strides == nullptr) << "The input must be contiguous";
+  int64_t batch_size = input->shape[0];
+  int64_t vocab_size = input->shape[1];
+  CHECK_LT(vocab_size, INT32_MAX);
+  DLDataType f32{kDLFloat, 32, 1};
+  if (temperature != nullptr) {
+    CheckSamplingTensor(temperature, batch_size, f32, "temperature");
+  }
+  CheckSamplingTensor(top_k, batch_size, DLDataType{kDLInt, 32, 1}, "top_k");
+  CheckSamplingTensor(top_p, batch_size, f32, "top_p");
+  CheckSamplingTensor(min_p, batch_size, f32, "min_p");
+  CheckSamplingTensor(uniform_sample, batch_size, f32, "uniform_sample");
+  CheckSamplingTensor(output, batch_size, DLDataType{kDLInt, 64, 1}, "output");
+  if (batch_size == 0) return;
+
+  auto data = [](DLTensor* tensor) {
+    return static_cast<char*>(tensor->data) + tensor->byte_offset;
+  };
+  CUDA_CALL(cudaSetDevice(input->device.device_id));
+  cudaStream_t stream =
+      static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, input->device.device_id));
+  BatchSampleKernel<<<batch_size, kSamplingBlockSize, 0, stream>>>(
+      reinterpret_cast<const float*>(data(input)), vocab_size,
+      temperature != nullptr ? reinterpret_cast<const float*>(data(temperature)) : nullptr,
+      reinterpret_cast<const int*>(data(top_k)), reinterpret_cast<const float*>(data(top_p)),
+      reinterpret_cast<const float*>(data(min_p)),
+      reinterpret_cast<const float*>(data(uniform_sample)),
+      reinterpret_cast<int64_t*>(data(output)));
+  CUDA_CALL(cudaGetLastError());
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("vm.builtin.cuda.batch_sample_from_logits",
+           [](DLTensor* logits, DLTensor* temperature, DLTensor* top_k, DLTensor* top_p,
+              DLTensor* min_p, DLTensor* uniform_sample, DLTensor* output) {
+             BatchSampleOnGPU(logits, temperature, top_k, top_p, min_p, uniform_sample, output);
+           })
+      .def("vm.builtin.cuda.batch_sample_from_prob",
+           [](DLTensor* prob, DLTensor* top_k, DLTensor* top_p, DLTensor* min_p,
+              DLTensor* uniform_sample, DLTensor* output) {
+             BatchSampleOnGPU(prob, nullptr, top_k, top_p, min_p, uniform_sample, output);
+           });
+}
+
+}  // namespace contrib
+}  // namespace tvm
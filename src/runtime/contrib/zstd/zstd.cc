@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file zstd.cc
+ * \brief The zstd codec used to compress the tensor copies of RPC sessions.
+ */
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/ffi/string.h>
+#include <tvm/runtime/logging.h>
+#include <zstd.h>
+
+#include <string>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Compress a host buffer.
+ * \param data The buffer to compress.
+ * \param nbytes The size of the buffer in bytes.
+ * \param level The zstd compression level.
+ * \return The compressed bytes.
+ */
+ffi::Bytes ZstdCompress(void* data, int64_t nbytes, int level) {
+  std::string out(ZSTD_compressBound(nbytes), '\0');
+  size_t size = ZSTD_compress(out.data(), out.size(), data, nbytes, level);
+  CHECK(!ZSTD_isError(size)) << "RuntimeError: zstd compression failed: "
+                             << ZSTD_getErrorName(size);
+  out.resize(size);
+  return ffi::Bytes(std::move(out));
+}
+
+/*!
+ * \brief Decompress bytes into a host buffer.
+ * \param payload The compressed bytes.
+ * \param out The buffer to decompress into.
+ * \param nbytes The size of the buffer, which must be the size of the decompressed bytes.
+ */
+void ZstdDecompress(ffi::Bytes payload, void* out, int64_t nbytes) {
+  size_t size = ZSTD_decompress(out, nbytes, payload.data(), payload.size());
+  CHECK(!ZSTD_isError(size)) << "RuntimeError: zstd decompression failed: "
+                             << ZSTD_getErrorName(size);
+  CHECK_EQ(size, static_cast<size_t>(nbytes))
+      << "RuntimeError: zstd decompressed " << size << " bytes, but " << nbytes
+      << " bytes are expected";
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("rpc.codec.zstd.compress", ZstdCompress)
+      .def("rpc.codec.zstd.decompress", ZstdDecompress);
+}
+
+}  // namespace runtime
+}  // namespace tvm
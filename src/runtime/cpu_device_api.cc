@@ -25,9 +25,13 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "workspace_pool.h"
 
@@ -39,6 +43,12 @@
 #include <sys/sysinfo.h>
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -50,6 +60,84 @@
 
 namespace tvm {
 namespace runtime {
+
+namespace {
+
+/*! \brief The NUMA placement of the CPU allocations, set by the TVM_NUMA_ALLOC environment. */
+enum class NumaAllocPolicy {
+  /*! \brief Keep the placement of the operating system. */
+  kDefault,
+  /*! \brief Prefer the node of the CPU that allocates. */
+  kLocal,
+  /*! \brief Interleave the pages over all the nodes. */
+  kInterleave,
+};
+
+NumaAllocPolicy GetNumaAllocPolicy() {
+  static const NumaAllocPolicy policy = []() {
+    const char* val = getenv("TVM_NUMA_ALLOC");
+    if (val == nullptr || std::string(val).empty()) {
+      return NumaAllocPolicy::kDefault;
+    }
+    std::string name = val;
+    if (name == "local") {
+      return NumaAllocPolicy::kLocal;
+    } else if (name == "interleave") {
+      return NumaAllocPolicy::kInterleave;
+    }
+    LOG(WARNING) << "Unknown TVM_NUMA_ALLOC value \"" << name
+                 << "\", expected \"local\" or \"interleave\"";
+    return NumaAllocPolicy::kDefault;
+  }();
+  return policy;
+}
+
+/*!
+ * \brief Apply the NUMA policy to the whole pages of an allocation, before they are touched.
+ * \note Weights read by the workers of all the sockets benefit from interleaving, while the
+ *  activations of a worker benefit from the local placement.
+ */
+void BindToNumaNodes(void* ptr, size_t nbytes, NumaAllocPolicy policy) {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+  constexpr int kMpolPreferred = 1;
+  constexpr int kMpolInterleave = 3;
+  const std::vector<std::vector<unsigned int>>& nodes = threading::NumaNodeCpus();
+  if (policy == NumaAllocPolicy::kDefault || nodes.size() <= 1) {
+    return;
+  }
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t len = nbytes / page_size * page_size;
+  if (len == 0) {
+    return;
+  }
+  constexpr size_t kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT(runtime/int)
+  std::vector<unsigned long> mask((nodes.size() + kBitsPerWord - 1) / kBitsPerWord, 0);  // NOLINT
+  int mode;
+  if (policy == NumaAllocPolicy::kInterleave) {
+    mode = kMpolInterleave;
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      if (!nodes[node].empty()) mask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+    }
+  } else {
+    mode = kMpolPreferred;
+    int cpu = sched_getcpu();
+    size_t local = 0;
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      const std::vector<unsigned int>& cpus = nodes[node];
+      if (std::find(cpus.begin(), cpus.end(), static_cast<unsigned int>(cpu)) != cpus.end()) {
+        local = node;
+      }
+    }
+    mask[local / kBitsPerWord] |= 1UL << (local % kBitsPerWord);
+  }
+  if (syscall(SYS_mbind, ptr, len, mode, mask.data(), mask.size() * kBitsPerWord + 1, 0) != 0) {
+    LOG(WARNING) << "mbind failed, the allocation keeps the default NUMA placement";
+  }
+#endif
+}
+
+}  // namespace
+
 class CPUDeviceAPI final : public DeviceAPI {
  public:
   void SetDevice(Device dev) final {}
@@ -95,6 +183,14 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
     void* ptr;
+    NumaAllocPolicy numa_policy = GetNumaAllocPolicy();
+#if defined(__linux__) && !defined(__ANDROID__)
+    // A NUMA policy applies to whole pages, so page-align the allocations that span pages.
+    if (numa_policy != NumaAllocPolicy::kDefault) {
+      size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      if (nbytes >= page_size) alignment = std::max(alignment, page_size);
+    }
+#endif
 #if _MSC_VER
     ptr = _aligned_malloc(nbytes, alignment);
     if (ptr == nullptr) throw std::bad_alloc();
@@ -106,6 +202,7 @@ class CPUDeviceAPI final : public DeviceAPI {
     int ret = posix_memalign(&ptr, alignment, nbytes);
     if (ret != 0) throw std::bad_alloc();
 #endif
+    BindToNumaNodes(ptr, nbytes, numa_policy);
     return ptr;
   }
 
@@ -30,9 +30,16 @@
 #include <tvm/ffi/reflection/registry.h>
 
 #include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
 #include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../file_utils.h"
@@ -114,19 +121,28 @@ class CUDAModuleNode : public ffi::ModuleObj {
     }
   }
 
-  // get a CUfunction from primary context in device_id
-  CUfunction GetFunc(int device_id, const std::string& func_name) {
-    std::lock_guard<std::mutex> lock(mutex_);
+  // load the module into the primary context of device_id, if not loaded yet
+  CUmodule LoadModule(int device_id) {
+    std::lock_guard<std::mutex> lock(mutex_[device_id]);
     // must recheck under the lock scope
     if (module_[device_id] == nullptr) {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
+      if (fmt_ == "ptx") {
+        LoadPTXWithCache(device_id);
+      } else {
+        CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
+      }
       static auto nvshmem_init_hook = ffi::Function::GetGlobal("runtime.nvshmem.cumodule_init");
       if (nvshmem_init_hook.has_value()) {
         (*nvshmem_init_hook)(static_cast<void*>(module_[device_id]));
       }
     }
+    return module_[device_id];
+  }
+  // get a CUfunction from primary context in device_id
+  CUfunction GetFunc(int device_id, const std::string& func_name) {
+    CUmodule module = LoadModule(device_id);
     CUfunction func;
-    CUresult result = cuModuleGetFunction(&func, module_[device_id], func_name.c_str());
+    CUresult result = cuModuleGetFunction(&func, module, func_name.c_str());
     if (result != CUDA_SUCCESS) {
       const char* msg;
       cuGetErrorName(result, &msg);
@@ -136,19 +152,11 @@ class CUDAModuleNode : public ffi::ModuleObj {
   }
   // get a global var from primary context in device_id
   CUdeviceptr GetGlobal(int device_id, const std::string& global_name, size_t expect_nbytes) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    // must recheck under the lock scope
-    if (module_[device_id] == nullptr) {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
-      static auto nvshmem_init_hook = ffi::Function::GetGlobal("runtime.nvshmem.cumodule_init");
-      if (nvshmem_init_hook.has_value()) {
-        (*nvshmem_init_hook)(static_cast<void*>(module_[device_id]));
-      }
-    }
+    CUmodule module = LoadModule(device_id);
     CUdeviceptr global;
     size_t nbytes;
 
-    CUresult result = cuModuleGetGlobal(&global, &nbytes, module_[device_id], global_name.c_str());
+    CUresult result = cuModuleGetGlobal(&global, &nbytes, module, global_name.c_str());
     ICHECK_EQ(nbytes, expect_nbytes);
     if (result != CUDA_SUCCESS) {
       const char* msg;
@@ -159,6 +167,77 @@ class CUDAModuleNode : public ffi::ModuleObj {
   }
 
  private:
+  // Load the PTX through the cubin cache, which keeps the driver JIT out of later cold starts.
+  void LoadPTXWithCache(int device_id) {
+    std::string path = CubinCachePath(device_id);
+    std::string cubin;
+    if (!path.empty() && std::filesystem::exists(path)) {
+      LoadBinaryFromFile(path, &cubin);
+      if (cuModuleLoadData(&(module_[device_id]), cubin.c_str()) == CUDA_SUCCESS) {
+        return;
+      }
+      // A stale or truncated cache entry is recompiled below.
+      module_[device_id] = nullptr;
+    }
+    if (!path.empty() && CompilePTX(&cubin)) {
+      CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), cubin.c_str()));
+      std::string tmp_path = path + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(this));
+      std::error_code ec;
+      std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+      try {
+        // The module is already loaded, a cubin that cannot be written only leaves the driver
+        // JIT to the next cold start.
+        if (!ec) {
+          SaveBinaryToFile(tmp_path, cubin);
+          std::filesystem::rename(tmp_path, path, ec);
+        }
+      } catch (const std::exception& e) {
+        VLOG(1) << "Failed to cache the cubin at " << path << ": " << e.what();
+      }
+      return;
+    }
+    CUDA_DRIVER_CALL(cuModuleLoadData(&(module_[device_id]), data_.c_str()));
+  }
+  // The path of the cached cubin of the PTX for the device, or empty if the cache is disabled.
+  std::string CubinCachePath(int device_id) const {
+    const char* env = std::getenv("TVM_CUDA_CUBIN_CACHE");
+    if (env != nullptr && std::string(env) == "0") {
+      return "";
+    }
+    int major, minor, driver_version;
+    CUDA_CALL(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id));
+    CUDA_CALL(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id));
+    CUDA_DRIVER_CALL(cuDriverGetVersion(&driver_version));
+    // FNV-1a, which unlike std::hash is stable across builds.
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : data_) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << GetCacheDir() << "/cuda_cubin/sm_" << major << minor << "_driver" << driver_version
+       << "/" << std::hex << hash << ".cubin";
+    return os.str();
+  }
+  // JIT-compile the PTX into cubin for the current device.
+  bool CompilePTX(std::string* cubin) const {
+    CUlinkState state;
+    if (cuLinkCreate(0, nullptr, nullptr, &state) != CUDA_SUCCESS) {
+      return false;
+    }
+    void* data = nullptr;
+    size_t size = 0;
+    bool success = cuLinkAddData(state, CU_JIT_INPUT_PTX, const_cast<char*>(data_.c_str()),
+                                 data_.size() + 1, "tvm_kernels.ptx", 0, nullptr,
+                                 nullptr) == CUDA_SUCCESS &&
+                   cuLinkComplete(state, &data, &size) == CUDA_SUCCESS;
+    if (success) {
+      // The output is owned by the link state.
+      cubin->assign(static_cast<const char*>(data), size);
+    }
+    cuLinkDestroy(state);
+    return success;
+  }
+
   // the binary data
   std::string data_;
   // The format
@@ -169,8 +248,8 @@ class CUDAModuleNode : public ffi::ModuleObj {
   std::string cuda_source_;
   // the internal modules per GPU, to be lazily initialized.
   std::array<CUmodule, kMaxNumGPUs> module_;
-  // internal mutex when updating the module
-  std::mutex mutex_;
+  // internal mutexes when updating the module of each GPU
+  std::array<std::mutex, kMaxNumGPUs> mutex_;
 };
 
 // a wrapped function class to get packed func.
@@ -203,22 +282,47 @@ class CUDAWrappedFunc {
                      << wl.dyn_shmem_size;
         }
       }
+      if (wl.cluster_dim(0) * wl.cluster_dim(1) * wl.cluster_dim(2) > 8) {
+        // Clusters of more than 8 blocks are only allowed with the non-portable opt-in.
+        CUresult result = cuFuncSetAttribute(
+            fcache_[device_id], CU_FUNC_ATTRIBUTE_NON_PORTABLE_CLUSTER_SIZE_ALLOWED, 1);
+        if (result != CUDA_SUCCESS) {
+          LOG(FATAL) << "Failed to allow the non-portable cluster size of " << func_name_;
+        }
+      }
     }
     CUstream strm = static_cast<CUstream>(TVMFFIEnvGetStream(kDLCUDA, device_id));
     CUresult result;
 
-    if (launch_param_config_.use_programtic_dependent_launch()) {
+    if (launch_param_config_.use_programtic_dependent_launch() ||
+        launch_param_config_.use_cluster_launch()) {
       CUlaunchConfig config{};
-      CUlaunchAttribute attribute[1]{};
-      attribute[0].id = CU_LAUNCH_ATTRIBUTE_PROGRAMMATIC_STREAM_SERIALIZATION;
-      attribute[0].value.programmaticStreamSerializationAllowed = 1;
+      CUlaunchAttribute attribute[2]{};
+      unsigned num_attrs = 0;
+      // The grid of a cluster launch counts the clusters, each made of cluster_dim blocks.
+      size_t grid_scale[3] = {1, 1, 1};
+      if (launch_param_config_.use_programtic_dependent_launch()) {
+        attribute[num_attrs].id = CU_LAUNCH_ATTRIBUTE_PROGRAMMATIC_STREAM_SERIALIZATION;
+        attribute[num_attrs].value.programmaticStreamSerializationAllowed = 1;
+        ++num_attrs;
+      }
+      if (launch_param_config_.use_cluster_launch()) {
+        attribute[num_attrs].id = CU_LAUNCH_ATTRIBUTE_CLUSTER_DIMENSION;
+        attribute[num_attrs].value.clusterDim.x = wl.cluster_dim(0);
+        attribute[num_attrs].value.clusterDim.y = wl.cluster_dim(1);
+        attribute[num_attrs].value.clusterDim.z = wl.cluster_dim(2);
+        ++num_attrs;
+        for (int i = 0; i < 3; ++i) {
+          grid_scale[i] = wl.cluster_dim(i);
+        }
+      }
 
       config.attrs = attribute;
-      config.numAttrs = 1;
+      config.numAttrs = num_attrs;
       config.hStream = strm;
-      config.gridDimX = wl.grid_dim(0);
-      config.gridDimY = wl.grid_dim(1);
-      config.gridDimZ = wl.grid_dim(2);
+      config.gridDimX = wl.grid_dim(0) * grid_scale[0];
+      config.gridDimY = wl.grid_dim(1) * grid_scale[1];
+      config.gridDimZ = wl.grid_dim(2) * grid_scale[2];
       config.blockDimX = wl.block_dim(0);
       config.blockDimY = wl.block_dim(1);
       config.blockDimZ = wl.block_dim(2);
@@ -242,7 +346,12 @@ class CUDAWrappedFunc {
       os << "CUDALaunch Error: " << msg << "\n"
          << " grid=(" << wl.grid_dim(0) << "," << wl.grid_dim(1) << "," << wl.grid_dim(2) << "), "
          << " block=(" << wl.block_dim(0) << "," << wl.block_dim(1) << "," << wl.block_dim(2)
-         << ")\n";
+         << ")";
+      if (launch_param_config_.use_cluster_launch()) {
+        os << " cluster=(" << wl.cluster_dim(0) << "," << wl.cluster_dim(1) << ","
+           << wl.cluster_dim(2) << ")";
+      }
+      os << "\n";
       std::string cuda = m_->InspectSource("");
       if (cuda.length() != 0) {
         os << "// func_name=" << func_name_ << "\n"
@@ -337,12 +446,70 @@ ffi::Module CUDAModuleLoadFromBytes(const ffi::Bytes& bytes) {
   return CUDAModuleCreate(data, fmt, fmap, std::string());
 }
 
+/*!
+ * \brief Load the CUDA modules in a module tree onto devices ahead of their first use, with one
+ * thread per module and device, so that the driver JIT of the modules overlaps.
+ * \param mod The root of the module tree.
+ * \param device_ids The devices to load onto. All devices if empty.
+ */
+void CUDAModulePrefetch(ffi::Module mod, ffi::Array<int64_t> device_ids) {
+  std::vector<CUDAModuleNode*> cuda_modules;
+  std::unordered_set<const ffi::ModuleObj*> visited{mod.operator->()};
+  std::vector<ffi::ModuleObj*> stack{mod.operator->()};
+  while (!stack.empty()) {
+    ffi::ModuleObj* node = stack.back();
+    stack.pop_back();
+    if (std::string(node->kind()) == "cuda") {
+      cuda_modules.push_back(static_cast<CUDAModuleNode*>(node));
+    }
+    for (Any m : node->imports()) {
+      ffi::ModuleObj* next = m.cast<ffi::Module>().operator->();
+      if (visited.insert(next).second) {
+        stack.push_back(next);
+      }
+    }
+  }
+  if (device_ids.empty()) {
+    int count;
+    CUDA_CALL(cudaGetDeviceCount(&count));
+    for (int i = 0; i < count; ++i) {
+      device_ids.push_back(i);
+    }
+  }
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> errors(cuda_modules.size() * device_ids.size());
+  for (size_t i = 0; i < cuda_modules.size(); ++i) {
+    for (size_t j = 0; j < device_ids.size(); ++j) {
+      int device_id = static_cast<int>(device_ids[j]);
+      ICHECK(device_id >= 0 && device_id < kMaxNumGPUs) << "Invalid CUDA device " << device_id;
+      std::exception_ptr* error = &errors[i * device_ids.size() + j];
+      threads.emplace_back([module = cuda_modules[i], device_id, error]() {
+        try {
+          CUDA_CALL(cudaSetDevice(device_id));
+          module->LoadModule(device_id);
+        } catch (...) {
+          *error = std::current_exception();
+        }
+      });
+    }
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
       .def("ffi.Module.load_from_file.cuda", CUDAModuleLoadFile)
       .def("ffi.Module.load_from_file.ptx", CUDAModuleLoadFile)
-      .def("ffi.Module.load_from_bytes.cuda", CUDAModuleLoadFromBytes);
+      .def("ffi.Module.load_from_bytes.cuda", CUDAModuleLoadFromBytes)
+      .def("runtime.cuda.PrefetchModules", CUDAModulePrefetch);
 }
 }  // namespace runtime
 }  // namespace tvm
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cuda_stream_ordered_allocator.cc
+ * \brief The allocator that allocates and frees CUDA memory in the order of the current stream.
+ */
+#include <cuda_runtime.h>
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+
+#include "cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+
+#if CUDART_VERSION >= 11020
+
+/*!
+ * \brief The allocator backed by cudaMallocFromPoolAsync and cudaFreeAsync on the current stream.
+ *
+ * Unlike cudaMalloc and cudaFree, neither call synchronizes the device, and the memory freed is
+ * reused by later allocations on the same stream right away. Each device has its own memory
+ * pool, which keeps the freed memory reserved up to the release threshold instead of returning
+ * it to the driver at every synchronization.
+ */
+class CUDAStreamOrderedAllocator final : public memory::Allocator {
+ public:
+  explicit CUDAStreamOrderedAllocator(int device_id)
+      : Allocator(memory::kStreamOrdered), device_id_(device_id), used_memory_(0) {
+    CUDA_CALL(cudaSetDevice(device_id_));
+    cudaMemPoolProps props = {};
+    props.allocType = cudaMemAllocationTypePinned;
+    props.handleTypes = cudaMemHandleTypeNone;
+    props.location.type = cudaMemLocationTypeDevice;
+    props.location.id = device_id_;
+    CUDA_CALL(cudaMemPoolCreate(&pool_, &props));
+    SetReleaseThreshold(std::numeric_limits<uint64_t>::max());
+  }
+
+  ~CUDAStreamOrderedAllocator() {
+    if (cudaSetDevice(device_id_) == cudaSuccess && cudaDeviceSynchronize() == cudaSuccess) {
+      cudaMemPoolDestroy(pool_);
+    }
+  }
+
+  memory::Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    ICHECK_EQ(256 % alignment, 0U) << "CUDA space is aligned at 256 bytes";
+    memory::Buffer buf;
+    buf.device = dev;
+    buf.size = nbytes;
+    buf.alloc_type = memory::kStreamOrdered;
+    CUDA_CALL(cudaSetDevice(device_id_));
+    CUDA_CALL(cudaMallocFromPoolAsync(&buf.data, nbytes, pool_, CurrentStream()));
+    used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    return buf;
+  }
+
+  void Free(const memory::Buffer& buffer) final {
+    if (std::uncaught_exceptions() && cudaPeekAtLastError() == cudaErrorIllegalAddress) {
+      // The driver is in an unrecoverable state, see CUDADeviceAPI::FreeDataSpace.
+      return;
+    }
+    CUDA_CALL(cudaSetDevice(device_id_));
+    CUDA_CALL(cudaFreeAsync(buffer.data, CurrentStream()));
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+  }
+
+  void Clear() final {
+    CUDA_CALL(cudaSetDevice(device_id_));
+    CUDA_CALL(cudaStreamSynchronize(CurrentStream()));
+    CUDA_CALL(cudaMemPoolTrimTo(pool_, 0));
+  }
+
+  size_t UsedMemory() const final { return used_memory_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Set the amount of the freed memory the pool keeps reserved at a synchronization.
+   * \param threshold The release threshold in bytes.
+   */
+  void SetReleaseThreshold(uint64_t threshold) {
+    CUDA_CALL(cudaMemPoolSetAttribute(pool_, cudaMemPoolAttrReleaseThreshold, &threshold));
+  }
+
+ private:
+  cudaStream_t CurrentStream() const {
+    return static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, device_id_));
+  }
+
+  int device_id_;
+  cudaMemPool_t pool_;
+  std::atomic<size_t> used_memory_;
+};
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def_packed("DeviceAllocator.stream_ordered.cuda",
+                  [](ffi::PackedArgs args, ffi::Any* rv) {
+                    Device dev = args[0].cast<Device>();
+                    memory::Allocator* alloc = new CUDAStreamOrderedAllocator(dev.device_id);
+                    *rv = static_cast<void*>(alloc);
+                  })
+      .def("vm.builtin.memory_manager.stream_ordered_set_release_threshold",
+           [](Device dev, int64_t threshold) {
+             CHECK_EQ(dev.device_type, kDLCUDA)
+                 << "ValueError: The stream-ordered allocator is only available on CUDA";
+             CHECK_GE(threshold, 0) << "ValueError: The release threshold must be non-negative";
+             auto* allocator = static_cast<CUDAStreamOrderedAllocator*>(
+                 memory::MemoryManager::GetOrCreateAllocator(dev, memory::kStreamOrdered));
+             allocator->SetReleaseThreshold(static_cast<uint64_t>(threshold));
+           });
+}
+
+#endif  // CUDART_VERSION >= 11020
+
+}  // namespace runtime
+}  // namespace tvm
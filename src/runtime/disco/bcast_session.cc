@@ -21,7 +21,9 @@
 #include <tvm/ffi/function.h>
 #include <tvm/runtime/disco/session.h>
 
+#include <algorithm>
 #include <sstream>
+#include <utility>
 
 namespace tvm {
 namespace runtime {
@@ -43,6 +45,29 @@ struct BcastSessionObj::Internal {
     p->session = session;
     return DRef(std::move(p));
   }
+
+  static void CheckNotRecording(BcastSessionObj* self, const char* action) {
+    CHECK(self->recording_ == nullptr)
+        << "ValueError: " << action << " cannot be issued while recording a command buffer";
+  }
+
+  static void PinReg(BcastSessionObj* self, int64_t reg_id) {
+    self->recording_->used_regs.push_back(reg_id);
+    ++self->pinned_regs_[reg_id];
+  }
+
+  static void UnpinRegs(BcastSessionObj* self, const std::vector<int64_t>& used_regs) {
+    for (int64_t reg_id : used_regs) {
+      auto it = self->pinned_regs_.find(reg_id);
+      ICHECK(it != self->pinned_regs_.end());
+      if (--it->second == 0) {
+        self->pinned_regs_.erase(it);
+        if (self->released_pinned_regs_.erase(reg_id)) {
+          self->DeallocReg(reg_id);
+        }
+      }
+    }
+  }
 };
 
 DRef BcastSessionObj::GetGlobalFunc(const std::string& name) {
@@ -52,12 +77,14 @@ DRef BcastSessionObj::GetGlobalFunc(const std::string& name) {
 }
 
 void BcastSessionObj::CopyFromWorker0(const Tensor& host_array, const DRef& remote_array) {
+  BcastSessionObj::Internal::CheckNotRecording(this, "CopyFromWorker0");
   this->AppendHostTensor(host_array);
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kCopyFromWorker0,
                                                remote_array->reg_id);
 }
 
 void BcastSessionObj::CopyToWorker0(const Tensor& host_array, const DRef& remote_array) {
+  BcastSessionObj::Internal::CheckNotRecording(this, "CopyToWorker0");
   this->AppendHostTensor(host_array);
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kCopyToWorker0,
                                                remote_array->reg_id);
@@ -75,6 +102,7 @@ void BcastSessionObj::InitCCL(ffi::String ccl, ffi::Shape device_ids) {
 }
 
 void BcastSessionObj::SyncWorker(int worker_id) {
+  BcastSessionObj::Internal::CheckNotRecording(this, "SyncWorker");
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kSyncWorker, worker_id);
   ffi::PackedArgs args = this->RecvReplyPacked(worker_id);
   ICHECK_EQ(args.size(), 2);
@@ -96,13 +124,92 @@ DRef BcastSessionObj::CallWithPacked(const ffi::PackedArgs& args) {
     args_vec[1] = reg_id;
     args_vec[2] = func->reg_id;
   }
-  this->BroadcastPacked(ffi::PackedArgs(args_vec, args.size()));
+  if (this->recording_ != nullptr) {
+    // Record the call, and pin every register it touches so that they are not reused while the
+    // command buffer is alive.
+    this->recording_->messages.emplace_back(args_vec, args_vec + args.size());
+    BcastSessionObj::Internal::PinReg(this, reg_id);
+    BcastSessionObj::Internal::PinReg(this, args[2].cast<int64_t>());
+    for (int i = 3; i < args.size(); ++i) {
+      if (const auto* dref = args[i].as<DRefObj>()) {
+        BcastSessionObj::Internal::PinReg(this, dref->reg_id);
+      }
+    }
+  } else {
+    this->BroadcastPacked(ffi::PackedArgs(args_vec, args.size()));
+  }
   return BcastSessionObj::Internal::MakeDRef(reg_id, ffi::GetRef<Session>(this));
 }
 
 void BcastSessionObj::DeallocReg(int reg_id) {
+  if (this->pinned_regs_.count(reg_id)) {
+    // Still used by a command buffer, which kills the register when it is released.
+    this->released_pinned_regs_.insert(reg_id);
+    return;
+  }
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kKillReg, reg_id);
   this->free_regs_.push_back(reg_id);
+  auto it = this->command_buffers_.find(reg_id);
+  if (it != this->command_buffers_.end()) {
+    std::vector<int64_t> used_regs = std::move(it->second.used_regs);
+    this->command_buffers_.erase(it);
+    BcastSessionObj::Internal::UnpinRegs(this, used_regs);
+  }
+}
+
+ffi::Array<DRef> BcastSessionObj::BeginCommandBuffer(int num_placeholders) {
+  CHECK(this->recording_ == nullptr) << "ValueError: A command buffer is already being recorded";
+  CHECK_GE(num_placeholders, 0);
+  this->recording_ = std::make_unique<CommandBufferRecord>();
+  ffi::Array<DRef> placeholders;
+  for (int i = 0; i < num_placeholders; ++i) {
+    int reg_id = AllocateReg();
+    this->recording_->placeholders.push_back(reg_id);
+    BcastSessionObj::Internal::PinReg(this, reg_id);
+    placeholders.push_back(
+        BcastSessionObj::Internal::MakeDRef(reg_id, ffi::GetRef<Session>(this)));
+  }
+  return placeholders;
+}
+
+DRef BcastSessionObj::EndCommandBuffer() {
+  CHECK(this->recording_ != nullptr) << "ValueError: No command buffer is being recorded";
+  std::unique_ptr<CommandBufferRecord> record = std::move(this->recording_);
+  int reg_id = AllocateReg();
+  // The calling convention: [action, reg_id, num_placeholders, placeholders...,
+  //                          num_messages, (num_args, args...)...]
+  std::vector<ffi::AnyView> packed_args;
+  packed_args.push_back(static_cast<int>(DiscoAction::kRecordCommandBuffer));
+  packed_args.push_back(reg_id);
+  packed_args.push_back(static_cast<int64_t>(record->placeholders.size()));
+  for (int64_t placeholder : record->placeholders) {
+    packed_args.push_back(placeholder);
+  }
+  packed_args.push_back(static_cast<int64_t>(record->messages.size()));
+  for (const std::vector<ffi::Any>& message : record->messages) {
+    packed_args.push_back(static_cast<int64_t>(message.size()));
+    packed_args.insert(packed_args.end(), message.begin(), message.end());
+  }
+  this->BroadcastPacked(ffi::PackedArgs(packed_args.data(), packed_args.size()));
+  this->command_buffers_[reg_id] = CommandBufferInfo{
+      static_cast<int>(record->placeholders.size()), std::move(record->used_regs)};
+  return BcastSessionObj::Internal::MakeDRef(reg_id, ffi::GetRef<Session>(this));
+}
+
+void BcastSessionObj::ReplayCommandBuffer(const DRef& command_buffer,
+                                          const ffi::PackedArgs& values) {
+  BcastSessionObj::Internal::CheckNotRecording(this, "ReplayCommandBuffer");
+  auto it = this->command_buffers_.find(command_buffer->reg_id);
+  CHECK(it != this->command_buffers_.end())
+      << "ValueError: Register " << command_buffer->reg_id << " is not a command buffer";
+  CHECK_EQ(values.size(), it->second.num_placeholders)
+      << "ValueError: The command buffer expects " << it->second.num_placeholders
+      << " placeholder values, but " << values.size() << " are given";
+  std::vector<ffi::AnyView> packed_args(values.size() + 2);
+  packed_args[0] = static_cast<int>(DiscoAction::kReplayCommandBuffer);
+  packed_args[1] = command_buffer->reg_id;
+  std::copy(values.data(), values.data() + values.size(), packed_args.begin() + 2);
+  this->BroadcastPacked(ffi::PackedArgs(packed_args.data(), packed_args.size()));
 }
 
 int BcastSessionObj::AllocateReg() {
@@ -22,7 +22,10 @@
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/disco/session.h>
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tvm {
@@ -44,6 +47,9 @@ class BcastSessionObj : public SessionObj {
   void InitCCL(ffi::String ccl, IntTuple device_ids) override;
   ffi::Any DebugGetFromRemote(int64_t reg_id, int worker_id) override = 0;
   void DebugSetRegister(int64_t reg_id, ffi::AnyView value, int worker_id) override = 0;
+  ffi::Array<DRef> BeginCommandBuffer(int num_placeholders) override;
+  DRef EndCommandBuffer() override;
+  void ReplayCommandBuffer(const DRef& command_buffer, const ffi::PackedArgs& values) override;
 
  protected:
   /*! \brief Deallocate a register id, kill it on all workers, and append it to `free_regs_`. */
@@ -91,6 +97,31 @@ class BcastSessionObj : public SessionObj {
   /*! \brief The regsiter ids that have been deallocated */
   std::vector<int64_t> free_regs_;
 
+  /*! \brief A command buffer being recorded on the controler side */
+  struct CommandBufferRecord {
+    /*! \brief The placeholder registers */
+    std::vector<int64_t> placeholders;
+    /*! \brief The recorded messages, each in the same format as a broadcast */
+    std::vector<std::vector<ffi::Any>> messages;
+    /*! \brief The registers used by the recorded messages, including the placeholders */
+    std::vector<int64_t> used_regs;
+  };
+  /*! \brief The registers used by a command buffer that has been shipped to workers */
+  struct CommandBufferInfo {
+    /*! \brief The number of placeholder registers */
+    int num_placeholders;
+    /*! \brief The registers pinned by the command buffer */
+    std::vector<int64_t> used_regs;
+  };
+  /*! \brief The command buffer being recorded, or nullptr if not recording */
+  std::unique_ptr<CommandBufferRecord> recording_;
+  /*! \brief The command buffers on workers, keyed by their register ids */
+  std::unordered_map<int64_t, CommandBufferInfo> command_buffers_;
+  /*! \brief The number of command buffers that use each register */
+  std::unordered_map<int64_t, int> pinned_regs_;
+  /*! \brief The pinned registers whose DRef has been released on the controler */
+  std::unordered_set<int64_t> released_pinned_regs_;
+
   struct Internal;
   friend struct Internal;
   friend class SocketSessionObj;
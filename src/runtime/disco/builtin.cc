@@ -23,6 +23,7 @@
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/tracing.h>
 #include <tvm/runtime/vm/vm.h>
 
 #include <sstream>
@@ -80,6 +81,14 @@ ffi::Function GetCCLFunc(const char* name) {
   const auto pf = tvm::ffi::Function::GetGlobal(pf_name);
   CHECK(pf.has_value()) << "ValueError: Cannot find the `" << name << "` function for `" << ccl
                         << "` via `" << pf_name << "`";
+  if (profiling::IsTracing()) {
+    // Record the collective on the timeline of the worker, and of its device if timed there.
+    return ffi::Function::FromPacked(
+        [pf = *pf, name = ffi::String(name)](ffi::PackedArgs args, ffi::Any* rv) {
+          profiling::TraceScope scope("ccl", name, DiscoWorker::ThreadLocal()->default_device);
+          pf.CallPacked(args, rv);
+        });
+  }
   return *pf;
 }
 
@@ -87,10 +96,29 @@ void AllReduce(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv)
   GetCCLFunc("allreduce")(send, static_cast<int>(reduce_kind), in_group, recv);
 }
 
+void AllReduceStart(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv) {
+  GetCCLFunc("allreduce_start")(send, static_cast<int>(reduce_kind), in_group, recv);
+}
+
+Tensor AllReduceWait(Tensor recv, Tensor send) {
+  return GetCCLFunc("allreduce_wait")(recv, send).cast<Tensor>();
+}
+
+void AllReduceQuantized(Tensor send, ReduceKind reduce_kind, bool in_group,
+                        ffi::String quantization, Tensor recv) {
+  GetCCLFunc("allreduce_quantized")(send, static_cast<int>(reduce_kind), in_group, quantization,
+                                    recv);
+}
+
 void AllGather(Tensor send, bool in_group, Tensor recv) {
   GetCCLFunc("allgather")(send, in_group, recv);
 }
 
+void AllToAll(Tensor send, ffi::Shape send_splits, ffi::Shape recv_splits, bool in_group,
+              Tensor recv) {
+  GetCCLFunc("alltoall")(send, send_splits, recv_splits, in_group, recv);
+}
+
 TVM_DLL void BroadcastFromWorker0(Tensor send, bool in_group, Tensor recv) {
   GetCCLFunc("broadcast_from_worker0")(send, in_group, recv);
 }
@@ -117,6 +145,14 @@ void RecvFromWorker(Tensor buffer, int sender_id) {
   GetCCLFunc("recv_from_worker")(buffer, sender_id);
 }
 
+void RingSendRecvStart(Tensor send, int num_workers, bool in_group, Tensor recv) {
+  GetCCLFunc("ring_send_recv_start")(send, num_workers, in_group, recv);
+}
+
+Tensor RingSendRecvWait(Tensor recv, Tensor send) {
+  return GetCCLFunc("ring_send_recv_wait")(recv, send).cast<Tensor>();
+}
+
 int WorkerId() { return DiscoWorker::ThreadLocal()->worker_id; }
 
 void SyncWorker() {
@@ -149,7 +185,22 @@ TVM_FFI_STATIC_INIT_BLOCK() {
              CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
              AllReduce(send, static_cast<ReduceKind>(kind), in_group, recv);
            })
+      .def("runtime.disco.allreduce_start",
+           [](Tensor send, ffi::Shape reduce_kind, bool in_group, Tensor recv) {
+             int kind = IntegerFromShape(reduce_kind);
+             CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+             AllReduceStart(send, static_cast<ReduceKind>(kind), in_group, recv);
+           })
+      .def("runtime.disco.allreduce_wait", AllReduceWait)
+      .def("runtime.disco.allreduce_quantized",
+           [](Tensor send, ffi::Shape reduce_kind, bool in_group, ffi::String quantization,
+              Tensor recv) {
+             int kind = IntegerFromShape(reduce_kind);
+             CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+             AllReduceQuantized(send, static_cast<ReduceKind>(kind), in_group, quantization, recv);
+           })
       .def("runtime.disco.allgather", AllGather)
+      .def("runtime.disco.alltoall", AllToAll)
       .def("runtime.disco.broadcast_from_worker0", BroadcastFromWorker0)
       .def("runtime.disco.scatter_from_worker0", ScatterFromWorker0)
       .def("runtime.disco.gather_to_worker0", GatherToWorker0)
@@ -158,6 +209,8 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def("runtime.disco.recv_from_prev_group", RecvFromPrevGroup)
       .def("runtime.disco.send_to_worker", SendToWorker)
       .def("runtime.disco.recv_from_worker", RecvFromWorker)
+      .def("runtime.disco.ring_send_recv_start", RingSendRecvStart)
+      .def("runtime.disco.ring_send_recv_wait", RingSendRecvWait)
       .def("runtime.disco.worker_id", []() -> ffi::Shape { return ffi::Shape({WorkerId()}); })
       .def("runtime.disco.worker_rank", []() -> int64_t { return WorkerId(); })
       .def("runtime.disco.device",
@@ -68,7 +68,10 @@ std::vector<cudaIpcMemHandle_t> AllGatherIPCHandles(nccl::CCLThreadLocalContext*
  */
 class CUDAIPCMemoryAllocator final : public memory::PooledAllocator {
  public:
-  explicit CUDAIPCMemoryAllocator() : PooledAllocator() {}
+  // IPC allocations are collective, so bypass the thread caches to keep every worker
+  // issuing the same sequence of device allocations.
+  explicit CUDAIPCMemoryAllocator()
+      : PooledAllocator(kDefaultPageSize, /*thread_cache_capacity=*/0) {}
 
   bool AllowMemoryScope(const std::string& mem_scope) const final {
     // The allowed memory scope of CUDAIPCMemory is "ipc_memory";
@@ -20,6 +20,11 @@
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/nvtx.h>
+#include <tvm/runtime/tracing.h>
+
+#include <string>
+#include <unordered_map>
 
 #include "../../support/process_id.h"
 #include "./protocol.h"
@@ -27,6 +32,18 @@
 namespace tvm {
 namespace runtime {
 
+/*! \brief A sequence of recorded calls on a worker, which is replayed as a whole. */
+class DiscoCommandBufferObj : public Object {
+ public:
+  /*! \brief The placeholder registers that are assigned by each replay */
+  std::vector<int64_t> placeholders;
+  /*! \brief The recorded messages, each in the calling convention of `kCallPacked` */
+  std::vector<std::vector<ffi::Any>> commands;
+
+  static constexpr const bool _type_mutable = true;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("runtime.disco.CommandBuffer", DiscoCommandBufferObj, Object);
+};
+
 TVM_DLL DiscoWorker* DiscoWorker::ThreadLocal() {
   DiscoWorker* ret = ThreadLocalDiscoWorker::Get()->worker;
   CHECK(ret) << "ValueError: The current thread is not a DiscoWorker thread";
@@ -49,11 +66,13 @@ void DiscoWorker::SetRegister(int reg_id, ffi::AnyView value) {
 struct DiscoWorker::Impl {
   static void MainLoop(DiscoWorker* self) {
     ThreadLocalDiscoWorker::Get()->worker = self;
+    profiling::SetTraceProcessId(self->worker_id);
     using namespace tvm;
     while (true) {
       ffi::PackedArgs args = self->channel->Recv();
       DiscoAction action = static_cast<DiscoAction>(args[0].cast<int>());
       int64_t reg_id = args[1].cast<int64_t>();
+      TVM_NVTX_OPTIONAL_SCOPE(RangeName(action, args));
       switch (action) {
         case DiscoAction::kShutDown: {
           Shutdown(self);
@@ -61,6 +80,7 @@ struct DiscoWorker::Impl {
         }
         case DiscoAction::kKillReg: {
           GetReg(self, reg_id) = nullptr;
+          FuncNames().erase(reg_id);
           break;
         }
         case DiscoAction::kGetGlobalFunc: {
@@ -73,6 +93,7 @@ struct DiscoWorker::Impl {
           ffi::Function func = GetReg(self, func_reg_id).cast<ffi::Function>();
           CHECK(func.defined());
           CallPacked(self, reg_id, func, args.Slice(3));
+          NameCallResult(reg_id, func_reg_id, args);
           break;
         }
         case DiscoAction::kCopyFromWorker0: {
@@ -98,6 +119,14 @@ struct DiscoWorker::Impl {
           DebugSetRegister(self, reg_id, worker_id, value);
           break;
         }
+        case DiscoAction::kRecordCommandBuffer: {
+          RecordCommandBuffer(self, reg_id, args.Slice(2));
+          break;
+        }
+        case DiscoAction::kReplayCommandBuffer: {
+          ReplayCommandBuffer(self, reg_id, args.Slice(2));
+          break;
+        }
       }
     }
   }
@@ -109,7 +138,39 @@ struct DiscoWorker::Impl {
     CHECK(pf.has_value()) << "ValueError: Cannot find global function: " << name;
     if (reg_id != 0) {
       GetReg(self, reg_id) = *pf;
+      FuncNames()[reg_id] = name;
+    }
+  }
+
+  /*!
+   * \brief The names of the functions in the registers of the worker thread, which name the NVTX
+   * ranges of their calls: the global functions, and the functions of the modules.
+   */
+  static std::unordered_map<int64_t, std::string>& FuncNames() {
+    static thread_local std::unordered_map<int64_t, std::string> names;
+    return names;
+  }
+
+  /*! \brief The name of the NVTX range of an action, the callee of the calls. */
+  static std::string RangeName(DiscoAction action, const ffi::PackedArgs& args) {
+    if (action == DiscoAction::kCallPacked) {
+      auto it = FuncNames().find(args[2].cast<int64_t>());
+      if (it != FuncNames().end()) return "Disco: " + it->second;
     }
+    return "Disco: " + DiscoAction2String(action);
+  }
+
+  /*! \brief Name the register a call returned to, if it got a function of a module. */
+  static void NameCallResult(int64_t ret_reg_id, int64_t func_reg_id,
+                             const ffi::PackedArgs& args) {
+    auto it = FuncNames().find(func_reg_id);
+    if (it != FuncNames().end() && it->second == "ffi.ModuleGetFunction" && args.size() > 4) {
+      if (auto name = args[4].try_cast<ffi::String>()) {
+        FuncNames()[ret_reg_id] = *name;
+        return;
+      }
+    }
+    FuncNames().erase(ret_reg_id);
   }
 
   static Tensor GetTensorFromHost(DiscoWorker* self) {
@@ -166,6 +227,51 @@ struct DiscoWorker::Impl {
     }
   }
 
+  static void RecordCommandBuffer(DiscoWorker* self, int64_t reg_id, const ffi::PackedArgs& args) {
+    ObjectPtr<DiscoCommandBufferObj> buffer = ffi::make_object<DiscoCommandBufferObj>();
+    int i = 0;
+    int64_t num_placeholders = args[i++].cast<int64_t>();
+    for (int64_t j = 0; j < num_placeholders; ++j) {
+      buffer->placeholders.push_back(args[i++].cast<int64_t>());
+    }
+    int64_t num_commands = args[i++].cast<int64_t>();
+    for (int64_t j = 0; j < num_commands; ++j) {
+      int num_args = args[i++].cast<int>();
+      // Copy the arguments, as the packed sequence only lives until the next message
+      buffer->commands.emplace_back(args.data() + i, args.data() + i + num_args);
+      i += num_args;
+    }
+    ICHECK_EQ(i, args.size());
+    GetReg(self, reg_id) = ObjectRef(std::move(buffer));
+  }
+
+  static void ReplayCommandBuffer(DiscoWorker* self, int64_t reg_id,
+                                  const ffi::PackedArgs& values) {
+    // Hold the buffer, as the register file may be resized by the calls
+    ffi::Any buffer_ref = GetReg(self, reg_id);
+    const auto* buffer = buffer_ref.as<DiscoCommandBufferObj>();
+    CHECK(buffer != nullptr) << "ValueError: Register " << reg_id << " is not a command buffer";
+    ICHECK_EQ(values.size(), buffer->placeholders.size());
+    for (int i = 0; i < values.size(); ++i) {
+      ffi::Any value = values[i];
+      if (const auto* dref = values[i].as<DRefObj>()) {
+        value = GetReg(self, dref->reg_id);
+      }
+      GetReg(self, buffer->placeholders[i]) = std::move(value);
+    }
+    std::vector<ffi::AnyView> args_vec;
+    for (const std::vector<ffi::Any>& command : buffer->commands) {
+      args_vec.assign(command.begin(), command.end());
+      ffi::PackedArgs args(args_vec.data(), args_vec.size());
+      ICHECK(static_cast<DiscoAction>(args[0].cast<int>()) == DiscoAction::kCallPacked);
+      TVM_NVTX_OPTIONAL_SCOPE(RangeName(DiscoAction::kCallPacked, args));
+      ffi::Function func = GetReg(self, args[2].cast<int>()).cast<ffi::Function>();
+      CHECK(func.defined());
+      CallPacked(self, args[1].cast<int64_t>(), func, args.Slice(3));
+      NameCallResult(args[1].cast<int64_t>(), args[2].cast<int64_t>(), args);
+    }
+  }
+
   static void CallPacked(DiscoWorker* self, int64_t ret_reg_id, ffi::Function func,
                          const ffi::PackedArgs& args) {
     // NOTE: this action is not safe unless we know args is not
@@ -50,11 +50,13 @@ class DiscoWorkerThread {
    * \param num_groups The total number of worker groups.
    * \param worker_zero_data_ The data shared between worker-0 and the controler. It's a nullptr if
    * the worker is not worker-0.
+   * \param spin_queue Whether the messages go through lock-free queues that the receivers spin on
+   * before they park, instead of queues guarded by a mutex.
    * \note This method is implemented in threaded worker, because it depends on creation of a
    * sub-class of DiscoChannel, DiscoThreadChannel, which is hidden from the public interface.
    */
   explicit DiscoWorkerThread(int worker_id, int num_workers, int num_groups,
-                             WorkerZeroData* worker_zero_data_);
+                             WorkerZeroData* worker_zero_data_, bool spin_queue = false);
 
   /*! \brief Move constructor. */
   explicit DiscoWorkerThread(DiscoWorkerThread&& other)
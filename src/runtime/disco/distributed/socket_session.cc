@@ -83,6 +83,8 @@ class SocketSessionObj : public BcastSessionObj {
     for (int i = 0; i + 1 < num_nodes; ++i) {
       SockAddr addr;
       remote_sockets_.push_back(socket_.Accept(&addr));
+      // Each command is a small packet that the remote node waits for, so do not coalesce them.
+      remote_sockets_.back().SetNoDelay(true);
       remote_channels_.emplace_back(std::make_unique<DiscoSocketChannel>(remote_sockets_.back()));
       packed_args[3] = i + 1;
       // Send metadata to each remote node:
@@ -218,6 +220,7 @@ class RemoteSocketSession {
       LOG(FATAL) << "Failed to connect to server " << server_addr.AsString()
                  << ", errno = " << Socket::GetLastErrorCode();
     }
+    socket_.SetNoDelay(true);
     channel_ = std::make_unique<DiscoSocketChannel>(socket_);
     ffi::PackedArgs metadata = channel_->Recv();
     ICHECK_EQ(metadata.size(), 4);
@@ -24,10 +24,23 @@
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/vm/tensor_cache_support.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef TVM_CUFILE_ENABLED
+#include <cufile.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -113,6 +126,220 @@ std::unordered_map<std::string, ShardInfo> LoadShardInfoFromStr(const std::strin
   return result;
 }
 
+/*!
+ * \brief Name of the builtin shard function that splits a tensor along its leading dimension.
+ *
+ * The output of this shard function is the input reshaped to `[num_shards, ...]`, so the slice
+ * kept by each worker is a contiguous byte range of the parameter. When it is the only shard
+ * function of a parameter, every worker reads its own byte range from disk instead of having
+ * worker 0 read the entire parameter and scatter it.
+ */
+constexpr const char* kShardLeadingDimFunc = "runtime.disco.shard_leading_dim";
+
+/*!
+ * \brief Reads byte ranges of parameter shards from disk.
+ *
+ * When built with cuFile (GPUDirect Storage), raw parameters on CUDA devices are read from the
+ * file into device memory directly. Otherwise, the range is read with `pread` into a host
+ * buffer, which is pinned when the device supports it, and copied to the device from there.
+ * Either way, only the requested bytes are read rather than the whole shard file.
+ */
+class ShardRangeReader {
+ public:
+  ShardRangeReader() = default;
+  ShardRangeReader(const ShardRangeReader&) = delete;
+  ShardRangeReader& operator=(const ShardRangeReader&) = delete;
+  ~ShardRangeReader() { Close(); }
+
+  /*!
+   * \brief Load a slice of a parameter.
+   * \param file_name The shard file that holds the parameter.
+   * \param param The parameter to load from.
+   * \param shape The shape of the slice.
+   * \param begin The offset of the slice in bytes, relative to the start of the parameter.
+   * \param nbytes The number of bytes of the slice, as stored in the file.
+   * \param device The device to load the slice onto.
+   * \return The loaded slice.
+   */
+  Tensor Load(const std::string& file_name, const ParamRecord& param, ffi::Shape shape,
+              int64_t begin, int64_t nbytes, Device device) {
+    Open(file_name);
+    int64_t file_offset = param.byte_offset + begin;
+    bool is_raw = !(param.dtype == DataType::Float(32) && param.format == "f32-to-bf16");
+#ifdef TVM_CUFILE_ENABLED
+    if (is_raw && device.device_type == kDLCUDA && cufile_registered_) {
+      Tensor arr = Tensor::Empty(shape, param.dtype, device);
+      ICHECK_EQ(GetDataSize(*arr.operator->()), nbytes);
+      if (ReadToDevice(arr, file_offset, nbytes)) {
+        return arr;
+      }
+    }
+#endif
+    if (is_raw && device.device_type == kDLCPU) {
+      Tensor arr = Tensor::Empty(shape, param.dtype, device);
+      ICHECK_EQ(GetDataSize(*arr.operator->()), nbytes);
+      ReadToHost(static_cast<char*>(arr->data) + arr->byte_offset, file_offset, nbytes);
+      return arr;
+    }
+    char* buffer = GetHostBuffer(nbytes, device);
+    ReadToHost(buffer, file_offset, nbytes);
+    ParamRecord slice = param;
+    slice.shape = shape;
+    slice.nbytes = nbytes;
+    slice.byte_offset = 0;
+    return slice.LoadFromBuffer(device, buffer, &opencl_staging_buffer_);
+  }
+
+ private:
+  void Open(const std::string& file_name) {
+    if (file_name == file_name_) {
+      return;
+    }
+    Close();
+#ifndef _WIN32
+    fd_ = open(file_name.c_str(), O_RDONLY);
+    CHECK_NE(fd_, -1) << "ValueError: Cannot open file " << file_name << ": "
+                      << std::strerror(errno);
+#else
+    stream_.open(file_name, std::ios::in | std::ios::binary);
+    CHECK(stream_.is_open()) << "ValueError: Cannot open file " << file_name;
+#endif
+    file_name_ = file_name;
+#ifdef TVM_CUFILE_ENABLED
+    RegisterCuFile();
+#endif
+  }
+
+  void Close() {
+#ifdef TVM_CUFILE_ENABLED
+    if (cufile_registered_) {
+      cuFileHandleDeregister(cufile_handle_);
+      cufile_registered_ = false;
+    }
+    if (direct_fd_ != -1) {
+      close(direct_fd_);
+      direct_fd_ = -1;
+    }
+#endif
+#ifndef _WIN32
+    if (fd_ != -1) {
+      close(fd_);
+      fd_ = -1;
+    }
+#else
+    if (stream_.is_open()) {
+      stream_.close();
+    }
+#endif
+    file_name_.clear();
+  }
+
+  void ReadToHost(char* dst, int64_t file_offset, int64_t nbytes) {
+#ifndef _WIN32
+    while (nbytes > 0) {
+      ssize_t n = pread(fd_, dst, nbytes, file_offset);
+      if (n == -1 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        LOG(FATAL) << "ValueError: Failed to read " << nbytes << " bytes at offset "
+                   << file_offset << " of " << file_name_ << ": "
+                   << (n == 0 ? "unexpected end of file" : std::strerror(errno))
+                   << ". It means the file is not downloaded completely or downloading is "
+                      "interrupted. Please try to download again.";
+      }
+      dst += n;
+      file_offset += n;
+      nbytes -= n;
+    }
+#else
+    stream_.clear();
+    stream_.seekg(file_offset, std::ios::beg);
+    stream_.read(dst, nbytes);
+    CHECK(stream_.good()) << "ValueError: Failed to read " << nbytes << " bytes at offset "
+                          << file_offset << " of " << file_name_;
+#endif
+  }
+
+  /*! \brief Get a host buffer of at least `nbytes` bytes, pinned if the device supports it. */
+  char* GetHostBuffer(int64_t nbytes, Device device) {
+    Device host_device = GetPreferredHostDevice(device);
+    if (!host_buffer_.defined() || host_buffer_->device.device_type != host_device.device_type ||
+        host_buffer_->shape[0] < nbytes) {
+      host_buffer_ = std::nullopt;
+      host_buffer_ = Tensor::Empty({nbytes}, DataType::UInt(8), host_device);
+    }
+    return static_cast<char*>(host_buffer_.value()->data) + host_buffer_.value()->byte_offset;
+  }
+
+#ifdef TVM_CUFILE_ENABLED
+  /*! \brief Open the cuFile driver for the process, returns whether it is usable. */
+  static bool CuFileDriverReady() {
+    static bool ready = []() {
+      CUfileError_t status = cuFileDriverOpen();
+      if (status.err != CU_FILE_SUCCESS) {
+        LOG(WARNING) << "cuFile driver is unavailable (error " << status.err
+                     << "), falling back to reading parameters through host memory";
+        return false;
+      }
+      return true;
+    }();
+    return ready;
+  }
+
+  void RegisterCuFile() {
+    if (!CuFileDriverReady()) {
+      return;
+    }
+    direct_fd_ = open(file_name_.c_str(), O_RDONLY | O_DIRECT);
+    if (direct_fd_ == -1) {
+      return;
+    }
+    CUfileDescr_t descr;
+    std::memset(&descr, 0, sizeof(descr));
+    descr.handle.fd = direct_fd_;
+    descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+    CUfileError_t status = cuFileHandleRegister(&cufile_handle_, &descr);
+    cufile_registered_ = status.err == CU_FILE_SUCCESS;
+  }
+
+  /*! \brief Read into device memory with cuFile, returns false if the read fails. */
+  bool ReadToDevice(const Tensor& arr, int64_t file_offset, int64_t nbytes) {
+    int64_t done = 0;
+    while (done < nbytes) {
+      ssize_t n = cuFileRead(cufile_handle_, arr->data, nbytes - done, file_offset + done,
+                             arr->byte_offset + done);
+      if (n <= 0) {
+        return false;
+      }
+      done += n;
+    }
+    return true;
+  }
+
+  /*! \brief The file opened with O_DIRECT for cuFile */
+  int direct_fd_ = -1;
+  /*! \brief The cuFile handle of the opened file */
+  CUfileHandle_t cufile_handle_;
+  /*! \brief Whether the opened file is registered to cuFile */
+  bool cufile_registered_ = false;
+#endif
+
+  /*! \brief The name of the opened file */
+  std::string file_name_;
+#ifndef _WIN32
+  /*! \brief The descriptor of the opened file */
+  int fd_ = -1;
+#else
+  /*! \brief The stream of the opened file */
+  std::ifstream stream_;
+#endif
+  /*! \brief The host buffer that byte ranges are read into */
+  ffi::Optional<Tensor> host_buffer_;
+  /*! \brief The staging buffer to avoid extra OpenCL copies */
+  ffi::Optional<Tensor> opencl_staging_buffer_;
+};
+
 /*! \brief An object that helps to load parameters in shards. */
 class ShardLoaderObj : public Object {
  public:
@@ -154,10 +381,8 @@ class ShardLoaderObj : public Object {
   std::vector<ParamInfo> param_info_;
   /*! \brief Maps the name of a shard to its index */
   std::unordered_map<std::string, int> param_name_to_index_;
-  /*! \brief The current file opened to load weights in it */
-  mutable const FileRecord* current_file_;
-  /*! \brief The context of the current file to be loaded from */
-  mutable std::string current_file_stream_;
+  /*! \brief The reader of parameter byte ranges from the shard files */
+  mutable std::unique_ptr<ShardRangeReader> reader_;
 
  private:
   /*! \brief Load the i-th parameter without post-processing
@@ -171,6 +396,16 @@ class ShardLoaderObj : public Object {
    * \returns The full tensor at the specified index
    */
   Tensor LoadDirect(int weight_index) const;
+
+  /*!
+   * \brief Load the slice of the i-th parameter kept by this worker, reading only its bytes.
+   *
+   * Only valid for parameters sharded by `kShardLeadingDimFunc` alone.
+   */
+  Tensor LoadLocalSlice(int weight_index) const;
+
+  /*! \brief Whether each worker can read its slice of the i-th parameter by itself */
+  bool IsLeadingDimShard(int weight_index) const;
 };
 
 ObjectRef ShardLoaderObj::Create(const std::string& path_to_metadata, const std::string& metadata,
@@ -182,7 +417,7 @@ ObjectRef ShardLoaderObj::Create(const std::string& path_to_metadata, const std:
   }
   ObjectPtr<ShardLoaderObj> n = ffi::make_object<ShardLoaderObj>();
   n->metadata_ = TensorCacheMetadata::LoadFromStr(metadata, path_to_metadata);
-  n->current_file_ = nullptr;
+  n->reader_ = std::make_unique<ShardRangeReader>();
   n->param_info_.clear();
   std::unordered_map<std::string, ShardInfo> shards = LoadShardInfoFromStr(shard_info);
   for (const FileRecord& file_record : n->metadata_.records) {
@@ -242,19 +477,9 @@ Tensor ShardLoaderObj::LoadParamOnWorker0(int weight_index) const {
   int param_index = param_name_to_index_.at("param_" + std::to_string(weight_index));
   const ParamInfo& param_info = param_info_.at(param_index);
   const ParamRecord* param = param_info.param;
-  const FileRecord* file = param_info.file;
-
-  auto load = [this, param, device, file]() {
-    if (file != current_file_) {
-      current_file_ = file;
-      std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-      LoadBinaryFromFile(file_name, &this->current_file_stream_);
-    }
-    return param->Load(device, &this->current_file_stream_);
-  };
 
   if (worker_id == 0) {
-    Tensor w = load();
+    Tensor w = LoadDirect(param_index);
     return w;
   } else {
     Tensor w = Tensor::Empty(param->shape, param->dtype, device);
@@ -292,12 +517,37 @@ Tensor ShardLoaderObj::LoadDirect(int weight_index) const {
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
   Device device = worker->default_device;
 
-  if (file != current_file_) {
-    current_file_ = file;
-    std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-    LoadBinaryFromFile(file_name, &this->current_file_stream_);
+  std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
+  return reader_->Load(file_name, *param, param->shape, 0, param->nbytes, device);
+}
+
+bool ShardLoaderObj::IsLeadingDimShard(int weight_index) const {
+  const ParamInfo& param_info = param_info_.at(weight_index);
+  const std::vector<ShardInfo::ShardFunc>& funcs = param_info.shard_info.funcs;
+  if (funcs.size() != 1 || funcs[0].name != kShardLeadingDimFunc) {
+    return false;
   }
-  return param->Load(device, &this->current_file_stream_);
+  const ffi::Shape& shape = funcs[0].output_info.shape;
+  return shape.size() >= 1 && param_info.param->nbytes % shape[0] == 0;
+}
+
+Tensor ShardLoaderObj::LoadLocalSlice(int weight_index) const {
+  const ParamInfo& param_info = param_info_.at(weight_index);
+  const ParamRecord* param = param_info.param;
+  const FileRecord* file = param_info.file;
+  const ShardInfo::TensorInfo& output_info = param_info.shard_info.funcs[0].output_info;
+  CHECK(output_info.dtype == param->dtype)
+      << "ValueError: " << kShardLeadingDimFunc << " cannot change the dtype of " << param->name
+      << " from " << param->dtype << " to " << output_info.dtype;
+
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  Device device = worker->default_device;
+  int64_t slice_nbytes = param->nbytes / output_info.shape[0];
+
+  std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
+  return reader_->Load(file_name, *param,
+                       ffi::Shape(output_info.shape.begin() + 1, output_info.shape.end()),
+                       slice_nbytes * worker->worker_id, slice_nbytes, device);
 }
 
 Tensor ShardLoaderObj::Load(int weight_index) const {
@@ -316,6 +566,9 @@ Tensor ShardLoaderObj::Load(int weight_index) const {
         << "ValueError: The first dimension of the "
         << "output shape must be equal to the "
         << "number of shards, but got: " << shape << " and num_shards = " << num_shards;
+    if (IsLeadingDimShard(weight_index)) {
+      return LoadLocalSlice(weight_index);
+    }
     Tensor recv = Tensor::Empty(ffi::Shape(shape.begin() + 1, shape.end()), dtype, device);
     if (worker_id == 0) {
       Tensor w = LoadDirect(weight_index);
@@ -405,6 +658,13 @@ ffi::Array<Tensor> ShardLoaderObj::LoadAllPresharded() const {
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
+      .def(kShardLeadingDimFunc,
+           [](Tensor src, int64_t num_shards, Tensor tgt) {
+             CHECK(src.Shape().size() >= 1 && src.Shape()[0] % num_shards == 0)
+                 << "ValueError: Cannot split the leading dimension of shape " << src.Shape()
+                 << " into " << num_shards << " shards";
+             tgt.CopyFrom(src.CreateView(tgt.Shape(), tgt->dtype));
+           })
       .def("runtime.disco.ShardLoader", ShardLoaderObj::Create)
       .def("runtime.disco.ShardLoaderLoad",
            [](ObjectRef loader_obj, ffi::Shape weight_index) {
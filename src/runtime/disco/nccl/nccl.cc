@@ -116,11 +116,11 @@ void InitCCLPerWorker(ffi::Shape device_ids, std::string unique_id_bytes) {
   }
 }
 
-void AllReduce(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv) {
+void AllReduceOnStream(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv,
+                       deviceStream_t stream) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ffi::Shape shape = send.Shape();
   int64_t numel = shape->Product();
-  deviceStream_t stream = ctx->GetDefaultStream();
   DataType dtype = DataType(send->dtype);
   if (dtype == DataType::Float8E4M3FN() || dtype == DataType::Float8E5M2()) {
     LOG(FATAL) << "Float8 data type cannot be allreduced, as nccl does not support this data type.";
@@ -131,6 +131,43 @@ void AllReduce(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv)
                           in_group ? ctx->group_comm : ctx->global_comm, stream));
 }
 
+void AllReduce(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv) {
+  AllReduceOnStream(send, reduce_kind, in_group, recv,
+                    CCLThreadLocalContext::Get()->GetDefaultStream());
+}
+
+void AllReduceStart(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  CHECK(!ctx->pending_events.count(recv->data))
+      << "ValueError: An allreduce into buffer " << recv->data << " is already pending";
+  deviceStream_t compute_stream = ctx->GetDefaultStream();
+  deviceStream_t comm_stream = ctx->GetCommStream();
+  // The allreduce starts after the work that produces `send` on the compute stream. The event can
+  // be recycled right away, as the wait is bound to the work recorded so far.
+  deviceEvent_t send_ready = ctx->AcquireEvent();
+  EventRecord(send_ready, compute_stream);
+  StreamWaitEvent(comm_stream, send_ready);
+  ctx->ReleaseEvent(send_ready);
+  AllReduceOnStream(send, reduce_kind, in_group, recv, comm_stream);
+  deviceEvent_t recv_ready = ctx->AcquireEvent();
+  EventRecord(recv_ready, comm_stream);
+  ctx->pending_events.emplace(recv->data, recv_ready);
+}
+
+/*! \brief Make the compute stream wait for the pending communication into `recv`. */
+Tensor WaitPendingRecv(Tensor recv, const char* name) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  auto it = ctx->pending_events.find(recv->data);
+  CHECK(it != ctx->pending_events.end())
+      << "ValueError: No " << name << " into buffer " << recv->data << " is pending";
+  StreamWaitEvent(ctx->GetDefaultStream(), it->second);
+  ctx->ReleaseEvent(it->second);
+  ctx->pending_events.erase(it);
+  return recv;
+}
+
+Tensor AllReduceWait(Tensor recv, Tensor send) { return WaitPendingRecv(recv, "allreduce"); }
+
 void AllGather(Tensor send, bool in_group, Tensor recv) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ffi::Shape shape = send.Shape();
@@ -141,6 +178,70 @@ void AllGather(Tensor send, bool in_group, Tensor recv) {
                           in_group ? ctx->group_comm : ctx->global_comm, stream));
 }
 
+/*!
+ * \brief Get the number of rows exchanged with each peer, checking they cover the buffer.
+ * \param splits The rows of each peer, or an empty shape for even splits.
+ */
+std::vector<int64_t> GetAllToAllSplits(const Tensor& buffer, const ffi::Shape& splits,
+                                       int num_peers, const char* name) {
+  CHECK_GE(buffer->ndim, 1) << "ValueError: buffer `" << name << "` of alltoall must not be 0-d";
+  int64_t num_rows = buffer->shape[0];
+  if (splits.empty()) {
+    CHECK_EQ(num_rows % num_peers, 0)
+        << "ValueError: Splitting `" << name << "` evenly requires its first dimension to be "
+        << "divisible by the number of workers, but got " << num_rows << " rows and "
+        << num_peers << " workers.";
+    return std::vector<int64_t>(num_peers, num_rows / num_peers);
+  }
+  CHECK_EQ(static_cast<int>(splits.size()), num_peers)
+      << "ValueError: The splits of `" << name << "` must have one entry per worker, but got "
+      << splits.size() << " entries and " << num_peers << " workers.";
+  std::vector<int64_t> result(splits.begin(), splits.end());
+  int64_t total = 0;
+  for (int64_t rows : result) {
+    CHECK_GE(rows, 0) << "ValueError: The splits of `" << name << "` must be non-negative";
+    total += rows;
+  }
+  CHECK_LE(total, num_rows) << "ValueError: The splits of `" << name << "` have " << total
+                            << " rows in total, more than the " << num_rows << " rows of it.";
+  return result;
+}
+
+void AllToAll(Tensor send, ffi::Shape send_splits, ffi::Shape recv_splits, bool in_group,
+              Tensor recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int num_workers = ctx->worker->num_workers;
+  int num_peers = in_group ? num_workers / ctx->worker->num_groups : num_workers;
+  CHECK(send.DataType() == recv.DataType())
+      << "ValueError: The buffers of alltoall must have the same dtype";
+  std::vector<int64_t> send_rows = GetAllToAllSplits(send, send_splits, num_peers, "send");
+  std::vector<int64_t> recv_rows = GetAllToAllSplits(recv, recv_splits, num_peers, "recv");
+  int64_t send_row_numel = send->shape[0] == 0 ? 0 : send.Shape()->Product() / send->shape[0];
+  int64_t recv_row_numel = recv->shape[0] == 0 ? 0 : recv.Shape()->Product() / recv->shape[0];
+  if (send->shape[0] != 0 && recv->shape[0] != 0) {
+    CHECK_EQ(send_row_numel, recv_row_numel)
+        << "ValueError: The rows of the buffers of alltoall must have the same size";
+  }
+  DataType dtype = send.DataType();
+  ncclDataType_t nccl_dtype = AsNCCLDataType(dtype);
+  ncclComm_t comm = in_group ? ctx->group_comm : ctx->global_comm;
+  deviceStream_t stream = ctx->GetDefaultStream();
+  uint8_t* send_data = static_cast<uint8_t*>(send->data);
+  uint8_t* recv_data = static_cast<uint8_t*>(recv->data);
+  NCCL_CALL(ncclGroupStart());
+  for (int i = 0; i < num_peers; ++i) {
+    if (send_rows[i] > 0) {
+      NCCL_CALL(ncclSend(send_data, send_rows[i] * send_row_numel, nccl_dtype, i, comm, stream));
+    }
+    if (recv_rows[i] > 0) {
+      NCCL_CALL(ncclRecv(recv_data, recv_rows[i] * recv_row_numel, nccl_dtype, i, comm, stream));
+    }
+    send_data += send_rows[i] * send_row_numel * dtype.bytes();
+    recv_data += recv_rows[i] * recv_row_numel * dtype.bytes();
+  }
+  NCCL_CALL(ncclGroupEnd());
+}
+
 void BroadcastFromWorker0(ffi::Optional<Tensor> send, bool in_group, Tensor recv) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   int worker_id = ctx->worker->worker_id;
@@ -320,11 +421,47 @@ void RecvFromWorker(Tensor buffer, int sender_id) {
                      sender_id, ctx->global_comm, stream));
 }
 
+void RingSendRecvStart(Tensor send, int num_workers, bool in_group, Tensor recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int group_size = ctx->worker->num_workers / ctx->worker->num_groups;
+  int ring_size = in_group ? group_size : ctx->worker->num_workers;
+  CHECK_EQ(num_workers, ring_size) << "ValueError: The ring has " << num_workers
+                                   << " workers, but the " << (in_group ? "group" : "session")
+                                   << " has " << ring_size << " workers";
+  CHECK(!ctx->pending_events.count(recv->data))
+      << "ValueError: A ring exchange into buffer " << recv->data << " is already pending";
+  int rank = in_group ? ctx->worker->worker_id % group_size : ctx->worker->worker_id;
+  ncclComm_t comm = in_group ? ctx->group_comm : ctx->global_comm;
+  deviceStream_t compute_stream = ctx->GetDefaultStream();
+  deviceStream_t comm_stream = ctx->GetCommStream();
+  deviceEvent_t send_ready = ctx->AcquireEvent();
+  EventRecord(send_ready, compute_stream);
+  StreamWaitEvent(comm_stream, send_ready);
+  ctx->ReleaseEvent(send_ready);
+  // The send and the receive are grouped, so that all the workers of the ring progress together.
+  NCCL_CALL(ncclGroupStart());
+  NCCL_CALL(ncclSend(send->data, send.Shape().Product(), AsNCCLDataType(send.DataType()),
+                     (rank + 1) % ring_size, comm, comm_stream));
+  NCCL_CALL(ncclRecv(recv->data, recv.Shape().Product(), AsNCCLDataType(recv.DataType()),
+                     (rank + ring_size - 1) % ring_size, comm, comm_stream));
+  NCCL_CALL(ncclGroupEnd());
+  deviceEvent_t recv_ready = ctx->AcquireEvent();
+  EventRecord(recv_ready, comm_stream);
+  ctx->pending_events.emplace(recv->data, recv_ready);
+}
+
+Tensor RingSendRecvWait(Tensor recv, Tensor send) {
+  return WaitPendingRecv(recv, "ring exchange");
+}
+
 void SyncWorker() {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ICHECK(ctx->worker != nullptr);
   deviceStream_t stream = ctx->GetDefaultStream();
   StreamSynchronize(stream);
+  if (ctx->comm_stream != nullptr) {
+    StreamSynchronize(ctx->comm_stream);
+  }
 }
 
 TVM_FFI_STATIC_INIT_BLOCK() {
@@ -338,8 +475,15 @@ TVM_FFI_STATIC_INIT_BLOCK() {
              CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
              nccl::AllReduce(send, static_cast<ReduceKind>(kind), in_group, recv);
            })
+      .def("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_start",
+           [](Tensor send, int kind, bool in_group, Tensor recv) {
+             CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+             nccl::AllReduceStart(send, static_cast<ReduceKind>(kind), in_group, recv);
+           })
+      .def("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_wait", AllReduceWait)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".allgather",
            [](Tensor send, bool in_group, Tensor recv) { nccl::AllGather(send, in_group, recv); })
+      .def("runtime.disco." TVM_DISCO_CCL_NAME ".alltoall", AllToAll)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".broadcast_from_worker0", BroadcastFromWorker0)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".scatter_from_worker0", ScatterFromWorker0)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".gather_to_worker0", GatherToWorker0)
@@ -348,6 +492,8 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".recv_from_prev_group", RecvFromPrevGroup)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".send_to_worker", SendToWorker)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".recv_from_worker", RecvFromWorker)
+      .def("runtime.disco." TVM_DISCO_CCL_NAME ".ring_send_recv_start", RingSendRecvStart)
+      .def("runtime.disco." TVM_DISCO_CCL_NAME ".ring_send_recv_wait", RingSendRecvWait)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".sync_worker", SyncWorker)
       .def("runtime.disco." TVM_DISCO_CCL_NAME ".test_send_to_next_group_recv_from_prev_group",
            [](Tensor buffer) {
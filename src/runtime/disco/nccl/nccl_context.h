@@ -26,6 +26,9 @@
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/disco/session.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "../../../support/process_id.h"
 #include "../utils.h"
 
@@ -61,11 +64,25 @@ namespace nccl {
 #define TVM_DISCO_CCL_NAME "nccl"
 
 using deviceStream_t = cudaStream_t;
+using deviceEvent_t = cudaEvent_t;
 const constexpr DLDeviceType TVM_DISCO_DEVICE_TYPE = DLDeviceType::kDLCUDA;
 inline void SetDevice(int device_id) { CUDA_CALL(cudaSetDevice(device_id)); }
 inline void StreamSynchronize(deviceStream_t stream) { CUDA_CALL(cudaStreamSynchronize(stream)); }
 inline void StreamCreate(deviceStream_t* stream) { CUDA_CALL(cudaStreamCreate(stream)); }
+inline void StreamCreateNonBlocking(deviceStream_t* stream) {
+  CUDA_CALL(cudaStreamCreateWithFlags(stream, cudaStreamNonBlocking));
+}
 inline void StreamDestroy(deviceStream_t stream) { CUDA_CALL(cudaStreamDestroy(stream)); }
+inline void EventCreate(deviceEvent_t* event) {
+  CUDA_CALL(cudaEventCreateWithFlags(event, cudaEventDisableTiming));
+}
+inline void EventDestroy(deviceEvent_t event) { CUDA_CALL(cudaEventDestroy(event)); }
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  CUDA_CALL(cudaEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  CUDA_CALL(cudaStreamWaitEvent(stream, event, 0));
+}
 
 #else
 
@@ -73,11 +90,25 @@ inline void StreamDestroy(deviceStream_t stream) { CUDA_CALL(cudaStreamDestroy(s
 #define TVM_DISCO_CCL_NAME "rccl"
 
 using deviceStream_t = hipStream_t;
+using deviceEvent_t = hipEvent_t;
 const constexpr DLDeviceType TVM_DISCO_DEVICE_TYPE = DLDeviceType::kDLROCM;
 inline void SetDevice(int device_id) { ROCM_CALL(hipSetDevice(device_id)); }
 inline void StreamSynchronize(deviceStream_t stream) { ROCM_CALL(hipStreamSynchronize(stream)); }
 inline void StreamCreate(deviceStream_t* stream) { ROCM_CALL(hipStreamCreate(stream)); }
+inline void StreamCreateNonBlocking(deviceStream_t* stream) {
+  ROCM_CALL(hipStreamCreateWithFlags(stream, hipStreamNonBlocking));
+}
 inline void StreamDestroy(deviceStream_t stream) { ROCM_CALL(hipStreamDestroy(stream)); }
+inline void EventCreate(deviceEvent_t* event) {
+  ROCM_CALL(hipEventCreateWithFlags(event, hipEventDisableTiming));
+}
+inline void EventDestroy(deviceEvent_t event) { ROCM_CALL(hipEventDestroy(event)); }
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  ROCM_CALL(hipEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  ROCM_CALL(hipStreamWaitEvent(stream, event, 0));
+}
 
 #endif
 
@@ -126,6 +157,12 @@ struct CCLThreadLocalContext {
   deviceStream_t default_stream = nullptr;
   ncclComm_t global_comm = nullptr;
   ncclComm_t group_comm = nullptr;
+  /*! \brief The stream of the asynchronous collectives, created on first use */
+  deviceStream_t comm_stream = nullptr;
+  /*! \brief The completion events of the pending asynchronous collectives, keyed by output */
+  std::unordered_map<void*, deviceEvent_t> pending_events;
+  /*! \brief The recycled events */
+  std::vector<deviceEvent_t> free_events;
 
   ~CCLThreadLocalContext() { Clear(); }
 
@@ -145,6 +182,19 @@ struct CCLThreadLocalContext {
       StreamDestroy(default_stream);
       default_stream = nullptr;
     }
+    if (comm_stream) {
+      StreamSynchronize(comm_stream);
+      StreamDestroy(comm_stream);
+      comm_stream = nullptr;
+    }
+    for (const auto& kv : pending_events) {
+      EventDestroy(kv.second);
+    }
+    pending_events.clear();
+    for (deviceEvent_t event : free_events) {
+      EventDestroy(event);
+    }
+    free_events.clear();
     worker = nullptr;
   }
 
@@ -155,6 +205,27 @@ struct CCLThreadLocalContext {
     return stream == nullptr ? default_stream : stream;
   }
 
+  deviceStream_t GetCommStream() {
+    if (comm_stream == nullptr) {
+      // Not synchronized with the legacy default stream, so only the events order the streams
+      StreamCreateNonBlocking(&comm_stream);
+    }
+    return comm_stream;
+  }
+
+  deviceEvent_t AcquireEvent() {
+    if (free_events.empty()) {
+      deviceEvent_t event;
+      EventCreate(&event);
+      return event;
+    }
+    deviceEvent_t event = free_events.back();
+    free_events.pop_back();
+    return event;
+  }
+
+  void ReleaseEvent(deviceEvent_t event) { free_events.push_back(event); }
+
   static CCLThreadLocalContext* Get();
 };
 
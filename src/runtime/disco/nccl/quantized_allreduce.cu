@@ -0,0 +1,288 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file quantized_allreduce.cu
+ * \brief Allreduce that exchanges block-quantized payloads instead of the full-precision data.
+ *
+ *  The input is split into one shard per rank. Each rank quantizes its input with one float
+ *  scale per kQuantBlockSize elements and sends shard j to rank j (reduce-scatter). Rank j
+ *  dequantizes and sums the shards it receives, requantizes the partial sum, and all ranks
+ *  allgather the quantized sums, which are finally dequantized into the output. Both phases
+ *  move one byte per element plus the scales, instead of the element size of the input.
+ */
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#if CUDART_VERSION >= 11080
+#include <cuda_fp8.h>
+#endif
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/tensor.h>
+
+#include <string>
+
+#include "nccl_context.h"
+
+namespace tvm {
+namespace runtime {
+namespace nccl {
+
+namespace {
+
+/*! \brief The number of elements that share one scale. */
+constexpr int kQuantBlockSize = 128;
+
+template <typename T>
+__device__ __forceinline__ float ToFloat(T v) {
+  return static_cast<float>(v);
+}
+template <>
+__device__ __forceinline__ float ToFloat<half>(half v) {
+  return __half2float(v);
+}
+template <>
+__device__ __forceinline__ float ToFloat<__nv_bfloat16>(__nv_bfloat16 v) {
+  return __bfloat162float(v);
+}
+
+template <typename T>
+__device__ __forceinline__ T FromFloat(float v) {
+  return static_cast<T>(v);
+}
+template <>
+__device__ __forceinline__ half FromFloat<half>(float v) {
+  return __float2half(v);
+}
+template <>
+__device__ __forceinline__ __nv_bfloat16 FromFloat<__nv_bfloat16>(float v) {
+  return __float2bfloat16(v);
+}
+
+/*! \brief Symmetric int8 quantization. */
+struct Int8Codec {
+  using Storage = int8_t;
+  static constexpr float kMaxValue = 127.0f;
+  __device__ static Storage Encode(float v) {
+    return static_cast<int8_t>(__float2int_rn(fminf(fmaxf(v, -kMaxValue), kMaxValue)));
+  }
+  __device__ static float Decode(Storage q) { return static_cast<float>(q); }
+};
+
+#if CUDART_VERSION >= 11080
+/*! \brief FP8 (e4m3) quantization. */
+struct Fp8E4M3Codec {
+  using Storage = __nv_fp8_e4m3;
+  static constexpr float kMaxValue = 448.0f;
+  __device__ static Storage Encode(float v) { return __nv_fp8_e4m3(v); }
+  __device__ static float Decode(Storage q) { return static_cast<float>(q); }
+};
+#endif
+
+/*! \brief The absolute maximum of `v` over the thread block. */
+__device__ float BlockAbsMax(float v, float* smem) {
+  smem[threadIdx.x] = fabsf(v);
+  __syncthreads();
+  for (int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+    if (threadIdx.x < stride) {
+      smem[threadIdx.x] = fmaxf(smem[threadIdx.x], smem[threadIdx.x + stride]);
+    }
+    __syncthreads();
+  }
+  return smem[0];
+}
+
+/*! \brief Quantize `v`, the element of this thread, and write the scale of the thread block. */
+template <typename Codec>
+__device__ void QuantizeBlock(float v, int64_t index, typename Codec::Storage* q, float* scales) {
+  __shared__ float smem[kQuantBlockSize];
+  float scale = BlockAbsMax(v, smem) / Codec::kMaxValue;
+  if (threadIdx.x == 0) {
+    scales[blockIdx.x] = scale;
+  }
+  q[index] = Codec::Encode(scale == 0.0f ? 0.0f : v / scale);
+}
+
+/*! \brief Quantize the input, padded with zeros up to the length of `q`. */
+template <typename T, typename Codec>
+__global__ void QuantizeKernel(const T* x, int64_t numel, typename Codec::Storage* q,
+                               float* scales) {
+  int64_t i = static_cast<int64_t>(blockIdx.x) * kQuantBlockSize + threadIdx.x;
+  float v = i < numel ? ToFloat(x[i]) : 0.0f;
+  QuantizeBlock<Codec>(v, i, q, scales);
+}
+
+/*! \brief Sum the shards received from all ranks, and requantize the sum. */
+template <typename Codec>
+__global__ void ReduceRequantizeKernel(const typename Codec::Storage* q_shards,
+                                       const float* scale_shards, int num_ranks,
+                                       int64_t shard_size, typename Codec::Storage* q_sum,
+                                       float* scale_sum) {
+  int64_t i = static_cast<int64_t>(blockIdx.x) * kQuantBlockSize + threadIdx.x;
+  int64_t blocks_per_shard = shard_size / kQuantBlockSize;
+  float acc = 0.0f;
+  for (int r = 0; r < num_ranks; ++r) {
+    acc += Codec::Decode(q_shards[r * shard_size + i]) *
+           scale_shards[r * blocks_per_shard + blockIdx.x];
+  }
+  QuantizeBlock<Codec>(acc, i, q_sum, scale_sum);
+}
+
+/*! \brief Dequantize the gathered sums into the output. */
+template <typename T, typename Codec>
+__global__ void DequantizeKernel(const typename Codec::Storage* q, const float* scales,
+                                 int64_t numel, float post_scale, T* y) {
+  int64_t i = static_cast<int64_t>(blockIdx.x) * kQuantBlockSize + threadIdx.x;
+  if (i < numel) {
+    y[i] = FromFloat<T>(Codec::Decode(q[i]) * scales[i / kQuantBlockSize] * post_scale);
+  }
+}
+
+/*! \brief Get a device buffer of at least `nbytes`, reused across calls on this worker. */
+void* GetWorkspace(int device_id, int64_t nbytes) {
+  thread_local Tensor workspace;
+  if (!workspace.defined() || workspace.Shape()[0] < nbytes) {
+    workspace = Tensor::Empty({nbytes}, DataType::UInt(8), Device{kDLCUDA, device_id});
+  }
+  return workspace->data;
+}
+
+int64_t AlignUp(int64_t value, int64_t align) { return (value + align - 1) / align * align; }
+
+template <typename T, typename Codec>
+void QuantizedAllReduceImpl(const T* send, int64_t numel, bool avg, ncclComm_t comm, T* recv) {
+  using Storage = typename Codec::Storage;
+  static_assert(sizeof(Storage) == 1, "The quantized payload is exchanged as bytes");
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  deviceStream_t stream = ctx->GetDefaultStream();
+  int num_ranks;
+  NCCL_CALL(ncclCommCount(comm, &num_ranks));
+
+  int64_t shard_size = AlignUp((numel + num_ranks - 1) / num_ranks, kQuantBlockSize);
+  int64_t padded_size = shard_size * num_ranks;
+  int64_t blocks_per_shard = shard_size / kQuantBlockSize;
+  int64_t num_blocks = padded_size / kQuantBlockSize;
+
+  // The layout of the workspace. The buffers of the full input are reused for the gathered sums
+  // once the exchange of the first phase is done, as every launch goes to the same stream.
+  constexpr int64_t kAlign = 256;
+  int64_t scales_bytes = AlignUp(num_blocks * sizeof(float), kAlign);
+  int64_t shard_scales_bytes = AlignUp(blocks_per_shard * sizeof(float), kAlign);
+  int64_t payload_bytes = AlignUp(padded_size, kAlign);
+  int64_t shard_payload_bytes = AlignUp(shard_size, kAlign);
+  char* base = static_cast<char*>(GetWorkspace(
+      ctx->device_id, 2 * scales_bytes + shard_scales_bytes + 2 * payload_bytes +
+                          shard_payload_bytes));
+  float* local_scales = reinterpret_cast<float*>(base);
+  float* recv_scales = reinterpret_cast<float*>(base + scales_bytes);
+  float* sum_scales = reinterpret_cast<float*>(base + 2 * scales_bytes);
+  char* payloads = base + 2 * scales_bytes + shard_scales_bytes;
+  Storage* local_q = reinterpret_cast<Storage*>(payloads);
+  Storage* recv_q = reinterpret_cast<Storage*>(payloads + payload_bytes);
+  Storage* sum_q = reinterpret_cast<Storage*>(payloads + 2 * payload_bytes);
+
+  QuantizeKernel<T, Codec>
+      <<<num_blocks, kQuantBlockSize, 0, stream>>>(send, numel, local_q, local_scales);
+
+  // Phase 1: reduce-scatter, by sending shard j of the quantized input to rank j.
+  NCCL_CALL(ncclGroupStart());
+  for (int j = 0; j < num_ranks; ++j) {
+    NCCL_CALL(ncclSend(local_q + j * shard_size, shard_size, ncclInt8, j, comm, stream));
+    NCCL_CALL(ncclRecv(recv_q + j * shard_size, shard_size, ncclInt8, j, comm, stream));
+    NCCL_CALL(ncclSend(local_scales + j * blocks_per_shard, blocks_per_shard, ncclFloat32, j, comm,
+                       stream));
+    NCCL_CALL(ncclRecv(recv_scales + j * blocks_per_shard, blocks_per_shard, ncclFloat32, j, comm,
+                       stream));
+  }
+  NCCL_CALL(ncclGroupEnd());
+  ReduceRequantizeKernel<Codec><<<blocks_per_shard, kQuantBlockSize, 0, stream>>>(
+      recv_q, recv_scales, num_ranks, shard_size, sum_q, sum_scales);
+
+  // Phase 2: allgather the quantized sums into the buffers of the local input.
+  NCCL_CALL(ncclGroupStart());
+  NCCL_CALL(ncclAllGather(sum_q, local_q, shard_size, ncclInt8, comm, stream));
+  NCCL_CALL(ncclAllGather(sum_scales, local_scales, blocks_per_shard, ncclFloat32, comm, stream));
+  NCCL_CALL(ncclGroupEnd());
+  float post_scale = avg ? 1.0f / num_ranks : 1.0f;
+  DequantizeKernel<T, Codec><<<(numel + kQuantBlockSize - 1) / kQuantBlockSize, kQuantBlockSize,
+                               0, stream>>>(local_q, local_scales, numel, post_scale, recv);
+  CUDA_CALL(cudaGetLastError());
+}
+
+template <typename Codec>
+void DispatchDataType(Tensor send, int64_t numel, bool avg, ncclComm_t comm, Tensor recv) {
+  DataType dtype(send->dtype);
+  if (dtype == DataType::Float(32)) {
+    QuantizedAllReduceImpl<float, Codec>(static_cast<const float*>(send->data), numel, avg, comm,
+                                         static_cast<float*>(recv->data));
+  } else if (dtype == DataType::Float(16)) {
+    QuantizedAllReduceImpl<half, Codec>(static_cast<const half*>(send->data), numel, avg, comm,
+                                        static_cast<half*>(recv->data));
+  } else if (dtype == DataType::BFloat(16)) {
+    QuantizedAllReduceImpl<__nv_bfloat16, Codec>(static_cast<const __nv_bfloat16*>(send->data),
+                                                 numel, avg, comm,
+                                                 static_cast<__nv_bfloat16*>(recv->data));
+  } else {
+    LOG(FATAL) << "ValueError: Quantized allreduce only supports float32, float16 and bfloat16, "
+               << "but got " << dtype;
+  }
+}
+
+}  // namespace
+
+void AllReduceQuantized(Tensor send, ReduceKind reduce_kind, bool in_group, Tensor recv,
+                        const std::string& quantization) {
+  CHECK(reduce_kind == ReduceKind::kSum || reduce_kind == ReduceKind::kAvg)
+      << "ValueError: Quantized allreduce only supports sum and avg, but got ReduceKind "
+      << static_cast<int>(reduce_kind);
+  int64_t numel = send.Shape()->Product();
+  CHECK_EQ(numel, recv.Shape()->Product())
+      << "ValueError: The send and recv buffers of allreduce must have the same size";
+  CHECK(send.IsContiguous() && recv.IsContiguous())
+      << "ValueError: Quantized allreduce requires contiguous buffers";
+  if (numel == 0) {
+    return;
+  }
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  ncclComm_t comm = in_group ? ctx->group_comm : ctx->global_comm;
+  bool avg = reduce_kind == ReduceKind::kAvg;
+  if (quantization == "int8") {
+    DispatchDataType<Int8Codec>(send, numel, avg, comm, recv);
+#if CUDART_VERSION >= 11080
+  } else if (quantization == "e4m3") {
+    DispatchDataType<Fp8E4M3Codec>(send, numel, avg, comm, recv);
+#endif
+  } else {
+    LOG(FATAL) << "ValueError: Unsupported allreduce quantization \"" << quantization
+               << "\". The supported ones are \"int8\" and \"e4m3\".";
+  }
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def(
+      "runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_quantized",
+      [](Tensor send, int kind, bool in_group, ffi::String quantization, Tensor recv) {
+        CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+        AllReduceQuantized(send, static_cast<ReduceKind>(kind), in_group, recv, quantization);
+      });
+}
+
+}  // namespace nccl
+}  // namespace runtime
+}  // namespace tvm
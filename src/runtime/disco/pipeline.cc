@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file pipeline.cc
+ * \brief Run the stages of relax.distributed.transform.PartitionPipelineStages over micro-batches,
+ *  with a disco group per stage.
+ */
+#include <tvm/ffi/container/array.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/disco/builtin.h>
+#include <tvm/runtime/disco/disco_worker.h>
+
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+ffi::Array<ffi::Any> RunPipelineStages(ffi::Module vm_module, ffi::String func_name,
+                                       ffi::Array<ffi::Array<ffi::Any>> micro_batches,
+                                       ffi::Array<ffi::Any> params) {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  int group_size = worker->num_workers / worker->num_groups;
+  int stage = worker->worker_id / group_size;
+  bool is_last = stage + 1 == worker->num_groups;
+  std::string stage_name = std::string(func_name) + "_stage" + std::to_string(stage);
+  ffi::Optional<ffi::Function> stage_func = vm_module->GetFunction(stage_name);
+  CHECK(stage_func.has_value()) << "ValueError: The module has no function " << stage_name
+                                << " for the pipeline stage of worker " << worker->worker_id
+                                << ". PartitionPipelineStages may need " << worker->num_groups
+                                << " stages";
+
+  // The buffers receiving the activations of the previous stage are reused by all the
+  // micro-batches, since the receive, the stage and the sends of a micro-batch are ordered on
+  // the stream before those of the next one.
+  ffi::Array<ffi::Any> recv_buffers;
+  if (stage > 0) {
+    ffi::Optional<ffi::Function> recv_buffers_func =
+        vm_module->GetFunction(stage_name + "_recv_buffers");
+    CHECK(recv_buffers_func.has_value())
+        << "ValueError: The module has no function " << stage_name << "_recv_buffers";
+    recv_buffers = (*recv_buffers_func)().cast<ffi::Array<ffi::Any>>();
+  }
+
+  ffi::Array<ffi::Any> results;
+  for (const ffi::Array<ffi::Any>& micro_batch : micro_batches) {
+    std::vector<ffi::AnyView> args;
+    if (stage == 0) {
+      args.insert(args.end(), micro_batch.begin(), micro_batch.end());
+    } else {
+      for (const ffi::Any& buffer : recv_buffers) {
+        RecvFromPrevGroup(buffer.cast<Tensor>());
+        args.push_back(buffer);
+      }
+    }
+    args.insert(args.end(), params.begin(), params.end());
+    ffi::Any result;
+    stage_func->CallPacked(ffi::PackedArgs(args.data(), args.size()), &result);
+    if (is_last) {
+      results.push_back(result);
+    } else {
+      for (const ffi::Any& output : result.cast<ffi::Array<ffi::Any>>()) {
+        SendToNextGroup(output.cast<Tensor>());
+      }
+    }
+  }
+  return results;
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("runtime.disco.run_pipeline_stages", RunPipelineStages);
+}
+
+}  // namespace runtime
+}  // namespace tvm
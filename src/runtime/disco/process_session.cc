@@ -22,8 +22,11 @@
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/object.h>
 
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -33,6 +36,7 @@
 #include "./disco_worker_thread.h"
 #include "./message_queue.h"
 #include "./protocol.h"
+#include "./shm_channel.h"
 
 namespace tvm {
 namespace runtime {
@@ -59,9 +63,38 @@ class DiscoProcessChannel final : public DiscoChannel {
   DiscoStreamMessageQueue worker_to_controler_;
 };
 
+/*!
+ * \brief Send the kind of channel to use to a worker, as the first message over its pipe.
+ * \param pipe The pipe channel to the worker.
+ * \param worker_id The id of the worker.
+ * \param channel The kind of channel, either "pipe" or "shm".
+ * \return The shared memory channel if requested, otherwise nullptr.
+ */
+std::unique_ptr<DiscoChannel> HandshakeChannel(DiscoProcessChannel* pipe, int worker_id,
+                                               const ffi::String& channel) {
+  ffi::String shm_name = "";
+  int64_t shm_capacity = 0;
+  std::unique_ptr<DiscoChannel> result = nullptr;
+#ifdef __linux__
+  if (channel == "shm") {
+    static std::atomic<int> counter{0};
+    shm_name = "/tvm-disco-" + std::to_string(getpid()) + "-" + std::to_string(worker_id) + "-" +
+               std::to_string(counter++);
+    std::unique_ptr<DiscoShmChannel> shm = DiscoShmChannel::Create(shm_name);
+    shm_capacity = static_cast<int64_t>(shm->capacity());
+    result = std::move(shm);
+  }
+#endif
+  ffi::AnyView packed_args[3];
+  ffi::PackedArgs::Fill(packed_args, channel, shm_name, shm_capacity);
+  pipe->Send(ffi::PackedArgs(packed_args, 3));
+  return result;
+}
+
 class ProcessSessionObj final : public BcastSessionObj {
  public:
-  explicit ProcessSessionObj(int num_workers, int num_groups, ffi::Function process_pool)
+  explicit ProcessSessionObj(int num_workers, int num_groups, ffi::Function process_pool,
+                             const ffi::String& channel)
       : process_pool_(process_pool),
         worker_0_(
             std::make_unique<DiscoWorkerThread>(0, num_workers, num_groups, &worker_zero_data_)) {
@@ -77,7 +110,14 @@ class ProcessSessionObj final : public BcastSessionObj {
       write_fds.push_back(fds[1]);
     }
     for (int i = 0; i < num_workers - 1; ++i) {
-      workers_.emplace_back(std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i]));
+      auto pipe = std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i]);
+      if (std::unique_ptr<DiscoChannel> shm = HandshakeChannel(pipe.get(), i + 1, channel)) {
+        // Keep the pipe open, as the worker exits once its end of the pipe is closed.
+        pipes_.push_back(std::move(pipe));
+        workers_.push_back(std::move(shm));
+      } else {
+        workers_.push_back(std::move(pipe));
+      }
     }
   }
 
@@ -86,6 +126,7 @@ class ProcessSessionObj final : public BcastSessionObj {
       this->Shutdown();
       this->worker_0_.reset();
       this->workers_.clear();
+      this->pipes_.clear();
       this->process_pool_(0);
     }
   }
@@ -138,7 +179,7 @@ class ProcessSessionObj final : public BcastSessionObj {
 
   void BroadcastPacked(const ffi::PackedArgs& args) final {
     worker_0_->channel->Send(args);
-    for (std::unique_ptr<DiscoProcessChannel>& channel : workers_) {
+    for (std::unique_ptr<DiscoChannel>& channel : workers_) {
       channel->Send(args);
     }
   }
@@ -167,19 +208,28 @@ class ProcessSessionObj final : public BcastSessionObj {
 
   ffi::Function process_pool_;
   std::unique_ptr<DiscoWorkerThread> worker_0_;
-  std::vector<std::unique_ptr<DiscoProcessChannel>> workers_;
+  /*! \brief The channels to workers 1 to `num_workers - 1` */
+  std::vector<std::unique_ptr<DiscoChannel>> workers_;
+  /*! \brief The pipes to the workers, when they communicate through shared memory instead */
+  std::vector<std::unique_ptr<DiscoProcessChannel>> pipes_;
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("runtime.disco.ProcessSession", ProcessSessionObj, SessionObj);
 };
 
 Session Session::ProcessSession(int num_workers, int num_group, ffi::String process_pool_creator,
-                                ffi::String entrypoint) {
+                                ffi::String entrypoint, ffi::String channel) {
   CHECK_EQ(num_workers % num_group, 0)
       << "The number of workers should be divisible by the number of worker group.";
+  CHECK(channel == "pipe" || channel == "shm")
+      << "ValueError: Unknown disco channel " << channel << ", expected \"pipe\" or \"shm\"";
+#ifndef __linux__
+  CHECK(channel != "shm")
+      << "ValueError: The shared memory disco channel is only supported on Linux";
+#endif
   const auto pf = tvm::ffi::Function::GetGlobal(process_pool_creator);
   CHECK(pf) << "ValueError: Cannot find function " << process_pool_creator
             << " in the registry. Please check if it is registered.";
   auto process_pool = (*pf)(num_workers, num_group, entrypoint).cast<ffi::Function>();
-  auto n = ffi::make_object<ProcessSessionObj>(num_workers, num_group, process_pool);
+  auto n = ffi::make_object<ProcessSessionObj>(num_workers, num_group, process_pool, channel);
   return Session(n);
 }
 
@@ -188,6 +238,21 @@ void WorkerProcess(int worker_id, int num_workers, int num_group, int64_t read_f
   CHECK_EQ(num_workers % num_group, 0)
       << "The number of workers should be divisible by the number of worker group.";
   DiscoProcessChannel channel(read_fd, write_fd);
+  ffi::PackedArgs handshake = channel.Recv();
+  std::optional<ffi::String> kind = handshake[0].try_cast<ffi::String>();
+  if (!kind.has_value()) {
+    // The controller exited before the handshake.
+    return;
+  }
+#ifdef __linux__
+  if (kind.value() == "shm") {
+    std::unique_ptr<DiscoShmChannel> shm = DiscoShmChannel::Open(
+        handshake[1].cast<ffi::String>(), static_cast<uint64_t>(handshake[2].cast<int64_t>()));
+    DiscoWorker worker(worker_id, num_workers, num_group, nullptr, shm.get());
+    worker.MainLoop();
+    return;
+  }
+#endif
   DiscoWorker worker(worker_id, num_workers, num_group, nullptr, &channel);
   worker.MainLoop();
 }
@@ -44,6 +44,13 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def_method("runtime.disco.SessionCopyToWorker0", &SessionObj::CopyToWorker0)
       .def_method("runtime.disco.SessionSyncWorker", &SessionObj::SyncWorker)
       .def_method("runtime.disco.SessionInitCCL", &SessionObj::InitCCL)
+      .def_method("runtime.disco.SessionBeginCommandBuffer", &SessionObj::BeginCommandBuffer)
+      .def_method("runtime.disco.SessionEndCommandBuffer", &SessionObj::EndCommandBuffer)
+      .def_packed("runtime.disco.SessionReplayCommandBuffer",
+                  [](ffi::PackedArgs args, ffi::Any* rv) {
+                    Session self = args[0].cast<Session>();
+                    self->ReplayCommandBuffer(args[1].cast<DRef>(), args.Slice(2));
+                  })
       .def_packed("runtime.disco.SessionCallPacked",
                   [](ffi::PackedArgs args, ffi::Any* rv) {
                     Session self = args[0].cast<Session>();
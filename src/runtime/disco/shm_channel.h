@@ -0,0 +1,313 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file shm_channel.h
+ * \brief A disco channel between the controller and a worker process over shared memory.
+ *
+ *  Each direction is a single-producer single-consumer byte ring in a shared memory segment.
+ *  Both sides spin briefly when the ring is empty or full, then sleep on a futex, so small
+ *  control messages are exchanged without any system call on the fast path. It is only
+ *  available on Linux.
+ */
+#ifndef TVM_RUNTIME_DISCO_SHM_CHANNEL_H_
+#define TVM_RUNTIME_DISCO_SHM_CHANNEL_H_
+
+#ifdef __linux__
+
+#include <dmlc/io.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "./message_queue.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The control block of one direction of the channel, at the start of its ring. */
+struct alignas(64) ShmRingHeader {
+  /*! \brief The total number of bytes read, only written by the consumer */
+  alignas(64) std::atomic<uint64_t> head;
+  /*! \brief The total number of bytes written, only written by the producer */
+  alignas(64) std::atomic<uint64_t> tail;
+  /*! \brief Futex word bumped after each write, to wake up the consumer */
+  alignas(64) std::atomic<uint32_t> data_seq;
+  /*! \brief Futex word bumped after each read, to wake up the producer */
+  std::atomic<uint32_t> space_seq;
+  /*! \brief Whether the consumer sleeps, or is about to sleep, on `data_seq` */
+  std::atomic<uint32_t> consumer_waiting;
+  /*! \brief Whether the producer sleeps, or is about to sleep, on `space_seq` */
+  std::atomic<uint32_t> producer_waiting;
+  /*! \brief Set when the controller closes the channel */
+  std::atomic<uint32_t> closed;
+  /*! \brief The processes on both sides, checked while waiting, or 0 before they attach */
+  std::atomic<int32_t> producer_pid;
+  std::atomic<int32_t> consumer_pid;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<int32_t>::is_always_lock_free,
+              "Shared memory rings require lock-free atomics");
+
+/*! \brief One direction of the channel, exposed as a stream to DiscoStreamMessageQueue. */
+class ShmRingStream : public dmlc::Stream {
+ public:
+  /*!
+   * \brief Attach to a ring.
+   * \param header The control block of the ring, followed by `capacity` bytes of data.
+   * \param capacity The number of data bytes in the ring.
+   * \param is_producer Whether this process writes to the ring, or reads from it.
+   */
+  ShmRingStream(ShmRingHeader* header, uint64_t capacity, bool is_producer)
+      : header_(header),
+        data_(reinterpret_cast<char*>(header) + sizeof(ShmRingHeader)),
+        capacity_(capacity),
+        peer_pid_(is_producer ? &header->consumer_pid : &header->producer_pid) {
+    (is_producer ? header->producer_pid : header->consumer_pid).store(getpid());
+  }
+
+  size_t Write(const void* data, size_t size) final {
+    const char* src = static_cast<const char*>(data);
+    size_t written = 0;
+    while (written < size) {
+      uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+      uint64_t head = header_->head.load(std::memory_order_acquire);
+      uint64_t space = capacity_ - (tail - head);
+      if (space == 0) {
+        Wait(&header_->space_seq, &header_->producer_waiting,
+             [this, tail]() { return capacity_ - (tail - header_->head.load()) != 0; });
+        continue;
+      }
+      size_t nbytes = std::min<uint64_t>(space, size - written);
+      CopyIn(tail, src + written, nbytes);
+      header_->tail.store(tail + nbytes, std::memory_order_release);
+      Notify(&header_->data_seq, &header_->consumer_waiting);
+      written += nbytes;
+    }
+    return size;
+  }
+
+  size_t Read(void* data, size_t size) final {
+    char* dst = static_cast<char*>(data);
+    size_t read = 0;
+    while (read < size) {
+      uint64_t head = header_->head.load(std::memory_order_relaxed);
+      uint64_t tail = header_->tail.load(std::memory_order_acquire);
+      if (tail == head) {
+        if (header_->closed.load(std::memory_order_acquire)) {
+          // Same as a closed pipe, which DiscoStreamMessageQueue treats as a shutdown.
+          return read;
+        }
+        Wait(&header_->data_seq, &header_->consumer_waiting,
+             [this, head]() { return header_->tail.load() != head || header_->closed.load(); });
+        continue;
+      }
+      size_t nbytes = std::min<uint64_t>(tail - head, size - read);
+      CopyOut(head, dst + read, nbytes);
+      header_->head.store(head + nbytes, std::memory_order_release);
+      Notify(&header_->space_seq, &header_->producer_waiting);
+      read += nbytes;
+    }
+    return size;
+  }
+
+ private:
+  void CopyIn(uint64_t pos, const char* src, size_t nbytes) {
+    size_t offset = pos % capacity_;
+    size_t first = std::min<size_t>(nbytes, capacity_ - offset);
+    std::memcpy(data_ + offset, src, first);
+    std::memcpy(data_, src + first, nbytes - first);
+  }
+
+  void CopyOut(uint64_t pos, char* dst, size_t nbytes) {
+    size_t offset = pos % capacity_;
+    size_t first = std::min<size_t>(nbytes, capacity_ - offset);
+    std::memcpy(dst, data_ + offset, first);
+    std::memcpy(dst + first, data_, nbytes - first);
+  }
+
+  static void Notify(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiting) {
+    seq->fetch_add(1);
+    if (waiting->load()) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+  }
+
+  /*! \brief Spin, then sleep on `seq`, until `ready` returns true. */
+  template <typename FReady>
+  void Wait(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiting, FReady ready) {
+    constexpr int kNumSpins = 4096;
+    for (int i = 0; i < kNumSpins; ++i) {
+      if (ready()) return;
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    }
+    while (true) {
+      uint32_t value = seq->load();
+      waiting->store(1);
+      if (ready()) {
+        waiting->store(0);
+        return;
+      }
+      // Wake up periodically, in case the peer died without closing the channel.
+      struct timespec timeout = {0, 100 * 1000 * 1000};
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAIT, value, &timeout, nullptr,
+              0);
+      waiting->store(0);
+      if (ready()) return;
+      pid_t peer_pid = peer_pid_->load();
+      CHECK(peer_pid == 0 || kill(peer_pid, 0) == 0 || errno != ESRCH)
+          << "The disco process on the other side of the shared memory channel has exited";
+    }
+  }
+
+  ShmRingHeader* header_;
+  char* data_;
+  uint64_t capacity_;
+  const std::atomic<int32_t>* peer_pid_;
+};
+
+/*!
+ * \brief A shared memory channel between the controller and a worker process.
+ *
+ *  The controller creates the segment and passes its name to the worker, which maps it and
+ *  unlinks the name right away, so the segment never outlives both processes.
+ */
+class DiscoShmChannel final : public DiscoChannel {
+ public:
+  /*! \brief The default number of data bytes in each direction. */
+  static constexpr uint64_t kDefaultCapacity = 1 << 20;
+
+  /*! \brief Create a new segment on the controller side. */
+  static std::unique_ptr<DiscoShmChannel> Create(const std::string& name,
+                                                 uint64_t capacity = kDefaultCapacity) {
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    CHECK_NE(fd, -1) << "Cannot create the shared memory segment " << name << ": "
+                     << strerror(errno);
+    size_t nbytes = SegmentSize(capacity);
+    if (ftruncate(fd, nbytes) != 0) {
+      int err = errno;
+      close(fd);
+      shm_unlink(name.c_str());
+      LOG(FATAL) << "Cannot resize the shared memory segment " << name << ": " << strerror(err);
+    }
+    // The segment is zero-initialized, which is the initial state of both rings.
+    return std::unique_ptr<DiscoShmChannel>(
+        new DiscoShmChannel(name, fd, capacity, /*is_controller=*/true));
+  }
+
+  /*! \brief Attach to the segment created by the controller, on the worker side. */
+  static std::unique_ptr<DiscoShmChannel> Open(const std::string& name, uint64_t capacity) {
+    int fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    CHECK_NE(fd, -1) << "Cannot open the shared memory segment " << name << ": "
+                     << strerror(errno);
+    shm_unlink(name.c_str());
+    return std::unique_ptr<DiscoShmChannel>(
+        new DiscoShmChannel(name, fd, capacity, /*is_controller=*/false));
+  }
+
+  ~DiscoShmChannel() {
+    if (is_controller_) {
+      controller_to_worker_header()->closed.store(1);
+      Notify(&controller_to_worker_header()->data_seq);
+      // The name is normally unlinked by the worker, unless it never attached.
+      shm_unlink(name_.c_str());
+    }
+    munmap(base_, SegmentSize(capacity_));
+  }
+
+  void Send(const ffi::PackedArgs& args) { controller_to_worker_.Send(args); }
+  ffi::PackedArgs Recv() { return controller_to_worker_.Recv(); }
+  void Reply(const ffi::PackedArgs& args) { worker_to_controller_.Send(args); }
+  ffi::PackedArgs RecvReply() { return worker_to_controller_.Recv(); }
+
+  /*! \brief The number of data bytes in each direction. */
+  uint64_t capacity() const { return capacity_; }
+
+ private:
+  DiscoShmChannel(std::string name, int fd, uint64_t capacity, bool is_controller)
+      : name_(std::move(name)),
+        capacity_(capacity),
+        is_controller_(is_controller),
+        base_(MapSegment(fd, capacity)),
+        controller_to_worker_stream_(controller_to_worker_header(), capacity, is_controller),
+        worker_to_controller_stream_(worker_to_controller_header(), capacity, !is_controller),
+        controller_to_worker_(&controller_to_worker_stream_),
+        worker_to_controller_(&worker_to_controller_stream_) {}
+
+  static size_t RingSize(uint64_t capacity) {
+    // Keep the header of the second ring aligned.
+    return (sizeof(ShmRingHeader) + capacity + 63) / 64 * 64;
+  }
+
+  static size_t SegmentSize(uint64_t capacity) { return 2 * RingSize(capacity); }
+
+  static void* MapSegment(int fd, uint64_t capacity) {
+    void* base = mmap(nullptr, SegmentSize(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int err = errno;
+    close(fd);
+    CHECK(base != MAP_FAILED) << "Cannot map the shared memory segment: " << strerror(err);
+    return base;
+  }
+
+  static void Notify(std::atomic<uint32_t>* seq) {
+    seq->fetch_add(1);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+  }
+
+  ShmRingHeader* controller_to_worker_header() const {
+    return static_cast<ShmRingHeader*>(base_);
+  }
+
+  ShmRingHeader* worker_to_controller_header() const {
+    return reinterpret_cast<ShmRingHeader*>(static_cast<char*>(base_) + RingSize(capacity_));
+  }
+
+  std::string name_;
+  uint64_t capacity_;
+  bool is_controller_;
+  void* base_;
+  ShmRingStream controller_to_worker_stream_;
+  ShmRingStream worker_to_controller_stream_;
+  DiscoStreamMessageQueue controller_to_worker_;
+  DiscoStreamMessageQueue worker_to_controller_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // __linux__
+#endif  // TVM_RUNTIME_DISCO_SHM_CHANNEL_H_
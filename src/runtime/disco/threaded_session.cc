@@ -22,12 +22,15 @@
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/object.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "../../support/ring_buffer.h"
 #include "../minrpc/rpc_reference.h"
@@ -38,15 +41,51 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The queue of the messages from a thread to another.
+ *
+ * By default, the packets go through a ring buffer guarded by a mutex, and the receiver waits on a
+ * condition variable, which costs a futex wakeup per message. With `spin`, the packets go through
+ * a lock-free single-producer single-consumer ring of buffers instead. The receiver spins on it for
+ * a bounded number of rounds before it parks on the condition variable, so that the sender only
+ * wakes it up after it has been idle for a while, and the buffers are swapped between the two
+ * sides instead of copied.
+ */
 class DiscoThreadedMessageQueue : private dmlc::Stream,
                                   private DiscoProtocol<DiscoThreadedMessageQueue> {
  public:
+  explicit DiscoThreadedMessageQueue(bool spin) : spin_(spin) {
+    if (spin_) {
+      slots_.resize(kNumSlots);
+    }
+  }
+
   void Send(const ffi::PackedArgs& args) {
     RPCReference::ReturnPackedSeq(reinterpret_cast<const TVMFFIAny*>(args.data()), args.size(),
                                   this);
     CommitSendAndNotifyEnqueue();
   }
 
+  /*!
+   * \brief Serialize a message into a packet, so that it is sent to many queues through
+   * `SendPacket` without serializing it again.
+   * \param args The message.
+   * \param packet The packet, whose memory is reused.
+   */
+  void Serialize(const ffi::PackedArgs& args, std::string* packet) {
+    std::swap(write_buffer_, *packet);
+    write_buffer_.clear();
+    RPCReference::ReturnPackedSeq(reinterpret_cast<const TVMFFIAny*>(args.data()), args.size(),
+                                  this);
+    std::swap(write_buffer_, *packet);
+  }
+
+  /*! \brief Send a packet created by `Serialize`. */
+  void SendPacket(const std::string& packet) {
+    write_buffer_.assign(packet);
+    CommitSendAndNotifyEnqueue();
+  }
+
   ffi::PackedArgs Recv() {
     DequeueNextPacket();
     ffi::AnyView* packed_args = nullptr;
@@ -57,6 +96,10 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
 
  protected:
   void CommitSendAndNotifyEnqueue() {
+    if (spin_) {
+      CommitSendToSlot();
+      return;
+    }
     bool need_notify = false;
     {
       std::lock_guard<std::mutex> lock{mutex_};
@@ -71,7 +114,9 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
   }
 
   void DequeueNextPacket() {
-    {
+    if (spin_) {
+      DequeueFromSlot();
+    } else {
       std::unique_lock<std::mutex> lock(mutex_);
       dequeue_waiting_ = true;
       condition_.wait(lock, [this] { return msg_cnt_.load() > 0; });
@@ -88,6 +133,43 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
     this->Read(&code);
   }
 
+  void CommitSendToSlot() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    // The ring is full only if the receiver is behind by kNumSlots messages.
+    while (tail - head_.load(std::memory_order_acquire) == kNumSlots) {
+      std::this_thread::yield();
+    }
+    // The slot keeps the buffer the receiver swapped in, which the next message is written to.
+    slots_[tail % kNumSlots].swap(write_buffer_);
+    write_buffer_.clear();
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+    // Either the receiver sees the new tail before it parks, or we see that it parked.
+    if (parked_.load(std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock{mutex_};
+      condition_.notify_one();
+    }
+  }
+
+  void DequeueFromSlot() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    auto ready = [this, head] { return tail_.load(std::memory_order_seq_cst) != head; };
+    for (int round = 0; !ready(); ++round) {
+      if (round < kSpinRounds) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      parked_.store(true, std::memory_order_seq_cst);
+      condition_.wait(lock, ready);
+      parked_.store(false, std::memory_order_relaxed);
+      break;
+    }
+    read_buffer_.swap(slots_[head % kNumSlots]);
+    head_.store(head + 1, std::memory_order_release);
+    // The packet starts with its length, which the ring doesn't need.
+    read_offset_ = sizeof(uint64_t);
+  }
+
   void MessageStart(uint64_t packet_nbytes) {}
 
   size_t Read(void* data, size_t size) final {
@@ -121,10 +203,27 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
   std::atomic<int> msg_cnt_{0};
   std::condition_variable condition_;
   support::RingBuffer ring_buffer_;
+
+  /*! \brief The number of packets in flight in the lock-free ring. */
+  static constexpr uint64_t kNumSlots = 64;
+  /*! \brief The number of rounds the receiver spins on an empty ring before it parks. */
+  static constexpr int kSpinRounds = 4096;
+  /*! \brief Whether the packets go through the lock-free ring. */
+  const bool spin_;
+  /*! \brief The buffers of the packets in the lock-free ring. */
+  std::vector<std::string> slots_;
+  /*! \brief The number of packets received from the lock-free ring. */
+  std::atomic<uint64_t> head_{0};
+  /*! \brief The number of packets sent to the lock-free ring. */
+  std::atomic<uint64_t> tail_{0};
+  /*! \brief Whether the receiver waits on the condition variable. */
+  std::atomic<bool> parked_{false};
 };
 
 class DiscoThreadChannel final : public DiscoChannel {
  public:
+  explicit DiscoThreadChannel(bool spin) : controler_to_worker_(spin), worker_to_controler_(spin) {}
+
   void Send(const ffi::PackedArgs& args) { controler_to_worker_.Send(args); }
   ffi::PackedArgs Recv() { return controler_to_worker_.Recv(); }
   void Reply(const ffi::PackedArgs& args) { worker_to_controler_.Send(args); }
@@ -135,8 +234,8 @@ class DiscoThreadChannel final : public DiscoChannel {
 };
 
 DiscoWorkerThread::DiscoWorkerThread(int worker_id, int num_workers, int num_groups,
-                                     WorkerZeroData* worker_zero_data_)
-    : channel(std::make_unique<DiscoThreadChannel>()),
+                                     WorkerZeroData* worker_zero_data_, bool spin_queue)
+    : channel(std::make_unique<DiscoThreadChannel>(spin_queue)),
       worker(std::make_unique<DiscoWorker>(worker_id, num_workers, num_groups, worker_zero_data_,
                                            channel.get())),
       thread(std::make_unique<std::thread>([worker = this->worker.get()] { worker->MainLoop(); })) {
@@ -144,10 +243,10 @@ DiscoWorkerThread::DiscoWorkerThread(int worker_id, int num_workers, int num_gro
 
 class ThreadedSessionObj final : public BcastSessionObj {
  public:
-  explicit ThreadedSessionObj(int num_workers, int num_groups) {
+  explicit ThreadedSessionObj(int num_workers, int num_groups, bool spin_queue) {
     for (int i = 0; i < num_workers; ++i) {
       WorkerZeroData* data = (i == 0) ? &worker_zero_data_ : nullptr;
-      workers_.emplace_back(i, num_workers, num_groups, data);
+      workers_.emplace_back(i, num_workers, num_groups, data, spin_queue);
     }
   }
 
@@ -169,8 +268,10 @@ class ThreadedSessionObj final : public BcastSessionObj {
   }
 
   void BroadcastPacked(const ffi::PackedArgs& args) final {
-    for (const DiscoWorkerThread& worker : this->workers_) {
-      worker.channel->Send(args);
+    // The message is serialized once and copied to the queue of each worker.
+    Channel(0)->controler_to_worker_.Serialize(args, &bcast_packet_);
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      Channel(i)->controler_to_worker_.SendPacket(bcast_packet_);
     }
   }
 
@@ -184,13 +285,22 @@ class ThreadedSessionObj final : public BcastSessionObj {
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("runtime.disco.ThreadedSession", ThreadedSessionObj,
                                     SessionObj);
 
+  DiscoThreadChannel* Channel(int worker_id) const {
+    return static_cast<DiscoThreadChannel*>(workers_[worker_id].channel.get());
+  }
+
   std::vector<DiscoWorkerThread> workers_;
+  /*! \brief The buffer of the packets broadcast to the workers. */
+  std::string bcast_packet_;
 };
 
-Session Session::ThreadedSession(int num_workers, int num_group) {
+Session Session::ThreadedSession(int num_workers, int num_group, ffi::String queue) {
   CHECK_EQ(num_workers % num_group, 0)
       << "The number of workers should be divisible by the number of worker group.";
-  ObjectPtr<ThreadedSessionObj> n = ffi::make_object<ThreadedSessionObj>(num_workers, num_group);
+  CHECK(queue == "mutex" || queue == "spin")
+      << "ValueError: Unknown disco queue " << queue << ", expected \"mutex\" or \"spin\"";
+  ObjectPtr<ThreadedSessionObj> n =
+      ffi::make_object<ThreadedSessionObj>(num_workers, num_group, queue == "spin");
   return Session(std::move(n));
 }
 
@@ -34,6 +34,13 @@
 #include <utility>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace tvm {
 namespace runtime {
 
@@ -142,6 +149,37 @@ void LoadBinaryFromFile(const std::string& file_name, std::string* data) {
   fs.read(&(*data)[0], size);
 }
 
+MappedFile::MappedFile(const std::string& file_name, bool sequential) {
+#if !defined(_WIN32)
+  int fd = open(file_name.c_str(), O_RDONLY);
+  CHECK_NE(fd, -1) << "ValueError: Cannot open file: " << file_name;
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "ValueError: Cannot stat file: " << file_name;
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ != 0) {
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK(addr != MAP_FAILED) << "ValueError: Cannot mmap file: " << file_name;
+    if (sequential) {
+      madvise(addr, size_, MADV_SEQUENTIAL);
+    }
+    data_ = static_cast<const char*>(addr);
+  }
+  close(fd);
+#else
+  LoadBinaryFromFile(file_name, &buffer_);
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+}
+
 void SaveBinaryToFile(const std::string& file_name, const std::string& data) {
   std::ofstream fs(file_name, std::ios::out | std::ios::binary);
   ICHECK(!fs.fail()) << "Cannot open " << file_name;
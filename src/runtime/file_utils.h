@@ -74,6 +74,36 @@ void LoadBinaryFromFile(const std::string& file_name, std::string* data);
  */
 void SaveBinaryToFile(const std::string& file_name, const std::string& data);
 
+/*!
+ * \brief A read-only view of a file, memory-mapped where the platform supports it
+ * and read into an in-memory buffer otherwise.
+ */
+class MappedFile {
+ public:
+  /*!
+   * \brief Map the file into memory.
+   * \param file_name The name of the file.
+   * \param sequential Whether the file is going to be read sequentially, which lets the
+   * kernel read ahead aggressively.
+   */
+  explicit MappedFile(const std::string& file_name, bool sequential = false);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /*! \return The start of the file contents. */
+  const char* data() const { return data_; }
+  /*! \return The size of the file in bytes. */
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_{nullptr};
+  size_t size_{0};
+#if defined(_WIN32)
+  std::string buffer_;
+#endif
+};
+
 /*!
  * \brief Save meta data to file.
  * \param file_name The name of the file.
@@ -191,6 +191,25 @@ void HexagonDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void
   memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
 }
 
+void HexagonDeviceAPI::SetParallelVtcmBytes(size_t nbytes_per_task) {
+  if (parallel_vtcm_ != nullptr) {
+    VtcmPool()->Free(parallel_vtcm_, parallel_vtcm_bytes_ * ThreadManager()->NumParallelThreads());
+    parallel_vtcm_ = nullptr;
+    parallel_vtcm_bytes_ = 0;
+  }
+  if (nbytes_per_task == 0) {
+    return;
+  }
+  // Keep the partitions 2k aligned, as the largest alignment of the VTCM allocations.
+  nbytes_per_task = (nbytes_per_task + 0x7ff) & -0x800;
+  parallel_vtcm_ = VtcmPool()->Allocate(nbytes_per_task * ThreadManager()->NumParallelThreads());
+  parallel_vtcm_bytes_ = nbytes_per_task;
+}
+
+bool HexagonParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int* ret) {
+  return HexagonDeviceAPI::Global()->ParallelLaunch(flambda, cdata, num_task, ret);
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
@@ -300,6 +319,13 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                     HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
                     api->ReleaseResources();
                   })
+      .def_packed("device_api.hexagon.set_parallel_vtcm_bytes",
+                  [](ffi::PackedArgs args, ffi::Any* rv) {
+                    int64_t nbytes = args[0].cast<int64_t>();
+                    CHECK_GE(nbytes, 0) << "ValueError: The VTCM bytes per task must be "
+                                        << "non-negative, but got " << nbytes;
+                    HexagonDeviceAPI::Global()->SetParallelVtcmBytes(nbytes);
+                  })
       .def_packed("device_api.hexagon.vtcm_device_bytes",
                   [](ffi::PackedArgs args, ffi::Any* rv) {
                     HexagonDeviceAPI* api = HexagonDeviceAPI::Global();
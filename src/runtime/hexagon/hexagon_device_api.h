@@ -75,6 +75,8 @@ class HexagonDeviceAPI final : public DeviceAPI {
 
   //! \brief Ensures all runtime resources are freed
   void ReleaseResources() {
+    SetParallelVtcmBytes(0);
+
     CHECK(runtime_dma) << "runtime_dma was not created in AcquireResources";
     runtime_dma.reset();
 
@@ -163,6 +165,29 @@ class HexagonDeviceAPI final : public DeviceAPI {
     return runtime_vtcm.get();
   }
 
+  /*!
+   * \brief Run a parallel job of compiled code on the HVX threads of the runtime.
+   * \param flambda The parallel function to be launched.
+   * \param cdata The closure data.
+   * \param num_task The number of tasks, 0 to use all the HVX threads.
+   * \param ret The return value of the launch, as that of `TVMBackendParallelLaunch`.
+   * \returns Whether the job ran, false when the runtime resources are not acquired.
+   */
+  bool ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int* ret) {
+    if (!runtime_threads) {
+      return false;
+    }
+    *ret = runtime_threads->ParallelLaunch(flambda, cdata, num_task, parallel_vtcm_,
+                                           parallel_vtcm_bytes_);
+    return true;
+  }
+
+  /*!
+   * \brief Give each task of the parallel launches a partition of VTCM for its allocations.
+   * \param nbytes_per_task The size of a partition, 0 to let the tasks share the VTCM pool.
+   */
+  void SetParallelVtcmBytes(size_t nbytes_per_task);
+
  protected:
   //! Standard Device API interface to copy data from one storage to another.
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
@@ -197,9 +222,21 @@ class HexagonDeviceAPI final : public DeviceAPI {
   //! \brief VTCM memory manager
   std::unique_ptr<HexagonVtcmPool> runtime_vtcm;
 
+  //! \brief VTCM split into the partitions of the tasks of the parallel launches.
+  void* parallel_vtcm_{nullptr};
+  size_t parallel_vtcm_bytes_{0};
+
   //! \brief Hexagon power manager
   std::unique_ptr<HexagonPowerManager> runtime_power_manager;
 };
+
+/*!
+ * \brief Run a parallel launch of compiled code on the HVX threads, called by
+ * `TVMBackendParallelLaunch` on Hexagon.
+ * \returns Whether the launch ran, false when the runtime resources are not acquired.
+ */
+bool HexagonParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int* ret);
+
 }  // namespace hexagon
 }  // namespace runtime
 }  // namespace tvm
@@ -19,10 +19,37 @@
 
 #include "hexagon_thread_manager.h"
 
+#include <algorithm>
+#include <atomic>
+
+#include "hexagon_vtcm_pool.h"
+
 namespace tvm {
 namespace runtime {
 namespace hexagon {
 
+namespace {
+
+//! \brief The stride of the counters of `TVMBackendParallelBarrier` in thread_pool.cc.
+constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
+
+//! \brief Whether the current thread runs a task of `ParallelLaunch`.
+thread_local bool in_parallel_task = false;
+
+//! \brief A task of `ParallelLaunch`, sent to a thread.
+struct ParallelTask {
+  FTVMParallelLambda flambda;
+  void* cdata;
+  TVMParallelGroupEnv* env;
+  int task_id;
+  char* vtcm;
+  size_t vtcm_bytes;
+  std::atomic<int>* num_failed;
+  qurt_sem_t* done;
+};
+
+}  // namespace
+
 HexagonThreadManager::HexagonThreadManager(unsigned num_threads, unsigned thread_stack_size_bytes,
                                            unsigned thread_pipe_size_words,
                                            const std::vector<HardwareResourceType> hw_resources) {
@@ -264,6 +291,78 @@ void HexagonThreadManager::WaitOnThreads() {
   }
 }
 
+std::vector<TVMStreamHandle> HexagonThreadManager::ParallelThreads() {
+  std::vector<TVMStreamHandle> out;
+  for (unsigned i = 0; i < hw_resources_.size(); i++) {
+    HardwareResourceType type = hw_resources_[i];
+    if ((type == HVX_0) || (type == HVX_1) || (type == HVX_2) || (type == HVX_3)) {
+      out.push_back(reinterpret_cast<TVMStreamHandle>(i));
+    }
+  }
+  // Without HVX instances, e.g. in the tests, all the threads run the tasks.
+  return out.empty() ? GetStreamHandles() : out;
+}
+
+unsigned HexagonThreadManager::NumParallelThreads() { return ParallelThreads().size(); }
+
+int HexagonThreadManager::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task,
+                                         void* vtcm, size_t vtcm_bytes_per_task) {
+  std::unique_lock<std::mutex> lock(parallel_mutex_, std::try_to_lock);
+  if (in_parallel_task || !lock.owns_lock()) {
+    std::atomic<int> sync_counter{0};
+    TVMParallelGroupEnv env;
+    env.num_task = 1;
+    env.sync_handle = &sync_counter;
+    return (*flambda)(0, &env, cdata) == 0 ? 0 : -1;
+  }
+  // In case Start() was never explicitly called, call it now to prevent deadlock
+  if (qurt_sem_get_val(&start_semaphore_) == 0) {
+    Start();
+  }
+
+  std::vector<TVMStreamHandle> threads = ParallelThreads();
+  unsigned ntasks = num_task > 0 ? std::min<unsigned>(num_task, threads.size()) : threads.size();
+  std::vector<std::atomic<int>> sync_counter(ntasks * kSyncStride);
+  TVMParallelGroupEnv env;
+  env.num_task = ntasks;
+  env.sync_handle = sync_counter.data();
+  std::atomic<int> num_failed{0};
+  qurt_sem_t done;
+  qurt_sem_init_val(&done, 0);
+
+  std::vector<ParallelTask> tasks(ntasks);
+  for (unsigned i = 0; i < ntasks; i++) {
+    char* task_vtcm = vtcm ? static_cast<char*>(vtcm) + i * vtcm_bytes_per_task : nullptr;
+    tasks[i] = ParallelTask{flambda, cdata, &env, static_cast<int>(i), task_vtcm,
+                            vtcm_bytes_per_task, &num_failed, &done};
+    bool success = Dispatch(threads[i], thread_parallel_task, &tasks[i]);
+    while (!success) {
+      success = Dispatch(threads[i], thread_parallel_task, &tasks[i]);
+    }
+  }
+  for (unsigned i = 0; i < ntasks; i++) {
+    qurt_sem_down(&done);
+  }
+  qurt_sem_destroy(&done);
+  return num_failed.load() == 0 ? 0 : -1;
+}
+
+void HexagonThreadManager::thread_parallel_task(void* task) {
+  ParallelTask* pt = static_cast<ParallelTask*>(task);
+  in_parallel_task = true;
+  if (pt->vtcm != nullptr) {
+    HexagonVtcmPool::SetThreadPartition(pt->vtcm, pt->vtcm_bytes);
+  }
+  if ((*pt->flambda)(pt->task_id, pt->env, pt->cdata) != 0) {
+    pt->num_failed->fetch_add(1);
+  }
+  if (pt->vtcm != nullptr) {
+    HexagonVtcmPool::SetThreadPartition(nullptr, 0);
+  }
+  in_parallel_task = false;
+  qurt_sem_add(pt->done, 1);
+}
+
 void HexagonThreadManager::CheckSemaphore(unsigned syncID) {
   // We want the success case to be fast, so do not lock the mutex
   if (semaphores_.find(syncID) == semaphores_.end()) {
@@ -22,9 +22,11 @@
 
 #include <tvm/ffi/function.h>
 #include <tvm/runtime/base.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/logging.h>
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -145,6 +147,25 @@ class HexagonThreadManager {
   //! call to wait until all threads have empty pipes.
   void WaitOnThreads();
 
+  /*!
+   * \brief Blocking run of a parallel job of compiled code, one task per thread that holds an
+   * HVX instance, or per thread when none does, as `TVMBackendParallelLaunch`.
+   * \param flambda The parallel function to be launched.
+   * \param cdata The closure data.
+   * \param num_task The number of tasks, 0 to use all the threads; it is capped to the number of
+   * threads, as the parallel loops split their work by the number of tasks of their launch.
+   * \param vtcm VTCM split into one partition per task, see `HexagonVtcmPool::SetThreadPartition`;
+   * nullptr for none.
+   * \param vtcm_bytes_per_task The size of each partition of `vtcm`.
+   * \returns 0 when all the tasks succeed, -1 otherwise. Nested launches, and the launches made
+   * while another one runs, run on the calling thread as a single task.
+   */
+  int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, void* vtcm = nullptr,
+                     size_t vtcm_bytes_per_task = 0);
+
+  //! \brief The number of threads the tasks of `ParallelLaunch` run on.
+  unsigned NumParallelThreads();
+
  private:
   struct ThreadContext {
     qurt_pipe_t* pipe;
@@ -184,6 +205,12 @@ class HexagonThreadManager {
   //! \brief Void function executed by a thread to exit at time of destruction.
   static void thread_exit(void* context);
 
+  //! \brief Void function executed by a thread to run a task of `ParallelLaunch`.
+  static void thread_parallel_task(void* task);
+
+  //! \brief The threads the tasks of `ParallelLaunch` run on.
+  std::vector<TVMStreamHandle> ParallelThreads();
+
   //! \brief Void function executed by each thread as `main`.
   static void thread_main(void* context);
 
@@ -219,6 +246,9 @@ class HexagonThreadManager {
   //! \brief Start semaphore created at time of construction; signled by `Start`.
   qurt_sem_t start_semaphore_;
 
+  //! \brief Serializes the parallel launches.
+  std::mutex parallel_mutex_;
+
   /*!
    *\brief Encapsulate a void function pointer + arg pointer; sent via pipe to threads to execute.
    */
@@ -25,6 +25,53 @@ namespace tvm {
 namespace runtime {
 namespace hexagon {
 
+namespace {
+
+//! \brief A partition of VTCM allocated in stack order, see SetThreadPartition.
+struct VtcmPartition {
+  char* data{nullptr};
+  size_t nbytes{0};
+  //! \brief The live allocations, by address.
+  std::vector<std::pair<char*, size_t>> allocations;
+
+  void* Allocate(size_t size) {
+    char* top = allocations.empty() ? data : allocations.back().first + allocations.back().second;
+    // The same alignments as those of the pool: 2k for multiples of 2k, 128 bytes otherwise.
+    uintptr_t align = (size & size_t(0x7FF)) ? 0x80 : 0x800;
+    uintptr_t addr = (reinterpret_cast<uintptr_t>(top) + align - 1) & ~(align - 1);
+    char* ptr = reinterpret_cast<char*>(addr);
+    if (ptr + size > data + nbytes) {
+      return nullptr;
+    }
+    allocations.emplace_back(ptr, size);
+    return ptr;
+  }
+
+  bool Free(void* ptr, size_t size) {
+    auto it = std::find_if(allocations.begin(), allocations.end(),
+                           [&](auto entry) { return entry.first == ptr; });
+    if (it == allocations.end()) {
+      return false;
+    }
+    CHECK(it->second == size) << "Attempted to free a different size than was allocated";
+    // The space of an allocation is reused once those above it are freed.
+    allocations.erase(it);
+    return true;
+  }
+};
+
+thread_local VtcmPartition thread_partition;
+
+}  // namespace
+
+void HexagonVtcmPool::SetThreadPartition(void* data, size_t nbytes) {
+  CHECK(thread_partition.allocations.empty())
+      << "Unset a VTCM partition with " << thread_partition.allocations.size()
+      << " live allocations";
+  thread_partition.data = static_cast<char*>(data);
+  thread_partition.nbytes = data == nullptr ? 0 : nbytes;
+}
+
 HexagonVtcmPool::HexagonVtcmPool() {
   compute_res_attr_t res_info;
   HEXAGON_SAFE_CALL(HAP_compute_res_attr_init(&res_info));
@@ -62,6 +109,11 @@ HexagonVtcmPool::HexagonVtcmPool() {
 HexagonVtcmPool::~HexagonVtcmPool() { HEXAGON_SAFE_CALL(HAP_compute_res_release(context_id_)); }
 
 void* HexagonVtcmPool::Allocate(size_t nbytes) {
+  if (thread_partition.data != nullptr) {
+    if (void* ptr = thread_partition.Allocate(nbytes)) {
+      return ptr;
+    }
+  }
   std::lock_guard<std::mutex> lock(mutex_);
 
   CHECK(!free_.empty()) << "No free VTCM";
@@ -109,6 +161,9 @@ void* HexagonVtcmPool::Allocate(size_t nbytes) {
 }
 
 void HexagonVtcmPool::Free(void* ptr, size_t nbytes) {
+  if (thread_partition.data != nullptr && thread_partition.Free(ptr, nbytes)) {
+    return;
+  }
   char* ptr_to_free = static_cast<char*>(ptr);
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -67,6 +67,18 @@ class HexagonVtcmPool {
    */
   void Free(void* ptr, size_t nbytes);
 
+  /* \brief Serve the VTCM allocations of the calling thread from a partition of the pool.
+   *
+   * The threads of a parallel launch then neither contend for the pool nor fragment it. The
+   * allocations that don't fit in the partition fall back to the pool, and those made in the
+   * partition must be freed before the partition is unset.
+   *
+   * \param data The partition, allocated from the pool, or nullptr to unset the partition.
+   *
+   * \param nbytes The size of the partition.
+   */
+  static void SetThreadPartition(void* data, size_t nbytes);
+
   //! \brief Returns the total number of bytes in this pool
   size_t VtcmDeviceBytes() { return reinterpret_cast<size_t>(vtcm_device_size_); }
 
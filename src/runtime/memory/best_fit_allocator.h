@@ -0,0 +1,420 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/best_fit_allocator.h
+ * \brief A caching allocator that serves requests by best-fit over size-class bins.
+ *
+ * Device memory is reserved in segments. Each segment is carved into blocks which
+ * are split on allocation and coalesced with free neighbors on release, so requests
+ * of slightly different sizes (as produced by dynamic shapes) can reuse the same
+ * reserved memory instead of reserving a new exact-size buffer each time.
+ */
+#ifndef TVM_RUNTIME_MEMORY_BEST_FIT_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_BEST_FIT_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+class BestFitAllocator : public Allocator {
+ public:
+  /*! \brief The granularity of all blocks. Also the alignment of sub-allocated blocks. */
+  static constexpr size_t kMinBlockSize = 512;
+  /*! \brief Requests up to this size are served from small segments. */
+  static constexpr size_t kSmallSize = 1 << 20;
+  /*! \brief The size of segments reserved for small requests. */
+  static constexpr size_t kSmallSegmentSize = 2 << 20;
+  /*! \brief The size of segments reserved for requests in (kSmallSize, kMediumSize). */
+  static constexpr size_t kMediumSegmentSize = 20 << 20;
+  /*! \brief Requests of at least this size reserve a segment of their own rounded size. */
+  static constexpr size_t kMediumSize = 10 << 20;
+  /*! \brief Large segments are rounded to a multiple of this size. */
+  static constexpr size_t kLargeRoundSize = 2 << 20;
+
+  /*! \brief Snapshot of the allocator's bookkeeping, used to reason about fragmentation. */
+  struct Stats {
+    /*! \brief Total bytes reserved from the device. */
+    size_t reserved_bytes{0};
+    /*! \brief Total bytes currently handed out to callers. */
+    size_t allocated_bytes{0};
+    /*! \brief Number of segments reserved from the device. */
+    size_t num_segments{0};
+    /*! \brief Number of blocks currently handed out to callers. */
+    size_t num_allocated_blocks{0};
+    /*! \brief Number of free blocks across all segments. */
+    size_t num_free_blocks{0};
+    /*! \brief The size of the largest free block. */
+    size_t largest_free_block{0};
+    /*! \brief Number of Alloc calls served without reserving new device memory. */
+    size_t num_cache_hits{0};
+    /*! \brief Number of Alloc calls that had to reserve a new segment. */
+    size_t num_cache_misses{0};
+    /*! \brief Number of times cached segments were released to recover from OOM. */
+    size_t num_oom_releases{0};
+    /*!
+     * \brief External fragmentation of the free memory in [0, 1]:
+     *  1 - largest_free_block / total_free_bytes.
+     */
+    double fragmentation() const {
+      size_t free_bytes = reserved_bytes - allocated_bytes;
+      if (free_bytes == 0) return 0.0;
+      return 1.0 - static_cast<double>(largest_free_block) / static_cast<double>(free_bytes);
+    }
+  };
+
+  BestFitAllocator() : Allocator(kBestFit), reserved_memory_(0) {}
+
+  ~BestFitAllocator() { ReleaseAll(); }
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    size_t size = RoundSize(nbytes);
+    bool splittable = SupportsSubAllocation(dev) && alignment <= kMinBlockSize;
+    Block* block = splittable ? FindFreeBlock(size) : FindWholeBlock(dev, size, alignment);
+    if (block != nullptr) {
+      ++stats_.num_cache_hits;
+    } else {
+      ++stats_.num_cache_misses;
+      block = ReserveSegment(dev, splittable ? SegmentSize(size) : size, alignment, type_hint,
+                             splittable);
+    }
+    block = SplitBlock(block, size);
+    block->allocated = true;
+    allocated_blocks_.emplace(block->ptr, block);
+    stats_.allocated_bytes += block->size;
+    ++stats_.num_allocated_blocks;
+
+    Buffer buf;
+    buf.device = dev;
+    buf.data = block->ptr;
+    buf.size = block->size;
+    buf.alloc_type = kBestFit;
+    VLOG(1) << "allocate " << buf.size << " B, allocated " << stats_.allocated_bytes
+            << " B, reserved " << reserved_memory_ << " B";
+    return buf;
+  }
+
+  Buffer Alloc(Device dev, ffi::Shape shape, DLDataType type_hint,
+               const std::string& mem_scope) override {
+    if (AllowMemoryScope(mem_scope)) {
+      return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+    }
+    LOG(FATAL) << "BestFitAllocator does not support memory scope " << mem_scope;
+    return {};
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = allocated_blocks_.find(buffer.data);
+    ICHECK(it != allocated_blocks_.end())
+        << "BestFitAllocator: freeing a buffer that was not allocated by this allocator";
+    Block* block = it->second;
+    allocated_blocks_.erase(it);
+    block->allocated = false;
+    stats_.allocated_bytes -= block->size;
+    --stats_.num_allocated_blocks;
+    block = MergeBlock(block, block->prev);
+    block = MergeBlock(block, block->next);
+    InsertFreeBlock(block);
+    VLOG(1) << "reclaim buffer " << buffer.size;
+  }
+
+  void Clear() override { ReleaseAll(); }
+
+  size_t UsedMemory() const override { return reserved_memory_.load(std::memory_order_relaxed); }
+
+  /*! \return A snapshot of the current allocator statistics. */
+  Stats GetStats() {
+    std::lock_guard<std::mutex> lock(mu_);
+    Stats ret = stats_;
+    ret.reserved_bytes = reserved_memory_.load(std::memory_order_relaxed);
+    ret.num_segments = segments_.size();
+    ret.num_free_blocks = 0;
+    ret.largest_free_block = 0;
+    for (const auto& bin : free_bins_) {
+      ret.num_free_blocks += bin.size();
+      if (!bin.empty()) {
+        ret.largest_free_block = std::max(ret.largest_free_block, (*bin.rbegin())->size);
+      }
+    }
+    for (const auto& kv : whole_free_blocks_) {
+      ret.num_free_blocks += kv.second.size();
+      if (!kv.second.empty()) ret.largest_free_block = std::max(ret.largest_free_block, kv.first);
+    }
+    return ret;
+  }
+
+ protected:
+  virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
+                                     DLDataType type_hint) {
+    return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
+  }
+
+  virtual void DeviceFreeDataSpace(Device dev, void* ptr) {
+    DeviceAPI::Get(dev)->FreeDataSpace(dev, ptr);
+  }
+
+  /*!
+   * \brief Whether pointers returned by the device API of \p dev can be offset on the host
+   *  to address a sub-range of the allocation.
+   */
+  virtual bool SupportsSubAllocation(Device dev) const {
+    switch (static_cast<int>(dev.device_type)) {
+      case kDLCPU:
+      case kDLCUDA:
+      case kDLCUDAHost:
+      case kDLCUDAManaged:
+      case kDLROCM:
+      case kDLROCMHost:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /*! \brief Release every segment that has no live allocation in it. */
+  virtual void ReleaseAll() {
+    std::lock_guard<std::mutex> lock(mu_);
+    ReleaseFreeSegments();
+    VLOG(1) << "release all unused segments";
+  }
+
+ private:
+  /*! \brief A contiguous range of a segment, either handed out or free. */
+  struct Block {
+    Device device;
+    uint8_t* ptr{nullptr};
+    size_t size{0};
+    /*! \brief The alignment the segment of this block was reserved with. */
+    size_t alignment{0};
+    bool allocated{false};
+    /*! \brief Whether this block may be split and merged with its neighbors. */
+    bool splittable{true};
+    /*! \brief The block starting the segment this block belongs to. */
+    Block* head{nullptr};
+    Block* prev{nullptr};
+    Block* next{nullptr};
+  };
+
+  /*! \brief Order blocks by size and then address, so lower_bound gives the best fit. */
+  struct BlockLess {
+    bool operator()(const Block* lhs, const Block* rhs) const {
+      if (lhs->size != rhs->size) return lhs->size < rhs->size;
+      return lhs->ptr < rhs->ptr;
+    }
+  };
+
+  /*! \brief Number of power-of-two size classes. */
+  static constexpr int kNumBins = 64;
+
+  static size_t RoundSize(size_t nbytes) {
+    if (nbytes < kMinBlockSize) return kMinBlockSize;
+    return (nbytes + kMinBlockSize - 1) / kMinBlockSize * kMinBlockSize;
+  }
+
+  static size_t SegmentSize(size_t size) {
+    if (size <= kSmallSize) return kSmallSegmentSize;
+    if (size < kMediumSize) return kMediumSegmentSize;
+    return (size + kLargeRoundSize - 1) / kLargeRoundSize * kLargeRoundSize;
+  }
+
+  /*! \brief The size class of a block: floor(log2(size)). */
+  static int BinIndex(size_t size) {
+    int bin = 0;
+    while (size >>= 1) ++bin;
+    return bin;
+  }
+
+  /*! \brief Whether a remainder of \p remaining bytes is worth splitting off \p block. */
+  static bool ShouldSplit(const Block* block, size_t remaining) {
+    if (!block->splittable) return false;
+    // Small blocks are split eagerly; large ones only when the remainder is sizeable, which
+    // keeps small requests from chopping up segments reserved for large tensors.
+    return block->size <= kSmallSegmentSize ? remaining >= kMinBlockSize : remaining > kSmallSize;
+  }
+
+  void InsertFreeBlock(Block* block) {
+    if (block->splittable) {
+      free_bins_[BinIndex(block->size)].insert(block);
+    } else {
+      whole_free_blocks_[block->size].push_back(block);
+    }
+  }
+
+  void EraseFreeBlock(Block* block) {
+    if (block->splittable) {
+      free_bins_[BinIndex(block->size)].erase(block);
+      return;
+    }
+    auto it = whole_free_blocks_.find(block->size);
+    ICHECK(it != whole_free_blocks_.end());
+    auto& blocks = it->second;
+    blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+    if (blocks.empty()) whole_free_blocks_.erase(it);
+  }
+
+  /*!
+   * \brief Find and detach a free non-splittable block of exactly \p size bytes, or nullptr.
+   *
+   *  Such blocks are whole segments that cannot be offset into, so they are reused like
+   *  the pooled allocator reuses buffers: on an exact size match with an alignment at least
+   *  as strict as requested.
+   */
+  Block* FindWholeBlock(Device dev, size_t size, size_t alignment) {
+    auto it = whole_free_blocks_.find(size);
+    if (it == whole_free_blocks_.end()) return nullptr;
+    for (Block* block : it->second) {
+      if (block->device.device_type == dev.device_type &&
+          block->device.device_id == dev.device_id && block->alignment >= alignment) {
+        EraseFreeBlock(block);
+        return block;
+      }
+    }
+    return nullptr;
+  }
+
+  /*! \brief Find and detach the smallest free block that fits \p size, or nullptr. */
+  Block* FindFreeBlock(size_t size) {
+    Block key;
+    key.size = size;
+    for (int bin = BinIndex(size); bin < kNumBins; ++bin) {
+      auto& free_set = free_bins_[bin];
+      // Bins cover disjoint, increasing size ranges, so the first hit is the best fit.
+      auto it = free_set.lower_bound(&key);
+      if (it != free_set.end()) {
+        Block* block = *it;
+        free_set.erase(it);
+        return block;
+      }
+    }
+    return nullptr;
+  }
+
+  /*! \brief Carve \p size bytes from the front of \p block, returning the remainder to bins. */
+  Block* SplitBlock(Block* block, size_t size) {
+    ICHECK_GE(block->size, size);
+    size_t remaining = block->size - size;
+    if (!ShouldSplit(block, remaining)) return block;
+    Block* rest = new Block();
+    rest->device = block->device;
+    rest->ptr = block->ptr + size;
+    rest->size = remaining;
+    rest->head = block->head;
+    rest->prev = block;
+    rest->next = block->next;
+    if (block->next != nullptr) block->next->prev = rest;
+    block->next = rest;
+    block->size = size;
+    InsertFreeBlock(rest);
+    return block;
+  }
+
+  /*! \brief Merge the free neighbor \p other into \p block, returning the surviving block. */
+  Block* MergeBlock(Block* block, Block* other) {
+    if (other == nullptr || other->allocated) return block;
+    EraseFreeBlock(other);
+    Block* first = block->ptr < other->ptr ? block : other;
+    Block* second = first == block ? other : block;
+    first->size += second->size;
+    first->next = second->next;
+    if (second->next != nullptr) second->next->prev = first;
+    delete second;
+    return first;
+  }
+
+  Block* ReserveSegment(Device dev, size_t size, size_t alignment, DLDataType type_hint,
+                        bool splittable) {
+    void* data = nullptr;
+    alignment = std::max(alignment, kMinBlockSize);
+    try {
+      data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "BestFitAllocator got InternalError during allocation: " << err.what();
+      LOG(WARNING) << "Trying to release all unused segments and reallocate...";
+      ++stats_.num_oom_releases;
+      ReleaseFreeSegments();
+      data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    }
+    Block* block = new Block();
+    block->device = dev;
+    block->ptr = static_cast<uint8_t*>(data);
+    block->size = size;
+    block->alignment = alignment;
+    block->splittable = splittable;
+    block->head = block;
+    segments_.emplace(block->ptr, size);
+    reserved_memory_.fetch_add(size, std::memory_order_relaxed);
+    return block;
+  }
+
+  void ReleaseFreeSegments() {
+    std::vector<Block*> to_release;
+    for (const auto& bin : free_bins_) {
+      for (Block* block : bin) {
+        // A free block spanning a whole segment means the segment is unused.
+        if (block->head == block && block->next == nullptr) {
+          to_release.push_back(block);
+        }
+      }
+    }
+    for (const auto& kv : whole_free_blocks_) {
+      to_release.insert(to_release.end(), kv.second.begin(), kv.second.end());
+    }
+    for (Block* block : to_release) {
+      EraseFreeBlock(block);
+      DeviceFreeDataSpace(block->device, block->ptr);
+      segments_.erase(block->ptr);
+      reserved_memory_.fetch_sub(block->size, std::memory_order_relaxed);
+      delete block;
+    }
+  }
+
+  /*! \brief Free blocks, one set per power-of-two size class. */
+  std::array<std::set<Block*, BlockLess>, kNumBins> free_bins_;
+  /*! \brief Free non-splittable blocks, keyed by size. */
+  std::unordered_map<size_t, std::vector<Block*>> whole_free_blocks_;
+  /*! \brief Blocks handed out to callers, keyed by their data pointer. */
+  std::unordered_map<void*, Block*> allocated_blocks_;
+  /*! \brief Reserved segments, keyed by base pointer, valued by size. */
+  std::unordered_map<void*, size_t> segments_;
+  std::atomic<size_t> reserved_memory_;
+  Stats stats_;
+  std::mutex mu_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_BEST_FIT_ALLOCATOR_H_
@@ -28,6 +28,7 @@
 #include <memory>
 #include <utility>
 
+#include "best_fit_allocator.h"
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
 
@@ -149,7 +150,20 @@ Allocator* GetDeviceSpecificAllocator(Device dev, AllocatorType type) {
   auto device_alloc_helper = tvm::ffi::Function::GetGlobal("DeviceAllocator." + dev_str);
   void* valloc;
   Allocator* allocator = nullptr;
-  if (device_alloc_helper) {
+  if (type == kStreamOrdered) {
+    std::string name = "DeviceAllocator.stream_ordered.";
+    name += DLDeviceType2Str(dev.device_type);
+    // The devices without stream-ordered allocation, e.g. the host device every VM has, fall back
+    // to the pooled allocator, which does not synchronize on frees either.
+    if (auto stream_ordered_helper = tvm::ffi::Function::GetGlobal(name)) {
+      VLOG(1) << "New stream-ordered allocator for " << dev;
+      valloc = (*stream_ordered_helper)(dev).cast<void*>();
+      return static_cast<Allocator*>(valloc);
+    }
+    type = kPooled;
+  }
+  // Device specific allocators only provide the naive and pooled strategies.
+  if (device_alloc_helper && type != kBestFit) {
     valloc = (*device_alloc_helper)(dev, static_cast<int>(type)).cast<void*>();
     allocator = static_cast<Allocator*>(valloc);
   }
@@ -165,6 +179,11 @@ Allocator* GetDeviceSpecificAllocator(Device dev, AllocatorType type) {
         allocator = new PooledAllocator();
         break;
       }
+      case kBestFit: {
+        VLOG(1) << "New best-fit allocator for " << dev;
+        allocator = new BestFitAllocator();
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
@@ -267,7 +286,25 @@ void Allocator::Clear() {
 
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("vm.builtin.memory_manager.clear", MemoryManager::Clear);
+  refl::GlobalDef()
+      .def("vm.builtin.memory_manager.clear", MemoryManager::Clear)
+      .def("vm.builtin.memory_manager.best_fit_stats", [](Device dev) {
+        auto* allocator = static_cast<BestFitAllocator*>(
+            MemoryManager::GetOrCreateAllocator(dev, kBestFit));
+        BestFitAllocator::Stats stats = allocator->GetStats();
+        ffi::Map<ffi::String, ffi::Any> ret;
+        ret.Set("reserved_bytes", static_cast<int64_t>(stats.reserved_bytes));
+        ret.Set("allocated_bytes", static_cast<int64_t>(stats.allocated_bytes));
+        ret.Set("num_segments", static_cast<int64_t>(stats.num_segments));
+        ret.Set("num_allocated_blocks", static_cast<int64_t>(stats.num_allocated_blocks));
+        ret.Set("num_free_blocks", static_cast<int64_t>(stats.num_free_blocks));
+        ret.Set("largest_free_block", static_cast<int64_t>(stats.largest_free_block));
+        ret.Set("num_cache_hits", static_cast<int64_t>(stats.num_cache_hits));
+        ret.Set("num_cache_misses", static_cast<int64_t>(stats.num_cache_misses));
+        ret.Set("num_oom_releases", static_cast<int64_t>(stats.num_oom_releases));
+        ret.Set("fragmentation", stats.fragmentation());
+        return ret;
+      });
 }
 
 }  // namespace memory
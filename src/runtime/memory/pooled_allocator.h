@@ -27,9 +27,11 @@
 #include <tvm/runtime/memory/memory_manager.h>
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -39,16 +41,46 @@ namespace memory {
 class PooledAllocator : public Allocator {
  public:
   static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief Default number of freed buffers each thread keeps in front of the shared pool. */
+  static constexpr size_t kDefaultThreadCacheCapacity = 8;
 
-  explicit PooledAllocator(size_t page_size = kDefaultPageSize)
-      : Allocator(kPooled), page_size_(page_size), used_memory_(0) {}
+  /*!
+   * \brief Construct a pooled allocator.
+   * \param page_size The granularity that allocation sizes are rounded to.
+   * \param thread_cache_capacity The number of recently freed buffers each thread caches
+   *  locally before returning them to the shared pool. Zero disables the thread caches.
+   */
+  explicit PooledAllocator(size_t page_size = kDefaultPageSize,
+                           size_t thread_cache_capacity = kDefaultThreadCacheCapacity)
+      : Allocator(kPooled),
+        page_size_(page_size),
+        used_memory_(0),
+        thread_cache_capacity_(thread_cache_capacity),
+        id_(NextAllocatorId()) {}
 
   ~PooledAllocator() { ReleaseAll(); }
 
   Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
+    if (thread_cache_capacity_ != 0) {
+      ThreadCache* cache = GetThreadCache();
+      if (std::vector<Buffer>* buffers = cache->Acquire()) {
+        for (auto it = buffers->rbegin(); it != buffers->rend(); ++it) {
+          if (it->size == size) {
+            Buffer ret = *it;
+            buffers->erase(std::next(it).base());
+            cache->Release(buffers);
+            return ret;
+          }
+        }
+        cache->Release(buffers);
+      }
+    }
+    std::lock_guard<std::recursive_mutex> lock(mu_);
     auto&& it = memory_pool_.find(size);
+    if ((it == memory_pool_.end() || it->second.empty()) && ReclaimOrphanedThreadCaches()) {
+      it = memory_pool_.find(size);
+    }
     if (it != memory_pool_.end() && !it->second.empty()) {
       auto&& pool = it->second;
       auto ret = pool.back();
@@ -83,12 +115,29 @@ class PooledAllocator : public Allocator {
   }
 
   void Free(const Buffer& buffer) override {
+    std::vector<Buffer> spilled;
+    ThreadCache* cache = thread_cache_capacity_ != 0 ? GetThreadCache() : nullptr;
+    std::vector<Buffer>* buffers = cache != nullptr ? cache->Acquire() : nullptr;
+    if (buffers != nullptr) {
+      if (buffers->size() < thread_cache_capacity_) {
+        buffers->push_back(buffer);
+        cache->Release(buffers);
+        return;
+      }
+      // Return the older half of the cache to the shared pool in one batch.
+      size_t num_spill = (buffers->size() + 1) / 2;
+      spilled.assign(buffers->begin(), buffers->begin() + num_spill);
+      buffers->erase(buffers->begin(), buffers->begin() + num_spill);
+      buffers->push_back(buffer);
+      cache->Release(buffers);
+    } else {
+      spilled.push_back(buffer);
+    }
     std::lock_guard<std::recursive_mutex> lock(mu_);
-    if (memory_pool_.find(buffer.size) == memory_pool_.end()) {
-      memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
+    for (const Buffer& buf : spilled) {
+      memory_pool_[buf.size].push_back(buf);
+      VLOG(1) << "reclaim buffer " << buf.size;
     }
-    memory_pool_.at(buffer.size).push_back(buffer);
-    VLOG(1) << "reclaim buffer " << buffer.size;
   }
 
   void Clear() override { ReleaseAll(); }
@@ -107,6 +156,16 @@ class PooledAllocator : public Allocator {
 
   virtual void ReleaseAll() {
     std::lock_guard<std::recursive_mutex> lock(mu_);
+    for (auto const& cache : thread_caches_) {
+      // A cache its owner is using right now is skipped, its buffers stay cached.
+      std::vector<Buffer>* buffers = cache->Acquire();
+      if (buffers == nullptr) continue;
+      for (auto const& buf : *buffers) {
+        DeviceFreeDataSpace(buf.device, buf.data);
+      }
+      buffers->clear();
+      cache->Release(buffers);
+    }
     for (auto const& it : memory_pool_) {
       auto const& pool = it.second;
       for (auto const& buf : pool) {
@@ -119,10 +178,109 @@ class PooledAllocator : public Allocator {
   }
 
  protected:
+  /*!
+   * \brief A per-thread cache of recently freed buffers.
+   *
+   * The buffer list is handed around through an atomic pointer instead of a lock: whoever
+   * exchanges it out owns it until it is stored back. The owning thread takes it on the
+   * Alloc/Free path and ReleaseAll takes it to drain the cache. Neither ever waits, a party
+   * that finds the list taken falls back to the shared pool or skips the cache.
+   */
+  struct ThreadCache {
+    std::vector<Buffer> storage;
+    std::atomic<std::vector<Buffer>*> buffers{&storage};
+    /*! \brief Set when the owning thread exits, the cache can then be reclaimed. */
+    std::atomic<bool> exited{false};
+
+    /*! \return The buffer list, or nullptr if another party holds it. */
+    std::vector<Buffer>* Acquire() { return buffers.exchange(nullptr, std::memory_order_acquire); }
+
+    void Release(std::vector<Buffer>* list) { buffers.store(list, std::memory_order_release); }
+  };
+
+  /*!
+   * \brief The thread caches of the calling thread, one per allocator it used.
+   *
+   * The allocator owns its caches. A thread only holds weak references, so entries of
+   * destroyed allocators are pruned, and on thread exit the caches that are still alive
+   * are flagged for the allocator to reclaim.
+   */
+  struct ThreadCacheMap {
+    struct Entry {
+      ThreadCache* cache;
+      std::weak_ptr<ThreadCache> ref;
+    };
+    std::unordered_map<uint64_t, Entry> entries;
+
+    ~ThreadCacheMap() {
+      for (auto& kv : entries) {
+        if (std::shared_ptr<ThreadCache> cache = kv.second.ref.lock()) {
+          cache->exited.store(true, std::memory_order_release);
+        }
+      }
+    }
+  };
+
+  /*! \brief Get the cache of the calling thread, creating it on first use. */
+  ThreadCache* GetThreadCache() {
+    // Keyed by a unique allocator id rather than by address, so that a new allocator
+    // reusing the address of a destroyed one never observes a stale cache. The raw pointer
+    // is safe to use here since this allocator, the owner of the cache, is alive.
+    thread_local ThreadCacheMap caches;
+    auto it = caches.entries.find(id_);
+    if (it != caches.entries.end()) {
+      return it->second.cache;
+    }
+    for (auto entry = caches.entries.begin(); entry != caches.entries.end();) {
+      entry = entry->second.ref.expired() ? caches.entries.erase(entry) : std::next(entry);
+    }
+    auto cache = std::make_shared<ThreadCache>();
+    {
+      std::lock_guard<std::recursive_mutex> lock(mu_);
+      thread_caches_.push_back(cache);
+    }
+    caches.entries.emplace(id_, ThreadCacheMap::Entry{cache.get(), cache});
+    return cache.get();
+  }
+
+  /*!
+   * \brief Move the buffers cached by exited threads back to the shared pool.
+   * \return Whether any buffer was reclaimed.
+   * \note Requires mu_ to be held.
+   */
+  bool ReclaimOrphanedThreadCaches() {
+    bool reclaimed = false;
+    for (auto it = thread_caches_.begin(); it != thread_caches_.end();) {
+      std::vector<Buffer>* buffers =
+          (*it)->exited.load(std::memory_order_acquire) ? (*it)->Acquire() : nullptr;
+      if (buffers != nullptr) {
+        for (const Buffer& buf : *buffers) {
+          memory_pool_[buf.size].push_back(buf);
+          reclaimed = true;
+        }
+        it = thread_caches_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return reclaimed;
+  }
+
+  static uint64_t NextAllocatorId() {
+    static std::atomic<uint64_t> next_id{0};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
   size_t page_size_;
   std::atomic<size_t> used_memory_;
   std::unordered_map<size_t, std::vector<Buffer>> memory_pool_;
   std::recursive_mutex mu_;
+  /*! \brief Capacity of each thread cache, zero if thread caches are disabled. */
+  size_t thread_cache_capacity_;
+  /*! \brief The unique id of this allocator, used to look up the thread caches. */
+  uint64_t id_;
+  /*! \brief All thread caches of this allocator, kept alive past the exit of their thread. */
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
 };
 
 }  // namespace memory
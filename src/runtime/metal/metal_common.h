@@ -28,6 +28,7 @@
 #import <Metal/MTLBuffer.h>
 #import <Metal/MTLCommandBuffer.h>
 #import <Metal/MTLCommandQueue.h>
+#import <Metal/MTLComputeCommandEncoder.h>
 #import <Metal/MTLDevice.h>
 #import <Metal/MTLLibrary.h>
 #include <tvm/ffi/function.h>
@@ -37,6 +38,7 @@
 
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -108,8 +110,16 @@ class AutoReleasePoolWrapper {
 class Stream {
  public:
   explicit Stream(id<MTLDevice> device) { queue_ = [device newCommandQueue]; }
-  ~Stream() { [queue_ release]; }
+  ~Stream() {
+    FlushBatch();
+    [queue_ release];
+  }
+  /*!
+   * \brief Get a new command buffer, after committing the batched kernels so that the commands
+   *  encoded into it run after them.
+   */
   id<MTLCommandBuffer> GetCommandBuffer(std::string label = "", bool attach_error_callback = true) {
+    FlushBatch();
     id<MTLCommandBuffer> cb = [queue_ commandBuffer];
     if (!label.empty()) {
       cb.label = [NSString stringWithUTF8String:label.c_str()];
@@ -132,9 +142,75 @@ class Stream {
 
   const std::string& ErrorDescription() const { return error_description_; }
 
+  /*!
+   * \brief Get the compute encoder of the batch the next kernel is encoded into.
+   *
+   * The kernels of a batch share one command buffer and one compute encoder, which are committed
+   * at the next synchronization or copy on the stream, or once the batch is full, instead of one
+   * command buffer committed per kernel. The encoder dispatches serially, so the kernels still
+   * run in order.
+   *
+   * \param func_name The name of the kernel, reported if the batch fails.
+   */
+  id<MTLComputeCommandEncoder> GetBatchEncoder(const std::string& func_name) {
+    if (batch_encoder_ != nil && batch_size_ >= max_batch_size_) {
+      FlushBatch();
+    }
+    if (batch_encoder_ == nil) {
+      batch_cb_ = [[queue_ commandBuffer] retain];
+      batch_cb_.label = @"TVMKernelBatch";
+      batch_encoder_ = [[batch_cb_ computeCommandEncoder] retain];
+    }
+    ++batch_size_;
+    batch_last_kernel_ = func_name;
+    return batch_encoder_;
+  }
+
+  /*! \brief Commit the batched kernels, if any. */
+  void FlushBatch() {
+    if (batch_encoder_ == nil) return;
+    [batch_encoder_ endEncoding];
+    std::ostringstream os;
+    os << "GPUError happens in a batch of " << batch_size_ << " kernels ending with "
+       << batch_last_kernel_ << ": ";
+    std::string prefix = os.str();
+    [batch_cb_ addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+      if (buffer.status == MTLCommandBufferStatusError) {
+        ICHECK(buffer.error != nil);
+        this->SetError(prefix + buffer.error.localizedDescription.UTF8String);
+      }
+    }];
+    [batch_cb_ commit];
+    [batch_encoder_ release];
+    [batch_cb_ release];
+    batch_encoder_ = nil;
+    batch_cb_ = nil;
+    batch_size_ = 0;
+  }
+
+  /*!
+   * \brief Set whether to batch the kernels launched on the stream.
+   * \param max_batch_size The maximum number of kernels in a batch, 0 to stop batching.
+   */
+  void SetMaxBatchSize(int max_batch_size) {
+    FlushBatch();
+    max_batch_size_ = max_batch_size;
+  }
+
+  bool IsBatching() const { return max_batch_size_ > 0; }
+
  private:
   // Queue
   id<MTLCommandQueue> queue_;
+  // The maximum number of kernels in a batch, or 0 if the kernels are not batched.
+  int max_batch_size_{0};
+  // The command buffer and the compute encoder of the current batch, nil if there is none.
+  id<MTLCommandBuffer> batch_cb_{nil};
+  id<MTLComputeCommandEncoder> batch_encoder_{nil};
+  // The number of kernels in the current batch
+  int batch_size_{0};
+  // The name of the last kernel in the current batch
+  std::string batch_last_kernel_;
   // Check if error happened in one previous run
   bool error_happened_{false};
   // error description
@@ -361,7 +361,14 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                     *rv = static_cast<void*>(ptr);
                   })
       .def("metal.ResetGlobalState",
-           []() { MetalWorkspace::Global()->ReinitializeDefaultStreams(); });
+           []() { MetalWorkspace::Global()->ReinitializeDefaultStreams(); })
+      .def("device_api.metal.set_command_batching", [](Device dev, int max_batch_size) {
+        CHECK_EQ(dev.device_type, kDLMetal) << "ValueError: Expect a Metal device, but got " << dev;
+        CHECK_GE(max_batch_size, 0) << "ValueError: The batch size must be non-negative";
+        MetalWorkspace* ws = MetalWorkspace::Global();
+        ws->CastStreamOrGetDefault(ws->GetCurrentStream(dev), dev.device_id)
+            ->SetMaxBatchSize(max_batch_size);
+      });
 }
 
 class MetalTimerNode : public TimerNode {
@@ -25,8 +25,12 @@
 #include <nvtx3/nvToolsExt.h>
 #endif  // TVM_NVTX_ENABLED
 
+#include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/nvtx.h>
 
+#include <atomic>
+#include <cstdlib>
+
 namespace tvm {
 namespace runtime {
 
@@ -38,5 +42,30 @@ NVTXScopedRange::NVTXScopedRange(const char* name) {}
 NVTXScopedRange::~NVTXScopedRange() {}
 #endif  // TVM_NVTX_ENABLED
 
+static std::atomic<bool>& NVTXRangesFlag() {
+  static std::atomic<bool> enabled([] {
+    const char* env = std::getenv("TVM_NVTX_RANGES");
+    return env != nullptr && std::string(env) != "0";
+  }());
+  return enabled;
+}
+
+bool NVTXRangesEnabled() {
+#if TVM_NVTX_ENABLED
+  return NVTXRangesFlag().load(std::memory_order_relaxed);
+#else
+  return false;
+#endif  // TVM_NVTX_ENABLED
+}
+
+void SetNVTXRangesEnabled(bool enabled) { NVTXRangesFlag().store(enabled); }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("runtime.profiling.SetNVTXRangesEnabled", SetNVTXRangesEnabled)
+      .def("runtime.profiling.NVTXRangesEnabled", NVTXRangesEnabled);
+}
+
 }  // namespace runtime
 }  // namespace tvm
@@ -84,6 +84,9 @@ using tvm::runtime::memory::Buffer;
 
 static_assert(sizeof(cl_mem) == sizeof(void*), "Required to store cl_mem inside void*");
 
+// Get a string property of a device.
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
+
 inline const char* CLGetErrorString(cl_int error) {
   switch (error) {
     case CL_SUCCESS:
@@ -261,6 +264,13 @@ class OpenCLWorkspace : public DeviceAPI {
   std::vector<size_t> free_kernel_ids;
   // the mutex for initialization
   std::mutex mu;
+  // Whether the copies from the host return right after they are enqueued, instead of waiting for
+  // the queue to drain. Set by TVM_OPENCL_ASYNC_HOST_COPY=1.
+  bool async_host_copy{false};
+  // The events and the staged host data of the asynchronous copies from the host, per device.
+  std::vector<std::vector<std::pair<cl_event, std::unique_ptr<char[]>>>> pending_host_copies;
+  // the mutex of the pending copies
+  std::mutex pending_host_copies_mu;
 
   // destructor
   ~OpenCLWorkspace() {
@@ -287,6 +297,10 @@ class OpenCLWorkspace : public DeviceAPI {
         << "Invalid OpenCL device_id=" << dev.device_id << ". " << GetError();
     return queues[dev.device_id];
   }
+  // Track an asynchronous copy from the host, which owns its staged host data until it completes.
+  void AddPendingHostCopy(Device dev, cl_event event, std::unique_ptr<char[]> staging);
+  // Release the staged host data of the completed copies from the host.
+  void ReleaseCompletedHostCopies(Device dev);
   // get the event queue of the context
   std::vector<cl_event>& GetEventQueue(Device dev) {
     ICHECK(IsOpenCLDevice(dev));
@@ -528,6 +542,16 @@ class OpenCLModuleNode : public OpenCLModuleNodeBase {
                           const std::string& func_name, const KTRefEntry& e) override;
 
  private:
+  // The path of the cached program binary of a kernel for a device, or empty if the cache is
+  // disabled. The path depends on the source of the kernel, the device and its driver.
+  std::string ProgramBinaryCachePath(cl::OpenCLWorkspace* w, const std::string& func_name,
+                                     int device_id);
+  // Create and build the program of a kernel from its cached binary, return false on a miss.
+  bool LoadCachedProgram(cl::OpenCLWorkspace* w, const std::string& func_name, int device_id,
+                         const std::string& path);
+  // Save the binary of the built program of a kernel into the cache.
+  void SaveCachedProgram(const std::string& func_name, int device_id, const std::string& path);
+
   // the binary data
   std::string data_;
   // The format
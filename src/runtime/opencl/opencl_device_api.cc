@@ -26,8 +26,11 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/profiling.h>
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
+#include "../../support/utils.h"
 #include "../memory/pooled_allocator.h"
 #include "opencl_common.h"
 
@@ -562,23 +565,39 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
     OPENCL_CALL(clFinish(this->GetQueue(from->device)));
   } else if (from->device.device_type == kDLCPU && IsOpenCLDevice(to->device)) {
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
+    const char* host_data = static_cast<const char*>(from->data) + from->byte_offset;
+    std::unique_ptr<char[]> staging;
+    cl_event event = nullptr;
+    cl_event* event_ptr = nullptr;
+    if (async_host_copy) {
+      // Stage the data, so that the caller may release the host memory before the copy completes.
+      // The queue is in order, so the copy still completes before the kernels enqueued after it.
+      staging.reset(new char[nbytes]);
+      std::memcpy(staging.get(), host_data, nbytes);
+      host_data = staging.get();
+      event_ptr = &event;
+    }
     switch (to_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
-        OPENCL_CALL(clEnqueueWriteBuffer(
-            this->GetQueue(to->device), to_desc->buffer, CL_FALSE, to->byte_offset, nbytes,
-            static_cast<const char*>(from->data) + from->byte_offset, 0, nullptr, nullptr));
+        OPENCL_CALL(clEnqueueWriteBuffer(this->GetQueue(to->device), to_desc->buffer, CL_FALSE,
+                                         to->byte_offset, nbytes, host_data, 0, nullptr,
+                                         event_ptr));
         break;
       case cl::BufferDescriptor::MemoryLayout::kImage2DActivation:
       case cl::BufferDescriptor::MemoryLayout::kImage2DWeight:
       case cl::BufferDescriptor::MemoryLayout::kImage2DNHWC:
         auto image_info = GetImageInfo(to_desc, to);
-        OPENCL_CALL(clEnqueueWriteImage(
-            this->GetQueue(to->device), to_desc->buffer, CL_FALSE, image_info.origin,
-            image_info.region, image_info.row_pitch, image_info.slice_pitch,
-            static_cast<const char*>(from->data) + from->byte_offset, 0, nullptr, nullptr));
+        OPENCL_CALL(clEnqueueWriteImage(this->GetQueue(to->device), to_desc->buffer, CL_FALSE,
+                                        image_info.origin, image_info.region, image_info.row_pitch,
+                                        image_info.slice_pitch, host_data, 0, nullptr, event_ptr));
         break;
     }
-    OPENCL_CALL(clFinish(this->GetQueue(to->device)));
+    if (async_host_copy) {
+      OPENCL_CALL(clFlush(this->GetQueue(to->device)));
+      AddPendingHostCopy(to->device, event, std::move(staging));
+    } else {
+      OPENCL_CALL(clFinish(this->GetQueue(to->device)));
+    }
   } else {
     LOG(FATAL) << "Expect copy from/to OpenCL or between OpenCL";
   }
@@ -588,6 +607,36 @@ void OpenCLWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   this->Init();
   ICHECK(stream == nullptr);
   OPENCL_CALL(clFinish(this->GetQueue(dev)));
+  ReleaseCompletedHostCopies(dev);
+}
+
+void OpenCLWorkspace::AddPendingHostCopy(Device dev, cl_event event,
+                                         std::unique_ptr<char[]> staging) {
+  ReleaseCompletedHostCopies(dev);
+  std::lock_guard<std::mutex> lock(pending_host_copies_mu);
+  if (pending_host_copies.size() <= static_cast<size_t>(dev.device_id)) {
+    pending_host_copies.resize(dev.device_id + 1);
+  }
+  pending_host_copies[dev.device_id].emplace_back(event, std::move(staging));
+}
+
+void OpenCLWorkspace::ReleaseCompletedHostCopies(Device dev) {
+  std::lock_guard<std::mutex> lock(pending_host_copies_mu);
+  if (pending_host_copies.size() <= static_cast<size_t>(dev.device_id)) {
+    return;
+  }
+  auto& pending = pending_host_copies[dev.device_id];
+  auto it = std::remove_if(pending.begin(), pending.end(), [](auto& copy) {
+    cl_int status;
+    OPENCL_CALL(clGetEventInfo(copy.first, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(cl_int),
+                               &status, nullptr));
+    if (status != CL_COMPLETE) {
+      return false;
+    }
+    OPENCL_CALL(clReleaseEvent(copy.first));
+    return true;
+  });
+  pending.erase(it, pending.end());
 }
 
 void* OpenCLWorkspace::AllocWorkspace(Device dev, size_t size, DLDataType type_hint) {
@@ -757,6 +806,7 @@ void OpenCLWorkspace::Init(const std::string& type_key, const std::string& devic
     OPENCL_CHECK_ERROR(err_code);
   }
   this->events.resize(this->devices.size());
+  this->async_host_copy = support::BoolEnvironmentVar("TVM_OPENCL_ASYNC_HOST_COPY");
   initialized_ = true;
 }
 
@@ -809,6 +859,14 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       });
 }
 
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("device_api.opencl.set_async_host_copy", [](bool enable) {
+    cl::OpenCLWorkspace::Global()->Init();
+    cl::OpenCLWorkspace::Global()->async_host_copy = enable;
+  });
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef().def("profiling.timer.opencl",
@@ -26,6 +26,11 @@
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -230,6 +235,13 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   int device_id = t->device.device_id;
   auto did = w->GetCLDeviceID(device_id);
   auto platform = w->device_info[did].platform_id;
+  std::string cache_path;
+  if (!IsProgramCreated(func_name, device_id) && fmt_ == "cl") {
+    cache_path = ProgramBinaryCachePath(w, func_name, device_id);
+    if (!cache_path.empty() && LoadCachedProgram(w, func_name, device_id, cache_path)) {
+      cache_path.clear();
+    }
+  }
   if (!IsProgramCreated(func_name, device_id)) {
     // create program
     if (fmt_ == "cl") {
@@ -266,6 +278,9 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
                  << "\nError: " << cl::CLGetErrorString(err) << "\n"
                  << log;
     }
+    if (!cache_path.empty()) {
+      SaveCachedProgram(func_name, device_id, cache_path);
+    }
   }
   // build kernel
   cl_int err;
@@ -277,6 +292,92 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   return kernel;
 }
 
+std::string OpenCLModuleNode::ProgramBinaryCachePath(cl::OpenCLWorkspace* w,
+                                                     const std::string& func_name,
+                                                     int device_id) {
+  const char* env = std::getenv("TVM_OPENCL_BINARY_CACHE");
+  if (env != nullptr && std::string(env) == "0") {
+    return "";
+  }
+  cl_device_id dev = w->devices[device_id];
+  // FNV-1a, which unlike std::hash is stable across builds.
+  uint64_t hash = 14695981039346656037ULL;
+  auto update = [&hash](const std::string& str) {
+    for (char c : str) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    hash = (hash ^ 0xffULL) * 1099511628211ULL;
+  };
+  update(parsed_kernels_[func_name]);
+  update(cl::GetDeviceInfo(dev, CL_DEVICE_NAME));
+  update(cl::GetDeviceInfo(dev, CL_DEVICE_VERSION));
+  update(cl::GetDeviceInfo(dev, CL_DRIVER_VERSION));
+  std::ostringstream os;
+  os << GetCacheDir() << "/opencl_binary/" << std::hex << hash << ".bin";
+  return os.str();
+}
+
+bool OpenCLModuleNode::LoadCachedProgram(cl::OpenCLWorkspace* w, const std::string& func_name,
+                                         int device_id, const std::string& path) {
+  std::ifstream fs(path, std::ios::in | std::ios::binary);
+  if (!fs) {
+    return false;
+  }
+  std::vector<unsigned char> binary((std::istreambuf_iterator<char>(fs)),
+                                    std::istreambuf_iterator<char>());
+  if (binary.empty()) {
+    return false;
+  }
+  cl_device_id dev = w->devices[device_id];
+  auto platform = w->device_info[dev].platform_id;
+  const unsigned char* data = binary.data();
+  size_t size = binary.size();
+  cl_int binary_status, err;
+  cl_program program = clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &size, &data,
+                                                 &binary_status, &err);
+  if (err != CL_SUCCESS || binary_status != CL_SUCCESS) {
+    // The binary is stale or corrupted, rebuild it from the source.
+    if (program != nullptr) clReleaseProgram(program);
+    return false;
+  }
+  if (clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr) != CL_SUCCESS) {
+    clReleaseProgram(program);
+    return false;
+  }
+  programs_[func_name][device_id] = program;
+  return true;
+}
+
+void OpenCLModuleNode::SaveCachedProgram(const std::string& func_name, int device_id,
+                                         const std::string& path) {
+  cl_program program = programs_[func_name][device_id];
+  size_t size = 0;
+  if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &size, nullptr) !=
+          CL_SUCCESS ||
+      size == 0) {
+    return;
+  }
+  std::string binary(size, '\0');
+  unsigned char* data = reinterpret_cast<unsigned char*>(&binary[0]);
+  if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &data, nullptr) !=
+      CL_SUCCESS) {
+    return;
+  }
+  std::string tmp_path = path + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(this));
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+  try {
+    // The program is already built for this run, without the binary the next run only builds
+    // it from source again.
+    if (!ec) {
+      SaveBinaryToFile(tmp_path, binary);
+      std::filesystem::rename(tmp_path, path, ec);
+    }
+  } catch (const std::exception& e) {
+    VLOG(1) << "Failed to cache the OpenCL program binary at " << path << ": " << e.what();
+  }
+}
+
 void OpenCLModuleNode::SetPreCompiledPrograms(const std::string& bytes) {
   workspace_->Init();
   std::string data = bytes;
@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file perf_event_collector.cc
+ * \brief A MetricCollector reading the CPU hardware counters with perf_event_open.
+ */
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/profiling.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#ifdef __linux__
+
+namespace {
+
+/*! \brief A counter to open, and the name of its metric in the reports. */
+struct PerfEventSpec {
+  std::string metric;
+  uint32_t type;
+  uint64_t config;
+};
+
+bool ParsePerfEvent(const std::string& name, PerfEventSpec* spec) {
+  static const std::vector<std::pair<std::string, PerfEventSpec>> known = {
+      {"cycles", {"Cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+      {"instructions", {"Instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+      {"cache-references",
+       {"Cache References", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}},
+      {"cache-misses", {"Cache Misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+      {"branch-misses", {"Branch Misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}},
+  };
+  for (const auto& kv : known) {
+    if (kv.first == name) {
+      *spec = kv.second;
+      return true;
+    }
+  }
+  // raw events of the PMU, such as the FP_ARITH_INST_RETIRED counters of x86 for the FLOPs.
+  if (name.size() > 1 && name[0] == 'r') {
+    char* end = nullptr;
+    uint64_t config = std::strtoull(name.c_str() + 1, &end, 16);
+    if (*end == '\0') {
+      *spec = {name, PERF_TYPE_RAW, config};
+      return true;
+    }
+  }
+  return false;
+}
+
+/*! \brief The counter values at the start of a call. */
+struct PerfEventStartNode : public Object {
+  std::vector<uint64_t> start_values;
+
+  explicit PerfEventStartNode(std::vector<uint64_t> start_values)
+      : start_values(std::move(start_values)) {}
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("PerfEventStartNode", PerfEventStartNode, Object);
+};
+
+}  // namespace
+
+/*!
+ * \brief Collects the CPU hardware counters of the process with perf_event_open.
+ *
+ * The counters are opened with `inherit`, so that they also count the threads created after
+ * them, such as the threads of the TVM thread pool that the profiler resets once the
+ * collectors are created. Reading a counter sums the counts of all the threads.
+ */
+class PerfEventMetricCollectorNode final : public MetricCollectorNode {
+ public:
+  /*!
+   * \brief Open the counters.
+   * \return An empty string on success, otherwise the reason the counters are not available.
+   */
+  std::string Open(const ffi::Array<ffi::String>& events) {
+    for (const ffi::String& event : events) {
+      PerfEventSpec spec;
+      CHECK(ParsePerfEvent(event, &spec))
+          << "ValueError: Unknown perf event \"" << event
+          << "\", expect one of cycles, instructions, cache-references, cache-misses, "
+          << "branch-misses or a raw event r<hex>";
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = spec.type;
+      attr.config = spec.config;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+      if (fd < 0) {
+        return "perf_event_open(" + std::string(event) + ") failed: " + std::strerror(errno);
+      }
+      fds_.push_back(fd);
+      metrics_.push_back(spec.metric);
+    }
+    return "";
+  }
+
+  void Init(ffi::Array<DeviceWrapper> devs) final {}
+
+  ObjectRef Start(Device dev) final {
+    if (dev.device_type != kDLCPU) return ObjectRef(nullptr);
+    return ObjectRef(ffi::make_object<PerfEventStartNode>(Read()));
+  }
+
+  ffi::Map<ffi::String, ffi::Any> Stop(ObjectRef obj) final {
+    const auto* start = obj.as<PerfEventStartNode>();
+    std::vector<uint64_t> end_values = Read();
+    ffi::Map<ffi::String, ffi::Any> reported_metrics;
+    for (size_t i = 0; i < end_values.size(); ++i) {
+      int64_t count = end_values[i] >= start->start_values[i]
+                          ? static_cast<int64_t>(end_values[i] - start->start_values[i])
+                          : -1;
+      reported_metrics.Set(metrics_[i], ObjectRef(ffi::make_object<CountNode>(count)));
+    }
+    return reported_metrics;
+  }
+
+  ~PerfEventMetricCollectorNode() final {
+    for (int fd : fds_) close(fd);
+  }
+
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("runtime.profiling.PerfEventMetricCollector",
+                                    PerfEventMetricCollectorNode, MetricCollectorNode);
+
+ private:
+  /*! \brief Read the counters, scaled up by the time they were multiplexed out. */
+  std::vector<uint64_t> Read() const {
+    std::vector<uint64_t> values;
+    for (int fd : fds_) {
+      // value, time enabled, time running
+      uint64_t data[3] = {0, 0, 0};
+      if (read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+        values.push_back(0);
+        continue;
+      }
+      if (data[2] != 0 && data[2] < data[1]) {
+        data[0] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+      }
+      values.push_back(data[0]);
+    }
+    return values;
+  }
+
+  std::vector<int> fds_;
+  std::vector<std::string> metrics_;
+};
+
+MetricCollector CreatePerfEventMetricCollector(ffi::Array<ffi::String> events,
+                                               std::string* error) {
+  if (events.empty()) events = ffi::Array<ffi::String>{"cycles", "instructions", "cache-misses"};
+  auto node = ffi::make_object<PerfEventMetricCollectorNode>();
+  std::string reason = node->Open(events);
+  if (!reason.empty()) {
+    if (error != nullptr) *error = reason;
+    return MetricCollector();
+  }
+  return MetricCollector(node);
+}
+
+#else
+
+MetricCollector CreatePerfEventMetricCollector(ffi::Array<ffi::String> events,
+                                               std::string* error) {
+  if (error != nullptr) *error = "perf_event_open is only available on Linux";
+  return MetricCollector();
+}
+
+#endif  // __linux__
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("runtime.profiling.PerfEventMetricCollector",
+                        [](ffi::Array<ffi::String> events) {
+                          std::string error;
+                          MetricCollector collector =
+                              CreatePerfEventMetricCollector(events, &error);
+                          CHECK(collector.defined()) << "RuntimeError: " << error;
+                          return collector;
+                        });
+}
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
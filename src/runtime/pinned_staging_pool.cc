@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file pinned_staging_pool.cc
+ * \brief Staging of the copies between pageable host memory and devices through pinned buffers.
+ */
+#include "pinned_staging_pool.h"
+
+#include <tvm/runtime/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+
+size_t GetEnvBytes(const char* name, size_t default_value) {
+  const char* value = std::getenv(name);
+  if (value == nullptr || value[0] == '\0') return default_value;
+  int64_t bytes = std::stoll(value);
+  CHECK_GE(bytes, 0) << "ValueError: " << name << " must not be negative, but got " << value;
+  return static_cast<size_t>(bytes);
+}
+
+/*! \brief Whether the process is exiting, since the first staging buffer was allocated. */
+std::atomic<bool> process_exiting{false};
+
+/*!
+ * \brief Set `process_exiting` at exit. It is created once the device runtime is initialized by
+ *  the first allocation, so that it is destroyed before the runtime is torn down.
+ */
+struct ProcessExitFlag {
+  ~ProcessExitFlag() { process_exiting.store(true); }
+};
+
+/*! \brief A flat byte view of a range of a contiguous tensor. */
+DLTensor ByteRange(const DLTensor* tensor, size_t offset, int64_t* size) {
+  DLTensor view = *tensor;
+  view.ndim = 1;
+  view.shape = size;
+  view.strides = nullptr;
+  view.dtype = DLDataType{kDLUInt, 8, 1};
+  view.byte_offset += offset;
+  return view;
+}
+
+}  // namespace
+
+PinnedStagingPool::PinnedStagingPool()
+    : chunk_bytes_(GetEnvBytes("TVM_PINNED_STAGING_CHUNK_BYTES", 8 << 20)) {}
+
+PinnedStagingPool::~PinnedStagingPool() {
+  if (process_exiting.load()) return;
+  for (auto& [key, buffers] : buffers_) {
+    Device device{static_cast<DLDeviceType>(key.first), key.second};
+    try {
+      Release(device, &buffers, 0);
+      Release(device, &buffers, 1);
+      for (void* staging : buffers.staging) {
+        DeviceAPI::Get(buffers.host_device)->FreeDataSpace(buffers.host_device, staging);
+      }
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to free the pinned staging buffers of " << device << ": "
+                   << e.what();
+    }
+  }
+}
+
+PinnedStagingPool* PinnedStagingPool::ThreadLocal() {
+  static thread_local PinnedStagingPool inst;
+  return &inst;
+}
+
+bool PinnedStagingPool::Enabled(Device device) {
+  return GetPreferredHostDevice(device).device_type != kDLCPU && ThreadLocal()->chunk_bytes_ != 0;
+}
+
+bool PinnedStagingPool::ShouldStage(Device device, size_t nbytes) {
+  static const size_t min_bytes = GetEnvBytes("TVM_PINNED_STAGING_MIN_BYTES", 1 << 20);
+  return nbytes >= min_bytes && Enabled(device);
+}
+
+PinnedStagingPool::Buffers& PinnedStagingPool::GetBuffers(Device device) {
+  Buffers& buffers = buffers_[{device.device_type, device.device_id}];
+  if (buffers.staging[0] == nullptr) {
+    CHECK_NE(chunk_bytes_, 0) << "InternalError: The pinned staging is disabled";
+    buffers.host_device = GetPreferredHostDevice(device);
+    for (int i = 0; i < 2; ++i) {
+      buffers.staging[i] = DeviceAPI::Get(buffers.host_device)
+                               ->AllocDataSpace(buffers.host_device, chunk_bytes_, kAllocAlignment,
+                                                DataType::UInt(8));
+    }
+    static ProcessExitFlag exit_flag;
+  }
+  return buffers;
+}
+
+DLTensor PinnedStagingPool::StagingView(const Buffers& buffers, int index, int64_t* size) {
+  DLTensor view;
+  view.data = buffers.staging[index];
+  view.device = buffers.host_device;
+  view.ndim = 1;
+  view.dtype = DLDataType{kDLUInt, 8, 1};
+  view.shape = size;
+  view.strides = nullptr;
+  view.byte_offset = 0;
+  return view;
+}
+
+void PinnedStagingPool::Release(Device device, Buffers* buffers, int index) {
+  if (buffers->in_flight[index]) {
+    // The streams are in order, so syncing releases the other buffer as well when it is in
+    // flight on the same stream.
+    TVMStreamHandle stream = buffers->stream[index];
+    DeviceAPI::Get(device)->StreamSync(device, stream);
+    for (int i = 0; i < 2; ++i) {
+      if (buffers->stream[i] == stream) buffers->in_flight[i] = false;
+    }
+  }
+}
+
+void PinnedStagingPool::CopyFromHost(const void* data, DLTensor* to, size_t nbytes,
+                                     TVMStreamHandle stream) {
+  ICHECK(IsContiguous(*to));
+  ICHECK_EQ(GetDataSize(*to), nbytes);
+  if (nbytes == 0) return;
+  Device device = to->device;
+  Buffers& buffers = GetBuffers(device);
+  for (size_t offset = 0; offset < nbytes; offset += chunk_bytes_) {
+    int64_t size = static_cast<int64_t>(std::min(chunk_bytes_, nbytes - offset));
+    int index = buffers.next;
+    Release(device, &buffers, index);
+    std::memcpy(buffers.staging[index], static_cast<const char*>(data) + offset, size);
+    DLTensor from = StagingView(buffers, index, &size);
+    DLTensor dst = ByteRange(to, offset, &size);
+    DeviceAPI::Get(device)->CopyDataFromTo(&from, &dst, stream);
+    buffers.stream[index] = stream;
+    buffers.in_flight[index] = true;
+    buffers.next ^= 1;
+  }
+}
+
+void PinnedStagingPool::CopyToHost(const DLTensor* from, void* data, size_t nbytes,
+                                   TVMStreamHandle stream) {
+  ICHECK(IsContiguous(*from));
+  ICHECK_EQ(GetDataSize(*from), nbytes);
+  if (nbytes == 0) return;
+  Device device = from->device;
+  Buffers& buffers = GetBuffers(device);
+  Release(device, &buffers, 0);
+  Release(device, &buffers, 1);
+  int64_t sizes[2];
+  // Issue the copy of a chunk into a buffer.
+  auto issue = [&](size_t offset, int index) {
+    sizes[index] = static_cast<int64_t>(std::min(chunk_bytes_, nbytes - offset));
+    DLTensor src = ByteRange(from, offset, &sizes[index]);
+    DLTensor dst = StagingView(buffers, index, &sizes[index]);
+    DeviceAPI::Get(device)->CopyDataFromTo(&src, &dst, stream);
+  };
+  int index = 0;
+  issue(0, index);
+  for (size_t offset = 0; offset < nbytes; offset += chunk_bytes_) {
+    // Only the chunk of `index` is in flight, the copy of the next chunk out of the device then
+    // overlaps with the host copy of this one.
+    DeviceAPI::Get(device)->StreamSync(device, stream);
+    if (offset + chunk_bytes_ < nbytes) {
+      issue(offset + chunk_bytes_, index ^ 1);
+    }
+    std::memcpy(static_cast<char*>(data) + offset, buffers.staging[index], sizes[index]);
+    index ^= 1;
+  }
+}
+
+void PinnedStagingPool::Sync(Device device) {
+  auto it = buffers_.find({device.device_type, device.device_id});
+  if (it == buffers_.end()) return;
+  Release(device, &it->second, 0);
+  Release(device, &it->second, 1);
+}
+
+}  // namespace runtime
+}  // namespace tvm
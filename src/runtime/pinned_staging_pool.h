@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file pinned_staging_pool.h
+ * \brief Staging of the copies between pageable host memory and devices through pinned buffers.
+ */
+#ifndef TVM_RUNTIME_PINNED_STAGING_POOL_H_
+#define TVM_RUNTIME_PINNED_STAGING_POOL_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/tensor.h>
+
+#include <map>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief A thread-local pool of pinned host buffers, to stage the copies between pageable host
+ *  memory and the devices that have a pinned host memory (CUDA and ROCm).
+ *
+ * Copies from pageable memory are done by the driver through its own small staging buffer, at
+ * about half the bandwidth, and block the host. The pool splits a copy into chunks and uses two
+ * pinned buffers of each device in turns, so that the host copy of a chunk into (or out of) one
+ * buffer overlaps with the DMA of the other one.
+ *
+ * The chunk size is set by the environment variable TVM_PINNED_STAGING_CHUNK_BYTES (8MB by
+ * default, 0 disables the staging), and only copies of at least TVM_PINNED_STAGING_MIN_BYTES
+ * (1MB by default) are staged.
+ *
+ * The buffers of a thread are freed when it exits, unless the process is exiting, when the
+ * device runtime may already be torn down and the buffers are left to it.
+ */
+class PinnedStagingPool {
+ public:
+  /*! \return The pool of the current thread. */
+  static PinnedStagingPool* ThreadLocal();
+  /*!
+   * \brief Check if the copies of a size between the host memory and a device are staged.
+   * \param device The device.
+   * \param nbytes The size of the copy.
+   */
+  static bool ShouldStage(Device device, size_t nbytes);
+  /*! \brief Check if the copies of a device can be staged, whatever their size. */
+  static bool Enabled(Device device);
+  /*!
+   * \brief Copy pageable host memory into a contiguous tensor.
+   * \param data The host memory.
+   * \param to The destination tensor.
+   * \param nbytes The number of bytes, the size of `to`.
+   * \param stream The stream of the copy.
+   * \note The copy completes asynchronously on `stream`, but `data` can be released as soon as
+   *       this function returns.
+   */
+  void CopyFromHost(const void* data, DLTensor* to, size_t nbytes, TVMStreamHandle stream);
+  /*!
+   * \brief Copy a contiguous tensor into pageable host memory.
+   * \param from The source tensor.
+   * \param data The host memory.
+   * \param nbytes The number of bytes, the size of `from`.
+   * \param stream The stream of the copy.
+   * \note The copy is complete when this function returns.
+   */
+  void CopyToHost(const DLTensor* from, void* data, size_t nbytes, TVMStreamHandle stream);
+  /*! \brief Wait for the staged copies to a device to complete. */
+  void Sync(Device device);
+
+ private:
+  /*! \brief The staging buffers of a device. */
+  struct Buffers {
+    /*! \brief The pinned host device the buffers are allocated on. */
+    Device host_device;
+    void* staging[2] = {nullptr, nullptr};
+    /*! \brief The stream of the copy out of each buffer in flight, if any. */
+    TVMStreamHandle stream[2] = {nullptr, nullptr};
+    bool in_flight[2] = {false, false};
+    int next = 0;
+  };
+
+  PinnedStagingPool();
+  ~PinnedStagingPool();
+  Buffers& GetBuffers(Device device);
+  /*! \brief A flat byte view of the first `size` bytes of a staging buffer. */
+  static DLTensor StagingView(const Buffers& buffers, int index, int64_t* size);
+  /*! \brief Wait for the copy out of a buffer, if any, so that it can be reused. */
+  void Release(Device device, Buffers* buffers, int index);
+
+  size_t chunk_bytes_;
+  std::map<std::pair<int, int>, Buffers> buffers_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_PINNED_STAGING_POOL_H_
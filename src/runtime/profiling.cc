@@ -23,6 +23,7 @@
  */
 
 #include <dmlc/json.h>
+#include <tvm/ffi/extra/module.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/c_backend_api.h>
@@ -34,8 +35,10 @@
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <numeric>
+#include <sstream>
 #include <thread>
 
 namespace tvm {
@@ -138,15 +141,18 @@ Profiler::Profiler(std::vector<Device> devs, std::vector<MetricCollector> metric
 
 void Profiler::Start() {
   is_running_ = true;
+  starting_totals_ = true;
   for (auto dev : devs_) {
     StartCall("Total", dev, {});
   }
+  starting_totals_ = false;
 }
 
 void Profiler::StartCall(ffi::String name, Device dev,
                          std::unordered_map<std::string, ffi::Any> extra_metrics) {
   std::vector<std::pair<MetricCollector, ObjectRef>> objs;
   for (auto& collector : collectors_) {
+    if (starting_totals_ && !collector->SupportsNesting()) continue;
     ObjectRef obj = collector->Start(dev);
     if (obj.defined()) {
       objs.emplace_back(collector, obj);
@@ -470,6 +476,59 @@ static ffi::String print_metric(ffi::Any metric) {
   return val;
 }
 
+// The bytes moved from memory for each cache miss.
+static constexpr int64_t kCacheLineBytes = 64;
+
+// Read a count, duration or ratio metric of a call, or return false when it is missing or not
+// positive.
+static bool GetMetricValue(const ffi::Map<ffi::String, ffi::Any>& call, const char* name,
+                           double* value) {
+  auto it = call.find(name);
+  if (it == call.end()) return false;
+  if (const auto* count = (*it).second.as<CountNode>()) {
+    *value = static_cast<double>(count->value);
+  } else if (const auto* duration = (*it).second.as<DurationNode>()) {
+    *value = duration->microseconds;
+  } else if (const auto* ratio = (*it).second.as<RatioNode>()) {
+    *value = ratio->ratio;
+  } else {
+    return false;
+  }
+  return *value > 0;
+}
+
+// Add the metrics derived from the others of a call: the achieved GFLOP/s when the FLOPs of the
+// call are known, the bytes per FLOP, estimated from the counted cache misses, and the roofline
+// metrics of GPU kernels, from the DRAM bytes that CUPTI counts: the arithmetic intensity and
+// the achieved fraction of the peak DRAM bandwidth. The CUPTI sessions replay the kernels of a
+// call within its wall-clock duration, so the rates use the kernel duration CUPTI measures
+// whenever it is reported.
+static void AddDerivedMetrics(ffi::Map<ffi::String, ffi::Any>* call) {
+  double flops = 0, us = 0, kernel_us = 0, misses = 0, dram_bytes = 0, peak_bandwidth = 0;
+  bool has_flops = GetMetricValue(*call, "FLOPs", &flops);
+  bool has_kernel_duration = GetMetricValue(*call, "Kernel Duration (us)", &kernel_us);
+  bool has_duration = has_kernel_duration || GetMetricValue(*call, "Duration (us)", &us);
+  if (has_kernel_duration) us = kernel_us;
+  bool has_dram_bytes = GetMetricValue(*call, "DRAM Bytes", &dram_bytes);
+  if (has_flops && has_duration) {
+    call->Set("GFLOP/s", ObjectRef(ffi::make_object<RatioNode>(flops / us / 1e3)));
+  }
+  // a count of -1 is a counter that could not be read
+  if (has_flops && GetMetricValue(*call, "Cache Misses", &misses)) {
+    call->Set("Bytes/FLOP",
+              ObjectRef(ffi::make_object<RatioNode>(misses * kCacheLineBytes / flops)));
+  }
+  if (has_flops && has_dram_bytes) {
+    call->Set("FLOP/Byte", ObjectRef(ffi::make_object<RatioNode>(flops / dram_bytes)));
+  }
+  if (has_kernel_duration && has_dram_bytes &&
+      GetMetricValue(*call, "Peak DRAM Bandwidth (GB/s)", &peak_bandwidth)) {
+    double gb_per_s = dram_bytes / us / 1e3;
+    call->Set("DRAM Bandwidth (%)",
+              ObjectRef(ffi::make_object<RatioNode>(gb_per_s / peak_bandwidth * 100)));
+  }
+}
+
 ffi::String ReportNode::AsTable(bool sort, bool aggregate, bool compute_col_sums) const {
   // aggregate calls by op hash (or op name if hash is not set) + argument shapes
   std::vector<ffi::Map<ffi::String, ffi::Any>> aggregated_calls;
@@ -527,6 +586,11 @@ ffi::String ReportNode::AsTable(bool sort, bool aggregate, bool compute_col_sums
     }
   }
 
+  // The ratios are derived after the aggregation, from the totals of the aggregated calls.
+  for (auto& call : aggregated_calls) {
+    AddDerivedMetrics(&call);
+  }
+
   // sort rows by duration
   if (sort) {
     std::sort(
@@ -925,9 +989,132 @@ ffi::Function WrapTimeEvaluator(ffi::Function pf, Device dev, int number, int re
   return ffi::Function::FromPacked(ftimer);
 }
 
+ffi::Bytes TimeEvaluateBatch(ffi::Array<ffi::Module> mods, ffi::Array<ffi::String> func_names,
+                             ffi::Array<ffi::Array<ffi::String>> arg_dtypes,
+                             ffi::Array<ffi::Array<ffi::Shape>> arg_shapes, Device dev,
+                             int number, int repeat, int min_repeat_ms, int cache_flush_bytes,
+                             ffi::Function f_preproc) {
+  size_t n = mods.size();
+  CHECK(func_names.size() == n && arg_dtypes.size() == n && arg_shapes.size() == n)
+      << "ValueError: Expect a function name and an argument signature per module";
+  CHECK_GT(repeat, 0) << "ValueError: `repeat` must be positive";
+  static const auto f_random_fill =
+      ffi::Function::GetGlobal("tvm.contrib.random.random_fill_for_measure");
+  std::vector<ffi::Function> timers(n, ffi::Function(nullptr));
+  std::vector<const std::vector<ffi::AnyView>*> args(n, nullptr);
+  std::vector<double> secs(n * repeat, std::numeric_limits<double>::quiet_NaN());
+  std::vector<bool> failed(n, false);
+  // The tensors of each signature, and the views the timers are called with.
+  std::unordered_map<std::string, std::pair<std::vector<Tensor>, std::vector<ffi::AnyView>>>
+      args_by_signature;
+  for (size_t i = 0; i < n; ++i) {
+    try {
+      CHECK_EQ(arg_dtypes[i].size(), arg_shapes[i].size())
+          << "ValueError: Expect a dtype per shape of the arguments of " << func_names[i];
+      std::ostringstream signature;
+      for (size_t j = 0; j < arg_dtypes[i].size(); ++j) {
+        signature << arg_dtypes[i][j];
+        for (int64_t dim : arg_shapes[i][j]) signature << "," << dim;
+        signature << ";";
+      }
+      auto it = args_by_signature.find(signature.str());
+      if (it == args_by_signature.end()) {
+        auto& entry = args_by_signature[signature.str()];
+        for (size_t j = 0; j < arg_dtypes[i].size(); ++j) {
+          Tensor arg = Tensor::Empty(arg_shapes[i][j],
+                                     DataType(ffi::StringToDLDataType(arg_dtypes[i][j])), dev);
+          if (f_random_fill.has_value()) (*f_random_fill)(arg);
+          entry.first.push_back(arg);
+        }
+        entry.second.assign(entry.first.begin(), entry.first.end());
+        it = args_by_signature.find(signature.str());
+      }
+      args[i] = &it->second.second;
+      std::string name = func_names[i].empty() ? ffi::symbol::tvm_ffi_main : func_names[i];
+      ffi::Optional<ffi::Function> f = mods[i]->GetFunction(name);
+      CHECK(f.has_value()) << "ValueError: Cannot find " << name << " in the module";
+      timers[i] = WrapTimeEvaluator(f.value(), dev, number, /*repeat=*/1, min_repeat_ms,
+                                    /*limit_zero_time_iterations=*/100,
+                                    /*cooldown_interval_ms=*/0, /*repeats_to_cooldown=*/1,
+                                    cache_flush_bytes, f_preproc);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "TimeEvaluateBatch: Cannot measure " << func_names[i] << ": " << e.what();
+      failed[i] = true;
+    }
+  }
+  // Each round measures every function once, starting from a different one each time.
+  for (int r = 0; r < repeat; ++r) {
+    for (size_t j = 0; j < n; ++j) {
+      size_t i = (j + r) % n;
+      if (failed[i]) continue;
+      try {
+        ffi::Any rv;
+        timers[i].CallPacked(args[i]->data(), args[i]->size(), &rv);
+        ffi::Bytes blob = rv.cast<ffi::Bytes>();
+        ICHECK_EQ(blob.size(), sizeof(double));
+        secs[i * repeat + r] = *reinterpret_cast<const double*>(blob.data());
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "TimeEvaluateBatch: Failed to run " << func_names[i] << ": " << e.what();
+        failed[i] = true;
+        std::fill_n(secs.begin() + i * repeat, repeat, std::numeric_limits<double>::quiet_NaN());
+      }
+    }
+  }
+  std::string blob(reinterpret_cast<const char*>(secs.data()), secs.size() * sizeof(double));
+  return ffi::Bytes(std::move(blob));
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
+      // Arrays can't be passed over RPC, so the functions are passed as triples of their
+      // module, name and signature, after the timer parameters. A signature lists the
+      // arguments as "dtype:dim,dim,..." separated by ";".
+      .def_packed("runtime.profiling.TimeEvaluateBatch",
+                  [](ffi::PackedArgs args, ffi::Any* rv) {
+                    constexpr int kNumParams = 7;
+                    CHECK(args.size() >= kNumParams && (args.size() - kNumParams) % 3 == 0)
+                        << "ValueError: Expect the timer parameters followed by triples of "
+                        << "module, function name and argument signature";
+                    Device dev{static_cast<DLDeviceType>(args[0].cast<int>()),
+                               args[1].cast<int>()};
+                    ffi::Function f_preproc;
+                    std::string f_preproc_name = args[6].cast<std::string>();
+                    if (!f_preproc_name.empty()) {
+                      auto pf_preproc = ffi::Function::GetGlobal(f_preproc_name);
+                      CHECK(pf_preproc.has_value()) << "ValueError: Cannot find "
+                                                    << f_preproc_name << " in the global function";
+                      f_preproc = *pf_preproc;
+                    }
+                    ffi::Array<ffi::Module> mods;
+                    ffi::Array<ffi::String> func_names;
+                    ffi::Array<ffi::Array<ffi::String>> arg_dtypes;
+                    ffi::Array<ffi::Array<ffi::Shape>> arg_shapes;
+                    for (int i = kNumParams; i + 2 < args.size(); i += 3) {
+                      mods.push_back(args[i].cast<ffi::Module>());
+                      func_names.push_back(args[i + 1].cast<ffi::String>());
+                      ffi::Array<ffi::String> dtypes;
+                      ffi::Array<ffi::Shape> shapes;
+                      std::istringstream signature(args[i + 2].cast<std::string>());
+                      std::string arg;
+                      while (std::getline(signature, arg, ';')) {
+                        size_t colon = arg.find(':');
+                        CHECK(colon != std::string::npos)
+                            << "ValueError: Invalid argument signature " << arg;
+                        dtypes.push_back(arg.substr(0, colon));
+                        std::vector<int64_t> shape;
+                        std::istringstream dims(arg.substr(colon + 1));
+                        std::string dim;
+                        while (std::getline(dims, dim, ',')) shape.push_back(std::stoll(dim));
+                        shapes.push_back(ffi::Shape(shape));
+                      }
+                      arg_dtypes.push_back(dtypes);
+                      arg_shapes.push_back(shapes);
+                    }
+                    *rv = TimeEvaluateBatch(mods, func_names, arg_dtypes, arg_shapes, dev,
+                                            args[2].cast<int>(), args[3].cast<int>(),
+                                            args[4].cast<int>(), args[5].cast<int>(), f_preproc);
+                  })
       .def("runtime.profiling.Report",
            [](ffi::Array<ffi::Map<ffi::String, ffi::Any>> calls,
               ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> device_metrics,
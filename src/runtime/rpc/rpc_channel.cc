@@ -25,10 +25,34 @@
 #include <tvm/runtime/logging.h>
 
 #include <string>
+#include <utility>
 
 namespace tvm {
 namespace runtime {
 
+void RPCChannel::SendAll(const void* header, size_t header_size, const void* payload,
+                         size_t payload_size) {
+  for (auto [data, size] : {std::make_pair(static_cast<const char*>(header), header_size),
+                            std::make_pair(static_cast<const char*>(payload), payload_size)}) {
+    while (size != 0) {
+      size_t n = this->Send(data, size);
+      CHECK_NE(n, 0U) << "RPCError: Channel closes before all the data is sent";
+      data += n;
+      size -= n;
+    }
+  }
+}
+
+void RPCChannel::RecvAll(void* data, size_t size) {
+  char* ptr = static_cast<char*>(data);
+  while (size != 0) {
+    size_t n = this->Recv(ptr, size);
+    CHECK_NE(n, 0U) << "RPCError: Channel closes before all the data is received";
+    ptr += n;
+    size -= n;
+  }
+}
+
 size_t CallbackChannel::Send(const void* data, size_t size) {
   TVMFFIByteArray bytes;
   bytes.data = static_cast<const char*>(data);
@@ -53,6 +53,26 @@ class RPCChannel {
    * \return The actual bytes received.
    */
   virtual size_t Recv(void* data, size_t size) = 0;
+  /*!
+   * \brief Send all the bytes of a header followed by a payload.
+   *
+   *  The default implementation calls Send until everything is sent. Channels that can send
+   *  both buffers with one gather write should override it.
+   *
+   * \param header The header pointer.
+   * \param header_size The size of the header.
+   * \param payload The payload pointer.
+   * \param payload_size The size of the payload.
+   */
+  virtual void SendAll(const void* header, size_t header_size, const void* payload,
+                       size_t payload_size);
+  /*!
+   * \brief Recv exactly the given number of bytes from channel.
+   *
+   * \param data The data pointer.
+   * \param size The size of the data.
+   */
+  virtual void RecvAll(void* data, size_t size);
 };
 
 /*!
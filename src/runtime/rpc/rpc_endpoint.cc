@@ -32,12 +32,15 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <deque>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "../../support/arena.h"
+#include "../../support/crc32.h"
 #include "../../support/ring_buffer.h"
 #include "../../support/utils.h"
 #include "rpc_local_session.h"
@@ -100,6 +103,15 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   /*! \brief Finish the copy ack stage. */
   void FinishCopyAck() { this->SwitchToState(kRecvPacketNumBytes); }
 
+  /*!
+   * \brief Expect the next packet to be a copy ack with the given payload size.
+   *
+   *  Only the code of such a packet is buffered, and the payload is left in the channel,
+   *  so that the caller can receive it straight into the destination.
+   * \param payload_nbytes The number of bytes of the payload.
+   */
+  void ExpectCopyAck(uint64_t payload_nbytes) { expected_copy_ack_bytes_ = payload_nbytes; }
+
   /*!
    * \brief Enter the io loop until the next event.
    * \param client_mode Whether we are in the client.
@@ -124,7 +136,14 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
           ICHECK(this->Read(&packet_nbytes));
           if (packet_nbytes != 0) {
             this->SwitchToState(kProcessPacket);
-            this->RequestBytes(packet_nbytes);
+            if (expected_copy_ack_bytes_ != 0 &&
+                packet_nbytes == sizeof(int32_t) + expected_copy_ack_bytes_) {
+              deferred_packet_bytes_ = expected_copy_ack_bytes_;
+              this->RequestBytes(sizeof(int32_t));
+            } else {
+              this->RequestBytes(packet_nbytes);
+            }
+            expected_copy_ack_bytes_ = 0;
           } else {
             this->SwitchToState(kRecvPacketNumBytes);
           }
@@ -161,6 +180,9 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   void Clear() {
     state_ = kRecvPacketNumBytes;
     pending_request_bytes_ = sizeof(uint64_t);
+    expected_copy_ack_bytes_ = 0;
+    deferred_packet_bytes_ = 0;
+    deferred_code_ = RPCCode::kNone;
   }
 
   /*!
@@ -343,6 +365,12 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   support::Arena arena_;
   // internal arena for temp objects
   std::vector<ffi::Any> any_arena_;
+  // The payload size of the copy ack expected by the client.
+  uint64_t expected_copy_ack_bytes_{0};
+  // The bytes of the current packet that are not requested yet.
+  uint64_t deferred_packet_bytes_{0};
+  // The code of the current packet, when it was read before the rest of the packet.
+  RPCCode deferred_code_{RPCCode::kNone};
 
   // State switcher
   void SwitchToState(State state) {
@@ -383,7 +411,25 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   // Handler for read code.
   void HandleProcessPacket(RPCSession::FEncodeReturn setreturn) {
     RPCCode code = RPCCode::kNone;
-    this->Read(&code);
+    if (deferred_code_ != RPCCode::kNone) {
+      code = deferred_code_;
+      deferred_code_ = RPCCode::kNone;
+    } else {
+      this->Read(&code);
+    }
+    if (deferred_packet_bytes_ != 0) {
+      uint64_t rest_nbytes = deferred_packet_bytes_;
+      deferred_packet_bytes_ = 0;
+      if (code == RPCCode::kCopyAck) {
+        // The payload stays in the channel, see ExpectCopyAck.
+        this->SwitchToState(kCopyAckReceived);
+      } else {
+        // Not the expected ack, e.g. an exception, so wait for the rest of the packet.
+        deferred_code_ = code;
+        this->RequestBytes(rest_nbytes);
+      }
+      return;
+    }
     if (code >= RPCCode::kSyscallCodeStart) {
       this->HandleSyscall(code);
     } else {
@@ -750,14 +796,7 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
 
 void RPCEndpoint::Init() {
   // callback to flush the writer.
-  auto flush_writer = [this]() {
-    while (writer_.bytes_available() != 0) {
-      size_t n = writer_.ReadWithCallback(
-          [this](const void* data, size_t size) { return channel_->Send(data, size); },
-          writer_.bytes_available());
-      if (n == 0) break;
-    }
-  };
+  auto flush_writer = [this]() { this->FlushWriter(); };
 
   // Event handler
   handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer);
@@ -765,6 +804,7 @@ void RPCEndpoint::Init() {
   // Quick function to for syscall remote.
   syscall_remote_ = ffi::Function([this](ffi::PackedArgs all_args, ffi::Any* rv) {
     std::lock_guard<std::mutex> lock(mutex_);
+    ReceivePendingReturns(std::numeric_limits<uint64_t>::max());
     RPCCode code = static_cast<RPCCode>(all_args[0].cast<int>());
     ffi::PackedArgs args = all_args.Slice(1);
 
@@ -889,7 +929,60 @@ void RPCEndpoint::InitRemoteSession(ffi::PackedArgs args) {
 void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, ffi::PackedArgs args,
                            RPCSession::FEncodeReturn encode_return) {
   std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingReturns(std::numeric_limits<uint64_t>::max());
+  SendCallFunc(h, args);
+  RPCCode code = HandleUntilReturnEvent(true, encode_return);
+  ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+}
+
+void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingReturns(std::numeric_limits<uint64_t>::max());
+  SendCopyToRemote(from_bytes, to, nbytes);
+  ICHECK(HandleUntilReturnEvent(true, [](ffi::PackedArgs) {}) == RPCCode::kReturn);
+}
+
+void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingReturns(std::numeric_limits<uint64_t>::max());
+  SendCopyFromRemote(from, nbytes);
+  ReceiveCopyAck(to_bytes, nbytes);
+}
+
+uint64_t RPCEndpoint::CallFuncNoWait(RPCSession::PackedFuncHandle h, ffi::PackedArgs args,
+                                     RPCSession::FEncodeReturn encode_return) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCopyAcks();
+  SendCallFunc(h, args);
+  return PushPendingRequest(PendingRequest::kCallFunc, std::move(encode_return));
+}
+
+uint64_t RPCEndpoint::CopyToRemoteNoWait(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCopyAcks();
+  SendCopyToRemote(from_bytes, to, nbytes);
+  return PushPendingRequest(PendingRequest::kCopyToRemote, nullptr);
+}
+
+uint64_t RPCEndpoint::CopyFromRemoteNoWait(DLTensor* from, void* to_bytes, uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCopyAcks();
+  SendCopyFromRemote(from, nbytes);
+  return PushPendingRequest(PendingRequest::kCopyFromRemote, nullptr, to_bytes, nbytes);
+}
+
+void RPCEndpoint::WaitForRequest(uint64_t seq) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingReturns(seq);
+  auto it = failed_requests_.begin();
+  if (it != failed_requests_.end() && it->first <= seq) {
+    Error err = it->second;
+    failed_requests_.erase(it, failed_requests_.upper_bound(seq));
+    throw err;
+  }
+}
 
+void RPCEndpoint::SendCallFunc(RPCSession::PackedFuncHandle h, ffi::PackedArgs args) {
   handler_->ValidateArguments(args);
   RPCCode code = RPCCode::kCallFunc;
   uint64_t handle = reinterpret_cast<uint64_t>(h);
@@ -902,13 +995,9 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, ffi::PackedArgs args,
   handler_->Write(code);
   handler_->Write(handle);
   handler_->SendPackedSeq(args.data(), args.size(), true);
-
-  code = HandleUntilReturnEvent(true, encode_return);
-  ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
-void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
+void RPCEndpoint::SendCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
   RPCCode code = RPCCode::kCopyToRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
@@ -923,12 +1012,15 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, to);
   handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](ffi::PackedArgs) {}) == RPCCode::kReturn);
+  // Send the payload straight from the source, behind the header that is staged in the writer.
+  CHECK(channel_) << "Expected connection to server " << name_
+                  << " to be active, but the connection was previously closed";
+  std::vector<char> header(writer_.bytes_available());
+  writer_.Read(header.data(), header.size());
+  channel_->SendAll(header.data(), header.size(), from_bytes, nbytes);
 }
 
-void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
+void RPCEndpoint::SendCopyFromRemote(DLTensor* from, uint64_t nbytes) {
   RPCCode code = RPCCode::kCopyFromRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
@@ -943,12 +1035,79 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, from);
   handler_->Write(nbytes);
+}
+
+void RPCEndpoint::ReceiveCopyAck(void* to_bytes, uint64_t nbytes) {
+  handler_->ExpectCopyAck(nbytes);
   ICHECK(HandleUntilReturnEvent(true, [](ffi::PackedArgs) {}) == RPCCode::kCopyAck);
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
+  // Receive the payload of the ack straight into the destination.
+  char* to_ptr = reinterpret_cast<char*>(to_bytes);
+  size_t nbuffered = std::min(reader_.bytes_available(), static_cast<size_t>(nbytes));
+  handler_->ReadArray(to_ptr, nbuffered);
+  channel_->RecvAll(to_ptr + nbuffered, nbytes - nbuffered);
   handler_->FinishCopyAck();
 }
 
+uint64_t RPCEndpoint::PushPendingRequest(PendingRequest::Kind kind,
+                                         RPCSession::FEncodeReturn encode_return, void* copy_to,
+                                         uint64_t copy_nbytes) {
+  // Push the request to the remote now, so that it runs while the caller goes on.
+  CHECK(channel_) << "Expected connection to server " << name_
+                  << " to be active, but the connection was previously closed";
+  FlushWriter();
+  PendingRequest request;
+  request.seq = next_request_seq_++;
+  request.kind = kind;
+  request.encode_return = std::move(encode_return);
+  request.copy_to = copy_to;
+  request.copy_nbytes = copy_nbytes;
+  pending_requests_.push_back(std::move(request));
+  return pending_requests_.back().seq;
+}
+
+void RPCEndpoint::ReceivePendingReturns(uint64_t seq) {
+  while (!pending_requests_.empty() && pending_requests_.front().seq <= seq) {
+    PendingRequest request = std::move(pending_requests_.front());
+    pending_requests_.pop_front();
+    try {
+      if (request.kind == PendingRequest::kCopyFromRemote) {
+        ReceiveCopyAck(request.copy_to, request.copy_nbytes);
+      } else {
+        RPCSession::FEncodeReturn encode_return = request.encode_return;
+        if (encode_return == nullptr) {
+          encode_return = [](ffi::PackedArgs) {};
+        }
+        RPCCode code = HandleUntilReturnEvent(true, encode_return);
+        ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+      }
+    } catch (const Error& e) {
+      // Keep the error until the request is waited for.
+      failed_requests_.emplace(request.seq, e);
+    }
+  }
+}
+
+void RPCEndpoint::ReceivePendingCopyAcks() {
+  // The payload of an ack can exceed the socket buffers. Receive it before sending more, so
+  // that the remote is never blocked on the ack while this side is blocked on a send.
+  for (auto it = pending_requests_.rbegin(); it != pending_requests_.rend(); ++it) {
+    if (it->kind == PendingRequest::kCopyFromRemote) {
+      ReceivePendingReturns(it->seq);
+      break;
+    }
+  }
+}
+
+void RPCEndpoint::FlushWriter() {
+  while (writer_.bytes_available() != 0) {
+    size_t n = writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+    if (n == 0) break;
+  }
+}
+
 // SysCallEventHandler functions
 void RPCGetGlobalFunc(RPCSession* handler, ffi::PackedArgs args, ffi::Any* rv) {
   auto name = args[0].cast<std::string>();
@@ -1117,57 +1276,103 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
   }
 
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyToRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
-    }
+    std::deque<uint64_t> in_flight;
+    ForEachTransferBlock(remote_to, RPCCode::kCopyToRemote, nbytes,
+                         [&](uint64_t offset, uint64_t block_nbytes) {
+                           char* block = static_cast<char*>(local_from_bytes) + offset;
+                           if (copy_window_ > 1) {
+                             PushInFlight(&in_flight,
+                                          SendBlockToRemote(block, remote_to, block_nbytes, true));
+                           } else {
+                             SendBlockToRemote(block, remote_to, block_nbytes, false);
+                           }
+                         });
+    if (!in_flight.empty()) endpoint_->WaitForRequest(in_flight.back());
+    if (verify_copy_crc_) CheckCopyCRC(remote_to, local_from_bytes, nbytes);
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyFromRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
+    std::deque<uint64_t> in_flight;
+    ForEachTransferBlock(
+        remote_from, RPCCode::kCopyFromRemote, nbytes, [&](uint64_t offset, uint64_t block_nbytes) {
+          char* block = static_cast<char*>(local_to_bytes) + offset;
+          if (copy_window_ > 1) {
+            PushInFlight(&in_flight, ReceiveBlockFromRemote(remote_from, block, block_nbytes, true));
+          } else {
+            ReceiveBlockFromRemote(remote_from, block, block_nbytes, false);
+          }
+        });
+    if (!in_flight.empty()) endpoint_->WaitForRequest(in_flight.back());
+    if (verify_copy_crc_) CheckCopyCRC(remote_from, local_to_bytes, nbytes);
+  }
+
+  uint64_t CallFuncNoWait(PackedFuncHandle func, ffi::PackedArgs args,
+                          const FEncodeReturn& fencode_return) final {
+    return endpoint_->CallFuncNoWait(func, args, fencode_return);
+  }
+
+  uint64_t CopyToRemoteNoWait(void* local_from_bytes, DLTensor* remote_to,
+                              uint64_t nbytes) final {
+    uint64_t seq = 0;
+    ForEachTransferBlock(remote_to, RPCCode::kCopyToRemote, nbytes,
+                         [&](uint64_t offset, uint64_t block_nbytes) {
+                           char* block = static_cast<char*>(local_from_bytes) + offset;
+                           seq = SendBlockToRemote(block, remote_to, block_nbytes, true);
+                         });
+    return seq;
+  }
+
+  uint64_t CopyFromRemoteNoWait(DLTensor* remote_from, void* local_to_bytes,
+                                uint64_t nbytes) final {
+    uint64_t seq = 0;
+    ForEachTransferBlock(remote_from, RPCCode::kCopyFromRemote, nbytes,
+                         [&](uint64_t offset, uint64_t block_nbytes) {
+                           char* block = static_cast<char*>(local_to_bytes) + offset;
+                           seq = ReceiveBlockFromRemote(remote_from, block, block_nbytes, true);
+                         });
+    return seq;
+  }
+
+  void EnableCompression(const std::string& codec, uint64_t threshold_bytes, int level) final {
+    compression_codec_.clear();
+    if (codec.empty()) return;
+    // Both sides must have the codec, and the remote must have the compressed copy functions,
+    // which older servers do not.
+    for (const char* name : {"compress", "decompress"}) {
+      std::string func_name = "rpc.codec." + codec + "." + name;
+      CHECK(ffi::Function::GetGlobal(func_name).has_value())
+          << "ValueError: RPC compression codec `" << codec << "` is not available locally";
+      PackedFuncHandle remote_func = GetFunction(func_name);
+      CHECK(remote_func != nullptr)
+          << "ValueError: RPC compression codec `" << codec << "` is not available on the remote";
+      FreeHandle(remote_func);
     }
+    if (remote_copy_to_compressed_ == nullptr) {
+      remote_copy_to_compressed_ = GetFunction("tvm.rpc.server.CopyToRemoteCompressed");
+      remote_copy_from_compressed_ = GetFunction("tvm.rpc.server.CopyFromRemoteCompressed");
+    }
+    CHECK(remote_copy_to_compressed_ != nullptr && remote_copy_from_compressed_ != nullptr)
+        << "ValueError: The remote does not support compressed copies";
+    fcompress_ = *ffi::Function::GetGlobal("rpc.codec." + codec + ".compress");
+    fdecompress_ = *ffi::Function::GetGlobal("rpc.codec." + codec + ".decompress");
+    compression_codec_ = codec;
+    compression_threshold_bytes_ = threshold_bytes;
+    compression_level_ = level;
+  }
 
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
+  void EnableWindowedCopy(uint64_t window, uint64_t block_nbytes, bool verify_crc) final {
+    if (verify_crc && remote_tensor_crc32_ == nullptr) {
+      remote_tensor_crc32_ = GetFunction("tvm.rpc.server.TensorCRC32");
+      CHECK(remote_tensor_crc32_ != nullptr)
+          << "ValueError: The remote does not support CRC-checked copies";
     }
+    copy_window_ = window;
+    copy_block_nbytes_ = block_nbytes;
+    verify_copy_crc_ = verify_crc;
   }
 
+  void WaitForRequest(uint64_t seq) final { endpoint_->WaitForRequest(seq); }
+
   void FreeHandle(void* handle) final { endpoint_->SysCallRemote(RPCCode::kFreeHandle, handle); }
 
   void SetDevice(Device dev) final { endpoint_->SysCallRemote(RPCCode::kDevSetDevice, dev); }
@@ -1242,6 +1447,141 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
   void Shutdown() final { endpoint_->Shutdown(); }
 
  private:
+  /*!
+   * \brief Split a copy into blocks that fit in the max transfer size.
+   * \param remote The remote array, whose byte_offset is set to the offset of each block.
+   * \param code The code of the copy.
+   * \param nbytes The size of the copy in bytes.
+   * \param fcopy The function to copy one block, called with its offset and size.
+   */
+  template <typename FCopy>
+  void ForEachTransferBlock(DLTensor* remote, RPCCode code, uint64_t nbytes, FCopy fcopy) {
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote, code, nbytes);
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    ICHECK_GT(rpc_max_size, overhead) << RPCCodeToString(code) << ": Invalid block size!";
+    uint64_t block_size = rpc_max_size - overhead;
+    if (copy_block_nbytes_ != 0) {
+      block_size = std::min(block_size, copy_block_nbytes_);
+    }
+    for (uint64_t offset = 0; offset < nbytes; offset += block_size) {
+      remote->byte_offset = offset;
+      fcopy(offset, std::min(block_size, nbytes - offset));
+    }
+  }
+
+  bool UseCompression(uint64_t nbytes) const {
+    return !compression_codec_.empty() && nbytes >= compression_threshold_bytes_;
+  }
+
+  /*!
+   * \brief Send a block of a copy to the remote, compressed if it is large enough.
+   * \param no_wait Whether to return without waiting for the remote.
+   * \return The sequence number of the request when no_wait is set.
+   */
+  uint64_t SendBlockToRemote(void* block, DLTensor* remote_to, uint64_t nbytes, bool no_wait) {
+    if (UseCompression(nbytes)) {
+      return CompressedCopyToRemote(block, remote_to, nbytes, no_wait);
+    }
+    if (no_wait) {
+      return endpoint_->CopyToRemoteNoWait(block, remote_to, nbytes);
+    }
+    endpoint_->CopyToRemote(block, remote_to, nbytes);
+    return 0;
+  }
+
+  /*!
+   * \brief Receive a block of a copy from the remote, compressed if it is large enough.
+   * \param no_wait Whether to return without waiting for the remote.
+   * \return The sequence number of the request when no_wait is set.
+   */
+  uint64_t ReceiveBlockFromRemote(DLTensor* remote_from, void* block, uint64_t nbytes,
+                                  bool no_wait) {
+    if (UseCompression(nbytes)) {
+      return CompressedCopyFromRemote(remote_from, block, nbytes, no_wait);
+    }
+    if (no_wait) {
+      return endpoint_->CopyFromRemoteNoWait(remote_from, block, nbytes);
+    }
+    endpoint_->CopyFromRemote(remote_from, block, nbytes);
+    return 0;
+  }
+
+  /*!
+   * \brief Add a block in flight to the window of a copy, and wait for the oldest block once
+   *  there are more than copy_window_ of them.
+   */
+  void PushInFlight(std::deque<uint64_t>* in_flight, uint64_t seq) {
+    in_flight->push_back(seq);
+    if (in_flight->size() > copy_window_) {
+      endpoint_->WaitForRequest(in_flight->front());
+      in_flight->pop_front();
+    }
+  }
+
+  /*!
+   * \brief Check the CRC-32 of the bytes of a copy against that of the remote array.
+   * \param remote The remote array, whose first nbytes bytes were copied.
+   * \param local_bytes The local bytes of the copy.
+   * \param nbytes The size of the copy in bytes.
+   */
+  void CheckCopyCRC(DLTensor* remote, const void* local_bytes, uint64_t nbytes) {
+    if (nbytes == 0) return;
+    remote->byte_offset = 0;
+    ffi::AnyView packed_args[2] = {remote, static_cast<int64_t>(nbytes)};
+    int64_t remote_crc = -1;
+    endpoint_->CallFunc(remote_tensor_crc32_, ffi::PackedArgs(packed_args, 2),
+                        [&remote_crc](ffi::PackedArgs args) {
+                          // Use args[1] as return value, args[0] is tcode
+                          remote_crc = args[1].cast<int64_t>();
+                        });
+    int64_t local_crc = support::CRC32(local_bytes, nbytes);
+    CHECK_EQ(remote_crc, local_crc) << "RuntimeError: The copy of " << nbytes
+                                    << " bytes was corrupted, its CRC-32 on the remote differs";
+  }
+
+  /*!
+   * \brief Compress a block of a copy to the remote and send it.
+   * \param no_wait Whether to return without waiting for the remote.
+   * \return The sequence number of the request when no_wait is set.
+   */
+  uint64_t CompressedCopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes,
+                                  bool no_wait) {
+    ffi::Bytes payload =
+        fcompress_(local_from_bytes, static_cast<int64_t>(nbytes), compression_level_)
+            .cast<ffi::Bytes>();
+    ffi::AnyView packed_args[4] = {remote_to, compression_codec_.c_str(), payload,
+                                   static_cast<int64_t>(nbytes)};
+    ffi::PackedArgs args(packed_args, 4);
+    auto fencode_return = [](ffi::PackedArgs) {};
+    if (no_wait) {
+      return endpoint_->CallFuncNoWait(remote_copy_to_compressed_, args, fencode_return);
+    }
+    endpoint_->CallFunc(remote_copy_to_compressed_, args, fencode_return);
+    return 0;
+  }
+
+  /*!
+   * \brief Receive a block of a copy from the remote compressed and decompress it.
+   * \param no_wait Whether to return without waiting for the remote.
+   * \return The sequence number of the request when no_wait is set.
+   */
+  uint64_t CompressedCopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes,
+                                    bool no_wait) {
+    ffi::AnyView packed_args[4] = {remote_from, compression_codec_.c_str(),
+                                   static_cast<int64_t>(nbytes), compression_level_};
+    ffi::PackedArgs args(packed_args, 4);
+    ffi::Function fdecompress = fdecompress_;
+    auto fencode_return = [fdecompress, local_to_bytes, nbytes](ffi::PackedArgs args) {
+      // Use args[1] as return value, args[0] is tcode
+      fdecompress(args[1].cast<ffi::Bytes>(), local_to_bytes, static_cast<int64_t>(nbytes));
+    };
+    if (no_wait) {
+      return endpoint_->CallFuncNoWait(remote_copy_from_compressed_, args, fencode_return);
+    }
+    endpoint_->CallFunc(remote_copy_from_compressed_, args, fencode_return);
+    return 0;
+  }
+
   uint64_t GetRPCMaxTransferSize() {
     if (rpc_chunk_max_size_bytes_ > 0) {
       return (uint64_t)rpc_chunk_max_size_bytes_;
@@ -1265,6 +1605,21 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  /*! \brief The codec of the compressed copies, empty when the compression is disabled. */
+  std::string compression_codec_;
+  uint64_t compression_threshold_bytes_ = 0;
+  int compression_level_ = 0;
+  ffi::Function fcompress_;
+  ffi::Function fdecompress_;
+  PackedFuncHandle remote_copy_to_compressed_ = nullptr;
+  PackedFuncHandle remote_copy_from_compressed_ = nullptr;
+  /*! \brief The number of blocks of a blocking copy in flight, 1 to wait for each block. */
+  uint64_t copy_window_ = 1;
+  /*! \brief The max size of the blocks of the copies, or 0 for the max transfer size. */
+  uint64_t copy_block_nbytes_ = 0;
+  /*! \brief Whether to check the CRC-32 of the blocking copies once they are done. */
+  bool verify_copy_crc_ = false;
+  PackedFuncHandle remote_tensor_crc32_ = nullptr;
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
@@ -26,6 +26,8 @@
 
 #include <tvm/ffi/function.h>
 
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -160,6 +162,50 @@ class RPCEndpoint {
    */
   void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
 
+  // Pipelined variant of the client API.
+  //
+  // The requests below are sent without waiting for their returns, so that several
+  // requests can be in flight. The remote handles requests in the order they are sent,
+  // thus their returns are received in the same order, either by WaitForRequest or
+  // before the next synchronous request. Each request is identified by a sequence number.
+
+  /*!
+   * \brief Call into remote function without waiting for its return.
+   * \param handle The function handle
+   * \param args The argument values.
+   * \param encode_return The function to receive return value encodings,
+   *                      called when the return is received.
+   * \return The sequence number of the request.
+   */
+  uint64_t CallFuncNoWait(RPCSession::PackedFuncHandle handle, ffi::PackedArgs args,
+                          RPCSession::FEncodeReturn encode_return);
+  /*!
+   * \brief Copy bytes into remote array content without waiting for the copy.
+   * \param from_bytes The source host data, which can be released once the call returns.
+   * \param to The target array.
+   * \param nbytes The size of the memory in bytes.
+   * \return The sequence number of the request.
+   */
+  uint64_t CopyToRemoteNoWait(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  /*!
+   * \brief Copy bytes from remote array content without waiting for the copy.
+   * \param from The source array.
+   * \param to_bytes The target host data, which must stay alive until the request is done.
+   * \param nbytes The size of the memory in bytes.
+   * \return The sequence number of the request.
+   */
+  uint64_t CopyFromRemoteNoWait(DLTensor* from, void* to_bytes, uint64_t nbytes);
+  /*!
+   * \brief Wait until the request with the given sequence number and all the requests sent
+   *  before it are done.
+   *
+   *  Raises the error of the earliest of these requests that failed, if it is not raised yet.
+   *  The errors of the other failed requests up to seq are dropped.
+   *
+   * \param seq The sequence number of the request.
+   */
+  void WaitForRequest(uint64_t seq);
+
   /*!
    * \brief Call a remote defined system function with arguments.
    * \param fcode The function code.
@@ -186,6 +232,35 @@ class RPCEndpoint {
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
+  /*! \brief A request that is sent but whose return is not received yet. */
+  struct PendingRequest {
+    enum Kind { kCallFunc, kCopyToRemote, kCopyFromRemote };
+    /*! \brief The sequence number of the request. */
+    uint64_t seq;
+    /*! \brief The kind of the request. */
+    Kind kind;
+    /*! \brief The function to receive the return of a call, can be nullptr. */
+    RPCSession::FEncodeReturn encode_return;
+    /*! \brief The destination of a copy from remote. */
+    void* copy_to{nullptr};
+    /*! \brief The number of bytes of a copy from remote. */
+    uint64_t copy_nbytes{0};
+  };
+  // Write the packets of the requests.
+  void SendCallFunc(RPCSession::PackedFuncHandle handle, ffi::PackedArgs args);
+  void SendCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  void SendCopyFromRemote(DLTensor* from, uint64_t nbytes);
+  // Receive the ack of a copy from remote, and its payload into to_bytes.
+  void ReceiveCopyAck(void* to_bytes, uint64_t nbytes);
+  // Flush the request just written, and record it as pending.
+  uint64_t PushPendingRequest(PendingRequest::Kind kind, RPCSession::FEncodeReturn encode_return,
+                              void* copy_to = nullptr, uint64_t copy_nbytes = 0);
+  // Receive the returns of the pending requests up to seq.
+  void ReceivePendingReturns(uint64_t seq);
+  // Receive the returns of the pending requests up to the last copy from remote.
+  void ReceivePendingCopyAcks();
+  // Flush the writer into the channel.
+  void FlushWriter();
   // Initalization
   void Init();
   // Internal channel.
@@ -205,6 +280,12 @@ class RPCEndpoint {
   std::string remote_key_;
   // Invoked when the RPC session is terminated
   ffi::TypedFunction<void()> fcleanup_;
+  // The requests that are sent but not returned yet, in the order of their sequence numbers.
+  std::deque<PendingRequest> pending_requests_;
+  // The errors of the failed requests that are not waited for yet.
+  std::map<uint64_t, Error> failed_requests_;
+  // The sequence number of the next request.
+  uint64_t next_request_seq_{0};
 };
 
 /*!
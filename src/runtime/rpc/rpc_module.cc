@@ -27,14 +27,19 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/profiling.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 #if defined(_M_X64) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
 
+#include "../../support/crc32.h"
 #include "rpc_endpoint.h"
 #include "rpc_session.h"
 
@@ -74,10 +79,26 @@ Tensor TensorFromRemoteOpaqueHandle(std::shared_ptr<RPCSession> sess, void* hand
   return Tensor::FromNDAlloc(RemoteSpaceAlloc(space), shape, template_tensor->dtype, dev);
 }
 
+/*!
+ * \brief The slot of the remote call made by rpc.CallAsync.
+ *
+ *  While rpc.CallAsync runs a function, the first RPCWrappedFunc called on the
+ *  thread sends its call without waiting for the return, and fills the slot.
+ */
+struct AsyncCallSlot {
+  /*! \brief The function that waits for the call and returns its result. */
+  ffi::Function future;
+  /*! \return The slot of the current thread, nullptr when not in rpc.CallAsync. */
+  static AsyncCallSlot*& ThreadLocal() {
+    thread_local AsyncCallSlot* slot = nullptr;
+    return slot;
+  }
+};
+
 /*!
  * \brief A wrapped remote function as a ffi::Function.
  */
-class RPCWrappedFunc : public Object {
+class RPCWrappedFunc : public Object, public std::enable_shared_from_this<RPCWrappedFunc> {
  public:
   RPCWrappedFunc(void* handle, std::shared_ptr<RPCSession> sess) : handle_(handle), sess_(sess) {}
 
@@ -137,6 +158,20 @@ class RPCWrappedFunc : public Object {
         }
       }
     }
+    if (AsyncCallSlot* slot = AsyncCallSlot::ThreadLocal()) {
+      AsyncCallSlot::ThreadLocal() = nullptr;
+      auto result = std::make_shared<ffi::Any>();
+      auto self = shared_from_this();
+      uint64_t seq = sess_->CallFuncNoWait(
+          handle_, ffi::PackedArgs(packed_args.data(), packed_args.size()),
+          [self, result](ffi::PackedArgs args) { self->WrapRemoteReturnToValue(args, result.get()); });
+      std::shared_ptr<RPCSession> sess = sess_;
+      slot->future = ffi::Function([sess, seq, result](ffi::PackedArgs, ffi::Any* rv) {
+        sess->WaitForRequest(seq);
+        *rv = *result;
+      });
+      return;
+    }
     auto set_return = [this, rv](ffi::PackedArgs args) { this->WrapRemoteReturnToValue(args, rv); };
     sess_->CallFunc(handle_, ffi::PackedArgs(packed_args.data(), packed_args.size()), set_return);
   }
@@ -445,6 +480,49 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                   [](ffi::PackedArgs args, ffi::Any* rv) { CPUCacheFlush(1, args); });
 }
 
+/*!
+ * \brief Get a function of an RPC compression codec.
+ * \param codec The name of the codec.
+ * \param name The name of the function, compress or decompress.
+ */
+ffi::Function GetRPCCodecFunc(const std::string& codec, const std::string& name) {
+  auto f = ffi::Function::GetGlobal("rpc.codec." + codec + "." + name);
+  CHECK(f.has_value()) << "ValueError: RPC compression codec `" << codec
+                       << "` is not available, it may require building TVM with it enabled";
+  return *f;
+}
+
+/*!
+ * \brief Copy bytes between a tensor, viewed as a flat byte array, and host memory.
+ * \param tensor The tensor, whose byte_offset is the offset of the copied bytes.
+ * \param host The host memory.
+ * \param nbytes The number of bytes to copy.
+ * \param to_tensor Whether to copy from the host memory to the tensor.
+ */
+void CopyTensorBytes(DLTensor* tensor, void* host, int64_t nbytes, bool to_tensor) {
+  int64_t shape[1] = {nbytes};
+  DLTensor bytes_view = *tensor;
+  bytes_view.ndim = 1;
+  bytes_view.dtype = DLDataType{kDLUInt, 8, 1};
+  bytes_view.shape = shape;
+  bytes_view.strides = nullptr;
+  DLTensor host_view;
+  host_view.data = host;
+  host_view.device = Device{kDLCPU, 0};
+  host_view.ndim = 1;
+  host_view.dtype = bytes_view.dtype;
+  host_view.shape = shape;
+  host_view.strides = nullptr;
+  host_view.byte_offset = 0;
+  DeviceAPI* api = DeviceAPI::Get(tensor->device);
+  if (to_tensor) {
+    api->CopyDataFromTo(&host_view, &bytes_view, nullptr);
+  } else {
+    api->CopyDataFromTo(&bytes_view, &host_view, nullptr);
+  }
+  api->StreamSync(tensor->device, nullptr);
+}
+
 // server function registration.
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
@@ -454,9 +532,90 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def("tvm.rpc.server.ModuleGetFunction",
            [](ffi::Module parent, std::string name, bool query_imports) {
              return parent->GetFunction(name, query_imports);
+           })
+      .def("tvm.rpc.server.CopyToRemoteCompressed",
+           [](DLTensor* to, std::string codec, ffi::Bytes payload, int64_t nbytes) {
+             std::vector<char> buffer(nbytes);
+             GetRPCCodecFunc(codec, "decompress")(payload, static_cast<void*>(buffer.data()),
+                                                  nbytes);
+             CopyTensorBytes(to, buffer.data(), nbytes, true);
+           })
+      .def("tvm.rpc.server.CopyFromRemoteCompressed",
+           [](DLTensor* from, std::string codec, int64_t nbytes, int level) {
+             std::vector<char> buffer(nbytes);
+             CopyTensorBytes(from, buffer.data(), nbytes, false);
+             return GetRPCCodecFunc(codec, "compress")(static_cast<void*>(buffer.data()), nbytes,
+                                                       level)
+                 .cast<ffi::Bytes>();
+           })
+      .def("tvm.rpc.server.TensorCRC32",
+           [](DLTensor* tensor, int64_t nbytes) {
+             // Read the tensor in pieces, so that the memory of small devices is not doubled.
+             constexpr int64_t kPieceBytes = 64 << 10;
+             std::vector<char> buffer(std::min(nbytes, kPieceBytes));
+             DLTensor piece = *tensor;
+             uint32_t crc = 0;
+             for (int64_t offset = 0; offset < nbytes; offset += kPieceBytes) {
+               int64_t piece_nbytes = std::min(kPieceBytes, nbytes - offset);
+               piece.byte_offset = tensor->byte_offset + offset;
+               CopyTensorBytes(&piece, buffer.data(), piece_nbytes, false);
+               crc = support::CRC32(buffer.data(), piece_nbytes, crc);
+             }
+             return static_cast<int64_t>(crc);
            });
 }
 
+/*!
+ * \brief Start a copy between a remote tensor and a local CPU tensor without waiting for it.
+ * \param remote The remote tensor.
+ * \param local The local tensor.
+ * \param to_remote Whether to copy from local to remote.
+ * \return The function that waits for the copy.
+ */
+ffi::Function CopyTensorAsync(Tensor remote, Tensor local, bool to_remote) {
+  CHECK(IsRPCSessionDevice(remote->device))
+      << "ValueError: Expect a remote tensor, but got a tensor on " << remote->device;
+  CHECK_EQ(local->device.device_type, kDLCPU)
+      << "ValueError: Expect a local CPU tensor, but got a tensor on " << local->device;
+  CHECK(remote.IsContiguous() && local.IsContiguous())
+      << "ValueError: Async RPC copies require contiguous tensors";
+  size_t nbytes = GetDataSize(*local.operator->());
+  CHECK_EQ(nbytes, GetDataSize(*remote.operator->()))
+      << "ValueError: The tensors of a copy must have the same size";
+  if (nbytes == 0) {
+    return ffi::Function([](ffi::PackedArgs, ffi::Any*) {});
+  }
+  const auto* space = static_cast<const RemoteSpace*>(remote->data);
+  std::shared_ptr<RPCSession> sess = space->sess;
+  DLTensor remote_tensor = *remote.operator->();
+  remote_tensor.device = RemoveRPCSessionMask(remote->device);
+  remote_tensor.data = space->data;
+  char* local_bytes = static_cast<char*>(local->data) + local->byte_offset;
+  uint64_t seq = to_remote ? sess->CopyToRemoteNoWait(local_bytes, &remote_tensor, nbytes)
+                           : sess->CopyFromRemoteNoWait(&remote_tensor, local_bytes, nbytes);
+  // A download writes into the local tensor when its return is received, so the copy must be
+  // done before the local tensor can be released, even if the future is dropped.
+  class WaitOnRelease {
+   public:
+    WaitOnRelease(std::shared_ptr<RPCSession> sess, uint64_t seq, Tensor local)
+        : sess(std::move(sess)), seq(seq), local(std::move(local)) {}
+    ~WaitOnRelease() {
+      try {
+        sess->WaitForRequest(seq);
+      } catch (const Error& e) {
+        // the error is only reported to the future
+      }
+    }
+    std::shared_ptr<RPCSession> sess;
+    uint64_t seq;
+    Tensor local;
+  };
+  auto guard = std::make_shared<WaitOnRelease>(sess, seq, local);
+  return ffi::Function([guard, remote](ffi::PackedArgs, ffi::Any*) {
+    guard->sess->WaitForRequest(guard->seq);
+  });
+}
+
 // functions to access an RPC module.
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
@@ -480,6 +639,46 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                     ICHECK_EQ(tkey, "rpc");
                     *rv = static_cast<RPCModuleNode*>(m.operator->())->sess()->table_index();
                   })
+      .def_packed("rpc.CallAsync",
+                  [](ffi::PackedArgs args, ffi::Any* rv) {
+                    ffi::Function func = args[0].cast<ffi::Function>();
+                    AsyncCallSlot slot;
+                    AsyncCallSlot::ThreadLocal() = &slot;
+                    ffi::Any ret;
+                    try {
+                      func.CallPacked(args.Slice(1), &ret);
+                    } catch (...) {
+                      AsyncCallSlot::ThreadLocal() = nullptr;
+                      throw;
+                    }
+                    AsyncCallSlot::ThreadLocal() = nullptr;
+                    if (slot.future != nullptr) {
+                      *rv = slot.future;
+                    } else {
+                      // Not a remote function, so the call is already done.
+                      *rv = ffi::Function([ret](ffi::PackedArgs, ffi::Any* rv) { *rv = ret; });
+                    }
+                  })
+      .def("rpc.SessEnableCompression",
+           [](ffi::Module sess, std::string codec, int64_t threshold_bytes, int level) {
+             CHECK_GE(threshold_bytes, 0)
+                 << "ValueError: The compression threshold must be non-negative, but got "
+                 << threshold_bytes;
+             RPCModuleGetSession(sess)->EnableCompression(codec, threshold_bytes, level);
+           })
+      .def("rpc.SessEnableWindowedCopy",
+           [](ffi::Module sess, int64_t window, int64_t block_bytes, bool verify_crc) {
+             CHECK_GE(window, 1) << "ValueError: The copy window must be at least 1, but got "
+                                 << window;
+             CHECK_GE(block_bytes, 0)
+                 << "ValueError: The copy block size must be non-negative, but got "
+                 << block_bytes;
+             RPCModuleGetSession(sess)->EnableWindowedCopy(window, block_bytes, verify_crc);
+           })
+      .def("rpc.CopyToRemoteAsync",
+           [](Tensor local, Tensor remote) { return CopyTensorAsync(remote, local, true); })
+      .def("rpc.CopyFromRemoteAsync",
+           [](Tensor remote, Tensor local) { return CopyTensorAsync(remote, local, false); })
       .def("tvm.rpc.TensorFromRemoteOpaqueHandle",
            [](ffi::Module mod, void* remote_array, DLTensor* template_tensor, Device dev,
               void* tensor_handle) -> Tensor {
@@ -21,9 +21,16 @@
  * \file rpc_server_env.cc
  * \brief Server environment of the RPC.
  */
+#include <tvm/ffi/extra/module.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 #include "../file_utils.h"
 
 namespace tvm {
@@ -36,6 +43,45 @@ std::string RPCGetPath(const std::string& name) {
   return (*f)(name).cast<std::string>();
 }
 
+/*!
+ * \brief The modules loaded by the server, by the hash of their artifact, so that a client that
+ * keeps its session measures an artifact again without uploading and loading it again. The
+ * least recently used modules are evicted past the capacity.
+ */
+class RPCModuleCache {
+ public:
+  static RPCModuleCache* Global() {
+    static RPCModuleCache* inst = new RPCModuleCache();
+    return inst;
+  }
+
+  ffi::Optional<ffi::Module> Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return std::nullopt;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+
+  void Put(const std::string& key, ffi::Module mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) entries_.erase(it->second);
+    entries_.emplace_front(key, std::move(mod));
+    index_[key] = entries_.begin();
+    while (entries_.size() > kCapacity) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  static constexpr size_t kCapacity = 64;
+  std::mutex mutex_;
+  std::list<std::pair<std::string, ffi::Module>> entries_;
+  std::unordered_map<std::string, std::list<std::pair<std::string, ffi::Module>>::iterator> index_;
+};
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
@@ -53,9 +99,15 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                     LOG(INFO) << "Download " << file_name << "... nbytes=" << data.size();
                     *rv = ffi::Bytes(data);
                   })
-      .def_packed("tvm.rpc.server.remove", [](ffi::PackedArgs args, ffi::Any* rv) {
-        std::string file_name = RPCGetPath(args[0].cast<std::string>());
-        RemoveFile(file_name);
+      .def_packed("tvm.rpc.server.remove",
+                  [](ffi::PackedArgs args, ffi::Any* rv) {
+                    std::string file_name = RPCGetPath(args[0].cast<std::string>());
+                    RemoveFile(file_name);
+                  })
+      .def("tvm.rpc.server.cached_module",
+           [](const std::string& key) { return RPCModuleCache::Global()->Get(key); })
+      .def("tvm.rpc.server.cache_module", [](const std::string& key, ffi::Module mod) {
+        RPCModuleCache::Global()->Put(key, std::move(mod));
       });
 }
 
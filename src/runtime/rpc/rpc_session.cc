@@ -40,6 +40,24 @@ void RPCSession::SendException(FAsyncCallback callback, const char* msg) {
   callback(RPCCode::kException, ffi::PackedArgs(packed_args, 1));
 }
 
+uint64_t RPCSession::CallFuncNoWait(PackedFuncHandle func, ffi::PackedArgs args,
+                                    const FEncodeReturn& fencode_return) {
+  this->CallFunc(func, args, fencode_return);
+  return 0;
+}
+
+uint64_t RPCSession::CopyToRemoteNoWait(void* local_from_bytes, DLTensor* remote_to,
+                                        uint64_t nbytes) {
+  this->CopyToRemote(local_from_bytes, remote_to, nbytes);
+  return 0;
+}
+
+uint64_t RPCSession::CopyFromRemoteNoWait(DLTensor* remote_from, void* local_to_bytes,
+                                          uint64_t nbytes) {
+  this->CopyFromRemote(remote_from, local_to_bytes, nbytes);
+  return 0;
+}
+
 void RPCSession::AsyncCallFunc(PackedFuncHandle func, ffi::PackedArgs packed_args,
                                FAsyncCallback callback) {
   try {
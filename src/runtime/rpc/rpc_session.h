@@ -175,6 +175,64 @@ class RPCSession {
    */
   virtual bool IsLocalSession() const = 0;
 
+  // Pipelined variant of the client API
+  // These APIs send a request without waiting for its completion, so that
+  // several requests can be in flight, and return the sequence number that
+  // identifies the request. The requests complete in the order they are sent.
+  //
+  // The default implementations run the requests synchronously.
+
+  /*!
+   * \brief Call into a remote Packed function without waiting for its return.
+   * \param func The function handle.
+   * \param args The input packed arguments.
+   * \param fencode_return The function to set the return value,
+   *                       called once the return is received.
+   * \return The sequence number of the request.
+   */
+  virtual uint64_t CallFuncNoWait(PackedFuncHandle func, ffi::PackedArgs args,
+                                  const FEncodeReturn& fencode_return);
+  /*!
+   * \brief Copy bytes into remote array content without waiting for the copy.
+   * \param local_from_bytes The source host data, which can be released once the call returns.
+   * \param remote_to The target array.
+   * \param nbytes The size of the memory in bytes.
+   * \return The sequence number of the request.
+   */
+  virtual uint64_t CopyToRemoteNoWait(void* local_from_bytes, DLTensor* remote_to,
+                                      uint64_t nbytes);
+  /*!
+   * \brief Copy bytes from remote array content without waiting for the copy.
+   * \param remote_from The source array.
+   * \param local_to_bytes The target host data, which must stay alive until the request is done.
+   * \param nbytes The size of the memory in bytes.
+   * \return The sequence number of the request.
+   */
+  virtual uint64_t CopyFromRemoteNoWait(DLTensor* remote_from, void* local_to_bytes,
+                                        uint64_t nbytes);
+  /*!
+   * \brief Wait until the request with the given sequence number and all the requests sent
+   *  before it are done, and raise the error of the earliest of them that failed.
+   * \param seq The sequence number of the request.
+   */
+  virtual void WaitForRequest(uint64_t seq) {}
+  /*!
+   * \brief Compress the bodies of the copies of at least threshold_bytes with the given codec.
+   *  Sessions that do not send the copies over a wire ignore it.
+   * \param codec The name of the codec, or an empty string to disable the compression.
+   * \param threshold_bytes The minimum size of a compressed copy in bytes.
+   * \param level The compression level passed to the codec.
+   */
+  virtual void EnableCompression(const std::string& codec, uint64_t threshold_bytes, int level) {}
+  /*!
+   * \brief Keep several blocks of a blocking copy in flight instead of waiting for each of them.
+   *  Sessions that do not send the copies over a wire ignore it.
+   * \param window The max number of blocks in flight, 1 to wait for each block.
+   * \param block_nbytes The max size of a block in bytes, or 0 for the max transfer size.
+   * \param verify_crc Whether to check the CRC-32 of each copy on the remote once it is done.
+   */
+  virtual void EnableWindowedCopy(uint64_t window, uint64_t block_nbytes, bool verify_crc) {}
+
   // Asynchrous variant of API
   // These APIs are used by the RPC server to allow sessions that
   // have special implementations for the async functions.
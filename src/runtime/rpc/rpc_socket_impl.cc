@@ -60,6 +60,16 @@ class SockChannel final : public RPCChannel {
     }
     return static_cast<size_t>(n);
   }
+  void SendAll(const void* header, size_t header_size, const void* payload,
+               size_t payload_size) final {
+    if (sock_.SendAll(header, header_size, payload, payload_size) != header_size + payload_size) {
+      support::Socket::Error("SockChannel::SendAll");
+    }
+  }
+  void RecvAll(void* data, size_t size) final {
+    CHECK_EQ(sock_.RecvAll(data, size), size)
+        << "RPCError: Channel closes before all the data is received";
+  }
 
  private:
   support::TCPSocket sock_;
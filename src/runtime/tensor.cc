@@ -28,6 +28,10 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/tensor.h>
 
+#include <algorithm>
+#include <utility>
+
+#include "pinned_staging_pool.h"
 #include "tvm/runtime/data_type.h"
 
 namespace tvm {
@@ -64,6 +68,12 @@ void TensorCopyFromBytes(DLTensor* handle, const void* data, size_t nbytes) {
   ICHECK_EQ(arr_size, nbytes) << "TensorCopyFromBytes: size mismatch";
   ICHECK(IsContiguous(*handle)) << "TensorCopyFromBytes only support contiguous array for now";
 
+  if (PinnedStagingPool::ShouldStage(handle->device, nbytes)) {
+    PinnedStagingPool::ThreadLocal()->CopyFromHost(data, handle, nbytes, nullptr);
+    DeviceAPI::Get(handle->device)->StreamSync(handle->device, nullptr);
+    return;
+  }
+
   DLTensor from;
   from.data = const_cast<void*>(data);
   from.device = Device{kDLCPU, 0};
@@ -83,6 +93,11 @@ void Tensor::CopyToBytes(const DLTensor* handle, void* data, size_t nbytes,
   ICHECK_EQ(arr_size, nbytes) << "ArrayCopyToBytes: size mismatch";
   ICHECK(ffi::IsContiguous(*handle)) << "ArrayCopyToBytes only support contiguous array for now";
 
+  if (PinnedStagingPool::ShouldStage(handle->device, nbytes)) {
+    PinnedStagingPool::ThreadLocal()->CopyToHost(handle, data, nbytes, stream);
+    return;
+  }
+
   DLTensor to;
   to.data = const_cast<void*>(data);
   to.device = Device{kDLCPU, 0};
@@ -103,6 +118,13 @@ void Tensor::CopyFromBytes(const DLTensor* handle, void* data, size_t nbytes,
   ICHECK_EQ(arr_size, nbytes) << "ArrayCopyToBytes: size mismatch";
   ICHECK(ffi::IsContiguous(*handle)) << "ArrayCopyToBytes only support contiguous array for now";
 
+  if (PinnedStagingPool::ShouldStage(handle->device, nbytes)) {
+    PinnedStagingPool::ThreadLocal()->CopyFromHost(data, const_cast<DLTensor*>(handle), nbytes,
+                                                   stream);
+    DeviceAPI::Get(handle->device)->StreamSync(handle->device, stream);
+    return;
+  }
+
   DLTensor from;
   from.data = const_cast<void*>(data);
   from.device = Device{kDLCPU, 0};
@@ -132,6 +154,70 @@ Tensor Tensor::Empty(ffi::Shape shape, DLDataType dtype, Device dev,
   return ffi::Tensor::FromNDAlloc(DeviceAPIAlloc(), shape, dtype, dev, mem_scope);
 }
 
+Tensor Tensor::FromExternal(void* data, ffi::Shape shape, DLDataType dtype, Device dev,
+                            std::function<void(void*)> deleter,
+                            ffi::Optional<ffi::Shape> strides, int64_t byte_offset,
+                            size_t alignment) {
+  VerifyDataType(dtype);
+  CHECK(data != nullptr || shape.Product() == 0)
+      << "ValueError: Cannot create a Tensor of shape " << shape << " from a null buffer";
+  CHECK_GE(byte_offset, 0) << "ValueError: The byte offset must not be negative, but got "
+                           << byte_offset;
+  CHECK(alignment != 0 && (alignment & (alignment - 1)) == 0)
+      << "ValueError: The alignment must be a power of 2, but got " << alignment;
+  uintptr_t address = reinterpret_cast<uintptr_t>(data);
+  CHECK_EQ(address % alignment, 0)
+      << "ValueError: The buffer " << data << " is not aligned to " << alignment << " bytes";
+  size_t elem_bytes = std::max<size_t>((dtype.bits * dtype.lanes + 7) / 8, 1);
+  CHECK_EQ((address + byte_offset) % elem_bytes, 0)
+      << "ValueError: The first element, at byte offset " << byte_offset << ", is not aligned to "
+      << "the " << elem_bytes << " bytes of the elements of " << dtype;
+  if (strides.defined()) {
+    const ffi::Shape& s = strides.value();
+    CHECK_EQ(s.size(), shape.size()) << "ValueError: The strides " << s << " do not match the "
+                                     << shape.size() << " dimensions of the shape " << shape;
+    bool compact = true;
+    int64_t expected = 1;
+    for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+      CHECK_GE(s[i], 0) << "ValueError: The strides " << s << " must not be negative";
+      if (shape[i] != 1 && s[i] != expected) compact = false;
+      expected *= shape[i];
+    }
+    CHECK(compact || dtype.bits * dtype.lanes % 8 == 0)
+        << "ValueError: Tensors of " << dtype << " must be compact, but got the strides " << s
+        << " for the shape " << shape;
+    if (compact) strides = std::nullopt;
+  }
+
+  // helper allocator class that hands the buffer back to its owner
+  class ExternalAlloc {
+   public:
+    ExternalAlloc(void* data, std::function<void(void*)> deleter,
+                  ffi::Optional<ffi::Shape> strides)
+        : data_(data), deleter_(std::move(deleter)), strides_(std::move(strides)) {}
+    void AllocData(DLTensor* tensor, int64_t byte_offset) {
+      tensor->data = data_;
+      tensor->byte_offset = byte_offset;
+      if (strides_.defined()) {
+        // strides_ lives as long as the tensor, in the allocator stored by the container.
+        tensor->strides = const_cast<int64_t*>(strides_.value().data());
+      }
+    }
+
+    void FreeData(DLTensor* tensor) {
+      if (deleter_) deleter_(data_);
+    }
+
+   private:
+    void* data_;
+    std::function<void(void*)> deleter_;
+    ffi::Optional<ffi::Shape> strides_;
+  };
+
+  return Tensor::FromNDAlloc(ExternalAlloc(data, std::move(deleter), std::move(strides)), shape,
+                             dtype, dev, byte_offset);
+}
+
 Tensor Tensor::CreateView(ffi::Shape shape, DLDataType dtype, uint64_t relative_byte_offset) const {
   ICHECK(data_ != nullptr);
 
@@ -228,6 +314,23 @@ void Tensor::CopyFromTo(const DLTensor* from, DLTensor* to, TVMStreamHandle stre
   // api manager.
   Device dev = from->device.device_type != kDLCPU ? from->device : to->device;
 
+  // Stage the copies between pageable memory and the device, the copies to the device remain
+  // asynchronous while the copies to the host complete before returning.
+  if (from->device.device_type != to->device.device_type &&
+      PinnedStagingPool::ShouldStage(dev, from_size) && ffi::IsContiguous(*from) &&
+      ffi::IsContiguous(*to)) {
+    if (from->device.device_type == kDLCPU) {
+      PinnedStagingPool::ThreadLocal()->CopyFromHost(
+          static_cast<const char*>(from->data) + from->byte_offset, to, from_size, stream);
+      return;
+    }
+    if (to->device.device_type == kDLCPU) {
+      PinnedStagingPool::ThreadLocal()->CopyToHost(
+          from, static_cast<char*>(to->data) + to->byte_offset, from_size, stream);
+      return;
+    }
+  }
+
   DeviceAPI::Get(dev)->CopyDataFromTo(const_cast<DLTensor*>(from), to, stream);
 }
 
@@ -241,6 +344,16 @@ TVM_FFI_STATIC_INIT_BLOCK() {
   refl::GlobalDef()
       .def("runtime.TVMTensorAllocWithScope", Tensor::Empty)
       .def_method("runtime.TVMTensorCreateView", &Tensor::CreateView)
+      .def("runtime.TVMTensorFromExternal",
+           [](void* data, ffi::Shape shape, DLDataType dtype, Device dev,
+              ffi::Optional<ffi::Function> deleter, ffi::Optional<ffi::Shape> strides,
+              int64_t byte_offset) {
+             std::function<void(void*)> fdelete;
+             if (deleter.defined()) {
+               fdelete = [deleter](void* data) { deleter.value()(data); };
+             }
+             return Tensor::FromExternal(data, shape, dtype, dev, fdelete, strides, byte_offset);
+           })
       .def("runtime.TVMTensorCopyFromBytes",
            [](DLTensor* arr, void* data, size_t nbytes) { TensorCopyFromBytes(arr, data, nbytes); })
       .def("runtime.TVMTensorCopyToBytes",
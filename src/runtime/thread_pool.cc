@@ -32,10 +32,14 @@
 #if TVM_THREADPOOL_USE_OPENMP
 #include <omp.h>
 #endif
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sched.h>
+#endif
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -60,6 +64,44 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+/*! \brief The thread pool implementations that back TVMBackendParallelLaunch. */
+enum class ThreadPoolKind : int {
+  /*! \brief One task per worker through single-producer-single-consumer queues. */
+  kSpsc = 0,
+  /*! \brief Work-stealing deques, supports nested launches and over-decomposition. */
+  kWorkStealing = 1,
+};
+
+ThreadPoolKind ReadThreadPoolKind() {
+  const char* val = getenv("TVM_THREAD_POOL_KIND");
+  if (!val || std::string(val).empty() || std::string(val) == "default" ||
+      std::string(val) == "spsc") {
+    return ThreadPoolKind::kSpsc;
+  }
+  if (std::string(val) == "work_stealing") {
+    return ThreadPoolKind::kWorkStealing;
+  }
+  LOG(WARNING) << "Unknown TVM_THREAD_POOL_KIND \"" << val
+               << "\", expected one of \"default\", \"work_stealing\"";
+  return ThreadPoolKind::kSpsc;
+}
+
+/*! \brief The selected thread pool kind, re-read from the environment on ResetThreadPool. */
+std::atomic<ThreadPoolKind>& CurrentThreadPoolKind() {
+  static std::atomic<ThreadPoolKind> kind{ReadThreadPoolKind()};
+  return kind;
+}
+
+constexpr int kDefaultChunksPerWorker = 4;
+
+int GetChunksPerWorker() {
+  const char* val = getenv("TVM_THREAD_POOL_CHUNKS_PER_WORKER");
+  if (!val) {
+    return kDefaultChunksPerWorker;
+  }
+  return std::max(atoi(val), 1);
+}
+
 }  // namespace
 
 // stride in the page, fit to cache line.
@@ -73,6 +115,7 @@ class ParallelLauncher {
   // Reset the task request.
   void Init(FTVMParallelLambda flambda, void* cdata, int num_task, bool need_sync) {
     num_pending_.store(num_task);
+    dynamic = false;
     this->cdata = cdata;
     this->flambda = flambda;
     this->env.num_task = num_task;
@@ -94,6 +137,26 @@ class ParallelLauncher {
       this->env.sync_handle = nullptr;
     }
   }
+  // Reset the task request of a launch whose tasks are taken dynamically by num_runner threads.
+  // The tasks do not run concurrently, so they cannot synchronize.
+  void InitDynamic(FTVMParallelLambda flambda, void* cdata, int num_task, int num_runner) {
+    Init(flambda, cdata, num_task, false);
+    num_pending_.store(num_runner);
+    next_task_.store(0);
+    dynamic = true;
+  }
+  // Run the tasks of a dynamic launch until none is left, then signal the runner has finished.
+  void RunDynamicTasks() {
+    int task_id;
+    while ((task_id = next_task_.fetch_add(1, std::memory_order_relaxed)) < env.num_task) {
+      if ((*flambda)(task_id, &env, cdata) != 0) {
+        par_errors_[task_id] = tvm::ffi::details::MoveFromSafeCallRaised();
+        has_error_.store(true);
+        break;
+      }
+    }
+    num_pending_.fetch_sub(1);
+  }
   ~ParallelLauncher() { delete[] sync_counter_; }
   // Wait n jobs to finish
   int WaitForJobs() {
@@ -132,8 +195,12 @@ class ParallelLauncher {
   // Whether this thread is worker of the pool.
   // used to prevent recursive launch.
   bool is_worker{false};
+  // Whether the tasks are taken dynamically by the runners.
+  bool dynamic{false};
 
  private:
+  // The next task of a dynamic launch.
+  std::atomic<int32_t> next_task_{0};
   // The pending jobs.
   std::atomic<int32_t> num_pending_;
   // Whether error has been countered.
@@ -268,6 +335,14 @@ class ThreadPool {
     }
     Init();
   }
+  /*!
+   * \brief Create a pool with a worker bound to each of the given CPUs. The launching thread
+   *  runs the task 0, and is expected to be bound to the CPUs by the caller.
+   */
+  explicit ThreadPool(std::vector<unsigned int> cpus)
+      : num_workers_(static_cast<int>(cpus.size())), cpus_(std::move(cpus)) {
+    Init();
+  }
 
   ~ThreadPool() {
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
@@ -290,6 +365,9 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    if (num_task == 0 && num_dynamic_tasks_ > 0) {
+      return LaunchDynamic(launcher, flambda, cdata);
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -329,11 +407,45 @@ class ThreadPool {
     // if MaxConcurrency restricted the number of workers (e.g., due to
     // hyperthreading), respect the restriction
     num_workers_used_ = std::min(num_workers_, num_workers_used_);
+    num_dynamic_tasks_ = 0;
+    if (mode == threading::ThreadGroup::kHybrid) {
+      // Split the launches into chunks proportional to the estimated throughput of the cores,
+      // so that a slow core takes a chunk of about its share while a fast core takes several.
+      static int chunks_per_fast_core = GetHybridChunksPerCore();
+      std::vector<double> throughputs = threads_->WorkerThroughputs();
+      double total = 0;
+      for (int i = 0; i < num_workers_used_ && i < static_cast<int>(throughputs.size()); ++i) {
+        total += throughputs[i];
+      }
+      num_dynamic_tasks_ =
+          std::max(num_workers_used_, static_cast<int>(total * chunks_per_fast_core + 0.5));
+    }
   }
 
   int32_t NumThreads() const { return num_workers_used_; }
 
  private:
+  // Launch num_dynamic_tasks_ tasks, which the workers take one after the other, so that the
+  // fast cores run more of them than the slow ones.
+  int LaunchDynamic(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata) {
+    launcher->InitDynamic(flambda, cdata, num_dynamic_tasks_, num_workers_used_);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    tsk.task_id = -1;
+    for (int i = exclude_worker0_; i < num_workers_used_; ++i) {
+      queues_[i]->Push(tsk);
+    }
+    if (exclude_worker0_) {
+      launcher->RunDynamicTasks();
+    }
+    return launcher->WaitForJobs();
+  }
+
+  static int GetHybridChunksPerCore() {
+    const char* val = getenv("TVM_THREAD_POOL_HYBRID_CHUNKS");
+    return val ? std::max(1, atoi(val)) : 4;
+  }
+
   // Shared initialization code
   void Init() {
     for (int i = 0; i < num_workers_; ++i) {
@@ -343,7 +455,13 @@ class ThreadPool {
     threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
         num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
         exclude_worker0_ /* include_main_thread */);
-    num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    num_dynamic_tasks_ = 0;
+    if (cpus_.empty()) {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    } else {
+      num_workers_used_ = threads_->Configure(threading::ThreadGroup::kSpecifyOneCorePerThread, 0,
+                                              exclude_worker0_, cpus_);
+    }
   }
 
   // Internal worker function.
@@ -357,6 +475,10 @@ class ThreadPool {
     static size_t spin_count = GetSpinCount();
     while (queue->Pop(&task, spin_count)) {
       ICHECK(task.launcher != nullptr);
+      if (task.launcher->dynamic) {
+        task.launcher->RunDynamicTasks();
+        continue;
+      }
       TVMParallelGroupEnv* penv = &(task.launcher->env);
       void* cdata = task.launcher->cdata;
       if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
@@ -369,12 +491,281 @@ class ThreadPool {
   int num_workers_;
   // number of workers used (can be restricted with affinity pref)
   int num_workers_used_;
+  // number of tasks taken dynamically by the workers on a launch with num_task == 0, or 0 to
+  // give a single task to each worker
+  int num_dynamic_tasks_{0};
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
+  // the cpus of an isolated pool, empty for the thread-local pools
+  std::vector<unsigned int> cpus_;
   std::vector<std::unique_ptr<SpscTaskQueue>> queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
 };
 
+/*!
+ * \brief A thread pool whose workers own a deque of tasks and steal from each other.
+ *
+ * Compared to ThreadPool, this pool
+ *  - splits a launch with num_task == 0 into TVM_THREAD_POOL_CHUNKS_PER_WORKER tasks per
+ *    worker, so idle workers pick up the remaining chunks of an unbalanced loop;
+ *  - allows launching a parallel job from inside a task. The nested tasks are pushed to the
+ *    deque of the launching worker, which keeps executing tasks until its job is done.
+ *
+ * Parallel barriers require all tasks of a launch to run concurrently, so they are only
+ * supported by top-level launches with at most one task per worker.
+ */
+class WorkStealingThreadPool {
+ public:
+  WorkStealingThreadPool()
+      : num_workers_(tvm::runtime::threading::MaxConcurrency()),
+        chunks_per_worker_(GetChunksPerWorker()) {
+    Init();
+  }
+
+  ~WorkStealingThreadPool() { Shutdown(); }
+
+  void Reset() {
+    Shutdown();
+    Init();
+  }
+
+  int Launch(FTVMParallelLambda flambda, void* cdata, int num_task, int need_sync) {
+    WorkerContext* ctx = WorkerContext::ThreadLocal();
+    if (ctx->pool == nullptr) {
+      // The launching thread takes the slot of worker 0.
+      ctx->pool = this;
+      ctx->worker_id = 0;
+    }
+    ICHECK(ctx->pool == this);
+    bool nested = ctx->depth >= 0;
+    int num_workers_used = num_workers_used_.load(std::memory_order_relaxed);
+    if (num_task == 0) {
+      num_task = nested ? num_workers_used : num_workers_used * chunks_per_worker_;
+    }
+
+    LaunchState launch;
+    launch.flambda = flambda;
+    launch.cdata = cdata;
+    launch.depth = ctx->depth + 1;
+    launch.env.num_task = num_task;
+    launch.env.sync_handle = nullptr;
+    launch.num_pending.store(num_task);
+    launch.errors.resize(num_task);
+    std::unique_ptr<std::atomic<int>[]> sync_counter;
+    if (need_sync != 0 && !nested && num_task <= num_workers_used) {
+      sync_counter.reset(new std::atomic<int>[num_task * kSyncStride]);
+      for (int i = 0; i < num_task; ++i) {
+        sync_counter[i * kSyncStride].store(0, std::memory_order_relaxed);
+      }
+      launch.env.sync_handle = sync_counter.get();
+    }
+
+    for (int i = 1; i < num_task; ++i) {
+      // Top-level tasks are spread over all workers, nested ones stay on the launching worker
+      // and are stolen by others on demand.
+      int target = nested ? ctx->worker_id : i % num_workers_used;
+      queues_[target]->Push(Task{&launch, i});
+    }
+    if (num_task > 1) {
+      NotifyWorkers(num_task - 1);
+    }
+    RunTask(ctx, Task{&launch, 0});
+    // Help with the pending tasks, restricted to the depth of this launch so that we never
+    // block in an unrelated task while our own job is waiting to finish.
+    Task task;
+    while (launch.num_pending.load(std::memory_order_acquire) != 0) {
+      if (PopTask(ctx->worker_id, launch.depth, &task)) {
+        RunTask(ctx, task);
+      } else {
+        tvm::runtime::threading::YieldThread();
+      }
+    }
+    if (!launch.has_error.load()) return 0;
+    std::ostringstream os;
+    for (int i = 0; i < num_task; ++i) {
+      if (launch.errors[i].has_value()) {
+        os << "Task " << i << " error: " << (*launch.errors[i]).what();
+      }
+    }
+    TVMFFIErrorSetRaisedFromCStr("RuntimeError", os.str().c_str());
+    return -1;
+  }
+
+  static WorkStealingThreadPool* ThreadLocal() {
+    return dmlc::ThreadLocalStore<WorkStealingThreadPool>::Get();
+  }
+
+  /*! \return The pool of the calling thread if it is currently running a task, else nullptr. */
+  static WorkStealingThreadPool* Current() {
+    WorkerContext* ctx = WorkerContext::ThreadLocal();
+    return ctx->depth >= 0 ? ctx->pool : nullptr;
+  }
+
+  void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
+                                 const std::vector<unsigned int>& cpus) {
+    int num_workers_used = threads_->Configure(mode, nthreads, /*exclude_worker0=*/true, cpus);
+    num_workers_used_.store(std::min(num_workers_, num_workers_used));
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+  }
+
+  int32_t NumThreads() const { return num_workers_used_.load(std::memory_order_relaxed); }
+
+ private:
+  struct LaunchState {
+    FTVMParallelLambda flambda;
+    void* cdata;
+    TVMParallelGroupEnv env;
+    /*! \brief The nesting depth of the launch, 0 for launches from outside of the pool. */
+    int depth;
+    std::atomic<int32_t> num_pending;
+    std::atomic<bool> has_error{false};
+    std::vector<ffi::Optional<tvm::ffi::Error>> errors;
+  };
+
+  struct Task {
+    LaunchState* launch;
+    int32_t task_id;
+  };
+
+  /*! \brief A worker's deque. The owner pops from the back, thieves take from the front. */
+  class alignas(kL1CacheBytes) TaskDeque {
+   public:
+    void Push(const Task& task) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(task);
+    }
+
+    bool PopBack(int min_depth, Task* task) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (tasks_.empty() || tasks_.back().launch->depth < min_depth) return false;
+      *task = tasks_.back();
+      tasks_.pop_back();
+      return true;
+    }
+
+    bool StealFront(int min_depth, Task* task) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (tasks_.empty() || tasks_.front().launch->depth < min_depth) return false;
+      *task = tasks_.front();
+      tasks_.pop_front();
+      return true;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+  };
+
+  /*! \brief Per-thread state, shared by the workers and the thread that owns the pool. */
+  struct WorkerContext {
+    WorkStealingThreadPool* pool{nullptr};
+    int worker_id{0};
+    /*! \brief The depth of the task being executed by this thread, -1 if none. */
+    int depth{-1};
+
+    static WorkerContext* ThreadLocal() { return dmlc::ThreadLocalStore<WorkerContext>::Get(); }
+  };
+
+  void Init() {
+    exit_now_.store(false);
+    num_queued_.store(0);
+    for (int i = 0; i < num_workers_; ++i) {
+      queues_.emplace_back(std::make_unique<TaskDeque>());
+    }
+    threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
+        num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
+        /*exclude_worker0=*/true);
+    num_workers_used_.store(
+        threads_->Configure(threading::ThreadGroup::kBig, 0, /*exclude_worker0=*/true));
+  }
+
+  void Shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_now_.store(true);
+      cv_.notify_all();
+    }
+    threads_.reset();
+    queues_.clear();
+  }
+
+  void NotifyWorkers(int num_tasks) {
+    num_queued_.fetch_add(num_tasks);
+    if (num_sleeping_.load() != 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_all();
+    }
+  }
+
+  /*! \brief Take a task of depth at least min_depth, from our own deque first. */
+  bool PopTask(int worker_id, int min_depth, Task* task) {
+    if (num_queued_.load(std::memory_order_relaxed) <= 0) return false;
+    bool found = queues_[worker_id]->PopBack(min_depth, task);
+    for (int i = 1; !found && i < num_workers_; ++i) {
+      found = queues_[(worker_id + i) % num_workers_]->StealFront(min_depth, task);
+    }
+    if (found) {
+      num_queued_.fetch_sub(1);
+    }
+    return found;
+  }
+
+  void RunTask(WorkerContext* ctx, const Task& task) {
+    LaunchState* launch = task.launch;
+    int prev_depth = ctx->depth;
+    ctx->depth = launch->depth;
+    int ret = (*launch->flambda)(task.task_id, &launch->env, launch->cdata);
+    ctx->depth = prev_depth;
+    if (ret != 0) {
+      launch->errors[task.task_id] = tvm::ffi::details::MoveFromSafeCallRaised();
+      launch->has_error.store(true);
+    }
+    launch->num_pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  void RunWorker(int worker_id) {
+    WorkerContext* ctx = WorkerContext::ThreadLocal();
+    ctx->pool = this;
+    ctx->worker_id = worker_id;
+    static uint32_t spin_count = GetSpinCount();
+    Task task;
+    while (!exit_now_.load(std::memory_order_relaxed)) {
+      bool enabled = worker_id < num_workers_used_.load(std::memory_order_relaxed);
+      if (enabled && PopTask(worker_id, 0, &task)) {
+        RunTask(ctx, task);
+        continue;
+      }
+      // Busy wait a bit before going to sleep, following the convention of SpscTaskQueue.
+      for (uint32_t i = 0; i < spin_count && enabled && num_queued_.load() <= 0 &&
+                           !exit_now_.load(std::memory_order_relaxed);
+           ++i) {
+        tvm::runtime::threading::YieldThread();
+      }
+      if (enabled && num_queued_.load() > 0) continue;
+      std::unique_lock<std::mutex> lock(mutex_);
+      num_sleeping_.fetch_add(1);
+      cv_.wait(lock, [this, worker_id] {
+        return exit_now_.load() || (num_queued_.load() > 0 &&
+                                    worker_id < num_workers_used_.load(std::memory_order_relaxed));
+      });
+      num_sleeping_.fetch_sub(1);
+    }
+  }
+
+  int num_workers_;
+  int chunks_per_worker_;
+  std::atomic<int> num_workers_used_{0};
+  std::vector<std::unique_ptr<TaskDeque>> queues_;
+  std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
+  /*! \brief Number of tasks pushed to the deques and not yet taken. */
+  std::atomic<int> num_queued_{0};
+  std::atomic<int> num_sleeping_{0};
+  std::atomic<bool> exit_now_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
 /*!
  * \brief args[0] is the AffinityMode, args[1] is the number of threads.
  *  args2 is a list of CPUs which is used to set the CPU affinity.
@@ -453,11 +844,18 @@ static void ConfigureOMP(tvm::runtime::threading::ThreadGroup::AffinityMode mode
 
 #endif
 
-void ResetThreadPool() { tvm::runtime::ThreadPool::ThreadLocal()->Reset(); }
+void ResetThreadPool() {
+  CurrentThreadPoolKind().store(ReadThreadPoolKind());
+  if (CurrentThreadPoolKind().load() == ThreadPoolKind::kWorkStealing) {
+    tvm::runtime::WorkStealingThreadPool::ThreadLocal()->Reset();
+  } else {
+    tvm::runtime::ThreadPool::ThreadLocal()->Reset();
+  }
+}
 /*!
  * \brief configure the CPU id affinity
  * \param mode The preferred CPU type (1 = big, -1 = little, -2 = kSpecifyOneCorePerThread,
- *  -3 = kSpecifyThreadShareAllCore).
+ *  -3 = kSpecifyThreadShareAllCore, -4 = kNuma, -5 = kHybrid).
  * \param nthreads The number of threads to use (0 = use all).
  * \param cpus cpus A list of CPUs is used to set the 'cpu affinity' for the worker threads.
  *
@@ -466,17 +864,177 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
                        std::vector<unsigned int> cpus) {
   tvm::runtime::threading::SetMaxConcurrency(cpus.size());
 #if !TVM_THREADPOOL_USE_OPENMP
-  tvm::runtime::ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads, cpus);
+  if (CurrentThreadPoolKind().load() == ThreadPoolKind::kWorkStealing) {
+    tvm::runtime::WorkStealingThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads,
+                                                                                   cpus);
+  } else {
+    tvm::runtime::ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads, cpus);
+  }
 #else
   ConfigureOMP(mode, nthreads, cpus);
 #endif
 }
-int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+int32_t NumThreads() {
+  if (IsolatedThreadPool* pool = IsolatedThreadPool::Current()) {
+    return static_cast<int32_t>(pool->cpus().size());
+  }
+  if (CurrentThreadPoolKind().load() == ThreadPoolKind::kWorkStealing) {
+    return tvm::runtime::WorkStealingThreadPool::ThreadLocal()->NumThreads();
+  }
+  return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads();
+}
+
+namespace {
+
+/*! \brief The isolated pool the current thread is in a scope of. */
+thread_local IsolatedThreadPool* current_isolated_pool = nullptr;
+/*! \brief Whether the current thread runs a task of an isolated pool. */
+thread_local bool in_isolated_task = false;
+
+std::vector<unsigned int> GetCurrentThreadAffinity() {
+  std::vector<unsigned int> cpus;
+#if defined(__linux__) && !defined(__ANDROID__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpuset)) cpus.push_back(cpu);
+    }
+  }
+#endif
+  return cpus;
+}
+
+void SetCurrentThreadAffinity(const std::vector<unsigned int>& cpus) {
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (cpus.empty()) return;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (unsigned int cpu : cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+    LOG(WARNING) << "sched_setaffinity failed";
+  }
+#endif
+}
+
+}  // namespace
+
+class IsolatedThreadPool::Impl {
+ public:
+  explicit Impl(std::vector<unsigned int> cpus) : cpus(cpus) {
+    // The pool binds the creating thread as its main thread, which is only right for the
+    // threads in a scope of the pool, so restore the affinity of the creating thread.
+    std::vector<unsigned int> affinity = GetCurrentThreadAffinity();
+    pool = std::make_unique<ThreadPool>(std::move(cpus));
+    SetCurrentThreadAffinity(affinity);
+  }
+
+  int Launch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+    // The task queues of the pool have a single producer.
+    std::lock_guard<std::mutex> lock(mutex);
+    return pool->Launch(flambda, cdata, num_task, 1);
+  }
+
+  std::vector<unsigned int> cpus;
+  std::unique_ptr<ThreadPool> pool;
+  std::mutex mutex;
+};
+
+IsolatedThreadPool::IsolatedThreadPool(std::vector<unsigned int> cpus) {
+  CHECK(!cpus.empty()) << "ValueError: An isolated thread pool needs at least one CPU";
+  impl_ = new Impl(std::move(cpus));
+}
+IsolatedThreadPool::~IsolatedThreadPool() { delete impl_; }
+const std::vector<unsigned int>& IsolatedThreadPool::cpus() const { return impl_->cpus; }
+IsolatedThreadPool* IsolatedThreadPool::Current() { return current_isolated_pool; }
+
+IsolatedThreadPool::Scope::Scope(IsolatedThreadPool* pool)
+    : prev_(current_isolated_pool), entered_(pool != current_isolated_pool) {
+  if (!entered_) return;
+  if (pool != nullptr) {
+    prev_cpus_ = GetCurrentThreadAffinity();
+    SetCurrentThreadAffinity(pool->cpus());
+  }
+  current_isolated_pool = pool;
+}
+
+IsolatedThreadPool::Scope::~Scope() {
+  if (!entered_) return;
+  SetCurrentThreadAffinity(prev_cpus_);
+  current_isolated_pool = prev_;
+}
+
+int IsolatedThreadPool::Launch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  // A nested launch from a task would wait for the pool that runs the task, e.g. on the lock
+  // held by the launching thread, so it runs inline as a single task, as on Hexagon.
+  if (in_isolated_task) {
+    std::atomic<int32_t> sync_counter{0};
+    TVMParallelGroupEnv env;
+    env.num_task = 1;
+    env.sync_handle = &sync_counter;
+    return (*flambda)(0, &env, cdata) == 0 ? 0 : -1;
+  }
+  struct Closure {
+    IsolatedThreadPool* pool;
+    FTVMParallelLambda flambda;
+    void* cdata;
+  } closure{this, flambda, cdata};
+  // The workers run the tasks in the scope of the pool, so their nested launches come back here.
+  FTVMParallelLambda run_task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    auto* closure = static_cast<Closure*>(cdata);
+    IsolatedThreadPool* prev_pool = current_isolated_pool;
+    current_isolated_pool = closure->pool;
+    in_isolated_task = true;
+    int ret = (*closure->flambda)(task_id, penv, closure->cdata);
+    in_isolated_task = false;
+    current_isolated_pool = prev_pool;
+    return ret;
+  };
+  return impl_->Launch(run_task, &closure, num_task);
+}
+
+bool SupportsNestedLaunch() {
+  if (IsolatedThreadPool::Current() != nullptr) {
+    // The nested launches of its tasks run inline.
+    return true;
+  }
+#if TVM_THREADPOOL_USE_OPENMP
+  return true;
+#else
+  return MaxConcurrency() == 1 ||
+         CurrentThreadPoolKind().load() == ThreadPoolKind::kWorkStealing;
+#endif
+}
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
 
+#if defined(__hexagon__)
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+// Defined in hexagon/hexagon_device_api.cc.
+bool HexagonParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int* ret);
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
+#endif
+
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  using tvm::runtime::threading::IsolatedThreadPool;
+  if (IsolatedThreadPool* pool = IsolatedThreadPool::Current()) {
+    return pool->Launch(flambda, cdata, num_task);
+  }
+#if defined(__hexagon__)
+  // Run on the threads of the Hexagon runtime that hold the HVX instances, rather than on
+  // threads that would have to lock an HVX instance for each task.
+  int hexagon_ret = 0;
+  if (tvm::runtime::hexagon::HexagonParallelLaunch(flambda, cdata, num_task, &hexagon_ret)) {
+    return hexagon_ret;
+  }
+#endif
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_workers == 1) {
     std::atomic<int32_t> sync_counter{0};
@@ -487,6 +1045,15 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
+    using tvm::runtime::WorkStealingThreadPool;
+    // Nested launches go to the pool that runs the current task.
+    if (WorkStealingThreadPool* pool = WorkStealingThreadPool::Current()) {
+      return pool->Launch(flambda, cdata, num_task, 1);
+    }
+    if (tvm::runtime::CurrentThreadPoolKind().load() ==
+        tvm::runtime::ThreadPoolKind::kWorkStealing) {
+      return WorkStealingThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
+    }
     int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
     return res;
 #else
@@ -510,6 +1077,11 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
   using tvm::runtime::kSyncStride;
   int num_task = penv->num_task;
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
+  CHECK(sync_counter != nullptr)
+      << "Parallel barrier requires all tasks of the launch to run concurrently, which is not "
+      << "the case for nested launches, launches with more tasks than workers, or launches of "
+      << "the kHybrid affinity mode. "
+      << "Set TVM_THREAD_POOL_CHUNKS_PER_WORKER=1 to use barriers with the work-stealing pool.";
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
   for (int i = 0; i < num_task; ++i) {
     if (i != task_id) {
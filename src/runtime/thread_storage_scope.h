@@ -211,6 +211,10 @@ struct ThreadScope {
     } else if (s.compare(0, 10, "threadIdx.") == 0) {
       r.rank = 1;
       r.dim_index = static_cast<int>(s[10] - 'x');
+    } else if (s.compare(0, 11, "clusterIdx.") == 0) {
+      // the rank of a block within its thread block cluster, at the same level as blocks
+      r.rank = 0;
+      r.dim_index = static_cast<int>(s[11] - 'x');
     } else {
       LOG(FATAL) << "Unknown threadscope " << s;
     }
@@ -220,8 +224,8 @@ struct ThreadScope {
 
 /*! \brief workload specification */
 struct ThreadWorkLoad {
-  // array, first three are thread configuration.
-  size_t work_size[6];
+  // array, first three are thread configuration, last three are the cluster configuration.
+  size_t work_size[9];
   // Dynamic shared memory allocation size in bytes.
   size_t dyn_shmem_size{0};
   /*!
@@ -234,13 +238,18 @@ struct ThreadWorkLoad {
    * \return i-th grid dim
    */
   inline size_t grid_dim(size_t i) const { return work_size[i]; }
+  /*!
+   * \param i The cluster dimension.
+   * \return i-th cluster dim, the number of blocks per cluster along the dimension.
+   */
+  inline size_t cluster_dim(size_t i) const { return work_size[i + 6]; }
 };
 /*! \brief Launch parameters configuration */
 class LaunchParamConfig {
  public:
   void Init(size_t base, const std::vector<std::string>& launch_param_tags) {
     base_ = base;
-    std::vector<bool> filled(6, false);
+    std::vector<bool> filled(9, false);
     for (size_t i = 0; i < launch_param_tags.size(); ++i) {
       const std::string& tag = launch_param_tags[i];
       if (tag == launch_param::kUseDynamicSharedMemoryTag) {
@@ -251,6 +260,11 @@ class LaunchParamConfig {
         use_programmatic_dependent_launch_ = true;
       } else if (tag == launch_param::kUseCooperativeLaunch) {
         use_cooperative_launch_ = true;
+      } else if (tag.compare(0, 11, "clusterIdx.") == 0) {
+        ThreadScope ts = ThreadScope::Create(tag);
+        arg_index_map_.push_back(6 + ts.dim_index);
+        filled[6 + ts.dim_index] = true;
+        use_cluster_launch_ = true;
       } else {
         ThreadScope ts = ThreadScope::Create(tag);
         arg_index_map_.push_back(ts.rank * 3 + ts.dim_index);
@@ -259,7 +273,7 @@ class LaunchParamConfig {
     }
     work_dim_ = 1;
     for (int i = 0; i < 3; ++i) {
-      if (filled[i] || filled[i + 3]) {
+      if (filled[i] || filled[i + 3] || filled[i + 6]) {
         work_dim_ = i + 1;
       }
     }
@@ -267,7 +281,7 @@ class LaunchParamConfig {
   // extract workload from arguments.
   ThreadWorkLoad Extract(ffi::PackedArgs args) const {
     ThreadWorkLoad w;
-    std::fill(w.work_size, w.work_size + 6, 1);
+    std::fill(w.work_size, w.work_size + 9, 1);
     const TVMFFIAny* raw_args = reinterpret_cast<const TVMFFIAny*>(args.data());
 
     for (size_t i = 0; i < arg_index_map_.size(); ++i) {
@@ -289,6 +303,8 @@ class LaunchParamConfig {
 
   bool use_cooperative_launch() const { return use_cooperative_launch_; }
 
+  bool use_cluster_launch() const { return use_cluster_launch_; }
+
  private:
   /*! \brief base axis */
   size_t base_;
@@ -302,6 +318,8 @@ class LaunchParamConfig {
   bool use_programmatic_dependent_launch_{false};
   /*! \brief Whether or not use cooperative launch. */
   bool use_cooperative_launch_{false};
+  /*! \brief Whether or not launch the blocks in thread block clusters. */
+  bool use_cluster_launch_{false};
 };
 
 }  // namespace runtime
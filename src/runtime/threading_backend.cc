@@ -49,6 +49,7 @@ extern "C" {
 #define HEXAGON_STACK_ALIGNMENT 32
 #endif
 #include <algorithm>
+#include <string>
 #include <thread>
 #define CURRENT_THREAD_HANDLE (static_cast<std::thread::native_handle_type>(0))
 namespace tvm {
@@ -142,6 +143,60 @@ void SetThreadAffinity(std::thread::native_handle_type thread,
 #endif
 }
 
+namespace {
+
+#if defined(__linux__) || defined(__ANDROID__)
+/*! \brief Parse a list of CPUs in the sysfs format, e.g. "0-15,32-47". */
+std::vector<unsigned int> ParseCpuList(const std::string& list) {
+  std::vector<unsigned int> cpus;
+  std::istringstream is(list);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    if (range.empty()) continue;
+    size_t dash = range.find('-');
+    unsigned int begin = std::stoul(range.substr(0, dash));
+    unsigned int end = dash == std::string::npos ? begin : std::stoul(range.substr(dash + 1));
+    for (unsigned int cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+#endif
+
+std::vector<std::vector<unsigned int>> ReadNumaNodeCpus() {
+  std::vector<std::vector<unsigned int>> nodes;
+#if defined(__linux__) || defined(__ANDROID__)
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string online_list;
+  if (std::getline(online, online_list)) {
+    for (unsigned int node : ParseCpuList(online_list)) {
+      std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string cpu_list;
+      if (!std::getline(ifs, cpu_list)) continue;
+      if (nodes.size() <= node) nodes.resize(node + 1);
+      nodes[node] = ParseCpuList(cpu_list);
+    }
+  }
+#endif
+  bool has_cpu = std::any_of(nodes.begin(), nodes.end(),
+                             [](const std::vector<unsigned int>& cpus) { return !cpus.empty(); });
+  if (!has_cpu) {
+    nodes.assign(1, {});
+    for (unsigned int i = 0; i < std::thread::hardware_concurrency(); ++i) {
+      nodes[0].push_back(i);
+    }
+  }
+  return nodes;
+}
+
+}  // namespace
+
+const std::vector<std::vector<unsigned int>>& NumaNodeCpus() {
+  static const std::vector<std::vector<unsigned int>> nodes = ReadNumaNodeCpus();
+  return nodes;
+}
+
 thread_local int max_concurrency = 0;
 class ThreadGroup::Impl {
  public:
@@ -171,6 +226,9 @@ class ThreadGroup::Impl {
       case kBig:
         num_workers_used = big_count_;
         break;
+      case kHybrid:
+        num_workers_used = static_cast<int>(sorted_order_.size());
+        break;
       case kSpecifyOneCorePerThread:
       case kSpecifyThreadShareAllCore:
         num_workers_used = cpus.size();
@@ -189,20 +247,27 @@ class ThreadGroup::Impl {
     // and N/2 physical cores this will set affinity to the first N/2 logical
     // ones.
     num_workers_used = std::min(num_workers_, num_workers_used);
-    SetAffinity(exclude_worker0, mode);
+    SetAffinity(exclude_worker0, mode, num_workers_used);
+    UpdateWorkerThroughputs(mode, num_workers_used);
     return num_workers_used;
   }
 
+  std::vector<double> WorkerThroughputs() const { return worker_throughputs_; }
+
  private:
   // bind worker threads to disjoint cores
   // if worker 0 is offloaded to main, i.e. exclude_worker0 is true,
   // the main thread is bound to core 0.
-  void SetAffinity(bool exclude_worker0, AffinityMode mode) {
+  void SetAffinity(bool exclude_worker0, AffinityMode mode, int num_workers_used) {
 #ifndef __hexagon__
     const char* val = getenv("TVM_BIND_THREADS");
     if (val != nullptr && atoi(val) != 1) {
       return;
     }
+    if (mode == kNuma) {
+      SetNumaAffinity(exclude_worker0, num_workers_used);
+      return;
+    }
     // Do not set affinity if there are more workers than found cores and mode is not kSpecify*.
     if (sorted_order_.size() < static_cast<unsigned int>(num_workers_)) {
       switch (mode) {
@@ -228,12 +293,14 @@ class ThreadGroup::Impl {
       ICHECK_GE(sorted_order_.size(), num_workers_);
       switch (mode) {
         case kSpecifyThreadShareAllCore:
+        case kNuma:
           for (unsigned i = 0; i < threads_.size(); ++i) {
             SetThreadFullCpuAffinity(threads_[i].native_handle(), mode);
           }
           break;
         case kLittle:
         case kBig:
+        case kHybrid:
         case kSpecifyOneCorePerThread:
           for (unsigned i = 0; i < threads_.size(); ++i) {
             bool reverse = mode == kLittle;
@@ -258,6 +325,29 @@ class ThreadGroup::Impl {
 #endif  // __hexagon__
   }
 
+  // bind the workers to the cpus of a NUMA node, in contiguous blocks of workers per node, so
+  // that the contiguous chunks of a parallel loop given to the workers of a node stay on the
+  // node. The main thread, which runs the task of worker 0, is bound to the first node.
+  void SetNumaAffinity(bool exclude_worker0, int num_workers_used) {
+#ifndef __hexagon__
+    std::vector<std::vector<unsigned int>> nodes;
+    for (const std::vector<unsigned int>& cpus : NumaNodeCpus()) {
+      if (!cpus.empty()) nodes.push_back(cpus);
+    }
+    int num_nodes = static_cast<int>(nodes.size());
+    int num_used = std::max(num_workers_used, 1);
+    auto node_of = [&](int worker_id) {
+      return std::min(worker_id, num_used - 1) * num_nodes / num_used;
+    };
+    for (unsigned i = 0; i < threads_.size(); ++i) {
+      SetThreadAffinity(threads_[i].native_handle(), nodes[node_of(i + exclude_worker0)]);
+    }
+    if (exclude_worker0) {
+      SetThreadAffinity(CURRENT_THREAD_HANDLE, nodes[0]);
+    }
+#endif  // __hexagon__
+  }
+
   void SetThreadFullCpuAffinity(std::thread::native_handle_type thread, AffinityMode mode) {
     // For example, we have 2xA72 + 4xA53 (id is 0 - 5, 4, 5 is A72 big core)
     // And we use config_threadpool API to set we will only use 4xA53.
@@ -283,17 +373,43 @@ class ThreadGroup::Impl {
           ids.push_back(sorted_order_[sorted_order_.size() - i - 1]);
         }
         break;
-      case kBig:
+      case kBig: {
         int num_cpu_workers = std::min(MaxConcurrency(), big_count_);
         for (int i = 0; i < num_cpu_workers; ++i) {
           ids.push_back(sorted_order_[i]);
         }
         break;
+      }
+      case kNuma:
+        for (const std::vector<unsigned int>& cpus : NumaNodeCpus()) {
+          ids.insert(ids.end(), cpus.begin(), cpus.end());
+        }
+        break;
+      case kHybrid: {
+        int num_cpu_workers = std::min(MaxConcurrency(), static_cast<int>(sorted_order_.size()));
+        ids.insert(ids.end(), sorted_order_.begin(), sorted_order_.begin() + num_cpu_workers);
+        break;
+      }
     }
     SetThreadAffinity(thread, ids);
 #endif  // __hexagon__
   }
 
+  // The workers of kBig, kLittle and kHybrid are bound to the cores of sorted_order_ in order,
+  // so their throughput follows the maximum frequency of these cores.
+  void UpdateWorkerThroughputs(AffinityMode mode, int num_workers_used) {
+    worker_throughputs_.assign(num_workers_used, 1.0);
+    if (mode != kBig && mode != kLittle && mode != kHybrid) return;
+    if (sorted_freqs_.empty() || sorted_freqs_.front() <= 0) return;
+    int num_cores = static_cast<int>(sorted_freqs_.size());
+    for (int i = 0; i < num_workers_used && i < num_cores; ++i) {
+      int64_t freq = mode == kLittle ? sorted_freqs_[num_cores - i - 1] : sorted_freqs_[i];
+      if (freq > 0) {
+        worker_throughputs_[i] = static_cast<double>(freq) / sorted_freqs_.front();
+      }
+    }
+  }
+
   void SetMainThreadFullCpuAffinity(AffinityMode mode) {
     SetThreadFullCpuAffinity(CURRENT_THREAD_HANDLE, mode);
   }
@@ -336,6 +452,7 @@ class ThreadGroup::Impl {
     int64_t little_freq = max_freqs.rbegin()->second;
     for (auto it = max_freqs.begin(); it != max_freqs.end(); it++) {
       sorted_order_.push_back(it->first);
+      sorted_freqs_.push_back(it->second);
       if (big_freq == it->second) {
         big_count_++;
       }
@@ -356,6 +473,10 @@ class ThreadGroup::Impl {
   std::vector<std::thread> threads_;
 #endif
   std::vector<unsigned int> sorted_order_;
+  // the maximum frequency of the cores of sorted_order_, 0 or -1 if unknown
+  std::vector<int64_t> sorted_freqs_;
+  // the relative throughput of the workers used by the last Configure
+  std::vector<double> worker_throughputs_;
   int big_count_ = 0;
   int little_count_ = 0;
 };
@@ -371,6 +492,8 @@ int ThreadGroup::Configure(AffinityMode mode, int nthreads, bool exclude_worker0
   return impl_->Configure(mode, nthreads, exclude_worker0, cpus);
 }
 
+std::vector<double> ThreadGroup::WorkerThroughputs() const { return impl_->WorkerThroughputs(); }
+
 void YieldThread() {
 #ifdef __hexagon__
   // QuRT doesn't have a yield API, so instead we sleep for the minimum amount
@@ -0,0 +1,304 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/tracing.cc
+ * \brief Timeline tracing of the runtime, exported as Chrome trace events.
+ */
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/tracing.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+namespace {
+
+/*! \brief An event recorded by a thread. */
+struct TraceEvent {
+  const char* category{nullptr};
+  std::string name;
+  int64_t begin_ns{0};
+  int64_t end_ns{0};
+  bool has_device{false};
+  Device device{kDLCPU, 0};
+  /*! \brief The timer of the event on its device, if timed there. */
+  Timer timer;
+  /*! \brief Whether the event has ended, published to the exporter. */
+  std::atomic<bool> done{false};
+};
+
+/*!
+ * \brief The events of a thread. Only the owner thread writes to it, so recording takes no lock,
+ * and the exporter reads the events published through `size` and `done`.
+ */
+struct ThreadBuffer {
+  std::vector<TraceEvent> events;
+  /*! \brief The number of slots taken, which may exceed the capacity by the dropped events. */
+  std::atomic<int64_t> size{0};
+  /*! \brief The trace the buffer is sized for. */
+  int64_t generation{-1};
+  int pid{0};
+  int tid{0};
+};
+
+struct TraceState {
+  std::atomic<bool> enabled{false};
+  bool device_timers{false};
+  int64_t buffer_size{0};
+  /*! \brief The number of traces started, which invalidates the events of the earlier ones. */
+  std::atomic<int64_t> generation{0};
+  std::mutex mutex;
+  /*! \brief The buffers of all threads that recorded, kept alive after their threads exit. */
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+  static TraceState* Global() {
+    static TraceState* inst = new TraceState();
+    return inst;
+  }
+};
+
+int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*! \brief The pid set on the current thread, which applies to the buffers it creates later. */
+thread_local int thread_pid = 0;
+
+ThreadBuffer* GetThreadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    TraceState* state = TraceState::Global();
+    auto buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    buffer->tid = static_cast<int>(state->buffers.size()) + 1;
+    state->buffers.push_back(buffer);
+    return buffer;
+  }();
+  return buffer.get();
+}
+
+std::string EscapeJSON(const std::string& str) {
+  std::string result;
+  result.reserve(str.size());
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+      result.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+      result += buf;
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+/*! \brief The lane of a device on the timeline, kept clear of the thread ids. */
+int DeviceLane(Device dev) { return 1000000 + dev.device_type * 1000 + dev.device_id; }
+
+}  // namespace
+
+void StartTracing(bool device_timers, int64_t buffer_size) {
+  CHECK_GT(buffer_size, 0) << "ValueError: The trace buffer size must be positive, but got "
+                           << buffer_size;
+  TraceState* state = TraceState::Global();
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->enabled.store(false, std::memory_order_relaxed);
+  state->device_timers = device_timers;
+  state->buffer_size = buffer_size;
+  state->generation.fetch_add(1, std::memory_order_release);
+  state->enabled.store(true, std::memory_order_release);
+}
+
+void StopTracing() { TraceState::Global()->enabled.store(false, std::memory_order_release); }
+
+bool IsTracing() { return TraceState::Global()->enabled.load(std::memory_order_relaxed); }
+
+void SetTraceProcessId(int pid) {
+  thread_pid = pid;
+  GetThreadBuffer()->pid = pid;
+}
+
+TraceScope::TraceScope(const char* category, const ffi::String& name,
+                       std::optional<Device> device) {
+  TraceState* state = TraceState::Global();
+  if (!state->enabled.load(std::memory_order_acquire)) {
+    return;
+  }
+  ThreadBuffer* buffer = GetThreadBuffer();
+  int64_t generation = state->generation.load(std::memory_order_acquire);
+  if (buffer->generation != generation) {
+    // The first event of this thread in a new trace, resize the buffer before publishing it.
+    buffer->size.store(0, std::memory_order_release);
+    buffer->events = std::vector<TraceEvent>(state->buffer_size);
+    buffer->generation = generation;
+    buffer->pid = thread_pid;
+  }
+  int64_t index = buffer->size.load(std::memory_order_relaxed);
+  if (index >= static_cast<int64_t>(buffer->events.size())) {
+    buffer->size.store(index + 1, std::memory_order_release);
+    return;
+  }
+  TraceEvent& event = buffer->events[index];
+  event.category = category;
+  event.name = name;
+  event.has_device = device.has_value();
+  if (device.has_value()) {
+    event.device = device.value();
+    if (state->device_timers && device->device_type != kDLCPU) {
+      event.timer = Timer::Start(device.value());
+    }
+  }
+  event.begin_ns = NowNanos();
+  buffer->size.store(index + 1, std::memory_order_release);
+  index_ = index;
+}
+
+TraceScope::~TraceScope() {
+  if (index_ < 0) {
+    return;
+  }
+  TraceEvent& event = GetThreadBuffer()->events[index_];
+  event.end_ns = NowNanos();
+  if (event.timer.defined()) {
+    event.timer->Stop();
+  }
+  event.done.store(true, std::memory_order_release);
+}
+
+ffi::String ExportChromeTrace() {
+  TraceState* state = TraceState::Global();
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  int64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    buffers = state->buffers;
+    generation = state->generation.load(std::memory_order_acquire);
+  }
+  // The events timed on the devices, grouped by (pid, device lane).
+  std::map<std::pair<int, int>, std::vector<const TraceEvent*>> device_events;
+  std::set<int> pids;
+  int64_t dropped = 0;
+  std::ostringstream os;
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  auto begin_event = [&]() -> std::ostringstream& {
+    os << (first ? "\n" : ",\n");
+    first = false;
+    return os;
+  };
+  auto write_duration = [&](const std::string& name, const char* category, int64_t begin_ns,
+                            int64_t dur_ns, int pid, int tid) {
+    begin_event() << "{\"name\":\"" << EscapeJSON(name) << "\",\"cat\":\"" << category
+                  << "\",\"ph\":\"X\",\"ts\":" << begin_ns / 1e3 << ",\"dur\":" << dur_ns / 1e3
+                  << ",\"pid\":" << pid << ",\"tid\":" << tid;
+  };
+  os.precision(15);
+  for (const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+    if (buffer->generation != generation) {
+      continue;
+    }
+    int64_t size = buffer->size.load(std::memory_order_acquire);
+    int64_t capacity = static_cast<int64_t>(buffer->events.size());
+    dropped += std::max<int64_t>(size - capacity, 0);
+    size = std::min(size, capacity);
+    if (size == 0) {
+      continue;
+    }
+    pids.insert(buffer->pid);
+    begin_event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << buffer->pid
+                  << ",\"tid\":" << buffer->tid << ",\"args\":{\"name\":\"thread " << buffer->tid
+                  << "\"}}";
+    for (int64_t i = 0; i < size; ++i) {
+      const TraceEvent& event = buffer->events[i];
+      if (!event.done.load(std::memory_order_acquire)) {
+        continue;
+      }
+      write_duration(event.name, event.category, event.begin_ns, event.end_ns - event.begin_ns,
+                     buffer->pid, buffer->tid);
+      if (event.has_device) {
+        os << ",\"args\":{\"device\":\"" << DLDeviceType2Str(event.device.device_type) << ':'
+           << event.device.device_id << "\"}";
+      }
+      os << '}';
+      if (event.timer.defined()) {
+        device_events[{buffer->pid, DeviceLane(event.device)}].push_back(&event);
+      }
+    }
+  }
+  // A device runs its events in the order they are launched, each no earlier than its launch and
+  // no earlier than the end of the previous one.
+  for (auto& kv : device_events) {
+    auto [pid, lane] = kv.first;
+    std::vector<const TraceEvent*>& events = kv.second;
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent* a, const TraceEvent* b) {
+      return a->begin_ns < b->begin_ns;
+    });
+    const Device& dev = events[0]->device;
+    begin_event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                  << ",\"tid\":" << lane << ",\"args\":{\"name\":\""
+                  << DLDeviceType2Str(dev.device_type) << ':' << dev.device_id << "\"}}";
+    int64_t last_end_ns = 0;
+    for (const TraceEvent* event : events) {
+      int64_t begin_ns = std::max(event->begin_ns, last_end_ns);
+      int64_t dur_ns = event->timer->SyncAndGetElapsedNanos();
+      write_duration(event->name, event->category, begin_ns, dur_ns, pid, lane);
+      os << '}';
+      last_end_ns = begin_ns + dur_ns;
+    }
+  }
+  for (int pid : pids) {
+    begin_event() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+                  << ",\"args\":{\"name\":\"worker " << pid << "\"}}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << dropped << "}}";
+  return os.str();
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("runtime.profiling.StartTracing", StartTracing)
+      .def("runtime.profiling.StopTracing", StopTracing)
+      .def("runtime.profiling.IsTracing", IsTracing)
+      .def("runtime.profiling.ExportChromeTrace", ExportChromeTrace);
+}
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -28,6 +28,8 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #if defined(OPENCL_ENABLE_HOST_PTR)
@@ -51,6 +53,13 @@ constexpr const int kIntAttnWorkspaceByte = 8 * 1024 * 1024;
 constexpr const int kFloatAttnWorkspaceByte = 768 * 1024 * 1024;
 /*! \brief The id of the temporary logical page, which is useful for sliding window. */
 constexpr const int kPagedKVCacheTempPageId = -1;
+/*!
+ * \brief The first internal sequence id used by prefix cache entries.
+ * Prefix cache entries live in the sequence map as hidden sequences,
+ * and their ids count up from the lowest int64 value so that they never
+ * collide with user sequence ids.
+ */
+constexpr const int64_t kPrefixCacheSeqIdBegin = std::numeric_limits<int64_t>::min();
 
 /*!
  * \brief The supported attention kinds in PagedKVCache.
@@ -326,6 +335,175 @@ inline std::pair<std::vector<std::pair<int32_t, int32_t>>, bool> GetChunkedBlock
           use_decode_kernel};
 }
 
+/*!
+ * \brief The radix tree indexing the token sequences committed to the
+ * prefix cache of paged KV cache.
+ * Each node holds the run of tokens on its incoming edge, so the path
+ * from the root to a node spells out a token prefix. A node whose path
+ * is exactly a committed token sequence records the id of the prefix
+ * cache entry that holds the KV data of the sequence. Since every entry
+ * below a node starts with the tokens on the path to that node, a match
+ * can attach to any entry in the subtree of the deepest matched node.
+ */
+class PrefixRadixTree {
+ public:
+  /*!
+   * \brief Look up the entry stored under exactly the given tokens.
+   * \return The entry id, or -1 if no entry is stored under the tokens.
+   */
+  int64_t Lookup(const std::vector<int64_t>& tokens) const {
+    const Node* node = FindNode(tokens);
+    return node != nullptr ? node->entry_id : -1;
+  }
+
+  /*!
+   * \brief Insert the given tokens with the entry id.
+   * \return The id of the entry previously stored under the same tokens, or -1.
+   */
+  int64_t Insert(const std::vector<int64_t>& tokens, int64_t entry_id) {
+    ICHECK(!tokens.empty()) << "Cannot insert an empty token sequence into the prefix tree.";
+    Node* node = &root_;
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+      auto it = node->children.find(tokens[pos]);
+      if (it == node->children.end()) {
+        std::unique_ptr<Node> leaf = std::make_unique<Node>();
+        leaf->tokens.assign(tokens.begin() + pos, tokens.end());
+        leaf->parent = node;
+        node = node->children.emplace(tokens[pos], std::move(leaf)).first->second.get();
+        pos = tokens.size();
+        break;
+      }
+      Node* child = it->second.get();
+      size_t common = CommonPrefixLength(child->tokens, tokens, pos);
+      if (common < child->tokens.size()) {
+        // Split the edge at the first mismatching token.
+        std::unique_ptr<Node> mid = std::make_unique<Node>();
+        mid->tokens.assign(child->tokens.begin(), child->tokens.begin() + common);
+        mid->parent = node;
+        child->tokens.erase(child->tokens.begin(), child->tokens.begin() + common);
+        child->parent = mid.get();
+        mid->children.emplace(child->tokens[0], std::move(it->second));
+        it->second = std::move(mid);
+        child = it->second.get();
+      }
+      node = child;
+      pos += common;
+    }
+    int64_t prev_entry_id = node->entry_id;
+    node->entry_id = entry_id;
+    return prev_entry_id;
+  }
+
+  /*! \brief Remove the entry stored under exactly the given tokens. */
+  void Erase(const std::vector<int64_t>& tokens) {
+    Node* node = FindNode(tokens);
+    if (node == nullptr || node == &root_) {
+      return;
+    }
+    node->entry_id = -1;
+    // Prune the nodes which no longer lead to any entry.
+    while (node != &root_ && node->entry_id == -1 && node->children.empty()) {
+      Node* parent = node->parent;
+      parent->children.erase(node->tokens[0]);
+      node = parent;
+    }
+    // Merge the remaining node with its only child to keep the tree compressed.
+    if (node != &root_ && node->entry_id == -1 && node->children.size() == 1) {
+      std::unique_ptr<Node> child = std::move(node->children.begin()->second);
+      node->tokens.insert(node->tokens.end(), child->tokens.begin(), child->tokens.end());
+      node->entry_id = child->entry_id;
+      node->children = std::move(child->children);
+      for (auto& kv : node->children) {
+        kv.second->parent = node;
+      }
+    }
+  }
+
+  /*!
+   * \brief Find the longest prefix of the given tokens that the tree covers.
+   * \return The matched length, together with the id of an entry whose tokens
+   * start with the matched prefix (or -1 when nothing matches).
+   */
+  std::pair<int64_t, int64_t> MatchPrefix(const std::vector<int64_t>& tokens) const {
+    const Node* node = &root_;
+    const Node* deepest = nullptr;
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+      auto it = node->children.find(tokens[pos]);
+      if (it == node->children.end()) {
+        break;
+      }
+      const Node* child = it->second.get();
+      size_t common = CommonPrefixLength(child->tokens, tokens, pos);
+      pos += common;
+      deepest = child;
+      if (common < child->tokens.size()) {
+        break;
+      }
+      node = child;
+    }
+    if (deepest == nullptr) {
+      return {0, -1};
+    }
+    // Every leaf holds an entry, so descending along any branch ends at an entry.
+    while (deepest->entry_id == -1) {
+      ICHECK(!deepest->children.empty());
+      deepest = deepest->children.begin()->second.get();
+    }
+    return {static_cast<int64_t>(pos), deepest->entry_id};
+  }
+
+  /*! \brief Remove all entries from the tree. */
+  void Clear() { root_.children.clear(); }
+
+ private:
+  /*! \brief The radix tree node. */
+  struct Node {
+    /*! \brief The tokens on the edge from the parent to this node. */
+    std::vector<int64_t> tokens;
+    /*! \brief The children nodes, keyed by the first token on their edges. */
+    std::unordered_map<int64_t, std::unique_ptr<Node>> children;
+    /*! \brief The parent node, or nullptr for the root. */
+    Node* parent = nullptr;
+    /*! \brief The id of the entry stored at this node, or -1. */
+    int64_t entry_id = -1;
+  };
+
+  /*! \brief The length of common prefix between the edge tokens and `tokens[pos:]`. */
+  static size_t CommonPrefixLength(const std::vector<int64_t>& edge,
+                                   const std::vector<int64_t>& tokens, size_t pos) {
+    size_t common = 0;
+    while (common < edge.size() && pos + common < tokens.size() &&
+           edge[common] == tokens[pos + common]) {
+      ++common;
+    }
+    return common;
+  }
+
+  /*! \brief Find the node whose path is exactly the given tokens. */
+  Node* FindNode(const std::vector<int64_t>& tokens) const {
+    Node* node = const_cast<Node*>(&root_);
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+      auto it = node->children.find(tokens[pos]);
+      if (it == node->children.end()) {
+        return nullptr;
+      }
+      Node* child = it->second.get();
+      if (CommonPrefixLength(child->tokens, tokens, pos) != child->tokens.size()) {
+        return nullptr;
+      }
+      node = child;
+      pos += child->tokens.size();
+    }
+    return node;
+  }
+
+  /*! \brief The root node, whose edge is empty. */
+  Node root_;
+};
+
 /*!
  * \brief The rotary embedding mode adopted by the paged KV cache
  * when computing attention.
@@ -771,6 +949,13 @@ class PlainPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
  * For each `CopyXXXAsync`, it copies the input data to a local cache on host.
  * In `CommitAttnAuxDataCopy`, it copies all the data in the local cache to the device
  * array for a single time, and thus reduce the number of host-to-device copies needed.
+ *
+ * The local cache of the attention auxiliary data is double-buffered: each commit compares
+ * the cache against the one of the previous commit, whose contents the device array holds,
+ * and only copies the chunks that changed. In decode steps of a large batch, most
+ * page-table entries are unchanged from the previous step, so that the copy is a small
+ * fraction of the cache. Alternating the buffers also keeps the host from overwriting
+ * the cache of the previous commit while its copy may still be in flight.
  */
 class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
  public:
@@ -785,9 +970,10 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
     // local cache and the large on-device array.
     int64_t attn_aux_data_cache_size =
         CalculateAttnAuxDataCacheSize(reserved_num_seqs, num_total_pages, prefill_chunk_size);
-    // - Initialize the host auxiliary data buffer.
-    merged_attn_aux_data_host_ =
-        HostMemoryVector(attn_aux_data_cache_size, dtype_aux, preferred_host_device);
+    // - Initialize the two host auxiliary data buffers.
+    for (HostMemoryVector& host : merged_attn_aux_data_host_) {
+      host = HostMemoryVector(attn_aux_data_cache_size, dtype_aux, preferred_host_device);
+    }
     // - Initialize the device auxiliary data buffer.
     merged_attn_aux_data_device_ = Tensor::Empty({attn_aux_data_cache_size}, dtype_aux, device);
 
@@ -854,12 +1040,13 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
                                     HostMemoryVector* sliding_window_offset,
                                     HostMemoryVector* sink_size, int depth) final {
     int64_t n_elem = last_page_len->size();
-    std::memcpy(merged_attn_aux_data_host_.data() + attn_aux_data_copy_offset_,
-                last_page_len->data(), n_elem * elem_byte_size_);
-    std::memcpy(merged_attn_aux_data_host_.data() + attn_aux_data_copy_offset_ + n_elem,
-                sliding_window_offset->data(), n_elem * elem_byte_size_);
-    std::memcpy(merged_attn_aux_data_host_.data() + attn_aux_data_copy_offset_ + 2 * n_elem,
-                sink_size->data(), n_elem * elem_byte_size_);
+    int32_t* host_data = merged_attn_aux_data_host_[host_buffer_index_].data();
+    std::memcpy(host_data + attn_aux_data_copy_offset_, last_page_len->data(),
+                n_elem * elem_byte_size_);
+    std::memcpy(host_data + attn_aux_data_copy_offset_ + n_elem, sliding_window_offset->data(),
+                n_elem * elem_byte_size_);
+    std::memcpy(host_data + attn_aux_data_copy_offset_ + 2 * n_elem, sink_size->data(),
+                n_elem * elem_byte_size_);
     Tensor view =
         Tensor::FromNDAlloc(ViewHelper(merged_attn_aux_data_device_), ffi::Shape({3, n_elem}),
                             dtype_aux_, device_, attn_aux_data_copy_offset_ * elem_byte_size_);
@@ -868,20 +1055,39 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   }
 
   void CommitAttnAuxDataCopy() final {
-    std::vector<int64_t> copy_shape{attn_aux_data_copy_offset_};
-    DLTensor copy_dst;
-    copy_dst.data = merged_attn_aux_data_device_->data;
-    copy_dst.device = device_;
-    copy_dst.ndim = 1;
-    copy_dst.dtype = dtype_aux_;
-    copy_dst.shape = copy_shape.data();
-    copy_dst.strides = nullptr;
-    copy_dst.byte_offset = 0;
-
-    DLTensor copy_src = copy_dst;
-    copy_src.data = merged_attn_aux_data_host_.data();
-    copy_src.device = Device{kDLCPU, 0};
-    Tensor::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
+    const int32_t* host_data = merged_attn_aux_data_host_[host_buffer_index_].data();
+    const int32_t* prev_host_data = merged_attn_aux_data_host_[1 - host_buffer_index_].data();
+    int64_t length = attn_aux_data_copy_offset_;
+    // - The device array holds the previous cache in [0, attn_aux_data_committed_length_),
+    // so only the chunks differing from it there, and the elements past it, are copied.
+    int64_t common_length = std::min(length, attn_aux_data_committed_length_);
+    std::vector<std::pair<int64_t, int64_t>> patches;
+    auto f_add_patch = [&patches](int64_t begin, int64_t end) {
+      if (!patches.empty() && patches.back().second == begin) {
+        patches.back().second = end;
+      } else {
+        patches.emplace_back(begin, end);
+      }
+    };
+    for (int64_t begin = 0; begin < common_length; begin += kAuxDataPatchChunkSize) {
+      int64_t end = std::min(begin + kAuxDataPatchChunkSize, common_length);
+      if (std::memcmp(host_data + begin, prev_host_data + begin, (end - begin) * elem_byte_size_)) {
+        f_add_patch(begin, end);
+      }
+    }
+    if (common_length < length) {
+      f_add_patch(common_length, length);
+    }
+    // - Too many patches cost more in copy launches than they save, so one copy spans them.
+    if (static_cast<int>(patches.size()) > kAuxDataMaxNumPatches) {
+      patches = {{patches.front().first, patches.back().second}};
+    }
+    for (const auto& [begin, end] : patches) {
+      CopyAttnAuxDataRange(host_data, begin, end);
+    }
+    attn_aux_data_committed_length_ = length;
+    // - The next copy writes into the other buffer.
+    host_buffer_index_ = 1 - host_buffer_index_;
   }
 
   void ResetCompactKVAuxDataCopy() final { compact_kv_aux_data_copy_offset_ = 0; }
@@ -935,6 +1141,24 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
     Tensor source_;
   };
 
+  /*! \brief Copy the elements in [begin, end) of a local attention cache to the device array. */
+  void CopyAttnAuxDataRange(const int32_t* host_data, int64_t begin, int64_t end) {
+    std::vector<int64_t> copy_shape{end - begin};
+    DLTensor copy_dst;
+    copy_dst.data = merged_attn_aux_data_device_->data;
+    copy_dst.device = device_;
+    copy_dst.ndim = 1;
+    copy_dst.dtype = dtype_aux_;
+    copy_dst.shape = copy_shape.data();
+    copy_dst.strides = nullptr;
+    copy_dst.byte_offset = begin * elem_byte_size_;
+
+    DLTensor copy_src = copy_dst;
+    copy_src.data = const_cast<int32_t*>(host_data);
+    copy_src.device = Device{kDLCPU, 0};
+    Tensor::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
+  }
+
   /*!
    * \brief Calculate the start element offsets of the auxiliary arrays in the local cache.
    * \return Return the local cache size (total number of elements in the local cache).
@@ -1004,8 +1228,8 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
    */
   Tensor CopyAttnAuxVecToCache(HostMemoryVector* data) {
     int64_t n_elem = data->size();
-    std::memcpy(merged_attn_aux_data_host_.data() + attn_aux_data_copy_offset_, data->data(),
-                n_elem * elem_byte_size_);
+    std::memcpy(merged_attn_aux_data_host_[host_buffer_index_].data() + attn_aux_data_copy_offset_,
+                data->data(), n_elem * elem_byte_size_);
     Tensor view =
         Tensor::FromNDAlloc(ViewHelper(merged_attn_aux_data_device_), ffi::Shape({n_elem}),
                             dtype_aux_, device_, attn_aux_data_copy_offset_ * elem_byte_size_);
@@ -1029,13 +1253,22 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
     return (n + offset_alignment_ - 1) / offset_alignment_ * offset_alignment_;
   }
 
+  /*! \brief The number of elements compared at a time to find the changed aux data. */
+  static constexpr int64_t kAuxDataPatchChunkSize = 256;
+  /*! \brief The maximum number of host-to-device copies of a commit. */
+  static constexpr int kAuxDataMaxNumPatches = 8;
+
   const int64_t cuda_byte_alignment_ = 16;
   const int64_t elem_byte_size_;
   const int64_t offset_alignment_;
 
   int64_t attn_aux_data_copy_offset_ = 0;
   int64_t compact_kv_aux_data_copy_offset_ = 0;
-  HostMemoryVector merged_attn_aux_data_host_;
+  /*! \brief The length of the previous commit, which the device array holds. */
+  int64_t attn_aux_data_committed_length_ = 0;
+  /*! \brief The index of the host buffer the current copy writes into. */
+  int host_buffer_index_ = 0;
+  HostMemoryVector merged_attn_aux_data_host_[2];
   HostMemoryVector merged_compact_kv_aux_data_host_;
   Tensor merged_attn_aux_data_device_;
   Tensor merged_compact_kv_aux_data_device_;
@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/call_sampler.cc
+ * \brief Sample the latency of the calls of the VM into per-function histograms.
+ */
+#include "call_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+int LatencyHistogram::BucketIndex(int64_t nanos) {
+  uint64_t value = std::min<uint64_t>(std::max<int64_t>(nanos, 0), (uint64_t(1) << kMaxBits) - 1);
+  if (value < static_cast<uint64_t>(kSubBuckets)) {
+    return static_cast<int>(value);
+  }
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - kSubBucketBits;
+  // The bucket keeps the kSubBucketBits bits of the value below its leading one.
+  return (shift + 1) * kSubBuckets + static_cast<int>((value >> shift) - kSubBuckets);
+}
+
+int64_t LatencyHistogram::BucketValue(int index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  int shift = index / kSubBuckets - 1;
+  int64_t lower = static_cast<int64_t>(kSubBuckets + index % kSubBuckets) << shift;
+  return lower + ((int64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::Record(int64_t nanos) {
+  ++buckets_[BucketIndex(nanos)];
+  ++count_;
+  sum_ += nanos;
+  max_ = std::max(max_, nanos);
+}
+
+int64_t LatencyHistogram::Quantile(double q) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  int64_t rank = std::max<int64_t>(static_cast<int64_t>(std::ceil(q * count_)), 1);
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return std::min(BucketValue(i), max_);
+    }
+  }
+  return max_;
+}
+
+CallSampler::CallSampler(size_t num_funcs, int64_t sample_every)
+    : sample_every_(sample_every), entries_(num_funcs) {
+  // Sample the first call of each function, so that rare functions show up too.
+  for (Entry& entry : entries_) {
+    entry.countdown = 1;
+  }
+}
+
+void CallSampler::RecordDevice(int64_t func_idx, Timer timer) {
+  Entry& entry = entries_[func_idx];
+  if (entry.pending.defined()) {
+    entry.histogram.Record(entry.pending->SyncAndGetElapsedNanos());
+  }
+  entry.pending = std::move(timer);
+}
+
+ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> CallSampler::Report(
+    const std::vector<std::string>& names) {
+  ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> result;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    Entry& entry = entries_[i];
+    if (entry.pending.defined()) {
+      entry.histogram.Record(entry.pending->SyncAndGetElapsedNanos());
+      entry.pending = Timer();
+    }
+    const LatencyHistogram& hist = entry.histogram;
+    if (hist.count() == 0) {
+      continue;
+    }
+    ffi::Map<ffi::String, ffi::Any> stats;
+    stats.Set("calls", entry.calls);
+    stats.Set("samples", hist.count());
+    stats.Set("mean_us", hist.mean() / 1e3);
+    stats.Set("p50_us", hist.Quantile(0.5) / 1e3);
+    stats.Set("p90_us", hist.Quantile(0.9) / 1e3);
+    stats.Set("p99_us", hist.Quantile(0.99) / 1e3);
+    stats.Set("max_us", hist.max() / 1e3);
+    result.Set(names[i], stats);
+  }
+  return result;
+}
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/call_sampler.h
+ * \brief Sample the latency of the calls of the VM into per-function histograms.
+ */
+#ifndef TVM_RUNTIME_VM_CALL_SAMPLER_H_
+#define TVM_RUNTIME_VM_CALL_SAMPLER_H_
+
+#include <tvm/ffi/container/map.h>
+#include <tvm/ffi/string.h>
+#include <tvm/runtime/profiling.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief A histogram of latencies in nanoseconds with buckets of a fixed relative width.
+ *
+ * Each power of two is split into 2^kSubBucketBits linear buckets, as in HdrHistogram, so that
+ * the quantiles it reports are within 1/2^kSubBucketBits of the recorded values at any scale.
+ */
+class LatencyHistogram {
+ public:
+  /*! \brief The number of bits of a value kept by its bucket. */
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  /*! \brief The latencies are clamped below 2^kMaxBits nanoseconds, about 18 minutes. */
+  static constexpr int kMaxBits = 40;
+  static constexpr int kNumBuckets = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  /*! \brief Record a latency. */
+  void Record(int64_t nanos);
+  /*! \brief The latency at a quantile in [0, 1], or 0 if empty. */
+  int64_t Quantile(double q) const;
+
+  int64_t count() const { return count_; }
+  int64_t max() const { return max_; }
+  double mean() const { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_; }
+
+ private:
+  static int BucketIndex(int64_t nanos);
+  /*! \brief The midpoint of the values of a bucket. */
+  static int64_t BucketValue(int index);
+
+  std::array<uint32_t, kNumBuckets> buckets_{};
+  int64_t count_{0};
+  int64_t sum_{0};
+  int64_t max_{0};
+};
+
+/*!
+ * \brief Sample the latency of one in every N calls of each function in the function table of
+ * an executable, into a table of histograms allocated once.
+ *
+ * The calls on a device other than the CPU are timed on the device. Their timer is left pending
+ * until the next sample of the same function, which by then has usually finished, so sampling
+ * does not synchronize the device.
+ */
+class CallSampler {
+ public:
+  /*!
+   * \param num_funcs The size of the function table.
+   * \param sample_every The sampling period.
+   */
+  CallSampler(size_t num_funcs, int64_t sample_every);
+
+  /*! \brief Count a call of a function, and return whether to time it. */
+  bool ShouldSample(int64_t func_idx) {
+    Entry& entry = entries_[func_idx];
+    ++entry.calls;
+    if (--entry.countdown > 0) {
+      return false;
+    }
+    entry.countdown = sample_every_;
+    return true;
+  }
+
+  /*!
+   * \brief Record a call timed on the host.
+   * \param func_idx The index of the function.
+   * \param nanos The latency of the call.
+   */
+  void RecordHost(int64_t func_idx, int64_t nanos) { entries_[func_idx].histogram.Record(nanos); }
+
+  /*!
+   * \brief Record a call timed on a device, whose timer has been stopped.
+   * \param func_idx The index of the function.
+   * \param timer The timer of the call.
+   */
+  void RecordDevice(int64_t func_idx, Timer timer);
+
+  /*!
+   * \brief The latency statistics of the functions sampled at least once.
+   * \param names The names of the functions in the function table.
+   */
+  ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> Report(
+      const std::vector<std::string>& names);
+
+ private:
+  struct Entry {
+    int64_t calls{0};
+    int64_t countdown{0};
+    /*! \brief The timer of the last sample timed on a device, not yet recorded. */
+    Timer pending;
+    LatencyHistogram histogram;
+  };
+
+  int64_t sample_every_;
+  std::vector<Entry> entries_;
+};
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_CALL_SAMPLER_H_
@@ -22,14 +22,26 @@
  * \brief The CUDA graph related builtin functions for Relax virtual machine.
  */
 
+#define PICOJSON_USE_INT64
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+#include <picojson.h>
 #include <tvm/ffi/container/array.h>
 #include <tvm/ffi/extra/c_env_api.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/vm/vm.h>
 
+#include <algorithm>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "../../../support/utils.h"
 #include "../../cuda/cuda_common.h"
+#include "../../file_utils.h"
 namespace tvm {
 namespace runtime {
 namespace vm {
@@ -80,6 +92,7 @@ struct CUDAGraphCapturedState {
   CUDAGraphCapturedState& operator=(CUDAGraphCapturedState&& other) {
     std::swap(states, other.states);
     std::swap(exec, other.exec);
+    std::swap(lru_it, other.lru_it);
     return *this;
   }
 
@@ -96,8 +109,36 @@ struct CUDAGraphCapturedState {
   ObjectRef states;
   /*! \brief The instantiated cuda graph */
   cudaGraphExec_t exec = nullptr;
+  /*! \brief The position of the entry in the LRU list of the capture cache. */
+  std::list<CUDAGraphCaptureKey>::iterator lru_it;
+};
+
+/*! \brief The capture function and its static arguments, recorded for pre-warming. */
+struct CUDAGraphCaptureFunc {
+  ObjectRef capture_func;
+  ffi::Array<Any> args;
 };
 
+/*!
+ * \brief Try to update an instantiated graph with a newly captured graph in place.
+ * \return Whether the update succeeded, which requires the two graphs to have the same topology.
+ */
+bool TryUpdateGraphExec(cudaGraphExec_t exec, cudaGraph_t graph) {
+#if CUDART_VERSION >= 12000
+  cudaGraphExecUpdateResultInfo result_info;
+  cudaError_t err = cudaGraphExecUpdate(exec, graph, &result_info);
+#else
+  cudaGraphNode_t error_node;
+  cudaGraphExecUpdateResult update_result;
+  cudaError_t err = cudaGraphExecUpdate(exec, graph, &error_node, &update_result);
+#endif
+  if (err == cudaSuccess) return true;
+  // Clear the error so that it does not leak to the following CUDA calls.
+  ICHECK_EQ(err, cudaErrorGraphExecUpdateFailure) << "CUDA: " << cudaGetErrorString(err);
+  cudaGetLastError();
+  return false;
+}
+
 class ScopedCUDAStream {
  public:
   ScopedCUDAStream() { CUDA_CALL(cudaStreamCreate(&stream_)); }
@@ -155,16 +196,122 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
     CUDAGraphCaptureKey entry_key{entry_index, shape_expr};
     if (auto it = capture_cache_.find(entry_key); it != capture_cache_.end()) {
       // Launch CUDA graph
-      const auto& [states, exec] = it->second;
+      CUDAGraphCapturedState& entry = it->second;
+      lru_.splice(lru_.begin(), lru_, entry.lru_it);
       int device_id;
       CUDA_CALL(cudaGetDevice(&device_id));
-      CUDA_CALL(
-          cudaGraphLaunch(exec, static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, device_id))));
-      return states;
+      CUDA_CALL(cudaGraphLaunch(
+          entry.exec, static_cast<cudaStream_t>(TVMFFIEnvGetStream(kDLCUDA, device_id))));
+      return entry.states;
     }
 
-    // Set up arguments for the graph execution
     ffi::Array<Any> tuple_args = args.cast<ffi::Array<Any>>();
+    // Capture the declared shape buckets once the capture function is known. The buckets run
+    // on the same static storages as this call, so they are captured first, and the states
+    // returned for this call are not overwritten before the caller reads them.
+    if (!capture_funcs_.count(entry_index)) {
+      capture_funcs_[entry_index] = CUDAGraphCaptureFunc{capture_func, tuple_args};
+      if (shape_expr.defined()) {
+        PrewarmEntry(vm, entry_index, shape_expr);
+      }
+    }
+    return Capture(vm, capture_func, tuple_args, entry_key);
+  }
+
+  /*!
+   * \brief Declare the shape buckets to be captured ahead of time.
+   *
+   * Each capture function with symbolic shapes receives the values of its symbolic
+   * variables as the last argument, which is also the cache key of the captured graphs.
+   * For every capture function that has been captured at least once, and for the ones
+   * captured later, graphs are captured for each declared shape tuple with the same
+   * number of symbolic variables by substituting that argument. This assumes the other
+   * arguments of the capture function are static, which is what RewriteCUDAGraph emits.
+   *
+   * The states of the capture functions are overwritten, as by a call of another shape, while
+   * the outputs the VM functions returned live out of the static storages of the graphs.
+   *
+   * \param vm The virtual machine.
+   * \param shape_buckets The values of the symbolic variables to capture.
+   */
+  void Prewarm(VirtualMachine* vm, ffi::Array<ffi::Shape> shape_buckets) {
+    for (const ffi::Shape& shape : shape_buckets) {
+      bool declared =
+          std::any_of(shape_buckets_.begin(), shape_buckets_.end(), [&](const ffi::Shape& bucket) {
+            return std::equal(bucket.begin(), bucket.end(), shape.begin(), shape.end());
+          });
+      if (!declared) shape_buckets_.push_back(shape);
+    }
+    for (const auto& [entry_index, _] : capture_funcs_) {
+      PrewarmEntry(vm, entry_index);
+    }
+  }
+
+  /*!
+   * \brief Set the maximum number of instantiated graphs alive at the same time.
+   * When the limit is reached, the least recently used graph is evicted and its instantiated
+   * graph is updated in place with the new capture if their topology is compatible.
+   * \param max_num_graphs The maximum number of graphs. Non-positive values mean no limit.
+   */
+  void SetMaxNumGraphs(int64_t max_num_graphs) {
+    max_num_graphs_ = max_num_graphs;
+    while (max_num_graphs_ > 0 && static_cast<int64_t>(capture_cache_.size()) > max_num_graphs_) {
+      capture_cache_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  /*!
+   * \brief Get the distinct shape tuples of the cached graphs, which can be saved as a
+   * warmup manifest for later deployments.
+   */
+  ffi::Array<ffi::Shape> GetCapturedShapes() const {
+    ffi::Array<ffi::Shape> shapes;
+    for (const CUDAGraphCaptureKey& key : lru_) {
+      if (key.shape_expr.empty()) continue;
+      bool seen = std::any_of(shapes.begin(), shapes.end(), [&](const ffi::Shape& shape) {
+        return std::equal(shape.begin(), shape.end(), key.shape_expr.begin(),
+                          key.shape_expr.end());
+      });
+      if (!seen) shapes.push_back(key.shape_expr);
+    }
+    return shapes;
+  }
+
+  /*! \brief Get the number of instantiated graphs. */
+  int64_t GetNumGraphs() const { return static_cast<int64_t>(capture_cache_.size()); }
+
+  /*!
+   * \brief Get the cached allocation from the cache or run the allocation function.
+   * \param vm The virtual machine.
+   * \param alloc_func The function of type () -> ObjectRef, where the returned object is the
+   * tuple of allocated storage objects.
+   * \param entry_index The unique index of the allocation function used for lookup.
+   */
+  ObjectRef GetCachedAllocation(VirtualMachine* vm, const ObjectRef& alloc_func,
+                                int64_t entry_index) {
+    if (auto it = alloc_cache_.find(entry_index); it != alloc_cache_.end()) {
+      return it->second;
+    }
+    ffi::Any alloc_func_rv;
+    vm->InvokeClosurePacked(alloc_func, ffi::PackedArgs(nullptr, 0), &alloc_func_rv);
+    ObjectRef alloc_result = alloc_func_rv.cast<ObjectRef>();
+    alloc_cache_[entry_index] = alloc_result;
+    return alloc_result;
+  }
+
+  static constexpr const bool _type_mutable = true;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("vm.CUDAGraphExtension", CUDAGraphExtensionNode,
+                                    VMExtensionNode);
+
+ private:
+  /*!
+   * \brief Run the capture function in capture mode and cache the instantiated graph.
+   * \return The return value of the capture function.
+   */
+  ObjectRef Capture(VirtualMachine* vm, const ObjectRef& capture_func,
+                    const ffi::Array<Any>& tuple_args, const CUDAGraphCaptureKey& entry_key) {
+    // Set up arguments for the graph execution
     int nargs = static_cast<int>(tuple_args.size());
 
     std::vector<AnyView> packed_args(nargs);
@@ -189,40 +336,52 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
 
     CUDAGraphCapturedState entry;
     entry.states = capture_func_rv.cast<ObjectRef>();
-    CUDA_CALL(cudaGraphInstantiate(&entry.exec, graph, NULL, NULL, 0));
+    if (max_num_graphs_ > 0 && static_cast<int64_t>(capture_cache_.size()) >= max_num_graphs_) {
+      // Evict the least recently used graph, and reuse its instantiated graph when possible,
+      // which saves both the instantiation latency and the device memory of a new graph.
+      auto victim_it = capture_cache_.find(lru_.back());
+      lru_.pop_back();
+      if (TryUpdateGraphExec(victim_it->second.exec, graph)) {
+        std::swap(entry.exec, victim_it->second.exec);
+      }
+      capture_cache_.erase(victim_it);
+    }
+    if (entry.exec == nullptr) {
+      CUDA_CALL(cudaGraphInstantiate(&entry.exec, graph, NULL, NULL, 0));
+    }
     CUDA_CALL(cudaGraphDestroy(graph));
 
     ObjectRef states = entry.states;
-
+    entry.lru_it = lru_.insert(lru_.begin(), entry_key);
     capture_cache_[entry_key] = std::move(entry);
 
     return states;
   }
 
   /*!
-   * \brief Get the cached allocation from the cache or run the allocation function.
+   * \brief Capture the declared shape buckets that are not captured yet for an entry.
    * \param vm The virtual machine.
-   * \param alloc_func The function of type () -> ObjectRef, where the returned object is the
-   * tuple of allocated storage objects.
-   * \param entry_index The unique index of the allocation function used for lookup.
+   * \param entry_index The index of the capture function.
+   * \param skip_shape The shape being captured by the caller, which is not prewarmed.
    */
-  ObjectRef GetCachedAllocation(VirtualMachine* vm, const ObjectRef& alloc_func,
-                                int64_t entry_index) {
-    if (auto it = alloc_cache_.find(entry_index); it != alloc_cache_.end()) {
-      return it->second;
+  void PrewarmEntry(VirtualMachine* vm, int64_t entry_index,
+                    ffi::Optional<ffi::Shape> skip_shape = std::nullopt) {
+    const CUDAGraphCaptureFunc& func = capture_funcs_.at(entry_index);
+    if (func.args.empty() || !func.args.back().as<ffi::Shape>()) return;
+    size_t num_symbolic_vars = func.args.back().cast<ffi::Shape>().size();
+    for (const ffi::Shape& shape : shape_buckets_) {
+      CUDAGraphCaptureKey entry_key{entry_index, shape};
+      if (shape.size() != num_symbolic_vars || capture_cache_.count(entry_key)) continue;
+      if (skip_shape.defined() &&
+          CUDAGraphCaptureKeyEqual()(entry_key, CUDAGraphCaptureKey{entry_index, skip_shape})) {
+        continue;
+      }
+      ffi::Array<Any> args = func.args;
+      args.Set(args.size() - 1, shape);
+      Capture(vm, func.capture_func, args, entry_key);
     }
-    ffi::Any alloc_func_rv;
-    vm->InvokeClosurePacked(alloc_func, ffi::PackedArgs(nullptr, 0), &alloc_func_rv);
-    ObjectRef alloc_result = alloc_func_rv.cast<ObjectRef>();
-    alloc_cache_[entry_index] = alloc_result;
-    return alloc_result;
   }
 
-  static constexpr const bool _type_mutable = true;
-  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("vm.CUDAGraphExtension", CUDAGraphExtensionNode,
-                                    VMExtensionNode);
-
- private:
   /*!
    * \brief The cache of captured cuda graphs. The key is a unique index for the capture function.
    * The value is the result of the capture.
@@ -235,6 +394,14 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
    * The value is the cached allocations, which is a tuple of storages.
    */
   std::unordered_map<int64_t, ObjectRef> alloc_cache_;
+  /*! \brief The keys of the captured graphs, from the most to the least recently used. */
+  std::list<CUDAGraphCaptureKey> lru_;
+  /*! \brief The maximum number of instantiated graphs. Non-positive values mean no limit. */
+  int64_t max_num_graphs_ = -1;
+  /*! \brief The capture functions and arguments of the first capture of each entry index. */
+  std::unordered_map<int64_t, CUDAGraphCaptureFunc> capture_funcs_;
+  /*! \brief The declared shape buckets to capture ahead of time. */
+  std::vector<ffi::Shape> shape_buckets_;
 };
 
 /*! Managed reference to CUDAGraphExtensionNode */
@@ -248,6 +415,46 @@ class CUDAGraphExtension : public VMExtension {
   }
 };
 
+/*!
+ * \brief Load the shape buckets from a CUDA graph warmup manifest.
+ *
+ * The manifest is a JSON file of the form `{"shape_buckets": [[1], [2], [4, 128]]}`, where
+ * each bucket lists the values of the symbolic variables that a capture function receives.
+ *
+ * \param path The path of the manifest file.
+ * \return The shape buckets.
+ */
+ffi::Array<ffi::Shape> LoadCUDAGraphWarmupManifest(const std::string& path) {
+  std::string json_str;
+  LoadBinaryFromFile(path, &json_str);
+  picojson::value json_info;
+  std::string err = picojson::parse(json_info, json_str);
+  CHECK(err.empty()) << "Failed to parse the CUDA graph warmup manifest " << path << ": " << err;
+  CHECK(json_info.is<picojson::object>() &&
+        json_info.get<picojson::object>().count("shape_buckets"))
+      << "The CUDA graph warmup manifest " << path << " must have the \"shape_buckets\" field";
+  const picojson::value& buckets_json = json_info.get<picojson::object>().at("shape_buckets");
+  CHECK(buckets_json.is<picojson::array>()) << "\"shape_buckets\" must be an array";
+  ffi::Array<ffi::Shape> shape_buckets;
+  for (const picojson::value& bucket_json : buckets_json.get<picojson::array>()) {
+    CHECK(bucket_json.is<picojson::array>()) << "Each shape bucket must be an array of integers";
+    std::vector<int64_t> bucket;
+    for (const picojson::value& value : bucket_json.get<picojson::array>()) {
+      CHECK(value.is<int64_t>()) << "Each shape bucket must be an array of integers";
+      bucket.push_back(value.get<int64_t>());
+    }
+    shape_buckets.push_back(ffi::Shape(bucket));
+  }
+  return shape_buckets;
+}
+
+/*! \brief Get the virtual machine from the module returned by the VM loader. */
+VirtualMachine* GetVirtualMachine(const ffi::Module& vm_mod) {
+  ICHECK_EQ(std::string(vm_mod->kind()), "relax.VirtualMachine")
+      << "Expect a relax VirtualMachine module, but got " << vm_mod->kind();
+  return static_cast<VirtualMachine*>(const_cast<ffi::ModuleObj*>(vm_mod.operator->()));
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
   refl::GlobalDef()
@@ -273,6 +480,34 @@ TVM_FFI_STATIC_INIT_BLOCK() {
         auto alloc_func = args[1].cast<ObjectRef>();
         int64_t entry_index = args[2].cast<int64_t>();
         *rv = extension->GetCachedAllocation(vm, alloc_func, entry_index);
+      })
+      .def("vm.builtin.cuda_graph.set_max_num_graphs",
+           [](ffi::Module vm_mod, int64_t max_num_graphs) {
+             VirtualMachine* vm = GetVirtualMachine(vm_mod);
+             vm->GetOrCreateExtension<CUDAGraphExtension>()->SetMaxNumGraphs(max_num_graphs);
+           })
+      .def("vm.builtin.cuda_graph.prewarm",
+           [](ffi::Module vm_mod, ffi::Array<ffi::Shape> shape_buckets) {
+             VirtualMachine* vm = GetVirtualMachine(vm_mod);
+             vm->GetOrCreateExtension<CUDAGraphExtension>()->Prewarm(vm, shape_buckets);
+           })
+      .def("vm.builtin.cuda_graph.load_warmup_manifest",
+           [](ffi::String path) { return LoadCUDAGraphWarmupManifest(path); })
+      .def("vm.builtin.cuda_graph.warmup",
+           [](ffi::Module vm_mod, ffi::String manifest_path) {
+             VirtualMachine* vm = GetVirtualMachine(vm_mod);
+             auto extension = vm->GetOrCreateExtension<CUDAGraphExtension>();
+             extension->Prewarm(vm, LoadCUDAGraphWarmupManifest(manifest_path));
+             return extension->GetNumGraphs();
+           })
+      .def("vm.builtin.cuda_graph.get_captured_shapes",
+           [](ffi::Module vm_mod) {
+             VirtualMachine* vm = GetVirtualMachine(vm_mod);
+             return vm->GetOrCreateExtension<CUDAGraphExtension>()->GetCapturedShapes();
+           })
+      .def("vm.builtin.cuda_graph.get_num_graphs", [](ffi::Module vm_mod) {
+        VirtualMachine* vm = GetVirtualMachine(vm_mod);
+        return vm->GetOrCreateExtension<CUDAGraphExtension>()->GetNumGraphs();
       });
 }
 
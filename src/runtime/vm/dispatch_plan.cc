@@ -0,0 +1,317 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/dispatch_plan.cc
+ * \brief Plan the concurrent execution of independent call instructions of the VM.
+ */
+#include "dispatch_plan.h"
+
+#include <tvm/ffi/reflection/registry.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+namespace {
+
+bool IsRegisterArg(const Instruction::Arg& arg) {
+  return arg.kind() == Instruction::ArgKind::kRegister &&
+         arg.value() < Instruction::kBeginSpecialReg;
+}
+
+/*!
+ * \brief Union-find over the registers of a function, where two registers are in the same set
+ *  when their values may share memory.
+ */
+class AliasSets {
+ public:
+  RegName Find(RegName reg) {
+    auto it = parent_.find(reg);
+    if (it == parent_.end() || it->second == reg) return reg;
+    RegName root = Find(it->second);
+    it->second = root;
+    return root;
+  }
+
+  void Union(RegName lhs, RegName rhs) {
+    RegName lhs_root = Find(lhs);
+    RegName rhs_root = Find(rhs);
+    if (lhs_root != rhs_root) {
+      parent_[lhs_root] = rhs_root;
+    }
+  }
+
+ private:
+  std::unordered_map<RegName, RegName> parent_;
+};
+
+/*! \brief An access of an instruction to the values of an alias set. */
+struct Access {
+  RegName root;
+  bool write;
+};
+
+class DispatchPlanner {
+ public:
+  explicit DispatchPlanner(const VMExecutable& exec) : exec_(exec) {}
+
+  void PlanFunction(const VMFuncInfo& func,
+                    std::unordered_map<Index, DispatchSegment>* segments) {
+    AliasSets aliases;
+    std::unordered_set<Index> jump_targets;
+    std::unordered_map<RegName, Index> alloc_pcs;
+    for (Index pc = func.start_instr; pc < func.end_instr; ++pc) {
+      Instruction instr = exec_.GetInstruction(pc);
+      if (instr.op == Opcode::If) {
+        jump_targets.insert(pc + 1);
+        jump_targets.insert(pc + instr.false_offset);
+      } else if (instr.op == Opcode::Goto) {
+        jump_targets.insert(pc + instr.pc_offset);
+      } else if (instr.op == Opcode::Call && instr.dst < Instruction::kBeginSpecialReg) {
+        const std::string& name = exec_.func_table[instr.func_idx].name;
+        if (name == "vm.builtin.alloc_tensor") {
+          aliases.Union(instr.dst, instr.args[0].value());
+          alloc_pcs[instr.dst] = pc;
+        } else if (name != "vm.builtin.alloc_storage" && name != "vm.builtin.null_value" &&
+                   !IsConcurrentCall(exec_, instr)) {
+          // Other builtins, e.g. copy, reshape and tuple accessors, may return a view of
+          // their arguments.
+          for (Index i = 0; i < instr.num_args; ++i) {
+            if (IsRegisterArg(instr.args[i])) {
+              aliases.Union(instr.dst, instr.args[i].value());
+            }
+          }
+        }
+      }
+    }
+
+    Index pc = func.start_instr;
+    while (pc < func.end_instr) {
+      if (exec_.GetInstruction(pc).op != Opcode::Call) {
+        ++pc;
+        continue;
+      }
+      Index end = pc + 1;
+      while (end < func.end_instr && exec_.GetInstruction(end).op == Opcode::Call &&
+             !jump_targets.count(end)) {
+        ++end;
+      }
+      // The tensors allocated in other runs, e.g. before a jump target, are not used before
+      // this run on some paths.
+      std::unordered_set<RegName> fresh_tensors;
+      for (const auto& [reg, alloc_pc] : alloc_pcs) {
+        if (alloc_pc < pc || alloc_pc >= end) fresh_tensors.insert(reg);
+      }
+      DispatchSegment segment = PlanSegment(func, pc, end, &aliases, std::move(fresh_tensors));
+      if (!segment.steps.empty()) {
+        segments->emplace(pc, std::move(segment));
+      }
+      pc = end;
+    }
+  }
+
+ private:
+  /*! \brief Whether the register is in the release table of the instruction. */
+  bool IsReleasedAfter(Index pc, RegName reg) const {
+    if (static_cast<size_t>(pc) + 1 >= exec_.release_offset.size()) return false;
+    auto begin = exec_.release_regs.begin() + exec_.release_offset[pc];
+    auto end = exec_.release_regs.begin() + exec_.release_offset[pc + 1];
+    return std::binary_search(begin, end, reg);
+  }
+
+  /*! \brief Plan a run of call instructions, returns a segment without steps if none of its
+   *  calls can run concurrently. */
+  DispatchSegment PlanSegment(const VMFuncInfo& func, Index begin, Index end,
+                              AliasSets* aliases, std::unordered_set<RegName> fresh_tensors) {
+    int num_instrs = static_cast<int>(end - begin);
+    std::vector<Instruction> instrs;
+    std::vector<bool> concurrent;
+    std::unordered_map<RegName, int> last_use;
+    for (int i = 0; i < num_instrs; ++i) {
+      instrs.push_back(exec_.GetInstruction(begin + i));
+      concurrent.push_back(IsConcurrentCall(exec_, instrs.back()));
+      for (Index j = 0; j < instrs[i].num_args; ++j) {
+        if (IsRegisterArg(instrs[i].args[j])) {
+          last_use[instrs[i].args[j].value()] = i;
+        }
+      }
+    }
+
+    // Build the dependencies from the accesses of each instruction, in program order.
+    std::vector<std::vector<int>> succs(num_instrs);
+    std::vector<int> num_preds(num_instrs, 0);
+    auto add_dep = [&](int from, int to) {
+      if (from == to) return;
+      succs[from].push_back(to);
+      ++num_preds[to];
+    };
+    std::unordered_map<RegName, int> last_writer;
+    std::unordered_map<RegName, std::vector<int>> readers;
+    std::vector<int> serial_instrs;
+    for (int i = 0; i < num_instrs; ++i) {
+      const Instruction& instr = instrs[i];
+      // A call without result and without fresh tensors to write its outputs to updates its
+      // arguments in place, e.g. call_tir_inplace, including the arguments of the function.
+      bool inplace = instr.dst == Instruction::kVoidRegister;
+      for (Index j = 0; j < instr.num_args && inplace; ++j) {
+        inplace = !IsRegisterArg(instr.args[j]) || !fresh_tensors.count(instr.args[j].value());
+      }
+      std::vector<Access> accesses;
+      for (Index j = 0; j < instr.num_args; ++j) {
+        if (!IsRegisterArg(instr.args[j])) continue;
+        RegName reg = instr.args[j].value();
+        // A register released after the call is cleared by it, after the other readers.
+        bool write = !concurrent[i] || inplace || fresh_tensors.erase(reg) ||
+                     (reg >= static_cast<RegName>(func.num_args) && last_use[reg] == i) ||
+                     IsReleasedAfter(begin + i, reg);
+        accesses.push_back(Access{aliases->Find(reg), write});
+      }
+      if (instr.dst < Instruction::kBeginSpecialReg) {
+        accesses.push_back(Access{aliases->Find(instr.dst), true});
+      }
+      if (exec_.func_table[instr.func_idx].name == "vm.builtin.alloc_tensor" &&
+          instr.dst < Instruction::kBeginSpecialReg) {
+        fresh_tensors.insert(instr.dst);
+      }
+
+      if (!concurrent[i]) {
+        // The other instructions keep their order.
+        if (!serial_instrs.empty()) add_dep(serial_instrs.back(), i);
+        serial_instrs.push_back(i);
+      }
+      for (const Access& access : accesses) {
+        auto it = last_writer.find(access.root);
+        if (it != last_writer.end()) add_dep(it->second, i);
+        std::vector<int>& root_readers = readers[access.root];
+        if (access.write) {
+          for (int reader : root_readers) add_dep(reader, i);
+          root_readers.clear();
+          last_writer[access.root] = i;
+        } else {
+          root_readers.push_back(i);
+        }
+      }
+    }
+
+    // Greedy list scheduling: run the other instructions as early as possible, then all the
+    // calls that are ready at once.
+    DispatchSegment segment;
+    segment.end = end;
+    std::vector<int> ready_calls;
+    for (int i = 0; i < num_instrs; ++i) {
+      if (concurrent[i] && num_preds[i] == 0) ready_calls.push_back(i);
+    }
+    auto finish = [&](int i, std::vector<int>* next_ready_calls) {
+      for (int succ : succs[i]) {
+        if (--num_preds[succ] == 0 && concurrent[succ]) next_ready_calls->push_back(succ);
+      }
+    };
+    size_t next_serial = 0;
+    int num_done = 0;
+    bool has_concurrent_step = false;
+    while (num_done < num_instrs) {
+      while (next_serial < serial_instrs.size() && num_preds[serial_instrs[next_serial]] == 0) {
+        int i = serial_instrs[next_serial++];
+        segment.steps.push_back({begin + i});
+        finish(i, &ready_calls);
+        ++num_done;
+      }
+      if (num_done == num_instrs) break;
+      ICHECK(!ready_calls.empty()) << "InternalError: Cyclic dependencies between instructions";
+      std::sort(ready_calls.begin(), ready_calls.end());
+      std::vector<int> wave = std::move(ready_calls);
+      ready_calls.clear();
+      std::vector<Index> step;
+      for (int i : wave) {
+        step.push_back(begin + i);
+        finish(i, &ready_calls);
+        ++num_done;
+      }
+      has_concurrent_step |= step.size() > 1;
+      segment.steps.push_back(std::move(step));
+    }
+    if (!has_concurrent_step) {
+      segment.steps.clear();
+    }
+    return segment;
+  }
+
+  const VMExecutable& exec_;
+};
+
+}  // namespace
+
+bool IsConcurrentCall(const VMExecutable& exec, const Instruction& instr) {
+  if (instr.op != Opcode::Call) return false;
+  const VMFuncInfo& callee = exec.func_table[instr.func_idx];
+  // VM builtins may use the state of the VM, and VM functions run on its frame stack.
+  if (callee.kind != VMFuncInfo::FuncKind::kPackedFunc || callee.name.rfind("vm.", 0) == 0) {
+    return false;
+  }
+  for (Index i = 0; i < instr.num_args; ++i) {
+    const Instruction::Arg& arg = instr.args[i];
+    if (arg.kind() == Instruction::ArgKind::kFuncIdx ||
+        (arg.kind() == Instruction::ArgKind::kRegister && !IsRegisterArg(arg))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unordered_map<Index, DispatchSegment> PlanConcurrentDispatch(const VMExecutable& exec) {
+  std::unordered_map<Index, DispatchSegment> segments;
+  DispatchPlanner planner(exec);
+  for (const VMFuncInfo& func : exec.func_table) {
+    if (func.kind == VMFuncInfo::FuncKind::kVMFunc) {
+      planner.PlanFunction(func, &segments);
+    }
+  }
+  return segments;
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("vm.builtin.get_dispatch_plan", [](ffi::Module exec_mod) {
+    CHECK_EQ(std::string(exec_mod->kind()), "relax.VMExecutable")
+        << "ValueError: Expect a relax VMExecutable module, but got " << exec_mod->kind();
+    const auto* exec = static_cast<const VMExecutable*>(exec_mod.operator->());
+    std::unordered_map<Index, DispatchSegment> segments = PlanConcurrentDispatch(*exec);
+    std::vector<Index> begins;
+    for (const auto& kv : segments) begins.push_back(kv.first);
+    std::sort(begins.begin(), begins.end());
+    // The steps of all the segments, in program order.
+    ffi::Array<ffi::Shape> steps;
+    for (Index begin : begins) {
+      for (const std::vector<Index>& step : segments.at(begin).steps) {
+        steps.push_back(ffi::Shape(step.begin(), step.end()));
+      }
+    }
+    return steps;
+  });
+}
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/dispatch_plan.h
+ * \brief Plan the concurrent execution of independent call instructions of the VM.
+ */
+#ifndef TVM_RUNTIME_VM_DISPATCH_PLAN_H_
+#define TVM_RUNTIME_VM_DISPATCH_PLAN_H_
+
+#include <tvm/runtime/vm/executable.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief The execution order of a straight-line run of call instructions.
+ *
+ * The run is split into steps that execute one after another. A step of a single instruction
+ * runs as usual, the calls of a larger step are independent and run concurrently.
+ */
+struct DispatchSegment {
+  /*! \brief The pc right after the last instruction of the run. */
+  Index end;
+  /*! \brief The pcs of the instructions of each step. */
+  std::vector<std::vector<Index>> steps;
+};
+
+/*!
+ * \brief Find the runs of call instructions of the VM functions of an executable that have
+ *  independent calls, and the order to execute them.
+ *
+ * Only calls to packed functions that do not take the VM context can run concurrently.
+ * Two calls are independent when neither writes the memory the other one accesses, where
+ * the tensors allocated from the same storage may alias each other. A call is assumed to write
+ * the tensors it is the first user of after their allocation, or in the run if they are
+ * allocated outside of it, i.e. its DPS outputs, and the registers other than the arguments of
+ * the function it is the last user of in the run. A call without result that has no such
+ * outputs is assumed to update all its arguments in place, as call_tir_inplace does.
+ *
+ * \param exec The executable.
+ * \return The segments with concurrent calls, by the pc of their first instruction.
+ */
+std::unordered_map<Index, DispatchSegment> PlanConcurrentDispatch(const VMExecutable& exec);
+
+/*!
+ * \brief Whether a call instruction may run concurrently with other calls.
+ * \param exec The executable.
+ * \param instr The call instruction.
+ */
+bool IsConcurrentCall(const VMExecutable& exec, const Instruction& instr);
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_DISPATCH_PLAN_H_
@@ -27,6 +27,13 @@
 #include <tvm/runtime/vm/executable.h>
 #include <tvm/runtime/vm/vm.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <functional>
 #include <sstream>
 
@@ -39,6 +46,10 @@ namespace vm {
 /*! \brief The magic number for the serialized VM bytecode file  */
 constexpr uint64_t kTVMVMBytecodeMagic = 0xD225DE2F4214151D;
 constexpr uint64_t kTVMVMBytecodeMagicV2 = 0xD225DE2F4214151E;
+/*! \brief The format with the data of the tensor constants at aligned offsets of the file. */
+constexpr uint64_t kTVMVMBytecodeMagicV3 = 0xD225DE2F4214151F;
+/*! \brief The alignment of the data of the tensor constants of at least a page. */
+constexpr size_t kConstantPageAlignment = 4096;
 
 #define STREAM_CHECK(val, section)                                          \
   ICHECK(val) << "Invalid VM file format in the " << section << " section." \
@@ -144,7 +155,7 @@ Instruction VMExecutable::GetInstruction(Index i) const {
 }
 
 void SaveHeader(dmlc::Stream* strm) {
-  uint64_t header = kTVMVMBytecodeMagicV2;
+  uint64_t header = kTVMVMBytecodeMagicV3;
   strm->Write(header);
   std::string version = VM_VERSION;
   strm->Write(version);
@@ -154,7 +165,9 @@ uint64_t LoadHeader(dmlc::Stream* strm) {
   // Check header.
   uint64_t header;
   STREAM_CHECK(strm->Read(&header), "header");
-  STREAM_CHECK((header == kTVMVMBytecodeMagic) || (header == kTVMVMBytecodeMagicV2), "header");
+  STREAM_CHECK((header == kTVMVMBytecodeMagic) || (header == kTVMVMBytecodeMagicV2) ||
+                   (header == kTVMVMBytecodeMagicV3),
+               "header");
 
   // Check version.
   std::string version;
@@ -184,6 +197,9 @@ ffi::Bytes VMExecutable::SaveToBytes() const {
   // Code section.
   SaveCodeSection(&strm);
 
+  // Register release section.
+  SaveReleaseSection(&strm);
+
   return ffi::Bytes(code);
 }
 
@@ -191,36 +207,87 @@ void VMExecutable::WriteToFile(const ffi::String& file_name, const ffi::String&
   runtime::SaveBinaryToFile(file_name, VMExecutable::SaveToBytes());
 }
 
-ffi::Module VMExecutable::LoadFromBytes(const ffi::Bytes& bytes) {
-  std::string code;
-  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(bytes.data()), bytes.size());
-
+ffi::Module VMExecutable::Load(dmlc::SeekStream* strm, const std::shared_ptr<MappedFile>& file) {
   ObjectPtr<VMExecutable> exec = ffi::make_object<VMExecutable>();
 
   // Load header.
-  uint64_t header_magic = LoadHeader(&strm);
+  uint64_t header_magic = LoadHeader(strm);
 
   // Global section.
-  exec->LoadGlobalSection(&strm);
+  exec->LoadGlobalSection(strm);
 
-  if (kTVMVMBytecodeMagicV2 == header_magic) {
+  if (header_magic != kTVMVMBytecodeMagic) {
     // Memory Scopes
-    exec->LoadMemoryScopeSection(&strm);
+    exec->LoadMemoryScopeSection(strm);
   }
 
   // Constant section.
-  exec->LoadConstantSection(&strm);
+  exec->LoadConstantSection(strm, header_magic, file);
 
   // Code section.
-  exec->LoadCodeSection(&strm);
+  exec->LoadCodeSection(strm);
+
+  // Register release section.
+  exec->LoadReleaseSection(strm);
 
   return ffi::Module(exec);
 }
 
+ffi::Module VMExecutable::LoadFromBytes(const ffi::Bytes& bytes) {
+  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(bytes.data()), bytes.size());
+  return Load(&strm, nullptr);
+}
+
+/*!
+ * \brief A private, copy-on-write mapping of a file, unmapped when the last tensor constant that
+ *  aliases it goes away.
+ */
+class MappedFile {
+ public:
+  MappedFile(char* data, size_t size) : data_(data), size_(size) {}
+  ~MappedFile() {
+#ifndef _WIN32
+    munmap(data_, size_);
+#endif
+  }
+
+  /*! \return The mapping of the file, nullptr if it can't be mapped. */
+  static std::shared_ptr<MappedFile> Open(const std::string& file_name) {
+#ifdef _WIN32
+    return nullptr;
+#else
+    int fd = open(file_name.c_str(), O_RDONLY);
+    ICHECK_GE(fd, 0) << "Cannot open " << file_name;
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      // The kernels may write to the constants in place, which only copies the pages they write.
+      data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    return std::make_shared<MappedFile>(static_cast<char*>(data), st.st_size);
+#endif
+  }
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  char* data_;
+  size_t size_;
+};
+
 ffi::Module VMExecutable::LoadFromFile(const ffi::String& file_name) {
-  std::string data;
-  runtime::LoadBinaryFromFile(file_name, &data);
-  return VMExecutable::LoadFromBytes(ffi::Bytes(data));
+  // The constants can only alias the file when they need no byte swap.
+  std::shared_ptr<MappedFile> file = DMLC_IO_NO_ENDIAN_SWAP ? MappedFile::Open(file_name) : nullptr;
+  if (file == nullptr) {
+    std::string data;
+    runtime::LoadBinaryFromFile(file_name, &data);
+    return VMExecutable::LoadFromBytes(ffi::Bytes(data));
+  }
+  dmlc::MemoryFixedSizeStream strm(file->data(), file->size());
+  return Load(&strm, file);
 }
 
 TVM_FFI_STATIC_INIT_BLOCK() {
@@ -265,12 +332,25 @@ void VMExecutable::SaveMemoryScopeSection(dmlc::Stream* strm) const {
   }
 }
 
-void VMExecutable::SaveConstantSection(dmlc::Stream* strm) const {
+void VMExecutable::SaveConstantSection(dmlc::SeekStream* strm) const {
   strm->Write(static_cast<uint64_t>(this->constants.size()));
   for (const auto& it : this->constants) {
     if (auto opt_nd = it.as<runtime::Tensor>()) {
+      const DLTensor* tensor = opt_nd.value().operator->();
       strm->Write<int32_t>(ffi::TypeIndex::kTVMFFITensor);
-      runtime::SaveDLTensor(strm, opt_nd.value().operator->());
+      // Pad the data to an aligned offset, so that the loads of the mapped file can alias it.
+      // It follows the padding size and the header of SaveDLTensor.
+      size_t nbytes = GetDataSize(*tensor);
+      size_t alignment =
+          nbytes >= kConstantPageAlignment ? kConstantPageAlignment : kAllocAlignment;
+      size_t data_offset = strm->Tell() + sizeof(uint64_t) + 2 * sizeof(uint64_t) +
+                           sizeof(DLDevice) + sizeof(int) + sizeof(DLDataType) +
+                           tensor->ndim * sizeof(int64_t) + sizeof(int64_t);
+      uint64_t padding = (alignment - data_offset % alignment) % alignment;
+      strm->Write(padding);
+      std::string zeros(padding, '\0');
+      strm->Write(zeros.data(), zeros.size());
+      runtime::SaveDLTensor(strm, tensor);
     } else if (auto opt_shape = it.as<ffi::Shape>()) {
       ffi::Shape shape = opt_shape.value();
       strm->Write<int32_t>(ffi::TypeIndex::kTVMFFIShape);
@@ -305,6 +385,11 @@ void VMExecutable::SaveCodeSection(dmlc::Stream* strm) const {
   strm->Write(instr_data);
 }
 
+void VMExecutable::SaveReleaseSection(dmlc::Stream* strm) const {
+  strm->Write(release_offset);
+  strm->Write(release_regs);
+}
+
 void VMExecutable::LoadGlobalSection(dmlc::Stream* strm) {
   STREAM_CHECK(strm->Read(&func_table), "Global Section");
   // setup func map
@@ -330,7 +415,42 @@ void VMExecutable::LoadMemoryScopeSection(dmlc::Stream* strm) {
   }
 }
 
-void VMExecutable::LoadConstantSection(dmlc::Stream* strm) {
+namespace {
+
+/*! \brief Load a tensor saved by SaveDLTensor as a view of its data in the mapped file. */
+Tensor LoadMappedTensor(dmlc::SeekStream* strm, const std::shared_ptr<MappedFile>& file) {
+  uint64_t header, reserved;
+  Device dev;
+  int ndim;
+  DLDataType dtype;
+  STREAM_CHECK(strm->Read(&header) && header == kTVMTensorMagic, "constant");
+  STREAM_CHECK(strm->Read(&reserved), "constant");
+  STREAM_CHECK(strm->Read(&dev) && dev.device_type == kDLCPU, "constant");
+  STREAM_CHECK(strm->Read(&ndim) && ndim >= 0, "constant");
+  STREAM_CHECK(strm->Read(&dtype), "constant");
+  std::vector<int64_t> shape(ndim);
+  if (ndim != 0) {
+    STREAM_CHECK(strm->ReadArray(shape.data(), ndim), "constant");
+  }
+  int64_t num_elems = 1;
+  for (int64_t extent : shape) {
+    num_elems *= extent;
+  }
+  int64_t data_byte_size;
+  STREAM_CHECK(strm->Read(&data_byte_size), "constant");
+  STREAM_CHECK(data_byte_size == num_elems * ((dtype.bits + 7) / 8), "constant");
+  size_t offset = strm->Tell();
+  STREAM_CHECK(offset + data_byte_size <= file->size(), "constant");
+  strm->Seek(offset + data_byte_size);
+  // The pages of the data are only read in when the tensor is first copied or used.
+  return Tensor::FromExternal(file->data() + offset, ffi::Shape(shape), dtype, dev,
+                              [file](void*) {});
+}
+
+}  // namespace
+
+void VMExecutable::LoadConstantSection(dmlc::SeekStream* strm, uint64_t header_magic,
+                                       const std::shared_ptr<MappedFile>& file) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
@@ -343,7 +463,16 @@ void VMExecutable::LoadConstantSection(dmlc::Stream* strm) {
     int constant_type;
     STREAM_CHECK(strm->Read(&constant_type, sizeof(constant_type)), "constant");
     if (constant_type == ffi::TypeIndex::kTVMFFITensor) {
-      ndarray.Load(strm);
+      if (header_magic == kTVMVMBytecodeMagicV3) {
+        uint64_t padding;
+        STREAM_CHECK(strm->Read(&padding), "constant");
+        strm->Seek(strm->Tell() + padding);
+      }
+      if (file != nullptr && header_magic == kTVMVMBytecodeMagicV3) {
+        ndarray = LoadMappedTensor(strm, file);
+      } else {
+        ndarray.Load(strm);
+      }
       ffi::Any cell;
       cell = ndarray;
       this->constants.push_back(cell);
@@ -396,6 +525,18 @@ void VMExecutable::LoadCodeSection(dmlc::Stream* strm) {
   STREAM_CHECK(strm->Read(&(this->instr_data)), "instr data");
 }
 
+void VMExecutable::LoadReleaseSection(dmlc::Stream* strm) {
+  // The section is optional, the registers are then only released when the frame exits.
+  if (!strm->Read(&(this->release_offset))) {
+    this->release_offset.clear();
+    return;
+  }
+  STREAM_CHECK(strm->Read(&(this->release_regs)), "release regs");
+  STREAM_CHECK(this->release_offset.empty() ||
+                   this->release_offset.size() == this->instr_offset.size() + 1,
+               "release offset");
+}
+
 template <typename T>
 std::string StrJoin(T* items, int offset, int cnt, std::string delim = ", ",
                     std::function<std::string(T)> repr = std::to_string) {
@@ -434,6 +575,10 @@ ffi::Module VMExecutable::VMProfilerLoadExecutable() const {
 
 bool VMExecutable::HasFunction(const ffi::String& name) const { return func_map.count(name); }
 
+ffi::Array<ffi::Any> VMExecutable::GetConstants() const {
+  return ffi::Array<ffi::Any>(constants.begin(), constants.end());
+}
+
 ffi::String VMExecutable::AsText() const {
   auto get_func_name = [&](Index index) -> std::string {
     if (static_cast<size_t>(index) < func_table.size()) {
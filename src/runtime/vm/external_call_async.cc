@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/external_call_async.cc
+ * \brief Run the external functions, e.g. the BYOC regions, on side streams of their device, so
+ *  that the independent regions overlap with each other and with the kernels of the VM.
+ */
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/tensor.h>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*! \brief The side streams of the devices, created on their first use and kept alive. */
+class ExternalCallStreamPool {
+ public:
+  static ExternalCallStreamPool* Global() {
+    static ExternalCallStreamPool* inst = new ExternalCallStreamPool();
+    return inst;
+  }
+
+  TVMStreamHandle Get(Device dev, int64_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto key = std::make_tuple(static_cast<int>(dev.device_type), dev.device_id, index);
+    auto it = streams_.find(key);
+    if (it == streams_.end()) {
+      it = streams_.emplace(key, DeviceAPI::Get(dev)->CreateStream(dev)).first;
+    }
+    return it->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::tuple<int, int, int64_t>, TVMStreamHandle> streams_;
+};
+
+/*! \brief Get the device of the first tensor argument, or nullopt if there is none. */
+std::optional<Device> GetTensorDevice(ffi::PackedArgs args) {
+  for (int i = 0; i < args.size(); ++i) {
+    if (auto opt_tensor = args[i].as<Tensor>()) {
+      return opt_tensor.value()->device;
+    } else if (auto opt_dltensor = args[i].try_cast<DLTensor*>()) {
+      return opt_dltensor.value()->device;
+    }
+  }
+  return std::nullopt;
+}
+
+/*!
+ * \brief Start an external function on a side stream of the device of its arguments.
+ *
+ * The side stream waits for the work enqueued so far on the current stream of the device, and the
+ * function enqueues its work on the side stream, which it reads as the current stream of the
+ * device. On the devices without streams, the function simply runs.
+ *
+ * args[0]: The external function, in destination-passing style.
+ * args[1]: The index of the side stream.
+ * args[2:]: The arguments of the function, with its outputs.
+ */
+void ExternalCallAsync(ffi::PackedArgs args, ffi::Any* rv) {
+  CHECK_GE(args.size(), 2);
+  ffi::Function func = args[0].cast<ffi::Function>();
+  int64_t index = args[1].cast<int64_t>();
+  ffi::PackedArgs func_args = args.Slice(2);
+  std::optional<Device> opt_dev = GetTensorDevice(func_args);
+  TVMStreamHandle side_stream =
+      opt_dev.has_value() ? ExternalCallStreamPool::Global()->Get(opt_dev.value(), index) : nullptr;
+  if (side_stream == nullptr) {
+    func.CallPacked(func_args, rv);
+    return;
+  }
+  Device dev = opt_dev.value();
+  TVMStreamHandle stream = TVMFFIEnvGetStream(dev.device_type, dev.device_id);
+  DeviceAPI::Get(dev)->SyncStreamFromTo(dev, stream, side_stream);
+  TVM_FFI_CHECK_SAFE_CALL(
+      TVMFFIEnvSetStream(dev.device_type, dev.device_id, side_stream, nullptr));
+  try {
+    func.CallPacked(func_args, rv);
+  } catch (...) {
+    TVM_FFI_CHECK_SAFE_CALL(TVMFFIEnvSetStream(dev.device_type, dev.device_id, stream, nullptr));
+    throw;
+  }
+  TVM_FFI_CHECK_SAFE_CALL(TVMFFIEnvSetStream(dev.device_type, dev.device_id, stream, nullptr));
+}
+
+/*!
+ * \brief Make the current stream of the device wait for the completion of an external function
+ *  started on a side stream, and return its result.
+ *
+ * args[0]: The result of the external function.
+ * args[1]: The inputs of the external function, which are unused and only kept alive until here.
+ * args[2]: The index of the side stream.
+ */
+Tensor ExternalCallWait(Tensor result, ffi::Any inputs, int64_t index) {
+  Device dev = result->device;
+  TVMStreamHandle side_stream = ExternalCallStreamPool::Global()->Get(dev, index);
+  if (side_stream != nullptr) {
+    TVMStreamHandle stream = TVMFFIEnvGetStream(dev.device_type, dev.device_id);
+    DeviceAPI::Get(dev)->SyncStreamFromTo(dev, side_stream, stream);
+  }
+  return result;
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def_packed("vm.builtin.external_call_async", ExternalCallAsync)
+      .def("vm.builtin.external_call_wait", ExternalCallWait);
+}
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
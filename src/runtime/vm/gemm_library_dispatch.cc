@@ -0,0 +1,230 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/gemm_library_dispatch.cc
+ * \brief Dispatch the GEMMs of dynamic shapes to the TIR kernel or the vendor library, whichever
+ *  the heuristic table records as faster for the shape bucket.
+ */
+#include <picojson.h>
+#include <tvm/ffi/container/map.h>
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/tensor.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "../file_utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*! \brief The implementation of a GEMM that a shape bucket dispatches to. */
+enum class GEMMChoice : int {
+  kTIR = 0,
+  kLibrary = 1,
+};
+
+/*!
+ * \brief The table of the fastest implementation of the GEMMs, by library, device, dtype and
+ *  the bucket of the (M, N, K) shape, where each extent is rounded up to a power of two.
+ *
+ * The table is measured once at deploy time, when the dispatcher benchmarks both
+ * implementations of the buckets it does not know yet, and is saved as a JSON file stored next
+ * to the executable to be loaded by the later runs.
+ */
+class GEMMDispatchTable {
+ public:
+  static GEMMDispatchTable* Global() {
+    static GEMMDispatchTable* inst = new GEMMDispatchTable();
+    return inst;
+  }
+
+  bool Lookup(const std::string& key, GEMMChoice* choice) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    *choice = it->second;
+    return true;
+  }
+
+  void Record(const std::string& key, GEMMChoice choice) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key] = choice;
+  }
+
+  bool measure() const { return measure_; }
+
+  void set_measure(bool measure) { measure_ = measure; }
+
+  /*! \brief Load the entries of a table file, on top of the current ones. */
+  void Load(const std::string& path) {
+    std::string json_str;
+    LoadBinaryFromFile(path, &json_str);
+    picojson::value json_info;
+    std::string err = picojson::parse(json_info, json_str);
+    CHECK(err.empty()) << "Failed to parse the GEMM dispatch table " << path << ": " << err;
+    CHECK(json_info.is<picojson::object>() &&
+          json_info.get<picojson::object>().count("entries") &&
+          json_info.get<picojson::object>().at("entries").is<picojson::object>())
+        << "The GEMM dispatch table " << path << " must have the \"entries\" object field";
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [key, value] : json_info.get<picojson::object>().at("entries")
+                                        .get<picojson::object>()) {
+      CHECK(value.is<std::string>() &&
+            (value.get<std::string>() == "tir" || value.get<std::string>() == "library"))
+          << "The entries of the GEMM dispatch table must be \"tir\" or \"library\"";
+      entries_[key] = value.get<std::string>() == "tir" ? GEMMChoice::kTIR : GEMMChoice::kLibrary;
+    }
+  }
+
+  void Save(const std::string& path) {
+    picojson::object entries;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& [key, choice] : entries_) {
+        entries[key] = picojson::value(choice == GEMMChoice::kTIR ? "tir" : "library");
+      }
+    }
+    picojson::object json_info;
+    json_info["entries"] = picojson::value(entries);
+    SaveBinaryToFile(path, picojson::value(json_info).serialize(/*prettify=*/true));
+  }
+
+  ffi::Map<ffi::String, ffi::String> AsMap() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ffi::Map<ffi::String, ffi::String> result;
+    for (const auto& [key, choice] : entries_) {
+      result.Set(key, choice == GEMMChoice::kTIR ? "tir" : "library");
+    }
+    return result;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, GEMMChoice> entries_;
+  /*! \brief Whether to benchmark the buckets missing from the table. */
+  std::atomic<bool> measure_{false};
+};
+
+/*! \brief Round an extent up to a power of two. */
+int64_t RoundUpToPowerOfTwo(int64_t extent) {
+  int64_t result = 1;
+  while (result < extent) {
+    result <<= 1;
+  }
+  return result;
+}
+
+/*!
+ * \brief Run a GEMM C = A @ B of dynamic shape with the TIR kernel or the library.
+ *
+ * args[0]: The library, e.g. "cublas", whose "tvm.contrib.<library>.matmul" is called.
+ * args[1]: The TIR kernel, taking A, B and C.
+ * args[2, 3, 4]: A, B, and the DPS output C.
+ */
+void GEMMLibraryDispatch(ffi::PackedArgs args, ffi::Any* rv) {
+  CHECK_EQ(args.size(), 5);
+  std::string library = args[0].cast<std::string>();
+  ffi::Function tir_func = args[1].cast<ffi::Function>();
+  ffi::PackedArgs kernel_args = args.Slice(2);
+  DLTensor* a = args[2].cast<DLTensor*>();
+  DLTensor* b = args[3].cast<DLTensor*>();
+
+  // Look the library up on every call, as it may be registered or overridden later, and the
+  // functions registered from Python must not outlive the interpreter.
+  ffi::Optional<ffi::Function> lib_func =
+      ffi::Function::GetGlobal("tvm.contrib." + library + ".matmul");
+  if (!lib_func.has_value()) {
+    tir_func.CallPacked(kernel_args, rv);
+    return;
+  }
+  ffi::Function lib_call([lib_func = lib_func.value()](ffi::PackedArgs args, ffi::Any* rv) {
+    lib_func(args[0], args[1], args[2], /*transa=*/false, /*transb=*/false);
+  });
+
+  std::ostringstream os;
+  os << library << "/" << DLDeviceType2Str(a->device.type) << "/" << DLDataTypeToString(a->dtype)
+     << "/" << RoundUpToPowerOfTwo(a->shape[0]) << "," << RoundUpToPowerOfTwo(b->shape[1]) << ","
+     << RoundUpToPowerOfTwo(a->shape[1]);
+  std::string key = os.str();
+
+  GEMMDispatchTable* table = GEMMDispatchTable::Global();
+  GEMMChoice choice = GEMMChoice::kTIR;
+  if (table->Lookup(key, &choice) || !table->measure()) {
+    (choice == GEMMChoice::kTIR ? tir_func : lib_call).CallPacked(kernel_args, rv);
+    return;
+  }
+
+  // Both implementations write the same output, which is left by the last run.
+  Device dev = a->device;
+  TVMStreamHandle stream = TVMFFIEnvGetStream(dev.device_type, dev.device_id);
+  auto f_time = [&](const ffi::Function& func) {
+    constexpr int kNumRepeats = 5;
+    func.CallPacked(kernel_args, rv);
+    DeviceAPI::Get(dev)->StreamSync(dev, stream);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kNumRepeats; ++i) {
+      func.CallPacked(kernel_args, rv);
+    }
+    DeviceAPI::Get(dev)->StreamSync(dev, stream);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  double library_time = f_time(lib_call);
+  double tir_time = f_time(tir_func);
+  choice = library_time < tir_time ? GEMMChoice::kLibrary : GEMMChoice::kTIR;
+  table->Record(key, choice);
+  VLOG(1) << "GEMM bucket " << key << ": TIR " << tir_time << "s, library " << library_time
+          << "s";
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def_packed("vm.builtin.gemm_library_dispatch", GEMMLibraryDispatch)
+      .def("vm.builtin.gemm_dispatch_table.load",
+           [](const std::string& path) { GEMMDispatchTable::Global()->Load(path); })
+      .def("vm.builtin.gemm_dispatch_table.save",
+           [](const std::string& path) { GEMMDispatchTable::Global()->Save(path); })
+      .def("vm.builtin.gemm_dispatch_table.set_measure",
+           [](bool measure) { GEMMDispatchTable::Global()->set_measure(measure); })
+      .def("vm.builtin.gemm_dispatch_table.entries",
+           []() { return GEMMDispatchTable::Global()->AsMap(); })
+      .def("vm.builtin.gemm_dispatch_table.clear", []() { GEMMDispatchTable::Global()->Clear(); });
+}
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
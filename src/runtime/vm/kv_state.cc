@@ -61,10 +61,27 @@ TVM_FFI_STATIC_INIT_BLOCK() {
       .def_method("vm.builtin.kv_cache_disagg_prepare_recv",
                   &AttentionKVCacheObj::DisaggPrepareRecv)
       .def_method("vm.builtin.kv_cache_disagg_mark_send", &AttentionKVCacheObj::DisaggMarkSend)
+      .def_method("vm.builtin.kv_cache_disagg_get_recv_layer_counters",
+                  &AttentionKVCacheObj::DisaggGetRecvLayerCounters)
       .def_method("vm.builtin.attention_kv_cache_enable_sliding_window_for_seq",
                   &AttentionKVCacheObj::EnableSlidingWindowForSeq)
       .def_method("vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes",
                   &AttentionKVCacheObj::CommitAcceptedTokenTreeNodes)
+      .def_method("vm.builtin.attention_kv_cache_commit_sequence_prefix",
+                  &AttentionKVCacheObj::CommitSequencePrefix)
+      .def_method("vm.builtin.attention_kv_cache_match_prefix", &AttentionKVCacheObj::MatchPrefix)
+      .def_method("vm.builtin.attention_kv_cache_add_sequence_with_prefix",
+                  &AttentionKVCacheObj::AddSequenceWithPrefix)
+      .def_method("vm.builtin.attention_kv_cache_evict_prefix_cache",
+                  &AttentionKVCacheObj::EvictPrefixCache)
+      .def_method("vm.builtin.attention_kv_cache_offload_sequence",
+                  &AttentionKVCacheObj::OffloadSequence)
+      .def_method("vm.builtin.attention_kv_cache_prefetch_sequence",
+                  &AttentionKVCacheObj::PrefetchSequence)
+      .def_method("vm.builtin.attention_kv_cache_get_page_fragmentation",
+                  &AttentionKVCacheObj::GetPageFragmentation)
+      .def_method("vm.builtin.attention_kv_cache_defragment_pages",
+                  &AttentionKVCacheObj::DefragmentPages)
       .def_method("vm.builtin.attention_kv_cache_empty", &AttentionKVCacheObj::Empty)
       .def_method("vm.builtin.attention_kv_cache_get_num_available_pages",
                   &AttentionKVCacheObj::GetNumAvailablePages)
@@ -118,7 +135,8 @@ TVM_FFI_STATIC_INIT_BLOCK() {
              state->Set(layer_id, state_id, data);
              return state;
            })
-      .def_method("vm.builtin.rnn_state_debug_get", &RNNStateObj::DebugGet);
+      .def_method("vm.builtin.rnn_state_debug_get", &RNNStateObj::DebugGet)
+      .def_method("vm.builtin.rnn_state_checkpoint_sequence", &RNNStateObj::CheckpointSequence);
 }
 
 }  // namespace vm
@@ -88,6 +88,9 @@ class KVStateObj : public Object {
    * forward. For instance, this method may send auxiliary KV cache
    * data structures to GPUs so that they can be operated
    * in the model forward function.
+   * In a batch mixing decodes with prefills, the paged KV cache runs the
+   * decode sequences placed before all the prefill sequences with the
+   * decode attention kernel, and the rest with the prefill kernel.
    * \param seq_ids The ids of the sequence to run in the incoming model forward.
    * \param append_lengths The sequence lengths to run forward for for each sequence.
    * \param token_tree_parent_ptr The parent idx array of the token trees. Its length
@@ -166,6 +169,99 @@ class AttentionKVCacheObj : public KVStateObj {
                               const IntTuple& compressed_remote_position_map,
                               int32_t recver_pe_offset) = 0;
 
+  /*!
+   * \brief Get the per-layer counters of the disaggregation KV data received.
+   * Each sender increments the counter of a layer once it has put the KV data of the layer,
+   * so that the scheduler polls the progress of a transfer without blocking on it.
+   * \return The counters of the layers of this KV cache.
+   */
+  virtual IntTuple DisaggGetRecvLayerCounters() = 0;
+
+  /************** Prefix Cache **************/
+
+  /*!
+   * \brief Commit the KV data of the leading tokens of a sequence to the prefix cache,
+   * so that later sequences sharing the token prefix can reuse the KV data.
+   * Only the full pages covered by the given tokens are committed.
+   * \param seq_id The id of the sequence whose KV data is being committed.
+   * \param token_ids The token ids of the sequence, whose length should
+   * not exceed the sequence length.
+   */
+  virtual void CommitSequencePrefix(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /*!
+   * \brief Get the number of leading tokens of the given token sequence
+   * whose KV data can be reused from the prefix cache.
+   * At least one token is always left out, so that the caller still
+   * has a token to prefill.
+   * \param token_ids The token ids of a new sequence.
+   * \return The number of reusable tokens.
+   */
+  virtual int64_t MatchPrefix(const IntTuple& token_ids) const = 0;
+
+  /*!
+   * \brief Add a new sequence whose leading tokens attach to the KV data in
+   * the prefix cache instead of being prefilled again.
+   * \param seq_id The id of the new sequence to be added.
+   * \param token_ids The token ids of the new sequence.
+   * \return The number of leading tokens whose KV data is reused. The caller
+   * is expected to prefill the remaining tokens.
+   * \throws Error if the given sequence id is not valid.
+   */
+  virtual int64_t AddSequenceWithPrefix(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /*!
+   * \brief Evict the least recently used prefix cache entries until the
+   * given number of pages are released or the prefix cache is empty.
+   * \param num_pages The number of pages to release, or -1 for evicting all entries.
+   * \return The number of pages released.
+   */
+  virtual int32_t EvictPrefixCache(int32_t num_pages) = 0;
+
+  /************** Offloading **************/
+
+  /*!
+   * \brief Swap the K/V data of an idle sequence out to host memory, and
+   * release the pages it exclusively owns for other sequences to use.
+   * The common prefix shared with other sequences stays in the cache.
+   * An offloaded sequence cannot run forward until it is prefetched.
+   * \param seq_id The id of the sequence to offload.
+   * \throws Error if the given sequence id is not valid.
+   */
+  virtual void OffloadSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Bring the K/V data of an offloaded sequence back into the cache.
+   * The copy is asynchronous, and the next BeginForward waits for it
+   * before running any attention. It is a no-op for sequences not offloaded.
+   * \param seq_id The id of the sequence to prefetch.
+   * \throws Error if the given sequence id is not valid or the cache has no room for it.
+   */
+  virtual void PrefetchSequence(int64_t seq_id) = 0;
+
+  /************** Defragmentation **************/
+
+  /*!
+   * \brief Get the metrics of how scattered the pages of the KV cache are.
+   * \return A tuple of four values:
+   * - the number of pages in use,
+   * - the number of runs of consecutive free page ids,
+   * - the length of the longest run of consecutive free page ids,
+   * - the number of breaks between the consecutive pages of the sequences,
+   *   i.e. the consecutive pages of a sequence whose ids are not consecutive.
+   */
+  virtual IntTuple GetPageFragmentation() const = 0;
+
+  /*!
+   * \brief Move the pages in use to the lowest page ids, laying out the pages of each
+   * sequence in order, and gather the free pages into a single run after them.
+   * Each layer gathers the moved pages into a staging tensor and scatters them to their
+   * new ids on the copy stream, and the call returns once the copies complete. It should
+   * be invoked between two rounds of forward, like the sequence management functions.
+   * \return The number of pages moved.
+   */
+  virtual int32_t DefragmentPages() = 0;
+
   /************** Attention **************/
 
   /*!
@@ -337,6 +433,15 @@ class RNNStateObj : public KVStateObj {
    */
   virtual Tensor DebugGet(int64_t layer_id, int64_t state_id, int64_t seq_id) = 0;
 
+  /*!
+   * \brief Snapshot the current state of the given sequence at its current length.
+   * The snapshot is shared by the sequences forked afterwards, and lets `PopN`
+   * roll the sequence back to this length, and `ForkSequence` fork at this
+   * length, beyond the history kept for rolling back.
+   * \param seq_id The sequence to snapshot.
+   */
+  virtual void CheckpointSequence(int64_t seq_id) = 0;
+
   static constexpr const bool _type_mutable = true;
   TVM_FFI_DECLARE_OBJECT_INFO("relax.vm.RNNState", RNNStateObj, KVStateObj);
 };
@@ -43,9 +43,14 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/tensor.h>
+#include <tvm/runtime/threading_backend.h>
 #include <tvm/runtime/vm/vm.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
@@ -358,65 +363,148 @@ TVM_FFI_STATIC_INIT_BLOCK() {
 }
 
 // NOTE this is a built-in highly related to LM so we put it here.
-int SampleTopPFromLogits(Tensor logits, double temperature, double top_p, double uniform_sample) {
-  ICHECK(logits.IsContiguous());
-  ICHECK(logits.DataType() == DataType::Float(32));
-
-  if (logits->device.device_type != kDLCPU) {
-    logits = logits.CopyTo(DLDevice{kDLCPU, 0});
-  }
 
-  ICHECK(logits->device.device_type == kDLCPU);
+/*!
+ * \brief Sample a token from the top-p nucleus of one row of probabilities.
+ *
+ * Instead of sorting the whole vocabulary, candidates are first filtered by a
+ * probability threshold (the pigeonhole principle bounds the number of elements
+ * above `top_p / 1024` by 1024), with the threshold lowered only when the
+ * candidates do not cover `top_p`. The candidates are then ordered
+ * incrementally with `std::nth_element`, so only the prefix up to the top-p
+ * cutoff is ever sorted.
+ *
+ * \param prob The probabilities of the row.
+ * \param n The number of elements in the row.
+ * \param top_p The top-p value.
+ * \param uniform_sample The uniform sample in [0, 1).
+ * \param data The workspace to hold the candidates.
+ * \return The sampled index, or -1 if the row has no element to sample from.
+ */
+int64_t SampleTopPFromProbRow(const float* prob, int64_t n, double top_p, double uniform_sample,
+                              std::vector<std::pair<float, int>>* data) {
+  auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
+    return lhs.first > rhs.first;
+  };
 
-  for (int i = 0; i < logits->ndim - 1; ++i) {
-    ICHECK_EQ(logits->shape[i], 1) << "The leading dimensions of logits must be 1";
+  // Step 1. Collect the candidates whose total probability covers top_p.
+  float cutoff = top_p < 1 ? static_cast<float>(top_p / 1024) : 0.0f;
+  while (true) {
+    data->clear();
+    float candidate_sum = 0.0f;
+    for (int64_t i = 0; i < n; ++i) {
+      if (prob[i] >= cutoff && prob[i] > 0.0f) {
+        data->emplace_back(prob[i], static_cast<int>(i));
+        candidate_sum += prob[i];
+      }
+    }
+    if (candidate_sum >= top_p || cutoff == 0.0f) break;
+    // Lower the threshold, falling back to all the elements when it underflows.
+    cutoff = cutoff < 1e-30f ? 0.0f : cutoff / 1024;
   }
+  if (data->empty()) return -1;
 
-  std::vector<std::pair<float, int>> data;
-  data.resize(logits->shape[logits->ndim - 1]);
-  const float* plogits = static_cast<float*>(logits->data);
-  for (size_t i = 0; i < data.size(); ++i) {
-    data[i] = std::make_pair(plogits[i], static_cast<int>(i));
+  // Step 2. Order the candidates by chunks until the cumulative sum reaches top_p.
+  auto begin = data->begin();
+  int64_t num_candidates = static_cast<int64_t>(data->size());
+  int64_t num_sorted = 0;
+  float cum_sum_prob = 0.0f;
+  while (num_sorted < num_candidates && cum_sum_prob < top_p) {
+    int64_t chunk_end = std::min(num_candidates, std::max<int64_t>(num_sorted * 2, 16));
+    if (chunk_end < num_candidates) {
+      std::nth_element(begin + num_sorted, begin + chunk_end, data->end(), fcmp);
+    }
+    std::sort(begin + num_sorted, begin + chunk_end, fcmp);
+    for (; num_sorted < chunk_end && cum_sum_prob < top_p; ++num_sorted) {
+      cum_sum_prob += (*data)[num_sorted].first;
+      (*data)[num_sorted].first = cum_sum_prob;
+    }
   }
 
-  auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
-    return lhs.first > rhs.first;
-  };
-  // sort by logits from largest to smallest
-  std::sort(data.begin(), data.end(), fcmp);
+  // Step 3. Pick a number in the nucleus based on the uniform sample.
+  float top_p_sum = cum_sum_prob;
+  for (int64_t i = 0; i < num_sorted; ++i) {
+    if (uniform_sample < (*data)[i].first / top_p_sum) {
+      return (*data)[i].second;
+    }
+  }
+  return (*data)[num_sorted - 1].second;
+}
 
+/*!
+ * \brief Sample a token from one row of logits with temperature and top-p.
+ * \param logits The logits of the row.
+ * \param n The number of elements in the row.
+ * \param temperature The temperature. Values close to 0 means argmax.
+ * \param top_p The top-p value.
+ * \param uniform_sample The uniform sample in [0, 1).
+ * \param prob The workspace to hold the probabilities, whose size is at least n.
+ * \param data The workspace to hold the top-p candidates.
+ * \return The sampled index, or -1 if the row has no element to sample from.
+ */
+int64_t SampleTopPFromLogitsRow(const float* logits, int64_t n, double temperature, double top_p,
+                                double uniform_sample, float* prob,
+                                std::vector<std::pair<float, int>>* data) {
   // argmax
   if (temperature < 1e-6f) {
-    return data[0].second;
+    return std::max_element(logits, logits + n) - logits;
   }
+  // The loops below work on contiguous float arrays without data-dependent
+  // branches so that they are vectorized by the compiler.
+  float max_value = *std::max_element(logits, logits + n);
+  float logit_scale = 1.0f / temperature;
+  float sum = 0.0f;
+  for (int64_t i = 0; i < n; ++i) {
+    prob[i] = expf((logits[i] - max_value) * logit_scale);
+    sum += prob[i];
+  }
+  float inv_sum = 1.0f / sum;
+  for (int64_t i = 0; i < n; ++i) {
+    prob[i] *= inv_sum;
+  }
+  return SampleTopPFromProbRow(prob, n, top_p, uniform_sample, data);
+}
 
-  // compute expf scaled by temp
-  float sum = 0.0f, logit_scale = 1.0f / temperature;
-  float max_value = data[0].first;
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    it->first = expf((it->first - max_value) * logit_scale);
-    sum += it->first;
+/*!
+ * \brief Check that a sampler returns a valid index, and otherwise report the reason.
+ */
+void CheckSampledIndex(int64_t sampled_index, const float* prob, int64_t n) {
+  if (sampled_index >= 0) return;
+  if (std::all_of(prob, prob + n, [](float x) { return std::isnan(x); })) {
+    LOG(FATAL) << "The output probabilities are all NaNs, can not sample from it";
+  } else {
+    LOG(FATAL) << "Cannot sample from the given probability distribution due to unknown reason";
   }
+}
 
-  // do a cumsum in order of data
-  float cum_sum_prob = 0.0f;
-  float top_p_sum = 0.0f;
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    float prob = it->first / sum;
-    if (cum_sum_prob < top_p) {
-      top_p_sum += prob;
-    }
-    cum_sum_prob += prob;
-    it->first = cum_sum_prob;
+/*!
+ * \brief Copy the tensor to CPU and check it is a contiguous float32 tensor.
+ * \return The tensor on CPU.
+ */
+Tensor GetFloat32TensorOnCPU(Tensor tensor) {
+  ICHECK(tensor.IsContiguous());
+  ICHECK(tensor.DataType() == DataType::Float(32));
+  if (tensor->device.device_type != kDLCPU) {
+    tensor = tensor.CopyTo(DLDevice{kDLCPU, 0});
   }
-  // pick a number based on random in (0, 1)
-  for (auto it = data.begin(); it != data.end(); ++it) {
-    if (uniform_sample < it->first / top_p_sum) {
-      return it->second;
-    }
+  ICHECK(tensor->device.device_type == kDLCPU);
+  return tensor;
+}
+
+int SampleTopPFromLogits(Tensor logits, double temperature, double top_p, double uniform_sample) {
+  logits = GetFloat32TensorOnCPU(logits);
+  for (int i = 0; i < logits->ndim - 1; ++i) {
+    ICHECK_EQ(logits->shape[i], 1) << "The leading dimensions of logits must be 1";
   }
-  ICHECK_LE(uniform_sample, data[0].first);
-  return data[0].second;
+
+  int64_t ndata = logits->shape[logits->ndim - 1];
+  const float* plogits = static_cast<float*>(logits->data);
+  std::vector<float> prob(ndata);
+  std::vector<std::pair<float, int>> data;
+  int64_t sampled_index = SampleTopPFromLogitsRow(plogits, ndata, temperature, top_p,
+                                                  uniform_sample, prob.data(), &data);
+  CheckSampledIndex(sampled_index, prob.data(), ndata);
+  return sampled_index;
 }
 
 TVM_FFI_STATIC_INIT_BLOCK() {
@@ -425,101 +513,91 @@ TVM_FFI_STATIC_INIT_BLOCK() {
 }
 
 int SampleTopPFromProb(Tensor prob, double top_p, double uniform_sample) {
-  ICHECK(prob.IsContiguous());
-  ICHECK(prob.DataType() == DataType::Float(32));
-
-  if (prob->device.device_type != kDLCPU) {
-    prob = prob.CopyTo(DLDevice{kDLCPU, 0});
-  }
-
-  ICHECK(prob->device.device_type == kDLCPU);
-
+  prob = GetFloat32TensorOnCPU(prob);
   for (int i = 0; i < prob->ndim - 1; ++i) {
     ICHECK_EQ(prob->shape[i], 1) << "The leading dimensions of logits must be 1";
   }
 
-  // Key observation: when we are doing top_p sampling
-  // usually we only need to preserve some of the elements with
-  // high probablities before we do sort
-  std::vector<std::pair<float, int>> data;
   int64_t ndata = prob->shape[prob->ndim - 1];
   const float* p_prob = static_cast<float*>(prob->data);
+  std::vector<std::pair<float, int>> data;
+  data.reserve(128);
+  int64_t sampled_index = SampleTopPFromProbRow(p_prob, ndata, top_p, uniform_sample, &data);
+  CheckSampledIndex(sampled_index, p_prob, ndata);
+  return sampled_index;
+}
 
-  auto sample_top_p_with_filter = [&](float cuttoff) -> int64_t {
-    data.clear();
-    // filter the data with cuttoff
-    for (int64_t i = 0; i < ndata; ++i) {
-      if (p_prob[i] >= cuttoff) {
-        data.emplace_back(std::make_pair(p_prob[i], static_cast<int>(i)));
-      }
-    }
-    if (data.size() == 0) return -1;
-    auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
-      return lhs.first > rhs.first;
-    };
-    std::sort(data.begin(), data.end(), fcmp);
-
-    // short cut, if we know that
-    // uniform sample < p[0] / top_p
-    // we know that unform_sample < p[0] / top_p_sum
-    // because top_p_sum gaurantees to be smaller than top_p
-    // so we can simply return the argmax sample
-    // without computing anything
-    if (uniform_sample < data[0].first / top_p) return data[0].second;
-
-    // compute top_p_sum
-    float cum_sum_prob = 0.0f;
-    float top_p_sum = 0.0f;
-    for (auto it = data.begin(); it != data.end(); ++it) {
-      float prob = it->first;
-      if (cum_sum_prob < top_p) {
-        top_p_sum += prob;
-      } else {
-        // we get to the right cutoff pt
-        break;
-      }
-      cum_sum_prob += prob;
-      it->first = cum_sum_prob;
-    }
-    // we find that the current total sum by the given cutoff
-    // is not sufficient to cover everything
-    // this means we might need to retry a smaller cutoff pt.
-    if (cum_sum_prob < top_p && cuttoff != 0.0f) return -1;
-
-    for (auto it = data.begin(); it != data.end(); ++it) {
-      if (uniform_sample < it->first / top_p_sum) {
-        return it->second;
-      }
-    }
-    return data[data.size() - 1].second;
-  };
-
-  auto is_all_nan = [&]() -> bool {
-    return std::all_of(p_prob, p_prob + ndata, [](float x) { return std::isnan(x); });
-  };
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("vm.builtin.sample_top_p_from_prob", SampleTopPFromProb);
+}
 
-  if (top_p < 1) {
-    // sample through cutoff by a number
-    // by pigeonhole principle we will get at most 1024 elements
-    // usually it is much less by applying this filtering(order of 10 - 20)
-    data.reserve(128);
-    int64_t sampled_index = sample_top_p_with_filter(top_p / 1024);
-    if (sampled_index >= 0) return sampled_index;
+/*!
+ * \brief Batched top-p sampling from probabilities or logits.
+ * Rows are sampled in parallel with the runtime threading backend.
+ * \param input The probabilities or logits of shape (batch_size, vocab_size).
+ * \param temperature The temperature of each row of shape (batch_size,), or
+ * std::nullopt when the input is already probabilities.
+ * \param top_p The top-p value of each row of shape (batch_size,).
+ * \param uniform_sample The uniform sample of each row of shape (batch_size,).
+ * \return The sampled indices of shape (batch_size, 1).
+ */
+Tensor BatchSampleTopP(Tensor input, ffi::Optional<Tensor> temperature, Tensor top_p,
+                       Tensor uniform_sample) {
+  input = GetFloat32TensorOnCPU(input);
+  top_p = GetFloat32TensorOnCPU(top_p);
+  uniform_sample = GetFloat32TensorOnCPU(uniform_sample);
+  if (temperature.defined()) {
+    temperature = GetFloat32TensorOnCPU(temperature.value());
   }
-  // fallback via full prob, rare case
-  data.reserve(ndata);
-  int64_t sampled_index = sample_top_p_with_filter(0.0f);
-  if (sampled_index < 0 && is_all_nan()) {
-    LOG(FATAL) << "The output probabilities are all NaNs, can not sample from it";
-  } else if (sampled_index < 0) {
-    LOG(FATAL) << "Cannot sample from the given probability distribution due to unknown reason";
+  ICHECK_EQ(input->ndim, 2) << "The input of batched sampling must be 2-dimensional";
+
+  int64_t batch_size = input->shape[0];
+  int64_t vocab_size = input->shape[1];
+  ICHECK_EQ(top_p.Shape()->Product(), batch_size);
+  ICHECK_EQ(uniform_sample.Shape()->Product(), batch_size);
+  const float* pinput = static_cast<float*>(input->data);
+  const float* ptop_p = static_cast<float*>(top_p->data);
+  const float* psample = static_cast<float*>(uniform_sample->data);
+  const float* ptemperature = nullptr;
+  if (temperature.defined()) {
+    ICHECK_EQ(temperature.value().Shape()->Product(), batch_size);
+    ptemperature = static_cast<float*>(temperature.value()->data);
   }
-  return sampled_index;
+
+  Tensor result = Tensor::Empty({batch_size, 1}, DataType::Int(64), DLDevice{kDLCPU, 0});
+  int64_t* presult = static_cast<int64_t*>(result->data);
+  // Errors are reported after the parallel loop, outside of the worker threads.
+  parallel_for_with_threading_backend(
+      [&](int64_t i) {
+        const float* row = pinput + i * vocab_size;
+        std::vector<std::pair<float, int>> data;
+        if (ptemperature != nullptr) {
+          std::vector<float> prob(vocab_size);
+          presult[i] = SampleTopPFromLogitsRow(row, vocab_size, ptemperature[i], ptop_p[i],
+                                               psample[i], prob.data(), &data);
+        } else {
+          presult[i] = SampleTopPFromProbRow(row, vocab_size, ptop_p[i], psample[i], &data);
+        }
+      },
+      0, batch_size);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    CheckSampledIndex(presult[i], pinput + i * vocab_size, vocab_size);
+  }
+  return result;
 }
 
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
-  refl::GlobalDef().def("vm.builtin.sample_top_p_from_prob", SampleTopPFromProb);
+  refl::GlobalDef()
+      .def("vm.builtin.batch_sample_top_p_from_logits",
+           [](Tensor logits, Tensor temperature, Tensor top_p, Tensor uniform_sample) {
+             return BatchSampleTopP(logits, temperature, top_p, uniform_sample);
+           })
+      .def("vm.builtin.batch_sample_top_p_from_prob",
+           [](Tensor prob, Tensor top_p, Tensor uniform_sample) {
+             return BatchSampleTopP(prob, std::nullopt, top_p, uniform_sample);
+           });
 }
 
 Tensor MultinomialFromUniform(Tensor prob, Tensor uniform_sample) {
@@ -542,18 +620,21 @@ Tensor MultinomialFromUniform(Tensor prob, Tensor uniform_sample) {
   const float* psample = static_cast<float*>(uniform_sample->data);
   Tensor new_array = Tensor::Empty({batch_size, 1}, DataType::Int(64), uniform_sample->device);
   int64_t* parray = static_cast<int64_t*>(new_array->data);
-  for (int64_t i = 0; i < batch_size; ++i) {
-    float cum_sum_prob = 0.0f;
-    int64_t prob_idx = 0;
-    for (int64_t j = 0; j < vocab_size; ++j) {
-      prob_idx = j;
-      cum_sum_prob += pprob[i * vocab_size + j];
-      if (cum_sum_prob > psample[i]) {
-        break;
-      }
-    }
-    parray[i] = prob_idx;
-  }
+  // Rows are independent, so they are processed in parallel like the batched top-p sampler.
+  parallel_for_with_threading_backend(
+      [&](int64_t i) {
+        float cum_sum_prob = 0.0f;
+        int64_t prob_idx = 0;
+        for (int64_t j = 0; j < vocab_size; ++j) {
+          prob_idx = j;
+          cum_sum_prob += pprob[i * vocab_size + j];
+          if (cum_sum_prob > psample[i]) {
+            break;
+          }
+        }
+        parray[i] = prob_idx;
+      },
+      0, batch_size);
   return new_array;
 }
 
@@ -627,6 +708,62 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                         ApplyPresenceAndFrequencyPenalty);
 }
 
+/*!
+ * \brief Apply the packed token bitmasks of grammar-constrained decoding to the logits.
+ * This is an inplace operation. The logits of the tokens whose bit is unset become the lowest
+ * float, rather than -inf, so that a fully masked row does not turn softmax into NaN.
+ * \param logits The logits of shape (batch_size, vocab_size).
+ * \param seq_ids The rows of logits to mask, of shape (num_seqs,).
+ * \param bitmask The packed bitmasks of shape (batch_size, ceildiv(vocab_size, 32)), where the
+ * bit (v % 32) of bitmask[i, v / 32] tells whether the token v is allowed in the row i.
+ * \note The device counterpart is relax.backend.gpu_generic.gpu_apply_bitmask_inplace, which
+ * has the same signature and keeps the mask on device.
+ */
+void ApplyBitmaskInplace(Tensor logits, Tensor seq_ids, Tensor bitmask) {
+  ICHECK(logits.IsContiguous());
+  ICHECK(seq_ids.IsContiguous());
+  ICHECK(bitmask.IsContiguous());
+  ICHECK(logits.DataType() == DataType::Float(32)) << "Logits data type is not float32!";
+  ICHECK(seq_ids.DataType() == DataType::Int(32)) << "seq ids must be int32!";
+  ICHECK(bitmask.DataType() == DataType::Int(32)) << "bitmask must be int32!";
+  ICHECK(logits->device.device_type == kDLCPU) << "logits device must be CPU!";
+  ICHECK(seq_ids->device.device_type == kDLCPU) << "seq_ids device must be CPU!";
+  ICHECK(bitmask->device.device_type == kDLCPU) << "bitmask device must be CPU!";
+  ICHECK_EQ(logits->ndim, 2);
+  ICHECK_EQ(bitmask->ndim, 2);
+  int64_t batch_size = logits->shape[0];
+  int64_t vocab_size = logits->shape[1];
+  int64_t num_words = bitmask->shape[1];
+  ICHECK_EQ(bitmask->shape[0], batch_size);
+  ICHECK_EQ(num_words, (vocab_size + 31) / 32);
+
+  float* logits_raw_data = static_cast<float*>(logits->data);
+  const int* seq_ids_data = static_cast<const int*>(seq_ids->data);
+  const uint32_t* bitmask_data = static_cast<const uint32_t*>(bitmask->data);
+  int64_t num_seqs = seq_ids->shape[seq_ids->ndim - 1];
+  for (int64_t i = 0; i < num_seqs; ++i) {
+    int64_t row = seq_ids_data[i];
+    ICHECK(row >= 0 && row < batch_size) << "seq id " << row << " is out of range!";
+    float* row_logits = logits_raw_data + row * vocab_size;
+    const uint32_t* row_bitmask = bitmask_data + row * num_words;
+    for (int64_t w = 0; w < num_words; ++w) {
+      uint32_t word = row_bitmask[w];
+      if (word == 0xFFFFFFFFu) continue;
+      int64_t end = std::min<int64_t>(32, vocab_size - w * 32);
+      for (int64_t b = 0; b < end; ++b) {
+        if (((word >> b) & 1) == 0) {
+          row_logits[w * 32 + b] = std::numeric_limits<float>::lowest();
+        }
+      }
+    }
+  }
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("vm.builtin.apply_bitmask_inplace", ApplyBitmaskInplace);
+}
+
 // This is an inplace operation.
 void ApplySoftmaxWithTemperature(Tensor logits, double temperature) {
   ICHECK(logits.IsContiguous());
@@ -0,0 +1,344 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/lora_adapter_pool.cc
+ * \brief Runtime pool of LoRA adapter weights for serving a batch mixing adapters.
+ *
+ * The pool keeps the weights of the registered adapters on the host, and the
+ * weights of up to `num_slots` adapters resident on device, each weight in a
+ * `(num_slots, *weight_shape)` array. Since the slot dimension is outermost,
+ * the arrays are the grouped weights of `cutlass.group_gemm`, with one group
+ * per slot. For each forward, the pool makes the adapters of the batch resident,
+ * evicting the least recently used ones, and groups the tokens by slot: the
+ * model gathers its input rows by the token permutation, runs the grouped GEMMs
+ * over the weight arrays with the segment indptr, and scatters the rows back.
+ */
+#include <tvm/ffi/container/array.h>
+#include <tvm/ffi/container/map.h>
+#include <tvm/ffi/container/shape.h>
+#include <tvm/ffi/memory.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/tensor.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+//-----------------------------------------------------------------------------
+// We keep the implementation private as they may subject to future changes.
+//
+// Users can interact with it through the runtime API function calls
+//-----------------------------------------------------------------------------
+
+class LoRAAdapterPoolObj : public Object {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param num_slots The number of adapters resident on device at a time.
+   * \param weight_shapes The shapes of the weights of an adapter.
+   * \param dtype The dtype of the weights.
+   * \param device The device of the resident weights.
+   */
+  explicit LoRAAdapterPoolObj(int64_t num_slots, ffi::Array<ffi::Shape> weight_shapes,
+                              DLDataType dtype, Device device)
+      : num_slots_(num_slots), weight_shapes_(std::move(weight_shapes)), device_(device) {
+    for (const ffi::Shape& shape : weight_shapes_) {
+      std::vector<int64_t> pool_shape{num_slots};
+      pool_shape.insert(pool_shape.end(), shape.begin(), shape.end());
+      weight_pools_.push_back(Tensor::Empty(pool_shape, dtype, device));
+    }
+    adapter_of_slot_.assign(num_slots, -1);
+    last_used_step_of_slot_.assign(num_slots, -1);
+    segment_indptr_device_ = Tensor::Empty({num_slots}, DataType::Int(64), device);
+  }
+
+  /************** Adapter Management **************/
+
+  /*!
+   * \brief Register the weights of an adapter. The weights are uploaded to device
+   * on the first forward of the adapter.
+   */
+  void AddAdapter(int64_t adapter_id, ffi::Array<Tensor> weights) {
+    CHECK_GE(adapter_id, 0) << "The adapter id cannot be negative.";
+    CHECK(host_adapters_.find(adapter_id) == host_adapters_.end())
+        << "The adapter " << adapter_id << " is already in the LoRA adapter pool.";
+    CHECK_EQ(weights.size(), weight_shapes_.size())
+        << "The adapter " << adapter_id << " has " << weights.size() << " weights, while the pool "
+        << "expects " << weight_shapes_.size() << ".";
+    for (int i = 0; i < static_cast<int>(weights.size()); ++i) {
+      ffi::Shape shape = weights[i].Shape();
+      CHECK(std::equal(shape.begin(), shape.end(), weight_shapes_[i].begin(),
+                       weight_shapes_[i].end()))
+          << "The weight " << i << " of adapter " << adapter_id << " has shape " << shape
+          << ", while the pool expects " << weight_shapes_[i] << ".";
+      CHECK(DataType(weights[i]->dtype) == DataType(weight_pools_[i]->dtype))
+          << "The weight " << i << " of adapter " << adapter_id << " has dtype "
+          << DataType(weights[i]->dtype) << ", while the pool expects "
+          << DataType(weight_pools_[i]->dtype) << ".";
+    }
+    host_adapters_.insert({adapter_id, std::move(weights)});
+  }
+
+  /*! \brief Remove an adapter, releasing its slot if it is resident. */
+  void RemoveAdapter(int64_t adapter_id) {
+    auto it = host_adapters_.find(adapter_id);
+    CHECK(it != host_adapters_.end())
+        << "The adapter " << adapter_id << " cannot be found in the LoRA adapter pool.";
+    host_adapters_.erase(it);
+    auto it_slot = slot_of_adapter_.find(adapter_id);
+    if (it_slot != slot_of_adapter_.end()) {
+      adapter_of_slot_[it_slot->second] = -1;
+      last_used_step_of_slot_[it_slot->second] = -1;
+      slot_of_adapter_.erase(it_slot);
+    }
+  }
+
+  /************** Interaction **************/
+
+  /*!
+   * \brief Make the adapters of the incoming forward resident, and group its tokens by slot.
+   * \param adapter_ids The adapter of each sequence in the batch, or -1 for no adapter.
+   * \param append_lengths The number of tokens of each sequence in the batch.
+   */
+  void BeginForward(const ffi::Shape& adapter_ids, const ffi::Shape& append_lengths) {
+    CHECK_EQ(adapter_ids.size(), append_lengths.size())
+        << "The adapter_ids size (" << adapter_ids.size() << ") and append_lengths size ("
+        << append_lengths.size() << ") mismatch.";
+    ++step_;
+    // - Mark the resident adapters of the batch as used, so that they are not evicted.
+    for (int64_t adapter_id : adapter_ids) {
+      auto it_slot = slot_of_adapter_.find(adapter_id);
+      if (it_slot != slot_of_adapter_.end()) {
+        last_used_step_of_slot_[it_slot->second] = step_;
+      }
+    }
+    // - Load the other adapters of the batch.
+    std::vector<int64_t> slot_of_seq;
+    slot_of_seq.reserve(adapter_ids.size());
+    for (int64_t adapter_id : adapter_ids) {
+      slot_of_seq.push_back(adapter_id == -1 ? -1 : GetOrLoadSlot(adapter_id));
+    }
+
+    // - Group the tokens by slot with a counting sort, which keeps the order of
+    // the tokens within a slot. The tokens without adapter are placed last.
+    std::vector<int64_t> num_tokens_of_slot(num_slots_ + 1, 0);
+    int64_t total_length = 0;
+    for (int i = 0; i < static_cast<int>(append_lengths.size()); ++i) {
+      int64_t slot = slot_of_seq[i] == -1 ? num_slots_ : slot_of_seq[i];
+      num_tokens_of_slot[slot] += append_lengths[i];
+      total_length += append_lengths[i];
+    }
+    std::vector<int64_t> segment_begin(num_slots_ + 1, 0);
+    segment_indptr_host_.resize(num_slots_);
+    for (int64_t slot = 0; slot < num_slots_; ++slot) {
+      segment_indptr_host_[slot] = segment_begin[slot] + num_tokens_of_slot[slot];
+      segment_begin[slot + 1] = segment_indptr_host_[slot];
+    }
+    token_permutation_host_.resize(total_length);
+    int64_t token_offset = 0;
+    for (int i = 0; i < static_cast<int>(append_lengths.size()); ++i) {
+      int64_t slot = slot_of_seq[i] == -1 ? num_slots_ : slot_of_seq[i];
+      for (int64_t j = 0; j < append_lengths[i]; ++j) {
+        token_permutation_host_[segment_begin[slot]++] = static_cast<int32_t>(token_offset + j);
+      }
+      token_offset += append_lengths[i];
+    }
+
+    // - Copy the grouping to device.
+    if (!token_permutation_device_.defined() ||
+        token_permutation_device_->shape[0] < total_length) {
+      int64_t capacity = token_permutation_device_.defined() ? token_permutation_device_->shape[0]
+                                                             : 1;
+      while (capacity < total_length) {
+        capacity *= 2;
+      }
+      token_permutation_device_ = Tensor::Empty({capacity}, DataType::Int(32), device_);
+    }
+    token_permutation_view_ =
+        token_permutation_device_.CreateView({total_length}, DataType::Int(32));
+    if (total_length > 0) {
+      CopyVecToDevice(token_permutation_host_.data(), token_permutation_view_);
+    }
+    CopyVecToDevice(segment_indptr_host_.data(), segment_indptr_device_);
+  }
+
+  /*! \brief The device array of the weight at the given index, in `(num_slots, *shape)`. */
+  Tensor GetWeightPool(int64_t weight_id) {
+    CHECK_GE(weight_id, 0);
+    CHECK_LT(weight_id, static_cast<int64_t>(weight_pools_.size()));
+    return weight_pools_[weight_id];
+  }
+
+  /*!
+   * \brief The int64 cumulative number of tokens of the slots, in the layout of the
+   * indptr of `cutlass.group_gemm`. The rows past its last element have no adapter.
+   */
+  Tensor GetSegmentIndptr() {
+    CHECK(token_permutation_view_.defined())
+        << "Please call `BeginForward` before getting the segment indptr.";
+    return segment_indptr_device_;
+  }
+
+  /*! \brief The int32 index into the batch of each token, with the tokens grouped by slot. */
+  Tensor GetTokenPermutation() {
+    CHECK(token_permutation_view_.defined())
+        << "Please call `BeginForward` before getting the token permutation.";
+    return token_permutation_view_;
+  }
+
+  /*! \brief The numbers of adapter weight uploads and evictions so far. */
+  ffi::Map<ffi::String, int64_t> GetStats() {
+    ffi::Map<ffi::String, int64_t> stats;
+    stats.Set("num_loads", num_loads_);
+    stats.Set("num_evictions", num_evictions_);
+    stats.Set("num_resident", static_cast<int64_t>(slot_of_adapter_.size()));
+    return stats;
+  }
+
+  static constexpr const bool _type_mutable = true;
+  TVM_FFI_DECLARE_OBJECT_INFO_FINAL("relax.vm.LoRAAdapterPool", LoRAAdapterPoolObj, Object);
+
+ private:
+  /*!
+   * \brief Get the slot of a registered adapter, uploading its weights into the
+   * least recently used slot if it is not resident.
+   */
+  int64_t GetOrLoadSlot(int64_t adapter_id) {
+    auto it_slot = slot_of_adapter_.find(adapter_id);
+    if (it_slot != slot_of_adapter_.end()) {
+      return it_slot->second;
+    }
+    auto it = host_adapters_.find(adapter_id);
+    CHECK(it != host_adapters_.end())
+        << "The adapter " << adapter_id << " cannot be found in the LoRA adapter pool.";
+    // - Pick a free slot, or else the least recently used one not used by the batch.
+    int64_t slot = -1;
+    for (int64_t s = 0; s < num_slots_; ++s) {
+      if (last_used_step_of_slot_[s] == step_) {
+        continue;
+      }
+      if (slot == -1 || last_used_step_of_slot_[s] < last_used_step_of_slot_[slot]) {
+        slot = s;
+      }
+    }
+    CHECK_NE(slot, -1) << "The batch uses more than " << num_slots_
+                       << " distinct adapters, which is the number of slots of the pool.";
+    if (adapter_of_slot_[slot] != -1) {
+      slot_of_adapter_.erase(adapter_of_slot_[slot]);
+      ++num_evictions_;
+    }
+    // - Upload the weights into the slot.
+    for (int i = 0; i < static_cast<int>(weight_pools_.size()); ++i) {
+      const Tensor& weight = it->second[i];
+      DLTensor copy_dst = *weight_pools_[i].operator->();
+      copy_dst.byte_offset = slot * GetDataSize(*weight.operator->());
+      copy_dst.ndim = weight->ndim;
+      copy_dst.shape = weight->shape;
+      copy_dst.strides = nullptr;
+      Tensor::CopyFromTo(weight.operator->(), &copy_dst);
+    }
+    adapter_of_slot_[slot] = adapter_id;
+    last_used_step_of_slot_[slot] = step_;
+    slot_of_adapter_[adapter_id] = slot;
+    ++num_loads_;
+    return slot;
+  }
+
+  template <typename T>
+  void CopyVecToDevice(const T* data, const Tensor& array) {
+    DLTensor copy_dst = *array.operator->();
+    DLTensor copy_src = copy_dst;
+    copy_src.data = const_cast<T*>(data);
+    copy_src.device = Device{kDLCPU, 0};
+    copy_src.byte_offset = 0;
+    Tensor::CopyFromTo(&copy_src, &copy_dst);
+  }
+
+  /*! \brief The number of adapters resident on device at a time. */
+  const int64_t num_slots_;
+  /*! \brief The shapes of the weights of an adapter. */
+  const ffi::Array<ffi::Shape> weight_shapes_;
+  /*! \brief The device of the resident weights. */
+  const Device device_;
+
+  /*! \brief The resident weights, each in `(num_slots, *weight_shape)`. */
+  std::vector<Tensor> weight_pools_;
+  /*! \brief The weights of the registered adapters. */
+  std::unordered_map<int64_t, ffi::Array<Tensor>> host_adapters_;
+  /*! \brief The mapping from resident adapters to their slots. */
+  std::unordered_map<int64_t, int64_t> slot_of_adapter_;
+  /*! \brief The adapter of each slot, or -1 if the slot is free. */
+  std::vector<int64_t> adapter_of_slot_;
+  /*! \brief The last forward step using each slot, for the LRU eviction. */
+  std::vector<int64_t> last_used_step_of_slot_;
+  /*! \brief The number of forward steps so far. */
+  int64_t step_ = 0;
+  int64_t num_loads_ = 0;
+  int64_t num_evictions_ = 0;
+
+  std::vector<int64_t> segment_indptr_host_;
+  std::vector<int32_t> token_permutation_host_;
+  Tensor segment_indptr_device_;
+  Tensor token_permutation_device_;
+  Tensor token_permutation_view_;
+};
+
+class LoRAAdapterPool : public ObjectRef {
+ public:
+  TVM_FFI_DEFINE_OBJECT_REF_METHODS_NULLABLE(LoRAAdapterPool, ObjectRef, LoRAAdapterPoolObj);
+};
+
+//-------------------------------------------------
+//  Register runtime functions
+//-------------------------------------------------
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("vm.builtin.lora_adapter_pool_create",
+           [](int64_t num_slots, ffi::Array<ffi::Shape> weight_shapes, DLDataType dtype,
+              Device device) {
+             CHECK_GT(num_slots, 0) << "The number of slots should be greater than 0.";
+             CHECK_GT(weight_shapes.size(), 0) << "An adapter should have at least one weight.";
+             return LoRAAdapterPool(ffi::make_object<LoRAAdapterPoolObj>(
+                 num_slots, std::move(weight_shapes), dtype, device));
+           })
+      .def_method("vm.builtin.lora_adapter_pool_add_adapter", &LoRAAdapterPoolObj::AddAdapter)
+      .def_method("vm.builtin.lora_adapter_pool_remove_adapter",
+                  &LoRAAdapterPoolObj::RemoveAdapter)
+      .def_method("vm.builtin.lora_adapter_pool_begin_forward", &LoRAAdapterPoolObj::BeginForward)
+      .def_method("vm.builtin.lora_adapter_pool_get_weight_pool",
+                  &LoRAAdapterPoolObj::GetWeightPool)
+      .def_method("vm.builtin.lora_adapter_pool_get_segment_indptr",
+                  &LoRAAdapterPoolObj::GetSegmentIndptr)
+      .def_method("vm.builtin.lora_adapter_pool_get_token_permutation",
+                  &LoRAAdapterPoolObj::GetTokenPermutation)
+      .def_method("vm.builtin.lora_adapter_pool_get_stats", &LoRAAdapterPoolObj::GetStats);
+}
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -26,9 +26,11 @@
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/tensor.h>
 
 #include <algorithm>
+#include <list>
 #include <numeric>
 #include <unordered_map>
 #include <utility>
@@ -57,6 +59,11 @@ namespace vm {
  * dimension with a configured page size.
  * - To add a sequence to the cache, use AddSequence with a provided
  * unique integer sequence id.
+ * - A sequence can commit its prefilled tokens to the prefix cache with
+ * CommitSequencePrefix. New sequences added with AddSequenceWithPrefix
+ * then share the KV pages of the longest committed token prefix, and
+ * only need to prefill the remaining tokens. Prefix cache entries are
+ * evicted in LRU order when the cache runs out of free pages.
  * - The basic example use of the paged KV cache after initialization
  * in each round of model forwarding is the following:
  *   - step 1. use `BeginForward` to specify the list of sequence ids
@@ -113,7 +120,13 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The optional RoPE extension factors for RoPE scaling. */
   const ffi::Optional<Tensor> rope_ext_factors_;
 
-  /*! \brief The KV cache dtype. */
+  /*! \brief The dtype of the input Q/K/V and output O data. */
+  const DataType qkv_dtype_;
+  /*!
+   * \brief The storage dtype of the KV pages.
+   * It may be narrower than the Q/K/V dtype (e.g., float8_e4m3fn), in which
+   * case K/V data is cast on append and cast back on read by the kernels.
+   */
   const DataType kv_dtype_;
   /*! \brief We fix int32 to be the index dtype of auxiliary data. */
   const DLDataType dtype_aux_ = DLDataType(DataType::Int(32, 1));
@@ -131,6 +144,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   std::vector<Tensor> pages_;
   /*! \brief The whole KV cache allocated by NVSHMEM*/
   Tensor nvshmem_pages_;
+  /*!
+   * \brief The per-layer counters of the KV transfers received, allocated by NVSHMEM.
+   * Each sender increments the counter of a layer on its recvers once their KV data of the
+   * layer has been put, so that the recver polls the progress of the transfer.
+   */
+  Tensor nvshmem_recv_counters_;
   /*! \brief The list of ids of released pages for page reuse. */
   std::vector<int32_t> free_page_ids_;
   /*! \brief The mapping from sequence ids to sequences. */
@@ -143,6 +162,48 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The list of free available blocks (in their indices). */
   std::vector<int32_t> free_block_idx_;
 
+  /********************* Prefix Cache Structures *********************/
+
+  /*!
+   * \brief The prefix cache entry.
+   * Each entry is a hidden sequence in `seq_map_` forked from a committed
+   * sequence. It keeps the blocks of the committed KV data referenced, so
+   * that the pages stay alive after the committed sequence is removed.
+   */
+  struct PrefixCacheEntry {
+    /*! \brief The token ids whose KV data the entry holds. */
+    std::vector<int64_t> tokens;
+    /*! \brief The position of the entry in the LRU list. */
+    std::list<int64_t>::iterator lru_it;
+    /*! \brief Whether the entry is being forked from, and thus cannot be evicted. */
+    bool pinned = false;
+  };
+  /*! \brief The radix tree mapping committed token prefixes to prefix cache entries. */
+  PrefixRadixTree prefix_tree_;
+  /*! \brief The mapping from the hidden sequence ids to prefix cache entries. */
+  std::unordered_map<int64_t, PrefixCacheEntry> prefix_cache_entries_;
+  /*! \brief The hidden sequence ids of prefix cache entries, most recently used first. */
+  std::list<int64_t> prefix_cache_lru_;
+  /*! \brief The hidden sequence id for the next prefix cache entry. */
+  int64_t next_prefix_cache_seq_id_ = kPrefixCacheSeqIdBegin;
+
+  /********************* Offloading Structures *********************/
+
+  /*! \brief The KV data of an offloaded sequence, swapped out to host memory. */
+  struct OffloadedSequence {
+    /*! \brief The indices of the offloaded blocks, and the number of pages each block had. */
+    std::vector<std::pair<int32_t, int32_t>> blocks;
+    /*! \brief The host copy of the offloaded pages, one tensor per layer. */
+    std::vector<Tensor> host_pages;
+  };
+  /*! \brief The mapping from sequence ids to their offloaded KV data. */
+  std::unordered_map<int64_t, OffloadedSequence> offloaded_seq_map_;
+  /*!
+   * \brief The host buffers read by the prefetch copies in flight.
+   * They are released once the copy stream is synchronized.
+   */
+  std::vector<Tensor> pending_prefetch_host_pages_;
+
   /*********** Current Batch Info & Auxiliary Arrays on Device ***********/
   //-------------------------------------------
   // The following fields are auxiliary arrays on device.
@@ -169,6 +230,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   bool append_before_attn_;
   /*! \brief Whether to use decode kernel for each depth. (see GetChunkedBlockIds) */
   std::vector<bool> use_decode_kernel_;
+  /*!
+   * \brief For each depth, the number of leading decode entries of a mixed prefill/decode
+   * batch that run with the decode kernel, while the other entries run with the prefill
+   * kernel. Zero means the depth runs with a single kernel.
+   */
+  std::vector<int64_t> num_decode_entries_on_depths_;
   /*! \brief Whether the attention request is a decode request, set in BeginForwardFunction. */
   bool is_decode_request_;
   /*! \brief The KV transfer recver disco group's PE offset in this forward.
@@ -184,6 +251,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   Tensor temp_attn_q_device_;
   Tensor temp_attn_k_device_;
   Tensor temp_attn_v_device_;
+  /*!
+   * \brief The second K/V buffers, used by the odd layers when transferring KV, so that the
+   * transfer of a layer overlaps with the computation of the next one.
+   */
+  Tensor temp_attn_k_alt_device_;
+  Tensor temp_attn_v_alt_device_;
   Tensor temp_attn_output_device_;
   Tensor temp_attn_lse_device_;
   Tensor merged_attn_lse_device_;
@@ -219,6 +292,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   HostMemoryVector kv_transfer_page_to_page_local_position_map_host_;
   HostMemoryVector kv_transfer_page_to_page_remote_position_map_host_;
   HostMemoryVector kv_transfer_page_to_page_recver_id_host_;
+  /*! \brief The distinct recver disco group's PE offsets of the KV transfer in this forward. */
+  std::vector<int64_t> kv_transfer_recver_groups_;
 
   //-------------------------------------------
   // For efficient memory management, the actual sizes of the arrays
@@ -255,6 +330,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   ffi::Optional<ffi::Function> f_transpose_append_mla_;
   ffi::Optional<ffi::Function> f_transfer_kv_;
   ffi::Optional<ffi::Function> f_transfer_kv_page_to_page_ = std::nullopt;
+  ffi::Optional<ffi::Function> f_transfer_kv_notify_ = std::nullopt;
   ffi::Function f_compact_copy_;
   std::unique_ptr<RaggedPrefillFunc> f_attention_prefill_ragged_;
   std::unique_ptr<PagedPrefillFunc> f_attention_prefill_;
@@ -287,7 +363,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       int64_t num_total_pages, int64_t prefill_chunk_size, bool support_sliding_window,
       RoPEMode rope_mode, double rotary_scale, double rotary_theta,
       ffi::Optional<Tensor> rope_ext_factors, bool enable_kv_transfer, DLDataType dtype,
-      Device device, ffi::Optional<ffi::Function> f_transpose_append_mha,
+      DLDataType kv_dtype, Device device, ffi::Optional<ffi::Function> f_transpose_append_mha,
       ffi::Optional<ffi::Function> f_transpose_append_mla, ffi::Function f_compact_copy,
       std::unique_ptr<RaggedPrefillFunc> f_attention_prefill_ragged,
       std::unique_ptr<PagedPrefillFunc> f_attention_prefill,
@@ -320,7 +396,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         rotary_scale_(rotary_scale),
         rotary_theta_(rotary_theta),
         rope_ext_factors_(std::move(rope_ext_factors)),
-        kv_dtype_(DataType(dtype)),
+        qkv_dtype_(DataType(dtype)),
+        kv_dtype_(DataType(kv_dtype)),
         f_transpose_append_mha_(std::move(f_transpose_append_mha)),
         f_transpose_append_mla_(std::move(f_transpose_append_mla)),
         f_compact_copy_(std::move(f_compact_copy)),
@@ -338,6 +415,16 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         f_copy_single_page_(std::move(f_copy_single_page)),
         f_debug_get_kv_(std::move(f_debug_get_kv)),
         device_(device) {
+    // Only TIR kernels support KV pages stored in a dtype different from Q/K/V.
+    if (kv_dtype_ != qkv_dtype_) {
+      std::vector<AttnBackendFunc*> funcs = {f_attention_prefill_.get(), f_attention_decode_.get(),
+                                             f_mla_prefill_.get()};
+      for (AttnBackendFunc* func : funcs) {
+        CHECK(func == nullptr || func->backend_kind == AttnBackendKind::kTIR)
+            << "The KV storage dtype " << kv_dtype_ << " differs from the Q/K/V dtype "
+            << qkv_dtype_ << ", which is only supported by TIR attention kernels.";
+      }
+    }
     // Note: For MLA, sliding window and disaggregation are disabled for now.
     if (std::find(attn_kinds_.begin(), attn_kinds_.end(), AttnKind::kMLA) != attn_kinds_.end()) {
       CHECK(!support_sliding_window_) << "Sliding window not supported yet for MLA";
@@ -359,7 +446,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       nvshmem_pages_ =
           (*f_nvshmem_empty)(
               ffi::Shape({num_layers, num_total_pages, 2, num_kv_heads, page_size, qk_head_dim}),
-              dtype, device)
+              kv_dtype, device)
               .cast<Tensor>();
       for (int i = 0; i < num_layers; ++i) {
         pages_.push_back(nvshmem_pages_.CreateView(
@@ -368,19 +455,29 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
                 nvshmem_pages_.DataType().bytes()));
       }
 
+      nvshmem_recv_counters_ =
+          (*f_nvshmem_empty)(ffi::Shape({num_layers}), DataType::UInt(64), device).cast<Tensor>();
+      Tensor zero_counters = Tensor::Empty({num_layers}, DataType::UInt(64), Device{kDLCPU, 0});
+      std::fill_n(static_cast<uint64_t*>(zero_counters->data), num_layers, 0);
+      nvshmem_recv_counters_.CopyFrom(zero_counters);
+
       const auto f_transfer_kv_ptr = tvm::ffi::Function::GetGlobal("nvshmem.KVTransfer");
       const auto f_transfer_kv_page_to_page_ptr =
           tvm::ffi::Function::GetGlobal("nvshmem.KVTransferPageToPage");
+      const auto f_transfer_kv_notify_ptr =
+          tvm::ffi::Function::GetGlobal("nvshmem.KVTransferNotify");
       ICHECK(f_transfer_kv_ptr.has_value());
       ICHECK(f_transfer_kv_page_to_page_ptr.has_value());
+      ICHECK(f_transfer_kv_notify_ptr.has_value());
       f_transfer_kv_ = *f_transfer_kv_ptr;
       f_transfer_kv_page_to_page_ = *f_transfer_kv_page_to_page_ptr;
+      f_transfer_kv_notify_ = *f_transfer_kv_notify_ptr;
     } else {
       for (int i = 0; i < num_layers; ++i) {
         ffi::Shape kv_cache_shape =
             GetKVCacheShape(attn_kinds_[layer_id_begin_offset_ + i], num_total_pages,
                             reserved_num_seqs, num_kv_heads, page_size, qk_head_dim, v_head_dim);
-        pages_.push_back(Tensor::Empty(kv_cache_shape, dtype, device));
+        pages_.push_back(Tensor::Empty(kv_cache_shape, kv_dtype, device));
       }
     }
 
@@ -476,6 +573,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
           Tensor::Empty({prefill_chunk_size_, num_kv_heads, qk_head_dim}, dtype, device);
       temp_attn_v_device_ =
           Tensor::Empty({prefill_chunk_size_, num_kv_heads, v_head_dim}, dtype, device);
+      if (enable_kv_transfer) {
+        temp_attn_k_alt_device_ =
+            Tensor::Empty({prefill_chunk_size_, num_kv_heads, qk_head_dim}, dtype, device);
+        temp_attn_v_alt_device_ =
+            Tensor::Empty({prefill_chunk_size_, num_kv_heads, v_head_dim}, dtype, device);
+      }
     }
     temp_attn_output_device_ =
         Tensor::Empty({prefill_chunk_size_, num_qo_heads, v_head_dim}, dtype, device);
@@ -519,6 +622,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   ~PagedAttentionKVCacheObj() {
+    SyncHostPageCopies();
     // Free the copy stream if defined.
     if (copy_stream_ != nullptr) {
       DeviceAPI::Get(device_)->FreeStream(device_, copy_stream_);
@@ -537,6 +641,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
     global_block_pool_.clear();
     free_block_idx_.clear();
+    prefix_tree_.Clear();
+    prefix_cache_entries_.clear();
+    prefix_cache_lru_.clear();
+    SyncHostPageCopies();
+    offloaded_seq_map_.clear();
+    pending_prefetch_host_pages_.clear();
     dirty_aux_data_device_ = false;
   }
 
@@ -569,6 +679,13 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       ICHECK_GT(global_block_pool_[block_idx].external_ref_cnt, 1);
       --global_block_pool_[block_idx].external_ref_cnt;
     }
+    // - The offloaded blocks have no pages, so only the host copy is released,
+    // once its offload copy is done.
+    auto offloaded_it = offloaded_seq_map_.find(seq_id);
+    if (offloaded_it != offloaded_seq_map_.end()) {
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+      offloaded_seq_map_.erase(offloaded_it);
+    }
     seq_map_.erase(it);
     dirty_aux_data_device_ = true;
   }
@@ -586,6 +703,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     CHECK(parent_it->second.accepted_indices_committed)
         << "The parent sequence's token tree computed in the last round of forward has not been "
            "committed with accepted nodes.";
+    CheckSequenceNotOffloaded(parent_seq_id);
 
     if (fork_pos == -1) {
       fork_pos = parent_it->second.seq_length;
@@ -772,6 +890,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
 
+    CheckSequenceNotOffloaded(seq_id);
     CHECK_GE(n, 0) << "The length of popping " << n << " cannot be negative.";
     CHECK_LE(n, it->second.seq_length)
         << "The sequence only has length " << it->second.seq_length
@@ -828,6 +947,307 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     dirty_aux_data_device_ = true;
   }
 
+  /************** Prefix Cache **************/
+
+  void CommitSequencePrefix(int64_t seq_id, const IntTuple& token_ids) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK(prefix_cache_entries_.find(seq_id) == prefix_cache_entries_.end())
+        << "Cannot commit a prefix cache entry to the prefix cache.";
+    CheckSequenceNotOffloaded(seq_id);
+    CHECK_LE(static_cast<int64_t>(token_ids.size()), it->second.seq_length)
+        << "The number of committed tokens " << token_ids.size()
+        << " exceeds the length of sequence \"" << seq_id << "\", which is "
+        << it->second.seq_length << ".";
+    if (it->second.sliding_window_size != -1) {
+      // Sequences with sliding window enabled cannot be forked beyond the sink.
+      return;
+    }
+    // Only commit full pages. The trailing partial page may still be
+    // appended by the sequence, and sharing it would require a page copy.
+    int64_t commit_length = static_cast<int64_t>(token_ids.size()) / page_size_ * page_size_;
+    if (commit_length == 0) {
+      return;
+    }
+    std::vector<int64_t> tokens(token_ids.begin(), token_ids.begin() + commit_length);
+    int64_t existing_seq_id = prefix_tree_.Lookup(tokens);
+    if (existing_seq_id != -1) {
+      TouchPrefixCacheEntry(existing_seq_id);
+      return;
+    }
+
+    int64_t entry_seq_id = next_prefix_cache_seq_id_++;
+    ForkSequence(seq_id, entry_seq_id, commit_length);
+    prefix_tree_.Insert(tokens, entry_seq_id);
+    prefix_cache_lru_.push_front(entry_seq_id);
+    PrefixCacheEntry entry;
+    entry.tokens = std::move(tokens);
+    entry.lru_it = prefix_cache_lru_.begin();
+    prefix_cache_entries_.emplace(entry_seq_id, std::move(entry));
+  }
+
+  int64_t MatchPrefix(const IntTuple& token_ids) const final {
+    std::vector<int64_t> tokens(token_ids.begin(), token_ids.end());
+    int64_t matched_length = prefix_tree_.MatchPrefix(tokens).first;
+    matched_length = std::min<int64_t>(matched_length, static_cast<int64_t>(tokens.size()) - 1);
+    return std::max<int64_t>(matched_length, 0);
+  }
+
+  int64_t AddSequenceWithPrefix(int64_t seq_id, const IntTuple& token_ids) final {
+    CHECK(seq_map_.find(seq_id) == seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    std::vector<int64_t> tokens(token_ids.begin(), token_ids.end());
+    auto [matched_length, entry_seq_id] = prefix_tree_.MatchPrefix(tokens);
+    // Leave at least one token to prefill, which produces the logits of the last token.
+    matched_length = std::min<int64_t>(matched_length, static_cast<int64_t>(tokens.size()) - 1);
+    if (matched_length <= 0) {
+      AddSequence(seq_id);
+      return 0;
+    }
+
+    TouchPrefixCacheEntry(entry_seq_id);
+    PrefixCacheEntry& entry = prefix_cache_entries_.at(entry_seq_id);
+    // Forking within a page allocates a new page, which must not evict the forked entry.
+    entry.pinned = true;
+    ForkSequence(entry_seq_id, seq_id, matched_length);
+    entry.pinned = false;
+    return matched_length;
+  }
+
+  int32_t EvictPrefixCache(int32_t num_pages) final {
+    size_t num_free_pages_before = free_page_ids_.size();
+    while ((num_pages == -1 ||
+            free_page_ids_.size() < num_free_pages_before + static_cast<size_t>(num_pages)) &&
+           EvictLRUPrefixCacheEntry()) {
+    }
+    return free_page_ids_.size() - num_free_pages_before;
+  }
+
+  /************** Offloading **************/
+
+  void OffloadSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK(prefix_cache_entries_.find(seq_id) == prefix_cache_entries_.end())
+        << "Cannot offload a prefix cache entry.";
+    CHECK(offloaded_seq_map_.find(seq_id) == offloaded_seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already offloaded.";
+    CHECK(it->second.accepted_indices_committed)
+        << "The sequence's token tree computed in the last round of forward has not been "
+           "committed with accepted nodes.";
+    for (AttnKind attn_kind : attn_kinds_) {
+      CHECK(attn_kind != AttnKind::kLinearAttn)
+          << "Offloading is not supported for KV cache with linear attention layers.";
+    }
+
+    // Only the blocks exclusively owned by the sequence are offloaded.
+    // The shared prefix blocks stay on device for the other sequences.
+    OffloadedSequence offloaded;
+    std::vector<int32_t> page_ids;
+    int32_t block_idx = it->second.last_block_idx;
+    while (block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1) {
+      const Block& block = global_block_pool_[block_idx];
+      for (int32_t page_id : block.page_ids) {
+        ICHECK_NE(page_id, kPagedKVCacheTempPageId);
+        page_ids.push_back(page_id);
+      }
+      offloaded.blocks.emplace_back(block_idx, block.page_ids.size());
+      block_idx = block.parent_idx;
+    }
+    if (page_ids.empty()) {
+      return;
+    }
+
+    Device host_device = GetPreferredHostDevice(device_);
+    offloaded.host_pages.reserve(num_layers_);
+    for (int layer = 0; layer < num_layers_; ++layer) {
+      std::vector<int64_t> shape(pages_[layer].Shape().begin(), pages_[layer].Shape().end());
+      shape[0] = page_ids.size();
+      offloaded.host_pages.push_back(Tensor::Empty(shape, pages_[layer]->dtype, host_device));
+    }
+    // The copy stream must observe all the KV data the compute stream wrote into the pages.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    CopyPagesWithHost(page_ids, offloaded.host_pages, /*to_host=*/true);
+
+    // Release the device pages. The next BeginForward makes the compute
+    // stream wait for the copy stream before the pages get overwritten.
+    for (const auto& [offloaded_block_idx, num_pages] : offloaded.blocks) {
+      global_block_pool_[offloaded_block_idx].page_ids.clear();
+    }
+    free_page_ids_.insert(free_page_ids_.end(), page_ids.rbegin(), page_ids.rend());
+    offloaded_seq_map_.emplace(seq_id, std::move(offloaded));
+    dirty_aux_data_device_ = true;
+  }
+
+  void PrefetchSequence(int64_t seq_id) final {
+    auto it = offloaded_seq_map_.find(seq_id);
+    if (it == offloaded_seq_map_.end()) {
+      CHECK(seq_map_.find(seq_id) != seq_map_.end())
+          << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+      return;
+    }
+    OffloadedSequence& offloaded = it->second;
+    int64_t num_pages = offloaded.host_pages[0]->shape[0];
+    if (static_cast<int64_t>(free_page_ids_.size()) < num_pages) {
+      EvictPrefixCache(num_pages - free_page_ids_.size());
+    }
+    CHECK_GE(static_cast<int64_t>(free_page_ids_.size()), num_pages)
+        << "The KV cache is full. Cannot prefetch the " << num_pages
+        << " pages of sequence \"" << seq_id << "\".";
+
+    std::vector<int32_t> page_ids;
+    page_ids.reserve(num_pages);
+    for (const auto& [block_idx, num_block_pages] : offloaded.blocks) {
+      Block& block = global_block_pool_[block_idx];
+      ICHECK(block.page_ids.empty());
+      for (int32_t i = 0; i < num_block_pages; ++i) {
+        block.page_ids.push_back(GetFreePage());
+        page_ids.push_back(block.page_ids.back());
+      }
+    }
+    // The copy is asynchronous on the copy stream, and is waited for
+    // by the compute stream in the next BeginForward.
+    CopyPagesWithHost(page_ids, offloaded.host_pages, /*to_host=*/false);
+    pending_prefetch_host_pages_.insert(pending_prefetch_host_pages_.end(),
+                                        offloaded.host_pages.begin(), offloaded.host_pages.end());
+    offloaded_seq_map_.erase(it);
+    dirty_aux_data_device_ = true;
+  }
+
+  /************** Defragmentation **************/
+
+  IntTuple GetPageFragmentation() const final {
+    std::vector<bool> is_free(num_total_pages_, false);
+    for (int32_t page_id : free_page_ids_) {
+      is_free[page_id] = true;
+    }
+    int64_t num_free_runs = 0;
+    int64_t max_free_run = 0;
+    int64_t free_run = 0;
+    for (int64_t page_id = 0; page_id < num_total_pages_; ++page_id) {
+      if (!is_free[page_id]) {
+        free_run = 0;
+        continue;
+      }
+      if (free_run == 0) {
+        ++num_free_runs;
+      }
+      max_free_run = std::max(max_free_run, ++free_run);
+    }
+    int64_t num_page_breaks = 0;
+    for (const auto& [seq_id, seq] : seq_map_) {
+      int32_t prev_page_id = -1;
+      for (int32_t block_idx : seq.GetBlockTrace(global_block_pool_)) {
+        for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
+          if (page_id == kPagedKVCacheTempPageId) {
+            continue;
+          }
+          if (prev_page_id != -1 && page_id != prev_page_id + 1) {
+            ++num_page_breaks;
+          }
+          prev_page_id = page_id;
+        }
+      }
+    }
+    int64_t num_used_pages = num_total_pages_ - static_cast<int64_t>(free_page_ids_.size());
+    return IntTuple{num_used_pages, num_free_runs, max_free_run, num_page_breaks};
+  }
+
+  int32_t DefragmentPages() final {
+    CHECK(!f_transfer_kv_.defined())
+        << "Defragmentation is not supported for KV cache with KV transfer, whose remote "
+           "writes target fixed pages.";
+    // - Assign the new page ids, walking the sequences in the order of their ids and
+    // their blocks from the root, so that the pages of a sequence are laid out in order.
+    // The blocks shared by several sequences are laid out with the first one of them.
+    std::vector<int64_t> seq_ids;
+    seq_ids.reserve(seq_map_.size());
+    for (const auto& [seq_id, seq] : seq_map_) {
+      seq_ids.push_back(seq_id);
+    }
+    std::sort(seq_ids.begin(), seq_ids.end());
+    std::vector<int32_t> new_page_ids(num_total_pages_, -1);
+    std::vector<bool> is_live_block(global_block_pool_.size(), false);
+    int32_t num_used_pages = 0;
+    for (int64_t seq_id : seq_ids) {
+      for (int32_t block_idx : seq_map_.at(seq_id).GetBlockTrace(global_block_pool_)) {
+        if (is_live_block[block_idx]) {
+          continue;
+        }
+        is_live_block[block_idx] = true;
+        for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
+          if (page_id != kPagedKVCacheTempPageId && new_page_ids[page_id] == -1) {
+            new_page_ids[page_id] = num_used_pages++;
+          }
+        }
+      }
+    }
+    ICHECK_EQ(num_used_pages, num_total_pages_ - static_cast<int64_t>(free_page_ids_.size()));
+    if (num_used_pages == num_total_pages_) {
+      // No page is free, so there is nothing to gather.
+      return 0;
+    }
+
+    // - Collect the moved pages in the order of their source page, so that both the gather
+    // and the scatter below coalesce consecutive pages into a single copy.
+    std::vector<std::pair<int32_t, int32_t>> gather_moves;
+    std::vector<std::pair<int32_t, int32_t>> scatter_moves;
+    for (int32_t page_id = 0; page_id < num_total_pages_; ++page_id) {
+      if (new_page_ids[page_id] != -1 && new_page_ids[page_id] != page_id) {
+        int32_t staging_page_id = static_cast<int32_t>(gather_moves.size());
+        gather_moves.emplace_back(page_id, staging_page_id);
+        scatter_moves.emplace_back(staging_page_id, new_page_ids[page_id]);
+      }
+    }
+    if (gather_moves.empty()) {
+      return 0;
+    }
+
+    // - Copy the pages on the copy stream after the KV data the compute stream wrote into
+    // them. Each layer gathers all moved pages into a staging tensor before scattering them,
+    // so that no page is overwritten before it is read, whatever the order of the moves.
+    if (copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    {
+      std::vector<int64_t> staging_shape(pages_[0]->shape, pages_[0]->shape + pages_[0]->ndim);
+      staging_shape[0] = static_cast<int64_t>(gather_moves.size());
+      Tensor staging = Tensor::Empty(staging_shape, pages_[0]->dtype, device_);
+      for (int layer = 0; layer < num_layers_; ++layer) {
+        CopyPages(pages_[layer], staging, gather_moves);
+        CopyPages(staging, pages_[layer], scatter_moves);
+      }
+      // The staging tensor is released at the end of the scope.
+      if (copy_stream_ != nullptr) {
+        DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+      }
+    }
+
+    // - Remap the pages of the blocks, and gather the free pages after the pages in use.
+    for (size_t block_idx = 0; block_idx < global_block_pool_.size(); ++block_idx) {
+      if (!is_live_block[block_idx]) {
+        continue;
+      }
+      for (int32_t& page_id : global_block_pool_[block_idx].page_ids) {
+        if (page_id != kPagedKVCacheTempPageId) {
+          page_id = new_page_ids[page_id];
+        }
+      }
+    }
+    free_page_ids_.clear();
+    for (int32_t page_id = num_total_pages_ - 1; page_id >= num_used_pages; --page_id) {
+      free_page_ids_.push_back(page_id);
+    }
+    dirty_aux_data_device_ = true;
+    int32_t num_moved_pages = 0;
+    for (int32_t page_id = 0; page_id < num_total_pages_; ++page_id) {
+      num_moved_pages += new_page_ids[page_id] != -1 && new_page_ids[page_id] != page_id;
+    }
+    return num_moved_pages;
+  }
+
   /************** Raw Info Query **************/
 
   bool Empty() const final {
@@ -841,6 +1261,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   int32_t GetTotalSequenceLength() const final {
     int32_t total_seq_len = 0;
     for (const auto& it : seq_map_) {
+      if (prefix_cache_entries_.count(it.first)) {
+        continue;
+      }
       total_seq_len += it.second.seq_length;
     }
     return total_seq_len;
@@ -850,6 +1273,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
   void BeginForward(const ffi::Shape& seq_ids, const ffi::Shape& append_lengths,
                     const ffi::Optional<ffi::Shape>& opt_token_tree_parent_ptr) final {
+    TVM_NVTX_OPTIONAL_SCOPE("PagedKVCache::BeginForward");
     // Note: MLA does not supported tree attention for now.
     if (attn_kinds_[0] == AttnKind::kMLA) {
       CHECK(!opt_token_tree_parent_ptr.defined()) << "Tree attention is not supported yet for MLA";
@@ -862,6 +1286,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     cur_seq_ids_ = seq_ids;
     cur_append_lengths_ = append_lengths;
 
+    // - Release the host buffers of finished prefetches.
+    if (!pending_prefetch_host_pages_.empty()) {
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+      pending_prefetch_host_pages_.clear();
+    }
+
     // - Collect sequence/block/page information for attention.
     std::vector<Sequence*> sequences;
     std::vector<int32_t> last_block_length_before_append;
@@ -873,6 +1303,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       auto it = seq_map_.find(seq_ids[i]);
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_ids[i]
                                   << "\" cannot be found in KV cache.";
+      CheckSequenceNotOffloaded(seq_ids[i]);
       sequences.push_back(&it->second);
       last_block_length_before_append.push_back(
           global_block_pool_[it->second.last_block_idx].seq_length);
@@ -897,14 +1328,22 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     std::vector<std::vector<std::pair<int32_t, int32_t>>> chunked_block_ids_arr;
     chunked_block_ids_arr.reserve(num_depths_);
     use_decode_kernel_.clear();
+    num_decode_entries_on_depths_.clear();
     for (int d = 0; d < num_depths_; ++d) {
       // We force the blocks at maximum depth not to coalesce, so that it can be concatenated with
       // trailing exceeding blocks.
       auto [chunked_block_ids, use_decode_kernel] = GetChunkedBlockIds(
           block_ids_on_depths[d], /*enable_coalesce=*/d != kPagedKVCacheMaxBlockDepth - 1,
           cur_append_lengths_, global_block_pool_, is_decode_request_);
+      // The leading entries of single tokens are the decodes not coalesced on this depth.
+      int64_t num_decode_entries = 0;
+      while (num_decode_entries < static_cast<int64_t>(chunked_block_ids.size()) &&
+             chunked_block_ids[num_decode_entries].second == 1) {
+        ++num_decode_entries;
+      }
       chunked_block_ids_arr.push_back(chunked_block_ids);
       use_decode_kernel_.push_back(use_decode_kernel);
+      num_decode_entries_on_depths_.push_back(use_decode_kernel ? 0 : num_decode_entries);
     }
 
     if (num_depths_ == kPagedKVCacheMaxBlockDepth) {
@@ -928,6 +1367,13 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     if (has_previous_tree) {
       append_before_attn_ = true;
     }
+    // The decode sub-batch of a mixed batch runs on views of the prefill page table, which
+    // the kernels planned ahead by BeginForward and the sliding window length info rule out.
+    if (append_before_attn_ || opt_token_tree_parent_ptr.defined() || support_sliding_window_ ||
+        support_layer_sliding_window_ || f_attention_decode_ == nullptr ||
+        f_attention_decode_->backend_kind != AttnBackendKind::kTIR || NeedKernelBeginForward()) {
+      std::fill(num_decode_entries_on_depths_.begin(), num_decode_entries_on_depths_.end(), 0);
+    }
 
     // - Check token tree validity and process the token tree.
     if (opt_token_tree_parent_ptr.defined()) {
@@ -1118,6 +1564,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     kv_transfer_page_to_page_local_position_map_host_.clear();
     kv_transfer_page_to_page_remote_position_map_host_.clear();
     kv_transfer_page_to_page_recver_id_host_.clear();
+    kv_transfer_recver_groups_.clear();
     transfer_kv_ = false;
     page_to_page_transfer_kv_ = false;
     for (int i = 0; i < cur_batch_size_; ++i) {
@@ -1162,8 +1609,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
           transfer_kv_ = true;
           kv_transfer_remote_position_map_host_.push_back(
               sequences[i]->kv_transfer_metadata.remote_position_map[pos_in_seq - seq_send_start]);
-          kv_transfer_recver_id_host_.push_back(
-              sequences[i]->kv_transfer_metadata.recver_pe_offset);
+          int32_t recver_pe_offset = sequences[i]->kv_transfer_metadata.recver_pe_offset;
+          kv_transfer_recver_id_host_.push_back(recver_pe_offset);
+          if (std::find(kv_transfer_recver_groups_.begin(), kv_transfer_recver_groups_.end(),
+                        recver_pe_offset) == kv_transfer_recver_groups_.end()) {
+            kv_transfer_recver_groups_.push_back(recver_pe_offset);
+          }
         }
       }
       if (!sequences[i]->kv_transfer_metadata.local_position_map.empty()) {
@@ -1184,6 +1635,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void EndForward() final {
+    TVM_NVTX_OPTIONAL_SCOPE("PagedKVCache::EndForward");
     if (kv_transfer_stream_ != nullptr) {
       DeviceAPI::Get(device_)->SyncStreamFromTo(device_, kv_transfer_stream_, compute_stream_);
     }
@@ -1271,6 +1723,17 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
                  sequence->kv_transfer_metadata.local_position_map.end());
   }
 
+  IntTuple DisaggGetRecvLayerCounters() final {
+    CHECK(nvshmem_recv_counters_.defined()) << "KV transfer is not enabled in the KV cache.";
+    // The counters are read on the copy stream, so the query does not wait for the computation
+    // or the transfers in flight.
+    Tensor counters = Tensor::Empty({num_layers_}, DataType::UInt(64), Device{kDLCPU, 0});
+    Tensor::CopyFromTo(nvshmem_recv_counters_.operator->(), counters.get_mutable(), copy_stream_);
+    DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+    const uint64_t* data = static_cast<const uint64_t*>(counters->data);
+    return IntTuple(data, data + num_layers_);
+  }
+
   void AttentionWithFusedQKV(int64_t layer_id, Tensor qkv_data, ffi::Optional<Tensor> mask,
                              Tensor o_data, double sm_scale) final {
     // Part 1. Shape and dtype check.
@@ -1310,10 +1773,15 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
     Tensor q_data = temp_attn_q_device_.CreateView({total_seq_length, num_qo_heads_, qk_head_dim_},
                                                    qkv_data->dtype);
-    Tensor k_data = temp_attn_k_device_.CreateView({total_seq_length, num_kv_heads_, qk_head_dim_},
-                                                   qkv_data->dtype);
-    Tensor v_data = temp_attn_v_device_.CreateView({total_seq_length, num_kv_heads_, qk_head_dim_},
-                                                   qkv_data->dtype);
+    // The KV transfer of a layer reads its K/V data, so with a transfer the layers alternate
+    // between two buffers, and a layer only waits for the transfer of two layers before.
+    bool use_alt_kv_buffer = transfer_kv_ && local_layer_id % 2 == 1;
+    Tensor k_data = (use_alt_kv_buffer ? temp_attn_k_alt_device_ : temp_attn_k_device_)
+                        .CreateView({total_seq_length, num_kv_heads_, qk_head_dim_},
+                                    qkv_data->dtype);
+    Tensor v_data = (use_alt_kv_buffer ? temp_attn_v_alt_device_ : temp_attn_v_device_)
+                        .CreateView({total_seq_length, num_kv_heads_, qk_head_dim_},
+                                    qkv_data->dtype);
 
     Tensor qkv_data_view = qkv_data;
     Tensor o_data_view = o_data;
@@ -1324,10 +1792,6 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
           o_data.CreateView({total_seq_length, num_qo_heads_, qk_head_dim_}, qkv_data->dtype);
     }
     // Part 2. Split fused qkv and apply rotary embedding to q/k data.
-    if (transfer_kv_) {
-      // The the compute stream needs to wait for the KV transfer stream.
-      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, kv_transfer_stream_, compute_stream_);
-    }
     if (!rope_ext_factors_.defined()) {
       f_split_rotary_(qkv_data_view, q_rope_position_map_view_, q_data, k_data, v_data,
                       static_cast<int>(rope_mode_ == RoPEMode::kNormal));
@@ -1357,11 +1821,19 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     if (transfer_kv_) {
       // FIXME: if the sender and recver's PP/TP degree do not match, we will need to first
       // get the view of remote pages, and then take the specific remote layer.
+      // The compute stream waits for the transfer of the previous layer, which is the last one
+      // on the KV transfer stream, before the next layer overwrites the buffers it reads.
+      // The transfer of this layer thus overlaps with the computation of the next one.
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, kv_transfer_stream_, compute_stream_);
       // The KV transfer stream nees to wait for the compute stream.
       DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, kv_transfer_stream_);
       f_transfer_kv_.value()(pages_[local_layer_id], k_data, v_data,
                              kv_transfer_remote_position_map_view_, kv_transfer_recver_id_view_,
                              kv_transfer_stream_);
+      // Notify the recvers once the KV data of this layer has landed.
+      f_transfer_kv_notify_.value()(nvshmem_recv_counters_, local_layer_id, pages_[local_layer_id],
+                                    num_kv_heads_, ffi::Shape(kv_transfer_recver_groups_),
+                                    kv_transfer_stream_);
     }
     // Part 5: perform attention
     AttentionInternal(layer_id, q_data, k_data, v_data, o_data_view, sm_scale);
@@ -1507,7 +1979,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_ids[i]
                                   << "\" cannot be found in KV cache.";
       sequences.push_back(&it->second);
-      is_chain = it->second.is_chain;
+      // The KV data needs compaction as soon as one sequence in the batch is not a chain.
+      is_chain = is_chain && it->second.is_chain;
       CHECK(leaf_indices[i] == -1 || !it->second.accepted_indices_committed)
           << "The accepted nodes of sequence " << seq_ids[i] << " are already committed.";
       CHECK_GE(leaf_indices[i], -1)
@@ -1525,8 +1998,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       commit_copy_length_indptr_host_.push_back(0);
 
       for (int i = 0; i < num_seq_to_commit; ++i) {
-        if (leaf_indices[i] == -1) {
-          // No node is accepted. All nodes in the token tree need to be popped.
+        if (leaf_indices[i] == -1 || sequences[i]->is_chain) {
+          // No node is accepted, so that all nodes in the token tree need to be popped,
+          // or the tree is a chain whose accepted nodes are already in place.
           commit_copy_length_indptr_host_.push_back(commit_copy_length_indptr_host_.back());
           continue;
         }
@@ -1601,6 +2075,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
            "initialization. Please construct the KV cache with `f_debug_get_kv`.";
 
     const Sequence& seq = seq_map_.at(seq_id);
+    CheckSequenceNotOffloaded(seq_id);
     CHECK_GE(start_pos, 0) << "DebugGetKV does not accept negative start_pos " << start_pos;
     CHECK_LE(end_pos, seq.seq_length) << "DebugGetKV does not accept out-of-range end_pos";
     CHECK_LT(start_pos, end_pos) << "DebugGetKV does not accept \"start_pos >= end_pos\"";
@@ -1697,6 +2172,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
  private:
   /*! \brief Get a new free page and return its id. */
   int32_t GetFreePage() {
+    // Release the least recently used prefix cache entries when running out of pages.
+    while (free_page_ids_.empty() && EvictLRUPrefixCacheEntry()) {
+    }
     // Find a page from the free page pools.
     CHECK(!free_page_ids_.empty()) << "The KV cache is full. No page can be allocated.";
     int32_t page_id = free_page_ids_.back();
@@ -1704,6 +2182,110 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     return page_id;
   }
 
+  /*! \brief Check the given sequence is not offloaded to host memory. */
+  void CheckSequenceNotOffloaded(int64_t seq_id) const {
+    CHECK(offloaded_seq_map_.find(seq_id) == offloaded_seq_map_.end())
+        << "The sequence \"" << seq_id
+        << "\" is offloaded to host memory. Please prefetch the sequence first.";
+  }
+
+  /*!
+   * \brief Wait for the copies between the pages and the host buffers of the offloaded and
+   * prefetched sequences, which the host buffers must outlive.
+   */
+  void SyncHostPageCopies() {
+    if (!offloaded_seq_map_.empty() || !pending_prefetch_host_pages_.empty()) {
+      DeviceAPI::Get(device_)->StreamSync(device_, copy_stream_);
+    }
+  }
+
+  /*!
+   * \brief Copy pages between the KV cache and the host buffers on the copy stream.
+   * Consecutive page ids are coalesced into a single copy.
+   * \param page_ids The ids of the pages, in the order they are laid out in the host buffers.
+   * \param host_pages The host buffers of each layer.
+   * \param to_host Whether to copy from the KV cache to host, or backwards.
+   */
+  void CopyPagesWithHost(const std::vector<int32_t>& page_ids,
+                         const std::vector<Tensor>& host_pages, bool to_host) {
+    std::vector<std::pair<int32_t, int32_t>> moves;
+    moves.reserve(page_ids.size());
+    for (size_t i = 0; i < page_ids.size(); ++i) {
+      if (to_host) {
+        moves.emplace_back(page_ids[i], static_cast<int32_t>(i));
+      } else {
+        moves.emplace_back(static_cast<int32_t>(i), page_ids[i]);
+      }
+    }
+    for (int layer = 0; layer < num_layers_; ++layer) {
+      if (to_host) {
+        CopyPages(pages_[layer], host_pages[layer], moves);
+      } else {
+        CopyPages(host_pages[layer], pages_[layer], moves);
+      }
+    }
+  }
+
+  /*!
+   * \brief Copy pages between two tensors laid out by page on the copy stream.
+   * Moves whose source and destination pages both follow the previous move are coalesced
+   * into a single copy.
+   * \param src The tensor to copy from, whose first dimension is the page.
+   * \param dst The tensor to copy to, of the same page shape as src.
+   * \param moves The (source page, destination page) pairs.
+   */
+  void CopyPages(const Tensor& src, const Tensor& dst,
+                 const std::vector<std::pair<int32_t, int32_t>>& moves) {
+    DLTensor src_view = *src.operator->();
+    DLTensor dst_view = *dst.operator->();
+    std::vector<int64_t> shape(src_view.shape, src_view.shape + src_view.ndim);
+    int64_t page_bytes = GetDataSize(src_view) / shape[0];
+    uint64_t src_byte_offset = src_view.byte_offset;
+    uint64_t dst_byte_offset = dst_view.byte_offset;
+    src_view.shape = shape.data();
+    dst_view.shape = shape.data();
+    for (size_t begin = 0; begin < moves.size();) {
+      size_t end = begin + 1;
+      while (end < moves.size() && moves[end].first == moves[end - 1].first + 1 &&
+             moves[end].second == moves[end - 1].second + 1) {
+        ++end;
+      }
+      shape[0] = end - begin;
+      src_view.byte_offset = src_byte_offset + moves[begin].first * page_bytes;
+      dst_view.byte_offset = dst_byte_offset + moves[begin].second * page_bytes;
+      Tensor::CopyFromTo(&src_view, &dst_view, copy_stream_);
+      begin = end;
+    }
+  }
+
+  /*! \brief Mark the prefix cache entry as the most recently used one. */
+  void TouchPrefixCacheEntry(int64_t entry_seq_id) {
+    PrefixCacheEntry& entry = prefix_cache_entries_.at(entry_seq_id);
+    prefix_cache_lru_.splice(prefix_cache_lru_.begin(), prefix_cache_lru_, entry.lru_it);
+  }
+
+  /*!
+   * \brief Evict the least recently used prefix cache entry that is not pinned.
+   * The pages of the entry are released unless other sequences still share them.
+   * \return Whether an entry is evicted.
+   */
+  bool EvictLRUPrefixCacheEntry() {
+    for (auto lru_it = prefix_cache_lru_.rbegin(); lru_it != prefix_cache_lru_.rend(); ++lru_it) {
+      int64_t entry_seq_id = *lru_it;
+      auto entry_it = prefix_cache_entries_.find(entry_seq_id);
+      ICHECK(entry_it != prefix_cache_entries_.end());
+      if (entry_it->second.pinned) {
+        continue;
+      }
+      prefix_tree_.Erase(entry_it->second.tokens);
+      prefix_cache_lru_.erase(entry_it->second.lru_it);
+      prefix_cache_entries_.erase(entry_it);
+      RemoveSequence(entry_seq_id);
+      return true;
+    }
+    return false;
+  }
+
   /*! \brief Get a new free block and return its index. */
   int32_t GetFreeBlock() {
     if (!free_block_idx_.empty()) {
@@ -1887,12 +2469,24 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int32_t page_start_offset_after_sliding =
         (block.sliding_window_offset + length_to_slide) % page_size_;
 
-    // - Free the pages that are fully slidden.
+    // - Free the pages that are fully slidden. A slidden page is recycled in
+    // place as the first temporary page borrowed by the tail of the window if any,
+    // so that the window reuses its own pages like a ring buffer.
+    auto it_temp_page = std::find(block.page_ids.begin() + num_sink_pages, block.page_ids.end(),
+                                  kPagedKVCacheTempPageId);
     while (page_idx_after_sliding > num_sink_pages) {
-      if (block.page_ids[num_sink_pages] != kPagedKVCacheTempPageId) {
-        free_page_ids_.push_back(block.page_ids[num_sink_pages]);
+      int32_t page_id = block.page_ids[num_sink_pages];
+      if (page_id != kPagedKVCacheTempPageId) {
+        it_temp_page = std::find(it_temp_page, block.page_ids.end(), kPagedKVCacheTempPageId);
+        if (it_temp_page != block.page_ids.end()) {
+          *it_temp_page = page_id;
+        } else {
+          free_page_ids_.push_back(page_id);
+        }
       }
       block.page_ids.erase(block.page_ids.begin() + num_sink_pages);
+      // The erase shifts the pages after the sink pages by one.
+      it_temp_page = block.page_ids.begin() + num_sink_pages;
       --page_idx_after_sliding;
     }
     // - The first sliding page after sliding is either the last sink page,
@@ -1939,10 +2533,19 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     int64_t tgt_npage = (block.seq_length - block.sink_length + block.sliding_window_offset +
                          append_length + page_size_ - 1) /
                         page_size_;
+    // A window already full slides out as many pages as a short append reserves,
+    // which the slide recycles in place into the borrowed pages. The attention of
+    // this round may still read the last `append_length` slots of a slidden page, while
+    // the append writes the first `append_length` slots of the recycled page, which
+    // do not overlap as long as the append is at most half a page.
+    bool recycle_slidden_pages = seq->sliding_window_size != -1 && support_sliding_window_ &&
+                                 seq->seq_length - append_length >= seq->sliding_window_size &&
+                                 2 * append_length <= page_size_;
     for (int64_t page_idx = cur_npage; page_idx < tgt_npage; ++page_idx) {
       // When sliding window is enabled for the seq, we can "borrow temporary pages (-1)",
       // since the pages need to be slidden out might not have been released.
-      if (free_page_ids_.empty() && seq->sliding_window_size != -1 && support_sliding_window_) {
+      if ((free_page_ids_.empty() || recycle_slidden_pages) && seq->sliding_window_size != -1 &&
+          support_sliding_window_) {
         block.page_ids.push_back(kPagedKVCacheTempPageId);
       } else {
         block.page_ids.push_back(GetFreePage());
@@ -2025,7 +2628,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
               d, temp_float_attn_workspace_, temp_int_attn_workspace_[d + 1],
               temp_int_pinned_attn_workspace_[d + 1], &page_indptr_on_depths_host_[d],
               cur_batch_size_, page_size_, num_qo_heads_, num_kv_heads_, qk_head_dim_, v_head_dim_,
-              rope_mode_, kv_dtype_, kv_dtype_, copy_stream_);
+              rope_mode_, qkv_dtype_, kv_dtype_, copy_stream_);
         }
       } else {
         if (f_attention_prefill_ != nullptr &&
@@ -2197,6 +2800,13 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         f_decode->MHA(d, q_data, pages_[local_layer_id], page_indptr, page_indices, length_info,
                       k_rope_pos, q_rope_position_map_view_, rope_mode_, rotary_scale, rotary_theta,
                       sm_scale, attn_output, attn_lse, compute_stream_);
+      } else if (num_decode_entries_on_depths_[d] > 0) {
+        // Use decode kernel for the leading decodes and prefill kernel for the rest on depth d
+        ICHECK_NOTNULL(f_decode);
+        ICHECK_NOTNULL(f_prefill);
+        MHACrossAttnMixedBatch(d, f_prefill, f_decode, q_data, pages_[local_layer_id],
+                               page_indptr, page_indices, length_info, k_rope_pos, rotary_scale,
+                               rotary_theta, sm_scale, attn_output, attn_lse);
       } else {
         // Use prefill kernel for depth d
         ICHECK_NOTNULL(f_prefill);
@@ -2217,6 +2827,46 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     return cross_attn_computed;
   }
 
+  /*!
+   * \brief Compute the cross-attention of a mixed prefill/decode batch on a depth, running the
+   * leading decode entries with the decode kernel and the rest with the prefill kernel.
+   * The decode kernel takes the prefix views of the arrays. The prefill kernel takes the
+   * suffix views of the per-entry arrays, and indexes the full q and output by qo_indptr.
+   */
+  void MHACrossAttnMixedBatch(int d, const std::unique_ptr<PagedPrefillFunc>& f_prefill,
+                              const std::unique_ptr<PagedDecodeFunc>& f_decode, Tensor q_data,
+                              Tensor pages, Tensor page_indptr, Tensor page_indices,
+                              Tensor length_info, Tensor k_rope_pos, double rotary_scale,
+                              double rotary_theta, double sm_scale, Tensor attn_output,
+                              Tensor attn_lse) {
+    int64_t num_decodes = num_decode_entries_on_depths_[d];
+    int64_t num_entries = qo_indptr_on_depths_view_[d]->shape[0] - 1;
+    auto f_prefix = [](const Tensor& data, int64_t n) {
+      std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+      shape[0] = n;
+      return data.CreateView(ffi::Shape(shape), data->dtype);
+    };
+    auto f_suffix = [this](const Tensor& data, int64_t begin) {
+      return data.CreateView({data->shape[0] - begin}, data->dtype,
+                             begin * (dtype_aux_.bits / 8));
+    };
+    f_decode->MHA(d, f_prefix(q_data, num_decodes), pages, f_prefix(page_indptr, num_decodes + 1),
+                  page_indices, f_prefix(length_info, num_decodes),
+                  f_prefix(k_rope_pos, num_decodes),
+                  f_prefix(q_rope_position_map_view_, num_decodes), rope_mode_, rotary_scale,
+                  rotary_theta, sm_scale, f_prefix(attn_output, num_decodes),
+                  f_prefix(attn_lse, num_decodes), compute_stream_);
+    if (num_decodes == num_entries) {
+      return;
+    }
+    f_prefill->MHA(d, q_data, f_suffix(qo_indptr_on_depths_view_[d], num_decodes), pages,
+                   f_suffix(page_indptr, num_decodes), page_indices,
+                   f_suffix(length_info, num_decodes), q_rope_position_map_view_,
+                   f_suffix(k_rope_pos, num_decodes), /*causal=*/false,
+                   /*rotary_mode=*/rope_mode_, rotary_scale, rotary_theta, sm_scale, attn_output,
+                   attn_lse, compute_stream_);
+  }
+
   /*! \brief Compute cross-attention for MLA. Return if there is effective computation. */
   bool MLACrossAttnInternal(int64_t local_layer_id, Tensor q_data, Tensor o_data, Tensor lse_data,
                             double sm_scale) {
@@ -2491,6 +3141,14 @@ TVM_FFI_STATIC_INIT_BLOCK() {
         if (auto opt_nd = args[11].as<Tensor>()) {
           rope_ext_factors = opt_nd.value();
         }
+        // The optional args[28] is an empty tensor in the storage dtype of KV pages,
+        // which defaults to the dtype of `init`.
+        DLDataType kv_dtype = init->dtype;
+        if (args.size() == 29) {
+          if (auto opt_nd = args[28].as<Tensor>()) {
+            kv_dtype = opt_nd.value()->dtype;
+          }
+        }
         auto f_convert_optional_packed_func = [&args](int arg_idx) -> ffi::Optional<ffi::Function> {
           if (auto opt_func = args[arg_idx].as<ffi::Function>()) {
             return opt_func.value();
@@ -2525,7 +3183,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
             num_kv_heads, qk_head_dim, v_head_dim, attn_kinds_vec, reserved_num_seqs,
             num_total_pages, prefill_chunk_size, support_sliding_window, RoPEMode(rope_mode),
             rotary_scale, rotary_theta, std::move(rope_ext_factors), enable_kv_transfer,  //
-            init->dtype, init->device,                                                    //
+            init->dtype, kv_dtype, init->device,                                          //
             std::move(f_transpose_append_mha), std::move(f_transpose_append_mla),
             std::move(f_compact_copy), std::move(f_attention_prefill_ragged),
             std::move(f_attention_prefill), std::move(f_attention_decode),
@@ -22,8 +22,11 @@
  */
 
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/nvtx.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include "kv_state.h"
@@ -55,6 +58,8 @@ class RNNStateImpObj : public RNNStateObj {
     int64_t history_slot_id = 0;
     /*! \brief The index of seq slot in the storage. */
     int64_t seq_slot_id;
+    /*! \brief The ids of the checkpoints of the sequence, in ascending sequence length. */
+    std::vector<int64_t> checkpoint_ids;
 
     /*! \brief Constructor. */
     explicit Sequence(int64_t seq_slot_id) : seq_slot_id(seq_slot_id) {}
@@ -66,6 +71,18 @@ class RNNStateImpObj : public RNNStateObj {
     }
   };
 
+  /*!
+   * \brief The snapshot of the state of a sequence at a sequence length.
+   * A checkpoint is never written after it is taken, so that the sequences
+   * forked from the sequence share it without copying.
+   */
+  struct Checkpoint {
+    /*! \brief The sequence length at which the state is taken. */
+    int64_t seq_length = 0;
+    /*! \brief The number of sequences referring to the checkpoint. */
+    int ref_cnt = 0;
+  };
+
   /********************* Configuration *********************/
 
   /*! \brief The number of layers in the model. */
@@ -99,6 +116,16 @@ class RNNStateImpObj : public RNNStateObj {
   std::vector<int64_t> free_slot_ids_;
   /*! \brief The mapping from sequence ids to sequences. */
   std::unordered_map<int64_t, Sequence> seq_map_;
+  /*!
+   * \brief The storages of the checkpoints, allocated on the first checkpoint.
+   * The array has `num_layers * num_states_per_layer_` Tensors,
+   * each of them has layout `(num_checkpoint_slots, state_size)`.
+   */
+  std::vector<std::vector<Tensor>> checkpoint_storages_;
+  /*! \brief The checkpoints, indexed by their slot in the checkpoint storages. */
+  std::vector<Checkpoint> checkpoints_;
+  /*! \brief The list of ids of released checkpoint slots for reuse. */
+  std::vector<int64_t> free_checkpoint_ids_;
 
   /****************** Auxiliary Arrays on Host ******************/
 
@@ -202,6 +229,12 @@ class RNNStateImpObj : public RNNStateObj {
     for (int64_t slot_id = reserved_num_seqs_ - 1; slot_id >= 0; --slot_id) {
       free_slot_ids_.push_back(slot_id);
     }
+    free_checkpoint_ids_.clear();
+    for (int64_t checkpoint_id = static_cast<int64_t>(checkpoints_.size()) - 1; checkpoint_id >= 0;
+         --checkpoint_id) {
+      checkpoints_[checkpoint_id] = Checkpoint();
+      free_checkpoint_ids_.push_back(checkpoint_id);
+    }
     dirty_aux_data_device_ = false;
   }
 
@@ -209,6 +242,7 @@ class RNNStateImpObj : public RNNStateObj {
 
   void BeginForward(const ffi::Shape& seq_ids, const ffi::Shape& append_lengths,
                     const ffi::Optional<ffi::Shape>& opt_token_tree_parent_ptr) final {
+    TVM_NVTX_OPTIONAL_SCOPE("RNNState::BeginForward");
     CHECK_EQ(seq_ids.size(), append_lengths.size())
         << "The seq_ids size (" << seq_ids.size() << ") and append_lengths size ("
         << append_lengths.size() << ") mismatch.";
@@ -235,6 +269,7 @@ class RNNStateImpObj : public RNNStateObj {
   }
 
   void EndForward() final {
+    TVM_NVTX_OPTIONAL_SCOPE("RNNState::EndForward");
     for (int64_t i = 0; i < cur_batch_size_; ++i) {
       int64_t seq_id = cur_seq_ids_[i];
       int64_t seq_length = cur_append_lengths_[i];
@@ -303,6 +338,30 @@ class RNNStateImpObj : public RNNStateObj {
     return result;
   }
 
+  void CheckpointSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
+                                << "\" cannot be found in the space state storage.";
+    Sequence& seq = it->second;
+    if (!seq.checkpoint_ids.empty() &&
+        checkpoints_[seq.checkpoint_ids.back()].seq_length == seq.seq_length) {
+      // The state at the current length is already taken.
+      return;
+    }
+    int64_t checkpoint_id = GetFreeCheckpoint();
+    for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
+      for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
+        DLTensor copy_src =
+            GetStatePtrBySeqHistory(layer_id, state_id, seq.seq_slot_id, seq.history_slot_id);
+        DLTensor copy_dst = GetCheckpointPtr(layer_id, state_id, checkpoint_id);
+        Tensor::CopyFromTo(&copy_src, &copy_dst);
+      }
+    }
+    checkpoints_[checkpoint_id].seq_length = seq.seq_length;
+    checkpoints_[checkpoint_id].ref_cnt = 1;
+    seq.checkpoint_ids.push_back(checkpoint_id);
+  }
+
   /************** Sequence Management **************/
 
   void AddSequence(int64_t seq_id) final {
@@ -330,6 +389,7 @@ class RNNStateImpObj : public RNNStateObj {
                                 << "\" cannot be found in the space state storage.";
 
     free_slot_ids_.push_back(it->second.seq_slot_id);
+    ReleaseCheckpoints(&it->second, /*seq_length=*/-1);
     seq_map_.erase(it);
 
     dirty_aux_data_device_ = true;
@@ -342,19 +402,61 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(seq_map_.find(child_seq_id) == seq_map_.end())
         << "The child sequence \"" << child_seq_id << "\" is already in the space state storage.";
 
+    const Sequence& parent = parent_it->second;
+    if (fork_pos == -1) {
+      fork_pos = parent.seq_length;
+    }
+    CHECK(fork_pos >= 0 && fork_pos <= parent.seq_length)
+        << "The fork position " << fork_pos << " is out of the range of the parent sequence "
+        << parent_seq_id << " of length " << parent.seq_length;
+    int64_t rollback_length = parent.seq_length - fork_pos;
+    const Checkpoint* checkpoint = nullptr;
+    if (rollback_length > parent.available_history_num) {
+      // The fork position is beyond the history, so the child starts from a checkpoint.
+      checkpoint = FindCheckpoint(parent, fork_pos);
+      CHECK(checkpoint != nullptr)
+          << "The fork position " << fork_pos << " of sequence " << parent_seq_id
+          << " is neither in its history of length " << parent.available_history_num
+          << " nor at one of its checkpoints.";
+    }
+
     // Create a child block with the parent block pointer.
     int64_t child_slot_id = GetFreeSlot();
-    seq_map_.insert({child_seq_id, Sequence::Fork(parent_it->second, child_slot_id)});
+    Sequence child = Sequence::Fork(parent, child_slot_id);
+    // The child shares the checkpoints of the parent up to the fork position.
+    while (!child.checkpoint_ids.empty() &&
+           checkpoints_[child.checkpoint_ids.back()].seq_length > fork_pos) {
+      child.checkpoint_ids.pop_back();
+    }
+    for (int64_t checkpoint_id : child.checkpoint_ids) {
+      ++checkpoints_[checkpoint_id].ref_cnt;
+    }
 
     // Copy the parent state data to the child state data.
-    int64_t parent_slot_id = parent_it->second.seq_slot_id;
+    int64_t parent_slot_id = parent.seq_slot_id;
     for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
       for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
-        DLTensor copy_src = GetStatePtrBySeq(layer_id, state_id, parent_slot_id);
-        DLTensor copy_dst = GetStatePtrBySeq(layer_id, state_id, child_slot_id);
+        DLTensor copy_src =
+            checkpoint != nullptr
+                ? GetCheckpointPtr(layer_id, state_id, child.checkpoint_ids.back())
+                : GetStatePtrBySeq(layer_id, state_id, parent_slot_id);
+        DLTensor copy_dst =
+            checkpoint != nullptr
+                ? GetStatePtrBySeqHistory(layer_id, state_id, child_slot_id, /*history_slot_id=*/0)
+                : GetStatePtrBySeq(layer_id, state_id, child_slot_id);
         Tensor::CopyFromTo(&copy_src, &copy_dst);
       }
     }
+    child.seq_length = fork_pos;
+    if (checkpoint != nullptr) {
+      child.available_history_num = 0;
+      child.history_slot_id = 0;
+    } else {
+      child.available_history_num -= rollback_length;
+      child.history_slot_id =
+          (child.history_slot_id - rollback_length + max_history_) % max_history_;
+    }
+    seq_map_.insert({child_seq_id, std::move(child)});
     dirty_aux_data_device_ = true;
   }
 
@@ -363,11 +465,32 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
                                 << "\" cannot be found in space state.";
     CHECK_GE(n, 0) << "The length of rolling back " << n << " cannot be negative.";
-    CHECK_LE(n, it->second.available_history_num)
-        << "The sequence only has " << it->second.available_history_num
-        << " available history in the space state storage, while the length of rollback is " << n
-        << " which exceeds the sequence length.";
+    Sequence& seq = it->second;
+    if (n > seq.available_history_num) {
+      // Roll back beyond the history by restoring the checkpoint at the target length.
+      const Checkpoint* checkpoint = FindCheckpoint(seq, seq.seq_length - n);
+      CHECK(checkpoint != nullptr)
+          << "The sequence only has " << seq.available_history_num
+          << " available history in the space state storage, while the length of rollback is "
+          << n << " which exceeds the sequence length, and the sequence has no checkpoint at "
+          << "length " << seq.seq_length - n << ".";
+      ReleaseCheckpoints(&seq, seq.seq_length - n);
+      for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
+        for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
+          DLTensor copy_src = GetCheckpointPtr(layer_id, state_id, seq.checkpoint_ids.back());
+          DLTensor copy_dst = GetStatePtrBySeqHistory(layer_id, state_id, seq.seq_slot_id,
+                                                      /*history_slot_id=*/0);
+          Tensor::CopyFromTo(&copy_src, &copy_dst);
+        }
+      }
+      seq.seq_length -= n;
+      seq.available_history_num = 0;
+      seq.history_slot_id = 0;
+      dirty_aux_data_device_ = true;
+      return;
+    }
 
+    ReleaseCheckpoints(&seq, seq.seq_length - n);
     it->second.seq_length -= n;
     it->second.available_history_num -= n;
     it->second.history_slot_id = (it->second.history_slot_id - n + max_history_) % max_history_;
@@ -383,6 +506,84 @@ class RNNStateImpObj : public RNNStateObj {
     return seq_slot_id;
   }
 
+  /*! \brief Get a free checkpoint slot, growing the checkpoint storages when all are used. */
+  int64_t GetFreeCheckpoint() {
+    if (free_checkpoint_ids_.empty()) {
+      int64_t old_capacity = checkpoints_.size();
+      int64_t new_capacity = std::max(old_capacity * 2, reserved_num_seqs_);
+      std::vector<std::vector<Tensor>> new_storages;
+      new_storages.reserve(num_layers_);
+      for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
+        std::vector<Tensor> layer_storages;
+        layer_storages.reserve(num_states_per_layer_);
+        for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
+          Tensor state = storages_[layer_id][state_id];
+          std::vector<int64_t> shape{new_capacity};
+          shape.insert(shape.end(), state->shape + 2, state->shape + state->ndim);
+          Tensor storage = Tensor::Empty(shape, state->dtype, state->device);
+          if (old_capacity > 0) {
+            // Copy the checkpoints taken so far to the front of the new storage.
+            DLTensor copy_src = *checkpoint_storages_[layer_id][state_id].operator->();
+            DLTensor copy_dst = *storage.operator->();
+            copy_dst.shape = copy_src.shape;
+            Tensor::CopyFromTo(&copy_src, &copy_dst);
+          }
+          layer_storages.push_back(storage);
+        }
+        new_storages.push_back(std::move(layer_storages));
+      }
+      checkpoint_storages_ = std::move(new_storages);
+      checkpoints_.resize(new_capacity);
+      for (int64_t checkpoint_id = new_capacity - 1; checkpoint_id >= old_capacity;
+           --checkpoint_id) {
+        free_checkpoint_ids_.push_back(checkpoint_id);
+      }
+    }
+    int64_t checkpoint_id = free_checkpoint_ids_.back();
+    free_checkpoint_ids_.pop_back();
+    return checkpoint_id;
+  }
+
+  /*! \brief Find the checkpoint of the sequence at the given length, or nullptr if none. */
+  const Checkpoint* FindCheckpoint(const Sequence& seq, int64_t seq_length) const {
+    for (int64_t checkpoint_id : seq.checkpoint_ids) {
+      if (checkpoints_[checkpoint_id].seq_length == seq_length) {
+        return &checkpoints_[checkpoint_id];
+      }
+    }
+    return nullptr;
+  }
+
+  /*!
+   * \brief Release the checkpoints of the sequence taken after the given length.
+   * A negative length releases all the checkpoints.
+   */
+  void ReleaseCheckpoints(Sequence* seq, int64_t seq_length) {
+    while (!seq->checkpoint_ids.empty() &&
+           (seq_length < 0 || checkpoints_[seq->checkpoint_ids.back()].seq_length > seq_length)) {
+      int64_t checkpoint_id = seq->checkpoint_ids.back();
+      seq->checkpoint_ids.pop_back();
+      if (--checkpoints_[checkpoint_id].ref_cnt == 0) {
+        free_checkpoint_ids_.push_back(checkpoint_id);
+      }
+    }
+  }
+
+  DLTensor GetCheckpointPtr(int64_t layer_id, int64_t state_id, int64_t checkpoint_id) {
+    Tensor storage = checkpoint_storages_[layer_id][state_id];
+    int64_t state_size = 1;
+    for (int64_t i = 1; i < storage->ndim; ++i) {
+      state_size *= storage->shape[i];
+    }
+    int64_t elem_offset = checkpoint_id * state_size;
+    DLTensor _state = *(storage.operator->());
+    _state.byte_offset = elem_offset * storage->dtype.bits / 8;
+    _state.ndim = storage->ndim - 1;
+    _state.shape = const_cast<int64_t*>(_state.shape + 1);
+    _state.strides = _state.strides == nullptr ? nullptr : _state.strides + 1;
+    return _state;
+  }
+
   DLTensor GetStatePtrBySeqHistory(int64_t layer_id, int64_t state_id, int64_t seq_slot_id,
                                    int64_t history_slot_id) {
     Tensor state = storages_[layer_id][state_id];
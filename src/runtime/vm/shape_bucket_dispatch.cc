@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/vm/shape_bucket_dispatch.cc
+ * \brief Dispatch a kernel call to the variant specialized for the shape bucket of the call.
+ */
+#include <tvm/ffi/container/array.h>
+#include <tvm/ffi/container/shape.h>
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/tensor.h>
+
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief The variants that won the online benchmark of the shape buckets of the call sites.
+ *
+ * A call site is identified by its generic variant, which the VM keeps alive as long as the
+ * call site can run.
+ */
+class ShapeBucketWinners {
+ public:
+  static ShapeBucketWinners* Global() {
+    static ShapeBucketWinners* inst = new ShapeBucketWinners();
+    return inst;
+  }
+
+  /*! \return The index of the winner of the bucket of the call site, or -1 if not measured. */
+  int Get(const Object* site, int num_variants, int bucket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = winners_.find(site);
+    if (it == winners_.end() || static_cast<int>(it->second.size()) != num_variants) {
+      return -1;
+    }
+    return it->second[bucket];
+  }
+
+  void Set(const Object* site, int num_variants, int bucket, int winner) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int>& winners = winners_[site];
+    if (static_cast<int>(winners.size()) != num_variants) {
+      winners.assign(num_variants, -1);
+    }
+    winners[bucket] = winner;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<const Object*, std::vector<int>> winners_;
+};
+
+/*!
+ * \brief Call the kernel variant of the shape bucket of a call.
+ *
+ * args[0]: The value of the symbolic variable the buckets are defined on.
+ * args[1]: The upper bounds of the buckets, in increasing order.
+ * args[2]: The variants, the i-th of which is valid for the values up to the i-th bound, and a
+ *   last generic variant valid for any value.
+ * args[3]: Whether to benchmark the valid variants of a bucket on its first call, and use the
+ *   fastest one for the later calls of the bucket.
+ * args[4, 5, ...]: The arguments of the kernel, including its DPS outputs.
+ */
+void ShapeBucketDispatch(ffi::PackedArgs args, ffi::Any* rv) {
+  int64_t key = args[0].cast<int64_t>();
+  ffi::Shape bounds = args[1].cast<ffi::Shape>();
+  ffi::Array<ffi::Function> variants = args[2].cast<ffi::Array<ffi::Function>>();
+  bool tune_online = args[3].cast<bool>();
+  ffi::PackedArgs kernel_args = args.Slice(4);
+  int num_variants = static_cast<int>(variants.size());
+  CHECK_EQ(num_variants, static_cast<int>(bounds.size()) + 1)
+      << "ValueError: Expect one variant per shape bucket and a generic variant, but got "
+      << num_variants << " variants for " << bounds.size() << " buckets";
+
+  int bucket = 0;
+  while (bucket < static_cast<int>(bounds.size()) && key > bounds[bucket]) {
+    ++bucket;
+  }
+  // The variants of the larger buckets are valid too, and so is the generic one.
+  if (!tune_online || bucket == num_variants - 1) {
+    variants[bucket].CallPacked(kernel_args, rv);
+    return;
+  }
+  const Object* site = variants[num_variants - 1].get();
+  int winner = ShapeBucketWinners::Global()->Get(site, num_variants, bucket);
+  if (winner >= 0) {
+    variants[winner].CallPacked(kernel_args, rv);
+    return;
+  }
+
+  // The kernels are pure up to their DPS outputs, so running all of them leaves the outputs
+  // of any of them.
+  std::optional<Device> device;
+  for (int i = 0; i < kernel_args.size() && !device.has_value(); ++i) {
+    if (auto opt_tensor = kernel_args[i].as<Tensor>()) {
+      device = opt_tensor.value()->device;
+    }
+  }
+  auto f_sync = [&]() {
+    if (device.has_value()) {
+      Device dev = device.value();
+      DeviceAPI::Get(dev)->StreamSync(dev, TVMFFIEnvGetStream(dev.device_type, dev.device_id));
+    }
+  };
+  constexpr int kNumRepeats = 3;
+  double best_time = std::numeric_limits<double>::infinity();
+  for (int i = bucket; i < num_variants; ++i) {
+    // The first run warms up the variant, e.g. loads its module on the device.
+    variants[i].CallPacked(kernel_args, rv);
+    f_sync();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kNumRepeats; ++r) {
+      variants[i].CallPacked(kernel_args, rv);
+    }
+    f_sync();
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (time < best_time) {
+      best_time = time;
+      winner = i;
+    }
+  }
+  ShapeBucketWinners::Global()->Set(site, num_variants, bucket, winner);
+  VLOG(1) << "Variant " << winner << " wins the shape bucket " << bucket << " of the call site "
+          << site << " in " << best_time / kNumRepeats * 1e6 << " us";
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def_packed("vm.builtin.shape_bucket_dispatch", ShapeBucketDispatch);
+}
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -44,11 +44,21 @@
 #include <tvm/runtime/tensor.h>
 #include <tvm/runtime/vm/tensor_cache_support.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../../support/utils.h"
 #include "../file_utils.h"
+#include "../pinned_staging_pool.h"
 
 namespace tvm {
 namespace runtime {
@@ -141,6 +151,28 @@ TVM_DLL TensorCacheMetadata TensorCacheMetadata::Load(const std::string& path) {
   return result;
 }
 
+/*!
+ * \brief The name of the metadata file of the parameters produced by the parameter transform
+ * with the given hash, which is stored next to `tensor-cache.json`.
+ */
+std::string TransformedCacheJSONName(const std::string& transform_hash) {
+  return "tensor-cache-transformed-" + transform_hash + ".json";
+}
+
+/*! \brief A digest of `tensor-cache.json`, which identifies the parameters before transform. */
+std::string SourceCacheDigest(const std::string& cache_path) {
+  std::string json_str;
+  LoadBinaryFromFile(cache_path + "/tensor-cache.json", &json_str);
+  // FNV-1a, so that the digest is stable across builds.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : json_str) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  char digest[17];
+  std::snprintf(digest, sizeof(digest), "%016" PRIx64, hash);
+  return digest;
+}
+
 void CopyTensorFromBytes(Tensor param, const void* data, size_t nbytes,
                          ffi::Optional<Tensor>* staging_buffer) {
   Device device = param->device;
@@ -168,22 +200,79 @@ void CopyTensorFromBytes(Tensor param, const void* data, size_t nbytes,
 
 Tensor TensorCacheMetadata::FileRecord::ParamRecord::Load(
     Device device, const std::string* raw_data, ffi::Optional<Tensor>* staging_buffer) const {
+  return LoadFromBuffer(device, raw_data->data(), staging_buffer);
+}
+
+/*! \brief Decode the parameter stored as bf16 into f32. */
+std::vector<uint32_t> DecodeBF16ToF32Param(const char* data, int64_t nbytes) {
+  std::vector<uint16_t> buffer(nbytes / 2);
+  std::vector<uint32_t> decoded(nbytes / 2);
+  std::memcpy(buffer.data(), data, nbytes);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
+  }
+  return decoded;
+}
+
+Tensor TensorCacheMetadata::FileRecord::ParamRecord::LoadFromBuffer(
+    Device device, const char* raw_data, ffi::Optional<Tensor>* staging_buffer) const {
   Tensor arr = Tensor::Empty(shape, dtype, device);
   if (dtype == DataType::Float(32) && format == "f32-to-bf16") {
-    // decode bf16 to f32
-    std::vector<uint16_t> buffer(nbytes / 2);
-    std::vector<uint32_t> decoded(nbytes / 2);
-    std::memcpy(buffer.data(), raw_data->data() + byte_offset, nbytes);
-    for (size_t i = 0; i < buffer.size(); ++i) {
-      decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
-    }
+    std::vector<uint32_t> decoded = DecodeBF16ToF32Param(raw_data + byte_offset, nbytes);
     CopyTensorFromBytes(arr, decoded.data(), decoded.size() * sizeof(uint32_t), staging_buffer);
   } else {
-    CopyTensorFromBytes(arr, raw_data->data() + byte_offset, nbytes, staging_buffer);
+    CopyTensorFromBytes(arr, raw_data + byte_offset, nbytes, staging_buffer);
   }
   return arr;
 }
 
+/*!
+ * \brief Copy host data to device tensors through the pinned staging pool on a dedicated stream.
+ *
+ * Filling a staging buffer (which is where the pages of a memory-mapped shard are read from
+ * disk) overlaps with the copy out of the other one. On devices without a pinned host memory,
+ * data is copied directly.
+ */
+class StagedTensorCopier {
+ public:
+  explicit StagedTensorCopier(Device device) : device_(device) {
+    use_staging_ = PinnedStagingPool::Enabled(device);
+    if (use_staging_) {
+      DeviceAPI::Get(device_)->SetDevice(device_);
+      stream_ = DeviceAPI::Get(device_)->CreateStream(device_);
+    }
+  }
+
+  ~StagedTensorCopier() {
+    if (use_staging_) {
+      Sync();
+      DeviceAPI::Get(device_)->FreeStream(device_, stream_);
+    }
+  }
+
+  /*! \brief Copy the bytes into the tensor. The copy completes after `Sync`. */
+  void Copy(const Tensor& tensor, const void* data, size_t nbytes) {
+    if (!use_staging_) {
+      tensor.CopyFromBytes(data, nbytes);
+      return;
+    }
+    ICHECK(tensor.IsContiguous());
+    PinnedStagingPool::ThreadLocal()->CopyFromHost(data, tensor.get_mutable(), nbytes, stream_);
+  }
+
+  /*! \brief Wait for all the issued copies to complete. */
+  void Sync() {
+    if (!use_staging_) return;
+    PinnedStagingPool::ThreadLocal()->Sync(device_);
+    DeviceAPI::Get(device_)->StreamSync(device_, stream_);
+  }
+
+ private:
+  Device device_;
+  bool use_staging_;
+  TVMStreamHandle stream_ = nullptr;
+};
+
 TVM_DLL ffi::Array<Tensor> TensorCacheMetadata::FileRecord::Load(
     Device device,
     const std::string& path_prefix,  //
@@ -245,13 +334,237 @@ class TensorCache {
    */
   static void Load(const std::string& cache_path, int device_type, int device_id) {
     DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
+    LoadMetadata(TensorCacheMetadata::Load(cache_path), device);
+  }
+
+  /*!
+   * \brief Load the parameters produced by a parameter transform, e.g. the weight prepacking
+   * lifted by LiftTransformParams, that were saved by `SaveTransformed` next to the cache.
+   * \param cache_path The cache to path.
+   * \param transform_hash The hash that identifies the transform.
+   * \param device_type The type of device to be loaded.
+   * \param device_id The device id.
+   * \return Whether the transformed parameters were found and loaded. They are not when they were
+   * never saved, or when the parameters of the cache changed since.
+   */
+  static bool LoadTransformed(const std::string& cache_path, const std::string& transform_hash,
+                              int device_type, int device_id) {
+    std::string json_path = cache_path + "/" + TransformedCacheJSONName(transform_hash);
+    if (!std::ifstream(json_path).good()) {
+      return false;
+    }
+    std::string json_str;
+    LoadBinaryFromFile(json_path, &json_str);
+    picojson::value json_info;
+    if (!picojson::parse(json_info, json_str).empty() || !json_info.is<picojson::object>()) {
+      LOG(WARNING) << "Ignoring the corrupted transformed parameters at " << json_path;
+      return false;
+    }
+    const picojson::object& json = json_info.get<picojson::object>();
+    auto it = json.find("metadata");
+    if (it == json.end() || !it->second.is<picojson::object>()) {
+      return false;
+    }
+    const picojson::object& metadata = it->second.get<picojson::object>();
+    auto digest = metadata.find("sourceDigest");
+    if (digest == metadata.end() || !digest->second.is<std::string>() ||
+        digest->second.get<std::string>() != SourceCacheDigest(cache_path)) {
+      return false;
+    }
+    DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
+    LoadMetadata(TensorCacheMetadata::LoadFromStr(json_str, cache_path), device);
+    return true;
+  }
+
+  /*!
+   * \brief Save the parameters produced by a parameter transform next to the cache, so that
+   * the next processes load them with `LoadTransformed` instead of running the transform again.
+   * \param cache_path The cache to path.
+   * \param transform_hash The hash that identifies the transform.
+   * \param names The names of the transformed parameters.
+   * \param params The transformed parameters.
+   */
+  static void SaveTransformed(const std::string& cache_path, const std::string& transform_hash,
+                              const ffi::Array<ffi::String>& names,
+                              const ffi::Array<Tensor>& params) {
+    constexpr size_t kShardCapBytes = 32 << 20;
+    CHECK_EQ(names.size(), params.size())
+        << "ValueError: Got " << names.size() << " names for " << params.size() << " parameters";
+    picojson::array shards;
+    picojson::array records;
+    std::string data;
+    auto f_commit = [&]() {
+      if (records.empty()) return;
+      std::string data_path = "params_transformed_" + transform_hash + "_shard_" +
+                              std::to_string(shards.size()) + ".bin";
+      SaveBinaryToFile(cache_path + "/" + data_path, data);
+      picojson::object shard;
+      shard["dataPath"] = picojson::value(data_path);
+      shard["format"] = picojson::value("raw-shard");
+      shard["nbytes"] = picojson::value(static_cast<int64_t>(data.size()));
+      shard["records"] = picojson::value(records);
+      shards.push_back(picojson::value(shard));
+      records.clear();
+      data.clear();
+    };
+    for (size_t i = 0; i < params.size(); ++i) {
+      const Tensor& param = params[i];
+      size_t nbytes = GetDataSize(*param.operator->());
+      if (!data.empty() && data.size() + nbytes > kShardCapBytes) {
+        f_commit();
+      }
+      picojson::array shape;
+      for (int64_t dim : param.Shape()) {
+        shape.push_back(picojson::value(dim));
+      }
+      picojson::object record;
+      record["name"] = picojson::value(std::string(names[i]));
+      record["shape"] = picojson::value(shape);
+      record["dtype"] = picojson::value(std::string(ffi::DLDataTypeToString(param->dtype)));
+      record["format"] = picojson::value("raw");
+      record["nbytes"] = picojson::value(static_cast<int64_t>(nbytes));
+      record["byteOffset"] = picojson::value(static_cast<int64_t>(data.size()));
+      records.push_back(picojson::value(record));
+      size_t offset = data.size();
+      data.resize(offset + nbytes);
+      param.CopyToBytes(&data[offset], nbytes);
+    }
+    f_commit();
+
+    picojson::object metadata;
+    metadata["transformHash"] = picojson::value(transform_hash);
+    metadata["sourceDigest"] = picojson::value(SourceCacheDigest(cache_path));
+    picojson::object json;
+    json["metadata"] = picojson::value(metadata);
+    json["records"] = picojson::value(shards);
+    // Write the metadata last and atomically, so that an interrupted save is never loaded.
+    std::string json_path = cache_path + "/" + TransformedCacheJSONName(transform_hash);
+    SaveBinaryToFile(json_path + ".tmp", picojson::value(json).serialize(true));
+    CHECK_EQ(std::rename((json_path + ".tmp").c_str(), json_path.c_str()), 0)
+        << "IOError: Failed to write " << json_path;
+  }
+
+  /*!
+   * \brief Load parameters from path in parallel and append them.
+   *
+   * Shards are memory-mapped instead of being read into a host copy, and are assigned to
+   * worker threads. Each worker copies its parameters to the device through pinned staging
+   * buffers on its own stream, so that cold start is bound by the disk bandwidth.
+   *
+   * \param cache_path The cache to path.
+   * \param device_type The type of device to be loaded.
+   * \param device_id The device id.
+   * \param num_threads The number of loading threads. Non-positive values mean the number of
+   * hardware threads, capped by the number of shards.
+   * \return The loading statistics of each shard, including its "data_path", "nbytes",
+   * "seconds", and "throughput_gb_per_sec".
+   */
+  static ffi::Array<ffi::Map<ffi::String, ffi::Any>> LoadParallel(const std::string& cache_path,
+                                                                int device_type, int device_id,
+                                                                int num_threads) {
+    DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
     TensorCacheMetadata metadata = TensorCacheMetadata::Load(cache_path);
+    int64_t num_shards = static_cast<int64_t>(metadata.records.size());
+    if (num_threads <= 0) {
+      num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Only load in parallel on devices with explicit streams, the others (e.g., OpenCL which
+    // needs the staging workaround in CopyTensorFromBytes) load the shards one by one.
+    if (device.device_type != kDLCPU && GetPreferredHostDevice(device).device_type == kDLCPU) {
+      num_threads = 1;
+    }
+    num_threads =
+        static_cast<int>(std::min<int64_t>(num_threads, std::max<int64_t>(num_shards, 1)));
+
+    std::vector<ffi::Array<Tensor>> shard_params(num_shards);
+    std::vector<double> shard_seconds(num_shards, 0.0);
+    std::vector<std::string> shard_errors(num_shards);
+    std::atomic<int64_t> next_shard{0};
+    auto worker = [&]() {
+      std::unique_ptr<StagedTensorCopier> copier;
+      ffi::Optional<Tensor> staging_buffer;
+      for (int64_t i = next_shard++; i < num_shards; i = next_shard++) {
+        const TensorCacheMetadata::FileRecord& shard_rec = metadata.records[i];
+        try {
+          auto start = std::chrono::steady_clock::now();
+          if (copier == nullptr) {
+            copier = std::make_unique<StagedTensorCopier>(device);
+          }
+          CHECK_EQ(shard_rec.format, "raw-shard")
+              << "ValueError: Only `raw-shard` format is supported";
+          MappedFile file(cache_path + "/" + shard_rec.data_path, /*sequential=*/true);
+          CHECK_EQ(shard_rec.nbytes, file.size())
+              << "ValueError: Encountered an corrupted parameter shard. It means it is not "
+                 "downloaded completely or downloading is interrupted. Please try to download "
+                 "again.";
+          ffi::Array<Tensor> params;
+          params.reserve(shard_rec.records.size());
+          for (const TensorCacheMetadata::FileRecord::ParamRecord& nd_rec : shard_rec.records) {
+            if (device.device_type == kDLOpenCL) {
+              params.push_back(nd_rec.LoadFromBuffer(device, file.data(), &staging_buffer));
+              continue;
+            }
+            Tensor arr = Tensor::Empty(nd_rec.shape, nd_rec.dtype, device);
+            const char* data = file.data() + nd_rec.byte_offset;
+            if (nd_rec.dtype == DataType::Float(32) && nd_rec.format == "f32-to-bf16") {
+              std::vector<uint32_t> decoded = DecodeBF16ToF32Param(data, nd_rec.nbytes);
+              copier->Copy(arr, decoded.data(), decoded.size() * sizeof(uint32_t));
+            } else {
+              copier->Copy(arr, data, nd_rec.nbytes);
+            }
+            params.push_back(arr);
+          }
+          // Wait for the copies so that the time of the shard covers them.
+          copier->Sync();
+          shard_params[i] = std::move(params);
+          shard_seconds[i] = std::chrono::duration_cast<std::chrono::duration<double>>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+        } catch (const std::exception& e) {
+          shard_errors[i] = e.what();
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    ffi::Array<ffi::Map<ffi::String, ffi::Any>> stats;
+    for (int64_t i = 0; i < num_shards; ++i) {
+      const TensorCacheMetadata::FileRecord& shard_rec = metadata.records[i];
+      if (!shard_errors[i].empty()) {
+        LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
+                   << ": " << shard_errors[i];
+      }
+      int num_params = shard_params[i].size();
+      for (int j = 0; j < num_params; ++j) {
+        Update(shard_rec.records[j].name, shard_params[i][j], true);
+      }
+      ffi::Map<ffi::String, ffi::Any> shard_stats;
+      shard_stats.Set("data_path", ffi::String(shard_rec.data_path));
+      shard_stats.Set("nbytes", shard_rec.nbytes);
+      shard_stats.Set("seconds", shard_seconds[i]);
+      shard_stats.Set("throughput_gb_per_sec",
+                      shard_seconds[i] > 0 ? shard_rec.nbytes / 1e9 / shard_seconds[i] : 0.0);
+      stats.push_back(shard_stats);
+    }
+    return stats;
+  }
+
+ private:
+  /*! \brief Load the parameters of all the shards of the metadata, and append them. */
+  static void LoadMetadata(const TensorCacheMetadata& metadata, Device device) {
     ffi::Optional<Tensor> staging_buffer;
     std::string raw_data;
     ffi::Array<Tensor> params;
     for (const TensorCacheMetadata::FileRecord& shard_rec : metadata.records) {
       try {
-        params = shard_rec.Load(device, cache_path, &raw_data, &staging_buffer);
+        params = shard_rec.Load(device, metadata.path, &raw_data, &staging_buffer);
       } catch (const dmlc::Error& e) {
         LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
                    << ": " << e.what();
@@ -263,7 +576,6 @@ class TensorCache {
     }
   }
 
- private:
   ffi::Map<ffi::String, Tensor> pool_;
 };
 
@@ -297,7 +609,10 @@ TVM_FFI_STATIC_INIT_BLOCK() {
                   })
       .def("vm.builtin.tensor_cache.remove", TensorCache::Remove)
       .def("vm.builtin.tensor_cache.clear", TensorCache::Clear)
-      .def("vm.builtin.tensor_cache.load", TensorCache::Load);
+      .def("vm.builtin.tensor_cache.load", TensorCache::Load)
+      .def("vm.builtin.tensor_cache.load_parallel", TensorCache::LoadParallel)
+      .def("vm.builtin.tensor_cache.load_transformed", TensorCache::LoadTransformed)
+      .def("vm.builtin.tensor_cache.save_transformed", TensorCache::SaveTransformed);
 }
 
 // This param module node can be useful to get param dict in RPC mode
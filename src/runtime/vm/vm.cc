@@ -22,13 +22,26 @@
  */
 #include <dlpack/dlpack.h>
 #include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/profiling.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/runtime/tracing.h>
 #include <tvm/runtime/vm/vm.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
 #include <optional>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "call_sampler.h"
+#include "dispatch_plan.h"
 
 namespace tvm {
 namespace runtime {
@@ -184,6 +197,36 @@ struct VMFrame {
   }
 };
 
+/*!
+ * \brief An instruction decoded for the dispatch loop, on its first run.
+ *
+ * The calls of packed functions keep the callee and the argument array, with the immediates,
+ * constants and functions filled in, so that a call only copies the array and patches the
+ * register arguments.
+ */
+struct DecodedInstr {
+  enum class Kind : uint8_t {
+    kUndecoded = 0,
+    /*! \brief A call of a packed function, through `callee`. */
+    kCallPacked = 1,
+    /*! \brief Any other call, e.g. of a closure or starting a dispatch segment. */
+    kCall = 2,
+    kRet = 3,
+    kGoto = 4,
+    kIf = 5,
+  };
+  Kind kind = Kind::kUndecoded;
+  /*! \brief The destination of a call, the result of a return or the condition of an if. */
+  RegName reg = 0;
+  /*! \brief The pc offset of a goto, the false offset of an if. */
+  Index offset = 0;
+  const ffi::FunctionObj* callee = nullptr;
+  /*! \brief The argument array of a packed call, the register arguments are patched per call. */
+  std::vector<ffi::AnyView> args;
+  /*! \brief The indices of the register arguments in `args`, and their registers. */
+  std::vector<std::pair<Index, RegName>> reg_args;
+};
+
 class VirtualMachineImpl : public VirtualMachine {
  public:
   //---------------------------------------------------
@@ -198,6 +241,8 @@ class VirtualMachineImpl : public VirtualMachine {
   void InvokeClosurePacked(const ObjectRef& closure_or_packedfunc, ffi::PackedArgs args,
                            ffi::Any* rv) final;
   void SetInstrument(ffi::Function instrument) final { this->instrument_ = instrument; }
+  void SetCallSampling(int64_t sample_every) final;
+  ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> GetCallSamplingReport() final;
 
   //---------------------------------------------------
   // Functions in the vtable of Module
@@ -207,6 +252,8 @@ class VirtualMachineImpl : public VirtualMachine {
   void _InvokeClosure(ffi::PackedArgs args, ffi::Any* rv);
   void _InvokeClosureStateful(std::string func_name);
   void _SetInstrument(ffi::PackedArgs args, ffi::Any* rv);
+  void _SetParallelDispatch(bool enable);
+  void _SetThreadPoolCpus(ffi::Shape cpus);
   void _GetOutputArity(ffi::PackedArgs args, ffi::Any* rv);
   void _GetOutput(ffi::PackedArgs args, ffi::Any* rv);
   void _SetInputWithoutParamModule(ffi::PackedArgs args, ffi::Any* rv);
@@ -221,6 +268,8 @@ class VirtualMachineImpl : public VirtualMachine {
   TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_closure", &VirtualMachineImpl::_InvokeClosure);
   TVM_MODULE_VTABLE_ENTRY("invoke_stateful", &VirtualMachineImpl::_InvokeClosureStateful);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_instrument", &VirtualMachineImpl::_SetInstrument);
+  TVM_MODULE_VTABLE_ENTRY("set_parallel_dispatch", &VirtualMachineImpl::_SetParallelDispatch);
+  TVM_MODULE_VTABLE_ENTRY("set_thread_pool_cpus", &VirtualMachineImpl::_SetThreadPoolCpus);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output_arity", &VirtualMachineImpl::_GetOutputArity);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output", &VirtualMachineImpl::_GetOutput);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_input", &VirtualMachineImpl::_SetInputWithoutParamModule);
@@ -363,6 +412,19 @@ class VirtualMachineImpl : public VirtualMachine {
     ICHECK_LT(reg, frame->register_file.size());
     frame->register_file[reg] = obj;
   }
+  /*!
+   * \brief Get a constant, copying a tensor constant to the device on its first use.
+   * \param idx The index of the constant.
+   * \return The constant.
+   */
+  const ffi::Any& GetConstant(Index idx) {
+    if (const_on_host_[idx]) {
+      const_pool_[idx] = ConvertRegToDevice(const_pool_[idx], devices[0], allocators[0],
+                                            exec_->memory_scopes[idx]);
+      const_on_host_[idx] = false;
+    }
+    return const_pool_[idx];
+  }
   /*!
    * \brief Read a VM register.
    * \param frame current vm frame.
@@ -392,9 +454,49 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   virtual void RunInstrCall(VMFrame* curr_frame, Instruction inst);
 
+  /*!
+   * \brief Run independent call instructions concurrently on the runtime thread pool.
+   * \param curr_frame The current frame.
+   * \param pcs The pcs of the call instructions.
+   */
+  virtual void RunConcurrentCalls(VMFrame* curr_frame, const std::vector<Index>& pcs);
+
+  /*!
+   * \brief Run a run of call instructions in the order of its dispatch plan.
+   * \param curr_frame The current frame.
+   * \param segment The dispatch plan of the run.
+   */
+  void RunDispatchSegment(VMFrame* curr_frame, const DispatchSegment& segment);
+
+  /*!
+   * \brief Run call instructions one after another.
+   * \param curr_frame The current frame.
+   * \param pcs The pcs of the call instructions.
+   */
+  void RunInstrCallsInOrder(VMFrame* curr_frame, const std::vector<Index>& pcs);
+
+  /*!
+   * \brief Clear the registers that are dead after an instruction, per the release table.
+   * \param curr_frame The current frame.
+   * \param pc The pc of the instruction.
+   */
+  void ReleaseRegisters(VMFrame* curr_frame, Index pc);
+
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
 
+  /*!
+   * \brief Decode an instruction for the dispatch loop.
+   * \param pc The pc of the instruction.
+   */
+  void DecodeInstr(Index pc);
+
+  /*!
+   * \brief Run a call instruction through RunInstrCall, or the dispatch segment it starts.
+   * \param curr_frame The current frame.
+   */
+  void RunCallInstr(VMFrame* curr_frame);
+
   /*!
    * \brief Retrieve the name of the function identified by the given index.
    * \param idx The index into the VM executable function table.
@@ -402,6 +504,22 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   const std::string& GetFuncName(int idx) { return exec_->func_table[idx].name; }
 
+  /*!
+   * \brief Get the device a call runs on, i.e. that of its first tensor argument off the host.
+   * \param args The arguments of the call.
+   * \return The device, or std::nullopt if the call runs on the host.
+   */
+  static std::optional<Device> GetCallDevice(ffi::PackedArgs args) {
+    for (int i = 0; i < args.size(); ++i) {
+      if (auto opt_tensor = args[i].try_cast<Tensor>()) {
+        if ((*opt_tensor)->device.device_type != kDLCPU) {
+          return (*opt_tensor)->device;
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
   /*!
    * \brief Retrieve the inputs for a function.
    * \param func_name The name of the function.
@@ -420,6 +538,10 @@ class VirtualMachineImpl : public VirtualMachine {
   ObjectPtr<VMExecutable> exec_;
   /*! \brief The global constant pool */
   std::vector<ffi::Any> const_pool_;
+  /*! \brief The tensor constants of the pool still on the host, copied on first use. */
+  std::vector<bool> const_on_host_;
+  /*! \brief The instructions decoded for the dispatch loop, by pc. */
+  std::vector<DecodedInstr> decoded_;
   /*!
    * \brief Function pool to cache functions in func_table
    */
@@ -452,6 +574,14 @@ class VirtualMachineImpl : public VirtualMachine {
   RegType return_value_;
   /*!\ brief instrument function. */
   ffi::Function instrument_ = nullptr;
+  /*! \brief The sampler of the call latencies, if sampling. */
+  std::unique_ptr<CallSampler> call_sampler_;
+  /*! \brief The runs of calls with independent calls by their first pc, empty unless parallel
+   *  dispatch is enabled. */
+  std::unordered_map<Index, DispatchSegment> dispatch_segments_;
+  /*! \brief The thread pool of the parallel jobs of this VM, if isolated from the thread-local
+   *  pools. */
+  std::shared_ptr<threading::IsolatedThreadPool> thread_pool_;
 };
 
 void VirtualMachineImpl::LoadExecutable(ObjectPtr<VMExecutable> exec) {
@@ -470,18 +600,27 @@ void VirtualMachineImpl::Init(const std::vector<Device>& devices,
     this->devices.push_back(devices[i]);
     this->allocators.push_back(alloc);
   }
-  // Setup constant sections.
+  // Setup constant sections. The tensors are copied to the device on first use, which spares
+  // the copy of the unused ones and only reads in the pages of a mapped executable when needed,
+  // unless compiled functions read the pool directly.
+  bool copy_on_use = std::none_of(
+      exec_->func_table.begin(), exec_->func_table.end(),
+      [](const VMFuncInfo& finfo) { return finfo.kind == VMFuncInfo::FuncKind::kVMTIRFunc; });
   this->const_pool_.reserve(exec_->constants.size());
+  this->const_on_host_.reserve(exec_->constants.size());
   for (size_t i = 0; i < exec_->constants.size(); ++i) {
-    if (auto opt_nd = exec_->constants[i].as<Tensor>()) {
+    auto opt_nd = exec_->constants[i].as<Tensor>();
+    if (opt_nd && !copy_on_use) {
       this->const_pool_.push_back(
           ConvertRegToDevice(opt_nd.value(), devices[0], allocators[0], exec_->memory_scopes[i]));
     } else {
       this->const_pool_.push_back(exec_->constants[i]);
     }
+    this->const_on_host_.push_back(opt_nd && copy_on_use);
   }
   // Setup function sections.
   this->InitFuncPool();
+  this->decoded_.assign(exec_->instr_offset.size(), DecodedInstr());
 }
 
 VMFuncInfo VirtualMachineImpl::LookupVMFuncInfo(const std::string& func_name) {
@@ -544,6 +683,8 @@ void VirtualMachineImpl::InvokeClosurePacked(const ObjectRef& closure_or_packedf
   // do first cast to VirtualMachine* then to void*
   packed_args[0] = static_cast<void*>(static_cast<VirtualMachine*>(this));
   std::copy(args.data(), args.data() + args.size(), packed_args.begin() + 1);
+  std::optional<threading::IsolatedThreadPool::Scope> pool_scope;
+  if (thread_pool_ != nullptr) pool_scope.emplace(thread_pool_.get());
   {
     NVTXScopedRange scope("RelaxVM: " + clo->func_name);
     clo->impl.CallPacked(ffi::PackedArgs(packed_args.data(), packed_args.size()), rv);
@@ -721,7 +862,15 @@ void VirtualMachineImpl::InitFuncPool() {
   }
 }
 
+void VirtualMachineImpl::ReleaseRegisters(VMFrame* curr_frame, Index pc) {
+  if (static_cast<size_t>(pc) + 1 >= exec_->release_offset.size()) return;
+  for (Index i = exec_->release_offset[pc]; i < exec_->release_offset[pc + 1]; ++i) {
+    curr_frame->register_file[exec_->release_regs[i]] = nullptr;
+  }
+}
+
 void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
+  Index pc = pc_;
   DLOG(INFO) << "\n  pc = " << pc_ << ", execute: " << GetFuncName(instr.func_idx);
   int args_begin_offset = instrument_ != nullptr ? 4 : 0;
   // Use the call arg stack from the current frame to increase reuse
@@ -745,7 +894,7 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
         break;
       }
       case Instruction::ArgKind::kConstIdx: {
-        call_args[arg_index] = this->const_pool_[arg.value()];
+        call_args[arg_index] = this->GetConstant(arg.value());
         break;
       }
       case Instruction::ArgKind::kFuncIdx: {
@@ -763,6 +912,25 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
 
   ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
 
+  std::optional<profiling::TraceScope> trace_scope;
+  if (profiling::IsTracing()) {
+    trace_scope.emplace("vm", GetFuncName(instr.func_idx), GetCallDevice(args));
+  }
+  std::optional<NVTXScopedRange> nvtx_range;
+  if (NVTXRangesEnabled()) nvtx_range.emplace(GetFuncName(instr.func_idx));
+  bool sampled = call_sampler_ != nullptr &&
+                 exec_->func_table[instr.func_idx].kind != VMFuncInfo::FuncKind::kVMFunc &&
+                 call_sampler_->ShouldSample(instr.func_idx);
+  Timer sample_timer;
+  std::chrono::steady_clock::time_point sample_begin;
+  if (sampled) {
+    if (std::optional<Device> device = GetCallDevice(args)) {
+      sample_timer = Timer::Start(device.value());
+    } else {
+      sample_begin = std::chrono::steady_clock::now();
+    }
+  }
+
   if (instrument_ == nullptr) {
     this->InvokeClosurePacked(func_pool_[instr.func_idx].cast<ObjectRef>(), args, &ret);
   } else {
@@ -795,61 +963,281 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
       instrument_.CallPacked(call_args.data(), call_args.size(), &rv);
     }
   }
+  nvtx_range.reset();
+  trace_scope.reset();
+  if (sampled) {
+    if (sample_timer.defined()) {
+      sample_timer->Stop();
+      call_sampler_->RecordDevice(instr.func_idx, std::move(sample_timer));
+    } else {
+      call_sampler_->RecordHost(
+          instr.func_idx, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - sample_begin)
+                              .count());
+    }
+  }
 
   // save the return value to the register
   // saving to special register is a NOP
   if (instr.dst < Instruction::kBeginSpecialReg) {
     WriteRegister(curr_frame, instr.dst, ret);
   }
+  // drop the registers that are dead after the call
+  ReleaseRegisters(curr_frame, pc);
   // increment pc
-  pc_++;
+  pc_ = pc + 1;
 }
 
-void VirtualMachineImpl::RunLoop() {
-  VMFrame* curr_frame = frames_.back().get();
+void VirtualMachineImpl::RunInstrCallsInOrder(VMFrame* curr_frame,
+                                              const std::vector<Index>& pcs) {
+  for (Index pc : pcs) {
+    pc_ = pc;
+    this->RunInstrCall(curr_frame, exec_->GetInstruction(pc));
+  }
+}
 
-  while (true) {
-    ICHECK_LT(static_cast<size_t>(pc_), exec_->instr_offset.size()) << "run into invalid section";
-    Instruction instr = exec_->GetInstruction(pc_);
-    switch (instr.op) {
-      case Opcode::Call: {
-        this->RunInstrCall(curr_frame, instr);
-        break;
+void VirtualMachineImpl::RunConcurrentCalls(VMFrame* curr_frame, const std::vector<Index>& pcs) {
+  if (instrument_ != nullptr) {
+    // The instrument sees the calls one at a time.
+    RunInstrCallsInOrder(curr_frame, pcs);
+    return;
+  }
+  // Copy the constants of the calls to the device first, the jobs then only read the pool.
+  for (Index pc : pcs) {
+    Instruction instr = exec_->GetInstruction(pc);
+    for (Index j = 0; j < instr.num_args; ++j) {
+      if (instr.args[j].kind() == Instruction::ArgKind::kConstIdx) {
+        this->GetConstant(instr.args[j].value());
       }
-      case Opcode::Ret: {
-        // If we have hit the point from which we started
-        // running, we should return to the caller breaking
-        // the dispatch loop.
-        return_value_ = ReadRegister(curr_frame, instr.result);
-        RegName caller_return_register = curr_frame->caller_return_register;
-        if (frames_.size() <= 1) {
-          // directly return if no other frame in the call stack.
-        } else {
-          // return from a local call.
-          // Update the current frame to be the parent frame.
-          VMFrame* parent_frame = frames_.end()[-2].get();
-          WriteRegister(parent_frame, caller_return_register, return_value_);
+    }
+  }
+  std::vector<std::exception_ptr> errors(pcs.size());
+  parallel_for_with_threading_backend(
+      [&](int64_t i) {
+        try {
+          Instruction instr = exec_->GetInstruction(pcs[i]);
+          std::vector<ffi::AnyView> call_args(instr.num_args);
+          for (Index j = 0; j < instr.num_args; ++j) {
+            Instruction::Arg arg = instr.args[j];
+            if (arg.kind() == Instruction::ArgKind::kRegister) {
+              call_args[j] = curr_frame->register_file[arg.value()];
+            } else if (arg.kind() == Instruction::ArgKind::kImmediate) {
+              call_args[j] = arg.value();
+            } else {
+              ICHECK(arg.kind() == Instruction::ArgKind::kConstIdx);
+              call_args[j] = this->const_pool_[arg.value()];
+            }
+          }
+          ffi::Any ret;
+          func_pool_[instr.func_idx].cast<ffi::Function>().CallPacked(call_args.data(),
+                                                                      instr.num_args, &ret);
+          // The calls of a step write distinct registers.
+          if (instr.dst < Instruction::kBeginSpecialReg) {
+            curr_frame->register_file[instr.dst] = std::move(ret);
+          }
+          ReleaseRegisters(curr_frame, pcs[i]);
+        } catch (...) {
+          errors[i] = std::current_exception();
         }
-        return;
-      }
-      case Opcode::Goto: {
-        pc_ += instr.pc_offset;
+      },
+      0, static_cast<int64_t>(pcs.size()));
+  for (const std::exception_ptr& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+void VirtualMachineImpl::RunDispatchSegment(VMFrame* curr_frame, const DispatchSegment& segment) {
+  for (const std::vector<Index>& step : segment.steps) {
+    if (step.size() == 1) {
+      RunInstrCallsInOrder(curr_frame, step);
+    } else {
+      this->RunConcurrentCalls(curr_frame, step);
+    }
+  }
+  pc_ = segment.end;
+}
+
+void VirtualMachineImpl::DecodeInstr(Index pc) {
+  Instruction instr = exec_->GetInstruction(pc);
+  DecodedInstr& decoded = decoded_[pc];
+  switch (instr.op) {
+    case Opcode::Call: {
+      decoded.reg = instr.dst;
+      ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
+      const auto* callee =
+          func_pool_[instr.func_idx].cast<ObjectRef>().as<ffi::Function::ContainerType>();
+      if (callee == nullptr || dispatch_segments_.count(pc)) {
+        decoded.kind = DecodedInstr::Kind::kCall;
         break;
       }
-      case Opcode::If: {
-        int64_t cond_val = ReadRegister(curr_frame, instr.cond).cast<int64_t>();
-        if (cond_val != 0) {
-          pc_++;
-        } else {
-          ICHECK_GT(instr.false_offset, 1);
-          pc_ += instr.false_offset;
+      decoded.callee = callee;
+      decoded.args.resize(instr.num_args);
+      decoded.reg_args.clear();
+      for (Index i = 0; i < instr.num_args; ++i) {
+        Instruction::Arg arg = instr.args[i];
+        switch (arg.kind()) {
+          case Instruction::ArgKind::kRegister: {
+            if (arg.value() < Instruction::kBeginSpecialReg) {
+              decoded.reg_args.emplace_back(i, arg.value());
+            } else {
+              // The special registers hold the same value for every call.
+              decoded.args[i] = ReadRegister(nullptr, arg.value());
+            }
+            break;
+          }
+          case Instruction::ArgKind::kImmediate: {
+            decoded.args[i] = arg.value();
+            break;
+          }
+          case Instruction::ArgKind::kConstIdx: {
+            // The constant is on its device from now on, so the view stays valid.
+            decoded.args[i] = this->GetConstant(arg.value());
+            break;
+          }
+          case Instruction::ArgKind::kFuncIdx: {
+            ICHECK_LT(static_cast<size_t>(arg.value()), this->func_pool_.size());
+            decoded.args[i] = this->func_pool_[arg.value()];
+            break;
+          }
+          default: {
+            LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+          }
         }
-        break;
       }
+      decoded.kind = DecodedInstr::Kind::kCallPacked;
+      break;
+    }
+    case Opcode::Ret: {
+      decoded.reg = instr.result;
+      decoded.kind = DecodedInstr::Kind::kRet;
+      break;
+    }
+    case Opcode::Goto: {
+      decoded.offset = instr.pc_offset;
+      decoded.kind = DecodedInstr::Kind::kGoto;
+      break;
+    }
+    case Opcode::If: {
+      decoded.reg = instr.cond;
+      decoded.offset = instr.false_offset;
+      decoded.kind = DecodedInstr::Kind::kIf;
+      break;
+    }
+  }
+}
+
+void VirtualMachineImpl::RunCallInstr(VMFrame* curr_frame) {
+  if (!dispatch_segments_.empty()) {
+    auto it = dispatch_segments_.find(pc_);
+    if (it != dispatch_segments_.end()) {
+      this->RunDispatchSegment(curr_frame, it->second);
+      return;
+    }
+  }
+  this->RunInstrCall(curr_frame, exec_->GetInstruction(pc_));
+}
+
+// Dispatch the decoded instructions through a table of labels where the compiler supports it,
+// which gives each handler its own indirect branch, and through a switch otherwise.
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_VM_COMPUTED_GOTO 1
+#define VM_TARGET(kind) target_##kind:
+#define VM_DISPATCH() goto* dispatch_table[static_cast<int>(next_instr().kind)]
+#else
+#define VM_TARGET(kind) case DecodedInstr::Kind::kind:
+#define VM_DISPATCH() continue
+#endif
+
+void VirtualMachineImpl::RunLoop() {
+  VMFrame* curr_frame = frames_.back().get();
+  // The packed calls skip RunInstrCall unless they are instrumented, sampled or traced.
+  bool direct_calls = instrument_ == nullptr && call_sampler_ == nullptr && !profiling::IsTracing();
+  auto next_instr = [this]() -> const DecodedInstr& {
+    ICHECK_LT(static_cast<size_t>(pc_), decoded_.size()) << "run into invalid section";
+    return decoded_[pc_];
+  };
+
+#ifdef TVM_VM_COMPUTED_GOTO
+  static void* const dispatch_table[] = {&&target_kUndecoded, &&target_kCallPacked,
+                                         &&target_kCall,      &&target_kRet,
+                                         &&target_kGoto,      &&target_kIf};
+  VM_DISPATCH();
+#else
+  while (true) {
+    switch (next_instr().kind) {
+#endif
+  VM_TARGET(kUndecoded) {
+    this->DecodeInstr(pc_);
+    VM_DISPATCH();
+  }
+  VM_TARGET(kCallPacked) {
+    const DecodedInstr& decoded = decoded_[pc_];
+    if (!direct_calls) {
+      this->RunCallInstr(curr_frame);
+      VM_DISPATCH();
+    }
+    Index pc = pc_;
+    RegName dst = decoded.reg;
+    std::vector<ffi::AnyView>& call_args = curr_frame->call_args;
+    call_args.assign(decoded.args.begin(), decoded.args.end());
+    for (const auto& [index, reg] : decoded.reg_args) {
+      call_args[index] = curr_frame->register_file[reg];
+    }
+    ffi::Any ret;
+    decoded.callee->CallPacked(call_args.data(), static_cast<int32_t>(call_args.size()), &ret);
+    if (dst < Instruction::kBeginSpecialReg) {
+      WriteRegister(curr_frame, dst, ret);
+    }
+    ReleaseRegisters(curr_frame, pc);
+    pc_ = pc + 1;
+    VM_DISPATCH();
+  }
+  VM_TARGET(kCall) {
+    this->RunCallInstr(curr_frame);
+    VM_DISPATCH();
+  }
+  VM_TARGET(kRet) {
+    // If we have hit the point from which we started
+    // running, we should return to the caller breaking
+    // the dispatch loop.
+    return_value_ = ReadRegister(curr_frame, decoded_[pc_].reg);
+    RegName caller_return_register = curr_frame->caller_return_register;
+    if (frames_.size() <= 1) {
+      // directly return if no other frame in the call stack.
+    } else {
+      // return from a local call.
+      // Update the current frame to be the parent frame.
+      VMFrame* parent_frame = frames_.end()[-2].get();
+      WriteRegister(parent_frame, caller_return_register, return_value_);
+    }
+    return;
+  }
+  VM_TARGET(kGoto) {
+    pc_ += decoded_[pc_].offset;
+    VM_DISPATCH();
+  }
+  VM_TARGET(kIf) {
+    const DecodedInstr& decoded = decoded_[pc_];
+    int64_t cond_val = ReadRegister(curr_frame, decoded.reg).cast<int64_t>();
+    ReleaseRegisters(curr_frame, pc_);
+    if (cond_val != 0) {
+      pc_++;
+    } else {
+      ICHECK_GT(decoded.offset, 1);
+      pc_ += decoded.offset;
     }
+    VM_DISPATCH();
   }
+#ifndef TVM_VM_COMPUTED_GOTO
+    }
+  }
+#endif
 }
 
+#undef VM_TARGET
+#undef VM_DISPATCH
+#undef TVM_VM_COMPUTED_GOTO
+
 ObjectPtr<VirtualMachine> VirtualMachine::Create() {
   return ffi::make_object<VirtualMachineImpl>();
 }
@@ -892,6 +1280,8 @@ void VirtualMachineImpl::_InvokeClosureStateful(std::string func_name) {
                << "; use `set_input` first.";
     return;
   }
+  std::optional<threading::IsolatedThreadPool::Scope> pool_scope;
+  if (thread_pool_ != nullptr) pool_scope.emplace(thread_pool_.get());
   outputs_[func_name] = this->InvokeClosureInternal(func_pool_[m.at(func_name)].cast<ObjectRef>(),
                                                     inputs_[func_name]);
 }
@@ -909,6 +1299,57 @@ void VirtualMachineImpl::_SetInstrument(ffi::PackedArgs args, ffi::Any* rv) {
   }
 }
 
+void VirtualMachineImpl::SetCallSampling(int64_t sample_every) {
+  CHECK_GE(sample_every, 0) << "ValueError: The sampling period must be non-negative, but got "
+                            << sample_every;
+  if (sample_every == 0) {
+    call_sampler_.reset();
+  } else {
+    call_sampler_ = std::make_unique<CallSampler>(exec_->func_table.size(), sample_every);
+  }
+}
+
+ffi::Map<ffi::String, ffi::Map<ffi::String, ffi::Any>> VirtualMachineImpl::GetCallSamplingReport() {
+  if (call_sampler_ == nullptr) {
+    return {};
+  }
+  std::vector<std::string> names;
+  names.reserve(exec_->func_table.size());
+  for (const VMFuncInfo& info : exec_->func_table) {
+    names.push_back(info.name);
+  }
+  return call_sampler_->Report(names);
+}
+
+void VirtualMachineImpl::_SetParallelDispatch(bool enable) {
+  dispatch_segments_.clear();
+  // The calls that start a segment are decoded differently.
+  decoded_.assign(exec_->instr_offset.size(), DecodedInstr());
+  if (!enable) return;
+  // The kernels of concurrent calls may launch parallel jobs themselves.
+  CHECK(threading::SupportsNestedLaunch())
+      << "ValueError: Parallel dispatch requires a thread pool that supports nested launches, "
+      << "e.g. TVM_THREAD_POOL_KIND=work_stealing";
+  for (const Device& dev : devices) {
+    CHECK(dev.device_type == kDLCPU)
+        << "ValueError: Parallel dispatch only supports CPU devices, but the VM uses " << dev;
+  }
+  dispatch_segments_ = PlanConcurrentDispatch(*exec_);
+}
+
+void VirtualMachineImpl::_SetThreadPoolCpus(ffi::Shape cpus) {
+  if (cpus.empty()) {
+    thread_pool_ = nullptr;
+    return;
+  }
+  std::vector<unsigned int> cpu_ids;
+  for (int64_t cpu : cpus) {
+    CHECK_GE(cpu, 0) << "ValueError: Invalid CPU id " << cpu;
+    cpu_ids.push_back(static_cast<unsigned int>(cpu));
+  }
+  thread_pool_ = std::make_shared<threading::IsolatedThreadPool>(cpu_ids);
+}
+
 void VirtualMachineImpl::_GetOutputArity(ffi::PackedArgs args, ffi::Any* rv) {
   std::string func_name = args[0].cast<std::string>();
   RegType out = LookupVMOutput(func_name);
@@ -993,7 +1434,19 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
           }
         }
 
-        prof_ = profiling::Profiler(devices, {}, {{ffi::String("Executor"), ffi::String("VM")}});
+        std::vector<profiling::MetricCollector> collectors;
+        if (UseHardwareCounters(devices)) {
+          std::string error;
+          profiling::MetricCollector collector =
+              profiling::CreatePerfEventMetricCollector({}, &error);
+          if (collector.defined()) {
+            collectors.push_back(collector);
+          } else {
+            VLOG(1) << "The CPU hardware counters are not collected: " << error;
+          }
+        }
+        prof_ = profiling::Profiler(devices, collectors,
+                                    {{ffi::String("Executor"), ffi::String("VM")}});
 
         auto inputs = GetInputsFor(f_name);
 
@@ -1019,17 +1472,40 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
         *rv = report_json;
 
         prof_ = std::nullopt;  // releases hardware counters
+        kernel_flops_.clear();
         if (clear_inputs) {
           // SetInput modifies the internal states of VM. Undo the change after profiling.
           ClearInputsFor(f_name);
         }
       });
+    } else if (name == "set_profile_flops") {
+      // set_profile_flops(kernel0, flops0, kernel1, flops1, ...), for the next profile. The
+      // arguments are flattened to be passed over RPC.
+      return ffi::Function([sptr_to_self, this](ffi::PackedArgs args, ffi::Any* rv) {
+        CHECK_EQ(args.size() % 2, 0) << "ValueError: Expect pairs of kernel name and FLOPs";
+        kernel_flops_.clear();
+        for (int i = 0; i < args.size(); i += 2) {
+          kernel_flops_[args[i].cast<std::string>()] =
+              static_cast<int64_t>(args[i + 1].cast<double>());
+        }
+      });
     } else {
       return VirtualMachineImpl::GetFunction(name);
     }
   }
 
  protected:
+  /*!
+   * \brief Whether to collect the CPU hardware counters of the calls, unless the
+   *        TVM_VM_PROFILE_HW_COUNTERS environment variable is set to 0.
+   */
+  static bool UseHardwareCounters(const std::vector<Device>& devices) {
+    const char* env = std::getenv("TVM_VM_PROFILE_HW_COUNTERS");
+    if (env != nullptr && std::string(env) == "0") return false;
+    return std::any_of(devices.begin(), devices.end(),
+                       [](const Device& dev) { return dev.device_type == kDLCPU; });
+  }
+
   void RunInstrCall(VMFrame* curr_frame, Instruction inst) override {
     bool profiling = false;
     if (prof_ && prof_->IsRunning()) {
@@ -1053,13 +1529,17 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
           auto reg = ReadRegister(curr_frame, arg.value());
           f_check_tensor_arg(reg);
         } else if (arg.kind() == Instruction::ArgKind::kConstIdx) {
-          const auto& const_val = this->const_pool_[arg.value()];
+          const auto& const_val = this->GetConstant(arg.value());
           f_check_tensor_arg(const_val);
         }
       }
 
       std::unordered_map<std::string, ffi::Any> metrics;
       metrics["Argument Shapes"] = profiling::ShapeString(arrs);
+      auto flops_it = kernel_flops_.find(f_name);
+      if (flops_it != kernel_flops_.end()) {
+        metrics["FLOPs"] = ObjectRef(ffi::make_object<profiling::CountNode>(flops_it->second));
+      }
 
       // If a suitable device is found, enable profiling.
       if (dev) {
@@ -1075,8 +1555,15 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
     }
   }
 
+  void RunConcurrentCalls(VMFrame* curr_frame, const std::vector<Index>& pcs) override {
+    // Profile the calls one at a time.
+    RunInstrCallsInOrder(curr_frame, pcs);
+  }
+
  private:
   std::optional<profiling::Profiler> prof_;
+  /*! \brief The estimated FLOPs of a call to each kernel, reported with its calls. */
+  std::unordered_map<std::string, int64_t> kernel_flops_;
 };
 
 ObjectPtr<VirtualMachine> VirtualMachine::CreateProfiler() {
@@ -1089,6 +1576,25 @@ ObjectPtr<VirtualMachine> VirtualMachine::CreateProfiler() {
   return nullptr;
 }
 #endif  // TVM_VM_ENABLE_PROFILER
+/*! \brief Get the virtual machine of a module created by the VM loader. */
+static VirtualMachine* GetVirtualMachine(const ffi::Module& vm_mod) {
+  CHECK_EQ(std::string(vm_mod->kind()), "relax.VirtualMachine")
+      << "ValueError: Expect a relax VirtualMachine module, but got " << vm_mod->kind();
+  return static_cast<VirtualMachine*>(const_cast<ffi::ModuleObj*>(vm_mod.operator->()));
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("vm.builtin.set_call_sampling",
+           [](ffi::Module vm_mod, int64_t sample_every) {
+             GetVirtualMachine(vm_mod)->SetCallSampling(sample_every);
+           })
+      .def("vm.builtin.get_call_sampling_report", [](ffi::Module vm_mod) {
+        return GetVirtualMachine(vm_mod)->GetCallSamplingReport();
+      });
+}
+
 }  // namespace vm
 }  // namespace runtime
 }  // namespace tvm
@@ -99,9 +99,9 @@ void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initiali
 
   // If the new kernel uses the same buffers in the same descriptor
   // set as an already-queued kernel, we don't need to initialize it
-  // again.  Since every VulkanWrappedFunc owns a single descriptor
-  // set, unless the same function is called with the same buffer
-  // arguments, deferred_initializer() will always be called.
+  // again.  Since VulkanWrappedFunc allocates a descriptor set for
+  // each set of buffer arguments, and only writes it on its first
+  // use, the synchronization above does not happen for its kernels.
   if (!std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
                    deferred_tokens_[deferred_token.descriptor_set_].end(),
                    [&](const VulkanStreamToken& token) {
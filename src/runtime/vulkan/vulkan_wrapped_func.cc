@@ -113,13 +113,27 @@ void VulkanWrappedFunc::operator()(ffi::PackedArgs args, ffi::Any* rv,
 
   // Otherwise, the more expensive deferred path.
   std::vector<ArgUnion64> pack_args_storage(pack_args, pack_args + num_pack_args_);
-  const auto& deferred_initializer = [&device, pipeline, descriptor_buffers]() {
+  VulkanStreamToken deferred_token;
+  deferred_token.buffers_.resize(descriptor_buffers.size());
+  for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
+    deferred_token.buffers_[i] = descriptor_buffers[i].buffer;
+  }
+  bool is_new_descriptor_set = false;
+  VkDescriptorSet descriptor_set = pipeline->GetDescriptorSet(
+      deferred_token.buffers_, &device.ThreadLocalStream(), &is_new_descriptor_set);
+  deferred_token.descriptor_set_ = descriptor_set;
+  const auto& deferred_initializer = [&device, pipeline, descriptor_set, descriptor_buffers,
+                                      is_new_descriptor_set]() {
+    if (!is_new_descriptor_set) {
+      // The descriptor set was written by an earlier launch with the same buffers.
+      return;
+    }
     std::vector<VkWriteDescriptorSet> write_descriptor_sets;
     write_descriptor_sets.resize(descriptor_buffers.size());
     for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
       write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
       write_descriptor_sets[i].pNext = nullptr;
-      write_descriptor_sets[i].dstSet = pipeline->descriptor_set;
+      write_descriptor_sets[i].dstSet = descriptor_set;
       write_descriptor_sets[i].dstBinding = i;
       write_descriptor_sets[i].dstArrayElement = 0;
       write_descriptor_sets[i].descriptorCount = 1;
@@ -137,14 +151,13 @@ void VulkanWrappedFunc::operator()(ffi::PackedArgs args, ffi::Any* rv,
     vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0,
                            nullptr);
   };
-  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars,
-                                 device_id](VulkanStreamState* state) {
+  const auto& deferred_kernel = [this, pipeline, descriptor_set, wl, pack_args_storage,
+                                 nbytes_scalars, device_id](VulkanStreamState* state) {
     auto& device = VulkanDeviceAPI::Global()->device(device_id);
 
     vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
     vkCmdBindDescriptorSets(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipeline->pipeline_layout, 0, 1, &(pipeline->descriptor_set), 0,
-                            nullptr);
+                            pipeline->pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
 
     if (pipeline->use_ubo) {
       auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
@@ -166,12 +179,6 @@ void VulkanWrappedFunc::operator()(ffi::PackedArgs args, ffi::Any* rv,
                          VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
                          1, &barrier_info, 0, nullptr, 0, nullptr);
   };
-  VulkanStreamToken deferred_token;
-  deferred_token.descriptor_set_ = pipeline->descriptor_set;
-  deferred_token.buffers_.resize(descriptor_buffers.size());
-  for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
-    deferred_token.buffers_[i] = descriptor_buffers[i].buffer;
-  }
   device.ThreadLocalStream().LaunchDeferred(deferred_initializer, deferred_kernel, deferred_token);
 
   if (device.UseDebugUtilsLabel()) {
@@ -184,6 +191,55 @@ void VulkanWrappedFunc::operator()(ffi::PackedArgs args, ffi::Any* rv,
   }
 }
 
+VkDescriptorSet VulkanPipeline::GetDescriptorSet(const std::vector<VkBuffer>& buffers,
+                                                 VulkanStream* stream, bool* is_new) {
+  std::lock_guard<std::mutex> lock(descriptor_mutex);
+  auto it = descriptor_sets.find(buffers);
+  if (it != descriptor_sets.end()) {
+    *is_new = false;
+    return it->second;
+  }
+  if (num_descriptor_sets == kMaxNumDescriptorSets) {
+    // Recycle all descriptor sets, once the queued kernels that use them have run.
+    stream->Synchronize();
+    for (VkDescriptorPool pool : descriptor_pools) {
+      VULKAN_CALL(vkResetDescriptorPool(*device, pool, 0));
+    }
+    descriptor_sets.clear();
+    num_descriptor_sets = 0;
+  }
+  size_t pool_index = num_descriptor_sets / kNumDescriptorSetsPerPool;
+  if (pool_index == descriptor_pools.size()) {
+    std::vector<VkDescriptorPoolSize> pool_sizes = descriptor_set_pool_sizes;
+    for (VkDescriptorPoolSize& pool_size : pool_sizes) {
+      pool_size.descriptorCount *= kNumDescriptorSetsPerPool;
+    }
+    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
+    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descrip_pool_cinfo.pNext = nullptr;
+    descrip_pool_cinfo.flags = 0;
+    descrip_pool_cinfo.maxSets = kNumDescriptorSetsPerPool;
+    descrip_pool_cinfo.poolSizeCount = pool_sizes.size();
+    descrip_pool_cinfo.pPoolSizes = pool_sizes.data();
+    VkDescriptorPool pool;
+    VULKAN_CALL(vkCreateDescriptorPool(*device, &descrip_pool_cinfo, nullptr, &pool));
+    descriptor_pools.push_back(pool);
+  }
+
+  VkDescriptorSetAllocateInfo alloc_info;
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.pNext = nullptr;
+  alloc_info.descriptorPool = descriptor_pools[pool_index];
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &descriptor_set_layout;
+  VkDescriptorSet descriptor_set;
+  VULKAN_CALL(vkAllocateDescriptorSets(*device, &alloc_info, &descriptor_set));
+  ++num_descriptor_sets;
+  descriptor_sets.emplace(buffers, descriptor_set);
+  *is_new = true;
+  return descriptor_set;
+}
+
 VulkanModuleNode::~VulkanModuleNode() {
   // cleanup vulkan related caches.
   for (size_t device_id = 0; device_id < ecache_.size(); ++device_id) {
@@ -198,7 +254,9 @@ VulkanModuleNode::~VulkanModuleNode() {
       }
       vkDestroyPipeline(device, pe->pipeline, nullptr);
       vkDestroyPipelineLayout(device, pe->pipeline_layout, nullptr);
-      vkDestroyDescriptorPool(device, pe->descriptor_pool, nullptr);
+      for (VkDescriptorPool pool : pe->descriptor_pools) {
+        vkDestroyDescriptorPool(device, pool, nullptr);
+      }
       vkDestroyDescriptorSetLayout(device, pe->descriptor_set_layout, nullptr);
       vkDestroyShaderModule(device, pe->shader, nullptr);
     }
@@ -229,6 +287,7 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   }
   // Create new pipeline
   auto pe = std::make_shared<VulkanPipeline>();
+  pe->device = &device;
   {
     // create shader
     auto sit = smap_.find(func_name);
@@ -319,23 +378,8 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   }
 
   if (!device.UseImmediate()) {
-    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
-    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descrip_pool_cinfo.pNext = nullptr;
-    descrip_pool_cinfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descrip_pool_cinfo.maxSets = 1;
-    descrip_pool_cinfo.poolSizeCount = descriptor_set_pool_sizes.size();
-    descrip_pool_cinfo.pPoolSizes = descriptor_set_pool_sizes.data();
-    VULKAN_CALL(
-        vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &(pe->descriptor_pool)));
-
-    VkDescriptorSetAllocateInfo alloc_info;
-    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    alloc_info.pNext = nullptr;
-    alloc_info.descriptorPool = pe->descriptor_pool;
-    alloc_info.descriptorSetCount = 1;
-    alloc_info.pSetLayouts = &(pe->descriptor_set_layout);
-    VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &(pe->descriptor_set)));
+    // The descriptor sets are allocated on the first launch with each set of buffers.
+    pe->descriptor_set_pool_sizes = descriptor_set_pool_sizes;
   }
 
   VkPushConstantRange crange;
@@ -21,6 +21,7 @@
 #define TVM_RUNTIME_VULKAN_VULKAN_WRAPPED_FUNC_H_
 
 #include <array>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -43,12 +44,42 @@ struct VulkanPipeline {
   VulkanDevice* device{nullptr};
   VkShaderModule shader{VK_NULL_HANDLE};
   VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
-  VkDescriptorPool descriptor_pool{VK_NULL_HANDLE};
-  VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
   VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
   VkPipeline pipeline{VK_NULL_HANDLE};
   VkDescriptorUpdateTemplateKHR descriptor_update_template{VK_NULL_HANDLE};
   bool use_ubo{false};
+
+  /*!
+   * \brief Get the descriptor set bound to the given buffers, in the deferred mode.
+   *
+   * Every set of buffers the function is launched with gets its own descriptor set, which is
+   * written once and reused by the later launches with the same buffers. The launches with
+   * different buffers then neither rewrite a descriptor set nor wait for the queued kernels
+   * that use it, which they would with a single descriptor set per pipeline.
+   *
+   * \param buffers The buffers of the bindings, in binding order.
+   * \param stream The stream the descriptor set is used on, which is synchronized before the
+   *  descriptor sets are recycled.
+   * \param is_new Set to whether the descriptor set is newly allocated and must be written.
+   * \return The descriptor set.
+   */
+  VkDescriptorSet GetDescriptorSet(const std::vector<VkBuffer>& buffers, VulkanStream* stream,
+                                   bool* is_new);
+
+  /*! \brief The maximum number of descriptor sets cached before they are recycled. */
+  static constexpr size_t kMaxNumDescriptorSets = 1024;
+  /*! \brief The number of descriptor sets allocated from each descriptor pool. */
+  static constexpr uint32_t kNumDescriptorSetsPerPool = 64;
+  /*! \brief The descriptor types of a single descriptor set. */
+  std::vector<VkDescriptorPoolSize> descriptor_set_pool_sizes;
+  /*! \brief The descriptor pools, in the deferred mode. */
+  std::vector<VkDescriptorPool> descriptor_pools;
+  /*! \brief The number of descriptor sets allocated from the pools since they were reset. */
+  size_t num_descriptor_sets{0};
+  /*! \brief The descriptor sets by the buffers they are bound to. */
+  std::map<std::vector<VkBuffer>, VkDescriptorSet> descriptor_sets;
+  /*! \brief Guards the descriptor sets, which are shared by the streams of all threads. */
+  std::mutex descriptor_mutex;
 };
 
 class VulkanModuleNode;
@@ -23,6 +23,11 @@
  */
 #include "workspace_pool.h"
 
+#include <tvm/ffi/extra/c_env_api.h>
+#include <tvm/ffi/reflection/registry.h>
+
+#include <algorithm>
+#include <atomic>
 #include <memory>
 
 namespace tvm {
@@ -30,6 +35,12 @@ namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// default size of the chunks of an arena.
+constexpr size_t kDefaultArenaChunkSize = 1 << 20;
+
+// The arena mode of the workspace pools, see WorkspacePool::SetArenaMode.
+static std::atomic<bool> arena_enabled{false};
+static std::atomic<size_t> arena_chunk_size{kDefaultArenaChunkSize};
 
 class WorkspacePool::Pool {
  public:
@@ -133,6 +144,107 @@ class WorkspacePool::Pool {
   std::vector<Entry> allocated_;
 };
 
+class WorkspacePool::Arena {
+ public:
+  // allocate by bumping the offset in the current chunk
+  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
+    nbytes = (nbytes + (kTempAllocaAlignment - 1)) / kTempAllocaAlignment * kTempAllocaAlignment;
+    if (nbytes == 0) nbytes = kTempAllocaAlignment;
+    // Skip the chunks too small for the request; their space is reclaimed at the reset.
+    while (current_ < chunks_.size() && offset_ + nbytes > chunks_[current_].size) {
+      ++current_;
+      offset_ = 0;
+    }
+    if (current_ == chunks_.size()) {
+      // grow geometrically so that a workload needs few chunks before the merge at the reset
+      size_t size = std::max({nbytes, reserved_, arena_chunk_size.load()});
+      size = (size + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
+      chunks_.push_back(Chunk{AllocChunk(dev, device, size), size});
+      reserved_ += size;
+    }
+    void* data = static_cast<char*>(chunks_[current_].data) + offset_;
+    allocated_.push_back(Entry{data, current_, offset_});
+    offset_ += nbytes;
+    return data;
+  }
+  // Whether the pointer is a workspace allocated by the arena and not freed yet.
+  bool Owns(void* data) const {
+    return std::any_of(allocated_.begin(), allocated_.end(),
+                       [data](const Entry& e) { return e.data == data; });
+  }
+  // free the workspace, rolling back the offset if it is the last allocated
+  void Free(Device dev, DeviceAPI* device, void* data) {
+    if (allocated_.back().data == data) {
+      current_ = allocated_.back().chunk;
+      offset_ = allocated_.back().offset;
+      allocated_.pop_back();
+    } else {
+      auto it = std::find_if(allocated_.begin(), allocated_.end(),
+                             [data](const Entry& e) { return e.data == data; });
+      ICHECK(it != allocated_.end()) << "trying to free things that has not been allocated";
+      allocated_.erase(it);
+    }
+    if (allocated_.empty()) {
+      Reset(dev, device);
+    }
+  }
+  // Whether no workspace is allocated from the arena.
+  bool Idle() const { return allocated_.empty(); }
+  // Release all resources
+  void Release(Device dev, DeviceAPI* device) {
+    for (const Chunk& chunk : chunks_) {
+      device->FreeDataSpace(dev, chunk.data);
+    }
+    chunks_.clear();
+    reserved_ = 0;
+    current_ = 0;
+    offset_ = 0;
+  }
+
+ private:
+  /*! \brief a chunk of device memory */
+  struct Chunk {
+    void* data;
+    size_t size;
+  };
+  /*! \brief an allocation, with the position of the arena before it */
+  struct Entry {
+    void* data;
+    size_t chunk;
+    size_t offset;
+  };
+
+  static void* AllocChunk(Device dev, DeviceAPI* device, size_t size) {
+    DLDataType type;
+    type.code = kDLUInt;
+    type.bits = 8;
+    type.lanes = 1;
+    return device->AllocDataSpace(dev, size, kTempAllocaAlignment, type);
+  }
+  // Start over from the first chunk, merging the chunks into one so the next run fits in it.
+  void Reset(Device dev, DeviceAPI* device) {
+    if (chunks_.size() > 1) {
+      size_t size = reserved_;
+      Release(dev, device);
+      chunks_.push_back(Chunk{AllocChunk(dev, device, size), size});
+      reserved_ = size;
+    }
+    current_ = 0;
+    offset_ = 0;
+  }
+
+  /*! \brief The chunks, in the order they are bumped through */
+  std::vector<Chunk> chunks_;
+  /*! \brief The total size of the chunks */
+  size_t reserved_{0};
+  /*! \brief The index of the current chunk */
+  size_t current_{0};
+  /*! \brief The offset of the next allocation in the current chunk */
+  size_t offset_{0};
+  /*! \brief List of allocated items */
+  std::vector<Entry> allocated_;
+};
+
 WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
     : device_type_(device_type), device_(device) {}
 
@@ -146,22 +258,79 @@ WorkspacePool::~WorkspacePool() {
       delete array_[i];
     }
   }
+  for (auto& kv : arenas_) {
+    Device dev;
+    dev.device_type = device_type_;
+    dev.device_id = kv.first.first;
+    kv.second->Release(dev, device_);
+    delete kv.second;
+  }
 }
 
 void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
   if (static_cast<size_t>(dev.device_id) >= array_.size()) {
     array_.resize(dev.device_id + 1, nullptr);
   }
+  if (arena_enabled.load(std::memory_order_relaxed)) {
+    TVMStreamHandle stream = TVMFFIEnvGetStream(device_type_, dev.device_id);
+    Arena*& arena = arenas_[{dev.device_id, stream}];
+    if (arena == nullptr) {
+      arena = new Arena();
+    }
+    return arena->Alloc(dev, device_, size);
+  }
   if (array_[dev.device_id] == nullptr) {
     array_[dev.device_id] = new Pool();
   }
+  ReleaseIdleArenas(dev.device_id);
   return array_[dev.device_id]->Alloc(dev, device_, size);
 }
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
+  if (!arenas_.empty()) {
+    // The workspace is usually freed on the stream it is allocated on.
+    auto it = arenas_.find({dev.device_id, TVMFFIEnvGetStream(device_type_, dev.device_id)});
+    if (it == arenas_.end() || !it->second->Owns(ptr)) {
+      it = std::find_if(arenas_.begin(), arenas_.end(), [&](const auto& kv) {
+        return kv.first.first == dev.device_id && kv.second->Owns(ptr);
+      });
+    }
+    if (it != arenas_.end()) {
+      it->second->Free(dev, device_, ptr);
+      return;
+    }
+  }
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
   array_[dev.device_id]->Free(ptr);
 }
 
+void WorkspacePool::ReleaseIdleArenas(int device_id) {
+  for (auto it = arenas_.begin(); it != arenas_.end();) {
+    if (it->first.first == device_id && it->second->Idle()) {
+      Device dev;
+      dev.device_type = device_type_;
+      dev.device_id = device_id;
+      it->second->Release(dev, device_);
+      delete it->second;
+      it = arenas_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void WorkspacePool::SetArenaMode(bool enabled, size_t chunk_size) {
+  arena_chunk_size.store(chunk_size == 0 ? kDefaultArenaChunkSize : chunk_size);
+  arena_enabled.store(enabled);
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("runtime.WorkspacePoolSetArenaMode", [](bool enabled, int64_t chunk_size) {
+    CHECK_GE(chunk_size, 0) << "ValueError: The chunk size must be non-negative";
+    WorkspacePool::SetArenaMode(enabled, static_cast<size_t>(chunk_size));
+  });
+}
+
 }  // namespace runtime
 }  // namespace tvm
@@ -26,7 +26,9 @@
 
 #include <tvm/runtime/device_api.h>
 
+#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -41,6 +43,11 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  In the arena mode, see SetArenaMode, each stream of a device has an arena that bump-allocates
+ *  from chunks of device memory and resets once all of its allocations are freed, i.e. at the
+ *  exit of the function that allocated them. The arena then merges its chunks into one, so that
+ *  the steady state allocates in constant time without calling into the device.
  */
 class TVM_DLL WorkspacePool {
  public:
@@ -65,11 +72,23 @@ class TVM_DLL WorkspacePool {
    * \param ptr The pointer to be freed.
    */
   void FreeWorkspace(Device dev, void* ptr);
+  /*!
+   * \brief Switch the workspace pools of all threads to or from the arena mode. An existing pool
+   * switches once it has no workspace allocated.
+   * \param enabled Whether to use the arena mode.
+   * \param chunk_size The minimum size of the chunks an arena allocates from the device.
+   */
+  static void SetArenaMode(bool enabled, size_t chunk_size);
 
  private:
   class Pool;
+  class Arena;
+  /*! \brief Release the arenas of a device that have no workspace allocated. */
+  void ReleaseIdleArenas(int device_id);
   /*! \brief pool of device local array */
   std::vector<Pool*> array_;
+  /*! \brief The arenas, by device id and stream */
+  std::map<std::pair<int, TVMStreamHandle>, Arena*> arenas_;
   /*! \brief device type this pool support */
   DLDeviceType device_type_;
   /*! \brief The device API */
@@ -16,7 +16,19 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <tvm/ffi/reflection/accessor.h>
+#include <tvm/ffi/reflection/registry.h>
 #include <tvm/ir/type.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "./utils.h"
 
@@ -55,6 +67,52 @@ struct SortableFunction {
   }
 };
 
+/*!
+ * \brief Define the module in the frame, and add the statements of its attributes and global
+ *  infos to the frame.
+ */
+IdDoc DefineModule(const IRModule& mod, const AccessPath& p, const IRDocsifier& d,
+                   const IRFrame& f) {
+  IdDoc module_doc = d->Define(mod, f, GetBindingName(d).value_or("Module"));
+  f->global_infos = &mod->global_infos;
+  if (mod->attrs.defined() && !mod->attrs->dict.empty()) {
+    f->stmts.push_back(
+        ExprStmtDoc(IR(d, "module_attrs")  //
+                        ->Call({d->AsDoc<ExprDoc>(mod->attrs, p->Attr("attrs"))})));
+  }
+  if (mod->global_infos.defined() && !mod->global_infos.empty()) {
+    f->stmts.push_back(ExprStmtDoc(
+        IR(d, "module_global_infos")  //
+            ->Call({d->AsDoc<ExprDoc>(mod->global_infos, p->Attr("global_infos"))})));
+  }
+  return module_doc;
+}
+
+/*! \brief Print a function of the module to the statement in the body of the module class. */
+StmtDoc PrintModuleFunction(const GlobalVar& gv, const BaseFunc& base_func, const AccessPath& p,
+                            const IRDocsifier& d) {
+  d->cfg->binding_names.push_back(gv->name_hint);
+  Doc doc = d->AsDoc(base_func, p->Attr("functions")->MapItem(gv));
+  d->cfg->binding_names.pop_back();
+  if (const auto* stmt_block = doc.as<StmtBlockDocNode>()) {
+    StmtDoc stmt = stmt_block->stmts.back();
+    stmt->source_paths = std::move(doc->source_paths);
+    return stmt;
+  } else if (auto stmt = doc.as<StmtDoc>()) {
+    return stmt.value();
+  } else if (auto func = doc.as<FunctionDoc>()) {
+    return func.value();
+  } else if (auto expr = doc.as<ExprDoc>()) {
+    ExprDoc lhs = IdDoc(gv->name_hint);
+    return AssignDoc(lhs, expr.value(), std::nullopt);
+  }
+  LOG(FATAL) << "TypeError: "
+             << "Expected IRModule to only contain functions, "
+             << " but mod[" << gv->name_hint << "] with type  " << base_func->GetTypeKey()
+             << " produced Doc type of " << doc->GetTypeKey();
+  throw;
+}
+
 TVM_STATIC_IR_FUNCTOR(IRDocsifier, vtable)
     .set_dispatch<IRModule>("", [](IRModule mod, AccessPath p, IRDocsifier d) -> Doc {
       std::vector<SortableFunction> functions;
@@ -64,20 +122,8 @@ TVM_STATIC_IR_FUNCTOR(IRDocsifier, vtable)
       std::sort(functions.begin(), functions.end());
       With<IRFrame> f(d);
       (*f)->AddDispatchToken(d, "ir");
-      IdDoc module_doc = d->Define(mod, f(), GetBindingName(d).value_or("Module"));
-      (*f)->global_infos = &mod->global_infos;
-      if (mod->attrs.defined() && !mod->attrs->dict.empty()) {
-        (*f)->stmts.push_back(
-            ExprStmtDoc(IR(d, "module_attrs")  //
-                            ->Call({d->AsDoc<ExprDoc>(mod->attrs, p->Attr("attrs"))})));
-      }
-      if (mod->global_infos.defined() && !mod->global_infos.empty()) {
-        (*f)->stmts.push_back(ExprStmtDoc(
-            IR(d, "module_global_infos")  //
-                ->Call({d->AsDoc<ExprDoc>(mod->global_infos, p->Attr("global_infos"))})));
-      }
+      IdDoc module_doc = DefineModule(mod, p, d, *f);
       // Declare GlobalVars first
-      IdDoc module_alias = d->cfg->module_alias.empty() ? module_doc : IdDoc(d->cfg->module_alias);
       for (const auto& entry : functions) {
         const GlobalVar& gv = entry.gv;
         d->Define(gv, f(), [=]() {
@@ -86,28 +132,7 @@ TVM_STATIC_IR_FUNCTOR(IRDocsifier, vtable)
       }
       // Print functions
       for (const auto& entry : functions) {
-        const GlobalVar& gv = entry.gv;
-        const BaseFunc& base_func = entry.func;
-        d->cfg->binding_names.push_back(gv->name_hint);
-        Doc doc = d->AsDoc(base_func, p->Attr("functions")->MapItem(gv));
-        d->cfg->binding_names.pop_back();
-        if (const auto* stmt_block = doc.as<StmtBlockDocNode>()) {
-          (*f)->stmts.push_back(stmt_block->stmts.back());
-          (*f)->stmts.back()->source_paths = std::move(doc->source_paths);
-        } else if (auto stmt = doc.as<StmtDoc>()) {
-          (*f)->stmts.push_back(stmt.value());
-        } else if (auto func = doc.as<FunctionDoc>()) {
-          (*f)->stmts.push_back(func.value());
-        } else if (auto expr = doc.as<ExprDoc>()) {
-          ExprDoc lhs = IdDoc(gv->name_hint);
-          AssignDoc assignment(lhs, expr.value(), std::nullopt);
-          (*f)->stmts.push_back(assignment);
-        } else {
-          LOG(FATAL) << "TypeError: "
-                     << "Expected IRModule to only contain functions, "
-                     << " but mod[" << gv->name_hint << "] with type  " << base_func->GetTypeKey()
-                     << " produced Doc type of " << doc->GetTypeKey();
-        }
+        (*f)->stmts.push_back(PrintModuleFunction(entry.gv, entry.func, p, d));
       }
       return HeaderWrapper(d, ClassDoc(module_doc, {IR(d, "ir_module")}, (*f)->stmts));
     });
@@ -170,6 +195,195 @@ TVM_SCRIPT_REPR(FuncTypeNode, ReprPrintIR);
 TVM_SCRIPT_REPR(RangeNode, ReprPrintIR);
 TVM_SCRIPT_REPR(IRModuleNode, ReprPrintIRModule);
 
+namespace {
+
+/*! \brief The script of a function of the module, printed on its own. */
+struct FunctionScript {
+  std::string text;
+  /*! \brief Whether the function is printed as a `def`, which ends with a blank line. */
+  bool is_function_doc = false;
+  bool has_metadata = false;
+  std::unordered_set<std::string> ir_usage;
+};
+
+/*! \brief The frames of the module printer, with the module and its global infos defined. */
+struct ModuleFrames {
+  With<IRFrame> outer;
+  With<IRFrame> module;
+  IdDoc module_doc{""};
+
+  ModuleFrames(const IRModule& mod, const IRDocsifier& d) : outer(d), module(d) {
+    (*outer)->AddDispatchToken(d, "ir");
+    (*module)->AddDispatchToken(d, "ir");
+    module_doc = DefineModule(mod, AccessPath::Root(), d, *module);
+  }
+};
+
+PrinterConfig CopyPrinterConfig(const PrinterConfig& cfg) {
+  return PrinterConfig(ffi::make_object<PrinterConfigNode>(*cfg.get()));
+}
+
+/*! \brief The GlobalVars of the module that the function refers to. */
+std::vector<GlobalVar> CollectGlobalVars(const IRModule& mod, const BaseFunc& func) {
+  std::vector<GlobalVar> gvars;
+  std::unordered_set<const Object*> visited;
+  std::vector<ObjectRef> stack = {func};
+  auto push = [&](const ffi::Any& value) {
+    if (std::optional<ObjectRef> obj = value.as<ObjectRef>()) {
+      if (obj->defined() && visited.insert(obj->get()).second) stack.push_back(*obj);
+    }
+  };
+  while (!stack.empty()) {
+    ObjectRef obj = stack.back();
+    stack.pop_back();
+    if (auto gv = obj.as<GlobalVar>()) {
+      if (mod->functions.count(gv.value())) gvars.push_back(gv.value());
+    } else if (const auto* array = obj.as<ffi::ArrayObj>()) {
+      for (const ffi::Any& element : *array) push(element);
+    } else if (const auto* map = obj.as<ffi::MapObj>()) {
+      for (const auto& kv : *map) {
+        push(kv.first);
+        push(kv.second);
+      }
+    } else {
+      const TVMFFITypeInfo* tinfo = TVMFFIGetTypeInfo(obj->type_index());
+      if (tinfo->metadata != nullptr) {
+        ffi::reflection::ForEachFieldInfo(tinfo, [&](const TVMFFIFieldInfo* field_info) {
+          push(ffi::reflection::FieldGetter(field_info)(obj));
+        });
+      }
+    }
+  }
+  return gvars;
+}
+
+/*!
+ * \brief Print a function with a printer of its own, in the same context as in the module
+ *  class, so that its text is that of the function in the script of the whole module.
+ */
+FunctionScript PrintFunctionScript(const IRModule& mod, const GlobalVar& gv,
+                                   const BaseFunc& func, const PrinterConfig& cfg) {
+  FunctionScript script;
+  PrinterConfig func_cfg = CopyPrinterConfig(cfg);
+  IRDocsifier d(func_cfg);
+  StmtDoc stmt{nullptr};
+  {
+    ModuleFrames frames(mod, d);
+    AccessPath p = AccessPath::Root();
+    for (const GlobalVar& ref : CollectGlobalVars(mod, func)) {
+      d->Define(ref, frames.module(), [=]() {
+        return d->AsDoc<ExprDoc>(mod, p->Attr("global_vars"))->Attr(ref->name_hint);
+      });
+    }
+    stmt = PrintModuleFunction(gv, func, p, d);
+  }
+  script.is_function_doc = stmt->IsInstance<FunctionDocNode>();
+  script.has_metadata = !d->metadata.empty();
+  script.ir_usage = d->ir_usage;
+  script.text = DocToPythonScript(stmt, func_cfg);
+  return script;
+}
+
+/*! \brief The script of the module up to the first line of the body of the module class. */
+std::string PrintModuleScriptPrefix(const IRModule& mod, const PrinterConfig& cfg,
+                                    const std::unordered_set<std::string>& ir_usage) {
+  static const char* kPlaceholder = "__tvm_script_function__";
+  PrinterConfig prefix_cfg = CopyPrinterConfig(cfg);
+  IRDocsifier d(prefix_cfg);
+  Doc doc{nullptr};
+  {
+    ModuleFrames frames(mod, d);
+    ffi::Array<StmtDoc> stmts = (*frames.module)->stmts;
+    stmts.push_back(ExprStmtDoc(IdDoc(kPlaceholder)));
+    ClassDoc module_class(frames.module_doc, {IR(d, "ir_module")}, stmts);
+    d->ir_usage.insert(ir_usage.begin(), ir_usage.end());
+    doc = HeaderWrapper(d, module_class);
+  }
+  std::string text = DocToPythonScript(doc, prefix_cfg);
+  size_t pos = text.rfind("\n" + std::string(cfg->indent_spaces, ' ') + kPlaceholder);
+  ICHECK_NE(pos, std::string::npos);
+  return text.substr(0, pos);
+}
+
+/*! \brief Write the lines of the text, indented by one level except the empty ones. */
+void WriteIndented(std::ostream& os, const std::string& text, const std::string& indent) {
+  size_t begin = 0;
+  while (true) {
+    size_t end = std::min(text.find('\n', begin), text.size());
+    if (end > begin) os << indent;
+    os.write(text.data() + begin, end - begin);
+    if (end == text.size()) break;
+    os << '\n';
+    begin = end + 1;
+  }
+}
+
+}  // namespace
+
+void PrintIRModuleScript(const IRModule& mod, const PrinterConfig& cfg, int num_threads,
+                         std::ostream& os) {
+  CHECK(!cfg->show_meta) << "ValueError: The per-function printer does not support show_meta, "
+                         << "as the metadata of the functions are indexed separately";
+  CHECK(!cfg->print_line_numbers)
+      << "ValueError: The per-function printer does not support print_line_numbers";
+  std::vector<SortableFunction> functions;
+  for (const auto& kv : mod->functions) {
+    functions.push_back(SortableFunction(kv));
+  }
+  if (functions.empty()) {
+    os << ReprPrintIRModule(mod, CopyPrinterConfig(cfg));
+    return;
+  }
+  std::sort(functions.begin(), functions.end());
+
+  std::vector<FunctionScript> scripts(functions.size());
+  auto f_print = [&](int thread_id, int i) {
+    scripts[i] = PrintFunctionScript(mod, functions[i].gv, functions[i].func, cfg);
+  };
+  if (num_threads <= 0) num_threads = runtime::threading::MaxConcurrency();
+  if (num_threads == 1) {
+    for (int i = 0; i < static_cast<int>(functions.size()); ++i) f_print(0, i);
+  } else {
+    support::parallel_for_dynamic(0, static_cast<int>(functions.size()), num_threads, f_print);
+  }
+
+  std::unordered_set<std::string> ir_usage;
+  bool has_metadata = false;
+  for (const FunctionScript& script : scripts) {
+    ir_usage.insert(script.ir_usage.begin(), script.ir_usage.end());
+    has_metadata |= script.has_metadata;
+  }
+  os << PrintModuleScriptPrefix(mod, cfg, ir_usage);
+  std::string indent(cfg->indent_spaces, ' ');
+  for (size_t i = 0; i < scripts.size(); ++i) {
+    os << '\n';
+    WriteIndented(os, scripts[i].text, indent);
+    // the blank line after a function, unless it would end the script
+    if (scripts[i].is_function_doc && (has_metadata || i + 1 < scripts.size())) os << '\n';
+  }
+  if (has_metadata) {
+    os << "\n# Metadata omitted. Use show_meta=True in script() method to show it.";
+  }
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("script.printer.IRModuleScriptPerFunction",
+           [](IRModule mod, PrinterConfig cfg, int num_threads) {
+             std::ostringstream os;
+             PrintIRModuleScript(mod, cfg, num_threads, os);
+             return os.str();
+           })
+      .def("script.printer.IRModuleScriptToFile",
+           [](IRModule mod, PrinterConfig cfg, ffi::String path, int num_threads) {
+             std::ofstream os(path);
+             CHECK(os.is_open()) << "RuntimeError: Cannot open " << path << " to write the script";
+             PrintIRModuleScript(mod, cfg, num_threads, os);
+             os << '\n';
+           });
+}
+
 }  // namespace printer
 }  // namespace script
 }  // namespace tvm
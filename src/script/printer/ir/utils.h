@@ -22,10 +22,12 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/ir/expr.h>
 #include <tvm/ir/function.h>
+#include <tvm/ir/module.h>
 #include <tvm/ir/op.h>
 #include <tvm/script/printer/ir_docsifier.h>
 #include <tvm/support/with.h>
 
+#include <ostream>
 #include <string>
 #include <utility>
 
@@ -67,6 +69,23 @@ inline std::string ReprPrintIR(const ObjectRef& obj, const PrinterConfig& cfg) {
   return Docsify(obj, d, *f, cfg);
 }
 
+/*!
+ * \brief Print the IRModule to TVMScript one function at a time.
+ *
+ * Each function is docsified and printed to text by a printer of its own, so that the Doc of
+ * one function at a time is alive on each thread instead of that of the whole module, and the
+ * functions are printed in parallel. The texts are written in the order of the module script,
+ * which is the same as printing the whole module, except that the indices of the omitted
+ * metadata restart in each function.
+ *
+ * \param mod The IRModule to print.
+ * \param cfg The printer config, show_meta and print_line_numbers are not supported.
+ * \param num_threads The number of threads to print the functions, or 0 for all the cores.
+ * \param os The stream to write the script.
+ */
+void PrintIRModuleScript(const IRModule& mod, const PrinterConfig& cfg, int num_threads,
+                         std::ostream& os);
+
 }  // namespace printer
 }  // namespace script
 }  // namespace tvm
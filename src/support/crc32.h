@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file crc32.h
+ * \brief The CRC-32 checksum of zlib and ethernet, used to check the integrity of transfers.
+ */
+#ifndef TVM_SUPPORT_CRC32_H_
+#define TVM_SUPPORT_CRC32_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tvm {
+namespace support {
+
+/*!
+ * \brief Compute the CRC-32 of a byte array.
+ * \param data The bytes.
+ * \param nbytes The number of bytes.
+ * \param crc The CRC-32 of the bytes before data, to compute it over several arrays.
+ * \return The CRC-32 of the bytes.
+ */
+inline uint32_t CRC32(const void* data, size_t nbytes, uint32_t crc = 0) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      table[i] = c;
+    }
+    return table;
+  }();
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < nbytes; ++i) {
+    crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+}  // namespace support
+}  // namespace tvm
+#endif  // TVM_SUPPORT_CRC32_H_
@@ -46,6 +46,14 @@
 #define TVM_INFO_USE_NVTX "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_CUFILE
+#define TVM_INFO_USE_CUFILE "NOT-FOUND"
+#endif
+
+#ifndef TVM_INFO_USE_CUPTI
+#define TVM_INFO_USE_CUPTI "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_NCCL
 #define TVM_INFO_USE_NCCL "NOT-FOUND"
 #endif
@@ -254,6 +262,10 @@
 #define TVM_INFO_USE_NVSHMEM "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_ZSTD
+#define TVM_INFO_USE_ZSTD "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_NNAPI_CODEGEN
 #define TVM_INFO_USE_NNAPI_CODEGEN "NOT-FOUND"
 #endif
@@ -299,6 +311,8 @@ TVM_DLL ffi::Map<ffi::String, ffi::String> GetLibInfo() {
       {"USE_CUBLAS", TVM_INFO_USE_CUBLAS},
       {"USE_CUDA", TVM_INFO_USE_CUDA},
       {"USE_NVTX", TVM_INFO_USE_NVTX},
+      {"USE_CUFILE", TVM_INFO_USE_CUFILE},
+      {"USE_CUPTI", TVM_INFO_USE_CUPTI},
       {"USE_NCCL", TVM_INFO_USE_NCCL},
       {"USE_MSCCL", TVM_INFO_USE_MSCCL},
       {"USE_CUDNN", TVM_INFO_USE_CUDNN},
@@ -361,6 +375,7 @@ TVM_DLL ffi::Map<ffi::String, ffi::String> GetLibInfo() {
       {"USE_NVSHMEM", TVM_INFO_USE_NVSHMEM},
       {"USE_NNAPI_CODEGEN", TVM_INFO_USE_NNAPI_CODEGEN},
       {"USE_NNAPI_RUNTIME", TVM_INFO_USE_NNAPI_RUNTIME},
+      {"USE_ZSTD", TVM_INFO_USE_ZSTD},
       {"BACKTRACE_ON_SEGFAULT", TVM_INFO_BACKTRACE_ON_SEGFAULT},
   };
   return result;
@@ -24,14 +24,152 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
-#include <future>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
 namespace tvm {
 namespace support {
 
+namespace {
+
+/*!
+ * \brief A lazily created, process-wide pool of threads backing parallel_for and
+ * parallel_for_dynamic.
+ *
+ * A thread waiting for its jobs to finish keeps executing queued jobs, so parallel loops may
+ * be nested or launched concurrently from several threads without deadlocking.
+ */
+class ParallelForThreadPool {
+ public:
+  static ParallelForThreadPool* Global() {
+    // NOTE: explicitly use new to avoid exit-time destruction of the detached workers' state.
+    static ParallelForThreadPool* inst = new ParallelForThreadPool();
+    return inst;
+  }
+
+  /*!
+   * \brief Run `job(0)`, ..., `job(num_jobs - 1)` in parallel and wait for all of them.
+   * `job(0)` runs in place on the calling thread.
+   * \throws The first exception thrown by any of the jobs.
+   */
+  void Run(int num_jobs, const std::function<void(int job_id)>& job) {
+    JobGroup group;
+    group.num_pending = num_jobs - 1;
+    if (num_jobs > 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      EnsureWorkers(num_jobs - 1);
+      for (int job_id = 1; job_id < num_jobs; ++job_id) {
+        queue_.push_back(Job{&job, job_id, &group});
+      }
+      worker_cv_.notify_all();
+    }
+    std::exception_ptr error = nullptr;
+    try {
+      job(0);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (group.num_pending != 0) {
+      if (!queue_.empty()) {
+        Job next = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+        Execute(next);
+        lock.lock();
+      } else {
+        done_cv_.wait(lock);
+      }
+    }
+    if (error == nullptr) {
+      error = group.error;
+    }
+    lock.unlock();
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+
+ private:
+  struct JobGroup {
+    /*! \brief Number of queued or running jobs, guarded by the pool mutex. */
+    int num_pending{0};
+    /*! \brief The first exception thrown by a job, guarded by the pool mutex. */
+    std::exception_ptr error{nullptr};
+  };
+
+  struct Job {
+    const std::function<void(int)>* fn;
+    int job_id;
+    JobGroup* group;
+  };
+
+  /*! \brief Grow the pool to at least `num_workers` threads. Requires mutex_ to be held. */
+  void EnsureWorkers(int num_workers) {
+#if !defined(_WIN32)
+    // Threads do not survive fork, start over in the child process.
+    if (pid_ != getpid()) {
+      pid_ = getpid();
+      num_workers_ = 0;
+    }
+#endif
+    for (; num_workers_ < num_workers; ++num_workers_) {
+      std::thread([this]() { this->RunWorker(); }).detach();
+    }
+  }
+
+  void Execute(const Job& job) {
+    std::exception_ptr error = nullptr;
+    try {
+      (*job.fn)(job.job_id);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error != nullptr && job.group->error == nullptr) {
+      job.group->error = error;
+    }
+    --job.group->num_pending;
+    done_cv_.notify_all();
+  }
+
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      worker_cv_.wait(lock, [this]() { return !queue_.empty(); });
+      Job next = queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+      Execute(next);
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  /*! \brief Notified when jobs are queued. */
+  std::condition_variable worker_cv_;
+  /*! \brief Notified when a job finishes. */
+  std::condition_variable done_cv_;
+  std::deque<Job> queue_;
+  int num_workers_{0};
+#if !defined(_WIN32)
+  pid_t pid_{getpid()};
+#endif
+};
+
+}  // namespace
+
 std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int num_threads) {
   int total_task_count = (end - begin) / step;
   ICHECK_GE(total_task_count, 0) << "Infinite loop condition with begin: " << begin
@@ -49,45 +187,18 @@ std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int n
 
 void parallel_for(int begin, int end, const std::function<void(int)>& f, int step,
                   const PartitionerFuncType partitioner) {
-  static bool GLOBAL_PARALLEL_FOR_FLAG{false};
-  static std::mutex M_GLOBAL_PARALLEL_FOR_FLAG;
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(!GLOBAL_PARALLEL_FOR_FLAG) << "There's another parallel_for running. Maybe you're "
-                                      << "currently inside another parallel_for loop.";
-    GLOBAL_PARALLEL_FOR_FLAG = true;
-  }
-
   int default_num_threads = std::thread::hardware_concurrency();
   const auto& run_partitions = partitioner(begin, end, step, default_num_threads);
-
-  std::vector<std::thread> threads;
-  threads.reserve(run_partitions.size());
-  std::vector<std::future<void>> res_vec;
-  res_vec.reserve(run_partitions.size());
-  for (const auto& run_partition : run_partitions) {
-    std::packaged_task<void(const std::vector<int>&, const std::function<void(int)>&)> task(
-        [](const std::vector<int>& run_partition, const std::function<void(int)>& f) {
-          for (const auto& i : run_partition) {
-            f(i);
-          }
-        });
-    res_vec.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), run_partition, f);
-  }
-
-  for (auto&& thread : threads) {
-    thread.join();
-  }
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(GLOBAL_PARALLEL_FOR_FLAG);
-    GLOBAL_PARALLEL_FOR_FLAG = false;
+  if (run_partitions.empty()) {
+    return;
   }
   try {
-    for (auto&& i : res_vec) {
-      i.get();
-    }
+    ParallelForThreadPool::Global()->Run(static_cast<int>(run_partitions.size()),
+                                         [&run_partitions, &f](int partition_id) {
+                                           for (const auto& i : run_partitions[partition_id]) {
+                                             f(i);
+                                           }
+                                         });
   } catch (const std::exception& e) {
     LOG(FATAL) << "Parallel_for error with " << e.what();
   }
@@ -101,40 +212,23 @@ void parallel_for_dynamic(int begin, int end, int num_threads,
   }
   CHECK_LE(begin, end) << "ValueError: The interval [begin, end) requires `begin <= end`";
   CHECK_GT(num_threads, 0) << "ValueError: `num_threads` should be positive";
-  // Step 2. Launch threads
-  // Step 2.1. Launch worker 1 to worker `num_threads - 1`
+  // Step 2. Run worker 0 in place and worker 1 to worker `num_threads - 1` in the pool.
+  // Each worker fetches the next task once it is idle.
   std::atomic<int> counter{begin};
-  std::vector<std::future<void>> futures;
-  std::vector<std::thread> threads;
-  futures.reserve(num_threads - 1);
-  threads.reserve(num_threads - 1);
   auto worker = [end, &counter, &f](int thread_id) -> void {
-    for (int task_id; (task_id = counter++) < end;) {
-      f(thread_id, task_id);
+    try {
+      for (int task_id; (task_id = counter++) < end;) {
+        f(thread_id, task_id);
+      }
+    } catch (...) {
+      // Stop the other workers from picking up further tasks.
+      counter = end;
+      throw;
     }
   };
-  for (int thread_id = 1; thread_id < num_threads; ++thread_id) {
-    std::packaged_task<void(int)> task(worker);
-    futures.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), thread_id);
-  }
-  // Step 2.2. Launch worker 0 inplace
+  // Step 3. Wait for all workers and check exceptions
   try {
-    worker(0);
-  } catch (const std::exception& e) {
-    for (auto&& thread : threads) {
-      thread.join();
-    }
-    LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
-  }
-  // Step 3. Join threads and check exceptions
-  for (auto&& thread : threads) {
-    thread.join();
-  }
-  try {
-    for (auto&& future : futures) {
-      future.get();
-    }
+    ParallelForThreadPool::Global()->Run(num_threads, worker);
   } catch (const std::exception& e) {
     LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
   }
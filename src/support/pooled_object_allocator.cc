@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file pooled_object_allocator.cc
+ * \brief Thread-local free lists of the pooled object allocator.
+ */
+#include "pooled_object_allocator.h"
+
+#include <tvm/ffi/container/map.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/ffi/string.h>
+#include <tvm/runtime/logging.h>
+
+#include <atomic>
+
+#include "arena.h"
+
+namespace tvm {
+namespace support {
+
+namespace {
+
+constexpr size_t kNumSizeClasses =
+    PooledObjAllocator::kMaxPooledSize / PooledObjAllocator::kGranularity;
+
+/*! \brief The unit of the arena allocations. */
+struct alignas(PooledObjAllocator::kGranularity) Granule {
+  char data[PooledObjAllocator::kGranularity];
+};
+
+/*! \brief A free block, linked through its own storage. */
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+std::atomic<int64_t> num_fresh{0};
+std::atomic<int64_t> num_reused{0};
+std::atomic<int64_t> num_released{0};
+
+/*! \brief The pages and the free lists of one thread. */
+struct ThreadPool {
+  Arena arena;
+  FreeBlock* free_lists[kNumSizeClasses] = {nullptr};
+  bool enabled{false};
+};
+
+ThreadPool* GetThreadPool() {
+  // Never destroyed: blocks of this thread may be in use by other threads, or
+  // released while other thread-local objects are destroyed.
+  thread_local ThreadPool* pool = new ThreadPool();
+  return pool;
+}
+
+size_t SizeClassOf(size_t size) {
+  ICHECK(size != 0 && size <= PooledObjAllocator::kMaxPooledSize)
+      << "InternalError: Object of " << size << " bytes cannot be pooled";
+  return (size - 1) / PooledObjAllocator::kGranularity;
+}
+
+}  // namespace
+
+void* PooledObjAllocator::Allocate(size_t size) {
+  size_t size_class = SizeClassOf(size);
+  ThreadPool* pool = GetThreadPool();
+  if (FreeBlock* block = pool->free_lists[size_class]) {
+    pool->free_lists[size_class] = block->next;
+    num_reused.fetch_add(1, std::memory_order_relaxed);
+    return block;
+  }
+  num_fresh.fetch_add(1, std::memory_order_relaxed);
+  return pool->arena.allocate_<Granule>(static_cast<int>(size_class + 1));
+}
+
+void PooledObjAllocator::Release(void* ptr, size_t size) {
+  size_t size_class = SizeClassOf(size);
+  ThreadPool* pool = GetThreadPool();
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+  block->next = pool->free_lists[size_class];
+  pool->free_lists[size_class] = block;
+  num_released.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool PooledObjAllocator::Enabled() { return GetThreadPool()->enabled; }
+
+PooledObjAllocator::Stats PooledObjAllocator::GetStats() {
+  Stats stats;
+  stats.num_fresh = num_fresh.load(std::memory_order_relaxed);
+  stats.num_reused = num_reused.load(std::memory_order_relaxed);
+  stats.num_released = num_released.load(std::memory_order_relaxed);
+  return stats;
+}
+
+PooledAllocationScope::PooledAllocationScope(bool enabled) {
+  ThreadPool* pool = GetThreadPool();
+  prev_enabled_ = pool->enabled;
+  pool->enabled = enabled;
+}
+
+PooledAllocationScope::~PooledAllocationScope() { GetThreadPool()->enabled = prev_enabled_; }
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("support.GetPooledObjectAllocatorStats", []() {
+    PooledObjAllocator::Stats stats = PooledObjAllocator::GetStats();
+    return ffi::Map<ffi::String, int64_t>({{"num_fresh", stats.num_fresh},
+                                           {"num_reused", stats.num_reused},
+                                           {"num_released", stats.num_released}});
+  });
+}
+
+}  // namespace support
+}  // namespace tvm
@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file pooled_object_allocator.h
+ * \brief Object allocator that recycles the memory of small IR nodes.
+ *
+ *  IR passes create and drop many small nodes of the same few types. When pooled
+ *  allocation is enabled on a thread, make_object requests of up to
+ *  PooledObjAllocator::kMaxPooledSize bytes are served from thread-local free
+ *  lists that are refilled from arena pages, instead of the global allocator.
+ *
+ *  The nodes may outlive the scope that enabled pooling, e.g. the IR returned by
+ *  a pass, so the pages are never released. Memory of a dropped node goes back to
+ *  the free list of the thread that drops it.
+ */
+#ifndef TVM_SUPPORT_POOLED_OBJECT_ALLOCATOR_H_
+#define TVM_SUPPORT_POOLED_OBJECT_ALLOCATOR_H_
+
+#include <tvm/ffi/memory.h>
+#include <tvm/runtime/base.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace tvm {
+namespace support {
+
+/*! \brief Allocator that serves small objects from thread-local free lists. */
+class PooledObjAllocator : public ffi::details::ObjAllocatorBase<PooledObjAllocator> {
+ public:
+  /*! \brief The granularity of the pooled size classes. */
+  static constexpr size_t kGranularity = 16;
+  /*! \brief The largest object size served from the pool. */
+  static constexpr size_t kMaxPooledSize = 256;
+
+  /*! \brief The counters of the pooled allocations made by all threads. */
+  struct Stats {
+    /*! \brief The number of blocks carved from new arena memory. */
+    int64_t num_fresh{0};
+    /*! \brief The number of blocks reused from a free list. */
+    int64_t num_reused{0};
+    /*! \brief The number of blocks returned to a free list. */
+    int64_t num_released{0};
+  };
+
+  /*! \brief Allocate a block of the given size, which must not exceed kMaxPooledSize. */
+  TVM_DLL static void* Allocate(size_t size);
+  /*! \brief Return a block allocated by Allocate with the same size. */
+  TVM_DLL static void Release(void* ptr, size_t size);
+  /*! \brief Whether pooled allocation is enabled on the current thread. */
+  TVM_DLL static bool Enabled();
+  /*! \brief Get the counters of the pooled allocations. */
+  TVM_DLL static Stats GetStats();
+
+  template <typename T>
+  class Handler {
+   public:
+    template <typename... Args>
+    static T* New(PooledObjAllocator*, Args&&... args) {
+      void* data = Allocate(sizeof(T));
+      new (data) T(std::forward<Args>(args)...);
+      return static_cast<T*>(data);
+    }
+
+    static ffi::FObjectDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(void* objptr, int flags) {
+      T* tptr = ffi::details::ObjectUnsafe::RawObjectPtrFromUnowned<T>(
+          static_cast<TVMFFIObject*>(objptr));
+      if (flags & kTVMFFIObjectDeleterFlagBitMaskStrong) {
+        // Call the destructor of T explicitly, same as the default allocator.
+        tptr->T::~T();
+      }
+      if (flags & kTVMFFIObjectDeleterFlagBitMaskWeak) {
+        Release(static_cast<void*>(tptr), sizeof(T));
+      }
+    }
+  };
+};
+
+/*!
+ * \brief RAII scope that enables or disables pooled allocation on the current thread.
+ *
+ *  The previous setting is restored when the scope exits, so scopes can be nested.
+ */
+class PooledAllocationScope {
+ public:
+  TVM_DLL explicit PooledAllocationScope(bool enabled = true);
+  TVM_DLL ~PooledAllocationScope();
+
+  PooledAllocationScope(const PooledAllocationScope&) = delete;
+  PooledAllocationScope& operator=(const PooledAllocationScope&) = delete;
+
+ private:
+  bool prev_enabled_;
+};
+
+/*! \brief The counters of the IR nodes created through MakePooledObject on a thread. */
+struct NodeAllocationCounter {
+  /*! \brief The number of nodes created. */
+  int64_t num_objects{0};
+  /*! \brief The total size of the nodes created, in bytes. */
+  int64_t num_bytes{0};
+};
+
+/*! \brief The counters of the current thread, whether pooled allocation is enabled or not. */
+inline thread_local NodeAllocationCounter thread_node_allocation_counter;
+
+/*!
+ * \brief Create an object, from the pool if pooled allocation is enabled on this thread.
+ * \tparam T The object type.
+ * \param args The arguments to the constructor of T.
+ * \return The created object.
+ */
+template <typename T, typename... Args>
+inline ffi::ObjectPtr<T> MakePooledObject(Args&&... args) {
+  static_assert(alignof(T) <= PooledObjAllocator::kGranularity, "Too large alignment");
+  ++thread_node_allocation_counter.num_objects;
+  thread_node_allocation_counter.num_bytes += sizeof(T);
+  if (sizeof(T) <= PooledObjAllocator::kMaxPooledSize && PooledObjAllocator::Enabled()) {
+    return PooledObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  }
+  return ffi::make_object<T>(std::forward<Args>(args)...);
+}
+
+}  // namespace support
+}  // namespace tvm
+#endif  // TVM_SUPPORT_POOLED_OBJECT_ALLOCATOR_H_
@@ -42,9 +42,11 @@
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 
@@ -390,6 +392,17 @@ class TCPSocket : public Socket, public dmlc::Stream {
       Socket::Error("SetKeepAlive");
     }
   }
+  /*!
+   * \brief enable/disable Nagle's algorithm, i.e. the coalescing of small packets
+   * \param nodelay whether to send small packets without delay
+   */
+  void SetNoDelay(bool nodelay) {
+    int opt = static_cast<int>(nodelay);
+    if (setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&opt), sizeof(opt)) <
+        0) {
+      Socket::Error("SetNoDelay");
+    }
+  }
   /*!
    * \brief create the socket, call this before using socket
    * \param af domain
@@ -506,6 +519,52 @@ class TCPSocket : public Socket, public dmlc::Stream {
     }
     return ndone;
   }
+  /*!
+   * \brief perform block write of a header followed by a payload,
+   *    with gather writes where the platform supports them
+   *    can still return smaller than request when error occurs
+   * \param header the pointer to the header
+   * \param header_size the size of the header
+   * \param payload the pointer to the payload
+   * \param payload_size the size of the payload
+   * \return size of data actually sent
+   */
+  size_t SendAll(const void* header, size_t header_size, const void* payload,
+                 size_t payload_size) {
+#ifdef _WIN32
+    size_t ndone = SendAll(header, header_size);
+    if (ndone != header_size) return ndone;
+    return ndone + SendAll(payload, payload_size);
+#else
+    size_t len = header_size + payload_size;
+    size_t ndone = 0;
+    while (ndone < len) {
+      iovec iov[2];
+      int iovcnt = 0;
+      if (ndone < header_size) {
+        iov[iovcnt].iov_base = const_cast<char*>(static_cast<const char*>(header) + ndone);
+        iov[iovcnt].iov_len = header_size - ndone;
+        ++iovcnt;
+      }
+      size_t payload_done = ndone > header_size ? ndone - header_size : 0;
+      iov[iovcnt].iov_base = const_cast<char*>(static_cast<const char*>(payload) + payload_done);
+      iov[iovcnt].iov_len = payload_size - payload_done;
+      ++iovcnt;
+      msghdr msg;
+      std::memset(&msg, 0, sizeof(msg));
+      msg.msg_iov = iov;
+      msg.msg_iovlen = iovcnt;
+      ssize_t ret =
+          RetryCallOnEINTR([&]() { return sendmsg(sockfd, &msg, 0); }, GetLastErrorCode);
+      if (ret == -1) {
+        if (LastErrorWouldBlock()) return ndone;
+        Socket::Error("SendAll");
+      }
+      ndone += ret;
+    }
+    return ndone;
+#endif
+  }
   /*!
    * \brief perform block read that will attempt to read all data
    *    can still return smaller than request when error occurs
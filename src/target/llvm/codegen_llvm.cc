@@ -88,10 +88,12 @@
 #include <llvm/Support/CodeGen.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/SwapByteOrder.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
 #include <tvm/runtime/base.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/tir/op.h>
 
@@ -1017,6 +1019,37 @@ CodeGenLLVM::TypedPointer CodeGenLLVM::CreateBufferPtr(llvm::Value* buffer_ptr,
   return TypedPointer(value_type, value_ptr);
 }
 
+llvm::Value* CodeGenLLVM::CreateGatherScatterPtrs(const Buffer& buffer,
+                                                  const ffi::Array<PrimExpr>& indices,
+                                                  const ffi::Optional<PrimExpr>& predicate) {
+  if (!predicate.defined() || indices.empty()) {
+    return nullptr;
+  }
+  PrimExpr last_index = indices.back();
+  const auto* ramp = last_index.as<RampNode>();
+  if (last_index.dtype().is_scalar() || (ramp != nullptr && is_one(ramp->stride))) {
+    return nullptr;
+  }
+  ICHECK_EQ(indices.size(), 1) << "CodeGenLLVM requires all buffers to be flat 1-d buffers.";
+  ICHECK_EQ(buffer->dtype.lanes(), 1)
+      << "Predicated gathers and scatters of vector elements are not supported, but buffer "
+      << buffer->name << " has element type " << buffer->dtype;
+  ICHECK(!volatile_buf_.count(buffer->data.get()))
+      << "The masked gather and scatter intrinsics do not support volatile accesses.";
+
+  llvm::Value* buffer_ptr = MakeValue(buffer->data);
+  llvm::PointerType* buffer_ptr_type = llvm::dyn_cast<llvm::PointerType>(buffer_ptr->getType());
+  ICHECK(buffer_ptr_type != nullptr);
+  llvm::Type* element_type = DTypeToLLVMType(buffer->dtype);
+  llvm::PointerType* element_ptr_type =
+      llvmGetPointerTo(element_type, buffer_ptr_type->getAddressSpace());
+  if (buffer_ptr_type != element_ptr_type) {
+    buffer_ptr = builder_->CreatePointerCast(buffer_ptr, element_ptr_type);
+  }
+  // A GEP with a vector of indices produces a vector of pointers.
+  return builder_->CreateInBoundsGEP(element_type, buffer_ptr, MakeValue(last_index));
+}
+
 llvm::Value* CodeGenLLVM::GetVarValue(const VarNode* v) const {
   auto it = var_map_.find(v);
   ICHECK(it != var_map_.end()) << "cannot find variable " << v->name_hint;
@@ -1837,6 +1870,18 @@ void CodeGenLLVM::BufferAccessHelper(
 llvm::Value* CodeGenLLVM::VisitExpr_(const BufferLoadNode* op) {
   DataType value_dtype = op->dtype;
 
+  if (llvm::Value* ptrs = CreateGatherScatterPtrs(op->buffer, op->indices, op->predicate)) {
+#if TVM_LLVM_VERSION >= 130
+    llvm::Instruction* load = builder_->CreateMaskedGather(
+        DTypeToLLVMType(value_dtype), ptrs, llvm::Align(op->buffer->dtype.bytes()),
+        MakeValue(op->predicate.value()));
+    AddAliasInfo(load, op->buffer->data.get(), op->indices.back(), op->buffer->dtype);
+    return load;
+#else
+    LOG(FATAL) << "Predicated gathers require LLVM 13 or newer.";
+#endif
+  }
+
   std::vector<llvm::Value*> loads;
 
   auto make_load = [this, &loads](TypedPointer buffer_ptr, int /* subelement_i */,
@@ -1986,6 +2031,18 @@ void CodeGenLLVM::VisitStmt_(const BufferStoreNode* op) {
 
   llvm::Value* value = MakeValue(op->value);
 
+  if (llvm::Value* ptrs = CreateGatherScatterPtrs(op->buffer, op->indices, op->predicate)) {
+#if TVM_LLVM_VERSION >= 130
+    llvm::Instruction* store =
+        builder_->CreateMaskedScatter(value, ptrs, llvm::Align(op->buffer->dtype.bytes()),
+                                      MakeValue(op->predicate.value()));
+    AddAliasInfo(store, buffer_var.get(), op->indices.back(), op->buffer->dtype);
+#else
+    LOG(FATAL) << "Predicated scatters require LLVM 13 or newer.";
+#endif
+    return;
+  }
+
   auto make_store = [this, value](TypedPointer buffer_ptr, int subelement_i, llvm::Value* predicate,
                                   int alignment, bool is_volatile) {
     llvm::Value* to_store = value;
@@ -2081,10 +2138,36 @@ void CodeGenLLVM::VisitStmt_(const IfThenElseNode* op) {
 void CodeGenLLVM::VisitStmt_(const AllocateConstNode* op) {
   EmitDebugLocation(op);
   auto data = op->data.value();
-  auto array = TensorToLLVMArray(llvm_target_->GetContext(), data);
   std::string symbol_name = op->buffer_var->name_hint;
-  llvm::GlobalVariable* param_symbol = new llvm::GlobalVariable(
-      *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
+  int64_t large_constants_threshold =
+      transform::PassContext::Current()
+          ->GetConfig<Integer>("target.llvm.large_constants_threshold", Integer(0))
+          .value()
+          ->value;
+  size_t num_bytes = runtime::GetDataSize(*data.operator->());
+  llvm::GlobalVariable* param_symbol = nullptr;
+  bool is_large = large_constants_threshold > 0 &&
+                  num_bytes >= static_cast<size_t>(large_constants_threshold);
+  if (is_large && data_layout_->isLittleEndian() == llvm::sys::IsLittleEndianHost) {
+    // Large constants are emitted as raw bytes into their own page-aligned read-only section,
+    // so that the loader maps them lazily, apart from the code, and the code only refers to
+    // their symbol.
+    auto array = TensorToLLVMRawArray(llvm_target_->GetContext(), data);
+    param_symbol = new llvm::GlobalVariable(
+        *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
+    if (llvm_target_->GetOrCreateTargetMachine()->getTargetTriple().isOSBinFormatELF()) {
+      param_symbol->setSection(".lrodata.tvm");
+    }
+#if TVM_LLVM_VERSION >= 100
+    param_symbol->setAlignment(llvm::Align(4096));
+#else
+    param_symbol->setAlignment(4096);
+#endif
+  } else {
+    auto array = TensorToLLVMArray(llvm_target_->GetContext(), data);
+    param_symbol = new llvm::GlobalVariable(
+        *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
+  }
 
   var_map_[op->buffer_var.operator->()] = param_symbol;
   this->VisitStmt(op->body);
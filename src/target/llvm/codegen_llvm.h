@@ -482,6 +482,13 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   llvm::Value* CreateMul(DataType t, llvm::Value* a, llvm::Value* b);
   virtual TypedPointer CreateBufferPtr(llvm::Value* buffer_ptr, DataType buffer_element_dtype,
                                        llvm::ArrayRef<llvm::Value*> indices, DataType value_dtype);
+  /*!
+   * \brief Get the vector of element addresses of a predicated access whose last index is a
+   *        vector but not a contiguous ramp, as used by masked gathers and scatters.
+   * \return The vector of pointers, or nullptr if the access is not such a gather or scatter.
+   */
+  llvm::Value* CreateGatherScatterPtrs(const Buffer& buffer, const ffi::Array<PrimExpr>& indices,
+                                       const ffi::Optional<PrimExpr>& predicate);
   // Vector concatenation.
   llvm::Value* CreateVecSlice(llvm::Value* vec, int begin, int extent);
   llvm::Value* CreateVecFlip(llvm::Value* vec);
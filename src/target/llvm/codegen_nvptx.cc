@@ -140,6 +140,8 @@ class CodeGenNVPTX : public CodeGenLLVM {
 
   // Return the thread index via intrinsics.
   llvm::Value* GetThreadIndex(const IterVar& iv) final {
+    CHECK_NE(iv->thread_tag.compare(0, 11, "clusterIdx."), 0)
+        << "Thread block clusters are only supported by the CUDA source codegen";
     runtime::ThreadScope ts = runtime::ThreadScope::Create(iv->thread_tag);
     llvm::Intrinsic::ID intrin_id = llvm::Intrinsic::nvvm_read_ptx_sreg_tid_x;
     if (ts.rank == 1) {
@@ -176,6 +176,14 @@ llvm::ConstantArray* TensorToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::T
       llvm::ArrayType::get(element_type, num_elements), llvm::ArrayRef<llvm::Constant*>(elements)));
 }
 
+llvm::Constant* TensorToLLVMRawArray(llvm::LLVMContext* ctx, ::tvm::runtime::Tensor arr) {
+  CHECK(arr.IsContiguous()) << "CodegenParams: only support contiguous arrays";
+  CHECK_EQ(arr->device.device_type, kDLCPU) << "CodegenParams: only support contiguous arrays";
+  size_t num_bytes = runtime::GetDataSize(*arr.operator->());
+  const uint8_t* data = static_cast<const uint8_t*>(arr->data) + arr->byte_offset;
+  return llvm::ConstantDataArray::get(*ctx, llvm::ArrayRef<uint8_t>(data, num_bytes));
+}
+
 }  // namespace codegen
 }  // namespace tvm
 
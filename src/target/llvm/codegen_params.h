@@ -27,6 +27,7 @@
 #include <tvm/runtime/tensor.h>
 
 namespace llvm {
+class Constant;
 class ConstantArray;
 class LLVMContext;
 }  // namespace llvm
@@ -45,6 +46,19 @@ namespace codegen {
  */
 llvm::ConstantArray* TensorToLLVMArray(llvm::LLVMContext* ctx, tvm::runtime::Tensor arr);
 
+/*!
+ * \brief Convert an Tensor to an LLVM array of its raw bytes.
+ *
+ * Unlike TensorToLLVMArray, the data is copied as a single blob rather than one LLVM constant
+ * per element, which keeps the code generation of large constants linear in their size. The
+ * bytes are in the byte order of the host, so the target must have the same byte order.
+ *
+ * \param ctx LLVM context used to create the array.
+ * \param arr Tensor to convert.
+ * \return LLVM array of i8 containing the array data.
+ */
+llvm::Constant* TensorToLLVMRawArray(llvm::LLVMContext* ctx, tvm::runtime::Tensor arr);
+
 }  // namespace codegen
 }  // namespace tvm
 
@@ -45,10 +45,22 @@ namespace codegen {
 class CodeGenX86_64 final : public CodeGenCPU {
  public:
   llvm::Value* VisitExpr_(const CastNode* op) override;
+  llvm::Value* CreateIntrinsic(const CallNode* op) override;
 
  private:
   llvm::Value* CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes, llvm::Type* result_ty,
                                 const std::vector<llvm::Value*>& args);
+  /*!
+   * \brief Load the AMX tile configuration at the entry of the current function.
+   *
+   * The AMX intrinsics address the tile registers by number, so the tiles are configured once
+   * per function, with all 8 tiles of 16 rows of 64 bytes, the shape of the AMX tensor
+   * intrinsics in tvm.tir.tensor_intrin.x86.
+   */
+  void EnsureAMXTileConfig();
+
+  /*! \brief The function whose entry already loads the AMX tile configuration. */
+  llvm::Function* amx_configured_function_{nullptr};
 };
 
 llvm::Value* CodeGenX86_64::VisitExpr_(const CastNode* op) {
@@ -91,6 +103,64 @@ llvm::Value* CodeGenX86_64::VisitExpr_(const CastNode* op) {
   return CodeGenCPU::VisitExpr_(op);
 }
 
+llvm::Value* CodeGenX86_64::CreateIntrinsic(const CallNode* op) {
+#if TVM_LLVM_VERSION >= 120
+  if (op->op.same_as(builtin_call_llvm_intrin_) || op->op.same_as(builtin_call_llvm_pure_intrin_)) {
+    ICHECK_GE(op->args.size(), 1U);
+    switch (static_cast<llvm::Intrinsic::ID>(Downcast<IntImm>(op->args[0])->value)) {
+      case llvm::Intrinsic::x86_tileloadd64:
+      case llvm::Intrinsic::x86_tilestored64:
+      case llvm::Intrinsic::x86_tilezero:
+      case llvm::Intrinsic::x86_tdpbssd:
+      case llvm::Intrinsic::x86_tdpbsud:
+      case llvm::Intrinsic::x86_tdpbusd:
+      case llvm::Intrinsic::x86_tdpbuud:
+      case llvm::Intrinsic::x86_tdpbf16ps:
+        EnsureAMXTileConfig();
+        break;
+      default:
+        break;
+    }
+  }
+#endif
+  return CodeGenCPU::CreateIntrinsic(op);
+}
+
+void CodeGenX86_64::EnsureAMXTileConfig() {
+#if TVM_LLVM_VERSION >= 120
+  if (amx_configured_function_ == function_) {
+    return;
+  }
+  ICHECK(llvm_target_->TargetHasCPUFeature("amx-tile"))
+      << "AMX intrinsics require a target with amx-tile, e.g. -mcpu=sapphirerapids";
+  // The 64-byte tile configuration: palette 1, then the bytes per row of each tile as
+  // uint16 at offset 16, and the number of rows of each tile as uint8 at offset 48.
+  std::vector<uint8_t> config(64, 0);
+  config[0] = 1;
+  for (int i = 0; i < 8; ++i) {
+    config[16 + 2 * i] = 64;
+    config[48 + i] = 16;
+  }
+  llvm::Constant* config_ptr = GetGlobalConstant(
+      llvm::ConstantDataArray::get(*llvm_target_->GetContext(), config), ".amx_tile_config",
+      llvm::GlobalValue::PrivateLinkage);
+#if TVM_LLVM_VERSION >= 200
+  llvm::Function* f = llvm::cast<llvm::Function>(
+      llvm::Intrinsic::getOrInsertDeclaration(module_.get(), llvm::Intrinsic::x86_ldtilecfg, {}));
+#else
+  llvm::Function* f =
+      llvm::Intrinsic::getDeclaration(module_.get(), llvm::Intrinsic::x86_ldtilecfg);
+#endif
+  llvm::IRBuilderBase::InsertPointGuard guard(*builder_);
+  llvm::BasicBlock& entry = function_->getEntryBlock();
+  builder_->SetInsertPoint(&entry, entry.getFirstInsertionPt());
+  builder_->CreateCall(f, {builder_->CreatePointerCast(config_ptr, t_void_p_)});
+  amx_configured_function_ = function_;
+#else
+  LOG(FATAL) << "AMX intrinsics require LLVM 12 or newer";
+#endif
+}
+
 llvm::Value* CodeGenX86_64::CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes,
                                              llvm::Type* result_ty,
                                              const std::vector<llvm::Value*>& args) {
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file llvm_jit_object_cache.cc
+ * \brief On-disk cache of the object files produced by the ORC JIT.
+ */
+#ifdef TVM_LLVM_VERSION
+
+#include "llvm_jit_object_cache.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+#include <tvm/ffi/container/map.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/ffi/string.h>
+#include <tvm/runtime/logging.h>
+
+#include <cstdlib>
+#include <system_error>
+#include <utility>
+
+namespace tvm {
+namespace codegen {
+
+LLVMJITObjectCache::LLVMJITObjectCache() {
+  if (const char* cache_dir = std::getenv("TVM_LLVM_JIT_CACHE_DIR")) {
+    cache_dir_ = cache_dir;
+  }
+}
+
+LLVMJITObjectCache* LLVMJITObjectCache::Global() {
+  static LLVMJITObjectCache* inst = new LLVMJITObjectCache();
+  return inst;
+}
+
+void LLVMJITObjectCache::SetCacheDir(const std::string& cache_dir) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_dir_ = cache_dir;
+}
+
+std::string LLVMJITObjectCache::GetCacheDir() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_dir_;
+}
+
+bool LLVMJITObjectCache::Enabled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !cache_dir_.empty();
+}
+
+LLVMJITObjectCache::Stats LLVMJITObjectCache::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void LLVMJITObjectCache::ResetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_ = Stats();
+}
+
+std::string LLVMJITObjectCache::GetKey(const llvm::Module* module) {
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+#if TVM_LLVM_VERSION <= 60
+  llvm::WriteBitcodeToFile(module, os);
+#else
+  llvm::WriteBitcodeToFile(*module, os);
+#endif
+  llvm::SHA1 hasher;
+  hasher.update(llvm::StringRef(bitcode.data(), bitcode.size()));
+#if TVM_LLVM_VERSION >= 210
+  hasher.update(module->getTargetTriple().str());
+#else
+  hasher.update(module->getTargetTriple());
+#endif
+  hasher.update(LLVM_VERSION_STRING);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string LLVMJITObjectCache::GetObjectPath(const std::string& key) const {
+  llvm::SmallString<256> path(cache_dir_);
+  llvm::sys::path::append(path, key + ".o");
+  return std::string(path.str());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::getObject(const llvm::Module* module) {
+  if (!Enabled()) {
+    return nullptr;
+  }
+  std::string key = GetKey(module);
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string path = GetObjectPath(key);
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer = llvm::MemoryBuffer::getFile(path);
+  if (buffer) {
+    ++stats_.hits;
+    VLOG(2) << "LLVM JIT object cache hit for " << module->getModuleIdentifier() << ": " << path;
+    return std::move(buffer.get());
+  }
+  ++stats_.misses;
+  pending_keys_[module] = std::move(key);
+  return nullptr;
+}
+
+void LLVMJITObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef obj) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_keys_.find(module);
+  if (it == pending_keys_.end()) {
+    return;
+  }
+  std::string key = std::move(it->second);
+  pending_keys_.erase(it);
+  if (cache_dir_.empty()) {
+    return;
+  }
+  std::error_code ecode = llvm::sys::fs::create_directories(cache_dir_);
+  if (ecode) {
+    LOG(WARNING) << "Cannot create the LLVM JIT object cache directory " << cache_dir_ << ": "
+                 << ecode.message();
+    return;
+  }
+  // Write into a temporary file first, so that concurrent processes never read a partial object.
+  std::string path = GetObjectPath(key);
+  llvm::SmallString<256> tmp_path;
+  int fd;
+  ecode = llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%", fd, tmp_path);
+  if (ecode) {
+    LOG(WARNING) << "Cannot write the LLVM JIT object cache file " << path << ": "
+                 << ecode.message();
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << obj.getBuffer();
+  }
+  ecode = llvm::sys::fs::rename(tmp_path, path);
+  if (ecode) {
+    llvm::sys::fs::remove(tmp_path);
+    LOG(WARNING) << "Cannot write the LLVM JIT object cache file " << path << ": "
+                 << ecode.message();
+    return;
+  }
+  ++stats_.stores;
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef()
+      .def("target.llvm_jit_cache_set_dir",
+           [](ffi::String cache_dir) { LLVMJITObjectCache::Global()->SetCacheDir(cache_dir); })
+      .def("target.llvm_jit_cache_get_dir",
+           []() -> ffi::String { return LLVMJITObjectCache::Global()->GetCacheDir(); })
+      .def("target.llvm_jit_cache_get_stats",
+           []() {
+             LLVMJITObjectCache::Stats stats = LLVMJITObjectCache::Global()->GetStats();
+             return ffi::Map<ffi::String, int64_t>(
+                 {{"hits", stats.hits}, {"misses", stats.misses}, {"stores", stats.stores}});
+           })
+      .def("target.llvm_jit_cache_reset_stats",
+           []() { LLVMJITObjectCache::Global()->ResetStats(); });
+}
+
+}  // namespace codegen
+}  // namespace tvm
+
+#endif  // TVM_LLVM_VERSION
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file llvm_jit_object_cache.h
+ * \brief On-disk cache of the object files produced by the ORC JIT.
+ */
+
+#ifndef TVM_TARGET_LLVM_LLVM_JIT_OBJECT_CACHE_H_
+#define TVM_TARGET_LLVM_LLVM_JIT_OBJECT_CACHE_H_
+
+#ifdef TVM_LLVM_VERSION
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief A process-wide llvm::ObjectCache that stores JIT compiled objects in a directory.
+ *
+ * Objects are keyed by a hash of the bitcode of the module, its target triple and the LLVM
+ * version, so that JIT compiling an identical module in another process skips codegen. The
+ * cache is disabled while its directory is empty. The directory defaults to the environment
+ * variable `TVM_LLVM_JIT_CACHE_DIR`, and can be changed with `SetCacheDir`.
+ */
+class LLVMJITObjectCache : public llvm::ObjectCache {
+ public:
+  /*! \brief Statistics of the lookups into the cache. */
+  struct Stats {
+    /*! \brief The number of modules whose object was found in the cache */
+    int64_t hits = 0;
+    /*! \brief The number of modules whose object was not found in the cache */
+    int64_t misses = 0;
+    /*! \brief The number of objects written into the cache */
+    int64_t stores = 0;
+  };
+
+  /*! \brief The global cache shared by all the JIT engines. */
+  static LLVMJITObjectCache* Global();
+
+  /*! \brief Set the cache directory, an empty directory disables the cache. */
+  void SetCacheDir(const std::string& cache_dir);
+  /*! \brief Get the cache directory. */
+  std::string GetCacheDir();
+  /*! \brief Whether the cache is enabled. */
+  bool Enabled();
+  /*! \brief Get the lookup statistics. */
+  Stats GetStats();
+  /*! \brief Reset the lookup statistics. */
+  void ResetStats();
+
+  void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) final;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) final;
+
+ private:
+  LLVMJITObjectCache();
+  /*! \brief Compute the key of the module. */
+  static std::string GetKey(const llvm::Module* module);
+  /*! \brief Path of the cached object of the key. */
+  std::string GetObjectPath(const std::string& key) const;
+
+  std::mutex mutex_;
+  /*! \brief The cache directory */
+  std::string cache_dir_;
+  /*! \brief The lookup statistics */
+  Stats stats_;
+  /*! \brief Keys of the modules missed in `getObject`, which are about to be compiled */
+  std::unordered_map<const llvm::Module*, std::string> pending_keys_;
+};
+
+}  // namespace codegen
+}  // namespace tvm
+
+#endif  // TVM_LLVM_VERSION
+#endif  // TVM_TARGET_LLVM_LLVM_JIT_OBJECT_CACHE_H_
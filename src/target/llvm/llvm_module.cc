@@ -26,6 +26,7 @@
 #include <dmlc/io.h>
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
@@ -44,7 +45,9 @@
 #include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Metadata.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/Support/FileSystem.h>
 #if TVM_LLVM_VERSION >= 180
 #include <llvm/TargetParser/Host.h>
@@ -61,18 +64,25 @@
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/string.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/object.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -81,6 +91,7 @@
 #include "codegen_cpu.h"
 #include "codegen_llvm.h"
 #include "llvm_instance.h"
+#include "llvm_jit_object_cache.h"
 
 namespace tvm {
 namespace codegen {
@@ -89,6 +100,9 @@ using ffi::Any;
 using ffi::Function;
 using ffi::PackedArgs;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("target.llvm.num_codegen_partitions", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("target.llvm.large_constants_threshold", Integer);
+
 class LLVMModuleNode final : public ffi::ModuleObj {
  public:
   ~LLVMModuleNode();
@@ -108,6 +122,23 @@ class LLVMModuleNode final : public ffi::ModuleObj {
   ffi::String InspectSource(const ffi::String& format) const final;
 
   void Init(const IRModule& mod, const Target& target);
+  /*!
+   * \brief Generate the LLVM module of the PrimFuncs in several partitions in parallel.
+   *
+   * Each partition is generated and optimized in its own LLVMContext on its own thread, and
+   * the optimized partitions are then linked into a module of the context of `llvm_target`.
+   *
+   * \param mod The IRModule to generate code for.
+   * \param target The target of the module.
+   * \param llvm_target The LLVM target of the module.
+   * \param entry_func The name of the entry function, empty if there is none.
+   * \param num_partitions The maximum number of partitions.
+   * \return The linked LLVM module.
+   */
+  std::unique_ptr<llvm::Module> CodegenInPartitions(const IRModule& mod, const Target& target,
+                                                    LLVMTarget* llvm_target,
+                                                    const std::string& entry_func,
+                                                    int num_partitions);
   void Init(std::unique_ptr<llvm::Module> module, std::unique_ptr<LLVMInstance> llvm_instance);
   void LoadIR(const std::string& file_name);
 
@@ -318,11 +349,149 @@ ffi::String LLVMModuleNode::InspectSource(const ffi::String& format) const {
   return "";
 }
 
+namespace {
+
+/*!
+ * \brief Split the PrimFuncs of a module into at most `num_partitions` groups.
+ *
+ * Functions that call each other through a GlobalVar are kept in the same group, as such
+ * calls are resolved within an LLVM module. Groups are balanced by the number of TIR nodes
+ * of their functions, and the group holding `entry_func` comes first.
+ */
+std::vector<std::vector<std::pair<GlobalVar, BaseFunc>>> PartitionPrimFuncs(
+    const IRModule& mod, int num_partitions, const std::string& entry_func) {
+  std::vector<std::pair<GlobalVar, BaseFunc>> funcs;
+  std::unordered_map<const GlobalVarNode*, int> func_index;
+  for (const auto& [gvar, func] : mod->functions) {
+    if (func->IsInstance<PrimFuncNode>()) {
+      func_index[gvar.get()] = funcs.size();
+      funcs.emplace_back(gvar, func);
+    }
+  }
+  // Union-find over the call graph.
+  std::vector<int> parent(funcs.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<int(int)> find_root = [&](int i) {
+    return parent[i] == i ? i : parent[i] = find_root(parent[i]);
+  };
+  std::vector<int64_t> cost(funcs.size(), 0);
+  int entry_index = -1;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    PrimFunc func = Downcast<PrimFunc>(funcs[i].second);
+    if (auto global_symbol = func->GetAttr<ffi::String>(tvm::attr::kGlobalSymbol)) {
+      if (!entry_func.empty() && global_symbol.value() == entry_func) {
+        entry_index = i;
+      }
+    }
+    tir::PostOrderVisit(func->body, [&](const ObjectRef& node) {
+      ++cost[i];
+      if (const auto* call = node.as<tir::CallNode>()) {
+        if (const auto* callee = call->op.as<GlobalVarNode>()) {
+          auto it = func_index.find(callee);
+          if (it != func_index.end()) {
+            parent[find_root(it->second)] = find_root(i);
+          }
+        }
+      }
+    });
+  }
+  std::unordered_map<int, std::vector<int>> components;
+  std::unordered_map<int, int64_t> component_cost;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    int root = find_root(i);
+    components[root].push_back(i);
+    component_cost[root] += cost[i];
+  }
+  std::vector<int> roots;
+  for (const auto& kv : components) {
+    roots.push_back(kv.first);
+  }
+  int entry_root = entry_index == -1 ? -1 : find_root(entry_index);
+  std::sort(roots.begin(), roots.end(), [&](int a, int b) {
+    if ((a == entry_root) != (b == entry_root)) return a == entry_root;
+    if (component_cost[a] != component_cost[b]) return component_cost[a] > component_cost[b];
+    return components[a][0] < components[b][0];
+  });
+  // Greedily assign the largest remaining component to the least loaded group.
+  std::vector<std::vector<std::pair<GlobalVar, BaseFunc>>> partitions(
+      std::max<size_t>(1, std::min<size_t>(num_partitions, roots.size())));
+  std::vector<int64_t> load(partitions.size(), 0);
+  for (int root : roots) {
+    size_t target = root == entry_root ? 0
+                                       : std::min_element(load.begin(), load.end()) - load.begin();
+    for (int i : components[root]) {
+      partitions[target].push_back(funcs[i]);
+    }
+    load[target] += component_cost[root];
+  }
+  return partitions;
+}
+
+}  // namespace
+
+std::unique_ptr<llvm::Module> LLVMModuleNode::CodegenInPartitions(const IRModule& mod,
+                                                                  const Target& target,
+                                                                  LLVMTarget* llvm_target,
+                                                                  const std::string& entry_func,
+                                                                  int num_partitions) {
+  std::vector<std::vector<std::pair<GlobalVar, BaseFunc>>> partitions =
+      PartitionPrimFuncs(mod, num_partitions, entry_func);
+  int n = static_cast<int>(partitions.size());
+  // The first partition is generated in the context of the module node. The LLVM instances
+  // and targets of the others are created here, as creating a target may modify the global
+  // LLVM command-line options, which must happen outside of the worker threads.
+  std::vector<std::unique_ptr<LLVMInstance>> instances;
+  std::vector<std::unique_ptr<LLVMTarget>> targets;
+  for (int i = 1; i < n; ++i) {
+    instances.push_back(std::make_unique<LLVMInstance>());
+    targets.push_back(std::make_unique<LLVMTarget>(*instances.back(), target));
+  }
+  std::vector<std::unique_ptr<llvm::Module>> modules(n);
+  support::parallel_for(0, n, [&](int i) {
+    LLVMTarget* partition_target = i == 0 ? llvm_target : targets[i - 1].get();
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(partition_target);
+    cg->Init("TVMMod", partition_target, std::nullopt, false, false);
+    cg->SetFastMathFlags(partition_target->GetFastMathFlags());
+    cg->AddFunctionsOrdered(partitions[i].begin(), partitions[i].end());
+    if (i == 0 && entry_func.length() != 0) {
+      cg->AddMainFunction(entry_func);
+    }
+    modules[i] = cg->Finish();
+  });
+  // Move the other partitions into the context of the first one through bitcode, and link them.
+  std::unique_ptr<llvm::Module> result = std::move(modules[0]);
+  for (int i = 1; i < n; ++i) {
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream os(bitcode);
+#if TVM_LLVM_VERSION <= 60
+    llvm::WriteBitcodeToFile(modules[i].get(), os);
+#else
+    llvm::WriteBitcodeToFile(*modules[i], os);
+#endif
+    modules[i].reset();
+    llvm::Expected<std::unique_ptr<llvm::Module>> partition = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), "TVMMod"),
+        *llvm_target->GetContext());
+    ICHECK(partition) << llvm::toString(partition.takeError());
+    ICHECK(!llvm::Linker::linkModules(*result, std::move(partition.get())))
+        << "Failed to link the LLVM module partitions";
+  }
+  // The targets are destroyed in the reverse order of creation to restore LLVM options.
+  while (!targets.empty()) {
+    targets.pop_back();
+  }
+  std::string verify_errors_storage;
+  llvm::raw_string_ostream verify_errors(verify_errors_storage);
+  LOG_IF(FATAL, llvm::verifyModule(*result, &verify_errors))
+      << "LLVM module verification failed with the following errors: \n"
+      << verify_errors.str();
+  return result;
+}
+
 void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   llvm_instance_ = std::make_unique<LLVMInstance>();
   With<LLVMTarget> llvm_target(*llvm_instance_, target);
   llvm::TargetMachine* tm = llvm_target->GetOrCreateTargetMachine();
-  std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(llvm_target.get());
 
   std::string entry_func;
 
@@ -349,16 +518,32 @@ void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   }
   // TODO(@jroesch): follow up on this condition.
   // ICHECK(funcs.size() > 0);
-  // TODO(tqchen): remove the entry function behavior as it does not
-  // makes sense when we start to use multiple modules.
-  cg->Init("TVMMod", llvm_target.get(), system_lib_prefix, system_lib_prefix.has_value(), false);
-  cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
-  cg->AddFunctionsOrdered(mod->functions.begin(), mod->functions.end());
-  if (entry_func.length() != 0) {
-    cg->AddMainFunction(entry_func);
+  int64_t num_partitions =
+      transform::PassContext::Current()
+          ->GetConfig<Integer>("target.llvm.num_codegen_partitions", Integer(1))
+          .value()
+          ->value;
+  if (num_partitions <= 0) {
+    num_partitions = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // A system library registers all of its functions in a single startup function, so it is
+  // always generated as one partition.
+  if (num_partitions > 1 && !system_lib_prefix.has_value()) {
+    module_owning_ptr_ = CodegenInPartitions(mod, target, llvm_target.get(), entry_func,
+                                             static_cast<int>(num_partitions));
+  } else {
+    // TODO(tqchen): remove the entry function behavior as it does not
+    // makes sense when we start to use multiple modules.
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(llvm_target.get());
+    cg->Init("TVMMod", llvm_target.get(), system_lib_prefix, system_lib_prefix.has_value(),
+             false);
+    cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
+    cg->AddFunctionsOrdered(mod->functions.begin(), mod->functions.end());
+    if (entry_func.length() != 0) {
+      cg->AddMainFunction(entry_func);
+    }
+    module_owning_ptr_ = cg->Finish();
   }
-
-  module_owning_ptr_ = cg->Finish();
   module_ = module_owning_ptr_.get();
   jit_engine_ = llvm_target->GetJITEngine();
   llvm_target->SetTargetMetadata(module_);
@@ -505,7 +690,9 @@ void LLVMModuleNode::InitORCJIT() {
   // compiler
   const auto compilerBuilder = [&](const llvm::orc::JITTargetMachineBuilder&)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
-    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(tm));
+    LLVMJITObjectCache* object_cache = LLVMJITObjectCache::Global();
+    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
+        std::move(tm), object_cache->Enabled() ? object_cache : nullptr);
   };
 
 #if TVM_LLVM_VERSION >= 130
@@ -24,6 +24,8 @@
 
 #include <tvm/arith/analyzer.h>
 #include <tvm/ir/name_supply.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/tir/transform.h>
 
 #include <cctype>
 #include <iomanip>
@@ -1078,10 +1080,19 @@ void CodeGenC::VisitStmt_(const AllocateNode* op) {
 
   auto scope = GetPtrStorageScope(op->buffer_var);
   alloc_storage_scope_[op->buffer_var.get()] = scope;
+  bool is_static = op->annotations.count(tir::transform::kStaticStorage) &&
+                   Downcast<Bool>(op->annotations[tir::transform::kStaticStorage]);
+  if (is_static) {
+    stream << "static ";
+  }
   PrintStorageScope(scope, stream);
 
   PrintType(op->dtype, stream);
-  stream << ' ' << vid << '[' << constant_size << "];\n";
+  stream << ' ' << vid << '[' << constant_size << ']';
+  if (is_static) {
+    stream << " __attribute__((aligned(" << runtime::kAllocAlignment << ")))";
+  }
+  stream << ";\n";
 
   RegisterHandleType(op->buffer_var.get(), op->dtype);
   this->PrintStmt(op->body);
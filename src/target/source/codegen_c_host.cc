@@ -74,7 +74,12 @@ void CodeGenCHost::AddFunction(const GlobalVar& gvar, const PrimFunc& func,
 
   emit_fwd_func_decl_ = emit_fwd_func_decl;
   CodeGenC::AddFunction(gvar, func);
-  if (func->HasNonzeroAttr(tir::attr::kIsEntryFunc) && !has_tvm_ffi_main_func_) {
+  // Functions of the direct-call API are called by their own symbol, without a packed wrapper.
+  bool is_packed_func =
+      func->GetAttr<Integer>(tvm::attr::kCallingConv, Integer(CallingConv::kDefault))
+          .value()
+          ->value == static_cast<int>(CallingConv::kCPackedFunc);
+  if (func->HasNonzeroAttr(tir::attr::kIsEntryFunc) && !has_tvm_ffi_main_func_ && is_packed_func) {
     ICHECK(global_symbol.has_value())
         << "CodeGenCHost: The entry func must have the global_symbol attribute, "
         << "but function " << gvar << " only has attributes " << func->attrs;
@@ -168,6 +168,9 @@ class ThreadIdxExtractor : public tir::StmtVisitor {
       if (iv->var->name_hint == "threadIdx.z" || iv->thread_tag == "threadIdx.z") {
         threadIdx_z_ext = op->value;
       }
+      if (iv->thread_tag.compare(0, 11, "clusterIdx.") == 0) {
+        has_cluster_idx = true;
+      }
     }
     StmtVisitor::VisitStmt_(op);
   }
@@ -176,11 +179,14 @@ class ThreadIdxExtractor : public tir::StmtVisitor {
   PrimExpr threadIdx_x_ext = Integer(1);
   PrimExpr threadIdx_y_ext = Integer(1);
   PrimExpr threadIdx_z_ext = Integer(1);
+  bool has_cluster_idx = false;
 };
 
 void CodeGenCUDA::PrintExtraAttrs(const PrimFunc& f, std::ostream& os) {
   ThreadIdxExtractor extractor;
   extractor(f->body);
+  // The block indices of a kernel launched in clusters are bound when visiting the body.
+  use_cluster_launch_ = extractor.has_cluster_idx;
   arith::Analyzer analyzer;
   PrimExpr threadIdx_ext = analyzer.Simplify(extractor.threadIdx_x_ext * extractor.threadIdx_y_ext *
                                              extractor.threadIdx_z_ext);
@@ -303,6 +309,30 @@ std::string CodeGenCUDA::Finish() {
     decl_stream << "}\n";
   }
 
+  if (need_cluster_helpers_) {
+    // The index of the cluster in the grid and of the block in its cluster.
+    for (const char* reg : {"clusterid", "cluster_ctaid"}) {
+      for (const char* dim : {"x", "y", "z"}) {
+        decl_stream << "__forceinline__ __device__ unsigned int tvm_" << reg << "_" << dim
+                    << "() {\n";
+        decl_stream << "  unsigned int r;\n";
+        decl_stream << "  asm volatile (\"mov.u32 %0, %%" << reg << "." << dim
+                    << ";\" : \"=r\"(r));\n";
+        decl_stream << "  return r;\n";
+        decl_stream << "}\n";
+      }
+    }
+    decl_stream << "template <typename T>\n";
+    decl_stream << "__forceinline__ __device__ T*\n";
+    decl_stream << "tvm_cluster_map_shared_rank(T* smem_ptr, unsigned int cta_rank)\n";
+    decl_stream << "{\n";
+    decl_stream << "  T* r;\n";
+    decl_stream << "  asm volatile (\"mapa.u64 %0, %1, %2;\" : \"=l\"(r) "
+                   ": \"l\"(smem_ptr), \"r\"(cta_rank));\n";
+    decl_stream << "  return r;\n";
+    decl_stream << "}\n";
+  }
+
   decl_stream << "\n#if (((__CUDACC_VER_MAJOR__ == 11) && (__CUDACC_VER_MINOR__ >= 4)) || \\\n";
   decl_stream << "     (__CUDACC_VER_MAJOR__ > 11))\n";
   decl_stream << "#define TVM_ENABLE_L2_PREFETCH 1\n";
@@ -334,7 +364,16 @@ void CodeGenCUDA::VisitStmt_(const tir::ForNode* op) {
 
 void CodeGenCUDA::BindThreadIndex(const IterVar& iv) {
   ICHECK(!var_idmap_.count(iv->var.get()));
-  var_idmap_[iv->var.get()] = CastFromTo(iv->thread_tag, DataType::UInt(32), iv->var.dtype());
+  std::string value = iv->thread_tag;
+  if (use_cluster_launch_ && value.compare(0, 9, "blockIdx.") == 0) {
+    // In a cluster launch, blockIdx indexes the clusters of the grid.
+    need_cluster_helpers_ = true;
+    value = "tvm_clusterid_" + value.substr(9) + "()";
+  } else if (value.compare(0, 11, "clusterIdx.") == 0) {
+    need_cluster_helpers_ = true;
+    value = "tvm_cluster_ctaid_" + value.substr(11) + "()";
+  }
+  var_idmap_[iv->var.get()] = CastFromTo(value, DataType::UInt(32), iv->var.dtype());
 }
 
 void CodeGenCUDA::PrintType(DataType t, std::ostream& os) {  // NOLINT(*)
@@ -753,6 +792,12 @@ void CodeGenCUDA::PrintStorageSync(const CallNode* op) {
   } else if (sync == "shared" || sync == "shared.dyn") {
     this->PrintIndent();
     this->stream << "__syncthreads();\n";
+  } else if (sync == "shared.cluster") {
+    // Synchronize all the threads of the cluster, making the shared memory writes of every
+    // block visible to the others.
+    this->PrintIndent();
+    this->stream << "asm volatile (\"barrier.cluster.arrive.aligned;\\n"
+                    "barrier.cluster.wait.aligned;\" ::: \"memory\");\n";
   } else if (sync == "global") {
     if (!need_global_barrier_) {
       need_global_barrier_ = true;
@@ -789,7 +834,7 @@ void CodeGenCUDA::PrintStorageSync(const CallNode* op) {
 void CodeGenCUDA::PrintStorageScope(const std::string& scope, std::ostream& os) {  // NOLINT(*)
   ICHECK_NE(scope, "global") << "Cannot allocate global memory when targeting CUDA. You must pass "
                                 "all global arrays as input instead";
-  if (scope == "shared") {
+  if (scope == "shared" || scope == "shared.cluster") {
     os << "__shared__ ";
   } else if (scope == "shared.dyn") {
     os << "extern __shared__ ";
@@ -1179,6 +1224,20 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
     CHECK(barrier_id < barrier_count_);
     std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
     this->stream << PrintCpAsyncBulkAsm(dst, dst_offset, src, src_offset, size, barrier);
+  } else if (op->op.same_as(builtin::ptx_cp_async_bulk_tensor())) {
+    need_cast_smem_ptr_to_int_ = true;
+    ICHECK_GE(op->args.size(), 5U);
+    std::string dst = this->PrintExpr(op->args[0]);
+    std::string dst_offset = this->PrintExpr(op->args[1]);
+    std::string tensormap = this->PrintExpr(op->args[2]);
+    int barrier_id = Downcast<IntImm>(op->args[3])->value;
+    CHECK(barrier_id < barrier_count_);
+    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::vector<std::string> coords;
+    for (size_t i = 4; i < op->args.size(); ++i) {
+      coords.push_back(this->PrintExpr(op->args[i]));
+    }
+    this->stream << PrintCpAsyncBulkTensorAsm(dst, dst_offset, tensormap, coords, barrier);
   } else if (op->op.same_as(builtin::ptx_commit_group())) {
     this->stream << "__asm__ __volatile__(\"cp.async.commit_group;\");\n\n";
   } else if (op->op.same_as(builtin::ptx_wait_group())) {
@@ -1215,7 +1274,8 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
     int barrier_id = Downcast<IntImm>(op->args[0])->value;
     CHECK(barrier_id < barrier_count_);
     std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
-    this->stream << PrintWaitBarrierAsm(barrier);
+    std::string phase = op->args.size() > 1 ? this->PrintExpr(op->args[1]) : "0";
+    this->stream << PrintWaitBarrierAsm(barrier, phase);
   } else if (op->op.same_as(builtin::create_barriers())) {
     CHECK_EQ(barrier_count_, -1);
     int barrier_count = Downcast<IntImm>(op->args[0])->value;
@@ -1230,6 +1290,60 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
                  << barrier_name_ << "[" << barrier_count << "];\n";
     this->stream << "for (int i = 0; i < " << barrier_count << "; ++i) { " << barrier_name_
                  << "[i] = 0; }\n";
+  } else if (op->op.same_as(builtin::ptx_map_shared_rank())) {
+    need_cluster_helpers_ = true;
+    os << "tvm_cluster_map_shared_rank(" << this->PrintExpr(op->args[0]) << ", "
+       << this->PrintExpr(op->args[1]) << ")";
+  } else if (op->op.same_as(builtin::ptx_wgmma_encode_smem_desc())) {
+    need_cast_smem_ptr_to_int_ = true;
+    std::string smem_addr = this->PrintExpr(op->args[0]) + " + " + this->PrintExpr(op->args[1]);
+    std::string leading_byte_offset = this->PrintExpr(op->args[2]);
+    std::string stride_byte_offset = this->PrintExpr(op->args[3]);
+    int swizzle_mode = Downcast<IntImm>(op->args[4])->value;
+    CHECK(swizzle_mode >= 0 && swizzle_mode <= 3)
+        << "The swizzle mode of the wgmma matrix descriptor must be in [0, 3], but got "
+        << swizzle_mode;
+    // The addresses and offsets are encoded in units of 16 bytes, in bits [0, 14) for the start
+    // address, [16, 30) for the leading byte offset, [32, 46) for the stride byte offset, and
+    // the swizzle mode is in bits [62, 64).
+    os << "((((uint64_t)cast_smem_ptr_to_int(" << smem_addr << ") & 0x3FFFF) >> 4) | ((((uint64_t)("
+       << leading_byte_offset << ") & 0x3FFFF) >> 4) << 16) | ((((uint64_t)(" << stride_byte_offset
+       << ") & 0x3FFFF) >> 4) << 32) | ((uint64_t)" << swizzle_mode << " << 62))";
+  } else if (op->op.same_as(builtin::ptx_wgmma_mma_async())) {
+    // arg 0: shape: m64nNkK
+    // arg 1: A precision: fp16, bf16, tf32, e4m3, e5m2
+    // arg 2: B precision: fp16, bf16, tf32, e4m3, e5m2
+    // arg 3: C precision: fp32, fp16
+    // arg 4: A shared memory matrix descriptor
+    // arg 5: B shared memory matrix descriptor
+    // arg 6: C accumulator
+    // arg 7: C accumulator index
+    // arg 8: scale of the accumulator, 0 to overwrite it
+    // arg 9: whether A is transposed
+    // arg 10: whether B is transposed
+    ICHECK_EQ(op->args.size(), 11U);
+    std::string shape = Downcast<StringImm>(op->args[0])->value;
+    std::string A_dtype = Downcast<StringImm>(op->args[1])->value;
+    std::string B_dtype = Downcast<StringImm>(op->args[2])->value;
+    std::string C_dtype = Downcast<StringImm>(op->args[3])->value;
+    std::string desc_a = this->PrintExpr(op->args[4]);
+    std::string desc_b = this->PrintExpr(op->args[5]);
+    std::string c_ref = this->PrintExpr(op->args[6]);
+    std::string c_bias = this->PrintExpr(op->args[7]);
+    std::string scale_d = this->PrintExpr(op->args[8]);
+    bool trans_a = Downcast<Bool>(op->args[9])->value;
+    bool trans_b = Downcast<Bool>(op->args[10])->value;
+    this->stream << PrintWgmmaAssembly(shape, A_dtype, B_dtype, C_dtype, desc_a, desc_b, c_ref,
+                                       c_bias, scale_d, trans_a, trans_b);
+  } else if (op->op.same_as(builtin::ptx_wgmma_fence())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.fence.sync.aligned;\" ::: \"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_commit_group())) {
+    this->stream
+        << "__asm__ __volatile__(\"wgmma.commit_group.sync.aligned;\" ::: \"memory\");\n\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_wait_group())) {
+    int n = Downcast<IntImm>(op->args[0])->value;
+    this->stream << "__asm__ __volatile__(\"wgmma.wait_group.sync.aligned " << n
+                 << ";\" ::: \"memory\");\n\n";
   } else if (op->op.same_as(builtin::ptx_ldg32())) {
     /*
     asm volatile (
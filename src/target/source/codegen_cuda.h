@@ -111,6 +111,10 @@ class CodeGenCUDA final : public CodeGenC {
   bool need_mma_h_{false};
   // whether need cast_smem_ptr_to_int helper function
   bool need_cast_smem_ptr_to_int_{false};
+  // whether need the thread block cluster helper functions
+  bool need_cluster_helpers_{false};
+  // whether the current kernel is launched in thread block clusters
+  bool use_cluster_launch_{false};
   // Op attribute map
   OpAttrMap<bool> op_need_warp_shuffle_ = Op::GetAttrMap<bool>("cuda.need_warp_shuffle");
 
@@ -24,6 +24,7 @@
 #include "ptx.h"
 
 #include <algorithm>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -758,6 +759,41 @@ std::string PrintCpAsyncBulkAsm(const std::string& shared_ptr,
   return asm_code;
 }
 
+std::string PrintCpAsyncBulkTensorAsm(const std::string& shared_ptr,
+                                      const std::string& shared_elem_offset,
+                                      const std::string& tensormap,
+                                      const std::vector<std::string>& coords,
+                                      const std::string& barrier) {
+  CHECK(coords.size() >= 1 && coords.size() <= 5)
+      << "cp.async.bulk.tensor supports tensors of 1 to 5 dimensions, but got " << coords.size();
+  std::string asm_code = R"(
+  {
+    unsigned int smem_addr_int = cast_smem_ptr_to_int({smem_addr});
+    unsigned int barrier_addr_int = cast_smem_ptr_to_int({barrier});
+    __asm__ __volatile__(
+      "cp.async.bulk.tensor.{dim}d.shared::cluster.global.tile.mbarrier::complete_tx::bytes [%0], [%1, {{coords}}], [%2];"
+      :: "r"(smem_addr_int), "l"(reinterpret_cast<uint64_t>(&{tensormap})), "r"(barrier_addr_int){coord_operands}
+      : "memory"
+    );
+  }
+)";
+
+  std::string coord_templates, coord_operands;
+  for (size_t i = 0; i < coords.size(); ++i) {
+    coord_templates += (i == 0 ? "%" : ", %") + std::to_string(i + 3);
+    coord_operands += ", \"r\"(" + coords[i] + ")";
+  }
+  Replacer replacer;
+  replacer.register_rule("{smem_addr}", shared_ptr + " + " + shared_elem_offset);
+  replacer.register_rule("{tensormap}", tensormap);
+  replacer.register_rule("{barrier}", "&" + barrier);
+  replacer.register_rule("{dim}", std::to_string(coords.size()));
+  replacer.register_rule("{coords}", coord_templates);
+  replacer.register_rule("{coord_operands}", coord_operands);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
 std::string PrintCpAsyncBarrierAsm(const std::string& barrier) {
   std::string predicated_asm_code = R"(
   {
@@ -832,11 +868,11 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
   return predicated_asm_code;
 }
 
-std::string PrintWaitBarrierAsm(const std::string& barrier) {
+std::string PrintWaitBarrierAsm(const std::string& barrier, const std::string& phase) {
   std::string predicated_asm_code = R"(
   {
     unsigned int barrier_addr_int = cast_smem_ptr_to_int({barrier});
-    constexpr int phase_bit = 0;
+    int phase_bit = {phase};
     __asm__ __volatile__(
       "{ .reg .pred P; WAIT: mbarrier.try_wait.parity.shared.b64 P, [%0], %1; @P bra.uni DONE; bra.uni WAIT; DONE: }"
       :: "r"(barrier_addr_int), "r"(phase_bit)
@@ -846,9 +882,89 @@ std::string PrintWaitBarrierAsm(const std::string& barrier) {
 
   Replacer replacer;
   replacer.register_rule("{barrier}", "&" + barrier);
+  replacer.register_rule("{phase}", phase);
   predicated_asm_code = replacer.rewrite(predicated_asm_code);
   return predicated_asm_code;
 }
 
+std::string PrintWgmmaAssembly(const std::string& shape, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& desc_a, const std::string& desc_b,
+                               const std::string& c_ptr, const std::string& c_offset,
+                               const std::string& scale_d, bool trans_a, bool trans_b) {
+  ptx::DataType dtype_a = ptx::DTypeFromString(A_dtype), dtype_b = ptx::DTypeFromString(B_dtype),
+                dtype_c = ptx::DTypeFromString(C_dtype);
+  auto [m, n, k] = ptx::ParseMMAShape(shape);
+  CHECK_EQ(m, 64) << "wgmma.mma_async only supports m = 64, but got " << shape;
+  CHECK(n >= 8 && n <= 256 && n % 8 == 0)
+      << "wgmma.mma_async requires n to be a multiple of 8 in [8, 256], but got " << shape;
+  // Only the 16-bit multiplicands support the transposed layouts.
+  bool is_16bit = dtype_a == ptx::DataType::kFloat16 || dtype_a == ptx::DataType::kBFloat16;
+  bool is_fp8 = dtype_a == ptx::DataType::kFloat8_e4m3 || dtype_a == ptx::DataType::kFloat8_e5m2;
+  if (is_16bit || dtype_a == ptx::DataType::kTensorFloat32) {
+    CHECK(dtype_a == dtype_b) << "The multiplicands of wgmma.mma_async must have the same type, "
+                              << "but got " << A_dtype << " and " << B_dtype;
+    CHECK_EQ(k, is_16bit ? 16 : 8) << "Invalid k of wgmma.mma_async for " << A_dtype;
+  } else {
+    CHECK(is_fp8) << "wgmma.mma_async does not support the multiplicand type " << A_dtype;
+    CHECK(dtype_b == ptx::DataType::kFloat8_e4m3 || dtype_b == ptx::DataType::kFloat8_e5m2)
+        << "The multiplicand B of wgmma.mma_async must be float8 when A is float8, but got "
+        << B_dtype;
+    CHECK_EQ(k, 32) << "Invalid k of wgmma.mma_async for " << A_dtype;
+  }
+  CHECK(dtype_c == ptx::DataType::kFloat32 ||
+        (dtype_c == ptx::DataType::kFloat16 && dtype_a != ptx::DataType::kBFloat16 &&
+         dtype_a != ptx::DataType::kTensorFloat32))
+      << "Invalid accumulator type " << C_dtype << " of wgmma.mma_async for " << A_dtype;
+  CHECK(is_16bit || (!trans_a && !trans_b))
+      << "wgmma.mma_async only supports transposed multiplicands of 16-bit types";
+
+  // The 64 x n accumulator is distributed over the 128 threads of the warpgroup, and
+  // the 16-bit accumulators are packed in pairs into 32-bit registers.
+  bool fp32_accum = dtype_c == ptx::DataType::kFloat32;
+  int num_regs = fp32_accum ? n / 2 : n / 4;
+  std::ostringstream templates, operands;
+  for (int i = 0; i < num_regs; ++i) {
+    templates << (i == 0 ? "%" : ", %") << i;
+    operands << (i == 0 ? "" : ", ") << (fp32_accum ? "\"+f\"(((float*)(" : "\"+r\"(((unsigned*)(")
+             << "{c_ptr} + {c_offset}))[" << i << "])";
+  }
+  std::string asm_code = R"(
+  {
+    __asm__ __volatile__(
+      "{\n"
+      ".reg .pred p;\n"
+      "setp.ne.b32 p, %{scale_d_id}, 0;\n"
+      "wgmma.mma_async.sync.aligned.{shape}{ctype}{atype}{btype} "
+      "{{templates}}, %{desc_a_id}, %{desc_b_id}, p, 1, 1{trans};\n"
+      "}\n"
+      : {operands}
+      : "l"((uint64_t)({desc_a})), "l"((uint64_t)({desc_b})), "r"((int)({scale_d}))
+    );
+  }
+)";
+
+  Replacer replacer;
+  replacer.register_rule("{scale_d_id}", std::to_string(num_regs + 2));
+  replacer.register_rule("{desc_a_id}", std::to_string(num_regs));
+  replacer.register_rule("{desc_b_id}", std::to_string(num_regs + 1));
+  replacer.register_rule("{shape}", shape);
+  replacer.register_rule("{ctype}", ptx::DTypeToString(dtype_c));
+  replacer.register_rule("{atype}", ptx::DTypeToString(dtype_a));
+  replacer.register_rule("{btype}", ptx::DTypeToString(dtype_b));
+  replacer.register_rule("{trans}", is_16bit ? std::string(", ") + (trans_a ? "1" : "0") + ", " +
+                                                   (trans_b ? "1" : "0")
+                                             : "");
+  replacer.register_rule("{templates}", templates.str());
+  replacer.register_rule("{operands}", operands.str());
+  replacer.register_rule("{desc_a}", desc_a);
+  replacer.register_rule("{desc_b}", desc_b);
+  replacer.register_rule("{scale_d}", scale_d);
+  replacer.register_rule("{c_ptr}", c_ptr);
+  replacer.register_rule("{c_offset}", c_offset);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
 }  // namespace codegen
 }  // namespace tvm
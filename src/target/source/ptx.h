@@ -28,6 +28,7 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace tvm {
 namespace codegen {
@@ -123,6 +124,21 @@ std::string PrintCpAsyncBulkAsm(const std::string& shared_ptr,
                                 const std::string& global_elem_offset, const std::string& bytes,
                                 const std::string& barrier);
 
+/*!
+ * \brief Print ptx async copy of a tensor tile from global to shared memory using
+ * cp.async.bulk.tensor
+ * \param shared_ptr: The pointer to the destination shared memory.
+ * \param shared_elem_offset: The offset into the shared memory.
+ * \param tensormap: The name of the CUtensorMap describing the global tensor and the tile.
+ * \param coords: The coordinates of the tile in the global tensor, innermost dimension first.
+ * \param barrier: The name of the barrier in shared memory.
+ */
+std::string PrintCpAsyncBulkTensorAsm(const std::string& shared_ptr,
+                                      const std::string& shared_elem_offset,
+                                      const std::string& tensormap,
+                                      const std::vector<std::string>& coords,
+                                      const std::string& barrier);
+
 /*!
  * \brief Print ptx async copy barrier using cp.async.mbarrier.arrive
  * \param barrier: The name of the barrier in shared memory.
@@ -155,8 +171,30 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
 /*!
  * \brief Print ptx barrier wait using mbarrier.try_wait
  * \param barrier: The name of the barrier in shared memory.
+ * \param phase: The parity of the phase of the barrier to wait for.
+ */
+std::string PrintWaitBarrierAsm(const std::string& barrier, const std::string& phase = "0");
+
+/*!
+ * \brief Print wgmma.mma_async assembly string given parameters, with both multiplicands in
+ * shared memory.
+ * \param shape The shape string m64nNkK.
+ * \param A_dtype The data type of multiplicand A.
+ * \param B_dtype The data type of multiplicand B.
+ * \param C_dtype The data type of accumulator C.
+ * \param desc_a The shared memory matrix descriptor of multiplicand A.
+ * \param desc_b The shared memory matrix descriptor of multiplicand B.
+ * \param c_ptr Pointer to buffer containing the accumulator registers of the thread.
+ * \param c_offset The offset of the accumulator registers in the buffer.
+ * \param scale_d Whether the accumulator is added to the product, when it is nonzero.
+ * \param trans_a Whether multiplicand A is transposed, i.e., M-major.
+ * \param trans_b Whether multiplicand B is transposed, i.e., N-major.
  */
-std::string PrintWaitBarrierAsm(const std::string& barrier);
+std::string PrintWgmmaAssembly(const std::string& shape, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& desc_a, const std::string& desc_b,
+                               const std::string& c_ptr, const std::string& c_offset,
+                               const std::string& scale_d, bool trans_a, bool trans_b);
 
 }  // namespace codegen
 }  // namespace tvm
@@ -376,8 +376,25 @@ bool VerifyWellFormed(const IRModule& mod, bool assert_mode) {
   return true;
 }
 
+bool VerifyWellFormedIncremental(const IRModule& mod, const IRModule& prev_mod,
+                                 bool assert_mode) {
+  ffi::Map<GlobalVar, BaseFunc> changed;
+  for (const auto& [gvar, base_func] : mod->functions) {
+    auto prev = prev_mod->functions.find(gvar);
+    if (prev != prev_mod->functions.end() && (*prev).second.same_as(base_func)) continue;
+    if (auto prim_func = base_func.as<PrimFunc>()) {
+      if (!VerifyWellFormed(prim_func.value(), assert_mode)) return false;
+      changed.Set(gvar, base_func);
+    }
+  }
+  if (changed.empty()) return true;
+  return UndefinedVarVerifier::Verify(IRModule(changed), assert_mode);
+}
+
 TVM_FFI_STATIC_INIT_BLOCK() {
   namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("tir.analysis.VerifyWellFormedIncremental",
+                        VerifyWellFormedIncremental);
   refl::GlobalDef().def("tir.analysis.VerifyWellFormed", [](const ObjectRef& obj,
                                                             bool assert_mode) {
     if (auto opt = obj.as<PrimFunc>()) {
@@ -30,6 +30,7 @@
 #include <optional>
 
 #include "../../arith/scalable_expression.h"
+#include "../../support/pooled_object_allocator.h"
 #include "../../support/str_escape.h"
 #include "buffer_common.h"
 
@@ -93,7 +94,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
     ICHECK(b.defined()) << "ValueError: b is undefined\n";                                   \
     CHECK(a.dtype() == b.dtype()) << "TypeError: mismatched types. " << a.dtype() << " vs. " \
                                   << b.dtype() << "\n";                                      \
-    ObjectPtr<T> node = ffi::make_object<T>();                                               \
+    ObjectPtr<T> node = support::MakePooledObject<T>();                                      \
     node->dtype = a.dtype();                                                                 \
     node->a = std::move(a);                                                                  \
     node->b = std::move(b);                                                                  \
@@ -108,7 +109,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
     ICHECK(b.defined()) << "ValueError: b is undefined\n";                                   \
     CHECK(a.dtype() == b.dtype()) << "TypeError: mismatched types. " << a.dtype() << " vs. " \
                                   << b.dtype() << "\n";                                      \
-    ObjectPtr<T> node = ffi::make_object<T>();                                               \
+    ObjectPtr<T> node = support::MakePooledObject<T>();                                      \
     DataType a_dtype = a.dtype();                                                            \
     node->dtype =                                                                            \
         DataType::Bool(a_dtype.get_lanes_or_vscale_factor(), a_dtype.is_scalable_vector());  \
@@ -250,7 +251,7 @@ Cast::Cast(DataType t, PrimExpr value, Span span) {
   ICHECK(value.defined());
   ICHECK_EQ(t.get_lanes_or_vscale_factor(), value.dtype().get_lanes_or_vscale_factor());
   ICHECK(t.is_scalable_vector() == value.dtype().is_scalable_vector());
-  ObjectPtr<CastNode> node = ffi::make_object<CastNode>();
+  ObjectPtr<CastNode> node = support::MakePooledObject<CastNode>();
   node->dtype = t;
   node->value = std::move(value);
   node->span = std::move(span);
@@ -401,7 +402,7 @@ And::And(PrimExpr a, PrimExpr b, Span span) {
   ICHECK(b.dtype().is_bool());
   ICHECK(a.dtype() == b.dtype()) << "TypeError: mismatched types";
 
-  ObjectPtr<AndNode> node = ffi::make_object<AndNode>();
+  ObjectPtr<AndNode> node = support::MakePooledObject<AndNode>();
   node->dtype =
       DataType::Bool(a.dtype().get_lanes_or_vscale_factor(), a.dtype().is_scalable_vector());
   node->a = std::move(a);
@@ -424,7 +425,7 @@ Or::Or(PrimExpr a, PrimExpr b, Span span) {
   ICHECK(b.dtype().is_bool());
   ICHECK(a.dtype() == b.dtype()) << "TypeError: mismatched types";
 
-  ObjectPtr<OrNode> node = ffi::make_object<OrNode>();
+  ObjectPtr<OrNode> node = support::MakePooledObject<OrNode>();
   node->dtype =
       DataType::Bool(a.dtype().get_lanes_or_vscale_factor(), a.dtype().is_scalable_vector());
   node->a = std::move(a);
@@ -443,7 +444,7 @@ Not::Not(PrimExpr a, Span span) {
   ICHECK(a.defined()) << "ValueError: a is undefined";
   ICHECK(a.dtype().is_bool());
 
-  ObjectPtr<NotNode> node = ffi::make_object<NotNode>();
+  ObjectPtr<NotNode> node = support::MakePooledObject<NotNode>();
   DataType a_dtype = a.dtype();
   node->dtype = DataType::Bool(a_dtype.get_lanes_or_vscale_factor(), a_dtype.is_scalable_vector());
   node->a = std::move(a);
@@ -469,7 +470,7 @@ Select::Select(PrimExpr condition, PrimExpr true_value, PrimExpr false_value, Sp
       << "TypeError: mismatched types. "
       << "False type: " << false_value.dtype() << "; True type: " << true_value.dtype();
 
-  ObjectPtr<SelectNode> node = ffi::make_object<SelectNode>();
+  ObjectPtr<SelectNode> node = support::MakePooledObject<SelectNode>();
   node->dtype = true_value.dtype();
   node->condition = std::move(condition);
   node->true_value = std::move(true_value);
@@ -496,7 +497,7 @@ Ramp::Ramp(PrimExpr base, PrimExpr stride, PrimExpr lanes, Span span) {
     stride = cast(base.dtype(), stride);
   }
 
-  ObjectPtr<RampNode> node = ffi::make_object<RampNode>();
+  ObjectPtr<RampNode> node = support::MakePooledObject<RampNode>();
   auto* lanes_as_int = lanes.as<IntImmNode>();
   if (lanes_as_int) {
     int lanes = static_cast<int>(lanes_as_int->value);
@@ -530,7 +531,7 @@ Broadcast::Broadcast(PrimExpr value, PrimExpr lanes, Span span) {
   ICHECK(value.defined());
   ICHECK(value.dtype().is_scalar());
 
-  ObjectPtr<BroadcastNode> node = ffi::make_object<BroadcastNode>();
+  ObjectPtr<BroadcastNode> node = support::MakePooledObject<BroadcastNode>();
   auto* lanes_int = lanes.as<IntImmNode>();
   if (lanes_int) {
     int lanes = static_cast<int>(lanes_int->value);
@@ -564,7 +565,7 @@ Let::Let(Var var, PrimExpr value, PrimExpr body, Span span) {
   ICHECK(body.defined());
   ICHECK_EQ(value.dtype(), var.dtype());
 
-  ObjectPtr<LetNode> node = ffi::make_object<LetNode>();
+  ObjectPtr<LetNode> node = support::MakePooledObject<LetNode>();
   node->dtype = body.dtype();
   node->var = std::move(var);
   node->value = std::move(value);
@@ -586,7 +587,7 @@ Call::Call(DataType dtype, RelaxExpr op, ffi::Array<PrimExpr> args, Span span) {
     ICHECK(args[i].defined()) << "arg " << i << " is not defined()";
   }
 
-  ObjectPtr<CallNode> node = ffi::make_object<CallNode>();
+  ObjectPtr<CallNode> node = support::MakePooledObject<CallNode>();
   node->dtype = dtype;
   node->op = std::move(op);
   node->args = std::move(args);
@@ -845,7 +846,7 @@ BufferLoad::BufferLoad(Buffer buffer, ffi::Array<PrimExpr> indices,
         << ".";
   }
 
-  ObjectPtr<BufferLoadNode> node = ffi::make_object<BufferLoadNode>();
+  ObjectPtr<BufferLoadNode> node = support::MakePooledObject<BufferLoadNode>();
   node->buffer = std::move(buffer);
   node->indices = std::move(indices);
   node->predicate = std::move(predicate);
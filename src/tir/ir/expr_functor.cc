@@ -123,7 +123,7 @@ PrimExpr ExprMutator::VisitExpr_(const BufferLoadNode* op) {
   if (indices.same_as(op->indices)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return BufferLoad(op->buffer, indices, op->predicate);
+    return RecordMutatorCopy(op, BufferLoad(op->buffer, indices, op->predicate));
   }
 }
 
@@ -133,7 +133,7 @@ PrimExpr ExprMutator::VisitExpr_(const ProducerLoadNode* op) {
   if (indices.same_as(op->indices)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return ProducerLoad(op->producer, indices);
+    return RecordMutatorCopy(op, ProducerLoad(op->producer, indices));
   }
 }
 
@@ -143,7 +143,7 @@ PrimExpr ExprMutator::VisitExpr_(const LetNode* op) {
   if (value.same_as(op->value) && body.same_as(op->body)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Let(op->var, value, body);
+    return RecordMutatorCopy(op, Let(op->var, value, body));
   }
 }
 
@@ -154,7 +154,7 @@ PrimExpr ExprMutator::VisitExpr_(const CallNode* op) {
   if (args.same_as(op->args)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Call(op->dtype, op->op, args);
+    return RecordMutatorCopy(op, Call(op->dtype, op->op, args));
   }
 }
 
@@ -172,7 +172,7 @@ DEFINE_OP_RETURN_SELF_EXPR_MUTATE_(StringImmNode)
     if (a.same_as(op->a) && b.same_as(op->b)) {          \
       return ffi::GetRef<PrimExpr>(op);                  \
     } else {                                             \
-      return OP(a, b);                                   \
+      return RecordMutatorCopy(op, OP(a, b));            \
     }                                                    \
   }
 
@@ -217,7 +217,8 @@ PrimExpr ExprMutator::VisitExpr_(const ReduceNode* op) {
       init.same_as(op->init)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Reduce(op->combiner, source, axis, condition, op->value_index, init);
+    return RecordMutatorCopy(
+        op, Reduce(op->combiner, source, axis, condition, op->value_index, init));
   }
 }
 
@@ -226,7 +227,7 @@ PrimExpr ExprMutator::VisitExpr_(const CastNode* op) {
   if (value.same_as(op->value)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Cast(op->dtype, value);
+    return RecordMutatorCopy(op, Cast(op->dtype, value));
   }
 }
 
@@ -235,7 +236,7 @@ PrimExpr ExprMutator::VisitExpr_(const NotNode* op) {
   if (a.same_as(op->a)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Not(a);
+    return RecordMutatorCopy(op, Not(a));
   }
 }
 
@@ -247,7 +248,7 @@ PrimExpr ExprMutator::VisitExpr_(const SelectNode* op) {
       false_value.same_as(op->false_value)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Select(condition, true_value, false_value);
+    return RecordMutatorCopy(op, Select(condition, true_value, false_value));
   }
 }
 
@@ -258,7 +259,7 @@ PrimExpr ExprMutator::VisitExpr_(const RampNode* op) {
   if (base.same_as(op->base) && stride.same_as(op->stride) && lanes.same_as(op->lanes)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Ramp(base, stride, lanes);
+    return RecordMutatorCopy(op, Ramp(base, stride, lanes));
   }
 }
 
@@ -268,7 +269,7 @@ PrimExpr ExprMutator::VisitExpr_(const BroadcastNode* op) {
   if (value.same_as(op->value) && lanes.same_as(op->lanes)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Broadcast(value, lanes);
+    return RecordMutatorCopy(op, Broadcast(value, lanes));
   }
 }
 
@@ -279,7 +280,7 @@ PrimExpr ExprMutator::VisitExpr_(const ShuffleNode* op) {
   if (vectors.same_as(op->vectors) && indices.same_as(op->indices)) {
     return ffi::GetRef<PrimExpr>(op);
   } else {
-    return Shuffle(vectors, indices);
+    return RecordMutatorCopy(op, Shuffle(vectors, indices));
   }
 }
 
@@ -17,6 +17,7 @@
  * under the License.
  */
 #include <tvm/ffi/container/array.h>
+#include <tvm/tir/stmt_functor.h>
 
 /*!
  * \file tir/ir/functor_common.h
@@ -41,6 +42,21 @@ inline ffi::Array<T> MutateArray(ffi::Array<T> arr, F fmutate) {
   return arr.Map(fmutate);
 }
 
+/*! \brief Count a node rebuilt by a default mutator visitor into the MutatorCopyStats. */
+void CountMutatorCopy(const Object* op, const ObjectRef& result);
+
+/*!
+ * \brief Return the node a default mutator visitor rebuilt from `op`, counting it as a copy
+ *  unless it was updated in place.
+ */
+template <typename T>
+inline T RecordMutatorCopy(const Object* op, T result) {
+  if (result.get() != op) {
+    CountMutatorCopy(op, result);
+  }
+  return result;
+}
+
 }  // namespace tir
 }  // namespace tvm
 #endif  // TVM_TIR_IR_FUNCTOR_COMMON_H_
@@ -27,6 +27,7 @@
 #include <tvm/tir/op_attr_types.h>
 #include <tvm/tir/stmt.h>
 
+#include "../../support/pooled_object_allocator.h"
 #include "buffer_common.h"
 
 namespace tvm {
@@ -66,7 +67,7 @@ LetStmt::LetStmt(Var var, PrimExpr value, Stmt body, Span span) {
     ICHECK_EQ(value.dtype(), var.dtype());
   }
 
-  ObjectPtr<LetStmtNode> node = ffi::make_object<LetStmtNode>();
+  ObjectPtr<LetStmtNode> node = support::MakePooledObject<LetStmtNode>();
   node->var = std::move(var);
   node->value = std::move(value);
   node->body = std::move(body);
@@ -83,7 +84,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
 
 // AttrStmt
 AttrStmt::AttrStmt(ffi::Any node, ffi::String attr_key, PrimExpr value, Stmt body, Span span) {
-  auto n = ffi::make_object<AttrStmtNode>();
+  auto n = support::MakePooledObject<AttrStmtNode>();
   n->node = node;
   n->attr_key = std::move(attr_key);
   n->value = std::move(value);
@@ -175,7 +176,7 @@ For::For(Var loop_var, PrimExpr min, PrimExpr extent, ForKind kind, Stmt body,
     ICHECK(loop_var.dtype() == (*step).dtype()) << loop_var.dtype() << " vs " << (*step).dtype();
   }
 
-  ObjectPtr<ForNode> node = ffi::make_object<ForNode>();
+  ObjectPtr<ForNode> node = support::MakePooledObject<ForNode>();
   node->loop_var = std::move(loop_var);
   node->min = std::move(min);
   node->extent = std::move(extent);
@@ -397,7 +398,7 @@ SeqStmt::SeqStmt(ffi::Array<Stmt> seq, Span span) {
                            << "Use the node " << seq[0] << "directly, "
                            << "or for dynamic usage, normalize using SeqStmt::Flatten()";
 
-  auto node = ffi::make_object<SeqStmtNode>();
+  auto node = support::MakePooledObject<SeqStmtNode>();
   node->seq = std::move(seq);
   node->span = std::move(span);
   data_ = std::move(node);
@@ -415,7 +416,7 @@ IfThenElse::IfThenElse(PrimExpr condition, Stmt then_case, ffi::Optional<Stmt> e
   ICHECK(condition.defined());
   ICHECK(then_case.defined());
   // else_case may be null.
-  ObjectPtr<IfThenElseNode> node = ffi::make_object<IfThenElseNode>();
+  ObjectPtr<IfThenElseNode> node = support::MakePooledObject<IfThenElseNode>();
   node->condition = std::move(condition);
   node->then_case = std::move(then_case);
   node->else_case = std::move(else_case);
@@ -435,7 +436,7 @@ TVM_FFI_STATIC_INIT_BLOCK() {
 Evaluate::Evaluate(PrimExpr value, Span span) {
   ICHECK(value.defined());
 
-  ObjectPtr<EvaluateNode> node = ffi::make_object<EvaluateNode>();
+  ObjectPtr<EvaluateNode> node = support::MakePooledObject<EvaluateNode>();
   node->value = std::move(value);
   node->span = std::move(span);
   data_ = std::move(node);
@@ -514,7 +515,7 @@ BufferStore::BufferStore(Buffer buffer, PrimExpr value, ffi::Array<PrimExpr> ind
                << "`, but RHS's dtype is `" << value.dtype() << "`";
   }
 
-  ObjectPtr<BufferStoreNode> node = ffi::make_object<BufferStoreNode>();
+  ObjectPtr<BufferStoreNode> node = support::MakePooledObject<BufferStoreNode>();
   node->buffer = std::move(buffer);
   node->value = std::move(value);
   node->indices = std::move(indices);
@@ -22,6 +22,7 @@
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/ir/module.h>
+#include <tvm/node/structural_equal.h>
 #include <tvm/tir/data_type_rewriter.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/stmt_functor.h>
@@ -33,6 +34,31 @@
 namespace tvm {
 namespace tir {
 
+namespace {
+struct MutatorCopyState {
+  MutatorCopyStats stats;
+  bool check_needless{false};
+};
+thread_local MutatorCopyState mutator_copy_state;
+}  // namespace
+
+void CountMutatorCopy(const Object* op, const ObjectRef& result) {
+  MutatorCopyState& state = mutator_copy_state;
+  ++state.stats.num_copies;
+  if (state.check_needless &&
+      StructuralEqual()(ffi::GetRef<ObjectRef>(op), result, /*map_free_params=*/false)) {
+    ++state.stats.num_needless_copies;
+  }
+}
+
+MutatorCopyStats GetMutatorCopyStats() { return mutator_copy_state.stats; }
+
+bool SetMutatorNeedlessCopyCheck(bool enabled) {
+  bool prev = mutator_copy_state.check_needless;
+  mutator_copy_state.check_needless = enabled;
+  return prev;
+}
+
 void StmtVisitor::VisitStmt_(const LetStmtNode* op) {
   this->VisitExpr(op->value);
   this->VisitStmt(op->body);
@@ -243,7 +269,7 @@ Stmt StmtMutator::VisitStmt_(const AttrStmtNode* op) {
     auto n = CopyOnWrite(op);
     n->value = std::move(value);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -256,7 +282,7 @@ Stmt StmtMutator::VisitStmt_(const LetStmtNode* op) {
     auto n = CopyOnWrite(op);
     n->value = std::move(value);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -277,7 +303,7 @@ Stmt StmtMutator::VisitStmt_(const ForNode* op) {
     n->extent = std::move(extent);
     n->step = std::move(step);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -290,7 +316,7 @@ Stmt StmtMutator::VisitStmt_(const WhileNode* op) {
     auto n = CopyOnWrite(op);
     n->condition = std::move(condition);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -306,7 +332,7 @@ Stmt StmtMutator::VisitStmt_(const AllocateNode* op) {
     n->extents = std::move(extents);
     n->body = std::move(body);
     n->condition = std::move(condition);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -320,7 +346,7 @@ Stmt StmtMutator::VisitStmt_(const AllocateConstNode* op) {
     auto n = CopyOnWrite(op);
     n->extents = std::move(extents);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -332,7 +358,7 @@ Stmt StmtMutator::VisitStmt_(const DeclBufferNode* op) {
   } else {
     auto n = CopyOnWrite(op);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -351,7 +377,7 @@ Stmt StmtMutator::VisitStmt_(const IfThenElseNode* op) {
     n->condition = std::move(condition);
     n->then_case = std::move(then_case);
     n->else_case = std::move(else_case);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -365,7 +391,7 @@ Stmt StmtMutator::VisitStmt_(const BufferStoreNode* op) {
     auto n = CopyOnWrite(op);
     n->value = std::move(value);
     n->indices = std::move(indices);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -381,7 +407,7 @@ Stmt StmtMutator::VisitStmt_(const BufferRealizeNode* op) {
     n->bounds = std::move(bounds);
     n->condition = std::move(condition);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -392,7 +418,7 @@ Stmt StmtMutator::VisitStmt_(const SeqStmtNode* op) {
   } else {
     auto node = CopyOnWrite(op);
     node->seq = std::move(seq);
-    return SeqStmt::Flatten(SeqStmt(node));
+    return RecordMutatorCopy(op, SeqStmt::Flatten(SeqStmt(node)));
   }
 }
 
@@ -417,7 +443,7 @@ Stmt StmtMutator::VisitSeqStmt_(const SeqStmtNode* op, bool flatten_before_visit
     } else {
       auto n = CopyOnWrite(op);
       n->seq = std::move(seq);
-      return Stmt(n);
+      return RecordMutatorCopy(op, Stmt(n));
     }
   };
   if (flatten_before_visit) {
@@ -451,7 +477,7 @@ Stmt StmtMutator::VisitStmt_(const AssertStmtNode* op) {
     n->condition = std::move(condition);
     n->message = std::move(message);
     n->body = std::move(body);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -462,7 +488,7 @@ Stmt StmtMutator::VisitStmt_(const EvaluateNode* op) {
   } else {
     auto n = CopyOnWrite(op);
     n->value = std::move(value);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -488,7 +514,7 @@ Stmt StmtMutator::VisitStmt_(const BlockNode* op) {
     n->body = std::move(body);
     n->init = std::move(init);
     n->match_buffers = std::move(match_buffers);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -503,7 +529,7 @@ Stmt StmtMutator::VisitStmt_(const BlockRealizeNode* op) {
     n->iter_values = std::move(v);
     n->predicate = std::move(pred);
     n->block = Downcast<Block>(block);
-    return Stmt(n);
+    return RecordMutatorCopy(op, Stmt(n));
   }
 }
 
@@ -856,13 +882,22 @@ TVM_FFI_STATIC_INIT_BLOCK() {
            [](ObjectRef node, ffi::Function f) {
              tir::PreOrderVisit(node, [f](const ObjectRef& n) { return f(n).cast<bool>(); });
            })
-      .def("tir.Substitute", [](ObjectRef node, ffi::Map<Var, PrimExpr> vmap) -> ObjectRef {
-        if (node->IsInstance<StmtNode>()) {
-          return Substitute(Downcast<Stmt>(node), vmap);
-        } else {
-          return Substitute(Downcast<PrimExpr>(node), vmap);
-        }
-      });
+      .def("tir.Substitute",
+           [](ObjectRef node, ffi::Map<Var, PrimExpr> vmap) -> ObjectRef {
+             if (node->IsInstance<StmtNode>()) {
+               return Substitute(Downcast<Stmt>(node), vmap);
+             } else {
+               return Substitute(Downcast<PrimExpr>(node), vmap);
+             }
+           })
+      .def("tir.GetMutatorCopyStats",
+           []() {
+             MutatorCopyStats stats = GetMutatorCopyStats();
+             return ffi::Map<ffi::String, int64_t>(
+                 {{"num_copies", stats.num_copies},
+                  {"num_needless_copies", stats.num_needless_copies}});
+           })
+      .def("tir.SetMutatorNeedlessCopyCheck", SetMutatorNeedlessCopyCheck);
 }
 
 }  // namespace tir
@@ -25,8 +25,16 @@
 #include <tvm/ffi/reflection/registry.h>
 #include <tvm/ffi/rvalue_ref.h>
 #include <tvm/node/repr_printer.h>
+#include <tvm/support/parallel_for.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/transform.h>
 
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../../support/pooled_object_allocator.h"
+
 namespace tvm {
 namespace tir {
 namespace transform {
@@ -46,10 +54,17 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.is_entry_func", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.add_lower_pass", ffi::Array<ffi::Array<ObjectRef>>);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.debug_keep_trivial_loop", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.use_async_copy", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.direct_call", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_static_smem", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_smem_interval_coloring", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_smem_alignment", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_smem_swizzle_bytes", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_lwp", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.vtcm_capacity", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.ptx_ldg32", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.pooled_node_allocation", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.parallel_prim_func_passes", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.narrow_index_with_fallback", Bool);
 
 /*!
  * \brief Function level pass that applies transformations to all
@@ -63,6 +78,12 @@ class PrimFuncPassNode : public PassNode {
   /*! \brief The pass function called on each. */
   std::function<PrimFunc(PrimFunc, IRModule, PassContext)> pass_func;
 
+  /*!
+   * \brief Whether the pass may run on several PrimFuncs concurrently, which the passes defined
+   *  in Python may not, since their calls would contend for the GIL.
+   */
+  bool parallel_safe{true};
+
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
     refl::ObjectDef<PrimFuncPassNode>().def_ro("pass_info", &PrimFuncPassNode::pass_info);
@@ -106,10 +127,75 @@ PrimFuncPass::PrimFuncPass(std::function<PrimFunc(PrimFunc, IRModule, PassContex
   data_ = std::move(n);
 }
 
+/*!
+ * \brief Run a pass on the PrimFuncs of a module concurrently.
+ *
+ * The pass sees the input module, which is left unchanged until all functions are done, and runs
+ * in a copy of the pass context without the instruments, since the instruments wrap the whole
+ * pass on the calling thread.
+ *
+ * \return Whether the pass ran, which it does not if the module has fewer than two PrimFuncs.
+ */
+bool RunPrimFuncPassInParallel(const PrimFuncPassNode* pass, IRModule* mod,
+                               const PassContext& pass_ctx, int num_threads, bool pooled) {
+  std::vector<GlobalVar> gvars;
+  std::vector<PrimFunc> funcs;
+  for (const auto& kv : (*mod)->functions) {
+    if (auto opt_func = kv.second.as<PrimFunc>()) {
+      gvars.push_back(kv.first);
+      funcs.push_back(opt_func.value());
+    }
+  }
+  if (funcs.size() < 2) {
+    return false;
+  }
+  auto ctx_node = ffi::make_object<PassContextNode>(*pass_ctx.operator->());
+  ctx_node->instruments = {};
+  PassContext worker_ctx(ctx_node);
+  Target target = Target::Current(/*allow_not_defined=*/true);
+
+  std::vector<ffi::Optional<PrimFunc>> results(funcs.size());
+  support::parallel_for_dynamic(
+      0, static_cast<int>(funcs.size()), num_threads, [&](int thread_id, int task_id) {
+        // The pass context and target scopes are thread-local, so enter them on each worker.
+        With<PassContext> ctx_scope(worker_ctx);
+        std::optional<With<Target>> target_scope;
+        if (target.defined()) {
+          target_scope.emplace(target);
+        }
+        support::PooledAllocationScope pooled_allocation(pooled);
+        PrimFunc func = std::move(funcs[task_id]);
+        results[task_id] = pass->pass_func(std::move(func), *mod, worker_ctx);
+      });
+
+  IRModuleNode* mod_ptr = mod->CopyOnWrite();
+  for (size_t i = 0; i < gvars.size(); ++i) {
+    if (results[i].defined()) {
+      mod_ptr->functions.Set(gvars[i], results[i].value());
+    } else {
+      mod_ptr->Remove(gvars[i]);
+    }
+  }
+  return true;
+}
+
 // Perform Module -> Module optimizations at the PrimFunc level.
 IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx) const {
   ICHECK(mod.defined());
+  bool pooled = pass_ctx->GetConfig<Bool>("tir.pooled_node_allocation", Bool(false)).value();
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("tir.parallel_prim_func_passes", Integer(0)).value()->value;
+  if (num_threads < 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (parallel_safe && num_threads > 1 &&
+      RunPrimFuncPassInParallel(this, &mod, pass_ctx, num_threads, pooled)) {
+    return mod;
+  }
+
   std::vector<GlobalVar> deleted_list;
+  // Recycle the memory of the short-lived nodes created by the pass.
+  support::PooledAllocationScope pooled_allocation(pooled);
 
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
@@ -156,7 +242,9 @@ TVM_FFI_STATIC_INIT_BLOCK() {
         auto wrapped_pass_func = [pass_func](PrimFunc func, IRModule mod, PassContext ctx) {
           return pass_func(ffi::RValueRef<PrimFunc>(std::move(func)), mod, ctx);
         };
-        return PrimFuncPass(wrapped_pass_func, pass_info);
+        PrimFuncPass pass(wrapped_pass_func, pass_info);
+        const_cast<PrimFuncPassNode*>(pass.as<PrimFuncPassNode>())->parallel_safe = false;
+        return pass;
       });
 }
 
@@ -145,6 +145,7 @@ class SRefTreeVerifier : public StmtVisitor {
 void VerifySRefTree(const ScheduleState& self) { SRefTreeVerifier::Verify(self.get()); }
 
 void VerifyCachedFlags(const ScheduleState& self) {
+  self->FlushBlockInfo();
   std::vector<StmtSRef> block_info_not_found;
   std::vector<std::tuple<StmtSRef, bool, bool>> block_info_wrong_affine_binding;
   std::vector<std::tuple<StmtSRef, bool, bool>> block_info_wrong_region_cover;
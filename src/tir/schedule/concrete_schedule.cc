@@ -58,6 +58,7 @@ class ScheduleCopier {
     ScheduleCopier copier(src_state);
     ObjectPtr<ScheduleStateNode> n = ffi::make_object<ScheduleStateNode>();
     n->mod = src_state->mod;
+    src_state->FlushBlockInfo();
     n->block_info = copier.Copy(src_state->block_info);
     n->stmt2ref = copier.Copy(src_state->stmt2ref);
     n->debug_mask = src_state->debug_mask;
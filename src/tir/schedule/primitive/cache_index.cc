@@ -463,7 +463,7 @@ ffi::Array<StmtSRef> CacheIndex(ScheduleState self, const StmtSRef& block_sref,
   ffi::Array<Block> cache_stages = MakeIndexCacheStage(&info, storage_scope);
   Stmt new_scope = CacheIndexRewriter::Rewrite(/*scope_sref=*/scope_sref, /*info=*/&info);
 
-  bool old_stage_pipeline = self->block_info[block_sref].stage_pipeline;
+  bool old_stage_pipeline = self->IsStagePipeline(block_sref);
 
   // Step 3. Replacing and updating flags.
   self->Replace(scope_sref, new_scope, info.block_reuse);
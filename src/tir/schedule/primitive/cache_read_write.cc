@@ -1662,7 +1662,7 @@ The region cover property require to hold for every of its child blocks
     const BlockNode* child_block = TVM_SREF_TO_BLOCK(child_block_sref);
     for (const BufferRegion& region : child_block->reads) {
       if (region->buffer.same_as(read_buffer)) {
-        if (!self->block_info.at(child_block_sref).region_cover) {
+        if (!self->IsRegionCoveredConsumer(child_block_sref)) {
           const BlockNode* block = TVM_SREF_TO_BLOCK(scope_root);
           throw NotRegionCoverError(self->mod, ffi::GetRef<Block>(block));
         }
@@ -89,8 +89,9 @@ class NotSingleReadWriteBuffer : public ScheduleError {
 
   static Buffer GetSingleRead(const ScheduleState& self, const Block& block,
                               const StmtSRef& scope_root_sref) {
+    BlockScope scope = self->GetBlockScope(scope_root_sref);
     const std::unordered_map<Buffer, ffi::Array<StmtSRef>, ObjectPtrHash, ObjectPtrEqual>&
-        buffer_writers = self->block_info.at(scope_root_sref).scope->buffer_writers;
+        buffer_writers = scope->buffer_writers;
     const BufferNode* read_buffer = nullptr;
     for (const BufferRegion& read_region : block->reads) {
       const BufferNode* buffer = read_region->buffer.get();
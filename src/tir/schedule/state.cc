@@ -154,6 +154,47 @@ class BlockInfoCollector : private StmtVisitor {
     collector.VisitStmt(stmt);
   }
 
+  /*!
+   * \brief Recalculate the scope of a scope root, its `stage_pipeline` flag and the `region_cover`
+   * flags of its child blocks, without visiting the blocks deeper in the scope.
+   * \param self The schedule state
+   * \param scope_root The sref to the scope root
+   */
+  static void CollectScope(ScheduleStateNode* self, const StmtSRef& scope_root) {
+    BlockInfoCollector collector(self);
+    collector.visit_child_blocks_ = false;
+    for (const StmtSRefNode* p = scope_root->parent; p != nullptr; p = p->parent) {
+      if (const auto* loop = p->StmtAs<ForNode>()) {
+        collector.analyzer_.Bind(loop->loop_var, Range::FromMinExtent(loop->min, loop->extent));
+      }
+    }
+    const BlockNode* block = TVM_SREF_TO_BLOCK(scope_root);
+    collector.srefs_.push_back(scope_root);
+    collector.VisitStmt(block->body);
+    ffi::Array<StmtSRef> child_block_srefs = std::move(collector.block_frames_.back());
+    BlockInfo& info = self->block_info.at(scope_root);
+    info.scope = BlockScope(child_block_srefs);
+    info.stage_pipeline =
+        collector.CheckRegionCoverAndStagePipeline(info, scope_root, child_block_srefs);
+  }
+
+  /*!
+   * \brief Recalculate the `affine_binding` flag of a block the same way as the collection does
+   * \param self The schedule state
+   * \param block_sref The sref to the block
+   */
+  static bool CalculateAffineBinding(ScheduleStateNode* self, const StmtSRef& block_sref) {
+    const BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+    if (block_sref->parent == nullptr) {
+      return block->iter_vars.empty();
+    }
+    arith::Analyzer analyzer;
+    return IsAffineBinding(
+        /*realize=*/GetBlockRealize(ffi::GetRef<ScheduleState>(self), block_sref),
+        /*loop_var_ranges=*/LoopDomainOfSRefTreePath(ffi::GetRef<StmtSRef>(block_sref->parent)),
+        /*analyzer=*/&analyzer);
+  }
+
  private:
   explicit BlockInfoCollector(ScheduleStateNode* self)
       : self_(self), srefs_{}, block2realize_{}, block_frames_{} {
@@ -340,6 +381,11 @@ class BlockInfoCollector : private StmtVisitor {
     block_frames_.emplace_back();
     const BlockNode* block = realize->block.get();
     block2realize_.emplace(block, ffi::GetRef<BlockRealize>(realize));
+    if (!visit_child_blocks_) {
+      block_frames_.pop_back();
+      block_frames_.back().push_back(self_->stmt2ref.at(block));
+      return;
+    }
     // Recursive visit
     PushSRef(block);
     VisitStmt(block->body);  // `block->init` is not visited
@@ -367,6 +413,8 @@ class BlockInfoCollector : private StmtVisitor {
   std::vector<ffi::Array<StmtSRef>> block_frames_;
   /*! \brief The auxiliary analyzer */
   arith::Analyzer analyzer_;
+  /*! \brief Whether to collect the BlockInfo of the blocks visited, or only list them */
+  bool visit_child_blocks_{true};
 };
 
 /**************** Constructor ****************/
@@ -686,22 +734,20 @@ class SRefUpdater : public StmtVisitor {
 
   void UpdateBlockInfo(const StmtSRef& block_sref) {
     using TIter = std::unordered_map<StmtSRef, BlockInfo, ObjectPtrHash, ObjectPtrEqual>::iterator;
-    // The caller is responsible for correcting the flags
-    BlockInfo new_info((BlockScope(GetChildBlockSRefOnSRefTree(self_, block_sref))));
-    std::pair<TIter, bool> insert_result = self_->block_info.emplace(block_sref, new_info);
+    // The caller is responsible for correcting the flags.
+    // The scope is left undefined, and calculated when it is first queried.
+    std::pair<TIter, bool> insert_result = self_->block_info.emplace(block_sref, BlockInfo());
     bool inserted = insert_result.second;
     BlockInfo& info = insert_result.first->second;
     if (inserted) {
       // Insertion has happened, update the flags accordingly
-      BlockInfo& info = insert_result.first->second;
       info.affine_binding = false;
       info.region_cover = false;
       info.stage_pipeline = false;
     } else {
       // Insertion didn't take place, because the entry has been there before.
       // In this case, we assume that flags are still valid so intentionally keep them unchanged
-      new_info.stage_pipeline = info.stage_pipeline;
-      info.scope = std::move(new_info.scope);
+      info.scope = BlockScope(ffi::UnsafeInit());
     }
   }
 
@@ -1000,11 +1046,106 @@ BlockInfo ScheduleStateNode::GetBlockInfo(const StmtSRef& block_sref) const {
   CHECK(it != this->block_info.end())
       << "IndexError: Cannot find the corresponding BlockScope to the block sref:\n"
       << ffi::GetRef<Stmt>(block_sref->stmt);
+  // Recalculating the stale BlockInfo does not change the state observed through the queries
+  const_cast<ScheduleStateNode*>(this)->SettleBlockInfo(block_sref);
   return it->second;
 }
 
+/*! \brief Find the nearest ancestor of a sref that is a block, or nullptr if there is none */
+static const StmtSRefNode* GetParentBlockSRef(const StmtSRefNode* sref) {
+  for (const StmtSRefNode* p = sref->parent; p != nullptr; p = p->parent) {
+    if (p->stmt->IsInstance<BlockNode>()) {
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+void ScheduleStateNode::SettleBlockInfo(const StmtSRef& block_sref) {
+  if (!stale_affine_binding_.empty() && stale_affine_binding_.erase(block_sref)) {
+    block_info.at(block_sref).affine_binding =
+        BlockInfoCollector::CalculateAffineBinding(this, block_sref);
+  }
+  if (!stale_scope_.empty()) {
+    // The `region_cover` flag of a block is calculated with the scope of its parent
+    if (const StmtSRefNode* parent = GetParentBlockSRef(block_sref.get())) {
+      StmtSRef parent_sref = ffi::GetRef<StmtSRef>(parent);
+      if (stale_scope_.erase(parent_sref)) {
+        BlockInfoCollector::CollectScope(this, parent_sref);
+      }
+    }
+    if (stale_scope_.erase(block_sref)) {
+      BlockInfoCollector::CollectScope(this, block_sref);
+    }
+  }
+  BlockInfo& info = block_info.at(block_sref);
+  if (!info.scope.defined()) {
+    info.scope =
+        BlockScope(GetChildBlockSRefOnSRefTree(ffi::GetRef<ScheduleState>(this), block_sref));
+  }
+}
+
+void ScheduleStateNode::FlushBlockInfo() const {
+  ScheduleStateNode* self = const_cast<ScheduleStateNode*>(this);
+  // The srefs expired since they were marked are skipped
+  auto is_alive = [self](const StmtSRef& sref) {
+    return sref->stmt != nullptr && self->block_info.count(sref);
+  };
+  std::vector<StmtSRef> scope_roots(stale_scope_.begin(), stale_scope_.end());
+  std::vector<StmtSRef> blocks(stale_affine_binding_.begin(), stale_affine_binding_.end());
+  self->stale_scope_.clear();
+  self->stale_affine_binding_.clear();
+  for (const StmtSRef& scope_root : scope_roots) {
+    if (is_alive(scope_root)) {
+      BlockInfoCollector::CollectScope(self, scope_root);
+    }
+  }
+  for (const StmtSRef& block_sref : blocks) {
+    if (is_alive(block_sref)) {
+      self->block_info.at(block_sref).affine_binding =
+          BlockInfoCollector::CalculateAffineBinding(self, block_sref);
+    }
+  }
+  for (auto& kv : self->block_info) {
+    if (!kv.second.scope.defined()) {
+      kv.second.scope =
+          BlockScope(GetChildBlockSRefOnSRefTree(ffi::GetRef<ScheduleState>(self), kv.first));
+    }
+  }
+}
+
 void ScheduleStateNode::UpdateScopeBlockInfo(const Stmt& stmt) {
-  BlockInfoCollector::Collect(this, stmt);
+  const BlockNode* root_block = stmt.as<BlockNode>();
+  bool is_outermost = true;
+  PreOrderVisit(stmt, [&](const ObjectRef& obj) -> bool {
+    if (obj->IsInstance<PrimExprNode>()) {
+      return false;
+    }
+    const auto* block = obj.as<BlockNode>();
+    if (block == nullptr) {
+      return true;
+    }
+    auto it = stmt2ref.find(block);
+    if (it == stmt2ref.end()) {
+      // `block->init` is not on the sref tree
+      return false;
+    }
+    const StmtSRef& sref = it->second;
+    if (is_outermost) {
+      is_outermost = false;
+      // The `region_cover` flags of the outermost blocks depend on the scope enclosing them
+      if (block != root_block) {
+        if (const StmtSRefNode* parent = GetParentBlockSRef(sref.get())) {
+          stale_scope_.insert(ffi::GetRef<StmtSRef>(parent));
+        }
+      }
+    }
+    if (block != root_block) {
+      stale_affine_binding_.insert(sref);
+    }
+    stale_scope_.insert(sref);
+    return true;
+  });
 }
 
 TVM_DLL ffi::Array<Bool> GetCachedFlags(const ScheduleState& self, const StmtSRef& block_sref) {
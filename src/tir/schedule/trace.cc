@@ -320,6 +320,21 @@ void TraceNode::ApplyToSchedule(
   }
 }
 
+void TraceNode::ApplyRangeToSchedule(
+    Schedule sch, int begin, int end,
+    std::unordered_map<const Object*, const Object*>* rv_map) const {
+  ICHECK(0 <= begin && begin <= end && end <= static_cast<int>(this->insts.size()))
+      << "ValueError: Invalid range [" << begin << ", " << end << ") of a trace with "
+      << this->insts.size() << " instruction(s)";
+  for (int i = begin; i < end; ++i) {
+    const Instruction& inst = this->insts[i];
+    ffi::Array<Any> inputs = TranslateInputRVs(inst->inputs, *rv_map);
+    ffi::Array<Any> outputs =
+        inst->kind->f_apply_to_schedule(sch, inputs, inst->attrs, this->GetDecision(inst));
+    TranslateAddOutputRVs(inst->outputs, outputs, rv_map);
+  }
+}
+
 ObjectRef TraceNode::AsJSON(bool remove_postproc) const {
   std::unordered_map<ObjectRef, ffi::String, ObjectPtrHash, ObjectPtrEqual> rv_names;
   ffi::Array<ffi::Any> json_insts;
@@ -18,6 +18,12 @@
  */
 #include "./traced_schedule.h"
 
+#include <tvm/ffi/reflection/registry.h>
+
+#include <algorithm>
+
+#include "../../support/utils.h"
+
 namespace tvm {
 namespace tir {
 
@@ -798,5 +804,136 @@ void TracedScheduleNode::AnnotateBufferAccess(const BlockRV& block_rv, int buffe
       /*outputs=*/{}));
 }
 
+/******** TraceReplayCache ********/
+
+Schedule TraceReplayCache::Replay(const IRModule& mod, const Trace& trace, bool remove_postproc,
+                                  support::LinearCongruentialEngine::TRandState seed,
+                                  ScheduleErrorRenderLevel error_render_level) {
+  const ffi::Array<Instruction>& insts = trace->insts;
+  int n_insts = 0;
+  while (n_insts < static_cast<int>(insts.size()) &&
+         !(remove_postproc && insts[n_insts]->kind->IsPostproc())) {
+    ++n_insts;
+  }
+  ffi::Array<Any> json_insts =
+      Downcast<ffi::Array<Any>>(trace->AsJSON(remove_postproc))[0].cast<ffi::Array<Any>>();
+  // Hash the prefixes, up to the first sampling instruction that is not decided yet, whose
+  // outcome depends on the random state rather than on the trace.
+  std::vector<uint64_t> prefix_hashes{ObjectPtrHash()(mod)};
+  std::vector<Any> decisions;
+  std::vector<int> decided_insts;
+  for (int i = 0; i < n_insts; ++i) {
+    const Instruction& inst = insts[i];
+    Any decision = trace->GetDecision(inst);
+    if (decision != nullptr) {
+      decided_insts.push_back(i);
+    } else if (support::StartsWith(inst->kind->name, "Sample")) {
+      break;
+    }
+    uint64_t hash = support::HashCombine(prefix_hashes.back(), StructuralHash()(json_insts[i]));
+    prefix_hashes.push_back(support::HashCombine(hash, StructuralHash()(decision)));
+    decisions.push_back(decision);
+  }
+  // A mutation keeps the instructions before the decision it changes, so the prefixes that end
+  // right before a decided instruction are the ones worth caching.
+  std::vector<int> checkpoints;
+  int n_decided = decided_insts.size();
+  for (int i = 1; i <= snapshots_per_trace_ && n_decided > 0; ++i) {
+    int checkpoint = decided_insts[std::max(0, i * n_decided / snapshots_per_trace_ - 1)];
+    if (checkpoint > 0 && (checkpoints.empty() || checkpoints.back() < checkpoint)) {
+      checkpoints.push_back(checkpoint);
+    }
+  }
+
+  auto f_matches = [&](const Snapshot& snapshot, int prefix_len) -> bool {
+    if (!snapshot.mod.same_as(mod) || static_cast<int>(snapshot.insts.size()) != prefix_len) {
+      return false;
+    }
+    for (int i = 0; i < prefix_len; ++i) {
+      if (!StructuralEqual()(snapshot.json_insts[i], json_insts[i]) ||
+          !StructuralEqual()(snapshot.decisions[i], decisions[i])) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  ffi::Optional<Schedule> sch = std::nullopt;
+  std::unordered_map<const Object*, const Object*> rv_map;
+  int begin = 0;
+  for (auto it = checkpoints.rbegin(); it != checkpoints.rend() && !sch.defined(); ++it) {
+    auto found = snapshots_.find(prefix_hashes[*it]);
+    if (found == snapshots_.end() || !f_matches(found->second, *it)) {
+      continue;
+    }
+    const Snapshot& snapshot = found->second;
+    sch = snapshot.sch->Copy();
+    sch.value()->Seed(seed);
+    // The copy shares the random variables of the snapshot, which are reached from the
+    // instructions of this trace by position.
+    for (int i = 0; i < *it; ++i) {
+      const ffi::Array<Any>& outputs = insts[i]->outputs;
+      const ffi::Array<Any>& snapshot_outputs = snapshot.insts[i]->outputs;
+      for (int j = 0, n = outputs.size(); j < n; ++j) {
+        rv_map[outputs[j].as<Object>()] = snapshot.rv_map.at(snapshot_outputs[j].as<Object>());
+      }
+    }
+    begin = *it;
+  }
+  if (!sch.defined()) {
+    sch = Schedule::Traced(mod, seed, /*debug_mask=*/0, error_render_level);
+  } else {
+    ++num_resumed_;
+  }
+
+  for (int checkpoint : checkpoints) {
+    if (checkpoint <= begin) {
+      continue;
+    }
+    trace->ApplyRangeToSchedule(sch.value(), begin, checkpoint, &rv_map);
+    begin = checkpoint;
+    uint64_t hash = prefix_hashes[checkpoint];
+    if (auto found = snapshots_.find(hash);
+        found != snapshots_.end() && f_matches(found->second, checkpoint)) {
+      continue;
+    }
+    Snapshot snapshot;
+    snapshot.mod = mod;
+    snapshot.insts = {insts.begin(), insts.begin() + checkpoint};
+    snapshot.json_insts = {json_insts.begin(), json_insts.begin() + checkpoint};
+    snapshot.decisions = {decisions.begin(), decisions.begin() + checkpoint};
+    snapshot.sch = sch.value()->Copy();
+    snapshot.rv_map = rv_map;
+    if (snapshots_.count(hash) == 0) {
+      order_.push_back(hash);
+    }
+    snapshots_[hash] = std::move(snapshot);
+    while (static_cast<int>(order_.size()) > max_snapshots_) {
+      snapshots_.erase(order_.front());
+      order_.pop_front();
+    }
+  }
+  trace->ApplyRangeToSchedule(sch.value(), begin, n_insts, &rv_map);
+  return sch.value();
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  // Replays the traces in order through one cache, and returns the modules replayed along with
+  // the number of replays that resumed from a cached prefix.
+  refl::GlobalDef().def("tir.schedule.TraceReplayCacheReplay",
+                        [](IRModule mod, ffi::Array<Trace> traces, bool remove_postproc,
+                           int64_t seed) -> ffi::Array<Any> {
+                          TraceReplayCache cache;
+                          ffi::Array<IRModule> mods;
+                          for (const Trace& trace : traces) {
+                            Schedule sch = cache.Replay(mod, trace, remove_postproc, seed,
+                                                        ScheduleErrorRenderLevel::kDetail);
+                            mods.push_back(sch->mod());
+                          }
+                          return {mods, cache.NumResumed()};
+                        });
+}
+
 }  // namespace tir
 }  // namespace tvm
@@ -19,6 +19,10 @@
 #ifndef TVM_TIR_SCHEDULE_TRACED_SCHEDULE_H_
 #define TVM_TIR_SCHEDULE_TRACED_SCHEDULE_H_
 
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 #include "./concrete_schedule.h"
 
 namespace tvm {
@@ -150,6 +154,63 @@ class TracedScheduleNode : public ConcreteScheduleNode {
                             BufferIndexType buffer_index_type, const IndexMap& index_map) final;
 };
 
+/*!
+ * \brief A cache of the schedules replayed from the prefixes of traces. A replay resumes from
+ * the longest cached prefix with the same instructions and decisions, so the traces that only
+ * differ in their last decisions, e.g. the mutants of the same parent, skip most of the replay.
+ * \note The cache is not thread-safe, each thread should own one.
+ */
+class TraceReplayCache {
+ public:
+  /*!
+   * \brief Constructor
+   * \param max_snapshots The maximum number of schedules cached
+   * \param snapshots_per_trace The maximum number of schedules cached when replaying a trace
+   */
+  explicit TraceReplayCache(int max_snapshots = 64, int snapshots_per_trace = 4)
+      : max_snapshots_(max_snapshots), snapshots_per_trace_(snapshots_per_trace) {}
+  /*!
+   * \brief Replay a trace onto a module, as `Schedule::Traced` followed by `ApplyToSchedule`
+   * \param mod The module to be scheduled
+   * \param trace The trace to be replayed
+   * \param remove_postproc If postprocessing instructions are removed
+   * \param seed The random seed of the schedule
+   * \param error_render_level The level of error rendering of the schedule
+   * \return The schedule replayed
+   */
+  Schedule Replay(const IRModule& mod, const Trace& trace, bool remove_postproc,
+                  support::LinearCongruentialEngine::TRandState seed,
+                  ScheduleErrorRenderLevel error_render_level);
+  /*! \brief The number of replays that resumed from a cached prefix */
+  int64_t NumResumed() const { return num_resumed_; }
+
+ private:
+  /*! \brief A schedule replayed from a prefix of a trace */
+  struct Snapshot {
+    /*! \brief The module scheduled */
+    IRModule mod{ffi::UnsafeInit()};
+    /*! \brief The instructions of the prefix, which own the random variables in `rv_map` */
+    std::vector<Instruction> insts;
+    /*! \brief The JSON form of the instructions, to compare with other traces */
+    std::vector<Any> json_insts;
+    /*! \brief The decisions on the instructions */
+    std::vector<Any> decisions;
+    /*! \brief The schedule after applying the prefix, only used as a source of copies */
+    Schedule sch{nullptr};
+    /*! \brief The mapping from the random variables of `insts` to those of `sch` */
+    std::unordered_map<const Object*, const Object*> rv_map;
+  };
+
+  int max_snapshots_;
+  int snapshots_per_trace_;
+  /*! \brief The snapshots by the hash of their prefixes */
+  std::unordered_map<uint64_t, Snapshot> snapshots_;
+  /*! \brief The hashes of the snapshots in the order of insertion, for eviction */
+  std::deque<uint64_t> order_;
+  /*! \brief The number of replays that resumed from a cached prefix */
+  int64_t num_resumed_{0};
+};
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -23,15 +23,21 @@
 // Instrument checkers for out of the bounds access.
 
 #include <tvm/arith/analyzer.h>
+#include <tvm/arith/int_set.h>
+#include <tvm/arith/iter_affine_map.h>
+#include <tvm/arith/pattern.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -61,6 +67,126 @@ class BoundCollector : public StmtVisitor {
   std::unordered_map<const VarNode*, ffi::Array<PrimExpr>> mem_to_shape;
 };
 
+/*!
+ * \brief Collect the accesses of a loop nest that run on every iteration that reaches them, with
+ *  the ranges of the loops around them, so that their bound checks can be hoisted before it.
+ */
+class LoopAccessCollector : public StmtExprVisitor {
+ public:
+  /*! \brief A buffer access of the loop nest. */
+  struct Access {
+    const Object* node;
+    ffi::Array<PrimExpr> indices;
+    Var buffer_var;
+  };
+
+  explicit LoopAccessCollector(const ForNode* loop) {
+    defined_vars.insert(loop->loop_var.get());
+    Range range = Range::FromMinExtent(loop->min, loop->extent);
+    loop_ranges.Set(loop->loop_var, range);
+    dom_map[loop->loop_var.get()] = arith::IntSet::FromRange(range);
+    analyzer_.Bind(loop->loop_var, range, true);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    Range range = Range::FromMinExtent(op->min, op->extent);
+    // A range that depends on the loop nest isn't a box, so its accesses are checked in place.
+    auto defined_in_loop = [&](const VarNode* var) { return defined_vars.count(var); };
+    if (!UsesVar(op->min, defined_in_loop) && !UsesVar(op->extent, defined_in_loop)) {
+      loop_ranges.Set(op->loop_var, range);
+    }
+    defined_vars.insert(op->loop_var.get());
+    dom_map[op->loop_var.get()] = arith::EvalSet(range, dom_map);
+    // The range of an empty loop would cover accesses that never run.
+    bool prev_unconditional = unconditional_;
+    unconditional_ = unconditional_ && analyzer_.CanProve(op->extent > 0);
+    analyzer_.Bind(op->loop_var, range, true);
+    StmtExprVisitor::VisitStmt_(op);
+    unconditional_ = prev_unconditional;
+  }
+
+  void VisitStmt_(const WhileNode* op) final {
+    bool prev_unconditional = unconditional_;
+    unconditional_ = false;
+    StmtExprVisitor::VisitStmt_(op);
+    unconditional_ = prev_unconditional;
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    this->VisitExpr(op->condition);
+    bool prev_unconditional = unconditional_;
+    unconditional_ = false;
+    this->VisitStmt(op->then_case);
+    if (op->else_case) {
+      this->VisitStmt(op->else_case.value());
+    }
+    unconditional_ = prev_unconditional;
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (!op->op.same_as(builtin::if_then_else())) {
+      StmtExprVisitor::VisitExpr_(op);
+      return;
+    }
+    this->VisitExpr(op->args[0]);
+    bool prev_unconditional = unconditional_;
+    unconditional_ = false;
+    this->VisitExpr(op->args[1]);
+    this->VisitExpr(op->args[2]);
+    unconditional_ = prev_unconditional;
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    defined_vars.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    defined_vars.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const AllocateNode* op) final {
+    defined_vars.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == tir::attr::thread_extent || op->attr_key == tir::attr::virtual_thread) {
+      defined_vars.insert(Downcast<IterVar>(op->node)->var.get());
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    if (unconditional_) {
+      accesses.push_back({op, op->indices, op->buffer->data});
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    if (unconditional_) {
+      accesses.push_back({op, op->indices, op->buffer->data});
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  /*! \brief The accesses that run on every iteration of the loops around them. */
+  std::vector<Access> accesses;
+  /*! \brief The variables defined in the loop nest, including its loop variables. */
+  std::unordered_set<const VarNode*> defined_vars;
+  /*! \brief The ranges of the loop variables of the loop nest that don't depend on the nest. */
+  ffi::Map<Var, Range> loop_ranges;
+  /*! \brief The ranges of all the loop variables of the loop nest. */
+  std::unordered_map<const VarNode*, arith::IntSet> dom_map;
+
+ private:
+  /*! \brief Whether the accesses visited run whenever the loop body does. */
+  bool unconditional_{true};
+  arith::Analyzer analyzer_;
+};
+
 class BoundChecker : public StmtExprMutator {
  public:
   explicit BoundChecker(
@@ -82,13 +208,45 @@ class BoundChecker : public StmtExprMutator {
     return StmtExprMutator::VisitExpr_(op);
   }
 
+  Stmt VisitStmt_(const ForNode* op) final {
+    // Check each access whose indices range over an interval known before the loop once,
+    // before it, instead of at every iteration, so that the loop can still be vectorized.
+    LoopAccessCollector collector(op);
+    collector(op->body);
+    PrimExpr condition;
+    for (const auto& access : collector.accesses) {
+      if (hoisted_.count(access.node) || !HasShape(access.buffer_var) ||
+          collector.defined_vars.count(access.buffer_var.get()) ||
+          !IndicesAreValid(access.indices)) {
+        continue;
+      }
+      ffi::Optional<PrimExpr> access_condition = MakeRangeCondition(access, collector);
+      if (!access_condition.has_value()) {
+        continue;
+      }
+      hoisted_.insert(access.node);
+      if (!analyzer_.CanProve(access_condition.value())) {
+        condition = condition.defined() ? And(condition, access_condition.value())
+                                        : access_condition.value();
+      }
+    }
+    Stmt loop = StmtExprMutator::VisitStmt_(op);
+    if (!condition.defined()) {
+      return loop;
+    }
+    if (!analyzer_.CanProve(op->extent > 0)) {
+      condition = Or(LE(op->extent, make_zero(op->extent.dtype())), condition);
+    }
+    return AssertStmt(condition, StringImm(error_message_), loop);
+  }
+
   Stmt VisitStmt_(const BufferStoreNode* op) final {
     store_scope_bound_collector_.clear();
     process_store_ = true;
     unsafe_rewritten_ = false;
     StmtExprMutator::VisitStmt_(op);
     process_store_ = false;
-    if (CanInstrument(op->indices, op->buffer->data)) {
+    if (!hoisted_.count(op) && CanInstrument(op->indices, op->buffer->data)) {
       Collect(op->indices, op->buffer->data);
     }
     // The collector should has at least one item.
@@ -106,7 +264,7 @@ class BoundChecker : public StmtExprMutator {
   }
 
   PrimExpr VisitExpr_(const BufferLoadNode* op) final {
-    if (CanInstrument(op->indices, op->buffer->data)) {
+    if (!hoisted_.count(op) && CanInstrument(op->indices, op->buffer->data)) {
       Collect(op->indices, op->buffer->data);
     }
     return StmtExprMutator::VisitExpr_(op);
@@ -177,9 +335,123 @@ class BoundChecker : public StmtExprMutator {
     return expr.defined() && expr.dtype().is_scalar();
   }
 
+  bool HasShape(const Var& buffer_var) const {
+    return buffer_var.defined() && mem_to_shape_.count(buffer_var.get());
+  }
+
   bool CanInstrument(const ffi::Array<PrimExpr>& indices, const Var& buffer_var) const {
-    return buffer_var.defined() && mem_to_shape_.count(buffer_var.get()) &&
-           IndicesAreValid(indices) && !unsafe_rewritten_;
+    return HasShape(buffer_var) && IndicesAreValid(indices) && !unsafe_rewritten_;
+  }
+
+  /*!
+   * \brief Compute the interval of the values an index takes over the loop ranges, when the
+   *  index is known to take both of its bounds.
+   * \return The interval, or std::nullopt when it would only be an over-approximation, e.g. for
+   *  an index using a loop variable in several non-linear terms.
+   */
+  static ffi::Optional<arith::IntSet> ExactIndexSet(const PrimExpr& index,
+                                                    const ffi::Map<Var, Range>& loop_ranges,
+                                                    arith::Analyzer* analyzer) {
+    auto sign_of = [&](const PrimExpr& value) {
+      if (analyzer->CanProve(value >= 0)) return 1;
+      if (analyzer->CanProve(value <= 0)) return -1;
+      return 0;
+    };
+    // An affine index over a box of loop ranges takes its bounds at the corners of the box.
+    ffi::Array<Var> loop_vars;
+    for (const auto& [var, range] : loop_ranges) {
+      loop_vars.push_back(var);
+    }
+    ffi::Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, loop_vars);
+    auto in_loop = [&](const VarNode* var) { return loop_ranges.count(ffi::GetRef<Var>(var)); };
+    if (!coeffs.empty() && std::none_of(coeffs.begin(), coeffs.end(), [&](const PrimExpr& c) {
+          return UsesVar(c, in_loop);
+        })) {
+      PrimExpr lower = coeffs.back();
+      PrimExpr upper = coeffs.back();
+      for (size_t i = 0; i < loop_vars.size(); ++i) {
+        Range range = loop_ranges[loop_vars[i]];
+        PrimExpr at_min = coeffs[i] * range->min;
+        PrimExpr at_max = coeffs[i] * (range->min + range->extent - 1);
+        int sign = sign_of(coeffs[i]);
+        if (sign == 0) {
+          return std::nullopt;
+        }
+        lower = lower + (sign > 0 ? at_min : at_max);
+        upper = upper + (sign > 0 ? at_max : at_min);
+      }
+      return arith::IntSet::Interval(lower, upper);
+    }
+    // A surjective iter map, e.g. of i % 4, covers the whole span of each of its splits.
+    arith::IterMapResult iter_map = arith::DetectIterMap(
+        {index}, loop_ranges, Bool(true), arith::IterMapLevel::Surjective, analyzer);
+    if (iter_map->indices.size() != 1) {
+      return std::nullopt;
+    }
+    const arith::IterSumExpr& sum = iter_map->indices[0];
+    PrimExpr lower = sum->base;
+    PrimExpr upper = sum->base;
+    for (const arith::IterSplitExpr& split : sum->args) {
+      PrimExpr span = (split->extent - 1) * split->scale;
+      int sign = sign_of(split->scale);
+      if (sign == 0) {
+        return std::nullopt;
+      }
+      lower = sign > 0 ? lower : lower + span;
+      upper = sign > 0 ? upper + span : upper;
+    }
+    return arith::IntSet::Interval(lower, upper);
+  }
+
+  /*!
+   * \brief Make the condition that all the indices an access takes in a loop nest are in bounds.
+   * \return The condition, or std::nullopt when the exact interval of an index isn't known, or
+   *  can't be expressed with the variables defined before the loop nest.
+   */
+  ffi::Optional<PrimExpr> MakeRangeCondition(const LoopAccessCollector::Access& access,
+                                             const LoopAccessCollector& collector) {
+    auto defined_in_loop = [&](const VarNode* var) { return collector.defined_vars.count(var); };
+    ffi::Array<PrimExpr> shape = mem_to_shape_[access.buffer_var.get()];
+    ICHECK_EQ(access.indices.size(), shape.size())
+        << "Mismatch between dimension of physical shape and physical indices";
+    arith::Analyzer analyzer;
+    for (const auto& [var, range] : collector.loop_ranges) {
+      analyzer.Bind(var, range);
+    }
+    PrimExpr condition;
+    for (size_t i = 0; i < access.indices.size(); i++) {
+      PrimExpr index = analyzer.Simplify(access.indices[i]);
+      if (UsesVar(shape[i], defined_in_loop)) {
+        return std::nullopt;
+      }
+      // Cast to the same type - signed, to be able to check lower bound.
+      PrimExpr upper_bound = Cast(DataType::Int(64), analyzer_.Simplify(shape[i]));
+      auto make_condition = [&](const arith::IntSet& index_set) {
+        return analyzer_.Simplify(
+            And(GE(Cast(DataType::Int(64), index_set.min()), make_zero(DataType::Int(64))),
+                LT(Cast(DataType::Int(64), index_set.max()), upper_bound)));
+      };
+      // An interval that over-approximates the index still proves it in bounds.
+      arith::IntSet bound_set = arith::EvalSet(index, collector.dom_map);
+      if (bound_set.HasLowerBound() && bound_set.HasUpperBound() &&
+          analyzer_.CanProve(make_condition(bound_set))) {
+        continue;
+      }
+      // A hoisted check must not fail where the per-access ones would pass, so it is only made
+      // from the exact interval of the index.
+      ffi::Optional<arith::IntSet> index_set =
+          ExactIndexSet(index, collector.loop_ranges, &analyzer);
+      if (!index_set.has_value() || UsesVar(index_set.value().min(), defined_in_loop) ||
+          UsesVar(index_set.value().max(), defined_in_loop)) {
+        return std::nullopt;
+      }
+      PrimExpr current_condition = make_condition(index_set.value());
+      condition = condition.defined() ? And(condition, current_condition) : current_condition;
+    }
+    if (!condition.defined()) {
+      return Bool(true);
+    }
+    return analyzer_.Simplify(condition);
   }
 
   void Collect(ffi::Array<PrimExpr> indices, Var buffer_var) {
@@ -232,6 +504,8 @@ class BoundChecker : public StmtExprMutator {
   const char* const error_message_ = "OUT OF THE BOUNDS";
   // Hashtable which maps buffer_var to shape.
   std::unordered_map<const VarNode*, ffi::Array<PrimExpr>> mem_to_shape_;
+  // The accesses checked before a loop around them.
+  std::unordered_set<const Object*> hoisted_;
   // internal analyzer
   arith::Analyzer analyzer_;
 };
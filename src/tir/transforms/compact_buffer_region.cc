@@ -43,10 +43,16 @@ namespace tir {
 
 using support::NDIntSet;
 
-/*! \brief a more constrained bound estimate for n-dimentional int set */
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.CompactBufferAllocation.polyhedral_bound", Bool);
+
+/*!
+ * \brief a more constrained bound estimate for n-dimentional int set
+ * \param polyhedral_bound Whether to tighten the result with the polyhedral bound, which is
+ * tighter on non-rectangular regions.
+ */
 NDIntSet NDIntSetEval(Region region, PrimExpr predicate,
                       const std::unordered_map<const VarNode*, arith::IntSet>& dom_map,
-                      arith::Analyzer* analyzer) {
+                      arith::Analyzer* analyzer, bool polyhedral_bound) {
   std::unordered_map<Var, Range, ObjectPtrHash, ObjectPtrEqual> var_dom;
   for (const auto& it : dom_map) {
     var_dom[ffi::GetRef<Var>(it.first)] = it.second.CoverRange(Range::FromMinExtent(0, 0));
@@ -55,7 +61,22 @@ NDIntSet NDIntSetEval(Region region, PrimExpr predicate,
       arith::EstimateRegionUpperBound(region, var_dom, predicate, analyzer);
 
   if (eval_res.defined()) {
-    return NDIntSet(eval_res.value().begin(), eval_res.value().end());
+    NDIntSet result(eval_res.value().begin(), eval_res.value().end());
+    if (polyhedral_bound) {
+      if (ffi::Optional<ffi::Array<arith::IntSet>> poly_res =
+              arith::EstimateRegionPolyhedralBound(region, var_dom, predicate, analyzer)) {
+        // Both are upper bounds. The interval one is kept only if provably within the
+        // polyhedral one, since it may refer to the relaxed vars on non-rectangular domains.
+        for (size_t i = 0; i < result.size(); ++i) {
+          const arith::IntSet& poly = poly_res.value()[i];
+          if (!analyzer->CanProve(result[i].min() >= poly.min()) ||
+              !analyzer->CanProve(result[i].max() <= poly.max())) {
+            result[i] = poly;
+          }
+        }
+      }
+    }
+    return result;
   }
   return support::NDIntSetEval(support::NDIntSetFromRegion(region), dom_map);
 }
@@ -103,8 +124,8 @@ class Var2BufferCollector : public StmtExprVisitor {
 class BufferAccessRegionCollector : public StmtExprVisitor {
  public:
   static std::unordered_map<Buffer, Region, ObjectPtrHash, ObjectPtrEqual> Collect(
-      const PrimFunc& f, bool collect_inbound) {
-    BufferAccessRegionCollector region_collector(collect_inbound);
+      const PrimFunc& f, bool collect_inbound, bool polyhedral_bound) {
+    BufferAccessRegionCollector region_collector(collect_inbound, polyhedral_bound);
 
     // collect buffer var to aliased buffer mapping
     Var2BufferCollector var2buffer_collector;
@@ -127,7 +148,8 @@ class BufferAccessRegionCollector : public StmtExprVisitor {
         : buffer(buffer), accessed_region(region) {}
   };
 
-  explicit BufferAccessRegionCollector(bool collect_inbound) : collect_inbound_(collect_inbound) {}
+  explicit BufferAccessRegionCollector(bool collect_inbound, bool polyhedral_bound)
+      : collect_inbound_(collect_inbound), polyhedral_bound_(polyhedral_bound) {}
 
   /**************** Visitor overload ****************/
 
@@ -374,8 +396,8 @@ class BufferAccessRegionCollector : public StmtExprVisitor {
                           [normalize_pred](const PrimExpr& x, const PrimExpr& y) {
                             return normalize_pred(x) && normalize_pred(y);
                           }));
-      NDIntSet nd_int_set =
-          NDIntSetEval(buffer_region->region, predicate, dom_map_, &dom_analyzer_);
+      NDIntSet nd_int_set = NDIntSetEval(buffer_region->region, predicate, dom_map_,
+                                         &dom_analyzer_, polyhedral_bound_);
 
       // Step 3. Restore the non-relaxed ancestor loops domain
       for (size_t i = 0; i < n_ancestor_loops; ++i) {
@@ -482,6 +504,8 @@ class BufferAccessRegionCollector : public StmtExprVisitor {
   /**************** Class members ****************/
   /*! \brief Only collect accessed region within original buffer shape bound. */
   bool collect_inbound_{true};
+  /*! \brief Whether to tighten the accessed regions with their polyhedral bound. */
+  bool polyhedral_bound_{false};
 
   /*! \brief The iteration scopes from the current node up to the root. */
   std::vector<IterVar> ancestor_iters_;
@@ -740,9 +764,10 @@ Stmt BufferCompactorCompact(
   return stmt;
 }
 
-PrimFunc CompactBufferAllocation(PrimFunc f, bool is_strict) {
+PrimFunc CompactBufferAllocation(PrimFunc f, bool is_strict, bool polyhedral_bound) {
   PrimFuncNode* fptr = f.CopyOnWrite();
-  auto region = BufferAccessRegionCollector::Collect(f, /*collect_inbound=*/is_strict);
+  auto region = BufferAccessRegionCollector::Collect(f, /*collect_inbound=*/is_strict,
+                                                     /*polyhedral_bound=*/polyhedral_bound);
   auto storage_align = CollectStorageAlignAnnotation(f->body);
   fptr->body = BufferCompactorCompact(f, region, storage_align);
   return f;
@@ -752,7 +777,9 @@ namespace transform {
 
 Pass CompactBufferAllocation(bool is_strict) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
-    return CompactBufferAllocation(std::move(f), is_strict);
+    bool polyhedral_bound =
+        ctx->GetConfig<Bool>("tir.CompactBufferAllocation.polyhedral_bound", Bool(false)).value();
+    return CompactBufferAllocation(std::move(f), is_strict, polyhedral_bound);
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.CompactBufferAllocation", {});
 }
@@ -26,6 +26,7 @@
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "../../support/utils.h"
@@ -980,6 +981,317 @@ class PipelineRewriter : public StmtExprMutator {
   ffi::Map<ffi::String, ffi::Any> preserved_annotations_;
 };
 
+/*!
+ * \brief Rewriter for the warp-specialized software pipeline, where extra producer threads run
+ * the statements of stage 0 and the original consumer threads run the other statements.
+ *
+ * The buffers produced in stage 0 and read by the consumers get `max_stage + 1` versions. Each
+ * version is guarded by a "full" mbarrier, which the producers arrive on once they have written
+ * the version, and an "empty" mbarrier, which the consumers arrive on once they have read it.
+ * The loop is unrolled by the number of versions so that every barrier id is a constant:
+ *
+ *   if threadIdx.x < num_consumer_threads:
+ *     for ko in range(ceildiv(extent, num_versions)):
+ *       for v in range(num_versions):  # unrolled
+ *         wait(full[v], ko % 2)
+ *         consumer statements of iteration ko * num_versions + v
+ *         arrive(empty[v])
+ *   else:
+ *     for ko in range(ceildiv(extent, num_versions)):
+ *       for v in range(num_versions):  # unrolled
+ *         if ko > 0: wait(empty[v], (ko - 1) % 2)
+ *         producer statements of iteration ko * num_versions + v
+ *         arrive(full[v])
+ *
+ * The producer statements are scheduled over the consumer threads, so each producer thread runs
+ * them for every `num_producer_threads`-th consumer thread index.
+ */
+class WarpSpecializedPipelineRewriter {
+ public:
+  static Stmt Rewrite(ffi::Map<Var, Buffer> buffer_data_to_buffer,
+                      const ffi::Array<Buffer>& pipeline_allocs, const For& pipeline_loop,
+                      const PipelineInfo& pipeline_info,
+                      const std::unordered_map<const VarNode*, FragmentInfo>& fragment_info,
+                      const ffi::Map<ffi::String, ffi::Any>& preserved_annotations,
+                      const Var& thread_var, const PrimExpr& num_consumer_threads,
+                      int num_producer_threads) {
+    WarpSpecializedPipelineRewriter rewriter(buffer_data_to_buffer, pipeline_allocs, pipeline_loop,
+                                             pipeline_info, fragment_info, preserved_annotations,
+                                             thread_var, num_consumer_threads,
+                                             num_producer_threads);
+    return rewriter.BuildPipeline();
+  }
+
+ private:
+  WarpSpecializedPipelineRewriter(
+      ffi::Map<Var, Buffer> buffer_data_to_buffer, const ffi::Array<Buffer>& pipeline_allocs,
+      const For& pipeline_loop, const PipelineInfo& pipeline_info,
+      const std::unordered_map<const VarNode*, FragmentInfo>& fragment_info,
+      const ffi::Map<ffi::String, ffi::Any>& preserved_annotations, const Var& thread_var,
+      const PrimExpr& num_consumer_threads, int num_producer_threads)
+      : buffer_data_to_buffer_(std::move(buffer_data_to_buffer)),
+        pipeline_allocs_(pipeline_allocs),
+        pipeline_loop_(pipeline_loop),
+        pipeline_info_(pipeline_info),
+        fragment_info_(fragment_info),
+        preserved_annotations_(preserved_annotations),
+        thread_var_(thread_var),
+        num_consumer_threads_(num_consumer_threads),
+        num_producer_threads_(num_producer_threads) {}
+
+  Stmt BuildPipeline() {
+    // Step 1: Split the statements into the producer and the consumer roles.
+    std::vector<std::pair<int, Block>> producers, consumers;
+    int max_stage = 0;
+    for (const auto& [block, info] : pipeline_info_) {
+      max_stage = std::max(max_stage, info.stage);
+      (info.stage == 0 ? producers : consumers).emplace_back(info.order, block);
+    }
+    CHECK(!producers.empty() && !consumers.empty())
+        << "ValueError: A warp-specialized software pipeline requires statements in stage 0 to "
+           "produce the data and statements in later stages to consume it";
+    std::sort(producers.begin(), producers.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::sort(consumers.begin(), consumers.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    num_versions_ = std::max(max_stage + 1, 2);
+
+    // Step 2: Keep multiple versions of the buffers passed from the producers to the consumers.
+    std::unordered_set<const BufferNode*> produced;
+    for (const auto& [order, block] : producers) {
+      for (const BufferRegion& write : block->writes) {
+        produced.insert(write->buffer.get());
+      }
+    }
+    std::unordered_set<const BufferNode*> allocated;
+    for (const Buffer& buffer : pipeline_allocs_) {
+      allocated.insert(buffer.get());
+    }
+    for (const auto& [order, block] : consumers) {
+      for (const BufferRegion& write : block->writes) {
+        CHECK(!produced.count(write->buffer.get()))
+            << "ValueError: The consumers of a warp-specialized software pipeline cannot write "
+            << "the buffer " << write->buffer->name << " written by the producers";
+      }
+      for (const BufferRegion& read : block->reads) {
+        const Buffer& buffer = read->buffer;
+        if (!produced.count(buffer.get()) || buffer_remap_.count(buffer)) {
+          continue;
+        }
+        CHECK(allocated.count(buffer.get()))
+            << "ValueError: The buffer " << buffer->name << " passed from the producers to the "
+            << "consumers of a warp-specialized software pipeline must be allocated in the "
+            << "pipeline";
+        buffer_remap_.Set(buffer, RewriteAllocBuffer(buffer, num_versions_));
+      }
+    }
+
+    // Step 3: Emit the loops of the two roles.
+    PrimExpr extent = pipeline_loop_->extent;
+    PrimExpr num_rounds = analyzer_.Simplify(floordiv(extent + num_versions_ - 1, num_versions_));
+    round_var_ = pipeline_loop_->loop_var.copy_with_suffix("_outer");
+    analyzer_.Bind(round_var_, Range::FromMinExtent(make_zero(num_rounds.dtype()), num_rounds));
+    ffi::Array<Stmt> consumer_body, producer_body;
+    for (int version = 0; version < num_versions_; ++version) {
+      consumer_body.push_back(EmitConsumer(consumers, version));
+      producer_body.push_back(EmitProducer(producers, version));
+    }
+    auto make_loop = [&](ffi::Array<Stmt> body) -> Stmt {
+      return For(round_var_, make_zero(num_rounds.dtype()), num_rounds, ForKind::kSerial,
+                 SeqStmt::Flatten(body), std::nullopt, preserved_annotations_);
+    };
+    Stmt roles = IfThenElse(thread_var_ < num_consumer_threads_, make_loop(consumer_body),
+                            make_loop(producer_body));
+
+    // Step 4: Create the barriers, and synchronize all threads around the pipeline.
+    auto sync = []() {
+      return Evaluate(Call(DataType::Int(32), builtin::tvm_storage_sync(), {StringImm("shared")}));
+    };
+    ffi::Array<Stmt> init_barriers;
+    for (int version = 0; version < num_versions_; ++version) {
+      init_barriers.push_back(
+          Evaluate(Call(DataType::Void(), builtin::ptx_init_barrier_thread_count(),
+                        {FullBarrier(version), Integer(num_producer_threads_)})));
+      init_barriers.push_back(
+          Evaluate(Call(DataType::Void(), builtin::ptx_init_barrier_thread_count(),
+                        {EmptyBarrier(version), num_consumer_threads_})));
+    }
+    Stmt body = SeqStmt({
+        Evaluate(Call(DataType::Void(), builtin::create_barriers(), {Integer(2 * num_versions_)})),
+        sync(),
+        IfThenElse(thread_var_ == make_zero(thread_var_.dtype()), SeqStmt(init_barriers)),
+        sync(),
+        roles,
+        sync(),
+    });
+    body = AttrStmt(make_zero(DataType::Int(32)), attr::warp_specialization_scope,
+                    num_producer_threads_, body);
+
+    // Step 5: Make a new block that contains new buffer allocations after pipeline rewriting.
+    ffi::Array<Buffer> alloc_buffers;
+    for (const auto& alloc : pipeline_allocs_) {
+      alloc_buffers.push_back(buffer_remap_.Get(alloc).value_or(alloc));
+      buffer_data_to_buffer_.erase(alloc->data);
+    }
+    Block block = MakeBlock(body, buffer_data_to_buffer_);
+    block.CopyOnWrite()->alloc_buffers = std::move(alloc_buffers);
+    return BlockRealize({}, Bool(true), block);
+  }
+
+  /*! \brief The id of the barrier signaling that a version of the buffers is written. */
+  Integer FullBarrier(int version) const { return Integer(version); }
+
+  /*! \brief The id of the barrier signaling that a version of the buffers is read. */
+  Integer EmptyBarrier(int version) const { return Integer(num_versions_ + version); }
+
+  Buffer RewriteAllocBuffer(const Buffer& buffer, int num_versions) {
+    ObjectPtr<BufferNode> new_buffer = ffi::make_object<BufferNode>(*(buffer.get()));
+    new_buffer->shape.insert(new_buffer->shape.begin(), PrimExpr(num_versions));
+    if (new_buffer->strides.size()) {
+      ICHECK(new_buffer->strides.size() + 1 == new_buffer->shape.size());
+      PrimExpr stride_0 = new_buffer->strides[0] * new_buffer->shape[1];
+      new_buffer->strides.insert(new_buffer->strides.begin(), stride_0);
+    }
+    return Buffer(new_buffer);
+  }
+
+  /*! \brief Rewrite a statement of the pipeline for the iteration using the given version. */
+  Block RewriteBlock(const Block& block, int version) {
+    Block new_block = Downcast<Block>(PipelineBodyRewriter(buffer_data_to_buffer_, buffer_remap_,
+                                                           pipeline_loop_, false,
+                                                           fragment_info_)(block));
+    PrimExpr iter = round_var_ * num_versions_ + version;
+    return Downcast<Block>(
+        Substitute(new_block, {{pipeline_loop_->loop_var, pipeline_loop_->min + iter}}));
+  }
+
+  /*! \brief Predicate the statements of an iteration on the iteration being in the loop. */
+  Stmt GuardIteration(Stmt body, int version) {
+    PrimExpr inbound = round_var_ * num_versions_ + version < pipeline_loop_->extent;
+    if (analyzer_.CanProve(inbound)) {
+      return body;
+    }
+    return IfThenElse(inbound, body);
+  }
+
+  Stmt EmitConsumer(const std::vector<std::pair<int, Block>>& consumers, int version) {
+    ffi::Array<Stmt> stmts;
+    stmts.push_back(Evaluate(Call(DataType::Void(), builtin::ptx_wait_barrier(),
+                                  {FullBarrier(version), floormod(round_var_, 2)})));
+    for (const auto& [order, block] : consumers) {
+      stmts.push_back(BlockRealize({}, Bool(true), RewriteBlock(block, version)));
+    }
+    stmts.push_back(
+        Evaluate(Call(DataType::Void(), builtin::ptx_arrive_barrier(), {EmptyBarrier(version)})));
+    return GuardIteration(SeqStmt(stmts), version);
+  }
+
+  Stmt EmitProducer(const std::vector<std::pair<int, Block>>& producers, int version) {
+    // Each producer thread runs the statements for the consumer threads with the same index
+    // modulo the number of producer threads.
+    PrimExpr num_repeats =
+        analyzer_.Simplify(floordiv(num_consumer_threads_ + num_producer_threads_ - 1,
+                                    num_producer_threads_));
+    bool is_one_repeat = is_one(num_repeats);
+    Var repeat_var("producer_repeat", thread_var_.dtype());
+    PrimExpr producer_index = thread_var_ - num_consumer_threads_;
+    PrimExpr virtual_thread =
+        is_one_repeat ? producer_index
+                      : producer_index + repeat_var * IntImm(thread_var_.dtype(),
+                                                             num_producer_threads_);
+    PrimExpr predicate = Bool(true);
+    if (!analyzer_.CanProveEqual(floormod(num_consumer_threads_, num_producer_threads_), 0)) {
+      predicate = virtual_thread < num_consumer_threads_;
+    }
+    bool is_async = false;
+    ffi::Array<Stmt> copies;
+    for (const auto& [order, block] : producers) {
+      Block new_block = RewriteBlock(block, version);
+      new_block = Downcast<Block>(Substitute(new_block, {{thread_var_, virtual_thread}}));
+      if (pipeline_info_.at(block).async) {
+        is_async = true;
+        BlockNode* n = new_block.CopyOnWrite();
+        n->body = AttrStmt(make_zero(DataType::Int(32)), attr::async_scope, 1, n->body);
+      }
+      copies.push_back(BlockRealize({}, predicate, new_block));
+    }
+    Stmt copy = SeqStmt::Flatten(copies);
+    if (!is_one_repeat) {
+      copy = For(repeat_var, make_zero(repeat_var.dtype()), num_repeats, ForKind::kSerial, copy);
+    }
+
+    ffi::Array<Stmt> stmts;
+    stmts.push_back(IfThenElse(
+        round_var_ > 0, Evaluate(Call(DataType::Void(), builtin::ptx_wait_barrier(),
+                                      {EmptyBarrier(version), floormod(round_var_ - 1, 2)}))));
+    stmts.push_back(copy);
+    if (is_async) {
+      // The arrival on the barrier is tracked until the asynchronous copies complete.
+      stmts.push_back(Evaluate(
+          Call(DataType::Void(), builtin::ptx_cp_async_barrier(), {FullBarrier(version)})));
+    }
+    stmts.push_back(
+        Evaluate(Call(DataType::Void(), builtin::ptx_arrive_barrier(), {FullBarrier(version)})));
+    return GuardIteration(SeqStmt(stmts), version);
+  }
+
+  arith::Analyzer analyzer_;
+  ffi::Map<Var, Buffer> buffer_data_to_buffer_;
+  ffi::Array<Buffer> pipeline_allocs_;
+  For pipeline_loop_;
+  const PipelineInfo& pipeline_info_;
+  const std::unordered_map<const VarNode*, FragmentInfo>& fragment_info_;
+  ffi::Map<ffi::String, ffi::Any> preserved_annotations_;
+  /*! \brief The loop variable bound to threadIdx.x. */
+  Var thread_var_;
+  /*! \brief The number of threads running the consumer statements. */
+  PrimExpr num_consumer_threads_;
+  /*! \brief The number of threads running the producer statements. */
+  int num_producer_threads_;
+  /*! \brief The number of versions of the buffers passed to the consumers. */
+  int num_versions_ = 2;
+  /*! \brief The loop variable over the rounds of the versions. */
+  Var round_var_;
+  ffi::Map<Buffer, Buffer> buffer_remap_;
+};
+
+/*!
+ * \brief Predicate the statements outside a warp-specialized software pipeline on the thread being
+ * one of the consumer threads, so that the producer threads added to the thread block only take
+ * part in the pipeline and in the synchronizations.
+ */
+class ConsumerThreadGuard : public StmtMutator {
+ public:
+  ConsumerThreadGuard(Var thread_var, PrimExpr num_consumer_threads)
+      : is_consumer_(thread_var < num_consumer_threads) {}
+
+ private:
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::warp_specialization_scope) {
+      return ffi::GetRef<Stmt>(op);
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    return IfThenElse(is_consumer_, ffi::GetRef<Stmt>(op));
+  }
+
+  Stmt VisitStmt_(const EvaluateNode* op) final {
+    if (const auto* call = op->value.as<CallNode>()) {
+      if (call->op.same_as(builtin::tvm_storage_sync())) {
+        return ffi::GetRef<Stmt>(op);
+      }
+    }
+    if (is_const_int(op->value)) {
+      return ffi::GetRef<Stmt>(op);
+    }
+    return IfThenElse(is_consumer_, ffi::GetRef<Stmt>(op));
+  }
+
+  PrimExpr is_consumer_;
+};
+
 /*!
  * \brief Build the dependency graph among a array of blocks.
  * \param[in] blocks The array of blocks.
@@ -1074,7 +1386,36 @@ class PipelineInjector : private StmtExprMutator {
     }
   }
 
+  /*!
+   * \brief Track the threadIdx.x binding of the kernel, and extend it with the producer threads
+   * of the warp-specialized software pipeline inside, if any.
+   */
+  Stmt VisitThreadBinding(const ForNode* op) {
+    const ffi::String& thread_tag = op->thread_binding.value()->thread_tag;
+    if (thread_tag != "threadIdx.x") {
+      int is_thread_index = support::StartsWith(thread_tag, "threadIdx.");
+      num_other_thread_indices_ += is_thread_index;
+      Stmt stmt = StmtExprMutator::VisitStmt_(op);
+      num_other_thread_indices_ -= is_thread_index;
+      return stmt;
+    }
+    thread_var_ = op->loop_var;
+    num_consumer_threads_ = op->extent;
+    For for_node = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    if (num_producer_threads_ > 0) {
+      ForNode* n = for_node.CopyOnWrite();
+      n->body = ConsumerThreadGuard(op->loop_var, op->extent)(n->body);
+      n->extent = op->extent + num_producer_threads_;
+    }
+    thread_var_ = std::nullopt;
+    num_producer_threads_ = 0;
+    return for_node;
+  }
+
   Stmt VisitStmt_(const ForNode* op) final {
+    if (op->kind == ForKind::kThreadBinding && op->thread_binding.defined()) {
+      return VisitThreadBinding(op);
+    }
     // Step 1: Recursively rewrite the children first.
     For for_node = Downcast<For>(StmtExprMutator::VisitStmt_(op));
     if (!HasPipelineAnnotation(op)) {
@@ -1154,7 +1495,8 @@ class PipelineInjector : private StmtExprMutator {
     for (const auto& kv : op->annotations) {
       const ffi::String& key = kv.first;
       if (kv.first != attr::software_pipeline_stage && kv.first != attr::software_pipeline_order &&
-          kv.first != attr::software_pipeline_async_stages) {
+          kv.first != attr::software_pipeline_async_stages &&
+          kv.first != attr::software_pipeline_warp_specialize) {
         preserved_annotations.Set(key, kv.second);
       }
     }
@@ -1170,10 +1512,36 @@ class PipelineInjector : private StmtExprMutator {
 
     ValidatePipelineBody(pipeline_info, original_order);
 
+    int num_producer_threads = 0;
+    if (auto annot = op->annotations.Get(attr::software_pipeline_warp_specialize)) {
+      num_producer_threads = Downcast<Integer>(annot.value())->value;
+    }
+
     // Step 4: Rewrite the pipeline body.
-    Stmt pipeline = PipelineRewriter::Rewrite(buffer_data_to_buffer_, double_buffers,
-                                              pipeline_allocs, ffi::GetRef<For>(op), pipeline_info,
-                                              fragment_info_, preserved_annotations);
+    Stmt pipeline{nullptr};
+    if (num_producer_threads > 0) {
+      CHECK(thread_var_.defined())
+          << "ValueError: A warp-specialized software pipeline must be inside a loop bound to "
+             "threadIdx.x";
+      CHECK_EQ(num_other_thread_indices_, 0)
+          << "ValueError: A warp-specialized software pipeline only supports thread blocks of "
+             "threadIdx.x";
+      CHECK_EQ(num_producer_threads % 32, 0)
+          << "ValueError: The number of producer threads of a warp-specialized software pipeline "
+             "must be a multiple of the warp size, but got "
+          << num_producer_threads;
+      CHECK_EQ(num_producer_threads_, 0)
+          << "ValueError: Only one warp-specialized software pipeline is supported in a kernel";
+      num_producer_threads_ = num_producer_threads;
+      pipeline = WarpSpecializedPipelineRewriter::Rewrite(
+          buffer_data_to_buffer_, pipeline_allocs, ffi::GetRef<For>(op), pipeline_info,
+          fragment_info_, preserved_annotations, thread_var_.value(), num_consumer_threads_,
+          num_producer_threads);
+    } else {
+      pipeline = PipelineRewriter::Rewrite(buffer_data_to_buffer_, double_buffers, pipeline_allocs,
+                                           ffi::GetRef<For>(op), pipeline_info, fragment_info_,
+                                           preserved_annotations);
+    }
 
     if (const auto* realize = op->body.as<BlockRealizeNode>()) {
       const auto& block = realize->block;
@@ -1243,6 +1611,14 @@ class PipelineInjector : private StmtExprMutator {
   std::unordered_map<const VarNode*, FragmentInfo> fragment_info_;
   std::unordered_set<Buffer, ObjectPtrHash, ObjectPtrEqual> double_buffers;
   ffi::Optional<ffi::String> global_symbol_;
+  /*! \brief The loop variable bound to threadIdx.x of the current kernel. */
+  ffi::Optional<Var> thread_var_;
+  /*! \brief The extent of threadIdx.x before adding the producer threads. */
+  PrimExpr num_consumer_threads_;
+  /*! \brief The number of producer threads of the warp-specialized pipeline in the kernel. */
+  int num_producer_threads_ = 0;
+  /*! \brief The number of enclosing thread bindings of threadIdx.y and threadIdx.z. */
+  int num_other_thread_indices_ = 0;
 };
 
 }  // namespace software_pipeline
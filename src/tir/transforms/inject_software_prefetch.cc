@@ -0,0 +1,281 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Prefetch the data that the next iterations of an annotated loop read.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/int_set.h>
+#include <tvm/ffi/function.h>
+#include <tvm/ffi/reflection/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The size of a cache line, which is the granularity of the prefetches. */
+constexpr int64_t kCacheLineBytes = 64;
+/*! \brief The largest number of prefetches issued per iteration of an annotated loop. */
+constexpr int64_t kMaxPrefetchesPerIteration = 256;
+
+/*!
+ * \brief Inject prefetches into the loops annotated with `software_prefetch_distance`.
+ *
+ * For a distance of `d`, every iteration `i` of the loop first prefetches the region of each
+ * global buffer that iteration `i + d` reads, and a prologue before the loop prefetches the
+ * regions of the first `d` iterations. Up to `d` iterations of data are in flight at once,
+ * which hides the memory latency of loops whose iterations read separate tiles.
+ */
+class SoftwarePrefetchInjector : public StmtExprMutator {
+ public:
+  static Stmt Inject(Stmt body) { return SoftwarePrefetchInjector()(std::move(body)); }
+
+ private:
+  /*! \brief The region of a buffer read by one iteration, as functions of the loop variable. */
+  struct Region {
+    Buffer buffer;
+    ffi::Array<PrimExpr> min;
+    ffi::Array<PrimExpr> max;
+  };
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    auto opt_distance = loop->annotations.Get(attr::software_prefetch_distance);
+    if (!opt_distance.has_value()) {
+      return loop;
+    }
+    int64_t distance = opt_distance.value().cast<Integer>()->value;
+    loop.CopyOnWrite()->annotations.erase(attr::software_prefetch_distance);
+    // The next iterations of a parallel or vectorized loop do not run after the current one on
+    // the same core.
+    if (distance <= 0 || (loop->kind != ForKind::kSerial && loop->kind != ForKind::kUnrolled)) {
+      return loop;
+    }
+
+    std::vector<Region> regions = CollectRegions(loop);
+    if (regions.empty()) {
+      return loop;
+    }
+    const Var& loop_var = loop->loop_var;
+    DataType dtype = loop_var.dtype();
+    PrimExpr next = loop_var + IntImm(dtype, distance);
+    Stmt steady = IfThenElse(next < loop->min + loop->extent, MakePrefetches(regions, loop, next));
+    loop.CopyOnWrite()->body = SeqStmt({steady, loop->body});
+
+    Var prologue_var(loop_var->name_hint + "_prefetch", dtype);
+    Stmt prologue =
+        For(prologue_var, IntImm(dtype, 0),
+            analyzer_.Simplify(min(IntImm(dtype, distance), loop->extent)), ForKind::kSerial,
+            MakePrefetches(regions, loop, analyzer_.Simplify(loop->min + prologue_var)));
+    return SeqStmt({prologue, loop});
+  }
+
+  /*! \brief Collect the regions of the global buffers that one iteration of the loop reads. */
+  std::vector<Region> CollectRegions(const For& loop) {
+    // The variables defined in the loop body, and the ranges of the inner loop variables.
+    std::unordered_set<const VarNode*> inner_defs;
+    ffi::Map<Var, arith::IntSet> inner_dom;
+    PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+      if (const auto* for_node = obj.as<ForNode>()) {
+        inner_defs.insert(for_node->loop_var.get());
+        inner_dom.Set(for_node->loop_var,
+                      arith::IntSet::FromMinExtent(for_node->min, for_node->extent));
+      } else if (const auto* let = obj.as<LetStmtNode>()) {
+        inner_defs.insert(let->var.get());
+      } else if (const auto* let = obj.as<LetNode>()) {
+        inner_defs.insert(let->var.get());
+      } else if (const auto* alloc = obj.as<AllocateNode>()) {
+        inner_defs.insert(alloc->buffer_var.get());
+      }
+    });
+
+    std::vector<Region> regions;
+    std::unordered_map<const VarNode*, size_t> region_index;
+    std::vector<std::vector<arith::IntSet>> region_sets;
+    PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+      const auto* load = obj.as<BufferLoadNode>();
+      if (load == nullptr || inner_defs.count(load->buffer->data.get())) {
+        return;
+      }
+      ffi::String scope = GetPtrStorageScope(load->buffer->data);
+      if (!scope.empty() && scope != "global") {
+        return;
+      }
+      for (const PrimExpr& index : load->indices) {
+        // An index that depends on a value computed in the body, e.g. an indirect access, cannot
+        // be evaluated ahead of time.
+        bool uses_inner_value = UsesVar(index, [&](const VarNode* var) {
+          return inner_defs.count(var) && !inner_dom.count(ffi::GetRef<Var>(var));
+        });
+        if (uses_inner_value || index.dtype().lanes() != 1) {
+          return;
+        }
+      }
+      auto [it, inserted] = region_index.emplace(load->buffer->data.get(), regions.size());
+      if (inserted) {
+        regions.push_back(Region{load->buffer, {}, {}});
+        region_sets.emplace_back();
+      } else if (!regions[it->second].buffer.same_as(load->buffer)) {
+        return;
+      }
+      std::vector<arith::IntSet>& sets = region_sets[it->second];
+      for (size_t i = 0; i < load->indices.size(); ++i) {
+        arith::IntSet set = arith::EvalSet(load->indices[i], inner_dom);
+        if (i < sets.size()) {
+          sets[i] = arith::Union({sets[i], set});
+        } else {
+          sets.push_back(set);
+        }
+      }
+    });
+
+    std::vector<Region> result;
+    for (size_t i = 0; i < regions.size(); ++i) {
+      Region& region = regions[i];
+      std::vector<int64_t> extents;
+      for (const arith::IntSet& set : region_sets[i]) {
+        if (!set.HasLowerBound() || !set.HasUpperBound()) {
+          break;
+        }
+        PrimExpr min_value = analyzer_.Simplify(set.min());
+        PrimExpr max_value = analyzer_.Simplify(set.max());
+        const auto* extent = analyzer_.Simplify(max_value - min_value + 1).as<IntImmNode>();
+        if (extent == nullptr) {
+          break;
+        }
+        extents.push_back(extent->value);
+        region.min.push_back(min_value);
+        region.max.push_back(max_value);
+      }
+      if (extents.empty() || extents.size() != region_sets[i].size()) {
+        continue;
+      }
+      int64_t num_rows = 1;
+      for (size_t j = 0; j + 1 < extents.size(); ++j) {
+        num_rows *= extents[j];
+      }
+      int64_t elems_per_line = ElemsPerLine(region);
+      int64_t prefetches_per_row = (extents.back() + elems_per_line - 1) / elems_per_line + 1;
+      if (num_rows * prefetches_per_row <= kMaxPrefetchesPerIteration) {
+        result.push_back(std::move(region));
+      }
+    }
+    return result;
+  }
+
+  int64_t ElemsPerLine(const Region& region) {
+    int64_t elem_bytes = region.buffer->dtype.bytes() * region.buffer->dtype.lanes();
+    return std::max<int64_t>(1, kCacheLineBytes / std::max<int64_t>(1, elem_bytes));
+  }
+
+  /*! \brief Prefetch the regions that the iteration `iter` of the loop reads. */
+  Stmt MakePrefetches(const std::vector<Region>& regions, const For& loop, const PrimExpr& iter) {
+    ffi::Array<Stmt> seq;
+    for (const Region& region : regions) {
+      ffi::Map<Var, PrimExpr> vmap{{loop->loop_var, iter}};
+      auto f_at_iter = [&](const PrimExpr& expr) {
+        return analyzer_.Simplify(Substitute(expr, vmap));
+      };
+      auto f_extent = [&](size_t i) {
+        return Downcast<IntImm>(analyzer_.Simplify(region.max[i] - region.min[i] + 1))->value;
+      };
+      size_t ndim = region.min.size();
+      // The loops over the rows of the region, i.e. all dimensions but the last.
+      std::vector<std::pair<Var, int64_t>> row_loops;
+      ffi::Array<PrimExpr> indices;
+      for (size_t i = 0; i + 1 < ndim; ++i) {
+        PrimExpr index = f_at_iter(region.min[i]);
+        if (int64_t extent = f_extent(i); extent > 1) {
+          Var var("ax" + std::to_string(i), index.dtype());
+          row_loops.emplace_back(var, extent);
+          index = index + var;
+        }
+        indices.push_back(index);
+      }
+      auto f_prefetch = [&](const PrimExpr& last_index) {
+        ffi::Array<PrimExpr> full_indices = indices;
+        full_indices.push_back(last_index);
+        PrimExpr address = Call(DataType::Handle(), builtin::address_of(),
+                                {BufferLoad(region.buffer, full_indices)});
+        return Evaluate(Call(DataType::Void(), builtin::prefetch(),
+                             {address, Integer(0), Integer(3), Integer(1)}));
+      };
+
+      // Prefetch one address per cache line of a row, and the last element of the row in case
+      // the row does not start at a line boundary.
+      PrimExpr last_min = f_at_iter(region.min.back());
+      int64_t last_extent = f_extent(ndim - 1);
+      int64_t elems_per_line = ElemsPerLine(region);
+      int64_t num_lines = (last_extent + elems_per_line - 1) / elems_per_line;
+      Stmt row;
+      if (num_lines > 1) {
+        DataType dtype = last_min.dtype();
+        Var line_var("line", dtype);
+        row = For(line_var, IntImm(dtype, 0), IntImm(dtype, num_lines), ForKind::kSerial,
+                  f_prefetch(last_min + line_var * IntImm(dtype, elems_per_line)));
+      } else {
+        row = f_prefetch(last_min);
+      }
+      if (last_extent > 1) {
+        row = SeqStmt({row, f_prefetch(f_at_iter(region.max.back()))});
+      }
+      for (auto it = row_loops.rbegin(); it != row_loops.rend(); ++it) {
+        DataType dtype = it->first.dtype();
+        row = For(it->first, IntImm(dtype, 0), IntImm(dtype, it->second), ForKind::kSerial, row);
+      }
+      seq.push_back(row);
+    }
+    return seq.size() == 1 ? seq[0] : SeqStmt(seq);
+  }
+
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [](PrimFunc func, IRModule mod, PassContext ctx) -> PrimFunc {
+    func.CopyOnWrite()->body = SoftwarePrefetchInjector::Inject(func->body);
+    return func;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_FFI_STATIC_INIT_BLOCK() {
+  namespace refl = tvm::ffi::reflection;
+  refl::GlobalDef().def("tir.transform.InjectSoftwarePrefetch", InjectSoftwarePrefetch);
+}
+
+}  // namespace transform
+}  // namespace tir
+}  // namespace tvm
@@ -45,6 +45,7 @@ struct LoopPartitionConfigNode : public AttrsNodeReflAdapter<LoopPartitionConfig
   bool partition_const_loop;
   bool no_unroll_loop_with_extent_one;
   bool unroll_loop_with_partition_hint_no_interval;
+  bool partition_vectorized_tail;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
@@ -57,6 +58,9 @@ struct LoopPartitionConfigNode : public AttrsNodeReflAdapter<LoopPartitionConfig
         .def_ro("unroll_loop_with_partition_hint_no_interval",
                 &LoopPartitionConfigNode::unroll_loop_with_partition_hint_no_interval,
                 "Unroll loops with pragma_loop_partition_hint and no interval",
+                refl::DefaultValue(false))
+        .def_ro("partition_vectorized_tail", &LoopPartitionConfigNode::partition_vectorized_tail,
+                "Peel the boundary checks of vectorized loops into a tail loop",
                 refl::DefaultValue(false));
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("tir.transform.LoopPartitionConfig", LoopPartitionConfigNode,
@@ -106,8 +110,9 @@ using ExpressionSet = std::unordered_set<PrimExpr, ObjectPtrHash, ObjectPtrEqual
 class CandidateSelector final : public StmtExprVisitor {
  public:
   using VarIsUsed = bool;
-  explicit CandidateSelector(bool partition_const_loop)
-      : partition_const_loop_(partition_const_loop) {}
+  explicit CandidateSelector(bool partition_const_loop,
+                             std::unordered_set<const VarNode*> tail_loop_vars = {})
+      : partition_const_loop_(partition_const_loop), tail_loop_vars_(std::move(tail_loop_vars)) {}
 
   void VisitStmt_(const ForNode* op) final {
     // always treat var with hint to be partitioned
@@ -117,8 +122,9 @@ class CandidateSelector final : public StmtExprVisitor {
       StmtExprVisitor::VisitStmt_(op);
       return;
     }
-    // partition const loop when sets partition_const_loop_
-    if (!is_const_int(op->min) || !is_const_int(op->extent) || partition_const_loop_) {
+    // partition const loop when sets partition_const_loop_, or when it has a vectorized tail
+    if (!is_const_int(op->min) || !is_const_int(op->extent) || partition_const_loop_ ||
+        tail_loop_vars_.count(var)) {
       record_.insert({var, false});
       StmtExprVisitor::VisitStmt_(op);
       if (record_.at(var) && !no_split_) {
@@ -205,6 +211,7 @@ class CandidateSelector final : public StmtExprVisitor {
   bool in_likely_{false};
   bool no_split_{false};
   bool partition_const_loop_{false};
+  std::unordered_set<const VarNode*> tail_loop_vars_;
   std::unordered_map<const VarNode*, VarIsUsed> record_;
   arith::Analyzer analyzer_;
 };
@@ -404,13 +411,89 @@ class ThreadPartitionInserter : public StmtMutator {
   bool innermost_thread_scope_;
 };
 
+/*!
+ * \brief Mark the boundary checks in vectorized loops as likely, so that the loop outside of the
+ * vectorized loop is partitioned into a main loop without the checks and a tail loop.
+ *
+ * The split schedule primitive guards the vectorized loop of a non-divisible split with a
+ * predicate on both loop variables, which otherwise keeps the whole loop from being vectorized
+ * without masks. The conditions of `T.ignore_loop_partition` are left as they are.
+ *
+ * \example
+ * for i_0 in range(T.ceildiv(n, 8)):
+ *     for i_1 in T.vectorized(8):
+ *         if i_0 * 8 + i_1 < n:
+ *             B[i_0 * 8 + i_1] = A[i_0 * 8 + i_1]
+ *
+ * has its condition wrapped in `T.likely`, and i_0 partitioned.
+ */
+class VectorizedTailMarker : public StmtExprMutator {
+ public:
+  Stmt VisitStmt_(const ForNode* op) final {
+    if (op->kind == ForKind::kVectorized) {
+      const VarNode* outer_vectorized_var = vectorized_var_;
+      size_t outer_num_serial_loops = num_serial_loops_;
+      vectorized_var_ = op->loop_var.get();
+      num_serial_loops_ = loop_vars_.size();
+      Stmt stmt = StmtExprMutator::VisitStmt_(op);
+      vectorized_var_ = outer_vectorized_var;
+      num_serial_loops_ = outer_num_serial_loops;
+      return stmt;
+    }
+    loop_vars_.push_back(op->loop_var.get());
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    loop_vars_.pop_back();
+    return stmt;
+  }
+
+  Stmt VisitStmt_(const IfThenElseNode* op) final {
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    if (vectorized_var_ == nullptr || op->else_case.defined()) {
+      return stmt;
+    }
+    if (const auto* call = op->condition.as<CallNode>()) {
+      if (call->op.same_as(builtin::ignore_loop_partition())) {
+        return stmt;
+      }
+    }
+    auto f_uses = [&](const VarNode* var) {
+      return UsesVar(op->condition, [var](const VarNode* v) { return v == var; });
+    };
+    if (!f_uses(vectorized_var_)) {
+      return stmt;
+    }
+    // Partition the innermost loop outside of the vectorized loop that the condition depends on.
+    for (size_t i = num_serial_loops_; i > 0; --i) {
+      if (f_uses(loop_vars_[i - 1])) {
+        tail_loop_vars.insert(loop_vars_[i - 1]);
+        IfThenElse if_stmt = Downcast<IfThenElse>(stmt);
+        const auto* call = if_stmt->condition.as<CallNode>();
+        if (call == nullptr || !call->op.same_as(builtin::likely())) {
+          if_stmt.CopyOnWrite()->condition = likely(if_stmt->condition);
+        }
+        return if_stmt;
+      }
+    }
+    return stmt;
+  }
+
+  /*! \brief The loops to partition. */
+  std::unordered_set<const VarNode*> tail_loop_vars;
+
+ private:
+  std::vector<const VarNode*> loop_vars_;
+  const VarNode* vectorized_var_{nullptr};
+  size_t num_serial_loops_{0};
+};
+
 // Try to partition range of iteration variables in order to remove (some)
 // likely conditions
 class LoopPartitioner : public StmtMutator {
  public:
   explicit LoopPartitioner(bool partition_const_loop, bool no_unroll_loop_with_extent_one,
-                           bool unroll_loop_with_partition_hint_no_interval)
-      : selector(CandidateSelector(partition_const_loop)),
+                           bool unroll_loop_with_partition_hint_no_interval,
+                           std::unordered_set<const VarNode*> tail_loop_vars = {})
+      : selector(CandidateSelector(partition_const_loop, std::move(tail_loop_vars))),
         no_unroll_loop_with_extent_one_(no_unroll_loop_with_extent_one),
         unroll_loop_with_partition_hint_no_interval_(unroll_loop_with_partition_hint_no_interval) {}
 
@@ -798,9 +881,16 @@ class RemoveLikelyTagsAndHints : public StmtExprMutator {
 };
 
 Stmt LoopPartition(Stmt stmt, bool partition_const_loop, bool no_unroll_loop_with_extent_one,
-                   bool unroll_loop_with_partition_hint_no_interval) {
+                   bool unroll_loop_with_partition_hint_no_interval,
+                   bool partition_vectorized_tail) {
+  std::unordered_set<const VarNode*> tail_loop_vars;
+  if (partition_vectorized_tail) {
+    VectorizedTailMarker marker;
+    stmt = marker(std::move(stmt));
+    tail_loop_vars = std::move(marker.tail_loop_vars);
+  }
   stmt = LoopPartitioner(partition_const_loop, no_unroll_loop_with_extent_one,
-                         unroll_loop_with_partition_hint_no_interval)
+                         unroll_loop_with_partition_hint_no_interval, std::move(tail_loop_vars))
              .VisitAndMutate(std::move(stmt));
   stmt = RemoveLikelyTagsAndHints()(std::move(stmt));
   return stmt;
@@ -817,7 +907,8 @@ Pass LoopPartition() {
     }
     n->body = LoopPartition(std::move(n->body), cfg.value()->partition_const_loop,
                             cfg.value()->no_unroll_loop_with_extent_one,
-                            cfg.value()->unroll_loop_with_partition_hint_no_interval);
+                            cfg.value()->unroll_loop_with_partition_hint_no_interval,
+                            cfg.value()->partition_vectorized_tail);
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {});
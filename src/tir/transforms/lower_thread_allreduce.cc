@@ -30,6 +30,8 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <cctype>
+#include <string>
 #include <unordered_set>
 
 #include "../../runtime/thread_storage_scope.h"
@@ -44,7 +46,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   explicit ThreadAllreduceBuilder(const TargetNode* target)
       : target_(target),
         warp_size_(target->GetAttr<Integer>("thread_warp_size", 1).value().IntValue()),
-        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()) {}
+        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()),
+        has_redux_sync_(HasReduxSync(target)) {}
 
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == attr::thread_extent) {
@@ -482,6 +485,20 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       local_bufs.push_back(mask_buffer.value());
     }
 
+    // A full warp reduction of a 32-bit integer is a single redux.sync on sm_80+, the result of
+    // which is already broadcast to all the lanes.
+    if (n_buffers == 1 && reduce_extent == warp_size_ && !predicate.defined() &&
+        mask_buffer.defined()) {
+      if (ffi::Optional<ffi::String> intrinsic = ReduxSyncIntrinsic(combiner, dtypes[0])) {
+        PrimExpr val = BufferLoad(shared_bufs[0], zero_indices);
+        PrimExpr mask_val = BufferLoad(mask_buffer.value(), zero_indices);
+        PrimExpr reduced = Call(dtypes[0], builtin::call_pure_extern(),
+                                {StringImm(intrinsic.value()), mask_val, val});
+        seq->push_back(BufferStore(shared_bufs[0], reduced, zero_indices));
+        return {{BufferLoad(shared_bufs[0], zero_indices)}, {mask_buffer.value()}};
+      }
+    }
+
     // Emit reductions within a warp.
     int start_offset = 1;
     while (start_offset * 2 < reduce_extent) {
@@ -770,6 +787,56 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
   }
 
+  /*!
+   * \brief The CUDA intrinsic that lowers to a redux.sync of the combiner over a warp, if any.
+   *
+   * redux.sync is only available on sm_80+, for the sum, min and max of 32-bit integers and the
+   * bitwise and, or and xor of unsigned 32-bit integers.
+   */
+  ffi::Optional<ffi::String> ReduxSyncIntrinsic(const CommReducerNode* combiner,
+                                                DataType dtype) const {
+    if (!has_redux_sync_ || combiner->result.size() != 1 || !dtype.is_scalar() ||
+        dtype.bits() != 32 || !(dtype.is_int() || dtype.is_uint())) {
+      return std::nullopt;
+    }
+    const VarNode* lhs = combiner->lhs[0].get();
+    const VarNode* rhs = combiner->rhs[0].get();
+    auto is_operands = [&](const PrimExpr& a, const PrimExpr& b) {
+      return (a.get() == lhs && b.get() == rhs) || (a.get() == rhs && b.get() == lhs);
+    };
+    const PrimExpr& result = combiner->result[0];
+    if (const auto* op = result.as<AddNode>(); op && is_operands(op->a, op->b)) {
+      return ffi::String("__reduce_add_sync");
+    } else if (const auto* op = result.as<MinNode>(); op && is_operands(op->a, op->b)) {
+      return ffi::String("__reduce_min_sync");
+    } else if (const auto* op = result.as<MaxNode>(); op && is_operands(op->a, op->b)) {
+      return ffi::String("__reduce_max_sync");
+    }
+    const auto* call = result.as<CallNode>();
+    if (!dtype.is_uint() || call == nullptr || call->args.size() != 2 ||
+        !is_operands(call->args[0], call->args[1])) {
+      return std::nullopt;
+    }
+    if (call->op.same_as(builtin::bitwise_and())) {
+      return ffi::String("__reduce_and_sync");
+    } else if (call->op.same_as(builtin::bitwise_or())) {
+      return ffi::String("__reduce_or_sync");
+    } else if (call->op.same_as(builtin::bitwise_xor())) {
+      return ffi::String("__reduce_xor_sync");
+    }
+    return std::nullopt;
+  }
+
+  static bool HasReduxSync(const TargetNode* target) {
+    if (target->kind->name != "cuda") return false;
+    std::string arch = target->GetAttr<ffi::String>("arch", ffi::String("")).value();
+    if (arch.size() <= 3 || arch.compare(0, 3, "sm_") != 0 ||
+        !std::isdigit(static_cast<unsigned char>(arch[3]))) {
+      return false;
+    }
+    return std::stoi(arch.substr(3)) >= 80;
+  }
+
   // The target.
   const TargetNode* target_ = nullptr;
 
@@ -777,6 +844,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   int warp_size_{1};
   // The maximum number of threads of the device. "-1" denotes unknown.
   int max_num_threads_{-1};
+  // Whether the target has the redux.sync warp reductions.
+  bool has_redux_sync_{false};
   // A boolean indicating if the target supports warp-level masking.
   bool need_warp_shuffle_mask_;
 
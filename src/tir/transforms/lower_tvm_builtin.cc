@@ -41,11 +41,17 @@ class BuiltinLower : public StmtExprMutator {
  public:
   static PrimFunc Build(PrimFunc func) {
     ffi::Optional<PrimExpr> device_type = std::nullopt;
+    bool is_c_target = false;
     if (auto target = func->GetAttr<Target>(tvm::attr::kTarget)) {
       device_type = Integer(target.value()->kind->default_device_type);
+      is_c_target = target.value()->kind->name == "c";
     }
 
     BuiltinLower mutator(device_type);
+    // Only CodeGenC prints the static storage, the other backends keep the workspace calls.
+    mutator.static_workspace_ =
+        is_c_target &&
+        transform::PassContext::Current()->GetConfig<Bool>("tir.direct_call", Bool(false)).value();
     func.CopyOnWrite()->body = mutator.VisitBodyAndRealizeAlloca(func->body);
     return func;
   }
@@ -244,6 +250,14 @@ class BuiltinLower : public StmtExprMutator {
         if (constant_size > 0 && constant_size * nbytes < runtime::kMaxStackAlloca) {
           return stmt;
         }
+        // In the direct-call mode, the workspace of a constant size is planned statically, so
+        // that the deployed code does not need a workspace allocator. A static array shared by
+        // the iterations of a parallel loop would be a data race, so those keep the workspace.
+        if (constant_size > 0 && static_workspace_ && parallel_depth_ == 0) {
+          auto n = CopyOnWrite(op);
+          n->annotations.Set(transform::kStaticStorage, Bool(true));
+          return Stmt(n);
+        }
       }
     }
     PrimExpr total_bytes = make_const(DataType::UInt(64), nbytes);
@@ -311,7 +325,9 @@ class BuiltinLower : public StmtExprMutator {
     Stmt body;
 
     if (op->kind == ForKind::kParallel) {
+      ++parallel_depth_;
       body = this->VisitBodyAndRealizeAlloca(op->body);
+      --parallel_depth_;
     } else {
       body = this->VisitStmt(op->body);
     }
@@ -661,6 +677,10 @@ class BuiltinLower : public StmtExprMutator {
   ffi::Optional<PrimExpr> device_id_{std::nullopt};
 
   bool is_precheck_{false};
+  // Whether the constant-size workspace is placed in static storage.
+  bool static_workspace_{false};
+  // The number of enclosing parallel loops.
+  int parallel_depth_{0};
 
   // Record all stack frames.
   std::vector<AllocaScope> alloca_scope_;
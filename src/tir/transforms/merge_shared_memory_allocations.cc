@@ -22,6 +22,14 @@
  * \brief Each GPU kernel is allowed to have only one dynamic or static shared memory allocation.
  * This pass merges multiple TIR-level dynamic or static shared memory allocations into one
  * allocation.
+ *
+ * By default, buffers reuse the storage freed by the buffers that are no longer live through a
+ * free list. With the "tir.merge_smem_interval_coloring" option, the offsets of constant-size
+ * buffers are instead planned by interval coloring over their lifetimes, so that the buffers of
+ * the different stages of a pipelined kernel pack into less memory, and more blocks fit on an SM.
+ * The offsets are then aligned to "tir.merge_smem_alignment" bytes, and the buffers of at least
+ * "tir.merge_smem_swizzle_bytes" bytes are aligned to that size, so that the swizzled layouts
+ * computed relative to the start of a buffer keep their bank pattern.
  */
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
@@ -30,8 +38,12 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <numeric>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../../runtime/thread_storage_scope.h"
 #include "../../support/arena.h"
@@ -246,6 +258,16 @@ class SharedMemLinearAccessPatternFinder final : public StmtExprVisitor {
   std::vector<StmtEntry> scope_;
 };
 
+/*! \brief The options of the interval coloring of the shared memory buffers. */
+struct IntervalColoringOptions {
+  /*! \brief Whether to plan the offsets by interval coloring, instead of the free list. */
+  bool enabled{false};
+  /*! \brief The alignment in bytes of the offset of each buffer. */
+  int64_t alignment{16};
+  /*! \brief The buffers of at least this size are aligned to it, 0 to disable. */
+  int64_t swizzle_bytes{0};
+};
+
 /*!
  * \brief merge the buffers whose live range has no intersection and rewrite the body
  */
@@ -253,8 +275,8 @@ class SharedMemoryRewriter : public StmtExprMutator {
  public:
   explicit SharedMemoryRewriter(
       const std::unordered_map<const VarNode*, const AllocateNode*>& shmem_allocs,
-      bool is_dynamic = true)
-      : is_dynamic_{is_dynamic}, shmem_allocs_{shmem_allocs} {
+      bool is_dynamic = true, IntervalColoringOptions coloring = {})
+      : is_dynamic_{is_dynamic}, coloring_{coloring}, shmem_allocs_{shmem_allocs} {
     if (!is_dynamic) {
       merged_buf_var_ = Var("buf_shmem", PointerType(PrimType(DataType::UInt(8)), "shared"));
     }
@@ -267,12 +289,22 @@ class SharedMemoryRewriter : public StmtExprMutator {
   void PlanReuse(const Stmt& stmt, bool is_dynamic = true) {
     SharedMemLinearAccessPatternFinder finder(is_dynamic);
     finder(stmt);
+    if (coloring_.enabled && AllConstantSize()) {
+      this->PlanIntervalColoring(finder.linear_seq_);
+      return;
+    }
     this->LivenessAnalysis(finder.linear_seq_);
     this->PlanMemory(finder.linear_seq_);
   }
 
  private:
   Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent && !allocated_ && interval_planned_) {
+      allocated_ = true;
+      Allocate new_body(merged_buf_var_, DataType::UInt(8), {merged_alloc_size_}, const_true(),
+                        StmtExprMutator::VisitStmt(op->body));
+      return AttrStmt(op->node, op->attr_key, op->value, new_body, op->span);
+    }
     if (op->attr_key == attr::thread_extent && !allocated_) {
       // Allocate one dynamic shared memory allocation at the beginning of thread scope
       int max_layer_num = 0;
@@ -487,6 +519,93 @@ class SharedMemoryRewriter : public StmtExprMutator {
     }
   }
 
+  /*! \brief Whether all the shared memory allocations have a constant size. */
+  bool AllConstantSize() const {
+    for (const auto& [var, alloc] : shmem_allocs_) {
+      if (alloc->ConstantAllocationSize() == 0) return false;
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Plan the offsets of the buffers by interval coloring over their lifetimes.
+   *
+   * The lifetime of a buffer spans the entries of the linear sequence from its first to its
+   * last access, a scope counting as a whole. The buffers are placed from the largest to the
+   * smallest, each at the lowest aligned offset that overlaps no placed buffer whose lifetime
+   * intersects its own.
+   *
+   * \param seq the linear pattern of storage access
+   */
+  void PlanIntervalColoring(const std::vector<StmtEntry>& seq) {
+    struct Interval {
+      const VarNode* var;
+      size_t begin;
+      size_t end;
+      int64_t nbytes;
+      int64_t align;
+      int64_t offset{0};
+    };
+    std::vector<Interval> intervals;
+    std::unordered_map<const VarNode*, size_t> index;
+    for (size_t i = 0; i < seq.size(); ++i) {
+      int64_t offset = seq[i].scope_pair_offset;
+      // The begin of a scope carries the buffers touched within, the end repeats them.
+      if (offset < 0) continue;
+      const StmtEntry& s = seq[i + offset];
+      for (const VarNode* buffer : s.touched) {
+        auto [it, inserted] = index.emplace(buffer, intervals.size());
+        if (inserted) {
+          const AllocateNode* alloc = shmem_allocs_.at(buffer);
+          int64_t nbytes = alloc->ConstantAllocationSize() * alloc->dtype.bytes();
+          int64_t align = std::lcm<int64_t>(std::max<int64_t>(coloring_.alignment, 1),
+                                            alloc->dtype.bytes());
+          if (coloring_.swizzle_bytes > 0 && nbytes >= coloring_.swizzle_bytes) {
+            align = std::lcm(align, coloring_.swizzle_bytes);
+          }
+          intervals.push_back({buffer, i, i + offset, nbytes, align});
+        } else {
+          intervals[it->second].end = std::max(intervals[it->second].end, i + offset);
+        }
+      }
+    }
+
+    std::vector<Interval*> order;
+    for (Interval& interval : intervals) {
+      order.push_back(&interval);
+    }
+    // The intervals are in the order of their first access, which breaks the ties.
+    std::stable_sort(order.begin(), order.end(),
+                     [](const Interval* a, const Interval* b) { return a->nbytes > b->nbytes; });
+    int64_t total_bytes = 0;
+    std::vector<const Interval*> placed;
+    for (Interval* interval : order) {
+      std::vector<std::pair<int64_t, int64_t>> busy;
+      for (const Interval* other : placed) {
+        if (other->begin <= interval->end && interval->begin <= other->end) {
+          busy.emplace_back(other->offset, other->offset + other->nbytes);
+        }
+      }
+      std::sort(busy.begin(), busy.end());
+      int64_t offset = 0;
+      for (const auto& [lo, hi] : busy) {
+        if (offset + interval->nbytes <= lo) break;
+        if (hi > offset) {
+          offset = (hi + interval->align - 1) / interval->align * interval->align;
+        }
+      }
+      interval->offset = offset;
+      total_bytes = std::max(total_bytes, offset + interval->nbytes);
+      placed.push_back(interval);
+    }
+
+    for (const Interval& interval : intervals) {
+      buffer_byte_offsets_[interval.var] = IntImm(DataType::Int(32), interval.offset);
+    }
+    merged_alloc_size_ = IntImm(DataType::Int(32), total_bytes);
+    interval_planned_ = true;
+  }
+
   /*!
    * \brief Memory plan algorithm
    * \param seq the linear pattern of storage access
@@ -644,6 +763,10 @@ class SharedMemoryRewriter : public StmtExprMutator {
   }
   // Wheather enable dyanmic analysis.
   bool is_dynamic_{true};
+  // The options of the interval coloring.
+  IntervalColoringOptions coloring_;
+  // Whether the offsets were planned by interval coloring.
+  bool interval_planned_{false};
   // The var for the merged buffer
   Var merged_buf_var_{"buf_dyn_shmem", PointerType(PrimType(DataType::UInt(8)), "shared.dyn")};
   // The mapping from the original buffer var to its allocate
@@ -668,16 +791,17 @@ class SharedMemoryRewriter : public StmtExprMutator {
   support::Arena arena_;
 };
 
-Stmt MergeSharedMemoryAllocations(Stmt stmt, bool merge_static_smem) {
+Stmt MergeSharedMemoryAllocations(Stmt stmt, bool merge_static_smem,
+                                  IntervalColoringOptions coloring) {
   AllocateCollector collector;
   collector(stmt);
   if (collector.dyn_shmem_allocs_.size() > 1) {
-    SharedMemoryRewriter rewriter(collector.dyn_shmem_allocs_);
+    SharedMemoryRewriter rewriter(collector.dyn_shmem_allocs_, true, coloring);
     rewriter.PlanReuse(stmt);
     stmt = rewriter(std::move(stmt));
   }
   if (merge_static_smem && collector.static_shmem_allocs_.size() > 1) {
-    SharedMemoryRewriter rewriter(collector.static_shmem_allocs_, false);
+    SharedMemoryRewriter rewriter(collector.static_shmem_allocs_, false, coloring);
     rewriter.PlanReuse(stmt, false);
     stmt = rewriter(std::move(stmt));
   }
@@ -689,8 +813,18 @@ namespace transform {
 Pass MergeSharedMemoryAllocations() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     bool merge_static_smem = ctx->GetConfig<Bool>("tir.merge_static_smem", Bool(false)).value();
+    IntervalColoringOptions coloring;
+    coloring.enabled =
+        ctx->GetConfig<Bool>("tir.merge_smem_interval_coloring", Bool(false)).value();
+    coloring.alignment =
+        ctx->GetConfig<Integer>("tir.merge_smem_alignment", Integer(16)).value()->value;
+    coloring.swizzle_bytes =
+        ctx->GetConfig<Integer>("tir.merge_smem_swizzle_bytes", Integer(0)).value()->value;
+    CHECK_GT(coloring.alignment, 0) << "ValueError: tir.merge_smem_alignment must be positive";
+    CHECK_GE(coloring.swizzle_bytes, 0)
+        << "ValueError: tir.merge_smem_swizzle_bytes must not be negative";
     auto* n = f.CopyOnWrite();
-    n->body = MergeSharedMemoryAllocations(std::move(n->body), merge_static_smem);
+    n->body = MergeSharedMemoryAllocations(std::move(n->body), merge_static_smem, coloring);
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.MergeSharedMemoryAllocations", {});
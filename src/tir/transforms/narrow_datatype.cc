@@ -22,8 +22,11 @@
  * \brief narrow the datatype of indexing vars
  */
 
+#include <tvm/arith/int_set.h>
 #include <tvm/ffi/function.h>
 #include <tvm/ffi/reflection/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/data_type_rewriter.h>
 #include <tvm/tir/op.h>
@@ -31,6 +34,7 @@
 
 #include "../../arith/ir_mutator_with_analyzer.h"
 #include "../../arith/ir_visitor_with_analyzer.h"
+#include "ir_utils.h"
 
 namespace tvm {
 namespace tir {
@@ -57,6 +61,15 @@ namespace tir {
 // Algorithm:
 // - Use DataTypeVisitor to determine whether a Var can be narrowed or not.
 // - Use DataTypeRewritter to rewrite the components of an indexing expression.
+//
+// The free vars of the function (e.g. the symbolic shapes) are bounded by the
+// "tir_var_upper_bound" attribute of the function, if any, and are narrowed by
+// casting them in the indexing expressions.
+//
+// On GPUs, the indexing expressions that cannot be proven to fit are bounded
+// with arith::EvalSet in terms of the free vars instead. When all the bounds are
+// found, the body is versioned into a narrowed body guarded by the runtime check
+// that the bounds fit, and the original body as a fallback.
 
 using arith::Analyzer;
 using arith::ConstIntBound;
@@ -74,7 +87,24 @@ using arith::IRMutatorWithAnalyzer;
 // Otherwise, `var` is not narrowed, that is, `vmap[var] = var.dtype.bits()`
 class DataTypeVisitor final : public StmtExprVisitor {
  public:
-  explicit DataTypeVisitor(int target_bits) : bits_(target_bits), target_bits_(target_bits) {}
+  /*!
+   * \param target_bits The target bits.
+   * \param free_var_bounds The free vars of the function, with their bounds, if any.
+   * \param guard Whether to assume that the expressions fit when their bounds in terms of the
+   *  free vars can be checked at runtime, see `guards`.
+   */
+  explicit DataTypeVisitor(int target_bits,
+                           const ffi::Map<Var, ffi::Optional<Range>>& free_var_bounds, bool guard)
+      : bits_(target_bits), target_bits_(target_bits), guard_(guard) {
+    for (const auto& [var, bound] : free_var_bounds) {
+      if (bound.defined()) {
+        analyzer_.Bind(var, bound.value());
+        dom_map_[var.get()] = arith::IntSet::FromRange(bound.value());
+      }
+      vextent_[var.get()] = var->dtype;
+      free_vars.insert(var.get());
+    }
+  }
 
   void VisitExpr(const PrimExpr& e) {
     if (e.dtype().is_int()) {
@@ -88,6 +118,8 @@ class DataTypeVisitor final : public StmtExprVisitor {
       if (e.dtype().bits() <= target_bits_ ||
           (bound->max_value <= ubound && bound->min_value >= lbound)) {
         bits = target_bits_;
+      } else if (guard_ && AddGuard(e, lbound, ubound)) {
+        bits = target_bits_;
       }
       int tmp = bits > bits_ ? bits : bits_;
       std::swap(bits_, tmp);
@@ -107,6 +139,7 @@ class DataTypeVisitor final : public StmtExprVisitor {
 
   void VisitStmt_(const ForNode* op) {
     analyzer_.Bind(op->loop_var, Range::FromMinExtent(op->min, op->extent));
+    dom_map_[op->loop_var.get()] = arith::IntSet::FromMinExtent(op->min, op->extent);
     vextent_[op->loop_var.as<VarNode>()] = op->extent.dtype();
     return StmtExprVisitor::VisitStmt_(op);
   }
@@ -114,6 +147,7 @@ class DataTypeVisitor final : public StmtExprVisitor {
   void VisitStmt_(const BlockNode* op) {
     for (const IterVar& iter : op->iter_vars) {
       analyzer_.Bind(iter->var, Range::FromMinExtent(iter->dom->min, iter->dom->extent));
+      dom_map_[iter->var.get()] = arith::IntSet::FromRange(iter->dom);
       vextent_[iter->var.as<VarNode>()] = iter->dom->extent.dtype();
     }
     StmtExprVisitor::VisitStmt_(op);
@@ -124,6 +158,8 @@ class DataTypeVisitor final : public StmtExprVisitor {
       IterVar iv = Downcast<IterVar>(op->node);
       ICHECK_NE(iv->thread_tag.length(), 0U);
       analyzer_.Bind(iv->var, Range::FromMinExtent(0, op->value));
+      dom_map_[iv->var.get()] =
+          arith::IntSet::FromMinExtent(make_zero(op->value.dtype()), op->value);
       vextent_[iv->var.as<VarNode>()] = op->value.dtype();
       StmtExprVisitor::VisitStmt_(op);
     } else {
@@ -186,6 +222,10 @@ class DataTypeVisitor final : public StmtExprVisitor {
 
   // the narrowed datatype of Var and IntImm
   std::unordered_map<const PrimExprNode*, DataType> vmap;
+  // the runtime checks under which the narrowing is valid, in guard mode
+  std::vector<PrimExpr> guards;
+  // the free vars of the function
+  std::unordered_set<const VarNode*> free_vars;
 
  protected:
   // internal analyzer
@@ -202,12 +242,49 @@ class DataTypeVisitor final : public StmtExprVisitor {
   std::unordered_map<const VarNode*, DataType> vextent_;
   // the memorized bound generated by ConstIntBoundAnalyzer
   arith::ConstIntBoundAnalyzer::BoundMapType bound_;
+  // whether to guard the expressions that don't provably fit
+  bool guard_;
+  // the domain of the vars, to bound the expressions in terms of the free vars
+  std::unordered_map<const VarNode*, arith::IntSet> dom_map_;
+
+  /*!
+   * \brief Add the runtime check that an expression fits into [lbound, ubound], if its bounds
+   *  only depend on the free vars.
+   */
+  bool AddGuard(const PrimExpr& e, int64_t lbound, int64_t ubound) {
+    arith::IntSet set = arith::EvalSet(e, dom_map_);
+    if (!set.HasLowerBound() || !set.HasUpperBound()) {
+      return false;
+    }
+    PrimExpr min_value = analyzer_.Simplify(set.min());
+    PrimExpr max_value = analyzer_.Simplify(set.max());
+    auto f_not_free = [this](const VarNode* var) { return !free_vars.count(var); };
+    if (UsesVar(min_value, f_not_free) || UsesVar(max_value, f_not_free)) {
+      return false;
+    }
+    auto f_add = [this](const PrimExpr& cond) {
+      if (analyzer_.CanProve(cond)) return;
+      for (const PrimExpr& guard : guards) {
+        if (StructuralEqual()(guard, cond)) return;
+      }
+      guards.push_back(cond);
+    };
+    f_add(min_value >= make_const(min_value.dtype(), lbound));
+    f_add(max_value <= make_const(max_value.dtype(), ubound));
+    return true;
+  }
 };
 
 class NarrowDataTypeRewriter : public IndexDataTypeRewriter {
  public:
   using Parent = IndexDataTypeRewriter;
-  explicit NarrowDataTypeRewriter(int target_bits) : visitor_(target_bits) {}
+  explicit NarrowDataTypeRewriter(int target_bits,
+                                  const ffi::Map<Var, ffi::Optional<Range>>& free_vars = {},
+                                  bool guard = false)
+      : visitor_(target_bits, free_vars, guard) {}
+
+  /*! \return The runtime checks under which the rewritten stmt is valid. */
+  const std::vector<PrimExpr>& guards() const { return visitor_.guards; }
 
   Stmt operator()(Stmt s) {
     visitor_(s);
@@ -232,7 +309,15 @@ class NarrowDataTypeRewriter : public IndexDataTypeRewriter {
   using Parent::VisitStmt_;
 
   PrimExpr VisitExpr_(const VarNode* op) final {
-    if (auto it = visitor_.vmap.find(op); !var_remap_.count(op) && it != visitor_.vmap.end()) {
+    auto it = visitor_.vmap.find(op);
+    if (visitor_.free_vars.count(op)) {
+      // The free vars are defined outside of the stmt, and are cast where they are narrowed.
+      if (is_enabled_ && it != visitor_.vmap.end()) {
+        return cast(it->second, ffi::GetRef<Var>(op));
+      }
+      return ffi::GetRef<Var>(op);
+    }
+    if (!var_remap_.count(op) && it != visitor_.vmap.end()) {
       var_remap_[op] = Var(op->name_hint, it->second);
     }
     return Parent::VisitExpr_(op);
@@ -310,12 +395,59 @@ Stmt NarrowDataType(Stmt stmt, int target_bits) {
   return NarrowDataTypeRewriter(target_bits)(stmt);
 }
 
+/*!
+ * \brief Get the free integer vars of a function, bounded by its "tir_var_upper_bound" attribute.
+ */
+ffi::Map<Var, ffi::Optional<Range>> GetFreeVarBounds(const PrimFunc& func) {
+  auto upper_bounds = func->GetAttr<ffi::Map<ffi::String, Any>>("tir_var_upper_bound")
+                          .value_or(ffi::Map<ffi::String, Any>());
+  ffi::Map<Var, ffi::Optional<Range>> free_vars;
+  for (const Var& var : UndefinedVars(func->body, func->params)) {
+    if (!var->dtype.is_int() || !var->dtype.is_scalar()) continue;
+    ffi::Optional<Range> bound;
+    if (auto opt_bound = upper_bounds.Get(var->name_hint)) {
+      if (const auto* upper_bound = Downcast<PrimExpr>(opt_bound.value()).as<IntImmNode>()) {
+        bound = Range(make_zero(var->dtype), make_const(var->dtype, upper_bound->value + 1));
+      }
+    }
+    free_vars.Set(var, bound);
+  }
+  return free_vars;
+}
+
+/*! \brief Narrow a function body, versioned on the runtime checks of the narrowing if needed. */
+Stmt NarrowDataTypeWithFallback(const PrimFunc& func, int target_bits, bool fallback) {
+  ffi::Map<Var, ffi::Optional<Range>> free_vars = GetFreeVarBounds(func);
+  Stmt narrowed = NarrowDataTypeRewriter(target_bits, free_vars)(func->body);
+  if (!fallback) {
+    return narrowed;
+  }
+  NarrowDataTypeRewriter guarded_rewriter(target_bits, free_vars, /*guard=*/true);
+  Stmt guarded = guarded_rewriter(func->body);
+  if (guarded_rewriter.guards().empty()) {
+    return narrowed;
+  }
+  PrimExpr cond = const_true();
+  for (const PrimExpr& guard : guarded_rewriter.guards()) {
+    cond = cond && guard;
+  }
+  return ConvertSSA(IfThenElse(cond, guarded, narrowed));
+}
+
 namespace transform {
 
 Pass NarrowDataType(int target_bits) {
   auto pass_func = [target_bits](PrimFunc f, IRModule m, PassContext ctx) {
-    auto* n = f.CopyOnWrite();
-    n->body = NarrowDataTypeRewriter(target_bits)(std::move(n->body));
+    // On GPUs, the 64-bit index arithmetic costs registers and instructions, so that a narrowed
+    // version of the kernel is worth the runtime check of the sizes.
+    bool fallback = false;
+    if (auto target = f->GetAttr<Target>(tvm::attr::kTarget)) {
+      ffi::String kind = target.value()->kind->name;
+      fallback = target_bits == 32 && (kind == "cuda" || kind == "rocm") &&
+                 ctx->GetConfig<Bool>("tir.narrow_index_with_fallback", Bool(true)).value();
+    }
+    Stmt body = NarrowDataTypeWithFallback(f, target_bits, fallback);
+    f.CopyOnWrite()->body = std::move(body);
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.NarrowDataType", {});
@@ -50,6 +50,7 @@ struct SimplifyConfigNode : public AttrsNodeReflAdapter<SimplifyConfigNode> {
   bool propagate_knowns_to_simplify_expressions;
   bool convert_boolean_to_and_of_ors;
   bool apply_constraints_to_boolean_branches;
+  bool memoize_analyzer_queries;
 
   static void RegisterReflection() {
     namespace refl = tvm::ffi::reflection;
@@ -75,6 +76,10 @@ struct SimplifyConfigNode : public AttrsNodeReflAdapter<SimplifyConfigNode> {
                 &SimplifyConfigNode::apply_constraints_to_boolean_branches,
                 "If true, simplify each branch of AND/OR under a constraints provided by the other "
                 "branch",
+                refl::DefaultValue(false))
+        .def_ro("memoize_analyzer_queries", &SimplifyConfigNode::memoize_analyzer_queries,
+                "If true, reuse the results of repeated simplifications and proofs of the same "
+                "expression",
                 refl::DefaultValue(false));
   }
   TVM_FFI_DECLARE_OBJECT_INFO_FINAL("tir.transform.SimplifyConfig", SimplifyConfigNode,
@@ -356,6 +361,9 @@ Pass Simplify() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     arith::Analyzer analyzer;
     auto cfg = ctx->GetConfig<arith::SimplifyConfig>("tir.Simplify");
+    if (cfg && cfg.value()->memoize_analyzer_queries) {
+      analyzer.SetMemoizationEnabled(true);
+    }
 
     return arith::StmtSimplifier::Apply(f, &analyzer, cfg);
   };
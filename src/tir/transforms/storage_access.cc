@@ -147,6 +147,17 @@ void StorageAccessVisitor::VisitStmt_(const AttrStmtNode* op) {
       StmtExprVisitor::VisitStmt_(op);
     }
     env_threads_.pop_back();
+  } else if (op->attr_key == attr::warp_specialization_scope) {
+    // The roles of a warp-specialized pipeline synchronize through mbarriers, while all threads
+    // synchronize on its entry and exit, so the region acts as a single barrier.
+    StmtEntry s;
+    s.stmt = op;
+    AccessEntry e;
+    e.threads = env_threads();
+    e.type = kSync;
+    e.scope = StorageScope::Create("shared");
+    s.access.emplace_back(std::move(e));
+    scope_.back().emplace_back(std::move(s));
   } else if (op->attr_key == attr::hand_threaded) {
     // skip this pass on blocks that were hand_threaded
     // this avoids control flow and read/write conflicts
@@ -634,9 +634,14 @@ class StoragePlanRewriter : public StmtExprMutator {
         }
         // Get the allocation size;
         e->alloc_var = e->allocs[0]->buffer_var;
+        // The arena is typed with the widest of the packed types, so that its alignment also
+        // suits the accesses of the narrower ones, e.g. float32 accesses to a float16 arena.
         DataType alloc_type = e->allocs[0]->dtype;
         for (const AllocateNode* op : e->allocs) {
-          if (op->dtype.lanes() > alloc_type.lanes()) {
+          int op_bits = op->dtype.bits() * op->dtype.lanes();
+          int alloc_bits = alloc_type.bits() * alloc_type.lanes();
+          if (op_bits > alloc_bits ||
+              (op_bits == alloc_bits && op->dtype.lanes() > alloc_type.lanes())) {
             alloc_type = op->dtype;
           }
         }
@@ -975,7 +980,9 @@ class StoragePlanRewriter : public StmtExprMutator {
         StorageEntry* e = it->second;
         if (e->attach_scope_ != attach_scope) continue;
         if (e->scope != scope) continue;
-        if (e->elem_type != op->dtype.element_of()) continue;
+        // Growing an untagged entry only grows its byte arena, whatever the types packed in it.
+        // The tagged memories are sized in units of the element type of the entry instead.
+        if (scope.tag.length() != 0 && e->elem_type != op->dtype.element_of()) continue;
         if (reuse_require_exact_matched_dtype && e->elem_type != op->dtype) {
           continue;
         }
@@ -33,6 +33,7 @@
 #include <tvm/tir/transform.h>
 
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../src/arith/scalable_expression.h"
@@ -91,9 +92,12 @@ bool EnableBufferLevelPredication(Target target) {
  * \brief A pass that tries to rewrite buffer accesses (loads and stores) with a
  * predicate expression where possible.
  *
- * \note For now we start with a minimal case targeting block-level predicates
- * produced by the split schedule primitive, with the potential for predicating
- * more complex terms in the future if needed.
+ * The condition must be a conjunction of lane bounds `Ramp(base, 1, lanes) < Broadcast(limit)`
+ * (or the equivalent `<=`, `>` and `>=` forms) sharing the same base, possibly wrapped in
+ * `T.likely`, and of conditions that are the same for all lanes. The tails produced by the
+ * split schedule primitive have this form. Any vectorized access can then be masked, since
+ * lane `l` of the access is executed exactly when iteration `l` of the scalar loop was;
+ * non-contiguous accesses become masked gathers and scatters in codegen.
  *
  * \example
  * Before:
@@ -122,22 +126,17 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
    * stmt if successful.
    */
   std::pair<bool, Stmt> Run(Stmt stmt, PrimExpr condition) {
-    // Check that the condition provided is of the form a < b, for now.
-    if (!condition->IsInstance<LTNode>()) {
+    if (!AddCondition(condition) || !base_.defined()) {
       return {false, stmt};
     }
 
-    LT lt = Downcast<LT>(condition);
-
-    // Check the form of the vectorized condition, we're expecting
-    // Ramp(...) < Broadcast(...)
-    if (!lt->a->IsInstance<RampNode>() || !lt->b->IsInstance<BroadcastNode>()) {
-      return {false, stmt};
+    predicate_ = Call(mask_dtype_, builtin::get_active_lane_mask(), {base_, limit_});
+    if (invariant_.defined()) {
+      predicate_ = And(predicate_, BroadcastTo(invariant_.value(),
+                                               mask_dtype_.get_lanes_or_vscale_factor(),
+                                               mask_dtype_.is_scalable_vector()));
     }
 
-    base_ = Downcast<Ramp>(lt->a)->base;
-    limit_ = Downcast<Broadcast>(lt->b)->value;
-
     // Now we can try to predicate
     Stmt predicated_stmt = StmtExprMutator::operator()(std::move(stmt));
     if (num_accesses_analyzed_ > 0 && num_accesses_analyzed_ == num_accesses_rewritten_) {
@@ -147,6 +146,60 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
   }
 
  private:
+  /*! \brief Fold a term of the vectorized condition into the predicate, if possible. */
+  bool AddCondition(const PrimExpr& condition) {
+    if (const auto* call = condition.as<CallNode>()) {
+      return call->op.same_as(builtin::likely()) && AddCondition(call->args[0]);
+    }
+    if (const auto* op = condition.as<AndNode>()) {
+      return AddCondition(op->a) && AddCondition(op->b);
+    }
+    if (const auto* op = condition.as<BroadcastNode>()) {
+      invariant_ = invariant_.defined() ? invariant_.value() && op->value : op->value;
+      return true;
+    }
+    // Normalize the lane bound to `ramp < limit`.
+    PrimExpr ramp, limit;
+    if (const auto* op = condition.as<LTNode>()) {
+      ramp = op->a;
+      limit = op->b;
+    } else if (const auto* op = condition.as<LENode>()) {
+      ramp = op->a;
+      limit = op->b;
+    } else if (const auto* op = condition.as<GTNode>()) {
+      ramp = op->b;
+      limit = op->a;
+    } else if (const auto* op = condition.as<GENode>()) {
+      ramp = op->b;
+      limit = op->a;
+    } else {
+      return false;
+    }
+    // Check the form of the vectorized condition, we're expecting
+    // Ramp(..., 1, ...) < Broadcast(...)
+    const auto* ramp_node = ramp.as<RampNode>();
+    const auto* limit_node = limit.as<BroadcastNode>();
+    if (ramp_node == nullptr || limit_node == nullptr || !is_one(ramp_node->stride)) {
+      return false;
+    }
+    PrimExpr limit_value = limit_node->value;
+    if (condition->IsInstance<LENode>() || condition->IsInstance<GENode>()) {
+      limit_value = limit_value + make_const(limit_value.dtype(), 1);
+    }
+    if (!base_.defined()) {
+      base_ = ramp_node->base;
+      limit_ = limit_value;
+      mask_dtype_ = DataType(DataType::kUInt, 1, ramp_node->dtype.get_lanes_or_vscale_factor(),
+                             ramp_node->dtype.is_scalable_vector());
+      return true;
+    }
+    if (!tvm::StructuralEqual()(ramp_node->base, base_)) {
+      return false;
+    }
+    limit_ = min(limit_, limit_value);
+    return true;
+  }
+
   PrimExpr VisitExpr_(const BufferLoadNode* op) final {
     auto load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
     return TryPredicateBufferAccess(load);
@@ -163,24 +216,20 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
 
     // Do not try to predicate non-vectorized accesses
     ffi::Array<PrimExpr> indices = node->indices;
-    if (!indices.size() || !indices[0]->IsInstance<RampNode>()) {
+    if (!indices.size() || !indices.back()->IsInstance<RampNode>()) {
       return node;
     }
-    Ramp ramp = Downcast<Ramp>(node->indices[0]);
-
-    // The vectorized access pattern must match the base of the predicate
-    if (!tvm::StructuralEqual()(ramp->base, base_)) {
+    // Each lane of the access must match a lane of the predicate
+    DataType index_dtype = indices.back().dtype();
+    if (index_dtype.get_lanes_or_vscale_factor() != mask_dtype_.get_lanes_or_vscale_factor() ||
+        index_dtype.is_scalable_vector() != mask_dtype_.is_scalable_vector() ||
+        node->buffer->dtype.lanes() != 1) {
       return node;
     }
 
-    DataType buf_predicate_dtype =
-        DataType(DataType::kUInt, 1, ramp->dtype.get_lanes_or_vscale_factor(),
-                 ramp->dtype.is_scalable_vector());
-    Call lane_mask = Call(buf_predicate_dtype, builtin::get_active_lane_mask(), {base_, limit_});
-
     num_accesses_rewritten_ += 1;
     auto writer = node.CopyOnWrite();
-    writer->predicate = lane_mask;
+    writer->predicate = predicate_;
     return node;
   }
 
@@ -189,6 +238,12 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
   /*! \brief The limit of the predicate. The expr specifies the upper bound of the base's
    * evaluated value. */
   PrimExpr limit_;
+  /*! \brief The conjunction of the terms of the condition that are the same for all lanes. */
+  ffi::Optional<PrimExpr> invariant_;
+  /*! \brief The dtype of the predicate. */
+  DataType mask_dtype_;
+  /*! \brief The predicate of the rewritten accesses. */
+  PrimExpr predicate_;
   /*! \brief The number of buffer accesses in the stmt we will analyze. */
   size_t num_accesses_analyzed_ = 0;
   /*! \brief The number of buffer accesses rewritten with predicates. */
@@ -359,3 +359,53 @@ TEST_F(HexagonThreadManagerTest, threads_for_resource_types) {
   thread = reinterpret_cast<TVMStreamHandle>(6);
   EXPECT_THROW(thread_manager->GetResourceTypeForStreamHandle(thread), InternalError);
 }
+
+struct ParallelRecord {
+  std::vector<int> task_ids;
+  std::vector<int> num_tasks;
+};
+
+int record_task(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  ParallelRecord* record = static_cast<ParallelRecord*>(cdata);
+  record->task_ids[task_id] = task_id;
+  record->num_tasks[task_id] = penv->num_task;
+  return TVMBackendParallelBarrier(task_id, penv);
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_launch) {
+  // Without hardware resources, every thread runs a task.
+  ParallelRecord record{std::vector<int>(threads, -1), std::vector<int>(threads, -1)};
+  CHECK_EQ(htm->ParallelLaunch(record_task, &record, 0), 0);
+  for (int i = 0; i < threads; i++) {
+    CHECK_EQ(record.task_ids[i], i);
+    CHECK_EQ(record.num_tasks[i], threads);
+  }
+  // The number of tasks is capped to the number of threads.
+  record = ParallelRecord{std::vector<int>(threads, -1), std::vector<int>(threads, -1)};
+  CHECK_EQ(htm->ParallelLaunch(record_task, &record, 2), 0);
+  CHECK_EQ(record.num_tasks[0], 2);
+  CHECK_EQ(record.task_ids[2], -1);
+  CHECK_EQ(htm->ParallelLaunch(record_task, &record, 100), 0);
+  CHECK_EQ(record.num_tasks[threads - 1], threads);
+}
+
+int allocate_vtcm(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  std::vector<void*>* ptrs = static_cast<std::vector<void*>*>(cdata);
+  HexagonVtcmPool* pool = HexagonDeviceAPI::Global()->VtcmPool();
+  (*ptrs)[task_id] = pool->Allocate(0x800);
+  pool->Free((*ptrs)[task_id], 0x800);
+  return 0;
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_launch_vtcm_partitions) {
+  HexagonVtcmPool* pool = HexagonDeviceAPI::Global()->VtcmPool();
+  const size_t partition_bytes = 0x1000;
+  char* vtcm = static_cast<char*>(pool->Allocate(partition_bytes * threads));
+  std::vector<void*> ptrs(threads, nullptr);
+  CHECK_EQ(htm->ParallelLaunch(allocate_vtcm, &ptrs, 0, vtcm, partition_bytes), 0);
+  // The allocations of each task come from its own partition.
+  for (int i = 0; i < threads; i++) {
+    CHECK_EQ(ptrs[i], vtcm + i * partition_bytes);
+  }
+  pool->Free(vtcm, partition_bytes * threads);
+}
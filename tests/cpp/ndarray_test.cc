@@ -71,3 +71,49 @@ TEST(TensorTest, IsContiguous_UncontiguousStride) {
   managed_tensor->dl_tensor.strides = nullptr;
   managed_tensor->deleter(managed_tensor);
 }
+
+TEST(TensorTest, FromExternal_CallsDeleter) {
+  alignas(64) static float buffer[6] = {0, 1, 2, 3, 4, 5};
+  int num_deleted = 0;
+  {
+    auto array = runtime::Tensor::FromExternal(buffer, {2, 3}, DataType::Float(32), {kDLCPU},
+                                               [&num_deleted](void* data) {
+                                                 ICHECK_EQ(data, buffer);
+                                                 ++num_deleted;
+                                               });
+    ICHECK_EQ(array->data, buffer);
+    ICHECK(array.IsContiguous());
+    auto view = array.CreateView({3}, DataType::Float(32), 3 * sizeof(float));
+    array = runtime::Tensor();
+    ICHECK_EQ(num_deleted, 0);
+    ICHECK_EQ(static_cast<float*>(view->data)[view->byte_offset / sizeof(float)], 3.0f);
+  }
+  ICHECK_EQ(num_deleted, 1);
+}
+
+TEST(TensorTest, FromExternal_Strides) {
+  alignas(64) static float buffer[8] = {};
+  // A column slice of a 2x4 matrix.
+  auto array = runtime::Tensor::FromExternal(buffer, {2, 2}, DataType::Float(32), {kDLCPU},
+                                             nullptr, ffi::Shape({4, 1}), 2 * sizeof(float));
+  ICHECK(!array.IsContiguous());
+  ICHECK_EQ(array->strides[0], 4);
+  ICHECK_EQ(array->strides[1], 1);
+  ICHECK_EQ(array->byte_offset, 2 * sizeof(float));
+
+  EXPECT_ANY_THROW(runtime::Tensor::FromExternal(buffer, {2, 2}, DataType::Float(32), {kDLCPU},
+                                                 nullptr, ffi::Shape({4})));
+  EXPECT_ANY_THROW(runtime::Tensor::FromExternal(buffer, {2, 2}, DataType::Float(32), {kDLCPU},
+                                                 nullptr, ffi::Shape({-4, 1})));
+}
+
+TEST(TensorTest, FromExternal_Alignment) {
+  alignas(64) static float buffer[8] = {};
+  EXPECT_ANY_THROW(runtime::Tensor::FromExternal(buffer + 1, {4}, DataType::Float(32), {kDLCPU},
+                                                 nullptr));
+  EXPECT_ANY_THROW(runtime::Tensor::FromExternal(buffer, {4}, DataType::Float(32), {kDLCPU},
+                                                 nullptr, std::nullopt, 2));
+  auto array = runtime::Tensor::FromExternal(buffer + 1, {4}, DataType::Float(32), {kDLCPU},
+                                             nullptr, std::nullopt, 0, sizeof(float));
+  ICHECK_EQ(array->data, buffer + 1);
+}
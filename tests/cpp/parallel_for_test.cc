@@ -21,6 +21,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
+#include <atomic>
 #include <thread>
 #include <vector>
 
@@ -91,20 +92,17 @@ TEST(ParallelFor, NestedWithNormalForLoop) {
 }
 
 TEST(ParallelFor, NestedWithParallelFor) {
-  // Currently do not support using nested parallel_for
   using tvm::support::parallel_for;
 
-  bool exception = false;
-  try {
-    parallel_for(0, 100, [](int i) {
-      parallel_for(0, 100, [](int j) {
-        // Blank loop
-      });
-    });
-  } catch (const std::exception& e) {
-    exception = true;
+  std::vector<std::vector<int>> a(100, std::vector<int>(100, 0));
+  parallel_for(0, 100, [&a](int i) {
+    parallel_for(0, 100, [&a, i](int j) { a[i][j] = i * j; });
+  });
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 100; j++) {
+      ICHECK_EQ(a[i][j], i * j);
+    }
   }
-  ICHECK(exception);
 }
 
 TEST(ParallelFor, Exception) {
@@ -157,3 +155,38 @@ TEST(ParallelForDynamic, ExceptionOnArbitrary) {
   }
   ICHECK(exception);
 }
+
+TEST(ParallelForDynamic, Nested) {
+  using tvm::support::parallel_for_dynamic;
+  int num_threads = 4;
+  std::vector<std::vector<int>> a(50, std::vector<int>(50, 0));
+  parallel_for_dynamic(0, 50, num_threads, [&](int thread_id, int i) {
+    ICHECK_LT(thread_id, num_threads);
+    parallel_for_dynamic(0, 50, num_threads, [&a, i](int thread_id, int j) { a[i][j] = i + j; });
+  });
+  for (int i = 0; i < 50; i++) {
+    for (int j = 0; j < 50; j++) {
+      ICHECK_EQ(a[i][j], i + j);
+    }
+  }
+}
+
+TEST(ParallelForDynamic, ConcurrentCallers) {
+  using tvm::support::parallel_for_dynamic;
+  std::vector<std::thread> callers;
+  std::vector<std::atomic<int>> sums(4);
+  for (int t = 0; t < 4; ++t) {
+    sums[t] = 0;
+    callers.emplace_back([&sums, t]() {
+      for (int repeat = 0; repeat < 10; ++repeat) {
+        parallel_for_dynamic(0, 100, 3, [&sums, t](int thread_id, int i) { sums[t] += i; });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (int t = 0; t < 4; ++t) {
+    ICHECK_EQ(sums[t].load(), 10 * 100 * 99 / 2);
+  }
+}
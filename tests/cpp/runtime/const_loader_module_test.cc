@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/ffi/container/map.h>
+#include <tvm/ffi/function.h>
+#include <tvm/runtime/tensor.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../src/runtime/const_loader_module.h"
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+
+Tensor MakeTensor(float value) {
+  Tensor tensor = Tensor::Empty({4}, DataType::Float(32), {kDLCPU, 0});
+  for (int i = 0; i < 4; ++i) {
+    static_cast<float*>(tensor->data)[i] = value + i;
+  }
+  return tensor;
+}
+
+ffi::Module SaveAndLoad(const ffi::Module& mod) {
+  static const auto load =
+      ffi::Function::GetGlobalRequired("ffi.Module.load_from_bytes.const_loader");
+  return load(mod->SaveToBytes()).cast<ffi::Module>();
+}
+
+float FirstElement(const ffi::Map<ffi::String, ffi::Any>& tensors, const std::string& var) {
+  return static_cast<float*>(tensors.at(var).cast<Tensor>()->data)[0];
+}
+
+}  // namespace
+
+TEST(ConstLoaderModule, LazyLoadPrefetchAndEvict) {
+  std::unordered_map<std::string, Tensor> tensors = {{"a", MakeTensor(1)}, {"b", MakeTensor(2)}};
+  std::unordered_map<std::string, std::vector<std::string>> vars = {{"f", {"a"}},
+                                                                    {"g", {"a", "b"}}};
+  ffi::Module mod = SaveAndLoad(ConstLoaderModuleCreate(tensors, vars));
+  // The constants not deserialized yet are saved as they are.
+  mod = SaveAndLoad(mod);
+  auto num_loaded = mod->GetFunction("num_loaded_constants").value();
+  EXPECT_EQ(num_loaded().cast<int64_t>(), 0);
+
+  auto prefetch = mod->GetFunction("prefetch_constants").value();
+  auto wait_prefetch = mod->GetFunction("wait_prefetch").value();
+  prefetch(ffi::Array<ffi::String>{"f"});
+  wait_prefetch();
+  // Only the constant of f is deserialized.
+  EXPECT_EQ(num_loaded().cast<int64_t>(), 1);
+  prefetch(ffi::Array<ffi::String>{"g"});
+  wait_prefetch();
+  EXPECT_EQ(num_loaded().cast<int64_t>(), 2);
+  auto get_const_var_tensor = mod->GetFunction("get_const_var_tensor").value();
+  auto loaded = get_const_var_tensor().cast<ffi::Map<ffi::String, ffi::Any>>();
+  EXPECT_EQ(loaded.size(), 2);
+  EXPECT_EQ(FirstElement(loaded, "a"), 1);
+  EXPECT_EQ(FirstElement(loaded, "b"), 2);
+
+  auto evict = mod->GetFunction("evict_constants").value();
+  EXPECT_EQ(evict(ffi::Array<ffi::String>{"f"}).cast<int64_t>(), 1);
+  EXPECT_EQ(evict(ffi::Array<ffi::String>{"f"}).cast<int64_t>(), 0);
+  EXPECT_EQ(num_loaded().cast<int64_t>(), 1);
+  // The evicted constants are deserialized again on their next use.
+  loaded = get_const_var_tensor().cast<ffi::Map<ffi::String, ffi::Any>>();
+  EXPECT_EQ(FirstElement(loaded, "a"), 1);
+}
+
+}  // namespace runtime
+}  // namespace tvm
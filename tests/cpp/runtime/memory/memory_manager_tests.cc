@@ -22,7 +22,12 @@
 #include <tvm/runtime/memory/memory_manager.h>
 
 #include <exception>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
 
+#include "../../../../src/runtime/memory/best_fit_allocator.h"
 #include "../../../../src/runtime/memory/pooled_allocator.h"
 
 namespace tvm {
@@ -182,6 +187,181 @@ TEST_F(TvmVMMemoryManagerTest, PooledAllocWithShape) {
   }
 }
 
+TEST_F(TvmVMMemoryManagerTest, BestFitAllocBasic) {
+  Device dev = {kDLCPU, 0};
+  auto* allocator =
+      static_cast<BestFitAllocator*>(MemoryManagerWrapper::GetOrCreateAllocator(dev, kBestFit));
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  auto buff = allocator->Alloc(dev, 64, 32, DataType::Float(32));
+  EXPECT_EQ(buff.size, BestFitAllocator::kMinBlockSize);
+  EXPECT_EQ(buff.alloc_type, kBestFit);
+  EXPECT_EQ(allocator->UsedMemory(), BestFitAllocator::kSmallSegmentSize);
+  allocator->Free(buff);
+  EXPECT_EQ(allocator->UsedMemory(), BestFitAllocator::kSmallSegmentSize);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BestFitSplitAndCoalesce) {
+  Device dev = {kDLCPU, 0};
+  auto* allocator =
+      static_cast<BestFitAllocator*>(MemoryManagerWrapper::GetOrCreateAllocator(dev, kBestFit));
+  // Requests of different sizes are carved out of the same segment.
+  auto a = allocator->Alloc(dev, 1000, 64, DataType::Float(32));
+  auto b = allocator->Alloc(dev, 3000, 64, DataType::Float(32));
+  auto c = allocator->Alloc(dev, 5000, 64, DataType::Float(32));
+  EXPECT_EQ(allocator->UsedMemory(), BestFitAllocator::kSmallSegmentSize);
+  EXPECT_EQ(static_cast<uint8_t*>(b.data), static_cast<uint8_t*>(a.data) + a.size);
+  EXPECT_EQ(static_cast<uint8_t*>(c.data), static_cast<uint8_t*>(b.data) + b.size);
+  BestFitAllocator::Stats stats = allocator->GetStats();
+  EXPECT_EQ(stats.num_segments, 1);
+  EXPECT_EQ(stats.num_allocated_blocks, 3);
+  EXPECT_EQ(stats.allocated_bytes, a.size + b.size + c.size);
+
+  // Freeing the middle block leaves a hole that a smaller request reuses.
+  allocator->Free(b);
+  stats = allocator->GetStats();
+  EXPECT_EQ(stats.num_free_blocks, 2);
+  EXPECT_GT(stats.fragmentation(), 0.0);
+  auto d = allocator->Alloc(dev, 2000, 64, DataType::Float(32));
+  EXPECT_EQ(d.data, b.data);
+
+  // Freeing everything coalesces back into a single free block.
+  allocator->Free(a);
+  allocator->Free(c);
+  allocator->Free(d);
+  stats = allocator->GetStats();
+  EXPECT_EQ(stats.num_free_blocks, 1);
+  EXPECT_EQ(stats.largest_free_block, BestFitAllocator::kSmallSegmentSize);
+  EXPECT_EQ(stats.fragmentation(), 0.0);
+  EXPECT_EQ(stats.num_cache_misses, 1);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BestFitLargeAlloc) {
+  Device dev = {kDLCPU, 0};
+  auto* allocator =
+      static_cast<BestFitAllocator*>(MemoryManagerWrapper::GetOrCreateAllocator(dev, kBestFit));
+  size_t nbytes = BestFitAllocator::kMediumSize + 1;
+  size_t round = BestFitAllocator::kLargeRoundSize;
+  auto buff = allocator->Alloc(dev, nbytes, 64, DataType::Float(32));
+  EXPECT_EQ(allocator->UsedMemory(), (nbytes + round - 1) / round * round);
+  allocator->Free(buff);
+  // A slightly smaller request reuses the cached large segment.
+  auto buff2 = allocator->Alloc(dev, nbytes - 4096, 64, DataType::Float(32));
+  EXPECT_EQ(buff2.data, buff.data);
+  EXPECT_EQ(allocator->GetStats().num_segments, 1);
+  allocator->Free(buff2);
+}
+
+// Treats every device as one whose pointers cannot be offset, so all blocks are whole segments.
+class WholeSegmentBestFitAllocator : public BestFitAllocator {
+ protected:
+  bool SupportsSubAllocation(Device dev) const final { return false; }
+};
+
+TEST_F(TvmVMMemoryManagerTest, BestFitWholeSegmentReuse) {
+  Device dev = {kDLCPU, 0};
+  WholeSegmentBestFitAllocator allocator;
+  auto a = allocator.Alloc(dev, 1000, 64, DataType::Float(32));
+  EXPECT_EQ(allocator.UsedMemory(), a.size);
+  allocator.Free(a);
+  EXPECT_EQ(allocator.GetStats().num_free_blocks, 1);
+  // A request of the same rounded size reuses the freed segment.
+  auto b = allocator.Alloc(dev, 900, 64, DataType::Float(32));
+  EXPECT_EQ(b.data, a.data);
+  // A different size reserves a new segment instead of handing out the wrong size.
+  auto c = allocator.Alloc(dev, 4096, 64, DataType::Float(32));
+  EXPECT_NE(c.data, a.data);
+  BestFitAllocator::Stats stats = allocator.GetStats();
+  EXPECT_EQ(stats.num_segments, 2);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.num_cache_misses, 2);
+  allocator.Free(b);
+  allocator.Free(c);
+  allocator.Clear();
+  EXPECT_EQ(allocator.UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BestFitEmptyBasic) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kBestFit);
+  auto dt = DataType::Float(32);
+  ffi::Shape shape = {1, 3, 6, 6};
+  {
+    auto ndarray = allocator->Empty(shape, dt, dev);
+    EXPECT_EQ(allocator->UsedMemory(), BestFitAllocator::kSmallSegmentSize);
+  }
+  EXPECT_EQ(static_cast<BestFitAllocator*>(allocator)->GetStats().num_allocated_blocks, 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PooledThreadCacheReuse) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = PooledAllocator::kDefaultPageSize;
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kPooled);
+  auto buff = allocator->Alloc(dev, page_size, 32, DataType::Float(32));
+  allocator->Free(buff);
+  // The freed buffer is served again from the calling thread's cache.
+  auto again = allocator->Alloc(dev, page_size, 32, DataType::Float(32));
+  EXPECT_EQ(again.data, buff.data);
+  EXPECT_EQ(allocator->UsedMemory(), page_size);
+  allocator->Free(again);
+
+  // Buffers cached by a thread that exited are reclaimed by the shared pool.
+  void* data_from_thread = nullptr;
+  std::thread worker([&]() {
+    auto buf = allocator->Alloc(dev, 2 * page_size, 32, DataType::Float(32));
+    data_from_thread = buf.data;
+    allocator->Free(buf);
+  });
+  worker.join();
+  auto reclaimed = allocator->Alloc(dev, 2 * page_size, 32, DataType::Float(32));
+  EXPECT_EQ(reclaimed.data, data_from_thread);
+  EXPECT_EQ(allocator->UsedMemory(), 3 * page_size);
+  allocator->Free(reclaimed);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PooledThreadCacheConcurrent) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kPooled);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&, t]() {
+      for (int i = 0; i < 100; ++i) {
+        size_t nbytes = (i % (PooledAllocator::kDefaultThreadCacheCapacity * 2) + t + 1) * 1024;
+        auto buf = allocator->Alloc(dev, nbytes, 32, DataType::Float(32));
+        allocator->Free(buf);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  EXPECT_NE(allocator->UsedMemory(), 0);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PooledThreadCacheOutlivedByThread) {
+  Device dev = {kDLCPU, 0};
+  auto allocator = std::make_unique<PooledAllocator>();
+  std::promise<void> used, destroyed;
+  std::thread worker([&]() {
+    auto buf = allocator->Alloc(dev, 1024, 32, DataType::Float(32));
+    allocator->Free(buf);
+    used.set_value();
+    // The allocator is destroyed before this thread exits and releases its cache entries.
+    destroyed.get_future().wait();
+  });
+  used.get_future().wait();
+  allocator.reset();
+  destroyed.set_value();
+  worker.join();
+}
+
 }  // namespace memory
 }  // namespace runtime
 }  // namespace tvm
@@ -22,6 +22,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <sstream>
@@ -184,6 +185,106 @@ TEST(ThreadingBackend, TVMBackendAffinityConfigure) {
   }
 }
 
+TEST(ThreadingBackend, NumaAffinityConfigure) {
+  const std::vector<std::vector<unsigned int>>& nodes = tvm::runtime::threading::NumaNodeCpus();
+  ASSERT_FALSE(nodes.empty());
+  std::unordered_set<unsigned int> seen;
+  for (const auto& cpus : nodes) {
+    for (unsigned int cpu : cpus) {
+      EXPECT_TRUE(seen.insert(cpu).second) << "CPU " << cpu << " is in two NUMA nodes";
+    }
+  }
+  EXPECT_FALSE(seen.empty());
+
+  std::thread t([]() {
+    tvm::runtime::threading::Configure(tvm::runtime::threading::ThreadGroup::kNuma, 0, {});
+    std::atomic<size_t> acc(0);
+    TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  });
+  t.join();
+}
+
+TEST(ThreadingBackend, IsolatedThreadPool) {
+  int max_concurrency = tvm::runtime::threading::MaxConcurrency();
+  if (max_concurrency <= 1) {
+    return;
+  }
+  const int num_pools = 2;
+  const int cpus_per_pool = max_concurrency / num_pools;
+  std::vector<std::unique_ptr<tvm::runtime::threading::IsolatedThreadPool>> pools;
+  for (int i = 0; i < num_pools; ++i) {
+    std::vector<unsigned int> cpus;
+    for (int k = 0; k < cpus_per_pool; ++k) {
+      cpus.push_back(i * cpus_per_pool + k);
+    }
+    pools.emplace_back(new tvm::runtime::threading::IsolatedThreadPool(cpus));
+  }
+  std::vector<std::unique_ptr<std::thread>> ts;
+  for (int i = 0; i < num_pools; ++i) {
+    ts.emplace_back(new std::thread([&, i]() {
+      tvm::runtime::threading::IsolatedThreadPool::Scope scope(pools[i].get());
+      EXPECT_EQ(tvm::runtime::threading::NumThreads(), cpus_per_pool);
+      for (int j = 0; j < 3; ++j) {
+        std::atomic<size_t> acc(0);
+        AffinityCheck ac(i, max_concurrency, &acc);
+        TVMBackendParallelLaunch(affinity_check_task_id, &ac, 0);
+        EXPECT_EQ(ac.GetComputeResult(), N * (N - 1) / 2);
+        EXPECT_EQ(ac.VerifyAffinity(pools[i]->cpus()), true);
+      }
+    }));
+  }
+  for (auto& t : ts) {
+    t->join();
+  }
+}
+
+TEST(ThreadingBackend, IsolatedThreadPoolNestedLaunch) {
+  int max_concurrency = tvm::runtime::threading::MaxConcurrency();
+  std::vector<unsigned int> cpus;
+  for (int k = 0; k < std::min(max_concurrency, 4); ++k) {
+    cpus.push_back(k);
+  }
+  tvm::runtime::threading::IsolatedThreadPool pool(cpus);
+  tvm::runtime::threading::IsolatedThreadPool::Scope scope(&pool);
+  EXPECT_TRUE(tvm::runtime::threading::SupportsNestedLaunch());
+  struct NestedData {
+    std::atomic<size_t> acc{0};
+    std::atomic<int> num_outer_task{0};
+  } data;
+  static FTVMParallelLambda outer = [](int task_id, TVMParallelGroupEnv* penv,
+                                       void* cdata) -> int {
+    auto* data = reinterpret_cast<NestedData*>(cdata);
+    data->num_outer_task.fetch_add(1);
+    std::atomic<size_t> inner_acc(0);
+    // The nested launches, including the one of the task 0 on the launching thread, run inline.
+    if (TVMBackendParallelLaunch(atomic_add_task_id, &inner_acc, 0) != 0) return -1;
+    data->acc.fetch_add(inner_acc.load());
+    return 0;
+  };
+  ASSERT_EQ(TVMBackendParallelLaunch(outer, &data, 0), 0);
+  int num_outer_task = data.num_outer_task.load();
+  EXPECT_GE(num_outer_task, 1);
+  EXPECT_EQ(data.acc.load(), num_outer_task * (N * (N - 1) / 2));
+
+  // The pool takes launches again after the nested ones.
+  std::atomic<size_t> acc(0);
+  ASSERT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+  EXPECT_EQ(acc.load(), N * (N - 1) / 2);
+}
+
+TEST(ThreadingBackend, HybridDynamicLaunch) {
+  std::thread t([]() {
+    tvm::runtime::threading::Configure(tvm::runtime::threading::ThreadGroup::kHybrid, 0, {});
+    for (int i = 0; i < 4; ++i) {
+      std::atomic<size_t> acc(0);
+      TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+  });
+  t.join();
+}
+
 TEST(ThreadingBackend, TVMBackendParallelForWithThreadingBackend) {
   int n = 100;
   std::vector<int> vec(/*size=*/n, /*value=*/0);
@@ -192,3 +293,34 @@ TEST(ThreadingBackend, TVMBackendParallelForWithThreadingBackend) {
     EXPECT_EQ(vec[i], i);
   }
 }
+
+TEST(ThreadingBackend, WorkStealingNestedLaunch) {
+  setenv("TVM_THREAD_POOL_KIND", "work_stealing", 1);
+  tvm::runtime::threading::ResetThreadPool();
+  struct NestedData {
+    std::atomic<size_t> acc{0};
+    std::atomic<int> num_outer_task{0};
+  } data;
+  static FTVMParallelLambda outer = [](int task_id, TVMParallelGroupEnv* penv,
+                                       void* cdata) -> int {
+    auto* data = reinterpret_cast<NestedData*>(cdata);
+    data->num_outer_task.fetch_add(1);
+    std::atomic<size_t> inner_acc(0);
+    // Launching from inside a task is allowed by the work-stealing pool.
+    if (TVMBackendParallelLaunch(atomic_add_task_id, &inner_acc, 0) != 0) return -1;
+    data->acc.fetch_add(inner_acc.load());
+    return 0;
+  };
+  ASSERT_EQ(TVMBackendParallelLaunch(outer, &data, 0), 0);
+  int num_outer_task = data.num_outer_task.load();
+  EXPECT_GE(num_outer_task, 1);
+  EXPECT_EQ(data.acc.load(), num_outer_task * (N * (N - 1) / 2));
+
+  // Over-decomposed launches still cover the full iteration space.
+  std::atomic<size_t> acc(0);
+  ASSERT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 4 * N), 0);
+  EXPECT_EQ(acc.load(), N * (N - 1) / 2);
+
+  unsetenv("TVM_THREAD_POOL_KIND");
+  tvm::runtime::threading::ResetThreadPool();
+}
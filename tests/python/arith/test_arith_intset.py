@@ -150,7 +150,7 @@ def check_region_bound(expect_region, var_dom, mode, predicate=None):
         Map var to iteration domain range.
 
     mode: str
-        Specify "lowerbound", "upperbound" or else use strict bound estimation.
+        Specify "lowerbound", "upperbound", "polyhedral" or else use strict bound estimation.
 
     predicate: PrimExpr
         Extra predicate, defaults to True.
@@ -172,6 +172,10 @@ def check_region_bound(expect_region, var_dom, mode, predicate=None):
         result = tvm.arith.estimate_region_upper_bound(
             region=region, var_dom=var_dom, predicate=predicate
         )
+    elif mode == "polyhedral":
+        result = tvm.arith.estimate_region_polyhedral_bound(
+            region=region, var_dom=var_dom, predicate=predicate
+        )
     else:
         result = tvm.arith.estimate_region_strict_bound(
             region=region, var_dom=var_dom, predicate=predicate
@@ -238,6 +242,25 @@ def test_region_bound_not_independent():
     )
 
 
+def test_region_polyhedral_bound():
+    # j ranges in [0, i], so i - j is in [0, 63] rather than [-63, 63]
+    i, j = tvm.tir.Var("i", "int32"), tvm.tir.Var("j", "int32")
+    var_dom = {
+        i: tvm.ir.Range(begin=0, end=64),
+        j: tvm.ir.Range.from_min_extent(0, i + 1),
+    }
+    check_region_bound({i - j: (0, 64), (i, i + 2): (0, 65)}, var_dom, mode="polyhedral")
+
+    # a causal mask given as the predicate
+    var_dom = {
+        i: tvm.ir.Range(begin=0, end=64),
+        j: tvm.ir.Range(begin=0, end=64),
+    }
+    check_region_bound({j - i: (0, 64)}, var_dom, predicate=i <= j, mode="polyhedral")
+    # the non-linear conditions are dropped
+    check_region_bound({(j, j + 4): (0, 67)}, var_dom, predicate=i * j < 8, mode="polyhedral")
+
+
 def test_region_bound_stride_too_wide():
     i = tvm.tir.Var("i", "int32")
     var_dom = {i: tvm.ir.Range(begin=0, end=64)}
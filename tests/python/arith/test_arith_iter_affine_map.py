@@ -1370,5 +1370,24 @@ def test_detect_iter_map_with_bufferload_recursion():
     assert len(result.indices) == 0
 
 
+def test_iter_map_cache():
+    x = tvm.tir.Var("x", "int32")
+    y = tvm.tir.Var("y", "int32")
+    dom = var_dom([(x, 3), (y, 4)])
+    with tvm.arith.IterMapCache() as cache:
+        first = tvm.arith.detect_iter_map([y * 3 + x], dom)
+        second = tvm.arith.detect_iter_map([y * 3 + x], dom)
+        failure = tvm.arith.detect_iter_map([y * 4 + x], dom)
+        assert len(tvm.arith.detect_iter_map([y * 4 + x], dom).indices) == 0
+    assert cache.num_hits == 2
+    assert cache.num_misses == 2
+    tvm.ir.assert_structural_equal(first.indices, second.indices)
+    assert not first.same_as(second)
+    assert len(failure.errors) > 0
+    # Out of its scope, the memo is not consulted.
+    tvm.arith.detect_iter_map([y * 3 + x], dom)
+    assert cache.num_hits == 2
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -1247,5 +1247,22 @@ class TestCLZ(BaseCompare):
     )
 
 
+def test_rewrite_rule_counters():
+    x = te.var("x", "int32")
+    y = te.var("y", "int32")
+    analyzer = tvm.arith.Analyzer()
+    analyzer.set_rewrite_rule_profiling_enabled(True)
+    tvm.ir.assert_structural_equal(analyzer.rewrite_simplify((x - y) + y), x)
+    counters = analyzer.rewrite_rule_counters
+    assert counters
+    assert sum(performed for _, performed in counters.values()) == 1
+    stats = analyzer.rewrite_simplify_stats
+    assert stats.rewrites_performed == 1
+    # The rules whose outermost patterns cannot match `(x - y) + y` are not attempted.
+    assert stats.rewrites_skipped > 0
+    analyzer.reset_rewrite_simplify_stats()
+    assert not analyzer.rewrite_rule_counters
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -156,5 +156,45 @@ def test_simplify_float_division():
     tvm.ir.assert_structural_equal(ry, sy)
 
 
+def test_memoized_simplify():
+    ana = tvm.arith.Analyzer()
+    ana.enable_memoization()
+    x = tir.Var("x", "int32")
+    y = tir.Var("y", "int32")
+    expr = (x * 4 + y * 4) // 4
+
+    tvm.ir.assert_structural_equal(ana.simplify(expr), x + y)
+    tvm.ir.assert_structural_equal(ana.simplify(expr), x + y)
+    stats = ana.memo_stats
+    assert stats["hits"] >= 1
+    assert stats["misses"] >= 1
+
+    # Binding a variable that the expression uses drops its result.
+    ana.reset_memo_stats()
+    ana.bind(y, 0)
+    tvm.ir.assert_structural_equal(ana.simplify(expr), x)
+    assert ana.memo_stats["invalidations"] >= 1
+
+
+def test_memoized_can_prove_in_constraint_scope():
+    ana = tvm.arith.Analyzer()
+    ana.enable_memoization()
+    x = tir.Var("x", "int32")
+    expr = x >= 0
+
+    assert not ana.can_prove(expr)
+    with ana.constraint_scope(x > 4):
+        # Results outside of the scope are not reused under the constraint.
+        assert ana.can_prove(expr)
+        assert ana.can_prove(expr)
+    assert not ana.can_prove(expr)
+    assert ana.memo_stats["invalidations"] >= 1
+
+    ana.enable_memoization(False)
+    ana.reset_memo_stats()
+    assert not ana.can_prove(expr)
+    assert ana.memo_stats == {"hits": 0, "misses": 0, "invalidations": 0}
+
+
 if __name__ == "__main__":
     tvm.testing.main()
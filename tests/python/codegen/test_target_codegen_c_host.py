@@ -196,5 +196,33 @@ def test_subroutine_call():
     ), "Expected three occurrences, for forward-declaration, definition, and call from main."
 
 
+def test_direct_call():
+    @I.ir_module
+    class mod:
+        @T.prim_func
+        def run(A: T.Buffer(1024, "float32"), B: T.Buffer(1024, "float32")):
+            T.func_attr({"global_symbol": "run"})
+            workspace = T.alloc_buffer(1024, "float32")
+            mod.scale(A.data, workspace.data)
+            mod.scale(workspace.data, B.data)
+
+        @T.prim_func
+        def scale(X: T.Buffer(1024, "float32"), Y: T.Buffer(1024, "float32")):
+            T.func_attr({"global_symbol": "scale"})
+            for i in range(1024):
+                Y[i] = X[i] * T.float32(2)
+
+    with tvm.transform.PassContext(config={"tir.direct_call": True}):
+        built = tvm.tir.build(mod, target="c")
+
+    source = built.inspect_source()
+    # The kernels are called directly, without packing their arguments.
+    assert "TVMFFIAny" not in source
+    assert source.count("scale(") >= 3, "Expected the definition and two calls."
+    # The workspace above the stack allocation limit is planned statically.
+    assert "TVMBackendAllocWorkspace" not in source
+    assert "static float workspace" in source
+
+
 if __name__ == "__main__":
     tvm.testing.main()
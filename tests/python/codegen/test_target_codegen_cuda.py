@@ -804,6 +804,41 @@ extern "C" __global__ void __launch_bounds__(128) main_kernel(float* __restrict_
     )
 
 
+@tvm.testing.requires_cuda
+@tvm.testing.requires_cuda_compute_version(9)
+def test_cuda_thread_block_cluster():
+    @T.prim_func
+    def main(A: T.Buffer((8, 128), "float32"), B: T.Buffer((8, 128), "float32")):
+        for bx in T.thread_binding(4, thread="blockIdx.x"):
+            for cx in T.thread_binding(2, thread="clusterIdx.x"):
+                for tx in T.thread_binding(128, thread="threadIdx.x"):
+                    S = T.alloc_buffer((128,), "float32", scope="shared.cluster")
+                    S[tx] = A[bx * 2 + cx, tx]
+                    T.tvm_storage_sync("shared.cluster")
+                    # Read the shared memory of the other block of the cluster.
+                    peer_data: T.handle("float32", "shared.cluster") = T.ptx_map_shared_rank(
+                        S.data, 1 - cx
+                    )
+                    peer = T.decl_buffer((128,), "float32", data=peer_data, scope="shared.cluster")
+                    B[bx * 2 + cx, tx] = peer[tx]
+                    T.tvm_storage_sync("shared.cluster")
+
+    lib = tvm.compile(tvm.IRModule({"main": main}), target="cuda")
+    cuda_code = lib.mod.imports[0].inspect_source()
+    assert "tvm_clusterid_x()" in cuda_code
+    assert "tvm_cluster_ctaid_x()" in cuda_code
+    assert "barrier.cluster.arrive.aligned" in cuda_code
+    assert "tvm_cluster_map_shared_rank(S" in cuda_code
+
+    dev = tvm.cuda(0)
+    a_np = np.random.uniform(size=(8, 128)).astype("float32")
+    a = tvm.runtime.tensor(a_np, dev)
+    b = tvm.runtime.empty((8, 128), "float32", dev)
+    lib(a, b)
+    # The blocks of each cluster of two swap their rows.
+    tvm.testing.assert_allclose(b.numpy(), a_np.reshape(4, 2, 128)[:, ::-1].reshape(8, 128))
+
+
 @tvm.testing.requires_cuda
 def test_cuda_device_func_call():
     @I.ir_module
@@ -935,5 +970,36 @@ def test_cuda_loop_step():
     tvm.testing.assert_allclose(c_nd.numpy(), a_np + b_np)
 
 
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_cuda_prefetch_modules_with_cubin_cache(tmp_path, monkeypatch):
+    monkeypatch.setenv("TVM_CACHE_DIR", str(tmp_path))
+    tvm.register_global_func(
+        "tvm_callback_cuda_compile",
+        lambda code, target: tvm.contrib.nvcc.compile_cuda(code, target_format="ptx"),
+        override=True,
+    )
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+    sch = tvm.tir.Schedule(te.create_prim_func([A, B]))
+    xo, xi = sch.split(sch.get_loops("B")[0], factors=[None, 128])
+    sch.bind(xo, "blockIdx.x")
+    sch.bind(xi, "threadIdx.x")
+
+    dev = tvm.cuda(0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    prefetch = tvm.get_global_func("runtime.cuda.PrefetchModules")
+    for _ in range(2):
+        # The second module loads the PTX from the cubin cache the first one fills.
+        fun = tvm.compile(sch.mod, target="cuda")
+        prefetch(fun, [0])
+        assert list((tmp_path / "cuda_cubin").glob("*/*.cubin"))
+        a = tvm.runtime.tensor(a_np, dev)
+        b = tvm.runtime.empty((n,), "float32", dev)
+        fun(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np * 2)
+
 if __name__ == "__main__":
     tvm.testing.main()
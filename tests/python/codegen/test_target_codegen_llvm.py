@@ -1121,6 +1121,34 @@ def test_invalid_volatile_masked_buffer_store():
             tvm.compile(func)
 
 
+@tvm.testing.requires_llvm
+def test_llvm_masked_gather_scatter():
+    @T.prim_func
+    def func(a: T.handle, b: T.handle):
+        T.func_attr({"tir.noalias": True})
+        A = T.match_buffer(a, (8,), "float32")
+        B = T.match_buffer(b, (8,), "float32")
+        B.vstore(
+            [T.Ramp(1, 2, 4)],
+            A.vload([T.Ramp(0, 2, 4)], predicate=T.get_active_lane_mask("uint1x4", 0, 3)),
+            predicate=T.get_active_lane_mask("uint1x4", 0, 3),
+        )
+
+    f = tvm.compile(func, target="llvm")
+    ll = f.inspect_source("ll")
+    assert "masked.gather" in ll
+    assert "masked.scatter" in ll
+
+    dev = tvm.cpu()
+    a_np = np.arange(8).astype("float32")
+    a = tvm.runtime.tensor(a_np, dev)
+    b = tvm.runtime.tensor(np.zeros(8, "float32"), dev)
+    f(a, b)
+    b_np = np.zeros(8, "float32")
+    b_np[[1, 3, 5]] = a_np[[0, 2, 4]]
+    tvm.testing.assert_allclose(b.numpy(), b_np)
+
+
 def test_int_parameter():
     """Boolean may be passed to functions accepting int"""
 
@@ -1197,5 +1225,102 @@ def test_invalid_arguments():
         built(False, tvm.runtime.empty([11], "float32"))
 
 
+@tvm.testing.requires_llvm
+def test_llvm_codegen_partitions():
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def fadd(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+            for i in range(16):
+                B[i] = A[i] + T.float32(1)
+
+        @T.prim_func
+        def fmul(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+            for i in range(16):
+                B[i] = A[i] * T.float32(2)
+
+        @T.prim_func
+        def fcall(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+            Module.subroutine(A.data, B.data)
+
+        @T.prim_func(private=True)
+        def subroutine(A_data: T.handle("float32"), B_data: T.handle("float32")):
+            A = T.decl_buffer(16, dtype="float32", data=A_data)
+            B = T.decl_buffer(16, dtype="float32", data=B_data)
+            for i in range(16):
+                B[i] = A[i] - T.float32(1)
+
+    with tvm.transform.PassContext(config={"target.llvm.num_codegen_partitions": 4}):
+        built = tvm.compile(Module, target="llvm")
+
+    dev = tvm.cpu(0)
+    a = tvm.runtime.tensor(np.random.uniform(size=16).astype("float32"), dev)
+    expected = {"fadd": a.numpy() + 1, "fmul": a.numpy() * 2, "fcall": a.numpy() - 1}
+    for name, expected_b in expected.items():
+        b = tvm.runtime.empty((16,), "float32", dev)
+        built[name](a, b)
+        tvm.testing.assert_allclose(b.numpy(), expected_b)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_orcjit_object_cache(tmp_path):
+    from tvm.target import codegen
+
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def main(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                B[i] = A[i] + T.float32(1)
+
+    prev_cache_dir = codegen.llvm_jit_cache_get_dir()
+    codegen.llvm_jit_cache_set_dir(str(tmp_path))
+    codegen.llvm_jit_cache_reset_stats()
+    try:
+        dev = tvm.cpu(0)
+        a = tvm.runtime.tensor(np.random.uniform(size=16).astype("float32"), dev)
+        for _ in range(2):
+            b = tvm.runtime.empty((16,), "float32", dev)
+            tvm.compile(Module, target="llvm -jit=orcjit")(a, b)
+            tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+        stats = codegen.llvm_jit_cache_get_stats()
+        assert stats == {"hits": 1, "misses": 1, "stores": 1}
+        assert len(list(tmp_path.glob("*.o"))) == 1
+    finally:
+        codegen.llvm_jit_cache_set_dir(prev_cache_dir)
+        codegen.llvm_jit_cache_reset_stats()
+
+
+@tvm.testing.requires_llvm
+def test_llvm_large_constants():
+    weights = np.arange(1024).astype("float32")
+
+    @T.prim_func
+    def main(A: T.Buffer((1024,), "float32"), B: T.Buffer((1024,), "float32")):
+        K_data = T.allocate_const(weights.tolist(), "float32", [1024])
+        K = T.Buffer(shape=(1024,), dtype="float32", data=K_data)
+        for i in range(1024):
+            B[i] = A[i] + K[i]
+
+    target = "llvm -mtriple=x86_64-linux-gnu"
+    with tvm.transform.PassContext(config={"target.llvm.large_constants_threshold": 4096}):
+        ll = tvm.tir.build(main, target=target).inspect_source("ll")
+    assert 'section ".lrodata.tvm"' in ll
+    assert "align 4096" in ll
+
+    # Constants below the threshold stay in the default section.
+    with tvm.transform.PassContext(config={"target.llvm.large_constants_threshold": 8192}):
+        ll = tvm.tir.build(main, target=target).inspect_source("ll")
+    assert ".lrodata.tvm" not in ll
+
+    with tvm.transform.PassContext(config={"target.llvm.large_constants_threshold": 4096}):
+        f = tvm.tir.build(main, target="llvm")
+    dev = tvm.cpu(0)
+    a = tvm.runtime.tensor(np.random.uniform(size=1024).astype("float32"), dev)
+    b = tvm.runtime.empty((1024,), "float32", dev)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + weights)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -16,6 +16,7 @@
 # under the License.
 import re
 
+import numpy as np
 import tvm
 import tvm.testing
 from tvm import te
@@ -221,6 +222,34 @@ def test_opencl_ceil_log2(target):
     _check(target, 32, "float32")
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_opencl
+def test_opencl_program_binary_cache_and_async_host_copy(monkeypatch, tmp_path):
+    monkeypatch.setenv("TVM_CACHE_DIR", str(tmp_path))
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    sch = tvm.tir.Schedule(te.create_prim_func([A, B]))
+    (x,) = sch.get_loops(sch.get_block("B"))
+    sch.bind(x, "threadIdx.x")
+
+    dev = tvm.opencl(0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    set_async_host_copy = tvm.get_global_func("device_api.opencl.set_async_host_copy")
+    set_async_host_copy(True)
+    try:
+        # The second module loads its program from the binary cached by the first one.
+        for _ in range(2):
+            fun = tvm.tir.build(sch.mod, target=target)
+            a = tvm.runtime.tensor(a_np, dev)
+            b = tvm.runtime.empty((n,), "float32", dev)
+            fun(a, b)
+            tvm.testing.assert_allclose(b.numpy(), a_np + 1.0)
+    finally:
+        set_async_host_copy(False)
+    assert list((tmp_path / "opencl_binary").glob("*.bin"))
+
+
 def _get_maximum_kernel_args(source):
     def get_kernel_args(source):
         import re
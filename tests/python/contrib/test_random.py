@@ -184,9 +184,23 @@ def test_random_fill_mt():
     assert no_exception_happened
 
 
+def test_random_fill_for_measure_covers_tail():
+    """Check the parallel fill reaches the last elements when the size is not a multiple of the
+    number of tasks."""
+    if not tvm.get_global_func("tvm.contrib.random.random_fill_for_measure", True):
+        print("skip because extern function is not available")
+        return
+    random_fill = tvm.get_global_func("tvm.contrib.random.random_fill_for_measure")
+    for dtype in ["int8", "float16", "float32", "int64"]:
+        value = tvm.runtime.empty((1021, 7), dtype, tvm.cpu())
+        random_fill(value)
+        assert np.count_nonzero(value.numpy()) == 1021 * 7
+
+
 if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
     test_random_fill()
     test_random_fill_mt()
+    test_random_fill_for_measure_covers_tail()
@@ -92,6 +92,43 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def test_argsort_radix_stable():
+    """Tests the radix sort path of argsort on large rows with many equal keys"""
+    argsort = tvm.get_global_func("tvm.contrib.sort.argsort")
+    dev = tvm.cpu(0)
+    for dtype in ["float32", "float64", "int32", "int64", "float16"]:
+        for shape, axis in [((4, 3000), 1), ((1, 200000), 1), ((3000, 8), 0)]:
+            np_data = np.random.randint(-50, 50, size=shape).astype(dtype)
+            for is_ascend in [True, False]:
+                keys = np_data if is_ascend else -np_data
+                np_out = np.argsort(keys, axis=axis, kind="stable").astype("int32")
+                a = tvm.runtime.tensor(np_data, dev)
+                c = tvm.runtime.tensor(np.zeros(shape, dtype="int32"), dev)
+                argsort(a, c, axis, is_ascend)
+                np.testing.assert_array_equal(c.numpy(), np_out)
+
+
+def test_topk_select():
+    """Tests the heap and the selection paths of topk"""
+    topk = tvm.get_global_func("tvm.contrib.sort.topk")
+    dev = tvm.cpu(0)
+    np_data = np.random.randint(0, 100, size=(16, 5000)).astype("float32")
+    for k in [5, 300]:
+        for is_ascend in [True, False]:
+            keys = np_data if is_ascend else -np_data
+            np_indices = np.argsort(keys, axis=1, kind="stable")[:, :k]
+            a = tvm.runtime.tensor(np_data, dev)
+            values = tvm.runtime.tensor(np.zeros((16, k), dtype="float32"), dev)
+            indices = tvm.runtime.tensor(np.zeros((16, k), dtype="int64"), dev)
+            topk(a, values, indices, k, 1, "both", is_ascend)
+            np.testing.assert_array_equal(indices.numpy(), np_indices)
+            np.testing.assert_array_equal(
+                values.numpy(), np.take_along_axis(np_data, np_indices, axis=1)
+            )
+
+
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_argsort_radix_stable()
+    test_topk_select()
@@ -24,6 +24,7 @@ import pytest
 
 import tvm.testing
 from tvm.contrib import tvmjs
+from tvm.script import ir as I, relax as R
 
 dtype = tvm.testing.parameter(
     "int8",
@@ -60,5 +61,90 @@ def test_save_load_float8(dtype):
     np.testing.assert_array_equal(arr, after_roundtrip)
 
 
+@I.ir_module
+class TransformModule:
+    @R.function
+    def transform_params(w0: R.Tensor((16, 16), "float32"), w1: R.Tensor((8, 4), "float32")):
+        with R.dataflow():
+            t0 = R.permute_dims(w0)
+            t1 = R.add(w1, w1)
+            t2 = R.multiply(w0, R.const(2, "float32"))
+            gv = (t0, t1, t2)
+            R.output(gv)
+        return gv
+
+
+@pytest.mark.parametrize("memory_cap_mb", [0, 64])
+def test_stream_transform_params(memory_cap_mb):
+    w0 = np.random.uniform(size=(16, 16)).astype("float32")
+    w1 = np.random.uniform(size=(8, 4)).astype("float32")
+    with tempfile.TemporaryDirectory(prefix="tvm_") as temp_dir:
+        cache_dir = f"{temp_dir}/params"
+        output_dir = f"{temp_dir}/transformed"
+        tvmjs.dump_tensor_cache(
+            {"w0": w0, "w1": w1}, cache_dir, encode_format="raw", show_progress=False
+        )
+        stats = tvmjs.stream_transform_params(
+            TransformModule,
+            cache_dir,
+            output_dir,
+            devices=[tvm.cpu(0), tvm.cpu(1)],
+            num_threads_per_device=2,
+            output_names=["t0", "t1", "t2"],
+            memory_cap_mb=memory_cap_mb,
+        )
+        transformed, _ = tvmjs.load_tensor_cache(output_dir, tvm.cpu())
+
+    assert stats["num_partitions"] == 3
+    assert stats["num_params"] == 3
+    np.testing.assert_allclose(transformed["t0"].numpy(), w0.T)
+    np.testing.assert_allclose(transformed["t1"].numpy(), w1 + w1)
+    np.testing.assert_allclose(transformed["t2"].numpy(), w0 * 2)
+    if memory_cap_mb == 0:
+        # Without room, an input is still held while its output is produced.
+        assert stats["peak_nbytes"] >= 2 * w0.nbytes
+
+
+def test_stream_transform_params_peak_covers_live_inputs():
+    @I.ir_module
+    class Module:
+        @R.function
+        def transform_params(w0: R.Tensor((16, 16), "float32"), w1: R.Tensor((16, 16), "float32")):
+            with R.dataflow():
+                gv = (R.add(w0, w1),)
+                R.output(gv)
+            return gv
+
+    w0 = np.random.uniform(size=(16, 16)).astype("float32")
+    w1 = np.random.uniform(size=(16, 16)).astype("float32")
+    with tempfile.TemporaryDirectory(prefix="tvm_") as temp_dir:
+        cache_dir = f"{temp_dir}/params"
+        output_dir = f"{temp_dir}/transformed"
+        tvmjs.dump_tensor_cache(
+            {"w0": w0, "w1": w1}, cache_dir, encode_format="raw", show_progress=False
+        )
+        stats = tvmjs.stream_transform_params(Module, cache_dir, output_dir, output_names=["w"])
+        transformed, _ = tvmjs.load_tensor_cache(output_dir, tvm.cpu())
+
+    np.testing.assert_allclose(transformed["w"].numpy(), w0 + w1)
+    # Both inputs are alive when their sum is appended to the output shard.
+    assert stats["peak_nbytes"] >= w0.nbytes + w1.nbytes + (w0 + w1).nbytes
+
+
+def test_stream_transform_params_tuple_needs_input_names():
+    @I.ir_module
+    class Module:
+        @R.function
+        def transform_params(params: R.Tuple(R.Tensor((4,), "float32"))):
+            R.func_attr({"relax.force_pure": True})
+            w = params[0]
+            gv = (R.add(w, w),)
+            return gv
+
+    with tempfile.TemporaryDirectory(prefix="tvm_") as temp_dir:
+        with pytest.raises(ValueError, match="input_names"):
+            tvmjs.stream_transform_params(Module, temp_dir, f"{temp_dir}/transformed")
+
+
 if __name__ == "__main__":
     tvm.testing.main()
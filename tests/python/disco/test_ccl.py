@@ -27,6 +27,7 @@ import tvm.testing
 from tvm import dlight as dl
 from tvm import get_global_func
 from tvm import relax as rx
+from tvm.runtime import ShapeTuple
 from tvm.runtime import disco as di
 from tvm.runtime.vm import VirtualMachine
 from tvm.script import relax as R
@@ -78,6 +79,26 @@ def test_allreduce(session_kind, ccl):
         np.testing.assert_equal(result, expected)
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("ccl", _ccl)
+def test_async_allreduce(session_kind, ccl):
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    array_1 = np.arange(12, dtype="float32").reshape(3, 4)
+    array_2 = np.arange(start=1, stop=-11, step=-1, dtype="float32").reshape(3, 4)
+    d_array = sess.empty((3, 4), "float32")
+    d_array.debug_copy_from(0, array_1)
+    d_array.debug_copy_from(1, array_2)
+    dst_array = sess.empty((3, 4), "float32")
+    allreduce_start = sess.get_global_func("runtime.disco.allreduce_start")
+    allreduce_wait = sess.get_global_func("runtime.disco.allreduce_wait")
+    allreduce_start(d_array, ShapeTuple([0]), True, dst_array)
+    result = allreduce_wait(dst_array, d_array)
+    np.testing.assert_equal(result.debug_get_from_remote(0).numpy(), array_1 + array_2)
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_group_allreduce(session_kind, ccl):
@@ -114,6 +135,42 @@ def test_group_allreduce(session_kind, ccl):
         np.testing.assert_equal(result_2, expected_2)
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("ccl", _ccl)
+@pytest.mark.parametrize("quantization", ["int8", "e4m3"])
+def test_allreduce_quantized(session_kind, ccl, quantization):
+    if ccl != "nccl":
+        pytest.skip("The quantized allreduce is only built with NCCL")
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    # The size is not a multiple of the quantization block, nor of the number of ranks.
+    shape = (7, 301)
+    rng = np.random.default_rng(0)
+    arrays = [rng.uniform(-1.0, 1.0, size=shape).astype("float32") for _ in devices]
+    d_array = sess.empty(shape, "float32")
+    for worker_id, array in enumerate(arrays):
+        d_array.debug_copy_from(worker_id, array)
+    # The inputs and then the partial sums are quantized with one scale per block. The values
+    # stay below num_ranks in magnitude, and each rounding is off by at most half an int8 step
+    # or by the relative precision of e4m3 at that magnitude.
+    step = 1.0 / 127 if quantization == "int8" else 1.0 / 8
+    atol = 2 * len(devices) * step
+    allreduce_quantized = sess.get_global_func("runtime.disco.allreduce_quantized")
+    for op, kind in [("sum", 0), ("avg", 4)]:
+        expected_array = sess.empty(shape, "float32")
+        sess.allreduce(d_array, expected_array, op=op)
+        dst_array = sess.empty(shape, "float32")
+        allreduce_quantized(d_array, ShapeTuple([kind]), False, quantization, dst_array)
+        expected = expected_array.debug_get_from_remote(0).numpy()
+        for worker_id in range(len(devices)):
+            result = dst_array.debug_get_from_remote(worker_id).numpy()
+            np.testing.assert_allclose(result, expected, rtol=0, atol=atol)
+        # The error is well below the bound on average, which catches a misplaced scale.
+        assert np.abs(result - expected).mean() < atol / 4
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_allgather(session_kind, ccl):
@@ -137,6 +194,35 @@ def test_allgather(session_kind, ccl):
     )
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("ccl", _ccl)
+def test_alltoall(session_kind, ccl):
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    array = np.arange(48, dtype="float32").reshape(2, 4, 6)
+    d_src = sess.empty((4, 6), "float32")
+    d_dst = sess.empty((4, 6), "float32")
+    d_src.debug_copy_from(0, array[0])
+    d_src.debug_copy_from(1, array[1])
+    sess.alltoall(d_src, d_dst)
+    # Worker i receives the split i of every worker.
+    for i in range(2):
+        np.testing.assert_equal(
+            d_dst.debug_get_from_remote(i).numpy(),
+            np.concatenate([array[0][i * 2 : i * 2 + 2], array[1][i * 2 : i * 2 + 2]]),
+        )
+
+    # Explicit splits covering part of the buffers, with 1 row for each worker.
+    sess.alltoall(d_src, d_dst, send_splits=[1, 1], recv_splits=[1, 1])
+    for i in range(2):
+        np.testing.assert_equal(
+            d_dst.debug_get_from_remote(i).numpy()[:2],
+            np.stack([array[0][i], array[1][i]]),
+        )
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_group_allgather(session_kind, ccl):
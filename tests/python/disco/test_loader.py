@@ -169,6 +169,49 @@ def test_load_shard():
         )
 
 
+def test_load_shard_leading_dim():
+    devices = [0, 1]
+    num_shards = len(devices)
+    param_dict = {
+        "x_0": np.random.uniform(size=[64, 128]).astype("float16"),
+        "x_1": np.random.uniform(size=[32, 128]).astype("float32"),
+    }
+    # Each worker reads its own rows of x_0 from disk, while x_1 is loaded and scattered by
+    # worker 0 through a generic shard function.
+    shard_info = {
+        "x_0": [
+            [
+                "runtime.disco.shard_leading_dim",
+                [(num_shards, 32, 128), "float16"],
+                num_shards,
+            ],
+        ],
+        "x_1": [
+            [
+                "tests.disco.shard_dim_0",
+                [(num_shards, 16, 128), "float32"],
+                num_shards,
+            ]
+        ],
+    }
+    with tempfile.TemporaryDirectory() as path:
+        sess = di.ThreadedSession(num_workers=len(devices))
+        sess.init_ccl("nccl", *devices)
+        loader = _create_loader(sess, path, param_dict, shard_info)
+        loader_load = sess.get_global_func("runtime.disco.ShardLoaderLoad")
+        d_0 = loader_load(loader, ShapeTuple([0]))
+        d_1 = loader_load(loader, ShapeTuple([1]))
+        for worker_id in range(num_shards):
+            np.testing.assert_equal(
+                param_dict["x_0"][worker_id * 32 : (worker_id + 1) * 32, :],
+                d_0.debug_get_from_remote(worker_id).numpy(),
+            )
+            np.testing.assert_equal(
+                param_dict["x_1"][worker_id * 16 : (worker_id + 1) * 16, :],
+                d_1.debug_get_from_remote(worker_id).numpy(),
+            )
+
+
 def _create_presharded_loader(sess, path):
     path_tensor_cache = path + "/tensor-cache.json"
     with open(path_tensor_cache, "r", encoding="utf-8") as i_f:
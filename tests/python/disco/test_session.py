@@ -117,7 +117,22 @@ def create_socket_session(num_workers):
     return _SOCKET_SESSION_TESTER.sess
 
 
-_all_session_kinds = [di.ThreadedSession, di.ProcessSession, create_socket_session]
+def create_shm_process_session(num_workers):
+    return di.ProcessSession(num_workers, channel="shm")
+
+
+def create_spin_threaded_session(num_workers):
+    return di.ThreadedSession(num_workers, queue="spin")
+
+
+_all_session_kinds = [
+    di.ThreadedSession,
+    create_spin_threaded_session,
+    di.ProcessSession,
+    create_socket_session,
+]
+if sys.platform.startswith("linux"):
+    _all_session_kinds.append(create_shm_process_session)
 
 
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
@@ -130,6 +145,24 @@ def test_int(session_kind):  # pylint: disable=invalid-name
         assert result.debug_get_from_remote(i) == 2
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_command_buffer(session_kind):
+    num_workers = 4
+    sess = session_kind(num_workers=num_workers)
+    func: di.DPackedFunc = sess.get_global_func("tests.disco.add_one")
+    (x,) = sess.begin_command_buffer(1)
+    # The intermediate register is released on the controller, but the command buffer keeps it
+    result: di.DRef = func(func(x))
+    command_buffer = sess.end_command_buffer()
+    for value in range(3):
+        sess.replay_command_buffer(command_buffer, value)
+        for i in range(num_workers):
+            assert result.debug_get_from_remote(i) == value + 2
+
+    with pytest.raises(ValueError):
+        sess.replay_command_buffer(command_buffer)
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 def test_float(session_kind):
     num_workers = 4
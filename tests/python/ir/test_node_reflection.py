@@ -204,5 +204,25 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+
+def test_binary_roundtrip():
+    dev = tvm.cpu(0)
+    np_data = np.random.rand(256).astype("float32")
+    x = tvm.tir.Var("x", dtype="int64")
+    node = {
+        "expr": x * 3 - tvm.tir.const(-(1 << 40), "int64"),
+        "float": tvm.tir.const(float("inf"), "float32"),
+        "names": ["layer", "layer", "a" * 100],
+        "tensor": tvm.runtime.tensor(np_data, device=dev),
+    }
+    data = tvm.ir.save_binary(node)
+    assert isinstance(data, bytes)
+    assert len(data) < len(tvm.ir.save_json(node))
+    node2 = tvm.ir.load_binary(data)
+    tvm.ir.assert_structural_equal(node, node2, map_free_vars=True)
+    np.testing.assert_array_equal(np_data, node2["tensor"].numpy())
+    with pytest.raises(Exception):
+        tvm.ir.load_binary(data[:-1])
+
 if __name__ == "__main__":
     tvm.testing.main()
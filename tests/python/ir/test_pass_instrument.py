@@ -19,7 +19,7 @@
 
 import tvm
 from tvm import relax
-from tvm.ir.instrument import PrintAfterAll, PrintBeforeAll
+from tvm.ir.instrument import PassResourceInstrument, PrintAfterAll, PrintBeforeAll
 from tvm.script import ir as I
 from tvm.script import relax as R
 from tvm.script import tir as T
@@ -61,3 +61,28 @@ def test_relax_print_all_passes(capsys):
     assert "Before Running Pass:" in all_passes_output
     assert "After Running Pass:" in all_passes_output
     assert "pass name: _pipeline" in all_passes_output
+
+
+def test_pass_resource_instrument():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "int32")):
+        for i in range(16):
+            A[i] = A[i] + (i * 4 + 8) // 4 - i - 2
+
+    mod = tvm.IRModule({"main": func})
+    seq = tvm.transform.Sequential([tvm.tir.transform.Simplify()], name="seq")
+    inst = PassResourceInstrument()
+    with tvm.transform.PassContext(instruments=[inst]):
+        seq(mod)
+        profiles = inst.profiles()
+        folded = inst.render_flame_graph("simplify_calls")
+
+    by_name = {p["name"]: p for p in profiles}
+    simplify = by_name["tir.Simplify"]
+    assert simplify["path"] == "seq;tir.Simplify"
+    assert simplify["depth"] == 1
+    assert simplify["simplify_calls"] > 0
+    assert simplify["alloc_objects"] > 0
+    assert simplify["nodes_after"] < simplify["nodes_before"]
+    assert by_name["seq"]["simplify_calls"] >= simplify["simplify_calls"]
+    assert f"seq;tir.Simplify {simplify['simplify_calls']}" in folded.splitlines()
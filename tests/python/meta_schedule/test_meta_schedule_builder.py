@@ -31,6 +31,7 @@ from tvm.meta_schedule.builder import (
     BuilderResult,
     LocalBuilder,
     PyBuilder,
+    ThreadedBuilder,
 )
 from tvm.runtime import Module
 from tvm.script import tir as T
@@ -220,6 +221,32 @@ def test_meta_schedule_error_handle_time_out():
         assert error_msg.startswith("LocalBuilder: Timeout")
 
 
+def test_meta_schedule_threaded_build():
+    """Test the builder that builds in the current process"""
+    builder = ThreadedBuilder(max_workers=2)
+    builder_inputs = [
+        BuilderInput(MatmulModule, Target("llvm")),
+        BuilderInput(MatmulReluModule, Target("llvm")),
+        BuilderInput(BatchMatmulModule, Target("llvm")),
+    ]
+    builder_results = builder.build(builder_inputs)
+    assert len(builder_results) == len(builder_inputs)
+    _check_build_results(builder_results)
+
+
+def test_meta_schedule_threaded_build_error():
+    """Test the error handing of the builder that builds in the current process"""
+
+    def test_build(mod: Module, target: Target, _) -> None:  # pylint: disable=unused-argument
+        raise ValueError("Builder intended Test Error (build func).")
+
+    builder = ThreadedBuilder(f_build=test_build)
+    builder_inputs = [BuilderInput(MatmulModule, Target("llvm"))]
+    (result,) = builder.build(builder_inputs)
+    assert result.artifact_path is None
+    assert result.error_msg.startswith("ThreadedBuilder: An exception occurred")
+
+
 def test_meta_schedule_missing_build_func():
     with pytest.raises(ValueError):
         LocalBuilder(f_build="wrong-name")
@@ -26,9 +26,10 @@ from typing import List
 import numpy as np
 import tvm
 import tvm.testing
-from tvm.meta_schedule.cost_model import PyCostModel, RandomModel, XGBModel
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.cost_model import GBDTModel, PyCostModel, RandomModel, XGBModel
 from tvm.meta_schedule.cost_model.xgb_model import PackSum, _get_custom_call_back
-from tvm.meta_schedule.feature_extractor import RandomFeatureExtractor
+from tvm.meta_schedule.feature_extractor import PyFeatureExtractor, RandomFeatureExtractor
 from tvm.meta_schedule.runner import RunnerResult
 from tvm.meta_schedule.search_strategy import MeasureCandidate
 from tvm.meta_schedule.tune_context import TuneContext
@@ -100,6 +101,58 @@ def test_meta_schedule_cost_model():
     assert results.shape == (10,)
 
 
+def test_meta_schedule_cost_model_pretrain():
+    updates = []
+
+    @derived_object
+    class RecordingCostModel(PyCostModel):
+        def load(self, path: str) -> None:
+            pass
+
+        def save(self, path: str) -> None:
+            pass
+
+        def update(
+            self,
+            context: TuneContext,
+            candidates: List[MeasureCandidate],
+            results: List[RunnerResult],
+        ) -> None:
+            updates.append((context, candidates, results))
+
+        def predict(self, context: TuneContext, candidates: List[MeasureCandidate]) -> np.ndarray:
+            return np.zeros(len(candidates))
+
+    target = tvm.target.Target("llvm --num-cores 4")
+    database = ms.database.MemoryDatabase()
+    workload = database.commit_workload(Matmul)
+    for factor, run_sec in [(4, 2.0), (8, 1.0), (16, None)]:
+        sch = Schedule(Matmul)
+        (i, _, _) = sch.get_loops(sch.get_block("matmul"))
+        sch.split(i, factors=[None, factor])
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                sch.trace,
+                workload,
+                None if run_sec is None else [run_sec],
+                target,
+                ms.arg_info.ArgInfo.from_prim_func(Matmul["main"]),
+            )
+        )
+
+    model = RecordingCostModel()
+    model.pretrain(database, num_threads=1)
+    # The record without measurements is skipped.
+    assert len(updates) == 1
+    context, candidates, results = updates[0]
+    assert str(context.target) == str(target)
+    tvm.ir.assert_structural_equal(context.mod, Matmul)
+    assert len(candidates) == 2
+    assert sorted(float(r.run_secs[0]) for r in results) == [1.0, 2.0]
+    for candidate in candidates:
+        assert len(candidate.sch.get_loops(candidate.sch.get_block("matmul"))) == 4
+
+
 def test_meta_schedule_cost_model_as_string():
     @derived_object
     class NotSoFancyCostModel(PyCostModel):
@@ -257,6 +310,91 @@ def test_meta_schedule_xgb_model_reupdate():
     model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
 
 
+def test_meta_schedule_gbdt_model():
+    extractor = RandomFeatureExtractor()
+    model = GBDTModel(extractor=extractor, num_trees=20, num_warmup_samples=2)
+    update_sample_count = 10
+    predict_sample_count = 100
+    model.update(
+        TuneContext(),
+        [_dummy_candidate() for i in range(update_sample_count)],
+        [_dummy_result() for i in range(update_sample_count)],
+    )
+    res = model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
+    assert res.shape == (predict_sample_count,)
+    assert np.isfinite(res).all()
+
+
+def test_meta_schedule_gbdt_model_learns_ranking():
+    @derived_object
+    class LinearFeatureExtractor(PyFeatureExtractor):
+        def __init__(self):
+            self.values: List[float] = []
+
+        def extract_from(
+            self,
+            context: TuneContext,  # pylint: disable = unused-argument
+            candidates: List[MeasureCandidate],
+        ) -> List[tvm.runtime.Tensor]:
+            assert len(candidates) == len(self.values)
+            return [
+                tvm.runtime.tensor(np.array([[v, 1.0 - v], [0.0, 0.0]], dtype="float64"))
+                for v in self.values
+            ]
+
+    extractor = LinearFeatureExtractor()
+    model = GBDTModel(extractor=extractor, num_trees=50, num_warmup_samples=0, seed=0)
+    values = list(np.linspace(0.0, 1.0, 32))
+    extractor.values = values
+    model.update(
+        TuneContext(),
+        [_dummy_candidate() for _ in values],
+        [RunnerResult([1.0 + 9.0 * v], None) for v in values],
+    )
+    extractor.values = [0.05, 0.5, 0.95]
+    res = model.predict(TuneContext(), [_dummy_candidate() for _ in extractor.values])
+    # The faster a candidate, the higher its score.
+    assert res[0] > res[1] > res[2]
+
+
+def test_meta_schedule_gbdt_model_no_feature():
+    model = GBDTModel(num_warmup_samples=0)
+    tune_ctx = TuneContext(
+        FullModule,
+        target="llvm --num-cores 16",
+        space_generator="post-order-apply",
+        search_strategy="evolutionary",
+    )
+    candidate = MeasureCandidate(Schedule(FullModule), [])
+    model.update(tune_ctx, [candidate], [_dummy_result()])
+    model.predict(tune_ctx, [candidate])
+
+
+def test_meta_schedule_gbdt_model_reload():
+    extractor = RandomFeatureExtractor()
+    model = GBDTModel(extractor=extractor, num_trees=20, num_warmup_samples=10)
+    update_sample_count = 20
+    predict_sample_count = 30
+    model.update(
+        TuneContext(),
+        [_dummy_candidate() for i in range(update_sample_count)],
+        [_dummy_result() for i in range(update_sample_count)],
+    )
+    with tempfile.NamedTemporaryFile() as path:
+        random_state = extractor.random_state  # save feature extractor's random state
+        model.save(path.name)
+        res1 = model.predict(
+            TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)]
+        )
+        new_model = GBDTModel(extractor=extractor, num_trees=20, num_warmup_samples=10)
+        new_model.load(path.name)
+        extractor.random_state = random_state  # load feature extractor's random state
+        res2 = new_model.predict(
+            TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)]
+        )
+    assert (res1 == res2).all()
+
+
 def test_meta_schedule_xgb_model_callback_as_function():
     # pylint: disable=import-outside-toplevel
     from itertools import chain as itertools_chain
@@ -16,6 +16,7 @@
 # under the License.
 # pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
 """Test Meta Schedule Database"""
+import json
 import os.path as osp
 import tempfile
 from typing import Callable, List, Optional
@@ -24,7 +25,7 @@ import pytest
 import tvm
 import tvm.testing
 from tvm import meta_schedule as ms
-from tvm import tir
+from tvm import te, tir
 from tvm.ir.module import IRModule
 from tvm.meta_schedule.database import TuningRecord, Workload
 from tvm.script import tir as T
@@ -582,6 +583,107 @@ def test_json_database_get_top_k(k, expected):
     assert result == expected
 
 
+def test_json_database_max_records_per_workload():
+    run_secs_list = [[1.5, 4.5], [], [0.0, 2.0], None, [2.0], [3.0, 1e10], [1e10]]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path_workload = osp.join(tmpdir, "workloads.json")
+        path_tuning_record = osp.join(tmpdir, "tuning_records.json")
+        database = ms.database.JSONDatabase(
+            path_workload, path_tuning_record, max_records_per_workload=2
+        )
+        assert call_get_top_k(run_secs_list, database, 5) == [[0.0, 2.0], [2.0]]
+        # Two valid and two invalid records stay in memory.
+        assert len(database) == 4
+        # The files keep every record, and the cap applies again on reload.
+        reloaded = ms.database.JSONDatabase(
+            path_workload, path_tuning_record, max_records_per_workload=1
+        )
+        workload = reloaded.commit_workload(Matmul)
+        top_k = reloaded.get_top_k(workload, 5)
+        assert [[v.value for v in r.run_secs] for r in top_k] == [[0.0, 2.0]]
+        unlimited = ms.database.JSONDatabase(path_workload, path_tuning_record)
+        assert len(unlimited) == len(run_secs_list)
+
+
+def test_json_database_duplicate_workloads():
+    with tempfile.TemporaryDirectory() as tmpdir_a, tempfile.TemporaryDirectory() as tmpdir_b:
+        call_get_top_k([[1.0], [3.0]], _create_tmp_database(tmpdir_a), 0)
+        call_get_top_k([[0.5], [2.0]], _create_tmp_database(tmpdir_b), 0)
+        # Concatenate both tables, so that the merged workload table lists Matmul twice.
+        with tempfile.TemporaryDirectory() as tmpdir:
+            tables = {}
+            for name in ["workloads.json", "tuning_records.json"]:
+                with open(osp.join(tmpdir_a, name)) as f_a, open(osp.join(tmpdir_b, name)) as f_b:
+                    tables[name] = (f_a.read().splitlines(), f_b.read().splitlines())
+            num_workloads_a = len(tables["workloads.json"][0])
+            records = list(tables["tuning_records.json"][0])
+            for line in tables["tuning_records.json"][1]:
+                workload_index, record = json.loads(line)
+                records.append(json.dumps([workload_index + num_workloads_a, record]))
+            with open(osp.join(tmpdir, "workloads.json"), "w") as f:
+                f.write("\n".join(sum(tables["workloads.json"], [])) + "\n")
+            with open(osp.join(tmpdir, "tuning_records.json"), "w") as f:
+                f.write("\n".join(records) + "\n")
+            expected = [[0.5], [1.0], [2.0], [3.0]]
+            database = _create_tmp_database(tmpdir)
+            assert call_get_top_k([], database, 5) == expected
+            # A workload committed after the duplicates is appended as a new line of the table.
+            workload = database.commit_workload(MatmulRelu)
+            record = ms.database.TuningRecord(
+                _create_schedule(MatmulRelu, lambda sch: None).trace,
+                workload,
+                [4.0],
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=MatmulRelu["main"]),
+            )
+            database.commit_tuning_record(record)
+            reloaded = _create_tmp_database(tmpdir)
+            assert call_get_top_k([], reloaded, 5) == expected
+            top_k = reloaded.get_top_k(reloaded.commit_workload(MatmulRelu), 5)
+            assert [[v.value for v in r.run_secs] for r in top_k] == [[4.0]]
+
+
+@pytest.mark.parametrize(
+    "k,expected",
+    [
+        (0, []),
+        (4, [[0.0, 2.0], [2.0], [1.5, 4.5], [3.0, 1e10]]),
+        (5, [[0.0, 2.0], [2.0], [1.5, 4.5], [3.0, 1e10]]),
+    ],
+)
+def test_binary_database_get_top_k(k, expected):
+    run_secs_list = [[1.5, 4.5], [], [0.0, 2.0], None, [2.0], [3.0, 1e10], [1e10]]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = ms.database.BinaryDatabase(osp.join(tmpdir, "database.bin"))
+        result = call_get_top_k(run_secs_list, database, k)
+        assert result == expected
+        # Reloading decodes the records lazily and gives the same answer.
+        reloaded = ms.database.BinaryDatabase(database.path)
+        assert len(reloaded) == len(run_secs_list)
+        assert reloaded.has_workload(Matmul)
+        workload = reloaded.commit_workload(Matmul)
+        top_k = reloaded.get_top_k(workload, k)
+        assert [[v.value for v in r.run_secs] for r in top_k] == expected
+
+
+def test_binary_database_from_json():
+    run_secs_list = [[1.5, 4.5], [], [0.0, 2.0], None, [2.0], [3.0, 1e10], [1e10]]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        json_database = _create_tmp_database(tmpdir)
+        expected = call_get_top_k(run_secs_list, json_database, 5)
+        database = ms.database.BinaryDatabase.from_json(
+            json_database.path_workload,
+            json_database.path_tuning_record,
+            osp.join(tmpdir, "database.bin"),
+        )
+        assert len(database) == len(run_secs_list)
+        workload = database.commit_workload(Matmul)
+        top_k = database.get_top_k(workload, 5)
+        assert [[v.value for v in r.run_secs] for r in top_k] == expected
+        record = database.query_tuning_record(Matmul, tvm.target.Target("llvm"), "main")
+        _equal_record(record, top_k[0])
+
+
 def MatmulPrimFunc() -> IRModule:
     return Matmul
 
@@ -603,5 +705,170 @@ def test_memory_database_commit_workload(f_mod, mod_eq):
     database.commit_workload(mod)
 
 
+def test_remote_database_share_records():
+    backing = ms.database.MemoryDatabase()
+    server = ms.database.DatabaseServer(backing, host="127.0.0.1")
+    try:
+        db_a = ms.database.RemoteDatabase("127.0.0.1", server.port, commit_batch_size=1)
+        db_b = ms.database.RemoteDatabase("127.0.0.1", server.port, pull_interval_sec=0.0)
+        workload = db_a.commit_workload(Matmul)
+        record = ms.database.TuningRecord(
+            _create_schedule(Matmul, _schedule_matmul).trace,
+            workload,
+            [1.5, 2.5, 1.8],
+            tvm.target.Target("llvm"),
+            ms.arg_info.ArgInfo.from_prim_func(func=Matmul["main"]),
+        )
+        db_a.commit_tuning_record(record)
+        assert len(backing) == 1
+        assert db_b.has_workload(Matmul)
+        (ret,) = db_b.get_top_k(db_b.commit_workload(Matmul), 3)
+        _equal_record(ret, record)
+        assert len(db_b) == 1
+    finally:
+        server.stop()
+
+
+
+def test_json_database_compact():
+    def _schedule_matmul_k(k_factor: int):
+        def _schedule(sch: Schedule):
+            (_, _, k) = sch.get_loops(block=sch.get_block("matmul"))
+            sch.split(loop=k, factors=[None, k_factor])
+
+        return _schedule
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = _create_tmp_database(tmpdir)
+        workload = database.commit_workload(Matmul)
+        target = Target("llvm")
+        for k_factor, run_secs in [(2, [3.0]), (4, [1.0]), (8, [2.0]), (4, [1.5]), (16, [])]:
+            database.commit_tuning_record(
+                ms.database.TuningRecord(
+                    _create_schedule(Matmul, _schedule_matmul_k(k_factor)).trace,
+                    workload,
+                    run_secs,
+                    target,
+                    ms.arg_info.ArgInfo.from_prim_func(func=Matmul["main"]),
+                )
+            )
+        assert len(database) == 5
+        # the record without a run time and the slower record of k_factor=4 also go
+        assert database.compact(top_k=2) == 3
+        for db in [database, _create_tmp_database(tmpdir)]:
+            records = db.get_top_k(db.commit_workload(Matmul), 5)
+            assert [float(r.run_secs[0]) for r in records] == [1.0, 2.0]
+            assert len(db) == 2
+        assert not osp.exists(osp.join(tmpdir, "tuning_records.json.tmp"))
+        with pytest.raises(ValueError):
+            database.compact(top_k=0)
+
+
+def _create_matmul(n: int) -> IRModule:
+    a = te.placeholder((n, n), name="A")
+    b = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    c = te.compute((n, n), lambda i, j: te.sum(a[i, k] * b[k, j], axis=k), name="matmul")
+    return IRModule({"main": te.create_prim_func([a, b, c])})
+
+
+def _schedule_matmul_sampled(sch: Schedule):
+    block = sch.get_block("matmul")
+    i, j, k = sch.get_loops(block=block)
+    i_tiles = sch.sample_perfect_tile(i, n=4, decision=[1, 1, 2, 512])
+    j_tiles = sch.sample_perfect_tile(j, n=4, decision=[1, 512, 1, 2])
+    k_tiles = sch.sample_perfect_tile(k, n=2, decision=[256, 4])
+    i_0, i_1, i_2, i_3 = sch.split(loop=i, factors=i_tiles)
+    j_0, j_1, j_2, j_3 = sch.split(loop=j, factors=j_tiles)
+    k_0, k_1 = sch.split(loop=k, factors=k_tiles)
+    sch.reorder(i_0, j_0, i_1, j_1, k_0, i_2, j_2, k_1, i_3, j_3)
+
+
+def test_nearest_neighbor_database_transfer():
+    target = tvm.target.Target("llvm")
+    tuned = _create_matmul(1024)
+    database = ms.database.MemoryDatabase()
+    database.commit_tuning_record(
+        ms.database.TuningRecord(
+            _create_schedule(tuned, _schedule_matmul_sampled).trace,
+            database.commit_workload(tuned),
+            [1.0],
+            target,
+            ms.arg_info.ArgInfo.from_prim_func(func=tuned["main"]),
+        )
+    )
+    nn_db = ms.database.NearestNeighborDatabase(database, k=2)
+    # A tuned workload is answered by the underlying database.
+    record = nn_db.query_tuning_record(tuned, target, "main")
+    assert record is not None and len(record.run_secs) == 1
+    # An unseen shape gets the tuned schedule with its tiles fitted to the new extents.
+    sch = nn_db.query_schedule(_create_matmul(768), target, "main")
+    assert sch is not None
+    decisions = [
+        [int(x) for x in sch.trace.decisions[inst]]
+        for inst in sch.trace.insts
+        if inst.kind.name == "SamplePerfectTile"
+    ]
+    assert decisions == [[1, 1, 2, 384], [1, 384, 1, 2], [192, 4]]
+    record = nn_db.query_tuning_record(_create_matmul(768), target, "main")
+    assert record is not None and record.run_secs is None
+    assert len(nn_db) == 1
+    # A workload without a matching anchor block is not answered.
+    a = te.placeholder((768, 768), name="A")
+    relu = te.compute((768, 768), lambda i, j: te.max(a[i, j], 0.0), name="relu")
+    elemwise = IRModule({"main": te.create_prim_func([a, relu])})
+    assert nn_db.query_schedule(elemwise, target, "main") is None
+
+def test_anchor_block_database_transfer():
+    target = tvm.target.Target("llvm")
+    tuned = _create_matmul(1024)
+    database = ms.database.MemoryDatabase()
+    workload = database.commit_workload(tuned)
+
+    def _schedule_matmul_fast(sch: Schedule):
+        block = sch.get_block("matmul")
+        i, j, k = sch.get_loops(block=block)
+        i_tiles = sch.sample_perfect_tile(i, n=4, decision=[4, 8, 2, 16])
+        j_tiles = sch.sample_perfect_tile(j, n=4, decision=[8, 4, 2, 16])
+        k_tiles = sch.sample_perfect_tile(k, n=2, decision=[128, 8])
+        i_0, i_1, i_2, i_3 = sch.split(loop=i, factors=i_tiles)
+        j_0, j_1, j_2, j_3 = sch.split(loop=j, factors=j_tiles)
+        k_0, k_1 = sch.split(loop=k, factors=k_tiles)
+        sch.reorder(i_0, j_0, i_1, j_1, k_0, i_2, j_2, k_1, i_3, j_3)
+
+    for f_sch, run_secs in [(_schedule_matmul_sampled, 2.0), (_schedule_matmul_fast, 1.0)]:
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                _create_schedule(tuned, f_sch).trace,
+                workload,
+                [run_secs],
+                target,
+                ms.arg_info.ArgInfo.from_prim_func(func=tuned["main"]),
+            )
+        )
+    anchor_db = ms.database.AnchorBlockDatabase(database)
+    # The same matmul with a fused relu gets the fastest record of the matmul.
+    a = te.placeholder((1024, 1024), name="A")
+    b = te.placeholder((1024, 1024), name="B")
+    k = te.reduce_axis((0, 1024), name="k")
+    c = te.compute((1024, 1024), lambda i, j: te.sum(a[i, k] * b[k, j], axis=k), name="matmul")
+    relu = te.compute((1024, 1024), lambda i, j: te.max(c[i, j], 0.0), name="relu")
+    fused = IRModule({"main": te.create_prim_func([a, b, relu])})
+    assert not database.has_workload(fused)
+    sch = anchor_db.query_schedule(fused, target, "main")
+    assert sch is not None
+    decisions = [
+        [int(x) for x in sch.trace.decisions[inst]]
+        for inst in sch.trace.insts
+        if inst.kind.name == "SamplePerfectTile"
+    ]
+    assert decisions == [[4, 8, 2, 16], [8, 4, 2, 16], [128, 8]]
+    record = anchor_db.query_tuning_record(fused, target, "main")
+    assert record is not None and record.run_secs is None
+    assert len(anchor_db) == 2
+    # A matmul of another shape has another anchor block.
+    assert anchor_db.query_schedule(_create_matmul(512), target, "main") is None
+
+
 if __name__ == "__main__":
     tvm.testing.main()
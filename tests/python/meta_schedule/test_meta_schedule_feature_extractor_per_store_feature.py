@@ -1632,5 +1632,54 @@ def test_negative_extent():
     assert named_features["B0.unique_bytes"] == 0
 
 
+def test_cached_features():
+    def _create_schedule():
+        sch = tir.Schedule(matmul, debug_mask="all")
+        i, _, _ = sch.get_loops(sch.get_block("C"))
+        sch.split(i, factors=[None, 16])
+        return sch
+
+    context = _make_context(tvm.target.Target("llvm"))
+    uncached = ms.feature_extractor.PerStoreFeature(cache_size=0)
+    (expected,) = uncached.extract_from(context, candidates=[_make_candidate(_create_schedule)])
+    extractor = ms.feature_extractor.PerStoreFeature(cache_size=1)
+    for _ in range(2):
+        (feature,) = extractor.extract_from(context, candidates=[_make_candidate(_create_schedule)])
+        assert_allclose(actual=feature.numpy(), desired=expected.numpy(), rtol=0, atol=0)
+    # Evicts the cached features of the split schedule.
+    (feature,) = extractor.extract_from(
+        context, candidates=[_make_candidate(lambda: tir.Schedule(matmul))]
+    )
+    assert feature.shape[1] == expected.shape[1]
+
+
+def test_texture_features():
+    a = te.placeholder((64, 32, 4), "float32", name="A")
+    b = te.placeholder((128, 32, 4), "float32", name="B")
+    k0 = te.reduce_axis((0, 32), name="k0")
+    k1 = te.reduce_axis((0, 4), name="k1")
+    c = te.compute(
+        (64, 128), lambda i, j: te.sum(a[i, k0, k1] * b[j, k0, k1], axis=[k0, k1]), name="C"
+    )
+
+    def _create_schedule():
+        sch = tir.Schedule(te.create_prim_func([a, b, c]), debug_mask="all")
+        sch.cache_read(sch.get_block("C"), 0, "global.texture-weight")
+        return sch
+
+    extractor = ms.feature_extractor.PerStoreFeature(extract_texture=True)
+    assert extractor.feature_vector_length == N_FEATURES + 3
+    (feature,) = extractor.extract_from(
+        _make_context(tvm.target.Target("opencl -device=adreno")),
+        candidates=[_make_candidate(_create_schedule)],
+    )
+    feature = feature.numpy()
+    assert feature.shape == (2, N_FEATURES + 3)
+    # The copy into the texture reads the global memory, the dense reads A through the texture.
+    texture_ratio = sorted(feature[:, -1])
+    assert texture_ratio[0] == 0
+    assert 0 < texture_ratio[1] < 1
+
+
 if __name__ == "__main__":
     tvm.testing.main()
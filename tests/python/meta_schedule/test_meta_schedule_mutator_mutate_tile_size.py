@@ -66,14 +66,27 @@ def _sch(decisions: List[List[int]]) -> Schedule:
     return sch
 
 
-def _make_mutator(target: Target) -> ms.Mutator:
+def _gpu_sch(decision: List[int]) -> Schedule:
+    sch = Schedule(matmul, debug_mask="all")
+    # pylint: disable=invalid-name
+    b0 = sch.get_block(name="C", func_name="main")
+    l1, _, _ = sch.get_loops(block=b0)
+    v2, v3, v4 = sch.sample_perfect_tile(loop=l1, n=3, max_innermost_factor=64, decision=decision)
+    l5, l6, _ = sch.split(loop=l1, factors=[v2, v3, v4])
+    sch.bind(loop=l5, thread_axis="blockIdx.x")
+    sch.bind(loop=l6, thread_axis="threadIdx.x")
+    # pylint: enable=invalid-name
+    return sch
+
+
+def _make_mutator(target: Target, mutator: ms.Mutator = None) -> ms.Mutator:
     ctx = ms.TuneContext(
         mod=matmul,
         target=target,
         space_generator=ms.space_generator.PostOrderApply(
             sch_rules=[],
             postprocs=[],
-            mutator_probs={ms.mutator.MutateTileSize(): 1.0},
+            mutator_probs={mutator or ms.mutator.MutateTileSize(): 1.0},
         ),
     )
     return list(ctx.space_generator.mutator_probs.keys())[0]
@@ -107,6 +120,43 @@ def test_mutate_sample_categorical_single_candidate():
     assert trace is None
 
 
+def test_mutate_tile_size_guided_thread_limit():
+    mutator = _make_mutator(
+        target=Target("cuda -max_threads_per_block=32 -max_shared_memory_per_block=49152"),
+        mutator=ms.mutator.MutateTileSizeGuided(),
+    )
+    sch = _gpu_sch(decision=[16, 32, 1])
+    results = set()
+    for _ in range(200):
+        trace = mutator.apply(sch.trace)
+        if trace is None:
+            continue
+        decision = [int(x) for x in trace.decisions[trace.insts[2]]]
+        # the mutations binding more than 32 threads are dropped before the postprocessors
+        assert decision[1] <= 32
+        results.add(str(decision))
+    assert len(results) > 3
+
+
+def test_mutate_tile_size_guided_by_scores():
+    mutator = _make_mutator(
+        target=Target("llvm --num-cores=16"),
+        mutator=ms.mutator.MutateTileSizeGuided(max_candidates=64, temperature=1e-3),
+    )
+    best = _sch(decisions=[[4, 32, 4, 1]])
+    worst = _sch(decisions=[[8, 16, 4, 1]])
+    mutator.notify_predicted_scores([best.trace, worst.trace], [1.0, 0.0])
+    num_best = 0
+    for _ in range(100):
+        trace = mutator.apply(worst.trace)
+        decision = [int(x) for x in trace.decisions[trace.insts[4]]]
+        num_best += decision == [4, 32, 4, 1]
+    # an unguided mutation of the worst trace yields the best tiles 1 time out of 27
+    assert num_best >= 50
+
+
 if __name__ == "__main__":
     test_mutate_tile_size_matmul()
     test_mutate_sample_categorical_single_candidate()
+    test_mutate_tile_size_guided_thread_limit()
+    test_mutate_tile_size_guided_by_scores()
@@ -457,6 +457,13 @@ def test_target_blocks_search_space():
             IRModule({"main": get_matmul_packed(128, 128, 128, "uint8", "uint8", "int32")}),
             "dot_4x4_u8u8i32_hdot",
         ),
+        (
+            Target(
+                "llvm -device=arm_cpu -mtriple=aarch64-linux-gnu -mattr=+neon,+v8.6a,+i8mm -num-cores 2"
+            ),
+            IRModule({"main": get_matmul_packed(128, 128, 128, "int8", "int8", "int32")}),
+            "mmla_2x2x8_i8i8s32_smmla",
+        ),
     ],
 )
 def test_meta_schedule_post_order_apply_arm_intrin(target, mod, expected_intr):
@@ -482,6 +489,47 @@ def test_meta_schedule_post_order_apply_arm_intrin(target, mod, expected_intr):
     assert any([expected_intr in str(sch.trace) for sch in schs])
 
 
+def test_meta_schedule_post_order_apply_resample_over_limits():
+    @derived_object
+    class SharedMemoryScheduleRule(PyScheduleRule):
+        def _initialize_with_tune_context(self, context: "TuneContext") -> None:
+            pass
+
+        def apply(self, sch: Schedule, block: BlockRV) -> List[Schedule]:
+            if _is_root(sch, block):
+                return [sch]
+            i, j, _ = sch.get_loops(block=block)
+            i_0, _ = sch.split(loop=i, factors=sch.sample_perfect_tile(loop=i, n=2))
+            _, j_1 = sch.split(loop=j, factors=sch.sample_perfect_tile(loop=j, n=2))
+            sch.bind(i_0, "blockIdx.x")
+            sch.bind(j_1, "threadIdx.x")
+            a_shared = sch.cache_read(block, 0, "shared")
+            sch.compute_at(a_shared, i_0)
+            return [sch]
+
+    target = Target("cuda -max_threads_per_block=64 -max_shared_memory_per_block=65536")
+    for _ in range(5):
+        context = TuneContext(
+            mod=Matmul,
+            target=target,
+            space_generator=PostOrderApply(
+                sch_rules=[SharedMemoryScheduleRule()],
+                postprocs=[],
+                mutator_probs={},
+                max_resamples=64,
+            ),
+        )
+        (sch,) = context.space_generator.generate_design_space(Matmul)
+        (_, i_1), (_, j_1) = [
+            [int(x) for x in sch.trace.decisions[inst]]
+            for inst in sch.trace.insts
+            if inst.kind.name == "SamplePerfectTile"
+        ]
+        # the shared copy of A takes i_1 * 1024 * 4 bytes
+        assert i_1 <= 16
+        assert j_1 <= 64
+
+
 def test_meta_schedule_derived_object():
     @derived_object
     class RemoveBlock(PyScheduleRule):
@@ -30,6 +30,7 @@ from tvm.meta_schedule.arg_info import TensorInfo
 from tvm.meta_schedule.builder import BuilderInput, LocalBuilder
 from tvm.meta_schedule.runner import (
     EvaluatorConfig,
+    InterleavedRunner,
     LocalRunner,
     PyRunner,
     RPCConfig,
@@ -205,6 +206,55 @@ def test_meta_schedule_rpc_single_run():
     _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_rpc_session_reuse():
+    """Test meta schedule rpc runner measuring on a kept session"""
+    mod = MatmulModule
+    builder = LocalBuilder()
+    (builder_result,) = builder.build([BuilderInput(mod, Target("llvm"))])
+    assert builder_result.error_msg is None
+    runner_input = RunnerInput(
+        builder_result.artifact_path,
+        "llvm",
+        [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)],
+    )
+
+    with LocalRPC() as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+        )
+        evaluator_config = EvaluatorConfig(
+            number=1,
+            repeat=1,
+            min_repeat_ms=0,
+            enable_cpu_cache_flush=False,
+        )
+        runner = RPCRunner(rpc_config, evaluator_config, session_reuse=True)
+        # The single server is held by the kept session of the single worker, so each run after
+        # the first measures on it, with the module cached by the server.
+        runner_results = []
+        for _ in range(3):
+            (runner_future,) = runner.run([runner_input])
+            runner_results.append(runner_future.result())
+    for runner_result in runner_results:
+        assert runner_result.error_msg is None
+        assert len(runner_result.run_secs) == 1
+    _clean_build(builder_result.artifact_path)
+
+
+def test_rpc_server_module_cache():
+    """Test the module cache of the rpc server"""
+    cached_module = tvm.get_global_func("tvm.rpc.server.cached_module")
+    cache_module = tvm.get_global_func("tvm.rpc.server.cache_module")
+    assert cached_module("test_rpc_server_module_cache") is None
+    rt_mod = tvm.tir.build(AddModule, target="llvm")
+    cache_module("test_rpc_server_module_cache", rt_mod)
+    assert cached_module("test_rpc_server_module_cache").same_as(rt_mod)
+
+
 def test_meta_schedule_local_single_run():
     """Test meta schedule local runner for a single run"""
     # Build the module
@@ -375,6 +425,38 @@ def test_meta_schedule_local_multiple_runs():
         _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_interleaved_multiple_runs():
+    """Test the runner that measures a batch in the current process"""
+    mods = [MatmulModule, MatmulReluModule, BatchMatmulModule]
+    builder = LocalBuilder()
+    builder_results = builder.build([BuilderInput(mod, Target("llvm")) for mod in mods])
+    matmul_args = [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)]
+    batch_matmul_args = [TensorInfo("float32", [16, MATMUL_M, MATMUL_M]) for _ in range(3)]
+    runner_inputs = [
+        RunnerInput(builder_results[0].artifact_path, "llvm", matmul_args),
+        RunnerInput(builder_results[1].artifact_path, "llvm", matmul_args),
+        RunnerInput(builder_results[2].artifact_path, "llvm", batch_matmul_args),
+        RunnerInput("/path/to/missing/artifact.tar", "llvm", matmul_args),
+    ]
+    evaluator_config = EvaluatorConfig(
+        number=1,
+        repeat=3,
+        min_repeat_ms=0,
+        enable_cpu_cache_flush=True,
+    )
+    runner = InterleavedRunner(evaluator_config=evaluator_config)
+    runner_results = [future.result() for future in runner.run(runner_inputs)]
+    for runner_result in runner_results[:3]:
+        assert runner_result.error_msg is None
+        assert len(runner_result.run_secs) == 3
+        for result in runner_result.run_secs:
+            assert result.value >= 0.0
+    assert runner_results[3].run_secs is None
+    assert runner_results[3].error_msg.startswith("InterleavedRunner: An exception occurred")
+    for builder_result in builder_results:
+        _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_py_runner():
     """Test meta schedule PyRunner"""
 
@@ -532,5 +532,54 @@ def test_inline_constant_scalars_skip_output_block():
     assert_structural_equal(sch.mod, Full)
 
 
+def test_inline_dequantize_into_gemm():
+    # fmt: off
+    @tvm.script.ir_module
+    class DecodeGEMM:
+        @T.prim_func
+        def main(A: T.Buffer((4, 4096), "float16"), Wq: T.Buffer((1024, 512), "uint32"), S: T.Buffer((1024, 32), "float16"), C: T.Buffer((4, 1024), "float16")):
+            W = T.alloc_buffer((1024, 4096), "float16")
+            for n, k in T.grid(1024, 4096):
+                with T.block("decode"):
+                    vn, vk = T.axis.remap("SS", [n, k])
+                    W[vn, vk] = (T.Cast("float16", T.bitwise_and(T.shift_right(Wq[vn, vk // 8], T.Cast("uint32", vk % 8 * 4)), T.uint32(15))) - T.float16(7)) * S[vn, vk // 128]
+            for i, n, k in T.grid(4, 1024, 4096):
+                with T.block("matmul"):
+                    vi, vn, vk = T.axis.remap("SSR", [i, n, k])
+                    with T.init():
+                        C[vi, vn] = T.float16(0)
+                    C[vi, vn] = C[vi, vn] + A[vi, vk] * W[vn, vk]
+    # fmt: on
+
+    sch = Schedule(DecodeGEMM)
+    sch = ms.schedule_rule.InlineDequantize().apply(sch, sch.get_block("decode"))[0]
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.get_block("decode")
+    matmul = sch.get(sch.get_block("matmul"))
+    assert {region.buffer.name for region in matmul.reads} == {"C", "A", "Wq", "S"}
+
+
+def test_inline_dequantize_skip_non_reduction_consumer():
+    # fmt: off
+    @tvm.script.ir_module
+    class DecodeAdd:
+        @T.prim_func
+        def main(Wq: T.Buffer((1024, 512), "uint32"), B: T.Buffer((1024, 4096), "float16"), C: T.Buffer((1024, 4096), "float16")):
+            W = T.alloc_buffer((1024, 4096), "float16")
+            for n, k in T.grid(1024, 4096):
+                with T.block("decode"):
+                    vn, vk = T.axis.remap("SS", [n, k])
+                    W[vn, vk] = T.Cast("float16", T.bitwise_and(T.shift_right(Wq[vn, vk // 8], T.Cast("uint32", vk % 8 * 4)), T.uint32(15)))
+            for n, k in T.grid(1024, 4096):
+                with T.block("add"):
+                    vn, vk = T.axis.remap("SS", [n, k])
+                    C[vn, vk] = W[vn, vk] + B[vn, vk]
+    # fmt: on
+
+    sch = Schedule(DecodeAdd)
+    sch = ms.schedule_rule.InlineDequantize().apply(sch, sch.get_block("decode"))[0]
+    assert_structural_equal(sch.mod, DecodeAdd)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,106 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm import te, tir
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.target import Target
+
+
+def _packed_dense(m, n, k, dtype="float32"):
+    # The reduction axis is packed by 4, as an image texel holds 4 channels.
+    a = te.placeholder((m, k // 4, 4), dtype, name="A")
+    b = te.placeholder((n, k // 4, 4), dtype, name="B")
+    k0 = te.reduce_axis((0, k // 4), name="k0")
+    k1 = te.reduce_axis((0, 4), name="k1")
+    c = te.compute(
+        (m, n), lambda i, j: te.sum(a[i, k0, k1] * b[j, k0, k1], axis=[k0, k1]), name="C"
+    )
+    return te.create_prim_func([a, b, c])
+
+
+def _texture_scopes(sch):
+    return [buf.scope() for buf in sch.mod["main"].body.block.alloc_buffers]
+
+
+def _design_space(func, target):
+    return generate_design_space(
+        kind="adreno",
+        mod=func,
+        target=Target(target),
+        types=None,
+        sch_rules=[ms.schedule_rule.CacheReadTexture()],
+    )
+
+
+def test_cache_read_texture():
+    actual = _design_space(_packed_dense(64, 128, 128), "opencl -device=adreno")
+    assert len(actual) == 2
+    scopes = sorted(_texture_scopes(sch) for sch in actual)
+    assert scopes == [[], ["global.texture-weight", "global.texture-weight"]]
+    texture = [sch for sch in actual if _texture_scopes(sch)][0]
+    assert "T.vectorized(4)" in texture.mod.script()
+
+
+def test_skip_unpacked_inputs():
+    # The texels of an image hold 4 channels of float16 or float32 only.
+    actual = _design_space(_packed_dense(64, 128, 128, "uint8"), "opencl -device=adreno")
+    assert len(actual) == 1
+    assert not _texture_scopes(actual[0])
+
+
+def test_skip_target_without_textures():
+    actual = _design_space(_packed_dense(64, 128, 128), "cuda")
+    assert len(actual) == 1
+    assert not _texture_scopes(actual[0])
+
+
+def test_default_rules():
+    rules = ms.ScheduleRule.create("adreno")
+    assert any(isinstance(rule, ms.schedule_rule.CacheReadTexture) for rule in rules)
+    postprocs = ms.Postproc.create("adreno")
+    assert any(isinstance(p, ms.postproc.VerifyTextureStorage) for p in postprocs)
+
+
+def test_verify_texture_storage():
+    def _verify(m, scope):
+        func = _packed_dense(m, 128, 128)
+        sch = tir.Schedule(func, debug_mask="all")
+        sch.cache_read(sch.get_block("C"), 0, scope)
+        ctx = ms.TuneContext(
+            mod=func,
+            target=Target("opencl -device=adreno"),
+            space_generator=ms.space_generator.PostOrderApply(
+                sch_rules=[],
+                postprocs=[ms.postproc.VerifyTextureStorage()],
+                mutator_probs={},
+            ),
+            task_name="test",
+        )
+        return ctx.space_generator.postprocs[0].apply(sch)
+
+    assert _verify(64, "global.texture-weight")
+    # The rows are beyond the texture_spatial_limit of 16384.
+    assert not _verify(32768, "global.texture-weight")
+    # They are spread over the depth, but also beyond the texture_depth_limit of 2048.
+    assert not _verify(32768, "global.texture-nhwc")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
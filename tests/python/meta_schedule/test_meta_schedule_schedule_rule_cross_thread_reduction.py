@@ -566,6 +566,58 @@ def test_gpu_batch_norm_bmn():
     )
 
 
+def test_gpu_batch_norm_bmn_grid_reduction():
+    mod = create_prim_func(te_workload.norm_bmn(B=1, M=512, N=512))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.CrossThreadReduction(
+                thread_extents=[32, 64, 128, 256], grid_reduction_min_extent=4096
+            )
+        ],
+    )
+    # the cross-thread reduction, the grid reduction, and the unchanged schedule
+    assert len(actual) == 3
+    grid_sch = actual[1]
+    insts = [inst.kind.name for inst in grid_sch.trace.insts]
+    assert insts.count("SampleCategorical") == 2
+    assert "RFactor" in insts
+
+    bindings = {}
+
+    def fvisit(stmt):
+        if isinstance(stmt, tvm.tir.Block):
+            loops = grid_sch.get_loops(grid_sch.get_block(stmt.name_hint))
+            bindings[stmt.name_hint] = [
+                grid_sch.get(loop).thread_binding.thread_tag
+                for loop in loops
+                if grid_sch.get(loop).thread_binding is not None
+            ]
+
+    tvm.tir.stmt_functor.post_order_visit(grid_sch.mod["main"].body, fvisit)
+    assert bindings["C_rf"] == ["blockIdx.x", "threadIdx.x"]
+    assert bindings["C"] == ["blockIdx.x", "threadIdx.x"]
+
+
+def test_grid_reduction_below_min_extent():
+    mod = create_prim_func(te_workload.norm_bmn(B=1, M=512, N=512))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.CrossThreadReduction(
+                thread_extents=[32, 64, 128, 256], grid_reduction_min_extent=1 << 20
+            )
+        ],
+    )
+    assert len(actual) == 2
+
+
 @T.prim_func
 def argmax(
     idx: T.Buffer((128, 128), "int32"),
@@ -761,5 +813,7 @@ if __name__ == "__main__":
     test_gpu_softmax_mn()
     test_gpu_softmax_mn_after_inline()
     test_gpu_batch_norm_bmn()
+    test_gpu_batch_norm_bmn_grid_reduction()
+    test_grid_reduction_below_min_extent()
     test_gpu_argmax()
     test_gpu_argmax_32()
@@ -625,6 +625,36 @@ def test_multi_level_tiling_hexagon():
     )
 
 
+def test_multi_level_tiling_hexagon_vtcm_dma():
+    target_hexagon = target.hexagon("v69", num_cores=4)
+    mod = te.create_prim_func(
+        te_workload.matmul(512, 512, 512, in_dtype="float16", out_dtype="float16")
+    )
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target(target_hexagon, host=target_hexagon),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.MultiLevelTilingWideVector(
+                structure="SRSRS",
+                vector_length_in_bits=1024,
+                max_innermost_factor=64,
+                reuse_read={"req": "may", "levels": [2], "scope": "global.vtcm"},
+                reuse_write=None,
+            )
+        ],
+    )
+    # Reading in place, reading from VTCM, and reading from VTCM double-buffered by DMA.
+    scripts = [sch.mod.script() for sch in actual]
+    assert len(scripts) == 3
+    assert "global.vtcm" not in scripts[0]
+    assert "global.vtcm" in scripts[1]
+    assert "software_pipeline_async_stages" not in scripts[1]
+    assert "global.vtcm" in scripts[2]
+    assert "software_pipeline_async_stages" in scripts[2]
+
+
 def test_cache_read_specify_consumer():
     @T.prim_func
     def cache_read_specify_consumer_0(
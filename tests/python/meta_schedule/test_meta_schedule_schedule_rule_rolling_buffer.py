@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm import te
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.target import Target
+
+
+def _sum_pool(src, name):
+    out = src.shape[2] - 2
+    rh = te.reduce_axis((0, 3), name=f"{name}_rh")
+    rw = te.reduce_axis((0, 3), name=f"{name}_rw")
+    return te.compute(
+        (1, 16, out, out),
+        lambda n, c, h, w: te.sum(src[n, c, h + rh, w + rw], axis=[rh, rw]),
+        name=name,
+    )
+
+
+def _stacked_windows(n_windows=2, size=32):
+    # 3x3 sum-poolings, each one sliding over the output of the previous one.
+    x = te.placeholder((1, 16, size, size), "float32", name="X")
+    out = x
+    for i in range(n_windows):
+        out = _sum_pool(out, f"pool{i}")
+    return te.create_prim_func([x, out])
+
+
+def _design_space(func, max_buffer_bytes=1048576):
+    return generate_design_space(
+        kind="llvm",
+        mod=func,
+        target=Target("llvm --num-cores=4"),
+        types=None,
+        sch_rules=[ms.schedule_rule.RollingBuffer(max_buffer_bytes=max_buffer_bytes)],
+    )
+
+
+def _is_rolled(sch):
+    return any(inst.kind.name == "RollingBuffer" for inst in sch.trace.insts)
+
+
+def test_rolling_buffer():
+    actual = _design_space(_stacked_windows())
+    assert len(actual) == 2
+    (rolled,) = [sch for sch in actual if _is_rolled(sch)]
+    (pool0,) = [
+        buf for buf in rolled.mod["main"].body.block.alloc_buffers if buf.name == "pool0"
+    ]
+    # Only the three rows of the window of pool1 are kept.
+    assert [int(dim) for dim in pool0.shape] == [1, 16, 3, 30]
+    assert "meta_schedule.rolling_buffer" in rolled.mod.script()
+
+
+def test_skip_large_buffer():
+    actual = _design_space(_stacked_windows(), max_buffer_bytes=1024)
+    assert len(actual) == 1
+    assert not _is_rolled(actual[0])
+
+
+def test_skip_without_window():
+    actual = _design_space(_stacked_windows(n_windows=1))
+    assert len(actual) == 1
+    assert not _is_rolled(actual[0])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
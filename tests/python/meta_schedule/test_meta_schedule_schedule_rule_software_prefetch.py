@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.script import tir as T
+from tvm.target import Target
+
+
+@tvm.script.ir_module
+class Matmul:
+    @T.prim_func
+    def main(
+        A: T.Buffer((128, 128), "float32"),
+        B: T.Buffer((128, 128), "float32"),
+        C: T.Buffer((128, 128), "float32"),
+    ) -> None:
+        T.func_attr({"global_symbol": "main"})
+        for i, j, k in T.grid(128, 128, 128):
+            with T.block("C"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+
+def _prefetch_distances(sch):
+    distances = []
+    for inst in sch.trace.insts:
+        if inst.kind.name == "Annotate" and inst.attrs[0] == "software_prefetch_distance":
+            distances.append(inst)
+    return distances
+
+
+def test_fork_per_pipeline_depth():
+    actual = generate_design_space(
+        kind="llvm",
+        mod=Matmul,
+        target=Target("llvm --num-cores=32"),
+        types=None,
+        sch_rules=[ms.schedule_rule.SoftwarePrefetch(prefetch_distances=[1, 2, 4])],
+    )
+    # The unchanged schedule, and one prefetching at each of the loops `j` and `i`.
+    assert len(actual) == 3
+    assert sorted(len(_prefetch_distances(sch)) for sch in actual) == [0, 1, 1]
+    for sch in actual:
+        for inst in sch.trace.insts:
+            if inst.kind.name == "SampleCategorical":
+                assert [int(c) for c in inst.attrs[0]] == [1, 2, 4]
+
+
+def test_skip_gpu_target():
+    actual = generate_design_space(
+        kind="cuda",
+        mod=Matmul,
+        target=Target("nvidia/geforce-rtx-3080"),
+        types=None,
+        sch_rules=[ms.schedule_rule.SoftwarePrefetch()],
+    )
+    assert len(actual) == 1
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,66 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.testing import te_workload
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.target import Target
+from tvm.te import create_prim_func
+
+
+def _has_rfactor(sch):
+    return any(inst.kind.name == "RFactor" for inst in sch.trace.insts)
+
+
+def _design_space(m, n, k, target):
+    return generate_design_space(
+        kind="cuda",
+        mod=create_prim_func(te_workload.matmul(n=m, m=n, k=k)),
+        target=Target(target),
+        types=None,
+        sch_rules=[ms.schedule_rule.SplitK(split_factors=[4, 8, 16])],
+    )
+
+
+def test_split_skinny_gemm():
+    actual = _design_space(4, 1024, 4096, "nvidia/geforce-rtx-3080")
+    assert len(actual) >= 2
+    unchanged = [sch for sch in actual if not _has_rfactor(sch)]
+    split = [sch for sch in actual if _has_rfactor(sch)]
+    assert len(unchanged) == 1 and split
+    for sch in split:
+        insts = [inst for inst in sch.trace.insts if inst.kind.name == "SampleCategorical"]
+        assert [int(c) for c in insts[0].attrs[0]] == [4, 8, 16]
+        # The partial sums are bound to the thread blocks by the tiling.
+        assert "blockIdx.x" in sch.mod.script()
+
+
+def test_skip_large_output():
+    actual = _design_space(1024, 1024, 4096, "nvidia/geforce-rtx-3080")
+    assert len(actual) == 1
+    assert not _has_rfactor(actual[0])
+
+
+def test_skip_cpu_target():
+    actual = _design_space(4, 1024, 4096, "llvm --num-cores=16")
+    assert len(actual) == 1
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
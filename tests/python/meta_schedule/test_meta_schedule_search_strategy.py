@@ -188,6 +188,115 @@ def test_meta_schedule_evolutionary_search():  # pylint: disable = invalid-name
     assert num_trials_each_iter.count(0) < 5
 
 
+def test_meta_schedule_evolutionary_search_top_k_early_stop():  # pylint: disable = invalid-name
+    def _schedule_matmul_small(sch: Schedule):
+        block = sch.get_block("matmul")
+        _, j, k = sch.get_loops(block=block)
+        _, _ = sch.split(j, sch.sample_perfect_tile(j, n=2))
+        _, _ = sch.split(k, sch.sample_perfect_tile(k, n=2))
+
+    context = ms.TuneContext(
+        mod=Matmul,
+        space_generator=ms.space_generator.ScheduleFn(
+            sch_fn=_schedule_matmul_small,
+            sch_rules=[],
+            postprocs=[],
+            mutator_probs={
+                DummyMutator(): 1.0,
+            },
+        ),
+        search_strategy=ms.search_strategy.EvolutionarySearch(
+            population_size=5,
+            init_measured_ratio=0.1,
+            init_min_unmeasured=50,
+            genetic_num_iters=100,
+            genetic_mutate_prob=0.5,
+            genetic_max_fail_count=10,
+            eps_greedy=0.9,
+            genetic_early_stop_patience=2,
+        ),
+        target=tvm.target.Target("llvm"),
+        num_threads=1,  # because we are using a mutator from the python side
+    )
+    strategy = context.search_strategy
+    assert strategy.genetic_early_stop_patience == 2
+    assert not strategy.genetic_pipeline_prediction
+    strategy.pre_tuning(
+        max_trials=20,
+        num_trials_per_iter=10,
+        design_spaces=context.space_generator.generate_design_space(context.mod),
+        database=ms.database.MemoryDatabase(),
+        cost_model=ms.cost_model.RandomModel(),
+    )
+    num_trials = 0
+    candidates = strategy.generate_measure_candidates()
+    while candidates is not None:
+        num_trials += len(candidates)
+        runner_results = [
+            ms.runner.RunnerResult(run_secs=[0.11, 0.41, 0.54], error_msg=None)
+            for _ in candidates
+        ]
+        strategy.notify_runner_results(candidates, runner_results)
+        candidates = strategy.generate_measure_candidates()
+    strategy.post_tuning()
+    assert 0 < num_trials <= 20
+
+
+def test_meta_schedule_evolutionary_search_pipeline_prediction():  # pylint: disable = invalid-name
+    def _search(genetic_pipeline_prediction):
+        context = ms.TuneContext(
+            mod=Matmul,
+            space_generator=ms.space_generator.ScheduleFn(
+                sch_fn=_schedule_matmul,
+                sch_rules=[],
+                postprocs=[],
+                mutator_probs={ms.mutator.MutateTileSize(): 1.0},
+            ),
+            search_strategy=ms.search_strategy.EvolutionarySearch(
+                population_size=16,
+                init_measured_ratio=0.1,
+                init_min_unmeasured=16,
+                genetic_num_iters=3,
+                genetic_mutate_prob=0.5,
+                genetic_max_fail_count=10,
+                eps_greedy=0.25,
+                genetic_pipeline_prediction=genetic_pipeline_prediction,
+            ),
+            target=tvm.target.Target("llvm"),
+            rand_state=42,
+            num_threads=1,
+        )
+        strategy = context.search_strategy
+        assert strategy.genetic_pipeline_prediction == genetic_pipeline_prediction
+        strategy.pre_tuning(
+            max_trials=24,
+            num_trials_per_iter=8,
+            design_spaces=context.space_generator.generate_design_space(context.mod),
+            database=ms.database.MemoryDatabase(),
+            cost_model=ms.cost_model.RandomModel(seed=42),
+        )
+        traces = []
+        candidates = strategy.generate_measure_candidates()
+        while candidates is not None:
+            traces.extend(str(candidate.sch.trace) for candidate in candidates)
+            runner_results = [
+                ms.runner.RunnerResult(run_secs=[0.11, 0.41, 0.54], error_msg=None)
+                for _ in candidates
+            ]
+            strategy.notify_runner_results(candidates, runner_results)
+            candidates = strategy.generate_measure_candidates()
+        strategy.post_tuning()
+        return traces
+
+    sequential = _search(genetic_pipeline_prediction=False)
+    pipelined = _search(genetic_pipeline_prediction=True)
+    # The pipeline only overlaps the prediction with the mutation of the same generation, so it
+    # finds the same candidates, with the same decisions.
+    assert len(sequential) > 0
+    assert len(pipelined) == len(sequential)
+    assert pipelined == sequential
+
+
 def test_meta_schedule_evolutionary_search_early_stop():  # pylint: disable = invalid-name
     def _schedule_matmul_empty(sch: Schedule):
         return sch
@@ -231,6 +231,55 @@ def test_meta_schedule_task_scheduler_multiple():
         )
 
 
+@pytest.mark.parametrize(
+    "scheduler",
+    [
+        lambda: ms.task_scheduler.RoundRobin(num_inflight_batches=2),
+        lambda: ms.task_scheduler.GradientBased(num_inflight_batches=2),
+    ],
+)
+def test_meta_schedule_task_scheduler_inflight_batches(scheduler):
+    num_trials_per_iter = 6
+    max_trials_per_task = 30
+    tasks = [
+        ms.TuneContext(
+            MatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="Matmul",
+            rand_state=42,
+        ),
+        ms.TuneContext(
+            BatchMatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_batch_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="BatchMatmul",
+            rand_state=0x114514,
+        ),
+    ]
+    database = ms.database.MemoryDatabase()
+    task_scheduler = scheduler()
+    assert task_scheduler.num_inflight_batches == 2
+    task_scheduler.tune(
+        tasks,
+        [1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=num_trials_per_iter,
+        cost_model=None,
+    )
+    assert len(database) == max_trials_per_task * len(tasks)
+    for task in task_scheduler.tasks_:
+        assert task.is_terminated
+        assert task.runner_futures is None
+
+
 def test_meta_schedule_task_scheduler_NIE():  # pylint: disable=invalid-name
     @ms.derived_object
     class NIETaskScheduler(ms.task_scheduler.PyTaskScheduler):
@@ -353,6 +402,70 @@ def test_meta_schedule_task_scheduler_multiple_gradient_based():
         )
 
 
+def _create_matmul_tasks():
+    return [
+        ms.TuneContext(
+            MatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="Matmul",
+            rand_state=42,
+        ),
+        ms.TuneContext(
+            BatchMatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=_schedule_batch_matmul,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name="BatchMatmul",
+            rand_state=0x114514,
+        ),
+    ]
+
+
+def test_meta_schedule_task_scheduler_ucb():
+    max_trials_per_task = 101
+    tasks = _create_matmul_tasks()
+    database = ms.database.MemoryDatabase()
+    ms.task_scheduler.create("ucb", min_gain=0.0).tune(
+        tasks,
+        task_weights=[1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=6,
+        cost_model=None,
+    )
+    assert len(database) == max_trials_per_task * len(tasks)
+
+
+def test_meta_schedule_task_scheduler_ucb_terminates_low_gain_tasks():
+    max_trials_per_task = 101
+    min_rounds = 2
+    tasks = _create_matmul_tasks()
+    database = ms.database.MemoryDatabase()
+    # No round can reduce the end-to-end latency by more than all of it.
+    ucb = ms.task_scheduler.UCB(exploration=0.0, min_gain=2.0, min_rounds=min_rounds)
+    ucb.tune(
+        tasks,
+        task_weights=[1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=6,
+        cost_model=None,
+    )
+    for task in tasks:
+        num_records = len(database.get_top_k(database.commit_workload(task.mod), 10000))
+        assert min_rounds * 6 <= num_records < max_trials_per_task
+
+
 def test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy():
     """
     When search strategy of one task returns empty list of candidates or None,
@@ -444,3 +557,5 @@ if __name__ == "__main__":
     test_meta_schedule_task_scheduler_override_next_task_id_only()
     test_meta_schedule_task_scheduler_multiple_gradient_based()
     test_meta_schedule_task_scheduler_gradient_based_with_null_search_strategy()
+    test_meta_schedule_task_scheduler_ucb()
+    test_meta_schedule_task_scheduler_ucb_terminates_low_gain_tasks()
@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, missing-docstring
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.ir import assert_structural_equal
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+
+
+@I.ir_module
+class MLP:
+    I.module_attrs({"device_num": 2})
+    I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+    @R.function
+    def foo(
+        x: R.Tensor((16, 128), "float32"),
+        weight1: R.Tensor((128, 256), "float32"),
+        weight2: R.Tensor((256, 128), "float32"),
+    ) -> R.Tensor((16, 128), "float32"):
+        lv0 = R.matmul(x, weight1)
+        lv1 = R.nn.gelu(lv0)
+        lv3 = R.matmul(lv1, weight2)
+        return lv3
+
+
+def _check_param_placements(mod, placements):
+    mesh = MLP.global_infos["mesh"][0]
+    for param, orig_param, placement in zip(mod["foo"].params, MLP["foo"].params, placements):
+        expected = relax.distributed.DTensorStructInfo(
+            orig_param.struct_info, mesh, relax.distributed.Placement.from_text(placement)
+        )
+        assert_structural_equal(param.struct_info, expected)
+
+
+def test_data_parallel_without_memory_limit():
+    mesh = MLP.global_infos["mesh"][0]
+    after = relax.distributed.transform.AutoSharding(mesh)(MLP)
+    # Sharding the batch needs no communication.
+    _check_param_placements(after, ["S[0]", "R", "R"])
+    assert_structural_equal(
+        after["foo"].ret_struct_info,
+        relax.distributed.DTensorStructInfo(
+            relax.TensorStructInfo((16, 128), "float32"),
+            mesh,
+            relax.distributed.Placement.from_text("S[0]"),
+        ),
+    )
+
+
+def test_tensor_parallel_under_memory_limit():
+    mesh = MLP.global_infos["mesh"][0]
+    # The replicated weights of data parallelism take 256 KB, while splitting the hidden axis
+    # of the weights fits 200 KB per device.
+    after = relax.distributed.transform.AutoSharding(mesh, memory_limit=200 * 1024)(MLP)
+    _check_param_placements(after, ["R", "S[1]", "S[0]"])
+    assert_structural_equal(
+        after["foo"].ret_struct_info,
+        relax.distributed.DTensorStructInfo(
+            relax.TensorStructInfo((16, 128), "float32"),
+            mesh,
+            relax.distributed.Placement.from_text("R"),
+        ),
+    )
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
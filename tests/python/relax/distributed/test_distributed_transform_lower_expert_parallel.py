@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+#  type: ignore
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+import tvm
+from tvm import relax
+import tvm.testing
+
+
+def test_group_gemm_of_local_experts():
+    # 4 experts over 2 workers, with a capacity of 4 rows per expert.
+    @I.ir_module
+    class Before:
+        @R.function
+        def foo(
+            x: R.Tensor((16, 8), "float16"),
+            w: R.Tensor((2, 4, 8), "float16"),
+            indptr: R.Tensor((4,), "int64"),
+            workspace: R.Tensor((1024,), "uint8"),
+        ):
+            gv = R.call_dps_packed(
+                "cutlass.group_gemm",
+                (x, w, indptr, workspace),
+                out_sinfo=R.Tensor((16, 4), "float16"),
+            )
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def foo(
+            x: R.Tensor((16, 8), "float16"),
+            w: R.Tensor((2, 4, 8), "float16"),
+            indptr: R.Tensor((4,), "int64"),
+            workspace: R.Tensor((1024,), "uint8"),
+        ) -> R.Tensor((16, 4), "float16"):
+            lv: R.Tensor((16, 8), "float16") = R.ccl.alltoall(x, num_workers=2)
+            lv1: R.Tensor((2, 2, 4, 8), "float16") = R.reshape(lv, R.shape([2, 2, 4, 8]))
+            lv2: R.Tensor((2, 2, 4, 8), "float16") = R.permute_dims(lv1, axes=[1, 0, 2, 3])
+            lv3: R.Tensor((16, 8), "float16") = R.reshape(lv2, R.shape([16, 8]))
+            lv4: R.Tensor((2,), "int64") = R.strided_slice(
+                indptr, axes=[0], begin=[1], end=[4], strides=[2]
+            )
+            lv5 = R.call_dps_packed(
+                "cutlass.group_gemm",
+                (lv3, w, lv4, workspace),
+                out_sinfo=R.Tensor((16, 4), "float16"),
+            )
+            lv6: R.Tensor((2, 2, 4, 4), "float16") = R.reshape(lv5, R.shape([2, 2, 4, 4]))
+            lv7: R.Tensor((2, 2, 4, 4), "float16") = R.permute_dims(lv6, axes=[1, 0, 2, 3])
+            lv8: R.Tensor((16, 4), "float16") = R.reshape(lv7, R.shape([16, 4]))
+            gv: R.Tensor((16, 4), "float16") = R.ccl.alltoall(lv8, num_workers=2)
+            return gv
+
+    after = relax.distributed.transform.LowerExpertParallel(num_workers=2, num_experts=4)(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_group_gemm_of_all_experts_is_kept():
+    # The weight holds all the experts, so there is nothing to distribute.
+    @I.ir_module
+    class Before:
+        @R.function
+        def foo(
+            x: R.Tensor((16, 8), "float16"),
+            w: R.Tensor((4, 4, 8), "float16"),
+            indptr: R.Tensor((4,), "int64"),
+            workspace: R.Tensor((1024,), "uint8"),
+        ):
+            gv = R.call_dps_packed(
+                "cutlass.group_gemm",
+                (x, w, indptr, workspace),
+                out_sinfo=R.Tensor((16, 4), "float16"),
+            )
+            return gv
+
+    after = relax.distributed.transform.LowerExpertParallel(num_workers=2, num_experts=4)(Before)
+    tvm.ir.assert_structural_equal(after, Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
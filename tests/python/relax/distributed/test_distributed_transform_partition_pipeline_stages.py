@@ -0,0 +1,130 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, missing-docstring
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.ir import assert_structural_equal
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+
+
+# fmt: off
+@I.ir_module
+class MLP:
+    @R.function
+    def main(
+        x: R.Tensor((16, 128), "float32"),
+        w0: R.Tensor((128, 128), "float32"),
+        w1: R.Tensor((128, 128), "float32"),
+        w2: R.Tensor((128, 128), "float32"),
+        w3: R.Tensor((128, 128), "float32"),
+    ) -> R.Tensor((16, 128), "float32"):
+        R.func_attr({"num_input": 1})
+        with R.dataflow():
+            lv0 = R.matmul(x, w0)
+            lv1 = R.nn.relu(lv0)
+            lv2 = R.matmul(lv1, w1)
+            lv3 = R.nn.relu(lv2)
+            lv4 = R.matmul(lv3, w2)
+            lv5 = R.nn.relu(lv4)
+            lv6 = R.matmul(lv5, w3)
+            gv = R.nn.relu(lv6)
+            R.output(gv)
+        return gv
+# fmt: on
+
+
+def test_partition_two_stages():
+    # fmt: off
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((16, 128), "float32"),
+            w0: R.Tensor((128, 128), "float32"),
+            w1: R.Tensor((128, 128), "float32"),
+            w2: R.Tensor((128, 128), "float32"),
+            w3: R.Tensor((128, 128), "float32"),
+        ) -> R.Tensor((16, 128), "float32"):
+            R.func_attr({"num_input": 1})
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                lv1 = R.nn.relu(lv0)
+                lv2 = R.matmul(lv1, w1)
+                lv3 = R.nn.relu(lv2)
+                lv4 = R.matmul(lv3, w2)
+                lv5 = R.nn.relu(lv4)
+                lv6 = R.matmul(lv5, w3)
+                gv = R.nn.relu(lv6)
+                R.output(gv)
+            return gv
+
+        @R.function
+        def main_stage0(
+            x: R.Tensor((16, 128), "float32"),
+            w0: R.Tensor((128, 128), "float32"),
+            w1: R.Tensor((128, 128), "float32"),
+        ) -> R.Tuple(R.Tensor((16, 128), "float32")):
+            R.func_attr({"num_input": 1})
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                lv1 = R.nn.relu(lv0)
+                lv2 = R.matmul(lv1, w1)
+                lv3 = R.nn.relu(lv2)
+                gv = (lv3,)
+                R.output(gv)
+            return gv
+
+        @R.function
+        def main_stage1(
+            lv3: R.Tensor((16, 128), "float32"),
+            w2: R.Tensor((128, 128), "float32"),
+            w3: R.Tensor((128, 128), "float32"),
+        ) -> R.Tensor((16, 128), "float32"):
+            R.func_attr({"num_input": 1})
+            with R.dataflow():
+                lv4 = R.matmul(lv3, w2)
+                lv5 = R.nn.relu(lv4)
+                lv6 = R.matmul(lv5, w3)
+                gv = R.nn.relu(lv6)
+                R.output(gv)
+            return gv
+
+        @R.function
+        def main_stage1_recv_buffers() -> R.Tuple(R.Tensor((16, 128), "float32")):
+            with R.dataflow():
+                lv = R.zeros(R.shape([16, 128]), "float32")
+                gv = (lv,)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    # Each half of the layers has the same FLOPs and weights, so the stages split in the middle.
+    after = relax.distributed.transform.PartitionPipelineStages("main", 2)(MLP)
+    assert_structural_equal(after, Expected)
+
+
+def test_partition_too_many_stages():
+    with pytest.raises(tvm.TVMError):
+        relax.distributed.transform.PartitionPipelineStages("main", 9)(MLP)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
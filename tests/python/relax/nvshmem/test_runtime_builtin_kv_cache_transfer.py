@@ -90,6 +90,7 @@ fnvshmem_get_uid = None
 fnvshmem_init = None
 fdisagg_mark_send = None
 fdisagg_prepare_recv = None
+fdisagg_get_recv_layer_counters = None
 
 ftranspose_append = None
 fcopy_cache = None
@@ -116,6 +117,7 @@ def set_global_func(head_dim, dtype):
     global fattn_prefill_sliding_window, fattn_decode_sliding_window
     global fmerge_state, fsplit_rotary, fattention_rotary, fcopy_single_page, fcompact_copy
     global fnvshmem_get_uid, fnvshmem_init, fdisagg_mark_send, fdisagg_prepare_recv
+    global fdisagg_get_recv_layer_counters
 
     fclear = tvm.get_global_func("vm.builtin.kv_state_clear")
     fadd_sequence = tvm.get_global_func("vm.builtin.kv_state_add_sequence")
@@ -140,6 +142,9 @@ def set_global_func(head_dim, dtype):
     fnvshmem_init = tvm.get_global_func("runtime.disco.nvshmem.init_nvshmem")
     fdisagg_mark_send = tvm.get_global_func("vm.builtin.kv_cache_disagg_mark_send")
     fdisagg_prepare_recv = tvm.get_global_func("vm.builtin.kv_cache_disagg_prepare_recv")
+    fdisagg_get_recv_layer_counters = tvm.get_global_func(
+        "vm.builtin.kv_cache_disagg_get_recv_layer_counters"
+    )
 
     target = tvm.target.Target.from_device(device)
     builts = []
@@ -705,6 +710,9 @@ def test_paged_attention_kv_cache_transfer(kv_cache_and_config):
                 skip_add_sequence=True,
             )
         comm.Barrier()
+        # The sender notifies every layer once per prefill step.
+        counters = list(fdisagg_get_recv_layer_counters(kv_cache))
+        assert counters == [len(prefill_operation_seq)] * len(counters), counters
         for batch in decode_operation_seq:
             apply_attention(kv_cache, rope_mode, batch, cached_k, cached_v, skip_add_sequence=True)
 
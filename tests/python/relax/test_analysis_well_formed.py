@@ -61,6 +61,22 @@ def test_var():
     assert not rx.analysis.well_formed(mod, check_struct_info=False)
 
 
+def test_incremental_only_checks_changed_functions():
+    # Error: Var undefined is not defined
+    gv0 = rx.Var("gv0", R.Tensor([m, n], "float32"))
+    undefined = rx.Var("undefined", R.Tensor([m, n], "float32"))
+    good_func = build_function([rx.BindingBlock([rx.VarBinding(gv0, rx.op.add(x, x))])])
+    bad_func = build_function([rx.BindingBlock([rx.VarBinding(gv0, rx.op.add(x, undefined))])])
+    gvar = rx.GlobalVar("foo")
+    good_mod = tvm.IRModule({gvar: good_func})
+    bad_mod = tvm.IRModule({gvar: bad_func})
+
+    assert not rx.analysis.well_formed(bad_mod, check_struct_info=False, prev_mod=good_mod)
+    assert rx.analysis.well_formed(good_mod, check_struct_info=False, prev_mod=bad_mod)
+    # the function is the same object as in the previous module, so it is not checked again
+    assert rx.analysis.well_formed(bad_mod, check_struct_info=False, prev_mod=bad_mod)
+
+
 def test_dataflow_var():
     # Error: DataflowVar lv0 is not defined
     lv0 = rx.DataflowVar("lv0", R.Tensor([m, n], "float32"))
@@ -0,0 +1,148 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax, te
+from tvm.relax.backend.cuda.sparse_matmul import DispatchSparseMatmul, compress_2in4
+
+TARGET = tvm.target.Target("cuda -arch=sm_80")
+
+
+def _sparse_weight(n_out, k_in, seed=0):
+    rng = np.random.default_rng(seed)
+    weight = rng.uniform(-1, 1, (n_out, k_in)).astype("float16")
+    groups = weight.reshape(n_out, -1, 4)
+    for row in groups:
+        for group in row:
+            group[rng.choice(4, 2, replace=False)] = 0
+    return weight
+
+
+def _compress_ref(weight):
+    """Reference compression in the layout of tests/python/tir-base/test_tir_ptx_mma_sp.py"""
+    n_out, k_in = weight.shape
+    positions = np.zeros((n_out, k_in // 4, 2), "uint32")
+    values = np.zeros((n_out, k_in // 2), "float16")
+    for n in range(n_out):
+        for g in range(k_in // 4):
+            kept = [j for j in range(4) if weight[n, g * 4 + j] != 0][:2]
+            if len(kept) == 0:
+                kept = [2, 3]
+            elif len(kept) == 1:
+                kept = [2, 3] if kept[0] == 3 else [kept[0], kept[0] + 1]
+            positions[n, g] = kept
+            values[n, 2 * g : 2 * g + 2] = weight[n, g * 4 + np.array(kept)]
+    positions = positions.reshape(n_out // 16, 2, 8, k_in // 16, 8)
+    metadata = np.zeros((n_out // 16, 8, k_in // 16), "uint32")
+    for r in range(16):
+        metadata |= positions[:, r // 8, :, :, r % 8] << np.uint32(2 * r)
+    return values, metadata.reshape(n_out // 2, k_in // 16)
+
+
+def _linear(weight, x_shape=(4, 64)):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", relax.TensorStructInfo(x_shape, "float16"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            weight_t = bb.emit(relax.op.permute_dims(weight))
+            out = bb.emit_output(bb.emit(relax.op.matmul(x, weight_t, out_dtype="float32")))
+        bb.emit_func_output(out)
+    return bb.get()
+
+
+def _called_funcs(mod):
+    return [
+        gv.name_hint for gv, func in mod.functions_items() if isinstance(func, tvm.tir.PrimFunc)
+    ]
+
+
+def test_compress_2in4():
+    weight_np = _sparse_weight(32, 64)
+    # the groups with fewer than 2 non-zeros keep zeros
+    weight_np[0, :4] = [0, 0, 0, 1]
+    weight_np[1, :4] = 0
+    weight = te.placeholder((32, 64), "float16", name="weight")
+    values, metadata = compress_2in4(weight)
+    func = tvm.compile(te.create_prim_func([weight, values, metadata]), target="llvm")
+    out = [tvm.runtime.empty((32, 32), "float16"), tvm.runtime.empty((16, 4), "uint32")]
+    func(tvm.runtime.tensor(weight_np), *out)
+    values_ref, metadata_ref = _compress_ref(weight_np)
+    tvm.testing.assert_allclose(out[0].numpy(), values_ref)
+    np.testing.assert_equal(out[1].numpy(), metadata_ref)
+
+
+def test_dispatch_sparse_constant():
+    mod = _linear(relax.const(_sparse_weight(32, 64)))
+    with TARGET:
+        mod = DispatchSparseMatmul()(mod)
+    assert sorted(_called_funcs(mod)) == ["compress_2in4", "sparse_matmul_2in4"]
+    assert "relax.matmul" not in mod["main"].script()
+
+
+def test_keep_dense_constant():
+    weight = np.random.uniform(-1, 1, (32, 64)).astype("float16")
+    mod = _linear(relax.const(weight))
+    with TARGET:
+        after = DispatchSparseMatmul()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+def test_keep_before_sm80():
+    mod = _linear(relax.const(_sparse_weight(32, 64)))
+    with tvm.target.Target("cuda -arch=sm_75"):
+        after = DispatchSparseMatmul()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+def test_compressed_parameter_is_lifted():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", relax.TensorStructInfo((4, 64), "float16"))
+    weight = relax.Var("fc_weight", relax.TensorStructInfo((32, 64), "float16"))
+    with bb.function("main", [x, weight], attrs={"num_input": 1}):
+        with bb.dataflow():
+            weight_t = bb.emit(relax.op.permute_dims(weight))
+            out = bb.emit_output(bb.emit(relax.op.matmul(x, weight_t)))
+        bb.emit_func_output(out)
+    with TARGET:
+        mod = DispatchSparseMatmul(weights=["fc_weight"])(bb.get())
+    mod = relax.transform.DeadCodeElimination()(mod)
+    mod = relax.transform.LiftTransformParams()(mod)
+    # The weights to save are the compressed ones, computed once from the pruned weight.
+    params = mod["main_transform_params"].ret_struct_info.fields
+    assert sorted(tuple(int(d) for d in p.shape) for p in params) == [(16, 4), (32, 32)]
+
+
+@tvm.testing.requires_cuda_compute_version(8)
+def test_sparse_matmul_e2e():
+    weight_np = _sparse_weight(64, 128)
+    x_np = np.random.uniform(-1, 1, (2, 10, 128)).astype("float16")
+    mod = _linear(relax.const(weight_np), x_np.shape)
+    target = tvm.target.Target("cuda")
+    with target:
+        mod = DispatchSparseMatmul()(mod)
+    assert "sparse_matmul_2in4" in _called_funcs(mod)
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(tvm.compile(mod, target), dev)
+    out = vm["main"](tvm.runtime.tensor(x_np, dev)).numpy()
+    ref = x_np.astype("float32") @ weight_np.astype("float32").T
+    tvm.testing.assert_allclose(out, ref, rtol=1e-2, atol=1e-2)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
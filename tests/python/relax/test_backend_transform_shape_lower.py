@@ -17,7 +17,7 @@
 
 import tvm.script
 import tvm.testing
-from tvm import relax
+from tvm import relax, tir
 from tvm.ir import assert_structural_equal
 from tvm.relax.testing.runtime_builtin import MakeShapeCode, MatchShapeCode
 from tvm.script import relax as R
@@ -893,5 +893,76 @@ def test_update_symbolic_vars_in_match_cast_rhs():
     assert_structural_equal(Expected, After)
 
 
+def _packed_calls(func, name=None):
+    calls = []
+
+    def fvisit(expr):
+        if isinstance(expr, relax.Call) and isinstance(expr.op, relax.ExternFunc):
+            if name is None or expr.op.global_symbol == name:
+                calls.append(expr)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return calls
+
+
+def test_fused_param_check():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor(["n", 2, "m"], "float32"), y: R.Tensor(["n", "m * 2"], "float32")
+        ) -> R.Shape(ndim=1):
+            R.func_attr({"relax.force_pure": True})
+            m = T.int64()
+            return R.shape([m + 1])
+
+    after = relax.transform.VMShapeLower(emit_err_ctx=False, fuse_checks=True)(Before)
+    # the parameters are checked and the heap populated by a single PrimFunc
+    names = [call.op.global_symbol for call in _packed_calls(after["main"])]
+    assert names == ["vm.builtin.make_shape"]
+    check_funcs = [gv for gv, func in after.functions.items() if isinstance(func, tir.PrimFunc)]
+    assert [gv.name_hint for gv in check_funcs] == ["param_check"]
+    assert len(after[check_funcs[0]].params) == 3
+
+    # the pass config enables the same lowering
+    with tvm.transform.PassContext(config={"relax.VMShapeLower.fuse_checks": True}):
+        configured = relax.transform.VMShapeLower(emit_err_ctx=False)(Before)
+    assert_structural_equal(configured, after)
+
+
+def test_fused_param_check_falls_back_for_non_tensor_params():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor(["n"], "float32"), s: R.Shape(["n"])):
+            R.func_attr({"relax.force_pure": True})
+            return x
+
+    expected = relax.transform.VMShapeLower(emit_err_ctx=False)(Before)
+    after = relax.transform.VMShapeLower(emit_err_ctx=False, fuse_checks=True)(Before)
+    assert_structural_equal(after, expected)
+
+
+def test_fused_match_cast_skips_proven_dims():
+    MS = MatchShapeCode
+
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor(["n", "k"], "float32")):
+            R.func_attr({"relax.force_pure": True})
+            n = T.int64()
+            m = T.int64()
+            y = R.match_cast(x, R.Tensor([n, m], "float32"))
+            return y
+
+    after = relax.transform.VMShapeLower(emit_err_ctx=False, fuse_checks=True)(Before)
+    match_shapes = _packed_calls(after["main"], "vm.builtin.match_shape")
+    assert len(match_shapes) == 1
+    # n is proven by the struct info of x, only m is stored
+    codes = [int(arg.value) for arg in match_shapes[0].args[3:7:2]]
+    assert codes == [MS.NO_OP, MS.STORE_TO_HEAP]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
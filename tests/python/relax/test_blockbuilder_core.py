@@ -211,6 +211,30 @@ def test_binary_shape_type_deduction():
         assert gv0.struct_info.dtype == "float16"
 
 
+def test_struct_info_memoized_for_static_shapes():
+    n = tir.Var("n", "int64")
+    x = rx.Var("x", rx.TensorStructInfo([4, 8], "float32"))
+    y = rx.Var("y", rx.TensorStructInfo([4, 8], "float32"))
+    z = rx.Var("z", rx.TensorStructInfo([n, 8], "float32"))
+    bb = rx.BlockBuilder()
+
+    with bb.function("func", [x, y, z]):
+        with bb.dataflow():
+            # the repeated layers share the struct info inferred for the first one
+            lv0 = bb.emit(rx.op.nn.relu(x))
+            lv1 = bb.emit(rx.op.nn.relu(y))
+            assert lv0.struct_info.same_as(lv1.struct_info)
+            lv2 = bb.emit(rx.op.sum(lv0, axis=[1]))
+            assert_structural_equal(lv2.struct_info, rx.TensorStructInfo([4], "float32"))
+            lv3 = bb.emit(rx.op.sum(lv1, axis=[0]))
+            assert_structural_equal(lv3.struct_info, rx.TensorStructInfo([8], "float32"))
+            # symbolic shapes are inferred in the scope of each call
+            lv4 = bb.emit(rx.op.add(z, z))
+            assert_structural_equal(lv4.struct_info, rx.TensorStructInfo([n, 8], "float32"))
+            gv = bb.emit_output(rx.Tuple([lv2, lv3, lv4]))
+        bb.emit_func_output(gv)
+
+
 def test_emit_match_cast():
     m = tir.Var("m", dtype="int64")
     n = tir.Var("n", dtype="int64")
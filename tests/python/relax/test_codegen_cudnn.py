@@ -202,6 +202,48 @@ def test_conv2d_offload(data_shape, weight_shape, dtype, with_bias, activation):
         tvm.testing.assert_allclose(out, ref, rtol=2.5e-2, atol=2.5e-2)
 
 
+def test_conv2d_offload_plan_cache(tmp_path):
+    set_dir = tvm.get_global_func("contrib.cudnn.frontend.set_plan_cache_dir", allow_missing=True)
+    if set_dir is None:
+        pytest.skip("require cudnn frontend")
+    get_dir = tvm.get_global_func("contrib.cudnn.frontend.get_plan_cache_dir")
+    cache_size = tvm.get_global_func("contrib.cudnn.frontend.plan_cache_size")
+    clear = tvm.get_global_func("contrib.cudnn.frontend.clear_plan_cache")
+
+    data_shape, weight_shape, dtype = (16, 32, 32, 16), (32, 3, 3, 16), "float32"
+    args = (
+        np.random.randn(*data_shape).astype(dtype),
+        np.random.randn(*weight_shape).astype(dtype),
+        np.random.randn(1, 1, 1, weight_shape[0]).astype(dtype),
+    )
+    # Bias+ReLU runs as a single frontend graph.
+    mod = get_relax_conv2d_module(
+        data_shape, weight_shape, dtype, with_bias=True, activation=R.nn.relu
+    )
+    prev_dir = get_dir()
+    try:
+        set_dir(str(tmp_path))
+        clear()
+        out = get_result_with_relax_cudnn_offload(mod, args)
+        plans = sorted(tmp_path.glob("*.plan"))
+        if not plans:
+            pytest.skip("the chosen cuDNN engine does not support serialization")
+        assert cache_size() >= 1
+        stats = [(plan.stat().st_ino, plan.stat().st_mtime_ns) for plan in plans]
+
+        # A process with an empty table restores the plan from the file, without rebuilding
+        # and rewriting it.
+        clear()
+        restored_out = get_result_with_relax_cudnn_offload(mod, args)
+        assert cache_size() >= 1
+        assert sorted(tmp_path.glob("*.plan")) == plans
+        assert [(plan.stat().st_ino, plan.stat().st_mtime_ns) for plan in plans] == stats
+        tvm.testing.assert_allclose(restored_out, out, rtol=1e-5, atol=1e-5)
+    finally:
+        set_dir(prev_dir)
+        clear()
+
+
 @pytest.mark.skip(reason="flaky test")
 @pytest.mark.parametrize(
     "data_shape, weight_shape, dtype, with_bias, activation",
@@ -92,5 +92,31 @@ def test_dnnl_offload():
     tvm.testing.assert_allclose(out, ref, rtol=1e-3, atol=1e-3)
 
 
+def test_dnnl_primitive_cache():
+    pat = make_fused_bias_activation_pattern(
+        "relax.nn.conv2d", with_bias=False, activation="relax.nn.relu"
+    )
+    seq = tvm.transform.Sequential(
+        [
+            relax.transform.FuseOpsByPattern([("dnnl.conv2d_relu", pat)]),
+            relax.transform.MergeCompositeFunctions(),
+            relax.transform.RunCodegen(),
+        ]
+    )
+    data_np = np.random.randn(1, 64, 56, 56).astype("float32")
+    weight1_np = np.random.randn(64, 64, 3, 3).astype("float32")
+    weight2_np = np.random.randn(64, 64, 3, 3).astype("float32")
+    inputs = [data_np, weight1_np, weight2_np]
+    cache_size = tvm.get_global_func("runtime.dnnl_primitive_cache_size")
+
+    out = build_and_run(seq(Conv2dReLUx2), inputs)
+    num_primitives = cache_size()
+    # The layers of the second module reuse the primitives created for the first one.
+    out_rebuilt = build_and_run(seq(Conv2dReLUx2), inputs)
+    assert cache_size() == num_primitives
+    tvm.testing.assert_allclose(out_rebuilt, out, rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     test_dnnl_offload()
+    test_dnnl_primitive_cache()
@@ -111,5 +111,42 @@ def test_tensorrt_offload():
     tvm.testing.assert_allclose(out, ref, rtol=1e-3, atol=1e-3)
 
 
+def test_tensorrt_offload_dynamic_batch():
+    @tvm.script.ir_module
+    class DynamicBatch:
+        @R.function
+        def main(data: R.Tensor(("n", 16), "float32")):
+            R.func_attr({"tir_var_upper_bound": {"n": 32}})
+            with R.dataflow():
+                out = R.nn.relu(R.add(data, data))
+                R.output(out)
+            return out
+
+    patterns = [
+        ("tensorrt.nn.relu", is_op("relax.nn.relu")(wildcard())),
+        ("tensorrt.add", is_op("relax.add")(wildcard(), wildcard())),
+    ]
+    with tvm.transform.PassContext(
+        config={"relax.ext.tensorrt.options": {"use_implicit_batch": False}}
+    ):
+        mod = tvm.transform.Sequential(
+            [
+                relax.transform.FuseOpsByPattern(patterns),
+                relax.transform.MergeCompositeFunctions(),
+                relax.transform.RunCodegen(),
+            ]
+        )(DynamicBatch)
+
+    ex = tvm.compile(mod, "cuda")
+    dev = tvm.cuda(0)
+    vm = relax.VirtualMachine(ex, dev)
+    # One engine with an optimization profile up to the bound serves all the batch sizes.
+    for n in [4, 32, 9]:
+        data_np = np.random.randn(n, 16).astype("float32")
+        out = vm["main"](tvm.runtime.tensor(data_np, dev)).numpy()
+        tvm.testing.assert_allclose(out, np.maximum(data_np * 2, 0), rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     test_tensorrt_offload()
+    test_tensorrt_offload_dynamic_batch()
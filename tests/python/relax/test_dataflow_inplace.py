@@ -640,5 +640,190 @@ def test_dynamic_mismatch():
     tvm.ir.assert_structural_equal(new_mod, DynamicMistmatchTestCase)
 
 
+def test_inplace_call_tir_elementwise():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def scale(A: T.Buffer((2, 3), "float32"), B: T.Buffer((2, 3), "float32")):
+            for i, j in T.grid(2, 3):
+                with T.block("scale"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] * T.float32(2)
+
+        @R.function
+        def main(x: R.Tensor((2, 3), dtype="float32")) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Before
+            with R.dataflow():
+                y = R.add(x, x)
+                # y is not used later and scale is elementwise, so it can write into y
+                z = R.call_tir(cls.scale, (y,), out_sinfo=R.Tensor((2, 3), dtype="float32"))
+                R.output(z)
+            return z
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def scale(A: T.Buffer((2, 3), "float32"), B: T.Buffer((2, 3), "float32")):
+            for i, j in T.grid(2, 3):
+                with T.block("scale"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] * T.float32(2)
+
+        @T.prim_func(private=True)
+        def scale_inplace(A: T.Buffer((2, 3), "float32")):
+            for i, j in T.grid(2, 3):
+                with T.block("scale"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    A[vi, vj] = A[vi, vj] * T.float32(2)
+
+        @R.function
+        def main(x: R.Tensor((2, 3), dtype="float32")) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Expected
+            with R.dataflow():
+                y: R.Tensor((2, 3), dtype="float32") = R.add(x, x)
+                z: R.Tensor((2, 3), dtype="float32") = R.call_tir_inplace(
+                    cls.scale_inplace,
+                    (y,),
+                    inplace_indices=[0],
+                    out_sinfo=[
+                        R.Tensor((2, 3), dtype="float32"),
+                    ],
+                )
+                R.output(z)
+            return z
+
+    new_mod = DataflowUseInplaceCalls()(Before)
+    tvm.ir.assert_structural_equal(new_mod, Expected)
+
+    x = np.random.rand(2, 3).astype("float32")
+    ex = tvm.compile(new_mod, tvm.target.Target("llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    res = vm["main"](tvm.runtime.tensor(x))
+    np.testing.assert_allclose(res.numpy(), (x + x) * 2, rtol=1e-6)
+
+
+def test_no_inplace_call_tir_not_elementwise():
+    @I.ir_module
+    class NotElementwise:
+        @T.prim_func(private=True)
+        def transpose(A: T.Buffer((3, 3), "float32"), B: T.Buffer((3, 3), "float32")):
+            for i, j in T.grid(3, 3):
+                with T.block("transpose"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vj, vi]
+
+        @T.prim_func(private=True)
+        def normalize(A: T.Buffer((3, 3), "float32"), B: T.Buffer((3, 3), "float32")):
+            total = T.alloc_buffer((3,), "float32")
+            for i, k in T.grid(3, 3):
+                with T.block("total"):
+                    vi, vk = T.axis.remap("SR", [i, k])
+                    with T.init():
+                        total[vi] = T.float32(0)
+                    total[vi] = total[vi] + A[vi, vk]
+            for i, j in T.grid(3, 3):
+                with T.block("normalize"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] / total[vi]
+
+        @R.function
+        def main(x: R.Tensor((3, 3), dtype="float32")) -> R.Tensor((3, 3), dtype="float32"):
+            cls = NotElementwise
+            with R.dataflow():
+                y = R.add(x, x)
+                # an element of y is read after the corresponding element of z is written
+                z = R.call_tir(cls.transpose, (y,), out_sinfo=R.Tensor((3, 3), dtype="float32"))
+                # z is read by the reduction as well as by the store
+                w = R.call_tir(cls.normalize, (z,), out_sinfo=R.Tensor((3, 3), dtype="float32"))
+                R.output(w)
+            return w
+
+    new_mod = DataflowUseInplaceCalls()(NotElementwise)
+    tvm.ir.assert_structural_equal(new_mod, NotElementwise)
+
+
+def test_inplace_across_dataflow_blocks():
+    @I.ir_module
+    class CrossBlock:
+        @R.function
+        def main(x: R.Tensor((2, 3), dtype="float32")) -> R.Tensor((2, 3), dtype="float32"):
+            with R.dataflow():
+                y = R.add(x, x)
+                R.output(y)
+            w = R.add(x, x)
+            with R.dataflow():
+                # y is the output of the previous block but it is not used later
+                z = R.multiply(y, x)
+                R.output(z)
+            r = R.add(z, w)
+            return r
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def multiply_inplace(
+            A: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+        ):
+            T.func_attr({"tir.noalias": True})
+            for ax0, ax1 in T.grid(T.int64(2), T.int64(3)):
+                with T.block("T_multiply"):
+                    v_ax0, v_ax1 = T.axis.remap("SS", [ax0, ax1])
+                    T.reads(A[v_ax0, v_ax1], B[v_ax0, v_ax1])
+                    T.writes(A[v_ax0, v_ax1])
+                    A[v_ax0, v_ax1] = A[v_ax0, v_ax1] * B[v_ax0, v_ax1]
+
+        @R.function
+        def main(x: R.Tensor((2, 3), dtype="float32")) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Expected
+            with R.dataflow():
+                y: R.Tensor((2, 3), dtype="float32") = R.add(x, x)
+                R.output(y)
+            w: R.Tensor((2, 3), dtype="float32") = R.add(x, x)
+            with R.dataflow():
+                z: R.Tensor((2, 3), dtype="float32") = R.call_tir_inplace(
+                    cls.multiply_inplace,
+                    (y, x),
+                    inplace_indices=[0],
+                    out_sinfo=[
+                        R.Tensor((2, 3), dtype="float32"),
+                    ],
+                )
+                R.output(z)
+            r: R.Tensor((2, 3), dtype="float32") = R.add(z, w)
+            return r
+
+    new_mod = DataflowUseInplaceCalls()(CrossBlock)
+    tvm.ir.assert_structural_equal(new_mod, Expected)
+
+
+def test_inplace_on_subroutine_result():
+    @I.ir_module
+    class Subroutine:
+        @R.function(private=True)
+        def double(x: R.Tensor((2, 3), dtype="float32")) -> R.Tensor((2, 3), dtype="float32"):
+            with R.dataflow():
+                y = R.add(x, x)
+                R.output(y)
+            return y
+
+        @R.function
+        def main(x: R.Tensor((2, 3), dtype="float32")) -> R.Tensor((2, 3), dtype="float32"):
+            cls = Subroutine
+            with R.dataflow():
+                # the result of double never aliases its argument, so it can be overwritten
+                y = cls.double(x)
+                z = R.multiply(y, y)
+                R.output(z)
+            return z
+
+    new_mod = DataflowUseInplaceCalls()(Subroutine)
+    main_bindings = new_mod["main"].body.blocks[0].bindings
+    assert main_bindings[0].value.op.same_as(new_mod.get_global_var("double"))
+    assert main_bindings[1].value.op.same_as(tvm.ir.Op.get("relax.call_tir_inplace"))
+    # the argument of the subroutine is not overwritten
+    tvm.ir.assert_structural_equal(new_mod["double"], Subroutine["double"])
+
+
 if __name__ == "__main__":
     testing.main()
@@ -28,6 +28,9 @@ def test_op_correctness():
     assert relax.op.ccl.allreduce(x).op == Op.get("relax.ccl.allreduce")
     assert relax.op.ccl.broadcast_from_worker0(x).op == Op.get("relax.ccl.broadcast_from_worker0")
     assert relax.op.ccl.allgather(x, 2).op == Op.get("relax.ccl.allgather")
+    assert relax.op.ccl.alltoall(x, 2).op == Op.get("relax.ccl.alltoall")
+    assert relax.op.ccl.ring_send_recv_start(x, 2).op == Op.get("relax.ccl.ring_send_recv_start")
+    assert relax.op.ccl.ring_attention(x, x, x, 2).op == Op.get("relax.ccl.ring_attention")
 
 
 def _check_inference(bb: relax.BlockBuilder, call: relax.Call, expected_sinfo: relax.StructInfo):
@@ -119,6 +122,21 @@ def test_allgather_infer_struct_info_shape_symbolic():
     _check_inference(bb, relax.op.ccl.allgather(x1, 2), relax.TensorStructInfo((8, n), "float32"))
 
 
+def test_alltoall_infer_struct_info():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x0 = relax.Var("x", R.Tensor((4, 3), "float32"))
+    x1 = relax.Var("x", R.Tensor((n * 2, 3), "float16"))
+    x2 = relax.Var("x", R.Tensor((3, 4), "float32"))
+
+    _check_inference(bb, relax.op.ccl.alltoall(x0, 2), relax.TensorStructInfo((4, 3), "float32"))
+    _check_inference(
+        bb, relax.op.ccl.alltoall(x1, 2), relax.TensorStructInfo((n * 2, 3), "float16")
+    )
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.ccl.alltoall(x2, 2))
+
+
 def test_allgather_infer_struct_info_shape_var():
     bb = relax.BlockBuilder()
     s0 = relax.Var("s", relax.ShapeStructInfo(ndim=2))
@@ -272,5 +290,31 @@ def test_scatter_from_worker0_infer_struct_info_more_input_dtype():
     )
 
 
+def test_ring_attention_infer_struct_info():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    q0 = relax.Var("q", R.Tensor((2, n, 8, 64), "float16"))
+    k0 = relax.Var("k", R.Tensor((2, n, 2, 64), "float16"))
+    v0 = relax.Var("v", R.Tensor((2, n, 2, 32), "float16"))
+    q1 = relax.Var("q", R.Tensor("float16", ndim=4))
+    k1 = relax.Var("k", R.Tensor((2, n, 3, 64), "float16"))
+    q2 = relax.Var("q", R.Tensor((2, n, 8), "float16"))
+
+    _check_inference(
+        bb,
+        relax.op.ccl.ring_attention(q0, k0, v0, 4),
+        relax.TensorStructInfo((2, n, 8, 32), "float16"),
+    )
+    _check_inference(
+        bb,
+        relax.op.ccl.ring_attention(q1, k0, v0, 4, causal=True),
+        relax.TensorStructInfo(dtype="float16", ndim=4),
+    )
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.ccl.ring_attention(q0, k1, v0, 4))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.ccl.ring_attention(q2, k0, v0, 4))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
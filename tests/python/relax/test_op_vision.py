@@ -20,7 +20,7 @@ import pytest
 
 import tvm
 import tvm.testing
-from tvm import TVMError, relax, tir
+from tvm import TVMError, relax, te, tir, topi
 from tvm.relax.transform import LegalizeOps
 from tvm.script import relax as R
 
@@ -176,5 +176,101 @@ def test_all_class_non_max_suppression_legalize_e2e():
     tvm.testing.assert_allclose(selected_indices.shape, (num_total_detections, 3))
 
 
+def test_all_class_non_max_suppression_legalize_fixed_output():
+    @tvm.script.ir_module
+    class NMSModule:
+        @R.function
+        def main(
+            boxes: R.Tensor((1, 5, 4), "float32"),
+            scores: R.Tensor((1, 2, 5), "float32"),
+        ):
+            max_output_boxes_per_class = R.const(3, "int64")
+            iou_threshold = R.const(0.5, "float32")
+            score_threshold = R.const(0.1, "float32")
+            return R.vision.all_class_non_max_suppression(
+                boxes,
+                scores,
+                max_output_boxes_per_class,
+                iou_threshold,
+                score_threshold,
+                "onnx",
+                fixed_output=True,
+            )
+
+    mod = LegalizeOps()(NMSModule)
+    assert "dynamic_strided_slice" not in str(mod)
+    tvm.ir.assert_structural_equal(
+        mod["main"].ret_struct_info,
+        relax.TupleStructInfo(
+            [relax.TensorStructInfo((10, 3), "int64"), relax.TensorStructInfo((1,), "int64")]
+        ),
+    )
+
+    boxes_data = np.array(
+        [
+            [
+                [0.0, 0.0, 1.0, 1.0],
+                [0.1, 0.1, 1.1, 1.1],
+                [2.0, 2.0, 3.0, 3.0],
+                [4.0, 4.0, 5.0, 5.0],
+                [6.0, 6.0, 7.0, 7.0],
+            ]
+        ],
+        dtype=np.float32,
+    )
+    scores_data = np.array(
+        [[[0.9, 0.8, 0.7, 0.6, 0.5], [0.85, 0.75, 0.65, 0.55, 0.45]]],
+        dtype=np.float32,
+    )
+    exe = tvm.compile(mod, target="llvm")
+    vm = relax.VirtualMachine(exe, tvm.cpu())
+    result = vm["main"](
+        tvm.runtime.tensor(boxes_data, tvm.cpu()),
+        tvm.runtime.tensor(scores_data, tvm.cpu()),
+    )
+    num_total_detections = int(result[1].numpy()[0])
+    # box 1 overlaps box 0, and only 3 boxes are kept per class
+    assert num_total_detections == 6
+    tvm.testing.assert_allclose(
+        result[0].numpy()[:num_total_detections],
+        [[0, 0, 0], [0, 0, 2], [0, 0, 3], [0, 1, 0], [0, 1, 2], [0, 1, 3]],
+    )
+
+
+@pytest.mark.parametrize("output_format", ["onnx", "tensorflow"])
+def test_all_class_non_max_suppression_bitmask_matches_loop(output_format):
+    batch, num_classes, num_boxes = 2, 3, 40
+    rng = np.random.default_rng(0)
+    corners = rng.uniform(0, 8, size=(batch, num_boxes, 2)).astype("float32")
+    sizes = rng.uniform(1, 4, size=(batch, num_boxes, 2)).astype("float32")
+    boxes_data = np.concatenate([corners, corners + sizes], axis=2)
+    scores_data = rng.uniform(0, 1, size=(batch, num_classes, num_boxes)).astype("float32")
+
+    def run(use_bitmask):
+        boxes = te.placeholder((batch, num_boxes, 4), name="boxes")
+        scores = te.placeholder((batch, num_classes, num_boxes), name="scores")
+        outs = topi.vision.all_class_non_max_suppression(
+            boxes, scores, 8, 0.4, 0.2, output_format, use_bitmask=use_bitmask
+        )
+        func = te.create_prim_func([boxes, scores] + list(outs))
+        lib = tvm.compile(func, target="llvm")
+        args = [tvm.runtime.tensor(boxes_data), tvm.runtime.tensor(scores_data)]
+        args += [tvm.runtime.empty([int(x) for x in o.shape], o.dtype) for o in outs]
+        lib(*args)
+        return [arg.numpy() for arg in args[2:]]
+
+    loop, bitmask = run(False), run(True)
+    if output_format == "onnx":
+        count = int(loop[1][0])
+        assert count == int(bitmask[1][0])
+        tvm.testing.assert_allclose(bitmask[0][:count], loop[0][:count])
+    else:
+        tvm.testing.assert_allclose(bitmask[2], loop[2])
+        for b in range(batch):
+            count = int(loop[2][b])
+            tvm.testing.assert_allclose(bitmask[0][b, :count], loop[0][b, :count])
+            tvm.testing.assert_allclose(bitmask[1][b, :count], loop[1][b, :count])
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -22,6 +22,8 @@ import pytest
 import numpy as np
 
 from tvm.ir import assert_structural_equal
+from tvm.script import ir as I
+from tvm.script import relax as R
 from tvm.relax.testing.runtime_builtin import MatchShapeCode, MakeShapeCode
 
 
@@ -188,6 +190,32 @@ def test_tensor_cache():
         tvm.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_tensor_cache_load_parallel():
+    fload_parallel = tvm.get_global_func("vm.builtin.tensor_cache.load_parallel")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    param_dict = {
+        f"y_{i}": np.random.uniform(size=[256, 1024]).astype("float32") for i in range(4)
+    }
+    param_dict["y_4"] = np.array([1, 2, 3], dtype="int32")
+
+    temp = utils.tempdir()
+    # Each 1MB shard holds a single parameter, so that the shards are loaded in parallel.
+    tvmjs.dump_tensor_cache(param_dict, temp.path, encode_format="f32-to-bf16", shard_cap_mb=1)
+    stats = fload_parallel(str(temp.path), tvm.cpu().dlpack_device_type(), 0, 4)
+    assert len(stats) > 1
+    assert sum(int(shard["nbytes"]) for shard in stats) == sum(
+        v.size * (2 if v.dtype == "float32" else 4) for v in param_dict.values()
+    )
+    res = fget_params("y", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        v_np = param_dict[f"y_{i}"]
+        if v_np.dtype == "float32":
+            v_np = tvmjs._convert_bf16_to_f32(tvmjs._convert_f32_to_bf16(v_np))
+        tvm.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
+
+
 def test_tensor_cache_update():
     fload = tvm.get_global_func("vm.builtin.tensor_cache.load")
     fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
@@ -213,6 +241,71 @@ def test_tensor_cache_update():
         tvm.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_tensor_cache_transformed_params():
+    fload = tvm.get_global_func("vm.builtin.tensor_cache.load")
+    fload_transformed = tvm.get_global_func("vm.builtin.tensor_cache.load_transformed")
+    fsave_transformed = tvm.get_global_func("vm.builtin.tensor_cache.save_transformed")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+    fclear = tvm.get_global_func("vm.builtin.tensor_cache.clear")
+    device_type = tvm.cpu().dlpack_device_type()
+
+    param_dict = {"w_0": np.random.uniform(size=[16, 8]).astype("float32")}
+    temp = utils.tempdir()
+    tvmjs.dump_tensor_cache(param_dict, temp.path, encode_format="raw")
+    assert not fload_transformed(str(temp.path), "abc", device_type, 0)
+
+    # Transform the parameters once, and save the result next to the cache.
+    fload(str(temp.path), device_type, 0)
+    packed = [
+        tvm.runtime.tensor(param_dict["w_0"].T.copy()),
+        tvm.runtime.tensor(np.arange(6, dtype="int8")),
+    ]
+    fsave_transformed(str(temp.path), "abc", ["packed_0", "packed_1"], packed)
+    fclear()
+
+    assert fload_transformed(str(temp.path), "abc", device_type, 0)
+    res = fget_params("packed", -1)
+    assert len(res) == 2
+    tvm.testing.assert_allclose(res[0].numpy(), param_dict["w_0"].T)
+    tvm.testing.assert_allclose(res[1].numpy(), np.arange(6, dtype="int8"))
+
+    # The transformed parameters are stale once the parameters of the cache change.
+    param_dict["w_0"] = np.random.uniform(size=[16, 8]).astype("float32")
+    tvmjs.dump_tensor_cache(param_dict, temp.path, encode_format="raw")
+    assert not fload_transformed(str(temp.path), "abc", device_type, 0)
+    fclear()
+
+
+def _transform_module(transpose: bool, main_offset: float):
+    transform_op = R.permute_dims if transpose else R.negative
+
+    @I.ir_module
+    class Module:
+        @R.function
+        def transform_params(params: R.Tuple(R.Tensor((16, 16), "float32"))):
+            with R.dataflow():
+                w = params[0]
+                w_t = transform_op(w)
+                R.output(w_t)
+            return (w_t,)
+
+        @R.function
+        def main(x: R.Tensor((4, 16), "float32")):
+            with R.dataflow():
+                y = R.add(x, R.const(main_offset, "float32"))
+                R.output(y)
+            return y
+
+    return Module
+
+
+def test_transform_params_hash():
+    hash_0 = tvmjs.transform_params_hash(_transform_module(True, 1.0))
+    # Changes outside of the transform keep its hash.
+    assert tvmjs.transform_params_hash(_transform_module(True, 2.0)) == hash_0
+    assert tvmjs.transform_params_hash(_transform_module(False, 1.0)) != hash_0
+
+
 def test_attention_kv_cache_window_override():
     fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create")
     foverride = tvm.get_global_func("vm.builtin.attention_kv_cache_window_override")
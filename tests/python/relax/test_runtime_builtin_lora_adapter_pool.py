@@ -0,0 +1,106 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-docstring
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.runtime import ShapeTuple
+
+rank = 4
+hidden = 8
+weight_shapes = [ShapeTuple([rank, hidden]), ShapeTuple([hidden, rank])]
+
+
+def create_pool(num_slots):
+    f_create = tvm.get_global_func("vm.builtin.lora_adapter_pool_create")
+    f_add = tvm.get_global_func("vm.builtin.lora_adapter_pool_add_adapter")
+    pool = f_create(num_slots, weight_shapes, "float32", tvm.cpu())
+    weights = {}
+    for adapter_id in range(4):
+        weights[adapter_id] = [
+            np.full(tuple(shape), adapter_id + 1, "float32") * (i + 1)
+            for i, shape in enumerate(weight_shapes)
+        ]
+        f_add(pool, adapter_id, [tvm.runtime.tensor(w) for w in weights[adapter_id]])
+    return pool, weights
+
+
+def begin_forward(pool, adapter_ids, append_lengths):
+    f_begin_forward = tvm.get_global_func("vm.builtin.lora_adapter_pool_begin_forward")
+    f_get_indptr = tvm.get_global_func("vm.builtin.lora_adapter_pool_get_segment_indptr")
+    f_get_perm = tvm.get_global_func("vm.builtin.lora_adapter_pool_get_token_permutation")
+    f_begin_forward(pool, ShapeTuple(adapter_ids), ShapeTuple(append_lengths))
+    return f_get_indptr(pool).numpy(), f_get_perm(pool).numpy()
+
+
+def get_resident_weights(pool, indptr, perm, append_lengths, adapter_ids):
+    """Check the grouping, and return the adapter of each slot with tokens."""
+    f_get_weight_pool = tvm.get_global_func("vm.builtin.lora_adapter_pool_get_weight_pool")
+    seq_of_token = np.repeat(np.arange(len(append_lengths)), append_lengths)
+    assert sorted(perm.tolist()) == list(range(sum(append_lengths)))
+    slot_adapters = {}
+    begin = 0
+    for slot, end in enumerate(indptr):
+        for token in perm[begin:end]:
+            adapter_id = adapter_ids[seq_of_token[token]]
+            assert slot_adapters.setdefault(slot, adapter_id) == adapter_id
+        begin = end
+    # The tokens without adapter come last.
+    for token in perm[begin:]:
+        assert adapter_ids[seq_of_token[token]] == -1
+    pools = [f_get_weight_pool(pool, i).numpy() for i in range(len(weight_shapes))]
+    return slot_adapters, pools
+
+
+def test_lora_adapter_pool_grouping():
+    pool, weights = create_pool(num_slots=2)
+    adapter_ids = [1, -1, 0, 1]
+    append_lengths = [3, 2, 1, 4]
+    indptr, perm = begin_forward(pool, adapter_ids, append_lengths)
+    assert indptr[-1] == 8
+    slot_adapters, pools = get_resident_weights(pool, indptr, perm, append_lengths, adapter_ids)
+    assert sorted(slot_adapters.values()) == [0, 1]
+    for slot, adapter_id in slot_adapters.items():
+        for i, pool_weight in enumerate(pools):
+            tvm.testing.assert_allclose(pool_weight[slot], weights[adapter_id][i])
+
+
+def test_lora_adapter_pool_lru_eviction():
+    pool, weights = create_pool(num_slots=2)
+    f_get_stats = tvm.get_global_func("vm.builtin.lora_adapter_pool_get_stats")
+    begin_forward(pool, [0, 1], [1, 1])
+    begin_forward(pool, [1], [1])
+    # Adapter 0 is the least recently used, and is evicted for adapter 2.
+    indptr, perm = begin_forward(pool, [2, 1], [2, 1])
+    slot_adapters, pools = get_resident_weights(pool, indptr, perm, [2, 1], [2, 1])
+    assert sorted(slot_adapters.values()) == [1, 2]
+    for slot, adapter_id in slot_adapters.items():
+        for i, pool_weight in enumerate(pools):
+            tvm.testing.assert_allclose(pool_weight[slot], weights[adapter_id][i])
+    stats = f_get_stats(pool)
+    assert stats["num_loads"] == 3
+    assert stats["num_evictions"] == 1
+
+    with pytest.raises(tvm.error.InternalError):
+        # More distinct adapters than slots in a batch.
+        begin_forward(pool, [0, 1, 2], [1, 1, 1])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
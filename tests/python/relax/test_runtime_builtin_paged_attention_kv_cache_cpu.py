@@ -54,6 +54,7 @@ rope_scale = 1.0
 rope_theta = 1e4
 rope_scaling = {}
 dtype = None
+kv_dtype = None
 device = tvm.cpu()
 
 fclear = None
@@ -68,6 +69,15 @@ fcommit_accepted_token_tree_nodes = None
 fattention_with_fuse_qkv = None
 fis_empty = None
 fdebug_get_kv = None
+fcommit_sequence_prefix = None
+fmatch_prefix = None
+fadd_sequence_with_prefix = None
+fevict_prefix_cache = None
+foffload_sequence = None
+fget_num_available_pages = None
+fprefetch_sequence = None
+fget_page_fragmentation = None
+fdefragment_pages = None
 
 ftranspose_append = None
 fcopy_cache = None
@@ -85,10 +95,13 @@ fcopy_single_page = None
 fcompact_copy = None
 
 
-def set_global_func(head_dim, dtype):
+def set_global_func(head_dim, dtype, kv_dtype=None):
     global fclear, fadd_sequence, fremove_sequence, ffork_sequence, fenable_sliding_window_for_seq
     global fpopn, fbegin_forward, fend_forward, fcommit_accepted_token_tree_nodes
     global fattention_with_fuse_qkv, fis_empty, fdebug_get_kv
+    global fcommit_sequence_prefix, fmatch_prefix, fadd_sequence_with_prefix, fevict_prefix_cache
+    global foffload_sequence, fprefetch_sequence, fget_num_available_pages
+    global fget_page_fragmentation, fdefragment_pages
     global ftranspose_append, fcopy_cache, fattn_prefill, fattn_decode
     global fattn_prefill_ragged, fattn_prefill_with_tree_mask, fattn_prefill_with_tree_mask_paged_kv_cache
     global fattn_prefill_sliding_window, fattn_decode_sliding_window
@@ -112,29 +125,54 @@ def set_global_func(head_dim, dtype):
     )
     fis_empty = tvm.get_global_func("vm.builtin.attention_kv_cache_empty")
     fdebug_get_kv = tvm.get_global_func("vm.builtin.attention_kv_cache_debug_get_kv")
+    fcommit_sequence_prefix = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_commit_sequence_prefix"
+    )
+    fmatch_prefix = tvm.get_global_func("vm.builtin.attention_kv_cache_match_prefix")
+    fadd_sequence_with_prefix = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_add_sequence_with_prefix"
+    )
+    fevict_prefix_cache = tvm.get_global_func("vm.builtin.attention_kv_cache_evict_prefix_cache")
+    foffload_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_offload_sequence")
+    fprefetch_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_prefetch_sequence")
+    fget_num_available_pages = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_num_available_pages"
+    )
+    fget_page_fragmentation = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_page_fragmentation"
+    )
+    fdefragment_pages = tvm.get_global_func("vm.builtin.attention_kv_cache_defragment_pages")
 
     target = tvm.target.Target.from_device(device)
     builts = []
     for tir_func in [
-        _kv_cache_transpose_append(num_kv_heads, head_dim, dtype),
-        _kv_cache_debug_get_kv(num_layers, num_kv_heads, head_dim, dtype),
-        _attention_prefill_cpu(num_kv_heads, num_qo_heads, head_dim, dtype, False, rope_scaling),
-        _attention_decode_cpu(num_kv_heads, num_qo_heads, head_dim, dtype, False, rope_scaling),
-        _attention_prefill_cpu(num_kv_heads, num_qo_heads, head_dim, dtype, True, rope_scaling),
-        _attention_decode_cpu(num_kv_heads, num_qo_heads, head_dim, dtype, True, rope_scaling),
+        _kv_cache_transpose_append(num_kv_heads, head_dim, dtype, kv_dtype=kv_dtype),
+        _kv_cache_debug_get_kv(num_layers, num_kv_heads, head_dim, dtype, kv_dtype=kv_dtype),
+        _attention_prefill_cpu(
+            num_kv_heads, num_qo_heads, head_dim, dtype, False, rope_scaling, kv_dtype=kv_dtype
+        ),
+        _attention_decode_cpu(
+            num_kv_heads, num_qo_heads, head_dim, dtype, False, rope_scaling, kv_dtype=kv_dtype
+        ),
+        _attention_prefill_cpu(
+            num_kv_heads, num_qo_heads, head_dim, dtype, True, rope_scaling, kv_dtype=kv_dtype
+        ),
+        _attention_decode_cpu(
+            num_kv_heads, num_qo_heads, head_dim, dtype, True, rope_scaling, kv_dtype=kv_dtype
+        ),
         _attention_prefill_ragged_cpu(
             num_kv_heads, num_qo_heads, head_dim, head_dim, dtype, rope_scaling
         ),
         tree_attn_cpu(num_kv_heads, num_qo_heads, head_dim, dtype, rope_scaling),
         tree_attn_with_paged_kv_cache_cpu(
-            num_kv_heads, num_qo_heads, head_dim, dtype, rope_scaling
+            num_kv_heads, num_qo_heads, head_dim, dtype, rope_scaling, kv_dtype=kv_dtype
         ),
         _merge_state_inplace_cpu(dtype),
         llama_rope_with_position_map(
             rope_theta, rope_scale, head_dim, num_qo_heads, num_kv_heads, dtype, rope_scaling
         ),
-        _copy_single_page_cpu(num_kv_heads, page_size, head_dim, dtype),
-        _compact_kv_copy_cpu(num_kv_heads, head_dim, dtype),
+        _copy_single_page_cpu(num_kv_heads, page_size, head_dim, dtype, kv_dtype=kv_dtype),
+        _compact_kv_copy_cpu(num_kv_heads, head_dim, dtype, kv_dtype=kv_dtype),
     ]:
         mod = tvm.IRModule({"main": tir_func})
         with target:
@@ -159,8 +197,10 @@ def set_global_func(head_dim, dtype):
     ) = builts
 
 
-def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window):
+def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window, kv_dtype=None):
     fcreate = tvm.get_global_func("vm.builtin.paged_attention_kv_cache_create")
+    # The KV pages are stored in the dtype of the optional last argument.
+    kv_dtype_args = [] if kv_dtype is None else [tvm.runtime.empty((), kv_dtype, device=device)]
     cache = fcreate(
         tvm.runtime.ShapeTuple(
             [
@@ -198,6 +238,7 @@ def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window):
         fcopy_single_page,
         fcopy_cache,
         fcompact_copy,
+        *kv_dtype_args,
     )
     return cache
 
@@ -251,6 +292,12 @@ def verify_cached_kv(kv_cache, seq_ids, expected_k, expected_v):
         tvm.testing.assert_allclose(values.numpy(), values_expected, rtol=1e-3, atol=1e-3)
 
 
+def round_to_kv_dtype(x):
+    # The pages keep K/V in the storage dtype, which the attention reads back.
+    # Rounding is idempotent, so the cached prefix can be rounded again.
+    return x if kv_dtype is None else x.astype(kv_dtype).astype(dtype)
+
+
 def f_apply_rotary(x, offset, scale, theta, offset_list: Optional[List[int]] = None):
     # x: (N, H, D)
     assert len(x.shape) == 3
@@ -387,6 +434,8 @@ def apply_attention(
             axis=1,
         )
         cached_v[seq_id] = np.concatenate([cached_v[seq_id], new_v], axis=1)
+        cached_k[seq_id] = round_to_kv_dtype(cached_k[seq_id])
+        cached_v[seq_id] = round_to_kv_dtype(cached_v[seq_id])
         global_new_q = np.concatenate([global_new_q, new_q], axis=1)
         global_new_k = np.concatenate([global_new_k, new_k], axis=1)
         global_new_v = np.concatenate([global_new_v, new_v], axis=1)
@@ -668,6 +717,153 @@ def test_paged_attention_kv_cache_fork_sequence(kv_cache_and_config):
     apply_attention(kv_cache, rope_mode, [(10, 1), (12, 1)], cached_k, cached_v)
 
 
+def test_paged_attention_kv_cache_prefix_cache(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    system_prompt = list(range(100, 140))
+    apply_attention(kv_cache, rope_mode, [(0, len(system_prompt))], cached_k, cached_v)
+    # Only the full pages of the 40 tokens are committed.
+    fcommit_sequence_prefix(kv_cache, 0, ShapeTuple(system_prompt))
+    assert fmatch_prefix(kv_cache, ShapeTuple(system_prompt + [0, 1])) == 32
+    # At least one token is left for prefill.
+    assert fmatch_prefix(kv_cache, ShapeTuple(system_prompt[:32])) == 31
+    assert fmatch_prefix(kv_cache, ShapeTuple([0] + system_prompt)) == 0
+
+    # The committed pages outlive the committed sequence.
+    prefix_k = cached_k.pop(0)
+    prefix_v = cached_v.pop(0)
+    fremove_sequence(kv_cache, 0)
+
+    # Attach new sequences to the cached prefix, forking within and at the page boundary.
+    for seq_id, num_shared in [(1, 20), (2, 32)]:
+        tokens = system_prompt[:num_shared] + [seq_id] * 5
+        assert fadd_sequence_with_prefix(kv_cache, seq_id, ShapeTuple(tokens)) == num_shared
+        cached_k[seq_id] = prefix_k[:, :num_shared]
+        cached_v[seq_id] = prefix_v[:, :num_shared]
+    verify_cached_kv(kv_cache, [1, 2], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(1, 5), (2, 5)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(1, 1), (2, 1)], cached_k, cached_v)
+
+    # A sequence without a shared prefix falls back to an empty sequence.
+    assert fadd_sequence_with_prefix(kv_cache, 3, ShapeTuple([7, 8, 9])) == 0
+    cached_k[3] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    cached_v[3] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    apply_attention(kv_cache, rope_mode, [(3, 3)], cached_k, cached_v)
+
+    for seq_id in [1, 2, 3]:
+        fremove_sequence(kv_cache, seq_id)
+    assert not fis_empty(kv_cache), "The prefix cache should still hold the committed pages"
+    assert fevict_prefix_cache(kv_cache, -1) > 0
+    assert fmatch_prefix(kv_cache, ShapeTuple(system_prompt)) == 0
+    assert fis_empty(kv_cache), "The KV cache is not empty after evicting the prefix cache"
+
+
+def test_paged_attention_kv_cache_offload(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 37), (1, 20)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [((2, 0, 32), 9)], cached_k, cached_v)
+    num_available_pages = fget_num_available_pages(kv_cache)
+
+    # Sequence 2 shares the first two pages with sequence 0, which stay in the cache.
+    foffload_sequence(kv_cache, 0)
+    foffload_sequence(kv_cache, 2)
+    assert fget_num_available_pages(kv_cache) == num_available_pages + 2
+    with pytest.raises(tvm.error.InternalError):
+        fbegin_forward(kv_cache, ShapeTuple([0]), ShapeTuple([1]))
+
+    # Other sequences keep running, and may reuse the released pages.
+    apply_attention(kv_cache, rope_mode, [(1, 30)], cached_k, cached_v)
+    fremove_sequence(kv_cache, 1)
+    cached_k.pop(1)
+    cached_v.pop(1)
+
+    fprefetch_sequence(kv_cache, 0)
+    fprefetch_sequence(kv_cache, 2)
+    verify_cached_kv(kv_cache, [0, 2], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (2, 1)], cached_k, cached_v)
+
+    # Removing an offloaded sequence drops its host copy.
+    foffload_sequence(kv_cache, 2)
+    for seq_id in [0, 2]:
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+def test_paged_attention_kv_cache_defragment(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    # The sequences grow in turns, so that their pages interleave.
+    apply_attention(kv_cache, rope_mode, [(0, 20), (1, 20), (2, 20)], cached_k, cached_v)
+    for _ in range(3):
+        apply_attention(kv_cache, rope_mode, [(0, 16), (1, 16), (2, 16)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [((3, 0, 40), 10)], cached_k, cached_v)
+    fremove_sequence(kv_cache, 1)
+    cached_k.pop(1)
+    cached_v.pop(1)
+
+    num_used_pages, num_free_runs, _, num_page_breaks = fget_page_fragmentation(kv_cache)
+    assert num_free_runs > 1 and num_page_breaks > 0
+    assert fdefragment_pages(kv_cache) > 0
+    fragmentation = fget_page_fragmentation(kv_cache)
+    assert fragmentation[0] == num_used_pages
+    assert fragmentation[1] == 1 and fragmentation[2] == fget_num_available_pages(kv_cache)
+    # Only sequence 3 breaks, from the prefix shared with sequence 0 to its own pages.
+    assert fragmentation[3] == 1
+    assert fdefragment_pages(kv_cache) == 0
+
+    verify_cached_kv(kv_cache, [0, 2, 3], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (2, 1), (3, 1)], cached_k, cached_v)
+    for seq_id in [0, 2, 3]:
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+def test_paged_attention_kv_cache_incremental_aux_data_copy(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    # Enough sequences and pages for the aux data to span several compared chunks, where each
+    # step only copies the chunks changed from the previous one. The attention of every step
+    # is checked against the reference, which a full copy of the aux data gives.
+    num_seqs = 30
+    for begin in range(0, num_seqs, 10):
+        prefill = [(i, 20 + i) for i in range(begin, begin + 10)]
+        apply_attention(kv_cache, rope_mode, prefill, cached_k, cached_v)
+    decode_all = [(i, 1) for i in range(num_seqs)]
+    decode_even = [(i, 1) for i in range(0, num_seqs, 2)]
+    # Decode steps only change the page tables of the sequences crossing a page boundary, and
+    # the batches shrink, grow and mix prefill with decode in between.
+    for batch in [decode_all, decode_all, decode_even, decode_all, decode_even]:
+        apply_attention(kv_cache, rope_mode, batch, cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, decode_all[:-1] + [(num_seqs - 1, 17)], cached_k, cached_v)
+    for _ in range(3):
+        apply_attention(kv_cache, rope_mode, decode_all, cached_k, cached_v)
+
+
 def test_paged_attention_kv_cache_unlimited_depth(kv_cache_and_config):
     kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
     if support_sliding_window and rope_mode == RopeMode.NORMAL:
@@ -796,6 +992,48 @@ def test_paged_attention_kv_cache_sliding_window(kv_cache_and_config):
         )
 
 
+def test_paged_attention_kv_cache_sliding_window_recycle_pages(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if not support_sliding_window or rope_mode == RopeMode.NORMAL:
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    sliding_window_sizes = [40]
+    attn_sink_sizes = [4]
+    fadd_sequence(kv_cache, 0)
+    fenable_sliding_window_for_seq(kv_cache, 0, sliding_window_sizes[0], attn_sink_sizes[0])
+    cached_k[0] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    cached_v[0] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+
+    # The sliding part of the window starts within its first two pages, which bounds the
+    # pages it holds.
+    sliding_length = sliding_window_sizes[0] - attn_sink_sizes[0]
+    max_num_pages = (2 * page_size - 1 + sliding_length + page_size - 1) // page_size
+
+    def step(append_length):
+        apply_attention(
+            kv_cache,
+            rope_mode,
+            [(0, append_length)],
+            cached_k,
+            cached_v,
+            sliding_window_sizes,
+            attn_sink_sizes,
+        )
+        assert fget_page_fragmentation(kv_cache)[0] <= max_num_pages
+
+    # Fill the window, then slide it by single tokens and by appends of up to half a
+    # page, which recycle the slidden pages in place, over several turns of its pages.
+    step(40)
+    for append_length in [1] * (4 * page_size) + [page_size // 2] * 6 + [3, 5, 1, 7, 1]:
+        step(append_length)
+    # Longer appends take the pages from the free list again.
+    step(page_size)
+    step(1)
+
+
 def test_paged_attention_kv_cache_sliding_window_fork(kv_cache_and_config):
     kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
     if not support_sliding_window or rope_mode == RopeMode.NORMAL:
@@ -863,6 +1101,31 @@ def test_paged_attention_kv_cache_sliding_window_fork(kv_cache_and_config):
     # seq_len: [15+6, 20+13, 25+7, 38, 41, 43, 24+6]
 
 
+def test_paged_attention_kv_cache_narrow_kv_dtype():
+    global head_dim, sm_scale, dtype, kv_dtype
+    head_dim, dtype, kv_dtype = 64, "float32", "float16"
+    sm_scale = head_dim ** (-0.5)
+    try:
+        set_global_func(head_dim, dtype, kv_dtype)
+        kv_cache = create_kv_cache(head_dim, dtype, RopeMode.NONE, False, kv_dtype)
+        cached_k = {}
+        cached_v = {}
+        # Prefill over several pages, then decode, against the rounded K/V.
+        for batch in [[(0, 6), (1, 35)], [(0, 1), (1, 1)], [(0, 17), (1, 1)]]:
+            apply_attention(kv_cache, RopeMode.NONE, batch, cached_k, cached_v)
+
+        # The pages hold exactly the K/V rounded to float16.
+        for seq_id in [0, 1]:
+            shape = cached_k[seq_id].shape
+            keys = tvm.runtime.empty(shape, dtype=dtype, device=device)
+            values = tvm.runtime.empty(shape, dtype=dtype, device=device)
+            fdebug_get_kv(kv_cache, seq_id, 0, shape[1], keys, values)
+            np.testing.assert_equal(keys.numpy(), cached_k[seq_id])
+            np.testing.assert_equal(values.numpy(), cached_v[seq_id])
+    finally:
+        kv_dtype = None
+
+
 def test_paged_attention_kv_cache_tree_attn(kv_cache_and_config):
     kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
     if support_sliding_window:
@@ -960,7 +1223,11 @@ if __name__ == "__main__":
         test_paged_attention_kv_cache_prefill_and_decode(cache_and_config)
         test_paged_attention_kv_cache_remove_sequence(cache_and_config)
         test_paged_attention_kv_cache_fork_sequence(cache_and_config)
+        test_paged_attention_kv_cache_prefix_cache(cache_and_config)
+        test_paged_attention_kv_cache_offload(cache_and_config)
         test_paged_attention_kv_cache_popn(cache_and_config)
         test_paged_attention_kv_cache_sliding_window(cache_and_config)
+        test_paged_attention_kv_cache_sliding_window_recycle_pages(cache_and_config)
         test_paged_attention_kv_cache_tree_attn(cache_and_config)
+        test_paged_attention_kv_cache_incremental_aux_data_copy(cache_and_config)
         test_paged_attention_kv_cache_unlimited_depth(cache_and_config)
@@ -610,6 +610,30 @@ def test_paged_attention_kv_cache_prefill_and_decode(kv_cache_and_config):
         apply_attention(kv_cache, rope_mode, batch, cached_k, cached_v)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_mixed_prefill_decode(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    # Prefill.
+    operation_seq = [[(0, 6), (1, 8), (2, 11)]]
+    # Decodes placed before the chunked prefills of long and new sequences.
+    operation_seq += [[(0, 1), (1, 1), (2, 37), (3, 29)]]
+    operation_seq += [[(0, 1), (3, 1), (1, 1), (2, 1), (4, 64)]]
+    operation_seq += [[(4, 1), (0, 1), (1, 1), (2, 1), (3, 1)]]
+    # Decodes after a prefill still run with a single kernel.
+    operation_seq += [[(4, 33), (0, 1), (1, 1)]]
+
+    cached_k = {}
+    cached_v = {}
+    for batch in operation_seq:
+        apply_attention(kv_cache, rope_mode, batch, cached_k, cached_v)
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_paged_attention_kv_cache_remove_sequence(kv_cache_and_config):
@@ -961,6 +985,27 @@ def test_paged_attention_kv_cache_tree_attn(kv_cache_and_config):
     for _ in range(5):
         apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1), (3, 1)], cached_k, cached_v)
 
+    # Test the cases where the last tree of the batch is a chain.
+    fclear(kv_cache)
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 10), (1, 20), (2, 30)], cached_k, cached_v)
+    apply_attention(
+        kv_cache,
+        rope_mode,
+        [(0, 7), (1, 15), (2, 5)],
+        cached_k,
+        cached_v,
+        token_tree_parent_ptr_list=[
+            [-1, 0, 0, 1, 1, 2, 2],  # complete binary tree of height 3
+            [-1, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6],  # complete binary tree of height 4
+            [-1, 0, 1, 2, 3],  # chain of length 5
+        ],
+        accepted_leaf_indices=[5, 12, 3],
+    )
+    for _ in range(3):
+        apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1)], cached_k, cached_v)
+
     # Test the cases where all trees are chains.
     fclear(kv_cache)
     cached_k = {}
@@ -1024,6 +1069,7 @@ if __name__ == "__main__":
         cache = create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window)
         cache_and_config = (cache, rope_mode, support_sliding_window)
         test_paged_attention_kv_cache_prefill_and_decode(cache_and_config)
+        test_paged_attention_kv_cache_mixed_prefill_decode(cache_and_config)
         test_paged_attention_kv_cache_remove_sequence(cache_and_config)
         test_paged_attention_kv_cache_fork_sequence(cache_and_config)
         test_paged_attention_kv_cache_popn(cache_and_config)
@@ -51,6 +51,7 @@ f_end_forward = None
 f_get = None
 f_set = None
 f_debug_get = None
+f_checkpoint_sequence = None
 
 f_tir_gets = []
 f_tir_sets = []
@@ -60,7 +61,7 @@ f_tir_sets = []
 
 def set_global_func():
     global f_clear, f_add_sequence, f_remove_sequence, f_fork_sequence, f_popn
-    global f_begin_forward, f_end_forward, f_get, f_set, f_debug_get
+    global f_begin_forward, f_end_forward, f_get, f_set, f_debug_get, f_checkpoint_sequence
     global f_tir_gets, f_tir_sets
 
     f_clear = tvm.get_global_func("vm.builtin.kv_state_clear")
@@ -73,6 +74,7 @@ def set_global_func():
     f_get = tvm.get_global_func("vm.builtin.rnn_state_get")
     f_set = tvm.get_global_func("vm.builtin.rnn_state_set")
     f_debug_get = tvm.get_global_func("vm.builtin.rnn_state_debug_get")
+    f_checkpoint_sequence = tvm.get_global_func("vm.builtin.rnn_state_checkpoint_sequence")
 
     target = tvm.target.Target("cuda")
 
@@ -182,6 +184,43 @@ def test_rnn_state_fork_sequence(rnn_state):  # pylint: disable=redefined-outer-
     verify_state(state, [0, 1], [[np_two, np_three], [np_zero, np_one]])
 
 
+@tvm.testing.requires_cuda
+def test_rnn_state_checkpoint(rnn_state):  # pylint: disable=redefined-outer-name
+    state = rnn_state
+    f_clear(state)
+
+    f_add_sequence(state, 0)
+    f_begin_forward(state, ShapeTuple([0]), ShapeTuple([1]))
+    f_set(state, 0, 0, tvm.runtime.tensor(np_two.reshape(1, 16, 16), device=device))
+    f_set(state, 0, 1, tvm.runtime.tensor(np_three.reshape(1, 32, 32), device=device))
+    f_end_forward(state)
+    f_checkpoint_sequence(state, 0)
+
+    # A prefill clears the history, which the checkpoint outlives.
+    f_begin_forward(state, ShapeTuple([0]), ShapeTuple([8]))
+    f_set(state, 0, 0, tvm.runtime.tensor(np_zero.reshape(1, 16, 16), device=device))
+    f_set(state, 0, 1, tvm.runtime.tensor(np_one.reshape(1, 32, 32), device=device))
+    f_end_forward(state)
+    verify_state(state, [0], [[np_zero, np_one]])
+
+    # Fork at the checkpoint, and roll back to the checkpoint.
+    f_fork_sequence(state, 0, 1, 1)
+    verify_state(state, [0, 1], [[np_zero, np_one], [np_two, np_three]])
+    f_popn(state, 0, 8)
+    verify_state(state, [0, 1], [[np_two, np_three], [np_two, np_three]])
+    with pytest.raises(tvm.error.TVMError):
+        f_popn(state, 0, 1)  # no history nor checkpoint to roll back to
+
+    # The forked sequence keeps the shared checkpoint after the parent is removed.
+    f_remove_sequence(state, 0)
+    f_begin_forward(state, ShapeTuple([1]), ShapeTuple([4]))
+    f_set(state, 0, 0, tvm.runtime.tensor(np_zero.reshape(1, 16, 16), device=device))
+    f_set(state, 0, 1, tvm.runtime.tensor(np_one.reshape(1, 32, 32), device=device))
+    f_end_forward(state)
+    f_popn(state, 1, 4)
+    verify_state(state, [1], [[np_two, np_three]])
+
+
 def rnn_state_get(
     shape: Sequence[int],
     dtype: str,
@@ -263,3 +302,4 @@ if __name__ == "__main__":
     test_rnn_state_set(rnn_state)
     test_rnn_state_popn(rnn_state)
     test_rnn_state_fork_sequence(rnn_state)
+    test_rnn_state_checkpoint(rnn_state)
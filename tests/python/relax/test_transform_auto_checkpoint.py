@@ -0,0 +1,106 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.ir.base import assert_structural_equal
+from tvm.script.parser import ir as I, relax as R
+
+# The bytes of each (64, 64) float32 activation.
+ACT_BYTES = 64 * 64 * 4
+
+
+# fmt: off
+@I.ir_module
+class Before:
+    @R.function
+    def main(x: R.Tensor((64, 64), "float32")):
+        with R.dataflow():
+            lv1 = R.power(x, R.const(3, "float32"))
+            lv2 = R.power(lv1, R.const(3, "float32"))
+            lv3 = R.power(lv2, R.const(3, "float32"))
+            lv4 = R.power(lv3, R.const(3, "float32"))
+            lv5 = R.power(lv4, R.const(3, "float32"))
+            gv = R.sum(lv5)
+            R.output(gv)
+        return gv
+# fmt: on
+
+
+def test_checkpoint_under_budget():
+    # fmt: off
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((64, 64), "float32")) -> R.Tensor((), "float32"):
+            with R.dataflow():
+                x_scp = R.grad.start_checkpoint(x)
+                lv1 = R.power(x_scp, R.const(3, "float32"))
+                lv1_ecp = R.grad.end_checkpoint(lv1)
+                lv2 = R.power(lv1_ecp, R.const(3, "float32"))
+                lv2_scp = R.grad.start_checkpoint(lv2)
+                lv3 = R.power(lv2_scp, R.const(3, "float32"))
+                lv3_ecp = R.grad.end_checkpoint(lv3)
+                lv4 = R.power(lv3_ecp, R.const(3, "float32"))
+                lv4_scp = R.grad.start_checkpoint(lv4)
+                lv5 = R.power(lv4_scp, R.const(3, "float32"))
+                lv5_ecp = R.grad.end_checkpoint(lv5)
+                gv = R.sum(lv5_ecp)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    # Keeping lv2 and lv4 and recomputing one activation at a time fits 3 activations.
+    After = relax.transform.AutoCheckpoint("main", 3 * ACT_BYTES + 4)(Before)
+    assert_structural_equal(After, Expected)
+
+    adjoint = relax.transform.Gradient("main")(After)["main_adjoint"]
+    names = [binding.var.name_hint for binding in adjoint.body.blocks[0].bindings]
+    # The backward of power reads its input, so lv1 and lv3 are recomputed, but not lv5.
+    for name in ["lv1_cp", "lv3_cp"]:
+        assert name in names
+    for name in ["lv2_cp", "lv4_cp", "lv5_cp"]:
+        assert name not in names
+
+
+def test_unchanged_within_budget():
+    After = relax.transform.AutoCheckpoint("main", 5 * ACT_BYTES + 4)(Before)
+    assert_structural_equal(After, Before)
+
+
+def test_unchanged_when_annotated():
+    # fmt: off
+    @I.ir_module
+    class Annotated:
+        @R.function
+        def main(x: R.Tensor((64, 64), "float32")):
+            with R.dataflow():
+                x_scp = R.grad.start_checkpoint(x)
+                lv1 = R.power(x_scp, R.const(3, "float32"))
+                lv1_ecp = R.grad.end_checkpoint(lv1)
+                lv2 = R.power(lv1_ecp, R.const(3, "float32"))
+                gv = R.sum(lv2)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    After = relax.transform.AutoCheckpoint("main", 0)(Annotated)
+    assert_structural_equal(After, Annotated)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
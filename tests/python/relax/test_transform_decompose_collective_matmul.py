@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+def test_decompose_row_parallel_matmul():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((1, 8, 64), "float16"), w: R.Tensor((64, 32), "float16")):
+            with R.dataflow():
+                lv0 = R.matmul(x, w)
+                gv = R.ccl.allreduce(lv0, "sum")
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((1, 8, 64), "float16"), w: R.Tensor((64, 32), "float16")):
+            with R.dataflow():
+                gv_lhs_chunks = R.split(x, 2, axis=1)
+                gv_0_lhs = gv_lhs_chunks[0]
+                gv_0 = R.matmul(gv_0_lhs, w)
+                gv_0_pending = R.ccl.allreduce_start(gv_0, "sum")
+                gv_1_lhs = gv_lhs_chunks[1]
+                gv_1 = R.matmul(gv_1_lhs, w)
+                gv_1_pending = R.ccl.allreduce_start(gv_1, "sum")
+                gv_0_reduced = R.ccl.allreduce_wait(gv_0_pending, gv_0)
+                gv_1_reduced = R.ccl.allreduce_wait(gv_1_pending, gv_1)
+                gv = R.concat((gv_0_reduced, gv_1_reduced), axis=1)
+                R.output(gv)
+            return gv
+
+    After = relax.transform.DecomposeCollectiveMatmul(num_chunks=2)(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_skip_matmul_with_other_uses_or_uneven_rows():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((8, 64), "float16"),
+            y: R.Tensor((6, 64), "float16"),
+            w: R.Tensor((64, 32), "float16"),
+        ):
+            with R.dataflow():
+                lv0 = R.matmul(x, w)
+                lv1 = R.ccl.allreduce(lv0, "sum")
+                lv2 = R.add(lv0, lv1)
+                lv3 = R.matmul(y, w)
+                lv4 = R.ccl.allreduce(lv3, "sum")
+                R.output(lv2, lv4)
+            return (lv2, lv4)
+
+    After = relax.transform.DecomposeCollectiveMatmul(num_chunks=4)(Before)
+    tvm.ir.assert_structural_equal(After, Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
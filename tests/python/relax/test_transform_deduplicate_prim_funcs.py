@@ -0,0 +1,144 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R, tir as T
+
+
+def test_merge_equal_prim_funcs():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def add_0(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def add_1(X: T.Buffer((16,), "float32"), Y: T.Buffer((16,), "float32")):
+            for j in range(16):
+                with T.block("add"):
+                    vj = T.axis.remap("S", [j])
+                    Y[vj] = X[vj] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def add_2(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(2)
+
+        @R.function
+        def main(x: R.Tensor((16,), "float32")):
+            cls = Before
+            lv0 = R.call_tir(cls.add_0, (x,), R.Tensor((16,), "float32"))
+            lv1 = R.call_tir(cls.add_1, (lv0,), R.Tensor((16,), "float32"))
+            gv = R.call_tir(cls.add_2, (lv1,), R.Tensor((16,), "float32"))
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def add_0(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def add_2(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(2)
+
+        @R.function
+        def main(x: R.Tensor((16,), "float32")):
+            cls = Expected
+            lv0 = R.call_tir(cls.add_0, (x,), R.Tensor((16,), "float32"))
+            lv1 = R.call_tir(cls.add_0, (lv0,), R.Tensor((16,), "float32"))
+            gv = R.call_tir(cls.add_2, (lv1,), R.Tensor((16,), "float32"))
+            return gv
+
+    After = relax.transform.DeduplicatePrimFuncs()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_keep_exposed_prim_funcs():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def add_0(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            T.func_attr({"global_symbol": "add_0"})
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func
+        def add_1(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            T.func_attr({"global_symbol": "add_1"})
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(1)
+
+    After = relax.transform.DeduplicatePrimFuncs()(Before)
+    tvm.ir.assert_structural_equal(After, Before)
+
+
+def test_merged_module_runs():
+    @I.ir_module
+    class Module:
+        @T.prim_func(private=True)
+        def add_0(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def add_1(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            for i in range(16):
+                with T.block("add"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((16,), "float32")):
+            cls = Module
+            lv0 = R.call_tir(cls.add_0, (x,), R.Tensor((16,), "float32"))
+            gv = R.call_tir(cls.add_1, (lv0,), R.Tensor((16,), "float32"))
+            return gv
+
+    mod = relax.transform.DeduplicatePrimFuncs()(Module)
+    assert sorted(gv.name_hint for gv in mod.get_global_vars()) == ["add_0", "main"]
+
+    ex = tvm.compile(mod, target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = np.random.uniform(size=(16,)).astype("float32")
+    out = vm["main"](tvm.runtime.tensor(x))
+    tvm.testing.assert_allclose(out.numpy(), x + 2, rtol=1e-6)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
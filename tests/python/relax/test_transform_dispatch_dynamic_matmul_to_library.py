@@ -0,0 +1,131 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm_ffi
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+@I.ir_module
+class Module:
+    @R.function
+    def main(
+        x: R.Tensor(("m", 4), "float32"), w: R.Tensor((4, 8), "float32")
+    ) -> R.Tensor(("m", 8), "float32"):
+        m = T.int64()
+        y: R.Tensor((m, 8), "float32") = R.matmul(x, w)
+        return y
+
+
+def test_dispatch_dynamic_matmul():
+    mod = relax.transform.DispatchDynamicMatmulToLibrary("testlib")(Module)
+    call = mod["main"].body.blocks[0].bindings[0].value
+    assert call.op.same_as(tvm.ir.Op.get("relax.call_dps_packed"))
+    assert call.args[0].global_symbol == "vm.builtin.gemm_library_dispatch"
+    library, kernel = call.args[1].fields[:2]
+    assert library.value == "testlib"
+    assert isinstance(mod[kernel], tvm.tir.PrimFunc)
+
+
+def test_static_matmul():
+    @I.ir_module
+    class Static:
+        @R.function
+        def main(
+            x: R.Tensor((2, 4), "float32"), w: R.Tensor((4, 8), "float32")
+        ) -> R.Tensor((2, 8), "float32"):
+            y: R.Tensor((2, 8), "float32") = R.matmul(x, w)
+            return y
+
+    mod = relax.transform.DispatchDynamicMatmulToLibrary("testlib")(Static)
+    tvm.ir.assert_structural_equal(mod, Static)
+
+
+def test_measure_and_save_table(tmp_path):
+    @tvm.register_global_func("tvm.contrib.testlib.matmul", override=True)
+    def matmul(a, b, c, transa, transb):  # pylint: disable=unused-argument
+        c.copyfrom(a.numpy() @ b.numpy())
+
+    set_measure = tvm.get_global_func("vm.builtin.gemm_dispatch_table.set_measure")
+    entries = tvm.get_global_func("vm.builtin.gemm_dispatch_table.entries")
+    clear = tvm.get_global_func("vm.builtin.gemm_dispatch_table.clear")
+    mod = relax.transform.DispatchDynamicMatmulToLibrary("testlib")(Module)
+    ex = tvm.compile(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    w_np = np.random.uniform(size=(4, 8)).astype("float32")
+    try:
+        clear()
+        set_measure(True)
+        for m in [3, 20, 3]:
+            x_np = np.random.uniform(size=(m, 4)).astype("float32")
+            y = vm["main"](tvm.runtime.tensor(x_np), tvm.runtime.tensor(w_np))
+            tvm.testing.assert_allclose(y.numpy(), x_np @ w_np, rtol=1e-5)
+        table = dict(entries())
+        assert set(table) == {"testlib/cpu/float32/4,8,4", "testlib/cpu/float32/32,8,4"}
+
+        path = str(tmp_path / "gemm_dispatch.json")
+        tvm.get_global_func("vm.builtin.gemm_dispatch_table.save")(path)
+        clear()
+        tvm.get_global_func("vm.builtin.gemm_dispatch_table.load")(path)
+        assert dict(entries()) == table
+    finally:
+        set_measure(False)
+        clear()
+
+
+def test_library_registered_after_first_call():
+    set_measure = tvm.get_global_func("vm.builtin.gemm_dispatch_table.set_measure")
+    entries = tvm.get_global_func("vm.builtin.gemm_dispatch_table.entries")
+    clear = tvm.get_global_func("vm.builtin.gemm_dispatch_table.clear")
+    mod = relax.transform.DispatchDynamicMatmulToLibrary("latelib")(Module)
+    ex = tvm.compile(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x_np = np.random.uniform(size=(3, 4)).astype("float32")
+    w_np = np.random.uniform(size=(4, 8)).astype("float32")
+    args = [tvm.runtime.tensor(x_np), tvm.runtime.tensor(w_np)]
+    num_calls = []
+    try:
+        clear()
+        set_measure(True)
+        # without the library, the TIR kernel runs and nothing is measured
+        tvm.testing.assert_allclose(vm["main"](*args).numpy(), x_np @ w_np, rtol=1e-5)
+        assert len(entries()) == 0
+
+        for step in range(2):
+            # a later or overriding registration is picked up by the next call
+            @tvm.register_global_func("tvm.contrib.latelib.matmul", override=True)
+            def matmul(a, b, c, transa, transb, step=step):  # pylint: disable=unused-argument
+                num_calls.append(step)
+                c.copyfrom(a.numpy() @ b.numpy())
+
+            clear()
+            tvm.testing.assert_allclose(vm["main"](*args).numpy(), x_np @ w_np, rtol=1e-5)
+            assert set(entries()) == {"latelib/cpu/float32/4,8,4"}
+            assert num_calls and num_calls[-1] == step
+    finally:
+        set_measure(False)
+        clear()
+        tvm_ffi.registry.remove_global_func("tvm.contrib.latelib.matmul")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
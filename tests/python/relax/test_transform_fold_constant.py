@@ -242,6 +242,52 @@ def test_fold_mixed_case():
     tvm.ir.assert_structural_equal(after, expected)
 
 
+def test_fold_repeated_calls():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def addone(A: T.Buffer((16, 16), "float32"), B: T.Buffer((16, 16), "float32")) -> None:
+            for i, j in T.grid(16, 16):
+                with T.block("addone"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @T.prim_func
+        def sub(
+            A: T.Buffer((16, 16), "float32"),
+            B: T.Buffer((16, 16), "float32"),
+            C: T.Buffer((16, 16), "float32"),
+        ) -> None:
+            for i, j in T.grid(16, 16):
+                with T.block("sub"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = A[vi, vj] - B[vi, vj]
+
+        @R.function
+        def before(c0: R.Tensor((16, 16), "float32")):
+            cls = Module
+            # the PrimFuncs are built together, and the second call reuses the first result
+            lv0 = relax.call_tir(cls.addone, (c0,), R.Tensor((16, 16), dtype="float32"))
+            lv1 = relax.call_tir(cls.addone, (c0,), R.Tensor((16, 16), dtype="float32"))
+            lv2 = relax.call_tir(cls.addone, (lv1,), R.Tensor((16, 16), dtype="float32"))
+            lv3 = relax.call_tir(cls.sub, (lv2, lv0), R.Tensor((16, 16), dtype="float32"))
+            return lv3
+
+        @R.function
+        def expected(c1: R.Tensor((16, 16), "float32")):
+            return c1
+
+    c0_np = np.arange((16 * 16)).astype("float32").reshape(16, 16)
+    c1_np = np.ones((16, 16), "float32")
+    before = gen_mod(Module, "before", {"c0": c0_np})
+    expected = gen_mod(Module, "expected", {"c1": c1_np})
+
+    fold = relax.transform.FoldConstant()
+    tvm.ir.assert_structural_equal(fold(before), expected)
+    # a second run of the same pass folds from its cached results
+    tvm.ir.assert_structural_equal(fold(before), expected)
+
+
 def test_int32_fold():
     @tvm.script.ir_module
     class Module:
@@ -1694,5 +1694,52 @@ def test_packed_params():
     _check(Before, Expected)
 
 
+def _fusion_policy_module():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", R.Tensor([10, 20], "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, relax.const(1, "float32"))
+            lv1 = bb.emit_te(topi.exp, lv0)
+            gv = bb.emit_output(bb.call_te(topi.squeeze, lv1))
+        bb.emit_func_output(gv)
+    return relax.transform.AnnotateTIROpPattern()(bb.get())
+
+
+def _num_fused_functions(mod):
+    return sum(
+        1
+        for func in mod.functions.values()
+        if isinstance(func, relax.Function) and func.attrs and "Primitive" in func.attrs
+    )
+
+
+def test_fusion_policy_refuses():
+    candidates = []
+
+    @tvm.register_global_func("test.fuse_ops.refuse_all", override=True)
+    def refuse_all(candidate):
+        candidates.append(candidate)
+        return False
+
+    with tvm.transform.PassContext(config={"relax.FuseOps.policy": "test.fuse_ops.refuse_all"}):
+        mod = relax.transform.FuseOps()(_fusion_policy_module())
+    assert _num_fused_functions(mod) == 0
+    assert len(candidates) > 0
+    for candidate in candidates:
+        assert candidate["num_groups"] == 2
+        assert candidate["flops"] > 0
+        # The intermediate tensor of 10 x 20 float32 is neither written nor read back.
+        assert candidate["unfused_bytes"] - candidate["fused_bytes"] == 2 * 800
+
+
+def test_fusion_policy_cost_model():
+    expected = relax.transform.FuseOps()(_fusion_policy_module())
+    with tvm.transform.PassContext(config={"relax.FuseOps.policy": "cost_model"}):
+        mod = relax.transform.FuseOps()(_fusion_policy_module())
+    # Fusing a short chain of elementwise ops only saves memory traffic.
+    tvm.ir.assert_structural_equal(mod, expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
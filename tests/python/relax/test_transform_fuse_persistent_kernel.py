@@ -0,0 +1,127 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax, tir
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+@I.ir_module
+class Module:
+    @T.prim_func(private=True)
+    def exp(A: T.Buffer((4, 64), "float32"), B: T.Buffer((4, 64), "float32")):
+        for bx in T.thread_binding(4, thread="blockIdx.x"):
+            for tx in T.thread_binding(64, thread="threadIdx.x"):
+                with T.block("B"):
+                    i, j = T.axis.remap("SS", [bx, tx])
+                    B[i, j] = T.exp(A[i, j])
+
+    @R.function
+    def main(x: R.Tensor((4, 64), "float32"), y: R.Tensor((4, 64), "float32")):
+        cls = Module
+        with R.dataflow():
+            a = R.call_tir(cls.exp, (x,), out_sinfo=R.Tensor((4, 64), "float32"))
+            b = R.call_tir(cls.exp, (y,), out_sinfo=R.Tensor((4, 64), "float32"))
+            c = R.call_tir(cls.exp, (a,), out_sinfo=R.Tensor((4, 64), "float32"))
+            R.output(b, c)
+        return (b, c)
+
+
+def _persistent_kernel(mod):
+    funcs = [func for gv, func in mod.functions.items() if gv.name_hint == "persistent_kernel"]
+    assert len(funcs) == 1
+    return funcs[0]
+
+
+def _global_barriers(func):
+    barriers = []
+
+    def fvisit(node):
+        if (
+            isinstance(node, tir.Call)
+            and node.op.same_as(tvm.ir.Op.get("tir.tvm_storage_sync"))
+            and node.args[0].value == "global"
+        ):
+            barriers.append(node)
+
+    tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return barriers
+
+
+def _grid_loops(func):
+    loops = []
+
+    def fvisit(node):
+        if isinstance(node, tir.For) and node.kind == tir.ForKind.THREAD_BINDING:
+            if node.thread_binding.thread_tag == "blockIdx.x":
+                loops.append(node)
+
+    tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return loops
+
+
+def test_fuse_sequence():
+    with tvm.target.Target("cuda"):
+        mod = relax.transform.FusePersistentKernel()(Module)
+
+    main = mod["main"]
+    calls = []
+    relax.analysis.post_order_visit(
+        main.body, lambda e: calls.append(e) if isinstance(e, relax.Call) else None
+    )
+    call_tirs = [c for c in calls if c.op.same_as(tvm.ir.Op.get("relax.call_tir"))]
+    assert len(call_tirs) == 1
+
+    func = _persistent_kernel(mod)
+    # The intermediate `a` is not an input of the kernel.
+    assert len(func.params) == 2 + 3
+    # Only `c` reads the result of an earlier stage.
+    barriers = _global_barriers(func)
+    assert len(barriers) == 1
+    tvm.ir.assert_structural_equal(barriers[0].args[2], T.int32(4))
+    (grid,) = _grid_loops(func)
+    tvm.ir.assert_structural_equal(grid.extent, T.int32(4))
+
+
+def test_stride_over_large_grid():
+    with tvm.target.Target("cuda"):
+        mod = relax.transform.FusePersistentKernel(max_num_blocks=2)(Module)
+
+    func = _persistent_kernel(mod)
+    (grid,) = _grid_loops(func)
+    tvm.ir.assert_structural_equal(grid.extent, T.int32(2))
+    trips = []
+
+    def fvisit(node):
+        if isinstance(node, tir.For) and node.kind == tir.ForKind.SERIAL:
+            trips.append(node)
+
+    tir.stmt_functor.post_order_visit(func.body, fvisit)
+    assert len(trips) == 3
+    assert all(trip.extent.value == 2 for trip in trips)
+
+
+def test_skip_non_cuda_target():
+    with tvm.target.Target("rocm"):
+        mod = relax.transform.FusePersistentKernel()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
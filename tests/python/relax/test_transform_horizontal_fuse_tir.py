@@ -0,0 +1,170 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+def test_combine_independent_kernels():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def exp(A: T.Buffer((4, 64), "float32"), B: T.Buffer((4, 64), "float32")):
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.exp(A[i, j])
+
+        @T.prim_func(private=True)
+        def sigmoid(A: T.Buffer((2, 64), "float32"), B: T.Buffer((2, 64), "float32")):
+            for bx in T.thread_binding(2, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.sigmoid(A[i, j])
+
+        @R.function
+        def main(x: R.Tensor((4, 64), "float32"), y: R.Tensor((2, 64), "float32")):
+            cls = Before
+            with R.dataflow():
+                a = R.call_tir(cls.exp, (x,), out_sinfo=R.Tensor((4, 64), "float32"))
+                b = R.call_tir(cls.sigmoid, (y,), out_sinfo=R.Tensor((2, 64), "float32"))
+                R.output(a, b)
+            return (a, b)
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def exp(A: T.Buffer((4, 64), "float32"), B: T.Buffer((4, 64), "float32")):
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.exp(A[i, j])
+
+        @T.prim_func(private=True)
+        def sigmoid(A: T.Buffer((2, 64), "float32"), B: T.Buffer((2, 64), "float32")):
+            for bx in T.thread_binding(2, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.sigmoid(A[i, j])
+
+        @T.prim_func(private=True)
+        def horizontal_fused_exp_sigmoid(
+            A: T.Buffer((4, 64), "float32"),
+            C: T.Buffer((2, 64), "float32"),
+            B: T.Buffer((4, 64), "float32"),
+            D: T.Buffer((2, 64), "float32"),
+        ):
+            T.func_attr({"tir.noalias": True})
+            for blockIdx_x in T.thread_binding(6, thread="blockIdx.x"):
+                if blockIdx_x < 4:
+                    for tx in T.thread_binding(64, thread="threadIdx.x"):
+                        with T.block("B"):
+                            i, j = T.axis.remap("SS", [blockIdx_x, tx])
+                            B[i, j] = T.exp(A[i, j])
+                else:
+                    for tx in T.thread_binding(64, thread="threadIdx.x"):
+                        with T.block("B"):
+                            i = T.axis.spatial(2, blockIdx_x - 4)
+                            j = T.axis.spatial(64, tx)
+                            D[i, j] = T.sigmoid(C[i, j])
+
+        @R.function
+        def main(x: R.Tensor((4, 64), "float32"), y: R.Tensor((2, 64), "float32")):
+            cls = Expected
+            with R.dataflow():
+                lv = R.call_tir(
+                    cls.horizontal_fused_exp_sigmoid,
+                    (x, y),
+                    out_sinfo=[R.Tensor((4, 64), "float32"), R.Tensor((2, 64), "float32")],
+                )
+                a = lv[0]
+                b = lv[1]
+                R.output(a, b)
+            return (a, b)
+
+    with tvm.target.Target("cuda"):
+        After = relax.transform.HorizontalFuseTIR()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_keep_dependent_kernels():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def exp(A: T.Buffer((4, 64), "float32"), B: T.Buffer((4, 64), "float32")):
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.exp(A[i, j])
+
+        @R.function
+        def main(x: R.Tensor((4, 64), "float32")):
+            cls = Before
+            with R.dataflow():
+                a = R.call_tir(cls.exp, (x,), out_sinfo=R.Tensor((4, 64), "float32"))
+                b = R.call_tir(cls.exp, (a,), out_sinfo=R.Tensor((4, 64), "float32"))
+                R.output(b)
+            return b
+
+    with tvm.target.Target("cuda"):
+        After = relax.transform.HorizontalFuseTIR()(Before)
+    tvm.ir.assert_structural_equal(After, Before)
+
+
+def test_skip_non_gpu_target():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def exp(A: T.Buffer((4, 64), "float32"), B: T.Buffer((4, 64), "float32")):
+            for bx in T.thread_binding(4, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.exp(A[i, j])
+
+        @T.prim_func(private=True)
+        def sigmoid(A: T.Buffer((2, 64), "float32"), B: T.Buffer((2, 64), "float32")):
+            for bx in T.thread_binding(2, thread="blockIdx.x"):
+                for tx in T.thread_binding(64, thread="threadIdx.x"):
+                    with T.block("B"):
+                        i, j = T.axis.remap("SS", [bx, tx])
+                        B[i, j] = T.sigmoid(A[i, j])
+
+        @R.function
+        def main(x: R.Tensor((4, 64), "float32"), y: R.Tensor((2, 64), "float32")):
+            cls = Before
+            with R.dataflow():
+                a = R.call_tir(cls.exp, (x,), out_sinfo=R.Tensor((4, 64), "float32"))
+                b = R.call_tir(cls.sigmoid, (y,), out_sinfo=R.Tensor((2, 64), "float32"))
+                R.output(a, b)
+            return (a, b)
+
+    with tvm.target.Target("llvm"):
+        After = relax.transform.HorizontalFuseTIR()(Before)
+    tvm.ir.assert_structural_equal(After, Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -15,9 +15,17 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
+import pytest
+
 import tvm
 import tvm.testing
+from tvm import te, tir
 from tvm.relax.transform import LegalizeOps
+from tvm.relax.transform.legalize_ops.ccl import (
+    _te_merge_attention_states,
+    _te_ring_attention_block,
+)
 from tvm.script import ir as I
 from tvm.script import relax as R
 from tvm.script import tir as T
@@ -52,6 +60,202 @@ def test_allreduce():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_allreduce_quantized():
+    # fmt: off
+    @tvm.script.ir_module
+    class AllReduce:
+        @R.function
+        def main(x: R.Tensor((10, 10), "float16"), y: R.Tensor((10, 10), "int32"))  -> R.Tensor((10, 10), "float16"):
+            gv0: R.Tensor((10, 10), "float16") = R.ccl.allreduce(x, "sum")
+            gv1: R.Tensor((10, 10), "float16") = R.ccl.allreduce(x, "max")
+            gv2: R.Tensor((10, 10), "int32") = R.ccl.allreduce(y, "sum")
+            return x
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((10, 10), dtype="float16"), y: R.Tensor((10, 10), dtype="int32")) -> R.Tensor((10, 10), dtype="float16"):
+            gv0: R.Tensor((10, 10), dtype="float16") = R.call_dps_packed("runtime.disco.allreduce_quantized", [x, R.shape([0]), True, R.str("int8")], out_sinfo=R.Tensor((10, 10), dtype="float16"))
+            gv1: R.Tensor((10, 10), dtype="float16") = R.call_dps_packed("runtime.disco.allreduce", [x, R.shape([3]), True], out_sinfo=R.Tensor((10, 10), dtype="float16"))
+            gv2: R.Tensor((10, 10), dtype="int32") = R.call_dps_packed("runtime.disco.allreduce", [y, R.shape([0]), True], out_sinfo=R.Tensor((10, 10), dtype="int32"))
+            return x
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.ccl.allreduce_quantization": "int8"}):
+        mod = LegalizeOps()(AllReduce)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_allreduce_start():
+    # fmt: off
+    @tvm.script.ir_module
+    class AllReduceStart:
+        @R.function
+        def main(x: R.Tensor((10, 10), "float32"))  -> R.Tensor((10, 10), "float32"):
+            gv0: R.Tensor((10, 10), "float32") = R.ccl.allreduce_start(x, "max")
+            gv1: R.Tensor((10, 10), "float32") = R.ccl.allreduce_wait(gv0, x)
+            return gv1
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((10, 10), dtype="float32")) -> R.Tensor((10, 10), dtype="float32"):
+            gv0: R.Tensor((10, 10), dtype="float32") = R.call_dps_packed("runtime.disco.allreduce_start", [x, R.shape([3]), True], out_sinfo=R.Tensor((10, 10), dtype="float32"))
+            gv1: R.Tensor((10, 10), dtype="float32") = R.ccl.allreduce_wait(gv0, x)
+            return gv1
+    # fmt: on
+
+    mod = LegalizeOps()(AllReduceStart)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_ring_send_recv_start():
+    # fmt: off
+    @tvm.script.ir_module
+    class RingSendRecvStart:
+        @R.function
+        def main(x: R.Tensor((10, 10), "float32"))  -> R.Tensor((10, 10), "float32"):
+            gv0: R.Tensor((10, 10), "float32") = R.ccl.ring_send_recv_start(x, 4)
+            gv1: R.Tensor((10, 10), "float32") = R.ccl.ring_send_recv_wait(gv0, x)
+            return gv1
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((10, 10), dtype="float32")) -> R.Tensor((10, 10), dtype="float32"):
+            gv0: R.Tensor((10, 10), dtype="float32") = R.call_dps_packed("runtime.disco.ring_send_recv_start", [x, 4, True], out_sinfo=R.Tensor((10, 10), dtype="float32"))
+            gv1: R.Tensor((10, 10), dtype="float32") = R.ccl.ring_send_recv_wait(gv0, x)
+            return gv1
+    # fmt: on
+
+    mod = LegalizeOps()(RingSendRecvStart)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_ring_attention():
+    # fmt: off
+    @tvm.script.ir_module
+    class RingAttention:
+        @R.function
+        def main(
+            q: R.Tensor((1, 8, 4, 16), "float16"),
+            k: R.Tensor((1, 8, 2, 16), "float16"),
+            v: R.Tensor((1, 8, 2, 16), "float16"),
+        ) -> R.Tensor((1, 8, 4, 16), "float16"):
+            gv: R.Tensor((1, 8, 4, 16), "float16") = R.ccl.ring_attention(q, k, v, 4, causal=True)
+            return gv
+    # fmt: on
+
+    mod = LegalizeOps()(RingAttention)
+    calls = []
+    tvm.relax.analysis.post_order_visit(
+        mod["main"].body,
+        lambda e: calls.append(e) if isinstance(e, tvm.relax.Call) else None,
+    )
+
+    def _count_packed(name):
+        return sum(
+            1
+            for call in calls
+            if call.op == tvm.ir.Op.get("relax.call_dps_packed")
+            and call.args[0].global_symbol == name
+        )
+
+    def _count_tir(name):
+        return sum(
+            1
+            for call in calls
+            if call.op == tvm.ir.Op.get("relax.call_tir")
+            and call.args[0].name_hint.startswith(name)
+        )
+
+    # Each of the 3 rotations of the 4-worker ring exchanges the keys and the values, and waits
+    # for them after the attention of the step.
+    wait_op = tvm.ir.Op.get("relax.ccl.ring_send_recv_wait")
+    assert _count_packed("runtime.disco.ring_send_recv_start") == 6
+    assert sum(1 for call in calls if call.op == wait_op) == 6
+    assert _count_tir("ring_attention_block") == 4
+    assert _count_tir("merge_attention_states") == 3
+    tvm.ir.assert_structural_equal(
+        mod["main"].ret_struct_info, tvm.relax.TensorStructInfo((1, 8, 4, 16), "float16")
+    )
+
+
+def _reference_attention(q, k, v, causal, q_offset):
+    """The attention of the queries at `q_offset` of the sequence to all the keys, in NumPy."""
+    group_size = q.shape[2] // k.shape[2]
+    k = np.repeat(k, group_size, axis=2)
+    v = np.repeat(v, group_size, axis=2)
+    score = np.einsum("bihd,bjhd->bhij", q, k) / np.sqrt(q.shape[3])
+    if causal:
+        i = np.arange(q.shape[1])[:, None] + q_offset
+        j = np.arange(k.shape[1])[None, :]
+        score = np.where(i >= j, score, -np.inf)
+    max_score = score.max(axis=-1, keepdims=True)
+    exp_score = np.exp(score - max_score)
+    sum_exp = exp_score.sum(axis=-1, keepdims=True)
+    out = np.einsum("bhij,bjhd->bihd", exp_score / sum_exp, v)
+    return out, (max_score + np.log(sum_exp))[..., 0]
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("causal", [False, True])
+@pytest.mark.parametrize("rank", [0, 1])
+def test_ring_attention_block_merge_numerics(causal, rank):
+    batch_size, block_len, num_head, num_kv_head, head_dim = 1, 4, 4, 2, 8
+    num_blocks = 2
+    q = te.placeholder((batch_size, block_len, num_head, head_dim), "float32", name="q")
+    k = te.placeholder((batch_size, block_len, num_kv_head, head_dim), "float32", name="k")
+    v = te.placeholder((batch_size, block_len, num_kv_head, head_dim), "float32", name="v")
+    blocks = []
+    for src in range(num_blocks):
+        out, lse = _te_ring_attention_block(
+            q, k, v, None, causal, tir.IntImm("int64", rank), tir.IntImm("int64", src)
+        )
+        blocks.append(tvm.compile(te.create_prim_func([q, k, v, out, lse])))
+    o_a = te.placeholder((batch_size, block_len, num_head, head_dim), "float32", name="o_a")
+    lse_a = te.placeholder((batch_size, num_head, block_len), "float32", name="lse_a")
+    o_b = te.placeholder((batch_size, block_len, num_head, head_dim), "float32", name="o_b")
+    lse_b = te.placeholder((batch_size, num_head, block_len), "float32", name="lse_b")
+    merged_out, merged_lse = _te_merge_attention_states(o_a, lse_a, o_b, lse_b)
+    merge = tvm.compile(te.create_prim_func([o_a, lse_a, o_b, lse_b, merged_out, merged_lse]))
+
+    seq_len = num_blocks * block_len
+    q_np = np.random.uniform(-1, 1, (batch_size, seq_len, num_head, head_dim)).astype("float32")
+    k_np = np.random.uniform(-1, 1, (batch_size, seq_len, num_kv_head, head_dim)).astype("float32")
+    v_np = np.random.uniform(-1, 1, (batch_size, seq_len, num_kv_head, head_dim)).astype("float32")
+    q_block = tvm.runtime.tensor(q_np[:, rank * block_len : (rank + 1) * block_len])
+
+    def run_block(src):
+        out = tvm.runtime.tensor(np.zeros((batch_size, block_len, num_head, head_dim), "float32"))
+        lse = tvm.runtime.tensor(np.zeros((batch_size, num_head, block_len), "float32"))
+        kv_range = slice(src * block_len, (src + 1) * block_len)
+        blocks[src](
+            q_block,
+            tvm.runtime.tensor(k_np[:, kv_range]),
+            tvm.runtime.tensor(v_np[:, kv_range]),
+            out,
+            lse,
+        )
+        return out, lse
+
+    # The blocks arrive in the order of the ring, from the local one backwards. With the causal
+    # mask, the block after the queries of rank 0 has no key to attend to.
+    out, lse = run_block(rank)
+    for step in range(1, num_blocks):
+        block_out, block_lse = run_block((rank - step) % num_blocks)
+        next_out = tvm.runtime.tensor(np.zeros(out.shape, "float32"))
+        next_lse = tvm.runtime.tensor(np.zeros(lse.shape, "float32"))
+        merge(out, lse, block_out, block_lse, next_out, next_lse)
+        out, lse = next_out, next_lse
+
+    expected_out, expected_lse = _reference_attention(
+        q_block.numpy(), k_np, v_np, causal, rank * block_len
+    )
+    tvm.testing.assert_allclose(out.numpy(), expected_out, rtol=1e-5, atol=1e-5)
+    tvm.testing.assert_allclose(lse.numpy(), expected_lse, rtol=1e-5, atol=1e-5)
+
+
 def test_allgather():
     # fmt: off
     @tvm.script.ir_module
@@ -75,6 +279,27 @@ def test_allgather():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_alltoall():
+    # fmt: off
+    @tvm.script.ir_module
+    class AllToAll:
+        @R.function
+        def main(x: R.Tensor((10, 10), "float32"))  -> R.Tensor((10, 10), "float32"):
+            gv0: R.Tensor((10, 10), "float32") = R.ccl.alltoall(x, 2)
+            return x
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((10, 10), dtype="float32")) -> R.Tensor((10, 10), dtype="float32"):
+            gv0: R.Tensor((10, 10), dtype="float32") = R.call_dps_packed("runtime.disco.alltoall", [x, R.shape([]), R.shape([]), True], out_sinfo=R.Tensor((10, 10), dtype="float32"))
+            return x
+    # fmt: on
+
+    mod = LegalizeOps()(AllToAll)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
 def test_broadcast_from_zero():
     # fmt: off
     @tvm.script.ir_module
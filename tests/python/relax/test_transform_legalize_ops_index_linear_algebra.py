@@ -15,8 +15,11 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
+
 import tvm
 import tvm.testing
+from tvm import relax
 from tvm.ir import Op
 from tvm.relax.transform import LegalizeOps
 from tvm.script import ir as I
@@ -1147,6 +1150,58 @@ def test_einsum():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_einsum_multi_operand_contraction_path():
+    @I.ir_module
+    class Einsum:
+        @R.function
+        def main(
+            x: R.Tensor((64, 2), "float32"),
+            y: R.Tensor((2, 64), "float32"),
+            z: R.Tensor((64, 8), "float32"),
+        ):
+            gv = R.einsum((x, y, z), subscripts="ij,jk,kl->il")
+            return gv
+
+    mod = LegalizeOps()(Einsum)
+    assert not any(gv.name_hint.startswith("einsum") for gv in mod.functions)
+    matmuls = []
+
+    def fvisit(expr):
+        if isinstance(expr, relax.Call) and expr.op.same_as(Op.get("relax.call_tir")):
+            if expr.args[0].name_hint.startswith("matmul"):
+                shapes = [[int(d) for d in arg.struct_info.shape] for arg in expr.args[1].fields]
+                matmuls.append(shapes)
+
+    relax.analysis.post_order_visit(mod["main"].body, fvisit)
+    # y and z are contracted first, for 2 * 64 * 8 + 64 * 2 * 8 multiply-adds, instead of the
+    # 64 * 64 * 2 + 64 * 64 * 8 of contracting x and y first
+    assert matmuls == [[[1, 2, 64], [1, 64, 8]], [[1, 64, 2], [1, 2, 8]]]
+
+
+def test_einsum_multi_operand_numerics():
+    x = np.random.rand(4, 3).astype("float32")
+    y = np.random.rand(3, 5).astype("float32")
+    z = np.random.rand(6, 5, 2).astype("float32")
+
+    @I.ir_module
+    class Einsum:
+        @R.function
+        def main(
+            x: R.Tensor((4, 3), "float32"),
+            y: R.Tensor((3, 5), "float32"),
+            z: R.Tensor((6, 5, 2), "float32"),
+        ):
+            gv = R.einsum((x, y, z), subscripts="ij,jk,bkl->bi")
+            return gv
+
+    ex = tvm.compile(LegalizeOps()(Einsum), target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    inputs = [tvm.runtime.tensor(arr) for arr in (x, y, z)]
+    tvm.testing.assert_allclose(
+        vm["main"](*inputs).numpy(), np.einsum("ij,jk,bkl->bi", x, y, z), rtol=1e-5
+    )
+
+
 def test_einsum_symbolic():
     # fmt: off
     @I.ir_module
@@ -1176,5 +1176,118 @@ class TestStaticInputWithSymbolicShape(BaseCompare):
             return gv_1
 
 
+def _bindings(func):
+    return [binding for block in func.body.blocks for binding in block.bindings]
+
+
+def _is_run_or_capture(value):
+    return (
+        isinstance(value, relax.Call)
+        and value.op.same_as(tvm.ir.Op.get("relax.call_builtin_with_ctx"))
+        and value.args[0].global_symbol == "vm.builtin.cuda_graph.run_or_capture"
+    )
+
+
+def _run_or_capture_calls(func):
+    return [b.value for b in _bindings(func) if _is_run_or_capture(b.value)]
+
+
+def test_capture_across_binding_blocks():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main():
+            R.func_attr({"relax.force_pure": True})
+            storage1 = R.memory.alloc_storage(R.shape([8]), 0, "global", "float32")
+            alloc1 = R.memory.alloc_tensor(storage1, 0, R.shape([8]), "float32")
+            storage2 = R.memory.alloc_storage(R.shape([8]), 0, "global", "float32")
+            alloc2 = R.memory.alloc_tensor(storage2, 0, R.shape([8]), "float32")
+            _1 = R.call_packed("dummy", alloc1, alloc2, sinfo_args=(R.Tuple,))
+            _2 = R.call_packed("dummy", alloc2, alloc1, sinfo_args=(R.Tuple,))
+            return R.tuple()
+
+    # Split the kernels into two binding blocks.
+    main = Before["main"]
+    bindings = main.body.blocks[0].bindings
+    body = relax.SeqExpr(
+        [relax.BindingBlock(bindings[:5]), relax.BindingBlock(bindings[5:])], main.body.body
+    )
+    Before["main"] = relax.Function(
+        main.params, body, main.ret_struct_info, main.is_pure, main.attrs
+    )
+
+    After = relax.transform.RewriteCUDAGraph()(Before)
+    calls = _run_or_capture_calls(After["main"])
+    assert len(calls) == 1
+    capture = After[calls[0].args[1].fields[0]]
+    assert len([b for b in _bindings(capture) if isinstance(b.value, relax.Call)]) == 2
+
+
+def test_capture_if_on_captured_symbolic_var():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor(("m",), "float32")) -> R.Tensor(("m",), "float32"):
+            R.func_attr(
+                {"relax.rewrite_cuda_graph.capture_symbolic_vars": ["m"], "relax.force_pure": True}
+            )
+            m = T.int64()
+            storage1 = R.memory.alloc_storage(R.shape([16]), 0, "global", "float32")
+            alloc1 = R.memory.alloc_tensor(storage1, 0, R.shape([m]), "float32")
+            _1 = R.call_packed("dummy", x, alloc1, sinfo_args=(R.Tuple,))
+            storage2 = R.memory.alloc_storage(R.shape([16]), 0, "global", "float32")
+            alloc2 = R.memory.alloc_tensor(storage2, 0, R.shape([m]), "float32")
+            _2 = R.call_packed("dummy", alloc1, alloc2, sinfo_args=(R.Tuple,))
+            if R.prim_value(m % 2 == 0):
+                r = R.call_packed("even", alloc2, alloc1, sinfo_args=(R.Tuple,))
+            else:
+                r = R.call_packed("odd", alloc2, alloc1, sinfo_args=(R.Tuple,))
+            _3 = R.call_packed("dummy", alloc1, alloc2, sinfo_args=(R.Tuple,))
+            alloc3 = R.builtin.alloc_tensor(R.shape([m]), "float32", 0)
+            _4 = R.call_packed("dummy", alloc2, alloc3, sinfo_args=(R.Tuple,))
+            return alloc3
+
+    After = relax.transform.RewriteCUDAGraph()(Before)
+    main = After["main"]
+    # A single graph captures the kernels before, in and after the If, for each value of the key.
+    calls = _run_or_capture_calls(main)
+    assert len(calls) == 1
+    assert not any(isinstance(b.value, relax.If) for b in _bindings(main))
+    capture = After[calls[0].args[1].fields[0]]
+    assert len([b for b in _bindings(capture) if isinstance(b.value, relax.If)]) == 1
+    m = main.params[0].struct_info.shape[0]
+    tvm.ir.assert_structural_equal(calls[0].args[1].fields[3], relax.ShapeExpr([m]))
+
+
+def test_if_on_uncaptured_value_ends_region():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor(("m",), "float32")) -> R.Tensor(("m",), "float32"):
+            R.func_attr({"relax.force_pure": True})
+            m = T.int64()
+            storage1 = R.memory.alloc_storage(R.shape([16]), 0, "global", "float32")
+            alloc1 = R.memory.alloc_tensor(storage1, 0, R.shape([8]), "float32")
+            storage2 = R.memory.alloc_storage(R.shape([16]), 0, "global", "float32")
+            alloc2 = R.memory.alloc_tensor(storage2, 0, R.shape([8]), "float32")
+            _1 = R.call_packed("dummy", alloc1, alloc2, sinfo_args=(R.Tuple,))
+            if R.prim_value(m % 2 == 0):
+                r = R.call_packed("even", alloc2, alloc1, sinfo_args=(R.Tuple,))
+            else:
+                r = R.call_packed("odd", alloc2, alloc1, sinfo_args=(R.Tuple,))
+            _2 = R.call_packed("dummy", alloc1, alloc2, sinfo_args=(R.Tuple,))
+            return x
+
+    After = relax.transform.RewriteCUDAGraph()(Before)
+    main = After["main"]
+    # The kernels after the If are not lifted before it.
+    bindings = _bindings(main)
+    if_index = [i for i, b in enumerate(bindings) if isinstance(b.value, relax.If)]
+    assert len(if_index) == 1
+    launches = [i for i, b in enumerate(bindings) if _is_run_or_capture(b.value)]
+    assert len([i for i in launches if i < if_index[0]]) == 1
+    assert len([i for i in launches if i > if_index[0]]) == 1
+
+
 if __name__ == "__main__":
     tvm.testing.main()
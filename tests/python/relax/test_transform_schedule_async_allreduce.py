@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+def test_sink_wait_past_independent_compute():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float16"),
+            w0: R.Tensor((8, 8), "float16"),
+            w1: R.Tensor((8, 8), "float16"),
+        ):
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                lv1 = R.ccl.allreduce(lv0, "sum")
+                lv2 = R.matmul(x, w1)
+                lv3 = R.add(lv1, lv2)
+                R.output(lv3)
+            return lv3
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float16"),
+            w0: R.Tensor((8, 8), "float16"),
+            w1: R.Tensor((8, 8), "float16"),
+        ):
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                lv1_pending = R.ccl.allreduce_start(lv0, "sum")
+                lv2 = R.matmul(x, w1)
+                lv1 = R.ccl.allreduce_wait(lv1_pending, lv0)
+                lv3 = R.add(lv1, lv2)
+                R.output(lv3)
+            return lv3
+
+    After = relax.transform.ScheduleAsyncAllReduce()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+def test_wait_at_end_of_block():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((4, 8), "float16"), w: R.Tensor((8, 8), "float16")):
+            with R.dataflow():
+                lv0 = R.ccl.allreduce(x, "sum", False)
+                lv1 = R.matmul(x, w)
+                R.output(lv0, lv1)
+            return (lv0, lv1)
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((4, 8), "float16"), w: R.Tensor((8, 8), "float16")):
+            with R.dataflow():
+                lv0_pending = R.ccl.allreduce_start(x, "sum", False)
+                lv1 = R.matmul(x, w)
+                lv0 = R.ccl.allreduce_wait(lv0_pending, x)
+                R.output(lv0, lv1)
+            return (lv0, lv1)
+
+    After = relax.transform.ScheduleAsyncAllReduce()(Before)
+    tvm.ir.assert_structural_equal(After, Expected)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+@I.ir_module
+class Module:
+    @R.function
+    def main(x: R.Tensor((4, 8), "float16"), y: R.Tensor((4, 8), "float16")):
+        with R.dataflow():
+            lv0 = R.call_dps_packed("ext_a", (x,), out_sinfo=R.Tensor((4, 8), "float16"))
+            lv1 = R.call_dps_packed("ext_b", (y,), out_sinfo=R.Tensor((4, 8), "float16"))
+            lv2 = R.add(x, y)
+            lv3 = R.add(lv0, lv2)
+            lv4 = R.add(lv1, lv3)
+            R.output(lv4)
+        return lv4
+
+
+def _with_external_mods(mod, func_names):
+    ext_mod = tvm.runtime._ffi_api.CSourceModuleCreate("", "cc", func_names, [])
+    return mod.with_attr("external_mods", [ext_mod])
+
+
+def test_overlap_independent_extern_calls():
+    mod = _with_external_mods(Module, ["ext_a", "ext_b"])
+    after = relax.transform.ScheduleAsyncExternCalls()(mod)
+    bindings = after["main"].body.blocks[0].bindings
+    names = [binding.var.name_hint for binding in bindings]
+    # The waits are sunk to the first use of the results, past the independent add.
+    assert names == ["lv0_pending", "lv1_pending", "lv2", "lv0", "lv3", "lv1", "lv4"]
+
+    starts = [bindings[0].value, bindings[1].value]
+    for start, symbol, stream in zip(starts, ["ext_a", "ext_b"], [0, 1]):
+        assert start.op.same_as(tvm.ir.Op.get("relax.call_dps_packed"))
+        assert start.args[0].global_symbol == "vm.builtin.external_call_async"
+        assert start.args[1].fields[0].global_symbol == symbol
+        assert start.args[1].fields[1].value.value == stream
+    wait = bindings[3].value
+    assert wait.op.same_as(tvm.ir.Op.get("relax.external_call_wait"))
+    assert wait.args[0].same_as(bindings[0].var)
+    assert wait.args[2].value.value == 0
+
+
+def test_skip_non_external_calls():
+    mod = _with_external_mods(Module, ["ext_a"])
+    after = relax.transform.ScheduleAsyncExternCalls()(mod)
+    names = [binding.var.name_hint for binding in after["main"].body.blocks[0].bindings]
+    assert names == ["lv0_pending", "lv1", "lv2", "lv0", "lv3", "lv4"]
+
+    unchanged = relax.transform.ScheduleAsyncExternCalls()(Module)
+    tvm.ir.assert_structural_equal(unchanged, Module)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,138 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.transform import LayoutCostModel, SearchLayout
+from tvm.script.parser import ir as I, relax as R
+
+CANDIDATES = {"relax.nn.conv2d": [["NHWC", "OHWI"]]}
+
+
+class ToyCost(LayoutCostModel):
+    """A conv2d in NHWC costs nhwc_cost instead of 10, a transform costs transform_cost."""
+
+    def __init__(self, nhwc_cost, transform_cost):
+        super().__init__()
+        self.nhwc_cost = nhwc_cost
+        self.transform = transform_cost
+        self.num_op_costs = 0
+
+    def op_cost(self, call):
+        self.num_op_costs += 1
+        return self.nhwc_cost if call.attrs.data_layout == "NHWC" else 10.0
+
+    def transform_cost(self, call):
+        return self.transform
+
+
+def _calls(func, op_name):
+    calls = []
+
+    def fvisit(expr):
+        if isinstance(expr, relax.Call) and expr.op.same_as(tvm.ir.Op.get(op_name)):
+            calls.append(expr)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return calls
+
+
+def _conv_chain():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(
+            x: R.Tensor((2, 4, 28, 28), "float32"),
+            w0: R.Tensor((4, 4, 3, 3), "float32"),
+            w1: R.Tensor((4, 4, 3, 3), "float32"),
+        ):
+            R.func_attr({"num_input": 1})
+            with R.dataflow():
+                lv0 = R.nn.conv2d(x, w0, padding=[1, 1], out_dtype="float32")
+                lv1 = R.nn.relu(lv0)
+                gv = R.nn.conv2d(lv1, w1, padding=[1, 1], out_dtype="float32")
+                R.output(gv)
+            return gv
+
+    return Module
+
+
+def test_convert_when_the_ops_amortize_the_transforms():
+    # Both convs in NHWC save 2 * 6, for a transform in and out of the chain.
+    mod = SearchLayout(CANDIDATES, ToyCost(nhwc_cost=4.0, transform_cost=3.0))(_conv_chain())
+    convs = _calls(mod["main"], "relax.nn.conv2d")
+    assert [conv.attrs.data_layout for conv in convs] == ["NHWC", "NHWC"]
+    # the weights are transformed, but the activations only at the boundaries of the chain
+    assert len(_calls(mod["main"], "relax.permute_dims")) == 4
+
+
+def test_keep_layout_when_the_transforms_dominate():
+    # Converting saves 2 * 1, which doesn't pay for the two transforms.
+    mod = SearchLayout(CANDIDATES, ToyCost(nhwc_cost=9.0, transform_cost=3.0))(_conv_chain())
+    convs = _calls(mod["main"], "relax.nn.conv2d")
+    assert [conv.attrs.data_layout for conv in convs] == ["NCHW", "NCHW"]
+    assert not _calls(mod["main"], "relax.permute_dims")
+
+
+def test_layout_per_call():
+    # Only the conv of x is worth converting.
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(
+            x: R.Tensor((2, 4, 28, 28), "float32"),
+            y: R.Tensor((2, 4, 14, 14), "float32"),
+            w: R.Tensor((4, 4, 3, 3), "float32"),
+        ):
+            R.func_attr({"num_input": 2})
+            with R.dataflow():
+                lv0 = R.nn.conv2d(x, w, padding=[1, 1], out_dtype="float32")
+                lv1 = R.nn.conv2d(y, w, padding=[1, 1], out_dtype="float32")
+                gv = (lv0, lv1)
+                R.output(gv)
+            return gv
+
+    class PerCallCost(ToyCost):
+        def op_cost(self, call):
+            if call.attrs.data_layout != "NHWC":
+                return 10.0
+            # the conv of x saves 9 for two transforms, that of y nothing
+            return 1.0 if call.args[0].struct_info.shape[1].value == 28 else 10.0
+
+    mod = SearchLayout(CANDIDATES, PerCallCost(nhwc_cost=None, transform_cost=2.0))(Module)
+    convs = _calls(mod["main"], "relax.nn.conv2d")
+    layouts = {conv.struct_info.shape[2].value: conv.attrs.data_layout for conv in convs}
+    assert layouts == {28: "NHWC", 14: "NCHW"}
+
+
+def test_analytic_model_keeps_layouts():
+    mod = SearchLayout(CANDIDATES)(_conv_chain())
+    convs = _calls(mod["main"], "relax.nn.conv2d")
+    assert [conv.attrs.data_layout for conv in convs] == ["NCHW", "NCHW"]
+    assert not _calls(mod["main"], "relax.permute_dims")
+
+
+def test_costs_are_cached():
+    cost_model = ToyCost(nhwc_cost=4.0, transform_cost=3.0)
+    SearchLayout(CANDIDATES, cost_model)(_conv_chain())
+    # the two convs have the same workload in each of the two layouts
+    assert cost_model.num_op_costs == 2
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
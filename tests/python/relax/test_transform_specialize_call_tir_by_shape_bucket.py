@@ -0,0 +1,79 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+@I.ir_module
+class Module:
+    @T.prim_func
+    def add_one(var_x: T.handle, var_y: T.handle):
+        n = T.int64()
+        X = T.match_buffer(var_x, (n,), "float32")
+        Y = T.match_buffer(var_y, (n,), "float32")
+        for i in range(n):
+            with T.block("add"):
+                vi = T.axis.spatial(n, i)
+                Y[vi] = X[vi] + T.float32(1)
+
+    @R.function
+    def main(x: R.Tensor(("n",), "float32")) -> R.Tensor(("n",), "float32"):
+        cls = Module
+        y = R.call_tir(cls.add_one, (x,), out_sinfo=R.Tensor(("n",), "float32"))
+        return y
+
+
+def test_specialize_variants():
+    mod = relax.transform.SpecializeCallTIRByShapeBucket({"n": [16, 64]})(Module)
+    upper_bounds = {
+        gv.name_hint: func.attrs["tir_var_upper_bound"]["n"]
+        for gv, func in mod.functions.items()
+        if isinstance(func, tvm.tir.PrimFunc) and "tir_var_upper_bound" in func.attrs
+    }
+    assert upper_bounds == {"add_one_n_le16": 16, "add_one_n_le64": 64}
+    call = mod["main"].body.blocks[0].bindings[0].value
+    assert call.op.same_as(tvm.ir.Op.get("relax.call_dps_packed"))
+    assert call.args[0].global_symbol == "vm.builtin.shape_bucket_dispatch"
+    variants = call.args[1].fields[2].fields
+    assert [gv.name_hint for gv in variants] == ["add_one_n_le16", "add_one_n_le64", "add_one"]
+
+
+def test_unbucketed_variable():
+    mod = relax.transform.SpecializeCallTIRByShapeBucket({"m": [16]})(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+@pytest.mark.parametrize("tune_online", [False, True])
+def test_dispatch(tune_online):
+    mod = relax.transform.SpecializeCallTIRByShapeBucket({"n": [16, 64]}, tune_online)(Module)
+    ex = tvm.compile(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    for n in [8, 16, 40, 100, 40]:
+        x_np = np.random.uniform(size=(n,)).astype("float32")
+        y = vm["main"](tvm.runtime.tensor(x_np))
+        tvm.testing.assert_allclose(y.numpy(), x_np + 1)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+@I.ir_module
+class Module:
+    @R.function
+    def main(
+        x: R.Tensor(("batch", 4), "float32"), w: R.Tensor((4, 8), "float32")
+    ) -> R.Tensor(("batch", 8), "float32"):
+        with R.dataflow():
+            y = R.matmul(x, w)
+            z = R.nn.relu(y)
+            R.output(z)
+        return z
+
+
+def test_specialize_clones():
+    mod = relax.transform.SpecializeShapeBuckets({"batch": [2, 8]})(Module)
+    assert relax.analysis.well_formed(mod)
+    names = {gv.name_hint for gv in mod.get_global_vars()}
+    assert names == {"main", "main_batch2", "main_batch8", "main_batch_dynamic"}
+    tvm.ir.assert_structural_equal(
+        mod["main_batch8"].params[0].struct_info, R.Tensor((8, 4), "float32")
+    )
+    tvm.ir.assert_structural_equal(mod["main_batch8"].ret_struct_info, R.Tensor((8, 8), "float32"))
+    assert "global_symbol" not in mod["main_batch8"].attrs
+    tvm.ir.assert_structural_equal(mod["main"].ret_struct_info, Module["main"].ret_struct_info)
+
+
+def test_unbucketed_function():
+    mod = relax.transform.SpecializeShapeBuckets({"batch": [2]}, func_name="other")(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_dispatch():
+    mod = relax.transform.SpecializeShapeBuckets({"batch": [2, 8]})(Module)
+    ex = tvm.compile(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    w_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    for batch in [1, 2, 5, 8, 11]:
+        x_np = np.random.uniform(-1, 1, size=(batch, 4)).astype("float32")
+        z = vm["main"](tvm.runtime.tensor(x_np), tvm.runtime.tensor(w_np))
+        tvm.testing.assert_allclose(z.numpy(), np.maximum(x_np @ w_np, 0), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -1772,5 +1772,139 @@ def test_with_dataflow():
     tvm.ir.assert_structural_equal(after, Expected)
 
 
+def test_offset_mode():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @T.prim_func
+        def tir_add(var_a: T.handle, var_b: T.handle, var_c: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((512,), dtype="float32")) -> R.Tensor((256,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Before
+            alloc = R.builtin.alloc_tensor(R.shape([512]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(x, alloc)
+            alloc1 = R.builtin.alloc_tensor(R.shape([64]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(alloc, alloc1)
+            alloc2 = R.builtin.alloc_tensor(R.shape([256]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(alloc1, alloc2)
+            alloc3 = R.builtin.alloc_tensor(R.shape([256]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(alloc2, alloc3)
+            alloc4 = R.builtin.alloc_tensor(R.shape([256]), dtype="float32", runtime_device_index=0)
+            cls.tir_add(alloc2, alloc3, alloc4)
+            return alloc4
+
+    # Whole-token reuse takes 2048 + 1024 bytes: alloc2 reuses the storage of alloc, and
+    # alloc3 enlarges the one of alloc1. Packing alloc2 and alloc3 side by side in the space
+    # of alloc takes 2048 + 256 bytes.
+    @I.ir_module
+    class Expected:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @T.prim_func
+        def tir_add(var_a: T.handle, var_b: T.handle, var_c: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((512,), dtype="float32")) -> R.Tensor((256,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Expected
+            storage: R.Object = R.memory.alloc_storage(
+                R.shape([2304]), R.prim_value(0), R.str("global"), R.dtype("float32")
+            )
+            alloc: R.Tensor((512,), dtype="float32") = R.memory.alloc_tensor(
+                storage, R.prim_value(0), R.shape([512]), R.dtype("float32")
+            )
+            cls.tir_exp(x, alloc)
+            alloc_1: R.Tensor((64,), dtype="float32") = R.memory.alloc_tensor(
+                storage, R.prim_value(2048), R.shape([64]), R.dtype("float32")
+            )
+            alloc1: R.Tensor((64,), dtype="float32") = R.memory.ensure_zero_offset(alloc_1)
+            cls.tir_exp(alloc, alloc1)
+            alloc2: R.Tensor((256,), dtype="float32") = R.memory.alloc_tensor(
+                storage, R.prim_value(0), R.shape([256]), R.dtype("float32")
+            )
+            cls.tir_exp(alloc1, alloc2)
+            alloc_2: R.Tensor((256,), dtype="float32") = R.memory.alloc_tensor(
+                storage, R.prim_value(1024), R.shape([256]), R.dtype("float32")
+            )
+            alloc3: R.Tensor((256,), dtype="float32") = R.memory.ensure_zero_offset(alloc_2)
+            cls.tir_exp(alloc2, alloc3)
+            alloc4: R.Tensor((256,), dtype="float32") = R.builtin.alloc_tensor(
+                R.shape([256]), R.dtype("float32"), R.prim_value(0), R.str("global")
+            )
+            cls.tir_add(alloc2, alloc3, alloc4)
+            return alloc4
+
+    with tvm.transform.PassContext(config={"relax.StaticPlanBlockMemory.mode": "offset"}):
+        after = relax.transform.StaticPlanBlockMemory()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_offset_mode_symbolic_size():
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor(("n",), dtype="float32")) -> R.Tensor(("n",), dtype="float32"):
+            R.func_attr({"relax.force_pure": True, "relax.memory_plan_mode": "offset"})
+            n = T.int64()
+            cls = Module
+            alloc = R.builtin.alloc_tensor(R.shape([n]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(x, alloc)
+            alloc1 = R.builtin.alloc_tensor(R.shape([n]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(alloc, alloc1)
+            alloc2 = R.builtin.alloc_tensor(R.shape([n]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(alloc1, alloc2)
+            alloc3 = R.builtin.alloc_tensor(R.shape([n]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(alloc2, alloc3)
+            return alloc3
+
+    after = relax.transform.StaticPlanBlockMemory()(Module)
+
+    storage_sizes = []
+    offsets = []
+
+    def visit(expr):
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.memory.alloc_storage"):
+            storage_sizes.append(expr.args[0].values[0])
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.memory.alloc_tensor"):
+            offsets.append(expr.args[1].value)
+
+    relax.analysis.post_order_visit(after["main"], visit)
+    n = after["main"].params[0].struct_info.shape.values[0]
+
+    def evaluate(expr, value):
+        expr = tvm.tir.stmt_functor.substitute(expr, {n: tvm.tir.IntImm("int64", value)})
+        return int(tvm.arith.Analyzer().simplify(expr))
+
+    # alloc and alloc2 share the first slot, alloc1 takes the second one.
+    assert len(storage_sizes) == 1
+    assert evaluate(storage_sizes[0], 10) == 64 + 40
+    assert [evaluate(offset, 10) for offset in offsets] == [0, 64, 0]
+
+
+def test_invalid_mode():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((8,), dtype="float32")) -> R.Tensor((8,), dtype="float32"):
+            return x
+
+    with tvm.transform.PassContext(config={"relax.StaticPlanBlockMemory.mode": "best"}):
+        with pytest.raises(ValueError):
+            relax.transform.StaticPlanBlockMemory()(Module)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
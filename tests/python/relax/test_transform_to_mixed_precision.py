@@ -16,9 +16,12 @@
 # under the License.
 
 import numpy as np
+import pytest
+
 import tvm
 from tvm import relax
 import tvm.testing
+import tvm.relax.backend.cuda.cublas
 from tvm.relax.transform import ToMixedPrecision
 from tvm.script.parser import ir as I, relax as R, tir as T
 
@@ -1117,5 +1120,98 @@ def test_dynamic_strided_slice():
     _assert_test(Input, Expected)
 
 
+def _fp8_linear():
+    @I.ir_module
+    class Linear:
+        @R.function
+        def main(x: R.Tensor((8, 64), "float32"), w: R.Tensor((32, 64), "float32")):
+            with R.dataflow():
+                wt = R.permute_dims(w)
+                y = R.matmul(x, wt)
+                gv = R.nn.relu(y)
+                R.output(gv)
+            return gv
+
+    return Linear
+
+
+def _bound_values(func):
+    return {
+        binding.var: binding.value for block in func.body.blocks for binding in block.bindings
+    }
+
+
+def _calls_to(func, op_name):
+    op = tvm.ir.Op.get(op_name)
+    return [
+        value
+        for value in _bound_values(func).values()
+        if isinstance(value, relax.Call) and value.op.same_as(op)
+    ]
+
+
+def _dequantize_scales(func, matmul):
+    """The scales multiplied with the output of the matmul, in order."""
+    values = _bound_values(func)
+    users = {}
+    for call in _calls_to(func, "relax.multiply"):
+        users[call.args[0]] = call
+    scales = []
+    out = next(var for var, value in values.items() if value.same_as(matmul))
+    while out in users:
+        scales.append(users[out].args[1])
+        out = next(var for var, value in values.items() if value.same_as(users[out]))
+    return scales
+
+
+def test_fp8_per_tensor_matmul():
+    mod = ToMixedPrecision(fp8_dtype="float8_e4m3fn")(_fp8_linear())
+    values = _bound_values(mod["main"])
+    (matmul,) = _calls_to(mod["main"], "relax.matmul")
+    assert [arg.struct_info.dtype for arg in matmul.args] == ["float8_e4m3fn"] * 2
+    assert matmul.struct_info.dtype == "float32"
+    # the weight is quantized before its transpose, for the scaled fp8 gemms
+    transpose = values[matmul.args[1]]
+    assert transpose.op.same_as(tvm.ir.Op.get("relax.permute_dims"))
+    assert transpose.args[0].struct_info.dtype == "float8_e4m3fn"
+    # both scales are computed from the current tensors, with shape (1,)
+    assert len(_calls_to(mod["main"], "relax.max")) == 2
+    (scale,) = _dequantize_scales(mod["main"], matmul)
+    shapes = [[int(dim) for dim in arg.struct_info.shape] for arg in values[scale].args]
+    assert shapes == [[1], [1]]
+
+    mod = relax.backend.cuda.cublas.partition_for_cublas(mod)
+    composites = [
+        func.attrs["Composite"]
+        for func in mod.functions.values()
+        if isinstance(func, relax.Function) and func.attrs and "Composite" in func.attrs
+    ]
+    assert composites == ["cublas.matmul_transposed_multiply"]
+
+
+def test_fp8_per_channel_matmul():
+    mod = ToMixedPrecision(fp8_dtype="float8_e4m3fn", fp8_scaling="channel")(_fp8_linear())
+    (matmul,) = _calls_to(mod["main"], "relax.matmul")
+    # one scale per row of x, then one per output channel of w
+    scales = _dequantize_scales(mod["main"], matmul)
+    shapes = [[int(dim) for dim in scale.struct_info.shape] for scale in scales]
+    assert shapes == [[8, 1], [1, 32]]
+
+
+def test_fp8_calibrated_amax():
+    mod = ToMixedPrecision(fp8_dtype="float8_e5m2", fp8_amax={"x": 4.0})(_fp8_linear())
+    # only the amax of w is computed, the scale of x is a constant
+    assert len(_calls_to(mod["main"], "relax.max")) == 1
+    (matmul,) = _calls_to(mod["main"], "relax.matmul")
+    assert [arg.struct_info.dtype for arg in matmul.args] == ["float8_e5m2"] * 2
+    # the relu and the output stay as in the fp16 mode
+    assert mod["main"].ret_struct_info.dtype == "float32"
+
+
+def test_fp8_invalid_dtype():
+    with pytest.raises(tvm.TVMError):
+        ToMixedPrecision(fp8_dtype="int8")
+
+
 if __name__ == "__main__":
     tvm.testing.main()
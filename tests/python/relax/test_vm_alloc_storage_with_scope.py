@@ -74,5 +74,29 @@ def test_alloc_storage_with_scope_global():
     tvm.testing.assert_allclose(output_ref, output)
 
 
+
+@tvm.testing.requires_cuda
+def test_alloc_storage_stream_ordered():
+    arg0 = np.random.uniform(size=(2, 2)).astype(np.float32)
+    output_ref = arg0 + arg0
+    target = tvm.target.Target("cuda")
+    with target:
+        mod = tvm.tir.transform.DefaultGPUSchedule()(Module)
+    with tvm.transform.PassContext(opt_level=3):
+        lib = tvm.relax.build(mod, target=target, exec_mode="compiled")
+
+    dev = tvm.cuda()
+    vm_rt = relax.VirtualMachine(lib, dev, memory_cfg="stream_ordered")
+    set_release_threshold = tvm.get_global_func(
+        "vm.builtin.memory_manager.stream_ordered_set_release_threshold"
+    )
+    set_release_threshold(dev, 0)
+    for _ in range(3):
+        x = tvm.runtime.tensor(arg0, dev)
+        vm_rt.set_input("main", x)
+        vm_rt.invoke_stateful("main")
+        output = vm_rt.get_outputs("main").numpy()
+        tvm.testing.assert_allclose(output_ref, output)
+
 if __name__ == "__main__":
     tvm.testing.main()
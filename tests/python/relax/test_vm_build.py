@@ -31,7 +31,7 @@ from tvm.script import relax as R, tir as T, ir as I
 from tvm.relax.testing.vm import check_saved_func
 from tvm.runtime import ShapeTuple
 
-EXEC_MODE = ["bytecode", "compiled"]
+EXEC_MODE = ["bytecode", "compiled", "auto"]
 
 
 @pytest.fixture(params=EXEC_MODE)
@@ -59,6 +59,36 @@ def test_vm_compile_simple(exec_mode):
     tvm.testing.assert_allclose(inp2.numpy(), inp1.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_compile_cache(tmp_path):
+    from tvm.driver import compile_cache
+
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def foo(x: R.Tensor((3, 4), "float32"), y: R.Tensor((3, 4), "float32")):
+            z = R.add(x, y)
+            return z
+
+    target = tvm.target.Target("llvm", host="llvm")
+    inp1 = tvm.runtime.tensor(np.random.rand(3, 4).astype(np.float32))
+    inp2 = tvm.runtime.tensor(np.random.rand(3, 4).astype(np.float32))
+    old_dir = compile_cache.get_cache_dir()
+    compile_cache.set_cache_dir(str(tmp_path))
+    compile_cache.reset_stats()
+    try:
+        results = []
+        for _ in range(2):
+            ex = relax.build(Module, target)
+            vm = relax.VirtualMachine(ex, tvm.cpu())
+            results.append(vm["foo"](inp1, inp2).numpy())
+        stats = compile_cache.get_stats()
+    finally:
+        compile_cache.set_cache_dir(old_dir)
+    assert stats == {"hits": 1, "misses": 1, "stores": 1}
+    tvm.testing.assert_allclose(results[0], inp1.numpy() + inp2.numpy())
+    tvm.testing.assert_allclose(results[1], results[0])
+
+
 def test_vm_compile_without_target_arg(exec_mode):
     """Like test_vm_compile_simple, but with a default target"""
 
@@ -137,6 +167,33 @@ def test_vm_compile_stage2(exec_mode):
         vm["foo"]([])
 
 
+def test_vm_fused_param_check(exec_mode):
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def foo(x: R.Tensor(["n", "m"], "float32"), y: R.Tensor(["m * 2"], "float32")) -> R.Shape:
+            n, m = T.int64(), T.int64()
+            return R.shape([n * m])
+
+    target = tvm.target.Target("llvm", host="llvm")
+    with tvm.transform.PassContext(config={"relax.VMShapeLower.fuse_checks": True}):
+        ex = relax.build(Module, target, exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    def run(x_shape, y_shape, x_dtype="float32"):
+        x = tvm.runtime.tensor(np.zeros(x_shape).astype(x_dtype))
+        y = tvm.runtime.tensor(np.zeros(y_shape).astype("float32"))
+        return vm["foo"](x, y)
+
+    assert run((3, 4), (8,))[0] == 12
+    with pytest.raises(RuntimeError, match=".*ndim.*"):
+        run((3,), (8,))
+    with pytest.raises(RuntimeError, match=".*dtype.*"):
+        run((3, 4), (8,), "int32")
+    with pytest.raises(RuntimeError, match=r".*shape\[0\] mismatch.*"):
+        run((3, 4), (4,))
+
+
 def test_vm_compile_stage3(exec_mode):
     @tvm.script.ir_module
     class TestVMCompileStage3:
@@ -848,6 +905,70 @@ def test_recursion(exec_mode):
     tvm.testing.assert_allclose(res.numpy(), np.power(2.0, recursion_runs), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_auto_exec_mode():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def double(x: R.Tensor((4,), "float32")) -> R.Tensor:
+            return R.call_pure_packed(
+                "test.vm.add", x, x, sinfo_args=(R.Tensor(ndim=1, dtype="float32"))
+            )
+
+        @R.function
+        def interpreted(x: R.Tensor((4,), "float32")) -> R.Tensor:
+            R.func_attr({"relax.vm_exec_mode": "bytecode"})
+            return Module.double(x)
+
+        @R.function
+        def branch(x: R.Tensor((4,), "float32"), cond: R.Tensor((), "bool")) -> R.Tensor:
+            if cond:
+                res = Module.double(x)
+            else:
+                res = x
+            return res
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.build(Module, target, exec_mode="auto")
+    text = ex.as_text()
+    # Only the function with static control flow and no attribute is compiled.
+    assert "@double num_inputs=1 vm_tir_func" in text
+    assert "@interpreted num_inputs=1 vm_tir_func" not in text
+    assert "@branch num_inputs=2 vm_tir_func" not in text
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = tvm.runtime.tensor(np.random.rand(4).astype("float32"))
+    tvm.testing.assert_allclose(vm["double"](x).numpy(), 2 * x.numpy())
+    tvm.testing.assert_allclose(vm["interpreted"](x).numpy(), 2 * x.numpy())
+    for cond, expected in [(True, 2 * x.numpy()), (False, x.numpy())]:
+        res = vm["branch"](x, tvm.runtime.tensor(np.array(cond)))
+        tvm.testing.assert_allclose(res.numpy(), expected)
+
+
+def test_vm_auto_exec_mode_calls_later_private_function():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((4,), "float32")) -> R.Tensor:
+            return Module.interpreted(x)
+
+        @R.function(private=True)
+        def interpreted(x: R.Tensor((4,), "float32")) -> R.Tensor:
+            R.func_attr({"relax.vm_exec_mode": "bytecode"})
+            return R.call_pure_packed(
+                "test.vm.add", x, x, sinfo_args=(R.Tensor(ndim=1, dtype="float32"))
+            )
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.build(Module, target, exec_mode="auto")
+    text = ex.as_text()
+    # The compiled caller refers to the private callee as a bytecode function.
+    assert "@main num_inputs=1 vm_tir_func" in text
+    assert "@interpreted num_inputs=1 vm_tir_func" not in text
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = tvm.runtime.tensor(np.random.rand(4).astype("float32"))
+    tvm.testing.assert_allclose(vm["main"](x).numpy(), 2 * x.numpy())
+
+
 @tvm.testing.requires_gpu
 def test_vm_to_device(exec_mode):
     @tvm.script.ir_module
@@ -53,6 +53,142 @@ def test_multinomial_from_uniform():
     tvm.testing.assert_allclose(res.numpy(), np.array([[4], [0], [4]]).astype(np.int64))
 
 
+def test_sample_top_p():
+    fsample_from_prob = tvm.get_global_func("vm.builtin.sample_top_p_from_prob")
+    fsample_from_logits = tvm.get_global_func("vm.builtin.sample_top_p_from_logits")
+    fbatch_sample_from_prob = tvm.get_global_func("vm.builtin.batch_sample_top_p_from_prob")
+    fbatch_sample_from_logits = tvm.get_global_func("vm.builtin.batch_sample_top_p_from_logits")
+
+    np_prob = np.array([[0.1, 0.5, 0.05, 0.3, 0.05]], dtype=np.float32)
+    # The top-p nucleus of 0.7 is {1: 0.5, 3: 0.3}, whose cumulative
+    # probabilities after renormalization are {1: 0.625, 3: 1.0}.
+    assert fsample_from_prob(tvm.runtime.tensor(np_prob), 0.7, 0.5) == 1
+    assert fsample_from_prob(tvm.runtime.tensor(np_prob), 0.7, 0.7) == 3
+    assert fsample_from_prob(tvm.runtime.tensor(np_prob), 1.0, 0.99) in [2, 4]
+    np_logits = np.log(np_prob)
+    assert fsample_from_logits(tvm.runtime.tensor(np_logits), 1.0, 0.7, 0.7) == 3
+    assert fsample_from_logits(tvm.runtime.tensor(np_logits), 0.0, 0.7, 0.7) == 1
+
+    # Batched sampling agrees with sampling row by row.
+    batch_size, vocab_size = 8, 32000
+    np_logits = np.random.randn(batch_size, vocab_size).astype(np.float32) * 4
+    np_prob = np.exp(np_logits - np_logits.max(axis=1, keepdims=True))
+    np_prob = (np_prob / np_prob.sum(axis=1, keepdims=True)).astype(np.float32)
+    np_top_p = np.random.uniform(0.1, 1.0, (batch_size,)).astype(np.float32)
+    np_temperature = np.ones((batch_size,), dtype=np.float32)
+    np_sample = np.random.uniform(0, 1, (batch_size,)).astype(np.float32)
+    res_prob = fbatch_sample_from_prob(
+        tvm.runtime.tensor(np_prob), tvm.runtime.tensor(np_top_p), tvm.runtime.tensor(np_sample)
+    ).numpy()
+    res_logits = fbatch_sample_from_logits(
+        tvm.runtime.tensor(np_logits),
+        tvm.runtime.tensor(np_temperature),
+        tvm.runtime.tensor(np_top_p),
+        tvm.runtime.tensor(np_sample),
+    ).numpy()
+    assert res_prob.shape == (batch_size, 1)
+    for i in range(batch_size):
+        expected = fsample_from_prob(
+            tvm.runtime.tensor(np_prob[i : i + 1]), float(np_top_p[i]), float(np_sample[i])
+        )
+        assert res_prob[i, 0] == expected
+        # The nucleus computed from logits only differs by rounding errors.
+        assert np_prob[i, res_logits[i, 0]] > 0
+
+
+@tvm.testing.requires_cuda
+def test_gpu_batch_sample():
+    fsample_from_prob = tvm.get_global_func(
+        "vm.builtin.cuda.batch_sample_from_prob", allow_missing=True
+    )
+    fsample_from_logits = tvm.get_global_func(
+        "vm.builtin.cuda.batch_sample_from_logits", allow_missing=True
+    )
+    if fsample_from_prob is None:
+        pytest.skip("The GPU sampling builtins need USE_THRUST")
+    dev = tvm.cuda()
+
+    def run(func, inputs, top_k, top_p, min_p, sample):
+        args = [tvm.runtime.tensor(x, dev) for x in inputs]
+        args.append(tvm.runtime.tensor(np.array(top_k, dtype=np.int32), dev))
+        for x in [top_p, min_p, sample]:
+            args.append(tvm.runtime.tensor(np.array(x, dtype=np.float32), dev))
+        output = tvm.runtime.empty((len(sample), 1), "int64", dev)
+        func(*args, output)
+        return output.numpy()[:, 0].tolist()
+
+    np_prob = np.tile(np.array([[0.1, 0.5, 0.05, 0.3, 0.05]], dtype=np.float32), (5, 1))
+    # The tokens kept are sampled in the index order: top-p of 0.7 and min-p of 0.5 keep
+    # {1: 0.5, 3: 0.3}, top-k of 3 keeps {0: 0.1, 1: 0.5, 3: 0.3}, and top-k of 1 keeps {1}.
+    res = run(
+        fsample_from_prob,
+        [np_prob],
+        top_k=[0, 0, 3, 1, 0],
+        top_p=[0.7, 0.7, 1.0, 1.0, 1.0],
+        min_p=[0.0, 0.0, 0.0, 0.0, 0.5],
+        sample=[0.5, 0.7, 0.05, 0.99, 0.7],
+    )
+    assert res == [1, 3, 0, 1, 3]
+
+    batch_size, vocab_size = 16, 32000
+    np_logits = np.random.randn(batch_size, vocab_size).astype(np.float32) * 4
+    np_temperature = np.array([0.0, 1.0] * (batch_size // 2), dtype=np.float32)
+    res = run(
+        fsample_from_logits,
+        [np_logits, np_temperature],
+        top_k=[0] * batch_size,
+        top_p=[0.9] * batch_size,
+        min_p=[0.0] * batch_size,
+        sample=np.random.uniform(0, 1, (batch_size,)),
+    )
+    np_prob = np.exp(np_logits - np_logits.max(axis=1, keepdims=True))
+    np_prob = np_prob / np_prob.sum(axis=1, keepdims=True)
+    for i in range(batch_size):
+        if np_temperature[i] == 0:
+            assert res[i] == np.argmax(np_logits[i])
+        else:
+            # The token is in the top-p nucleus, up to rounding errors.
+            assert np_prob[i][np_prob[i] > np_prob[i, res[i]]].sum() < 0.9 + 1e-4
+
+
+def _bitmask_inputs(batch_size=4, vocab_size=100):
+    np_logits = np.random.randn(batch_size, vocab_size).astype(np.float32)
+    np_allowed = np.random.rand(batch_size, vocab_size) < 0.3
+    num_words = (vocab_size + 31) // 32
+    np_bits = np.zeros((batch_size, num_words * 32), dtype=np.uint64)
+    np_bits[:, :vocab_size] = np_allowed
+    np_bitmask = (np_bits.reshape(batch_size, num_words, 32) << np.arange(32, dtype=np.uint64))
+    np_bitmask = np_bitmask.sum(axis=2).astype(np.uint32).view(np.int32)
+    # Only the rows in seq_ids are masked.
+    np_seq_ids = np.array([2, 0, 3], dtype=np.int32)
+    expected = np_logits.copy()
+    for row in np_seq_ids:
+        expected[row][~np_allowed[row]] = np.finfo(np.float32).min
+    return np_logits, np_seq_ids, np_bitmask, expected
+
+
+def test_apply_bitmask_inplace():
+    fapply_bitmask = tvm.get_global_func("vm.builtin.apply_bitmask_inplace")
+    np_logits, np_seq_ids, np_bitmask, expected = _bitmask_inputs()
+    logits = tvm.runtime.tensor(np_logits)
+    fapply_bitmask(logits, tvm.runtime.tensor(np_seq_ids), tvm.runtime.tensor(np_bitmask))
+    tvm.testing.assert_allclose(logits.numpy(), expected)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.parametrize_targets("cuda")
+def test_gpu_apply_bitmask_inplace(target, dev):
+    from tvm.relax.backend.gpu_generic import gpu_apply_bitmask_inplace
+
+    with tvm.target.Target(target):
+        func = gpu_apply_bitmask_inplace()
+    lib = tvm.compile(func, target=target)
+    np_logits, np_seq_ids, np_bitmask, expected = _bitmask_inputs()
+    logits = tvm.runtime.tensor(np_logits, dev)
+    lib(logits, tvm.runtime.tensor(np_seq_ids, dev), tvm.runtime.tensor(np_bitmask, dev))
+    tvm.testing.assert_allclose(logits.numpy(), expected)
+
+
 @tvm.testing.parametrize_targets("cuda")
 def test_alloc_tensor_raises_out_of_memory(target, dev):
     """Out-of-memory exceptions may be raised from VM
@@ -107,6 +107,95 @@ def test_vm_run():
     tvm.testing.assert_allclose(y.numpy(), y_np, rtol=1e-5, atol=1e-5)
 
 
+@tvm.testing.requires_cudagraph
+def test_vm_run_with_bounded_graph_cache():
+    mod = Module
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = codegen(mod, target)
+    dev = tvm.cuda(0)
+    vm = relax.VirtualMachine(ex, dev)
+    vm.set_cuda_graph_max_num_graphs(1)
+    # The capture function has no symbolic variables, so no bucket applies to it.
+    vm.prewarm_cuda_graph([(4,), (8,)])
+    for _ in range(3):
+        x_np = np.random.uniform(size=(16, 16)).astype("float32")
+        x = tvm.runtime.tensor(x_np, dev)
+        y = vm["main"](x)
+        tvm.testing.assert_allclose(y.numpy(), x_np + 4.0, rtol=1e-5, atol=1e-5)
+
+
+@tvm.testing.requires_cudagraph
+def test_vm_warmup_manifest(tmp_path):
+    manifest_path = str(tmp_path / "cuda_graph_manifest.json")
+    with open(manifest_path, "w") as manifest_file:
+        manifest_file.write('{"shape_buckets": [[1], [2, 128]]}')
+    shape_buckets = tvm.get_global_func("vm.builtin.cuda_graph.load_warmup_manifest")(
+        manifest_path
+    )
+    assert [list(shape) for shape in shape_buckets] == [[1], [2, 128]]
+
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = codegen(Module, target)
+    dev = tvm.cuda(0)
+    vm = relax.VirtualMachine(ex, dev)
+    x = tvm.runtime.tensor(np.random.uniform(size=(16, 16)).astype("float32"), dev)
+    assert vm.warmup_cuda_graph(manifest_path) == 0
+    assert vm.warmup_cuda_graph(manifest_path, "main", x) == 1
+
+    # The capture function of the module has no symbolic variables to record.
+    vm.save_cuda_graph_warmup_manifest(manifest_path)
+    with open(manifest_path, "r") as manifest_file:
+        assert manifest_file.read() == '{"shape_buckets": []}'
+
+
+@tvm.testing.requires_cudagraph
+def test_prewarm_keeps_states_of_first_call():
+    @I.ir_module
+    class SymbolicModule:
+        @R.function
+        def main(A: R.Tensor(("n",), "float32")):
+            R.func_attr(
+                {
+                    "relax.rewrite_cuda_graph.capture_symbolic_vars": ["n"],
+                    "tir_var_upper_bound": {"n": 16},
+                }
+            )
+            B = R.add(A, A)
+            C = R.multiply(B, B)
+            D = R.add(C, A)
+            return D
+
+    target = tvm.target.Target("cuda")
+    dev = tvm.cuda()
+    with target, tvm.ir.transform.PassContext(config={"relax.backend.use_cuda_graph": True}):
+        mod = tvm.ir.transform.Sequential(
+            [
+                tvm.relax.transform.LegalizeOps(),
+                tvm.tir.transform.DefaultGPUSchedule(),
+                tvm.relax.transform.RemovePurityChecking(),
+                tvm.relax.transform.CallTIRRewrite(),
+                tvm.relax.transform.StaticPlanBlockMemory(),
+                tvm.relax.transform.RewriteCUDAGraph(),
+            ]
+        )(SymbolicModule)
+    assert "cuda_graph_alloc" in mod
+
+    vm = tvm.relax.VirtualMachine(tvm.compile(mod, target=target), dev)
+    # The buckets are captured on the first call, on the storages of that call.
+    vm.prewarm_cuda_graph([(2,), (4,), (2,)])
+    for n in [8, 4, 8]:
+        a_np = np.arange(n).astype("float32")
+        d = vm["main"](tvm.runtime.tensor(a_np, dev))
+        tvm.testing.assert_allclose(d.numpy(), (2 * a_np) ** 2 + a_np, rtol=1e-5, atol=1e-5)
+    get_num_graphs = tvm.get_global_func("vm.builtin.cuda_graph.get_num_graphs")
+    get_captured_shapes = tvm.get_global_func("vm.builtin.cuda_graph.get_captured_shapes")
+    assert sorted(list(shape) for shape in get_captured_shapes(vm.module)) == [[2], [4], [8]]
+    # Declaring the buckets again captures nothing new.
+    num_graphs = get_num_graphs(vm.module)
+    vm.prewarm_cuda_graph([(2,), (4,)])
+    assert get_num_graphs(vm.module) == num_graphs
+
+
 @tvm.testing.requires_cudagraph
 def test_capture_error_is_recoverable():
     """Function calls while capturing cudagraph may throw exceptions
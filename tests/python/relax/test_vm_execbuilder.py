@@ -15,6 +15,9 @@
 # specific language governing permissions and limitations
 # under the License.
 """Lowest level testing VM. Test execbuilder and execution."""
+import os
+import sys
+
 import numpy as np
 import pytest
 
@@ -292,5 +295,123 @@ def test_vm_stack_restore_after_failure():
     vm["main"](correct_input)
 
 
+def test_vm_release_dead_registers():
+    stashed = []
+
+    @tvm.register_global_func("test.vm.release.stash", override=True)
+    def stash(x):
+        stashed.append(x)
+        return x
+
+    @tvm.register_global_func("test.vm.release.use_count", override=True)
+    def use_count():
+        return tvm.testing.object_use_count(stashed[0])
+
+    ib = relax.ExecBuilder()
+    with ib.function("func0", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(0)], dst=ib.r(1))
+        # The last use of r1, whose result is dead.
+        ib.emit_call("test.vm.release.stash", args=[ib.r(1)], dst=ib.r(2))
+        ib.emit_call("test.vm.release.use_count", args=[], dst=ib.r(3))
+        ib.emit_ret(ib.r(3))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    a = tvm.runtime.tensor(np.random.rand(4))
+    # Only the stash refers to the sum when the count is taken.
+    assert check_saved_func(vm, "func0", a) == 1
+    stashed.clear()
+
+
+def test_vm_decoded_call_args():
+    @tvm.register_global_func("test.vm.decoded.axpy", override=True)
+    def axpy(vm_state, x, y, scale):
+        assert vm_state is not None
+        return tvm.runtime.tensor(x.numpy() * scale + y.numpy())
+
+    y = tvm.runtime.tensor(np.random.rand(4))
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=1):
+        for i, scale in enumerate([2, 3]):
+            args = [ib.vm_state(), ib.r(i), y, ib.imm(scale)]
+            ib.emit_call("test.vm.decoded.axpy", args=args, dst=ib.r(i + 1))
+        ib.emit_ret(ib.r(2))
+    vm = relax.VirtualMachine(ib.get(), tvm.cpu())
+
+    num_calls = []
+
+    def instrument(func, name, before_run, ret, *args):
+        if before_run:
+            num_calls.append(name)
+
+    # The decoded calls only patch the register of the input, whichever path runs them.
+    for use_instrument in [False, True, False]:
+        vm.set_instrument(instrument if use_instrument else None)
+        x = tvm.runtime.tensor(np.random.rand(4))
+        expected = (x.numpy() * 2 + y.numpy()) * 3 + y.numpy()
+        tvm.testing.assert_allclose(vm["main"](x).numpy(), expected, rtol=1e-7, atol=1e-7)
+    assert len(num_calls) == 2
+
+
+def test_vm_load_from_file_with_constants(tmp_path):
+    small = tvm.runtime.tensor(np.random.rand(4).astype("float32"))
+    # Its data is saved at a page-aligned offset that the load of the mapped file aliases.
+    large = tvm.runtime.tensor(np.random.rand(64, 64).astype("float32"))
+    ib = relax.ExecBuilder()
+    with ib.function("small", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), small], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    with ib.function("large", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), large], dst=ib.r(1))
+        ib.emit_call("test.vm.add", args=[ib.r(1), large], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    path = str(tmp_path / "exec.bin")
+    ib.get().mod.write_to_file(path)
+
+    load_from_file = tvm.get_global_func("ffi.Module.load_from_file.relax.VMExecutable")
+    load_from_bytes = tvm.get_global_func("ffi.Module.load_from_bytes.relax.VMExecutable")
+    with open(path, "rb") as f:
+        data = f.read()
+    mapped_mod = load_from_file(path)
+    for mod in [mapped_mod, load_from_bytes(data)]:
+        vm = relax.VirtualMachine(relax.VMExecutable(mod), tvm.cpu())
+        x = tvm.runtime.tensor(np.random.rand(4).astype("float32"))
+        tvm.testing.assert_allclose(vm["small"](x).numpy(), x.numpy() + small.numpy())
+        y = tvm.runtime.tensor(np.random.rand(64, 64).astype("float32"))
+        res = vm["large"](y).numpy()
+        tvm.testing.assert_allclose(res, y.numpy() + 2 * large.numpy(), rtol=1e-6)
+
+    if sys.platform != "linux":
+        return
+    # The tensor constants loaded from the file are views of its mapping, and not copies.
+    mappings = []
+    with open("/proc/self/maps") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 6 and fields[5] == os.path.realpath(path):
+                begin, end = (int(addr, 16) for addr in fields[0].split("-"))
+                mappings.append((begin, end))
+    assert mappings
+    constants = [c for c in mapped_mod["get_constants"]() if isinstance(c, tvm.runtime.Tensor)]
+    assert len(constants) == 2
+    for constant in constants:
+        ptr = np.from_dlpack(constant).ctypes.data
+        assert any(begin <= ptr < end for begin, end in mappings)
+    assert np.from_dlpack(constants[1]).ctypes.data % 4096 == 0
+
+
+def test_vm_release_keeps_returned_register():
+    ib = relax.ExecBuilder()
+    with ib.function("func0", num_inputs=1):
+        # r1 is only used by the return after its definition.
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(0)], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    a = tvm.runtime.tensor(np.random.rand(4))
+    res = check_saved_func(vm, "func0", a)
+    assert res is not None
+    tvm.testing.assert_allclose(res.numpy(), a.numpy() * 2, rtol=1e-7, atol=1e-7)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -98,5 +98,26 @@ def test_lib_comparator():
     vm["main"](tvm.runtime.tensor(data_np))
 
 
+def test_call_sampling():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm.set_call_sampling(3)
+    for _ in range(10):
+        vm["main"](tvm.runtime.tensor(data_np))
+
+    report = vm.get_call_sampling_report()
+    # The first call is sampled, then every third one.
+    assert report["matmul"]["calls"] == 20
+    assert report["matmul"]["samples"] == 7
+    stats = report["relu"]
+    assert 0 <= stats["p50_us"] <= stats["p90_us"] <= stats["p99_us"] <= stats["max_us"]
+    assert stats["mean_us"] <= stats["max_us"]
+    assert "main" not in report
+
+    vm.set_call_sampling(0)
+    assert vm.get_call_sampling_report() == {}
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,140 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+
+@I.ir_module
+class TwoTowers:
+    @R.function
+    def main(
+        x: R.Tensor((16, 32), "float32"),
+        w0: R.Tensor((32, 32), "float32"),
+        w1: R.Tensor((32, 32), "float32"),
+    ):
+        with R.dataflow():
+            a0 = R.matmul(x, w0)
+            b0 = R.matmul(x, w1)
+            a1 = R.nn.relu(a0)
+            b1 = R.multiply(b0, b0)
+            a2 = R.matmul(a1, w1)
+            b2 = R.matmul(b1, w0)
+            out = R.add(a2, b2)
+            R.output(out)
+        return out
+
+
+def _reference(x, w0, w1):
+    a = np.maximum(x @ w0, 0) @ w1
+    b = x @ w1
+    return a + (b * b) @ w0
+
+
+@tvm.testing.requires_llvm
+def test_parallel_dispatch_two_towers(monkeypatch):
+    # A single worker runs the concurrent calls inline, which supports nested launches.
+    monkeypatch.setenv("TVM_NUM_THREADS", "1")
+    ex = relax.build(TwoTowers, tvm.target.Target("llvm", host="llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm.set_parallel_dispatch(True)
+
+    shapes = [(16, 32), (32, 32), (32, 32)]
+    x, w0, w1 = [np.random.uniform(size=shape).astype("float32") for shape in shapes]
+    args = [tvm.runtime.tensor(v) for v in [x, w0, w1]]
+    expected = _reference(x, w0, w1)
+    # run twice, the second run reuses the planned storage
+    for _ in range(2):
+        tvm.testing.assert_allclose(vm["main"](*args).numpy(), expected, rtol=1e-5, atol=1e-5)
+
+    vm.set_parallel_dispatch(False)
+    tvm.testing.assert_allclose(vm["main"](*args).numpy(), expected, rtol=1e-5, atol=1e-5)
+
+
+def _concurrent_steps(ex):
+    plan = tvm.get_global_func("vm.builtin.get_dispatch_plan")(ex.mod)
+    return [list(step) for step in plan if len(step) > 1]
+
+
+@tvm.testing.requires_llvm
+def test_parallel_dispatch_plans_concurrent_towers():
+    ex = relax.build(TwoTowers, tvm.target.Target("llvm", host="llvm"))
+    # the first matmuls of both towers only read the arguments of the function
+    assert any(len(step) >= 2 for step in _concurrent_steps(ex))
+
+
+@I.ir_module
+class InplaceAfterRead:
+    @T.prim_func(private=True)
+    def copy(a: T.Buffer((16,), "float32"), b: T.Buffer((16,), "float32")):
+        for i in range(16):
+            with T.block("copy"):
+                vi = T.axis.spatial(16, i)
+                b[vi] = a[vi]
+
+    @T.prim_func(private=True)
+    def add_one(a: T.Buffer((16,), "float32")):
+        for i in range(16):
+            with T.block("add_one"):
+                vi = T.axis.spatial(16, i)
+                a[vi] = a[vi] + T.float32(1)
+
+    @R.function
+    def main(x: R.Tensor((16,), "float32")):
+        cls = InplaceAfterRead
+        y = R.call_tir(cls.copy, (x,), out_sinfo=R.Tensor((16,), "float32"))
+        z = R.call_tir_inplace(
+            cls.add_one, (x,), inplace_indices=[0], out_sinfo=R.Tensor((16,), "float32")
+        )
+        return (y, z)
+
+
+@tvm.testing.requires_llvm
+def test_parallel_dispatch_inplace_call_stays_sequential(monkeypatch):
+    monkeypatch.setenv("TVM_NUM_THREADS", "1")
+    ex = relax.build(InplaceAfterRead, tvm.target.Target("llvm", host="llvm"))
+    # the in-place update of the argument must wait for the copy that reads it
+    assert _concurrent_steps(ex) == []
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm.set_parallel_dispatch(True)
+    x = np.random.uniform(size=(16,)).astype("float32")
+    y, z = vm["main"](tvm.runtime.tensor(x))
+    tvm.testing.assert_allclose(y.numpy(), x)
+    tvm.testing.assert_allclose(z.numpy(), x + 1)
+
+
+@tvm.testing.requires_llvm
+def test_parallel_dispatch_requires_nested_launch(monkeypatch):
+    monkeypatch.setenv("TVM_NUM_THREADS", "4")
+    monkeypatch.delenv("TVM_THREAD_POOL_KIND", raising=False)
+    if tvm.support.libinfo().get("USE_OPENMP", "none") not in ["none", "OFF", "NOT-FOUND"]:
+        pytest.skip("OpenMP pool supports nested launches")
+    ex = relax.build(TwoTowers, tvm.target.Target("llvm", host="llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    with pytest.raises(ValueError):
+        vm.set_parallel_dispatch(True)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
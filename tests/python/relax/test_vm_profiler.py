@@ -14,11 +14,14 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
 import tvm
 import tvm.testing
 
 from tvm import relax, rpc
+from tvm.runtime import profiling
 from tvm.contrib import utils
 from tvm.relax.testing import nn
 from tvm.script import relax as R
@@ -62,6 +65,143 @@ def test_conv2d_cpu():
     assert "matmul" in str(report)
 
 
+def test_kernel_flops():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+    vm = relax.VirtualMachine(ex, tvm.cpu(), profile=True)
+    data = tvm.runtime.tensor(data_np)
+
+    calls = json.loads(vm.profile("main", data).json())["calls"]
+    kernels = {call["Name"]["string"] for call in calls if "matmul" in call["Name"]["string"]}
+    assert kernels
+    report = vm.profile("main", data, flops={name: 2 * 64 * 64 for name in kernels})
+    calls = json.loads(report.json())["calls"]
+    for call in calls:
+        if call["Name"]["string"] in kernels:
+            assert call["FLOPs"]["count"] == 2 * 64 * 64
+    assert "GFLOP/s" in report.table()
+
+    # The FLOPs only apply to the profile they are given to.
+    calls = json.loads(vm.profile("main", data).json())["calls"]
+    assert all("FLOPs" not in call for call in calls)
+
+
+def test_derived_metrics():
+    calls = [
+        {
+            "Name": "matmul",
+            "Duration (us)": profiling.Duration(2.0),
+            "Count": profiling.Count(1),
+            "FLOPs": profiling.Count(8000),
+            "Cache Misses": profiling.Count(250),
+        }
+    ]
+    report = profiling.Report(calls, {}, {})
+    table = report.table(aggregate=False, col_sums=False)
+    header, row = table.splitlines()[:2]
+
+    def column(name):
+        # the columns but the first are right aligned
+        end = header.index(name) + len(name)
+        return float(row[:end].split()[-1])
+
+    # 8000 FLOPs in 2 us, and 250 * 64 bytes for 8000 FLOPs
+    assert column("GFLOP/s") == 4
+    assert column("Bytes/FLOP") == 2
+
+
+def test_roofline_metrics():
+    # the metrics of a CUDA kernel, as the CUPTI collector reports them, where the duration of
+    # the call includes the replays of its kernels
+    calls = [
+        {
+            "Name": "matmul",
+            "Duration (us)": profiling.Duration(20.0),
+            "Kernel Duration (us)": profiling.Duration(2.0),
+            "Count": profiling.Count(1),
+            "FLOPs": profiling.Count(8000),
+            "DRAM Bytes": profiling.Count(4000),
+            "Peak DRAM Bandwidth (GB/s)": profiling.Ratio(8.0),
+        },
+        {
+            "Name": "copy",
+            "Duration (us)": profiling.Duration(10.0),
+            "Kernel Duration (us)": profiling.Duration(1.0),
+            "Count": profiling.Count(1),
+            "DRAM Bytes": profiling.Count(4000),
+            "Peak DRAM Bandwidth (GB/s)": profiling.Ratio(8.0),
+        },
+        {
+            "Name": "replayed",
+            "Duration (us)": profiling.Duration(10.0),
+            "Count": profiling.Count(1),
+            "DRAM Bytes": profiling.Count(4000),
+            "Peak DRAM Bandwidth (GB/s)": profiling.Ratio(8.0),
+        },
+    ]
+    table = profiling.Report(calls, {}, {}).table(sort=False, aggregate=False, col_sums=False)
+    header, matmul, copy, replayed = table.splitlines()[:4]
+
+    def column(row, name):
+        # the headers are wider than the cells, which are right aligned under them
+        start = header.index(name)
+        return row[start : start + len(name)].strip()
+
+    # 8000 FLOPs for 4000 bytes, moved at 2 GB/s then 4 GB/s by the kernels
+    assert float(column(matmul, "FLOP/Byte")) == 2
+    assert float(column(matmul, "GFLOP/s")) == 4
+    assert float(column(matmul, "DRAM Bandwidth (%)")) == 25
+    assert float(column(copy, "DRAM Bandwidth (%)")) == 50
+    # the duration of the call alone would count the replays
+    assert column(replayed, "DRAM Bandwidth (%)") == ""
+    # the arithmetic intensity needs the FLOPs of the call
+    assert column(copy, "FLOP/Byte") == ""
+
+
+def test_nvtx_ranges():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    expected = vm["main"](tvm.runtime.tensor(data_np)).numpy()
+
+    profiling.enable_nvtx_ranges()
+    try:
+        # the ranges are only entered when TVM is built with NVTX
+        if tvm.support.libinfo().get("USE_NVTX", "OFF").lower() not in ["on", "true", "1"]:
+            assert not tvm.get_global_func("runtime.profiling.NVTXRangesEnabled")()
+        out = vm["main"](tvm.runtime.tensor(data_np))
+    finally:
+        profiling.enable_nvtx_ranges(False)
+    tvm.testing.assert_allclose(out.numpy(), expected)
+
+
+def test_chrome_trace():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    profiling.start_tracing()
+    vm["main"](tvm.runtime.tensor(data_np))
+    profiling.stop_tracing()
+    trace = json.loads(profiling.export_chrome_trace())
+
+    calls = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert any("matmul" in e["name"] for e in calls)
+    assert all(e["cat"] == "vm" and e["dur"] >= 0 for e in calls)
+    assert trace["otherData"]["dropped_events"] == 0
+
+    merged = json.loads(profiling.merge_chrome_traces([json.dumps(trace)] * 2))
+    assert len(merged["traceEvents"]) == 2 * len(trace["traceEvents"])
+
+    # Events past the capacity of the buffer are dropped
+    profiling.start_tracing(buffer_size=1)
+    vm["main"](tvm.runtime.tensor(data_np))
+    profiling.stop_tracing()
+    trace = json.loads(profiling.export_chrome_trace())
+    assert len([e for e in trace["traceEvents"] if e["ph"] == "X"]) == 1
+    assert trace["otherData"]["dropped_events"] > 0
+
+
 def with_rpc(ex, f, data_np):
     temp = utils.tempdir()
     path = temp.relpath("vm_library.so")
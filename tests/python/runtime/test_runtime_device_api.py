@@ -19,8 +19,11 @@ import os
 import subprocess
 import sys
 
+import numpy as np
+
 import tvm
 import tvm.testing
+from tvm.script import tir as T
 
 
 def test_check_if_device_exists():
@@ -48,5 +51,38 @@ def test_check_if_device_exists():
     )
 
 
+
+def test_workspace_arena():
+    """Large workspaces of a function are served from the arena when it is enabled"""
+
+    @T.prim_func
+    def func(A: T.Buffer((4096,), "float32"), B: T.Buffer((4096,), "float32")):
+        C = T.alloc_buffer((4096,), "float32")
+        D = T.alloc_buffer((4096,), "float32")
+        for i in range(4096):
+            C[i] = A[i] + T.float32(1)
+        for i in range(4096):
+            D[i] = C[i] * T.float32(2)
+        for i in range(4096):
+            B[i] = D[i] + C[i]
+
+    f = tvm.compile(func, target="llvm")
+    dev = tvm.cpu()
+    a_np = np.random.uniform(size=4096).astype("float32")
+    set_arena_mode = tvm.get_global_func("runtime.WorkspacePoolSetArenaMode")
+    try:
+        # A chunk smaller than a single workspace makes the arena grow and merge its chunks.
+        for chunk_size in [0, 4096]:
+            set_arena_mode(True, chunk_size)
+            for _ in range(3):
+                a = tvm.runtime.tensor(a_np, dev)
+                b = tvm.runtime.empty((4096,), "float32", dev)
+                f(a, b)
+                tvm.testing.assert_allclose(b.numpy(), (a_np + 1) * 3)
+    finally:
+        set_arena_mode(False, 0)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), (a_np + 1) * 3)
+
 if __name__ == "__main__":
     tvm.testing.main()
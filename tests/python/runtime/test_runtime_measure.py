@@ -18,8 +18,9 @@ import time
 import ctypes
 
 import tvm
-from tvm import te
+from tvm import rpc, te
 from tvm.contrib.utils import tempdir
+from tvm.runtime import profiling
 from tvm.runtime.module import BenchmarkResult
 
 
@@ -56,6 +57,48 @@ def test_min_repeat_ms():
     assert ct > 10 + 2
 
 
+def _add_func(n):
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    return tvm.tir.build(te.create_prim_func([A, B]))
+
+
+def test_time_evaluate_batch():
+    mods = [_add_func(64), _add_func(64), _add_func(128)]
+    args_info = [[((64,), "float32")] * 2, [((64,), "float32")] * 2, [((128,), "float32")] * 2]
+    results = profiling.time_evaluate_batch(
+        mods + [mods[0]],
+        tvm.cpu(),
+        args_info + [args_info[0]],
+        func_names=["main"] * 3 + ["missing"],
+        number=2,
+        repeat=3,
+    )
+    for result in results[:3]:
+        assert len(result.results) == 3
+        assert all(sec >= 0 for sec in result.results)
+    # the failed functions get no results, and don't stop the others
+    assert results[3] is None
+
+
+def test_time_evaluate_batch_rpc():
+    temp = tempdir()
+    path = temp.relpath("add.so")
+    _add_func(64).export_library(path)
+    remote = rpc.LocalSession()
+    remote.upload(path)
+    rmod = remote.load_module("add.so")
+    results = profiling.time_evaluate_batch(
+        [rmod, rmod],
+        remote.cpu(),
+        [[((64,), "float32")] * 2] * 2,
+        func_names=["main", "main"],
+        repeat=2,
+        session=remote,
+    )
+    assert [len(result.results) for result in results] == [2, 2]
+
+
 def test_benchmark_result():
     r = BenchmarkResult([1, 2, 2, 5])
     assert r.mean == 2.5
@@ -67,4 +110,6 @@ def test_benchmark_result():
 
 if __name__ == "__main__":
     test_min_repeat_ms()
+    test_time_evaluate_batch()
+    test_time_evaluate_batch_rpc()
     test_benchmark_result()
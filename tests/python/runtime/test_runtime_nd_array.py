@@ -249,5 +249,18 @@ def test_2d_view_of_second_half_of_2d_arr():
     np.testing.assert_equal(tvm_output.numpy(), np_expected)
 
 
+@tvm.testing.requires_cuda
+def test_large_copy_through_pinned_staging():
+    """Large copies between pageable memory and the device are staged in chunks"""
+    np_input = np.random.uniform(size=(3 << 20) + 7).astype("float32")
+    dev = tvm.cuda(0)
+    tvm_input = tvm.runtime.tensor(np_input, dev)
+    np.testing.assert_equal(tvm_input.numpy(), np_input)
+
+    tvm_copy = tvm.runtime.empty(np_input.shape, "float32", dev)
+    tvm_copy.copyfrom(np_input[::-1].copy())
+    np.testing.assert_equal(tvm_copy.copyto(tvm.cpu()).numpy(), np_input[::-1])
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -160,6 +160,106 @@ def test_rpc_large_array():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_array_copy_contents():
+    # the payloads are sent from and received into the local buffers directly,
+    # check that the bytes arrive in order, including the odd-sized tail
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+
+    def check_remote():
+        dev = remote.cpu(0)
+        x_np = np.random.randint(0, 255, size=(3 << 20) + 7).astype("uint8")
+        x = tvm.runtime.empty(x_np.shape, "uint8", dev)
+        x.copyfrom(x_np)
+        np.testing.assert_equal(x.numpy(), x_np)
+        y_np = np.zeros((0,), "float32")
+        y = tvm.runtime.tensor(y_np, dev)
+        np.testing.assert_equal(y.numpy(), y_np)
+
+    check_remote()
+
+
+@tvm.testing.requires_rpc
+def test_rpc_pipelined_requests():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+
+    def check_remote():
+        faddone = remote.get_function("rpc.test.addone")
+        fexcept = remote.get_function("rpc.test.except")
+        futures = [remote.call_async(faddone, i) for i in range(8)]
+        failed = remote.call_async(fexcept, "abc")
+        after_failure = remote.call_async(faddone, 100)
+        assert [f.wait() for f in futures] == list(range(1, 9))
+        with pytest.raises(tvm.base.TVMError):
+            failed.wait()
+        assert after_failure.wait() == 101
+        # synchronous calls still work while requests are in flight
+        pending = remote.call_async(faddone, 1)
+        assert faddone(2) == 3
+        assert pending.wait() == 2
+
+        dev = remote.cpu(0)
+        x_np = np.random.uniform(size=(1024, 64)).astype("float32")
+        x = tvm.runtime.empty(x_np.shape, "float32", dev)
+        y = tvm.runtime.empty(x_np.shape, "float32")
+        upload = remote.copyfrom_async(x, x_np)
+        download = remote.copyto_async(x, y)
+        upload.wait()
+        download.wait()
+        np.testing.assert_equal(y.numpy(), x_np)
+
+    check_remote()
+
+
+@tvm.testing.requires_rpc
+@pytest.mark.skipif(
+    tvm.get_global_func("rpc.codec.zstd.compress", allow_missing=True) is None,
+    reason="Need USE_ZSTD",
+)
+def test_rpc_compressed_copy():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    remote.enable_compression("zstd", threshold=1024)
+
+    dev = remote.cpu(0)
+    x_np = np.zeros((512, 64), dtype="float32")
+    x_np[::7] = np.random.uniform(size=(64,))
+    x = tvm.runtime.tensor(x_np, dev)
+    np.testing.assert_equal(x.numpy(), x_np)
+    # small copies are sent as is
+    small_np = np.arange(16, dtype="float32")
+    np.testing.assert_equal(tvm.runtime.tensor(small_np, dev).numpy(), small_np)
+    y = tvm.runtime.empty(x_np.shape, "float32")
+    remote.copyto_async(x, y).wait()
+    np.testing.assert_equal(y.numpy(), x_np)
+
+    with pytest.raises(ValueError):
+        remote.enable_compression("unknown-codec")
+    remote.enable_compression(None)
+    np.testing.assert_equal(tvm.runtime.tensor(x_np, dev).numpy(), x_np)
+
+
+@tvm.testing.requires_rpc
+def test_rpc_windowed_copy():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    remote.enable_windowed_copy(window=4, block_size=1000, verify_crc=True)
+
+    dev = remote.cpu(0)
+    x_np = np.random.randint(0, 255, size=(64 << 10) + 7).astype("uint8")
+    x = tvm.runtime.tensor(x_np, dev)
+    np.testing.assert_equal(x.numpy(), x_np)
+    y_np = np.zeros((0,), "float32")
+    np.testing.assert_equal(tvm.runtime.tensor(y_np, dev).numpy(), y_np)
+
+    with pytest.raises(ValueError):
+        remote.enable_windowed_copy(window=0)
+    remote.enable_windowed_copy(window=1)
+    np.testing.assert_equal(tvm.runtime.tensor(x_np, dev).numpy(), x_np)
+
+
 @tvm.testing.skip_if_32bit(reason="skipping test for i386.")
 @tvm.testing.requires_rpc
 def test_rpc_echo():
@@ -57,6 +57,30 @@ def test_fail_use_out_loop_var():
     assert not tvm.tir.analysis.verify_well_formed(element_wise, assert_mode=False)
 
 
+def test_incremental_only_verifies_changed_functions():
+    @T.prim_func(check_well_formed=False)
+    def bad(A: T.Buffer((128, 128), "float32"), B: T.Buffer((128, 128), "float32")):
+        for i, j in T.grid(128, 128):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[i, vj] * 2.0
+
+    @T.prim_func
+    def good(A: T.Buffer((128, 128), "float32"), B: T.Buffer((128, 128), "float32")):
+        for i, j in T.grid(128, 128):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] * 2.0
+
+    gvar = tvm.ir.GlobalVar("main")
+    good_mod = tvm.IRModule({gvar: good})
+    bad_mod = tvm.IRModule({gvar: bad})
+    verify = tvm.tir.analysis.verify_well_formed
+    assert not verify(bad_mod, assert_mode=False, prev_mod=good_mod)
+    assert verify(good_mod, assert_mode=False, prev_mod=bad_mod)
+    assert verify(bad_mod, assert_mode=False, prev_mod=bad_mod)
+
+
 def test_error_for_out_of_scope_usage():
     """A variable may not be used after its scope ends"""
 
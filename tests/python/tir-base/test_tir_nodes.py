@@ -530,5 +530,46 @@ def test_scalable_vec_cast():
     assert isinstance(store.value.value, tvm.tir.expr.FloatImm)
 
 
+def test_pooled_node_allocation():
+    from tvm.script import tir as T
+
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "int32")):
+        for i in range(16):
+            A[i] = A[i] + (i * 4 + 8) // 4 - i - 2
+
+    get_stats = tvm.get_global_func("support.GetPooledObjectAllocatorStats")
+    mod = tvm.IRModule({"main": func})
+    expected = tvm.tir.transform.Simplify()(mod)
+
+    before = get_stats()
+    with tvm.transform.PassContext(config={"tir.pooled_node_allocation": True}):
+        after_pooled = tvm.tir.transform.Simplify()(mod)
+    stats = get_stats()
+    tvm.ir.assert_structural_equal(after_pooled, expected)
+    assert stats["num_fresh"] + stats["num_reused"] > before["num_fresh"] + before["num_reused"]
+
+    # The nodes created in the pass stay valid out of the pass scope.
+    del mod, func
+    tvm.ir.assert_structural_equal(tvm.tir.transform.Simplify()(after_pooled), expected)
+
+
+
+def test_parallel_prim_func_passes():
+    from tvm.script import tir as T
+
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "int32"), n: T.int32):
+        for i in range(16):
+            A[i] = A[i] + (i * n + 8) // 4 - i * 0 - 2
+
+    mod = tvm.IRModule({f"func_{i}": func.with_attr("value", i) for i in range(8)})
+    seq = tvm.transform.Sequential([tvm.tir.transform.Simplify(), tvm.tir.transform.RemoveNoOp()])
+    expected = seq(mod)
+    with tvm.transform.PassContext(config={"tir.parallel_prim_func_passes": 4}):
+        after = seq(mod)
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -241,6 +241,14 @@ def test_op_ptx_cp_async_bulk():
     assert expr.op.name == "tir.ptx_cp_async_bulk"
 
 
+def test_op_ptx_cp_async_bulk_tensor():
+    buffer_shared = tir.decl_buffer([16, 16], "float16", scope="shared")
+    tensormap = tir.Var("tensormap", "handle")
+    expr = tir.ptx_cp_async_bulk_tensor("float16", buffer_shared.data, 0, tensormap, 0, 16, 32)
+    assert expr.op.name == "tir.ptx_cp_async_bulk_tensor"
+    assert len(expr.args) == 6
+
+
 def test_op_ptx_commit_group():
     expr = tir.ptx_commit_group()
     assert expr.op.name == "tir.ptx_commit_group"
@@ -281,6 +289,26 @@ def test_op_create_barriers():
     assert expr.op.name == "tir.create_barriers"
 
 
+def test_op_ptx_wgmma_mma_async():
+    buffer_a = tir.decl_buffer([64, 16], "float16", scope="shared")
+    buffer_b = tir.decl_buffer([64, 16], "float16", scope="shared")
+    buffer_c = tir.decl_buffer([32], "float32", scope="local")
+    desc_a = tir.ptx_wgmma_encode_smem_desc(buffer_a.data, 0, 128, 256, 1)
+    desc_b = tir.ptx_wgmma_encode_smem_desc(buffer_b.data, 0, 128, 256, 1)
+    assert desc_a.op.name == "tir.ptx_wgmma_encode_smem_desc"
+    assert desc_a.dtype == "uint64"
+    expr = tir.ptx_wgmma_mma_async(
+        "float32", "m64n64k16", "fp16", "fp16", "fp32", desc_a, desc_b, buffer_c.data, 0
+    )
+    assert expr.op.name == "tir.ptx_wgmma_mma_async"
+
+
+def test_op_ptx_wgmma_fence_commit_wait():
+    assert tir.ptx_wgmma_fence().op.name == "tir.ptx_wgmma_fence"
+    assert tir.ptx_wgmma_commit_group().op.name == "tir.ptx_wgmma_commit_group"
+    assert tir.ptx_wgmma_wait_group(0).op.name == "tir.ptx_wgmma_wait_group"
+
+
 def test_tir_op_vectorlow():
     buffer = tir.decl_buffer((4, 4), "int8", offset_factor=1)
     vec = buffer.vload([0, 0], dtype="int8x16")
@@ -46,5 +46,35 @@ def test_ir_transform():
     assert stmt_list[1].value.value == 42
 
 
+def test_mutator_copy_stats():
+    a = te.var("a")
+    b = te.var("b")
+    stmt = tvm.tir.Evaluate((a + b) * 2 + (a - b))
+
+    def rebuild_add(op):
+        # A fresh but structurally equal node, so that its parents are rebuilt needlessly.
+        return tvm.tir.Add(op.a, op.b)
+
+    get_stats = tvm.get_global_func("tir.GetMutatorCopyStats")
+    set_check = tvm.get_global_func("tir.SetMutatorNeedlessCopyCheck")
+    before = get_stats()
+    prev = set_check(True)
+    try:
+        result = tvm.tir.stmt_functor.ir_transform(stmt, None, rebuild_add, ["tir.Add"])
+    finally:
+        set_check(prev)
+    after = get_stats()
+    tvm.ir.assert_structural_equal(result, stmt)
+    # The Mul, the outer Add and the Evaluate are rebuilt, all needlessly.
+    assert after["num_copies"] - before["num_copies"] == 3
+    assert after["num_needless_copies"] - before["num_needless_copies"] == 3
+
+    # An unchanged tree is returned as is, without any copy.
+    before = get_stats()
+    assert tvm.tir.stmt_functor.ir_transform(stmt, None, lambda op: op, ["tir.Add"]).same_as(stmt)
+    assert get_stats()["num_copies"] == before["num_copies"]
+
+
 if __name__ == "__main__":
     test_ir_transform()
+    test_mutator_copy_stats()
@@ -462,5 +462,118 @@ def test_all_nan_values_are_equivalent():
     assert tvm.ir.structural_hash(float_1) == tvm.ir.structural_hash(float_2)
 
 
+def test_structural_hash_cache():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "float32")):
+        for i in range(16):
+            A[i] = A[i] * T.float32(2)
+
+    mod = tvm.IRModule({"main": func})
+    cached_hash = tvm.get_global_func("node.CachedStructuralHash")
+    expected = tvm.ir.structural_hash(mod)
+
+    tvm.ir.set_structural_hash_cache_capacity(1)
+    try:
+        assert cached_hash(mod, False) == expected
+        assert cached_hash(mod, False) == expected
+        assert cached_hash(mod, True) == tvm.ir.structural_hash(mod, True)
+        # Hashing with map_free_vars evicted the first entry.
+        assert cached_hash(mod, False) == expected
+        stats = tvm.ir.structural_hash_cache_stats()
+        assert stats == {"hits": 1, "misses": 3}
+    finally:
+        tvm.ir.set_structural_hash_cache_capacity(0)
+        tvm.get_global_func("node.StructuralHashCacheClear")()
+
+
+def test_structural_may_equal():
+    def make_func(n):
+        @T.prim_func(private=True)
+        def func(A: T.Buffer((n,), "float32")):
+            for i in range(n):
+                A[i] = A[i] * T.float32(2)
+
+        return func
+
+    may_equal = tvm.get_global_func("node.StructuralMayEqual")
+    mod_16 = tvm.IRModule({"main": make_func(16)})
+    assert may_equal(mod_16, tvm.IRModule({"main": make_func(16)}), 4)
+    assert not may_equal(mod_16, tvm.IRModule({"other": make_func(16)}), 4)
+    assert not may_equal([1, 2], [1, 2, 3], 4)
+    assert not may_equal(["a", mod_16], ["b", mod_16], 4)
+    # Without the cache, the bodies are left to the full comparison.
+    mod_32 = tvm.IRModule({"main": make_func(32)})
+    assert may_equal(mod_16, mod_32, 4)
+
+    tvm.ir.set_structural_hash_cache_capacity(16)
+    try:
+        assert not may_equal(mod_16, mod_32, 4)
+        assert may_equal(mod_16, tvm.IRModule({"main": make_func(16)}), 4)
+        # The functions are not reached within a depth of one.
+        assert may_equal(mod_16, mod_32, 1)
+    finally:
+        tvm.ir.set_structural_hash_cache_capacity(0)
+        tvm.get_global_func("node.StructuralHashCacheClear")()
+
+
+def test_structural_may_equal_module_mutated_in_place():
+    def make_func(n):
+        @T.prim_func(private=True)
+        def func(A: T.Buffer((n,), "float32")):
+            for i in range(n):
+                A[i] = A[i] * T.float32(2)
+
+        return func
+
+    may_equal = tvm.get_global_func("node.StructuralMayEqual")
+    cached_hash = tvm.get_global_func("node.CachedStructuralHash")
+    mod = tvm.IRModule({"main": make_func(16)})
+    mod_32 = tvm.IRModule({"main": make_func(32)})
+
+    tvm.ir.set_structural_hash_cache_capacity(16)
+    try:
+        assert not may_equal(mod, mod_32, 4)
+        cached_hash(mod, False)
+        # The cached hash values of the replaced function must not reject the updated module.
+        mod["main"] = make_func(32)
+        assert may_equal(mod, mod_32, 4)
+        assert cached_hash(mod, False) == cached_hash(mod_32, False)
+        assert tvm.ir.structural_equal(mod, mod_32)
+    finally:
+        tvm.ir.set_structural_hash_cache_capacity(0)
+        tvm.get_global_func("node.StructuralHashCacheClear")()
+
+
+def test_structural_hash_cache_module_mutated_in_place():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "float32")):
+        for i in range(16):
+            A[i] = A[i] * T.float32(2)
+
+    @T.prim_func(private=True)
+    def other(A: T.Buffer((16,), "float32")):
+        for i in range(16):
+            A[i] = A[i] + T.float32(1)
+
+    mod = tvm.IRModule({"main": func})
+    cached_hash = tvm.get_global_func("node.CachedStructuralHash")
+
+    tvm.ir.set_structural_hash_cache_capacity(4)
+    try:
+        assert cached_hash(mod, False) == tvm.ir.structural_hash(mod)
+        mod["main"] = other
+        assert cached_hash(mod, False) == tvm.ir.structural_hash(mod)
+        mod["other"] = func
+        assert cached_hash(mod, False) == tvm.ir.structural_hash(mod)
+        del mod["other"]
+        assert cached_hash(mod, False) == tvm.ir.structural_hash(mod)
+        assert cached_hash(mod, False) == tvm.ir.structural_hash(mod)
+        stats = tvm.ir.structural_hash_cache_stats()
+        assert stats == {"hits": 1, "misses": 4}
+    finally:
+        tvm.ir.set_structural_hash_cache_capacity(0)
+        tvm.get_global_func("node.StructuralHashCacheClear")()
+
+
 if __name__ == "__main__":
     tvm.testing.main()
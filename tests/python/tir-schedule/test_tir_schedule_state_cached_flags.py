@@ -895,5 +895,25 @@ def test_splitted_square_sum_with_predicate():
     # pylint: enable=protected-access
 
 
+def test_flags_recalculated_on_query():
+    sch = tir.Schedule(elementwise, debug_mask=0)
+    _, j = sch.get_loops(sch.get_block("C"))
+    sch.blockize(j)
+    sch.compute_at(sch.get_block("B"), sch.get_loops(sch.get_block("C"))[0])
+    fresh = tir.ScheduleState(sch.mod, debug_mask="all")
+    blocks = []
+    post_order_visit(
+        sch.mod["main"].body,
+        lambda node: blocks.append(node.name_hint) if isinstance(node, tir.Block) else None,
+    )
+    assert len(blocks) == 4
+    # pylint: disable=protected-access
+    for block in blocks:
+        assert sch.state._get_cached_flags(_get_block(sch.state, block)) == (
+            fresh._get_cached_flags(_get_block(fresh, block))
+        )
+    # pylint: enable=protected-access
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -32,9 +32,15 @@ from tvm.tir.tensor_intrin.arm_cpu import (
     DP4A_S8U8S32_INTRIN,
     ARM_DOT_4x4_i8_NEON_INTRIN,
     ARM_DOT_4x4_i8_SDOT_INTRIN,
+    ARM_MMLA_2x2x8_i8_SMMLA_INTRIN,
 )
 from tvm.tir.tensor_intrin.rocm import AMDGPU_SDOT4_INTRIN
-from tvm.tir.tensor_intrin.x86 import VNNI_DOT_16x4_INTRIN, AVX512_DOT_16x4_INTRIN
+from tvm.tir.tensor_intrin.x86 import (
+    AMX_DOT_16x16x64_U8I8I32_INTRIN,
+    AVX512_DOT_16x4_INTRIN,
+    AVX_VNNI_DOT_8x4_INTRIN,
+    VNNI_DOT_16x4_INTRIN,
+)
 from tvm.tir.tensor_intrin.hexagon import VRMPY_u8u8i32_INTRIN, VDMPY_i16i16i32_INTRIN
 
 # fmt: off
@@ -629,6 +635,47 @@ def test_tensorize_avx512():
     tensorize_16x4_test(AVX512_DOT_16x4_INTRIN)
 
 
+def test_tensorize_avx_vnni():
+    m, n, k = 128, 128, 128
+
+    func = get_matmul_packed(m, n, k, "uint8")
+
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    sch.transform_layout(block, "W", lambda i, j: [i // 8, j // 4, i % 8, j % 4])
+    _, j, k = sch.get_loops(block)
+
+    _, ji = sch.split(j, factors=[None, 8])
+    ko, ki = sch.split(k, factors=[None, 4])
+    sch.reorder(ko, ji, ki)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ji, AVX_VNNI_DOT_8x4_INTRIN)
+
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
+def test_tensorize_amx():
+    m, n, k = 128, 128, 128
+
+    func = get_matmul_packed(m, n, k, "uint8")
+
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    sch.transform_layout(block, "W", lambda i, j: [i // 16, j // 64, j % 64 // 4, i % 16, j % 4])
+    i, j, k = sch.get_loops(block)
+
+    io, ii = sch.split(i, factors=[None, 16])
+    jo, ji = sch.split(j, factors=[None, 16])
+    ko, ki = sch.split(k, factors=[None, 64])
+    sch.reorder(io, jo, ko, ii, ji, ki)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, AMX_DOT_16x16x64_U8I8I32_INTRIN)
+
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
 def test_tensorize_arm_dot():
     m, n, k = 128, 128, 128
 
@@ -650,6 +697,27 @@ def test_tensorize_arm_dot():
         verify_trace_roundtrip(sch=sch, mod=func)
 
 
+def test_tensorize_arm_mmla():
+    m, n, k = 128, 128, 128
+
+    func = get_matmul_packed(m, n, k, "int8")
+
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    sch.transform_layout(block, "W", lambda i, j: [i // 2, j // 8, i % 2, j % 8])
+    i, j, k = sch.get_loops(block)
+
+    io, ii = sch.split(i, factors=[None, 2])
+    jo, ji = sch.split(j, factors=[None, 2])
+    ko, ki = sch.split(k, factors=[None, 8])
+    sch.reorder(io, jo, ko, ii, ji, ki)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, ARM_MMLA_2x2x8_i8_SMMLA_INTRIN)
+
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
 def test_tensorize_vrmpy():
     m, n, k = 128, 128, 128
 
@@ -391,5 +391,33 @@ def test_apply_annotation_from_json():
     _test_apply_annotation_trace_from_json('"')
 
 
+def test_trace_replay_cache_resumes_from_prefix():
+    mod = tvm.IRModule({"main": elementwise})
+    sch = tir.Schedule(mod, seed=42)
+    i, j = sch.get_loops(sch.get_block("B"))
+    sch.split(i, factors=sch.sample_perfect_tile(i, n=2))
+    sch.split(j, factors=sch.sample_perfect_tile(j, n=2))
+    trace = sch.trace
+    last_sample = [inst for inst in trace.insts if inst.kind.name == "SamplePerfectTile"][-1]
+    # The factors of 128 differ, so swapping them changes the decision.
+    decision = [int(factor) for factor in trace.decisions[last_sample]]
+    mutated = trace.with_decision(last_sample, decision[::-1], remove_postproc=True)
+
+    def full_replay(trace):
+        sch = tir.Schedule(mod, seed=42)
+        trace.apply_to_schedule(sch, remove_postproc=True)
+        return sch.mod
+
+    replay = tvm.get_global_func("tir.schedule.TraceReplayCacheReplay")
+    mods, num_resumed = replay(mod, [trace, trace, mutated], True, 42)
+    # The second replay resumes from the prefix cached by the first one, and so does the one of
+    # the mutant, whose last decision differs.
+    assert num_resumed == 2
+    tvm.ir.assert_structural_equal(mods[0], full_replay(trace))
+    tvm.ir.assert_structural_equal(mods[1], full_replay(trace))
+    tvm.ir.assert_structural_equal(mods[2], full_replay(mutated))
+    assert not tvm.ir.structural_equal(mods[2], mods[0])
+
+
 if __name__ == "__main__":
     tvm.testing.main()
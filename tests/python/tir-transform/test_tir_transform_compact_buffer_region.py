@@ -28,9 +28,18 @@ class BaseCompactTest:
        (LowerOpaqueBlock . CompactBufferAllocation)(before) ==
        (CompactBufferAllocation . LowerOpaqueBlock)(before)
     - `is_strict` tag, defaults to True, controls the `is_strict` option of the compaction pass.
+    - `polyhedral_bound` tag, defaults to False, controls the
+      `tir.CompactBufferAllocation.polyhedral_bound` config of the compaction pass.
     """
 
     def test_compact(self):
+        polyhedral_bound = getattr(self, "polyhedral_bound", False)
+        with tvm.transform.PassContext(
+            config={"tir.CompactBufferAllocation.polyhedral_bound": polyhedral_bound}
+        ):
+            self._check_compact()
+
+    def _check_compact(self):
         is_lower_order_free = getattr(self, "is_lower_order_free", True)
         is_strict = getattr(self, "is_strict_mode", True)
 
@@ -743,6 +752,32 @@ class TestNarrowShape(BaseCompactTest):
             A[i] = B_cache[i] + T.float32(1)
 
 
+class TestPolyhedralBoundCausalMask(BaseCompactTest):
+    """Under the mask j <= i, i - j is in [0, 32), while the intervals give (-32, 32)."""
+
+    polyhedral_bound = True
+
+    @T.prim_func
+    def before(A: T.Buffer((32, 32), "float32"), C: T.Buffer((32, 32), "float32")) -> None:
+        B = T.alloc_buffer((64,), "float32")
+        for i, j in T.grid(32, 32):
+            if j <= i:
+                B[i - j] = A[i, j]
+        for i, j in T.grid(32, 32):
+            if j <= i:
+                C[i, j] = B[i - j]
+
+    @T.prim_func
+    def expected(A: T.Buffer((32, 32), "float32"), C: T.Buffer((32, 32), "float32")) -> None:
+        B = T.alloc_buffer((32,), "float32")
+        for i, j in T.grid(32, 32):
+            if j <= i:
+                B[i - j] = A[i, j]
+        for i, j in T.grid(32, 32):
+            if j <= i:
+                C[i, j] = B[i - j]
+
+
 class TestLetBinding(BaseCompactTest):
     @T.prim_func
     def before():
@@ -1811,5 +1811,56 @@ def test_less_loop_than_num_stage_dynamic():
     _check(before, after)
 
 
+def test_warp_specialized_pipeline():
+    @T.prim_func
+    def before(A: T.Buffer((16, 16), "float32"), C: T.Buffer((16, 16), "float32")):
+        for tx in T.thread_binding(0, 16, thread="threadIdx.x"):
+            for i in T.serial(
+                0,
+                16,
+                annotations={
+                    "software_pipeline_stage": [0, 1],
+                    "software_pipeline_order": [0, 1],
+                    "software_pipeline_warp_specialize": 32,
+                },
+            ):
+                with T.block("compute"):
+                    T.reads(A[tx, i])
+                    T.writes(C[tx, i])
+                    B = T.alloc_buffer((16, 1), dtype="float32", scope="shared")
+                    with T.block():
+                        T.reads(A[tx, i])
+                        T.writes(B[tx, 0])
+                        B[tx, 0] = A[tx, i] * T.float32(2)
+                    with T.block():
+                        T.reads(B[tx, 0])
+                        T.writes(C[tx, i])
+                        C[tx, i] = B[tx, 0] + T.float32(1)
+
+    mod = tvm.IRModule.from_expr(before.with_attr("global_symbol", "main"))
+    mod = tvm.tir.transform.InjectSoftwarePipeline()(mod)
+    thread_extents = []
+    barrier_ops = set()
+    num_scopes = [0]
+
+    def visit(node):
+        if isinstance(node, tir.For) and node.thread_binding is not None:
+            thread_extents.append(node.extent)
+        elif isinstance(node, tir.Call) and node.op.name.startswith("tir.ptx_"):
+            barrier_ops.add(node.op.name)
+        elif isinstance(node, tir.AttrStmt) and node.attr_key == "warp_specialization_scope":
+            num_scopes[0] += 1
+
+    tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    # The 32 producer threads are appended to the 16 consumer threads.
+    assert [int(extent) for extent in thread_extents] == [48]
+    assert num_scopes[0] == 1
+    assert {
+        "tir.ptx_init_barrier_thread_count",
+        "tir.ptx_arrive_barrier",
+        "tir.ptx_wait_barrier",
+    } <= barrier_ops
+
+
 if __name__ == "__main__":
     tvm.testing.main()
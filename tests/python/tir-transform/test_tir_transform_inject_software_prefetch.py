@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def test_prefetch_next_rows():
+    @T.prim_func
+    def before(A: T.Buffer((64, 64), "float32"), B: T.Buffer((64, 64), "float32")):
+        for i in T.serial(64, annotations={"software_prefetch_distance": 2}):
+            for j in range(64):
+                B[i, j] = A[i, j] * T.float32(2)
+
+    @T.prim_func
+    def expected(A: T.Buffer((64, 64), "float32"), B: T.Buffer((64, 64), "float32")):
+        for i_prefetch in range(2):
+            for line in range(4):
+                T.call_intrin(
+                    "void", "tir.prefetch", T.address_of(A[i_prefetch, line * 16]), 0, 3, 1
+                )
+            T.call_intrin("void", "tir.prefetch", T.address_of(A[i_prefetch, 63]), 0, 3, 1)
+        for i in range(64):
+            if i + 2 < 64:
+                for line in range(4):
+                    T.call_intrin(
+                        "void", "tir.prefetch", T.address_of(A[i + 2, line * 16]), 0, 3, 1
+                    )
+                T.call_intrin("void", "tir.prefetch", T.address_of(A[i + 2, 63]), 0, 3, 1)
+            for j in range(64):
+                B[i, j] = A[i, j] * T.float32(2)
+
+    after = tvm.tir.transform.InjectSoftwarePrefetch()(tvm.IRModule.from_expr(before))
+    tvm.ir.assert_structural_equal(after["main"], expected.with_attr("global_symbol", "main"))
+
+
+def test_skip_parallel_loop():
+    @T.prim_func
+    def before(A: T.Buffer((64, 64), "float32"), B: T.Buffer((64, 64), "float32")):
+        for i in T.parallel(64, annotations={"software_prefetch_distance": 2}):
+            for j in range(64):
+                B[i, j] = A[i, j] * T.float32(2)
+
+    @T.prim_func
+    def expected(A: T.Buffer((64, 64), "float32"), B: T.Buffer((64, 64), "float32")):
+        for i in T.parallel(64):
+            for j in range(64):
+                B[i, j] = A[i, j] * T.float32(2)
+
+    after = tvm.tir.transform.InjectSoftwarePrefetch()(tvm.IRModule.from_expr(before))
+    tvm.ir.assert_structural_equal(after["main"], expected.with_attr("global_symbol", "main"))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,110 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import tir
+from tvm.script import tir as T
+
+
+def _count(func, node_type):
+    nodes = []
+    tir.stmt_functor.post_order_visit(
+        func.body, lambda node: nodes.append(node) if isinstance(node, node_type) else None
+    )
+    return len(nodes)
+
+
+def _instrument(func):
+    mod = tvm.IRModule({"main": func})
+    return tir.transform.InstrumentBoundCheckers()(mod)["main"]
+
+
+def test_in_bounds_loop_is_not_checked():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+        with T.attr(A.data, "buffer_bound", T.tvm_tuple(16)):
+            with T.attr(B.data, "buffer_bound", T.tvm_tuple(16)):
+                for i in range(16):
+                    B[i] = A[i] * T.float32(2)
+
+    after = _instrument(func)
+    assert _count(after, tir.AssertStmt) == 0
+    assert _count(after, tir.IfThenElse) == 0
+
+
+def test_check_is_hoisted_before_the_loop():
+    @T.prim_func(private=True)
+    def func(n: T.int32, A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+        with T.attr(A.data, "buffer_bound", T.tvm_tuple(16)):
+            with T.attr(B.data, "buffer_bound", T.tvm_tuple(16)):
+                for i, j in T.grid(n, 4):
+                    B[i * 4 + j] = A[i * 4 + j] * T.float32(2)
+
+    after = _instrument(func)
+    # one range check before the loop nest, none in the innermost loop
+    assert isinstance(after.body.body.body, tir.AssertStmt)
+    assert isinstance(after.body.body.body.body, tir.For)
+    assert _count(after, tir.AssertStmt) == 1
+    assert _count(after, tir.IfThenElse) == 0
+
+
+def test_conditional_access_is_checked_in_place():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+        with T.attr(A.data, "buffer_bound", T.tvm_tuple(16)):
+            with T.attr(B.data, "buffer_bound", T.tvm_tuple(16)):
+                for i in range(17):
+                    if i < 16:
+                        B[i] = A[i]
+
+    after = _instrument(func)
+    # the guarded store is checked as before, as its loop also runs out of bounds
+    assert _count(after, tir.AssertStmt) == 1
+    assert _count(after, tir.IfThenElse) == 2
+
+
+def test_correlated_index_is_simplified_before_hoisting():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((16,), "float32"), B: T.Buffer((4,), "float32")):
+        with T.attr(A.data, "buffer_bound", T.tvm_tuple(16)):
+            with T.attr(B.data, "buffer_bound", T.tvm_tuple(4)):
+                for i in range(16):
+                    B[i - i // 4 * 4] = A[15 - i + i]
+
+    after = _instrument(func)
+    # the interval of the unsimplified indices would exceed the bounds and fail every call
+    assert _count(after, tir.AssertStmt) == 0
+    assert _count(after, tir.IfThenElse) == 0
+
+
+def test_inexact_index_range_is_checked_in_place():
+    @T.prim_func(private=True)
+    def func(A: T.Buffer((200,), "float32"), B: T.Buffer((16,), "float32")):
+        with T.attr(A.data, "buffer_bound", T.tvm_tuple(200)):
+            with T.attr(B.data, "buffer_bound", T.tvm_tuple(16)):
+                for i in range(16):
+                    B[i] = A[i * i]
+
+    after = _instrument(func)
+    # the interval of the non-affine index is only an over-approximation, so its check stays
+    # in the loop body
+    assert isinstance(after.body.body.body, tir.For)
+    assert _count(after.body.body.body.body, tir.AssertStmt) == 1
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -820,5 +820,79 @@ def test_ignore_loop_partition_hint():
     tvm.ir.assert_structural_equal(after["main"], expected)
 
 
+def _vectorized_loops(func):
+    loops = []
+
+    def fvisit(stmt):
+        if isinstance(stmt, tvm.tir.For) and stmt.kind == tvm.tir.ForKind.VECTORIZED:
+            loops.append(stmt)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return loops
+
+
+def test_partition_vectorized_tail():
+    @T.prim_func
+    def before(A: T.Buffer(14, "float32"), B: T.Buffer(14, "float32")):
+        for i_0 in range(2):
+            for i_1 in T.vectorized(8):
+                if i_0 * 8 + i_1 < 14:
+                    B[i_0 * 8 + i_1] = A[i_0 * 8 + i_1]
+
+    @T.prim_func
+    def expected(A: T.Buffer(14, "float32"), B: T.Buffer(14, "float32")):
+        for i_1 in T.vectorized(8):
+            B[i_1] = A[i_1]
+        for i_1 in T.vectorized(8):
+            if i_1 < 6:
+                B[i_1 + 8] = A[i_1 + 8]
+
+    after = partition_from_scheduled_tir(
+        before, {"tir.LoopPartition": {"partition_vectorized_tail": True}}
+    )
+    tvm.ir.assert_structural_equal(after["main"], expected.with_attr("global_symbol", "main"))
+
+    # the loop is left as is without the option
+    after = partition_from_scheduled_tir(before, {})
+    assert len(_vectorized_loops(after["main"])) == 1
+
+
+def _vectorized_tail_func():
+    @T.prim_func
+    def func(a: T.handle, b: T.handle):
+        n = T.int32()
+        A = T.match_buffer(a, n, "float32")
+        B = T.match_buffer(b, n, "float32")
+        for i_0 in range((n + 7) // 8):
+            for i_1 in T.vectorized(8):
+                if i_0 * 8 + i_1 < n:
+                    B[i_0 * 8 + i_1] = A[i_0 * 8 + i_1] + T.float32(1)
+
+    return func
+
+
+def test_partition_vectorized_tail_dynamic():
+    after = partition_from_scheduled_tir(
+        _vectorized_tail_func(), {"tir.LoopPartition": {"partition_vectorized_tail": True}}
+    )
+    vectorized = _vectorized_loops(after["main"])
+    # the main loop has no boundary check, the tail keeps it
+    assert len(vectorized) == 2
+    assert not any(collect_visit(vectorized[0], lambda x: isinstance(x, tvm.tir.IfThenElse)))
+    assert any(collect_visit(vectorized[1], lambda x: isinstance(x, tvm.tir.IfThenElse)))
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("n", [3, 16, 21])
+def test_partition_vectorized_tail_run(n):
+    config = {"tir.LoopPartition": {"partition_vectorized_tail": True}}
+    with tvm.transform.PassContext(config=config):
+        lib = tvm.compile(_vectorized_tail_func(), target="llvm")
+    a = tvm.runtime.tensor(numpy.random.rand(n).astype("float32"))
+    b = tvm.runtime.tensor(numpy.zeros(n, "float32"))
+    lib(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -95,6 +95,132 @@ class TestBasic(BaseCompare):
                 B[i] = reduce[0]
 
 
+class TestReduxSync(BaseCompare):
+    """A full warp sum of int32 is a single redux.sync on sm_80+"""
+
+    @T.prim_func(private=True)
+    def before(A: T.Buffer((128, 32), "int32"), B: T.Buffer(128, "int32")):
+        T.func_attr({"target": T.target({"kind": "cuda", "arch": "sm_80"}, host="llvm")})
+        A_flat = T.Buffer(4096, "int32", data=A.data)
+
+        for i in range(128):
+            threadIdx_x = T.launch_thread("threadIdx.x", 32)
+
+            reduce_data = T.allocate([1], "int32", "local")
+            reduce = T.Buffer(1, "int32", data=reduce_data, scope="local")
+
+            with T.attr(
+                T.comm_reducer(lambda x, y: x + y, [T.int32(0)]),
+                "reduce_scope",
+                T.reinterpret("handle", T.uint64(0)),
+            ):
+                T.tvm_thread_allreduce(
+                    T.uint32(1),
+                    A_flat[0],
+                    T.bool(True),
+                    reduce[0],
+                    threadIdx_x,
+                )
+            if threadIdx_x == 0:
+                B[i] = reduce[0]
+
+    @T.prim_func(private=True)
+    def expected(A: T.Buffer((128, 32), "int32"), B: T.Buffer(128, "int32")):
+        T.func_attr({"target": T.target({"kind": "cuda", "arch": "sm_80"}, host="llvm")})
+        A_flat = T.Buffer(4096, "int32", data=A.data)
+
+        for i in range(128):
+            threadIdx_x = T.launch_thread("threadIdx.x", 32)
+
+            reduce_data = T.allocate([1], "int32", "local")
+            reduce = T.Buffer(1, "int32", data=reduce_data, scope="local")
+
+            with T.attr(
+                T.comm_reducer(lambda x, y: x + y, [T.int32(0)]),
+                "reduce_scope",
+                T.reinterpret("handle", T.uint64(0)),
+            ):
+                mask_data = T.allocate([1], "uint32", "local")
+                mask = T.decl_buffer(1, "uint32", data=mask_data, scope="local")
+
+                reduce[0] = A_flat[0]
+                mask[0] = T.tvm_warp_activemask()
+
+                reduce[0] = T.call_pure_extern("int32", "__reduce_add_sync", mask[0], reduce[0])
+                reduce[0] = T.tvm_warp_shuffle(mask[0], reduce[0], 0, 32, 32)
+            if threadIdx_x == 0:
+                B[i] = reduce[0]
+
+
+class TestNoReduxSyncBeforeSm80(TestReduxSync):
+    """Before sm_80, the int32 sum is still a tree of shuffles"""
+
+    @T.prim_func(private=True)
+    def before(A: T.Buffer((128, 32), "int32"), B: T.Buffer(128, "int32")):
+        T.func_attr({"target": T.target({"kind": "cuda", "arch": "sm_75"}, host="llvm")})
+        A_flat = T.Buffer(4096, "int32", data=A.data)
+
+        for i in range(128):
+            threadIdx_x = T.launch_thread("threadIdx.x", 32)
+
+            reduce_data = T.allocate([1], "int32", "local")
+            reduce = T.Buffer(1, "int32", data=reduce_data, scope="local")
+
+            with T.attr(
+                T.comm_reducer(lambda x, y: x + y, [T.int32(0)]),
+                "reduce_scope",
+                T.reinterpret("handle", T.uint64(0)),
+            ):
+                T.tvm_thread_allreduce(
+                    T.uint32(1),
+                    A_flat[0],
+                    T.bool(True),
+                    reduce[0],
+                    threadIdx_x,
+                )
+            if threadIdx_x == 0:
+                B[i] = reduce[0]
+
+    @T.prim_func(private=True)
+    def expected(A: T.Buffer((128, 32), "int32"), B: T.Buffer(128, "int32")):
+        T.func_attr({"target": T.target({"kind": "cuda", "arch": "sm_75"}, host="llvm")})
+        A_flat = T.Buffer(4096, "int32", data=A.data)
+
+        for i in range(128):
+            threadIdx_x = T.launch_thread("threadIdx.x", 32)
+
+            reduce_data = T.allocate([1], "int32", "local")
+            reduce = T.Buffer(1, "int32", data=reduce_data, scope="local")
+
+            with T.attr(
+                T.comm_reducer(lambda x, y: x + y, [T.int32(0)]),
+                "reduce_scope",
+                T.reinterpret("handle", T.uint64(0)),
+            ):
+                mask_data = T.allocate([1], "uint32", "local")
+                mask = T.decl_buffer(1, "uint32", data=mask_data, scope="local")
+
+                t0_data = T.allocate([1], "int32", "local")
+                t0 = T.decl_buffer(1, "int32", data=t0_data, scope="local")
+
+                reduce[0] = A_flat[0]
+                mask[0] = T.tvm_warp_activemask()
+
+                t0[0] = T.tvm_warp_shuffle_down(mask[0], reduce[0], 16, 32, 32)
+                reduce[0] = reduce[0] + t0[0]
+                t0[0] = T.tvm_warp_shuffle_down(mask[0], reduce[0], 8, 32, 32)
+                reduce[0] = reduce[0] + t0[0]
+                t0[0] = T.tvm_warp_shuffle_down(mask[0], reduce[0], 4, 32, 32)
+                reduce[0] = reduce[0] + t0[0]
+                t0[0] = T.tvm_warp_shuffle_down(mask[0], reduce[0], 2, 32, 32)
+                reduce[0] = reduce[0] + t0[0]
+                t0[0] = T.tvm_warp_shuffle_down(mask[0], reduce[0], 1, 32, 32)
+                reduce[0] = reduce[0] + t0[0]
+                reduce[0] = T.tvm_warp_shuffle(mask[0], reduce[0], 0, 32, 32)
+            if threadIdx_x == 0:
+                B[i] = reduce[0]
+
+
 class TestBasicWithDeclBuffer(BaseCompare):
     @T.prim_func(private=True)
     def before(A: T.Buffer((128, 32), "float32"), B: T.Buffer(128, "float32")):
@@ -279,5 +279,54 @@ class TestLowerCPUAllocWithFunctionAttr(tvm.testing.CompareBeforeAfter):
     expected = before
 
 
+def _static_storage_allocations(func):
+    """Lower the function in the direct-call mode, return the allocations in static storage."""
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(config={"tir.direct_call": True}):
+        mod = tvm.tir.transform.LowerTVMBuiltin()(mod)
+
+    allocations = []
+
+    def visit(node):
+        if isinstance(node, tvm.tir.Allocate) and "static_storage" in node.annotations:
+            allocations.append(node.buffer_var.name)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    return allocations
+
+
+def test_direct_call_static_storage_only_for_c_target():
+    """Only CodeGenC prints the static storage, LLVM keeps the workspace calls."""
+
+    def make_func(target):
+        @T.prim_func
+        def func(A: T.Buffer(1024 * 1024, "float32")):
+            T.func_attr({"target": T.target(target)})
+            ptr = T.allocate([1024 * 1024], "float32")
+            buf = T.decl_buffer(1024 * 1024, "float32", data=ptr)
+            buf[0] = A[0]
+            A[1] = buf[0]
+
+        return func
+
+    assert _static_storage_allocations(make_func("c")) == ["ptr"]
+    assert _static_storage_allocations(make_func("llvm")) == []
+
+
+def test_direct_call_no_static_storage_under_parallel_loop():
+    """The iterations of a parallel loop may not share a static array."""
+
+    @T.prim_func
+    def func(A: T.Buffer((4, 1024 * 1024), "float32")):
+        T.func_attr({"target": T.target("c")})
+        for i in T.parallel(4):
+            ptr = T.allocate([1024 * 1024], "float32")
+            buf = T.decl_buffer(1024 * 1024, "float32", data=ptr)
+            buf[0] = A[i, 0]
+            A[i, 1] = buf[0]
+
+    assert _static_storage_allocations(func) == []
+
+
 if __name__ == "__main__":
     tvm.testing.main()
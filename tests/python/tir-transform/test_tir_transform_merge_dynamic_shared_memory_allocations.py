@@ -240,5 +240,82 @@ class TestAsyncCopy(tvm.testing.CompareBeforeAfter):
         return func
 
 
+def _merge_with_interval_coloring(func, **config):
+    config = {"tir.merge_smem_interval_coloring": True, **config}
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.MergeSharedMemoryAllocations()(tvm.IRModule({"main": func}))
+    return mod["main"]
+
+
+def test_interval_coloring_reuses_freed_space():
+    """B takes the place of A once A is dead, and C is placed next to B.
+
+    The free list hands the whole storage of A to B, so that C needs a new storage.
+    """
+
+    @T.prim_func
+    def before():
+        threadIdx_x = T.launch_thread("threadIdx.x", 64)
+        A_sh_data = T.allocate([128], "float32", "shared.dyn")
+        B_sh_data = T.allocate([64], "float32", "shared.dyn")
+        C_sh_data = T.allocate([64], "float32", "shared.dyn")
+        A_sh = T.decl_buffer([128], data=A_sh_data, scope="shared.dyn")
+        B_sh = T.decl_buffer([64], data=B_sh_data, scope="shared.dyn")
+        C_sh = T.decl_buffer([64], data=C_sh_data, scope="shared.dyn")
+        A_sh[threadIdx_x] = 0
+        B_sh[threadIdx_x] = 0
+        C_sh[threadIdx_x] = 0
+        B_sh[threadIdx_x] = C_sh[threadIdx_x] + B_sh[threadIdx_x]
+
+    @T.prim_func
+    def expected():
+        threadIdx_x = T.launch_thread("threadIdx.x", 64)
+        buf_dyn_shmem = T.allocate([512], "uint8", "shared.dyn")
+        A_sh = T.decl_buffer((128,), data=buf_dyn_shmem, scope="shared.dyn")
+        B_sh = T.decl_buffer((64,), data=buf_dyn_shmem, scope="shared.dyn")
+        C_sh = T.decl_buffer((64,), data=buf_dyn_shmem, scope="shared.dyn")
+        A_sh[threadIdx_x] = 0
+        B_sh[threadIdx_x] = 0
+        C_sh[threadIdx_x + 64] = 0
+        B_sh[threadIdx_x] = C_sh[threadIdx_x + 64] + B_sh[threadIdx_x]
+
+    after = _merge_with_interval_coloring(before)
+    tvm.ir.assert_structural_equal(after, expected)
+
+    # The free list needs 768 bytes.
+    mod = tvm.tir.transform.MergeSharedMemoryAllocations()(tvm.IRModule({"main": before}))
+    assert "768" in mod["main"].script()
+
+
+swizzle_bytes, expected_offset, expected_size = tvm.testing.parameters(
+    (0, 384, 2560),
+    (1024, 512, 3072),
+)
+
+
+def test_interval_coloring_swizzle_alignment(swizzle_bytes, expected_offset, expected_size):
+    """The buffers of at least `swizzle_bytes` start on a multiple of it."""
+
+    @T.prim_func
+    def before():
+        threadIdx_x = T.launch_thread("threadIdx.x", 256)
+        A_sh_data = T.allocate([384], "float32", "shared.dyn")
+        B_sh_data = T.allocate([256], "float32", "shared.dyn")
+        A_sh = T.decl_buffer([384], data=A_sh_data, scope="shared.dyn")
+        B_sh = T.decl_buffer([256], data=B_sh_data, scope="shared.dyn")
+        B_sh[threadIdx_x] = A_sh[threadIdx_x]
+
+    @T.prim_func
+    def expected():
+        threadIdx_x = T.launch_thread("threadIdx.x", 256)
+        buf_dyn_shmem = T.allocate([expected_size], "uint8", "shared.dyn")
+        A_sh = T.decl_buffer((384,), data=buf_dyn_shmem, scope="shared.dyn")
+        B_sh = T.decl_buffer((256,), data=buf_dyn_shmem, scope="shared.dyn")
+        B_sh[threadIdx_x + expected_offset] = A_sh[threadIdx_x]
+
+    after = _merge_with_interval_coloring(before, **{"tir.merge_smem_swizzle_bytes": swizzle_bytes})
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
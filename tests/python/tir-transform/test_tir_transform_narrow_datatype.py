@@ -271,5 +271,67 @@ def test_narrow_i64_valued_bufferload_index_to_i32():
     tvm.ir.assert_structural_equal(after, expect.with_attr("global_symbol", "main"))
 
 
+def _loop_var_dtypes(stmt):
+    dtypes = []
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.For):
+            dtypes.append(node.loop_var.dtype)
+        elif isinstance(node, tvm.tir.AttrStmt) and node.attr_key == "thread_extent":
+            dtypes.append(node.node.var.dtype)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, fvisit)
+    return dtypes
+
+
+def _copy_func(attrs):
+    @T.prim_func
+    def func(a: T.handle, b: T.handle):
+        n = T.int64()
+        A = T.match_buffer(a, (n * T.int64(256),), "float32")
+        B = T.match_buffer(b, (n * T.int64(256),), "float32")
+        for bx in T.thread_binding(n, thread="blockIdx.x"):
+            for tx in T.thread_binding(T.int64(256), thread="threadIdx.x"):
+                B[bx * T.int64(256) + tx] = A[bx * T.int64(256) + tx]
+
+    func = func.with_attr("global_symbol", "main")
+    for key, value in attrs.items():
+        func = func.with_attr(key, value)
+    mod = tvm.IRModule.from_expr(func)
+    return tvm.tir.transform.FlattenBuffer()(tvm.tir.transform.LowerOpaqueBlock()(mod))
+
+
+def test_narrow_with_var_upper_bound():
+    mod = _copy_func({"tir_var_upper_bound": {"n": 1024}})
+    after = tvm.tir.transform.NarrowDataType(32)(mod)["main"]
+    assert _loop_var_dtypes(after.body) == ["int32", "int32"]
+
+    # without the bound, n * 256 may not fit into int32
+    after = tvm.tir.transform.NarrowDataType(32)(_copy_func({}))["main"]
+    assert _loop_var_dtypes(after.body) == ["int64", "int64"]
+
+
+def test_narrow_with_int64_fallback_on_gpu():
+    mod = _copy_func({"target": tvm.target.Target("cuda", host="llvm")})
+    after = tvm.tir.transform.NarrowDataType(32)(mod)["main"]
+    # the narrowed kernel runs when the sizes fit, and the original one otherwise
+    assert isinstance(after.body, tvm.tir.IfThenElse)
+    assert _loop_var_dtypes(after.body.then_case) == ["int32", "int32"]
+    assert _loop_var_dtypes(after.body.else_case) == ["int64", "int64"]
+    n = after.buffer_map[after.params[0]].shape[0].a
+
+    def check_fits(value):
+        cond = tvm.tir.stmt_functor.substitute(after.body.condition, {n: T.int64(value)})
+        return tvm.arith.Analyzer().simplify(cond)
+
+    assert check_fits(2**20)
+    assert not check_fits(2**24)
+
+    with tvm.transform.PassContext(config={"tir.narrow_index_with_fallback": False}):
+        after = tvm.tir.transform.NarrowDataType(32)(mod)["main"]
+    assert not isinstance(after.body, tvm.tir.IfThenElse)
+    assert _loop_var_dtypes(after.body) == ["int64", "int64"]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -79,6 +79,7 @@ class BaseBeforeAfter(tvm.testing.CompareBeforeAfter):
     apply_constraints_to_boolean_branches = False
     propagate_knowns_to_prove_conditional = False
     propagate_knowns_to_simplify_expressions = False
+    memoize_analyzer_queries = False
     # from base class
     check_well_formed = False
 
@@ -91,6 +92,7 @@ class BaseBeforeAfter(tvm.testing.CompareBeforeAfter):
                     "apply_constraints_to_boolean_branches": self.apply_constraints_to_boolean_branches,
                     "propagate_knowns_to_prove_conditional": self.propagate_knowns_to_prove_conditional,
                     "propagate_knowns_to_simplify_expressions": self.propagate_knowns_to_simplify_expressions,
+                    "memoize_analyzer_queries": self.memoize_analyzer_queries,
                 }
             }
             with tvm.transform.PassContext(config=config):
@@ -1734,5 +1736,11 @@ class TestNestedIfElimination(BaseBeforeAfter):
             b[i0, j0] = T.if_then_else(i0 == 1 and 6 <= j0, 0, T.max(0, a[i0, j0]))
 
 
+class TestNestedIfEliminationWithMemoizedAnalyzer(TestNestedIfElimination):
+    """Memoized analyzer queries must not reuse results across loop scopes."""
+
+    memoize_analyzer_queries = True
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -389,6 +389,35 @@ def test_reuse_small_buffer():
     assert num_alloc[0] == 1
 
 
+def test_reuse_smaller_buffer_of_other_dtype():
+    @T.prim_func
+    def func(A: T.Buffer((64,), "float32"), B: T.Buffer((256,), "float16")):
+        X_data = T.allocate([64], "float32", "global")
+        X = T.Buffer([64], "float32", data=X_data)
+        for i in range(64):
+            X[i] = A[i] + T.float32(1)
+        for i in range(64):
+            A[i] = X[i]
+        Y_data = T.allocate([256], "float16", "global")
+        Y = T.Buffer([256], "float16", data=Y_data)
+        for i in range(256):
+            Y[i] = B[i] + T.float16(1)
+        for i in range(256):
+            B[i] = Y[i]
+
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    body = tvm.tir.transform.StorageRewrite()(mod)["main"].body
+
+    allocs = []
+    tvm.tir.stmt_functor.post_order_visit(
+        body, lambda n: allocs.append(n) if isinstance(n, tvm.tir.Allocate) else None
+    )
+    # the float16 buffer grows the arena of the float32 one, which keeps its wider type
+    assert len(allocs) == 1
+    assert allocs[0].dtype == "float32"
+    assert allocs[0].extents[0].value == 128
+
+
 def test_access_in_let_value():
     @T.prim_func
     def func(A: T.Buffer((8,), "float32")):
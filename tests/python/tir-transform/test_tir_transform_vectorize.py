@@ -669,6 +669,108 @@ def test_vectorize_and_predicate_invalid_conditions():
     tvm.ir.assert_structural_equal(after, expected)
 
 
+def test_vectorize_and_predicate_offset_and_strided_accesses():
+    @T.prim_func
+    def before(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (32,), "float32")
+        B = T.match_buffer(b, (16,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in T.serial(T.ceildiv(14, 4)):
+            for i_1 in T.vectorized(4):
+                if T.likely(i_0 * 4 + i_1 < 14):
+                    B[i_0 * 4 + i_1] = A[i_0 * 4 + i_1 + 1] + A[(i_0 * 4 + i_1) * 2]
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (32,), "float32")
+        B = T.match_buffer(b, (16,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in range(4):
+            load_a = T.meta_var(
+                A.vload(
+                    [T.Ramp(i_0 * 4 + 1, 1, 4)],
+                    predicate=T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+                )
+            )
+            load_a_strided = T.meta_var(
+                A.vload(
+                    [T.Ramp(i_0 * 4 * 2, 2, 4)],
+                    predicate=T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+                )
+            )
+            B.vstore(
+                [T.Ramp(i_0 * 4, 1, 4)],
+                load_a + load_a_strided,
+                predicate=T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+            )
+
+    mod = tvm.IRModule.from_expr(before)
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        after = tvm.tir.transform.VectorizeLoop()(mod)["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_and_predicate_conjunction():
+    @T.prim_func
+    def before(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (16,), "float32")
+        B = T.match_buffer(b, (16,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in T.serial(T.ceildiv(14, 4)):
+            for i_1 in T.vectorized(4):
+                if i_0 * 4 + i_1 <= 13 and 0 < n:
+                    B[i_0 * 4 + i_1] = A[i_0 * 4 + i_1]
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle, n: T.int32):
+        A = T.match_buffer(a, (16,), "float32")
+        B = T.match_buffer(b, (16,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in range(4):
+            B.vstore(
+                [T.Ramp(i_0 * 4, 1, 4)],
+                A.vload(
+                    [T.Ramp(i_0 * 4, 1, 4)],
+                    predicate=T.And(
+                        T.get_active_lane_mask("uint1x4", i_0 * 4, 14), T.Broadcast(0 < n, 4)
+                    ),
+                ),
+                predicate=T.And(
+                    T.get_active_lane_mask("uint1x4", i_0 * 4, 14), T.Broadcast(0 < n, 4)
+                ),
+            )
+
+    mod = tvm.IRModule.from_expr(before)
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        after = tvm.tir.transform.VectorizeLoop()(mod)["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
+def test_vectorize_and_predicate_strided_condition():
+    # A lane mask cannot express a strided bound, so the block is scalarized.
+    @T.prim_func
+    def before(a: T.handle):
+        A = T.match_buffer(a, (32,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in T.serial(4):
+            for i_1 in T.vectorized(4):
+                if i_0 * 8 + i_1 * 2 < 28:
+                    A[i_0 * 8 + i_1 * 2] = 2.0
+
+    @T.prim_func
+    def expected(a: T.handle):
+        A = T.match_buffer(a, (32,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0, i_1_s in T.grid(4, 4):
+            if i_0 * 8 + i_1_s * 2 < 28:
+                A[i_0 * 8 + i_1_s * 2] = T.float32(2)
+
+    mod = tvm.IRModule.from_expr(before)
+    with tvm.transform.PassContext(config={"tir.enable_buffer_level_predication": True}):
+        after = tvm.tir.transform.VectorizeLoop()(mod)["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 def test_vectorize_with_explicitly_disabled_buffer_level_predication():
     # Since the target has the VLA feature, buffer level predication is enabled
     # by default. However, it has been explicitly disabled by the pass context
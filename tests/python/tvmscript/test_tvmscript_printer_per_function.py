@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-docstring
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.script import ir as I, relax as R, tir as T
+
+
+def _module():
+    @I.ir_module
+    class Module:
+        @T.prim_func(private=True)
+        def add_one(A: T.Buffer((4,), "float32"), B: T.Buffer((4,), "float32")):
+            for i in range(4):
+                with T.block("B"):
+                    vi = T.axis.spatial(4, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+        @R.function(private=True)
+        def layer(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            cls = Module
+            y = R.call_tir(cls.add_one, (x,), out_sinfo=R.Tensor((4,), "float32"))
+            return y
+
+        @R.function
+        def main(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            cls = Module
+            y = cls.layer(x)
+            z = cls.layer(y)
+            return z
+
+    return Module
+
+
+@pytest.mark.parametrize("num_threads", [1, 2])
+def test_same_script_as_whole_module(num_threads):
+    mod = _module()
+    assert mod.script_per_function(num_threads=num_threads) == mod.script()
+    assert mod.script_per_function(num_threads=num_threads, name="MyModule") == mod.script(
+        name="MyModule"
+    )
+
+
+def test_write_to_file(tmp_path):
+    mod = _module()
+    path = str(tmp_path / "mod.py")
+    mod.script_per_function(path)
+    with open(path) as file:
+        assert file.read() == mod.script() + "\n"
+
+
+def test_show_meta_not_supported():
+    with pytest.raises(ValueError):
+        _module().script_per_function(show_meta=True)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -201,7 +201,10 @@ class WebGPUModuleNode final : public ffi::ModuleObj {
       std::ostringstream os;
       dmlc::JSONWriter writer(&os);
       info.Save(&writer);
-      return create_shader_(os.str(), it->second);
+      ffi::Function func = create_shader_(os.str(), it->second);
+      // Keep the shader, so that its pipeline is created once.
+      prebuild_[name] = func;
+      return func;
     } else {
       return std::nullopt;
     }
@@ -47,6 +47,8 @@ export interface ArtifactCacheTemplate {
    * return the actual data object rather than the request. There are two options:
    * 1. "json": returns equivalent to `fetch(url).json()`
    * 2. "arraybuffer": returns equivalent to `fetch(url).arraybuffer()`
+   * 3. "blob": returns equivalent to `fetch(url).blob()`, only supported by `ArtifactCache`, whose
+   *    blobs are backed by the cache, so that slices of them can be read without reading the rest.
    * @param signal: An optional AbortSignal allowing user to abort the fetching before its completion.
    * @return The data object (i.e. users do not need to call `.json()` or `.arraybuffer()`).
    *
@@ -84,15 +86,29 @@ export interface ArtifactCacheTemplate {
 }
 
 
+/**
+ * The key of the bytes of an interrupted fetch of `url` in the cache.
+ */
+function partialKey(url: string): string {
+  return url + (url.indexOf("?") === -1 ? "?" : "&") + "tvmjs-partial";
+}
+
 /**
  * Cache to store model related data, implemented with the Cache API.
+ *
+ * The artifacts are streamed into the cache. When a fetch is interrupted, by an error or by the
+ * `AbortSignal`, the bytes received so far are kept in the cache, and the next fetch of the
+ * artifact resumes from them with an HTTP range request if the server supports it.
  */
 export class ArtifactCache implements ArtifactCacheTemplate {
   private scope: string;
   private cache?: Cache;
+  /** The number of times a failed fetch is resumed before giving up. */
+  private maxRetries: number;
 
-  constructor(scope: string) {
+  constructor(scope: string, maxRetries = 3) {
     this.scope = scope;
+    this.maxRetries = maxRetries;
   }
 
   /**
@@ -105,6 +121,8 @@ export class ArtifactCache implements ArtifactCacheTemplate {
       return await response.json();
     } else if (storetype.toLowerCase() === "arraybuffer") {
       return await response.arrayBuffer();
+    } else if (storetype.toLowerCase() === "blob") {
+      return await response.blob();
     } else {
       console.error("Unknown storage type " + storetype + ", returning raw response");
       return response;
@@ -136,8 +154,78 @@ export class ArtifactCache implements ArtifactCacheTemplate {
     }
     const result = await this.cache.match(request);
     if (result === undefined) {
-      await this.cache.add(request);
+      await this.cache.put(request, await this.fetchResumable(url, signal));
+    }
+  }
+
+  /**
+   * Fetch the url, resuming from the bytes of the earlier interrupted fetches.
+   *
+   * The received bytes are gathered into a blob, which the browser may keep out of the JS heap,
+   * rather than into one array buffer.
+   *
+   * @param url The url to fetch.
+   * @param signal An optional abort signal to abort fetching.
+   * @returns The response with the whole content.
+   */
+  private async fetchResumable(url: string, signal?: AbortSignal): Promise<Response> {
+    const cache = this.cache as Cache;
+    const partial = await cache.match(partialKey(url));
+    let received = partial === undefined ? new Blob([]) : await partial.blob();
+    // The validator of the partial bytes, so that they are only resumed from if unchanged.
+    let validator = partial?.headers.get("x-tvmjs-validator") ?? null;
+    for (let attempt = 0; ; ++attempt) {
+      const headers: Record<string, string> = {};
+      if (received.size > 0 && validator !== null) {
+        headers["Range"] = "bytes=" + received.size + "-";
+        headers["If-Range"] = validator;
+      }
+      let chunks: Array<Uint8Array> = [];
+      let chunksBytes = 0;
+      const flush = () => {
+        received = new Blob([received, ...chunks]);
+        chunks = [];
+        chunksBytes = 0;
+      };
+      try {
+        const response = await fetch(url, { signal, headers });
+        if (!response.ok || response.body === null) {
+          throw Error("Cannot fetch " + url + ", status " + response.status);
+        }
+        if (response.status !== 206) {
+          // The server sends the whole content, as it ignores ranges or the content changed.
+          received = new Blob([]);
+        }
+        validator = response.headers.get("ETag") ?? response.headers.get("Last-Modified");
+        const reader = response.body.getReader();
+        for (;;) {
+          const { done, value } = await reader.read();
+          if (done) {
+            break;
+          }
+          chunks.push(value);
+          chunksBytes += value.byteLength;
+          // Bound the bytes held in the JS heap.
+          if (chunksBytes >= (16 << 20)) {
+            flush();
+          }
+        }
+        flush();
+        break;
+      } catch (err) {
+        flush();
+        if (received.size > 0 && validator !== null) {
+          await cache.put(partialKey(url), new Response(received, {
+            headers: { "x-tvmjs-validator": validator }
+          }));
+        }
+        if (signal?.aborted || attempt >= this.maxRetries) {
+          throw err;
+        }
+      }
     }
+    await cache.delete(partialKey(url));
+    return new Response(received);
   }
 
   /**
@@ -164,6 +252,7 @@ export class ArtifactCache implements ArtifactCacheTemplate {
       this.cache = await caches.open(this.scope);
     }
     await this.cache.delete(url);
+    await this.cache.delete(partialKey(url));
   }
 }
 
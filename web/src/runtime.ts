@@ -1255,6 +1255,7 @@ export class Instance implements Disposable {
    * @param cacheScope The scope identifier of the cache
    * @param cacheType The type of the cache: "cache" or "indexedDB"
    * @param signal An optional AbortSignal to abort the fetch
+   * @param maxConcurrency The maximum number of shards downloaded at the same time
    * @returns The meta data
    */
   async fetchTensorCache(
@@ -1263,6 +1264,7 @@ export class Instance implements Disposable {
     cacheScope = "tvmjs",
     cacheType = "cache",
     signal?: AbortSignal,
+    maxConcurrency = 4,
   ): Promise<any> {
     let artifactCache: ArtifactCacheTemplate;
     if (cacheType === undefined || cacheType.toLowerCase() === "cache") {
@@ -1278,7 +1280,7 @@ export class Instance implements Disposable {
     await this.fetchTensorCacheInternal(
       tensorCacheUrl,
       list["records"] as Array<TensorShardEntry>, device, artifactCache,
-      signal);
+      signal, maxConcurrency);
     this.cacheMetadata = { ...this.cacheMetadata, ...(list["metadata"] as Record<string, any>) };
   }
 
@@ -1291,6 +1293,7 @@ export class Instance implements Disposable {
    * @param device The device to store the data to.
    * @param artifactCache The artifact cache
    * @param signal An optional AbortSignal to abort the fetch
+   * @param maxConcurrency The maximum number of shards downloaded at the same time
    */
   private async fetchTensorCacheInternal(
     tensorCacheUrl: string,
@@ -1298,6 +1301,7 @@ export class Instance implements Disposable {
     device: DLDevice,
     artifactCache: ArtifactCacheTemplate,
     signal?: AbortSignal,
+    maxConcurrency = 4,
   ) {
     const perf = compact.getPerformance();
     const tstart = perf.now();
@@ -1346,10 +1350,12 @@ export class Instance implements Disposable {
     }
 
     // First download all shards to cache parallely if not yet in cache
-    const downloadCache = async (start: number, end: number) => {
-      // Download params [start, end) from `list`
-      for (let i = start; i < end; i++) {
-        const shard = list[i];
+    let nextShard = 0;
+    const downloadCache = async () => {
+      // Each worker takes the next shard once it is done with its last one, so that a slow shard
+      // doesn't hold back the shards behind it.
+      while (nextShard < list.length) {
+        const shard = list[nextShard++];
         const dataUrl = new URL(shard.dataPath, tensorCacheUrl).href;
         try {
           await artifactCache.addToCache(dataUrl, "arraybuffer", signal);
@@ -1362,28 +1368,28 @@ export class Instance implements Disposable {
         reportCallback(++fetchedShards, /*loading=*/false);
       }
     }
-    // We launch 4 parallel for loops to limit the max concurrency to 4 download
+    // We launch maxConcurrency workers to limit the number of concurrent downloads
     if (!cacheOnly) {
-      const loopSize = Math.floor(list.length / 4);
-      await Promise.all([
-        downloadCache(0, loopSize),
-        downloadCache(loopSize, 2 * loopSize),
-        downloadCache(2 * loopSize, 3 * loopSize),
-        downloadCache(3 * loopSize, list.length)
-      ]);
+      const workers = [];
+      for (let w = 0; w < Math.max(1, Math.min(maxConcurrency, list.length)); ++w) {
+        workers.push(downloadCache());
+      }
+      await Promise.all(workers);
     }
 
     // Reset for the loading phase to avoid double counting with download phase
     fetchedBytes = 0;
     fetchedShards = 0;
 
+    // The blobs of the Cache API are read by slices, so that a shard is not held in memory at once.
+    const readBySlices = artifactCache instanceof ArtifactCache;
     // Then iteratively, load the shard from cache
     for (let i = 0; i < list.length; ++i) {
       const shard = list[i];
       const dataUrl = new URL(shard.dataPath, tensorCacheUrl).href;
       let buffer;
       try {
-        buffer = await artifactCache.fetchWithCache(dataUrl, "arraybuffer");
+        buffer = await artifactCache.fetchWithCache(dataUrl, readBySlices ? "blob" : "arraybuffer");
       } catch (err) {
         this.env.logger("Error: Cannot fetch " + dataUrl + " err= " + err);
         throw err;
@@ -1392,12 +1398,27 @@ export class Instance implements Disposable {
       for (let j = 0; j < shardRecords.length; ++j) {
         try {
           const rec = shardRecords[j];
+          const recEnd = rec.byteOffset + rec.nbytes;
+          const recSource = readBySlices
+            ? await (buffer as Blob).slice(rec.byteOffset, recEnd).arrayBuffer()
+            : buffer.slice(rec.byteOffset, recEnd);
+          if (rec.format === "raw" && device.deviceType === DeviceStrToEnum.webgpu) {
+            // the raw bytes need no decoding, so they are written to the gpu array directly.
+            const gpu_arr = this.withNewScope(() => {
+              return this.detachFromCurrentScope(
+                this.empty(rec.shape, rec.dtype, device)
+              )
+            });
+            gpu_arr.copyFromRawBytes(new Uint8Array(recSource));
+            this.tensorCacheUpdate(rec.name, gpu_arr, false);
+            gpu_arr.dispose();
+            continue;
+          }
           const cpu_arr = this.withNewScope(() => {
             return this.detachFromCurrentScope(
               this.empty(rec.shape, rec.dtype, this.cpu())
             )
           });
-          const recSource = buffer.slice(rec.byteOffset, rec.byteOffset + rec.nbytes);
           // first sync copy to cpu.
           this.ctx.arrayDecodeStorage(cpu_arr, new Uint8Array(recSource), rec.format, rec.dtype);
           // then async stream into GPU if needed
@@ -1412,6 +1433,7 @@ export class Instance implements Disposable {
               )
             });
             gpu_arr.copyFrom(cpu_arr);
+            // wait for the copy before the cpu array is freed
             await device.sync();
             this.tensorCacheUpdate(rec.name, gpu_arr, false);
             cpu_arr.dispose();
@@ -1425,6 +1447,10 @@ export class Instance implements Disposable {
           throw err;
         }
       }
+      if (device.deviceType !== DeviceStrToEnum.cpu) {
+        // the direct copies of the shard are only waited for once
+        await device.sync();
+      }
       fetchedBytes += shard.nbytes;
       timeElapsed = Math.ceil((perf.now() - tstart) / 1000);
       reportCallback(++fetchedShards, /*loading=*/true);
@@ -389,10 +389,27 @@ export class WebGPUContext {
   // internal data
   private bufferTable: Array<GPUBuffer | undefined> = [undefined];
   private bufferTableFreeId: Array<number> = [];
-  private podArgStagingBuffers: Array<GPUBuffer> = [];
   private canvasRenderManager?: CanvasRenderManager = undefined;
-  // number of pod arg staging buffers
-  private maxNumPodArgsStagingBuffers = 2;
+  // pipelines keyed by their layout, entry point and code, or the promise of one being created.
+  private pipelineCache: Map<string, GPUComputePipeline | Promise<GPUComputePipeline>> = new Map();
+  // bind group layouts and pipeline layouts keyed by the types of their bindings.
+  private layoutCache: Map<string, [GPUBindGroupLayout, GPUPipelineLayout]> = new Map();
+  // the command encoder of the dispatches not submitted yet
+  private pendingEncoder?: GPUCommandEncoder = undefined;
+  // the compute pass the pending dispatches are encoded into
+  private pendingComputePass?: GPUComputePassEncoder = undefined;
+  // number of commands in the pending encoder
+  private numPendingCommands = 0;
+  // maximum number of commands batched into one submit
+  private maxBatchCommands = 64;
+  // size of the pod args buffer
+  private static readonly podArgsBufferSize = 1 << 16;
+  // uniform buffer holding the pod args of the pending dispatches, one slot each
+  private podArgsBuffer?: GPUBuffer = undefined;
+  // host copy of podArgsBuffer, written to it right before the submit
+  private podArgsHostData = new ArrayBuffer(WebGPUContext.podArgsBufferSize);
+  // bytes of podArgsHostData taken by the pending dispatches
+  private podArgsOffset = 0;
   // flags for debugging
   // stats of the runtime.
   // peak allocation
@@ -422,9 +439,11 @@ export class WebGPUContext {
     while (this.bufferTable.length != 0) {
       this.bufferTable.pop()?.destroy();
     }
-    while (this.podArgStagingBuffers.length != 0) {
-      this.podArgStagingBuffers.pop()?.destroy();
-    }
+    this.pendingComputePass = undefined;
+    this.pendingEncoder = undefined;
+    this.podArgsBuffer?.destroy();
+    this.pipelineCache.clear();
+    this.layoutCache.clear();
     this.device.destroy();
   }
 
@@ -432,9 +451,81 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushCommands();
     await this.device.queue.onSubmittedWorkDone();
   }
 
+  /**
+   * Set the maximum number of commands batched into one submit.
+   *
+   * The dispatches and the copies within the GPU are encoded into one command encoder, which is
+   * submitted once full, at the next copy from or to the host, at sync, or at the end of the
+   * current task, whichever comes first.
+   *
+   * @param maxBatchCommands The maximum number of commands, 1 to submit each command.
+   */
+  setMaxBatchCommands(maxBatchCommands: number): void {
+    assert(maxBatchCommands >= 1);
+    this.flushCommands();
+    this.maxBatchCommands = maxBatchCommands;
+  }
+
+  /**
+   * Submit the pending commands, if any.
+   */
+  flushCommands(): void {
+    if (this.pendingEncoder === undefined) return;
+    this.pendingComputePass?.end();
+    if (this.podArgsOffset != 0) {
+      assert(this.podArgsBuffer !== undefined);
+      this.device.queue.writeBuffer(
+        this.podArgsBuffer, 0, this.podArgsHostData, 0, this.podArgsOffset);
+    }
+    this.device.queue.submit([this.pendingEncoder.finish()]);
+    this.pendingComputePass = undefined;
+    this.pendingEncoder = undefined;
+    this.numPendingCommands = 0;
+    this.podArgsOffset = 0;
+  }
+
+  /**
+   * Get the command encoder of the pending commands, and count a command encoded into it.
+   * @param podArgsBytes The size of the pod args of the command, if it is a dispatch.
+   */
+  private getPendingEncoder(podArgsBytes = 0): GPUCommandEncoder {
+    if (this.pendingEncoder !== undefined && (
+      this.numPendingCommands >= this.maxBatchCommands ||
+      this.podArgsOffset + podArgsBytes > WebGPUContext.podArgsBufferSize)) {
+      this.flushCommands();
+    }
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
+      // submit the commands of a task even when nothing reads their results in it.
+      queueMicrotask(() => this.flushCommands());
+    }
+    this.numPendingCommands += 1;
+    return this.pendingEncoder;
+  }
+
+  /**
+   * Take a slot of the pod args buffer for the dispatch just counted by getPendingEncoder.
+   * @param nbytes The size of the pod args.
+   * @returns The offset of the slot.
+   */
+  private allocPodArgsSlot(nbytes: number): number {
+    const alignment = this.device.limits.minUniformBufferOffsetAlignment;
+    assert(this.podArgsOffset + nbytes <= WebGPUContext.podArgsBufferSize);
+    if (this.podArgsBuffer === undefined) {
+      this.podArgsBuffer = tryCreateBuffer(this.device, {
+        size: WebGPUContext.podArgsBufferSize,
+        usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_DST,
+      });
+    }
+    const offset = this.podArgsOffset;
+    this.podArgsOffset = Math.ceil((offset + nbytes) / alignment) * alignment;
+    return offset;
+  }
+
   /**
    * Obtain the runtime information in readable format.
    */
@@ -455,6 +546,7 @@ export class WebGPUContext {
     if (this.canvasRenderManager == undefined) {
       throw Error("Do not have a canvas context, call bindCanvas first");
     }
+    this.flushCommands();
     this.canvasRenderManager.draw(this.gpuBufferFromPtr(ptr), height, width);
   }
 
@@ -473,6 +565,7 @@ export class WebGPUContext {
     nbytes: number
   ): void {
     // Perhaps it would be more useful to use a staging buffer?
+    this.flushCommands();
     this.device.queue.writeBuffer(
       this.gpuBufferFromPtr(toPtr),
       toOffset,
@@ -520,40 +613,6 @@ export class WebGPUContext {
     return await (this.createShadeInternal(finfo, code, true) as Promise<Function>);
   }
 
-  /**
-   * Get the pod arg staging buffer
-   * \param nbytes The minimum size.
-   * \return The allocated buffer
-   */
-  private getPodArgsBuffer(nbytes: number): GPUBuffer {
-    let buffer: GPUBuffer | undefined = undefined;
-    if (this.podArgStagingBuffers.length >= this.maxNumPodArgsStagingBuffers) {
-      buffer = this.podArgStagingBuffers.shift();
-    }
-    // minimum of 16 bytes
-    let allocSize = 16;
-    if (buffer !== undefined) {
-      allocSize = buffer.size;
-      if (buffer.size < nbytes) {
-        buffer.destroy();
-        buffer = undefined;
-      }
-    }
-    while (allocSize < nbytes) {
-      allocSize *= 2;
-    }
-
-    if (buffer == undefined) {
-      // create uniform buffer
-      buffer = tryCreateBuffer(this.device, {
-        size: allocSize,
-        usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_DST,
-      });
-    }
-    assert(nbytes <= buffer.size);
-    return buffer;
-  }
-
   /**
    * Internal impl of createShader for both async and sync mode.
    *
@@ -620,12 +679,19 @@ export class WebGPUContext {
       }
     });
 
-    const bindGroupLayout = this.device.createBindGroupLayout({
-      entries: layoutEntries
-    });
-    const pipelineLayout = this.device.createPipelineLayout({
-      bindGroupLayouts: [bindGroupLayout]
-    });
+    const layoutKey = layoutEntries.map((entry) => entry.buffer?.type).join(",");
+    let layouts = this.layoutCache.get(layoutKey);
+    if (layouts === undefined) {
+      const bindGroupLayout = this.device.createBindGroupLayout({
+        entries: layoutEntries
+      });
+      const pipelineLayout = this.device.createPipelineLayout({
+        bindGroupLayouts: [bindGroupLayout]
+      });
+      layouts = [bindGroupLayout, pipelineLayout];
+      this.layoutCache.set(layoutKey, layouts);
+    }
+    const [bindGroupLayout, pipelineLayout] = layouts;
 
     // Function to create the pipeline.
     const createShaderFunc = (pipeline: GPUComputePipeline): Function => {
@@ -636,9 +702,6 @@ export class WebGPUContext {
           return;
         }
 
-        const commandEncoder = this.device.createCommandEncoder();
-        const compute = commandEncoder.beginComputePass();
-        compute.setPipeline(pipeline);
         const bindGroupEntries: Array<GPUBindGroupEntry> = [];
         const numBufferOrPodArgs = bufferArgIndices.length + podArgIndices.length;
 
@@ -684,10 +747,12 @@ export class WebGPUContext {
 
         // push pod buffer
         const sizeOfI32 = 4;
-        const podArgBuffer = this.getPodArgsBuffer((podArgIndices.length + 1) * sizeOfI32);
-        const i32View = new Int32Array(podArgIndices.length + 1);
-        const u32View = new Uint32Array(i32View.buffer);
-        const f32View = new Float32Array(i32View.buffer);
+        const podArgsBytes = (podArgIndices.length + 1) * sizeOfI32;
+        const commandEncoder = this.getPendingEncoder(podArgsBytes);
+        const podArgsOffset = this.allocPodArgsSlot(podArgsBytes);
+        const i32View = new Int32Array(this.podArgsHostData, podArgsOffset, podArgIndices.length + 1);
+        const u32View = new Uint32Array(this.podArgsHostData, podArgsOffset, i32View.length);
+        const f32View = new Float32Array(this.podArgsHostData, podArgsOffset, i32View.length);
 
         for (let i = 0; i < podArgIndices.length; ++i) {
           const value = args[podArgIndices[i]];
@@ -704,27 +769,29 @@ export class WebGPUContext {
         }
         // always pass in dim z launching grid size in
         u32View[podArgIndices.length] = packDimX;
-        this.device.queue.writeBuffer(podArgBuffer, 0, i32View.buffer);
 
         bindGroupEntries.push({
           binding: bufferArgIndices.length,
           resource: {
-            buffer: podArgBuffer,
-            size: i32View.buffer.byteLength
+            buffer: this.podArgsBuffer as GPUBuffer,
+            offset: podArgsOffset,
+            size: podArgsBytes
           }
         });
 
+        if (this.pendingComputePass === undefined) {
+          this.pendingComputePass = commandEncoder.beginComputePass();
+        }
+        const compute = this.pendingComputePass;
+        compute.setPipeline(pipeline);
         compute.setBindGroup(0, this.device.createBindGroup({
           layout: bindGroupLayout,
           entries: bindGroupEntries
         }));
-
         compute.dispatchWorkgroups(workDim[0], workDim[1], workDim[2])
-        compute.end()
-        const command = commandEncoder.finish();
-        this.device.queue.submit([command]);
 
         if (this.debugLogFinish) {
+          this.flushCommands();
           const currCounter = this.shaderSubmitCounter;
           this.device.queue.onSubmittedWorkDone().then(() => {
             console.log("[" + currCounter + "][Debug] finish shader" + finfo.name);
@@ -745,17 +812,29 @@ export class WebGPUContext {
       ]
     });
 
+    // Identical shaders, e.g. of modules loaded again, share one pipeline.
+    const pipelineKey = layoutKey + "\n" + finfo.name + "\n" + code;
+    const cached = this.pipelineCache.get(pipelineKey);
     if (asyncMode) {
-      return this.device.createComputePipelineAsync({
+      if (cached !== undefined) {
+        return Promise.resolve(cached).then(createShaderFunc);
+      }
+      const promise = this.device.createComputePipelineAsync({
         layout: pipelineLayout,
         compute: {
           module: shaderModule,
           entryPoint: finfo.name
         }
       }).then((pipeline: GPUComputePipeline) => {
-        return createShaderFunc(pipeline);
+        this.pipelineCache.set(pipelineKey, pipeline);
+        return pipeline;
       });
+      this.pipelineCache.set(pipelineKey, promise);
+      return promise.then(createShaderFunc);
     } else {
+      if (cached !== undefined && !(cached instanceof Promise)) {
+        return createShaderFunc(cached);
+      }
       const pipeline = this.device.createComputePipeline({
         layout: pipelineLayout,
         compute: {
@@ -763,6 +842,7 @@ export class WebGPUContext {
           entryPoint: finfo.name
         }
       });
+      this.pipelineCache.set(pipelineKey, pipeline);
       return createShaderFunc(pipeline);
     }
   }
@@ -835,6 +915,8 @@ export class WebGPUContext {
 
   private deviceFreeDataSpace(ptr: GPUPointer): void {
     const idx = ptr;
+    // the pending commands may still use the buffer.
+    this.flushCommands();
     const buffer = this.bufferTable[idx];
     this.bufferTable[idx] = undefined;
     assert(buffer !== undefined);
@@ -858,6 +940,8 @@ export class WebGPUContext {
       rawBytes.set(rawBytes);
       nbytes = nbytes + toPad;
     }
+    // queue writes run before the commands submitted later, submit the pending ones first.
+    this.flushCommands();
     this.device.queue.writeBuffer(
       this.gpuBufferFromPtr(to),
       toOffset,
@@ -879,7 +963,8 @@ export class WebGPUContext {
       usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
     });
 
-    const copyEncoder = this.device.createCommandEncoder();
+    const copyEncoder = this.getPendingEncoder();
+    this.endPendingComputePass();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
@@ -887,8 +972,7 @@ export class WebGPUContext {
       0,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
+    this.flushCommands();
 
     gpuTemp.mapAsync(GPUMapMode.READ).then(() => {
       const data = gpuTemp.getMappedRange();
@@ -904,7 +988,8 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
+    const copyEncoder = this.getPendingEncoder();
+    this.endPendingComputePass();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
@@ -912,8 +997,14 @@ export class WebGPUContext {
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
+  }
+
+  /**
+   * End the compute pass of the pending dispatches, before encoding a copy after them.
+   */
+  private endPendingComputePass(): void {
+    this.pendingComputePass?.end();
+    this.pendingComputePass = undefined;
   }
 
   private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {